@@ -61,7 +61,7 @@ To run 10-fold cross-validation for softmax regression with accuracy as a
 performance measure, we can write the following piece of code.
 
 @code
-  KFoldCV<SoftmaxRegression, Accuracy> cv(10, data, labels, numClasses);
+  KFoldCV<SoftmaxRegression<>, Accuracy> cv(10, data, labels, numClasses);
   double lambda = 0.1;
   double softmaxAccuracy = cv.Evaluate(lambda);
 @endcode
@@ -309,7 +309,7 @@ performance of a softmax regression model, and that we have constructed
 the appropriate \c KFoldCV object using the code below:
 
 @code
-KFoldCV<SoftmaxRegression, Precision> cv(k, data, labels, numClasses);
+KFoldCV<SoftmaxRegression<>, Precision> cv(k, data, labels, numClasses);
 @endcode
 
 The \ref regression::SoftmaxRegression "SoftmaxRegression" class has the
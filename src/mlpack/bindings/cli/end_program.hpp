@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  * @author Matthew Amidon
  *
- * Terminate the program; handle --verbose option; print output parameters.
+ * Terminate the program; handle --verbose and --trace_file options; print
+ * output parameters.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -28,6 +29,20 @@ inline void EndProgram()
   // Stop the CLI timers.
   IO::GetSingleton().timer.StopAllTimers();
 
+  // Save the trace of the timers, if it was requested.
+  if (IO::HasParam("trace_file"))
+  {
+    const std::string& traceFile = IO::GetParam<std::string>("trace_file");
+    try
+    {
+      Timer::SaveTrace(traceFile);
+    }
+    catch (std::runtime_error& e)
+    {
+      Log::Warn << e.what() << "; the trace was not saved." << std::endl;
+    }
+  }
+
   // Print any output.
   std::map<std::string, util::ParamData>& parameters = IO::Parameters();
   for (auto& it : parameters)
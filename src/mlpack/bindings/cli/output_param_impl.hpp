@@ -14,6 +14,7 @@
 
 #include "output_param.hpp"
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/block_writer.hpp>
 #include <iostream>
 
 namespace mlpack {
@@ -47,6 +48,67 @@ void OutputParamImpl(
   std::cout << std::endl;
 }
 
+//! Matrices that don't hold indices are never saved with 32-bit elements.
+template<typename T>
+bool SaveCompactIndices(
+    util::ParamData& /* data */,
+    const T& /* output */,
+    const std::string& /* filename */,
+    const bool /* transpose */,
+    const typename std::enable_if<!std::is_same<typename T::elem_type,
+        size_t>::value>::type* = 0)
+{
+  return false;
+}
+
+/**
+ * If --compact_indices was given, save a matrix of indices (such as the
+ * neighbors of knn) to a binary file with 32-bit unsigned elements, if every
+ * index fits.
+ *
+ * @return Whether the matrix was saved.
+ */
+template<typename T>
+bool SaveCompactIndices(
+    util::ParamData& data,
+    const T& output,
+    const std::string& filename,
+    const bool transpose,
+    const typename std::enable_if<std::is_same<typename T::elem_type,
+        size_t>::value>::type* = 0)
+{
+  if (!IO::HasParam("compact_indices") ||
+      !IO::GetParam<bool>("compact_indices"))
+    return false;
+
+  const arma::file_type type = data::DetectFromExtension(filename);
+  if (type != arma::arma_binary && type != arma::raw_binary)
+    return false;
+
+  if (output.max() > std::numeric_limits<uint32_t>::max())
+  {
+    Log::Warn << "--compact_indices: the values of --" << data.name << " don't "
+        << "fit in 32 bits; saving them with 64 bits." << std::endl;
+    return false;
+  }
+
+  Log::Info << "Saving --" << data.name << " with 32-bit elements to '"
+      << filename << "'." << std::endl;
+  Timer::Start("saving_data");
+  try
+  {
+    data::SaveInBlocks<uint32_t>(filename, output, transpose, type);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("saving_data");
+    Log::Fatal << e.what() << std::endl;
+  }
+  Timer::Stop("saving_data");
+
+  return true;
+}
+
 //! Output a matrix option (this saves it to file).
 template<typename T>
 void OutputParamImpl(
@@ -58,7 +120,11 @@ void OutputParamImpl(
   const std::string& filename =
       std::get<0>(std::get<1>(*boost::any_cast<TupleType>(&data.value)));
 
-  if (output.n_elem > 0 && filename != "")
+  // Row vectors are saved with one value per line, like column vectors.
+  const bool transpose = arma::is_Row<T>::value ||
+      (!arma::is_Col<T>::value && !data.noTranspose);
+  if (output.n_elem > 0 && filename != "" &&
+      !SaveCompactIndices(data, output, filename, transpose))
   {
     if (arma::is_Row<T>::value || arma::is_Col<T>::value)
       data::Save(filename, output, false);
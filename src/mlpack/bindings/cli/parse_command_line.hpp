@@ -28,6 +28,25 @@ PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_INT_IN("num_threads", "Number of OpenMP threads used by the method, if "
+    "it is parallelized; 0 uses the default number of threads.", "", 0);
+PARAM_STRING_IN("trace_file", "If specified, a trace of the timers of each "
+    "thread is saved to this file in the Chrome trace event format (it can be "
+    "viewed with chrome://tracing or Perfetto).", "", "");
+PARAM_STRING_IN("serve_input", "If specified, run as a server: the program "
+    "is run on batches of requests read from stdin, and this input matrix "
+    "parameter (for instance 'test' or 'query') is set to the points of each "
+    "batch.  The other parameters, and the input models, are the same for "
+    "every batch, so the models are only loaded once.", "", "");
+PARAM_STRING_IN("serve_output", "Comma-separated list of the output matrix "
+    "parameters whose values are returned to each request, for instance "
+    "'predictions' or 'neighbors,distances' (with --serve_input).", "", "");
+PARAM_INT_IN("serve_batch_size", "Maximum number of points of the requests "
+    "that are run together (with --serve_input).", "", 10000);
+PARAM_FLAG("compact_indices", "If specified, output matrices of indices (such "
+    "as neighbors or predictions) that are saved to Armadillo binary (.bin) "
+    "files are stored with 32-bit unsigned elements if all the values fit; "
+    "such files must be loaded as 32-bit matrices.", "");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -129,6 +148,20 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
+  // Limit the number of threads, so that several programs can share a host.
+  const int numThreads = IO::GetParam<int>("num_threads");
+  if (numThreads < 0)
+  {
+    Log::Fatal << "Invalid value for --num_threads (" << numThreads << "); "
+        << "must be non-negative (0 uses the default number of threads)."
+        << std::endl;
+  }
+  util::SetNumThreads((size_t) numThreads);
+
+  // Record the runs of the timers, if a trace was requested.
+  if (IO::HasParam("trace_file"))
+    Timer::EnableTracing();
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
@@ -0,0 +1,450 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * The serving mode of command-line programs: the program is run on batches of
+ * prediction requests read from stdin, so that models are only loaded once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core/util/io.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+//! A prediction request of the serving mode.
+struct ServeRequest
+{
+  //! The identifier of the request, which is repeated in the response.
+  std::string id;
+  //! The points of the request, one per column.
+  arma::mat points;
+  //! If not empty, the request is malformed, and this is the reason.
+  std::string error;
+  //! The time the request was read at.
+  std::chrono::steady_clock::time_point received;
+};
+
+/**
+ * A histogram of latencies, with buckets of exponentially increasing sizes
+ * (bucket b holds the latencies in [2^(b - 1), 2^b) microseconds).
+ */
+class LatencyHistogram
+{
+ public:
+  //! Create an empty histogram.
+  LatencyHistogram() : buckets(40, 0), count(0), total(0.0) { }
+
+  //! Add a latency, in microseconds.
+  void Add(const double microseconds)
+  {
+    size_t b = 0;
+    while (b + 1 < buckets.size() && std::ldexp(1.0, (int) b) <= microseconds)
+      ++b;
+    ++buckets[b];
+    ++count;
+    total += microseconds;
+  }
+
+  //! Get the number of latencies.
+  size_t Count() const { return count; }
+
+  /**
+   * Get an upper bound of the given quantile of the latencies (the upper end
+   * of the bucket it falls into), in microseconds.
+   */
+  double Quantile(const double q) const
+  {
+    const size_t rank = (size_t) std::ceil(q * count);
+    size_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); ++b)
+    {
+      seen += buckets[b];
+      if (seen >= rank && seen > 0)
+        return std::ldexp(1.0, (int) b);
+    }
+
+    return 0.0;
+  }
+
+  //! Print the histogram and a summary of it to the given stream.
+  template<typename StreamType>
+  void Print(StreamType& out) const
+  {
+    if (count == 0)
+    {
+      out << "  no requests." << std::endl;
+      return;
+    }
+
+    out << "  " << count << " requests; mean " << total / count << "us, p50 <"
+        << Quantile(0.5) << "us, p90 <" << Quantile(0.9) << "us, p99 <"
+        << Quantile(0.99) << "us." << std::endl;
+    for (size_t b = 0; b < buckets.size(); ++b)
+    {
+      if (buckets[b] == 0)
+        continue;
+
+      out << "  [" << ((b == 0) ? 0.0 : std::ldexp(1.0, (int) b - 1)) << "us, "
+          << std::ldexp(1.0, (int) b) << "us): " << buckets[b] << std::endl;
+    }
+  }
+
+ private:
+  //! The number of latencies in each bucket.
+  std::vector<size_t> buckets;
+  //! The number of latencies.
+  size_t count;
+  //! The sum of the latencies.
+  double total;
+};
+
+/**
+ * Read a request from the given stream.  A request is a line with an
+ * identifier (without spaces) and a number of points, followed by one line for
+ * each point, with values separated by commas or spaces.  Empty lines between
+ * requests are skipped.  A malformed request is returned with an error; its
+ * lines are still read, so the following requests can be read.
+ *
+ * @param in Stream to read from.
+ * @param request Request to fill.
+ * @return false if the end of the input or a line with "quit" was reached.
+ */
+inline bool ReadServeRequest(std::istream& in, ServeRequest& request)
+{
+  std::string line;
+  do
+  {
+    if (!std::getline(in, line))
+      return false;
+  } while (line.find_first_not_of(" \t\r") == std::string::npos);
+
+  std::istringstream header(line);
+  size_t numPoints = 0;
+  request.id.clear();
+  request.error.clear();
+  request.points.clear();
+  if (!(header >> request.id) || request.id == "quit")
+    return false;
+
+  if (!(header >> numPoints))
+  {
+    request.error = "the header must give the number of points";
+    request.received = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  std::vector<double> values;
+  size_t dimensionality = 0;
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (!std::getline(in, line))
+    {
+      request.error = "the input ended before the last point";
+      break;
+    }
+
+    // Parse the values of the point.
+    size_t pointDimensionality = 0;
+    const char* current = line.c_str();
+    while (true)
+    {
+      while (*current == ',' || *current == ' ' || *current == '\t' ||
+             *current == '\r')
+        ++current;
+      if (*current == '\0')
+        break;
+
+      char* end;
+      const double value = std::strtod(current, &end);
+      if (end == current)
+      {
+        request.error = "point " + std::to_string(i) + " has a value that "
+            "isn't a number";
+        break;
+      }
+
+      values.push_back(value);
+      ++pointDimensionality;
+      current = end;
+    }
+
+    if (i == 0)
+      dimensionality = pointDimensionality;
+    if (request.error.empty() && (pointDimensionality != dimensionality ||
+        dimensionality == 0))
+    {
+      request.error = "point " + std::to_string(i) + " has " +
+          std::to_string(pointDimensionality) + " values, but point 0 has " +
+          std::to_string(dimensionality);
+    }
+  }
+
+  if (request.error.empty() && numPoints > 0)
+    request.points = arma::mat(values.data(), dimensionality, numPoints);
+  request.received = std::chrono::steady_clock::now();
+
+  return true;
+}
+
+/**
+ * Run the program on a batch of requests with the same dimensionality, and
+ * write the responses.  If the program fails on a batch of several requests,
+ * each request is run on its own, so that only the bad requests fail.
+ *
+ * @param requests Requests of the batch.
+ * @param begin Index of the first request of the batch.
+ * @param end Index after the last request of the batch.
+ * @param run Function that runs the program.
+ * @param input Parameter that gets the points of the requests.
+ * @param outputs Output parameters that are returned to the requests.
+ * @param responses Stream to write the responses to.
+ * @param latencies Histogram of the latencies of the requests.
+ */
+inline void RunServeBatch(const std::vector<ServeRequest>& requests,
+                          const size_t begin,
+                          const size_t end,
+                          void (*run)(),
+                          util::ParamData& input,
+                          const std::vector<util::ParamData*>& outputs,
+                          std::ostream& responses,
+                          LatencyHistogram& latencies)
+{
+  size_t numPoints = 0;
+  for (size_t r = begin; r < end; ++r)
+    numPoints += requests[r].points.n_cols;
+
+  try
+  {
+    arma::mat points(requests[begin].points.n_rows, numPoints);
+    size_t column = 0;
+    for (size_t r = begin; r < end; ++r)
+    {
+      points.cols(column, column + requests[r].points.n_cols - 1) =
+          requests[r].points;
+      column += requests[r].points.n_cols;
+    }
+
+    IO::GetSingleton().functionMap[input.tname]["SetServeInput"](input,
+        (const void*) &points, NULL);
+    run();
+
+    std::vector<arma::mat> values(outputs.size());
+    for (size_t o = 0; o < outputs.size(); ++o)
+    {
+      IO::GetSingleton().functionMap[outputs[o]->tname]["GetServeOutput"](
+          *outputs[o], NULL, (void*) &values[o]);
+      if (values[o].n_cols != numPoints)
+      {
+        std::ostringstream oss;
+        oss << "output " << outputs[o]->name << " has " << values[o].n_cols
+            << " columns for " << numPoints << " points";
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    column = 0;
+    for (size_t r = begin; r < end; ++r)
+    {
+      responses << requests[r].id << " ok " << requests[r].points.n_cols
+          << "\n";
+      for (size_t i = 0; i < requests[r].points.n_cols; ++i, ++column)
+      {
+        bool first = true;
+        for (size_t o = 0; o < values.size(); ++o)
+        {
+          for (size_t j = 0; j < values[o].n_rows; ++j)
+          {
+            responses << (first ? "" : ",") << values[o](j, column);
+            first = false;
+          }
+        }
+        responses << "\n";
+      }
+    }
+  }
+  catch (std::exception& e)
+  {
+    // The timers that were running when the program failed must be stopped
+    // before it can run again; the timers of the serving loop are restarted.
+    IO::GetSingleton().timer.StopAllTimers();
+    Timer::Start("total_time");
+    Timer::Start("serve_batch");
+
+    if (end - begin > 1)
+    {
+      for (size_t r = begin; r < end; ++r)
+      {
+        RunServeBatch(requests, r, r + 1, run, input, outputs, responses,
+            latencies);
+      }
+      return;
+    }
+
+    responses << requests[begin].id << " error " << e.what() << "\n";
+  }
+
+  responses.flush();
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  for (size_t r = begin; r < end; ++r)
+  {
+    latencies.Add(std::chrono::duration<double, std::micro>(now -
+        requests[r].received).count());
+  }
+}
+
+/**
+ * Run the program in the serving mode.  The command-line parameters are used
+ * for every run, so the input models are only loaded once; the requests are
+ * read from stdin by another thread, and the requests that are waiting when the
+ * program is ready are batched (up to --serve_batch_size points), so that the
+ * program runs once for all of them.  For each request, in order, the response
+ * is a line "<id> ok <number of points>" followed by one line for each point,
+ * with the values of the --serve_output parameters for the point separated by
+ * commas, or a line "<id> error <message>".  The responses are the only output
+ * on stdout; log messages are written to stderr.  A histogram of the latencies
+ * of the requests is printed with --verbose.
+ *
+ * @param run Function that runs the program (mlpackMain()).
+ */
+inline void Serve(void (*run)())
+{
+  std::map<std::string, util::ParamData>& parameters = IO::Parameters();
+
+  // Find the parameters the requests go through.
+  const std::string inputName = IO::GetParam<std::string>("serve_input");
+  if (parameters.count(inputName) == 0 || !parameters[inputName].input)
+  {
+    Log::Fatal << "--serve_input: '" << inputName << "' is not an input "
+        << "parameter of this program!" << std::endl;
+  }
+  util::ParamData& input = parameters[inputName];
+
+  std::vector<util::ParamData*> outputs;
+  std::istringstream outputNames(IO::GetParam<std::string>("serve_output"));
+  std::string outputName;
+  while (std::getline(outputNames, outputName, ','))
+  {
+    if (parameters.count(outputName) == 0 || parameters[outputName].input)
+    {
+      Log::Fatal << "--serve_output: '" << outputName << "' is not an output "
+          << "parameter of this program!" << std::endl;
+    }
+
+    // Many programs only compute the outputs that were requested.
+    outputs.push_back(&parameters[outputName]);
+    outputs.back()->wasPassed = true;
+  }
+  if (outputs.empty())
+  {
+    Log::Fatal << "--serve_output must give at least one output parameter!"
+        << std::endl;
+  }
+
+  const int batchSize = IO::GetParam<int>("serve_batch_size");
+  if (batchSize <= 0)
+  {
+    Log::Fatal << "Invalid value for --serve_batch_size (" << batchSize
+        << "); must be positive." << std::endl;
+  }
+
+  // Log messages go to stderr, so that stdout only holds the responses.
+  std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+  std::ostream responses(stdoutBuffer);
+  responses.precision(std::numeric_limits<double>::max_digits10);
+
+  // The requests are read while the previous batch runs.
+  std::deque<ServeRequest> queue;
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  bool inputDone = false;
+  std::thread reader([&]()
+  {
+    ServeRequest request;
+    while (ReadServeRequest(std::cin, request))
+    {
+      std::lock_guard<std::mutex> lock(queueMutex);
+      queue.push_back(std::move(request));
+      queueCondition.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    inputDone = true;
+    queueCondition.notify_one();
+  });
+
+  LatencyHistogram latencies;
+  size_t numBatches = 0;
+  std::vector<ServeRequest> batch;
+  while (true)
+  {
+    // Take the waiting requests, up to the batch size.
+    batch.clear();
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueCondition.wait(lock, [&]() { return !queue.empty() || inputDone; });
+      if (queue.empty())
+        break;
+
+      size_t numPoints = 0;
+      while (!queue.empty())
+      {
+        const ServeRequest& next = queue.front();
+        if (!batch.empty() && (next.error.empty() != batch[0].error.empty() ||
+            next.points.n_rows != batch[0].points.n_rows ||
+            numPoints + next.points.n_cols > (size_t) batchSize))
+          break;
+
+        numPoints += next.points.n_cols;
+        batch.push_back(std::move(queue.front()));
+        queue.pop_front();
+      }
+    }
+
+    if (!batch[0].error.empty() || batch[0].points.n_cols == 0)
+    {
+      for (size_t r = 0; r < batch.size(); ++r)
+      {
+        if (batch[r].error.empty())
+          responses << batch[r].id << " ok 0\n";
+        else
+          responses << batch[r].id << " error " << batch[r].error << "\n";
+      }
+      responses.flush();
+      continue;
+    }
+
+    Timer::Start("serve_batch");
+    RunServeBatch(batch, 0, batch.size(), run, input, outputs, responses,
+        latencies);
+    Timer::Stop("serve_batch");
+    ++numBatches;
+  }
+
+  reader.join();
+
+  Log::Info << "Served " << latencies.Count() << " requests in " << numBatches
+      << " batches; latencies:" << std::endl;
+  latencies.Print(Log::Info);
+
+  std::cout.rdbuf(stdoutBuffer);
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file bindings/cli/serve_param.hpp
+ *
+ * Set the input matrix and get the output matrices of a binding in the serving
+ * mode.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "parameter_type.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Only matrix parameters can be served.
+ *
+ * @param d ParamData object to set.
+ * @param * (points) Points of the requests. (Unused.)
+ */
+template<typename T>
+void SetServeInputInternal(
+    util::ParamData& d,
+    const arma::mat& /* points */,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  Log::Fatal << "Parameter --" << d.name << " is not a matrix parameter, so "
+      << "it can't be given by requests!" << std::endl;
+}
+
+/**
+ * Set a matrix parameter to the points of a batch of requests, as if it had
+ * been loaded from a file.
+ *
+ * @param d ParamData object to set.
+ * @param points Points of the requests, one per column.
+ */
+template<typename T>
+void SetServeInputInternal(
+    util::ParamData& d,
+    const arma::mat& points,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  TupleType& tuple = *boost::any_cast<TupleType>(&d.value);
+  T& matrix = std::get<0>(tuple);
+
+  // Vectors hold one value per point; matrices that aren't transposed when
+  // they are loaded hold one point per row.
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+  {
+    if (points.n_rows != 1)
+    {
+      Log::Fatal << "Parameter --" << d.name << " takes one value per point, "
+          << "but the points have " << points.n_rows << " values!"
+          << std::endl;
+    }
+
+    matrix = arma::conv_to<T>::from(arma::vectorise(points));
+  }
+  else if (d.noTranspose)
+  {
+    matrix = arma::conv_to<T>::from(arma::mat(points.t()));
+  }
+  else
+  {
+    matrix = arma::conv_to<T>::from(points);
+  }
+
+  std::get<1>(std::get<1>(tuple)) = matrix.n_rows;
+  std::get<2>(std::get<1>(tuple)) = matrix.n_cols;
+  d.wasPassed = true;
+  d.loaded = true;
+}
+
+/**
+ * Only matrix parameters can be returned to requests.
+ *
+ * @param d ParamData object to get.
+ * @param * (output) Output values. (Unused.)
+ */
+template<typename T>
+void GetServeOutputInternal(
+    util::ParamData& d,
+    arma::mat& /* output */,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  Log::Fatal << "Parameter --" << d.name << " is not a matrix parameter, so "
+      << "it can't be returned to requests!" << std::endl;
+}
+
+/**
+ * Get the values of a matrix output parameter, with one column per point (a
+ * vector gives one value per point).
+ *
+ * @param d ParamData object to get.
+ * @param output Output values.
+ */
+template<typename T>
+void GetServeOutputInternal(
+    util::ParamData& d,
+    arma::mat& output,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  const T& matrix = std::get<0>(*boost::any_cast<TupleType>(&d.value));
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    output = arma::conv_to<arma::rowvec>::from(matrix);
+  else
+    output = arma::conv_to<arma::mat>::from(matrix);
+}
+
+/**
+ * Set the given matrix parameter to the points of a batch of requests.
+ *
+ * @param d Parameter information.
+ * @param input Pointer to the points (an arma::mat with one point per column).
+ * @param * (output) Unused parameter.
+ */
+template<typename T>
+void SetServeInput(util::ParamData& d,
+                   const void* input,
+                   void* /* output */)
+{
+  SetServeInputInternal<typename std::remove_pointer<T>::type>(d,
+      *((const arma::mat*) input));
+}
+
+/**
+ * Get the values of the given matrix output parameter for each point.
+ *
+ * @param d Parameter information.
+ * @param * (input) Unused parameter.
+ * @param output Pointer to the arma::mat to store the values in.
+ */
+template<typename T>
+void GetServeOutput(util::ParamData& d,
+                    const void* /* input */,
+                    void* output)
+{
+  GetServeOutputInternal<typename std::remove_pointer<T>::type>(d,
+      *((arma::mat*) output));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -62,7 +62,8 @@ class MDOption
     data.loaded = false;
     // Several options from Python and CLI bindings are persistent.
     if (identifier == "verbose" || identifier == "copy_all_inputs" ||
-        identifier == "help" || identifier == "info" || identifier == "version")
+        identifier == "num_threads" || identifier == "help" ||
+        identifier == "info" || identifier == "version")
       data.persistent = true;
     else
       data.persistent = false;
@@ -72,7 +73,8 @@ class MDOption
     data.value = boost::any(defaultValue);
 
     // Restore the parameters for this program.
-    if (identifier != "verbose" && identifier != "copy_all_inputs")
+    if (identifier != "verbose" && identifier != "copy_all_inputs" &&
+        identifier != "num_threads")
       IO::RestoreSettings(bindingName, false);
 
     // Set the function pointers that we'll need.  Most of these simply delegate
@@ -96,7 +98,8 @@ class MDOption
     // Add the option.
     IO::Add(std::move(data));
     if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+        identifier != "num_threads" && identifier != "help" &&
+        identifier != "info" && identifier != "version")
       IO::StoreSettings(bindingName);
     IO::ClearSettings();
   }
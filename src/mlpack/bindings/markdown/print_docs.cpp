@@ -130,6 +130,9 @@ void PrintDocs(const std::string& bindingName,
       // There are some special options that don't exist in some languages.
       if (languages[i] != "python" && it->second.name == "copy_all_inputs")
         continue;
+      if (languages[i] != "python" && languages[i] != "cli" &&
+          it->second.name == "num_threads")
+        continue;
       if (languages[i] != "cli" &&
           (it->second.name == "help" || it->second.name == "info" ||
            it->second.name == "version"))
@@ -160,7 +163,8 @@ void PrintDocs(const std::string& bindingName,
       string desc = boost::replace_all_copy(it->second.desc, "|", "\\|");
       cout << desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
-      if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
+      if (it->second.name == "copy_all_inputs" ||
+          it->second.name == "num_threads" || it->second.name == "help" ||
           it->second.name == "info" || it->second.name == "version")
       {
         cout << "  <span class=\"special\">Only exists in "
@@ -224,7 +228,8 @@ void PrintDocs(const std::string& bindingName,
       cout << ParamType(it->second) << " | ";
       cout << it->second.desc;
       // Print whether or not it's a "special" language-only parameter.
-      if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
+      if (it->second.name == "copy_all_inputs" ||
+          it->second.name == "num_threads" || it->second.name == "help" ||
           it->second.name == "info" || it->second.name == "version")
       {
         cout << "  <span class=\"special\">Only exists in "
@@ -48,8 +48,12 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -68,9 +72,12 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -132,9 +139,12 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -154,9 +164,12 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -215,9 +228,12 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -237,9 +253,12 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not X.flags.c_contiguous or (not X.flags.owndata and not isWin):
-    # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+  # C-contiguous memory is used directly, even if it belongs to another array
+  # (for instance if X is a slice or the values of a DataFrame); it only needs
+  # to be copied if it is not contiguous, or if we must take ownership of it and
+  # X doesn't own it.
+  if not X.flags.c_contiguous or \
+      (takeOwnership and not X.flags.owndata and not isWin):
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -53,3 +53,7 @@ cdef extern from "<mlpack/bindings/python/mlpack/io_util.hpp>" \
   void DisableBacktrace() nogil except +
   void ResetTimers() nogil except +
   void EnableTimers() nogil except +
+  void LockBindings() nogil except +
+  void UnlockBindings() nogil except +
+  int SetNumThreads() nogil except +
+  void RestoreNumThreads(int) nogil except +
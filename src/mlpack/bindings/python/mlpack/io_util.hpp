@@ -14,6 +14,7 @@
 #define MLPACK_BINDINGS_PYTHON_CYTHON_IO_UTIL_HPP
 
 #include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/parallel.hpp>
 #include <mlpack/core/data/dataset_mapper.hpp>
 
 namespace mlpack {
@@ -163,6 +164,53 @@ inline void EnableTimers()
   Timer::EnableTiming();
 }
 
+/**
+ * Wait until no other binding is running, and prevent other bindings from
+ * running until UnlockBindings() is called.  This is called without the GIL.
+ */
+inline void LockBindings()
+{
+  IO::GetSingleton().bindingMutex.lock();
+}
+
+/**
+ * Allow other bindings to run.
+ */
+inline void UnlockBindings()
+{
+  IO::GetSingleton().bindingMutex.unlock();
+}
+
+/**
+ * Set the number of OpenMP threads of the calling thread to the value of the
+ * num_threads parameter, if it is positive, and return the previous number of
+ * threads, to be given to RestoreNumThreads() after the method has run.
+ */
+inline int SetNumThreads()
+{
+  const int numThreads = IO::GetParam<int>("num_threads");
+  if (numThreads < 0)
+  {
+    throw std::invalid_argument("num_threads must be non-negative (0 uses the "
+        "default number of threads)!");
+  }
+
+  const int oldNumThreads = (int) NumThreads();
+  if (numThreads > 0)
+    SetNumThreads((size_t) numThreads);
+  return oldNumThreads;
+}
+
+/**
+ * Restore the number of OpenMP threads of the calling thread.
+ *
+ * @param numThreads Number of threads returned by SetNumThreads().
+ */
+inline void RestoreNumThreads(const int numThreads)
+{
+  SetNumThreads((size_t) numThreads);
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -97,15 +97,15 @@ void PrintInputProcessing(
 
     if (GetPrintableType<T>(d) == "bool")
     {
-      std::cout << "  else:" << std::endl;
-      std::cout << "    raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "else:" << std::endl;
+      std::cout << prefix << "  raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
     else
     {
-      std::cout << "    else:" << std::endl;
-      std::cout << "      raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "  else:" << std::endl;
+      std::cout << prefix << "    raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
@@ -141,15 +141,15 @@ void PrintInputProcessing(
 
     if (GetPrintableType<T>(d) == "bool")
     {
-      std::cout << "  else:" << std::endl;
-      std::cout << "    raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "else:" << std::endl;
+      std::cout << prefix << "  raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
     else
     {
-      std::cout << "    else:" << std::endl;
-      std::cout << "      raise TypeError(" <<"\"'"<< name
+      std::cout << prefix << "  else:" << std::endl;
+      std::cout << prefix << "    raise TypeError(" <<"\"'"<< name
           << "' must have type \'" << GetPrintableType<T>(d)
           << "'!\")" << std::endl;
     }
@@ -347,7 +347,7 @@ void PrintInputProcessing(
       std::cout << prefix << d.name << "_tuple = to_matrix(" << d.name
           << ", dtype=" << GetNumpyType<typename T::elem_type>()
           << ", copy=IO.HasParam('copy_all_inputs'))" << std::endl;
-      std::cout << prefix << "if len(" << d.name << "_tuple[0].shape) > 2:"
+      std::cout << prefix << "if len(" << d.name << "_tuple[0].shape) < 2:"
           << std::endl;
       std::cout << prefix << "  " << d.name << "_tuple[0].shape = (" << d.name
           << "_tuple[0].shape[0], 1)" << std::endl;
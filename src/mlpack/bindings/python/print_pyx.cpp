@@ -78,7 +78,8 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from io cimport SetParam, SetParamPtr, SetParamWithInfo, "
       << "GetParamPtr" << endl;
   cout << "from io cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
-      << "ResetTimers, EnableTimers" << endl;
+      << "ResetTimers, EnableTimers, LockBindings, UnlockBindings, "
+      << "SetNumThreads, RestoreNumThreads" << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
   cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
   cout << endl;
@@ -185,24 +186,31 @@ void PrintPYX(const util::BindingDetails& doc,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // The parameters of all the bindings are held by IO, so only one binding
+  // can run at a time.  The lock is taken without the GIL, so that other
+  // Python threads can run while we wait for it and while the method runs.
+  cout << "  with nogil:" << endl;
+  cout << "    LockBindings()" << endl;
+  cout << "  try:" << endl;
+
   // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
-  cout << "  DisableBacktrace()" << endl;
-  cout << "  DisableVerbose()" << endl;
+  cout << "    ResetTimers()" << endl;
+  cout << "    EnableTimers()" << endl;
+  cout << "    DisableBacktrace()" << endl;
+  cout << "    DisableVerbose()" << endl;
 
   // Restore the parameters.
-  cout << "  IO.RestoreSettings(\"" << doc.programName << "\")"
+  cout << "    IO.RestoreSettings(\"" << doc.programName << "\")"
       << endl;
 
   // Determine whether or not we need to copy parameters.
-  cout << "  if isinstance(copy_all_inputs, bool):" << endl;
-  cout << "    if copy_all_inputs:" << endl;
-  cout << "      SetParam[cbool](<const string> 'copy_all_inputs', "
+  cout << "    if isinstance(copy_all_inputs, bool):" << endl;
+  cout << "      if copy_all_inputs:" << endl;
+  cout << "        SetParam[cbool](<const string> 'copy_all_inputs', "
       << "copy_all_inputs)" << endl;
-  cout << "      IO.SetPassed(<const string> 'copy_all_inputs')" << endl;
-  cout << "  else:" << endl;
-  cout << "    raise TypeError(" <<"\"'copy_all_inputs\' must have type "
+  cout << "        IO.SetPassed(<const string> 'copy_all_inputs')" << endl;
+  cout << "    else:" << endl;
+  cout << "      raise TypeError(" <<"\"'copy_all_inputs\' must have type "
       << "\'bool'!\")" << endl;
   cout << endl;
 
@@ -211,53 +219,59 @@ void PrintPYX(const util::BindingDetails& doc,
   {
     util::ParamData& d = parameters.at(inputOptions[i]);
 
-    size_t indent = 2;
+    size_t indent = 4;
     IO::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  IO.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    IO.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
   // Checking the type of check_input_matrices parameter.
-  cout << "  if not isinstance(check_input_matrices, bool):" << endl;
-  cout << "    raise TypeError(" <<"\"'check_input_matrices\' must have type "
-      << "\'bool'!\")" << endl;
+  cout << "    if not isinstance(check_input_matrices, bool):" << endl;
+  cout << "      raise TypeError(" <<"\"'check_input_matrices\' must have "
+      << "type \'bool'!\")" << endl;
   cout << endl;
 
   // Before calling mlpackMain(), we check input matrices for NaN values if needed.
-  cout << "  if check_input_matrices:" << endl;
-  cout << "    IO.CheckInputMatrices()" << endl;
-
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "    if check_input_matrices:" << endl;
+  cout << "      IO.CheckInputMatrices()" << endl;
+
+  // Call the method without the GIL, with the requested number of threads.
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    oldNumThreads = SetNumThreads()" << endl;
+  cout << "    try:" << endl;
+  cout << "      with nogil:" << endl;
+  cout << "        mlpackMain()" << endl;
+  cout << "    finally:" << endl;
+  cout << "      RestoreNumThreads(oldNumThreads)" << endl;
 
   // Do any output processing and return.
-  cout << "  # Initialize result dictionary." << endl;
-  cout << "  result = {}" << endl;
+  cout << "    # Initialize result dictionary." << endl;
+  cout << "    result = {}" << endl;
   cout << endl;
 
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     util::ParamData& d = parameters.at(outputOptions[i]);
 
-    std::tuple<size_t, bool> t = std::make_tuple(2, false);
+    std::tuple<size_t, bool> t = std::make_tuple(4, false);
     IO::GetSingleton().functionMap[d.tname]["PrintOutputProcessing"](d,
         (void*) &t, NULL);
   }
 
-  // Clear the parameters.
-  cout << endl;
-  cout << "  IO.ClearSettings()" << endl;
+  // Clear the parameters, and release the lock, even if an exception was
+  // thrown.
   cout << endl;
-
-  cout << "  return result" << endl;
+  cout << "    return result" << endl;
+  cout << "  finally:" << endl;
+  cout << "    IO.ClearSettings()" << endl;
+  cout << "    UnlockBindings()" << endl;
 }
 
 } // namespace python
@@ -155,7 +155,10 @@ std::string PrintTypeDoc(
 {
   return "An mlpack model pointer.  This type can be pickled to or from disk, "
       "and internally holds a pointer to C++ memory containing the mlpack "
-      "model.  Note that this means that the mlpack model itself cannot be "
+      "model.  Passing it to another binding call uses that memory directly, "
+      "without serializing or copying the model (unless copy_all_inputs is "
+      "set), so a model can be trained once and then used for many fast "
+      "calls.  Note that this means that the mlpack model itself cannot be "
       "easily inspected in Python; however, the pickled model can be loaded "
       "in C++ and inspected there.";
 }
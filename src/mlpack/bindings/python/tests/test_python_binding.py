@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -131,6 +132,38 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyMatrixView(self):
+    """
+    A C-contiguous view of a larger matrix should be usable as an input, and its
+    memory should be used directly.
+    """
+    x = np.random.rand(200, 5)
+    z = copy.deepcopy(x)
+    view = z[50:150]
+    self.assertFalse(view.flags.owndata)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 mat_req_in=[[1.0]],
+                                 col_req_in=[1.0],
+                                 matrix_in=view)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[50 + j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[50 + j, 2], output['matrix_out'][j, 2])
+
+    # The rest of the matrix is untouched.
+    for j in range(50):
+      self.assertEqual(x[j, 2], z[j, 2])
+      self.assertEqual(x[150 + j, 2], z[150 + j, 2])
+
   def testNumpyMatrixForceCopy(self):
     """
     The matrix we pass in, we should get back with the third dimension doubled
@@ -1432,5 +1465,49 @@ class TestPythonBinding(unittest.TestCase):
                                                    matrix_and_info_in=x,
                                                    check_input_matrices=True))
 
+  def testThreadedCalls(self):
+    """
+    Bindings called from several Python threads at once should all give
+    correct results, and a call that fails should not block the next calls.
+    """
+    self.assertRaises(TypeError,
+                      lambda : test_python_binding(string_in="hello",
+                                                   int_in="wrong",
+                                                   double_in=4.0,
+                                                   mat_req_in=[[1.0]],
+                                                   col_req_in=[1.0]))
+
+    results = [None] * 8
+    def call(i):
+      x = np.random.rand(100, 5)
+      output = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   mat_req_in=[[1.0]],
+                                   col_req_in=[1.0],
+                                   matrix_in=x,
+                                   num_threads=2)
+      results[i] = np.allclose(output['matrix_out'][:, 2], 2 * x[:, 2])
+
+    threads = [threading.Thread(target=call, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    self.assertTrue(all(results))
+
+  def testNegativeNumThreads(self):
+    """
+    A negative number of threads should be rejected.
+    """
+    self.assertRaises(ValueError,
+                      lambda : test_python_binding(string_in="hello",
+                                                   int_in=12,
+                                                   double_in=4.0,
+                                                   mat_req_in=[[1.0]],
+                                                   col_req_in=[1.0],
+                                                   num_threads=-1))
+
 if __name__ == '__main__':
   unittest.main()
@@ -70,9 +70,15 @@
 #include <mlpack/core/util/arma_traits.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/parallel.hpp>
+#include <mlpack/core/util/profile_timers.hpp>
+#include <mlpack/core/util/training_profiler.hpp>
 #include <mlpack/core/util/deprecated.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/mapped_model.hpp>
+#include <mlpack/core/data/data_stream.hpp>
+#include <mlpack/core/data/block_writer.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
 #include <mlpack/core/math/clamp.hpp>
 #include <mlpack/core/math/random.hpp>
@@ -16,14 +16,122 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
 
+#include <mlpack/core/cereal/aligned_binary.hpp>
 #include <mlpack/core/cereal/array_wrapper.hpp>
 
 #include <armadillo>
 
+namespace cereal {
+
+/**
+ * Serialize the given memory of an Armadillo object, element by element, as
+ * the text archives need.
+ */
+template<typename Archive, typename eT>
+void SerializeArmaMemory(Archive& ar,
+                         eT* mem,
+                         const size_t n_elem,
+                         const char* name)
+{
+  for (size_t i = 0; i < n_elem; ++i)
+    ar(cereal::make_nvp(name, mem[i]));
+}
+
+/**
+ * Save the given memory of an Armadillo object to a binary archive in a single
+ * block.  The bytes are the same as when the elements are saved one by one,
+ * except in aligned binary archives, where the block is preceded by padding
+ * that makes it start at a 64-byte boundary of the file.
+ */
+template<typename eT>
+void SerializeArmaMemory(BinaryOutputArchive& ar,
+                         eT* mem,
+                         const size_t n_elem,
+                         const char* /* name */)
+{
+  AlignedBinaryContext* context = AlignedBinaryContext::For(&ar);
+  if (context != NULL)
+  {
+    // The padding follows its own size byte.
+    const size_t position = (size_t) context->out->tellp() + 1;
+    const uint8_t padding = (uint8_t) ((AlignedBinaryAlignment -
+        position % AlignedBinaryAlignment) % AlignedBinaryAlignment);
+    const char zeros[AlignedBinaryAlignment] = { 0 };
+    ar(padding);
+    ar(cereal::binary_data(zeros, padding));
+  }
+
+  ar(cereal::binary_data(mem, n_elem * sizeof(eT)));
+}
+
+//! Skip the padding before a memory block of an aligned binary archive.
+inline void SkipArmaPadding(BinaryInputArchive& ar)
+{
+  if (AlignedBinaryContext::For(&ar) == NULL)
+    return;
+
+  uint8_t padding;
+  char skipped[AlignedBinaryAlignment];
+  ar(padding);
+  if (padding >= AlignedBinaryAlignment)
+    throw Exception("Invalid padding in aligned binary archive!");
+  ar(cereal::binary_data(skipped, padding));
+}
+
+/**
+ * Load the given memory of an Armadillo object from a binary archive with a
+ * single read.
+ */
+template<typename eT>
+void SerializeArmaMemory(BinaryInputArchive& ar,
+                         eT* mem,
+                         const size_t n_elem,
+                         const char* /* name */)
+{
+  SkipArmaPadding(ar);
+  ar(cereal::binary_data(mem, n_elem * sizeof(eT)));
+}
+
+/**
+ * Make the given matrix alias its memory in the mapped file that the archive
+ * is read from, instead of loading it.  This is only possible with the aligned
+ * binary archives of data::MappedModel; false is returned otherwise.
+ */
+template<typename Archive, typename eT>
+bool AliasArmaMemory(Archive& /* ar */,
+                     arma::Mat<eT>& /* mat */,
+                     const arma::uword /* n_rows */,
+                     const arma::uword /* n_cols */)
+{
+  return false;
+}
+
+template<typename eT>
+bool AliasArmaMemory(BinaryInputArchive& ar,
+                     arma::Mat<eT>& mat,
+                     const arma::uword n_rows,
+                     const arma::uword n_cols)
+{
+  AlignedBinaryContext* context = AlignedBinaryContext::For(&ar);
+  if (context == NULL || context->mapped == NULL || n_rows * n_cols == 0)
+    return false;
+
+  SkipArmaPadding(ar);
+  const size_t bytes = n_rows * n_cols * sizeof(eT);
+  if (context->mapped->Remaining() < bytes)
+    throw Exception("Matrix extends past the end of the mapped archive!");
+
+  // The matrix takes the aliasing memory of the temporary matrix, so it can
+  // be resized (which makes it allocate its own memory) like any other matrix.
+  mat = arma::Mat<eT>((eT*) context->mapped->Current(), n_rows, n_cols, false,
+      false);
+  context->mapped->Skip(bytes);
+  return true;
+}
+
 /**
  * Add an external serialization function for SpMat.
  */
-namespace cereal {
 
 template<typename Archive, typename eT>
 void serialize(Archive& ar, arma::SpMat<eT>& mat)
@@ -51,12 +159,12 @@ void serialize(Archive& ar, arma::SpMat<eT>& mat)
   }
 
   // Serialize the values held in the sparse matrix.
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("value", arma::access::rw(mat.values[i])));
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("row_index", arma::access::rw(mat.row_indices[i])));
-  for (size_t i = 0; i < mat.n_cols + 1; ++i)
-    ar(cereal::make_nvp("col_ptr", arma::access::rw(mat.col_ptrs[i])));
+  SerializeArmaMemory(ar, arma::access::rwp(mat.values), mat.n_nonzero,
+      "value");
+  SerializeArmaMemory(ar, arma::access::rwp(mat.row_indices), mat.n_nonzero,
+      "row_index");
+  SerializeArmaMemory(ar, arma::access::rwp(mat.col_ptrs), mat.n_cols + 1,
+      "col_ptr");
 }
 
 // Add an external serialization function for Mat.
@@ -74,13 +182,18 @@ void serialize(Archive& ar, arma::Mat<eT>& mat)
 
   if (cereal::is_loading<Archive>())
   {
+    if (AliasArmaMemory(ar, mat, n_rows, n_cols))
+    {
+      arma::access::rw(mat.vec_state) = vec_state;
+      return;
+    }
+
     mat.set_size(n_rows, n_cols);
     arma::access::rw(mat.vec_state) = vec_state;
   }
 
   // Directly serialize the contents of the matrix's memory.
-  for (size_t i = 0; i < mat.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(mat.mem[i])));
+  SerializeArmaMemory(ar, mat.memptr(), mat.n_elem, "elem");
 }
 
 // Add a serialization function for armadillo Cube
@@ -100,8 +213,7 @@ void serialize(Archive& ar, arma::Cube<eT>& cube)
     cube.set_size(n_rows, n_cols, n_slices);
 
   // Directly serialize the contents of the cube's memory.
-  for (size_t i = 0; i < cube.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(cube.mem[i])));
+  SerializeArmaMemory(ar, cube.memptr(), cube.n_elem, "elem");
 }
 
 } // end namespace cereal
@@ -0,0 +1,150 @@
+/**
+ * @file core/cereal/aligned_binary.hpp
+ *
+ * Support for the aligned binary model format (data::format::aligned_binary),
+ * in which the memory of Armadillo objects is written in single blocks that
+ * start at 64-byte boundaries of the file, so that it can be read with a single
+ * call, or aliased by a memory-mapped file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_ALIGNED_BINARY_HPP
+#define MLPACK_CORE_CEREAL_ALIGNED_BINARY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+namespace cereal {
+
+//! The alignment of the Armadillo memory blocks in aligned binary files.
+static const size_t AlignedBinaryAlignment = 64;
+
+//! The size of the header of aligned binary files.
+static const size_t AlignedBinaryHeaderSize = 16;
+
+//! The header of aligned binary files: a magic string and the version.
+static const char AlignedBinaryHeader[AlignedBinaryHeaderSize] =
+    { 'M', 'L', 'P', 'A', 'C', 'K', 'A', 'B', 1, 0, 0, 0, 0, 0, 0, 0 };
+
+/**
+ * A read-only stream buffer over a memory-mapped aligned binary file.  The
+ * position in the buffer is the position in the file, so the memory blocks of
+ * Armadillo objects are aligned in memory as they are in the file and can be
+ * aliased instead of read.
+ */
+class AlignedBinaryBuffer : public std::streambuf
+{
+ public:
+  /**
+   * Create a buffer over the given memory, starting after the header.
+   *
+   * @param memory The mapped file.
+   * @param size The size of the mapped file.
+   */
+  AlignedBinaryBuffer(char* memory, const size_t size)
+  {
+    setg(memory, memory + std::min(size, AlignedBinaryHeaderSize),
+        memory + size);
+  }
+
+  //! Get the memory at the current position.
+  char* Current() const { return gptr(); }
+  //! Get the current position, from the start of the file.
+  size_t Position() const { return gptr() - eback(); }
+  //! Get the number of bytes after the current position.
+  size_t Remaining() const { return egptr() - gptr(); }
+  //! Move the current position forward by the given number of bytes.
+  void Skip(const size_t bytes) { setg(eback(), gptr() + bytes, egptr()); }
+};
+
+/**
+ * The state of the aligned binary archive that is being written or read, which
+ * the serialization functions of the Armadillo objects use to align their
+ * memory.  data::Save() and data::Load() set it, with AlignedBinaryScope, for
+ * the archives they create for format::aligned_binary; other binary archives
+ * are not affected.
+ */
+struct AlignedBinaryContext
+{
+  //! The archive that the context belongs to.
+  const void* archive;
+  //! The stream written to, or NULL when loading.
+  std::ostream* out;
+  //! The buffer over the mapped file, or NULL if the file is not mapped.
+  AlignedBinaryBuffer* mapped;
+
+  //! Get the context of the archive used by this thread, or NULL.
+  static AlignedBinaryContext*& Current()
+  {
+    static thread_local AlignedBinaryContext* current = NULL;
+    return current;
+  }
+
+  //! Get the context for the given archive, or NULL if it has none.
+  static AlignedBinaryContext* For(const void* archive)
+  {
+    AlignedBinaryContext* context = Current();
+    return (context != NULL && context->archive == archive) ? context : NULL;
+  }
+};
+
+/**
+ * Set the aligned binary context of this thread for the lifetime of the object.
+ */
+class AlignedBinaryScope
+{
+ public:
+  //! Set the context of the given archive.
+  AlignedBinaryScope(const void* archive,
+                     std::ostream* out,
+                     AlignedBinaryBuffer* mapped = NULL) :
+      previous(AlignedBinaryContext::Current())
+  {
+    context.archive = archive;
+    context.out = out;
+    context.mapped = mapped;
+    AlignedBinaryContext::Current() = &context;
+  }
+
+  //! Restore the previous context.
+  ~AlignedBinaryScope() { AlignedBinaryContext::Current() = previous; }
+
+ private:
+  //! The context.
+  AlignedBinaryContext context;
+  //! The context set before this one.
+  AlignedBinaryContext* previous;
+};
+
+//! Write the header of an aligned binary file.
+inline void WriteAlignedBinaryHeader(std::ostream& stream)
+{
+  stream.write(AlignedBinaryHeader, AlignedBinaryHeaderSize);
+}
+
+/**
+ * Read the header of an aligned binary file.  If the stream does not start
+ * with the header, it is rewound and false is returned.
+ */
+inline bool ReadAlignedBinaryHeader(std::istream& stream)
+{
+  char header[AlignedBinaryHeaderSize];
+  if (stream.read(header, AlignedBinaryHeaderSize) &&
+      std::memcmp(header, AlignedBinaryHeader, AlignedBinaryHeaderSize) == 0)
+    return true;
+
+  stream.clear();
+  stream.seekg(0);
+  return false;
+}
+
+} // namespace cereal
+
+#endif
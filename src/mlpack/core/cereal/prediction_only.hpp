@@ -0,0 +1,66 @@
+/**
+ * @file core/cereal/prediction_only.hpp
+ *
+ * Support for prediction-only loading of models, in which the state that is
+ * only needed to train a model further is not kept.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_PREDICTION_ONLY_HPP
+#define MLPACK_CORE_CEREAL_PREDICTION_ONLY_HPP
+
+#include <mlpack/core/cereal/is_loading.hpp>
+
+namespace cereal {
+
+/**
+ * Get whether the models loaded by this thread are loaded for prediction
+ * only.  data::Load() and data::MappedModel set this, with PredictionOnlyScope,
+ * when they are asked to.
+ */
+inline bool& PredictionOnlyFlag()
+{
+  static thread_local bool predictionOnly = false;
+  return predictionOnly;
+}
+
+/**
+ * Load the models of this thread for prediction only (or not) for the lifetime
+ * of the object.
+ */
+class PredictionOnlyScope
+{
+ public:
+  //! Set whether models are loaded for prediction only.
+  explicit PredictionOnlyScope(const bool predictionOnly) :
+      previous(PredictionOnlyFlag())
+  {
+    PredictionOnlyFlag() = predictionOnly;
+  }
+
+  //! Restore the previous setting.
+  ~PredictionOnlyScope() { PredictionOnlyFlag() = previous; }
+
+ private:
+  //! The setting before this one.
+  bool previous;
+};
+
+/**
+ * Get whether the given archive is loading a model for prediction only, in
+ * which case the serialize() functions may drop the members that are only
+ * needed for training.  The members must still be read from the archive, so
+ * that the file is the same whether it is loaded for prediction or not.
+ */
+template<typename Archive>
+bool IsPredictionOnly(const Archive& /* ar */)
+{
+  return is_loading<Archive>() && PredictionOnlyFlag();
+}
+
+} // namespace cereal
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file core/cereal/template_class_version.hpp
+ *
+ * A version of CEREAL_CLASS_VERSION() for class templates.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+#define MLPACK_CORE_CEREAL_TEMPLATE_CLASS_VERSION_HPP
+
+#include <cereal/details/helpers.hpp>
+#include <cereal/details/static_object.hpp>
+#include <typeindex>
+
+/**
+ * Remove the parentheses around the given arguments.
+ */
+#define CEREAL_TEMPLATE_UNPAREN(...) __VA_ARGS__
+
+/**
+ * CEREAL_CLASS_VERSION() only works for complete types; this macro sets the
+ * version of every instantiation of a class template.  Both the template
+ * signature and the type have to be given in parentheses, since they hold
+ * commas:
+ *
+ * @code
+ * CEREAL_TEMPLATE_CLASS_VERSION((template<typename T, typename U>),
+ *     (mlpack::Foo<T, U>), 1);
+ * @endcode
+ *
+ * The version is written in archives, and given to the serialize() function
+ * when an archive is loaded; archives that were written before the version was
+ * set have version 0.  The macro must be used outside of any namespace.
+ *
+ * @param SIGNATURE Template signature of the class, in parentheses.
+ * @param T Type of the class, in parentheses.
+ * @param VERSION Version of the class.
+ */
+#define CEREAL_TEMPLATE_CLASS_VERSION(SIGNATURE, T, VERSION) \
+namespace cereal { \
+namespace detail { \
+CEREAL_TEMPLATE_UNPAREN SIGNATURE \
+struct Version<CEREAL_TEMPLATE_UNPAREN T> \
+{ \
+  static const std::uint32_t version; \
+  static std::uint32_t registerVersion() \
+  { \
+    ::cereal::detail::StaticObject<Versions>::getInstance().mapping.emplace( \
+        std::type_index(typeid(CEREAL_TEMPLATE_UNPAREN T)).hash_code(), \
+        VERSION); \
+    return VERSION; \
+  } \
+  static void unused() { (void) version; } \
+}; \
+CEREAL_TEMPLATE_UNPAREN SIGNATURE \
+const std::uint32_t Version<CEREAL_TEMPLATE_UNPAREN T>::version = \
+    Version<CEREAL_TEMPLATE_UNPAREN T>::registerVersion(); \
+} /* namespace detail */ \
+} /* namespace cereal */
+
+#endif
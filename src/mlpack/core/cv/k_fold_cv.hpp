@@ -15,6 +15,9 @@
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
 
+#include <exception>
+#include <memory>
+
 namespace mlpack {
 namespace cv {
 
@@ -44,6 +47,12 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The training set of each fold is a contiguous block of the stored data, so
+ * it is passed to MLAlgorithm as an alias rather than a copy.  The folds can be
+ * trained at once by setting @c NumThreads() above 1; the training of
+ * MLAlgorithm must then be thread-safe (in particular, it should not draw
+ * random numbers).
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -168,6 +177,15 @@ class KFoldCV
           const WeightsType& weights,
           const bool shuffle = true);
 
+  /**
+   * Copy the given KFoldCV object.  The data is not copied but shared between
+   * the two objects (shuffling one of them gives it its own data), and the
+   * model from the last run is not copied.
+   *
+   * @param other KFoldCV object to copy.
+   */
+  KFoldCV(const KFoldCV& other);
+
   /**
    * Run k-fold cross-validation.
    *
@@ -180,6 +198,23 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the number of folds trained at once.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of folds trained at once.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the fraction of the training set of each fold the model is trained
+  //! on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction of the training set of each fold the model is trained
+   * on.  If it is less than 1, only the first points of each training set are
+   * used (at least one), so that cheap approximate evaluations can be run (for
+   * instance by the successive halving of HyperParameterTuner); the validation
+   * sets are not changed.  The default value is 1.
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,12 +244,15 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
-  MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
-  PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
-  WeightsType weights;
+  //! The extended (by repeating the first k - 2 bins) data points, shared with
+  //! the copies of this object.
+  std::shared_ptr<MatType> xs;
+  //! The extended (by repeating the first k - 2 bins) predictions, shared with
+  //! the copies of this object.
+  std::shared_ptr<PredictionsType> ys;
+  //! The extended (by repeating the first k - 2 bins) weights, shared with the
+  //! copies of this object.
+  std::shared_ptr<WeightsType> weights;
 
   //! The original size of the dataset.
   size_t lastBinSize;
@@ -225,6 +263,12 @@ class KFoldCV
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
+  //! The number of folds trained at once.
+  size_t numThreads;
+
+  //! The fraction of the training set of each fold the model is trained on.
+  double trainingFraction;
+
   /**
    * Assert the k parameter and data consistency and initialize fields required
    * for running k-fold cross-validation.
@@ -278,6 +322,12 @@ class KFoldCV
    */
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
+  /**
+   * Get the number of points of the ith training subset the model is trained
+   * on, given the fraction of the training set in use.
+   */
+  inline size_t TrainingSubsetSize(const size_t i) const;
+
   /**
    * Get the ith training subset from a variable of a matrix type.
    */
@@ -135,15 +135,20 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    xs(std::make_shared<MatType>()),
+    ys(std::make_shared<PredictionsType>()),
+    weights(std::make_shared<WeightsType>()),
+    numThreads(1),
+    trainingFraction(1.0)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
 
   Base::AssertDataConsistency(xs, ys);
 
-  InitKFoldCVMat(xs, this->xs);
-  InitKFoldCVMat(ys, this->ys);
+  InitKFoldCVMat(xs, *this->xs);
+  InitKFoldCVMat(ys, *this->ys);
 
   // Do we need to shuffle the dataset?
   if (shuffle)
@@ -166,19 +171,45 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    xs(std::make_shared<MatType>()),
+    ys(std::make_shared<PredictionsType>()),
+    weights(std::make_shared<WeightsType>()),
+    numThreads(1),
+    trainingFraction(1.0)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
-  InitKFoldCVMat(xs, this->xs);
-  InitKFoldCVMat(ys, this->ys);
-  InitKFoldCVMat(weights, this->weights);
+  InitKFoldCVMat(xs, *this->xs);
+  InitKFoldCVMat(ys, *this->ys);
+  InitKFoldCVMat(weights, *this->weights);
 
   // Do we need to shuffle the dataset?
   if (shuffle)
     Shuffle();
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+KFoldCV<MLAlgorithm,
+        Metric,
+        MatType,
+        PredictionsType,
+        WeightsType>::KFoldCV(const KFoldCV& other) :
+    base(other.base),
+    k(other.k),
+    xs(other.xs),
+    ys(other.ys),
+    weights(other.weights),
+    lastBinSize(other.lastBinSize),
+    binSize(other.binSize),
+    numThreads(other.numThreads),
+    trainingFraction(other.trainingFraction)
+{ /* Nothing left to do. */ }
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -191,6 +222,10 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
+  if (trainingFraction <= 0.0 || trainingFraction > 1.0)
+    throw std::invalid_argument("KFoldCV: the trainingFraction parameter "
+        "should be more than 0 and not more than 1");
+
   return TrainAndEvaluate(args...);
 }
 
@@ -246,13 +281,33 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
+  std::exception_ptr exception;
+  #pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+  {
+    try
+    {
+      MLAlgorithm&& model  = base.Train(GetTrainingSubset(*xs, i),
+          GetTrainingSubset(*ys, i), args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(*xs, i),
+          GetValidationSubset(*ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      // Exceptions cannot leave an OpenMP loop, so the exception of a
+      // failing fold is thrown again after the loop.
+      #pragma omp critical
+      exception = std::current_exception();
+    }
+  }
+  if (exception)
+    std::rethrow_exception(exception);
+
   size_t numInvalidScores = 0;
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -260,8 +315,6 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
   if (numInvalidScores == k)
@@ -288,18 +341,30 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  std::exception_ptr exception;
+  #pragma omp parallel for num_threads(numThreads) if (numThreads > 1)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    try
+    {
+      MLAlgorithm&& model = (weights->n_elem > 0) ?
+          base.Train(GetTrainingSubset(*xs, i), GetTrainingSubset(*ys, i),
+              GetTrainingSubset(*weights, i), args...) :
+          base.Train(GetTrainingSubset(*xs, i), GetTrainingSubset(*ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model, GetValidationSubset(*xs, i),
+          GetValidationSubset(*ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+    catch (...)
+    {
+      #pragma omp critical
+      exception = std::current_exception();
+    }
   }
+  if (exception)
+    std::rethrow_exception(exception);
 
   return arma::mean(evaluations);
 }
@@ -316,14 +381,17 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
+  MatType xsOrig = xs->cols(0, (k - 1) * binSize + lastBinSize - 1);
+  PredictionsType ysOrig = ys->cols(0, (k - 1) * binSize + lastBinSize - 1);
 
   // Now shuffle the data.
   math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
 
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  // The copies of this object keep the unshuffled data.
+  xs = std::make_shared<MatType>();
+  ys = std::make_shared<PredictionsType>();
+  InitKFoldCVMat(xsOrig, *xs);
+  InitKFoldCVMat(ysOrig, *ys);
 }
 
 template<typename MLAlgorithm,
@@ -338,22 +406,27 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
+  MatType xsOrig = xs->cols(0, (k - 1) * binSize + lastBinSize - 1);
+  PredictionsType ysOrig = ys->cols(0, (k - 1) * binSize + lastBinSize - 1);
   WeightsType weightsOrig;
-  if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
+  const bool hasWeights = (weights->n_elem > 0);
+  if (hasWeights)
+    weightsOrig = weights->cols(0, (k - 1) * binSize + lastBinSize - 1);
 
   // Now shuffle the data.
-  if (weights.n_elem > 0)
+  if (hasWeights)
     math::ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
   else
     math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
 
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
-  if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+  // The copies of this object keep the unshuffled data.
+  xs = std::make_shared<MatType>();
+  ys = std::make_shared<PredictionsType>();
+  weights = std::make_shared<WeightsType>();
+  InitKFoldCVMat(xsOrig, *xs);
+  InitKFoldCVMat(ysOrig, *ys);
+  if (hasWeights)
+    InitKFoldCVMat(weightsOrig, *weights);
 }
 
 template<typename MLAlgorithm,
@@ -371,6 +444,26 @@ size_t KFoldCV<MLAlgorithm,
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingSubsetSize(const size_t i) const
+{
+  // If this is not the first fold, we have to handle it a little bit
+  // differently, since the last fold may contain slightly more than 'binSize'
+  // points.
+  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+      (k - 1) * binSize;
+
+  return std::max((size_t) round(subsetSize * trainingFraction), (size_t) 1);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -385,11 +478,7 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t subsetSize = TrainingSubsetSize(i);
 
   return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
       false, true);
@@ -409,11 +498,7 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t subsetSize = TrainingSubsetSize(i);
 
   return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
 }
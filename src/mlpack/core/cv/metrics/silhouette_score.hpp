@@ -41,17 +41,24 @@ class SilhouetteScore
 {
  public:
   /**
-   * Find the overall silhouette score.
+   * Find the overall silhouette score.  If sampleSize is given, the score is
+   * estimated as the mean of the silhouette scores of sampleSize points drawn
+   * at random without replacement; the score of each drawn point is still
+   * computed exactly, from its distances to all the points.  This takes
+   * O(sampleSize * n) distance computations instead of O(n^2).
    *
    * @param X Column-major data used for clustering.
    * @param labels Labels assigned to data by clustering.
    * @param metric Metric to be used to calculate dissimilarity.
+   * @param sampleSize Number of points to estimate the score with; if 0 (or
+   *     at least the number of points), the exact score is computed.
    * @return (double) silhouette score.
    */
   template<typename DataType, typename Metric>
   static double Overall(const DataType& X,
                         const arma::Row<size_t>& labels,
-                        const Metric& metric);
+                        const Metric& metric,
+                        const size_t sampleSize = 0);
 
   /**
    * Find the individual silhouette scores for precomputted dissimilarites.
@@ -68,6 +75,10 @@ class SilhouetteScore
    * Find silhouette score of all individual elements.
    * (Distance not precomputed).
    *
+   * The distances are computed in tiles and summed per cluster on the fly, so
+   * the pairwise distance matrix is never stored, and the tiles are processed
+   * in parallel with OpenMP.
+   *
    * @param X Column-major data used for clustering.
    * @param labels Labels assigned to data by clustering.
    * @param metric Metric to be used to calculate dissimilarity.
@@ -97,6 +108,23 @@ class SilhouetteScore
    * to maximize the metric.
    */
   static const bool NeedsMinimization = false;
+
+ private:
+  /**
+   * Find the silhouette scores of the given points, from their distances to
+   * all the points.
+   *
+   * @param X Column-major data used for clustering.
+   * @param labels Labels assigned to data by clustering.
+   * @param metric Metric to be used to calculate dissimilarity.
+   * @param points Indices of the points to score.
+   * @return (arma::rowvec) silhouette score of each given point.
+   */
+  template<typename DataType, typename Metric>
+  static arma::rowvec PointsScore(const DataType& X,
+                                  const arma::Row<size_t>& labels,
+                                  const Metric& metric,
+                                  const arma::uvec& points);
 };
 
 } // namespace cv
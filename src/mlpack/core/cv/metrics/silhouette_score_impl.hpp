@@ -20,10 +20,15 @@ namespace cv {
 template<typename DataType, typename Metric>
 double SilhouetteScore::Overall(const DataType& X,
                                 const arma::Row<size_t>& labels,
-                                const Metric& metric)
+                                const Metric& metric,
+                                const size_t sampleSize)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::Overall()");
-  return arma::mean(SamplesScore(X, labels, metric));
+  if (sampleSize == 0 || sampleSize >= X.n_cols)
+    return arma::mean(SamplesScore(X, labels, metric));
+
+  const arma::uvec points = arma::randperm(X.n_cols, sampleSize);
+  return arma::mean(PointsScore(X, labels, metric, points));
 }
 
 template<typename DataType>
@@ -77,8 +82,91 @@ arma::rowvec SilhouetteScore::SamplesScore(const DataType& X,
                                            const Metric& metric)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::SamplesScore()");
-  DataType distances = PairwiseDistances(X, metric);
-  return SamplesScore(distances, labels);
+  if (X.n_cols == 0)
+    return arma::rowvec();
+
+  return PointsScore(X, labels, metric,
+      arma::regspace<arma::uvec>(0, X.n_cols - 1));
+}
+
+template<typename DataType, typename Metric>
+arma::rowvec SilhouetteScore::PointsScore(const DataType& X,
+                                          const arma::Row<size_t>& labels,
+                                          const Metric& metric,
+                                          const arma::uvec& points)
+{
+  // Map the labels to the indices of the clusters.
+  const arma::Row<size_t> uniqueLabels = arma::unique(labels);
+  const size_t numClusters = uniqueLabels.n_elem;
+  arma::Row<size_t> clusters(labels.n_elem);
+  arma::Col<size_t> clusterSizes(numClusters, arma::fill::zeros);
+  for (size_t j = 0; j < labels.n_elem; ++j)
+  {
+    clusters[j] = std::lower_bound(uniqueLabels.begin(), uniqueLabels.end(),
+        labels[j]) - uniqueLabels.begin();
+    ++clusterSizes[clusters[j]];
+  }
+
+  // The points are scored in tiles of tileSize points.  For each tile, the
+  // distances to all the points are summed per cluster; the points of the
+  // tile are reused for every point of the dataset, so they stay in cache.
+  const size_t tileSize = 256;
+  const size_t numTiles = (points.n_elem + tileSize - 1) / tileSize;
+  arma::rowvec scores(points.n_elem);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) numTiles; ++t)
+  {
+    const size_t first = (size_t) t * tileSize;
+    const size_t size = std::min(tileSize, points.n_elem - first);
+
+    arma::mat clusterSums(numClusters, size, arma::fill::zeros);
+    for (size_t j = 0; j < X.n_cols; ++j)
+    {
+      for (size_t i = 0; i < size; ++i)
+      {
+        if (points[first + i] != j)
+        {
+          clusterSums(clusters[j], i) += metric.Evaluate(
+              X.col(points[first + i]), X.col(j));
+        }
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+      const size_t cluster = clusters[points[first + i]];
+      if (clusterSizes[cluster] == 1)
+      {
+        // The point is the only element of its cluster.
+        scores[first + i] = 0.0;
+        continue;
+      }
+
+      const double intraClusterDistance = clusterSums(cluster, i) /
+          (clusterSizes[cluster] - 1);
+      if (intraClusterDistance == 0)
+      {
+        scores[first + i] = 0.0;
+        continue;
+      }
+
+      double minInterClusterDistance = DBL_MAX;
+      for (size_t c = 0; c < numClusters; ++c)
+      {
+        if (c != cluster)
+        {
+          minInterClusterDistance = std::min(minInterClusterDistance,
+              clusterSums(c, i) / clusterSizes[c]);
+        }
+      }
+
+      scores[first + i] = (minInterClusterDistance - intraClusterDistance) /
+          std::max(intraClusterDistance, minInterClusterDistance);
+    }
+  }
+
+  return scores;
 }
 
 double SilhouetteScore::MeanDistanceFromCluster(const arma::colvec& distances,
@@ -15,6 +15,8 @@
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/cv/cv_base.hpp>
 
+#include <memory>
+
 namespace mlpack {
 namespace cv {
 
@@ -198,6 +200,15 @@ class SimpleCV
            const size_t numClasses,
            WeightsInType&& weights);
 
+  /**
+   * Copy the given SimpleCV object.  The data is not copied but shared between
+   * the two objects, since it is never modified, and the model from the last
+   * run is not copied.
+   *
+   * @param other SimpleCV object to copy.
+   */
+  SimpleCV(const SimpleCV& other);
+
   /**
    * Train on the training set and assess performance on the validation set by
    * using the class Metric.
@@ -211,6 +222,17 @@ class SimpleCV
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
+  //! Get the fraction of the training set the model is trained on.
+  double TrainingFraction() const { return trainingFraction; }
+  /**
+   * Modify the fraction of the training set the model is trained on.  If it
+   * is less than 1, only the first points of the training set are used (at
+   * least one), so that cheap approximate evaluations can be run (for
+   * instance by the successive halving of HyperParameterTuner); the
+   * validation set is not changed.  The default value is 1.
+   */
+  double& TrainingFraction() { return trainingFraction; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -218,24 +240,19 @@ class SimpleCV
   //! An auxiliary object.
   Base base;
 
-  //! All input data points.
-  MatType xs;
-  //! All input predictions.
-  PredictionsType ys;
-  //! All input weights (optional).
-  WeightsType weights;
+  //! All input data points, shared with the copies of this object.
+  std::shared_ptr<MatType> xs;
+  //! All input predictions, shared with the copies of this object.
+  std::shared_ptr<PredictionsType> ys;
+  //! All input weights (optional), shared with the copies of this object.
+  std::shared_ptr<WeightsType> weights;
 
-  //! The training data points.
-  MatType trainingXs;
-  //! The training predictions.
-  PredictionsType trainingYs;
-  //! The training weights (optional).
-  WeightsType trainingWeights;
+  //! The number of training points; the training set is the first
+  //! trainingSize points, and the validation set is the rest.
+  size_t trainingSize;
 
-  //! The validation data points.
-  MatType validationXs;
-  //! The validation predictions.
-  PredictionsType validationYs;
+  //! The fraction of the training set the model is trained on.
+  double trainingFraction;
 
   //! The pointer to the last trained model.
   std::unique_ptr<MLAlgorithm> modelPtr;
@@ -269,6 +286,12 @@ class SimpleCV
    */
   size_t CalculateAndAssertNumberOfTrainingPoints(const double validationSize);
 
+  /**
+   * Get the number of points the model is trained on, given the fraction of
+   * the training set in use.
+   */
+  size_t NumTrainingPoints() const;
+
   /**
    * Get the specified submatrix without coping the data.
    */
@@ -142,19 +142,14 @@ SimpleCV<MLAlgorithm,
                                 MIT&& xs,
                                 PIT&& ys) :
     base(std::move(base)),
-    xs(std::forward<MIT>(xs)),
-    ys(std::forward<PIT>(ys))
+    xs(std::make_shared<MatType>(std::forward<MIT>(xs))),
+    ys(std::make_shared<PredictionsType>(std::forward<PIT>(ys))),
+    weights(std::make_shared<WeightsType>()),
+    trainingFraction(1.0)
 {
-  Base::AssertDataConsistency(this->xs, this->ys);
+  Base::AssertDataConsistency(*this->xs, *this->ys);
 
-  size_t numberOfTrainingPoints = CalculateAndAssertNumberOfTrainingPoints(
-      validationSize);
-
-  trainingXs = GetSubset(this->xs, 0, numberOfTrainingPoints - 1);
-  trainingYs = GetSubset(this->ys, 0, numberOfTrainingPoints - 1);
-
-  validationXs = GetSubset(this->xs, numberOfTrainingPoints, xs.n_cols - 1);
-  validationYs = GetSubset(this->ys, numberOfTrainingPoints, xs.n_cols - 1);
+  trainingSize = CalculateAndAssertNumberOfTrainingPoints(validationSize);
 }
 
 template<typename MLAlgorithm,
@@ -175,13 +170,29 @@ SimpleCV<MLAlgorithm,
     SimpleCV(std::move(base), validationSize, std::forward<MIT>(xs),
         std::forward<PIT>(ys))
 {
-  this->weights = std::forward<WIT>(weights);
+  this->weights = std::make_shared<WeightsType>(std::forward<WIT>(weights));
 
-  Base::AssertWeightsConsistency(this->xs, this->weights);
-
-  trainingWeights = GetSubset(this->weights, 0, trainingXs.n_cols - 1);
+  Base::AssertWeightsConsistency(*this->xs, *this->weights);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+SimpleCV<MLAlgorithm,
+         Metric,
+         MatType,
+         PredictionsType,
+         WeightsType>::SimpleCV(const SimpleCV& other) :
+    base(other.base),
+    xs(other.xs),
+    ys(other.ys),
+    weights(other.weights),
+    trainingSize(other.trainingSize),
+    trainingFraction(other.trainingFraction)
+{ /* Nothing left to do. */ }
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -194,6 +205,10 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
+  if (trainingFraction <= 0.0 || trainingFraction > 1.0)
+    throw std::invalid_argument("SimpleCV: the trainingFraction parameter "
+        "should be more than 0 and not more than 1");
+
   return TrainAndEvaluate(args...);
 }
 
@@ -231,18 +246,33 @@ size_t SimpleCV<MLAlgorithm,
     throw std::invalid_argument("SimpleCV: the validationSize parameter should "
         "be more than 0 and less than 1");
 
-  if (xs.n_cols < 2)
+  if (xs->n_cols < 2)
     throw std::invalid_argument("SimpleCV: 2 or more data points are expected");
 
-  size_t trainingPoints = round(xs.n_cols * (1.0 - validationSize));
+  size_t trainingPoints = round(xs->n_cols * (1.0 - validationSize));
 
-  if (trainingPoints == 0 || trainingPoints == xs.n_cols)
+  if (trainingPoints == 0 || trainingPoints == xs->n_cols)
     throw std::invalid_argument("SimpleCV: the validationSize parameter is "
         "either too small or too big");
 
   return trainingPoints;
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::NumTrainingPoints() const
+{
+  const size_t trainingPoints = round(trainingSize * trainingFraction);
+  return std::max(trainingPoints, (size_t) 1);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -293,9 +323,14 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  // The training and validation sets are aliases of the stored data.
+  const size_t numTraining = NumTrainingPoints();
+  modelPtr.reset(new MLAlgorithm(base.Train(
+      GetSubset(*xs, 0, numTraining - 1),
+      GetSubset(*ys, 0, numTraining - 1), args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*modelPtr, GetSubset(*xs, trainingSize,
+      xs->n_cols - 1), GetSubset(*ys, trainingSize, xs->n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -310,14 +345,20 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
-  if (trainingWeights.n_elem > 0)
+  // The training and validation sets are aliases of the stored data.
+  const size_t numTraining = NumTrainingPoints();
+  if (weights->n_elem > 0)
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+        base.Train(GetSubset(*xs, 0, numTraining - 1),
+            GetSubset(*ys, 0, numTraining - 1),
+            GetSubset(*weights, 0, numTraining - 1), args...)));
   else
     modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+        base.Train(GetSubset(*xs, 0, numTraining - 1),
+            GetSubset(*ys, 0, numTraining - 1), args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*modelPtr, GetSubset(*xs, trainingSize,
+      xs->n_cols - 1), GetSubset(*ys, trainingSize, xs->n_cols - 1));
 }
 
 } // namespace cv
@@ -0,0 +1,174 @@
+/**
+ * @file core/data/block_writer.hpp
+ *
+ * Definition of the BlockWriter class, which writes a matrix to a binary file
+ * in blocks of columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BLOCK_WRITER_HPP
+#define MLPACK_CORE_DATA_BLOCK_WRITER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <exception>
+#include <thread>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A BlockWriter writes a matrix to an Armadillo binary or raw binary file in
+ * blocks of points (columns), which is the counterpart of DataStream: the
+ * matrix never has to be held in memory at once (or transposed at once), and
+ * each block is written on a background thread while the caller computes or
+ * converts the next one.
+ *
+ * @code
+ * data::BlockWriter<> writer("output.bin", dimensionality, numPoints);
+ * for (size_t i = 0; i < numPoints; i += 10000)
+ * {
+ *   arma::mat block = ...; // Compute the next (up to) 10000 points.
+ *   writer.Write(block);
+ * }
+ * writer.Finish();
+ * @endcode
+ *
+ * Like data::Save(), the file holds one point per row by default (transpose is
+ * true), so data::Load() and DataStream read it back as the original matrix.
+ * The blocks are converted to eT before they are written, so, for instance, a
+ * BlockWriter<uint32_t> stores a matrix of size_t indices with half the space;
+ * such a file has to be loaded into a matrix of the same element type.
+ *
+ * @tparam eT Element type of the file.
+ */
+template<typename eT = double>
+class BlockWriter
+{
+ public:
+  /**
+   * Create the given file for a matrix of the given size.  A
+   * std::runtime_error is thrown if the file can't be created, and a
+   * std::invalid_argument if the format isn't a binary format.
+   *
+   * @param filename Name of the file to write.
+   * @param nRows Dimensionality of the points.
+   * @param nCols Number of points.
+   * @param transpose Whether the file holds one point per row (default true).
+   * @param type Format of the file: arma::arma_binary, arma::raw_binary, or
+   *     arma::auto_detect to detect it from the extension of the filename.
+   * @param writeBehind Whether to write each block on a background thread.
+   */
+  BlockWriter(const std::string& filename,
+              const size_t nRows,
+              const size_t nCols,
+              const bool transpose = true,
+              const arma::file_type type = arma::auto_detect,
+              const bool writeBehind = true);
+
+  //! Copying is not allowed, since the writer owns its background thread.
+  BlockWriter(const BlockWriter& other) = delete;
+  //! Copying is not allowed, since the writer owns its background thread.
+  BlockWriter& operator=(const BlockWriter& other) = delete;
+
+  //! Wait for the background thread and close the file.  If Finish() wasn't
+  //! called, the file may be incomplete.
+  ~BlockWriter();
+
+  /**
+   * Write the next block of points.  The block is converted to eT first, and
+   * written once the previous block has been written.  An exception is thrown
+   * if the block doesn't have nRows rows, if there are more than nCols points,
+   * or if the previous block couldn't be written.
+   *
+   * @param block Points to write (any Armadillo matrix expression).
+   */
+  template<typename MatType>
+  void Write(const MatType& block);
+
+  /**
+   * Wait for the last block to be written and close the file.  An exception
+   * is thrown if the file couldn't be written or if fewer than nCols points
+   * were given.
+   */
+  void Finish();
+
+  //! Get the dimensionality of the points.
+  size_t NumRows() const { return nRows; }
+  //! Get the number of points of the matrix.
+  size_t NumCols() const { return nCols; }
+  //! Get the number of points given to Write() so far.
+  size_t Position() const { return position; }
+
+ private:
+  //! Write the pending block to the file.
+  void WriteBlock();
+  //! Write the pending block; this runs on the background thread.
+  void WriteBehind();
+  //! Wait for the background thread, and rethrow its error, if any.
+  void Wait();
+
+  //! The name of the file.
+  std::string filename;
+  //! The dimensionality of the points.
+  size_t nRows;
+  //! The number of points.
+  size_t nCols;
+  //! Whether the file holds one point per row.
+  bool transpose;
+  //! Whether to write the blocks on a background thread.
+  bool writeBehind;
+  //! Whether Finish() was called.
+  bool finished;
+
+  //! The stream of the file.
+  std::ofstream stream;
+  //! The offset of the data of the file (after its header).
+  std::streamoff dataOffset;
+  //! The number of points given to Write().
+  size_t position;
+
+  //! The block that is being written.
+  arma::Mat<eT> pending;
+  //! The index of the first point of the pending block.
+  size_t pendingPosition;
+  //! The buffer for the transposed block of a file that holds one point per
+  //! row.
+  arma::Mat<eT> transposeBuffer;
+
+  //! The thread that writes the pending block.
+  std::thread worker;
+  //! The error given while writing the pending block, if any.
+  std::exception_ptr error;
+};
+
+/**
+ * Save a matrix to a binary file with a BlockWriter, converting its elements
+ * to OutElemType; the matrix is copied and converted one block at a time, so
+ * no transposed or converted copy of the whole matrix is made.  Exceptions are
+ * thrown like BlockWriter throws them.
+ *
+ * @param filename Name of the file to write.
+ * @param matrix Matrix to save.
+ * @param transpose Whether the file holds one point per row (default true).
+ * @param type Format of the file (see BlockWriter).
+ * @param blockSize Number of points of each block; 0 chooses blocks of about
+ *     a million elements.
+ */
+template<typename OutElemType, typename eT>
+void SaveInBlocks(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const bool transpose = true,
+                  const arma::file_type type = arma::auto_detect,
+                  const size_t blockSize = 0);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "block_writer_impl.hpp"
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ * @file core/data/block_writer_impl.hpp
+ *
+ * Implementation of the BlockWriter class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BLOCK_WRITER_IMPL_HPP
+#define MLPACK_CORE_DATA_BLOCK_WRITER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "block_writer.hpp"
+
+#include "detect_file_type.hpp"
+// For details::ArmaBinaryTypeCode().
+#include "data_stream.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+BlockWriter<eT>::BlockWriter(const std::string& filename,
+                             const size_t nRows,
+                             const size_t nCols,
+                             const bool transpose,
+                             const arma::file_type type,
+                             const bool writeBehind) :
+    filename(filename),
+    nRows(nRows),
+    nCols(nCols),
+    transpose(transpose),
+    writeBehind(writeBehind),
+    finished(false),
+    dataOffset(0),
+    position(0),
+    pendingPosition(0)
+{
+  const arma::file_type fileType = (type == arma::auto_detect) ?
+      DetectFromExtension(filename) : type;
+  if (fileType != arma::arma_binary && fileType != arma::raw_binary)
+  {
+    throw std::invalid_argument("BlockWriter::BlockWriter(): '" + filename +
+        "' must be an Armadillo binary or raw binary file!");
+  }
+
+  stream.open(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("BlockWriter::BlockWriter(): cannot open file '" +
+        filename + "' for writing!");
+  }
+
+  // The header is "ARMA_MAT_BIN_<type code>\n<rows> <cols>\n", like Armadillo
+  // writes it.
+  if (fileType == arma::arma_binary)
+  {
+    stream << "ARMA_MAT_BIN_" << details::ArmaBinaryTypeCode<eT>() << '\n'
+        << (transpose ? nCols : nRows) << ' ' << (transpose ? nRows : nCols)
+        << '\n';
+  }
+
+  dataOffset = stream.tellp();
+  if (!stream)
+  {
+    throw std::runtime_error("BlockWriter::BlockWriter(): cannot write to '" +
+        filename + "'!");
+  }
+}
+
+template<typename eT>
+BlockWriter<eT>::~BlockWriter()
+{
+  if (worker.joinable())
+    worker.join();
+}
+
+template<typename eT>
+template<typename MatType>
+void BlockWriter<eT>::Write(const MatType& block)
+{
+  if (finished)
+  {
+    throw std::runtime_error("BlockWriter::Write(): Finish() was already "
+        "called!");
+  }
+  if (block.n_rows != nRows)
+  {
+    std::ostringstream oss;
+    oss << "BlockWriter::Write(): the block has " << block.n_rows << " rows, "
+        << "but the points have " << nRows << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (position + block.n_cols > nCols)
+  {
+    std::ostringstream oss;
+    oss << "BlockWriter::Write(): the block would make " << position +
+        block.n_cols << " points, but the matrix has " << nCols << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Convert the block while the previous one is written.
+  arma::Mat<eT> converted = arma::conv_to<arma::Mat<eT>>::from(block);
+
+  Wait();
+  pending.swap(converted);
+  pendingPosition = position;
+  position += pending.n_cols;
+
+  if (writeBehind)
+    worker = std::thread(&BlockWriter::WriteBehind, this);
+  else
+    WriteBlock();
+}
+
+template<typename eT>
+void BlockWriter<eT>::Finish()
+{
+  if (finished)
+    return;
+
+  Wait();
+  if (position != nCols)
+  {
+    std::ostringstream oss;
+    oss << "BlockWriter::Finish(): only " << position << " of the " << nCols
+        << " points were written to '" << filename << "'!";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.close();
+  finished = true;
+  if (!stream)
+  {
+    throw std::runtime_error("BlockWriter::Finish(): cannot write to '" +
+        filename + "'!");
+  }
+}
+
+template<typename eT>
+void BlockWriter<eT>::WriteBlock()
+{
+  if (!transpose)
+  {
+    // The points are stored one after the other.
+    stream.seekp(dataOffset + std::streamoff(pendingPosition * nRows *
+        sizeof(eT)));
+    stream.write((const char*) pending.memptr(), pending.n_elem * sizeof(eT));
+  }
+  else
+  {
+    // The file holds the transposed matrix, so each dimension of the block is
+    // a contiguous segment of the file.
+    transposeBuffer = arma::trans(pending);
+    for (size_t r = 0; r < nRows; ++r)
+    {
+      stream.seekp(dataOffset + std::streamoff((r * nCols + pendingPosition) *
+          sizeof(eT)));
+      stream.write((const char*) transposeBuffer.colptr(r),
+          pending.n_cols * sizeof(eT));
+    }
+  }
+
+  if (!stream)
+  {
+    throw std::runtime_error("BlockWriter::Write(): cannot write to '" +
+        filename + "'!");
+  }
+}
+
+template<typename eT>
+void BlockWriter<eT>::WriteBehind()
+{
+  try
+  {
+    WriteBlock();
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+}
+
+template<typename eT>
+void BlockWriter<eT>::Wait()
+{
+  if (worker.joinable())
+    worker.join();
+
+  if (error)
+  {
+    std::exception_ptr e = error;
+    error = std::exception_ptr();
+    std::rethrow_exception(e);
+  }
+}
+
+template<typename OutElemType, typename eT>
+void SaveInBlocks(const std::string& filename,
+                  const arma::Mat<eT>& matrix,
+                  const bool transpose,
+                  const arma::file_type type,
+                  const size_t blockSize)
+{
+  const size_t pointsPerBlock = (blockSize > 0) ? blockSize :
+      std::max(size_t(1), size_t(1 << 20) / std::max(size_t(1),
+      (size_t) matrix.n_rows));
+
+  BlockWriter<OutElemType> writer(filename, matrix.n_rows, matrix.n_cols,
+      transpose, type);
+  for (size_t i = 0; i < matrix.n_cols; i += pointsPerBlock)
+  {
+    const size_t end = std::min(i + pointsPerBlock, (size_t) matrix.n_cols);
+    writer.Write(matrix.cols(i, end - 1));
+  }
+  writer.Finish();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
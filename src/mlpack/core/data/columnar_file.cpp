@@ -0,0 +1,117 @@
+/**
+ * @file core/data/columnar_file.cpp
+ *
+ * Implementation of the block compression used by ColumnarFile: the bytes of
+ * the elements are grouped by position and then run-length encoded.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "columnar_file.hpp"
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+// The encoding is a sequence of runs, each starting with a control byte c.  If
+// c < 128, it is followed by c + 1 literal bytes; otherwise, it is followed by
+// one byte that is repeated c - 125 times (so, 3 to 130 times).
+static const size_t maxLiteralRun = 128;
+static const size_t minRepeatRun = 3;
+static const size_t maxRepeatRun = 130;
+
+void CompressColumnarBlock(const char* data,
+                           const size_t size,
+                           const size_t elemSize,
+                           std::vector<char>& compressed)
+{
+  // Group byte j of every element together.
+  const size_t numElems = size / elemSize;
+  std::vector<char> shuffled(size);
+  for (size_t i = 0; i < numElems; ++i)
+    for (size_t j = 0; j < elemSize; ++j)
+      shuffled[j * numElems + i] = data[i * elemSize + j];
+
+  compressed.clear();
+  const char* s = shuffled.data();
+  size_t i = 0;
+  while (i < size)
+  {
+    size_t run = 1;
+    while (i + run < size && run < maxRepeatRun && s[i + run] == s[i])
+      ++run;
+
+    if (run >= minRepeatRun)
+    {
+      compressed.push_back((char) (run + 125));
+      compressed.push_back(s[i]);
+      i += run;
+      continue;
+    }
+
+    // Collect literal bytes until the next run of repeated bytes.
+    const size_t start = i;
+    size_t length = 0;
+    while (i < size && length < maxLiteralRun)
+    {
+      if (i + 2 < size && s[i] == s[i + 1] && s[i] == s[i + 2])
+        break;
+      ++i;
+      ++length;
+    }
+
+    compressed.push_back((char) (length - 1));
+    compressed.insert(compressed.end(), s + start, s + start + length);
+  }
+}
+
+bool DecompressColumnarBlock(const char* compressed,
+                             const size_t compressedSize,
+                             const size_t elemSize,
+                             char* data,
+                             const size_t size)
+{
+  std::vector<char> shuffled(size);
+  size_t in = 0;
+  size_t out = 0;
+  while (in < compressedSize)
+  {
+    const unsigned char control = (unsigned char) compressed[in++];
+    if (control < maxLiteralRun)
+    {
+      const size_t length = control + 1;
+      if (length > compressedSize - in || length > size - out)
+        return false;
+
+      std::memcpy(shuffled.data() + out, compressed + in, length);
+      in += length;
+      out += length;
+    }
+    else
+    {
+      const size_t length = control - 125;
+      if (in == compressedSize || length > size - out)
+        return false;
+
+      std::memset(shuffled.data() + out, compressed[in++], length);
+      out += length;
+    }
+  }
+
+  if (out != size)
+    return false;
+
+  // Put the bytes of each element back together.
+  const size_t numElems = size / elemSize;
+  for (size_t i = 0; i < numElems; ++i)
+    for (size_t j = 0; j < elemSize; ++j)
+      data[i * elemSize + j] = shuffled[j * numElems + i];
+
+  return true;
+}
+
+} // namespace details
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,281 @@
+/**
+ * @file core/data/columnar_file.hpp
+ *
+ * Definition of the ColumnarFile class, which reads and writes mlpack's native
+ * binary dataset format.  The format holds a matrix together with the
+ * DatasetMapper that describes it, and can be memory-mapped and used without
+ * copying.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMNAR_FILE_HPP
+#define MLPACK_CORE_DATA_COLUMNAR_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * Compress a block of elements of the given size.  The bytes are first grouped
+ * by their position in each element (so that the bytes that differ little
+ * between elements, such as the exponents of floating-point values or the high
+ * bytes of integers, form long runs), and then run-length encoded.
+ *
+ * @param data Block to compress.
+ * @param size Size of the block, in bytes; a multiple of elemSize.
+ * @param elemSize Size of each element, in bytes.
+ * @param compressed Set to the compressed block.
+ */
+void CompressColumnarBlock(const char* data,
+                           const size_t size,
+                           const size_t elemSize,
+                           std::vector<char>& compressed);
+
+/**
+ * Decompress a block compressed by CompressColumnarBlock().
+ *
+ * @param compressed Compressed block.
+ * @param compressedSize Size of the compressed block, in bytes.
+ * @param elemSize Size of each element, in bytes.
+ * @param data Location to decompress the block to.
+ * @param size Size of the decompressed block, in bytes.
+ * @return false if the compressed block is corrupt.
+ */
+bool DecompressColumnarBlock(const char* compressed,
+                             const size_t compressedSize,
+                             const size_t elemSize,
+                             char* data,
+                             const size_t size);
+
+} // namespace details
+
+/**
+ * The ColumnarFile class gives access to a matrix stored in mlpack's native
+ * binary dataset format (with the extension .mlbin), as written by
+ * ColumnarFile::Save() or data::Save().  The file holds a header with the size
+ * and element type of the matrix, the serialized DatasetMapper of the dataset
+ * (if one was saved), and the columns of the matrix in blocks that start at
+ * 64-byte boundaries.  Each block may be compressed.
+ *
+ * Opening the file memory-maps it.  If the file is not compressed, Matrix()
+ * is an Armadillo matrix that aliases the mapped memory, so the data is never
+ * read or copied until it is used and the pages can be shared between
+ * processes; otherwise, Matrix() decompresses the blocks the first time it is
+ * called.  LoadColumns() reads only the blocks that hold the requested
+ * columns.  The mapping is private: modifying Matrix() never modifies the
+ * file.
+ *
+ * The matrix is stored in the orientation mlpack uses, with one point per
+ * column, so that the categorical mappings of the DatasetMapper refer to the
+ * rows of the matrix.
+ *
+ * @code
+ * arma::mat dataset;
+ * data::DatasetInfo info;
+ * data::Load("dataset.csv", dataset, info);
+ * data::ColumnarFile<double>::Save("dataset.mlbin", dataset, info);
+ *
+ * // Later, without parsing the CSV again.
+ * data::ColumnarFile<double> file("dataset.mlbin");
+ * file.LoadInfo(info);
+ * const arma::mat& mapped = file.Matrix();
+ * @endcode
+ *
+ * Files are written in the byte order of the machine, and can only be read on
+ * a machine with the same byte order.  The element type of the file must match
+ * the element type of the ColumnarFile.
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class ColumnarFile
+{
+ public:
+  /**
+   * Map the dataset stored in the given file.  A std::runtime_error is thrown
+   * if the file can't be opened or mapped, or if it doesn't hold a valid
+   * dataset with elements of type eT.
+   *
+   * @param filename File to map.
+   */
+  ColumnarFile(const std::string& filename);
+
+  //! Copying is not allowed, since the object owns the mapping.
+  ColumnarFile(const ColumnarFile& other) = delete;
+  //! Copying is not allowed, since the object owns the mapping.
+  ColumnarFile& operator=(const ColumnarFile& other) = delete;
+
+  /**
+   * Release the mapping; any matrix returned by Matrix() becomes invalid.
+   */
+  ~ColumnarFile();
+
+  /**
+   * Save the given matrix to the given file.  A std::runtime_error is thrown if
+   * the file can't be written.
+   *
+   * @param filename File to save to.
+   * @param matrix Matrix to save, with one point per column.
+   * @param compress Whether to compress the blocks of the file; compressed
+   *     files can't be memory-mapped without copying.
+   */
+  static void Save(const std::string& filename,
+                   const arma::Mat<eT>& matrix,
+                   const bool compress = false);
+
+  /**
+   * Save the given matrix and the DatasetMapper that describes it to the given
+   * file.  A std::runtime_error is thrown if the file can't be written.
+   *
+   * @param filename File to save to.
+   * @param matrix Matrix to save, with one point per column.
+   * @param info DatasetMapper of the matrix.
+   * @param compress Whether to compress the blocks of the file; compressed
+   *     files can't be memory-mapped without copying.
+   */
+  template<typename PolicyType>
+  static void Save(const std::string& filename,
+                   const arma::Mat<eT>& matrix,
+                   const DatasetMapper<PolicyType>& info,
+                   const bool compress = false);
+
+  //! Get the number of rows (dimensions) of the matrix.
+  size_t NumRows() const { return nRows; }
+  //! Get the number of columns (points) of the matrix.
+  size_t NumCols() const { return nCols; }
+  //! Get whether the file is compressed (so Matrix() has to copy).
+  bool IsCompressed() const { return compressed; }
+  //! Get whether the file holds a DatasetMapper.
+  bool HasInfo() const { return infoSize > 0; }
+
+  /**
+   * Get the matrix.  If the file is not compressed, this aliases the mapped
+   * memory; otherwise, the file is decompressed the first time this is called.
+   * The matrix is valid as long as the ColumnarFile exists.
+   */
+  arma::Mat<eT>& Matrix();
+
+  /**
+   * Copy the matrix into the given matrix.
+   *
+   * @param output Matrix to store the dataset in.
+   */
+  void Load(arma::Mat<eT>& output) const;
+
+  /**
+   * Copy the given columns of the matrix into the given matrix, reading only
+   * the blocks that hold them.  A std::invalid_argument is thrown if a column
+   * index is out of bounds.
+   *
+   * @param columns Indices of the columns to read, in the order to store them.
+   * @param output Matrix to store the columns in.
+   */
+  void LoadColumns(const arma::uvec& columns, arma::Mat<eT>& output) const;
+
+  /**
+   * Get the DatasetMapper saved with the matrix.  A std::runtime_error is
+   * thrown if the file doesn't hold one, or if it can't be read as a
+   * DatasetMapper with the given policy.
+   *
+   * @param info DatasetMapper to store the mappings in.
+   */
+  template<typename PolicyType>
+  void LoadInfo(DatasetMapper<PolicyType>& info) const;
+
+ private:
+  //! The header at the start of the file.
+  struct FileHeader
+  {
+    //! Identifies the file type.
+    char magic[8];
+    //! Version of the layout.
+    uint64_t version;
+    //! Identifies the element type of the matrix.
+    uint64_t elemType;
+    //! Number of rows of the matrix.
+    uint64_t nRows;
+    //! Number of columns of the matrix.
+    uint64_t nCols;
+    //! Number of columns in each block (except possibly the last one).
+    uint64_t colsPerBlock;
+    //! Number of blocks.
+    uint64_t numBlocks;
+    //! Whether any block is compressed.
+    uint64_t compressed;
+    //! Offset of the serialized DatasetMapper in the file.
+    uint64_t infoOffset;
+    //! Size of the serialized DatasetMapper (0 if there is none).
+    uint64_t infoSize;
+    //! Offset of the block records in the file.
+    uint64_t blockOffset;
+    //! Total size of the file.
+    uint64_t fileSize;
+  };
+
+  //! The record of each block of columns.
+  struct BlockRecord
+  {
+    //! Offset of the block in the file.
+    uint64_t offset;
+    //! Size of the block in the file.
+    uint64_t storedSize;
+    //! Whether the block is compressed.
+    uint64_t compressed;
+  };
+
+  //! Save the matrix with the given serialized DatasetMapper.
+  static void WriteFile(const std::string& filename,
+                        const arma::Mat<eT>& matrix,
+                        const std::string& info,
+                        const bool compress);
+
+  //! Check the header and block records of the mapped file.
+  void ReadLayout(const std::string& filename);
+
+  //! Decode the given block into the given memory; returns false if the block
+  //! is corrupt.
+  bool ReadBlock(const size_t block, eT* output) const;
+
+  //! Get the number of columns in the given block.
+  size_t BlockCols(const size_t block) const;
+
+  //! Release the mapped memory.
+  void Unmap();
+
+  //! The mapped memory.
+  char* memory;
+  //! The size of the mapped memory.
+  size_t memorySize;
+  //! Whether the memory is a real mapping (or a plain copy of the file).
+  bool isMapped;
+  //! The number of rows of the matrix.
+  size_t nRows;
+  //! The number of columns of the matrix.
+  size_t nCols;
+  //! The number of columns in each block.
+  size_t colsPerBlock;
+  //! Whether any block is compressed.
+  bool compressed;
+  //! The offset of the serialized DatasetMapper.
+  size_t infoOffset;
+  //! The size of the serialized DatasetMapper.
+  size_t infoSize;
+  //! The records of the blocks.
+  std::vector<BlockRecord> blocks;
+  //! The matrix returned by Matrix() (NULL until it is needed).
+  arma::Mat<eT>* matrix;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "columnar_file_impl.hpp"
+
+#endif
@@ -0,0 +1,533 @@
+/**
+ * @file core/data/columnar_file_impl.hpp
+ *
+ * Implementation of the ColumnarFile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_COLUMNAR_FILE_IMPL_HPP
+#define MLPACK_CORE_DATA_COLUMNAR_FILE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "columnar_file.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <cereal/archives/binary.hpp>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+// The magic string at the start of every file.
+static const char columnarFileMagic[8] = { 'M', 'L', 'P', 'K', 'D', 'A', 'T',
+    'A' };
+
+// The alignment of each section and block of the file.
+static const size_t columnarFileAlignment = 64;
+
+// The approximate size of each block of columns, in bytes.
+static const size_t columnarBlockSize = 1 << 20;
+
+namespace details {
+
+//! Identify an element type by its kind and size.
+template<typename eT>
+uint64_t ColumnarElemType()
+{
+  const uint64_t kind = !std::is_arithmetic<eT>::value ? 4 :
+      std::is_floating_point<eT>::value ? 1 :
+      std::is_signed<eT>::value ? 2 : 3;
+  return (kind << 8) | sizeof(eT);
+}
+
+//! Round the given offset up to the alignment of the file.
+inline uint64_t ColumnarAlign(const uint64_t offset)
+{
+  return ((offset + columnarFileAlignment - 1) / columnarFileAlignment) *
+      columnarFileAlignment;
+}
+
+} // namespace details
+
+template<typename eT>
+ColumnarFile<eT>::ColumnarFile(const std::string& filename) :
+    memory(NULL),
+    memorySize(0),
+    isMapped(false),
+    nRows(0),
+    nCols(0),
+    colsPerBlock(1),
+    compressed(false),
+    infoOffset(0),
+    infoSize(0),
+    matrix(NULL)
+{
+#if !defined(_WIN32)
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): cannot open file '"
+        + filename + "'!");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): cannot get size of "
+        "file '" + filename + "'!");
+  }
+  memorySize = (size_t) fileStat.st_size;
+
+  // The mapping is private and writable, so the matrix can be used like any
+  // other matrix; pages are only copied if they are written to.
+  void* address = (memorySize == 0) ? MAP_FAILED : mmap(NULL, memorySize,
+      PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): cannot map file '"
+        + filename + "'!");
+  }
+
+  memory = (char*) address;
+  isMapped = true;
+#else
+  // There is no mmap(); read the whole file instead.
+  std::ifstream f(filename, std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+  {
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): cannot open file '"
+        + filename + "'!");
+  }
+
+  memorySize = (size_t) f.tellg();
+  f.seekg(0);
+  memory = (char*) std::malloc(memorySize);
+  if (!memory || !f.read(memory, memorySize))
+  {
+    Unmap();
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): cannot read file '"
+        + filename + "'!");
+  }
+#endif
+
+  try
+  {
+    ReadLayout(filename);
+  }
+  catch (...)
+  {
+    Unmap();
+    throw;
+  }
+}
+
+template<typename eT>
+ColumnarFile<eT>::~ColumnarFile()
+{
+  // The matrix may alias the mapped memory, so it has to go first.
+  delete matrix;
+  Unmap();
+}
+
+template<typename eT>
+void ColumnarFile<eT>::Save(const std::string& filename,
+                            const arma::Mat<eT>& matrix,
+                            const bool compress)
+{
+  WriteFile(filename, matrix, std::string(), compress);
+}
+
+template<typename eT>
+template<typename PolicyType>
+void ColumnarFile<eT>::Save(const std::string& filename,
+                            const arma::Mat<eT>& matrix,
+                            const DatasetMapper<PolicyType>& info,
+                            const bool compress)
+{
+  if (info.Dimensionality() != matrix.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ColumnarFile::Save(): dimensionality of DatasetMapper ("
+        << info.Dimensionality() << ") does not match the number of rows of "
+        << "the matrix (" << matrix.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  std::ostringstream stream;
+  {
+    cereal::BinaryOutputArchive ar(stream);
+    ar(cereal::make_nvp("info", info));
+  }
+
+  WriteFile(filename, matrix, stream.str(), compress);
+}
+
+template<typename eT>
+arma::Mat<eT>& ColumnarFile<eT>::Matrix()
+{
+  if (!matrix)
+  {
+    if (!compressed && !blocks.empty())
+    {
+      // The blocks of an uncompressed file are contiguous, so the matrix can
+      // alias them directly.
+      matrix = new arma::Mat<eT>((eT*) (memory + blocks[0].offset), nRows,
+          nCols, false, true);
+    }
+    else
+    {
+      matrix = new arma::Mat<eT>();
+      Load(*matrix);
+    }
+  }
+
+  return *matrix;
+}
+
+template<typename eT>
+void ColumnarFile<eT>::Load(arma::Mat<eT>& output) const
+{
+  output.set_size(nRows, nCols);
+
+  // Blocks are independent, so they can be decompressed in parallel.  Errors
+  // can't be thrown from inside the loop.
+  std::vector<char> blockFailed(blocks.size(), 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks.size(); ++b)
+    blockFailed[b] = !ReadBlock(b, output.colptr(b * colsPerBlock));
+
+  for (size_t b = 0; b < blocks.size(); ++b)
+  {
+    if (blockFailed[b])
+    {
+      output.reset();
+      throw std::runtime_error("ColumnarFile::Load(): block of columns is "
+          "corrupt!");
+    }
+  }
+}
+
+template<typename eT>
+void ColumnarFile<eT>::LoadColumns(const arma::uvec& columns,
+                                   arma::Mat<eT>& output) const
+{
+  for (size_t i = 0; i < columns.n_elem; ++i)
+  {
+    if (columns[i] >= nCols)
+    {
+      std::ostringstream oss;
+      oss << "ColumnarFile::LoadColumns(): column index " << columns[i]
+          << " is out of bounds (the matrix has " << nCols << " columns)!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  output.set_size(nRows, columns.n_elem);
+  if (nRows == 0)
+    return;
+
+  if (!compressed)
+  {
+    // The columns can be copied straight from the mapping; only the pages
+    // that hold them are read.
+    const eT* data = (const eT*) (memory + blocks[0].offset);
+    for (size_t i = 0; i < columns.n_elem; ++i)
+    {
+      std::memcpy(output.colptr(i), data + columns[i] * nRows,
+          nRows * sizeof(eT));
+    }
+    return;
+  }
+
+  // Visit the columns in order, so that each block is decompressed only once.
+  const arma::uvec order = arma::sort_index(columns);
+  arma::Mat<eT> blockData;
+  size_t currentBlock = blocks.size();
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    const size_t column = columns[order[i]];
+    const size_t block = column / colsPerBlock;
+    if (block != currentBlock)
+    {
+      blockData.set_size(nRows, BlockCols(block));
+      if (!ReadBlock(block, blockData.memptr()))
+      {
+        output.reset();
+        throw std::runtime_error("ColumnarFile::LoadColumns(): block of "
+            "columns is corrupt!");
+      }
+      currentBlock = block;
+    }
+
+    output.col(order[i]) = blockData.col(column - block * colsPerBlock);
+  }
+}
+
+template<typename eT>
+template<typename PolicyType>
+void ColumnarFile<eT>::LoadInfo(DatasetMapper<PolicyType>& info) const
+{
+  if (infoSize == 0)
+  {
+    throw std::runtime_error("ColumnarFile::LoadInfo(): the file does not hold "
+        "a DatasetMapper!");
+  }
+
+  std::istringstream stream(std::string(memory + infoOffset, infoSize));
+  try
+  {
+    cereal::BinaryInputArchive ar(stream);
+    ar(cereal::make_nvp("info", info));
+  }
+  catch (cereal::Exception& e)
+  {
+    throw std::runtime_error(std::string("ColumnarFile::LoadInfo(): cannot "
+        "read the DatasetMapper: ") + e.what());
+  }
+
+  if (info.Dimensionality() != nRows)
+  {
+    throw std::runtime_error("ColumnarFile::LoadInfo(): dimensionality of the "
+        "DatasetMapper does not match the matrix!");
+  }
+}
+
+template<typename eT>
+void ColumnarFile<eT>::WriteFile(const std::string& filename,
+                                 const arma::Mat<eT>& matrix,
+                                 const std::string& info,
+                                 const bool compress)
+{
+  // Blocks hold whole columns, and their size is a multiple of the alignment,
+  // so that the blocks of an uncompressed file are contiguous.
+  const size_t columnBytes = matrix.n_rows * sizeof(eT);
+  size_t colsPerBlock = 1;
+  size_t numBlocks = 0;
+  if (columnBytes > 0 && matrix.n_cols > 0)
+  {
+    size_t divisor = columnarFileAlignment;
+    size_t remainder = columnBytes;
+    while (remainder != 0)
+    {
+      const size_t next = divisor % remainder;
+      divisor = remainder;
+      remainder = next;
+    }
+    const size_t granularity = columnarFileAlignment / divisor;
+
+    colsPerBlock = std::max(columnarBlockSize / columnBytes, (size_t) 1);
+    colsPerBlock = ((colsPerBlock + granularity - 1) / granularity) *
+        granularity;
+    numBlocks = (matrix.n_cols + colsPerBlock - 1) / colsPerBlock;
+  }
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(FileHeader));
+  std::memcpy(header.magic, columnarFileMagic, sizeof(header.magic));
+  header.version = 1;
+  header.elemType = details::ColumnarElemType<eT>();
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+  header.colsPerBlock = colsPerBlock;
+  header.numBlocks = numBlocks;
+  header.compressed = 0;
+  header.infoOffset = details::ColumnarAlign(sizeof(FileHeader));
+  header.infoSize = info.size();
+  header.blockOffset = details::ColumnarAlign(header.infoOffset +
+      header.infoSize);
+
+  std::ofstream f(filename, std::ios::binary);
+  if (!f.is_open())
+  {
+    throw std::runtime_error("ColumnarFile::Save(): cannot open file '" +
+        filename + "' for writing!");
+  }
+
+  // Pad the file with zeros up to the given offset.
+  auto padTo = [&f](const uint64_t offset)
+  {
+    const char zeros[columnarFileAlignment] = { 0 };
+    uint64_t position = (uint64_t) f.tellp();
+    while (f.good() && position < offset)
+    {
+      const size_t padding = std::min((size_t) (offset - position),
+          columnarFileAlignment);
+      f.write(zeros, padding);
+      position += padding;
+    }
+  };
+
+  // The header and the block records are written again once the blocks are
+  // written.
+  f.write((const char*) &header, sizeof(FileHeader));
+
+  padTo(header.infoOffset);
+  f.write(info.data(), info.size());
+
+  padTo(header.blockOffset);
+  std::vector<BlockRecord> records(numBlocks);
+  std::memset(records.data(), 0, numBlocks * sizeof(BlockRecord));
+  f.write((const char*) records.data(), numBlocks * sizeof(BlockRecord));
+
+  uint64_t end = header.blockOffset + numBlocks * sizeof(BlockRecord);
+  std::vector<char> buffer;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t cols = std::min(colsPerBlock,
+        (size_t) matrix.n_cols - b * colsPerBlock);
+    const char* data = (const char*) matrix.colptr(b * colsPerBlock);
+    const size_t size = cols * columnBytes;
+
+    if (compress)
+      details::CompressColumnarBlock(data, size, sizeof(eT), buffer);
+
+    records[b].offset = details::ColumnarAlign(end);
+    padTo(records[b].offset);
+    if (compress && buffer.size() < size)
+    {
+      f.write(buffer.data(), buffer.size());
+      records[b].storedSize = buffer.size();
+      records[b].compressed = 1;
+      header.compressed = 1;
+    }
+    else
+    {
+      f.write(data, size);
+      records[b].storedSize = size;
+      records[b].compressed = 0;
+    }
+
+    end = records[b].offset + records[b].storedSize;
+  }
+
+  header.fileSize = end;
+  f.seekp(header.blockOffset);
+  f.write((const char*) records.data(), numBlocks * sizeof(BlockRecord));
+  f.seekp(0);
+  f.write((const char*) &header, sizeof(FileHeader));
+
+  if (!f.good())
+  {
+    throw std::runtime_error("ColumnarFile::Save(): cannot write to file '" +
+        filename + "'!");
+  }
+}
+
+template<typename eT>
+void ColumnarFile<eT>::ReadLayout(const std::string& filename)
+{
+  const std::string invalid = "ColumnarFile::ColumnarFile(): file '" +
+      filename + "' is not a valid mlpack dataset file!";
+
+  if (memorySize < sizeof(FileHeader))
+    throw std::runtime_error(invalid);
+
+  FileHeader header;
+  std::memcpy(&header, memory, sizeof(FileHeader));
+  if (std::memcmp(header.magic, columnarFileMagic, sizeof(header.magic)) != 0 ||
+      header.version != 1 || header.fileSize != memorySize)
+    throw std::runtime_error(invalid);
+
+  if (header.elemType != details::ColumnarElemType<eT>())
+  {
+    throw std::runtime_error("ColumnarFile::ColumnarFile(): file '" + filename +
+        "' holds a matrix with a different element type!");
+  }
+
+  nRows = header.nRows;
+  nCols = header.nCols;
+  colsPerBlock = header.colsPerBlock;
+  compressed = (header.compressed != 0);
+  infoOffset = header.infoOffset;
+  infoSize = header.infoSize;
+
+  const size_t numBlocks = (nRows == 0 || nCols == 0 || colsPerBlock == 0) ? 0 :
+      (nCols + colsPerBlock - 1) / colsPerBlock;
+  if (colsPerBlock == 0 || header.numBlocks != numBlocks ||
+      infoSize > memorySize || infoOffset > memorySize - infoSize ||
+      header.blockOffset > memorySize ||
+      numBlocks > (memorySize - header.blockOffset) / sizeof(BlockRecord))
+    throw std::runtime_error(invalid);
+
+  blocks.resize(numBlocks);
+  std::memcpy(blocks.data(), memory + header.blockOffset,
+      numBlocks * sizeof(BlockRecord));
+
+  const size_t columnBytes = nRows * sizeof(eT);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const BlockRecord& record = blocks[b];
+    const size_t size = BlockCols(b) * columnBytes;
+    if (record.storedSize > memorySize ||
+        record.offset > memorySize - record.storedSize ||
+        (record.compressed != 0 && !compressed) ||
+        (record.compressed == 0 && record.storedSize != size))
+      throw std::runtime_error(invalid);
+
+    // The blocks of an uncompressed file must be contiguous and aligned, since
+    // Matrix() aliases them.
+    if (!compressed && (record.offset % columnarFileAlignment != 0 ||
+        record.offset != blocks[0].offset + b * colsPerBlock * columnBytes))
+      throw std::runtime_error(invalid);
+  }
+}
+
+template<typename eT>
+bool ColumnarFile<eT>::ReadBlock(const size_t block, eT* output) const
+{
+  const BlockRecord& record = blocks[block];
+  const size_t size = BlockCols(block) * nRows * sizeof(eT);
+  if (record.compressed == 0)
+  {
+    std::memcpy(output, memory + record.offset, size);
+    return true;
+  }
+
+  return details::DecompressColumnarBlock(memory + record.offset,
+      record.storedSize, sizeof(eT), (char*) output, size);
+}
+
+template<typename eT>
+size_t ColumnarFile<eT>::BlockCols(const size_t block) const
+{
+  return std::min(colsPerBlock, nCols - block * colsPerBlock);
+}
+
+template<typename eT>
+void ColumnarFile<eT>::Unmap()
+{
+  if (!memory)
+    return;
+
+#if !defined(_WIN32)
+  if (isMapped)
+    munmap(memory, memorySize);
+  else
+    std::free(memory);
+#else
+  std::free(memory);
+#endif
+
+  memory = NULL;
+  memorySize = 0;
+  isMapped = false;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file core/data/data_stream.hpp
+ *
+ * Definition of the DataStream class, which reads a dataset from a file in
+ * blocks of columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DATA_STREAM_HPP
+#define MLPACK_CORE_DATA_DATA_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "columnar_file.hpp"
+
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A DataStream reads a dataset from a file in blocks of a fixed number of
+ * points (columns), so that datasets that don't fit in memory can be processed
+ * one block at a time; only the current block and the block after it are held
+ * in memory.  While the current block is used, the next one is read on a
+ * background thread.
+ *
+ * @code
+ * data::DataStream<> stream("dataset.csv", 10000);
+ * arma::mat block;
+ * while (stream.Next(block))
+ * {
+ *   // Use the points of the block.
+ * }
+ * @endcode
+ *
+ * The following formats can be streamed; the format is detected like
+ * data::Load() detects it.
+ *
+ *  - Numeric text (CSV or whitespace-separated), with one point per line; empty
+ *    lines are skipped.
+ *  - Armadillo binary (arma_binary), as written by data::Save() to a .bin file.
+ *  - HDF5 (hdf5_binary), as written by data::Save(), if Armadillo was compiled
+ *    with HDF5 support; only the points of each block are read from the file.
+ *  - mlpack binary datasets (see ColumnarFile), denoted by .mlbin.
+ *
+ * Like data::Load(), a DataStream reads Armadillo binary and HDF5 files as if
+ * they hold one point per row (which is the way data::Save() writes them by
+ * default), unless transpose is false.  Text files must hold one point per
+ * line, and mlbin files always hold one point per column.
+ *
+ * @tparam eT Element type of the blocks.
+ */
+template<typename eT = double>
+class DataStream
+{
+ public:
+  /**
+   * Open the given file for streaming.  A std::runtime_error is thrown if the
+   * file can't be opened or read, and a std::invalid_argument if its format
+   * can't be streamed.
+   *
+   * @param filename Name of the file to stream.
+   * @param blockSize Number of points of each block (the last block may have
+   *     fewer).
+   * @param transpose Whether an Armadillo binary or HDF5 file holds one point
+   *     per row (default true); must be true for the other formats.
+   * @param readAhead Whether to read the next block on a background thread.
+   */
+  DataStream(const std::string& filename,
+             const size_t blockSize = 1024,
+             const bool transpose = true,
+             const bool readAhead = true);
+
+  //! Copying is not allowed, since the stream owns its background thread.
+  DataStream(const DataStream& other) = delete;
+  //! Copying is not allowed, since the stream owns its background thread.
+  DataStream& operator=(const DataStream& other) = delete;
+
+  //! Wait for the background thread and close the file.
+  ~DataStream();
+
+  /**
+   * Get the next block of points.  The matrix is swapped with the buffer of
+   * the stream, so its memory is reused.  An exception is thrown if the block
+   * can't be read.
+   *
+   * @param block Matrix to store the points of the block in.
+   * @return false (and an empty block) if there are no more points.
+   */
+  bool Next(arma::Mat<eT>& block);
+
+  //! Go back to the start of the file.
+  void Reset();
+
+  //! Get the dimensionality of the points.
+  size_t NumRows() const { return nRows; }
+  //! Get the number of points of the file, or size_t(-1) for text files,
+  //! whose number of points isn't known until they are read.
+  size_t NumCols() const { return nCols; }
+  //! Get the number of points of each block.
+  size_t BlockSize() const { return blockSize; }
+  //! Get the number of points given by Next() since the start of the file.
+  size_t Position() const { return position; }
+
+ private:
+  //! The formats that can be streamed.
+  enum StreamFormat
+  {
+    TEXT,
+    ARMA_BINARY,
+    HDF5_BINARY,
+    COLUMNAR
+  };
+
+  //! Open the file as numeric text, and find the dimensionality.
+  void OpenText();
+  //! Open the file as Armadillo binary, and read its header.
+  void OpenArmaBinary();
+  //! Open the file as HDF5.
+  void OpenHDF5();
+
+  //! Read the next block of the file into the given matrix.
+  void ReadBlock(arma::Mat<eT>& block);
+  //! Read the next block of a text file.
+  void ReadTextBlock(arma::Mat<eT>& block);
+  //! Read the given points of an Armadillo binary file.
+  void ReadArmaBinaryBlock(const size_t begin,
+                           const size_t count,
+                           arma::Mat<eT>& block);
+  //! Read the given points of an HDF5 file.
+  void ReadHDF5Block(const size_t begin,
+                     const size_t count,
+                     arma::Mat<eT>& block);
+
+  //! Read the next block; this runs on the background thread.
+  void ReadAhead();
+  //! Wait for the background thread to finish reading.
+  void Wait();
+
+  //! The name of the file.
+  std::string filename;
+  //! The number of points of each block.
+  size_t blockSize;
+  //! Whether the file holds one point per row.
+  bool transpose;
+  //! Whether to read the next block on a background thread.
+  bool readAhead;
+  //! The format of the file.
+  StreamFormat format;
+
+  //! The dimensionality of the points.
+  size_t nRows;
+  //! The number of points, or size_t(-1) if it isn't known.
+  size_t nCols;
+  //! The number of points given by Next().
+  size_t position;
+  //! The number of points read from the file (including the next block).
+  size_t readPosition;
+  //! The number of lines read from a text file.
+  size_t lineNumber;
+
+  //! The stream of a text or Armadillo binary file.
+  std::ifstream stream;
+  //! Whether the values of a text file are separated by commas.
+  bool commas;
+  //! The offset of the data of a text or Armadillo binary file (after its
+  //! header).
+  std::streamoff dataOffset;
+  //! The file of an mlbin dataset.
+  std::unique_ptr<ColumnarFile<eT>> columnarFile;
+#ifdef ARMA_USE_HDF5
+  //! The HDF5 file.
+  hid_t hdf5File;
+  //! The dataset of the HDF5 file.
+  hid_t hdf5Dataset;
+#endif
+  //! The buffer for the points of a file that holds one point per row.
+  arma::Mat<eT> transposeBuffer;
+
+  //! The thread that reads the next block.
+  std::thread worker;
+  //! Whether the next block has been read.
+  bool prefetched;
+  //! The next block.
+  arma::Mat<eT> nextBlock;
+  //! The error given while reading the next block, if any.
+  std::exception_ptr error;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "data_stream_impl.hpp"
+
+#endif
@@ -0,0 +1,549 @@
+/**
+ * @file core/data/data_stream_impl.hpp
+ *
+ * Implementation of the DataStream class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DATA_STREAM_IMPL_HPP
+#define MLPACK_CORE_DATA_DATA_STREAM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_stream.hpp"
+
+#include "detect_file_type.hpp"
+#include "extension.hpp"
+#include "load_numeric_text.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * Get the code that Armadillo writes in the header of binary files for
+ * elements of type eT (for instance, "FN008" for double).
+ */
+template<typename eT>
+std::string ArmaBinaryTypeCode()
+{
+  std::ostringstream oss;
+  if (std::is_floating_point<eT>::value)
+    oss << "FN";
+  else if (std::is_signed<eT>::value)
+    oss << "IS";
+  else
+    oss << "IU";
+  oss << std::setw(3) << std::setfill('0') << sizeof(eT);
+  return oss.str();
+}
+
+/**
+ * Return whether the given line of a text file holds only whitespace.
+ */
+inline bool IsBlankLine(const std::string& line)
+{
+  return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+#ifdef ARMA_USE_HDF5
+/**
+ * Get the native HDF5 type of elements of type eT.  (Armadillo includes the
+ * HDF5 headers when it is compiled with HDF5 support.)
+ */
+template<typename eT>
+hid_t HDF5NativeType()
+{
+  if (std::is_floating_point<eT>::value)
+    return (sizeof(eT) == sizeof(float)) ? H5T_NATIVE_FLOAT :
+        H5T_NATIVE_DOUBLE;
+
+  const bool isSigned = std::is_signed<eT>::value;
+  switch (sizeof(eT))
+  {
+    case 1:
+      return isSigned ? H5T_NATIVE_INT8 : H5T_NATIVE_UINT8;
+    case 2:
+      return isSigned ? H5T_NATIVE_INT16 : H5T_NATIVE_UINT16;
+    case 4:
+      return isSigned ? H5T_NATIVE_INT32 : H5T_NATIVE_UINT32;
+    default:
+      return isSigned ? H5T_NATIVE_INT64 : H5T_NATIVE_UINT64;
+  }
+}
+#endif
+
+} // namespace details
+
+template<typename eT>
+DataStream<eT>::DataStream(const std::string& filename,
+                           const size_t blockSize,
+                           const bool transpose,
+                           const bool readAhead) :
+    filename(filename),
+    blockSize(blockSize),
+    transpose(transpose),
+    readAhead(readAhead),
+    format(TEXT),
+    nRows(0),
+    nCols(0),
+    position(0),
+    readPosition(0),
+    lineNumber(0),
+    commas(false),
+    dataOffset(0),
+#ifdef ARMA_USE_HDF5
+    hdf5File(-1),
+    hdf5Dataset(-1),
+#endif
+    prefetched(false)
+{
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("DataStream::DataStream(): the block size "
+        "must be positive!");
+  }
+
+  if (Extension(filename) == "mlbin")
+  {
+    if (!transpose)
+    {
+      throw std::invalid_argument("DataStream::DataStream(): mlbin files "
+          "always hold one point per column; transpose must be true!");
+    }
+
+    format = COLUMNAR;
+    columnarFile.reset(new ColumnarFile<eT>(filename));
+    nRows = columnarFile->NumRows();
+    nCols = columnarFile->NumCols();
+    return;
+  }
+
+  std::fstream detectStream(filename.c_str(), std::fstream::in |
+      std::fstream::binary);
+  if (!detectStream.is_open())
+  {
+    throw std::runtime_error("DataStream::DataStream(): cannot open file '" +
+        filename + "'!");
+  }
+
+  const arma::file_type type = AutoDetect(detectStream, filename);
+  if (type == arma::csv_ascii || type == arma::raw_ascii)
+  {
+    if (!transpose)
+    {
+      throw std::invalid_argument("DataStream::DataStream(): text files are "
+          "streamed one point per line; transpose must be true!");
+    }
+
+    // AutoDetect() skips the header row of a CSV file, if there is one.
+    format = TEXT;
+    commas = (type == arma::csv_ascii);
+    detectStream.clear();
+    dataOffset = detectStream.tellg();
+    detectStream.close();
+    OpenText();
+  }
+  else if (type == arma::arma_binary)
+  {
+    format = ARMA_BINARY;
+    detectStream.close();
+    OpenArmaBinary();
+  }
+  else if (type == arma::hdf5_binary)
+  {
+    format = HDF5_BINARY;
+    detectStream.close();
+    OpenHDF5();
+  }
+  else
+  {
+    throw std::invalid_argument("DataStream::DataStream(): the format of '" +
+        filename + "' can't be streamed; only numeric text, Armadillo binary, "
+        "HDF5 and mlbin files can!");
+  }
+}
+
+template<typename eT>
+DataStream<eT>::~DataStream()
+{
+  Wait();
+
+#ifdef ARMA_USE_HDF5
+  if (hdf5Dataset >= 0)
+    H5Dclose(hdf5Dataset);
+  if (hdf5File >= 0)
+    H5Fclose(hdf5File);
+#endif
+}
+
+template<typename eT>
+bool DataStream<eT>::Next(arma::Mat<eT>& block)
+{
+  Wait();
+  if (error)
+  {
+    // Report the error only once; the next call will try to read again.
+    std::exception_ptr e = error;
+    error = std::exception_ptr();
+    std::rethrow_exception(e);
+  }
+
+  if (prefetched)
+  {
+    block.swap(nextBlock);
+    prefetched = false;
+  }
+  else
+  {
+    ReadBlock(block);
+  }
+
+  if (block.n_cols == 0)
+    return false;
+
+  position += block.n_cols;
+  if (readAhead)
+    worker = std::thread(&DataStream::ReadAhead, this);
+
+  return true;
+}
+
+template<typename eT>
+void DataStream<eT>::Reset()
+{
+  Wait();
+  prefetched = false;
+  error = std::exception_ptr();
+  position = 0;
+  readPosition = 0;
+  lineNumber = 0;
+
+  if (format == TEXT || format == ARMA_BINARY)
+  {
+    stream.clear();
+    stream.seekg(dataOffset);
+  }
+}
+
+template<typename eT>
+void DataStream<eT>::OpenText()
+{
+  stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("DataStream::DataStream(): cannot open file '" +
+        filename + "'!");
+  }
+
+  // The first nonempty line gives the dimensionality.
+  stream.seekg(dataOffset);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (details::IsBlankLine(line))
+      continue;
+
+    const size_t numValues = details::ParseNumericLine<eT>(line.data(),
+        line.data() + line.size(), commas, NULL, 0, 0);
+    if (numValues == 0 || numValues == size_t(-1))
+    {
+      throw std::runtime_error("DataStream::DataStream(): the first point of '"
+          + filename + "' can't be parsed as numbers!");
+    }
+
+    nRows = numValues;
+    break;
+  }
+
+  // The number of points isn't known until the whole file is read.
+  nCols = size_t(-1);
+  stream.clear();
+  stream.seekg(dataOffset);
+}
+
+template<typename eT>
+void DataStream<eT>::OpenArmaBinary()
+{
+  stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("DataStream::DataStream(): cannot open file '" +
+        filename + "'!");
+  }
+
+  // The header is "ARMA_MAT_BIN_<type code>\n<rows> <cols>\n".
+  std::string header;
+  size_t fileRows = 0, fileCols = 0;
+  stream >> header >> fileRows >> fileCols;
+  stream.get();
+  if (!stream || header.substr(0, 13) != "ARMA_MAT_BIN_")
+  {
+    throw std::runtime_error("DataStream::DataStream(): '" + filename +
+        "' doesn't have a valid Armadillo binary header!");
+  }
+
+  const std::string typeCode = details::ArmaBinaryTypeCode<eT>();
+  if (header.substr(13) != typeCode)
+  {
+    throw std::runtime_error("DataStream::DataStream(): '" + filename +
+        "' holds elements of type " + header.substr(13) + ", but elements of "
+        "type " + typeCode + " were requested!");
+  }
+
+  dataOffset = stream.tellg();
+  nRows = transpose ? fileCols : fileRows;
+  nCols = transpose ? fileRows : fileCols;
+
+  // Make sure that all the data is there, so that a truncated file is reported
+  // now and not after some of it has been used.
+  stream.seekg(0, std::ios::end);
+  const std::streamoff size = stream.tellg();
+  if (size - dataOffset < std::streamoff(nRows * nCols * sizeof(eT)))
+  {
+    throw std::runtime_error("DataStream::DataStream(): '" + filename +
+        "' is truncated!");
+  }
+
+  stream.seekg(dataOffset);
+}
+
+template<typename eT>
+void DataStream<eT>::OpenHDF5()
+{
+#ifdef ARMA_USE_HDF5
+  hdf5File = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (hdf5File < 0)
+  {
+    throw std::runtime_error("DataStream::DataStream(): cannot open HDF5 file "
+        "'" + filename + "'!");
+  }
+
+  // Armadillo stores matrices in the dataset "dataset".
+  hdf5Dataset = H5Dopen(hdf5File, "dataset", H5P_DEFAULT);
+  if (hdf5Dataset < 0)
+  {
+    H5Fclose(hdf5File);
+    hdf5File = -1;
+    throw std::runtime_error("DataStream::DataStream(): '" + filename +
+        "' has no dataset named 'dataset'!");
+  }
+
+  const hid_t space = H5Dget_space(hdf5Dataset);
+  hsize_t dims[2];
+  const int numDims = H5Sget_simple_extent_ndims(space);
+  if (numDims == 2)
+    H5Sget_simple_extent_dims(space, dims, NULL);
+  H5Sclose(space);
+  if (numDims != 2)
+  {
+    H5Dclose(hdf5Dataset);
+    H5Fclose(hdf5File);
+    hdf5Dataset = -1;
+    hdf5File = -1;
+    throw std::runtime_error("DataStream::DataStream(): the dataset of '" +
+        filename + "' is not a matrix!");
+  }
+
+  // The HDF5 dimensions of a matrix, in C order, are its columns and then its
+  // rows.
+  nRows = transpose ? dims[0] : dims[1];
+  nCols = transpose ? dims[1] : dims[0];
+#else
+  throw std::invalid_argument("DataStream::DataStream(): '" + filename + "' "
+      "is an HDF5 file, but Armadillo was compiled without HDF5 support!");
+#endif
+}
+
+template<typename eT>
+void DataStream<eT>::ReadBlock(arma::Mat<eT>& block)
+{
+  if (format == TEXT)
+  {
+    ReadTextBlock(block);
+    return;
+  }
+
+  const size_t begin = readPosition;
+  const size_t count = std::min(blockSize, nCols - begin);
+  if (format == COLUMNAR)
+  {
+    if (count == 0)
+      block.set_size(nRows, 0);
+    else
+      columnarFile->LoadColumns(arma::regspace<arma::uvec>(begin,
+          begin + count - 1), block);
+  }
+  else if (format == ARMA_BINARY)
+  {
+    ReadArmaBinaryBlock(begin, count, block);
+  }
+  else
+  {
+    ReadHDF5Block(begin, count, block);
+  }
+
+  readPosition += count;
+}
+
+template<typename eT>
+void DataStream<eT>::ReadTextBlock(arma::Mat<eT>& block)
+{
+  block.set_size(nRows, blockSize);
+  size_t count = 0;
+  std::string line;
+  while (count < blockSize && std::getline(stream, line))
+  {
+    ++lineNumber;
+    if (details::IsBlankLine(line))
+      continue;
+
+    const size_t numValues = details::ParseNumericLine(line.data(),
+        line.data() + line.size(), commas, block.colptr(count), 1, nRows);
+    if (numValues != nRows)
+    {
+      std::ostringstream oss;
+      oss << "DataStream::Next(): line " << lineNumber << " of '" << filename
+          << "' doesn't hold " << nRows << " numbers!";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++count;
+  }
+
+  if (count < blockSize)
+    block.resize(nRows, count);
+  readPosition += count;
+}
+
+template<typename eT>
+void DataStream<eT>::ReadArmaBinaryBlock(const size_t begin,
+                                         const size_t count,
+                                         arma::Mat<eT>& block)
+{
+  if (count == 0)
+  {
+    block.set_size(nRows, 0);
+    return;
+  }
+
+  if (!transpose)
+  {
+    // The points of the block are contiguous.
+    block.set_size(nRows, count);
+    stream.seekg(dataOffset + std::streamoff(begin * nRows * sizeof(eT)));
+    stream.read((char*) block.memptr(), count * nRows * sizeof(eT));
+  }
+  else
+  {
+    // Each dimension is a column of the file; read the part of each column
+    // that belongs to the block.
+    transposeBuffer.set_size(count, nRows);
+    for (size_t d = 0; d < nRows; ++d)
+    {
+      stream.seekg(dataOffset + std::streamoff((d * nCols + begin) *
+          sizeof(eT)));
+      stream.read((char*) transposeBuffer.colptr(d), count * sizeof(eT));
+    }
+
+    block = transposeBuffer.t();
+  }
+
+  if (!stream)
+  {
+    throw std::runtime_error("DataStream::Next(): cannot read from '" +
+        filename + "'!");
+  }
+}
+
+template<typename eT>
+void DataStream<eT>::ReadHDF5Block(const size_t begin,
+                                   const size_t count,
+                                   arma::Mat<eT>& block)
+{
+#ifdef ARMA_USE_HDF5
+  if (count == 0)
+  {
+    block.set_size(nRows, 0);
+    return;
+  }
+
+  // Select the points of the block in the dataset; in C order, the points are
+  // the second dimension if the file holds one point per row.
+  hsize_t offset[2], counts[2];
+  if (transpose)
+  {
+    offset[0] = 0;
+    offset[1] = begin;
+    counts[0] = nRows;
+    counts[1] = count;
+    transposeBuffer.set_size(count, nRows);
+  }
+  else
+  {
+    offset[0] = begin;
+    offset[1] = 0;
+    counts[0] = count;
+    counts[1] = nRows;
+    block.set_size(nRows, count);
+  }
+
+  const hid_t fileSpace = H5Dget_space(hdf5Dataset);
+  const hid_t memorySpace = H5Screate_simple(2, counts, NULL);
+  herr_t status = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL,
+      counts, NULL);
+  if (status >= 0)
+  {
+    status = H5Dread(hdf5Dataset, details::HDF5NativeType<eT>(), memorySpace,
+        fileSpace, H5P_DEFAULT, transpose ? transposeBuffer.memptr() :
+        block.memptr());
+  }
+  H5Sclose(memorySpace);
+  H5Sclose(fileSpace);
+
+  if (status < 0)
+  {
+    throw std::runtime_error("DataStream::Next(): cannot read from '" +
+        filename + "'!");
+  }
+
+  if (transpose)
+    block = transposeBuffer.t();
+#else
+  // OpenHDF5() has already thrown.
+  (void) begin;
+  (void) count;
+  (void) block;
+#endif
+}
+
+template<typename eT>
+void DataStream<eT>::ReadAhead()
+{
+  try
+  {
+    ReadBlock(nextBlock);
+    prefetched = true;
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+}
+
+template<typename eT>
+void DataStream<eT>::Wait()
+{
+  if (worker.joinable())
+    worker.join();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
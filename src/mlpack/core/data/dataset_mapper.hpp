@@ -18,7 +18,9 @@
 #include <mlpack/prereqs.hpp>
 #include <unordered_map>
 
+#include "dimension_map.hpp"
 #include "map_policies/increment_policy.hpp"
+#include "map_policies/missing_policy.hpp"
 
 namespace mlpack {
 namespace data {
@@ -34,6 +36,11 @@ namespace data {
  * can be specified with the InputType template parameter.  By default, the
  * InputType parameter is std::string.
  *
+ * The mappings of each dimension are held by a DimensionMap, which stores each
+ * input once and finds it with flat hash tables.  Inputs of different
+ * dimensions can be mapped at the same time by different threads (with
+ * IncrementPolicy and MissingPolicy); inputs of the same dimension can't.
+ *
  * @tparam PolicyType Mapping policy used to specify MapString().
  * @tparam InputType Type of input to be mapped.
  */
@@ -79,6 +86,9 @@ class DatasetMapper
    * mappings for the given dimension.  The dimension parameter refers to the
    * index of the dimension of the string (i.e. the row in the dataset).
    *
+   * Different threads may call MapString() at the same time for different
+   * dimensions.
+   *
    * @tparam T Numeric type to map to (int/double/float/etc.).
    * @param input Input to find/create mapping for.
    * @param dimension Index of the dimension of the string.
@@ -148,14 +158,13 @@ class DatasetMapper
   size_t Dimensionality() const;
 
   /**
-   * Serialize the dataset information.
+   * Serialize the dataset information.  Since version 1 (for DatasetInfo and
+   * DatasetMapper<MissingPolicy>), only the list of inputs and values of each
+   * dimension is stored; older models, which stored the forward and reverse
+   * maps, can still be loaded.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
-  {
-    ar(CEREAL_NVP(types));
-    ar(CEREAL_NVP(maps));
-  }
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Return the policy of the mapper.
   const PolicyType& Policy() const;
@@ -169,20 +178,17 @@ class DatasetMapper
   //! Types of each dimension.
   std::vector<Datatype> types;
 
-  // Forward mapping type.
-  using ForwardMapType = typename std::unordered_map<InputType, typename
-      PolicyType::MappedType>;
+  // Mappings from strings to integers, one DimensionMap for each dimension.
+  using MapType = std::vector<DimensionMap<InputType,
+      typename PolicyType::MappedType>>;
 
-  // Reverse mapping type.  Multiple inputs may map to a single output, hence
-  // the need for std::vector.
-  using ReverseMapType = std::unordered_map<typename PolicyType::MappedType,
-      std::vector<InputType>>;
-
-  // Mappings from strings to integers.
-  // Map entries will only exist for dimensions that are categorical.
-  // MapType = map<dimension, pair<bimap<string, MappedType>, numMappings>>
-  using MapType = std::unordered_map<size_t, std::pair<ForwardMapType,
-      ReverseMapType>>;
+  // The maps used by versions before 1 of serialize(): forward maps, and
+  // reverse maps (multiple inputs may map to a single output, hence the need
+  // for std::vector), for the dimensions that are categorical.
+  using OldMapType = std::unordered_map<size_t, std::pair<
+      std::unordered_map<InputType, typename PolicyType::MappedType>,
+      std::unordered_map<typename PolicyType::MappedType,
+          std::vector<InputType>>>>;
 
   //! maps object stores string and numerical pairs.
   MapType maps;
@@ -198,6 +204,10 @@ using DatasetInfo = DatasetMapper<data::IncrementPolicy>;
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::DatasetInfo, 1);
+CEREAL_CLASS_VERSION(mlpack::data::DatasetMapper<mlpack::data::MissingPolicy>,
+    1);
+
 #include "dataset_mapper_impl.hpp"
 
 #endif
@@ -23,7 +23,8 @@ namespace data {
 template<typename PolicyType, typename InputType>
 inline DatasetMapper<PolicyType, InputType>::DatasetMapper(
     const size_t dimensionality) :
-    types(dimensionality, Datatype::numeric)
+    types(dimensionality, Datatype::numeric),
+    maps(dimensionality)
 {
   // Nothing to initialize here.
 }
@@ -32,6 +33,7 @@ template<typename PolicyType, typename InputType>
 inline DatasetMapper<PolicyType, InputType>::DatasetMapper(PolicyType& policy,
     const size_t dimensionality) :
     types(dimensionality, Datatype::numeric),
+    maps(dimensionality),
     policy(std::move(policy))
 {
   // Nothing to initialize here.
@@ -42,7 +44,7 @@ inline void DatasetMapper<PolicyType, InputType>::SetDimensionality(
     const size_t dimensionality)
 {
   types = std::vector<Datatype>(dimensionality, Datatype::numeric);
-  maps.clear();
+  maps = MapType(dimensionality);
 }
 
 // Utility helper function to call MapFirstPass.
@@ -127,32 +129,28 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
     const size_t dimension,
     const size_t unmappingIndex) const
 {
-  // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
-  // key---so we will use something else...
-  const T usedValue = isnanSafe(value) ?
-      std::nexttoward(std::numeric_limits<T>::max(), T(0)) :
-      value;
+  const typename PolicyType::MappedType mappedValue =
+      static_cast<typename PolicyType::MappedType>(value);
+  const InputType* input = maps.at(dimension).FindInput(mappedValue,
+      unmappingIndex);
+  if (input)
+    return *input;
 
   // Throw an exception if the value doesn't exist.
-  if (maps.at(dimension).second.count(usedValue) == 0)
+  const size_t numUnmappings = maps.at(dimension).NumInputs(mappedValue);
+  std::ostringstream oss;
+  if (numUnmappings == 0)
   {
-    std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
         << value << "' unknown for dimension " << dimension;
-    throw std::invalid_argument(oss.str());
   }
-
-  if (unmappingIndex >= maps.at(dimension).second.at(usedValue).size())
+  else
   {
-    std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
-        << value << "' only has "
-        << maps.at(dimension).second.at(usedValue).size()
-        << " unmappings, but unmappingIndex is " << unmappingIndex << "!";
-    throw std::invalid_argument(oss.str());
+        << value << "' only has " << numUnmappings << " unmappings, but "
+        << "unmappingIndex is " << unmappingIndex << "!";
   }
-
-  return maps.at(dimension).second.at(usedValue)[unmappingIndex];
+  throw std::invalid_argument(oss.str());
 }
 
 template<typename PolicyType, typename InputType>
@@ -161,15 +159,8 @@ inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappings(
     const T value,
     const size_t dimension) const
 {
-  // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
-  // key---so we will use something else...
-  if (isnanSafe(value))
-  {
-    const T newValue = std::nexttoward(std::numeric_limits<T>::max(), T(0));
-    return maps.at(dimension).second.at(newValue).size();
-  }
-
-  return maps.at(dimension).second.at(value).size();
+  return maps.at(dimension).NumInputs(
+      static_cast<typename PolicyType::MappedType>(value));
 }
 
 // Return the value corresponding to an input in a given dimension.
@@ -179,8 +170,11 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     const InputType& input,
     const size_t dimension)
 {
+  const typename PolicyType::MappedType* value = (dimension < maps.size()) ?
+      maps[dimension].Find(input) : NULL;
+
   // Throw an exception if the value doesn't exist.
-  if (maps[dimension].first.count(input) == 0)
+  if (!value)
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapValue(): input '"
@@ -188,7 +182,7 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     throw std::invalid_argument(oss.str());
   }
 
-  return maps[dimension].first.at(input);
+  return *value;
 }
 
 // Get the type of a particular dimension.
@@ -212,7 +206,10 @@ inline Datatype& DatasetMapper<PolicyType, InputType>::Type(
     const size_t dimension)
 {
   if (dimension >= types.size())
+  {
     types.resize(dimension + 1, Datatype::numeric);
+    maps.resize(dimension + 1);
+  }
 
   return types[dimension];
 }
@@ -221,7 +218,7 @@ template<typename PolicyType, typename InputType>
 inline size_t
 DatasetMapper<PolicyType, InputType>::NumMappings(const size_t dimension) const
 {
-  return (maps.count(dimension) == 0) ? 0 : maps.at(dimension).first.size();
+  return (dimension < maps.size()) ? maps[dimension].Size() : 0;
 }
 
 template<typename PolicyType, typename InputType>
@@ -230,6 +227,67 @@ inline size_t DatasetMapper<PolicyType, InputType>::Dimensionality() const
   return types.size();
 }
 
+template<typename PolicyType, typename InputType>
+template<typename Archive>
+void DatasetMapper<PolicyType, InputType>::serialize(Archive& ar,
+                                                     const uint32_t version)
+{
+  ar(CEREAL_NVP(types));
+
+  if (version >= 1)
+  {
+    ar(CEREAL_NVP(maps));
+    return;
+  }
+
+  // Older versions stored the forward and reverse maps of the categorical
+  // dimensions.
+  typedef typename PolicyType::MappedType MappedType;
+  OldMapType oldMaps;
+  if (cereal::is_saving<Archive>())
+  {
+    for (size_t d = 0; d < maps.size(); ++d)
+    {
+      for (size_t i = 0; i < maps[d].Size(); ++i)
+      {
+        MappedType value = maps[d].Value(i);
+        oldMaps[d].first.insert(std::make_pair(maps[d].Input(i), value));
+
+        // NaN can't be used as a key.
+        if (isnanSafe(value))
+        {
+          value = std::nexttoward(std::numeric_limits<MappedType>::max(),
+              MappedType(0));
+        }
+        oldMaps[d].second[value].push_back(maps[d].Input(i));
+      }
+    }
+  }
+
+  ar(cereal::make_nvp("maps", oldMaps));
+
+  if (cereal::is_loading<Archive>())
+  {
+    maps = MapType(types.size());
+    typedef typename OldMapType::const_iterator IteratorType;
+    for (IteratorType it = oldMaps.begin(); it != oldMaps.end(); ++it)
+    {
+      if (it->first >= maps.size())
+        maps.resize(it->first + 1);
+
+      // The reverse maps hold the inputs of each value in the order they were
+      // mapped; the values themselves come from the forward map.
+      std::map<MappedType, std::vector<InputType>> reverseMap(
+          it->second.second.begin(), it->second.second.end());
+      for (const auto& group : reverseMap)
+      {
+        for (const InputType& input : group.second)
+          maps[it->first].Insert(input, it->second.first.at(input));
+      }
+    }
+  }
+}
+
 template<typename PolicyType, typename InputType>
 inline const PolicyType& DatasetMapper<PolicyType, InputType>::Policy() const
 {
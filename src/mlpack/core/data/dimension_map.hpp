@@ -0,0 +1,268 @@
+/**
+ * @file core/data/dimension_map.hpp
+ *
+ * Definition of the DimensionMap class, which holds the mappings of one
+ * dimension of a DatasetMapper.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DIMENSION_MAP_HPP
+#define MLPACK_CORE_DATA_DIMENSION_MAP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <deque>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The mappings between inputs (usually strings) and values of one dimension of
+ * a DatasetMapper.  Each input is stored once, in the order it was mapped, and
+ * is found through flat hash tables with open addressing (one from inputs to
+ * values, one from values to the inputs that map to them), so mapping an input
+ * takes no allocations beyond the storage of new inputs and the occasional
+ * growth of the tables.  Several inputs may map to the same value; NaN values
+ * are considered equal to each other.
+ *
+ * @tparam InputType Type of the inputs.
+ * @tparam MappedType Type of the values.
+ */
+template<typename InputType, typename MappedType>
+class DimensionMap
+{
+ public:
+  //! Create an empty map.
+  DimensionMap() { }
+
+  //! Get the number of mapped inputs.
+  size_t Size() const { return inputs.size(); }
+
+  //! Get the i'th mapped input, in the order inputs were mapped.
+  const InputType& Input(const size_t i) const { return inputs[i]; }
+  //! Get the value of the i'th mapped input.
+  MappedType Value(const size_t i) const { return values[i]; }
+
+  /**
+   * Find the value of the given input.
+   *
+   * @return A pointer to the value, or NULL if the input isn't mapped.
+   */
+  const MappedType* Find(const InputType& input) const
+  {
+    if (inputSlots.empty())
+      return NULL;
+
+    const size_t hash = std::hash<InputType>()(input);
+    const size_t mask = inputSlots.size() - 1;
+    for (size_t slot = hash & mask; inputSlots[slot] != 0;
+        slot = (slot + 1) & mask)
+    {
+      const size_t i = inputSlots[slot] - 1;
+      if (inputHashes[i] == hash && inputs[i] == input)
+        return &values[i];
+    }
+
+    return NULL;
+  }
+
+  /**
+   * Map the given input, which must not be mapped yet, to the given value.
+   *
+   * @param input Input to map.
+   * @param value Value to map the input to.
+   */
+  void Insert(const InputType& input, const MappedType value)
+  {
+    const size_t index = inputs.size();
+    inputs.push_back(input);
+    values.push_back(value);
+    inputHashes.push_back(std::hash<InputType>()(input));
+    nextInputs.push_back(0);
+
+    // Keep the tables at most half full.
+    if (2 * inputs.size() > inputSlots.size())
+      Rehash(inputSlots, std::max(size_t(16), 4 * inputs.size()), inputHashes);
+    else
+      Place(inputSlots, index, inputHashes[index]);
+
+    const size_t group = FindGroup(value);
+    if (group != 0)
+    {
+      // Append the input to the inputs that map to the same value.
+      nextInputs[groupLasts[group - 1]] = index + 1;
+      groupLasts[group - 1] = index;
+      ++groupSizes[group - 1];
+      return;
+    }
+
+    groupFirsts.push_back(index);
+    groupLasts.push_back(index);
+    groupSizes.push_back(1);
+    groupHashes.push_back(HashValue(value));
+    if (2 * groupFirsts.size() > groupSlots.size())
+    {
+      Rehash(groupSlots, std::max(size_t(16), 4 * groupFirsts.size()),
+          groupHashes);
+    }
+    else
+    {
+      Place(groupSlots, groupFirsts.size() - 1, groupHashes.back());
+    }
+  }
+
+  //! Get the number of inputs that map to the given value.
+  size_t NumInputs(const MappedType value) const
+  {
+    const size_t group = FindGroup(value);
+    return (group == 0) ? 0 : groupSizes[group - 1];
+  }
+
+  /**
+   * Find the given input (in the order inputs were mapped) of the inputs that
+   * map to the given value.
+   *
+   * @return A pointer to the input, or NULL if there isn't such an input.
+   */
+  const InputType* FindInput(const MappedType value, const size_t index) const
+  {
+    const size_t group = FindGroup(value);
+    if (group == 0 || index >= groupSizes[group - 1])
+      return NULL;
+
+    size_t i = groupFirsts[group - 1];
+    for (size_t j = 0; j < index; ++j)
+      i = nextInputs[i] - 1;
+
+    return &inputs[i];
+  }
+
+  //! Remove all the mappings.
+  void Clear()
+  {
+    *this = DimensionMap();
+  }
+
+  /**
+   * Serialize the map.  Only the inputs and their values are stored; the
+   * tables are rebuilt when the map is loaded.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    std::vector<InputType> inputList;
+    std::vector<MappedType> valueList;
+    if (cereal::is_saving<Archive>())
+    {
+      inputList.assign(inputs.begin(), inputs.end());
+      valueList = values;
+    }
+
+    ar(CEREAL_NVP(inputList));
+    ar(CEREAL_NVP(valueList));
+
+    if (cereal::is_loading<Archive>())
+    {
+      if (inputList.size() != valueList.size())
+      {
+        throw std::runtime_error("DimensionMap::serialize(): the numbers of "
+            "inputs and values do not match!");
+      }
+
+      Clear();
+      for (size_t i = 0; i < inputList.size(); ++i)
+        Insert(inputList[i], valueList[i]);
+    }
+  }
+
+ private:
+  //! Hash a value; all NaNs have the same hash.
+  static size_t HashValue(const MappedType& value)
+  {
+    return (value != value) ? 0 : std::hash<MappedType>()(value);
+  }
+
+  //! Return whether two values are equal; all NaNs are equal.
+  static bool SameValue(const MappedType& a, const MappedType& b)
+  {
+    return (a == b) || (a != a && b != b);
+  }
+
+  //! Find the group of inputs (plus one) that map to the given value, or 0.
+  size_t FindGroup(const MappedType& value) const
+  {
+    if (groupSlots.empty())
+      return 0;
+
+    const size_t hash = HashValue(value);
+    const size_t mask = groupSlots.size() - 1;
+    for (size_t slot = hash & mask; groupSlots[slot] != 0;
+        slot = (slot + 1) & mask)
+    {
+      const size_t group = groupSlots[slot];
+      if (groupHashes[group - 1] == hash &&
+          SameValue(values[groupFirsts[group - 1]], value))
+        return group;
+    }
+
+    return 0;
+  }
+
+  //! Put the given index in the first free slot for the given hash.
+  static void Place(std::vector<size_t>& slots,
+                    const size_t index,
+                    const size_t hash)
+  {
+    const size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = index + 1;
+  }
+
+  //! Rebuild a table with the given number of slots (a power of 2).
+  static void Rehash(std::vector<size_t>& slots,
+                     const size_t minSize,
+                     const std::vector<size_t>& hashes)
+  {
+    size_t size = 1;
+    while (size < minSize)
+      size <<= 1;
+
+    slots.assign(size, 0);
+    for (size_t i = 0; i < hashes.size(); ++i)
+      Place(slots, i, hashes[i]);
+  }
+
+  //! The mapped inputs, in the order they were mapped.  A deque never moves
+  //! its elements, so references to them stay valid.
+  std::deque<InputType> inputs;
+  //! The value of each input.
+  std::vector<MappedType> values;
+  //! The hash of each input.
+  std::vector<size_t> inputHashes;
+  //! For each input, the next input (plus one) with the same value, or 0.
+  std::vector<size_t> nextInputs;
+  //! The table of inputs: each slot holds the index of an input plus one, or
+  //! 0 if it is empty.
+  std::vector<size_t> inputSlots;
+
+  //! For each distinct value, the first input that maps to it.
+  std::vector<size_t> groupFirsts;
+  //! For each distinct value, the last input that maps to it.
+  std::vector<size_t> groupLasts;
+  //! For each distinct value, the number of inputs that map to it.
+  std::vector<size_t> groupSizes;
+  //! The hash of each distinct value.
+  std::vector<size_t> groupHashes;
+  //! The table of distinct values: each slot holds the index of a value plus
+  //! one, or 0 if it is empty.
+  std::vector<size_t> groupSlots;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -16,13 +16,19 @@
 namespace mlpack {
 namespace data {
 
-//! Define the formats we can read through cereal.
+/**
+ * Define the formats we can read through cereal.  aligned_binary is the binary
+ * format with the memory of each Armadillo object in a single block aligned to
+ * 64 bytes, which is loaded with one read per object, or without reading at all
+ * by MappedModel; it also uses the .bin extension.
+ */
 enum format
 {
   autodetect,
   json,
   xml,
-  binary
+  binary,
+  aligned_binary
 };
 
 } // namespace data
@@ -46,28 +46,17 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
+    // The elements of the dimension are the elements of a row if the matrix
+    // is column major, and of a column otherwise.
+    const size_t numElems = columnMajor ? input.n_cols : input.n_rows;
+
+    // replace the target value to custom value, in parallel.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numElems; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
-      }
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = customValue;
     }
   }
 
@@ -42,43 +42,20 @@ class MeanImputation
     double sum = 0;
     size_t elems = 0; // excluding nan or missing target
 
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-
+    // The elements of the dimension are the elements of a row if the matrix
+    // is column major, and of a column otherwise.
+    const size_t numElems = columnMajor ? input.n_cols : input.n_rows;
 
     // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
-        }
-      }
-    }
-    else
+    // nan, in parallel.
+    #pragma omp parallel for reduction(+:sum, elems)
+    for (omp_size_t i = 0; i < (omp_size_t) numElems; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      const T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (!(value == mappedValue || std::isnan(value)))
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
+        elems++;
+        sum += value;
       }
     }
 
@@ -89,11 +66,14 @@ class MeanImputation
     // calculate mean;
     const double mean = sum / elems;
 
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    // Now replace the calculated mean to the missing variables.  Nothing is
+    // stored during the first pass, so a second pass finds them again.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numElems; ++i)
     {
-      input(target.first, target.second) = mean;
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = mean;
     }
   }
 }; // class MeanImputation
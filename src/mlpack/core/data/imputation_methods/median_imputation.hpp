@@ -40,49 +40,30 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    // The elements of the dimension are the elements of a row if the matrix
+    // is column major, and of a column otherwise.
+    const size_t numElems = columnMajor ? input.n_cols : input.n_rows;
+
     // good elements are kept inside this vector.
     std::vector<double> elemsToKeep;
-
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
-      }
-    }
-    else
+    elemsToKeep.reserve(numElems);
+    for (size_t i = 0; i < numElems; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
-      }
+      const T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (!(value == mappedValue || std::isnan(value)))
+        elemsToKeep.push_back(value);
     }
 
     // calculate median
     const double median = arma::median(arma::vec(elemsToKeep));
 
-    for (const PairType& target : targets)
+    // Replace the missing variables with the median, in parallel.
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numElems; ++i)
     {
-       input(target.first, target.second) = median;
+      T& value = columnMajor ? input(dimension, i) : input(i, dimension);
+      if (value == mappedValue || std::isnan(value))
+        value = median;
     }
   }
 }; // class MedianImputation
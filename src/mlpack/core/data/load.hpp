@@ -41,6 +41,7 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (arma::raw_binary), denoted by .bin
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack binary dataset (see ColumnarFile), denoted by .mlbin
  *
  * By default, this function will try to automatically determine the type of
  * file to load based on its extension and by inspecting the file.  If you know
@@ -84,6 +85,10 @@ bool Load(const std::string& filename,
  *  - TXT (coord_ascii), denoted by .txt
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
+ *  - LibSVM / SVMlight, denoted by .svm, .libsvm or .svmlight (the labels
+ *    are ignored; use LoadLibSVM() to load them too)
+ *  - ARFF, denoted by .arff, with dense or sparse lines (the mappings of the
+ *    categorical features are dropped; use LoadARFF() to keep them)
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -256,11 +261,13 @@ bool Load(const std::string& filename,
  * mapping categorical features with a DatasetMapper object.  This will
  * transpose the matrix (unless the transpose parameter is set to false).
  * This particular overload of Load() can only load text-based formats, such as
- * those given below:
+ * those given below, and mlpack binary datasets that hold their DatasetMapper:
  *
  * - CSV (csv_ascii), denoted by .csv, or optionally .txt
  * - TSV (raw_ascii), denoted by .tsv, .csv, or .txt
  * - ASCII (raw_ascii), denoted by .txt
+ * - ARFF, denoted by .arff
+ * - mlpack binary dataset (see ColumnarFile), denoted by .mlbin
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -349,9 +356,12 @@ extern template bool Load<double, IncrementPolicy>(
  *  - binary, denoted by .bin
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::json', 'format::xml', and 'format::binary'.
- * The autodetect functionality operates on the file extension (so, "file.txt"
- * would be autodetected as text).
+ * 'format::autodetect', 'format::json', 'format::xml', 'format::binary', and
+ * 'format::aligned_binary'.  The autodetect functionality operates on the file
+ * extension (so, "file.txt" would be autodetected as text).  Binary files saved
+ * with 'format::aligned_binary' are recognized by their header, and the memory
+ * of each Armadillo object is loaded with a single read; to map such a file
+ * instead, use MappedModel.
  *
  * The name parameter should be specified to indicate the name of the structure
  * to be loaded.  This should be the same as the name that was used to save the
@@ -360,13 +370,21 @@ extern template bool Load<double, IncrementPolicy>(
  * If the parameter 'fatal' is set to true, then an exception will be thrown in
  * the event of load failure.  Otherwise, the method will return false and the
  * relevant error information will be printed to Log::Warn.
+ *
+ * If 'predictionOnly' is true, the model is loaded to make predictions only,
+ * and models may drop the state that is only needed to train them further
+ * (see cereal::IsPredictionOnly()); such a model can't be saved or trained
+ * again.  Together with MappedModel, which pages in the matrices of a model
+ * only when they are used, this reduces the time and memory taken to load a
+ * model for serving.
  */
 template<typename T>
 bool Load(const std::string& filename,
           const std::string& name,
           T& t,
           const bool fatal = false,
-          format f = format::autodetect);
+          format f = format::autodetect,
+          const bool predictionOnly = false);
 
 /**
  * Image load/save interfaces.
@@ -388,7 +406,9 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  The
+ * images are decoded in parallel with OpenMP, directly into their column of
+ * the matrix; they must all have the dimensions of the first image.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
@@ -402,6 +422,27 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal = false);
 
+/**
+ * Load the image files into the given matrix, one image per column, and
+ * resize each image to the width and height of the given target with
+ * bilinear interpolation while it is written to its column, so the images may
+ * have different dimensions.  The images are decoded in parallel with OpenMP.
+ *
+ * @param files A vector consisting of filenames.
+ * @param matrix Matrix to save the image from.
+ * @param info An object of ImageInfo class; it holds the dimensions of the
+ *     resized images after loading.
+ * @param targetInfo The width and height that the images are resized to.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const ImageInfo& targetInfo,
+          const bool fatal = false);
+
 // Implementation found in load_image.cpp.
 bool LoadImage(const std::string& filename,
                arma::Mat<unsigned char>& matrix,
@@ -44,6 +44,17 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * loading the training set is not used, then the test set may be loaded with
  * different mappings---which can cause horrible problems!
  *
+ * Both dense lines and sparse lines (such as "{0 1.5, 3 red}", which give the
+ * nonzero values of a point as pairs of a 0-based attribute index and a value,
+ * in increasing order of index) can be loaded; the attributes a sparse line
+ * doesn't list are 0.  Empty lines and comments (from '%' to the end of the
+ * line) in the data section are ignored.
+ *
+ * The file is memory-mapped, and the data section is parsed in parallel, one
+ * block of lines per thread.  Categorical values are then mapped in the order
+ * they appear in the file (with different dimensions mapped in parallel), so
+ * the mappings don't depend on the number of threads.
+ *
  * @param filename Name of ARFF file to load.
  * @param matrix Matrix to load data into.
  * @param info DatasetInfo object; can be default-constructed or pre-existing
@@ -54,6 +65,23 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * A utility function to load an ARFF dataset into a sparse matrix, mapping
+ * categorical features with the DatasetInfo structure just like the dense
+ * overload above; an exception will be thrown upon failure.  This is most
+ * useful for files with sparse lines.  Values that are 0 (including
+ * categorical values that map to 0) aren't stored in the matrix.
+ *
+ * @param filename Name of ARFF file to load.
+ * @param matrix Sparse matrix to load data into.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing
+ *     from another call to LoadARFF().
+ */
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info);
+
 } // namespace data
 } // namespace mlpack
 
@@ -16,42 +16,158 @@
 #include "load_arff.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
-#include "is_naninf.hpp"
+#include "load_numeric_text.hpp"
+
+#include <cstring>
 
 namespace mlpack {
 namespace data {
+namespace details {
 
-template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
+/**
+ * The attributes declared in the header of an ARFF file, and the location of
+ * its data section.
+ */
+struct ARFFHeader
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename, std::ios::in | std::ios::binary);
+  ARFFHeader() : dataBegin(0), headerLines(0) { }
 
-  // if file is not open throw an error (file not found).
-  if (!ifs.is_open())
+  //! For each attribute, whether it is categorical.
+  std::vector<bool> types;
+  //! The categories of the attributes whose categories were declared.
+  std::map<size_t, std::vector<std::string>> categoryStrings;
+  //! The offset of the data section in the file.
+  size_t dataBegin;
+  //! The number of lines before the data section (including "@data").
+  size_t headerLines;
+};
+
+/**
+ * The points parsed from one block of lines of the data section of an ARFF
+ * file.  Each point is a list of (attribute, value) entries, in increasing
+ * order of attribute.
+ */
+template<typename eT>
+struct ARFFBlock
+{
+  ARFFBlock() : sparseLines(0), lines(0), errorLine(0), errorToken(-1) { }
+
+  //! The number of entries of each point.
+  std::vector<arma::uword> counts;
+  //! The attribute of each entry.
+  std::vector<arma::uword> rows;
+  //! The value of each entry; categorical values are mapped later.
+  std::vector<eT> values;
+  //! The categorical values of the block, in order.
+  std::vector<std::string> strings;
+  //! The entry of each categorical value.
+  std::vector<size_t> stringEntries;
+  //! The line of the block (counted from 1) of each categorical value.
+  std::vector<size_t> stringLines;
+  //! For each categorical dimension, its categorical values in the block.
+  std::vector<std::vector<size_t>> dimensionStrings;
+  //! The number of sparse lines of the block.
+  size_t sparseLines;
+  //! The number of lines of the block.
+  size_t lines;
+  //! The line of the block (counted from 1) that couldn't be parsed, if any.
+  size_t errorLine;
+  //! The token of that line that couldn't be parsed, or size_t(-1).
+  size_t errorToken;
+  //! The reason why that line couldn't be parsed.
+  std::string error;
+  //! The token that couldn't be parsed, if any.
+  std::string errorValue;
+};
+
+//! Return whether the given character is a space or a tab.
+inline bool IsARFFSpace(const char c)
+{
+  return (c == ' ' || c == '\t');
+}
+
+/**
+ * Find the end of the token of a data line that starts at p: the first
+ * delimiter, or the start of a comment, that isn't inside quotes.  Quotes only
+ * count at the start of a word, so that values like O'Brien can be unquoted.
+ */
+inline const char* FindARFFTokenEnd(const char* p,
+                                    const char* end,
+                                    const char delimiter)
+{
+  bool wordStart = true;
+  while (p < end && *p != delimiter && *p != '%')
   {
-    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+    if (wordStart && (*p == '"' || *p == '\''))
+    {
+      // Skip to the closing quote.
+      const char quote = *p;
+      for (++p; p < end && *p != quote; ++p)
+      {
+        if (*p == '\\' && p + 1 < end)
+          ++p;
+      }
+
+      if (p == end)
+        break;
+    }
+
+    wordStart = IsARFFSpace(*p);
+    ++p;
   }
 
-  std::string line;
-  size_t dimensionality = 0;
-  // We'll store a vector of strings representing categories to be mapped, if
-  // needed.
-  std::map<size_t, std::vector<std::string>> categoryStrings;
-  std::vector<bool> types;
-  size_t headerLines = 0;
-  while (ifs.good())
+  return p;
+}
+
+/**
+ * Get the token [begin, end) of a data line without its surrounding spaces
+ * and, if it is quoted, without its quotes and escape characters.
+ */
+inline std::string ARFFTokenString(const char* begin, const char* end)
+{
+  while (begin < end && IsARFFSpace(*begin))
+    ++begin;
+  while (end > begin && IsARFFSpace(*(end - 1)))
+    --end;
+
+  if (begin == end || (*begin != '"' && *begin != '\''))
+    return std::string(begin, end);
+
+  const char quote = *begin;
+  std::string token;
+  for (const char* p = begin + 1; p < end && *p != quote; ++p)
+  {
+    if (*p == '\\' && p + 1 < end)
+      ++p;
+    token.push_back(*p);
+  }
+
+  return token;
+}
+
+/**
+ * Parse the header of the ARFF file held by [data, data + size), up to and
+ * including its "@data" line.  A std::runtime_error is thrown if the header
+ * can't be parsed.
+ */
+inline void ParseARFFHeader(const char* data,
+                            const size_t size,
+                            ARFFHeader& header)
+{
+  const char* p = data;
+  const char* end = data + size;
+  while (p < end)
   {
     // Read the next line, then strip whitespace from either side.
-    std::getline(ifs, line, '\n');
+    const char* newline = (const char*) std::memchr(p, '\n', end - p);
+    const char* lineEnd = newline ? newline : end;
+    std::string line(p, lineEnd);
+    p = newline ? newline + 1 : end;
     boost::trim(line);
-    ++headerLines;
+    ++header.headerLines;
 
     // Is the first character a comment, or is the line empty?
-    if (line[0] == '%' || line.empty())
+    if (line.empty() || line[0] == '%')
       continue; // Ignore this line.
 
     // If the first character is @, we are looking at @relation, @attribute, or
@@ -76,7 +192,6 @@ void LoadARFF(const std::string& filename,
       }
       else if (annotation == "@attribute")
       {
-        ++dimensionality;
         // We need to mark this dimension with its according type.
         ++it; // Ignore the dimension name.
         ++it;
@@ -90,11 +205,11 @@ void LoadARFF(const std::string& filename,
 
         if (dimType == "numeric" || dimType == "integer" || dimType == "real")
         {
-          types.push_back(false); // The feature is numeric.
+          header.types.push_back(false); // The feature is numeric.
         }
         else if (dimType == "string")
         {
-          types.push_back(true); // The feature is categorical.
+          header.types.push_back(true); // The feature is categorical.
         }
         else if (dimType[0] == '{')
         {
@@ -102,7 +217,7 @@ void LoadARFF(const std::string& filename,
           // Note that categories are case-sensitive, and so we must use the
           // `origDimType` string here instead (which has not had ::tolower used
           // on it).
-          types.push_back(true);
+          header.types.push_back(true);
           boost::trim_if(origDimType,
               [](char c)
               {
@@ -123,13 +238,20 @@ void LoadARFF(const std::string& filename,
             ++it;
           }
 
-          categoryStrings[dimensionality - 1] = std::move(categories);
+          header.categoryStrings[header.types.size() - 1] =
+              std::move(categories);
+        }
+        else
+        {
+          // Any other type is treated as numeric.
+          header.types.push_back(false);
         }
       }
       else if (annotation == "@data")
       {
         // We are in the data section.  So we can move out of this loop.
-        break;
+        header.dataBegin = p - data;
+        return;
       }
       else
       {
@@ -139,8 +261,184 @@ void LoadARFF(const std::string& filename,
     }
   }
 
-  if (ifs.eof())
-    throw std::runtime_error("no @data section found");
+  throw std::runtime_error("no @data section found");
+}
+
+/**
+ * Parse the token [begin, end) of a data line as the value of the given
+ * attribute, and append it as an entry of the current point of the block.
+ *
+ * @return Whether the token could be parsed; if not, the error is set.
+ */
+template<typename eT>
+bool ParseARFFValue(const char* begin,
+                    const char* end,
+                    const size_t dimension,
+                    const ARFFHeader& header,
+                    ARFFBlock<eT>& block)
+{
+  if (header.types[dimension])
+  {
+    // Categorical values are mapped once the whole file is parsed.
+    block.rows.push_back(dimension);
+    block.values.push_back(eT(0));
+    block.strings.push_back(ARFFTokenString(begin, end));
+    block.stringEntries.push_back(block.values.size() - 1);
+    block.stringLines.push_back(block.lines);
+    return true;
+  }
+
+  while (begin < end && IsARFFSpace(*begin))
+    ++begin;
+  while (end > begin && IsARFFSpace(*(end - 1)))
+    --end;
+
+  eT value;
+  if (!ParseNumericToken(begin, end, value))
+  {
+    // If it's '?', we issue a specific error, otherwise we issue a general
+    // error.
+    block.errorValue = std::string(begin, end);
+    block.errorToken = dimension;
+    if (block.errorValue == "?")
+      block.error = "Missing values ('?') not supported";
+    else
+      block.error = "Parse error";
+    return false;
+  }
+
+  block.rows.push_back(dimension);
+  block.values.push_back(value);
+  return true;
+}
+
+/**
+ * Parse the line [begin, end) (without its newline) of the data section of an
+ * ARFF file, and append its point, if it holds one, to the given block.
+ *
+ * @return Whether the line could be parsed; if not, the error is set.
+ */
+template<typename eT>
+bool ParseARFFLine(const char* begin,
+                   const char* end,
+                   const ARFFHeader& header,
+                   ARFFBlock<eT>& block)
+{
+  // Ignore the carriage return of Windows line endings.
+  if (end > begin && *(end - 1) == '\r')
+    --end;
+
+  const char* p = begin;
+  while (p < end && IsARFFSpace(*p))
+    ++p;
+  if (p == end || *p == '%')
+    return true; // Nothing on this line.
+
+  const size_t dimensionality = header.types.size();
+  const size_t first = block.rows.size();
+  if (*p == '{')
+  {
+    // This is a sparse line: a list of "index value" pairs.
+    const char* close = FindARFFTokenEnd(p + 1, end, '}');
+    const char* rest = close + 1;
+    while (rest < end && IsARFFSpace(*rest))
+      ++rest;
+    if (close == end || *close != '}' || (rest < end && *rest != '%'))
+    {
+      block.error = "Unterminated sparse line";
+      return false;
+    }
+
+    p = p + 1;
+    while (p < close)
+    {
+      const char* tokenEnd = FindARFFTokenEnd(p, close, ',');
+      while (p < tokenEnd && IsARFFSpace(*p))
+        ++p;
+
+      // Allow "{}" and "{ }", which are points whose values are all 0.
+      if (p == tokenEnd && tokenEnd == close && block.rows.size() == first)
+        break;
+
+      const char* indexEnd = p;
+      while (indexEnd < tokenEnd && !IsARFFSpace(*indexEnd))
+        ++indexEnd;
+
+      size_t index;
+      if (!ParseNumericToken(p, indexEnd, index) || index >= dimensionality ||
+          (block.rows.size() > first && index <= block.rows.back()))
+      {
+        block.error = "Invalid or unordered sparse index";
+        block.errorValue = std::string(p, indexEnd);
+        return false;
+      }
+
+      if (!ParseARFFValue(indexEnd, tokenEnd, index, header, block))
+        return false;
+
+      p = tokenEnd + 1;
+    }
+
+    ++block.sparseLines;
+  }
+  else
+  {
+    size_t col = 0;
+    while (true)
+    {
+      // Check that we are not too many columns in.
+      if (col >= dimensionality)
+      {
+        block.error = "Too many columns";
+        return false;
+      }
+
+      const char* tokenEnd = FindARFFTokenEnd(p, end, ',');
+      if (!ParseARFFValue(p, tokenEnd, col, header, block))
+        return false;
+
+      ++col;
+      if (tokenEnd == end || *tokenEnd == '%')
+        break;
+      p = tokenEnd + 1;
+    }
+
+    if (col < dimensionality)
+    {
+      block.error = "Too few columns";
+      return false;
+    }
+  }
+
+  block.counts.push_back(block.rows.size() - first);
+  return true;
+}
+
+/**
+ * Parse the given ARFF file into blocks of points, and map its categorical
+ * values with the given DatasetMapper, which is reset (or checked) as
+ * documented for LoadARFF().  A std::runtime_error is thrown if the file can't
+ * be parsed.
+ */
+template<typename eT, typename PolicyType>
+void ParseARFF(const std::string& filename,
+               DatasetMapper<PolicyType>& info,
+               std::vector<ARFFBlock<eT>>& blocks)
+{
+  TextFileView file(filename);
+
+  // if file is not open throw an error (file not found).
+  if (!file.IsOpen())
+  {
+    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
+  }
+
+  const char* data = file.Data();
+  const size_t size = file.Size();
+
+  ARFFHeader header;
+  ParseARFFHeader(data, size, header);
+  const size_t dimensionality = header.types.size();
 
   // Reset the DatasetInfo object, if needed.
   if (info.Dimensionality() == 0)
@@ -156,9 +454,9 @@ void LoadARFF(const std::string& filename,
     throw std::invalid_argument(oss.str());
   }
 
-  for (size_t i = 0; i < types.size(); ++i)
+  for (size_t i = 0; i < header.types.size(); ++i)
   {
-    if (types[i])
+    if (header.types[i])
       info.Type(i) = Datatype::categorical;
     else
       info.Type(i) = Datatype::numeric;
@@ -167,8 +465,8 @@ void LoadARFF(const std::string& filename,
   // Make sure all strings are mapped, if we have any.
   typedef std::map<size_t, std::vector<std::string>>::const_iterator
       IteratorType;
-  for (IteratorType it = categoryStrings.begin(); it != categoryStrings.end();
-      ++it)
+  for (IteratorType it = header.categoryStrings.begin();
+      it != header.categoryStrings.end(); ++it)
   {
     for (const std::string& str : (*it).second)
     {
@@ -176,122 +474,259 @@ void LoadARFF(const std::string& filename,
     }
   }
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (ifs.good())
+  // Split the data section into one block per thread; each block starts at
+  // the start of a line.  Small files aren't worth splitting.
+  const size_t dataSize = size - header.dataBegin;
+#ifdef HAS_OPENMP
+  const size_t maxBlocks = omp_get_max_threads();
+#else
+  const size_t maxBlocks = 1;
+#endif
+  const size_t minBlockSize = 1 << 20;
+  const size_t numBlocks = std::max(size_t(1),
+      std::min(maxBlocks, dataSize / minBlockSize));
+
+  std::vector<size_t> blockBegin(numBlocks + 1);
+  blockBegin[0] = header.dataBegin;
+  blockBegin[numBlocks] = size;
+  for (size_t b = 1; b < numBlocks; ++b)
   {
-    std::getline(ifs, line, '\n');
-    ++row;
+    const size_t position = std::max(header.dataBegin +
+        b * (dataSize / numBlocks), blockBegin[b - 1]);
+    const char* newline = (const char*) std::memchr(data + position, '\n',
+        size - position);
+    blockBegin[b] = newline ? (newline - data) + 1 : size;
   }
-  // Uncount the EOF row.
-  --row;
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  // Parse each block on its own.
+  blocks.clear();
+  blocks.resize(numBlocks);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    ARFFBlock<eT>& block = blocks[b];
+    const char* p = data + blockBegin[b];
+    const char* end = data + blockBegin[b + 1];
+    while (p < end)
+    {
+      const char* newline = (const char*) std::memchr(p, '\n', end - p);
+      const char* lineEnd = newline ? newline : end;
+      ++block.lines;
+      if (!ParseARFFLine(p, lineEnd, header, block))
+      {
+        block.errorLine = block.lines;
+        break;
+      }
 
-  // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+      p = lineEnd + 1;
+    }
+  }
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (ifs.good())
+  // Find the categorical values of each categorical dimension.
+  std::vector<size_t> dimensions;
+  std::vector<size_t> dimensionIndices(dimensionality, size_t(-1));
+  for (size_t d = 0; d < dimensionality; ++d)
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
+    if (header.types[d])
+    {
+      dimensionIndices[d] = dimensions.size();
+      dimensions.push_back(d);
+    }
+  }
 
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    ARFFBlock<eT>& block = blocks[b];
+    block.dimensionStrings.resize(dimensions.size());
+    for (size_t i = 0; i < block.strings.size(); ++i)
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
+      const size_t col = block.rows[block.stringEntries[i]];
+      block.dimensionStrings[dimensionIndices[col]].push_back(i);
+    }
+  }
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+  // Map the categorical values of each dimension in the order they appear in
+  // the file, so that the mappings don't depend on the number of threads;
+  // different dimensions are mapped in parallel.  Mapping stops at the first
+  // value of a dimension that isn't one of its declared categories.
+  std::vector<size_t> errorBlocks(dimensions.size(), numBlocks);
+  std::vector<size_t> errorStrings(dimensions.size(), 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) dimensions.size(); ++c)
+  {
+    const size_t col = dimensions[c];
+    const bool declared = (header.categoryStrings.count(col) > 0);
+    for (size_t b = 0; b < numBlocks && errorBlocks[c] == numBlocks; ++b)
+    {
+      ARFFBlock<eT>& block = blocks[b];
+      for (const size_t i : block.dimensionStrings[c])
       {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
         const size_t currentNumMappings = info.NumMappings(col);
-        const eT result = info.template MapString<eT>(token, col);
+        block.values[block.stringEntries[i]] =
+            info.template MapString<eT>(block.strings[i], col);
 
         // If the set of categories was pre-specified, then we must crash if
         // this was not one of those categories.
-        if (categoryStrings.count(col) > 0 &&
-            currentNumMappings < info.NumMappings(col))
+        if (declared && currentNumMappings < info.NumMappings(col))
         {
-          std::stringstream error;
-          error << "Parse error at line " << (headerLines + row) << " token "
-              << col << ": category \"" << token << "\" not in the set of known"
-              << " categories for this dimension (";
-          for (size_t i = 0; i < categoryStrings.at(col).size() - 1; ++i)
-            error << "\"" << categoryStrings.at(col)[i] << "\", ";
-          error << "\"" << categoryStrings.at(col).back() << "\").";
-          throw std::runtime_error(error.str());
+          errorBlocks[c] = b;
+          errorStrings[c] = i;
+          break;
         }
-
-        // We load transposed.
-        matrix(col, row) = result;
       }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
+    }
+  }
 
-        eT val = eT(0);
-        token >> val;
+  // Report the first error of the file.  The values of a block were all
+  // parsed before its parse error, if it has one.
+  size_t line = header.headerLines;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const ARFFBlock<eT>& block = blocks[b];
+    size_t first = size_t(-1);
+    for (size_t c = 0; c < dimensions.size(); ++c)
+    {
+      if (errorBlocks[c] == b && (first == size_t(-1) ||
+          block.stringLines[errorStrings[c]] <
+          block.stringLines[errorStrings[first]]))
+        first = c;
+    }
 
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
+    if (first != size_t(-1) && (block.errorLine == 0 ||
+        block.stringLines[errorStrings[first]] <= block.errorLine))
+    {
+      const size_t col = dimensions[first];
+      const std::vector<std::string>& categories =
+          header.categoryStrings.at(col);
+      std::stringstream error;
+      error << "Parse error at line "
+          << (line + block.stringLines[errorStrings[first]]) << " token "
+          << col << ": category \"" << block.strings[errorStrings[first]]
+          << "\" not in the set of known categories for this dimension (";
+      for (size_t j = 0; j < categories.size() - 1; ++j)
+        error << "\"" << categories[j] << "\", ";
+      error << "\"" << categories.back() << "\").";
+      throw std::runtime_error(error.str());
+    }
+
+    if (block.errorLine > 0)
+    {
+      std::stringstream error;
+      error << block.error << " at line " << (line + block.errorLine);
+      if (block.errorToken != size_t(-1))
+        error << " token " << block.errorToken;
+      if (!block.errorValue.empty())
+        error << ": \"" << block.errorValue << "\"";
+      error << ".";
+      throw std::runtime_error(error.str());
+    }
+
+    line += block.lines;
+  }
+
+  // The strings aren't needed anymore.
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    std::vector<std::string>().swap(blocks[b].strings);
+    std::vector<std::vector<size_t>>().swap(blocks[b].dimensionStrings);
+  }
+}
 
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  std::vector<details::ARFFBlock<eT>> blocks;
+  details::ParseARFF(filename, info, blocks);
+
+  std::vector<size_t> pointOffsets(blocks.size() + 1, 0);
+  bool sparse = false;
+  for (size_t b = 0; b < blocks.size(); ++b)
+  {
+    pointOffsets[b + 1] = pointOffsets[b] + blocks[b].counts.size();
+    sparse |= (blocks[b].sparseLines > 0);
+  }
+
+  // Sparse lines don't give every value, so the others must be 0.
+  if (sparse)
+    matrix.zeros(info.Dimensionality(), pointOffsets.back());
+  else
+    matrix.set_size(info.Dimensionality(), pointOffsets.back());
+
+  // We load transposed.
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks.size(); ++b)
+  {
+    const details::ARFFBlock<eT>& block = blocks[b];
+    size_t entry = 0;
+    for (size_t i = 0; i < block.counts.size(); ++i)
+    {
+      eT* column = matrix.colptr(pointOffsets[b] + i);
+      for (size_t j = 0; j < block.counts[i]; ++j, ++entry)
+        column[block.rows[entry]] = block.values[entry];
+    }
+  }
+}
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::SpMat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  std::vector<details::ARFFBlock<eT>> blocks;
+  details::ParseARFF(filename, info, blocks);
+
+  // Count the nonzero values of each block.
+  std::vector<size_t> nonzeros(blocks.size(), 0);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks.size(); ++b)
+  {
+    for (const eT value : blocks[b].values)
+      nonzeros[b] += (value != eT(0));
+  }
+
+  std::vector<size_t> pointOffsets(blocks.size() + 1, 0);
+  std::vector<size_t> valueOffsets(blocks.size() + 1, 0);
+  for (size_t b = 0; b < blocks.size(); ++b)
+  {
+    pointOffsets[b + 1] = pointOffsets[b] + blocks[b].counts.size();
+    valueOffsets[b + 1] = valueOffsets[b] + nonzeros[b];
+  }
+
+  // Copy the nonzero values directly into the compressed sparse column arrays.
+  const size_t numPoints = pointOffsets.back();
+  arma::uvec rowIndices(valueOffsets.back());
+  arma::uvec colPointers(numPoints + 1);
+  arma::Col<eT> values(valueOffsets.back());
+  colPointers[0] = 0;
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) blocks.size(); ++b)
+  {
+    const details::ARFFBlock<eT>& block = blocks[b];
+    size_t entry = 0, offset = valueOffsets[b];
+    for (size_t i = 0; i < block.counts.size(); ++i)
+    {
+      for (size_t j = 0; j < block.counts[i]; ++j, ++entry)
+      {
+        if (block.values[entry] == eT(0))
+          continue;
+
+        rowIndices[offset] = block.rows[entry];
+        values[offset] = block.values[entry];
+        ++offset;
       }
 
-      ++col;
+      colPointers[pointOffsets[b] + i + 1] = offset;
     }
-    ++row;
   }
+
+  matrix = arma::SpMat<eT>(rowIndices, colPointers, values,
+      info.Dimensionality(), numPoints);
 }
 
 } // namespace data
@@ -83,9 +83,11 @@ bool LoadImage(const std::string& filename,
     return false;
   }
 
+  // STB converts the image to the requested number of channels, whatever the
+  // number of channels of the file.
   info.Width() = tempWidth;
   info.Height() = tempHeight;
-  info.Channels() = tempChannels;
+  info.Channels() = (info.Channels() == 1) ? 1 : 3;
 
   // Copy image into armadillo Mat.
   matrix = arma::Mat<unsigned char>(image, info.Width() * info.Height() *
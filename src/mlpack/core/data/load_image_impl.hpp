@@ -16,6 +16,8 @@
 // In case it hasn't been included yet.
 #include "load.hpp"
 
+#include <exception>
+
 namespace mlpack {
 namespace data {
 
@@ -45,12 +47,74 @@ bool Load(const std::string& filename,
   return true;
 }
 
-// Image loading API for multiple files.
+/**
+ * Write the given decoded image to the given column, converted to eT.  If the
+ * output width and height differ from the image, the image is resized with
+ * bilinear interpolation.  The pixels are stored row by row, with their
+ * channels interleaved, as STB decodes them.
+ */
 template<typename eT>
-bool Load(const std::vector<std::string>& files,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
+void WriteImageColumn(const arma::Mat<unsigned char>& image,
+                      const ImageInfo& imageInfo,
+                      const size_t outputWidth,
+                      const size_t outputHeight,
+                      eT* column)
+{
+  const size_t width = imageInfo.Width();
+  const size_t height = imageInfo.Height();
+  const size_t channels = imageInfo.Channels();
+
+  if (width == outputWidth && height == outputHeight)
+  {
+    for (size_t k = 0; k < image.n_elem; ++k)
+      column[k] = eT(image[k]);
+    return;
+  }
+
+  // Position of the center of an output pixel in the input image.
+  const double scaleX = double(width) / outputWidth;
+  const double scaleY = double(height) / outputHeight;
+  for (size_t y = 0; y < outputHeight; ++y)
+  {
+    const double srcY = std::min(std::max((y + 0.5) * scaleY - 0.5, 0.0),
+        double(height - 1));
+    const size_t y0 = (size_t) srcY;
+    const size_t y1 = std::min(y0 + 1, height - 1);
+    const double dy = srcY - y0;
+    for (size_t x = 0; x < outputWidth; ++x)
+    {
+      const double srcX = std::min(std::max((x + 0.5) * scaleX - 0.5, 0.0),
+          double(width - 1));
+      const size_t x0 = (size_t) srcX;
+      const size_t x1 = std::min(x0 + 1, width - 1);
+      const double dx = srcX - x0;
+      for (size_t c = 0; c < channels; ++c)
+      {
+        const double top = (1 - dx) * image[(y0 * width + x0) * channels + c] +
+            dx * image[(y0 * width + x1) * channels + c];
+        const double bottom = (1 - dx) *
+            image[(y1 * width + x0) * channels + c] +
+            dx * image[(y1 * width + x1) * channels + c];
+        const double value = (1 - dy) * top + dy * bottom;
+        column[(y * outputWidth + x) * channels + c] =
+            std::is_integral<eT>::value ? eT(value + 0.5) : eT(value);
+      }
+    }
+  }
+}
+
+/**
+ * Load the given image files into the given matrix, one image per column, and
+ * resize them if resize is true.  The images are decoded in parallel, each
+ * thread with its own buffer.
+ */
+template<typename eT>
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<eT>& matrix,
+                ImageInfo& info,
+                const bool resize,
+                const ImageInfo& targetInfo,
+                const bool fatal)
 {
   if (files.size() == 0)
   {
@@ -65,29 +129,122 @@ bool Load(const std::vector<std::string>& files,
     return false;
   }
 
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
+  if (resize && (targetInfo.Width() == 0 || targetInfo.Height() == 0))
+  {
+    std::ostringstream oss;
+    oss << "Load(): the width and height to resize the images to must be "
+        << "positive." << std::endl;
+
+    if (fatal)
+      Log::Fatal << oss.str();
+    else
+      Log::Warn << oss.str();
 
-  if (!status)
     return false;
+  }
 
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
+  // The first image decides the number of channels, and the dimensions of the
+  // images if they are not resized.
+  arma::Mat<unsigned char> img;
+  if (!LoadImage(files[0], img, info, fatal))
+    return false;
 
-  for (size_t i = 1; i < files.size() ; ++i)
+  const ImageInfo firstInfo(info);
+  const size_t outputWidth = resize ? targetInfo.Width() : info.Width();
+  const size_t outputHeight = resize ? targetInfo.Height() : info.Height();
+
+  matrix.set_size(outputWidth * outputHeight * info.Channels(), files.size());
+  WriteImageColumn(img, info, outputWidth, outputHeight, matrix.colptr(0));
+
+  bool status = true;
+  std::exception_ptr exception;
+  #pragma omp parallel
   {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
+    arma::Mat<unsigned char> buffer;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 1; i < (omp_size_t) files.size(); ++i)
+    {
+      try
+      {
+        ImageInfo imageInfo(firstInfo);
+        bool loaded = LoadImage(files[i], buffer, imageInfo, fatal);
+
+        if (loaded && !resize && (imageInfo.Width() != firstInfo.Width() ||
+            imageInfo.Height() != firstInfo.Height() ||
+            imageInfo.Channels() != firstInfo.Channels()))
+        {
+          std::ostringstream oss;
+          oss << "Load(): dimensions of image '" << files[i] << "' ("
+              << imageInfo.Width() << "x" << imageInfo.Height() << "x"
+              << imageInfo.Channels() << ") do not match the dimensions of "
+              << "the first image (" << firstInfo.Width() << "x"
+              << firstInfo.Height() << "x" << firstInfo.Channels() << ")."
+              << std::endl;
+
+          if (fatal)
+            Log::Fatal << oss.str();
+          else
+            Log::Warn << oss.str();
+
+          loaded = false;
+        }
+
+        if (loaded)
+        {
+          WriteImageColumn(buffer, imageInfo, outputWidth, outputHeight,
+              matrix.colptr(i));
+        }
+        else
+        {
+          #pragma omp critical
+          status = false;
+        }
+      }
+      catch (...)
+      {
+        // Exceptions cannot leave the parallel region; the first one is thrown
+        // once all the images are processed.
+        #pragma omp critical
+        {
+          if (!exception)
+            exception = std::current_exception();
+        }
+      }
+    }
+  }
 
-    if (!status)
-      return false;
+  if (exception)
+    std::rethrow_exception(exception);
+
+  if (resize)
+  {
+    info.Width() = outputWidth;
+    info.Height() = outputHeight;
   }
 
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
-  return true;
+  return status;
+}
+
+// Image loading API for multiple files.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal)
+{
+  return LoadImages(files, matrix, info, false, ImageInfo(), fatal);
+}
+
+// Image loading API for multiple files, with resizing.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const ImageInfo& targetInfo,
+          const bool fatal)
+{
+  return LoadImages(files, matrix, info, true, targetInfo, fatal);
 }
 
 } // namespace data
@@ -19,9 +19,13 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "load_csv.hpp"
+#include "load_numeric_text.hpp"
+#include "load_libsvm.hpp"
+#include "columnar_file.hpp"
 #include "load.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "numa_placement.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -113,6 +117,42 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // mlpack's own binary format isn't handled by Armadillo.
+  if (inputLoadType == arma::auto_detect && Extension(filename) == "mlbin")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack binary dataset.  "
+        << std::flush;
+    try
+    {
+      ColumnarFile<eT> file(filename);
+      file.Load(matrix);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    // The file holds the matrix with one point per column.
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows
+        << ".\n";
+
+    bool success = true;
+    if (!transpose)
+      success = inplace_transpose(matrix, fatal);
+    if (success)
+      PlaceColumns(matrix);
+
+    Timer::Stop("loading_data");
+    return success;
+  }
+
   arma::file_type loadType = inputLoadType;
   std::string stringType;
   if (inputLoadType == arma::auto_detect)
@@ -162,9 +202,18 @@ bool Load(const std::string& filename,
     Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
         << std::flush;
 
+  // Plain numeric text files can be parsed in parallel directly into their
+  // final layout; anything the fast parser doesn't handle goes to Armadillo.
   // We can't use the stream if the type is HDF5.
   bool success;
-  if (loadType != arma::hdf5_binary)
+  bool transposed = false;
+  if ((loadType == arma::csv_ascii || loadType == arma::raw_ascii) &&
+      LoadNumericText(filename, matrix, loadType, transpose))
+  {
+    success = true;
+    transposed = transpose;
+  }
+  else if (loadType != arma::hdf5_binary)
     success = matrix.load(stream, loadType);
   else
     success = matrix.load(filename, loadType);
@@ -180,16 +229,23 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  else if (transposed)
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows
+        << ".\n";
   else
     Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
         << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
   // Now transpose the matrix, if necessary.
-  if (transpose)
+  if (transpose && !transposed)
   {
     success = inplace_transpose(matrix, fatal);
   }
 
+  // Spread the columns over the NUMA nodes of the threads, if requested.
+  if (success)
+    PlaceColumns(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -270,6 +326,39 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "mlbin")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack binary dataset.  "
+        << std::flush;
+    try
+    {
+      ColumnarFile<eT> file(filename);
+      file.Load(matrix);
+
+      // Files saved without mappings hold only numeric data.
+      if (file.HasInfo())
+        file.LoadInfo(info);
+      else
+        info.SetDimensionality(matrix.n_rows);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    // The file holds the matrix with one point per column.
+    if (!transpose && !inplace_transpose(matrix, fatal))
+    {
+      Timer::Stop("loading_data");
+      return false;
+    }
+  }
   else
   {
     // The type is unknown.
@@ -287,6 +376,8 @@ bool Load(const std::string& filename,
   Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
       << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
+  PlaceColumns(matrix);
+
   Timer::Stop("loading_data");
 
   return true;
@@ -323,6 +414,69 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // LibSVM files hold one point per line, so they are already in the
+  // transposed form.  The labels aren't kept; use LoadLibSVM() to get them.
+  if (extension == "svm" || extension == "libsvm" || extension == "svmlight")
+  {
+    Log::Info << "Loading '" << filename << "' as LibSVM data (without its "
+        << "labels).  " << std::flush;
+
+    arma::rowvec labels;
+    std::string error;
+    if (!details::ParseLibSVM(filename, matrix, labels, 0, false, error))
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+      else
+        Log::Warn << "Loading from '" << filename << "' failed: " << error
+            << "." << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows
+        << ".\n";
+    if (!transpose)
+      matrix = matrix.t();
+
+    Timer::Stop("loading_data");
+    return true;
+  }
+
+  // ARFF files also hold one point per line.  Categorical values are mapped,
+  // but the mappings aren't kept; use LoadARFF() to get them.
+  if (extension == "arff")
+  {
+    Log::Info << "Loading '" << filename << "' as ARFF dataset.  "
+        << std::flush;
+    try
+    {
+      DatasetInfo info;
+      LoadARFF(filename, matrix, info);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows
+        << ".\n";
+    if (!transpose)
+      matrix = matrix.t();
+
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
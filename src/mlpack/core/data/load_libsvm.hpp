@@ -0,0 +1,68 @@
+/**
+ * @file core/data/load_libsvm.hpp
+ *
+ * A parallel loader for sparse datasets in the LibSVM / SVMlight format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a sparse dataset in the LibSVM / SVMlight format, where each line holds
+ * the label of a point followed by its nonzero features:
+ *
+ * @code
+ * <label> <index>:<value> <index>:<value> ... # comment
+ * @endcode
+ *
+ * Each line becomes a column of the sparse matrix, and each index a row;
+ * indices are 1-based unless zeroBased is true.  Empty lines, comments (from
+ * '#' to the end of the line) and SVMlight "qid:" tokens are ignored, and so
+ * are explicit zero values.  The indices of a line don't need to be sorted,
+ * but each may only appear once.
+ *
+ * The file is memory-mapped and parsed in parallel, one block of lines per
+ * thread, and the matrix is assembled directly in compressed sparse column
+ * form, without an intermediate list of (row, column, value) triplets.  The
+ * result can be given directly to the methods that take sparse matrices, such
+ * as LogisticRegression<arma::sp_mat> (with the labels as an arma::rowvec or,
+ * if they are 0 and 1, an arma::Row<size_t>) or CFType::Train(), for which
+ * each line is a user and each index an item.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the file can't be loaded; otherwise a warning is printed and
+ * false is returned.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Sparse matrix to load the features into, one point per column.
+ * @param labels Row vector to load the labels into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param numFeatures Number of rows of the matrix; if 0, it is one more than
+ *     the largest index in the file.
+ * @param zeroBased Whether the indices in the file start at 0 (default false).
+ * @return Whether the file was loaded.
+ */
+template<typename eT, typename LabelType>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const bool fatal = false,
+                const size_t numFeatures = 0,
+                const bool zeroBased = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_libsvm_impl.hpp"
+
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file core/data/load_libsvm_impl.hpp
+ *
+ * Implementation of the parallel loader for LibSVM / SVMlight files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_LIBSVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_libsvm.hpp"
+
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/timers.hpp>
+#include "load_numeric_text.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * The points parsed from one block of lines of a LibSVM file, in compressed
+ * sparse column form relative to the block.
+ */
+template<typename eT, typename LabelType>
+struct LibSVMBlock
+{
+  LibSVMBlock() : numIndices(0), lines(0), errorLine(0) { }
+
+  //! The label of each point.
+  std::vector<LabelType> labels;
+  //! The number of nonzero values of each point.
+  std::vector<arma::uword> counts;
+  //! The (0-based) index of each nonzero value.
+  std::vector<arma::uword> rows;
+  //! The nonzero values.
+  std::vector<eT> values;
+  //! One more than the largest index of the block.
+  size_t numIndices;
+  //! The number of lines of the block.
+  size_t lines;
+  //! The line of the block (counted from 1) that couldn't be parsed, if any.
+  size_t errorLine;
+  //! The reason why that line couldn't be parsed.
+  std::string error;
+};
+
+/**
+ * Parse the line [begin, end) (without its newline) of a LibSVM file, and
+ * append its point, if it holds one, to the given block.
+ *
+ * @return Whether the line could be parsed; if not, block.error is set.
+ */
+template<typename eT, typename LabelType>
+bool ParseLibSVMLine(const char* begin,
+                     const char* end,
+                     const bool zeroBased,
+                     LibSVMBlock<eT, LabelType>& block)
+{
+  // Ignore the carriage return of Windows line endings, and comments.
+  if (end > begin && *(end - 1) == '\r')
+    --end;
+  const char* comment = (const char*) std::memchr(begin, '#', end - begin);
+  if (comment)
+    end = comment;
+
+  const char* p = begin;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    ++p;
+  if (p == end)
+    return true; // Nothing on this line.
+
+  const char* tokenEnd = p;
+  while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t')
+    ++tokenEnd;
+
+  LabelType label;
+  if (!ParseNumericToken(p, tokenEnd, label))
+  {
+    block.error = "invalid label '" + std::string(p, tokenEnd) + "'";
+    return false;
+  }
+
+  const size_t first = block.rows.size();
+  bool sorted = true;
+  while (true)
+  {
+    p = tokenEnd;
+    while (p < end && (*p == ' ' || *p == '\t'))
+      ++p;
+    if (p == end)
+      break;
+
+    tokenEnd = p;
+    while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t')
+      ++tokenEnd;
+
+    const char* colon = (const char*) std::memchr(p, ':', tokenEnd - p);
+    if (!colon)
+    {
+      block.error = "expected index:value, found '" +
+          std::string(p, tokenEnd) + "'";
+      return false;
+    }
+
+    // SVMlight query identifiers aren't features.
+    if (colon - p == 3 && std::strncmp(p, "qid", 3) == 0)
+      continue;
+
+    size_t index;
+    eT value;
+    if (!ParseNumericToken(p, colon, index) ||
+        !ParseNumericToken(colon + 1, tokenEnd, value) ||
+        (!zeroBased && index == 0))
+    {
+      block.error = "invalid index:value '" + std::string(p, tokenEnd) + "'";
+      return false;
+    }
+
+    if (!zeroBased)
+      --index;
+
+    if (value == eT(0))
+      continue;
+
+    if (block.rows.size() > first && index <= block.rows.back())
+      sorted = false;
+    block.rows.push_back(index);
+    block.values.push_back(value);
+  }
+
+  // Sort the indices of the point, if they weren't already.
+  const size_t count = block.rows.size() - first;
+  if (!sorted)
+  {
+    std::vector<std::pair<arma::uword, eT>> pairs(count);
+    for (size_t i = 0; i < count; ++i)
+      pairs[i] = std::make_pair(block.rows[first + i],
+          block.values[first + i]);
+
+    std::sort(pairs.begin(), pairs.end(),
+        [](const std::pair<arma::uword, eT>& a,
+           const std::pair<arma::uword, eT>& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (i > 0 && pairs[i].first == pairs[i - 1].first)
+      {
+        std::ostringstream oss;
+        oss << "index " << (pairs[i].first + (zeroBased ? 0 : 1))
+            << " appears twice";
+        block.error = oss.str();
+        return false;
+      }
+
+      block.rows[first + i] = pairs[i].first;
+      block.values[first + i] = pairs[i].second;
+    }
+  }
+
+  if (count > 0)
+    block.numIndices = std::max(block.numIndices,
+        size_t(block.rows.back() + 1));
+  block.labels.push_back(label);
+  block.counts.push_back(count);
+  return true;
+}
+
+/**
+ * Parse the given LibSVM file.  Errors aren't reported; instead, false is
+ * returned and the reason is stored in error.
+ */
+template<typename eT, typename LabelType>
+bool ParseLibSVM(const std::string& filename,
+                 arma::SpMat<eT>& matrix,
+                 arma::Row<LabelType>& labels,
+                 const size_t numFeatures,
+                 const bool zeroBased,
+                 std::string& error)
+{
+  TextFileView file(filename);
+  if (!file.IsOpen())
+  {
+    error = "cannot open file";
+    return false;
+  }
+
+  const char* data = file.Data();
+  const size_t size = file.Size();
+
+  // Split the file into one block per thread; each block starts at the start
+  // of a line.  Small files aren't worth splitting.
+#ifdef HAS_OPENMP
+  const size_t maxBlocks = omp_get_max_threads();
+#else
+  const size_t maxBlocks = 1;
+#endif
+  const size_t minBlockSize = 1 << 20;
+  const size_t numBlocks = std::max(size_t(1),
+      std::min(maxBlocks, size / minBlockSize));
+
+  std::vector<size_t> blockBegin(numBlocks + 1);
+  blockBegin[0] = 0;
+  blockBegin[numBlocks] = size;
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    const size_t position = std::max(b * (size / numBlocks), blockBegin[b - 1]);
+    const char* newline = (const char*) std::memchr(data + position, '\n',
+        size - position);
+    blockBegin[b] = newline ? (newline - data) + 1 : size;
+  }
+
+  // Parse each block on its own.
+  std::vector<LibSVMBlock<eT, LabelType>> blocks(numBlocks);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    LibSVMBlock<eT, LabelType>& block = blocks[b];
+    const char* p = data + blockBegin[b];
+    const char* end = data + blockBegin[b + 1];
+    while (p < end)
+    {
+      const char* newline = (const char*) std::memchr(p, '\n', end - p);
+      const char* lineEnd = newline ? newline : end;
+      ++block.lines;
+      if (!ParseLibSVMLine(p, lineEnd, zeroBased, block))
+      {
+        block.errorLine = block.lines;
+        break;
+      }
+
+      p = lineEnd + 1;
+    }
+  }
+
+  // Find the offsets of the points and values of each block, and report the
+  // first error.
+  std::vector<size_t> pointOffsets(numBlocks + 1, 0);
+  std::vector<size_t> valueOffsets(numBlocks + 1, 0);
+  size_t numIndices = 0, line = 0;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    if (blocks[b].errorLine > 0)
+    {
+      std::ostringstream oss;
+      oss << "line " << (line + blocks[b].errorLine) << ": "
+          << blocks[b].error;
+      error = oss.str();
+      return false;
+    }
+
+    line += blocks[b].lines;
+    pointOffsets[b + 1] = pointOffsets[b] + blocks[b].labels.size();
+    valueOffsets[b + 1] = valueOffsets[b] + blocks[b].rows.size();
+    numIndices = std::max(numIndices, blocks[b].numIndices);
+  }
+
+  if (numFeatures > 0 && numIndices > numFeatures)
+  {
+    std::ostringstream oss;
+    oss << "index " << (numIndices - (zeroBased ? 1 : 0)) << " is larger than "
+        << "the given number of features (" << numFeatures << ")";
+    error = oss.str();
+    return false;
+  }
+
+  // Copy the blocks directly into the compressed sparse column arrays.
+  const size_t numPoints = pointOffsets[numBlocks];
+  arma::uvec rowIndices(valueOffsets[numBlocks]);
+  arma::uvec colPointers(numPoints + 1);
+  arma::Col<eT> values(valueOffsets[numBlocks]);
+  labels.set_size(numPoints);
+  colPointers[0] = 0;
+
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const LibSVMBlock<eT, LabelType>& block = blocks[b];
+    std::copy(block.rows.begin(), block.rows.end(),
+        rowIndices.begin() + valueOffsets[b]);
+    std::copy(block.values.begin(), block.values.end(),
+        values.begin() + valueOffsets[b]);
+
+    size_t offset = valueOffsets[b];
+    for (size_t i = 0; i < block.labels.size(); ++i)
+    {
+      labels[pointOffsets[b] + i] = block.labels[i];
+      offset += block.counts[i];
+      colPointers[pointOffsets[b] + i + 1] = offset;
+    }
+  }
+
+  matrix = arma::SpMat<eT>(rowIndices, colPointers, values,
+      (numFeatures > 0) ? numFeatures : numIndices, numPoints);
+  return true;
+}
+
+} // namespace details
+
+template<typename eT, typename LabelType>
+bool LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const bool fatal,
+                const size_t numFeatures,
+                const bool zeroBased)
+{
+  Timer::Start("loading_data");
+  Log::Info << "Loading '" << filename << "' as LibSVM data.  " << std::flush;
+
+  std::string error;
+  if (!details::ParseLibSVM(filename, matrix, labels, numFeatures, zeroBased,
+      error))
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Loading from '" << filename << "' failed: " << error
+          << "." << std::endl;
+    else
+      Log::Warn << "Loading from '" << filename << "' failed: " << error
+          << "." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows << ".\n";
+  Timer::Stop("loading_data");
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/binary.hpp>
 #include <cereal/archives/json.hpp>
+#include <mlpack/core/cereal/aligned_binary.hpp>
 
 namespace mlpack {
 namespace data {
@@ -37,7 +38,8 @@ bool Load(const std::string& filename,
           const std::string& name,
           T& t,
           const bool fatal,
-          format f)
+          format f,
+          const bool predictionOnly)
 {
   if (f == format::autodetect)
   {
@@ -65,7 +67,7 @@ bool Load(const std::string& filename,
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
+  if (f == format::binary || f == format::aligned_binary)
     ifs.open(filename, std::ifstream::in | std::ifstream::binary);
   else
     ifs.open(filename, std::ifstream::in);
@@ -84,6 +86,15 @@ bool Load(const std::string& filename,
 
     return false;
   }
+  // Files saved with format::aligned_binary have the .bin extension too, and
+  // are recognized by their header.
+  if (f == format::binary || f == format::aligned_binary)
+  {
+    f = cereal::ReadAlignedBinaryHeader(ifs) ? format::aligned_binary :
+        format::binary;
+  }
+
+  cereal::PredictionOnlyScope predictionOnlyScope(predictionOnly);
   try
   {
     if (f == format::xml)
@@ -101,6 +112,12 @@ bool Load(const std::string& filename,
       cereal::BinaryInputArchive ar(ifs);
       ar(cereal::make_nvp(name.c_str(), t));
     }
+    else if (f == format::aligned_binary)
+    {
+      cereal::BinaryInputArchive ar(ifs);
+      cereal::AlignedBinaryScope scope(&ar, NULL);
+      ar(cereal::make_nvp(name.c_str(), t));
+    }
 
     return true;
   }
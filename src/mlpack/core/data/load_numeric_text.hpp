@@ -0,0 +1,54 @@
+/**
+ * @file core/data/load_numeric_text.hpp
+ *
+ * A parallel loader for plain numeric CSV and whitespace-separated text files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_NUMERIC_TEXT_HPP
+#define MLPACK_CORE_DATA_LOAD_NUMERIC_TEXT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a plain numeric text file (arma::csv_ascii or arma::raw_ascii) in
+ * parallel.  The file is memory-mapped and split into one block of lines per
+ * thread; each thread counts the lines of its block, and then parses them
+ * directly into their final place in the matrix, so that no intermediate copy
+ * or transpose is needed.
+ *
+ * Only the simplest files are handled: every line must hold the same number of
+ * values, separated by commas (for csv_ascii) or spaces and tabs (for
+ * raw_ascii), with no quotes, empty fields or empty lines.  Values are parsed
+ * with std::strtod() (or std::strtoll() / std::strtoull() for integer types),
+ * so they are read exactly like Armadillo reads them.  If anything else is
+ * found, false is returned and the matrix is left empty; the caller should
+ * then load the file with Armadillo, which will either handle it or report the
+ * problem.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Matrix to load the data into.
+ * @param type Type of the file; must be arma::csv_ascii or arma::raw_ascii.
+ * @param transpose If true, each line of the file becomes a column of the
+ *     matrix; otherwise, each line becomes a row.
+ * @return Whether the file was loaded.
+ */
+template<typename eT>
+bool LoadNumericText(const std::string& filename,
+                     arma::Mat<eT>& matrix,
+                     const arma::file_type type,
+                     const bool transpose);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_numeric_text_impl.hpp"
+
+#endif
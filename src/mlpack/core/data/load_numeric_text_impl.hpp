@@ -0,0 +1,380 @@
+/**
+ * @file core/data/load_numeric_text_impl.hpp
+ *
+ * Implementation of the parallel loader for plain numeric text files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_NUMERIC_TEXT_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_NUMERIC_TEXT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_numeric_text.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+namespace details {
+
+/**
+ * A read-only view of the contents of a file.  The file is memory-mapped where
+ * possible, and read into memory otherwise.  The contents are not terminated by
+ * a null character.
+ */
+class TextFileView
+{
+ public:
+  //! Open the given file; use IsOpen() to see whether that worked.
+  TextFileView(const std::string& filename) :
+      data(NULL),
+      size(0),
+      isMapped(false),
+      isOpen(false)
+  {
+#if !defined(_WIN32)
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+      close(fd);
+      return;
+    }
+
+    size = (size_t) fileStat.st_size;
+    if (size > 0)
+    {
+      void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED)
+      {
+        // The file is read sequentially by each thread.
+        madvise(address, size, MADV_SEQUENTIAL);
+        data = (const char*) address;
+        isMapped = true;
+      }
+    }
+    close(fd);
+
+    if (isMapped || size == 0)
+    {
+      isOpen = true;
+      return;
+    }
+#endif
+
+    // There is no mmap() (or it failed); read the whole file instead.
+    std::ifstream f(filename, std::ios::binary | std::ios::ate);
+    if (!f.is_open())
+      return;
+
+    size = (size_t) f.tellg();
+    f.seekg(0);
+    buffer.resize(size);
+    if (size > 0 && !f.read(buffer.data(), size))
+      return;
+
+    data = buffer.data();
+    isOpen = true;
+  }
+
+  //! Copying is not allowed, since the object owns the mapping.
+  TextFileView(const TextFileView& other) = delete;
+  //! Copying is not allowed, since the object owns the mapping.
+  TextFileView& operator=(const TextFileView& other) = delete;
+
+  //! Release the mapping.
+  ~TextFileView()
+  {
+#if !defined(_WIN32)
+    if (isMapped)
+      munmap((void*) data, size);
+#endif
+  }
+
+  //! Get whether the file could be read.
+  bool IsOpen() const { return isOpen; }
+  //! Get the contents of the file.
+  const char* Data() const { return data; }
+  //! Get the size of the file.
+  size_t Size() const { return size; }
+
+ private:
+  //! The contents of the file.
+  const char* data;
+  //! The size of the file.
+  size_t size;
+  //! Whether the contents are mapped (or held in the buffer).
+  bool isMapped;
+  //! Whether the file could be read.
+  bool isOpen;
+  //! The contents of the file, if it isn't mapped.
+  std::vector<char> buffer;
+};
+
+//! Convert a null-terminated token to a floating-point (or other non-integer)
+//! value.
+template<typename eT>
+typename std::enable_if<!std::is_integral<eT>::value, eT>::type
+ConvertNumericToken(const char* token, char** end)
+{
+  return eT(std::strtod(token, end));
+}
+
+//! Convert a null-terminated token to a signed integer value.
+template<typename eT>
+typename std::enable_if<std::is_integral<eT>::value &&
+    std::is_signed<eT>::value, eT>::type
+ConvertNumericToken(const char* token, char** end)
+{
+  return eT(std::strtoll(token, end, 10));
+}
+
+//! Convert a null-terminated token to an unsigned integer value.  Negative
+//! values are not converted.
+template<typename eT>
+typename std::enable_if<std::is_integral<eT>::value &&
+    !std::is_signed<eT>::value, eT>::type
+ConvertNumericToken(const char* token, char** end)
+{
+  if (*token == '-')
+  {
+    *end = const_cast<char*>(token);
+    return eT(0);
+  }
+
+  return eT(std::strtoull(token, end, 10));
+}
+
+/**
+ * Parse the token [begin, end) as a number.  The token is copied to a buffer
+ * first, since the contents of the file aren't null-terminated.
+ *
+ * @return Whether the whole token is a number.
+ */
+template<typename eT>
+inline bool ParseNumericToken(const char* begin, const char* end, eT& value)
+{
+  const size_t length = end - begin;
+  char token[64];
+  if (length == 0 || length >= sizeof(token))
+    return false;
+
+  std::memcpy(token, begin, length);
+  token[length] = '\0';
+
+  char* tokenEnd;
+  value = ConvertNumericToken<eT>(token, &tokenEnd);
+  return (tokenEnd == token + length);
+}
+
+/**
+ * Parse the line [begin, end) (without its newline) of a numeric text file.
+ * If values is not NULL, the i'th value is stored in values[i * stride], and
+ * parsing stops (with an error) if there are more than maxValues values.
+ *
+ * @param begin Start of the line.
+ * @param end End of the line.
+ * @param commas Whether values are separated by commas (or by whitespace).
+ * @param values Location to store the values at; may be NULL.
+ * @param stride Distance between consecutive values in memory.
+ * @param maxValues Maximum number of values to store.
+ * @return The number of values on the line, or size_t(-1) if the line can't be
+ *     parsed.
+ */
+template<typename eT>
+size_t ParseNumericLine(const char* begin,
+                        const char* end,
+                        const bool commas,
+                        eT* values,
+                        const size_t stride,
+                        const size_t maxValues)
+{
+  // Ignore the carriage return of Windows line endings.
+  if (end > begin && *(end - 1) == '\r')
+    --end;
+
+  const char* p = begin;
+  size_t numValues = 0;
+  while (true)
+  {
+    while (p < end && (*p == ' ' || *p == '\t'))
+      ++p;
+    // Trailing whitespace is fine, but a trailing comma (or an empty line) is
+    // an empty field.
+    if (p == end && !commas)
+      break;
+
+    const char* tokenEnd = p;
+    while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t' &&
+        *tokenEnd != ',')
+      ++tokenEnd;
+
+    eT value;
+    if (!ParseNumericToken(p, tokenEnd, value))
+      return size_t(-1);
+
+    if (values)
+    {
+      if (numValues == maxValues)
+        return size_t(-1);
+      values[numValues * stride] = value;
+    }
+    ++numValues;
+
+    p = tokenEnd;
+    if (commas)
+    {
+      while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+      if (p == end)
+        break;
+      if (*p != ',')
+        return size_t(-1);
+      ++p;
+    }
+  }
+
+  return numValues;
+}
+
+} // namespace details
+
+template<typename eT>
+bool LoadNumericText(const std::string& filename,
+                     arma::Mat<eT>& matrix,
+                     const arma::file_type type,
+                     const bool transpose)
+{
+  matrix.reset();
+  if (type != arma::csv_ascii && type != arma::raw_ascii)
+    return false;
+
+  details::TextFileView file(filename);
+  if (!file.IsOpen() || file.Size() == 0)
+    return false;
+
+  const char* data = file.Data();
+  const size_t size = file.Size();
+  const bool commas = (type == arma::csv_ascii);
+
+  // The first line gives the number of dimensions.
+  const char* firstNewline = (const char*) std::memchr(data, '\n', size);
+  const size_t dimensionality = details::ParseNumericLine<eT>(data,
+      firstNewline ? firstNewline : data + size, commas, NULL, 0, 0);
+  if (dimensionality == 0 || dimensionality == size_t(-1))
+    return false;
+
+  // Split the file into one block per thread; each block starts at the start
+  // of a line.  Small files aren't worth splitting.
+#ifdef HAS_OPENMP
+  const size_t maxBlocks = omp_get_max_threads();
+#else
+  const size_t maxBlocks = 1;
+#endif
+  const size_t minBlockSize = 1 << 20;
+  const size_t numBlocks = std::max(size_t(1),
+      std::min(maxBlocks, size / minBlockSize));
+
+  std::vector<size_t> blockBegin(numBlocks + 1);
+  blockBegin[0] = 0;
+  blockBegin[numBlocks] = size;
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    const size_t position = std::max(b * (size / numBlocks), blockBegin[b - 1]);
+    const char* newline = (const char*) std::memchr(data + position, '\n',
+        size - position);
+    blockBegin[b] = newline ? (newline - data) + 1 : size;
+  }
+
+  // Count the lines of each block, and then find the index of the first line
+  // of each block.
+  std::vector<size_t> blockFirstLine(numBlocks + 1, 0);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const char* p = data + blockBegin[b];
+    const char* end = data + blockBegin[b + 1];
+    size_t lines = 0;
+    while (p < end)
+    {
+      ++lines;
+      const char* newline = (const char*) std::memchr(p, '\n', end - p);
+      if (!newline)
+        break;
+      p = newline + 1;
+    }
+
+    blockFirstLine[b + 1] = lines;
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    blockFirstLine[b + 1] += blockFirstLine[b];
+  const size_t numLines = blockFirstLine[numBlocks];
+
+  // Each line is a column of the (transposed) matrix, or a row otherwise.
+  if (transpose)
+    matrix.set_size(dimensionality, numLines);
+  else
+    matrix.set_size(numLines, dimensionality);
+
+  eT* memory = matrix.memptr();
+  const size_t lineStride = transpose ? dimensionality : 1;
+  const size_t valueStride = transpose ? 1 : numLines;
+
+  // Now parse each block directly into the matrix.  (std::vector<bool> can't be
+  // written to from different threads.)
+  std::vector<char> blockFailed(numBlocks, 0);
+  #pragma omp parallel for schedule(static, 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const char* p = data + blockBegin[b];
+    const char* end = data + blockBegin[b + 1];
+    size_t line = blockFirstLine[b];
+    while (p < end)
+    {
+      const char* newline = (const char*) std::memchr(p, '\n', end - p);
+      const char* lineEnd = newline ? newline : end;
+      const size_t numValues = details::ParseNumericLine(p, lineEnd, commas,
+          memory + line * lineStride, valueStride, dimensionality);
+      if (numValues != dimensionality)
+      {
+        blockFailed[b] = 1;
+        break;
+      }
+
+      ++line;
+      p = lineEnd + 1;
+    }
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    if (blockFailed[b])
+    {
+      matrix.reset();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -80,10 +80,10 @@ class IncrementPolicy
    * the given dimension. This function is used as a helper function for
    * DatasetMapper class.
    *
-   * @tparam MapType Type of unordered_map that contains mapped value pairs
+   * @tparam MapType Type of the vector of DimensionMaps of the DatasetMapper.
    * @param input Input to find/create mapping for.
    * @param dimension Index of the dimension of the input.
-   * @param maps Unordered map given by the DatasetMapper.
+   * @param maps DimensionMap of each dimension, given by the DatasetMapper.
    * @param types Vector containing the type information about each dimensions.
    */
   template<typename MapType, typename T, typename InputType>
@@ -112,33 +112,23 @@ class IncrementPolicy
     // If this condition is true, either we have no mapping for the given input
     // or we have no mappings for the given dimension at all.  In either case,
     // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
+    const MappedType* value = maps[dimension].Find(input);
+    if (value == NULL)
     {
       // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
+      const size_t numMappings = maps[dimension].Size();
 
       // Change type of the feature to categorical.
       if (numMappings == 0)
         types[dimension] = Datatype::categorical;
 
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
-
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
-
+      maps[dimension].Insert(input, numMappings);
       return T(numMappings);
     }
     else
     {
       // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
+      return T(*value);
     }
   }
 
@@ -73,10 +73,10 @@ class MissingPolicy
    * dimension. This function is used as a helper function for DatasetMapper
    * class.
    *
-   * @tparam MapType Type of unordered_map that contains mapped value pairs
+   * @tparam MapType Type of the vector of DimensionMaps of the DatasetMapper.
    * @param string String to find/create mapping for.
    * @param dimension Index of the dimension of the string.
-   * @param maps Unordered map given by the DatasetMapper.
+   * @param maps DimensionMap of each dimension, given by the DatasetMapper.
    * @param * (types) Vector containing the type information about each
    *          dimensions.
    */
@@ -95,11 +95,7 @@ class MissingPolicy
     T t;
     token >> t; // Could be sped up by only doing this if we need to.
 
-    MappedType value = std::numeric_limits<MappedType>::quiet_NaN();
-    // But we can't use that for the map, so we need some other thing that will
-    // represent quiet_NaN().
-    const MappedType mapValue = std::nexttoward(
-        std::numeric_limits<MappedType>::max(), MappedType(0));
+    const MappedType value = std::numeric_limits<MappedType>::quiet_NaN();
 
     // If extraction of the value fails, or if it is a value that is supposed to
     // be mapped, then do mapping.
@@ -108,22 +104,8 @@ class MissingPolicy
     {
       // Everything is mapped to NaN.  However we must still keep track of
       // everything that we have mapped, so we add it to the maps if needed.
-      if (maps.count(dimension) == 0 ||
-          maps[dimension].first.count(string) == 0)
-      {
-        // This string does not exist yet.
-        typedef std::pair<std::string, MappedType> PairType;
-        maps[dimension].first.insert(PairType(string, value));
-
-        // Insert right mapping too.
-        if (maps[dimension].second.count(mapValue) == 0)
-        {
-          // Create new element in reverse map.
-          maps[dimension].second.insert(std::make_pair(mapValue,
-              std::vector<std::string>()));
-        }
-        maps[dimension].second[mapValue].push_back(string);
-      }
+      if (maps[dimension].Find(string) == NULL)
+        maps[dimension].Insert(string, value);
 
       return value;
     }
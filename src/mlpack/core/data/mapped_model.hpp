@@ -0,0 +1,107 @@
+/**
+ * @file core/data/mapped_model.hpp
+ *
+ * Definition of the MappedModel class, which loads a model saved with
+ * format::aligned_binary by memory-mapping the file, so that the Armadillo
+ * objects of the model alias the file instead of being read.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/cereal/aligned_binary.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The MappedModel class holds a model loaded from a file saved by data::Save()
+ * with format::aligned_binary.  The file is memory-mapped, and the matrices
+ * (and vectors) of the model alias the mapped memory instead of being read, so
+ * loading a large model (such as the reference set of an NSModel, or the trees
+ * of a RandomForestModel) takes about as long as deserializing its small
+ * members; the pages of the matrices are only read when they are used, and can
+ * be shared between processes.  Cubes and sparse matrices are read into their
+ * own memory.
+ *
+ * The mapping is private: modifying the model never modifies the file, and a
+ * matrix that is resized allocates its own memory, as usual.  The mapping is
+ * released when the MappedModel is destroyed, so the model must not be moved
+ * out of it, and the file must not be modified while it is mapped.  On systems
+ * without mmap(), the file is read into memory in one call, and the matrices
+ * alias that memory.
+ *
+ * @code
+ * data::Save("model.bin", "model", model, true, data::format::aligned_binary);
+ *
+ * // Later.
+ * data::MappedModel<NSModel<NearestNeighborSort>> mapped("model.bin", "model",
+ *     true);
+ * mapped.Model().Search(...);
+ * @endcode
+ *
+ * @tparam ModelType Type of the model; it must be default-constructible and
+ *     serializable.
+ */
+template<typename ModelType>
+class MappedModel
+{
+ public:
+  /**
+   * Map the given file and load the model in it.  A std::runtime_error is
+   * thrown if the file can't be opened or mapped, if it was not saved with
+   * format::aligned_binary, or if the model can't be loaded from it.
+   *
+   * @param filename File to map.
+   * @param name Name the model was saved with.
+   * @param predictionOnly Whether to load the model for prediction only (see
+   *     data::Load()).
+   */
+  MappedModel(const std::string& filename,
+              const std::string& name,
+              const bool predictionOnly = false);
+
+  //! Copying is not allowed, since the object owns the mapping.
+  MappedModel(const MappedModel& other) = delete;
+  //! Copying is not allowed, since the object owns the mapping.
+  MappedModel& operator=(const MappedModel& other) = delete;
+
+  /**
+   * Destroy the model and release the mapping.
+   */
+  ~MappedModel();
+
+  //! Get the model.
+  const ModelType& Model() const { return *model; }
+  //! Modify the model.
+  ModelType& Model() { return *model; }
+
+  //! Get whether the file is really mapped (or was read into memory).
+  bool IsMapped() const { return isMapped; }
+
+ private:
+  //! Release the mapped memory.
+  void Unmap();
+
+  //! The mapped memory.
+  char* memory;
+  //! The size of the mapped memory.
+  size_t memorySize;
+  //! Whether the memory is a real mapping (or a plain copy of the file).
+  bool isMapped;
+  //! The model.
+  ModelType* model;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_model_impl.hpp"
+
+#endif
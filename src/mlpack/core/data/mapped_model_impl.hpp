@@ -0,0 +1,150 @@
+/**
+ * @file core/data/mapped_model_impl.hpp
+ *
+ * Implementation of the MappedModel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_model.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <cereal/archives/binary.hpp>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+template<typename ModelType>
+MappedModel<ModelType>::MappedModel(const std::string& filename,
+                                    const std::string& name,
+                                    const bool predictionOnly) :
+    memory(NULL),
+    memorySize(0),
+    isMapped(false),
+    model(NULL)
+{
+#if !defined(_WIN32)
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("MappedModel::MappedModel(): cannot open file '"
+        + filename + "'!");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedModel::MappedModel(): cannot get size of "
+        "file '" + filename + "'!");
+  }
+  memorySize = (size_t) fileStat.st_size;
+
+  // The mapping is private and writable, so the matrices can be used like any
+  // other matrices; pages are only copied if they are written to.
+  void* address = (memorySize == 0) ? MAP_FAILED : mmap(NULL, memorySize,
+      PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    throw std::runtime_error("MappedModel::MappedModel(): cannot map file '"
+        + filename + "'!");
+  }
+
+  memory = (char*) address;
+  isMapped = true;
+#else
+  // There is no mmap(); read the whole file instead.
+  std::ifstream f(filename, std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+  {
+    throw std::runtime_error("MappedModel::MappedModel(): cannot open file '"
+        + filename + "'!");
+  }
+
+  memorySize = (size_t) f.tellg();
+  f.seekg(0);
+  memory = (char*) std::malloc(memorySize);
+  if (!memory || !f.read(memory, memorySize))
+  {
+    Unmap();
+    throw std::runtime_error("MappedModel::MappedModel(): cannot read file '"
+        + filename + "'!");
+  }
+#endif
+
+  if (memorySize < cereal::AlignedBinaryHeaderSize ||
+      std::memcmp(memory, cereal::AlignedBinaryHeader,
+          cereal::AlignedBinaryHeaderSize) != 0)
+  {
+    Unmap();
+    throw std::runtime_error("MappedModel::MappedModel(): file '" + filename
+        + "' was not saved with format::aligned_binary!");
+  }
+
+  try
+  {
+    model = new ModelType();
+    cereal::AlignedBinaryBuffer buffer(memory, memorySize);
+    std::istream stream(&buffer);
+    cereal::BinaryInputArchive ar(stream);
+    cereal::AlignedBinaryScope scope(&ar, NULL, &buffer);
+    cereal::PredictionOnlyScope predictionOnlyScope(predictionOnly);
+    ar(cereal::make_nvp(name.c_str(), *model));
+  }
+  catch (cereal::Exception& e)
+  {
+    delete model;
+    Unmap();
+    throw std::runtime_error("MappedModel::MappedModel(): cannot load model "
+        "from file '" + filename + "': " + e.what());
+  }
+}
+
+template<typename ModelType>
+MappedModel<ModelType>::~MappedModel()
+{
+  // The model may alias the memory, so it is destroyed first.
+  delete model;
+  Unmap();
+}
+
+template<typename ModelType>
+void MappedModel<ModelType>::Unmap()
+{
+  if (!memory)
+    return;
+
+#if !defined(_WIN32)
+  if (isMapped)
+    munmap(memory, memorySize);
+  else
+    std::free(memory);
+#else
+  std::free(memory);
+#endif
+
+  memory = NULL;
+  memorySize = 0;
+  isMapped = false;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
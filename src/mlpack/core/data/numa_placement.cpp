@@ -0,0 +1,20 @@
+/**
+ * @file core/data/numa_placement.cpp
+ *
+ * Definition of the global NUMA placement setting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "numa_placement.hpp"
+
+namespace mlpack {
+namespace data {
+
+// Whether PlaceColumns() moves matrices.
+MLPACK_EXPORT bool numaPlacement = false;
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,91 @@
+/**
+ * @file core/data/numa_placement.hpp
+ *
+ * Place the columns of large matrices in the memory of the NUMA nodes of the
+ * threads that use them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_NUMA_PLACEMENT_HPP
+#define MLPACK_CORE_DATA_NUMA_PLACEMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/mlpack_export.hpp>
+#include <mlpack/core/util/parallel.hpp>
+
+namespace mlpack {
+namespace data /** Functions to load and save matrices and models. */ {
+
+// Whether PlaceColumns() moves matrices (false by default).
+extern MLPACK_EXPORT bool numaPlacement;
+
+/**
+ * Enable or disable the placement of large dense matrices by PlaceColumns(),
+ * which data::Load() and the trees that reorder their points call.  This is
+ * useful on machines with several NUMA nodes, where a matrix that is written
+ * by a single thread ends up in the memory of a single node, so that the
+ * parallel scans over its columns are limited by the bandwidth of that node.
+ * It is disabled by default, since placing a matrix copies it.
+ *
+ * @param enable Whether to place the matrices.
+ */
+inline void SetNumaPlacement(const bool enable) { numaPlacement = enable; }
+
+//! Get whether the placement of large dense matrices is enabled.
+inline bool NumaPlacement() { return numaPlacement; }
+
+/**
+ * If NUMA placement is enabled (see SetNumaPlacement()), move the given
+ * matrix into new memory whose columns are first written by the threads of a
+ * static schedule over the columns: thread t writes the t-th contiguous block
+ * of columns, so with the usual first-touch policy of the operating system
+ * each block lives on the node of the thread that will scan it in the loops
+ * that use a static schedule (`#pragma omp parallel for schedule(static)`).
+ * The threads should be bound to their cores for this to last (for instance
+ * with OMP_PROC_BIND=close); to interleave the pages of all matrices across
+ * the nodes instead, run the program under `numactl --interleave=all`.
+ *
+ * Nothing is done without OpenMP, with a single thread, or for matrices smaller
+ * than a few megabytes, whose columns share too few pages to be worth it.
+ *
+ * @param matrix Matrix to place.
+ */
+template<typename eT>
+void PlaceColumns(arma::Mat<eT>& matrix)
+{
+  #ifdef HAS_OPENMP
+    if (!numaPlacement || util::NumThreads() < 2 ||
+        matrix.n_elem * sizeof(eT) < (size_t(1) << 22))
+      return;
+
+    // set_size() doesn't write to the memory, so its pages aren't placed yet.
+    arma::Mat<eT> placed;
+    placed.set_size(matrix.n_rows, matrix.n_cols);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) matrix.n_cols; ++j)
+      std::copy(matrix.colptr(j), matrix.colptr(j) + matrix.n_rows,
+          placed.colptr(j));
+
+    matrix.steal_mem(placed);
+  #else
+    (void) matrix;
+  #endif
+}
+
+/**
+ * Matrices other than dense matrices are left where they are.
+ */
+template<typename MatType>
+void PlaceColumns(MatType& /* matrix */)
+{
+  // Nothing to do.
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -33,6 +33,17 @@ template<typename RowType, typename MatType>
 void OneHotEncoding(const RowType& labelsIn,
                     MatType& output);
 
+/**
+ * Overload of the function above that writes a sparse matrix; the matrix is
+ * built at once from the locations of its ones.
+ *
+ * @param labelsIn Input labels of arbitrary datatype.
+ * @param output Sparse binary matrix.
+ */
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -47,6 +58,21 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     const arma::Col<size_t>& indices,
                     arma::Mat<eT>& output);
 
+/**
+ * Overload of the function above that writes a sparse matrix, so that
+ * dimensions with many categories do not need a dense output.  The nonzero
+ * values of each point are found in parallel, and the matrix is built at once
+ * from their locations.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Sparse encoded matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a DatasetInfo object and outputs a matrix.
@@ -62,6 +88,20 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overload of the function above that writes a sparse matrix.  This function
+ * encodes all the dimensions marked `Datatype::categorical` in the
+ * data::DatasetInfo.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Sparse encoded matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
@@ -65,6 +65,81 @@ void OneHotEncoding(const RowType& labelsIn,
   labelMap.clear();
 }
 
+template<typename RowType, typename eT>
+void OneHotEncoding(const RowType& labelsIn,
+                    arma::SpMat<eT>& output)
+{
+  // Map the labels in the order of their first occurrence, and remember the
+  // row of the one of each point.
+  arma::umat locations(2, labelsIn.n_elem);
+  std::unordered_map<eT, size_t> labelMap;
+  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  {
+    typename std::unordered_map<eT, size_t>::const_iterator it =
+        labelMap.find(labelsIn[i]);
+    if (it == labelMap.end())
+    {
+      const size_t label = labelMap.size();
+      labelMap[labelsIn[i]] = label;
+      locations(0, i) = label;
+    }
+    else
+    {
+      locations(0, i) = it->second;
+    }
+    locations(1, i) = i;
+  }
+
+  // There is one nonzero value per column, so the locations are sorted.
+  output = arma::SpMat<eT>(locations, arma::Col<eT>(labelsIn.n_elem,
+      arma::fill::ones), labelMap.size(), labelsIn.n_elem, false, false);
+}
+
+/**
+ * Map the values of the given dimensions of the input to the index of the
+ * output dimension they are one-hot encoded to, in the order of their first
+ * occurrence, and compute the first output dimension of each input dimension.
+ * The mappings of the dimensions that are not encoded are empty.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param mappings The mapping of each input dimension.
+ * @param dimensionOffsets The first output dimension of each input dimension;
+ *     the last element is the number of output dimensions.
+ */
+template<typename eT>
+void OneHotEncodingMappings(
+    const arma::Mat<eT>& input,
+    const arma::Col<size_t>& indices,
+    std::vector<std::unordered_map<eT, size_t>>& mappings,
+    arma::Col<size_t>& dimensionOffsets)
+{
+  std::vector<char> isEncoded(input.n_rows, 0);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    isEncoded[indices[i]] = 1;
+
+  mappings.assign(input.n_rows, std::unordered_map<eT, size_t>());
+  for (size_t col = 0; col < input.n_cols; ++col)
+  {
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (isEncoded[row] && mappings[row].count(input(row, col)) == 0)
+      {
+        const size_t label = mappings[row].size();
+        mappings[row][input(row, col)] = label;
+      }
+    }
+  }
+
+  dimensionOffsets.set_size(input.n_rows + 1);
+  dimensionOffsets[0] = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    dimensionOffsets[row + 1] = dimensionOffsets[row] +
+        (isEncoded[row] ? mappings[row].size() : 1);
+  }
+}
+
 /**
  * Overloaded function for the above function, which takes a matrix as input
  * and also a vector of indices to encode and outputs a matrix.
@@ -86,61 +161,102 @@ void OneHotEncoding(const arma::Mat<eT>& input,
     return;
   }
 
-  // First, we need to compute the size of the output matrix.
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  arma::Col<size_t> dimensionOffsets;
+  OneHotEncodingMappings(input, indices, mappings, dimensionOffsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size.
+  output.zeros(dimensionOffsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // Finally, one-hot encode the matrix; the points are independent.
+  #pragma omp parallel for
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
+      const size_t dimOffset = dimensionOffsets[row];
+      if (!mappings[row].empty())
       {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
+        // Only NaN values are not in the mapping; they are encoded as zeros.
+        const auto it = mappings[row].find(input(row, col));
+        if (it != mappings[row].end())
+          output(dimOffset + it->second, col) = eT(1);
+      }
+      else
+      {
+        // No need for one-hot encoding.
+        output(dimOffset, col) = input(row, col);
       }
     }
   }
+}
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  arma::Col<size_t> dimensionOffsets;
+  OneHotEncodingMappings(input, indices, mappings, dimensionOffsets);
 
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+  // Count the nonzero values of each point, in parallel.
+  arma::Col<size_t> columnStarts(input.n_cols + 1);
+  columnStarts[0] = 0;
+  #pragma omp parallel for
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
+  {
+    size_t nonzeros = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (mappings[row].empty() ? (input(row, col) != eT(0)) :
+          (mappings[row].count(input(row, col)) > 0))
+        ++nonzeros;
+    }
+    columnStarts[col + 1] = nonzeros;
+  }
 
-  // Finally, one-hot encode the matrix.
   for (size_t col = 0; col < input.n_cols; ++col)
+    columnStarts[col + 1] += columnStarts[col];
+
+  // Fill the locations of the nonzero values; the rows of each point are
+  // visited in order, so the locations are sorted.
+  arma::umat locations(2, columnStarts[input.n_cols]);
+  arma::Col<eT> values(columnStarts[input.n_cols]);
+  #pragma omp parallel for
+  for (omp_size_t col = 0; col < (omp_size_t) input.n_cols; ++col)
   {
+    size_t k = columnStarts[col];
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      const size_t dimOffset = dimensionOffsets[row];
+      if (!mappings[row].empty())
+      {
+        // Only NaN values are not in the mapping; they are encoded as zeros.
+        const auto it = mappings[row].find(input(row, col));
+        if (it == mappings[row].end())
+          continue;
+
+        locations(0, k) = dimOffset + it->second;
+        values[k] = eT(1);
+      }
+      else if (input(row, col) != eT(0))
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        locations(0, k) = dimOffset;
+        values[k] = input(row, col);
       }
       else
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        continue;
       }
+
+      locations(1, k) = col;
+      ++k;
     }
   }
+
+  output = arma::SpMat<eT>(locations, values, dimensionOffsets[input.n_rows],
+      input.n_cols, false, false);
 }
 
 /**
@@ -169,6 +285,22 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -0,0 +1,216 @@
+/**
+ * @file core/data/pipeline.hpp
+ *
+ * Definition of the Pipeline class, which chains the imputation, binarization,
+ * scaling and one-hot encoding of a dataset into a single pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PIPELINE_HPP
+#define MLPACK_CORE_DATA_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/scaler_methods/feature_statistics.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
+#include <unordered_map>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A serializable preprocessing pipeline, which is fitted once on training data
+ * and then applied to any data (for instance, before the predictions of a
+ * model trained on the preprocessed training data).  The stages are applied in
+ * the following order, and each of them is optional:
+ *
+ *  1. imputation: the missing values (NaN, or the given missing value) of each
+ *     dimension are replaced with the mean, the median or a custom value;
+ *  2. binarization: the values of the given dimensions are set to 1 if they
+ *     are greater than a threshold, and 0 otherwise;
+ *  3. scaling: the dimensions that are neither binarized nor one-hot encoded
+ *     are scaled with ScalerType;
+ *  4. one-hot encoding: each of the given dimensions is replaced with one
+ *     dimension per value seen by Fit(), in the order of first occurrence,
+ *     like OneHotEncoding() does; values not seen by Fit() are encoded as
+ *     zeros.
+ *
+ * Unlike the preprocess_* bindings, which each make a pass over the whole
+ * dataset, Transform() applies all the stages to one block of columns at a
+ * time, so each point is read and written once, and the blocks are processed
+ * in parallel with OpenMP.
+ *
+ * @code
+ * Pipeline<StandardScaler> pipeline;
+ * pipeline.AddImputation(Pipeline<>::MEAN_IMPUTATION);
+ * pipeline.AddScaling();
+ * pipeline.AddOneHotEncoding(categoricalDimensions);
+ * pipeline.Fit(trainingData);
+ *
+ * arma::mat preprocessed;
+ * pipeline.Transform(testData, preprocessed);
+ * @endcode
+ *
+ * @tparam ScalerType The scaler used by the scaling stage; it must provide
+ *     Fit() and Transform(), as the scalers of data/scaler_methods do.
+ */
+template<typename ScalerType = StandardScaler>
+class Pipeline
+{
+ public:
+  //! The strategies of the imputation stage.
+  enum ImputationStrategy
+  {
+    NO_IMPUTATION,
+    MEAN_IMPUTATION,
+    MEDIAN_IMPUTATION,
+    CUSTOM_IMPUTATION
+  };
+
+  //! Create an empty pipeline, which does not change the data.
+  Pipeline();
+
+  /**
+   * Impute the missing values of every dimension.  A value is missing if it
+   * is NaN or equal to the given missing value.
+   *
+   * @param strategy The value that replaces the missing values.
+   * @param missingValue Value that is missing, in addition to NaN.
+   * @param customValue Value that replaces the missing values with
+   *     CUSTOM_IMPUTATION.
+   */
+  void AddImputation(const ImputationStrategy strategy,
+                     const double missingValue =
+                         std::numeric_limits<double>::quiet_NaN(),
+                     const double customValue = 0.0);
+
+  /**
+   * Binarize the given dimension with the given threshold.
+   *
+   * @param dimension The dimension to binarize.
+   * @param threshold Largest value set to 0.
+   */
+  void AddBinarization(const size_t dimension, const double threshold);
+
+  /**
+   * Scale the dimensions that are neither binarized nor one-hot encoded with
+   * the given scaler; it is fitted by Fit().
+   *
+   * @param scaler The scaler to use.
+   */
+  void AddScaling(const ScalerType& scaler = ScalerType());
+
+  /**
+   * One-hot encode the given dimensions.
+   *
+   * @param dimensions The dimensions to encode.
+   */
+  void AddOneHotEncoding(const arma::Col<size_t>& dimensions);
+
+  /**
+   * Fit the stages of the pipeline to the given data: the imputed values, the
+   * scaler and the values of the one-hot encoded dimensions.
+   *
+   * @param input Training data, with one point per column.
+   */
+  void Fit(const arma::mat& input);
+
+  /**
+   * Apply the fitted stages to the given data, in a single parallel pass over
+   * blocks of its columns.
+   *
+   * @param input Data to preprocess, with one point per column.
+   * @param output Preprocessed data.
+   */
+  void Transform(const arma::mat& input, arma::mat& output);
+
+  //! Get whether the pipeline was fitted.
+  bool IsFitted() const { return fitted; }
+
+  //! Get the dimensionality of the data that the pipeline was fitted to.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the dimensionality of the preprocessed data.
+  size_t OutputDimensionality() const { return outputDimensionality; }
+
+  //! Get the value imputed in each dimension.
+  const arma::vec& ImputedValues() const { return imputedValues; }
+
+  //! Get the scaler.
+  const ScalerType& Scaler() const { return scaler; }
+
+  /**
+   * Serialize the pipeline.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Get whether the given value is missing.
+  bool IsMissing(const double value) const
+  {
+    return std::isnan(value) || value == missingValue;
+  }
+
+  /**
+   * Impute and binarize the given block of data in place.
+   */
+  void ImputeAndBinarize(arma::mat& block) const;
+
+  //! Compute the value imputed in each dimension.
+  void FitImputation(const arma::mat& input);
+
+  //! Fit the scaler to the imputed and binarized data.
+  void FitScaling(const arma::mat& input);
+
+  //! Map the values of the one-hot encoded dimensions.
+  void FitOneHotEncoding(const arma::mat& input);
+
+  //! The imputation strategy.
+  ImputationStrategy imputationStrategy;
+  //! Value that is missing, in addition to NaN.
+  double missingValue;
+  //! Value imputed with CUSTOM_IMPUTATION.
+  double customValue;
+
+  //! The binarized dimensions.
+  std::vector<size_t> binarizedDimensions;
+  //! The threshold of each binarized dimension.
+  std::vector<double> thresholds;
+
+  //! Whether the scaling stage is used.
+  bool scale;
+  //! The scaler.
+  ScalerType scaler;
+
+  //! The one-hot encoded dimensions.
+  arma::Col<size_t> oneHotDimensions;
+
+  //! Whether Fit() was called.
+  bool fitted;
+  //! The dimensionality of the input data.
+  size_t dimensionality;
+  //! The dimensionality of the output data.
+  size_t outputDimensionality;
+  //! The value imputed in each dimension.
+  arma::vec imputedValues;
+  //! The scaled dimensions.
+  arma::uvec scaledDimensions;
+  //! The first output dimension of each input dimension.
+  std::vector<size_t> outputOffsets;
+  //! For each input dimension, the output index of each value if the
+  //! dimension is one-hot encoded; empty otherwise.
+  std::vector<std::unordered_map<double, size_t>> mappings;
+  //! Whether each input dimension is one-hot encoded.
+  std::vector<char> isOneHot;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "pipeline_impl.hpp"
+
+#endif
@@ -0,0 +1,339 @@
+/**
+ * @file core/data/pipeline_impl.hpp
+ *
+ * Implementation of the Pipeline class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_PIPELINE_IMPL_HPP
+#define MLPACK_CORE_DATA_PIPELINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pipeline.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename ScalerType>
+Pipeline<ScalerType>::Pipeline() :
+    imputationStrategy(NO_IMPUTATION),
+    missingValue(std::numeric_limits<double>::quiet_NaN()),
+    customValue(0.0),
+    scale(false),
+    fitted(false),
+    dimensionality(0),
+    outputDimensionality(0)
+{ /* Nothing to do here. */ }
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::AddImputation(const ImputationStrategy strategy,
+                                         const double missingValue,
+                                         const double customValue)
+{
+  this->imputationStrategy = strategy;
+  this->missingValue = missingValue;
+  this->customValue = customValue;
+  fitted = false;
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::AddBinarization(const size_t dimension,
+                                           const double threshold)
+{
+  binarizedDimensions.push_back(dimension);
+  thresholds.push_back(threshold);
+  fitted = false;
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::AddScaling(const ScalerType& scaler)
+{
+  this->scaler = scaler;
+  scale = true;
+  fitted = false;
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::AddOneHotEncoding(
+    const arma::Col<size_t>& dimensions)
+{
+  oneHotDimensions = arma::unique(arma::join_cols(oneHotDimensions,
+      dimensions));
+  fitted = false;
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::Fit(const arma::mat& input)
+{
+  for (size_t i = 0; i < binarizedDimensions.size(); ++i)
+  {
+    if (binarizedDimensions[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "Pipeline::Fit(): binarized dimension " << binarizedDimensions[i]
+          << " is not smaller than the dimensionality of the data ("
+          << input.n_rows << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  for (size_t i = 0; i < oneHotDimensions.n_elem; ++i)
+  {
+    if (oneHotDimensions[i] >= input.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "Pipeline::Fit(): one-hot encoded dimension "
+          << oneHotDimensions[i] << " is not smaller than the dimensionality "
+          << "of the data (" << input.n_rows << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  dimensionality = input.n_rows;
+  isOneHot.assign(dimensionality, 0);
+  for (size_t i = 0; i < oneHotDimensions.n_elem; ++i)
+    isOneHot[oneHotDimensions[i]] = 1;
+
+  FitImputation(input);
+  FitScaling(input);
+  FitOneHotEncoding(input);
+
+  // Each one-hot encoded dimension takes one output dimension per value.
+  outputOffsets.resize(dimensionality);
+  outputDimensionality = 0;
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    outputOffsets[d] = outputDimensionality;
+    outputDimensionality += isOneHot[d] ? mappings[d].size() : 1;
+  }
+
+  fitted = true;
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::Transform(const arma::mat& input,
+                                     arma::mat& output)
+{
+  if (!fitted)
+  {
+    throw std::runtime_error("Pipeline::Transform(): the pipeline must be "
+        "fitted before Transform() is called!");
+  }
+
+  if (input.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "Pipeline::Transform(): dimensionality of data (" << input.n_rows
+        << ") does not match the dimensionality of the pipeline ("
+        << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The output is initialized before the input is read.
+  if (&input == &output)
+  {
+    const arma::mat inputCopy(input);
+    Transform(inputCopy, output);
+    return;
+  }
+
+  output.zeros(outputDimensionality, input.n_cols);
+
+  // All the stages are applied to each block before the next one is read.
+  ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+  {
+    arma::mat block = input.cols(first, last);
+    ImputeAndBinarize(block);
+
+    if (scaledDimensions.n_elem > 0)
+    {
+      arma::mat scaled;
+      scaler.Transform(arma::mat(block.rows(scaledDimensions)), scaled);
+      block.rows(scaledDimensions) = scaled;
+    }
+
+    for (size_t i = 0; i < block.n_cols; ++i)
+    {
+      for (size_t d = 0; d < dimensionality; ++d)
+      {
+        if (!isOneHot[d])
+        {
+          output(outputOffsets[d], first + i) = block(d, i);
+          continue;
+        }
+
+        // Values that were not seen by Fit() are encoded as zeros.
+        std::unordered_map<double, size_t>::const_iterator it =
+            mappings[d].find(block(d, i));
+        if (it != mappings[d].end())
+          output(outputOffsets[d] + it->second, first + i) = 1.0;
+      }
+    }
+  });
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::ImputeAndBinarize(arma::mat& block) const
+{
+  if (imputationStrategy != NO_IMPUTATION)
+  {
+    for (size_t i = 0; i < block.n_cols; ++i)
+    {
+      for (size_t d = 0; d < block.n_rows; ++d)
+      {
+        if (IsMissing(block(d, i)))
+          block(d, i) = imputedValues[d];
+      }
+    }
+  }
+
+  for (size_t k = 0; k < binarizedDimensions.size(); ++k)
+  {
+    const size_t d = binarizedDimensions[k];
+    for (size_t i = 0; i < block.n_cols; ++i)
+      block(d, i) = (block(d, i) > thresholds[k]) ? 1.0 : 0.0;
+  }
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::FitImputation(const arma::mat& input)
+{
+  if (imputationStrategy == NO_IMPUTATION)
+  {
+    imputedValues.clear();
+    return;
+  }
+
+  imputedValues.set_size(input.n_rows);
+  if (imputationStrategy == CUSTOM_IMPUTATION)
+  {
+    imputedValues.fill(customValue);
+    return;
+  }
+
+  // The dimensions are independent of each other.  A dimension without valid
+  // values gets NaN.
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) input.n_rows; ++d)
+  {
+    std::vector<double> values;
+    values.reserve(input.n_cols);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      if (!IsMissing(input(d, i)))
+        values.push_back(input(d, i));
+    }
+
+    if (values.empty())
+      imputedValues[d] = std::numeric_limits<double>::quiet_NaN();
+    else if (imputationStrategy == MEAN_IMPUTATION)
+      imputedValues[d] = arma::mean(arma::vec(values));
+    else
+      imputedValues[d] = arma::median(arma::vec(values));
+  }
+
+  for (size_t d = 0; d < imputedValues.n_elem; ++d)
+  {
+    if (std::isnan(imputedValues[d]))
+    {
+      std::ostringstream oss;
+      oss << "Pipeline::Fit(): dimension " << d << " has no valid values to "
+          << "impute missing values with!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::FitScaling(const arma::mat& input)
+{
+  std::vector<size_t> dimensions;
+  if (scale)
+  {
+    std::vector<char> isBinarized(input.n_rows, 0);
+    for (size_t k = 0; k < binarizedDimensions.size(); ++k)
+      isBinarized[binarizedDimensions[k]] = 1;
+
+    for (size_t d = 0; d < input.n_rows; ++d)
+    {
+      if (!isBinarized[d] && !isOneHot[d])
+        dimensions.push_back(d);
+    }
+  }
+
+  scaledDimensions = arma::conv_to<arma::uvec>::from(dimensions);
+  if (scaledDimensions.n_elem == 0)
+    return;
+
+  // The scaler is fitted to the imputed (and binarized) values.
+  arma::mat scaledData(scaledDimensions.n_elem, input.n_cols);
+  ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+  {
+    arma::mat block = input.cols(first, last);
+    ImputeAndBinarize(block);
+    scaledData.cols(first, last) = block.rows(scaledDimensions);
+  });
+
+  scaler.Fit(scaledData);
+}
+
+template<typename ScalerType>
+void Pipeline<ScalerType>::FitOneHotEncoding(const arma::mat& input)
+{
+  mappings.assign(input.n_rows, std::unordered_map<double, size_t>());
+  if (oneHotDimensions.n_elem == 0)
+    return;
+
+  // The values are labeled in the order of their first occurrence, so the
+  // blocks are visited in order.  NaN values are not labeled.
+  const size_t blockSize = 1024;
+  for (size_t first = 0; first < input.n_cols; first += blockSize)
+  {
+    const size_t last = std::min((size_t) input.n_cols, first + blockSize) - 1;
+    arma::mat block = input.cols(first, last);
+    ImputeAndBinarize(block);
+
+    for (size_t i = 0; i < block.n_cols; ++i)
+    {
+      for (size_t k = 0; k < oneHotDimensions.n_elem; ++k)
+      {
+        const size_t d = oneHotDimensions[k];
+        if (!std::isnan(block(d, i)) && mappings[d].count(block(d, i)) == 0)
+        {
+          const size_t label = mappings[d].size();
+          mappings[d][block(d, i)] = label;
+        }
+      }
+    }
+  }
+}
+
+template<typename ScalerType>
+template<typename Archive>
+void Pipeline<ScalerType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(imputationStrategy));
+  ar(CEREAL_NVP(missingValue));
+  ar(CEREAL_NVP(customValue));
+  ar(CEREAL_NVP(binarizedDimensions));
+  ar(CEREAL_NVP(thresholds));
+  ar(CEREAL_NVP(scale));
+  ar(CEREAL_NVP(scaler));
+  ar(CEREAL_NVP(oneHotDimensions));
+  ar(CEREAL_NVP(fitted));
+  ar(CEREAL_NVP(dimensionality));
+  ar(CEREAL_NVP(outputDimensionality));
+  ar(CEREAL_NVP(imputedValues));
+  ar(CEREAL_NVP(scaledDimensions));
+  ar(CEREAL_NVP(outputOffsets));
+  ar(CEREAL_NVP(mappings));
+  ar(CEREAL_NVP(isOneHot));
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
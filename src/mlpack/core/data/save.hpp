@@ -19,6 +19,7 @@
 #include <string>
 
 #include "format.hpp"
+#include "dataset_mapper.hpp"
 #include "image_info.hpp"
 
 namespace mlpack {
@@ -39,6 +40,7 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (arma::raw_binary), denoted by .bin
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - mlpack binary dataset (see ColumnarFile), denoted by .mlbin
  *
  * By default, this function will try to automatically determine the format to
  * save with based only on the filename's extension.  If you would prefer to
@@ -66,6 +68,32 @@ bool Save(const std::string& filename,
           bool transpose = true,
           arma::file_type inputSaveType = arma::auto_detect);
 
+/**
+ * Saves a matrix and the DatasetMapper that describes its categorical features
+ * to file.  Only mlpack binary datasets (denoted by .mlbin; see ColumnarFile)
+ * can hold a DatasetMapper, so an error will be given for any other extension.
+ * The saved file can be loaded with the overload of Load() that takes a
+ * DatasetMapper, which restores the mappings without parsing the data again.
+ *
+ * If the 'fatal' parameter is set to true, a std::runtime_error exception will
+ * be thrown upon failure.  The 'transpose' parameter has the same meaning as
+ * for the other overloads of Save(), and should generally be left at its
+ * default value of 'true'.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save into file.
+ * @param info DatasetMapper object holding the mappings of the matrix.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, transpose the matrix before saving (default true).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT, typename PolicyType>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetMapper<PolicyType>& info,
+          const bool fatal = false,
+          bool transpose = true);
+
 /**
  * Saves a sparse matrix to file, guessing the filetype from the
  * extension.  This will transpose the matrix at save time.  If the
@@ -110,9 +138,16 @@ bool Save(const std::string& filename,
  *  - binary, denoted by .bin
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::json', 'format::xml', and 'format::binary'.
- * The autodetect functionality operates on the file extension (so, "file.txt"
- * would be autodetected as text).
+ * 'format::autodetect', 'format::json', 'format::xml', 'format::binary', and
+ * 'format::aligned_binary'.  The autodetect functionality operates on the file
+ * extension (so, "file.txt" would be autodetected as text); .bin files are
+ * saved with 'format::binary'.
+ *
+ * 'format::aligned_binary' writes the memory of each Armadillo object of the
+ * model in one block that starts at a 64-byte boundary of the file.  Such files
+ * are loaded with a single read per object by Load(), or mapped without
+ * reading the objects at all by MappedModel, which is much faster for large
+ * models; they can't be loaded by older versions of mlpack.
  *
  * The name parameter should be specified to indicate the name of the structure
  * to be saved.  If Load() is later called on the generated file, the name used
@@ -16,9 +16,12 @@
 #include "save.hpp"
 #include "extension.hpp"
 #include "detect_file_type.hpp"
+#include "columnar_file.hpp"
+#include "block_writer.hpp"
 
 #include <cereal/archives/xml.hpp>
 #include <cereal/archives/json.hpp>
+#include <mlpack/core/cereal/aligned_binary.hpp>
 #include <cereal/archives/binary.hpp>
 
 namespace mlpack {
@@ -52,6 +55,34 @@ bool Save(const std::string& filename,
 {
   Timer::Start("saving_data");
 
+  // mlpack's own binary format isn't handled by Armadillo.
+  if (inputSaveType == arma::auto_detect && Extension(filename) == "mlbin")
+  {
+    Log::Info << "Saving mlpack binary dataset to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      // The file holds the matrix with one point per column.
+      if (transpose)
+        ColumnarFile<eT>::Save(filename, matrix);
+      else
+        ColumnarFile<eT>::Save(filename, arma::Mat<eT>(trans(matrix)));
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   arma::file_type saveType = inputSaveType;
   std::string stringType = "";
 
@@ -74,6 +105,32 @@ bool Save(const std::string& filename,
 
   stringType = GetStringType(saveType);
 
+  // Binary files are written in blocks of points, so that no transposed copy
+  // of the matrix is made, and each block is written while the next one is
+  // prepared.
+  if (saveType == arma::arma_binary || saveType == arma::raw_binary)
+  {
+    Log::Info << "Saving " << stringType << " to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      SaveInBlocks<eT>(filename, matrix, transpose, saveType);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -150,6 +207,55 @@ bool Save(const std::string& filename,
   return true;
 }
 
+// Save with mappings.
+template<typename eT, typename PolicyType>
+bool Save(const std::string& filename,
+          const arma::Mat<eT>& matrix,
+          const DatasetMapper<PolicyType>& info,
+          const bool fatal,
+          bool transpose)
+{
+  Timer::Start("saving_data");
+
+  // Only mlpack's own binary format can hold the mappings.
+  if (Extension(filename) != "mlbin")
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Cannot save mappings to '" << filename << "'; only .mlbin "
+          << "files can hold a DatasetMapper.  Save failed." << std::endl;
+    else
+      Log::Warn << "Cannot save mappings to '" << filename << "'; only .mlbin "
+          << "files can hold a DatasetMapper.  Save failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving mlpack binary dataset to '" << filename << "'."
+      << std::endl;
+  try
+  {
+    // The file holds the matrix with one point per column.
+    if (transpose)
+      ColumnarFile<eT>::Save(filename, matrix, info);
+    else
+      ColumnarFile<eT>::Save(filename, arma::Mat<eT>(trans(matrix)), info);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 // Save a Sparse Matrix
 template<typename eT>
 bool Save(const std::string& filename,
@@ -294,7 +400,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || f == format::aligned_binary)
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -331,6 +438,13 @@ bool Save(const std::string& filename,
       cereal::BinaryOutputArchive ar(ofs);
       ar(cereal::make_nvp(name.c_str(), t));
     }
+    else if (f == format::aligned_binary)
+    {
+      cereal::WriteAlignedBinaryHeader(ofs);
+      cereal::BinaryOutputArchive ar(ofs);
+      cereal::AlignedBinaryScope scope(&ar, &ofs);
+      ar(cereal::make_nvp(name.c_str(), t));
+    }
 
     return true;
   }
@@ -0,0 +1,200 @@
+/**
+ * @file core/data/scaler_methods/feature_statistics.hpp
+ *
+ * FeatureStatistics class, which accumulates the statistics of each feature
+ * that the scalers are fitted with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FEATURE_STATISTICS_HPP
+#define MLPACK_CORE_DATA_FEATURE_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Accumulate the number of points and the mean, the sum of squared
+ * deviations from the mean, the minimum and the maximum of each feature (row)
+ * of the data, in one pass.
+ *
+ * The statistics of the points given to Update() are merged with the
+ * statistics of the points given before, with the pairwise update of Chan et
+ * al., so that a dataset that does not fit in memory can be given chunk by
+ * chunk.  Each call computes the statistics of blocks of columns
+ * independently, in parallel with OpenMP, and merges them in order.
+ */
+class FeatureStatistics
+{
+ public:
+  //! Create empty statistics.
+  FeatureStatistics() : count(0) { }
+
+  /**
+   * Add the points (columns) of the given data to the statistics.
+   *
+   * @param input Data to add; it must have the same number of rows as the
+   *     data added before.
+   */
+  template<typename MatType>
+  void Update(const MatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "FeatureStatistics::Update(): dimensionality of data ("
+          << input.n_rows << ") does not match the dimensionality of the "
+          << "data given before (" << mean.n_elem << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Each block of columns holds about 32768 values, so that it stays in
+    // cache while its statistics are computed.
+    const size_t blockSize = std::max((size_t) 1,
+        (size_t) 32768 / std::max((size_t) 1, (size_t) input.n_rows));
+    const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+
+    size_t numChunks = 1;
+    #ifdef HAS_OPENMP
+      numChunks = (size_t) omp_get_max_threads();
+    #endif
+    numChunks = std::max((size_t) 1, std::min(numChunks, numBlocks));
+
+    // Each chunk of blocks is accumulated separately.
+    std::vector<FeatureStatistics> chunkStatistics(numChunks);
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t firstBlock = (size_t) c * numBlocks / numChunks;
+      const size_t lastBlock = ((size_t) c + 1) * numBlocks / numChunks;
+      for (size_t b = firstBlock; b < lastBlock; ++b)
+      {
+        const size_t first = b * blockSize;
+        const size_t last = std::min((size_t) input.n_cols,
+            first + blockSize) - 1;
+        const arma::mat block(input.cols(first, last));
+
+        FeatureStatistics blockStatistics;
+        blockStatistics.count = block.n_cols;
+        blockStatistics.mean = arma::mean(block, 1);
+        blockStatistics.squaredDeviations = arma::sum(arma::square(
+            block.each_col() - blockStatistics.mean), 1);
+        blockStatistics.min = arma::min(block, 1);
+        blockStatistics.max = arma::max(block, 1);
+
+        chunkStatistics[c].Merge(blockStatistics);
+      }
+    }
+
+    for (size_t c = 0; c < numChunks; ++c)
+      Merge(chunkStatistics[c]);
+  }
+
+  /**
+   * Merge the given statistics, of other points, into these statistics.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const FeatureStatistics& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    const double total = double(count + other.count);
+    const arma::vec delta = other.mean - mean;
+    mean += delta * (other.count / total);
+    squaredDeviations += other.squaredDeviations +
+        arma::square(delta) * (count * (other.count / total));
+    min = arma::min(min, other.min);
+    max = arma::max(max, other.max);
+    count += other.count;
+  }
+
+  //! Remove all the points from the statistics.
+  void Reset()
+  {
+    count = 0;
+    mean.clear();
+    squaredDeviations.clear();
+    min.clear();
+    max.clear();
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the mean of each feature.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the (population) variance of each feature.
+  arma::vec Variance() const { return squaredDeviations / count; }
+  //! Get the minimum of each feature.
+  const arma::vec& Min() const { return min; }
+  //! Get the maximum of each feature.
+  const arma::vec& Max() const { return max; }
+
+  /**
+   * Serialize the statistics.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(count));
+    ar(CEREAL_NVP(mean));
+    ar(CEREAL_NVP(squaredDeviations));
+    ar(CEREAL_NVP(min));
+    ar(CEREAL_NVP(max));
+  }
+
+ private:
+  //! The number of points.
+  size_t count;
+  //! The mean of each feature.
+  arma::vec mean;
+  //! The sum of the squared deviations from the mean of each feature.
+  arma::vec squaredDeviations;
+  //! The minimum of each feature.
+  arma::vec min;
+  //! The maximum of each feature.
+  arma::vec max;
+};
+
+/**
+ * Call the given function on blocks of columns of a dataset with the given
+ * number of columns, in parallel with OpenMP.  The scalers use it to
+ * transform the data block by block; the blocks are disjoint, so the output
+ * can be the input itself.
+ *
+ * @param numCols Number of columns of the dataset.
+ * @param function Function called with the first and the last column of each
+ *     block.
+ */
+template<typename FunctionType>
+void ForEachColumnBlock(const size_t numCols, FunctionType function)
+{
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (numCols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t first = (size_t) b * blockSize;
+    function(first, std::min(numCols, first + blockSize) - 1);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MAX_ABS_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "feature_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -42,6 +43,11 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The minimum and the maximum are computed in one parallel pass over the
+ * data.  Data that does not fit in memory can be fitted chunk by chunk with
+ * PartialFit(), and FitTransform() scales the data it fits, in place if the
+ * output is the input.
  */
 class MaxAbsScaler
 {
@@ -54,14 +60,41 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to add the given features to the features fitted before, so that
+   * a dataset can be fitted chunk by chunk.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
   }
 
+  /**
+   * Function to fit features and scale them.  The output may be the input.
+   *
+   * @param input Dataset to fit and scale.
+   * @param output Output matrix with scaled features.
+   */
+  template<typename MatType>
+  void FitTransform(const MatType& input, MatType& output)
+  {
+    Fit(input);
+    Transform(input, output);
+  }
+
   /**
    * Function to scale features.
    *
@@ -77,7 +110,10 @@ class MaxAbsScaler
         " refer to the documentation.");
     }
     output.copy_size(input);
-    output = input.each_col() / scale;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = input.cols(first, last).each_col() / scale;
+    });
   }
 
   /**
@@ -90,7 +126,10 @@ class MaxAbsScaler
   void InverseTransform(const MatType& input, MatType& output)
   {
     output.copy_size(input);
-    output = input.each_col() % scale;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = input.cols(first, last).each_col() % scale;
+    });
   }
 
   //! Get the Min row vector.
@@ -99,13 +138,21 @@ class MaxAbsScaler
   const arma::vec& ItemMax() const { return itemMax; }
   //! Get the Scale row vector.
   const arma::vec& Scale() const { return scale; }
+  //! Get the statistics of the fitted features.
+  const FeatureStatistics& Statistics() const { return statistics; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMin));
     ar(CEREAL_NVP(itemMax));
     ar(CEREAL_NVP(scale));
+
+    // Scalers saved before version 1 cannot be fitted further.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics.Reset();
   }
  private:
   // Vector which holds minimum of each feature.
@@ -114,9 +161,13 @@ class MaxAbsScaler
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Statistics of the fitted features.
+  FeatureStatistics statistics;
 }; // class MaxAbsScaler
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::MaxAbsScaler, 1);
+
 #endif
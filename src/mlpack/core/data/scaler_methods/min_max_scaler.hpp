@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "feature_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -44,6 +45,11 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The minimum and the maximum are computed in one parallel pass over the
+ * data.  Data that does not fit in memory can be fitted chunk by chunk with
+ * PartialFit(), and FitTransform() scales the data it fits, in place if the
+ * output is the input.
  */
 class MinMaxScaler
 {
@@ -73,8 +79,22 @@ class MinMaxScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = arma::min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to add the given features to the features fitted before, so that
+   * a dataset can be fitted chunk by chunk.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = itemMax - itemMin;
     // Handle zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -85,6 +105,19 @@ class MinMaxScaler
     scalerowmin = scalerowmin - itemMin % scale;
   }
 
+  /**
+   * Function to fit features and scale them.  The output may be the input.
+   *
+   * @param input Dataset to fit and scale.
+   * @param output Output matrix with scaled features.
+   */
+  template<typename MatType>
+  void FitTransform(const MatType& input, MatType& output)
+  {
+    Fit(input);
+    Transform(input, output);
+  }
+
   /**
    * Function to scale features.
    *
@@ -100,7 +133,11 @@ class MinMaxScaler
           " refer to the documentation.");
     }
     output.copy_size(input);
-    output = (input.each_col() % scale).each_col() + scalerowmin;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = (input.cols(first, last).each_col() %
+          scale).each_col() + scalerowmin;
+    });
   }
 
   /**
@@ -113,7 +150,11 @@ class MinMaxScaler
   void InverseTransform(const MatType& input, MatType& output)
   {
     output.copy_size(input);
-    output = (input.each_col() - scalerowmin).each_col() / scale;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = (input.cols(first, last).each_col() -
+          scalerowmin).each_col() / scale;
+    });
   }
 
   //! Get the Min row vector.
@@ -126,9 +167,11 @@ class MinMaxScaler
   double ScaleMax() const { return scaleMax; }
   //! Get the lower range parameter.
   double ScaleMin() const { return scaleMin; }
+  //! Get the statistics of the fitted features.
+  const FeatureStatistics& Statistics() const { return statistics; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMin));
     ar(CEREAL_NVP(itemMax));
@@ -136,6 +179,12 @@ class MinMaxScaler
     ar(CEREAL_NVP(scaleMin));
     ar(CEREAL_NVP(scaleMax));
     ar(CEREAL_NVP(scalerowmin));
+
+    // Scalers saved before version 1 cannot be fitted further.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics.Reset();
   }
 
  private:
@@ -151,9 +200,13 @@ class MinMaxScaler
   double scaleMax;
   // Column vector of scalemin
   arma::vec scalerowmin;
+  // Statistics of the fitted features.
+  FeatureStatistics statistics;
 }; // class MinMaxScaler
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::MinMaxScaler, 1);
+
 #endif
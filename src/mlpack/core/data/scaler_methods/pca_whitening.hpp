@@ -72,8 +72,8 @@ class PCAWhitening
   {
     itemMean = arma::mean(input, 1);
     // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, mlpack::math::ColumnCovariance(
-        input.each_col() - itemMean));
+    // ColumnCovariance() centers the data itself, without a centered copy.
+    eig_sym(eigenValues, eigenVectors, mlpack::math::ColumnCovariance(input));
     eigenValues += epsilon;
   }
 
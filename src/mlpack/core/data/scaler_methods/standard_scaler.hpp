@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "feature_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -43,6 +44,11 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The mean and the standard deviation are computed in one parallel pass over
+ * the data.  Data that does not fit in memory can be fitted chunk by chunk
+ * with PartialFit(), and FitTransform() scales the data it fits, in place if
+ * the output is the input.
  */
 class StandardScaler
 {
@@ -55,13 +61,40 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to add the given features to the features fitted before, so that
+   * a dataset can be fitted chunk by chunk.
+   *
+   * @param input Chunk of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    itemMean = statistics.Mean();
+    itemStdDev = arma::sqrt(statistics.Variance());
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
   }
 
+  /**
+   * Function to fit features and scale them.  The output may be the input.
+   *
+   * @param input Dataset to fit and scale.
+   * @param output Output matrix with scaled features.
+   */
+  template<typename MatType>
+  void FitTransform(const MatType& input, MatType& output)
+  {
+    Fit(input);
+    Transform(input, output);
+  }
+
   /**
    * Function to scale features.
    *
@@ -77,7 +110,11 @@ class StandardScaler
         " refer to the documentation.");
     }
     output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = (input.cols(first, last).each_col() -
+          itemMean).each_col() / itemStdDev;
+    });
   }
 
   /**
@@ -90,19 +127,31 @@ class StandardScaler
   void InverseTransform(const MatType& input, MatType& output)
   {
     output.copy_size(input);
-    output = (input.each_col() % itemStdDev).each_col() + itemMean;
+    ForEachColumnBlock(input.n_cols, [&](const size_t first, const size_t last)
+    {
+      output.cols(first, last) = (input.cols(first, last).each_col() %
+          itemStdDev).each_col() + itemMean;
+    });
   }
 
   //! Get the mean row vector.
   const arma::vec& ItemMean() const { return itemMean; }
   //! Get the standard deviation row vector.
   const arma::vec& ItemStdDev() const { return itemStdDev; }
+  //! Get the statistics of the fitted features.
+  const FeatureStatistics& Statistics() const { return statistics; }
 
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(itemMean));
     ar(CEREAL_NVP(itemStdDev));
+
+    // Scalers saved before version 1 cannot be fitted further.
+    if (version > 0)
+      ar(CEREAL_NVP(statistics));
+    else if (cereal::is_loading<Archive>())
+      statistics.Reset();
   }
 
  private:
@@ -110,9 +159,13 @@ class StandardScaler
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
   arma::vec itemStdDev;
+  // Statistics of the fitted features.
+  FeatureStatistics statistics;
 }; // class StandardScaler
 
 } // namespace data
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::data::StandardScaler, 1);
+
 #endif
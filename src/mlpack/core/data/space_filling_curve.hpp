@@ -0,0 +1,98 @@
+/**
+ * @file core/data/space_filling_curve.hpp
+ *
+ * Defines SpaceFillingCurveOrder() and SpaceFillingCurveSort(), utility
+ * functions that order the points of a dataset along a Z-order (Morton) or
+ * Hilbert curve, so that points that are close in space are also close in
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPACE_FILLING_CURVE_HPP
+#define MLPACK_CORE_DATA_SPACE_FILLING_CURVE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The space-filling curves that datasets can be ordered along.  z_order
+ * interleaves the bits of the coordinates of the points; hilbert follows the
+ * Hilbert curve, which has no jumps between neighbouring cells and so usually
+ * gives better locality, at a slightly higher cost.
+ */
+enum space_filling_curve
+{
+  z_order,
+  hilbert
+};
+
+/**
+ * Compute the order of the points of the given dataset along a space-filling
+ * curve.  Each dimension of the bounding box of the dataset is divided into
+ * 2^bitsPerDimension cells, and the points are sorted by the position of their
+ * cell along the curve; points in the same cell keep their relative order.
+ * The keys are computed and sorted in parallel if OpenMP is available, and the
+ * result does not depend on the number of threads.
+ *
+ * After the call, order[i] is the index of the point of the dataset that comes
+ * i-th along the curve, so dataset.cols(order) is the reordered dataset, and
+ * labels(order) (or labels.cols(order)) reorders anything that goes with it.
+ * Applying the order before running kmeans, GMMs, or nearest neighbor search
+ * improves the locality of their passes over the data.
+ *
+ * Note that the UB tree (UBTreeSplit) also sorts points along a Z-order
+ * curve, but its addresses are computed from the bits of the floating-point
+ * values, not from cells of the bounding box, so the orders are different.
+ *
+ * @code
+ * arma::mat dataset = ...;
+ * arma::Row<size_t> labels = ...;
+ * arma::Col<size_t> order;
+ * data::SpaceFillingCurveOrder(dataset, order, data::hilbert);
+ * dataset = dataset.cols(order);
+ * labels = labels.cols(order);
+ * @endcode
+ *
+ * @param dataset Dataset to order (one point per column).
+ * @param order Vector to store the order of the points in.
+ * @param curve Space-filling curve to order the points along.
+ * @param bitsPerDimension Number of bits of each coordinate to use (between 1
+ *     and 32).
+ */
+template<typename eT>
+void SpaceFillingCurveOrder(const arma::Mat<eT>& dataset,
+                            arma::Col<size_t>& order,
+                            const space_filling_curve curve = hilbert,
+                            const size_t bitsPerDimension = 16);
+
+/**
+ * Reorder the points of the given dataset along a space-filling curve, storing
+ * the reordered points in output and the order in order, so that output.col(i)
+ * is input.col(order[i]).  See SpaceFillingCurveOrder() for details.
+ *
+ * @param input Dataset to reorder (one point per column).
+ * @param output Matrix to store the reordered dataset in.
+ * @param order Vector to store the order of the points in.
+ * @param curve Space-filling curve to order the points along.
+ * @param bitsPerDimension Number of bits of each coordinate to use (between 1
+ *     and 32).
+ */
+template<typename eT>
+void SpaceFillingCurveSort(const arma::Mat<eT>& input,
+                           arma::Mat<eT>& output,
+                           arma::Col<size_t>& order,
+                           const space_filling_curve curve = hilbert,
+                           const size_t bitsPerDimension = 16);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "space_filling_curve_impl.hpp"
+
+#endif
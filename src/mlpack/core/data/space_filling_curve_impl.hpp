@@ -0,0 +1,222 @@
+/**
+ * @file core/data/space_filling_curve_impl.hpp
+ *
+ * Implementation of SpaceFillingCurveOrder() and SpaceFillingCurveSort().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SPACE_FILLING_CURVE_IMPL_HPP
+#define MLPACK_CORE_DATA_SPACE_FILLING_CURVE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "space_filling_curve.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Transform the given cell coordinates into the "transposed" Hilbert index of
+ * the cell: interleaving the bits of the result, from the most significant bit
+ * of the first coordinate to the least significant bit of the last one, gives
+ * the position of the cell along the Hilbert curve.  This is the algorithm of
+ * J. Skilling, "Programming the Hilbert curve" (2004).
+ *
+ * @param coords Coordinates of the cell, transformed in place.
+ * @param bits Number of bits of each coordinate.
+ */
+inline void HilbertTranspose(std::vector<uint32_t>& coords, const size_t bits)
+{
+  const size_t n = coords.size();
+  const uint32_t m = (uint32_t) 1 << (bits - 1);
+
+  // Inverse undo.
+  for (uint32_t q = m; q > 1; q >>= 1)
+  {
+    const uint32_t p = q - 1;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (coords[i] & q)
+      {
+        coords[0] ^= p; // Invert.
+      }
+      else
+      {
+        // Exchange.
+        const uint32_t t = (coords[0] ^ coords[i]) & p;
+        coords[0] ^= t;
+        coords[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode.
+  for (size_t i = 1; i < n; ++i)
+    coords[i] ^= coords[i - 1];
+
+  uint32_t t = 0;
+  for (uint32_t q = m; q > 1; q >>= 1)
+    if (coords[n - 1] & q)
+      t ^= q - 1;
+
+  for (size_t i = 0; i < n; ++i)
+    coords[i] ^= t;
+}
+
+/**
+ * Sort the given indices by the given keys (one per column, compared word by
+ * word), breaking ties by index.  Chunks of the indices are sorted in parallel
+ * and then merged in parallel, pairwise; since the order is total, the result
+ * is the same for any number of chunks.
+ *
+ * @param keys Keys of the points (one column per point).
+ * @param order Indices to sort.
+ */
+inline void SortByKeys(const arma::Mat<uint64_t>& keys,
+                       arma::Col<size_t>& order)
+{
+  const size_t n = order.n_elem;
+  auto less = [&keys](const size_t a, const size_t b)
+  {
+    const uint64_t* keyA = keys.colptr(a);
+    const uint64_t* keyB = keys.colptr(b);
+    for (size_t w = 0; w < keys.n_rows; ++w)
+      if (keyA[w] != keyB[w])
+        return keyA[w] < keyB[w];
+
+    return a < b;
+  };
+
+#ifdef HAS_OPENMP
+  const size_t numChunks = (n >= 16384 && !omp_in_parallel()) ?
+      (size_t) omp_get_max_threads() : 1;
+#else
+  const size_t numChunks = 1;
+#endif
+
+  std::vector<size_t> bounds(numChunks + 1);
+  for (size_t c = 0; c <= numChunks; ++c)
+    bounds[c] = c * n / numChunks;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    std::sort(order.begin() + bounds[c], order.begin() + bounds[c + 1], less);
+
+  if (numChunks == 1)
+    return;
+
+  // Merge neighbouring runs until only one is left.
+  arma::Col<size_t> buffer(n);
+  size_t* source = order.memptr();
+  size_t* dest = buffer.memptr();
+  for (size_t width = 1; width < numChunks; width *= 2)
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; c += 2 * width)
+    {
+      const size_t begin = bounds[c];
+      const size_t middle = bounds[std::min((size_t) c + width, numChunks)];
+      const size_t end = bounds[std::min((size_t) c + 2 * width, numChunks)];
+      std::merge(source + begin, source + middle, source + middle,
+          source + end, dest + begin, less);
+    }
+
+    std::swap(source, dest);
+  }
+
+  if (source != order.memptr())
+    order = buffer;
+}
+
+template<typename eT>
+void SpaceFillingCurveOrder(const arma::Mat<eT>& dataset,
+                            arma::Col<size_t>& order,
+                            const space_filling_curve curve,
+                            const size_t bitsPerDimension)
+{
+  if (bitsPerDimension < 1 || bitsPerDimension > 32)
+  {
+    throw std::invalid_argument("SpaceFillingCurveOrder(): bitsPerDimension "
+        "must be between 1 and 32!");
+  }
+
+  const size_t n = dataset.n_cols;
+  const size_t d = dataset.n_rows;
+  order.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+  if (n < 2 || d == 0)
+    return;
+
+  // Map each dimension of the bounding box to the cells [0, 2^bits).
+  const arma::Col<eT> lo = arma::min(dataset, 1);
+  const arma::Col<eT> hi = arma::max(dataset, 1);
+  const double numCells = std::ldexp(1.0, (int) bitsPerDimension);
+  const uint32_t maxCell = (uint32_t) (numCells - 1);
+  arma::vec scales(d);
+  for (size_t i = 0; i < d; ++i)
+    scales[i] = (hi[i] > lo[i]) ? numCells / (hi[i] - lo[i]) : 0.0;
+
+  // The key of a point holds d * bitsPerDimension bits, from the most
+  // significant bit of the first coordinate onwards.
+  const size_t numBits = d * bitsPerDimension;
+  arma::Mat<uint64_t> keys(((numBits + 63) / 64), n, arma::fill::zeros);
+
+  #pragma omp parallel
+  {
+    std::vector<uint32_t> coords(d);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t p = 0; p < (omp_size_t) n; ++p)
+    {
+      for (size_t i = 0; i < d; ++i)
+      {
+        const double cell = (dataset(i, p) - lo[i]) * scales[i];
+        coords[i] = (cell >= maxCell) ? maxCell : (uint32_t) cell;
+      }
+
+      if (curve == hilbert)
+        HilbertTranspose(coords, bitsPerDimension);
+
+      uint64_t* key = keys.colptr(p);
+      for (size_t b = 0; b < bitsPerDimension; ++b)
+      {
+        const size_t shift = bitsPerDimension - 1 - b;
+        for (size_t i = 0; i < d; ++i)
+        {
+          const size_t bit = b * d + i;
+          key[bit / 64] |= (uint64_t) ((coords[i] >> shift) & 1) <<
+              (63 - bit % 64);
+        }
+      }
+    }
+  }
+
+  SortByKeys(keys, order);
+}
+
+template<typename eT>
+void SpaceFillingCurveSort(const arma::Mat<eT>& input,
+                           arma::Mat<eT>& output,
+                           arma::Col<size_t>& order,
+                           const space_filling_curve curve,
+                           const size_t bitsPerDimension)
+{
+  SpaceFillingCurveOrder(input, order, curve, bitsPerDimension);
+
+  // Make sure that input and output can be the same matrix.
+  arma::Mat<eT> result(input.n_rows, input.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) order.n_elem; ++i)
+    result.col(i) = input.col(order[i]);
+
+  output = std::move(result);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
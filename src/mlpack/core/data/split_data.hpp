@@ -62,6 +62,182 @@ void SplitHelper(const InputType& input,
   }
 }
 
+/**
+ * Compute the indices of the points of the training set and of the test set of
+ * a dataset with the given number of points, without copying any data.  The
+ * indices are the ones that Split() uses: if the points are shuffled, the same
+ * random numbers are drawn, so that with the same seed, trainData and testData
+ * of Split() are input.cols(trainIndices) and input.cols(testIndices).
+ *
+ * @code
+ * arma::uvec trainIndices, testIndices;
+ * SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+ * @endcode
+ *
+ * @param numPoints Number of points of the dataset.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Compute the indices of the points of the stratified training set and test
+ * set of a dataset with the given labels, without copying any data.  The
+ * indices are the ones that StratifiedSplit() uses.  Expects labels to be of
+ * type arma::Row<> or arma::Col<>, between 0 and the number of classes.
+ *
+ * @param inputLabel Input labels to stratify.
+ * @param trainIndices Vector to store the indices of the training points into.
+ * @param testIndices Vector to store the indices of the test points into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+void StratifiedSplitIndices(const LabelsType& inputLabel,
+                            arma::uvec& trainIndices,
+                            arma::uvec& testIndices,
+                            const double testRatio,
+                            const bool shuffleData = true)
+{
+  const bool typeCheck = (arma::is_Row<LabelsType>::value)
+      || (arma::is_Col<LabelsType>::value);
+  if (!typeCheck)
+    throw std::runtime_error("data::Split(): when stratified sampling is done, "
+        "labels must have type `arma::Row<>`!");
+
+  // See StratifiedSplit() for the idea of the algorithm.
+  size_t trainSize = 0;
+  size_t testSize = 0;
+  arma::uvec labelCounts;
+  arma::uvec testLabelCounts;
+  typename LabelsType::elem_type maxLabel = inputLabel.max();
+
+  labelCounts.zeros(maxLabel+1);
+  testLabelCounts.zeros(maxLabel+1);
+
+  for (typename LabelsType::elem_type label : inputLabel)
+    ++labelCounts[label];
+
+  for (arma::uword labelCount : labelCounts)
+  {
+    testSize += floor(labelCount * testRatio);
+    trainSize += labelCount - floor(labelCount * testRatio);
+  }
+
+  trainIndices.set_size(trainSize);
+  testIndices.set_size(testSize);
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, inputLabel.n_elem - 1,
+      inputLabel.n_elem);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  size_t trainIdx = 0;
+  size_t testIdx = 0;
+  for (arma::uword i : order)
+  {
+    typename LabelsType::elem_type label = inputLabel[i];
+    if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
+    {
+      testLabelCounts[label] += 1;
+      testIndices[testIdx++] = i;
+    }
+    else
+    {
+      trainIndices[trainIdx++] = i;
+    }
+  }
+}
+
+/**
+ * Permute the columns of the given matrix in place, so that its column i is
+ * its former column order[i].  Only one column is buffered: each cycle of the
+ * permutation is followed once.  The rows are split into strips that are
+ * permuted in parallel, so each thread moves contiguous memory and no thread
+ * waits for another.
+ *
+ * @param matrix Matrix whose columns are permuted.
+ * @param order The permutation of the columns.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& matrix, const arma::uvec& order)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (order.n_elem != matrix.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PermuteColumns(): the permutation has " << order.n_elem
+        << " elements but the matrix has " << matrix.n_cols << " columns!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Find the first column of each cycle of the permutation.
+  std::vector<size_t> cycleStarts;
+  std::vector<bool> visited(matrix.n_cols, false);
+  for (size_t i = 0; i < matrix.n_cols; ++i)
+  {
+    if (visited[i] || order[i] == i)
+      continue;
+
+    cycleStarts.push_back(i);
+    for (size_t j = i; !visited[j]; j = order[j])
+      visited[j] = true;
+  }
+
+  // Strips are at least a cache line long.
+  const size_t minStripSize = std::max((size_t) 1, 64 / sizeof(ElemType));
+  size_t numStrips = 1;
+  #ifdef HAS_OPENMP
+    numStrips = (size_t) omp_get_max_threads();
+  #endif
+  numStrips = std::max((size_t) 1, std::min(numStrips,
+      (size_t) matrix.n_rows / minStripSize));
+
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) numStrips; ++s)
+  {
+    const size_t firstRow = (size_t) s * matrix.n_rows / numStrips;
+    const size_t numRows = ((size_t) s + 1) * matrix.n_rows / numStrips -
+        firstRow;
+    std::vector<ElemType> buffer(numRows);
+    for (const size_t start : cycleStarts)
+    {
+      const ElemType* startPtr = matrix.colptr(start) + firstRow;
+      std::copy(startPtr, startPtr + numRows, buffer.begin());
+
+      size_t j = start;
+      while (order[j] != start)
+      {
+        const ElemType* from = matrix.colptr(order[j]) + firstRow;
+        std::copy(from, from + numRows, matrix.colptr(j) + firstRow);
+        j = order[j];
+      }
+      std::copy(buffer.begin(), buffer.end(), matrix.colptr(j) + firstRow);
+    }
+  }
+}
+
 /**
  * Given an input dataset and labels, stratify into a training set and test set.
  * It is recommended to have the input labels between the range [0, n) where n
@@ -142,79 +318,18 @@ void StratifiedSplit(const arma::Mat<T>& input,
    * 0
    * 1 1
    */
-  const bool typeCheck = (arma::is_Row<LabelsType>::value)
-      || (arma::is_Col<LabelsType>::value);
-  if (!typeCheck)
-    throw std::runtime_error("data::Split(): when stratified sampling is done, "
-        "labels must have type `arma::Row<>`!");
-  size_t trainIdx = 0;
-  size_t testIdx = 0;
-  size_t trainSize = 0;
-  size_t testSize = 0;
-  arma::uvec labelCounts;
-  arma::uvec testLabelCounts;
-  typename LabelsType::elem_type maxLabel = inputLabel.max();
-
-  labelCounts.zeros(maxLabel+1);
-  testLabelCounts.zeros(maxLabel+1);
-
-  for (typename LabelsType::elem_type label : inputLabel)
-    ++labelCounts[label];
-
-  for (arma::uword labelCount : labelCounts)
-  {
-    testSize += floor(labelCount * testRatio);
-    trainSize += labelCount - floor(labelCount * testRatio);
-  }
-
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(inputLabel.n_rows, trainSize);
-  testLabel.set_size(inputLabel.n_rows, testSize);
-
-  if (shuffleData)
-  {
-    arma::uvec order = arma::shuffle(
-        arma::linspace<arma::uvec>(0, input.n_cols - 1, input.n_cols));
+  arma::uvec trainIndices, testIndices;
+  StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+      shuffleData);
 
-    for (arma::uword i : order)
-    {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
-    }
-  }
-  else
-  {
-    for (arma::uword i = 0; i < input.n_cols; i++)
-    {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
-    }
-  }
+  trainData = input.cols(trainIndices);
+  testData = input.cols(testIndices);
+  trainLabel.set_size(inputLabel.n_rows, trainIndices.n_elem);
+  testLabel.set_size(inputLabel.n_rows, testIndices.n_elem);
+  for (size_t i = 0; i < trainIndices.n_elem; ++i)
+    trainLabel[i] = inputLabel[trainIndices[i]];
+  for (size_t i = 0; i < testIndices.n_elem; ++i)
+    testLabel[i] = inputLabel[testIndices[i]];
 }
 
 /**
@@ -610,6 +725,105 @@ Split(const FieldType& input,
                          std::move(testData));
 }
 
+/**
+ * Split the given dataset into a training set and a test set in place,
+ * without allocating a second copy of the data: the columns are permuted so
+ * that the training points come first.  The split is the same as the one of
+ * Split() with the same random seed, so input.head_cols(trainSize) is
+ * trainData and input.tail_cols(input.n_cols - trainSize) is testData.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * const size_t trainSize = SplitInPlace(input, 0.3);
+ * arma::mat trainData(input.memptr(), input.n_rows, trainSize, false, true);
+ * @endcode
+ *
+ * @param input Dataset to split; its columns are permuted.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ * @return The number of points of the training set.
+ */
+template<typename T>
+size_t SplitInPlace(arma::Mat<T>& input,
+                    const double testRatio,
+                    const bool shuffleData = true)
+{
+  arma::uvec trainIndices, testIndices;
+  SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+      shuffleData);
+
+  if (shuffleData)
+    PermuteColumns(input, arma::join_cols(trainIndices, testIndices));
+
+  return trainIndices.n_elem;
+}
+
+/**
+ * Split the given dataset and labels into a training set and a test set in
+ * place, without allocating a second copy of the data: the columns of the
+ * dataset and the labels are permuted so that the training points come first.
+ * The split is the same as the one of Split() with the same random seed and
+ * the same stratifyData setting.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> labels = loadLabel();
+ * const size_t trainSize = SplitInPlace(input, labels, 0.3, true, true);
+ * @endcode
+ *
+ * @param input Dataset to split; its columns are permuted.
+ * @param inputLabel Labels of the dataset; they are permuted too.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ * @param stratifyData If true, the train and test splits are stratified
+ *     so that the ratio of each class in the training and test sets is the same
+ *     as in the original dataset.
+ * @return The number of points of the training set.
+ */
+template<typename T, typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+size_t SplitInPlace(arma::Mat<T>& input,
+                    LabelsType& inputLabel,
+                    const double testRatio,
+                    const bool shuffleData = true,
+                    const bool stratifyData = false)
+{
+  if (inputLabel.n_elem != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "data::SplitInPlace(): the number of labels (" << inputLabel.n_elem
+        << ") does not match the number of points (" << input.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::uvec trainIndices, testIndices;
+  if (stratifyData)
+  {
+    StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+        shuffleData);
+  }
+  else
+  {
+    SplitIndices(input.n_cols, trainIndices, testIndices, testRatio,
+        shuffleData);
+  }
+
+  // Without shuffling or stratification, the order does not change.
+  if (shuffleData || stratifyData)
+  {
+    const arma::uvec order = arma::join_cols(trainIndices, testIndices);
+    PermuteColumns(input, order);
+
+    const LabelsType labels(inputLabel);
+    for (size_t i = 0; i < order.n_elem; ++i)
+      inputLabel[i] = labels[order[i]];
+  }
+
+  return trainIndices.n_elem;
+}
+
 } // namespace data
 } // namespace mlpack
 
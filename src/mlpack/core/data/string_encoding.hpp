@@ -17,6 +17,7 @@
 #include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
 #include <mlpack/core/data/string_encoding_dictionary.hpp>
 #include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <map>
 #include <vector>
 
 namespace mlpack {
@@ -27,6 +28,15 @@ namespace data {
  * algorithms. The encoder writes data either in the column-major order or
  * in the row-major order depending on the output data type.
  *
+ * Unless the policy supports one pass encoding and the output is a 2D
+ * std::vector, Encode() tokenizes the strings in parallel with OpenMP: each
+ * thread tokenizes a contiguous chunk of the strings and collects the tokens
+ * that are not in the dictionary yet, and the chunks are then merged in
+ * order, so the tokens get the same labels as with a serial pass.  The
+ * labels of all the tokens are kept, so the strings are only tokenized once,
+ * and the encoded values are then written in parallel.  Sparse output is
+ * built directly from the nonzero values of each string.
+ *
  * @tparam EncodingPolicyType Type of the encoding algorithm itself.
  * @tparam DictionaryType Type of the dictionary.
  */
@@ -202,6 +212,70 @@ class StringEncoding
                     typename std::enable_if<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>::type* = 0);
 
+  /**
+   * Tokenize the given strings in parallel, add the new tokens to the
+   * dictionary in the order of their first occurrence, and store the label of
+   * every token.
+   *
+   * @param input Corpus of text to tokenize.
+   * @param tokenizer The tokenizer object.
+   * @param values The labels of the tokens of all the strings, one string
+   *     after another.
+   * @param lineStarts The position in values of the first token of each
+   *     string; the last element is the total number of tokens.
+   */
+  template<typename TokenizerType>
+  void TokenizeLines(const std::vector<std::string>& input,
+                     const TokenizerType& tokenizer,
+                     std::vector<size_t>& values,
+                     std::vector<size_t>& lineStarts);
+
+  /**
+   * Write the encoded tokens of each string to the given dense output, in
+   * parallel over the strings.
+   */
+  template<typename OutputType, typename PolicyType>
+  void EncodeLines(OutputType& output,
+                   const std::vector<size_t>& values,
+                   const std::vector<size_t>& lineStarts,
+                   PolicyType& policy);
+
+  /**
+   * Write the encoded tokens of each string to the given sparse output.  The
+   * nonzero values of each string are collected in parallel, and the sparse
+   * matrix is built from them at once.
+   */
+  template<typename eT, typename PolicyType>
+  void EncodeLines(arma::SpMat<eT>& output,
+                   const std::vector<size_t>& values,
+                   const std::vector<size_t>& lineStarts,
+                   PolicyType& policy);
+
+  /**
+   * The column of a sparse output that the policy writes a string to.  It
+   * provides the members of a matrix that the encoding policies use, and
+   * stores the written values sorted by row.
+   */
+  template<typename eT>
+  struct SparseColumn
+  {
+    //! The type of the values.
+    typedef eT elem_type;
+
+    //! Access the value at the given row; the column is ignored.
+    eT& operator()(const size_t row, const size_t /* col */)
+    {
+      return values[row];
+    }
+
+    //! The number of rows of the output.
+    size_t n_rows;
+    //! The number of columns of the output.
+    size_t n_cols;
+    //! The written values, keyed by row.
+    std::map<size_t, eT> values;
+  };
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
@@ -105,55 +105,206 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
-  size_t numColumns = 0;
-
   policy.Reset();
 
-  // The first pass adds the extracted tokens to the dictionary.
+  // The first pass adds the extracted tokens to the dictionary and stores
+  // their labels.
+  std::vector<size_t> values, lineStarts;
+  TokenizeLines(input, tokenizer, values, lineStarts);
+
+  size_t numColumns = 0;
   for (size_t i = 0; i < input.size(); ++i)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
+    const size_t numTokens = lineStarts[i + 1] - lineStarts[i];
+    for (size_t j = 0; j < numTokens; ++j)
+      policy.PreprocessToken(i, j, values[lineStarts[i] + j]);
 
-    static_assert(
-        std::is_same<typename std::remove_reference<decltype(token)>::type,
-                     typename std::remove_reference<typename DictionaryType::
-                        TokenType>::type>::value,
-        "The dictionary token type doesn't match the return value type "
-        "of the tokenizer.");
+    numColumns = std::max(numColumns, numTokens);
+  }
 
-    size_t numTokens = 0;
+  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
 
-    while (!tokenizer.IsTokenEmpty(token))
+  // The second pass writes the encoded values to the output.
+  EncodeLines(output, values, lineStarts, policy);
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::TokenizeLines(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer,
+    std::vector<size_t>& values,
+    std::vector<size_t>& lineStarts)
+{
+  using TokenType = typename std::remove_reference<
+      typename DictionaryType::TokenType>::type;
+
+  // The labels of a chunk-local dictionary are marked with the highest bit.
+  const size_t localFlag = size_t(1) << (sizeof(size_t) * CHAR_BIT - 1);
+
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = (size_t) omp_get_max_threads();
+  #endif
+  numChunks = std::max((size_t) 1, std::min(numChunks, input.size()));
+
+  std::vector<std::vector<size_t>> chunkValues(numChunks);
+  std::vector<std::vector<TokenType>> chunkNewTokens(numChunks);
+  std::vector<size_t> lineSizes(input.size());
+
+  // Each chunk of strings is tokenized separately.  The dictionary is only
+  // read here; the tokens that are not in it get the label of a chunk-local
+  // dictionary.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t first = (size_t) c * input.size() / numChunks;
+    const size_t last = ((size_t) c + 1) * input.size() / numChunks;
+    DictionaryType localDictionary;
+    for (size_t i = first; i < last; ++i)
     {
-      if (!dictionary.HasToken(token))
-        dictionary.AddToken(std::move(token));
+      boost::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      static_assert(
+          std::is_same<typename std::remove_reference<decltype(token)>::type,
+                       TokenType>::value,
+          "The dictionary token type doesn't match the return value type "
+          "of the tokenizer.");
+
+      size_t numTokens = 0;
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (dictionary.HasToken(token))
+        {
+          chunkValues[c].push_back(dictionary.Value(token));
+        }
+        else if (localDictionary.HasToken(token))
+        {
+          chunkValues[c].push_back(localDictionary.Value(token) | localFlag);
+        }
+        else
+        {
+          chunkNewTokens[c].push_back(token);
+          chunkValues[c].push_back(localDictionary.AddToken(token) |
+              localFlag);
+        }
+
+        token = tokenizer(strView);
+        numTokens++;
+      }
+      lineSizes[i] = numTokens;
+    }
+  }
 
-      policy.PreprocessToken(i, numTokens, dictionary.Value(token));
+  // Merge the new tokens of the chunks in order, so that the labels are the
+  // same as with a serial pass, and replace the local labels.
+  lineStarts.resize(input.size() + 1);
+  lineStarts[0] = 0;
+  for (size_t i = 0; i < input.size(); ++i)
+    lineStarts[i + 1] = lineStarts[i] + lineSizes[i];
 
-      token = tokenizer(strView);
-      numTokens++;
+  values.clear();
+  values.reserve(lineStarts.back());
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    std::vector<size_t> labels(chunkNewTokens[c].size());
+    for (size_t k = 0; k < chunkNewTokens[c].size(); ++k)
+    {
+      TokenType& token = chunkNewTokens[c][k];
+      labels[k] = dictionary.HasToken(token) ? dictionary.Value(token) :
+          dictionary.AddToken(std::move(token));
     }
 
-    numColumns = std::max(numColumns, numTokens);
+    for (const size_t value : chunkValues[c])
+      values.push_back((value & localFlag) ? labels[(value & ~localFlag) - 1] :
+          value);
+
+    // Release the memory of the chunk as soon as it is merged.
+    std::vector<size_t>().swap(chunkValues[c]);
   }
+}
 
-  policy.InitMatrix(output, input.size(), numColumns, dictionary.Size());
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename OutputType, typename PolicyType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::EncodeLines(
+    OutputType& output,
+    const std::vector<size_t>& values,
+    const std::vector<size_t>& lineStarts,
+    PolicyType& policy)
+{
+  // Each string is written to its own column (or row) of the output.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) lineStarts.size() - 1; ++i)
+  {
+    for (size_t j = lineStarts[i]; j < lineStarts[i + 1]; ++j)
+      policy.Encode(output, values[j], i, j - lineStarts[i]);
+  }
+}
 
-  // The second pass writes the encoded values to the output.
-  for (size_t i = 0; i < input.size(); ++i)
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename eT, typename PolicyType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::EncodeLines(
+    arma::SpMat<eT>& output,
+    const std::vector<size_t>& values,
+    const std::vector<size_t>& lineStarts,
+    PolicyType& policy)
+{
+  const size_t numLines = lineStarts.size() - 1;
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = (size_t) omp_get_max_threads();
+  #endif
+  numChunks = std::max((size_t) 1, std::min(numChunks, numLines));
+
+  // Each chunk of strings collects its nonzero values in column-major order.
+  std::vector<std::vector<arma::uword>> chunkRows(numChunks);
+  std::vector<std::vector<arma::uword>> chunkCols(numChunks);
+  std::vector<std::vector<eT>> chunkValues(numChunks);
+
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
   {
-    boost::string_view strView(input[i]);
-    auto token = tokenizer(strView);
-    size_t numTokens = 0;
+    const size_t first = (size_t) c * numLines / numChunks;
+    const size_t last = ((size_t) c + 1) * numLines / numChunks;
+    SparseColumn<eT> column;
+    column.n_rows = output.n_rows;
+    column.n_cols = output.n_cols;
+    for (size_t i = first; i < last; ++i)
+    {
+      column.values.clear();
+      for (size_t j = lineStarts[i]; j < lineStarts[i + 1]; ++j)
+        policy.Encode(column, values[j], i, j - lineStarts[i]);
+
+      for (const std::pair<const size_t, eT>& entry : column.values)
+      {
+        chunkRows[c].push_back(entry.first);
+        chunkCols[c].push_back(i);
+        chunkValues[c].push_back(entry.second);
+      }
+    }
+  }
 
-    while (!tokenizer.IsTokenEmpty(token))
+  size_t nnz = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+    nnz += chunkValues[c].size();
+
+  arma::umat locations(2, nnz);
+  arma::Col<eT> nonzeros(nnz);
+  size_t k = 0;
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (size_t n = 0; n < chunkValues[c].size(); ++n, ++k)
     {
-      policy.Encode(output, dictionary.Value(token), i, numTokens);
-      token = tokenizer(strView);
-      numTokens++;
+      locations(0, k) = chunkRows[c][n];
+      locations(1, k) = chunkCols[c][n];
+      nonzeros[k] = chunkValues[c][n];
     }
   }
+
+  // The locations are already sorted in column-major order.
+  output = arma::SpMat<eT>(locations, nonzeros, output.n_rows, output.n_cols,
+      false, true);
 }
 
 template<typename EncodingPolicyType, typename DictionaryType>
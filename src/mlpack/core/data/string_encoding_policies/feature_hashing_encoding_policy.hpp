@@ -0,0 +1,381 @@
+/**
+ * @file core/data/string_encoding_policies/feature_hashing_encoding_policy.hpp
+ *
+ * Definition of the HashingDictionary and FeatureHashingEncodingPolicy
+ * classes, which implement the hashing trick for StringEncoding.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STR_ENCODING_POLICIES_FEATURE_HASHING_POLICY_HPP
+#define MLPACK_CORE_DATA_STR_ENCODING_POLICIES_FEATURE_HASHING_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/boost_backport/boost_backport_string_view.hpp>
+#include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <mlpack/core/data/string_encoding.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A stateless replacement of StringEncodingDictionary that implements the
+ * hashing trick.  Every token is considered to be in the dictionary: its
+ * label is computed from the 32-bit MurmurHash3 of the bytes of the token, so
+ * the dictionary never grows, and the labels of the tokens do not depend on
+ * the order in which they are seen.
+ *
+ * The hash selects one of the Dimension() output features (the lower 31
+ * bits), and a sign (the highest bit) that FeatureHashingEncodingPolicy uses
+ * to make the collisions cancel out on average.  Both are packed in the label,
+ * which is equal to 2 * feature + signBit + 1, so that the labels start from
+ * one, as with the other dictionaries.
+ *
+ * @tparam Token Type of the tokens; boost::string_view, std::string and int
+ *     (as returned by CharExtract) are supported.
+ */
+template<typename Token>
+class HashingDictionary
+{
+ public:
+  //! The type of the token that the dictionary stores.
+  using TokenType = Token;
+
+  /**
+   * Create the dictionary with the given number of output features.
+   *
+   * @param dimension Number of output features.
+   * @param seed Seed of the hash function.
+   */
+  HashingDictionary(const size_t dimension = 1 << 20,
+                    const uint32_t seed = 0) :
+      dimension(dimension),
+      seed(seed)
+  {
+    if (dimension == 0)
+    {
+      throw std::invalid_argument("HashingDictionary::HashingDictionary(): "
+          "dimension must be greater than 0!");
+    }
+  }
+
+  /**
+   * The function returns true for every token, since every token is mapped
+   * to a feature.
+   */
+  bool HasToken(const Token& /* token */) const { return true; }
+
+  /**
+   * The function returns the label of the given token; nothing is stored.
+   *
+   * @param token The given token.
+   */
+  size_t AddToken(const Token& token) const { return Value(token); }
+
+  /**
+   * The function returns the label of the given token.
+   *
+   * @param token The given token.
+   */
+  size_t Value(const Token& token) const
+  {
+    const uint32_t hash = Hash(token);
+    const size_t feature = (hash & 0x7FFFFFFFu) % dimension;
+    return 2 * feature + (hash >> 31) + 1;
+  }
+
+  //! Get the number of output features.
+  size_t Size() const { return dimension; }
+
+  //! Clear the dictionary; nothing is stored, so this does nothing.
+  void Clear() { }
+
+  //! Get the number of output features.
+  size_t Dimension() const { return dimension; }
+  //! Modify the number of output features.
+  size_t& Dimension() { return dimension; }
+
+  //! Get the seed of the hash function.
+  uint32_t Seed() const { return seed; }
+  //! Modify the seed of the hash function.
+  uint32_t& Seed() { return seed; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(dimension));
+    ar(CEREAL_NVP(seed));
+  }
+
+ private:
+  //! Hash the characters of the given string token.
+  uint32_t Hash(const boost::string_view token) const
+  {
+    return MurmurHash3(token.data(), token.size());
+  }
+
+  //! Hash the characters of the given string token.
+  uint32_t Hash(const std::string& token) const
+  {
+    return MurmurHash3(token.data(), token.size());
+  }
+
+  //! Hash the bytes of the given integer token.
+  uint32_t Hash(const int token) const
+  {
+    return MurmurHash3(reinterpret_cast<const char*>(&token), sizeof(int));
+  }
+
+  /**
+   * Compute the 32-bit MurmurHash3 of the given bytes.
+   *
+   * @param data The bytes to hash.
+   * @param length The number of bytes.
+   */
+  uint32_t MurmurHash3(const char* data, const size_t length) const
+  {
+    const uint32_t c1 = 0xcc9e2d51u;
+    const uint32_t c2 = 0x1b873593u;
+    uint32_t h = seed;
+
+    // The bytes are read in blocks of four.
+    const size_t numBlocks = length / 4;
+    for (size_t i = 0; i < numBlocks; ++i)
+    {
+      uint32_t k;
+      std::memcpy(&k, data + 4 * i, 4);
+      k *= c1;
+      k = (k << 15) | (k >> 17);
+      k *= c2;
+
+      h ^= k;
+      h = (h << 13) | (h >> 19);
+      h = h * 5 + 0xe6546b64u;
+    }
+
+    // Mix the remaining bytes.
+    const unsigned char* tail =
+        reinterpret_cast<const unsigned char*>(data + 4 * numBlocks);
+    uint32_t k = 0;
+    switch (length & 3)
+    {
+      case 3:
+        k ^= uint32_t(tail[2]) << 16;
+        // Fall through.
+      case 2:
+        k ^= uint32_t(tail[1]) << 8;
+        // Fall through.
+      case 1:
+        k ^= uint32_t(tail[0]);
+        k *= c1;
+        k = (k << 15) | (k >> 17);
+        k *= c2;
+        h ^= k;
+    }
+
+    // Finalize the hash.
+    h ^= (uint32_t) length;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+  }
+
+  //! Locally-stored number of output features.
+  size_t dimension;
+
+  //! Locally-stored seed of the hash function.
+  uint32_t seed;
+};
+
+/**
+ * Definition of the FeatureHashingEncodingPolicy class.
+ *
+ * FeatureHashingEncodingPolicy is used as a helper class for StringEncoding
+ * with a HashingDictionary.  The encoder maps each dataset item to a vector
+ * whose size is the dimension of the dictionary.  Each token adds one to the
+ * feature it is hashed to, or, if alternateSign is true (the default), adds
+ * the sign given by its hash, so that the inner products of the encoded
+ * vectors are unbiased in spite of the collisions.
+ *
+ * Since the dictionary holds no state, the encoding of a string does not
+ * depend on the other strings, and all the strings are encoded in the single
+ * tokenization pass of StringEncoding::Encode().  Sparse output (arma::sp_mat)
+ * only stores the nonzero features of each string.
+ */
+class FeatureHashingEncodingPolicy
+{
+ public:
+  /**
+   * Construct the class with the given setting.
+   *
+   * @param alternateSign Whether the tokens add the sign given by their hash
+   *     instead of one.
+   */
+  FeatureHashingEncodingPolicy(const bool alternateSign = true) :
+      alternateSign(alternateSign)
+  { }
+
+  /**
+   * Clear the necessary internal variables.
+   */
+  static void Reset()
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The function initializes the output matrix. The encoder writes data
+   * in the column-major order.
+   *
+   * @tparam MatType The output matrix type.
+   *
+   * @param output Output matrix to store the encoded results (sp_mat or mat).
+   * @param datasetSize The number of strings in the input dataset.
+   * @param * (maxNumTokens) The maximum number of tokens in the strings of the
+   *                     input dataset (not used).
+   * @param dictionarySize The number of output features.
+   */
+  template<typename MatType>
+  static void InitMatrix(MatType& output,
+                         const size_t datasetSize,
+                         const size_t /* maxNumTokens */,
+                         const size_t dictionarySize)
+  {
+    output.zeros(dictionarySize, datasetSize);
+  }
+
+  /**
+   * The function initializes the output matrix. The encoder writes data
+   * in the row-major order.
+   *
+   * Overloaded function to save the result in vector<vector<ElemType>>.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param output Output matrix to store the encoded results.
+   * @param datasetSize The number of strings in the input dataset.
+   * @param * (maxNumTokens) The maximum number of tokens in the strings of the
+   *                     input dataset (not used).
+   * @param dictionarySize The number of output features.
+   */
+  template<typename ElemType>
+  static void InitMatrix(std::vector<std::vector<ElemType>>& output,
+                         const size_t datasetSize,
+                         const size_t /* maxNumTokens */,
+                         const size_t dictionarySize)
+  {
+    output.resize(datasetSize, std::vector<ElemType>(dictionarySize));
+  }
+
+  /**
+   * The function writes the encoded token to the output. The encoder writes
+   * data in the column-major order.
+   *
+   * @tparam MatType The output matrix type.
+   *
+   * @param output Output matrix to store the encoded results (sp_mat or mat).
+   * @param value The label of the token given by HashingDictionary.
+   * @param line The line number at which the encoding is performed.
+   * @param * (index) The token index in the line.
+   */
+  template<typename MatType>
+  void Encode(MatType& output,
+              const size_t value,
+              const size_t line,
+              const size_t /* index */) const
+  {
+    output((value - 1) / 2, line) += Sign(value);
+  }
+
+  /**
+   * The function writes the encoded token to the output. The encoder writes
+   * data in the row-major order.
+   *
+   * Overloaded function to accept vector<vector<ElemType>> as the output
+   * type.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param output Output matrix to store the encoded results.
+   * @param value The label of the token given by HashingDictionary.
+   * @param line The line number at which the encoding is performed.
+   * @param * (index) The line token number at which the encoding is performed.
+   */
+  template<typename ElemType>
+  void Encode(std::vector<std::vector<ElemType>>& output,
+              const size_t value,
+              const size_t line,
+              const size_t /* index */) const
+  {
+    output[line][(value - 1) / 2] += Sign(value);
+  }
+
+  /**
+   * The function is not used by the feature hashing encoding policy.
+   *
+   * @param * (line) The line number at which the encoding is performed.
+   * @param * (index) The token sequence number in the line.
+   * @param * (value) The encoded token.
+   */
+  static void PreprocessToken(size_t /* line */,
+                              size_t /* index */,
+                              size_t /* value */)
+  { }
+
+  //! Get whether the tokens add the sign given by their hash.
+  bool AlternateSign() const { return alternateSign; }
+  //! Modify whether the tokens add the sign given by their hash.
+  bool& AlternateSign() { return alternateSign; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(alternateSign));
+  }
+
+ private:
+  //! Get the value that the token with the given label adds to its feature.
+  double Sign(const size_t value) const
+  {
+    return (alternateSign && ((value - 1) & 1)) ? -1.0 : 1.0;
+  }
+
+  //! Whether the tokens add the sign given by their hash.
+  bool alternateSign;
+};
+
+/**
+ * A convenient alias for the StringEncoding class with
+ * FeatureHashingEncodingPolicy and the hashing dictionary for the given token
+ * type.  The number of output features is set through the dictionary:
+ *
+ * @code
+ * FeatureHashingEncoding<boost::string_view> encoder;
+ * encoder.Dictionary() = HashingDictionary<boost::string_view>(1 << 18);
+ * encoder.Encode(input, output, SplitByAnyOf(" ,."));
+ * @endcode
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using FeatureHashingEncoding = StringEncoding<FeatureHashingEncodingPolicy,
+                                              HashingDictionary<TokenType>>;
+
+} // namespace data
+} // namespace mlpack
+
+#endif
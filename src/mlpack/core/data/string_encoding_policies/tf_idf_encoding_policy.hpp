@@ -152,11 +152,11 @@ class TfIdfEncodingPolicy
   {
     const typename MatType::elem_type tf =
         TermFrequency<typename MatType::elem_type>(
-            tokensFrequences[line][value], linesSizes[line]);
+            tokensFrequences[line].at(value), linesSizes[line]);
 
     const typename MatType::elem_type idf =
         InverseDocumentFrequency<typename MatType::elem_type>(
-            output.n_cols, numContainingStrings[value]);
+            output.n_cols, numContainingStrings.at(value));
 
     output(value - 1, line) =  tf * idf;
   }
@@ -183,10 +183,10 @@ class TfIdfEncodingPolicy
               const size_t /* index */)
   {
     const ElemType tf = TermFrequency<ElemType>(
-        tokensFrequences[line][value], linesSizes[line]);
+        tokensFrequences[line].at(value), linesSizes[line]);
 
     const ElemType idf = InverseDocumentFrequency<ElemType>(
-        output.size(), numContainingStrings[value]);
+        output.size(), numContainingStrings.at(value));
 
     output[line][value - 1] =  tf * idf;
   }
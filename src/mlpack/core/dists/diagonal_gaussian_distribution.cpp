@@ -51,16 +51,28 @@ void DiagonalGaussianDistribution::LogProbability(
     arma::vec& logProbabilities) const
 {
   const size_t k = observations.n_rows;
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  const double logNormalizer = -0.5 * k * log2pi - 0.5 * logDetCov;
 
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  arma::mat diffs = observations.each_col() - mean;
-
-  // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  arma::vec logExponents = -0.5 * arma::trans(diffs % diffs) * invCov;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  logProbabilities.set_size(observations.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols);
+
+    // Column i of 'diffs' is the difference between observations.col(i) and
+    // the mean.
+    arma::mat diffs = observations.cols(begin, end - 1);
+    diffs.each_col() -= mean;
+
+    // Calculates log of exponent equation in multivariate Gaussian
+    // distribution. We use only diagonal part for faster computation.
+    logProbabilities.subvec(begin, end - 1) = logNormalizer -
+        0.5 * arma::trans(diffs % diffs) * invCov;
+  }
 }
 
 arma::vec DiagonalGaussianDistribution::Random() const
@@ -76,6 +76,34 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // Blocks of observations are small enough that their differences to the mean
+  // stay in cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+  const double logNormalizer = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov;
+
+  logProbabilities.set_size(x.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+    // Since cov = LL^T, the Mahalanobis distance of each observation is the
+    // squared norm of L^-1 (x - mean); the triangular solve takes half the work
+    // of a product with the inverse covariance.
+    arma::mat diffs = x.cols(begin, end - 1);
+    diffs.each_col() -= mean;
+    const arma::mat whitened = arma::solve(arma::trimatl(covLower), diffs);
+
+    logProbabilities.subvec(begin, end - 1) = logNormalizer -
+        0.5 * arma::sum(arma::square(whitened), 0).t();
+  }
+}
+
 arma::vec GaussianDistribution::Random() const
 {
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
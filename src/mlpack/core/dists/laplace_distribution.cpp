@@ -36,10 +36,36 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
 void LaplaceDistribution::Probability(const arma::mat& x,
                                       arma::vec& probabilities) const
 {
-  probabilities.set_size(x.n_cols);
-  for (size_t i = 0; i < x.n_cols; ++i)
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Evaluate log probability density function of given observations, one block of
+ * observations at a time (in parallel, if OpenMP is available).
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
+void LaplaceDistribution::LogProbability(const arma::mat& x,
+                                         arma::vec& logProbabilities) const
+{
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (x.n_cols + blockSize - 1) / blockSize;
+  const double logNormalizer = -log(2. * scale);
+
+  logProbabilities.set_size(x.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    probabilities(i) = Probability(x.unsafe_col(i));
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) x.n_cols);
+
+    arma::mat diffs = x.cols(begin, end - 1);
+    diffs.each_col() -= mean;
+
+    logProbabilities.subvec(begin, end - 1) = logNormalizer -
+        arma::sqrt(arma::sum(arma::square(diffs), 0)).t() / scale;
   }
 }
 
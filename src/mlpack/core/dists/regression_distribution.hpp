@@ -132,6 +132,27 @@ class RegressionDistribution
     return log(Probability(observation));
   }
 
+  /**
+   * Evaluate probability density function of each of the given observations.
+   *
+   * @param observations List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Evaluate log probability density function of each of the given
+   * observations.  The fitted values of all observations are predicted at once,
+   * and then the log probabilities of all the residuals are computed at once.
+   *
+   * @param observations List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -14,6 +14,9 @@
 
 #include <mlpack/core.hpp>
 
+#include <map>
+#include <set>
+
 namespace mlpack {
 namespace hpt {
 
@@ -73,6 +76,22 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation for each column of the given matrix of candidate
+   * parameters.  The candidates are split into numThreads contiguous parts
+   * that are evaluated in parallel with OpenMP, each on its own copy of the
+   * cross-validation object; the best model is then chosen as if the
+   * candidates were evaluated one after another.  Candidates that have been
+   * evaluated before are not evaluated again.
+   *
+   * @param candidates Candidate parameters, one per column.
+   * @param objectives Vector to store the objective of each candidate.
+   * @param numThreads Number of parts evaluated in parallel.
+   */
+  void EvaluateCandidates(const arma::mat& candidates,
+                          arma::rowvec& objectives,
+                          const size_t numThreads);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -86,6 +105,17 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get the number of distinct parameters evaluated so far.
+  size_t NumEvaluations() const { return cache.size(); }
+
+  /**
+   * Forget the parameters evaluated so far and the best model, so that the
+   * next evaluations start from scratch.  This should be called when the
+   * cross-validation object has been changed (for instance when it is set to
+   * train on a different fraction of the data).
+   */
+  void Reset();
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -125,6 +155,15 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! The objectives of the parameters evaluated so far.
+  std::map<std::vector<double>, double> cache;
+
+  /**
+   * Change the best model if the given objective is better, or if we probably
+   * have not assigned any valid (trained) model yet.
+   */
+  void UpdateBestModel(const double objective, MLAlgorithm& model);
+
   /**
    * Collect all arguments and run cross-validation.
    */
@@ -133,10 +172,13 @@ class CVFunction
            typename... Args,
            typename = typename
                std::enable_if<(BoundArgIndex + ParamIndex < TotalArgs)>::type>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(CVType& currentCV,
+                         const arma::mat& parameters,
+                         const Args&... args);
 
   /**
-   * Run cross-validation with the collected arguments.
+   * Run cross-validation with the collected arguments on the given
+   * cross-validation object.
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
@@ -144,7 +186,9 @@ class CVFunction
            typename = typename
                std::enable_if<BoundArgIndex + ParamIndex == TotalArgs>::type,
            typename = void>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(CVType& currentCV,
+                         const arma::mat& parameters,
+                         const Args&... args);
 
   /**
    * Put the bound argument (at the BoundArgIndex position) as the next one.
@@ -154,7 +198,9 @@ class CVFunction
            typename... Args,
            typename = typename std::enable_if<
                UseBoundArg<BoundArgIndex, ParamIndex>::value>::type>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(CVType& currentCV,
+                           const arma::mat& parameters,
+                           const Args&... args);
 
   /**
    * Put the element (at the ParamIndex position) of the parameters as the next
@@ -166,7 +212,9 @@ class CVFunction
            typename = typename std::enable_if<
                !UseBoundArg<BoundArgIndex, ParamIndex>::value>::type,
            typename = void>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(CVType& currentCV,
+                           const arma::mat& parameters,
+                           const Args&... args);
 };
 
 
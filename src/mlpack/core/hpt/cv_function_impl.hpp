@@ -65,7 +65,116 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  const std::vector<double> key(parameters.begin(), parameters.end());
+  const auto it = cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
+  const double objective = Evaluate<0, 0>(cv, parameters);
+  UpdateBestModel(objective, cv.Model());
+  cache[key] = objective;
+
+  return objective;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+EvaluateCandidates(const arma::mat& candidates,
+                   arma::rowvec& objectives,
+                   const size_t numThreads)
+{
+  objectives.set_size(candidates.n_cols);
+
+  // Collect the candidates that have not been evaluated yet, keeping only the
+  // first of equal candidates.
+  std::vector<size_t> pending;
+  std::set<std::vector<double>> pendingKeys;
+  for (size_t i = 0; i < candidates.n_cols; ++i)
+  {
+    const std::vector<double> key(candidates.begin_col(i),
+        candidates.end_col(i));
+    if (cache.count(key) == 0 && pendingKeys.insert(key).second)
+      pending.push_back(i);
+  }
+
+  const size_t numParts = std::min(numThreads, pending.size());
+  if (numParts <= 1)
+  {
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      const arma::mat parameters = candidates.col(i);
+      objectives[i] = Evaluate(parameters);
+    }
+    return;
+  }
+
+  arma::vec pendingObjectives(pending.size());
+  arma::vec partObjectives(numParts);
+  std::vector<MLAlgorithm> partModels(numParts);
+
+  #pragma omp parallel for
+  for (omp_size_t p = 0; p < (omp_size_t) numParts; ++p)
+  {
+    // Each part keeps its last model in its own copy of the cross-validation
+    // object; the copies share the data.
+    CVType partCV(cv);
+    const size_t first = (size_t) p * pending.size() / numParts;
+    const size_t last = ((size_t) p + 1) * pending.size() / numParts;
+    for (size_t j = first; j < last; ++j)
+    {
+      const arma::mat parameters = candidates.col(pending[j]);
+      pendingObjectives[j] = Evaluate<0, 0>(partCV, parameters);
+      if (j == first || partObjectives[p] > pendingObjectives[j])
+      {
+        partObjectives[p] = pendingObjectives[j];
+        partModels[p] = std::move(partCV.Model());
+      }
+    }
+  }
+
+  // The parts are merged in order, so that ties are broken as in a serial
+  // evaluation.
+  for (size_t p = 0; p < numParts; ++p)
+    UpdateBestModel(partObjectives[p], partModels[p]);
+  for (size_t j = 0; j < pending.size(); ++j)
+  {
+    cache[std::vector<double>(candidates.begin_col(pending[j]),
+        candidates.end_col(pending[j]))] = pendingObjectives[j];
+  }
+
+  for (size_t i = 0; i < candidates.n_cols; ++i)
+  {
+    objectives[i] = cache.at(std::vector<double>(candidates.begin_col(i),
+        candidates.end_col(i)));
+  }
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Reset()
+{
+  cache.clear();
+  bestObjective = std::numeric_limits<double>::max();
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+UpdateBestModel(const double objective, MLAlgorithm& model)
+{
+  if (bestObjective > objective ||
+      bestObjective == std::numeric_limits<double>::max())
+  {
+    bestObjective = objective;
+    bestModel = std::move(model);
+  }
 }
 
 template<typename CVType,
@@ -98,10 +207,11 @@ template<size_t BoundArgIndex,
          typename... Args,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    CVType& currentCV,
     const arma::mat& parameters,
     const Args&... args)
 {
-  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, args...);
+  return PutNextArg<BoundArgIndex, ParamIndex>(currentCV, parameters, args...);
 }
 
 template<typename CVType,
@@ -114,21 +224,11 @@ template<size_t BoundArgIndex,
          typename,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    CVType& currentCV,
     const arma::mat& /* parameters */,
     const Args&... args)
 {
-  double objective = cv.Evaluate(args...);
-
-  // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
-  {
-    bestObjective = objective;
-    bestModel = std::move(cv.Model());
-  }
-
-  return objective;
+  return currentCV.Evaluate(args...);
 }
 
 template<typename CVType,
@@ -140,11 +240,12 @@ template<size_t BoundArgIndex,
          typename... Args,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
+    CVType& currentCV,
     const arma::mat& parameters,
     const Args&... args)
 {
-  return Evaluate<BoundArgIndex + 1, ParamIndex>(
-      parameters, args..., std::get<BoundArgIndex>(boundArgs).value);
+  return Evaluate<BoundArgIndex + 1, ParamIndex>(currentCV, parameters,
+      args..., std::get<BoundArgIndex>(boundArgs).value);
 }
 
 template<typename CVType,
@@ -157,18 +258,20 @@ template<size_t BoundArgIndex,
          typename,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
+    CVType& currentCV,
     const arma::mat& parameters,
     const Args&... args)
 {
   if (datasetInfo.Type(ParamIndex) == data::Datatype::categorical)
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
-        datasetInfo.UnmapString(size_t(parameters(ParamIndex, 0)), ParamIndex));
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(currentCV, parameters,
+        args..., datasetInfo.UnmapString(size_t(parameters(ParamIndex, 0)),
+        ParamIndex));
   }
   else
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
-        parameters(ParamIndex, 0));
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(currentCV, parameters,
+        args..., parameters(ParamIndex, 0));
   }
 }
 
@@ -151,6 +151,84 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  /**
+   * Get the number of threads used to evaluate the candidate hyper-parameters
+   * when the optimizer is GridSearch.  If it is greater than 1, all the
+   * candidates of the grid are evaluated in parallel with OpenMP, each thread
+   * using its own copy of the cross-validation object (the copies share the
+   * data); the result is the same as with a serial search.
+   *
+   * The default value is 1.
+   */
+  size_t NumThreads() const { return numThreads; }
+
+  /**
+   * Modify the number of threads used to evaluate the candidate
+   * hyper-parameters when the optimizer is GridSearch.  If it is greater than
+   * 1, all the candidates of the grid are evaluated in parallel with OpenMP,
+   * each thread using its own copy of the cross-validation object (the copies
+   * share the data); the result is the same as with a serial search.
+   *
+   * The default value is 1.
+   */
+  size_t& NumThreads() { return numThreads; }
+
+  /**
+   * Get whether the candidates of GridSearch are evaluated with successive
+   * halving.  If true, all the candidates are first evaluated with models
+   * trained on the fraction MinTrainingFraction() of the training data (the
+   * CV class has to provide TrainingFraction(), as SimpleCV and KFoldCV do);
+   * then only the best 1 / ReductionFactor() of them are kept and evaluated
+   * again with ReductionFactor() times more data, and so on until the
+   * remaining candidates are evaluated with all the data.  Each round of
+   * evaluations is run in parallel when NumThreads() is greater than 1.  This
+   * is much cheaper than evaluating every candidate with all the data, but
+   * the best candidate may be discarded early if its advantage only shows on
+   * large training sets.
+   *
+   * The default value is false.
+   */
+  bool SuccessiveHalving() const { return successiveHalving; }
+  /**
+   * Modify whether the candidates of GridSearch are evaluated with successive
+   * halving (see SuccessiveHalving() const).
+   *
+   * The default value is false.
+   */
+  bool& SuccessiveHalving() { return successiveHalving; }
+
+  /**
+   * Get the factor by which the number of candidates is reduced and the
+   * fraction of training data is increased after each round of successive
+   * halving.  It should be greater than 1.
+   *
+   * The default value is 3.
+   */
+  double ReductionFactor() const { return reductionFactor; }
+  /**
+   * Modify the factor by which the number of candidates is reduced and the
+   * fraction of training data is increased after each round of successive
+   * halving.  It should be greater than 1.
+   *
+   * The default value is 3.
+   */
+  double& ReductionFactor() { return reductionFactor; }
+
+  /**
+   * Get the fraction of the training data used in the first round of
+   * successive halving.  It should be more than 0 and not more than 1.
+   *
+   * The default value is 1 / 9.
+   */
+  double MinTrainingFraction() const { return minTrainingFraction; }
+  /**
+   * Modify the fraction of the training data used in the first round of
+   * successive halving.  It should be more than 0 and not more than 1.
+   *
+   * The default value is 1 / 9.
+   */
+  double& MinTrainingFraction() { return minTrainingFraction; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
@@ -230,6 +308,20 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! The number of threads used to evaluate the candidates of GridSearch.
+  size_t numThreads;
+
+  //! Whether the candidates of GridSearch are evaluated with successive
+  //! halving.
+  bool successiveHalving;
+
+  //! The reduction factor of successive halving.
+  double reductionFactor;
+
+  //! The fraction of the training data used in the first round of successive
+  //! halving.
+  double minTrainingFraction;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -345,6 +437,58 @@ class HyperParameterTuner
                std::enable_if_t<I == std::tuple_size<TupleType>::value>,
            typename = void>
   inline TupleType VectorToTuple(const arma::vec& vector, const Args&... args);
+
+  /**
+   * Run the optimizer on the given CVFunction, and store the best parameters
+   * in bestParams.  This overload is called when the optimizer is GridSearch,
+   * which may be replaced by a parallel search or by successive halving.
+   */
+  template<typename CVFunctionType>
+  double RunOptimizer(CVFunctionType& cvFunction,
+                      arma::mat& bestParams,
+                      const std::vector<bool>& categoricalDimensions,
+                      const arma::Row<size_t>& numCategories,
+                      std::true_type /* isGridSearch */);
+
+  /**
+   * Run the optimizer on the given CVFunction, and store the best parameters
+   * in bestParams.  This overload is called when the optimizer is not
+   * GridSearch.
+   */
+  template<typename CVFunctionType>
+  double RunOptimizer(CVFunctionType& cvFunction,
+                      arma::mat& bestParams,
+                      const std::vector<bool>& categoricalDimensions,
+                      const arma::Row<size_t>& numCategories,
+                      std::false_type /* isGridSearch */);
+
+  /**
+   * Enumerate all the candidates of the grid defined by the given numbers of
+   * categories, one per column, in the order GridSearch visits them.
+   */
+  arma::mat GridCandidates(const std::vector<bool>& categoricalDimensions,
+                           const arma::Row<size_t>& numCategories);
+
+  /**
+   * Evaluate all the candidates of the grid defined by the given numbers of
+   * categories in parallel, and store the best candidate in bestParams.
+   */
+  template<typename CVFunctionType>
+  double ParallelGridSearch(CVFunctionType& cvFunction,
+                            arma::mat& bestParams,
+                            const std::vector<bool>& categoricalDimensions,
+                            const arma::Row<size_t>& numCategories);
+
+  /**
+   * Evaluate the candidates of the grid defined by the given numbers of
+   * categories with successive halving, and store the best candidate in
+   * bestParams.
+   */
+  template<typename CVFunctionType>
+  double SuccessiveHalvingSearch(CVFunctionType& cvFunction,
+                                 arma::mat& bestParams,
+                                 const std::vector<bool>& categoricalDimensions,
+                                 const arma::Row<size_t>& numCategories);
 };
 
 } // namespace hpt
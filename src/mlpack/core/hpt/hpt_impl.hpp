@@ -32,7 +32,9 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), relativeDelta(0.01), minDelta(1e-10), numThreads(1),
+    successiveHalving(false), reductionFactor(3.0),
+    minTrainingFraction(1.0 / 9.0) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -104,11 +106,11 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
-  bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
-      bestParams, categoricalDimensions, numCategories) :
-      -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
-      numCategories);
-      bestModel = std::move(cvFunction.BestModel());
+  const double objective = RunOptimizer(cvFunction, bestParams,
+      categoricalDimensions, numCategories,
+      std::is_same<decltype(optimizer), ens::GridSearch>());
+  bestObjective = Metric::NeedsMinimization ? objective : -objective;
+  bestModel = std::move(cvFunction.BestModel());
 }
 
 template<typename MLAlgorithm,
@@ -244,6 +246,224 @@ TupleType HyperParameterTuner<MLAlgorithm,
   return TupleType(args...);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::ParallelGridSearch(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  const arma::mat candidates = GridCandidates(categoricalDimensions,
+      numCategories);
+
+  arma::rowvec objectives;
+  cvFunction.EvaluateCandidates(candidates, objectives, numThreads);
+
+  // index_min() returns the first minimum, as GridSearch does.
+  const size_t best = objectives.index_min();
+  bestParams = candidates.col(best);
+  return objectives[best];
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::SuccessiveHalvingSearch(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  if (reductionFactor <= 1.0)
+  {
+    throw std::invalid_argument("HyperParameterTuner::Optimize(): the "
+        "reduction factor of successive halving must be greater than 1!");
+  }
+
+  if (minTrainingFraction <= 0.0 || minTrainingFraction > 1.0)
+  {
+    throw std::invalid_argument("HyperParameterTuner::Optimize(): the minimum "
+        "training fraction of successive halving must be more than 0 and not "
+        "more than 1!");
+  }
+
+  const arma::mat candidates = GridCandidates(categoricalDimensions,
+      numCategories);
+
+  // The number of rounds before the last one, which uses all the training
+  // data.
+  const size_t numReducedRounds = (size_t) std::floor(std::log(1.0 /
+      minTrainingFraction) / std::log(reductionFactor) + 1e-10);
+
+  // The survivors are kept in the order of the grid, so that ties are broken
+  // as GridSearch does.
+  arma::uvec survivors = arma::regspace<arma::uvec>(0, candidates.n_cols - 1);
+  arma::rowvec objectives;
+  for (size_t r = 0; ; ++r)
+  {
+    const bool lastRound = (r >= numReducedRounds || survivors.n_elem == 1);
+    cv.TrainingFraction() = lastRound ? 1.0 :
+        minTrainingFraction * std::pow(reductionFactor, (double) r);
+
+    // The objectives obtained with different fractions of the data can't be
+    // compared, so each round starts from scratch.
+    cvFunction.Reset();
+    cvFunction.EvaluateCandidates(candidates.cols(survivors), objectives,
+        numThreads);
+    if (lastRound)
+      break;
+
+    const size_t numKept = std::max((size_t) (survivors.n_elem /
+        reductionFactor), (size_t) 1);
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    survivors = arma::sort(survivors(order.head(numKept)));
+  }
+  cv.TrainingFraction() = 1.0;
+
+  // index_min() returns the first minimum, as GridSearch does.
+  const size_t best = objectives.index_min();
+  bestParams = candidates.col(survivors[best]);
+  return objectives[best];
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    std::true_type /* isGridSearch */)
+{
+  if (successiveHalving)
+  {
+    return SuccessiveHalvingSearch(cvFunction, bestParams,
+        categoricalDimensions, numCategories);
+  }
+  else if (numThreads > 1)
+  {
+    return ParallelGridSearch(cvFunction, bestParams, categoricalDimensions,
+        numCategories);
+  }
+
+  return optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
+      numCategories);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    std::false_type /* isGridSearch */)
+{
+  if (successiveHalving)
+  {
+    throw std::invalid_argument("HyperParameterTuner::Optimize(): successive "
+        "halving can only be used with GridSearch!");
+  }
+
+  return optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
+      numCategories);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+arma::mat HyperParameterTuner<MLAlgorithm,
+                              Metric,
+                              CV,
+                              Optimizer,
+                              MatType,
+                              PredictionsType,
+                              WeightsType>::GridCandidates(
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  size_t numCandidates = 1;
+  for (size_t d = 0; d < categoricalDimensions.size(); ++d)
+  {
+    if (!categoricalDimensions[d])
+    {
+      std::ostringstream oss;
+      oss << "HyperParameterTuner::Optimize(): GridSearch can only optimize "
+          << "categorical dimensions, but dimension " << d << " is not "
+          << "categorical!";
+      throw std::invalid_argument(oss.str());
+    }
+    numCandidates *= numCategories[d];
+  }
+
+  // Enumerate the candidates in the order GridSearch visits them: the last
+  // dimension changes the fastest.
+  arma::mat candidates(categoricalDimensions.size(), numCandidates);
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    size_t index = c;
+    for (size_t d = categoricalDimensions.size(); d > 0; --d)
+    {
+      candidates(d - 1, c) = index % numCategories[d - 1];
+      index /= numCategories[d - 1];
+    }
+  }
+
+  return candidates;
+}
+
 } // namespace hpt
 } // namespace mlpack
 
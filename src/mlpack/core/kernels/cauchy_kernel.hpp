@@ -14,7 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
-#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +68,24 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Compute the kernel matrix between the columns of a and the columns of b,
+   * k(i, j) = K(a_i, b_j), from the matrix of squared distances between the
+   * points (see SquaredDistanceMatrix()).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  template<typename eT>
+  void Evaluate(const arma::Mat<eT>& a,
+                const arma::Mat<eT>& b,
+                arma::Mat<eT>& k) const
+  {
+    SquaredDistanceMatrix(a, b, k);
+    k = 1.0 / (1.0 + k / (bandwidth * bandwidth));
+  }
+
   /**
    * Serialize the kernel.
    */
@@ -89,6 +107,8 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel has a block evaluation.
+  static const bool HasBlockEvaluate = true;
 };
 
 } // namespace kernel
@@ -41,6 +41,20 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Compute the kernel matrix between the columns of a and the columns of b,
+   * k(i, j) = K(a_i, b_j), with one matrix product, normalized by the norms of
+   * the points.
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  template<typename eT>
+  static void Evaluate(const arma::Mat<eT>& a,
+                       const arma::Mat<eT>& b,
+                       arma::Mat<eT>& k);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -56,6 +70,9 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel has a block evaluation.
+  static const bool HasBlockEvaluate = true;
 };
 
 } // namespace kernel
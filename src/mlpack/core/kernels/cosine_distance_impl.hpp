@@ -32,6 +32,23 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename eT>
+void CosineDistance::Evaluate(const arma::Mat<eT>& a,
+                              const arma::Mat<eT>& b,
+                              arma::Mat<eT>& k)
+{
+  // As above, the value is 0 if either point has a norm of 0; the norms are
+  // replaced by 1, since the dot products are then 0 already.
+  arma::Row<eT> aNorms = arma::sqrt(arma::sum(arma::square(a), 0));
+  arma::Row<eT> bNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+  aNorms.elem(arma::find(aNorms == 0)).ones();
+  bNorms.elem(arma::find(bNorms == 0)).ones();
+
+  k = a.t() * b;
+  k.each_col() /= aNorms.t();
+  k.each_row() /= bNorms;
+}
+
 } // namespace kernel
 } // namespace mlpack
 
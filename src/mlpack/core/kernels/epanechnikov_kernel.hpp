@@ -13,7 +13,7 @@
 #define MLPACK_CORE_KERNELS_EPANECHNIKOV_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -51,6 +51,20 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Compute the kernel matrix between the columns of a and the columns of b,
+   * k(i, j) = K(a_i, b_j), from the matrix of squared distances between the
+   * points (see SquaredDistanceMatrix()).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  template<typename eT>
+  void Evaluate(const arma::Mat<eT>& a,
+                const arma::Mat<eT>& b,
+                arma::Mat<eT>& k) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
@@ -111,6 +125,8 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel has a block evaluation.
+  static const bool HasBlockEvaluate = true;
 };
 
 } // namespace kernel
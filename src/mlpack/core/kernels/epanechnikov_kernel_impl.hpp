@@ -29,6 +29,16 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+template<typename eT>
+inline void EpanechnikovKernel::Evaluate(const arma::Mat<eT>& a,
+                                         const arma::Mat<eT>& b,
+                                         arma::Mat<eT>& k) const
+{
+  SquaredDistanceMatrix(a, b, k);
+  k = 1.0 - k * inverseBandwidthSquared;
+  k.elem(arma::find(k < 0)).zeros();
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
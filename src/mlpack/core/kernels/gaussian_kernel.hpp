@@ -16,7 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
-#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -68,6 +68,24 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Compute the kernel matrix between the columns of a and the columns of b,
+   * k(i, j) = K(a_i, b_j), from the matrix of squared distances between the
+   * points (see SquaredDistanceMatrix()).
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  template<typename eT>
+  void Evaluate(const arma::Mat<eT>& a,
+                const arma::Mat<eT>& b,
+                arma::Mat<eT>& k) const
+  {
+    SquaredDistanceMatrix(a, b, k);
+    k = arma::exp(gamma * k);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -171,6 +189,8 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel has a block evaluation.
+  static const bool HasBlockEvaluate = true;
 };
 
 } // namespace kernel
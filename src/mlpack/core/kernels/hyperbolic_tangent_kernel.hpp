@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -62,6 +63,22 @@ class HyperbolicTangentKernel
     return tanh(scale * arma::dot(a, b) + offset);
   }
 
+  /**
+   * Compute the kernel matrix between the columns of a and the columns of b,
+   * k(i, j) = K(a_i, b_j), with one matrix product.
+   *
+   * @param a First set of points (one per column).
+   * @param b Second set of points (one per column).
+   * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+   */
+  template<typename eT>
+  void Evaluate(const arma::Mat<eT>& a,
+                const arma::Mat<eT>& b,
+                arma::Mat<eT>& k) const
+  {
+    k = arma::tanh(scale * (a.t() * b) + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -85,6 +102,19 @@ class HyperbolicTangentKernel
   double offset;
 };
 
+//! Kernel traits for the hyperbolic tangent kernel.
+template<>
+class KernelTraits<HyperbolicTangentKernel>
+{
+ public:
+  //! The hyperbolic tangent kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The hyperbolic tangent kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The hyperbolic tangent kernel has a block evaluation.
+  static const bool HasBlockEvaluate = true;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -0,0 +1,185 @@
+/**
+ * @file core/kernels/kernel_matrix.hpp
+ *
+ * Functions to compute the kernel matrix between two sets of points, with the
+ * block evaluation of the kernel when it has one (see KernelTraits), and with
+ * one kernel evaluation per pair of points otherwise.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Compute the squared Euclidean distances between the columns of a and the
+ * columns of b, d(i, j) = || a_i - b_j ||^2, with one matrix product, as
+ * || a_i ||^2 + || b_j ||^2 - 2 a_i^T b_j.  Distances that are negative
+ * because of cancellation are set to 0, and if a and b are the same matrix the
+ * diagonal is exactly 0.  The block evaluations of the distance-based kernels
+ * use this function.
+ *
+ * @param a First set of points (one per column).
+ * @param b Second set of points (one per column).
+ * @param d Matrix to store the squared distances in (a.n_cols x b.n_cols).
+ */
+template<typename eT>
+void SquaredDistanceMatrix(const arma::Mat<eT>& a,
+                           const arma::Mat<eT>& b,
+                           arma::Mat<eT>& d)
+{
+  d = -2 * a.t() * b;
+  d.each_col() += arma::sum(arma::square(a), 0).t();
+  d.each_row() += arma::sum(arma::square(b), 0);
+  d.elem(arma::find(d < 0)).zeros();
+
+  if (&a == &b)
+    d.diag().zeros();
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * k(i, j) = K(a_i, b_j), one kernel evaluation at a time.  The columns of the
+ * matrix are computed in parallel, so the kernel's Evaluate() function must be
+ * callable from several threads.  The other overloads use this function when
+ * the kernel has no block evaluation, or for matrices that are not dense.
+ */
+template<typename KernelType, typename MatType, typename OutMatType>
+void KernelMatrixLoop(KernelType& kernel,
+                      const MatType& a,
+                      const MatType& b,
+                      OutMatType& k)
+{
+  k.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      k(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * k(i, j) = K(a_i, b_j), with the block evaluation of the kernel, which uses
+ * matrix products instead of one evaluation per pair of points.  This
+ * overload is used for kernels with KernelTraits<KernelType>::HasBlockEvaluate
+ * set to true.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points (one per column).
+ * @param b Second set of points (one per column).
+ * @param k Matrix to store the kernel values in (a.n_cols x b.n_cols).
+ */
+template<typename KernelType, typename eT>
+typename std::enable_if<KernelTraits<KernelType>::HasBlockEvaluate>::type
+KernelMatrix(KernelType& kernel,
+             const arma::Mat<eT>& a,
+             const arma::Mat<eT>& b,
+             arma::Mat<eT>& k)
+{
+  kernel.Evaluate(a, b, k);
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * k(i, j) = K(a_i, b_j), for a kernel without block evaluation.
+ */
+template<typename KernelType, typename eT>
+typename std::enable_if<!KernelTraits<KernelType>::HasBlockEvaluate>::type
+KernelMatrix(KernelType& kernel,
+             const arma::Mat<eT>& a,
+             const arma::Mat<eT>& b,
+             arma::Mat<eT>& k)
+{
+  KernelMatrixLoop(kernel, a, b, k);
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * k(i, j) = K(a_i, b_j), for matrices that are not dense (such as sparse
+ * matrices).  The kernel is evaluated once per pair of points.
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& k)
+{
+  KernelMatrixLoop(kernel, a, b, k);
+}
+
+/**
+ * Compute the (symmetric) kernel matrix of the columns of the given data,
+ * k(i, j) = K(x_i, x_j).  If the kernel has a block evaluation, it is used;
+ * otherwise, only the upper triangular part of the matrix is evaluated, and it
+ * is copied to the lower triangular part.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param data Set of points (one per column).
+ * @param k Matrix to store the kernel values in (data.n_cols x data.n_cols).
+ */
+template<typename KernelType, typename eT>
+typename std::enable_if<KernelTraits<KernelType>::HasBlockEvaluate>::type
+KernelMatrix(KernelType& kernel, const arma::Mat<eT>& data, arma::Mat<eT>& k)
+{
+  kernel.Evaluate(data, data, k);
+}
+
+/**
+ * Compute the (symmetric) kernel matrix of the columns of the given data,
+ * k(i, j) = K(x_i, x_j), for a kernel without block evaluation, or for
+ * matrices that are not dense.  Only the upper triangular part of the matrix
+ * is evaluated, and it is copied to the lower triangular part.  The upper
+ * triangular part is split into square blocks of 64 x 64 entries, which are
+ * evaluated in parallel, so that the points of a block stay in the cache
+ * while they are compared.
+ */
+template<typename KernelType, typename MatType, typename OutMatType>
+typename std::enable_if<!KernelTraits<KernelType>::HasBlockEvaluate ||
+    !std::is_same<MatType, OutMatType>::value>::type
+KernelMatrix(KernelType& kernel, const MatType& data, OutMatType& k)
+{
+  const size_t blockSize = 64;
+  const size_t n = data.n_cols;
+  k.set_size(n, n);
+
+  // The pairs of blocks (bi, bj) with bi <= bj are numbered column by column.
+  const size_t numBlocks = (n + blockSize - 1) / blockSize;
+  const size_t numPairs = numBlocks * (numBlocks + 1) / 2;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t p = 0; p < (omp_size_t) numPairs; ++p)
+  {
+    size_t bj = (size_t) ((std::sqrt(8.0 * p + 1.0) - 1.0) / 2.0);
+    while (bj * (bj + 1) / 2 > (size_t) p)
+      --bj;
+    while ((bj + 1) * (bj + 2) / 2 <= (size_t) p)
+      ++bj;
+    const size_t bi = (size_t) p - bj * (bj + 1) / 2;
+
+    const size_t iBegin = bi * blockSize;
+    const size_t jBegin = bj * blockSize;
+    const size_t jEnd = std::min(jBegin + blockSize, n);
+    for (size_t j = jBegin; j < jEnd; ++j)
+    {
+      const size_t iEnd = (bi == bj) ? j + 1 : iBegin + blockSize;
+      for (size_t i = iBegin; i < iEnd; ++i)
+        k(i, j) = kernel.Evaluate(data.col(i), data.col(j));
+    }
+  }
+
+  k = arma::symmatu(k);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -36,6 +36,14 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel has a block evaluation,
+   * Evaluate(const arma::Mat<eT>& a, const arma::Mat<eT>& b, arma::Mat<eT>& k),
+   * which computes the kernel matrix between the columns of a and the columns
+   * of b with matrix products.  KernelMatrix() uses it when it is available.
+   */
+  static const bool HasBlockEvaluate = false;
 };
 
 } // namespace kernel
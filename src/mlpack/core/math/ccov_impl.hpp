@@ -40,9 +40,43 @@ inline arma::Mat<eT> ColumnCovariance(const arma::Mat<eT>& x,
     const size_t n = xAlias.n_cols;
     const eT normVal = (normType == 0) ? ((n > 1) ? eT(n - 1) : eT(1)) : eT(n);
 
-    const arma::Mat<eT> tmp = xAlias.each_col() - arma::mean(xAlias, 1);
+    const arma::Col<eT> mean = arma::mean(xAlias, 1);
+
+    // Instead of centering a copy of the whole matrix, center blocks of points
+    // that are small enough to stay in cache, and accumulate their outer
+    // products.  The points are split into one contiguous range per thread,
+    // and the sums of the ranges are added in order, so the result only
+    // depends on the number of threads.
+    const size_t blockSize = 1024;
+    const size_t numBlocks = (n + blockSize - 1) / blockSize;
+#ifdef HAS_OPENMP
+    const size_t numRanges = std::max(size_t(1), std::min(numBlocks,
+        (size_t) omp_get_max_threads()));
+#else
+    const size_t numRanges = 1;
+#endif
+
+    std::vector<arma::Mat<eT>> sums(numRanges);
+    #pragma omp parallel for schedule(static, 1)
+    for (omp_size_t r = 0; r < (omp_size_t) numRanges; ++r)
+    {
+      sums[r].zeros(xAlias.n_rows, xAlias.n_rows);
+      const size_t firstBlock = r * numBlocks / numRanges;
+      const size_t lastBlock = (r + 1) * numBlocks / numRanges;
+      arma::Mat<eT> centered;
+      for (size_t b = firstBlock; b < lastBlock; ++b)
+      {
+        const size_t begin = b * blockSize;
+        const size_t end = std::min(begin + blockSize, n);
+        centered = xAlias.cols(begin, end - 1);
+        centered.each_col() -= mean;
+        sums[r] += centered * centered.t();
+      }
+    }
 
-    out = tmp * tmp.t();
+    out = std::move(sums[0]);
+    for (size_t r = 1; r < numRanges; ++r)
+      out += sums[r];
     out /= normVal;
   }
 
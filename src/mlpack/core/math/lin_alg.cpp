@@ -43,9 +43,23 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
 void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
 {
   // Get the mean of the elements in each row.
-  arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+  // If xCentered is x, this centers it in place.
+  xCentered.set_size(x.n_rows, x.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    xCentered.col(i) = x.col(i) - rowMean;
+}
+
+/**
+ * Centers a matrix in place, by subtracting the mean of each row from it.
+ *
+ * @param x Matrix to center.
+ */
+void mlpack::math::Center(arma::mat& x)
+{
+  Center(x, x);
 }
 
 /**
@@ -57,18 +71,16 @@ void mlpack::math::WhitenUsingSVD(const arma::mat& x,
                                   arma::mat& xWhitened,
                                   arma::mat& whiteningMatrix)
 {
-  arma::mat covX, u, v, invSMatrix, temp1;
+  arma::mat covX, u, v;
   arma::vec sVector;
 
   covX = mlpack::math::ColumnCovariance(x);
 
   svd(u, sVector, v, covX);
 
-  size_t d = sVector.n_elem;
-  invSMatrix.zeros(d, d);
-  invSMatrix.diag() = 1 / sqrt(sVector);
-
-  whiteningMatrix = v * invSMatrix * trans(u);
+  // Scale the columns of v instead of multiplying by a diagonal matrix.
+  v.each_row() /= arma::sqrt(sVector).t();
+  whiteningMatrix = v * trans(u);
 
   xWhitened = whiteningMatrix * x;
 }
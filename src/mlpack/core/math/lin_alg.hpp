@@ -36,6 +36,14 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Centers a matrix in place, by subtracting the mean of each row from it.
+ * This avoids the copy made by the other overload.
+ *
+ * @param x Matrix to center.
+ */
+void Center(arma::mat& x);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
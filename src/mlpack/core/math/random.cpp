@@ -11,6 +11,8 @@
 #include <random>
 #include <mlpack/mlpack_export.hpp>
 
+#include "random.hpp"
+
 namespace mlpack {
 namespace math {
 
@@ -20,6 +22,44 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// Seed of the per-thread random streams.
+MLPACK_EXPORT uint64_t randStreamSeed = 0;
+// Incremented each time the seed of the per-thread random streams is set.
+MLPACK_EXPORT size_t randStreamGeneration = 0;
+
+namespace {
+
+// The random number generator of each thread, and the generation of the seed
+// it was started from.
+struct ThreadStream
+{
+  ThreadStream() : generation(size_t(-1)) { }
+
+  RandomStream stream;
+  size_t generation;
+};
+
+thread_local ThreadStream threadStream;
+
+} // namespace
+
+RandomStream& ThreadRandGen()
+{
+  if (threadStream.generation != randStreamGeneration)
+  {
+    #ifdef HAS_OPENMP
+      const size_t thread = (size_t) omp_get_thread_num();
+    #else
+      const size_t thread = 0;
+    #endif
+
+    // Stream 0 is left for code that seeds a stream by hand.
+    threadStream.stream.Seed(randStreamSeed, thread + 1);
+    threadStream.generation = randStreamGeneration;
+  }
+
+  return threadStream.stream;
+}
 
 } // namespace math
 } // namespace mlpack
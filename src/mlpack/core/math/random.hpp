@@ -15,6 +15,8 @@
 #include <mlpack/mlpack_export.hpp>
 #include <random>
 
+#include "random_stream.hpp"
+
 namespace mlpack {
 namespace math /** Miscellaneous math routines. */ {
 
@@ -29,6 +31,55 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// Seed of the per-thread random streams.
+extern MLPACK_EXPORT uint64_t randStreamSeed;
+// Incremented each time the seed of the per-thread random streams is set.
+extern MLPACK_EXPORT size_t randStreamGeneration;
+
+/**
+ * Get the random number generator of the calling thread.  Each thread has its
+ * own RandomStream, so it can be used inside OpenMP regions without any
+ * locking; the random functions below (Random(), RandInt(), RandNormal(), ...)
+ * use it when they are called inside a parallel region, and the global
+ * randGen otherwise.
+ *
+ * The stream of a thread is stream t + 1 of the seed given to RandomSeed(),
+ * where t is the OpenMP index of the thread when it first draws a number
+ * after the seed was set; so the numbers drawn by each thread are
+ * reproducible as long as the work is split across the threads the same way
+ * (for instance with a static schedule).  A parallel loop whose results
+ * should not depend on the scheduling at all can instead restart the stream
+ * of the thread for each iteration with SeedThreadRandGen().
+ */
+MLPACK_EXPORT RandomStream& ThreadRandGen();
+
+/**
+ * Restart the random number generator of the calling thread at the given
+ * stream of the given seed.  This is typically called at the start of each
+ * iteration of a parallel loop, with a seed drawn from randGen before the
+ * loop and the index of the iteration as the stream, so that each iteration
+ * draws the same numbers whichever thread runs it.
+ *
+ * @param seed Seed of the stream.
+ * @param stream Index of the stream.
+ */
+inline void SeedThreadRandGen(const uint64_t seed, const uint64_t stream)
+{
+  ThreadRandGen().Seed(seed, stream);
+}
+
+/**
+ * Return whether the random functions should use the generator of the calling
+ * thread, that is, whether they are called inside an OpenMP parallel region.
+ */
+inline bool UseThreadRandGen()
+{
+  #ifdef HAS_OPENMP
+    return omp_in_parallel();
+  #else
+    return false;
+  #endif
+}
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
@@ -41,6 +92,8 @@ inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
     randGen.seed((uint32_t) seed);
+    randStreamSeed = seed;
+    ++randStreamGeneration;
     #if (BINDING_TYPE == BINDING_TYPE_R)
       // To suppress Found 'srand', possibly from 'srand' (C).
       (void) seed;
@@ -65,6 +118,8 @@ inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
   randGen.seed((uint32_t) seed);
+  randStreamSeed = seed;
+  ++randStreamGeneration;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -72,6 +127,8 @@ inline void FixedRandomSeed()
 inline void CustomRandomSeed(const size_t seed)
 {
   randGen.seed((uint32_t) seed);
+  randStreamSeed = seed;
+  ++randStreamGeneration;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
@@ -82,6 +139,9 @@ inline void CustomRandomSeed(const size_t seed)
  */
 inline double Random()
 {
+  if (UseThreadRandGen())
+    return ThreadRandGen().Random();
+
   return randUniformDist(randGen);
 }
 
@@ -90,7 +150,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -109,7 +169,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -117,8 +177,7 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
 }
 
 /**
@@ -126,6 +185,9 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
+  if (UseThreadRandGen())
+    return ThreadRandGen().RandNormal();
+
   return randNormalDist(randGen);
 }
 
@@ -138,7 +200,7 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
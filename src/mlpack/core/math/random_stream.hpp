@@ -0,0 +1,163 @@
+/**
+ * @file core/math/random_stream.hpp
+ *
+ * Definition of the RandomStream class, a counter-based random number
+ * generator with independent streams.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+#define MLPACK_CORE_MATH_RANDOM_STREAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math /** Miscellaneous math routines. */ {
+
+/**
+ * A counter-based random number generator (Philox4x32-10, from Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3", 2011).  The n-th block of
+ * random bits is a fixed function of the seed, the stream and n, so each
+ * (seed, stream) pair gives its own sequence, and any stream can be started
+ * in constant time; streams with different indices don't overlap.  This makes
+ * it easy to give each thread, or each task of a parallel loop, its own
+ * reproducible sequence.  The state is a few words, and the generator is
+ * faster than std::mt19937.
+ *
+ * RandomStream is a UniformRandomBitGenerator, so it can be given to
+ * std::shuffle() and to the distributions of <random>.
+ */
+class RandomStream
+{
+ public:
+  //! The type of the values returned by the generator.
+  typedef uint64_t result_type;
+
+  /**
+   * Create the generator of the given stream of the given seed.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Index of the stream.
+   */
+  RandomStream(const uint64_t seed = 0, const uint64_t stream = 0)
+  {
+    Seed(seed, stream);
+  }
+
+  /**
+   * Restart the generator at the beginning of the given stream of the given
+   * seed.
+   *
+   * @param seed Seed of the generator.
+   * @param stream Index of the stream.
+   */
+  void Seed(const uint64_t seed, const uint64_t stream = 0)
+  {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t) stream;
+    counter[3] = (uint32_t) (stream >> 32);
+    position = 4;
+    hasNormal = false;
+  }
+
+  //! Get 64 random bits.
+  result_type operator()()
+  {
+    if (position == 4)
+      NextBlock();
+
+    const uint64_t result = ((uint64_t) block[position + 1] << 32) |
+        block[position];
+    position += 2;
+    return result;
+  }
+
+  //! Get a uniform random number in [0, 1).
+  double Random()
+  {
+    // The 53 upper bits fill the mantissa of a double.
+    return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  //! Get a normally distributed random number with mean 0 and variance 1.
+  double RandNormal()
+  {
+    if (hasNormal)
+    {
+      hasNormal = false;
+      return normal;
+    }
+
+    // The polar method gives two numbers at once.
+    double u, v, s;
+    do
+    {
+      u = 2.0 * Random() - 1.0;
+      v = 2.0 * Random() - 1.0;
+      s = u * u + v * v;
+    } while (s >= 1.0 || s == 0.0);
+
+    const double factor = std::sqrt(-2.0 * std::log(s) / s);
+    normal = v * factor;
+    hasNormal = true;
+    return u * factor;
+  }
+
+  //! Get the smallest value the generator returns.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest value the generator returns.
+  static constexpr result_type max() { return ~result_type(0); }
+
+ private:
+  //! Compute the next block of random bits, and advance the counter.
+  void NextBlock()
+  {
+    uint32_t c[4] = { counter[0], counter[1], counter[2], counter[3] };
+    uint32_t k[2] = { key[0], key[1] };
+    for (size_t r = 0; r < 10; ++r)
+    {
+      const uint64_t p0 = (uint64_t) 0xD2511F53 * c[0];
+      const uint64_t p1 = (uint64_t) 0xCD9E8D57 * c[2];
+      const uint32_t c0 = (uint32_t) (p1 >> 32) ^ c[1] ^ k[0];
+      const uint32_t c2 = (uint32_t) (p0 >> 32) ^ c[3] ^ k[1];
+      c[1] = (uint32_t) p1;
+      c[3] = (uint32_t) p0;
+      c[0] = c0;
+      c[2] = c2;
+      k[0] += 0x9E3779B9;
+      k[1] += 0xBB67AE85;
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+      block[i] = c[i];
+
+    // The first two words of the counter are the index of the block.
+    if (++counter[0] == 0)
+      ++counter[1];
+    position = 0;
+  }
+
+  //! The key, given by the seed.
+  uint32_t key[2];
+  //! The counter: the index of the next block and the index of the stream.
+  uint32_t counter[4];
+  //! The current block of random bits.
+  uint32_t block[4];
+  //! The position of the next unused word of the block.
+  size_t position;
+  //! The second number of the last pair of normal numbers.
+  double normal;
+  //! Whether normal hasn't been used yet.
+  bool hasNormal;
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -83,6 +83,25 @@ class LMetric
   static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
                                                const VecTypeB& b);
 
+  /**
+   * Computes the distances between all the points of two blocks of points
+   * (columns), in parallel.  For the L2 metric, the distances are computed
+   * from one matrix product and the norms of the points, which is much faster
+   * than evaluating each pair, but can have a small absolute error for points
+   * that are very close to each other.
+   *
+   * @tparam MatTypeA Type of first block (generally arma::mat).
+   * @tparam MatTypeB Type of second block.
+   * @param a First block of points.
+   * @param b Second block of points.
+   * @param distances Matrix to store the distances in; distances(i, j) is the
+   *     distance between a.col(i) and b.col(j).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::Mat<typename MatTypeA::elem_type>& distances);
+
   //! Serialize the metric (nothing to do).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
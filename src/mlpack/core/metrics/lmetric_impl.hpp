@@ -15,6 +15,8 @@
 // In case it hasn't been included.
 #include "lmetric.hpp"
 
+#include <sstream>
+
 namespace mlpack {
 namespace metric {
 
@@ -106,6 +108,54 @@ typename VecTypeA::elem_type LMetric<INT_MAX, false>::Evaluate(
   return arma::as_scalar(arma::max(arma::abs(a - b)));
 }
 
+// Batch evaluation, for any power.
+template<int TPower, bool TTakeRoot>
+template<typename MatTypeA, typename MatTypeB>
+void LMetric<TPower, TTakeRoot>::Evaluate(
+    const MatTypeA& a,
+    const MatTypeB& b,
+    arma::Mat<typename MatTypeA::elem_type>& distances)
+{
+  typedef typename MatTypeA::elem_type ElemType;
+
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LMetric::Evaluate(): the points of the blocks have different "
+        << "dimensionalities (" << a.n_rows << " and " << b.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (TPower == 2)
+  {
+    // ||x - y||^2 = ||x||^2 + ||y||^2 - 2 x^T y; the products are one matrix
+    // multiplication.
+    const arma::Col<ElemType> aNorms = arma::sum(arma::square(a), 0).t();
+    const arma::Row<ElemType> bNorms = arma::sum(arma::square(b), 0);
+    distances = a.t() * b;
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    {
+      for (size_t i = 0; i < a.n_cols; ++i)
+      {
+        // Rounding can make the distance of close points slightly negative.
+        const ElemType d = std::max(ElemType(0),
+            aNorms[i] + bNorms[j] - 2 * distances(i, j));
+        distances(i, j) = TTakeRoot ? std::sqrt(d) : d;
+      }
+    }
+
+    return;
+  }
+
+  distances.set_size(a.n_cols, b.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      distances(i, j) = Evaluate(a.col(i), b.col(j));
+}
+
 } // namespace metric
 } // namespace mlpack
 
@@ -37,10 +37,17 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L, and then multiply the data by L; Transform() does
+ * both.  The Euclidean distance between transformed points is the Mahalanobis
+ * distance between the original points, so the transformed dataset can be
+ * given to KNN with the default KDTree and EuclideanDistance.  If you still
+ * wish to use the KNN class with a custom distance anyway, you will need to use
+ * a different tree type than the default KDTree, which only works with the
+ * LMetric class.
+ *
+ * To compute the distances between many points at once, use the batch
+ * Evaluate() overload, which takes blocks of points and needs only a few
+ * matrix products instead of one matrix-vector product per pair.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -96,6 +103,47 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Compute the distances between all the points of two blocks of points
+   * (columns), in parallel.  The distances are computed from the products of
+   * the points with the covariance matrix, which is much faster than
+   * evaluating each pair, but can have a small absolute error for points that
+   * are very close to each other.  An empty covariance matrix is treated as
+   * the identity.
+   *
+   * @param a First block of points.
+   * @param b Second block of points.
+   * @param distances Matrix to store the distances in; distances(i, j) is the
+   *     distance between a.col(i) and b.col(j).
+   */
+  void Evaluate(const arma::mat& a,
+                const arma::mat& b,
+                arma::mat& distances) const;
+
+  /**
+   * Compute a matrix L such that the covariance matrix is Q = L^T L, so that
+   * the distance between x and y is the Euclidean distance between L x and
+   * L y.  A Cholesky decomposition is used if Q is positive definite;
+   * otherwise (for instance if Q is a learned metric of low rank), L is
+   * computed from the eigendecomposition of Q, and negative eigenvalues are
+   * treated as zero.
+   *
+   * @param transformation Matrix to store L in.
+   */
+  void Transformation(arma::mat& transformation) const;
+
+  /**
+   * Transform the given points (columns) by the matrix L given by
+   * Transformation(), so that the Euclidean distance between transformed
+   * points is the Mahalanobis distance between the given points.  This allows
+   * Euclidean trees and the fast Euclidean KNN search to be used with this
+   * distance.
+   *
+   * @param data Points to transform.
+   * @param transformed Matrix to store the transformed points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformed) const;
+
   /**
    * Access the covariance matrix.
    *
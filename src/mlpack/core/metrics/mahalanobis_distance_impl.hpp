@@ -14,6 +14,8 @@
 
 #include "mahalanobis_distance.hpp"
 
+#include <sstream>
+
 namespace mlpack {
 namespace metric {
 
@@ -47,6 +49,84 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Evaluate(const arma::mat& a,
+                                             const arma::mat& b,
+                                             arma::mat& distances) const
+{
+  if (a.n_rows != b.n_rows ||
+      (covariance.n_rows != 0 && covariance.n_rows != a.n_rows))
+  {
+    std::ostringstream oss;
+    oss << "MahalanobisDistance::Evaluate(): the points of the blocks have "
+        << "dimensionalities " << a.n_rows << " and " << b.n_rows << ", but "
+        << "the covariance matrix is " << covariance.n_rows << " x "
+        << covariance.n_cols << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // (x - y)^T Q (x - y) = x^T Q x + y^T Q y - 2 x^T Q y, where only the
+  // symmetric part of Q matters.
+  const arma::mat q = (covariance.n_rows == 0) ?
+      arma::mat(arma::eye<arma::mat>(a.n_rows, a.n_rows)) :
+      arma::mat(0.5 * (covariance + covariance.t()));
+  const arma::mat qa = q * a;
+  const arma::vec aNorms = arma::sum(a % qa, 0).t();
+  const arma::rowvec bNorms = arma::sum(b % (q * b), 0);
+  distances = qa.t() * b;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      // Rounding can make the distance of close points slightly negative.
+      const double d = std::max(0.0,
+          aNorms[i] + bNorms[j] - 2 * distances(i, j));
+      distances(i, j) = TakeRoot ? std::sqrt(d) : d;
+    }
+  }
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Transformation(
+    arma::mat& transformation) const
+{
+  const arma::mat q = 0.5 * (covariance + covariance.t());
+
+  // chol() gives an upper triangular R with Q = R^T R.
+  if (arma::chol(transformation, q))
+    return;
+
+  // Q = V diag(lambda) V^T, so L = diag(sqrt(lambda)) V^T.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, q))
+  {
+    throw std::runtime_error("MahalanobisDistance::Transformation(): the "
+        "eigendecomposition of the covariance matrix failed!");
+  }
+
+  transformation = eigenvectors.t();
+  transformation.each_col() %= arma::sqrt(arma::clamp(eigenvalues, 0.0,
+      arma::datum::inf));
+}
+
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Transform(const arma::mat& data,
+                                              arma::mat& transformed) const
+{
+  if (covariance.n_rows == 0)
+  {
+    transformed = data;
+    return;
+  }
+
+  arma::mat transformation;
+  Transformation(transformation);
+  transformed = transformation * data;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
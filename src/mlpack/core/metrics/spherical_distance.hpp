@@ -0,0 +1,93 @@
+/**
+ * @file core/metrics/spherical_distance.hpp
+ *
+ * The spherical distance: the Euclidean distance between two points after they
+ * are projected onto the unit sphere.  This is a metric that only depends on
+ * the cosine similarity of the points, and is used by spherical k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_SPHERICAL_DISTANCE_HPP
+#define MLPACK_CORE_METRICS_SPHERICAL_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The spherical distance between two points a and b is the Euclidean distance
+ * between a / ||a|| and b / ||b||, that is
+ *
+ * @f[
+ * d(a, b) = \sqrt{2 - 2 \frac{a^T b}{|| a || || b ||}}.
+ * @f]
+ *
+ * Unlike one minus the cosine similarity, this satisfies the triangle
+ * inequality, so it can be used with the pruning rules of ElkanKMeans and the
+ * trees.  Clustering with this metric (where each centroid is the normalized
+ * mean direction of its points) is spherical k-means; NaiveKMeans and
+ * ElkanKMeans detect this metric and compute the distances from dot products,
+ * which only touch the nonzero elements of sparse points.
+ *
+ * A point with norm zero has cosine similarity zero with every other point, so
+ * its distance to every other point is sqrt(2).
+ */
+class SphericalDistance
+{
+ public:
+  /**
+   * Default constructor does nothing, but is required to satisfy the Metric
+   * policy.
+   */
+  SphericalDistance() { }
+
+  /**
+   * Computes the spherical distance between two points.
+   *
+   * @tparam VecTypeA Type of first vector (generally arma::vec or
+   *      arma::sp_vec).
+   * @tparam VecTypeB Type of second vector.
+   * @param a First vector.
+   * @param b Second vector.
+   * @return Distance between vectors a and b.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(const VecTypeA& a,
+                                               const VecTypeB& b)
+  {
+    return FromSimilarity(arma::dot(a, b), arma::dot(a, a), arma::dot(b, b));
+  }
+
+  /**
+   * Compute the spherical distance from the dot product of two points and
+   * their squared norms.
+   *
+   * @param dot Dot product of the two points.
+   * @param squaredNormA Squared norm of the first point.
+   * @param squaredNormB Squared norm of the second point.
+   */
+  static double FromSimilarity(const double dot,
+                               const double squaredNormA,
+                               const double squaredNormB)
+  {
+    if (squaredNormA == 0.0 || squaredNormB == 0.0)
+      return std::sqrt(2.0);
+
+    // Rounding can make the cosine similarity slightly larger than 1.
+    const double cosine = dot / std::sqrt(squaredNormA * squaredNormB);
+    return std::sqrt(std::max(0.0, 2.0 - 2.0 * cosine));
+  }
+
+  //! Serialize the metric (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */) { }
+};
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file core/optimizers/hogwild_sgd.hpp
+ *
+ * A lock-free parallel stochastic gradient descent optimizer for functions
+ * with sparse gradients.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization /** Optimizers specific to mlpack models. */ {
+
+/**
+ * An implementation of the lock-free parallel stochastic gradient descent
+ * scheme described in the following paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, B. and Re, C. and Wright, S. and Niu, F.},
+ *   booktitle={Advances in Neural Information Processing Systems (NIPS 2011)},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * In each epoch the separable functions are visited in a (shuffled) order
+ * that is split between the OpenMP threads.  For each function, the gradient
+ * is computed as a sparse matrix, and only its nonzero coordinates are
+ * updated.  The updates are written without any locks or atomic operations:
+ * when the gradients are sparse, concurrent updates of the same coordinate are
+ * rare, and the analysis in the paper shows that the occasional lost update
+ * does not prevent convergence.  Because of this, the results are not
+ * reproducible when more than one thread is used.
+ *
+ * The function to optimize must provide
+ *
+ * @code
+ * size_t NumFunctions();
+ * double Evaluate(const MatType& coordinates, const size_t i,
+ *                 const size_t batchSize);
+ * void Gradient(const MatType& coordinates, const size_t i,
+ *               arma::SpMat<ElemType>& gradient, const size_t batchSize);
+ * @endcode
+ *
+ * where the gradient only has nonzero elements for the coordinates the i'th
+ * function depends on.  This is the same interface used by
+ * ens::ParallelSGD, and it is implemented by LogisticRegressionFunction,
+ * SoftmaxRegressionFunction, LinearSVMFunction and RegularizedSVDFunction.
+ * The optimizer can therefore be passed to the Train() method of the
+ * corresponding models.
+ */
+class HogwildSGD
+{
+ public:
+  /**
+   * Construct the optimizer with the given parameters.
+   *
+   * @param stepSize Step size of the first epoch.
+   * @param maxIterations Maximum number of epochs (passes over the data); 0
+   *     means no limit.
+   * @param tolerance The optimization stops when the objective changes by
+   *     less than this between two epochs.
+   * @param shuffle If true, the order of the functions is shuffled before
+   *     each epoch.
+   * @param stepDecay The step size is multiplied by this after each epoch.
+   */
+  HogwildSGD(const double stepSize = 0.01,
+             const size_t maxIterations = 100,
+             const double tolerance = 1e-5,
+             const bool shuffle = true,
+             const double stepDecay = 1.0) :
+      stepSize(stepSize),
+      maxIterations(maxIterations),
+      tolerance(tolerance),
+      shuffle(shuffle),
+      stepDecay(stepDecay)
+  { }
+
+  /**
+   * Optimize the given function, starting at the given coordinates, and
+   * return the final objective.
+   *
+   * @param function Function to optimize.
+   * @param iterate Starting point, which will be overwritten with the result.
+   * @return The objective at the result.
+   */
+  template<typename SeparableFunctionType, typename MatType>
+  typename MatType::elem_type Optimize(SeparableFunctionType& function,
+                                       MatType& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of epochs (0 means no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of epochs (0 means no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the functions are shuffled before each epoch.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether the functions are shuffled before each epoch.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the step size decay.
+  double StepDecay() const { return stepDecay; }
+  //! Modify the step size decay.
+  double& StepDecay() { return stepDecay; }
+
+ private:
+  //! Evaluate the objective over all the functions, in parallel.
+  template<typename SeparableFunctionType, typename MatType>
+  double Objective(SeparableFunctionType& function, const MatType& iterate);
+
+  //! The step size of the first epoch.
+  double stepSize;
+  //! The maximum number of epochs.
+  size_t maxIterations;
+  //! The tolerance on the change of the objective.
+  double tolerance;
+  //! Whether to shuffle the functions before each epoch.
+  bool shuffle;
+  //! The step size decay between epochs.
+  double stepDecay;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "hogwild_sgd_impl.hpp"
+
+#endif
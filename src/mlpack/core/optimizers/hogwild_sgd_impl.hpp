@@ -0,0 +1,105 @@
+/**
+ * @file core/optimizers/hogwild_sgd_impl.hpp
+ *
+ * Implementation of the HogwildSGD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_HOGWILD_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hogwild_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename SeparableFunctionType, typename MatType>
+typename MatType::elem_type HogwildSGD::Optimize(
+    SeparableFunctionType& function,
+    MatType& iterate)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t numFunctions = function.NumFunctions();
+  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
+      numFunctions - 1, numFunctions);
+
+  double currentStepSize = stepSize;
+  double overallObjective = Objective(function, iterate);
+  for (size_t i = 1; maxIterations == 0 || i <= maxIterations; ++i)
+  {
+    if (shuffle)
+    {
+      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
+          math::randGen);
+    }
+
+    #pragma omp parallel
+    {
+      arma::SpMat<ElemType> gradient;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t j = 0; j < (omp_size_t) numFunctions; ++j)
+      {
+        function.Gradient(iterate, visitationOrder[j], gradient, 1);
+
+        // Only the nonzero coordinates of the gradient are written, without
+        // locks or atomic operations.
+        typename arma::SpMat<ElemType>::const_iterator it = gradient.begin();
+        for (; it != gradient.end(); ++it)
+          iterate(it.row(), it.col()) -= currentStepSize * (*it);
+      }
+    }
+
+    currentStepSize *= stepDecay;
+
+    const double lastObjective = overallObjective;
+    overallObjective = Objective(function, iterate);
+    Log::Info << "HogwildSGD: epoch " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "HogwildSGD: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "HogwildSGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Log::Info << "HogwildSGD: maximum epochs (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+template<typename SeparableFunctionType, typename MatType>
+double HogwildSGD::Objective(SeparableFunctionType& function,
+                             const MatType& iterate)
+{
+  double objective = 0.0;
+
+  #pragma omp parallel for reduction(+:objective)
+  for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    objective += function.Evaluate(iterate, j, 1);
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file core/optimizers/stratified_sgd.hpp
+ *
+ * A parallel stochastic gradient descent optimizer for matrix factorization
+ * that splits the ratings into independent blocks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_STRATIFIED_SGD_HPP
+#define MLPACK_CORE_OPTIMIZERS_STRATIFIED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An implementation of the stratified parallel stochastic gradient descent
+ * scheme for matrix factorization (DSGD) described in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining (KDD '11)},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * With B threads, the users and the items are each split into B blocks, and
+ * the ratings are sorted by block, so that the ratings of each of the B x B
+ * blocks are contiguous (a CSR layout over the blocks).  An epoch is made of B
+ * sub-epochs; in sub-epoch s, thread b visits the ratings of user block b and
+ * item block (b + s) mod B.  The blocks visited at the same time share no user
+ * and no item, so the threads update disjoint columns of the parameters and
+ * no locks or atomic operations are needed.  The result does not depend on the
+ * scheduling of the threads, but it does depend on the number of threads,
+ * since that sets the blocks.
+ *
+ * Some parameters are shared between all the ratings of a user, whatever the
+ * item block (such as the implicit item vectors of SVD++).  Their updates are
+ * written by each thread to its own delayed update matrix, and added to the
+ * parameters at the end of each sub-epoch.
+ *
+ * The function to optimize must provide
+ *
+ * @code
+ * size_t NumFunctions();
+ * size_t NumUsers();
+ * size_t NumItems();
+ * const arma::mat& Dataset(); // (user, item, rating) triples, one per column.
+ * double Evaluate(const arma::mat& coordinates, const size_t i,
+ *                 const size_t batchSize);
+ * void StratifiedUpdate(arma::mat& coordinates, const size_t i,
+ *                       const double stepSize, arma::mat& delayedUpdate);
+ * void ApplyDelayedUpdate(arma::mat& coordinates, arma::mat& delayedUpdate);
+ * @endcode
+ *
+ * where StratifiedUpdate() takes one SGD step on the i'th rating, writing only
+ * the columns of its user and its item, plus delayedUpdate, and
+ * ApplyDelayedUpdate() adds the delayed update to the coordinates and resets
+ * it.  This is implemented by RegularizedSVDFunction, BiasSVDFunction and
+ * SVDPlusPlusFunction, so the optimizer can be passed to the Apply() methods
+ * of RegularizedSVD, BiasSVD and SVDPlusPlus.
+ */
+class StratifiedSGD
+{
+ public:
+  /**
+   * Construct the optimizer with the given parameters.
+   *
+   * @param stepSize Step size of the first epoch.
+   * @param maxIterations Maximum number of epochs (passes over the data); 0
+   *     means no limit.
+   * @param tolerance The optimization stops when the objective changes by
+   *     less than this between two epochs.
+   * @param shuffle If true, the ratings of each block are shuffled before
+   *     each epoch.
+   * @param stepDecay The step size is multiplied by this after each epoch.
+   */
+  StratifiedSGD(const double stepSize = 0.01,
+                const size_t maxIterations = 100,
+                const double tolerance = 1e-5,
+                const bool shuffle = true,
+                const double stepDecay = 1.0) :
+      stepSize(stepSize),
+      maxIterations(maxIterations),
+      tolerance(tolerance),
+      shuffle(shuffle),
+      stepDecay(stepDecay)
+  { }
+
+  /**
+   * Optimize the given function, starting at the given coordinates, and
+   * return the final objective.
+   *
+   * @param function Function to optimize.
+   * @param iterate Starting point, which will be overwritten with the result.
+   * @return The objective at the result.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of epochs (0 means no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of epochs (0 means no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether the ratings are shuffled before each epoch.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether the ratings are shuffled before each epoch.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the step size decay.
+  double StepDecay() const { return stepDecay; }
+  //! Modify the step size decay.
+  double& StepDecay() { return stepDecay; }
+
+ private:
+  //! Evaluate the objective over all the ratings, in parallel.
+  template<typename DecomposableFunctionType>
+  double Objective(DecomposableFunctionType& function,
+                   const arma::mat& iterate);
+
+  //! The step size of the first epoch.
+  double stepSize;
+  //! The maximum number of epochs.
+  size_t maxIterations;
+  //! The tolerance on the change of the objective.
+  double tolerance;
+  //! Whether to shuffle the ratings of each block before each epoch.
+  bool shuffle;
+  //! The step size decay between epochs.
+  double stepDecay;
+};
+
+} // namespace optimization
+} // namespace mlpack
+
+// Include implementation.
+#include "stratified_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file core/optimizers/stratified_sgd_impl.hpp
+ *
+ * Implementation of the StratifiedSGD optimizer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_OPTIMIZERS_STRATIFIED_SGD_IMPL_HPP
+#define MLPACK_CORE_OPTIMIZERS_STRATIFIED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stratified_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+double StratifiedSGD::Optimize(DecomposableFunctionType& function,
+                               arma::mat& iterate)
+{
+#ifdef HAS_OPENMP
+  const size_t numBlocks = (size_t) omp_get_max_threads();
+#else
+  const size_t numBlocks = 1;
+#endif
+  const size_t numStrata = numBlocks * numBlocks;
+
+  const arma::mat& data = function.Dataset();
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numUsers = function.NumUsers();
+  const size_t numItems = function.NumItems();
+
+  // The users and the items are split into contiguous ranges, and the ratings
+  // are sorted by block with a counting sort: the ratings of block s are
+  // order[offsets[s]] to order[offsets[s + 1] - 1].
+  arma::Col<size_t> strata(numFunctions);
+  arma::Col<size_t> offsets(numStrata + 1, arma::fill::zeros);
+  for (size_t i = 0; i < numFunctions; ++i)
+  {
+    const size_t userBlock = (size_t) data(0, i) * numBlocks / numUsers;
+    const size_t itemBlock = (size_t) data(1, i) * numBlocks / numItems;
+    strata[i] = userBlock * numBlocks + itemBlock;
+    ++offsets[strata[i] + 1];
+  }
+
+  for (size_t s = 0; s < numStrata; ++s)
+    offsets[s + 1] += offsets[s];
+
+  arma::Col<size_t> order(numFunctions);
+  arma::Col<size_t> next = offsets.subvec(0, numStrata - 1);
+  for (size_t i = 0; i < numFunctions; ++i)
+    order[next[strata[i]]++] = i;
+
+  // One delayed update per user block; the function allocates it when it
+  // needs it.
+  std::vector<arma::mat> delayedUpdates(numBlocks);
+
+  double currentStepSize = stepSize;
+  double overallObjective = Objective(function, iterate);
+  for (size_t i = 1; maxIterations == 0 || i <= maxIterations; ++i)
+  {
+    if (shuffle)
+    {
+      // Each stratum is shuffled with its own stream, so the order doesn't
+      // depend on the scheduling of the threads.
+      const uint64_t streamSeed = math::randGen();
+
+      #pragma omp parallel for
+      for (omp_size_t s = 0; s < (omp_size_t) numStrata; ++s)
+      {
+        math::SeedThreadRandGen(streamSeed, s);
+        std::shuffle(order.begin() + offsets[s], order.begin() + offsets[s + 1],
+            math::ThreadRandGen());
+      }
+    }
+
+    for (size_t s = 0; s < numBlocks; ++s)
+    {
+      // The blocks visited in this sub-epoch have no users and no items in
+      // common, so they are updated in parallel without any synchronization.
+      #pragma omp parallel for schedule(static, 1)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t stratum = b * numBlocks + (b + s) % numBlocks;
+        for (size_t j = offsets[stratum]; j < offsets[stratum + 1]; ++j)
+        {
+          function.StratifiedUpdate(iterate, order[j], currentStepSize,
+              delayedUpdates[b]);
+        }
+      }
+
+      // The delayed updates are applied in a fixed order, so that the result
+      // does not depend on the scheduling of the threads.
+      for (size_t b = 0; b < numBlocks; ++b)
+        function.ApplyDelayedUpdate(iterate, delayedUpdates[b]);
+    }
+
+    currentStepSize *= stepDecay;
+
+    const double lastObjective = overallObjective;
+    overallObjective = Objective(function, iterate);
+    Log::Info << "StratifiedSGD: epoch " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "StratifiedSGD: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Log::Info << "StratifiedSGD: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Log::Info << "StratifiedSGD: maximum epochs (" << maxIterations
+      << ") reached; terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+template<typename DecomposableFunctionType>
+double StratifiedSGD::Objective(DecomposableFunctionType& function,
+                                const arma::mat& iterate)
+{
+  double objective = 0.0;
+
+  #pragma omp parallel for reduction(+:objective)
+  for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    objective += function.Evaluate(iterate, j, 1);
+
+  return objective;
+}
+
+} // namespace optimization
+} // namespace mlpack
+
+#endif
@@ -15,10 +15,15 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+// Forward declaration of the MappedTree class, which needs to create nodes.
+template<typename TreeType>
+class MappedTree;
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -88,6 +93,12 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! If we are the root of the tree, this holds all of the other nodes of the
+  //! tree, contiguously and in breadth-first order (or NULL if the nodes were
+  //! allocated separately).
+  BinarySpaceTree* nodePool;
+  //! The number of nodes in nodePool.
+  size_t nodePoolSize;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -546,6 +557,110 @@ class BinarySpaceTree
    */
   void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
 
+  /**
+   * Move all descendants of this node (which must be the root) into one
+   * contiguous block of memory in breadth-first order, so that traversals hit
+   * fewer cache misses.  The root itself stays where it is.  Nothing is done if
+   * the nodes are already stored that way.
+   */
+  void PackNodes();
+
+  /**
+   * Delete the children of this node, whether they are stored in a block owned
+   * by this node, allocated separately, or part of a block owned by the root
+   * (in which case they are only detached, and deleted with the root).
+   */
+  void DeleteChildren();
+
+  //! Return whether this node is stored in the block owned by the root.
+  bool InNodePool() const;
+
+  /**
+   * Construct this node as a child of the given parent, starting at column
+   * begin and using count points, but do not compute its bound or split it.
+   * This is used to build the top levels of the tree when building it in
+   * parallel.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point held by this node.
+   * @param count Number of points held by this node.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const size_t begin,
+                  const size_t count);
+
+  /**
+   * Return whether the tree rooted at this node should be built with multiple
+   * threads.  This is only possible when OpenMP is available, the splitter
+   * can split different nodes concurrently, and the node is large enough.
+   */
+  bool BuildInParallel() const;
+
+  /**
+   * Build the tree rooted at this node with multiple threads.  The top levels
+   * of the tree are built one node at a time (with the bounds of large nodes
+   * computed in parallel) until there are enough subtrees to keep all threads
+   * busy; then, the subtrees are built concurrently.  The resulting tree is
+   * exactly the same as the one built by SplitNode().
+   *
+   * @param oldFromNew Vector holding permuted indices; this may be NULL if the
+   *     mapping is not needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                         const size_t maxLeafSize,
+                         SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Compute the bound of this node and, if the node should be split, partition
+   * its points and create its two children, without splitting the children.
+   *
+   * @param oldFromNew Vector holding permuted indices; this may be NULL if the
+   *     mapping is not needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @return Whether or not the node was split.
+   */
+  bool ExpandNode(std::vector<size_t>* oldFromNew,
+                  const size_t maxLeafSize,
+                  SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Set the parent distances of the children of this node.  Both children must
+   * exist and have their bounds computed.
+   */
+  void SetChildParentDistances();
+
+  /**
+   * Update the bound of the current node, possibly with multiple threads.
+   * Only bounds that can be combined exactly are computed in parallel; others
+   * fall back to UpdateBound().
+   *
+   * @param boundToUpdate The bound to update.
+   */
+  template<typename BoundType2>
+  void ParallelUpdateBound(BoundType2& boundToUpdate);
+
+  /**
+   * Update the bound of the current node with multiple threads, by computing
+   * the bound of chunks of the points and combining them.
+   *
+   * @param boundToUpdate The bound to update.
+   */
+  void ParallelUpdateBound(bound::HRectBound<MetricType>& boundToUpdate);
+
+  //! The minimum number of points a node must hold for it to be built with
+  //! multiple threads.
+  static const size_t parallelBuildMinPoints = 16384;
+
+  /**
+   * Serialize this node and, through pointers, its children, like archives of
+   * version 0 store the tree.
+   */
+  template<typename Archive>
+  void SerializeRecursive(Archive& ar);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -558,9 +673,16 @@ class BinarySpaceTree
   //! Friend access is given for the default constructor.
   friend class cereal::access;
 
+  //! Friend access is given so that trees can be created from mapped files.
+  template<typename TreeType>
+  friend class MappedTree;
+
  public:
   /**
-   * Serialize the tree.
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -569,6 +691,14 @@ class BinarySpaceTree
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename MetricType,
+    typename StatisticType, typename MatType,
+    template<typename BoundMetricType, typename...> class BoundType,
+    template<typename SplitBoundType, typename SplitMatType>
+        class SplitType>), (mlpack::tree::BinarySpaceTree<MetricType,
+    StatisticType, MatType, BoundType, SplitType>), 1);
+
 // Include implementation.
 #include "binary_space_tree_impl.hpp"
 
@@ -15,6 +15,8 @@
 #include "binary_space_tree.hpp"
 
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/data/numa_placement.hpp>
+#include <deque>
 #include <queue>
 
 namespace mlpack {
@@ -39,7 +41,9 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -67,7 +71,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -101,7 +107,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -136,7 +144,9 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -164,7 +174,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -198,7 +210,9 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -237,7 +251,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -266,7 +282,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -300,7 +318,9 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +362,9 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -376,6 +398,9 @@ BinarySpaceTree(
       if (node->right)
         queue.push(node->right);
     }
+
+    // Store the copied nodes contiguously.
+    PackNodes();
   }
 }
 
@@ -398,11 +423,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
-  left = NULL;
-  right = NULL;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -446,6 +468,9 @@ operator=(const BinarySpaceTree& other)
       if (node->right)
         queue.push(node->right);
     }
+
+    // Store the copied nodes contiguously.
+    PackNodes();
   }
 
   return *this;
@@ -470,8 +495,7 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
@@ -484,6 +508,14 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  nodePool = other.nodePool;
+  nodePoolSize = other.nodePoolSize;
+
+  // Set new parent.
+  if (left)
+    left->parent = this;
+  if (right)
+    right->parent = this;
 
   other.left = NULL;
   other.right = NULL;
@@ -494,6 +526,8 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodePool = NULL;
+  other.nodePoolSize = 0;
 
   return *this;
 }
@@ -520,7 +554,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodePool(other.nodePool),
+    nodePoolSize(other.nodePoolSize)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -533,6 +569,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodePool = NULL;
+  other.nodePoolSize = 0;
 
   // Set new parent.
   if (left)
@@ -576,8 +614,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -868,6 +905,15 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  MLPACK_PROFILE_SCOPE(TREE_BUILD);
+
+  // Large trees are built with multiple threads, starting from the root.
+  if (!parent && BuildInParallel())
+  {
+    ParallelSplitNode(NULL, maxLeafSize, splitter);
+    return;
+  }
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -910,18 +956,15 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
       splitter, maxLeafSize);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
-  Center(center);
-  left->Center(leftCenter);
-  right->Center(rightCenter);
+  SetChildParentDistances();
 
-  const ElemType leftParentDistance = bound.Metric().Evaluate(center,
-      leftCenter);
-  const ElemType rightParentDistance = bound.Metric().Evaluate(center,
-      rightCenter);
-
-  left->ParentDistance() = leftParentDistance;
-  right->ParentDistance() = rightParentDistance;
+  // Once the whole tree is built, store its nodes contiguously, and spread
+  // the reordered points over the NUMA nodes if requested.
+  if (!parent)
+  {
+    PackNodes();
+    data::PlaceColumns(*dataset);
+  }
 }
 
 template<typename MetricType,
@@ -935,6 +978,15 @@ SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
           SplitType<BoundType<MetricType>, MatType>& splitter)
 {
+  MLPACK_PROFILE_SCOPE(TREE_BUILD);
+
+  // Large trees are built with multiple threads, starting from the root.
+  if (!parent && BuildInParallel())
+  {
+    ParallelSplitNode(&oldFromNew, maxLeafSize, splitter);
+    return;
+  }
+
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
 
@@ -978,18 +1030,15 @@ SplitNode(std::vector<size_t>& oldFromNew,
       oldFromNew, splitter, maxLeafSize);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
-  Center(center);
-  left->Center(leftCenter);
-  right->Center(rightCenter);
+  SetChildParentDistances();
 
-  const ElemType leftParentDistance = bound.Metric().Evaluate(center,
-      leftCenter);
-  const ElemType rightParentDistance = bound.Metric().Evaluate(center,
-      rightCenter);
-
-  left->ParentDistance() = leftParentDistance;
-  right->ParentDistance() = rightParentDistance;
+  // Once the whole tree is built, store its nodes contiguously, and spread
+  // the reordered points over the NUMA nodes if requested.
+  if (!parent)
+  {
+    PackNodes();
+    data::PlaceColumns(*dataset);
+  }
 }
 
 template<typename MetricType,
@@ -1032,6 +1081,353 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const size_t begin,
+    const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(begin),
+    count(count),
+    bound(parent->Dataset().n_rows),
+    dataset(&parent->Dataset()),
+    nodePool(NULL),
+    nodePoolSize(0)
+{
+  // Nothing to do; the caller computes the bound and splits this node.
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildInParallel() const
+{
+#ifdef HAS_OPENMP
+  // The bound of a node with a HollowBallBound depends on the bound of its
+  // sibling, so those nodes can't be built concurrently.
+  const bool canBuildInParallel =
+      SplitTraits<SplitType<BoundType<MetricType>, MatType>>::IsThreadSafe &&
+      !std::is_same<BoundType<MetricType>,
+          bound::HollowBallBound<MetricType>>::value;
+
+  return canBuildInParallel && count >= parallelBuildMinPoints &&
+      omp_get_max_threads() > 1 && !omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelSplitNode(std::vector<size_t>* oldFromNew,
+                  const size_t maxLeafSize,
+                  SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+#ifdef HAS_OPENMP
+  const size_t minSubtrees = 4 * omp_get_max_threads();
+#else
+  const size_t minSubtrees = 1;
+#endif
+
+  // Build the top levels of the tree in breadth-first order, one node at a
+  // time, until there are enough subtrees left to build.
+  std::vector<BinarySpaceTree*> expanded;
+  std::deque<BinarySpaceTree*> subtrees;
+  subtrees.push_back(this);
+  while (!subtrees.empty() && subtrees.size() < minSubtrees)
+  {
+    BinarySpaceTree* node = subtrees.front();
+    subtrees.pop_front();
+    expanded.push_back(node);
+
+    if (node->ExpandNode(oldFromNew, maxLeafSize, splitter))
+    {
+      subtrees.push_back(node->left);
+      subtrees.push_back(node->right);
+    }
+  }
+
+  // The remaining subtrees hold disjoint sets of points, so they can be built
+  // concurrently.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    BinarySpaceTree* node = subtrees[i];
+    if (oldFromNew)
+      node->SplitNode(*oldFromNew, maxLeafSize, splitter);
+    else
+      node->SplitNode(maxLeafSize, splitter);
+
+    node->stat = StatisticType(*node);
+  }
+
+  // Now finish the top levels of the tree from the bottom up, in the same
+  // order that the recursive build does.  The statistic of the root is created
+  // by the constructor.
+  for (size_t i = expanded.size(); i > 0; --i)
+  {
+    BinarySpaceTree* node = expanded[i - 1];
+    if (node->left)
+      node->SetChildParentDistances();
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+
+  // Store the nodes of the tree contiguously, and spread the reordered points
+  // over the NUMA nodes if requested.
+  PackNodes();
+  data::PlaceColumns(*dataset);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ExpandNode(std::vector<size_t>* oldFromNew,
+           const size_t maxLeafSize,
+           SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  // We need to expand the bounds of this node properly.
+  ParallelUpdateBound(bound);
+
+  // Calculate the furthest descendant distance.
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // First, check if we need to split at all.
+  if (count <= maxLeafSize)
+    return false;
+
+  // Find the partition of the node, if the node can be split.
+  typename Split::SplitInfo splitInfo;
+  if (!splitter.SplitNode(bound, *dataset, begin, count, splitInfo))
+    return false;
+
+  // Perform the actual splitting.
+  const size_t splitCol = (oldFromNew == NULL) ?
+      splitter.PerformSplit(*dataset, begin, count, splitInfo) :
+      splitter.PerformSplit(*dataset, begin, count, splitInfo, *oldFromNew);
+
+  assert(splitCol > begin);
+  assert(splitCol < begin + count);
+
+  // Create the children, but leave the splitting of the children to the
+  // caller.
+  left = new BinarySpaceTree(this, begin, splitCol - begin);
+  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol);
+
+  return true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+SetChildParentDistances()
+{
+  arma::vec center, leftCenter, rightCenter;
+  Center(center);
+  left->Center(leftCenter);
+  right->Center(rightCenter);
+
+  const ElemType leftParentDistance = bound.Metric().Evaluate(center,
+      leftCenter);
+  const ElemType rightParentDistance = bound.Metric().Evaluate(center,
+      rightCenter);
+
+  left->ParentDistance() = leftParentDistance;
+  right->ParentDistance() = rightParentDistance;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename BoundType2>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelUpdateBound(BoundType2& boundToUpdate)
+{
+  UpdateBound(boundToUpdate);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelUpdateBound(bound::HRectBound<MetricType>& boundToUpdate)
+{
+#ifdef HAS_OPENMP
+  if (count >= parallelBuildMinPoints)
+  {
+    // Compute the bound of each chunk of points separately; the union of those
+    // bounds is exactly the bound of all the points.
+    const size_t numChunks = omp_get_max_threads();
+    std::vector<bound::HRectBound<MetricType>> chunkBounds(numChunks,
+        bound::HRectBound<MetricType>(dataset->n_rows));
+
+    #pragma omp parallel for
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      const size_t chunkBegin = begin + ((size_t) c * count) / numChunks;
+      const size_t chunkEnd = begin + ((size_t) (c + 1) * count) / numChunks;
+      if (chunkEnd > chunkBegin)
+        chunkBounds[c] |= dataset->cols(chunkBegin, chunkEnd - 1);
+    }
+
+    for (size_t c = 0; c < numChunks; ++c)
+      boundToUpdate |= chunkBounds[c];
+
+    return;
+  }
+#endif
+
+  UpdateBound(boundToUpdate);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+PackNodes()
+{
+  if (nodePool)
+    return; // The nodes are already stored contiguously.
+
+  // Collect all descendants in breadth-first order.
+  std::vector<BinarySpaceTree*> oldNodes;
+  if (left)
+    oldNodes.push_back(left);
+  if (right)
+    oldNodes.push_back(right);
+  for (size_t i = 0; i < oldNodes.size(); ++i)
+  {
+    if (oldNodes[i]->left)
+      oldNodes.push_back(oldNodes[i]->left);
+    if (oldNodes[i]->right)
+      oldNodes.push_back(oldNodes[i]->right);
+  }
+
+  if (oldNodes.empty())
+    return;
+
+  // Move every node into the block.  The moved nodes still point to the old
+  // locations of their children; that is fixed below.
+  BinarySpaceTree* pool = static_cast<BinarySpaceTree*>(::operator new(
+      oldNodes.size() * sizeof(BinarySpaceTree)));
+  for (size_t i = 0; i < oldNodes.size(); ++i)
+    new (pool + i) BinarySpaceTree(std::move(*oldNodes[i]));
+
+  // Because the nodes are in breadth-first order, the children of each node
+  // are the next unclaimed nodes in the block.
+  size_t nextChild = 0;
+  for (size_t i = 0; i <= oldNodes.size(); ++i)
+  {
+    BinarySpaceTree* node = (i == 0) ? this : pool + (i - 1);
+    if (node->left)
+    {
+      node->left = pool + nextChild++;
+      node->left->parent = node;
+    }
+    if (node->right)
+    {
+      node->right = pool + nextChild++;
+      node->right->parent = node;
+    }
+  }
+
+  // The old nodes were emptied by the move, so this frees nothing else.
+  for (size_t i = 0; i < oldNodes.size(); ++i)
+    delete oldNodes[i];
+
+  nodePool = pool;
+  nodePoolSize = oldNodes.size();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DeleteChildren()
+{
+  if (nodePool)
+  {
+    // Every descendant is in the block; detach them all from each other so
+    // that no destructor tries to delete its children.
+    for (size_t i = 0; i < nodePoolSize; ++i)
+    {
+      nodePool[i].left = NULL;
+      nodePool[i].right = NULL;
+    }
+
+    for (size_t i = 0; i < nodePoolSize; ++i)
+      nodePool[i].~BinarySpaceTree();
+    ::operator delete(nodePool);
+
+    nodePool = NULL;
+    nodePoolSize = 0;
+  }
+  else if ((left || right) && !InNodePool())
+  {
+    delete left;
+    delete right;
+  }
+  // Otherwise, the children are in the block owned by the root, and will be
+  // deleted with it.
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+bool BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+InNodePool() const
+{
+  const BinarySpaceTree* root = this;
+  while (root->parent)
+    root = root->parent;
+
+  return (root->nodePool != NULL) && (this >= root->nodePool) &&
+      (this < root->nodePool + root->nodePoolSize);
+}
+
 // Default constructor (private), for cereal.
 template<typename MetricType,
          typename StatisticType,
@@ -1049,7 +1445,9 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodePool(NULL),
+    nodePoolSize(0)
 {
   // Nothing to do.
 }
@@ -1065,15 +1463,12 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-    serialize(Archive& ar, const uint32_t /* version */)
+    serialize(Archive& ar, const uint32_t version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
@@ -1082,6 +1477,134 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     right = NULL;
   }
 
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    SerializeRecursive(ar);
+    return;
+  }
+
+  // The nodes of the subtree are stored as arrays that hold one element for
+  // each node, in breadth-first order, so that neither saving nor loading
+  // recurses; the children of each node are the next unclaimed nodes.
+  std::vector<BinarySpaceTree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (nodes[i]->left)
+        nodes.push_back(nodes[i]->left);
+      if (nodes[i]->right)
+        nodes.push_back(nodes[i]->right);
+    }
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  // The members of arithmetic types are written in one block each.
+  std::vector<size_t> begins(numNodes), counts(numNodes),
+      numChildren(numNodes);
+  std::vector<ElemType> parentDistances(numNodes),
+      furthestDescendantDistances(numNodes),
+      minimumBoundDistances(numNodes);
+  if (cereal::is_saving<Archive>())
+  {
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      begins[i] = nodes[i]->begin;
+      counts[i] = nodes[i]->count;
+      numChildren[i] = nodes[i]->NumChildren();
+      parentDistances[i] = nodes[i]->parentDistance;
+      furthestDescendantDistances[i] = nodes[i]->furthestDescendantDistance;
+      minimumBoundDistances[i] = nodes[i]->minimumBoundDistance;
+    }
+  }
+  ar(CEREAL_NVP(begins));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(parentDistances));
+  ar(CEREAL_NVP(furthestDescendantDistances));
+  ar(CEREAL_NVP(minimumBoundDistances));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+      throw std::runtime_error("BinarySpaceTree::serialize(): the archive "
+          "holds no nodes!");
+
+    // The descendants are stored in a block owned by this node, like
+    // PackNodes() stores them.
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    if (numNodes > 1)
+    {
+      nodePool = static_cast<BinarySpaceTree*>(::operator new(
+          (numNodes - 1) * sizeof(BinarySpaceTree)));
+      nodePoolSize = numNodes - 1;
+      for (size_t i = 1; i < numNodes; ++i)
+        nodes[i] = new (nodePool + (i - 1)) BinarySpaceTree();
+    }
+
+    size_t nextChild = 1;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      BinarySpaceTree* node = nodes[i];
+      if (numChildren[i] > 2 || nextChild + numChildren[i] > numNodes)
+        throw std::runtime_error("BinarySpaceTree::serialize(): the archive "
+            "holds an invalid tree!");
+
+      if (numChildren[i] >= 1)
+      {
+        node->left = nodes[nextChild++];
+        node->left->parent = node;
+      }
+      if (numChildren[i] == 2)
+      {
+        node->right = nodes[nextChild++];
+        node->right->parent = node;
+      }
+
+      node->begin = begins[i];
+      node->count = counts[i];
+      node->parentDistance = parentDistances[i];
+      node->furthestDescendantDistance = furthestDescendantDistances[i];
+      node->minimumBoundDistance = minimumBoundDistances[i];
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    ar(cereal::make_nvp("bound", nodes[i]->bound));
+    ar(cereal::make_nvp("stat", nodes[i]->stat));
+  }
+
+  bool hasParent = (parent != NULL);
+  ar(CEREAL_NVP(hasParent));
+  if (!hasParent)
+  {
+    MatType*& datasetTemp = const_cast<MatType*&>(dataset);
+    ar(CEREAL_POINTER(datasetTemp));
+
+    if (cereal::is_loading<Archive>())
+    {
+      for (size_t i = 1; i < numNodes; ++i)
+        nodes[i]->dataset = dataset;
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename Archive>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    SerializeRecursive(Archive& ar)
+{
   ar(CEREAL_NVP(begin));
   ar(CEREAL_NVP(count));
   ar(CEREAL_NVP(bound));
@@ -1133,6 +1656,10 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
       if (node->right)
        stack.push(node->right);
     }
+
+    // Store the loaded nodes contiguously.
+    if (cereal::is_loading<Archive>())
+      PackNodes();
   }
 }
 
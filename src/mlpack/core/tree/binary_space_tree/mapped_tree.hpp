@@ -0,0 +1,183 @@
+/**
+ * @file core/tree/binary_space_tree/mapped_tree.hpp
+ *
+ * Definition of the MappedTree class, which stores a kd-tree in a flat,
+ * pointer-free file that can be memory-mapped and queried in place.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_MAPPED_TREE_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_MAPPED_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The MappedTree class gives access to a BinarySpaceTree stored in a flat
+ * file written by MappedTree::Save().  The file holds the dataset (in the
+ * order of the tree), one fixed-size record per node (in breadth-first order,
+ * with children referred to by index), the bounds of every node, and the
+ * oldFromNew mapping.  Loading the file memory-maps it: the dataset of the
+ * resulting tree is an Armadillo matrix that aliases the mapped memory, so it
+ * is never read or copied until it is used, and the pages can be shared with
+ * other processes that map the same file.  Only the (small) node objects are
+ * allocated.
+ *
+ * The mapping is private: a process that modifies the dataset of the tree only
+ * modifies its own copy of the pages, never the file.
+ *
+ * The tree can be used directly, or it can be moved into a NeighborSearch (or
+ * any other class that takes a tree) with std::move(); in that case, the
+ * MappedTree object must outlive the object that the tree was moved into,
+ * since the dataset memory is released when the MappedTree is destroyed.
+ * Results are given in terms of the order of points in the tree; use
+ * OldFromNew() to map them back to the original dataset.
+ *
+ * @code
+ * // Build and save the tree.
+ * std::vector<size_t> oldFromNew;
+ * KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>, arma::mat>
+ *     tree(dataset, oldFromNew);
+ * MappedTree<decltype(tree)>::Save("tree.bin", tree, oldFromNew);
+ *
+ * // Later, in any number of processes.
+ * MappedTree<decltype(tree)> mapped("tree.bin");
+ * KNN knn(std::move(mapped.Tree()));
+ * @endcode
+ *
+ * Only trees with HRectBound bounds (such as kd-trees and mean-split kd-trees)
+ * are supported.  Files are written in the byte order of the machine, and can
+ * only be read on a machine with the same byte order.
+ *
+ * @tparam TreeType Type of BinarySpaceTree to map.
+ */
+template<typename TreeType>
+class MappedTree
+{
+ public:
+  //! The type of element held in the dataset.
+  typedef typename TreeType::ElemType ElemType;
+  //! The type of the dataset.
+  typedef typename TreeType::Mat MatType;
+
+  /**
+   * Map the tree stored in the given file.  A std::runtime_error is thrown if
+   * the file can't be opened or mapped, or if it doesn't hold a valid tree of
+   * this type.
+   *
+   * @param filename File written by Save().
+   */
+  MappedTree(const std::string& filename);
+
+  //! Copying is not allowed, since the object owns the mapping.
+  MappedTree(const MappedTree& other) = delete;
+  //! Copying is not allowed, since the object owns the mapping.
+  MappedTree& operator=(const MappedTree& other) = delete;
+
+  /**
+   * Delete the tree (if it wasn't moved elsewhere) and release the mapping.
+   */
+  ~MappedTree();
+
+  /**
+   * Save the given tree to the given file in the flat layout that can be
+   * mapped by the MappedTree constructor.  A std::runtime_error is thrown if
+   * the file can't be written.
+   *
+   * @param filename File to save to.
+   * @param tree Tree to save; this must be the root of the tree.
+   * @param oldFromNew Mapping from the order of points in the tree to the
+   *     order of points in the original dataset; this may be empty.
+   */
+  static void Save(const std::string& filename,
+                   const TreeType& tree,
+                   const std::vector<size_t>& oldFromNew);
+
+  //! Get the mapped tree.
+  const TreeType& Tree() const { return *tree; }
+  //! Modify the mapped tree (or move it elsewhere).
+  TreeType& Tree() { return *tree; }
+
+  //! Get the mapping from tree order to original order (may be empty).
+  const std::vector<size_t>& OldFromNew() const { return oldFromNew; }
+
+ private:
+  //! The header at the start of the file.
+  struct FileHeader
+  {
+    //! Identifies the file type.
+    char magic[8];
+    //! Version of the layout.
+    uint64_t version;
+    //! Size of each element of the dataset, in bytes.
+    uint64_t elemSize;
+    //! Dimensionality of the dataset.
+    uint64_t dimensionality;
+    //! Number of points in the dataset.
+    uint64_t numPoints;
+    //! Number of nodes in the tree.
+    uint64_t numNodes;
+    //! Number of elements in the oldFromNew mapping (0 or numPoints).
+    uint64_t numMappings;
+    //! Offset of the dataset in the file.
+    uint64_t dataOffset;
+    //! Offset of the node records in the file.
+    uint64_t nodeOffset;
+    //! Offset of the bounds in the file.
+    uint64_t boundOffset;
+    //! Offset of the oldFromNew mapping in the file.
+    uint64_t mappingOffset;
+    //! Total size of the file.
+    uint64_t fileSize;
+  };
+
+  //! The record of each node; children are referred to by index, and an index
+  //! of 0 (the root) means that there is no child.
+  struct NodeRecord
+  {
+    uint64_t begin;
+    uint64_t count;
+    uint64_t left;
+    uint64_t right;
+    double parentDistance;
+    double furthestDescendantDistance;
+    double minWidth;
+  };
+
+  //! Compute the header (and so the layout) of a file.
+  static FileHeader MakeHeader(const size_t dimensionality,
+                               const size_t numPoints,
+                               const size_t numNodes,
+                               const size_t numMappings);
+
+  //! Build the tree from the mapped memory.
+  void BuildTree(const char* filename);
+
+  //! Release the mapped memory.
+  void Unmap();
+
+  //! The mapped memory.
+  char* memory;
+  //! The size of the mapped memory.
+  size_t memorySize;
+  //! Whether the memory is a real mapping (or a plain copy of the file).
+  bool isMapped;
+  //! The mapped tree.
+  TreeType* tree;
+  //! The mapping from tree order to original order.
+  std::vector<size_t> oldFromNew;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,385 @@
+/**
+ * @file core/tree/binary_space_tree/mapped_tree_impl.hpp
+ *
+ * Implementation of the MappedTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_MAPPED_TREE_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_MAPPED_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_tree.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+// The magic string at the start of every file.
+static const char mappedTreeMagic[8] = { 'M', 'L', 'P', 'K', 'T', 'R', 'E',
+    'E' };
+
+// The alignment of each section of the file.
+static const size_t mappedTreeAlignment = 64;
+
+template<typename TreeType>
+MappedTree<TreeType>::MappedTree(const std::string& filename) :
+    memory(NULL),
+    memorySize(0),
+    isMapped(false),
+    tree(NULL)
+{
+#if !defined(_WIN32)
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): cannot open file '" +
+        filename + "'!");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedTree::MappedTree(): cannot get size of "
+        "file '" + filename + "'!");
+  }
+  memorySize = (size_t) fileStat.st_size;
+
+  // The mapping is private and writable, so the tree can be used like any
+  // other tree; pages are only copied if they are written to.
+  void* address = (memorySize == 0) ? MAP_FAILED : mmap(NULL, memorySize,
+      PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): cannot map file '" +
+        filename + "'!");
+  }
+
+  memory = (char*) address;
+  isMapped = true;
+#else
+  // There is no mmap(); read the whole file instead.
+  std::ifstream f(filename, std::ios::binary | std::ios::ate);
+  if (!f.is_open())
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): cannot open file '" +
+        filename + "'!");
+  }
+
+  memorySize = (size_t) f.tellg();
+  f.seekg(0);
+  memory = (char*) std::malloc(memorySize);
+  if (!memory || !f.read(memory, memorySize))
+  {
+    Unmap();
+    throw std::runtime_error("MappedTree::MappedTree(): cannot read file '" +
+        filename + "'!");
+  }
+#endif
+
+  try
+  {
+    BuildTree(filename.c_str());
+  }
+  catch (...)
+  {
+    delete tree;
+    Unmap();
+    throw;
+  }
+}
+
+template<typename TreeType>
+MappedTree<TreeType>::~MappedTree()
+{
+  // The dataset of the tree aliases the mapped memory, so the tree has to go
+  // first.
+  delete tree;
+  Unmap();
+}
+
+template<typename TreeType>
+void MappedTree<TreeType>::Save(const std::string& filename,
+                                const TreeType& tree,
+                                const std::vector<size_t>& oldFromNew)
+{
+  if (tree.Parent() != NULL)
+  {
+    throw std::invalid_argument("MappedTree::Save(): the given node is not the "
+        "root of a tree!");
+  }
+
+  const MatType& dataset = tree.Dataset();
+  if (!oldFromNew.empty() && oldFromNew.size() != dataset.n_cols)
+  {
+    throw std::invalid_argument("MappedTree::Save(): size of oldFromNew does "
+        "not match the number of points in the tree!");
+  }
+
+  // Number the nodes in breadth-first order.
+  std::vector<const TreeType*> nodes;
+  nodes.push_back(&tree);
+  for (size_t i = 0; i < nodes.size(); ++i)
+    for (size_t c = 0; c < nodes[i]->NumChildren(); ++c)
+      nodes.push_back(&nodes[i]->Child(c));
+
+  const FileHeader header = MakeHeader(dataset.n_rows, dataset.n_cols,
+      nodes.size(), oldFromNew.size());
+
+  std::ofstream f(filename, std::ios::binary);
+  if (!f.is_open())
+  {
+    throw std::runtime_error("MappedTree::Save(): cannot open file '" +
+        filename + "' for writing!");
+  }
+
+  // Pad the file with zeros up to the given offset.
+  auto padTo = [&f](const uint64_t offset)
+  {
+    const char zeros[mappedTreeAlignment] = { 0 };
+    uint64_t position = (uint64_t) f.tellp();
+    while (f.good() && position < offset)
+    {
+      const size_t padding = std::min((size_t) (offset - position),
+          mappedTreeAlignment);
+      f.write(zeros, padding);
+      position += padding;
+    }
+  };
+
+  f.write((const char*) &header, sizeof(FileHeader));
+
+  padTo(header.dataOffset);
+  f.write((const char*) dataset.memptr(), dataset.n_elem * sizeof(ElemType));
+
+  padTo(header.nodeOffset);
+  size_t nextChild = 1;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    NodeRecord record;
+    record.begin = nodes[i]->Begin();
+    record.count = nodes[i]->Count();
+    record.left = (nodes[i]->Left() == NULL) ? 0 : nextChild++;
+    record.right = (nodes[i]->Right() == NULL) ? 0 : nextChild++;
+    record.parentDistance = nodes[i]->ParentDistance();
+    record.furthestDescendantDistance =
+        nodes[i]->FurthestDescendantDistance();
+    record.minWidth = nodes[i]->Bound().MinWidth();
+    f.write((const char*) &record, sizeof(NodeRecord));
+  }
+
+  padTo(header.boundOffset);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      const double range[2] = { (double) nodes[i]->Bound()[d].Lo(),
+                                 (double) nodes[i]->Bound()[d].Hi() };
+      f.write((const char*) range, sizeof(range));
+    }
+  }
+
+  padTo(header.mappingOffset);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    const uint64_t index = oldFromNew[i];
+    f.write((const char*) &index, sizeof(uint64_t));
+  }
+
+  padTo(header.fileSize);
+  if (!f.good())
+  {
+    throw std::runtime_error("MappedTree::Save(): error writing file '" +
+        filename + "'!");
+  }
+}
+
+template<typename TreeType>
+typename MappedTree<TreeType>::FileHeader MappedTree<TreeType>::MakeHeader(
+    const size_t dimensionality,
+    const size_t numPoints,
+    const size_t numNodes,
+    const size_t numMappings)
+{
+  // Round the given offset up to a multiple of the alignment.
+  auto align = [](const uint64_t offset)
+  {
+    return ((offset + mappedTreeAlignment - 1) / mappedTreeAlignment) *
+        mappedTreeAlignment;
+  };
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(FileHeader));
+  std::memcpy(header.magic, mappedTreeMagic, sizeof(header.magic));
+  header.version = 1;
+  header.elemSize = sizeof(ElemType);
+  header.dimensionality = dimensionality;
+  header.numPoints = numPoints;
+  header.numNodes = numNodes;
+  header.numMappings = numMappings;
+  header.dataOffset = align(sizeof(FileHeader));
+  header.nodeOffset = align(header.dataOffset +
+      dimensionality * numPoints * sizeof(ElemType));
+  header.boundOffset = align(header.nodeOffset +
+      numNodes * sizeof(NodeRecord));
+  header.mappingOffset = align(header.boundOffset +
+      numNodes * dimensionality * 2 * sizeof(double));
+  header.fileSize = align(header.mappingOffset +
+      numMappings * sizeof(uint64_t));
+
+  return header;
+}
+
+template<typename TreeType>
+void MappedTree<TreeType>::BuildTree(const char* filename)
+{
+  FileHeader header;
+  if (memorySize < sizeof(FileHeader))
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): file '" +
+        std::string(filename) + "' is too small to hold a tree!");
+  }
+  std::memcpy(&header, memory, sizeof(FileHeader));
+
+  if (std::memcmp(header.magic, mappedTreeMagic, sizeof(header.magic)) != 0 ||
+      header.version != 1)
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): file '" +
+        std::string(filename) + "' does not hold a mapped tree!");
+  }
+
+  if (header.elemSize != sizeof(ElemType))
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): the element type of "
+        "the tree in file '" + std::string(filename) + "' does not match!");
+  }
+
+  // Make sure the layout is what we expect, so that nothing is read outside of
+  // the file.
+  const FileHeader expected = MakeHeader(header.dimensionality,
+      header.numPoints, header.numNodes, header.numMappings);
+  if (std::memcmp(&header, &expected, sizeof(FileHeader)) != 0 ||
+      header.fileSize != memorySize || header.numNodes == 0 ||
+      (header.numMappings != 0 && header.numMappings != header.numPoints))
+  {
+    throw std::runtime_error("MappedTree::MappedTree(): file '" +
+        std::string(filename) + "' is corrupt!");
+  }
+
+  const size_t dimensionality = header.dimensionality;
+  const NodeRecord* records = (const NodeRecord*) (memory + header.nodeOffset);
+  const double* bounds = (const double*) (memory + header.boundOffset);
+
+  // The root owns the dataset object, which aliases the mapped memory.
+  tree = new TreeType();
+  tree->dataset = new MatType((ElemType*) (memory + header.dataOffset),
+      dimensionality, header.numPoints, false, true);
+  tree->begin = records[0].begin;
+  tree->count = records[0].count;
+
+  // Create the nodes in breadth-first order.
+  std::vector<TreeType*> nodes(header.numNodes, NULL);
+  nodes[0] = tree;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    TreeType* node = nodes[i];
+    if (node == NULL)
+    {
+      throw std::runtime_error("MappedTree::MappedTree(): file '" +
+          std::string(filename) + "' is corrupt!");
+    }
+
+    const NodeRecord& record = records[i];
+    if (record.begin + record.count > header.numPoints)
+    {
+      throw std::runtime_error("MappedTree::MappedTree(): file '" +
+          std::string(filename) + "' is corrupt!");
+    }
+
+    node->bound = typename std::decay<decltype(node->Bound())>::type(
+        dimensionality);
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      node->bound[d].Lo() = bounds[2 * (i * dimensionality + d)];
+      node->bound[d].Hi() = bounds[2 * (i * dimensionality + d) + 1];
+    }
+    node->bound.MinWidth() = record.minWidth;
+    node->parentDistance = record.parentDistance;
+    node->furthestDescendantDistance = record.furthestDescendantDistance;
+
+    // Children always come after their parent.
+    const uint64_t children[2] = { record.left, record.right };
+    for (size_t c = 0; c < 2; ++c)
+    {
+      if (children[c] == 0)
+        continue;
+
+      if (children[c] <= i || children[c] >= nodes.size() ||
+          nodes[children[c]] != NULL)
+      {
+        throw std::runtime_error("MappedTree::MappedTree(): file '" +
+            std::string(filename) + "' is corrupt!");
+      }
+
+      const NodeRecord& childRecord = records[children[c]];
+      TreeType* child = new TreeType(node, childRecord.begin,
+          childRecord.count);
+      nodes[children[c]] = child;
+      if (c == 0)
+        node->left = child;
+      else
+        node->right = child;
+    }
+  }
+
+  // Create the statistics bottom-up, like when the tree is built.
+  for (size_t i = nodes.size(); i > 0; --i)
+    nodes[i - 1]->stat = typename std::decay<decltype(
+        nodes[i - 1]->Stat())>::type(*nodes[i - 1]);
+
+  // Store the nodes contiguously, like any other tree.
+  tree->PackNodes();
+
+  const uint64_t* mappings = (const uint64_t*) (memory + header.mappingOffset);
+  oldFromNew.assign(mappings, mappings + header.numMappings);
+}
+
+template<typename TreeType>
+void MappedTree<TreeType>::Unmap()
+{
+  if (!memory)
+    return;
+
+#if !defined(_WIN32)
+  if (isMapped)
+    munmap(memory, memorySize);
+  else
+    std::free(memory);
+#else
+  std::free(memory);
+#endif
+
+  memory = NULL;
+  memorySize = 0;
+  isMapped = false;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
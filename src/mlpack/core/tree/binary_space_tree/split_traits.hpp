@@ -0,0 +1,61 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * The SplitTraits class describes properties of the splitters used by the
+ * BinarySpaceTree, so that the tree can decide how it may be built.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class provides compile-time information about a splitter
+ * for the BinarySpaceTree.  By default, nothing is assumed about the splitter;
+ * specializations should be written for splitters that allow more.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if two different nodes can be split at the same time with
+   * the same splitter object; that is, the splitter holds no state and does
+   * not use the random number generator.
+   */
+  static const bool IsThreadSafe = false;
+};
+
+/**
+ * The midpoint split only uses the bound of the node being split.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool IsThreadSafe = true;
+};
+
+/**
+ * The mean split only uses the bound and the points of the node being split.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool IsThreadSafe = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
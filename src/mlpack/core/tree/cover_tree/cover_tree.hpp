@@ -79,6 +79,13 @@ namespace tree {
  * }
  * @endcode
  *
+ * The distances computed during construction are split between threads with
+ * OpenMP when the point set of a node is large, so the metric must be safe to
+ * evaluate from several threads at once (as all mlpack metrics are).  The tree
+ * that is built does not depend on the number of threads: the children of a
+ * node are built in order, because each child removes the points it covers
+ * from the point sets of the next children.
+ *
  * The CoverTree class offers three template parameters; a custom metric type
  * can be used with MetricType (this class defaults to the L2-squared metric).
  * The root node's point can be chosen with the RootPointPolicy; by default, the
@@ -563,21 +570,37 @@ class CoverTree
 
  public:
   /**
-   * Serialize the tree.
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   size_t DistanceComps() const { return distanceComps; }
   size_t& DistanceComps() { return distanceComps; }
 
  private:
   size_t distanceComps;
+
+  /**
+   * Serialize this node and, through pointers, its children, like archives of
+   * version 0 store the tree.
+   */
+  template<typename Archive>
+  void SerializeRecursive(Archive& ar);
 };
 
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename MetricType,
+    typename StatisticType, typename MatType, typename RootPointPolicy>),
+    (mlpack::tree::CoverTree<MetricType, StatisticType, MatType,
+    RootPointPolicy>), 1);
+
 // Include implementation.
 #include "cover_tree_impl.hpp"
 
@@ -1392,9 +1392,12 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                      const size_t pointSetSize)
 {
   // For each point, rebuild the distances.  The indices do not need to be
-  // modified.
+  // modified.  The large point sets of the top levels of the tree, where most
+  // of the distances of the construction are computed, are split between
+  // threads; the small sets of the lower levels are not worth it.
   distanceComps += pointSetSize;
-  for (size_t i = 0; i < pointSetSize; ++i)
+  #pragma omp parallel for if (pointSetSize >= 4096)
+  for (omp_size_t i = 0; i < (omp_size_t) pointSetSize; ++i)
   {
     distances[i] = metric->Evaluate(dataset->col(pointIndex),
         dataset->col(indices[i]));
@@ -1728,7 +1731,7 @@ template<
 template<typename Archive>
 void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::serialize(
     Archive& ar,
-    const uint32_t /* version */)
+    const uint32_t version)
 {
   // If we're loading, and we have children, they need to be deleted.  We may
   // also need to delete the local metric and dataset.
@@ -1736,6 +1739,7 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::serialize(
   {
     for (size_t i = 0; i < children.size(); ++i)
       delete children[i];
+    children.clear();
 
     if (localMetric && metric)
       delete metric;
@@ -1745,6 +1749,133 @@ void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::serialize(
     parent = NULL;
   }
 
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    SerializeRecursive(ar);
+    return;
+  }
+
+  // The nodes of the subtree are stored as arrays that hold one element for
+  // each node, in breadth-first order, so that neither saving nor loading
+  // recurses; the children of each node are the next unclaimed nodes.
+  std::vector<CoverTree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      for (size_t j = 0; j < nodes[i]->children.size(); ++j)
+        nodes.push_back(nodes[i]->children[j]);
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  // The members of arithmetic types are written in one block each.
+  std::vector<size_t> points(numNodes), numChildren(numNodes),
+      numDescendantPoints(numNodes);
+  std::vector<int> scales(numNodes);
+  std::vector<ElemType> parentDistances(numNodes),
+      furthestDescendantDistances(numNodes);
+  if (cereal::is_saving<Archive>())
+  {
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      points[i] = nodes[i]->point;
+      numChildren[i] = nodes[i]->children.size();
+      numDescendantPoints[i] = nodes[i]->numDescendants;
+      scales[i] = nodes[i]->scale;
+      parentDistances[i] = nodes[i]->parentDistance;
+      furthestDescendantDistances[i] = nodes[i]->furthestDescendantDistance;
+    }
+  }
+  ar(CEREAL_NVP(points));
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(numDescendantPoints));
+  ar(CEREAL_NVP(scales));
+  ar(CEREAL_NVP(parentDistances));
+  ar(CEREAL_NVP(furthestDescendantDistances));
+  ar(CEREAL_NVP(base));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+      throw std::runtime_error("CoverTree::serialize(): the archive holds no "
+          "nodes!");
+
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    for (size_t i = 1; i < numNodes; ++i)
+      nodes[i] = new CoverTree();
+
+    size_t nextChild = 1;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      CoverTree* node = nodes[i];
+      if (nextChild + numChildren[i] > numNodes)
+      {
+        // Free the nodes that weren't attached yet.
+        for (size_t j = nextChild; j < numNodes; ++j)
+          delete nodes[j];
+        throw std::runtime_error("CoverTree::serialize(): the archive holds "
+            "an invalid tree!");
+      }
+
+      node->children.resize(numChildren[i]);
+      for (size_t j = 0; j < numChildren[i]; ++j)
+      {
+        node->children[j] = nodes[nextChild++];
+        node->children[j]->parent = node;
+      }
+
+      node->point = points[i];
+      node->numDescendants = numDescendantPoints[i];
+      node->scale = scales[i];
+      node->base = base;
+      node->parentDistance = parentDistances[i];
+      node->furthestDescendantDistance = furthestDescendantDistances[i];
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+    ar(cereal::make_nvp("stat", nodes[i]->stat));
+
+  // Only the root holds the dataset and the metric.
+  bool hasParent = (parent != NULL);
+  ar(CEREAL_NVP(hasParent));
+  if (!hasParent)
+  {
+    MatType*& datasetTemp = const_cast<MatType*&>(dataset);
+    ar(CEREAL_POINTER(datasetTemp));
+  }
+  ar(CEREAL_POINTER(metric));
+
+  if (cereal::is_loading<Archive>())
+  {
+    localMetric = true;
+    localDataset = true;
+    for (size_t i = 1; i < numNodes; ++i)
+    {
+      nodes[i]->dataset = dataset;
+      nodes[i]->metric = metric;
+    }
+  }
+}
+
+/**
+ * Serialize this node and, through pointers, its children, like archives of
+ * version 0 store the tree.
+ */
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+template<typename Archive>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    SerializeRecursive(Archive& ar)
+{
   bool hasParent = (parent != NULL);
   ar(CEREAL_NVP(hasParent));
   MatType*& datasetTemp = const_cast<MatType*&>(dataset);
@@ -0,0 +1,230 @@
+/**
+ * @file core/tree/leaf_distance_cache.hpp
+ *
+ * The LeafDistanceCache class computes the distances between a query point and
+ * all points of a reference leaf at once, so that the base cases of
+ * tree-independent rules don't have to evaluate the metric one pair at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_LEAF_DISTANCE_CACHE_HPP
+#define MLPACK_CORE_TREE_LEAF_DISTANCE_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The LeafDistanceCacheTraits class says whether the distances of a metric can
+ * be computed in blocks by the LeafDistanceCache.  By default they can't.
+ */
+template<typename MetricType>
+class LeafDistanceCacheTraits
+{
+ public:
+  //! Whether the LeafDistanceCache can compute distances for this metric.
+  static const bool IsBatchable = false;
+  //! Whether the square root of the squared distances must be taken.
+  static const bool TakeRoot = false;
+};
+
+//! The Euclidean and squared Euclidean distances can be computed in blocks.
+template<bool TakeRootValue>
+class LeafDistanceCacheTraits<metric::LMetric<2, TakeRootValue>>
+{
+ public:
+  static const bool IsBatchable = true;
+  static const bool TakeRoot = TakeRootValue;
+};
+
+/**
+ * A cache of the distances between one query point and all points of a
+ * reference leaf.  When the rules score a query point against a reference leaf
+ * (and don't prune it), they call Prepare(); at the next base case between that
+ * query point and a point of the leaf, all distances to the leaf are computed
+ * in one loop over the leaf, which keeps the query point in registers and lets
+ * the compiler vectorize over the reference points.  Later base cases against
+ * the leaf only look up the distance.
+ *
+ * Two leaves are remembered, since the single-tree traversers score both
+ * children of a node before visiting either of them.  The distances of a leaf
+ * are only computed if a base case is actually performed against it.
+ *
+ * For metrics and matrix types that can't be handled (anything but the
+ * (squared) Euclidean distance on dense matrices), every method is a no-op and
+ * Distance() always returns false, so the rules fall back to the metric.  The
+ * points of the leaf must be contiguous in the dataset, as in a
+ * BinarySpaceTree; other leaves are ignored.
+ *
+ * @tparam MetricType Metric used by the rules.
+ * @tparam MatType Type of the query and reference matrices.
+ */
+template<typename MetricType, typename MatType>
+class LeafDistanceCache
+{
+ public:
+  //! Whether distances can be computed in blocks.
+  static const bool IsBatchable =
+      LeafDistanceCacheTraits<MetricType>::IsBatchable &&
+      !arma::is_SpMat<MatType>::value;
+
+  //! Create an empty cache.
+  LeafDistanceCache() : nextBlock(0)
+  {
+    for (size_t i = 0; i < 2; ++i)
+    {
+      blocks[i].queryIndex = size_t(-1);
+      blocks[i].begin = 0;
+      blocks[i].count = 0;
+      blocks[i].computed = false;
+    }
+  }
+
+  /**
+   * Note that base cases between the given query point and the points of the
+   * given reference node may follow.  Nothing is done if the node is not a
+   * leaf, holds fewer than two points, or holds points that are not
+   * contiguous.
+   *
+   * @param queryIndex Index of the query point.
+   * @param referenceNode Reference node that was just scored.
+   */
+  template<typename TreeType>
+  void Prepare(const size_t queryIndex, const TreeType& referenceNode)
+  {
+    if (!IsBatchable || !referenceNode.IsLeaf())
+      return;
+
+    const size_t numPoints = referenceNode.NumPoints();
+    if (numPoints < 2)
+      return;
+
+    const size_t begin = referenceNode.Point(0);
+    if (referenceNode.Point(numPoints - 1) != begin + numPoints - 1)
+      return;
+
+    for (size_t i = 0; i < 2; ++i)
+      if (blocks[i].queryIndex == queryIndex && blocks[i].begin == begin &&
+          blocks[i].count == numPoints)
+        return;
+
+    Block& block = blocks[nextBlock];
+    nextBlock = 1 - nextBlock;
+
+    block.queryIndex = queryIndex;
+    block.begin = begin;
+    block.count = numPoints;
+    block.computed = false;
+  }
+
+  /**
+   * Get the distance between the given query and reference points, if the
+   * reference point is in a prepared leaf for that query point.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet Set of reference points.
+   * @param queryIndex Index of the query point.
+   * @param referenceIndex Index of the reference point.
+   * @param distance Set to the distance between the points, if found.
+   * @return Whether the distance was found.
+   */
+  bool Distance(const MatType& querySet,
+                const MatType& referenceSet,
+                const size_t queryIndex,
+                const size_t referenceIndex,
+                double& distance)
+  {
+    if (!IsBatchable)
+      return false;
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+      Block& block = blocks[i];
+      // The unsigned subtraction also rejects indices before the block.
+      if (block.queryIndex != queryIndex ||
+          referenceIndex - block.begin >= block.count)
+        continue;
+
+      if (!block.computed)
+      {
+        Compute(querySet, referenceSet, block,
+            std::integral_constant<bool, IsBatchable>());
+      }
+
+      distance = block.distances[referenceIndex - block.begin];
+      return true;
+    }
+
+    return false;
+  }
+
+ private:
+  //! The distances between one query point and the points of one leaf.
+  struct Block
+  {
+    //! The index of the query point.
+    size_t queryIndex;
+    //! The index of the first point of the leaf.
+    size_t begin;
+    //! The number of points in the leaf.
+    size_t count;
+    //! Whether the distances have been computed yet.
+    bool computed;
+    //! The distances to each point of the leaf.
+    std::vector<double> distances;
+  };
+
+  //! Compute the distances of the given block.
+  void Compute(const MatType& querySet,
+               const MatType& referenceSet,
+               Block& block,
+               std::true_type /* isBatchable */)
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    const size_t dim = querySet.n_rows;
+    const ElemType* query = querySet.colptr(block.queryIndex);
+    const ElemType* references = referenceSet.colptr(block.begin);
+
+    // Accumulate one dimension at a time, so the inner loop is over
+    // independent reference points.
+    block.distances.assign(block.count, 0.0);
+    double* distances = block.distances.data();
+    for (size_t d = 0; d < dim; ++d)
+    {
+      const double q = query[d];
+      for (size_t j = 0; j < block.count; ++j)
+      {
+        const double diff = q - references[j * dim + d];
+        distances[j] += diff * diff;
+      }
+    }
+
+    if (LeafDistanceCacheTraits<MetricType>::TakeRoot)
+      for (size_t j = 0; j < block.count; ++j)
+        distances[j] = std::sqrt(distances[j]);
+
+    block.computed = true;
+  }
+
+  //! This is never called, but must compile for unsupported matrix types.
+  void Compute(const MatType& /* querySet */,
+               const MatType& /* referenceSet */,
+               Block& /* block */,
+               std::false_type /* isBatchable */) { }
+
+  //! The two most recently prepared blocks.
+  Block blocks[2];
+  //! The block to replace next.
+  size_t nextBlock;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -396,9 +396,14 @@ class Octree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
-  //! Serialize the tree.
+  /**
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
+   */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  protected:
   /**
@@ -413,6 +418,13 @@ class Octree
   friend class cereal::access;
 
  private:
+  /**
+   * Serialize this node and, through pointers, its children, like archives of
+   * version 0 store the tree.
+   */
+  template<typename Archive>
+  void SerializeRecursive(Archive& ar);
+
   /**
    * Split the node, using the given center and the given maximum width of this
    * node.
@@ -466,6 +478,11 @@ class Octree
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename MetricType,
+    typename StatisticType, typename MatType>),
+    (mlpack::tree::Octree<MetricType, StatisticType, MatType>), 1);
+
 // Include implementation.
 #include "octree_impl.hpp"
 
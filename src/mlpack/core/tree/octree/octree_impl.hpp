@@ -710,7 +710,7 @@ template<typename MetricType, typename StatisticType, typename MatType>
 template<typename Archive>
 void Octree<MetricType, StatisticType, MatType>::serialize(
     Archive& ar,
-    const uint32_t /* version */)
+    const uint32_t version)
 {
   // If we're loading and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
@@ -725,6 +725,124 @@ void Octree<MetricType, StatisticType, MatType>::serialize(
     parent = NULL;
   }
 
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    SerializeRecursive(ar);
+    return;
+  }
+
+  // The nodes of the subtree are stored as arrays that hold one element for
+  // each node, in breadth-first order, so that neither saving nor loading
+  // recurses; the children of each node are the next unclaimed nodes.
+  std::vector<Octree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      for (size_t j = 0; j < nodes[i]->children.size(); ++j)
+        nodes.push_back(nodes[i]->children[j]);
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  // The members of arithmetic types are written in one block each.
+  std::vector<size_t> begins(numNodes), counts(numNodes),
+      numChildren(numNodes);
+  std::vector<ElemType> parentDistances(numNodes),
+      furthestDescendantDistances(numNodes);
+  if (cereal::is_saving<Archive>())
+  {
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      begins[i] = nodes[i]->begin;
+      counts[i] = nodes[i]->count;
+      numChildren[i] = nodes[i]->children.size();
+      parentDistances[i] = nodes[i]->parentDistance;
+      furthestDescendantDistances[i] = nodes[i]->furthestDescendantDistance;
+    }
+  }
+  ar(CEREAL_NVP(begins));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(parentDistances));
+  ar(CEREAL_NVP(furthestDescendantDistances));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+      throw std::runtime_error("Octree::serialize(): the archive holds no "
+          "nodes!");
+
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    for (size_t i = 1; i < numNodes; ++i)
+    {
+      // Only the root owns a dataset.
+      nodes[i] = new Octree();
+      delete nodes[i]->dataset;
+      nodes[i]->dataset = NULL;
+    }
+
+    size_t nextChild = 1;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      Octree* node = nodes[i];
+      if (nextChild + numChildren[i] > numNodes)
+      {
+        // Free the nodes that weren't attached yet.
+        for (size_t j = nextChild; j < numNodes; ++j)
+          delete nodes[j];
+        throw std::runtime_error("Octree::serialize(): the archive holds an "
+            "invalid tree!");
+      }
+
+      node->children.resize(numChildren[i]);
+      for (size_t j = 0; j < numChildren[i]; ++j)
+      {
+        node->children[j] = nodes[nextChild++];
+        node->children[j]->parent = node;
+      }
+
+      node->begin = begins[i];
+      node->count = counts[i];
+      node->parentDistance = parentDistances[i];
+      node->furthestDescendantDistance = furthestDescendantDistances[i];
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    ar(cereal::make_nvp("bound", nodes[i]->bound));
+    ar(cereal::make_nvp("stat", nodes[i]->stat));
+    ar(cereal::make_nvp("metric", nodes[i]->metric));
+  }
+
+  bool hasParent = (parent != NULL);
+  ar(CEREAL_NVP(hasParent));
+  if (!hasParent)
+  {
+    MatType*& datasetTemp = const_cast<MatType*&>(dataset);
+    ar(CEREAL_POINTER(datasetTemp));
+
+    if (cereal::is_loading<Archive>())
+    {
+      for (size_t i = 1; i < numNodes; ++i)
+        nodes[i]->dataset = dataset;
+    }
+  }
+}
+
+/**
+ * Serialize this node and, through pointers, its children, like archives of
+ * version 0 store the tree.
+ */
+template<typename MetricType, typename StatisticType, typename MatType>
+template<typename Archive>
+void Octree<MetricType, StatisticType, MatType>::SerializeRecursive(
+    Archive& ar)
+{
   bool hasParent = (parent != NULL);
 
   ar(CEREAL_NVP(begin));
@@ -0,0 +1,86 @@
+/**
+ * @file core/tree/query_subtrees.hpp
+ *
+ * Split a query tree into a set of disjoint subtrees, so that independent
+ * dual-tree traversals of each subtree against a reference tree can be run in
+ * parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+#define MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+#include <algorithm>
+#include <deque>
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * Split the tree rooted at the given node into at least minSubtrees disjoint
+ * subtrees (when the tree is big enough for that), by expanding nodes in
+ * breadth-first order.  The union of the descendants of the returned nodes is
+ * exactly the set of descendants of the given node, and no point is held by
+ * two of the returned subtrees.  So, a dual-tree traversal against each of the
+ * returned subtrees touches a disjoint set of query points, and the traversals
+ * can run concurrently as long as each uses its own rule object.
+ *
+ * A node that holds points of its own that are not also held by one of its
+ * children (i.e. a non-leaf with points in a tree without self-children) is
+ * never expanded, because those points would otherwise be lost.
+ *
+ * The returned subtrees are sorted in decreasing order of size, which gives a
+ * reasonable load balance for a dynamic schedule.
+ *
+ * @param node Root of the tree to split.
+ * @param minSubtrees Minimum number of subtrees to split the tree into.
+ * @param subtrees Vector to store the roots of the subtrees in.
+ */
+template<typename TreeType>
+void QuerySubtrees(TreeType& node,
+                   const size_t minSubtrees,
+                   std::vector<TreeType*>& subtrees)
+{
+  subtrees.clear();
+
+  std::deque<TreeType*> frontier;
+  frontier.push_back(&node);
+
+  // Expand the shallowest nodes first until we have enough subtrees or there is
+  // nothing left to expand.
+  while (!frontier.empty() && frontier.size() + subtrees.size() < minSubtrees)
+  {
+    TreeType* current = frontier.front();
+    frontier.pop_front();
+
+    const bool canExpand = !current->IsLeaf() && (current->NumPoints() == 0 ||
+        TreeTraits<TreeType>::HasSelfChildren);
+    if (!canExpand)
+    {
+      subtrees.push_back(current);
+      continue;
+    }
+
+    for (size_t i = 0; i < current->NumChildren(); ++i)
+      frontier.push_back(&current->Child(i));
+  }
+
+  subtrees.insert(subtrees.end(), frontier.begin(), frontier.end());
+
+  // Process the largest subtrees first.
+  std::stable_sort(subtrees.begin(), subtrees.end(),
+      [](const TreeType* a, const TreeType* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file core/tree/rectangle_tree/concurrent_rectangle_tree.hpp
+ *
+ * Definition of the ConcurrentRectangleTree class, which lets a writer modify a
+ * RectangleTree while any number of readers search published snapshots of it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ConcurrentRectangleTree class holds a RectangleTree (of any variant) that
+ * is modified by writers while it is searched by readers.  The writers insert
+ * and delete points in a private working tree, and Publish() makes a copy of
+ * the working tree available to the readers as an immutable snapshot.  Readers
+ * get the latest snapshot with Snapshot(), which never blocks, and can traverse
+ * it with any number of threads while the writers keep modifying the working
+ * tree; a snapshot is destroyed when the last reader holding it releases it.
+ *
+ * Publishing copies the whole tree, so the changes should be published in
+ * batches rather than after each insertion.  Writers are serialized with a
+ * mutex; a writer that calls Insert() while another one publishes waits for the
+ * copy to finish.
+ *
+ * Snapshots are searched with the traversers of the tree and the rules of the
+ * search; each thread needs its own rules.  For instance, to find the nearest
+ * neighbors of a set of query points:
+ *
+ * @code
+ * typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+ *     arma::mat> TreeType;
+ * typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+ *     TreeType> RulesType;
+ *
+ * ConcurrentRectangleTree<TreeType> index(data);
+ *
+ * // Writer thread.
+ * index.Insert(point);
+ * index.Publish();
+ *
+ * // Reader threads.
+ * std::shared_ptr<const TreeType> snapshot = index.Snapshot();
+ * EuclideanDistance metric;
+ * RulesType rules(snapshot->Dataset(), queries, k, metric);
+ * TreeType::SingleTreeTraverser<RulesType> traverser(rules);
+ * for (size_t i = 0; i < queries.n_cols; ++i)
+ *   traverser.Traverse(i, *snapshot);
+ * rules.GetResults(neighbors, distances);
+ * @endcode
+ *
+ * @tparam TreeType The type of RectangleTree, such as RTree or XTree.
+ */
+template<typename TreeType>
+class ConcurrentRectangleTree
+{
+ public:
+  //! The type of the dataset of the tree.
+  typedef typename TreeType::Mat MatType;
+  //! The element type held by the dataset.
+  typedef typename TreeType::ElemType ElemType;
+
+  /**
+   * Build the tree on the given dataset, and publish it.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  ConcurrentRectangleTree(const MatType& data,
+                          const size_t maxLeafSize = 20,
+                          const size_t minLeafSize = 8,
+                          const size_t maxNumChildren = 5,
+                          const size_t minNumChildren = 2);
+
+  /**
+   * Take ownership of the given tree, which must be the root of a tree built
+   * on its own dataset, and publish it.
+   *
+   * @param tree The tree to take ownership of.
+   */
+  explicit ConcurrentRectangleTree(TreeType&& tree);
+
+  /**
+   * Insert the given point into the working tree.  The point is added to the
+   * dataset of the tree, and the index of its column is returned.  Readers see
+   * the point after the next call to Publish().
+   *
+   * @param point The point to insert.
+   * @return The index of the point in the dataset.
+   */
+  template<typename VecType>
+  size_t Insert(const VecType& point);
+
+  /**
+   * Delete the point with the given index from the working tree.  The point is
+   * kept in the dataset, so that the other indices don't change.  Readers see
+   * the deletion after the next call to Publish().
+   *
+   * @param index The index of the point in the dataset.
+   * @return false if the point is not in the tree.
+   */
+  bool Delete(const size_t index);
+
+  /**
+   * Publish a copy of the working tree, which the readers get with Snapshot()
+   * from now on.  The readers that hold the previous snapshot can keep using
+   * it.
+   */
+  void Publish();
+
+  /**
+   * Get the latest published snapshot of the tree.  The snapshot is never
+   * modified, and can be searched by any number of threads.
+   */
+  std::shared_ptr<const TreeType> Snapshot() const
+  { return std::atomic_load(&snapshot); }
+
+  //! Get the number of changes that were not published yet.
+  size_t NumUnpublishedChanges() const;
+
+ private:
+  //! The working tree, which is only used by the writers.
+  TreeType working;
+  //! The number of changes made to the working tree since the last snapshot.
+  size_t unpublishedChanges;
+  //! The mutex that serializes the writers.
+  mutable std::mutex writerMutex;
+  //! The latest published snapshot.
+  std::shared_ptr<const TreeType> snapshot;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "concurrent_rectangle_tree_impl.hpp"
+
+#endif
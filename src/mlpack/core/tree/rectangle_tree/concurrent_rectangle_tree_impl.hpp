@@ -0,0 +1,106 @@
+/**
+ * @file core/tree/rectangle_tree/concurrent_rectangle_tree_impl.hpp
+ *
+ * Implementation of the ConcurrentRectangleTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "concurrent_rectangle_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+ConcurrentRectangleTree<TreeType>::ConcurrentRectangleTree(
+    const MatType& data,
+    const size_t maxLeafSize,
+    const size_t minLeafSize,
+    const size_t maxNumChildren,
+    const size_t minNumChildren) :
+    working(data, maxLeafSize, minLeafSize, maxNumChildren, minNumChildren),
+    unpublishedChanges(0)
+{
+  Publish();
+}
+
+template<typename TreeType>
+ConcurrentRectangleTree<TreeType>::ConcurrentRectangleTree(TreeType&& tree) :
+    working(std::move(tree)),
+    unpublishedChanges(0)
+{
+  if (working.Parent() != NULL)
+  {
+    throw std::invalid_argument("ConcurrentRectangleTree::"
+        "ConcurrentRectangleTree(): the tree must be the root of a tree!");
+  }
+
+  Publish();
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t ConcurrentRectangleTree<TreeType>::Insert(const VecType& point)
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+
+  if (point.n_elem != working.Dataset().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ConcurrentRectangleTree::Insert(): the point has " << point.n_elem
+        << " dimensions, but the tree has " << working.Dataset().n_rows
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only the writers use the dataset of the working tree, so it can be
+  // reallocated; the snapshots own copies of it.
+  const size_t index = working.Dataset().n_cols;
+  working.Dataset().insert_cols(index, point);
+  working.InsertPoint(index);
+  ++unpublishedChanges;
+
+  return index;
+}
+
+template<typename TreeType>
+bool ConcurrentRectangleTree<TreeType>::Delete(const size_t index)
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+
+  if (!working.DeletePoint(index))
+    return false;
+
+  ++unpublishedChanges;
+  return true;
+}
+
+template<typename TreeType>
+void ConcurrentRectangleTree<TreeType>::Publish()
+{
+  // The snapshot is stored while the lock is held, so that the snapshots of
+  // concurrent writers are published in order.  The previous snapshot is
+  // destroyed when its last reader releases it.
+  std::lock_guard<std::mutex> lock(writerMutex);
+  std::atomic_store(&snapshot,
+      std::shared_ptr<const TreeType>(std::make_shared<TreeType>(working)));
+  unpublishedChanges = 0;
+}
+
+template<typename TreeType>
+size_t ConcurrentRectangleTree<TreeType>::NumUnpublishedChanges() const
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+  return unpublishedChanges;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -20,10 +20,27 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "x_tree_auxiliary_information.hpp"
+#include "discrete_hilbert_value.hpp"
+#include <mlpack/core/tree/tree_traits.hpp>
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The orders in which the bulk-loading constructors of RectangleTree can pack
+ * the points into the leaves of the tree.
+ */
+enum BulkLoadType
+{
+  //! Sort-Tile-Recursive packing: the points are sorted into slabs along each
+  //! dimension in turn, and each slab is packed into full leaves.
+  STR_BULK_LOAD,
+  //! Hilbert packing: the points are sorted by their discrete Hilbert value,
+  //! and consecutive points are packed into full leaves.
+  HILBERT_BULK_LOAD
+};
+
 /**
  * A rectangle type tree tree, such as an R-tree or X-tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -156,6 +173,59 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, by bulk-loading the points instead of inserting them one at a
+   * time.  The points are sorted in the given order and packed into full
+   * leaves, and the levels above the leaves are built bottom-up by packing the
+   * nodes in the same order; this is much faster than inserting the points,
+   * and usually gives leaves with less overlap.  The leaves are built in
+   * parallel when OpenMP is available.
+   *
+   * Trees whose nodes must not overlap (the R+ and R++ trees) and the Hilbert
+   * R tree, which keeps the Hilbert values of its nodes up to date during
+   * insertion, can't be packed bottom-up; for these trees, the points are
+   * inserted one at a time, in the given order, which still gives better
+   * packed leaves than the order of the dataset.  In either case the tree can
+   * be modified afterwards with InsertPoint() and DeletePoint() as usual.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoadType The order in which to pack the points.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadType bulkLoadType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, by bulk-loading the points, and taking ownership of the given
+   * dataset.  See the constructor above for details.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoadType The order in which to pack the points.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadType bulkLoadType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -564,6 +634,44 @@ class RectangleTree
    */
   void BuildStatistics(RectangleTree* node);
 
+  /**
+   * Bulk-load all the points of the dataset into this node, which must be an
+   * empty root.
+   *
+   * @param bulkLoadType The order in which to pack the points.
+   */
+  void BulkLoad(const BulkLoadType bulkLoadType);
+
+  /**
+   * Sort the given columns of the given matrix in Sort-Tile-Recursive order:
+   * sort them along the given dimension, cut them into slabs, and sort each
+   * slab recursively along the next dimension.
+   *
+   * @param points Matrix whose columns are sorted.
+   * @param order Indices of the columns; order[begin, end) are sorted.
+   * @param begin The first index to sort.
+   * @param end One past the last index to sort.
+   * @param dimension The dimension to sort along.
+   * @param pageSize The number of columns that will be packed together.
+   */
+  template<typename PointMatType>
+  static void STROrder(const PointMatType& points,
+                       std::vector<size_t>& order,
+                       const size_t begin,
+                       const size_t end,
+                       const size_t dimension,
+                       const size_t pageSize);
+
+  /**
+   * Sort the columns of the given matrix by their discrete Hilbert value.
+   *
+   * @param points Matrix whose columns are sorted.
+   * @param order Indices of the columns, which are sorted.
+   */
+  template<typename PointMatType>
+  static void HilbertOrder(const PointMatType& points,
+                           std::vector<size_t>& order);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
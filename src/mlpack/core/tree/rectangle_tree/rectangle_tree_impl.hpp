@@ -121,6 +121,80 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType bulkLoadType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoadType);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType bulkLoadType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoadType);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -1036,6 +1110,200 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Bulk-load the points of the dataset into this node.  The points are sorted in
+ * the given order and packed into full leaves; then the nodes of each level are
+ * sorted in the same order (by their centers) and packed into full parents,
+ * until they fit into this node.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(const BulkLoadType bulkLoadType)
+{
+  const size_t numPoints = dataset->n_cols;
+  std::vector<size_t> order(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    order[i] = i;
+
+  if (bulkLoadType == HILBERT_BULK_LOAD)
+    HilbertOrder(*dataset, order);
+  else
+    STROrder(*dataset, order, 0, numPoints, 0, maxLeafSize);
+
+  // Packing the nodes bottom-up would break the invariants of the trees whose
+  // nodes can't overlap and of the trees whose auxiliary information is built
+  // during insertion, so for these trees, the points are inserted in order.
+  const bool packBottomUp = TreeTraits<RectangleTree>::HasOverlappingChildren &&
+      (std::is_same<AuxiliaryInformation,
+                    NoAuxiliaryInformation<RectangleTree>>::value ||
+       std::is_same<AuxiliaryInformation,
+                    XTreeAuxiliaryInformation<RectangleTree>>::value);
+  if (!packBottomUp || numPoints <= maxLeafSize)
+  {
+    for (size_t i = 0; i < numPoints; ++i)
+      InsertPoint(order[i]);
+    return;
+  }
+
+  // Spread the points evenly over the leaves, so that no leaf is much smaller
+  // than the others.  All the nodes are created as children of this node, so
+  // that they get the parameters of the tree.
+  const size_t numLeaves = (numPoints + maxLeafSize - 1) / maxLeafSize;
+  std::vector<RectangleTree*> nodes(numLeaves);
+  for (size_t i = 0; i < numLeaves; ++i)
+    nodes[i] = new RectangleTree(this);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numLeaves; ++i)
+  {
+    RectangleTree* leaf = nodes[i];
+    const size_t first = i * numPoints / numLeaves;
+    const size_t last = (i + 1) * numPoints / numLeaves;
+    for (size_t j = first; j < last; ++j)
+    {
+      leaf->points[leaf->count++] = order[j];
+      leaf->bound |= dataset->col(order[j]);
+    }
+    leaf->numDescendants = leaf->count;
+  }
+
+  // Pack each level into the next, until the nodes fit into this node.
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::Mat<ElemType> centers(dataset->n_rows, nodes.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+      for (size_t d = 0; d < centers.n_rows; ++d)
+        centers(d, i) = nodes[i]->bound[d].Mid();
+
+    std::vector<size_t> nodeOrder(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      nodeOrder[i] = i;
+
+    if (bulkLoadType == HILBERT_BULK_LOAD)
+      HilbertOrder(centers, nodeOrder);
+    else
+      STROrder(centers, nodeOrder, 0, nodes.size(), 0, maxNumChildren);
+
+    const size_t numParents = (nodes.size() + maxNumChildren - 1) /
+        maxNumChildren;
+    std::vector<RectangleTree*> parents(numParents);
+    for (size_t i = 0; i < numParents; ++i)
+      parents[i] = new RectangleTree(this);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numParents; ++i)
+    {
+      RectangleTree* node = parents[i];
+      const size_t first = i * nodes.size() / numParents;
+      const size_t last = (i + 1) * nodes.size() / numParents;
+      for (size_t j = first; j < last; ++j)
+      {
+        RectangleTree* child = nodes[nodeOrder[j]];
+        node->children[node->numChildren++] = child;
+        child->parent = node;
+        node->bound |= child->bound;
+        node->numDescendants += child->numDescendants;
+      }
+    }
+
+    nodes = std::move(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    children[numChildren++] = nodes[i];
+    nodes[i]->parent = this;
+    bound |= nodes[i]->bound;
+    numDescendants += nodes[i]->numDescendants;
+  }
+}
+
+/**
+ * Sort the columns in Sort-Tile-Recursive order.  The number of slabs along
+ * each dimension is chosen so that the pages are tiled about equally along the
+ * remaining dimensions.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PointMatType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    STROrder(const PointMatType& points,
+             std::vector<size_t>& order,
+             const size_t begin,
+             const size_t end,
+             const size_t dimension,
+             const size_t pageSize)
+{
+  std::sort(order.begin() + begin, order.begin() + end,
+      [&points, dimension](const size_t a, const size_t b)
+      {
+        return points(dimension, a) < points(dimension, b);
+      });
+
+  const size_t numColumns = end - begin;
+  const size_t remainingDimensions = points.n_rows - dimension;
+  if (remainingDimensions <= 1 || numColumns <= pageSize)
+    return;
+
+  const size_t numPages = (numColumns + pageSize - 1) / pageSize;
+  const size_t numSlabs = (size_t) std::ceil(std::pow((double) numPages,
+      1.0 / remainingDimensions));
+  const size_t slabSize = ((numPages + numSlabs - 1) / numSlabs) * pageSize;
+  const size_t numUsedSlabs = (numColumns + slabSize - 1) / slabSize;
+
+  // The slabs are disjoint, so the slabs of the first dimension can be sorted
+  // in parallel.
+  #pragma omp parallel for if (dimension == 0)
+  for (omp_size_t i = 0; i < (omp_size_t) numUsedSlabs; ++i)
+  {
+    const size_t slabBegin = begin + i * slabSize;
+    STROrder(points, order, slabBegin, std::min(slabBegin + slabSize, end),
+        dimension + 1, pageSize);
+  }
+}
+
+/**
+ * Sort the columns by their discrete Hilbert value.  The values are computed
+ * in parallel, once per column.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+template<typename PointMatType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    HilbertOrder(const PointMatType& points, std::vector<size_t>& order)
+{
+  typedef DiscreteHilbertValue<ElemType> HilbertValue;
+  std::vector<arma::Col<typename HilbertValue::HilbertElemType>> values(
+      points.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    values[i] = HilbertValue::CalculateValue(points.col(i));
+
+  std::sort(order.begin(), order.end(),
+      [&values](const size_t a, const size_t b)
+      {
+        return HilbertValue::CompareValues(values[a], values[b]) < 0;
+      });
+}
+
 //! Default constructor for cereal.
 template<typename MetricType,
          typename StatisticType,
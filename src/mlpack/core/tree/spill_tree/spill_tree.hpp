@@ -91,8 +91,13 @@ class SpillTree
   //! children).
   size_t count;
   //! The list of indexes of points contained in this node (non-NULL if the node
-  //! is a leaf or if overlappingNode is true).
-  arma::Col<size_t>* pointsIndex;
+  //! is a leaf or if overlappingNode is true).  It points into the pool of the
+  //! root of the tree, and holds count elements.
+  size_t* pointsIndex;
+  //! The lists of indexes of points of all the nodes of the tree, stored one
+  //! after the other in depth-first order.  This is only non-NULL in the node
+  //! that built (or loaded, or copied) the tree, which owns it.
+  arma::Col<size_t>* pointsPool;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
   //! Splitting hyperplane represented by this node.
@@ -451,6 +456,91 @@ class SpillTree
                  const double tau,
                  const double rho);
 
+  /**
+   * Construct this node as a child of the given parent, holding the given
+   * number of points.  The node is not split; the caller splits it.
+   *
+   * @param parent Parent of this node.
+   * @param count Number of points held in this node.
+   */
+  SpillTree(SpillTree* parent, const size_t count);
+
+  /**
+   * Copy the given node and its descendants, with the given parent.  The
+   * copied nodes use the lists of points of the other tree, so PackPoints()
+   * must be called on the result before the other tree is modified.
+   *
+   * @param other Node to copy.
+   * @param parent Parent of the copy.
+   */
+  SpillTree(const SpillTree& other, SpillTree* parent);
+
+  /**
+   * Return whether the tree should be built in parallel: this is the case if
+   * OpenMP is available with more than one thread, if we are not already in a
+   * parallel region, and if the node holds enough points for that to be worth
+   * it.
+   */
+  bool BuildInParallel() const;
+
+  /**
+   * Split the current node and build its subtree in parallel.  The top levels
+   * of the subtree are expanded one node at a time until there are enough
+   * subtrees left to build for all the threads; then those subtrees are built
+   * concurrently.  The resulting tree is the same as the one SplitNode()
+   * builds.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void ParallelSplitNode(arma::Col<size_t>& points,
+                         const size_t maxLeafSize,
+                         const double tau,
+                         const double rho);
+
+  /**
+   * Compute the bound of the current node and split its points, creating its
+   * children if the node can be split, but without splitting the children.
+   *
+   * @param points Vector of indexes of points to be included in this node.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   * @param leftPoints Indexes of points to be included in the left child.
+   * @param rightPoints Indexes of points to be included in the right child.
+   * @return Whether the node was split.
+   */
+  bool ExpandNode(arma::Col<size_t>& points,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho,
+                  arma::Col<size_t>& leftPoints,
+                  arma::Col<size_t>& rightPoints);
+
+  /**
+   * Keep the given list of points in this node, until PackPoints() moves it to
+   * the pool.  The given list is emptied.
+   */
+  void StorePoints(arma::Col<size_t>& points);
+
+  //! Compute the distances from the center of this node to the centers of its
+  //! children.
+  void SetChildParentDistances();
+
+  /**
+   * Move the lists of points of all the nodes of the tree into one pool owned
+   * by this node, in depth-first order.
+   *
+   * @param ownsLists Whether the nodes own their current lists of points
+   *     (which are then freed), or share them with another tree.
+   */
+  void PackPoints(const bool ownsLists);
+
+  //! The minimum number of points of a node for it to be built in parallel.
+  static const size_t parallelBuildMinPoints = 16384;
+
   /**
    * Split the list of points.
    *
@@ -480,15 +570,34 @@ class SpillTree
 
  public:
   /**
-   * Serialize the tree.
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
    */
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  /**
+   * Serialize this node and, through pointers, its children, like archives of
+   * version 0 store the tree.
+   */
+  template<typename Archive>
+  void SerializeRecursive(Archive& ar);
 };
 
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename MetricType,
+    typename StatisticType, typename MatType,
+    template<typename HyperplaneMetricType> class HyperplaneType,
+    template<typename SplitMetricType, typename SplitMatType>
+        class SplitType>), (mlpack::tree::SpillTree<MetricType,
+    StatisticType, MatType, HyperplaneType, SplitType>), 1);
+
 // Include implementation.
 #include "spill_tree_impl.hpp"
 
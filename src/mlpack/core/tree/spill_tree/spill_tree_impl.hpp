@@ -14,7 +14,9 @@
 // In case it wasn't included already for some reason.
 #include "spill_tree.hpp"
 
+#include <deque>
 #include <queue>
+#include <stack>
 
 namespace mlpack {
 namespace tree {
@@ -36,6 +38,7 @@ SpillTree(
     parent(NULL),
     count(data.n_cols),
     pointsIndex(NULL),
+    pointsPool(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -50,7 +53,13 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  if (BuildInParallel())
+    ParallelSplitNode(points, maxLeafSize, tau, rho);
+  else
+    SplitNode(points, maxLeafSize, tau, rho);
+
+  // Store the lists of points of all the nodes in one block.
+  PackPoints(true);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -73,6 +82,7 @@ SpillTree(
     parent(NULL),
     count(data.n_cols),
     pointsIndex(NULL),
+    pointsPool(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -87,7 +97,13 @@ SpillTree(
         dataset->n_cols);
 
   // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
+  if (BuildInParallel())
+    ParallelSplitNode(points, maxLeafSize, tau, rho);
+  else
+    SplitNode(points, maxLeafSize, tau, rho);
+
+  // Store the lists of points of all the nodes in one block.
+  PackPoints(true);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -111,6 +127,7 @@ SpillTree(
     parent(parent),
     count(points.n_elem),
     pointsIndex(NULL),
+    pointsPool(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(parent->Dataset().n_rows),
@@ -120,6 +137,9 @@ SpillTree(
   // Perform the actual splitting.
   SplitNode(points, maxLeafSize, tau, rho);
 
+  // Store the lists of points of all the nodes in one block.
+  PackPoints(true);
+
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
 }
@@ -136,11 +156,30 @@ template<typename MetricType,
              class SplitType>
 SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 SpillTree(const SpillTree& other) :
+    SpillTree(other, other.parent)
+{
+  // Copy the lists of points into a pool of our own.
+  PackPoints(false);
+}
+
+/**
+ * Copy the given node and its descendants, sharing the lists of points of the
+ * other tree.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(const SpillTree& other, SpillTree* parent) :
     left(NULL),
     right(NULL),
-    parent(other.parent),
+    parent(parent),
     count(other.count),
-    pointsIndex(NULL),
+    pointsIndex(other.pointsIndex),
+    pointsPool(NULL),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(other.bound),
@@ -155,20 +194,10 @@ SpillTree(const SpillTree& other) :
 {
   // Create left and right children (if any).
   if (other.Left())
-  {
-    left = new SpillTree(*other.Left());
-    left->Parent() = this; // Set parent to this, not other tree.
-  }
+    left = new SpillTree(*other.Left(), this);
 
   if (other.Right())
-  {
-    right = new SpillTree(*other.Right());
-    right->Parent() = this; // Set parent to this, not other tree.
-  }
-
-  // If vector of indexes, copy it.
-  if (other.pointsIndex)
-    pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
+    right = new SpillTree(*other.Right(), this);
 
   // Propagate matrix, but only if we are the root.
   if (parent == NULL && localDataset)
@@ -208,69 +237,8 @@ operator=(const SpillTree& other)
   if (this == &other)
     return *this;
 
-  // Freeing memory that will not be used anymore.
-  if (localDataset)
-    delete dataset;
-
-  delete pointsIndex;
-  delete left;
-  delete right;
-
-  left = NULL;
-  right = NULL;
-  parent = other.parent;
-  count = other.count;
-  pointsIndex = NULL;
-  overlappingNode = other.overlappingNode;
-  hyperplane = other.hyperplane;
-  bound = other.bound;
-  stat = other.stat;
-  parentDistance = other.parentDistance;
-  furthestDescendantDistance = other.furthestDescendantDistance;
-
-  // Copy matrix, but only if we are the root and the other tree has its own
-  // copy of the dataset.
-  dataset = (other.parent == NULL && other.localDataset) ?
-      new MatType(*other.dataset) : other.dataset;
-  localDataset = other.parent == NULL && other.localDataset;
-
-  // Create left and right children (if any).
-  if (other.Left())
-  {
-    left = new SpillTree(*other.Left());
-    left->Parent() = this; // Set parent to this, not other tree.
-  }
-
-  if (other.Right())
-  {
-    right = new SpillTree(*other.Right());
-    right->Parent() = this; // Set parent to this, not other tree.
-  }
-
-  // If vector of indexes, copy it.
-  if (other.pointsIndex)
-    pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
-
-  // Propagate matrix, but only if we are the root.
-  if (parent == NULL && localDataset)
-  {
-    std::queue<SpillTree*> queue;
-    if (left)
-      queue.push(left);
-    if (right)
-      queue.push(right);
-    while (!queue.empty())
-    {
-      SpillTree* node = queue.front();
-      queue.pop();
-
-      node->dataset = dataset;
-      if (node->left)
-        queue.push(node->left);
-      if (node->right)
-        queue.push(node->right);
-    }
-  }
+  // Copy the other tree, and take ownership of the copy.
+  *this = SpillTree(other);
   return *this;
 }
 
@@ -290,6 +258,7 @@ SpillTree(SpillTree&& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(other.pointsIndex),
+    pointsPool(other.pointsPool),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(std::move(other.bound)),
@@ -306,6 +275,7 @@ SpillTree(SpillTree&& other) :
   other.right = NULL;
   other.count = 0;
   other.pointsIndex = NULL;
+  other.pointsPool = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
@@ -339,7 +309,7 @@ operator=(SpillTree&& other)
   if (localDataset)
     delete dataset;
 
-  delete pointsIndex;
+  delete pointsPool;
   delete left;
   delete right;
 
@@ -348,6 +318,7 @@ operator=(SpillTree&& other)
   parent = other.parent;
   count = other.count;
   pointsIndex = other.pointsIndex;
+  pointsPool = other.pointsPool;
   overlappingNode = other.overlappingNode;
   hyperplane = other.hyperplane;
   bound = std::move(other.bound);
@@ -364,6 +335,7 @@ operator=(SpillTree&& other)
   other.right = NULL;
   other.count = 0;
   other.pointsIndex = NULL;
+  other.pointsPool = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
@@ -416,7 +388,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 {
   delete left;
   delete right;
-  delete pointsIndex;
+  delete pointsPool;
 
   // If we're the root and we own the dataset, delete it.
   if (!parent && localDataset)
@@ -681,7 +653,7 @@ inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Descendant(const size_t index) const
 {
   if (IsLeaf() || overlappingNode)
-    return (*pointsIndex)[index];
+    return pointsIndex[index];
 
   // If this is not a leaf and not an overlapping node, then determine whether
   // we should get the descendant from the left or the right node.
@@ -705,7 +677,7 @@ inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Point(const size_t index) const
 {
   if (IsLeaf())
-    return (*pointsIndex)[index];
+    return pointsIndex[index];
   // This should never happen.
   return (size_t() - 1);
 }
@@ -721,6 +693,150 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
               const size_t maxLeafSize,
               const double tau,
               const double rho)
+{
+  arma::Col<size_t> leftPoints, rightPoints;
+  if (!ExpandNode(points, maxLeafSize, tau, rho, leftPoints, rightPoints))
+    return; // We can't split this.
+
+  // Now we will recursively split the children.
+  left->SplitNode(leftPoints, maxLeafSize, tau, rho);
+  left->stat = StatisticType(*left);
+  right->SplitNode(rightPoints, maxLeafSize, tau, rho);
+  right->stat = StatisticType(*right);
+
+  // Calculate parent distances for those two nodes.
+  SetChildParentDistances();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(SpillTree* parent, const size_t count) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    count(count),
+    pointsIndex(NULL),
+    pointsPool(NULL),
+    overlappingNode(false),
+    hyperplane(),
+    bound(parent->Dataset().n_rows),
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    localDataset(false)
+{
+  // Nothing to do; the caller splits this node.
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildInParallel() const
+{
+#ifdef HAS_OPENMP
+  // The splits of the non-axis-orthogonal trees start from a point chosen with
+  // rand(), so those trees would not be the same as the ones built serially.
+  const bool canBuildInParallel = std::is_same<HyperplaneType<MetricType>,
+      AxisOrthogonalHyperplane<MetricType>>::value;
+
+  return canBuildInParallel && count >= parallelBuildMinPoints &&
+      omp_get_max_threads() > 1 && !omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    ParallelSplitNode(arma::Col<size_t>& points,
+                      const size_t maxLeafSize,
+                      const double tau,
+                      const double rho)
+{
+#ifdef HAS_OPENMP
+  const size_t minSubtrees = 4 * omp_get_max_threads();
+#else
+  const size_t minSubtrees = 1;
+#endif
+
+  // Build the top levels of the tree in breadth-first order, one node at a
+  // time, until there are enough subtrees left to build.  The points of each
+  // subtree are kept until it is built.
+  std::vector<SpillTree*> expanded;
+  std::deque<SpillTree*> subtrees;
+  std::deque<arma::Col<size_t>> subtreePoints;
+  subtrees.push_back(this);
+  subtreePoints.push_back(arma::Col<size_t>());
+  subtreePoints.back().swap(points);
+  while (!subtrees.empty() && subtrees.size() < minSubtrees)
+  {
+    SpillTree* node = subtrees.front();
+    arma::Col<size_t> nodePoints;
+    nodePoints.swap(subtreePoints.front());
+    subtrees.pop_front();
+    subtreePoints.pop_front();
+    expanded.push_back(node);
+
+    arma::Col<size_t> leftPoints, rightPoints;
+    if (node->ExpandNode(nodePoints, maxLeafSize, tau, rho, leftPoints,
+        rightPoints))
+    {
+      subtrees.push_back(node->left);
+      subtreePoints.push_back(arma::Col<size_t>());
+      subtreePoints.back().swap(leftPoints);
+      subtrees.push_back(node->right);
+      subtreePoints.push_back(arma::Col<size_t>());
+      subtreePoints.back().swap(rightPoints);
+    }
+  }
+
+  // The remaining subtrees only read the dataset and their own lists of points
+  // (even if those overlap), so they can be built concurrently.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    SpillTree* node = subtrees[i];
+    node->SplitNode(subtreePoints[i], maxLeafSize, tau, rho);
+    node->stat = StatisticType(*node);
+  }
+
+  // Now finish the top levels of the tree from the bottom up.  The statistic
+  // of the root is created by the constructor.
+  for (size_t i = expanded.size(); i > 0; --i)
+  {
+    SpillTree* node = expanded[i - 1];
+    if (node->left)
+      node->SetChildParentDistances();
+    if (node != this)
+      node->stat = StatisticType(*node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    ExpandNode(arma::Col<size_t>& points,
+               const size_t maxLeafSize,
+               const double tau,
+               const double rho,
+               arma::Col<size_t>& leftPoints,
+               arma::Col<size_t>& rightPoints)
 {
   // We need to expand the bounds of this node properly.
   for (size_t i = 0; i < points.n_elem; ++i)
@@ -732,9 +848,8 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   // Now, check if we need to split at all.
   if (points.n_elem <= maxLeafSize)
   {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
-    return; // We can't split this.
+    StorePoints(points);
+    return false; // We can't split this.
   }
 
   const bool split = SplitType<MetricType, MatType>::SplitSpace(bound,
@@ -743,12 +858,10 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   // same, we can't split them.
   if (!split)
   {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
-    return; // We can't split this.
+    StorePoints(points);
+    return false; // We can't split this.
   }
 
-  arma::Col<size_t> leftPoints, rightPoints;
   // Split the node.
   overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
 
@@ -756,8 +869,7 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   {
     // If the node is overlapping, we have to keep track of which points are
     // held in the node.
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
+    StorePoints(points);
   }
   else
   {
@@ -765,12 +877,37 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     arma::Col<size_t>().swap(points);
   }
 
-  // Now we will recursively split the children by calling their constructors
-  // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  // Create the children, but leave the splitting of the children to the
+  // caller.
+  left = new SpillTree(this, leftPoints.n_elem);
+  right = new SpillTree(this, rightPoints.n_elem);
 
-  // Calculate parent distances for those two nodes.
+  return true;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    StorePoints(arma::Col<size_t>& points)
+{
+  pointsIndex = new size_t[points.n_elem];
+  std::copy(points.begin(), points.end(), pointsIndex);
+  arma::Col<size_t>().swap(points);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SetChildParentDistances()
+{
   arma::vec center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
@@ -784,6 +921,61 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    PackPoints(const bool ownsLists)
+{
+  // Only leaves and overlapping nodes hold a list of points; first count the
+  // points held in those lists.
+  size_t totalPoints = 0;
+  std::stack<SpillTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.top();
+    stack.pop();
+
+    if (node->IsLeaf() || node->overlappingNode)
+      totalPoints += node->count;
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+
+  // Now copy the lists into the pool, in depth-first order, so that the points
+  // of each subtree are stored contiguously.
+  pointsPool = new arma::Col<size_t>(totalPoints);
+  size_t offset = 0;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    SpillTree* node = stack.top();
+    stack.pop();
+
+    if (node->IsLeaf() || node->overlappingNode)
+    {
+      size_t* nodePoints = pointsPool->memptr() + offset;
+      std::copy(node->pointsIndex, node->pointsIndex + node->count,
+          nodePoints);
+      if (ownsLists)
+        delete[] node->pointsIndex;
+
+      node->pointsIndex = nodePoints;
+      offset += node->count;
+    }
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -883,6 +1075,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsPool(NULL),
     overlappingNode(false),
     stat(*this),
     parentDistance(0),
@@ -904,7 +1097,7 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
-    serialize(Archive& ar, const uint32_t /* version */)
+    serialize(Archive& ar, const uint32_t version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
@@ -915,18 +1108,194 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       delete right;
     if (!parent && localDataset)
       delete dataset;
+    delete pointsPool;
 
     parent = NULL;
     left = NULL;
     right = NULL;
+    pointsIndex = NULL;
+    pointsPool = NULL;
+  }
+
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    SerializeRecursive(ar);
+    return;
+  }
+
+  // The nodes of the subtree are stored as arrays that hold one element for
+  // each node, in breadth-first order, so that neither saving nor loading
+  // recurses; the children of each node are the next unclaimed nodes.  The
+  // lists of points of the leaves and overlapping nodes are concatenated.
+  std::vector<SpillTree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (nodes[i]->left)
+        nodes.push_back(nodes[i]->left);
+      if (nodes[i]->right)
+        nodes.push_back(nodes[i]->right);
+    }
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  // The members of arithmetic types are written in one block each.
+  std::vector<size_t> counts(numNodes), numChildren(numNodes);
+  std::vector<char> overlappingNodes(numNodes);
+  std::vector<ElemType> parentDistances(numNodes),
+      furthestDescendantDistances(numNodes);
+  arma::Col<size_t> points;
+  if (cereal::is_saving<Archive>())
+  {
+    size_t totalPoints = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      counts[i] = nodes[i]->count;
+      numChildren[i] = nodes[i]->NumChildren();
+      overlappingNodes[i] = nodes[i]->overlappingNode;
+      parentDistances[i] = nodes[i]->parentDistance;
+      furthestDescendantDistances[i] = nodes[i]->furthestDescendantDistance;
+      if (nodes[i]->IsLeaf() || nodes[i]->overlappingNode)
+        totalPoints += nodes[i]->count;
+    }
+
+    points.set_size(totalPoints);
+    size_t offset = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      if (nodes[i]->IsLeaf() || nodes[i]->overlappingNode)
+      {
+        std::copy(nodes[i]->pointsIndex, nodes[i]->pointsIndex +
+            nodes[i]->count, points.memptr() + offset);
+        offset += nodes[i]->count;
+      }
+    }
+  }
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(overlappingNodes));
+  ar(CEREAL_NVP(parentDistances));
+  ar(CEREAL_NVP(furthestDescendantDistances));
+  ar(CEREAL_NVP(points));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+      throw std::runtime_error("SpillTree::serialize(): the archive holds no "
+          "nodes!");
+
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    for (size_t i = 1; i < numNodes; ++i)
+      nodes[i] = new SpillTree();
+
+    size_t nextChild = 1;
+    size_t offset = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      SpillTree* node = nodes[i];
+      const bool hasPoints = (numChildren[i] == 0 || overlappingNodes[i]);
+      if (numChildren[i] > 2 || nextChild + numChildren[i] > numNodes ||
+          (hasPoints && offset + counts[i] > points.n_elem))
+      {
+        // Free the nodes that weren't attached yet.
+        for (size_t j = nextChild; j < numNodes; ++j)
+          delete nodes[j];
+        throw std::runtime_error("SpillTree::serialize(): the archive holds "
+            "an invalid tree!");
+      }
+
+      if (numChildren[i] >= 1)
+      {
+        node->left = nodes[nextChild++];
+        node->left->parent = node;
+      }
+      if (numChildren[i] == 2)
+      {
+        node->right = nodes[nextChild++];
+        node->right->parent = node;
+      }
+
+      node->count = counts[i];
+      node->overlappingNode = overlappingNodes[i];
+      node->parentDistance = parentDistances[i];
+      node->furthestDescendantDistance = furthestDescendantDistances[i];
+      if (hasPoints)
+      {
+        // Keep the list until it is moved to the pool below.
+        arma::Col<size_t> nodePoints(points.memptr() + offset, counts[i]);
+        node->StorePoints(nodePoints);
+        offset += counts[i];
+      }
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    ar(cereal::make_nvp("hyperplane", nodes[i]->hyperplane));
+    ar(cereal::make_nvp("bound", nodes[i]->bound));
+    ar(cereal::make_nvp("stat", nodes[i]->stat));
+  }
+
+  bool hasParent = (parent != NULL);
+  ar(CEREAL_NVP(hasParent));
+  if (!hasParent)
+  {
+    // Force a non-const pointer.
+    MatType*& datasetPtr = const_cast<MatType*&>(dataset);
+    ar(CEREAL_POINTER(datasetPtr));
   }
 
+  if (cereal::is_loading<Archive>())
+  {
+    localDataset = true;
+    for (size_t i = 1; i < numNodes; ++i)
+    {
+      nodes[i]->dataset = dataset;
+      nodes[i]->localDataset = false;
+    }
+
+    PackPoints(true);
+  }
+}
+
+/**
+ * Serialize this node and, through pointers, its children, like archives of
+ * version 0 store the tree.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+template<typename Archive>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SerializeRecursive(Archive& ar)
+{
   if (cereal::is_loading<Archive>())
   {
     localDataset = true;
   }
   ar(CEREAL_NVP(count));
-  ar(CEREAL_POINTER(pointsIndex));
+
+  // The list of points of the node is serialized as a vector of its own.
+  arma::Col<size_t>* nodePoints = NULL;
+  if (!cereal::is_loading<Archive>() && (IsLeaf() || overlappingNode))
+    nodePoints = new arma::Col<size_t>(pointsIndex, count);
+  ar(CEREAL_POINTER(nodePoints));
+  if (cereal::is_loading<Archive>() && nodePoints)
+  {
+    // Keep the list until the root moves it to its pool.
+    StorePoints(*nodePoints);
+  }
+  delete nodePoints;
+
   ar(CEREAL_NVP(overlappingNode));
   ar(CEREAL_NVP(hyperplane));
   ar(CEREAL_NVP(bound));
@@ -966,9 +1335,13 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     }
   }
 
-  // If we are the root, we need to restore the dataset pointer throughout
+  // If we are the root, we need to restore the dataset pointer throughout, and
+  // store the lists of points that were loaded in one block.
   if (!hasParent)
   {
+    if (cereal::is_loading<Archive>())
+      PackPoints(true);
+
     std::stack<SpillTree*> stack;
     if (left)
       stack.push(left);
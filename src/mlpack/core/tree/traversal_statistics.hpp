@@ -0,0 +1,173 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * The TraversalStatistics class, which collects the number of base cases,
+ * scores, prunes and visited nodes of tree traversals.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace tree {
+
+//! Check whether a traverser counts the node combinations it visits.
+HAS_MEM_FUNC(NumVisited, HasNumVisitedCheck);
+
+/**
+ * The TraversalStatistics class holds the work done by one or more tree
+ * traversals: the number of base cases and of Score() calls made by the rules,
+ * and the number of prunes and of visited nodes (or node combinations, for
+ * dual-tree traversals) of the traversers.  The tree-based algorithms (such as
+ * NeighborSearch, RangeSearch, KDE, FastMKS, DualTreeBoruvka and
+ * DualTreeKMeans) hold the statistics of their last search in an object of
+ * this class, which they print to Log::Info, and which can be used to compare
+ * leaf sizes and tree types.
+ *
+ * When a traversal is split between threads, each thread collects its own
+ * statistics, and they are summed with operator+=().
+ *
+ * @code
+ * TraversalStatistics statistics;
+ * statistics.Add(rules, traverser);
+ * Log::Info << statistics << std::endl;
+ * @endcode
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create empty statistics.
+  TraversalStatistics() :
+      baseCases(0),
+      scores(0),
+      prunes(0),
+      visited(0)
+  { }
+
+  /**
+   * Add the work done by the given rules and the given traverser, which ran
+   * one or more traversals with the rules.  The base cases and the scores are
+   * counted by the rules, and the prunes and the visited nodes by the
+   * traverser.  Single-tree traversers don't count visited nodes: each node
+   * scored and not pruned is visited.
+   *
+   * @param rules The rules of the traversals.
+   * @param traverser The traverser that used the rules.
+   */
+  template<typename RuleType, typename TraverserType>
+  void Add(const RuleType& rules, const TraverserType& traverser)
+  {
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    prunes += traverser.NumPrunes();
+    visited += Visited(rules, traverser);
+  }
+
+  /**
+   * Add the work done by the given rules, when no traverser is available (for
+   * instance if the traverser was created by another class).
+   *
+   * @param rules The rules of the traversals.
+   */
+  template<typename RuleType>
+  void Add(const RuleType& rules)
+  {
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+
+  //! Add the given statistics to these statistics.
+  TraversalStatistics& operator+=(const TraversalStatistics& other)
+  {
+    baseCases += other.baseCases;
+    scores += other.scores;
+    prunes += other.prunes;
+    visited += other.visited;
+    return *this;
+  }
+
+  //! Set all the counts to zero.
+  void Reset() { *this = TraversalStatistics(); }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of Score() calls.
+  size_t Scores() const { return scores; }
+  //! Modify the number of Score() calls.
+  size_t& Scores() { return scores; }
+
+  //! Get the number of prunes.
+  size_t Prunes() const { return prunes; }
+  //! Modify the number of prunes.
+  size_t& Prunes() { return prunes; }
+
+  //! Get the number of visited nodes (or node combinations).
+  size_t Visited() const { return visited; }
+  //! Modify the number of visited nodes (or node combinations).
+  size_t& Visited() { return visited; }
+
+  //! Get the ratio of the scores that resulted in a prune.
+  double PruneRatio() const
+  {
+    return (scores == 0) ? 0.0 : double(prunes) / double(scores);
+  }
+
+  //! Print the statistics to the given stream.
+  friend std::ostream& operator<<(std::ostream& stream,
+                                  const TraversalStatistics& statistics)
+  {
+    stream << statistics.baseCases << " base cases, " << statistics.scores
+        << " scores, " << statistics.prunes << " prunes ("
+        << 100.0 * statistics.PruneRatio() << "% of scores), "
+        << statistics.visited << " visited nodes";
+    return stream;
+  }
+
+ private:
+  //! Get the number of visited nodes of a traverser that counts them.
+  template<typename RuleType, typename TraverserType>
+  static size_t Visited(
+      const RuleType& /* rules */,
+      const TraverserType& traverser,
+      const typename std::enable_if<HasNumVisitedCheck<TraverserType,
+          size_t(TraverserType::*)() const>::value>::type* = 0)
+  {
+    return traverser.NumVisited();
+  }
+
+  //! Get the number of visited nodes of a traverser that doesn't count them.
+  template<typename RuleType, typename TraverserType>
+  static size_t Visited(
+      const RuleType& rules,
+      const TraverserType& traverser,
+      const typename std::enable_if<!HasNumVisitedCheck<TraverserType,
+          size_t(TraverserType::*)() const>::value>::type* = 0)
+  {
+    return (rules.Scores() > traverser.NumPrunes()) ?
+        rules.Scores() - traverser.NumPrunes() : 0;
+  }
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of Score() calls.
+  size_t scores;
+  //! The number of prunes.
+  size_t prunes;
+  //! The number of visited nodes (or node combinations).
+  size_t visited;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
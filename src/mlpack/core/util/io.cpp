@@ -210,7 +210,18 @@ void IO::RestoreSettings(const std::string& name, const bool fatal)
   {
     GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
     GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+
+    // The function mappings are kept by ClearSettings(), so only the types
+    // that haven't been seen yet are added; this avoids a copy of the whole map
+    // each time a binding is called.
+    const FunctionMapType& functions =
+        std::get<2>(GetSingleton().storageMap[name]);
+    for (FunctionMapType::const_iterator it = functions.begin();
+         it != functions.end(); ++it)
+    {
+      if (GetSingleton().functionMap.count(it->first) == 0)
+        GetSingleton().functionMap.insert(*it);
+    }
   }
 }
 
@@ -220,11 +231,6 @@ void IO::ClearSettings()
   // Check for any parameters we need to keep.
   std::map<std::string, util::ParamData> persistent;
   std::map<char, std::string> persistentAliases;
-  FunctionMapType persistentFunctions;
-
-  // For the function mappings we have to preserve, we have to collect the
-  // types.
-  std::vector<std::string> persistentTypes;
 
   std::map<std::string, util::ParamData>::const_iterator it =
       GetSingleton().parameters.begin();
@@ -232,13 +238,7 @@ void IO::ClearSettings()
   {
     // Is the parameter persistent?
     if (it->second.persistent)
-    {
       persistent[it->first] = it->second; // Save the parameter.
-      // Add to the list of types, if it hasn't already been added.
-      if (std::find(persistentTypes.begin(), persistentTypes.end(),
-          it->second.tname) == persistentTypes.end())
-        persistentTypes.push_back(it->second.tname);
-    }
 
     ++it;
   }
@@ -255,17 +255,10 @@ void IO::ClearSettings()
     ++it2;
   }
 
-  for (size_t i = 0; i < persistentTypes.size(); ++i)
-  {
-    // Add to persistent function map.
-    persistentFunctions[persistentTypes[i]] =
-        GetSingleton().functionMap[persistentTypes[i]];
-  }
-
-  // Save only the persistent parameters.
+  // Save only the persistent parameters.  The function mappings only depend
+  // on the type of each parameter, so they are all kept.
   GetSingleton().parameters = persistent;
   GetSingleton().aliases = persistentAliases;
-  GetSingleton().functionMap = persistentFunctions;
 }
 
 void IO::CheckInputMatrices()
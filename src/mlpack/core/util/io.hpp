@@ -290,7 +290,10 @@ class IO
   static void RestoreSettings(const std::string& name, const bool fatal = true);
 
   /**
-   * Clear all of the settings, removing all parameters and function mappings.
+   * Clear all of the settings, removing all parameters.  The function mappings
+   * are kept, since they only depend on the types of the parameters; so
+   * calling a binding again (RestoreSettings(), then ClearSettings()) doesn't
+   * copy them.
    */
   static void ClearSettings();
 
@@ -328,6 +331,10 @@ class IO
   //! Holds the timer objects.
   Timers timer;
 
+  //! Held by the Python bindings while they run, since all the bindings of a
+  //! process share the parameters.
+  std::mutex bindingMutex;
+
   //! So that Timer::Start() and Timer::Stop() can access the timer variable.
   friend class Timer;
 
@@ -91,6 +91,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -104,7 +105,11 @@ int main(int argc, char** argv)
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
-  mlpackMain();
+  // In the serving mode, the program is run once for each batch of requests.
+  if (mlpack::IO::HasParam("serve_input"))
+    mlpack::bindings::cli::Serve(&mlpackMain);
+  else
+    mlpackMain();
 
   // Print output options, print verbose information, save model parameters,
   // clean up, and so forth.
@@ -232,6 +237,8 @@ PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     "slow down the code.", "");
 PARAM_FLAG("check_input_matrices", "If specified, the input matrix is checked for"
     " NaN and inf values; an exception is thrown if any are found.", "");
+PARAM_INT_IN("num_threads", "Number of OpenMP threads used by the method, if "
+    "it is parallelized; 0 uses the default number of threads.", "", 0);
 
 // Nothing else needs to be defined---the binding will use mlpackMain() as-is.
 
@@ -487,6 +494,8 @@ PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
     " copied before the method is run.  This is useful for debugging problems "
     "where the input parameters are being modified by the algorithm, but can "
     "slow down the code.", "");
+PARAM_INT_IN("num_threads", "Number of OpenMP threads used by the method, if "
+    "it is parallelized; 0 uses the default number of threads.", "", 0);
 
 #else
 
@@ -0,0 +1,51 @@
+/**
+ * @file core/util/parallel.cpp
+ *
+ * Implementation of the functions that configure the number of threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "parallel.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace util {
+
+size_t NumThreads()
+{
+  #ifdef HAS_OPENMP
+    return (size_t) omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+}
+
+size_t DefaultNumThreads()
+{
+  // This is computed once, before any call to SetNumThreads() changes it.
+  static const size_t defaultNumThreads = NumThreads();
+  return defaultNumThreads;
+}
+
+void SetNumThreads(const size_t numThreads)
+{
+  // Make sure the default is known before it is changed.
+  const size_t defaultNumThreads = DefaultNumThreads();
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads((int) (numThreads == 0 ? defaultNumThreads :
+        numThreads));
+  #else
+    (void) numThreads;
+    (void) defaultNumThreads;
+  #endif
+}
+
+} // namespace util
+} // namespace mlpack
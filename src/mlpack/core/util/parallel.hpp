@@ -0,0 +1,80 @@
+/**
+ * @file core/util/parallel.hpp
+ *
+ * Functions to configure the number of threads used by the parallel parts of
+ * mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_HPP
+
+#include <cstddef>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The parallel parts of mlpack are OpenMP regions, and they all run on the
+ * thread pool of the OpenMP runtime; these functions are the one place where
+ * the size of that pool is set, so that several mlpack jobs can share a host
+ * without oversubscribing it.  The irregular loops already use dynamic
+ * schedules or tasks, which the runtime balances across the threads.  The
+ * placement of the threads on cores and NUMA nodes is that of the runtime,
+ * and is set with the standard OMP_PROC_BIND and OMP_PLACES environment
+ * variables (for instance OMP_PROC_BIND=close OMP_PLACES=cores).
+ *
+ * Like omp_set_num_threads(), the number of threads applies to the parallel
+ * regions started by the calling thread.  If mlpack is compiled without
+ * OpenMP, there is always one thread.
+ */
+
+//! Get the number of threads that the parallel regions started by the calling
+//! thread use.
+size_t NumThreads();
+
+//! Get the default number of threads, that is, the number of threads of the
+//! OpenMP runtime when mlpack first asked for it.
+size_t DefaultNumThreads();
+
+/**
+ * Set the number of threads that the parallel regions started by the calling
+ * thread use.
+ *
+ * @param numThreads Number of threads; 0 restores the default number.
+ */
+void SetNumThreads(const size_t numThreads);
+
+/**
+ * Set the number of threads of the calling thread for the lifetime of the
+ * object, and restore the previous number when it is destroyed.
+ */
+class ScopedNumThreads
+{
+ public:
+  /**
+   * Set the number of threads of the calling thread.
+   *
+   * @param numThreads Number of threads; 0 keeps the current number.
+   */
+  ScopedNumThreads(const size_t numThreads) : oldNumThreads(NumThreads())
+  {
+    if (numThreads > 0)
+      SetNumThreads(numThreads);
+  }
+
+  //! Restore the previous number of threads.
+  ~ScopedNumThreads() { SetNumThreads(oldNumThreads); }
+
+ private:
+  //! The number of threads before the object was created.
+  size_t oldNumThreads;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file core/util/profile_timers.hpp
+ *
+ * Lock-free timers for the hot paths of mlpack (tree building, tree traversal,
+ * optimizer steps, neural network passes), where the named timers of Timer are
+ * too expensive.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PROFILE_TIMERS_HPP
+#define MLPACK_CORE_UTIL_PROFILE_TIMERS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mlpack {
+
+/**
+ * The profile timers.  Each of them is identified at compile time, so no
+ * lookup by name is done when a timer is used.
+ */
+enum class ProfileTimerID : size_t
+{
+  //! Building a tree (BinarySpaceTree::SplitNode()).
+  TREE_BUILD,
+  //! Base cases of tree traversals (NeighborSearchRules::BaseCase()).
+  TREE_BASE_CASE,
+  //! Node scores of tree traversals (NeighborSearchRules::Score()).
+  TREE_SCORE,
+  //! Optimizer steps, measured by the ProfileOptimizerSteps callback.
+  OPTIMIZER_STEP,
+  //! Forward passes of FFN.
+  FFN_FORWARD,
+  //! Backward passes of FFN (the errors and the gradients).
+  FFN_BACKWARD,
+  //! The number of profile timers; not a timer.
+  NUM_TIMERS
+};
+
+/**
+ * The profile timers are a low-overhead alternative to Timer, meant to be used
+ * in code that runs millions of times.  Each thread accumulates the time spent
+ * in, and the number of calls to, each timer in its own counters, so no lock
+ * is taken and no memory is shared between threads while timing; the counters
+ * of all the threads are only summed when Get() or Calls() is called.
+ *
+ * The timers are only compiled in if MLPACK_PROFILE_TIMERS is defined (with
+ * the PROFILE_TIMERS CMake option, or before including mlpack); otherwise
+ * MLPACK_PROFILE_SCOPE() expands to nothing.  When they are compiled in, they
+ * still do nothing but check a flag until Enable() is called.
+ *
+ * @code
+ * ProfileTimers::Enable();
+ * KNN knn(referenceSet);
+ * knn.Search(k, neighbors, distances);
+ * std::cout << ProfileTimers::Get(ProfileTimerID::TREE_BASE_CASE).count()
+ *     << "ns in " << ProfileTimers::Calls(ProfileTimerID::TREE_BASE_CASE)
+ *     << " base cases." << std::endl;
+ * @endcode
+ *
+ * The time of a timer is summed over the threads that use it, so with
+ * multiple threads it can be greater than the elapsed time.  A timer that is
+ * entered again (recursively) by a thread that is already in it is counted as
+ * a call, but its time is not counted twice.  Reset() should not be called
+ * while timers are running.
+ */
+class ProfileTimers
+{
+ public:
+  //! The number of profile timers.
+  static constexpr size_t NumTimers = (size_t) ProfileTimerID::NUM_TIMERS;
+
+  //! The counters of one thread.
+  struct ThreadCounters
+  {
+    //! The accumulated time of each timer, in nanoseconds.
+    std::atomic<uint64_t> time[NumTimers];
+    //! The number of calls to each timer.
+    std::atomic<uint64_t> calls[NumTimers];
+    //! How many times each timer is currently entered by the thread.
+    size_t depth[NumTimers];
+    //! The counters of the next thread.
+    ThreadCounters* next;
+  };
+
+  //! Start timing.
+  static void Enable() { EnabledFlag().store(true); }
+
+  //! Stop timing; the accumulated times are kept.
+  static void Disable() { EnabledFlag().store(false); }
+
+  //! Get whether timing is enabled.
+  static bool Enabled()
+  {
+    return EnabledFlag().load(std::memory_order_relaxed);
+  }
+
+  //! Get the name of the given timer.
+  static const char* Name(const ProfileTimerID id)
+  {
+    static const char* names[NumTimers] = { "tree_build", "tree_base_case",
+        "tree_score", "optimizer_step", "ffn_forward", "ffn_backward" };
+    return names[(size_t) id];
+  }
+
+  //! Get the time spent in the given timer, summed over all threads.
+  static std::chrono::nanoseconds Get(const ProfileTimerID id)
+  {
+    uint64_t total = 0;
+    for (ThreadCounters* c = Head().load(); c != NULL; c = c->next)
+      total += c->time[(size_t) id].load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds(total);
+  }
+
+  //! Get the number of calls to the given timer, summed over all threads.
+  static uint64_t Calls(const ProfileTimerID id)
+  {
+    uint64_t total = 0;
+    for (ThreadCounters* c = Head().load(); c != NULL; c = c->next)
+      total += c->calls[(size_t) id].load(std::memory_order_relaxed);
+    return total;
+  }
+
+  //! Set the time and the number of calls of every timer to zero.
+  static void Reset()
+  {
+    for (ThreadCounters* c = Head().load(); c != NULL; c = c->next)
+    {
+      for (size_t i = 0; i < NumTimers; ++i)
+      {
+        c->time[i].store(0, std::memory_order_relaxed);
+        c->calls[i].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Add the given time to the given timer, in the counters of this thread.
+   *
+   * @param id The timer.
+   * @param time The time to add.
+   */
+  static void Add(const ProfileTimerID id, const std::chrono::nanoseconds time)
+  {
+    ThreadCounters& counters = Local();
+    counters.time[(size_t) id].fetch_add(time.count(),
+        std::memory_order_relaxed);
+    counters.calls[(size_t) id].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Get the counters of this thread.  They are created the first time a
+   * thread uses a timer, and are never freed, so that the time of threads
+   * that have exited is still counted (a thread pool, like the one of
+   * OpenMP, only creates a few of them).
+   */
+  static ThreadCounters& Local()
+  {
+    static thread_local ThreadCounters* local = NULL;
+    if (local == NULL)
+    {
+      local = new ThreadCounters();
+      for (size_t i = 0; i < NumTimers; ++i)
+      {
+        local->time[i].store(0, std::memory_order_relaxed);
+        local->calls[i].store(0, std::memory_order_relaxed);
+        local->depth[i] = 0;
+      }
+
+      // Push the counters to the list of all counters, without a lock.
+      local->next = Head().load();
+      while (!Head().compare_exchange_weak(local->next, local)) { }
+    }
+
+    return *local;
+  }
+
+ private:
+  //! Get the list of the counters of all threads.
+  static std::atomic<ThreadCounters*>& Head()
+  {
+    static std::atomic<ThreadCounters*> head(NULL);
+    return head;
+  }
+
+  //! Get the flag that tells whether timing is enabled.
+  static std::atomic<bool>& EnabledFlag()
+  {
+    static std::atomic<bool> enabled(false);
+    return enabled;
+  }
+};
+
+/**
+ * Time the scope it is declared in with the given profile timer; use
+ * MLPACK_PROFILE_SCOPE() instead, so that it is only compiled in with
+ * MLPACK_PROFILE_TIMERS.
+ */
+class ScopedProfileTimer
+{
+ public:
+  //! Start the given timer, if timing is enabled.
+  explicit ScopedProfileTimer(const ProfileTimerID id) :
+      counters(NULL),
+      index((size_t) id)
+  {
+    if (!ProfileTimers::Enabled())
+      return;
+
+    counters = &ProfileTimers::Local();
+    counters->calls[index].fetch_add(1, std::memory_order_relaxed);
+    if (counters->depth[index]++ == 0)
+      start = std::chrono::steady_clock::now();
+  }
+
+  //! Stop the timer and add its time to the counters of this thread.
+  ~ScopedProfileTimer()
+  {
+    if (counters == NULL || --counters->depth[index] > 0)
+      return;
+
+    const std::chrono::nanoseconds time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    counters->time[index].fetch_add(time.count(), std::memory_order_relaxed);
+  }
+
+ private:
+  //! The counters of this thread, or NULL if timing was disabled.
+  ProfileTimers::ThreadCounters* counters;
+  //! The index of the timer.
+  size_t index;
+  //! The time the timer was started.
+  std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * An ensmallen callback that adds the time of each step of the optimizer (from
+ * the beginning of the optimization or the previous step) to the
+ * OPTIMIZER_STEP profile timer.  FFN::Train() uses it when
+ * MLPACK_PROFILE_TIMERS is defined; it can be given to any optimizer that
+ * takes callbacks.
+ */
+class ProfileOptimizerSteps
+{
+ public:
+  //! Start timing the first step.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    last = std::chrono::steady_clock::now();
+  }
+
+  //! Add the time of the step that was taken, and start timing the next one.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    if (ProfileTimers::Enabled())
+    {
+      ProfileTimers::Add(ProfileTimerID::OPTIMIZER_STEP,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(now - last));
+    }
+    last = now;
+  }
+
+ private:
+  //! The time the current step was started.
+  std::chrono::steady_clock::time_point last;
+};
+
+} // namespace mlpack
+
+#define MLPACK_PROFILE_CONCAT_INNER(a, b) a ## b
+#define MLPACK_PROFILE_CONCAT(a, b) MLPACK_PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * Time the rest of the enclosing scope with the given profile timer, for
+ * instance MLPACK_PROFILE_SCOPE(TREE_BUILD);.  This expands to nothing unless
+ * MLPACK_PROFILE_TIMERS is defined.
+ */
+#ifdef MLPACK_PROFILE_TIMERS
+  #define MLPACK_PROFILE_SCOPE(id) \
+      mlpack::ScopedProfileTimer MLPACK_PROFILE_CONCAT(mlpackProfileScope, \
+          __LINE__)(mlpack::ProfileTimerID::id)
+#else
+  #define MLPACK_PROFILE_SCOPE(id) ((void) 0)
+#endif
+
+#endif
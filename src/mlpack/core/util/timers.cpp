@@ -15,6 +15,7 @@
 #include "io.hpp"
 #include "log.hpp"
 
+#include <fstream>
 #include <map>
 #include <string>
 
@@ -64,12 +65,40 @@ void Timer::ResetAll()
   IO::GetSingleton().timer.Reset();
 }
 
+// Start recording trace events.
+void Timer::EnableTracing()
+{
+  IO::GetSingleton().timer.Tracing() = true;
+}
+
+// Stop recording trace events.
+void Timer::DisableTracing()
+{
+  IO::GetSingleton().timer.Tracing() = false;
+}
+
+// Save the trace events to a file.
+void Timer::SaveTrace(const string& filename)
+{
+  ofstream stream(filename);
+  if (!stream.is_open())
+  {
+    ostringstream error;
+    error << "Timer::SaveTrace(): cannot open file '" << filename
+        << "' for writing";
+    throw runtime_error(error.str());
+  }
+
+  IO::GetSingleton().timer.WriteTrace(stream);
+}
+
 // Reset a Timers object.
 void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
   timerStartTime.clear();
+  traceEvents.clear();
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -165,8 +194,14 @@ void Timers::StopAllTimers()
 
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
   for (auto it : timerStartTime)
+  {
     for (auto it2 : it.second)
+    {
       timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+      if (tracing)
+        traceEvents.push_back({ it2.first, it.first, it2.second, currTime });
+    }
+  }
 
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
@@ -225,8 +260,61 @@ void Timers::StopTimer(const string& timerName,
   timers[timerName] += duration_cast<microseconds>(currTime -
       timerStartTime[threadId][timerName]);
 
+  if (tracing)
+  {
+    traceEvents.push_back({ timerName, threadId,
+        timerStartTime[threadId][timerName], currTime });
+  }
+
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
   if (timerStartTime[threadId].empty())
     timerStartTime.erase(threadId);
 }
+
+size_t Timers::NumTraceEvents()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return traceEvents.size();
+}
+
+void Timers::WriteTrace(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  // Timestamps are in microseconds since the first event started.
+  high_resolution_clock::time_point origin = high_resolution_clock::now();
+  for (const TraceEvent& event : traceEvents)
+    origin = min(origin, event.start);
+
+  map<thread::id, size_t> threadIndices;
+  stream << "{\"traceEvents\": [";
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    const TraceEvent& event = traceEvents[i];
+    if (threadIndices.count(event.threadId) == 0)
+    {
+      const size_t index = threadIndices.size();
+      threadIndices[event.threadId] = index;
+    }
+
+    // Timer names don't usually need escaping, but make sure the JSON is
+    // valid.
+    string name;
+    for (const char c : event.name)
+    {
+      if (c == '"' || c == '\\')
+        name += '\\';
+      if ((unsigned char) c >= 0x20)
+        name += c;
+    }
+
+    stream << (i == 0 ? "" : ",") << endl << "  {\"name\": \"" << name
+        << "\", \"cat\": \"mlpack\", \"ph\": \"X\", \"ts\": "
+        << duration_cast<microseconds>(event.start - origin).count()
+        << ", \"dur\": "
+        << duration_cast<microseconds>(event.stop - event.start).count()
+        << ", \"pid\": 0, \"tid\": " << threadIndices[event.threadId] << "}";
+  }
+  stream << endl << "], \"displayTimeUnit\": \"ms\"}" << endl;
+}
@@ -20,8 +20,10 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <ostream>
 #include <string>
 #include <thread> // std::thread is used for thread safety.
+#include <vector>
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -93,13 +95,38 @@ class Timer
    * existing timers.
    */
   static void ResetAll();
+
+  /**
+   * Start recording a trace of the timers: each time a timer is stopped, an
+   * event holding its name, its thread, and the time it was started and
+   * stopped at is recorded.  Timing must also be enabled.  Do not run this
+   * while timers are running!
+   */
+  static void EnableTracing();
+
+  /**
+   * Stop recording a trace of the timers; the recorded events are kept.
+   */
+  static void DisableTracing();
+
+  /**
+   * Save the recorded trace to the given file in the Chrome trace event
+   * format, which can be opened with chrome://tracing, Perfetto or speedscope
+   * to see when each timer ran on each thread.
+   *
+   * @note A std::runtime_error exception will be thrown if the file cannot be
+   * opened.
+   *
+   * @param filename Name of the file to save the trace to.
+   */
+  static void SaveTrace(const std::string& filename);
 };
 
 class Timers
 {
  public:
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers() : enabled(false), tracing(false) { }
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -163,11 +190,28 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Write the recorded trace events to the given stream as Chrome trace event
+   * JSON.  Each thread that ran a timer gets its own track; the threads are
+   * numbered in the order they first ran a timer.
+   *
+   * @param stream Stream to write the trace to.
+   */
+  void WriteTrace(std::ostream& stream);
+
+  //! Get the number of recorded trace events.
+  size_t NumTraceEvents();
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
+  //! Modify whether or not trace events are recorded.
+  std::atomic<bool>& Tracing() { return tracing; }
+  //! Get whether or not trace events are recorded.
+  bool Tracing() const { return tracing; }
+
  private:
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
@@ -179,6 +223,24 @@ class Timers
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+
+  //! A run of a timer, recorded when tracing.
+  struct TraceEvent
+  {
+    //! The name of the timer.
+    std::string name;
+    //! The thread that ran the timer.
+    std::thread::id threadId;
+    //! The time the timer was started.
+    std::chrono::high_resolution_clock::time_point start;
+    //! The time the timer was stopped.
+    std::chrono::high_resolution_clock::time_point stop;
+  };
+
+  //! Whether or not trace events are recorded.
+  std::atomic<bool> tracing;
+  //! The recorded trace events.
+  std::vector<TraceEvent> traceEvents;
 };
 
 } // namespace mlpack
@@ -0,0 +1,38 @@
+/**
+ * @file core/util/training_profiler.cpp
+ *
+ * Implementation of PeakMemoryUsage().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "training_profiler.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/resource.h>
+#endif
+
+namespace mlpack {
+
+size_t PeakMemoryUsage()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  // The peak resident set size is in bytes on macOS, and in kilobytes
+  // elsewhere.
+  #ifdef __APPLE__
+    return (size_t) usage.ru_maxrss;
+  #else
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#else
+  return 0;
+#endif
+}
+
+} // namespace mlpack
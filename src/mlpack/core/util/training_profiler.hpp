@@ -0,0 +1,476 @@
+/**
+ * @file core/util/training_profiler.hpp
+ *
+ * Definition of the TrainingProfiler class, an ensmallen callback that records
+ * the time, throughput and memory use of training, and of the FunctionProfile
+ * class, which the functions being optimized (such as FFN) use to record the
+ * time of their passes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_TRAINING_PROFILER_HPP
+#define MLPACK_CORE_UTIL_TRAINING_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+#include <numeric>
+
+namespace mlpack {
+
+/**
+ * Return the largest amount of memory the process has used so far (its peak
+ * resident set size), in bytes, or 0 if it is not known on this platform.
+ */
+size_t PeakMemoryUsage();
+
+/**
+ * The time a function being optimized spends in its passes.  A function that
+ * has a FunctionProfile& Profile() member (such as FFN) records its passes
+ * while Enabled() is true; the TrainingProfiler callback turns it on for the
+ * time of the optimization.
+ *
+ * All the times are in seconds.  The time of each layer is summed over the
+ * threads that ran it, so with parallel training it can be greater than the
+ * elapsed time.
+ */
+class FunctionProfile
+{
+ public:
+  //! Create an empty, disabled profile.
+  FunctionProfile() : evaluationTime(0), points(0), enabled(false) { }
+
+  //! Get whether the passes are recorded.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the passes are recorded.
+  bool& Enabled() { return enabled; }
+
+  //! Set every time and count to zero, for the given number of layers.
+  void Reset(const size_t numLayers = 0)
+  {
+    forwardTime.assign(numLayers, 0.0);
+    backwardTime.assign(numLayers, 0.0);
+    evaluationTime = 0;
+    points = 0;
+  }
+
+  //! Add the times of the layers of the given profile (for instance, one of a
+  //! copy of the network that ran on another thread) to this profile.
+  void AddLayerTimes(const FunctionProfile& other)
+  {
+    for (size_t i = 0; i < other.forwardTime.size(); ++i)
+      AddTime(forwardTime, i, other.forwardTime[i]);
+    for (size_t i = 0; i < other.backwardTime.size(); ++i)
+      AddTime(backwardTime, i, other.backwardTime[i]);
+  }
+
+  //! Add the given time to the given layer.
+  static void AddTime(std::vector<double>& times,
+                      const size_t layer,
+                      const double time)
+  {
+    if (layer >= times.size())
+      times.resize(layer + 1, 0.0);
+    times[layer] += time;
+  }
+
+  //! The time of the forward passes of each layer.
+  std::vector<double> forwardTime;
+  //! The time of the backward passes of each layer (the errors and the
+  //! gradients).
+  std::vector<double> backwardTime;
+  //! The elapsed time of the evaluations of the objective and the gradient.
+  double evaluationTime;
+  //! The number of points the gradient was evaluated on.
+  size_t points;
+
+ private:
+  //! Whether the passes are recorded.
+  bool enabled;
+};
+
+/**
+ * Measure the time between successive passes of the layers of a network, and
+ * add it to the given profile.  Nothing is measured if the profile is NULL.
+ *
+ * @code
+ * LayerTimer timer(profile.Enabled() ? &profile : NULL);
+ * for (size_t i = 0; i < network.size(); ++i)
+ * {
+ *   boost::apply_visitor(ForwardVisitor(...), network[i]);
+ *   timer.Forward(i);
+ * }
+ * @endcode
+ */
+class LayerTimer
+{
+ public:
+  //! Start timing the first pass.
+  explicit LayerTimer(FunctionProfile* profile) : profile(profile)
+  {
+    if (profile != NULL)
+      last = std::chrono::steady_clock::now();
+  }
+
+  //! Start timing the next pass now, so that the time since the last pass
+  //! isn't counted.
+  void Restart()
+  {
+    if (profile != NULL)
+      last = std::chrono::steady_clock::now();
+  }
+
+  //! Add the time since the last pass to the forward time of the given layer.
+  void Forward(const size_t layer)
+  {
+    if (profile != NULL)
+      FunctionProfile::AddTime(profile->forwardTime, layer, Lap());
+  }
+
+  //! Add the time since the last pass to the backward time of the given
+  //! layer.
+  void Backward(const size_t layer)
+  {
+    if (profile != NULL)
+      FunctionProfile::AddTime(profile->backwardTime, layer, Lap());
+  }
+
+ private:
+  //! Return the time since the last pass, and start timing the next one.
+  double Lap()
+  {
+    const std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double>(now - last).count();
+    last = now;
+    return time;
+  }
+
+  //! The profile the times are added to, or NULL.
+  FunctionProfile* profile;
+  //! The end of the last pass.
+  std::chrono::steady_clock::time_point last;
+};
+
+/**
+ * Add the time from the construction to the destruction of the object to the
+ * evaluation time of the given profile, and the given number of points to its
+ * points.  Nothing is measured if the profile is NULL.
+ */
+class ScopedEvaluationTimer
+{
+ public:
+  //! Start timing an evaluation on the given number of points.
+  ScopedEvaluationTimer(FunctionProfile* profile, const size_t points) :
+      profile(profile),
+      points(points)
+  {
+    if (profile != NULL)
+      start = std::chrono::steady_clock::now();
+  }
+
+  //! Add the time of the evaluation to the profile.
+  ~ScopedEvaluationTimer()
+  {
+    if (profile == NULL)
+      return;
+
+    profile->evaluationTime += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    profile->points += points;
+  }
+
+ private:
+  //! The profile the time is added to, or NULL.
+  FunctionProfile* profile;
+  //! The number of points of the evaluation.
+  size_t points;
+  //! The time the evaluation was started.
+  std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * An ensmallen callback that records how fast a model trains: the time and
+ * throughput (points per second) of every epoch and of every step of the
+ * optimizer, the peak memory use of the process, and, for functions that
+ * record a FunctionProfile (such as FFN), the time spent evaluating the
+ * function and in the forward and backward passes of each layer.  The results
+ * can be saved as JSON with data::Save():
+ *
+ * @code
+ * TrainingProfiler profiler;
+ * model.Train(data, responses, optimizer, profiler);
+ * std::cout << profiler.PointsPerSecond() << " points/s" << std::endl;
+ * data::Save("profile.json", "profile", profiler);
+ * @endcode
+ *
+ * The number of points of each step is the number the function was evaluated
+ * on when it records a FunctionProfile; otherwise it is the batch size of the
+ * optimizer, if it has a BatchSize() member, or else the number of functions
+ * (the whole dataset) for full-batch optimizers such as L-BFGS.  The epochs are
+ * only recorded for optimizers that call the BeginEpoch() and EndEpoch()
+ * callbacks, such as SGD and its variants.
+ */
+class TrainingProfiler
+{
+ public:
+  //! The record of one step of the optimizer.
+  struct Step
+  {
+    Step() : time(0), points(0), evaluationTime(0), forwardTime(0),
+        backwardTime(0) { }
+
+    //! The elapsed time of the step (since the previous step).
+    double time;
+    //! The number of points the step was computed on.
+    size_t points;
+    //! The time spent evaluating the function (0 if it isn't recorded); the
+    //! rest of the step was spent in the optimizer.
+    double evaluationTime;
+    //! The time of the forward passes of the layers, summed over threads.
+    double forwardTime;
+    //! The time of the backward passes of the layers, summed over threads.
+    double backwardTime;
+
+    //! Serialize the step.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(time));
+      ar(CEREAL_NVP(points));
+      ar(CEREAL_NVP(evaluationTime));
+      ar(CEREAL_NVP(forwardTime));
+      ar(CEREAL_NVP(backwardTime));
+    }
+  };
+
+  //! The record of one epoch.
+  struct Epoch
+  {
+    Epoch() : time(0), points(0), steps(0), objective(0), pointsPerSecond(0),
+        peakMemory(0) { }
+
+    //! The elapsed time of the epoch.
+    double time;
+    //! The number of points the steps of the epoch were computed on.
+    size_t points;
+    //! The number of steps of the epoch.
+    size_t steps;
+    //! The objective the optimizer gave at the end of the epoch.
+    double objective;
+    //! The throughput of the epoch.
+    double pointsPerSecond;
+    //! The peak memory use of the process at the end of the epoch, in bytes.
+    size_t peakMemory;
+
+    //! Serialize the epoch.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(time));
+      ar(CEREAL_NVP(points));
+      ar(CEREAL_NVP(steps));
+      ar(CEREAL_NVP(objective));
+      ar(CEREAL_NVP(pointsPerSecond));
+      ar(CEREAL_NVP(peakMemory));
+    }
+  };
+
+  /**
+   * Create the profiler.
+   *
+   * @param recordSteps Whether to keep the record of every step; if false,
+   *     only the epochs and the totals are kept.
+   */
+  TrainingProfiler(const bool recordSteps = true);
+
+  //! Start recording the optimization.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& optimizer,
+                         FunctionType& function,
+                         MatType& coordinates);
+
+  //! Start recording an epoch.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool BeginEpoch(OptimizerType& optimizer,
+                  FunctionType& function,
+                  MatType& coordinates,
+                  const size_t epoch,
+                  const double objective);
+
+  //! Record the step that was taken.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& optimizer,
+                 FunctionType& function,
+                 MatType& coordinates);
+
+  //! Record the epoch that ended.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& optimizer,
+                FunctionType& function,
+                MatType& coordinates,
+                const size_t epoch,
+                const double objective);
+
+  //! Finish recording the optimization.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& optimizer,
+                       FunctionType& function,
+                       MatType& coordinates);
+
+  //! Get the record of every step (empty if the steps aren't recorded).
+  const std::vector<Step>& Steps() const { return steps; }
+  //! Get the record of every epoch.
+  const std::vector<Epoch>& Epochs() const { return epochs; }
+
+  //! Get the number of steps that were taken.
+  size_t NumSteps() const { return numSteps; }
+  //! Get the elapsed time of the optimization.
+  double Time() const { return time; }
+  //! Get the number of points the steps were computed on.
+  size_t Points() const { return points; }
+  //! Get the throughput of the optimization.
+  double PointsPerSecond() const { return (time > 0) ? points / time : 0; }
+  //! Get the time spent evaluating the function (0 if it isn't recorded).
+  double EvaluationTime() const { return evaluationTime; }
+  //! Get the time spent in the optimizer, outside of the evaluations of the
+  //! function (only meaningful if the evaluations are recorded).
+  double OptimizerTime() const
+  {
+    return std::max(time - evaluationTime, 0.0);
+  }
+  //! Get the peak memory use of the process at the end of the optimization,
+  //! in bytes (0 if it isn't known).
+  size_t PeakMemory() const { return peakMemory; }
+
+  //! Get the time of the forward passes of each layer (empty if the function
+  //! doesn't record a FunctionProfile).
+  const std::vector<double>& LayerForwardTime() const
+  {
+    return layerForwardTime;
+  }
+  //! Get the time of the backward passes of each layer (empty if the function
+  //! doesn't record a FunctionProfile).
+  const std::vector<double>& LayerBackwardTime() const
+  {
+    return layerBackwardTime;
+  }
+
+  //! Serialize the profiler (for instance, to save it as JSON).
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Return the profile of the function, or NULL if it has none.
+  template<typename FunctionType>
+  static auto ProfileOf(FunctionType& function, int) ->
+      typename std::enable_if<std::is_same<decltype(function.Profile()),
+          FunctionProfile&>::value, FunctionProfile*>::type
+  {
+    return &function.Profile();
+  }
+
+  //! Return NULL, since the function has no profile.
+  template<typename FunctionType>
+  static FunctionProfile* ProfileOf(FunctionType& /* function */, long)
+  {
+    return NULL;
+  }
+
+  //! Return the batch size of the optimizer.
+  template<typename OptimizerType, typename FunctionType>
+  static auto PointsPerStep(OptimizerType& optimizer,
+                            FunctionType& /* function */,
+                            int, int) -> decltype(size_t(optimizer.BatchSize()))
+  {
+    return optimizer.BatchSize();
+  }
+
+  //! Return the number of functions, for optimizers without batches.
+  template<typename OptimizerType, typename FunctionType>
+  static auto PointsPerStep(OptimizerType& /* optimizer */,
+                            FunctionType& function,
+                            int, long) ->
+      decltype(size_t(function.NumFunctions()))
+  {
+    return function.NumFunctions();
+  }
+
+  //! Return 0, since the number of points of a step isn't known.
+  template<typename OptimizerType, typename FunctionType>
+  static size_t PointsPerStep(OptimizerType& /* optimizer */,
+                              FunctionType& /* function */,
+                              long, long)
+  {
+    return 0;
+  }
+
+  //! Return the current time.
+  static std::chrono::steady_clock::time_point Now()
+  {
+    return std::chrono::steady_clock::now();
+  }
+
+  //! Return the time since the given time, in seconds.
+  static double Since(const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(Now() - start).count();
+  }
+
+  //! Return the sum of the given times.
+  static double Sum(const std::vector<double>& times)
+  {
+    return std::accumulate(times.begin(), times.end(), 0.0);
+  }
+
+  //! Whether to keep the record of every step.
+  bool recordSteps;
+  //! The record of every step.
+  std::vector<Step> steps;
+  //! The record of every epoch.
+  std::vector<Epoch> epochs;
+
+  //! The number of steps that were taken.
+  size_t numSteps;
+  //! The elapsed time of the optimization.
+  double time;
+  //! The number of points the steps were computed on.
+  size_t points;
+  //! The time spent evaluating the function.
+  double evaluationTime;
+  //! The peak memory use of the process, in bytes.
+  size_t peakMemory;
+  //! The time of the forward passes of each layer.
+  std::vector<double> layerForwardTime;
+  //! The time of the backward passes of each layer.
+  std::vector<double> layerBackwardTime;
+
+  //! The profile of the function being optimized, or NULL.
+  FunctionProfile* profile;
+  //! The start of the optimization.
+  std::chrono::steady_clock::time_point optimizationStart;
+  //! The end of the last step.
+  std::chrono::steady_clock::time_point lastStep;
+  //! The start of the current epoch.
+  std::chrono::steady_clock::time_point epochStart;
+  //! The number of points and steps when the current epoch started.
+  size_t epochPoints;
+  size_t epochSteps;
+  //! The evaluation, forward and backward times of the profile at the end of
+  //! the last step.
+  double lastEvaluationTime;
+  double lastForwardTime;
+  double lastBackwardTime;
+  //! The points of the profile at the end of the last step.
+  size_t lastPoints;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "training_profiler_impl.hpp"
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file core/util/training_profiler_impl.hpp
+ *
+ * Implementation of the TrainingProfiler class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_TRAINING_PROFILER_IMPL_HPP
+#define MLPACK_CORE_UTIL_TRAINING_PROFILER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "training_profiler.hpp"
+
+namespace mlpack {
+
+inline TrainingProfiler::TrainingProfiler(const bool recordSteps) :
+    recordSteps(recordSteps),
+    numSteps(0),
+    time(0),
+    points(0),
+    evaluationTime(0),
+    peakMemory(0),
+    profile(NULL),
+    epochPoints(0),
+    epochSteps(0),
+    lastEvaluationTime(0),
+    lastForwardTime(0),
+    lastBackwardTime(0),
+    lastPoints(0)
+{
+  // Nothing to do here.
+}
+
+template<typename OptimizerType, typename FunctionType, typename MatType>
+void TrainingProfiler::BeginOptimization(OptimizerType& /* optimizer */,
+                                         FunctionType& function,
+                                         MatType& /* coordinates */)
+{
+  steps.clear();
+  epochs.clear();
+  numSteps = 0;
+  time = 0;
+  points = 0;
+  evaluationTime = 0;
+  peakMemory = 0;
+  layerForwardTime.clear();
+  layerBackwardTime.clear();
+  lastEvaluationTime = 0;
+  lastForwardTime = 0;
+  lastBackwardTime = 0;
+  lastPoints = 0;
+
+  profile = ProfileOf(function, 0);
+  if (profile != NULL)
+  {
+    profile->Reset();
+    profile->Enabled() = true;
+  }
+
+  optimizationStart = Now();
+  lastStep = optimizationStart;
+  epochStart = optimizationStart;
+}
+
+template<typename OptimizerType, typename FunctionType, typename MatType>
+bool TrainingProfiler::BeginEpoch(OptimizerType& /* optimizer */,
+                                  FunctionType& /* function */,
+                                  MatType& /* coordinates */,
+                                  const size_t /* epoch */,
+                                  const double /* objective */)
+{
+  epochStart = Now();
+  epochPoints = points;
+  epochSteps = numSteps;
+  return false;
+}
+
+template<typename OptimizerType, typename FunctionType, typename MatType>
+bool TrainingProfiler::StepTaken(OptimizerType& optimizer,
+                                 FunctionType& function,
+                                 MatType& /* coordinates */)
+{
+  const std::chrono::steady_clock::time_point now = Now();
+  Step step;
+  step.time = std::chrono::duration<double>(now - lastStep).count();
+  lastStep = now;
+
+  if (profile != NULL)
+  {
+    // The profile holds the totals since the beginning of the optimization.
+    const double forwardTime = Sum(profile->forwardTime);
+    const double backwardTime = Sum(profile->backwardTime);
+    step.points = profile->points - lastPoints;
+    step.evaluationTime = profile->evaluationTime - lastEvaluationTime;
+    step.forwardTime = forwardTime - lastForwardTime;
+    step.backwardTime = backwardTime - lastBackwardTime;
+
+    lastPoints = profile->points;
+    lastEvaluationTime = profile->evaluationTime;
+    lastForwardTime = forwardTime;
+    lastBackwardTime = backwardTime;
+  }
+  else
+  {
+    step.points = PointsPerStep(optimizer, function, 0, 0);
+  }
+
+  ++numSteps;
+  points += step.points;
+  evaluationTime += step.evaluationTime;
+  if (recordSteps)
+    steps.push_back(step);
+
+  return false;
+}
+
+template<typename OptimizerType, typename FunctionType, typename MatType>
+bool TrainingProfiler::EndEpoch(OptimizerType& /* optimizer */,
+                                FunctionType& /* function */,
+                                MatType& /* coordinates */,
+                                const size_t /* epoch */,
+                                const double objective)
+{
+  Epoch epoch;
+  epoch.time = Since(epochStart);
+  epoch.points = points - epochPoints;
+  epoch.steps = numSteps - epochSteps;
+  epoch.objective = objective;
+  epoch.pointsPerSecond = (epoch.time > 0) ? epoch.points / epoch.time : 0;
+  epoch.peakMemory = PeakMemoryUsage();
+  epochs.push_back(epoch);
+
+  // The next epoch starts when this one ends, unless BeginEpoch() is called.
+  epochStart = Now();
+  epochPoints = points;
+  epochSteps = numSteps;
+  return false;
+}
+
+template<typename OptimizerType, typename FunctionType, typename MatType>
+void TrainingProfiler::EndOptimization(OptimizerType& /* optimizer */,
+                                       FunctionType& /* function */,
+                                       MatType& /* coordinates */)
+{
+  time = Since(optimizationStart);
+  peakMemory = PeakMemoryUsage();
+
+  if (profile != NULL)
+  {
+    // The evaluations after the last step (such as the final objective) are
+    // counted too.
+    evaluationTime = profile->evaluationTime;
+    layerForwardTime = profile->forwardTime;
+    layerBackwardTime = profile->backwardTime;
+    profile->Enabled() = false;
+    profile = NULL;
+  }
+
+  Log::Info << "TrainingProfiler: " << numSteps << " steps on " << points
+      << " points in " << time << "s (" << PointsPerSecond() << " points/s)."
+      << std::endl;
+}
+
+template<typename Archive>
+void TrainingProfiler::serialize(Archive& ar, const uint32_t /* version */)
+{
+  double pointsPerSecond = PointsPerSecond();
+  double optimizerTime = OptimizerTime();
+
+  ar(CEREAL_NVP(numSteps));
+  ar(CEREAL_NVP(time));
+  ar(CEREAL_NVP(points));
+  ar(CEREAL_NVP(pointsPerSecond));
+  ar(CEREAL_NVP(evaluationTime));
+  ar(CEREAL_NVP(optimizerTime));
+  ar(CEREAL_NVP(peakMemory));
+  ar(CEREAL_NVP(layerForwardTime));
+  ar(CEREAL_NVP(layerBackwardTime));
+  ar(CEREAL_NVP(epochs));
+  ar(CEREAL_NVP(steps));
+}
+
+} // namespace mlpack
+
+#endif
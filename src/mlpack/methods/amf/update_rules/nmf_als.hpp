@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "parallel_products.hpp"
+
 namespace mlpack {
 namespace amf {
 
@@ -37,6 +39,12 @@ namespace amf {
  * It uses the least squares projection formula to reduce the error value of
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ by alternately calculating W and H
  * respectively while holding the other matrix constant.
+ *
+ * Every row of W (and every column of H) is the solution of a least squares
+ * problem with the same r x r normal equations, so the pseudoinverse of the
+ * small Gram matrix is computed once per update, and only the product with the
+ * input matrix is formed for each row or column.  For sparse input matrices
+ * that product only visits the nonzero elements and is computed in parallel.
  */
 class NMFALSUpdate
 {
@@ -75,7 +83,9 @@ class NMFALSUpdate
   {
     // The call to inv() sometimes fails; so we are using the psuedoinverse.
     // W = (inv(H * H.t()) * H * V.t()).t();
-    W = V * H.t() * pinv(H * H.t());
+    arma::mat vht;
+    RightMultiplyTransposed(V, H, vht);
+    W = vht * pinv(H * H.t());
 
     // Set all negative numbers to machine epsilon.
     for (size_t i = 0; i < W.n_elem; ++i)
@@ -106,7 +116,9 @@ class NMFALSUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = pinv(W.t() * W) * W.t() * V;
+    arma::mat wtv;
+    LeftMultiply(W.t(), V, wtv);
+    H = pinv(W.t() * W) * wtv;
 
     // Set all negative numbers to 0.
     for (size_t i = 0; i < H.n_elem; ++i)
@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "parallel_products.hpp"
+
 namespace mlpack {
 namespace amf {
 
@@ -35,6 +37,10 @@ namespace amf {
  * This is a multiplicative rule that ensures that the Frobenius norm
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ is non-increasing between subsequent
  * iterations. Both of the update rules for W and H are defined in this file.
+ *
+ * The denominators are computed through the small r x r matrices H H^T and
+ * W^T W, the products with sparse input matrices only visit the nonzero
+ * elements, and the elementwise updates are applied in parallel blocks.
  */
 class NMFMultiplicativeDistanceUpdate
 {
@@ -71,7 +77,10 @@ class NMFMultiplicativeDistanceUpdate
                              arma::mat& W,
                              const arma::mat& H)
   {
-    W = (W % (V * H.t())) / (W * H * H.t());
+    arma::mat numerator;
+    RightMultiplyTransposed(V, H, numerator);
+    const arma::mat denominator = W * (H * H.t());
+    MultiplicativeStep(W, numerator, denominator);
   }
 
   /**
@@ -93,7 +102,10 @@ class NMFMultiplicativeDistanceUpdate
                              const arma::mat& W,
                              arma::mat& H)
   {
-    H = (H % (W.t() * V)) / (W.t() * W * H);
+    arma::mat numerator;
+    LeftMultiply(W.t(), V, numerator);
+    const arma::mat denominator = (W.t() * W) * H;
+    MultiplicativeStep(H, numerator, denominator);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
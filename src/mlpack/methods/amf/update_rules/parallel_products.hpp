@@ -0,0 +1,134 @@
+/**
+ * @file methods/amf/update_rules/parallel_products.hpp
+ *
+ * Products of the input matrix with the factors W and H that are shared by
+ * the AMF update rules.  For sparse input matrices the products only visit the
+ * nonzero elements and are computed in parallel over the columns of the
+ * result.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_PARALLEL_PRODUCTS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_PARALLEL_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * Compute out = A * V, where A is a dense matrix with as many columns as V has
+ * rows.  For dense V this is a single BLAS call.
+ *
+ * @param A Dense left-hand matrix.
+ * @param V Input matrix.
+ * @param out Matrix to store the product in.
+ */
+template<typename MatType>
+inline void LeftMultiply(const arma::mat& A, const MatType& V, arma::mat& out)
+{
+  out = A * V;
+}
+
+/**
+ * Compute out = A * V for sparse V.  Each column of the result is a linear
+ * combination of the columns of A given by the nonzero elements of the same
+ * column of V, so the columns are computed independently in parallel.
+ *
+ * @param A Dense left-hand matrix.
+ * @param V Sparse input matrix.
+ * @param out Matrix to store the product in.
+ */
+inline void LeftMultiply(const arma::mat& A,
+                         const arma::sp_mat& V,
+                         arma::mat& out)
+{
+  const size_t r = A.n_rows;
+  out.zeros(r, V.n_cols);
+  V.sync();
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+  {
+    double* outCol = out.colptr(j);
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+    {
+      const double value = V.values[k];
+      const double* aCol = A.colptr(V.row_indices[k]);
+      for (size_t d = 0; d < r; ++d)
+        outCol[d] += value * aCol[d];
+    }
+  }
+}
+
+/**
+ * Compute out = V * H^T, where H has as many columns as V.  For dense V this is
+ * a single BLAS call.
+ *
+ * @param V Input matrix.
+ * @param H Dense right-hand matrix.
+ * @param out Matrix to store the product in.
+ */
+template<typename MatType>
+inline void RightMultiplyTransposed(const MatType& V,
+                                    const arma::mat& H,
+                                    arma::mat& out)
+{
+  out = V * H.t();
+}
+
+/**
+ * Compute out = V * H^T for sparse V.  The rows of the result are the columns
+ * of H * V^T, so V is transposed once (in O(nnz) time) and the product is
+ * computed with the parallel LeftMultiply().
+ *
+ * @param V Sparse input matrix.
+ * @param H Dense right-hand matrix.
+ * @param out Matrix to store the product in.
+ */
+inline void RightMultiplyTransposed(const arma::sp_mat& V,
+                                    const arma::mat& H,
+                                    arma::mat& out)
+{
+  const arma::sp_mat vt = V.t();
+  arma::mat outT;
+  LeftMultiply(H, vt, outT);
+  out = outT.t();
+}
+
+/**
+ * Multiply each element of X by the ratio of the corresponding elements of
+ * numerator and denominator, in parallel over blocks of elements.  This is the
+ * shared step of the multiplicative update rules.
+ *
+ * @param X Matrix to update.
+ * @param numerator Numerator of the ratio.
+ * @param denominator Denominator of the ratio.
+ */
+inline void MultiplicativeStep(arma::mat& X,
+                               const arma::mat& numerator,
+                               const arma::mat& denominator)
+{
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (X.n_elem + blockSize - 1) / blockSize;
+  double* x = X.memptr();
+  const double* num = numerator.memptr();
+  const double* den = denominator.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) X.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      x[i] = (x[i] * num[i]) / den[i];
+  }
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_AMF_UPDATE_RULES_PARALLEL_PRODUCTS_HPP
@@ -98,9 +98,11 @@ class SVDBatchLearning
     mW = momentum * mW;
 
     // Compute the step.
+    // The rows of the step are independent.
     arma::mat deltaW;
     deltaW.zeros(n, r);
-    for (size_t i = 0; i < n; ++i)
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
     {
       for (size_t j = 0; j < m; ++j)
       {
@@ -143,9 +145,11 @@ class SVDBatchLearning
     mH = momentum * mH;
 
     // Compute the step.
+    // The columns of the step are independent.
     arma::mat deltaH;
     deltaH.zeros(r, m);
-    for (size_t j = 0; j < m; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) m; ++j)
     {
       for (size_t i = 0; i < n; ++i)
       {
@@ -208,17 +212,26 @@ inline void SVDBatchLearning::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
 
   mW = momentum * mW;
 
-  arma::mat deltaW;
-  deltaW.zeros(n, r);
+  // Each row of the step only depends on the nonzero elements in the same row
+  // of V, which are the columns of V^T; these are computed in parallel as the
+  // columns of the transposed step.
+  const arma::sp_mat vt = V.t();
+  const arma::mat wt = W.t();
+  arma::mat deltaWt;
+  deltaWt.zeros(r, n);
 
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaW.row(it.row()) += (*it - arma::dot(W.row(row), H.col(col))) *
-                                             arma::trans(H.col(col));
+    for (size_t k = vt.col_ptrs[i]; k < vt.col_ptrs[i + 1]; ++k)
+    {
+      const size_t col = vt.row_indices[k];
+      deltaWt.col(i) += (vt.values[k] - arma::dot(wt.col(i), H.col(col))) *
+          H.col(col);
+    }
   }
 
+  arma::mat deltaW = deltaWt.t();
   if (kw != 0)
     deltaW -= kw * W;
 
@@ -236,15 +249,22 @@ inline void SVDBatchLearning::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
 
   mH = momentum * mH;
 
+  // Each column of the step only depends on the nonzero elements in the same
+  // column of V, so the columns are computed in parallel.
+  V.sync();
+  const arma::mat wt = W.t();
   arma::mat deltaH;
   deltaH.zeros(r, m);
 
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) m; ++j)
   {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaH.col(col) += (*it - arma::dot(W.row(row), H.col(col))) *
-        W.row(row).t();
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+    {
+      const size_t row = V.row_indices[k];
+      deltaH.col(j) += (V.values[k] - arma::dot(wt.col(row), H.col(j))) *
+          wt.col(row);
+    }
   }
 
   if (kh != 0)
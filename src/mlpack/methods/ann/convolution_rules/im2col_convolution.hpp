@@ -0,0 +1,477 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution by lowering the input to a matrix (im2col)
+ * and computing the result with a single matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that the filter is applied to into a row of a matrix (im2col), so that the
+ * convolution becomes a matrix product that is computed by BLAS.  The results
+ * are the same as the results of NaiveConvolution.
+ *
+ * Besides the interface shared by all convolution rules, the class provides
+ * MultiChannelConvolution(), which convolves all the maps of an input with a
+ * whole bank of filters with one matrix product; the Convolution,
+ * AtrousConvolution and TransposedConvolution layers use it to process all the
+ * maps of each point at once.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /**
+   * Lower the given maps of the input into a matrix (valid mode).  Each row of
+   * the matrix holds the patches of all the maps that one output element is
+   * computed from; the patch of map s is stored in the columns
+   * [s * filterRows * filterCols, (s + 1) * filterRows * filterCols), in
+   * column-major order like the filter.  The rows are ordered like the
+   * elements of the (column-major) output.
+   *
+   * @param input Input maps.
+   * @param firstSlice Index of the first map to lower.
+   * @param numSlices Number of maps to lower.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param columns Matrix to store the lowered input in.
+   * @param outputRows Set to the number of rows of the output.
+   * @param outputCols Set to the number of columns of the output.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t firstSlice,
+                     const size_t numSlices,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     arma::Mat<eT>& columns,
+                     size_t& outputRows,
+                     size_t& outputCols,
+                     const size_t dW = 1,
+                     const size_t dH = 1,
+                     const size_t dilationW = 1,
+                     const size_t dilationH = 1)
+  {
+    // These are the same output sizes and input indices as NaiveConvolution.
+    outputRows = (input.n_rows - (filterRows - 1) * dilationW - 1) / dW + 1;
+    outputCols = (input.n_cols - (filterCols - 1) * dilationH - 1) / dH + 1;
+
+    const size_t filterSize = filterRows * filterCols;
+    columns.set_size(outputRows * outputCols, filterSize * numSlices);
+
+    for (size_t s = 0; s < numSlices; ++s)
+    {
+      const arma::Mat<eT>& map = input.slice(firstSlice + s);
+      for (size_t kj = 0; kj < filterCols; ++kj)
+      {
+        for (size_t ki = 0; ki < filterRows; ++ki)
+        {
+          eT* columnPtr = columns.colptr(s * filterSize + kj * filterRows + ki);
+          for (size_t j = 0; j < outputCols; ++j)
+          {
+            const eT* inputPtr = map.colptr(kj * dilationW + j * dW) +
+                ki * dilationH;
+            for (size_t i = 0; i < outputRows; ++i, ++columnPtr,
+                inputPtr += dH)
+              *columnPtr = *inputPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Convolve the maps of the input with a bank of filters, so that output map
+   * o is the sum over all input maps s of the convolution of map s with filter
+   * (s, o).  Column o of the filter bank holds the filters of output map o,
+   * with the filter of input map s (in column-major order) in the rows
+   * [s * filterRows * filterCols, (s + 1) * filterRows * filterCols).
+   *
+   * The output has one column per output map, in column-major order; if the
+   * output already has the right size, it is written in place, so it can be an
+   * alias of memory owned elsewhere.
+   *
+   * @param input Input maps.
+   * @param firstSlice Index of the first input map.
+   * @param numSlices Number of input maps.
+   * @param filters Filter bank.
+   * @param filterRows Number of rows of each filter.
+   * @param filterCols Number of columns of each filter.
+   * @param output Output maps.
+   * @param outputRows Set to the number of rows of each output map.
+   * @param outputCols Set to the number of columns of each output map.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  MultiChannelConvolution(const arma::Cube<eT>& input,
+                          const size_t firstSlice,
+                          const size_t numSlices,
+                          const arma::Mat<eT>& filters,
+                          const size_t filterRows,
+                          const size_t filterCols,
+                          arma::Mat<eT>& output,
+                          size_t& outputRows,
+                          size_t& outputCols,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> columns;
+    Im2Col(input, firstSlice, numSlices, filterRows, filterCols, columns,
+        outputRows, outputCols, dW, dH, dilationW, dilationH);
+
+    output = columns * filters;
+  }
+
+  /**
+   * Convolve the maps of the input with a bank of filters (full mode).  See
+   * the valid mode for the layout of the filter bank and the output.
+   *
+   * @param input Input maps.
+   * @param firstSlice Index of the first input map.
+   * @param numSlices Number of input maps.
+   * @param filters Filter bank.
+   * @param filterRows Number of rows of each filter.
+   * @param filterCols Number of columns of each filter.
+   * @param output Output maps.
+   * @param outputRows Set to the number of rows of each output map.
+   * @param outputCols Set to the number of columns of each output map.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  MultiChannelConvolution(const arma::Cube<eT>& input,
+                          const size_t firstSlice,
+                          const size_t numSlices,
+                          const arma::Mat<eT>& filters,
+                          const size_t filterRows,
+                          const size_t filterCols,
+                          arma::Mat<eT>& output,
+                          size_t& outputRows,
+                          size_t& outputCols,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Cube<eT> inputPadded;
+    PadFull(input, firstSlice, numSlices, filterRows, filterCols, inputPadded,
+        dW, dH, dilationW, dilationH);
+
+    Im2ColConvolution<ValidConvolution>::MultiChannelConvolution(inputPadded,
+        0, numSlices, filters, filterRows, filterCols, output, outputRows,
+        outputCols, 1, 1, dilationW, dilationH);
+  }
+
+  /**
+   * Arrange the filters of a layer into a filter bank for
+   * MultiChannelConvolution().  Slice (o * numIn + s) of the weights is the
+   * filter between input map s and output map o; in the bank, it becomes the
+   * filter of input map s for output map o, or, if transpose is true, the
+   * filter of input map o for output map s (as needed to propagate the error
+   * back through the layer).
+   *
+   * @param weights Filters of the layer.
+   * @param numIn Number of input maps of the layer.
+   * @param numOut Number of output maps of the layer.
+   * @param transpose Whether to swap the roles of the input and output maps.
+   * @param rotate Whether to rotate each filter by 180 degrees.
+   * @param filters Matrix to store the filter bank in.
+   */
+  template<typename eT>
+  static void FilterBank(const arma::Cube<eT>& weights,
+                         const size_t numIn,
+                         const size_t numOut,
+                         const bool transpose,
+                         const bool rotate,
+                         arma::Mat<eT>& filters)
+  {
+    const size_t filterSize = weights.n_rows * weights.n_cols;
+    if (transpose)
+      filters.set_size(filterSize * numOut, numIn);
+    else
+      filters.set_size(filterSize * numIn, numOut);
+
+    for (size_t o = 0; o < numOut; ++o)
+    {
+      for (size_t s = 0; s < numIn; ++s)
+      {
+        const eT* weightPtr = weights.slice(o * numIn + s).memptr();
+        eT* filterPtr = transpose ? filters.colptr(s) + o * filterSize :
+            filters.colptr(o) + s * filterSize;
+
+        // Rotating a column-major filter by 180 degrees reverses it.
+        if (rotate)
+          std::reverse_copy(weightPtr, weightPtr + filterSize, filterPtr);
+        else
+          std::copy(weightPtr, weightPtr + filterSize, filterPtr);
+      }
+    }
+  }
+
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+        input.n_rows, input.n_cols, 1, false, true);
+    const arma::Mat<eT> filterTemp(const_cast<arma::Mat<eT>&>(filter).memptr(),
+        filter.n_elem, 1, false, true);
+
+    arma::Mat<eT> result;
+    size_t outputRows, outputCols;
+    MultiChannelConvolution(inputTemp, 0, 1, filterTemp, filter.n_rows,
+        filter.n_cols, result, outputRows, outputCols, dW, dH, dilationW,
+        dilationH);
+
+    output = arma::reshape(result, outputRows, outputCols);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+        input.n_rows, input.n_cols, 1, false, true);
+    arma::Cube<eT> inputPadded;
+    PadFull(inputTemp, 0, 1, filter.n_rows, filter.n_cols, inputPadded, dW, dH,
+        dilationW, dilationH);
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded.slice(0),
+        filter, output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+ private:
+  /*
+   * Pad the given maps of the input with zeros so that the valid convolution
+   * of the padded maps is the full convolution of the input.  The size of the
+   * padded maps is the same as in NaiveConvolution.
+   */
+  template<typename eT>
+  static void PadFull(const arma::Cube<eT>& input,
+                      const size_t firstSlice,
+                      const size_t numSlices,
+                      const size_t filterRows,
+                      const size_t filterCols,
+                      arma::Cube<eT>& output,
+                      const size_t dW,
+                      const size_t dH,
+                      const size_t dilationW,
+                      const size_t dilationH)
+  {
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filterRows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filterCols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filterRows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filterCols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    output.zeros(outputRows, outputCols, numSlices);
+    const size_t top = (filterRows - 1) * dilationW;
+    const size_t left = (filterCols - 1) * dilationH;
+    for (size_t s = 0; s < numSlices; ++s)
+    {
+      output.slice(s).submat(top, left, top + input.n_rows - 1,
+          left + input.n_cols - 1) = input.slice(firstSlice + s);
+    }
+  }
+};  // class Im2ColConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
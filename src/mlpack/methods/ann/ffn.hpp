@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/training_profiler.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -24,8 +25,11 @@
 #include "visitor/weight_size_visitor.hpp"
 #include "visitor/copy_visitor.hpp"
 #include "visitor/loss_visitor.hpp"
+#include "visitor/recomputable_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/workspace.hpp"
+#include "util/prefetch_loader.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -163,6 +167,57 @@ class FFN
                arma::mat responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the given input data using the given
+   * optimizer, with sparse gradients: the gradient of the embeddings of a
+   * Lookup layer only has nonzero elements for the tokens of each batch (see
+   * the sparse overload of EvaluateWithGradient()).  This is useful with large
+   * vocabularies and optimizers whose updates only touch the nonzero elements
+   * of the gradient, such as ens::StandardSGD; optimizers that keep dense
+   * statistics of the gradient (such as ens::Adam) still update every
+   * parameter.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model; it
+   *     must accept a sparse gradient type.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double TrainSparse(arma::mat predictors,
+                     arma::mat responses,
+                     OptimizerType& optimizer,
+                     CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on the batches given by the loader, using
+   * the given optimizer.  The next batch is read while the network is trained
+   * on the current one (see PrefetchLoader), so the data doesn't have to fit in
+   * memory.  Only the optimizers of separable functions (such as ens::SGD and
+   * its variants) can be used.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam SourceType Type of the source of the points.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param loader Loader that gives the batches of the training data.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename SourceType, typename OptimizerType,
+           typename... CallbackTypes>
+  double Train(PrefetchLoader<SourceType>& loader,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -171,10 +226,17 @@ class FFN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
+   * The predictors are passed through the network batchSize points at a time,
+   * so each layer works on a whole batch at once, and the output of each layer
+   * keeps its memory from one batch to the next.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(arma::mat predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -275,6 +337,44 @@ class FFN
                 arma::mat& gradient,
                 const size_t batchSize);
 
+  /**
+   * Evaluate the feedforward network and its gradient with respect to the
+   * given points, as a sparse matrix.  The Lookup layers only give the
+   * gradient of the embeddings of the tokens of the batch, so for large
+   * vocabularies the gradient has few nonzero elements, and optimizers with
+   * sparse updates (such as ens::StandardSGD, used through TrainSparse()) only
+   * write the parameters of those embeddings.  The batch is processed by this
+   * network only, even if more than one thread is used.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::sp_mat& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the feedforward network with respect to the
+   * given points, as a sparse matrix; see the sparse overload of
+   * EvaluateWithGradient().
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize);
+
   /**
    * Shuffle the order of function visitation. This may be called by the
    * optimizer.
@@ -324,11 +424,102 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  //! Get the number of threads that compute the gradient of each batch.
+  size_t NumThreads() const { return numThreads; }
+  /**
+   * Modify the number of threads that compute the gradient of each batch
+   * during training.  With more than one thread, every batch is split in
+   * parts that are passed through copies of the layers (which share the
+   * parameters of the network) in parallel, and the gradients of the parts are
+   * summed before the optimizer step; the output layer still evaluates the
+   * whole batch.  This gives the same objective and gradient as one thread,
+   * except for layers whose results depend on the whole batch (such as
+   * BatchNorm, VirtualBatchNorm, MiniBatchDiscrimination or the KL term of
+   * Reparametrization).  The layers are copied again whenever the data or the
+   * parameters change.  This has no effect if mlpack is built without OpenMP.
+   */
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the layers whose outputs are kept for the backward pass when
+  //! activation checkpointing is used (empty if it isn't).
+  const std::vector<size_t>& Checkpoints() const { return checkpoints; }
+  /**
+   * Modify the layers whose outputs are kept for the backward pass.  If this
+   * isn't empty, training uses activation checkpointing: the outputs of the
+   * other layers are released during the forward pass as soon as the next
+   * layer has used them, and they are computed again during the backward
+   * pass, one run of layers at a time, from the last kept output before them.
+   * Each layer is then run forward about twice per batch, but only the kept
+   * outputs and the outputs of one run of layers are in memory at once, so
+   * much larger batches fit.
+   *
+   * The outputs of the last layer, and of the layers that don't give the same
+   * output when they are run again (the layers with a Deterministic() or
+   * Model() function, such as Dropout or BatchNorm), are always kept.  The
+   * gradient is the same as without checkpointing.  A batch isn't split
+   * across threads when checkpointing is used (see NumThreads()).
+   */
+  std::vector<size_t>& Checkpoints() { return checkpoints; }
+
+  //! Get the time the network spent in its passes while training.
+  const FunctionProfile& Profile() const { return profile; }
+  /**
+   * Modify the time the network spent in its passes while training.  While
+   * Profile().Enabled() is true, the time of the forward and backward passes
+   * of each layer, and the time and number of points of each evaluation of the
+   * objective and the gradient, are added to the profile.  The
+   * TrainingProfiler callback turns this on while the network is trained.
+   */
+  FunctionProfile& Profile() { return profile; }
+
+  /**
+   * Keep the output of every k-th layer of the network for the backward pass
+   * (see Checkpoints()); call this after the layers have been added.  A
+   * value of 0 turns activation checkpointing off.
+   *
+   * @param k Number of layers between two kept outputs.
+   */
+  void CheckpointEvery(const size_t k);
+
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Turn the trained network into a network for inference only.  Every
+   * BatchNorm layer that follows a Linear or Convolution layer is folded into
+   * the weights and bias of that layer, Dropout and AlphaDropout layers (which
+   * do nothing at inference time) are removed, and the training data and the
+   * buffers the network and its layers use for training are released.  The
+   * remaining BatchNorm layers use their running statistics.
+   *
+   * The network gives the same predictions as before (up to rounding), but it
+   * has fewer layers and parameters, so it is a different model: training it
+   * again is possible, but won't train the removed layers.
+   *
+   * If maxDensity is positive, every Linear or LinearNoBias layer of which
+   * less than this fraction of the weights are nonzero (for instance, after
+   * Prune()) is replaced by a SparseLinear layer, which stores its weights as
+   * a sparse matrix and can't be trained.
+   *
+   * @param maxDensity Largest fraction of nonzero weights of the layers that
+   *     are made sparse; 0 means no layer is.
+   */
+  void Freeze(const double maxDensity = 0.0);
+
+  /**
+   * Prune the weights of the Linear and LinearNoBias layers of the network by
+   * magnitude: in each of these layers, the given fraction of the weights that
+   * have the smallest absolute values is set to zero.  The biases are kept.
+   * The pruned weights aren't masked, so training the network again makes
+   * them nonzero again.  To get faster predictions from a pruned network, pass
+   * a maxDensity to Freeze().
+   *
+   * @param sparsity Fraction of the weights of each layer to set to zero.
+   */
+  void Prune(const double sparsity);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -415,17 +606,134 @@ class FFN
   template<typename InputType>
   void Gradient(const InputType& input);
 
+  /**
+   * Compute the gradient of all the layers as a sparse matrix, after the
+   * backward pass.  The dense layers write their gradient to
+   * sparseGradientBuffer, and the Lookup layers only compute the gradient of
+   * the tokens of the input.
+   *
+   * @param input Input of the first layer.
+   * @param gradient Sparse matrix to store the gradient in.
+   */
+  template<typename InputType>
+  void SparseGradient(const InputType& input, arma::sp_mat& gradient);
+
   /**
    * Reset the module status by setting the current deterministic parameter
    * for all modules that implement the Deterministic function.
    */
   void ResetDeterministic();
 
+  /**
+   * Give the targets to the last layer if it computes the loss itself (see
+   * SampledSoftmax and HierarchicalSoftmax); an empty matrix removes them.
+   *
+   * @param targets Targets of the points that are given to the network next.
+   */
+  void SetTargets(const arma::mat& targets);
+
+  /**
+   * Give the responses of the given batch to the last layer if it computes the
+   * loss itself.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   */
+  void SetTargets(const size_t begin, const size_t batchSize);
+
   /**
    * Reset the gradient for all modules that implement the Gradient function.
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Make the outputs and deltas of the layers views of the training workspace,
+   * for a pass with the given batch size, so that the layers don't allocate
+   * them for every batch.  Nothing is done until a training pass has given the
+   * shapes of the layers.
+   *
+   * @param batchSize Number of points of the pass.
+   */
+  void InitializeWorkspace(const size_t batchSize);
+
+  /**
+   * Store the shapes of the outputs and deltas of the layers after a training
+   * pass with the given batch size.
+   *
+   * @param batchSize Number of points of the pass.
+   */
+  void UpdateWorkspaceShapes(const size_t batchSize);
+
+  /**
+   * Compute the objective and gradient of the given batch by splitting it
+   * across the replicas of the network, as EvaluateWithGradient() does with
+   * more than one thread.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Gradient to store the result in, already set to zero.
+   * @param batchSize Number of points of the batch.
+   */
+  template<typename GradType>
+  double EvaluateWithGradientReplicas(const size_t begin,
+                                      GradType& gradient,
+                                      const size_t batchSize);
+
+  /**
+   * Compute the objective and gradient of the given batch with activation
+   * checkpointing, as EvaluateWithGradient() does when Checkpoints() isn't
+   * empty.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param gradient Gradient to store the result in, already set to zero.
+   * @param batchSize Number of points of the batch.
+   */
+  template<typename GradType>
+  double EvaluateWithGradientCheckpoints(const size_t begin,
+                                         GradType& gradient,
+                                         const size_t batchSize);
+
+  /**
+   * Make sure there are the given number of replicas of the network, whose
+   * layers share the parameters of the network.
+   *
+   * @param numReplicas Number of replicas.
+   */
+  void ResetReplicas(const size_t numReplicas);
+
+  //! Delete the replicas of the network.
+  void DeleteReplicas();
+
+  /**
+   * Fold the given BatchNorm layer into the weights and bias of the given
+   * Linear or Convolution layer, whose outputs it normalizes.
+   *
+   * @param layer Layer before the BatchNorm layer.
+   * @param batchNorm BatchNorm layer to fold.
+   */
+  void FoldBatchNorm(LayerTypes<CustomLayers...>& layer,
+                     BatchNorm<>& batchNorm);
+
+  /**
+   * Replace the Linear and LinearNoBias layers with less than the given
+   * fraction of nonzero weights by SparseLinear layers.
+   *
+   * @param maxDensity Largest fraction of nonzero weights of the layers to
+   *     replace.
+   */
+  void Sparsify(const double maxDensity);
+
+  /**
+   * Lay the parameters of the layers out again, after some layers have been
+   * replaced by layers with other parameters (or none).  The layers are reset
+   * before their parameters are copied, since resetting may overwrite them.
+   *
+   * @param offsets For each layer, the offset of its parameters in the current
+   *     parameters (ignored for the new layers).
+   * @param replaced For each layer, whether it is new.
+   */
+  void ResetParameterLayout(const std::vector<size_t>& offsets,
+                            const std::vector<bool>& replaced);
+
   /**
    * Swap the content of this network with given network.
    *
@@ -506,6 +814,48 @@ class FFN
   //! Locally-stored gradient parameter.
   arma::mat gradient;
 
+  //! The dense gradient of the layers other than Lookup layers, when the
+  //! gradient is sparse; the part of the Lookup layers is never written.
+  arma::mat sparseGradientBuffer;
+
+  //! The memory that holds the outputs and deltas of the layers in training.
+  Workspace workspace;
+
+  //! The number of rows of the output of each layer (0 if the output isn't
+  //! stored in the workspace).
+  std::vector<size_t> workspaceOutputRows;
+
+  //! The number of rows of the delta of each layer (0 if the delta isn't
+  //! stored in the workspace).
+  std::vector<size_t> workspaceDeltaRows;
+
+  //! The number of threads that compute the gradient of each batch.
+  size_t numThreads;
+
+  //! The copies of the network that process the other parts of each batch in
+  //! parallel training.
+  std::vector<FFN*> replicas;
+
+  //! The parameters the layers of the replicas alias (NULL if there are no
+  //! replicas).
+  const double* replicaParameter;
+
+  //! The gradients computed by the replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! The layers whose outputs are kept for the backward pass with activation
+  //! checkpointing.
+  std::vector<size_t> checkpoints;
+
+  //! The time the network spent in its passes while training.
+  FunctionProfile profile;
+
+  //! The output of the network for the whole batch in parallel training.
+  arma::mat replicaOutput;
+
+  //! The error of the output layer for the whole batch in parallel training.
+  arma::mat replicaError;
+
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
@@ -517,6 +867,14 @@ class FFN
     typename PolicyType
   >
   friend class GAN;
+
+  // QuantizedFFN runs the network to calibrate it, and replaces its layers.
+  template<
+    typename OutputLayerType1,
+    typename InitializationRuleType1,
+    typename... CustomLayers1
+  >
+  friend class QuantizedFFN;
 }; // class FFN
 
 } // namespace ann
@@ -22,6 +22,7 @@
 #include "visitor/gradient_visitor.hpp"
 #include "visitor/set_input_height_visitor.hpp"
 #include "visitor/set_input_width_visitor.hpp"
+#include "visitor/target_set_visitor.hpp"
 
 #include "util/check_input_shape.hpp"
 
@@ -39,7 +40,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(false)
+    deterministic(false),
+    numThreads(1),
+    replicaParameter(NULL)
 {
   /* Nothing to do here. */
 }
@@ -48,6 +51,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  DeleteReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -65,6 +69,9 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
 
   if (!reset)
     ResetParameters();
+
+  // The replicas are made again for the new data, in case the layers changed.
+  DeleteReplicas();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -121,7 +128,12 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("ffn_optimization");
+  #ifdef MLPACK_PROFILE_TIMERS
+  const double out = optimizer.Optimize(*this, parameter, callbacks...,
+      ProfileOptimizerSteps());
+  #else
   const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  #endif
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -149,7 +161,81 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   // Train the model.
   Timer::Start("ffn_optimization");
+  #ifdef MLPACK_PROFILE_TIMERS
+  const double out = optimizer.Optimize(*this, parameter, callbacks...,
+      ProfileOptimizerSteps());
+  #else
   const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  #endif
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+TrainSparse(arma::mat predictors,
+            arma::mat responses,
+            OptimizerType& optimizer,
+            CallbackTypes&&... callbacks)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      predictors.n_rows, "FFN<>::TrainSparse()");
+
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model, asking the optimizer for sparse gradients.
+  Timer::Start("ffn_optimization");
+  #ifdef MLPACK_PROFILE_TIMERS
+  const double out = optimizer.template Optimize<FFN, arma::mat, arma::sp_mat>(
+      *this, parameter, callbacks..., ProfileOptimizerSteps());
+  #else
+  const double out = optimizer.template Optimize<FFN, arma::mat, arma::sp_mat>(
+      *this, parameter, callbacks...);
+  #endif
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::FFN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename SourceType, typename OptimizerType,
+         typename... CallbackTypes>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    PrefetchLoader<SourceType>& loader,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  // The data of the network is replaced by each batch of the loader.
+  numFunctions = loader.NumPoints();
+  this->deterministic = false;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+
+  DeleteReplicas();
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, loader.NumPoints());
+
+  // Train the model.
+  LoaderFunction<FFN, SourceType> function(*this, loader);
+  Timer::Start("ffn_optimization");
+  #ifdef MLPACK_PROFILE_TIMERS
+  const double out = optimizer.Optimize(function, parameter, callbacks...,
+      ProfileOptimizerSteps());
+  #else
+  const double out = optimizer.Optimize(function, parameter, callbacks...);
+  #endif
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -225,12 +311,18 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    arma::mat predictors, arma::mat& results, const size_t batchSize)
 {
   CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network, 
                                                               predictors.n_rows, 
                                                               "FFN<>::Predict()");
 
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("FFN<>::Predict(): batchSize must be "
+        "positive!");
+  }
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -240,21 +332,33 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
-
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
-
-  for (size_t i = 1; i < predictors.n_cols; ++i)
+  // The layers that compute the loss themselves give their full output when
+  // they have no targets.
+  SetTargets(arma::mat());
+
+  // The first batch gives the size of the output.
+  const size_t firstBatchSize = std::min(batchSize,
+      size_t(predictors.n_cols));
+  Forward(arma::mat(predictors.colptr(0), predictors.n_rows, firstBatchSize,
+      false, true));
+  const arma::mat& firstResults = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+
+  results.set_size(firstResults.n_rows, predictors.n_cols);
+  results.cols(0, firstBatchSize - 1) = firstResults;
+
+  // Every batch (except maybe the last) has the same size, so the layers can
+  // reuse the memory of their outputs.
+  for (size_t begin = firstBatchSize; begin < predictors.n_cols;
+      begin += batchSize)
   {
-    Forward(arma::mat(predictors.colptr(i), predictors.n_rows, 1, false, true));
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    Forward(arma::mat(predictors.colptr(begin), predictors.n_rows,
+        effectiveBatchSize, false, true));
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
-        network.back());
-    results.col(i) = resultsTemp.col(0);
+    results.cols(begin, begin + effectiveBatchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, network.back());
   }
 }
 
@@ -277,6 +381,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
+  SetTargets(responses);
   Forward(predictors);
 
   double res = outputLayer.Forward(boost::apply_visitor(
@@ -310,6 +415,9 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     const size_t batchSize,
     const bool deterministic)
 {
+  ScopedEvaluationTimer evaluationTimer(profile.Enabled() ? &profile : NULL,
+      0);
+
   if (parameter.is_empty())
     ResetParameters();
 
@@ -319,6 +427,8 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
+  InitializeWorkspace(batchSize);
+  SetTargets(begin, batchSize);
   Forward(predictors.cols(begin, begin + batchSize - 1));
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
@@ -362,6 +472,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
                      GradType& gradient,
                      const size_t batchSize)
 {
+  ScopedEvaluationTimer evaluationTimer(profile.Enabled() ? &profile : NULL,
+      batchSize);
+
   if (gradient.is_empty())
   {
     if (parameter.is_empty())
@@ -380,6 +493,16 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
+  SetTargets(begin, batchSize);
+  if (!checkpoints.empty())
+    return EvaluateWithGradientCheckpoints(begin, gradient, batchSize);
+
+  #ifdef HAS_OPENMP
+  if (std::min(numThreads, batchSize) > 1)
+    return EvaluateWithGradientReplicas(begin, gradient, batchSize);
+  #endif
+
+  InitializeWorkspace(batchSize);
   Forward(predictors.cols(begin, begin + batchSize - 1));
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
@@ -398,10 +521,313 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   Backward();
   ResetGradients(gradient);
   Gradient(predictors.cols(begin, begin + batchSize - 1));
+  UpdateWorkspaceShapes(batchSize);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradientReplicas(const size_t begin,
+                             GradType& gradient,
+                             const size_t batchSize)
+{
+  const size_t numParts = std::min(numThreads, batchSize);
+  ResetReplicas(numParts - 1);
+  replicaGradients.resize(numParts - 1);
+  for (size_t r = 0; r < replicas.size(); ++r)
+    replicas[r]->profile.Enabled() = profile.Enabled();
+
+  // The first part of the batch is processed by this network, and the other
+  // parts by the replicas.  Part k holds the points in [begin + k * batchSize /
+  // numParts, begin + (k + 1) * batchSize / numParts).
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) numParts; ++k)
+  {
+    FFN& model = (k == 0) ? *this : *replicas[k - 1];
+    const size_t partBegin = begin + k * batchSize / numParts;
+    const size_t partSize = begin + (k + 1) * batchSize / numParts - partBegin;
+
+    model.InitializeWorkspace(partSize);
+    model.SetTargets(arma::mat(const_cast<double*>(responses.colptr(
+        partBegin)), responses.n_rows, partSize, false, true));
+    model.Forward(predictors.cols(partBegin, partBegin + partSize - 1));
+  }
+
+  // The output layer evaluates the whole batch, so that the objective doesn't
+  // depend on how the output layer reduces the batch.
+  const size_t outputRows = boost::apply_visitor(outputParameterVisitor,
+      network.back()).n_rows;
+  replicaOutput.set_size(outputRows, batchSize);
+  for (size_t k = 0; k < numParts; ++k)
+  {
+    const FFN& model = (k == 0) ? *this : *replicas[k - 1];
+    const size_t partBegin = k * batchSize / numParts;
+    const size_t partEnd = (k + 1) * batchSize / numParts;
+    replicaOutput.cols(partBegin, partEnd - 1) = boost::apply_visitor(
+        outputParameterVisitor, model.network.back());
+  }
+
+  double res = outputLayer.Forward(replicaOutput,
+      responses.cols(begin, begin + batchSize - 1));
+  outputLayer.Backward(replicaOutput,
+      responses.cols(begin, begin + batchSize - 1), replicaError);
+
+  // The losses of the layers are averages over the points they see.
+  for (size_t k = 0; k < numParts; ++k)
+  {
+    const FFN& model = (k == 0) ? *this : *replicas[k - 1];
+    const size_t partSize = (k + 1) * batchSize / numParts -
+        k * batchSize / numParts;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      res += boost::apply_visitor(lossVisitor, model.network[i]) * partSize /
+          batchSize;
+    }
+  }
+
+  #pragma omp parallel for
+  for (omp_size_t k = 0; k < (omp_size_t) numParts; ++k)
+  {
+    FFN& model = (k == 0) ? *this : *replicas[k - 1];
+    const size_t partBegin = k * batchSize / numParts;
+    const size_t partSize = (k + 1) * batchSize / numParts - partBegin;
+
+    model.error = replicaError.cols(partBegin, partBegin + partSize - 1);
+    model.Backward();
+    if (k == 0)
+    {
+      ResetGradients(gradient);
+    }
+    else
+    {
+      replicaGradients[k - 1].zeros(parameter.n_rows, parameter.n_cols);
+      model.ResetGradients(replicaGradients[k - 1]);
+    }
+
+    model.Gradient(predictors.cols(begin + partBegin,
+        begin + partBegin + partSize - 1));
+    model.UpdateWorkspaceShapes(partSize);
+  }
+
+  for (size_t k = 0; k < replicaGradients.size(); ++k)
+    gradient += replicaGradients[k];
+
+  // The times of the layers of the replicas are summed with those of this
+  // network.
+  if (profile.Enabled())
+  {
+    for (size_t r = 0; r < replicas.size(); ++r)
+    {
+      profile.AddLayerTimes(replicas[r]->profile);
+      replicas[r]->profile.Reset();
+    }
+  }
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradientCheckpoints(const size_t begin,
+                                GradType& gradient,
+                                const size_t batchSize)
+{
+  // The outputs aren't views of the workspace, since most of them are
+  // released during the pass.
+  if (!workspaceOutputRows.empty())
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      math::ClearAlias(boost::apply_visitor(outputParameterVisitor,
+          network[i]));
+      math::ClearAlias(boost::apply_visitor(deltaVisitor, network[i]));
+    }
+
+    workspace = Workspace();
+    workspaceOutputRows.clear();
+    workspaceDeltaRows.clear();
+  }
+
+  std::vector<bool> kept(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    kept[i] = (i == network.size() - 1) ||
+        !boost::apply_visitor(RecomputableVisitor(), network[i]);
+  }
+
+  for (size_t i = 0; i < checkpoints.size(); ++i)
+  {
+    if (checkpoints[i] < network.size())
+      kept[checkpoints[i]] = true;
+  }
+
+  const arma::mat input(const_cast<double*>(predictors.colptr(begin)),
+      predictors.n_rows, batchSize, false, true);
+
+  // The first pass also finds the shapes of the layers.
+  LayerTimer timer(profile.Enabled() ? &profile : NULL);
+  if (!reset)
+  {
+    Forward(input);
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      if (!kept[i])
+        boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      boost::apply_visitor(ForwardVisitor((i == 0) ? input :
+          boost::apply_visitor(outputParameterVisitor, network[i - 1]),
+          boost::apply_visitor(outputParameterVisitor, network[i])),
+          network[i]);
+      timer.Forward(i);
+
+      if (i > 0 && !kept[i - 1])
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]).reset();
+    }
+  }
+
+  double res = outputLayer.Forward(
+      boost::apply_visitor(outputParameterVisitor, network.back()),
+      responses.cols(begin, begin + batchSize - 1));
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    res += boost::apply_visitor(lossVisitor, network[i]);
+  }
+
+  outputLayer.Backward(
+      boost::apply_visitor(outputParameterVisitor, network.back()),
+      responses.cols(begin, begin + batchSize - 1),
+      error);
+
+  ResetGradients(gradient);
+  timer.Restart();
+
+  // The layers are visited from the last one.  Layer i needs its own output
+  // for its backward pass and the output of layer i - 1 for its gradient;
+  // when the output of layer i - 1 was released, the run of released outputs
+  // that ends there is computed again from the last kept output before it.
+  for (size_t i = network.size(); i-- > 0; )
+  {
+    if (i > 0 && !kept[i - 1])
+    {
+      size_t first = i - 1;
+      while (first > 0 && !kept[first - 1])
+        --first;
+
+      for (size_t j = first; j < i; ++j)
+      {
+        boost::apply_visitor(ForwardVisitor((j == 0) ? input :
+            boost::apply_visitor(outputParameterVisitor, network[j - 1]),
+            boost::apply_visitor(outputParameterVisitor, network[j])),
+            network[j]);
+        timer.Forward(j);
+      }
+    }
+
+    const arma::mat& nextDelta = (i == network.size() - 1) ? error :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+
+    // The delta of the first layer is never used.
+    if (i > 0)
+    {
+      boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
+          outputParameterVisitor, network[i]), nextDelta,
+          boost::apply_visitor(deltaVisitor, network[i])), network[i]);
+    }
+
+    boost::apply_visitor(GradientVisitor((i == 0) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]),
+        nextDelta), network[i]);
+    timer.Backward(i);
+
+    // Neither the output of this layer nor the delta of the next one is used
+    // again.
+    if (!kept[i])
+      boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    if (i < network.size() - 1)
+      boost::apply_visitor(deltaVisitor, network[i + 1]).reset();
+  }
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CheckpointEvery(const size_t k)
+{
+  checkpoints.clear();
+  if (k == 0)
+    return;
+
+  for (size_t i = k - 1; i < network.size(); i += k)
+    checkpoints.push_back(i);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t numReplicas)
+{
+  // The layers of the replicas alias the parameters, so they are only valid as
+  // long as the parameters are not reallocated.
+  if (replicas.size() != numReplicas || replicaParameter != parameter.memptr())
+  {
+    DeleteReplicas();
+    for (size_t r = 0; r < numReplicas; ++r)
+    {
+      FFN* replica = new FFN(outputLayer, initializeRule);
+      size_t offset = 0;
+      for (size_t i = 0; i < network.size(); ++i)
+      {
+        replica->network.push_back(boost::apply_visitor(copyVisitor,
+            network[i]));
+        offset += boost::apply_visitor(WeightSetVisitor(parameter, offset),
+            replica->network.back());
+        boost::apply_visitor(resetVisitor, replica->network.back());
+      }
+
+      replica->width = width;
+      replica->height = height;
+      replicas.push_back(replica);
+    }
+
+    replicaParameter = parameter.memptr();
+  }
+
+  for (size_t r = 0; r < replicas.size(); ++r)
+  {
+    if (replicas[r]->deterministic != deterministic)
+    {
+      replicas[r]->deterministic = deterministic;
+      replicas[r]->ResetDeterministic();
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t r = 0; r < replicas.size(); ++r)
+    delete replicas[r];
+
+  replicas.clear();
+  replicaGradients.clear();
+  replicaParameter = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -413,6 +839,67 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     arma::sp_mat& gradient,
+                     const size_t batchSize)
+{
+  ScopedEvaluationTimer evaluationTimer(profile.Enabled() ? &profile : NULL,
+      batchSize);
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // The buffer is not zeroed: the gradient of each dense layer is zeroed before
+  // it is computed, and the part of the Lookup layers is never used.
+  if (sparseGradientBuffer.n_elem != parameter.n_elem)
+    sparseGradientBuffer.set_size(parameter.n_rows, parameter.n_cols);
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  InitializeWorkspace(batchSize);
+  SetTargets(begin, batchSize);
+  Forward(predictors.cols(begin, begin + batchSize - 1));
+  double res = outputLayer.Forward(
+      boost::apply_visitor(outputParameterVisitor, network.back()),
+      responses.cols(begin, begin + batchSize - 1));
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    res += boost::apply_visitor(lossVisitor, network[i]);
+  }
+
+  outputLayer.Backward(
+      boost::apply_visitor(outputParameterVisitor, network.back()),
+      responses.cols(begin, begin + batchSize - 1),
+      error);
+
+  Backward();
+  ResetGradients(sparseGradientBuffer);
+  SparseGradient(predictors.cols(begin, begin + batchSize - 1), gradient);
+  UpdateWorkspaceShapes(batchSize);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
@@ -433,6 +920,273 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Freeze(
+    const double maxDensity)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  // Find the layers to keep, and the parameters each of them holds.
+  std::vector<LayerTypes<CustomLayers...> > frozenNetwork;
+  std::vector<size_t> frozenOffsets;
+  std::vector<std::pair<size_t, BatchNorm<>*> > folds;
+  std::vector<LayerTypes<CustomLayers...> > removed;
+  size_t offset = 0;
+  size_t frozenSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(weightSizeVisitor, network[i]);
+
+    // A BatchNorm layer can be folded if it normalizes every output of a
+    // Linear layer, or every output map of a Convolution layer.
+    bool foldable = false;
+    BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i]);
+    if (batchNorm && !frozenNetwork.empty())
+    {
+      const size_t size = (*batchNorm)->InputSize();
+      Linear<>** linear = boost::get<Linear<>*>(&frozenNetwork.back());
+      Convolution<>** convolution =
+          boost::get<Convolution<>*>(&frozenNetwork.back());
+      foldable = (linear && (*linear)->OutputSize() % size == 0) ||
+          (convolution && (*convolution)->OutputSize() == size);
+    }
+
+    if (boost::get<Dropout<>*>(&network[i]) ||
+        boost::get<AlphaDropout<>*>(&network[i]))
+    {
+      removed.push_back(network[i]);
+    }
+    else if (foldable)
+    {
+      folds.push_back(std::make_pair(frozenNetwork.size() - 1, *batchNorm));
+      removed.push_back(network[i]);
+    }
+    else
+    {
+      frozenNetwork.push_back(network[i]);
+      frozenOffsets.push_back(offset);
+      frozenSize += weights;
+    }
+
+    offset += weights;
+  }
+
+  // Lay the parameters of the remaining layers out again.  The layers are
+  // reset before their parameters are copied, since resetting may overwrite
+  // them (as BatchNorm does).
+  arma::mat frozenParameter(frozenSize, 1);
+  offset = 0;
+  for (size_t i = 0; i < frozenNetwork.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(WeightSetVisitor(
+        frozenParameter, offset), frozenNetwork[i]);
+    boost::apply_visitor(resetVisitor, frozenNetwork[i]);
+
+    if (weights > 0)
+    {
+      frozenParameter.rows(offset, offset + weights - 1) = parameter.rows(
+          frozenOffsets[i], frozenOffsets[i] + weights - 1);
+    }
+
+    offset += weights;
+  }
+
+  // The folded BatchNorm layers still alias the old parameters.
+  for (size_t i = 0; i < folds.size(); ++i)
+    FoldBatchNorm(frozenNetwork[folds[i].first], *folds[i].second);
+
+  for (size_t i = 0; i < removed.size(); ++i)
+    boost::apply_visitor(deleteVisitor, removed[i]);
+
+  network.swap(frozenNetwork);
+  parameter = std::move(frozenParameter);
+
+  if (maxDensity > 0.0)
+    Sparsify(maxDensity);
+
+  deterministic = true;
+  ResetDeterministic();
+
+  // Release the memory used for training.  The outputs and deltas of the
+  // layers may be views of the workspace, so they are released first.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+    boost::apply_visitor(deltaVisitor, network[i]).reset();
+  }
+
+  DeleteReplicas();
+  workspace = Workspace();
+  workspaceOutputRows.clear();
+  workspaceDeltaRows.clear();
+  predictors.reset();
+  responses.reset();
+  numFunctions = 0;
+  error.reset();
+  delta.reset();
+  inputParameter.reset();
+  outputParameter.reset();
+  gradient.reset();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Prune(
+    const double sparsity)
+{
+  if (sparsity < 0.0 || sparsity > 1.0)
+  {
+    throw std::invalid_argument("FFN<>::Prune(): sparsity must be between 0 "
+        "and 1!");
+  }
+
+  if (parameter.is_empty())
+    ResetParameters();
+
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    // The weights alias the parameters of the network.
+    arma::mat* weight = NULL;
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+      weight = &(*linear)->Weight();
+    else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(&network[i]))
+      weight = &(*linear)->Parameters();
+    else
+      continue;
+
+    const size_t numPruned = (size_t) std::floor(sparsity * weight->n_elem);
+    if (numPruned == 0)
+      continue;
+
+    const arma::uvec order = arma::sort_index(arma::abs(
+        arma::vectorise(*weight)));
+    for (size_t j = 0; j < numPruned; ++j)
+      (*weight)[order[j]] = 0.0;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Sparsify(
+    const double maxDensity)
+{
+  std::vector<size_t> offsets(network.size());
+  std::vector<bool> replaced(network.size(), false);
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i] = offset;
+    offset += boost::apply_visitor(weightSizeVisitor, network[i]);
+
+    SparseLinear<>* sparseLayer = NULL;
+    if (Linear<>** linear = boost::get<Linear<>*>(&network[i]))
+    {
+      const arma::mat& weight = (*linear)->Weight();
+      if (arma::accu(weight != 0) < maxDensity * weight.n_elem)
+      {
+        sparseLayer = new SparseLinear<>(arma::sp_mat(weight),
+            (*linear)->Bias());
+      }
+    }
+    else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(&network[i]))
+    {
+      const arma::mat weight((*linear)->Parameters().memptr(),
+          (*linear)->OutputSize(), (*linear)->InputSize(), false, true);
+      if (arma::accu(weight != 0) < maxDensity * weight.n_elem)
+        sparseLayer = new SparseLinear<>(arma::sp_mat(weight));
+    }
+
+    if (sparseLayer)
+    {
+      boost::apply_visitor(deleteVisitor, network[i]);
+      network[i] = sparseLayer;
+      replaced[i] = true;
+    }
+  }
+
+  ResetParameterLayout(offsets, replaced);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ResetParameterLayout(const std::vector<size_t>& offsets,
+                     const std::vector<bool>& replaced)
+{
+  size_t size = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    size += boost::apply_visitor(weightSizeVisitor, network[i]);
+
+  arma::mat newParameter(size, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weights = boost::apply_visitor(WeightSetVisitor(
+        newParameter, offset), network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+
+    if (weights > 0 && !replaced[i])
+    {
+      newParameter.rows(offset, offset + weights - 1) = parameter.rows(
+          offsets[i], offsets[i] + weights - 1);
+    }
+
+    offset += weights;
+  }
+
+  parameter = std::move(newParameter);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+FoldBatchNorm(LayerTypes<CustomLayers...>& layer, BatchNorm<>& batchNorm)
+{
+  // The parameters of the BatchNorm layer are gamma followed by beta.
+  const size_t size = batchNorm.InputSize();
+  const arma::mat& gammaBeta = batchNorm.Parameters();
+  const arma::mat& mean = batchNorm.TrainingMean();
+  const arma::mat& variance = batchNorm.TrainingVariance();
+
+  // Normalizing the outputs of map c is an affine map, scale * x + shift,
+  // which is folded into the weights and bias that give map c.
+  if (Linear<>** linear = boost::get<Linear<>*>(&layer))
+  {
+    arma::mat& weight = (*linear)->Weight();
+    arma::mat& bias = (*linear)->Bias();
+    const size_t mapSize = (*linear)->OutputSize() / size;
+    for (size_t c = 0; c < size; ++c)
+    {
+      const double scale = gammaBeta(c) / std::sqrt(variance(c) +
+          batchNorm.Epsilon());
+      const double shift = gammaBeta(size + c) - scale * mean(c);
+
+      weight.rows(c * mapSize, (c + 1) * mapSize - 1) *= scale;
+      bias.rows(c * mapSize, (c + 1) * mapSize - 1) *= scale;
+      bias.rows(c * mapSize, (c + 1) * mapSize - 1) += shift;
+    }
+  }
+  else if (Convolution<>** convolution = boost::get<Convolution<>*>(&layer))
+  {
+    arma::cube& weight = (*convolution)->Weight();
+    arma::mat& bias = (*convolution)->Bias();
+    const size_t inSize = (*convolution)->InputSize();
+    for (size_t c = 0; c < size; ++c)
+    {
+      const double scale = gammaBeta(c) / std::sqrt(variance(c) +
+          batchNorm.Epsilon());
+      const double shift = gammaBeta(size + c) - scale * mean(c);
+
+      // The filters of output map c are the slices c * inSize to
+      // (c + 1) * inSize - 1.
+      weight.slices(c * inSize, (c + 1) * inSize - 1) *= scale;
+      bias(c) = scale * bias(c) + shift;
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -443,6 +1197,24 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(deterministicSetVisitor));
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SetTargets(const arma::mat& targets)
+{
+  boost::apply_visitor(TargetSetVisitor(targets), network.back());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SetTargets(const size_t begin,
+                                      const size_t batchSize)
+{
+  SetTargets(arma::mat(const_cast<double*>(responses.colptr(begin)),
+      responses.n_rows, batchSize, false, true));
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -456,15 +1228,75 @@ void FFN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::InitializeWorkspace(const size_t batchSize)
+{
+  // The shapes of the layers are only known after a training pass.
+  if (workspaceOutputRows.size() != network.size())
+    return;
+
+  size_t size = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    size += (workspaceOutputRows[i] + workspaceDeltaRows[i]) * batchSize;
+
+  // All the views are made again, since reserving may move the memory.
+  workspace.Clear();
+  workspace.Reserve(size);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat& layerOutput = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    if (workspaceOutputRows[i] > 0)
+      workspace.View(layerOutput, workspaceOutputRows[i], batchSize);
+    else
+      math::ClearAlias(layerOutput);
+
+    arma::mat& layerDelta = boost::apply_visitor(deltaVisitor, network[i]);
+    if (workspaceDeltaRows[i] > 0)
+      workspace.View(layerDelta, workspaceDeltaRows[i], batchSize);
+    else
+      math::ClearAlias(layerDelta);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::UpdateWorkspaceShapes(const size_t batchSize)
+{
+  workspaceOutputRows.resize(network.size());
+  workspaceDeltaRows.resize(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    // Only outputs and deltas with one column per point can be stored.
+    const arma::mat& layerOutput = boost::apply_visitor(
+        outputParameterVisitor, network[i]);
+    workspaceOutputRows[i] = (layerOutput.n_cols == batchSize) ?
+        layerOutput.n_rows : 0;
+
+    // The delta of the first layer is never computed.
+    const arma::mat& layerDelta = boost::apply_visitor(deltaVisitor,
+        network[i]);
+    workspaceDeltaRows[i] = (i > 0 && layerDelta.n_cols == batchSize) ?
+        layerDelta.n_rows : 0;
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(const InputType& input)
 {
+  MLPACK_PROFILE_SCOPE(FFN_FORWARD);
+  LayerTimer timer(profile.Enabled() ? &profile : NULL);
+
   boost::apply_visitor(ForwardVisitor(input,
       boost::apply_visitor(outputParameterVisitor, network.front())),
       network.front());
+  timer.Forward(0);
 
   if (!reset)
   {
@@ -493,6 +1325,7 @@ void FFN<OutputLayerType, InitializationRuleType,
     boost::apply_visitor(ForwardVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(outputParameterVisitor, network[i])), network[i]);
+    timer.Forward(i);
 
     if (!reset)
     {
@@ -518,9 +1351,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  MLPACK_PROFILE_SCOPE(FFN_BACKWARD);
+  LayerTimer timer(profile.Enabled() ? &profile : NULL);
+
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network.back()), error,
       boost::apply_visitor(deltaVisitor, network.back())), network.back());
+  timer.Backward(network.size() - 1);
 
   for (size_t i = 2; i < network.size(); ++i)
   {
@@ -529,6 +1366,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]),
         boost::apply_visitor(deltaVisitor, network[network.size() - i])),
         network[network.size() - i]);
+    timer.Backward(network.size() - i);
   }
 }
 
@@ -538,19 +1376,101 @@ template<typename InputType>
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(const InputType& input)
 {
+  MLPACK_PROFILE_SCOPE(FFN_BACKWARD);
+  LayerTimer timer(profile.Enabled() ? &profile : NULL);
+
   boost::apply_visitor(GradientVisitor(input,
       boost::apply_visitor(deltaVisitor, network[1])), network.front());
+  timer.Backward(0);
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
     boost::apply_visitor(GradientVisitor(boost::apply_visitor(
         outputParameterVisitor, network[i - 1]),
         boost::apply_visitor(deltaVisitor, network[i + 1])), network[i]);
+    timer.Backward(i);
   }
 
   boost::apply_visitor(GradientVisitor(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2]), error),
       network[network.size() - 1]);
+  timer.Backward(network.size() - 1);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename InputType>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+SparseGradient(const InputType& input, arma::sp_mat& gradient)
+{
+  MLPACK_PROFILE_SCOPE(FFN_BACKWARD);
+
+  LayerTimer timer(profile.Enabled() ? &profile : NULL);
+
+  // The nonzero elements are found in increasing order, since the layers are
+  // visited in the order of their parameters.
+  std::vector<arma::uword> rows;
+  std::vector<double> values;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weightSize = boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+    const arma::mat& layerError = (i + 1 < network.size()) ?
+        boost::apply_visitor(deltaVisitor, network[i + 1]) : error;
+
+    Lookup<arma::mat, arma::mat>** lookup =
+        boost::get<Lookup<arma::mat, arma::mat>*>(&network[i]);
+    if (lookup != NULL)
+    {
+      // A Lookup layer is always the first layer.
+      arma::uvec tokens;
+      arma::mat tokenGradients;
+      (*lookup)->SparseGradient(arma::mat(input), layerError, tokens,
+          tokenGradients);
+
+      const size_t embeddingSize = (*lookup)->EmbeddingSize();
+      for (size_t t = 0; t < tokens.n_elem; ++t)
+      {
+        for (size_t r = 0; r < embeddingSize; ++r)
+        {
+          rows.push_back(offset + tokens[t] * embeddingSize + r);
+          values.push_back(tokenGradients(r, t));
+        }
+      }
+    }
+    else
+    {
+      if (weightSize > 0)
+        sparseGradientBuffer.rows(offset, offset + weightSize - 1).zeros();
+
+      if (i == 0)
+      {
+        boost::apply_visitor(GradientVisitor(input, layerError), network[i]);
+      }
+      else
+      {
+        boost::apply_visitor(GradientVisitor(boost::apply_visitor(
+            outputParameterVisitor, network[i - 1]), layerError), network[i]);
+      }
+
+      for (size_t j = offset; j < offset + weightSize; ++j)
+      {
+        rows.push_back(j);
+        values.push_back(sparseGradientBuffer[j]);
+      }
+    }
+
+    offset += weightSize;
+    timer.Backward(i);
+  }
+
+  // The parameters are a single column.
+  arma::uvec colPtrs(2);
+  colPtrs[0] = 0;
+  colPtrs[1] = rows.size();
+  gradient = arma::sp_mat(arma::uvec(rows), colPtrs, arma::vec(values),
+      parameter.n_rows, parameter.n_cols);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -568,6 +1488,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   // Be sure to clear other layers before loading.
   if (cereal::is_loading<Archive>())
   {
+    DeleteReplicas();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -613,6 +1534,15 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(workspace, network.workspace);
+  std::swap(workspaceOutputRows, network.workspaceOutputRows);
+  std::swap(workspaceDeltaRows, network.workspaceDeltaRows);
+  std::swap(numThreads, network.numThreads);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaParameter, network.replicaParameter);
+  std::swap(replicaGradients, network.replicaGradients);
+  std::swap(checkpoints, network.checkpoints);
+  std::swap(profile, network.profile);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -633,7 +1563,13 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    workspaceOutputRows(network.workspaceOutputRows),
+    workspaceDeltaRows(network.workspaceDeltaRows),
+    numThreads(network.numThreads),
+    replicaParameter(NULL),
+    checkpoints(network.checkpoints),
+    profile(network.profile)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -662,8 +1598,19 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    workspace(std::move(network.workspace)),
+    workspaceOutputRows(std::move(network.workspaceOutputRows)),
+    workspaceDeltaRows(std::move(network.workspaceDeltaRows)),
+    numThreads(network.numThreads),
+    replicas(std::move(network.replicas)),
+    replicaParameter(network.replicaParameter),
+    replicaGradients(std::move(network.replicaGradients)),
+    checkpoints(std::move(network.checkpoints)),
+    profile(std::move(network.profile))
 {
+  network.replicas.clear();
+  network.replicaParameter = NULL;
   this->network = std::move(network.network);
 };
 
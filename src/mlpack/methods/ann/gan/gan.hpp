@@ -313,6 +313,19 @@ class GAN
   //! Modify the discriminator of the GAN.
   Model& Discriminator() { return discriminator; }
 
+  /**
+   * Get whether the Standard GAN and DCGAN evaluate the discriminator on the
+   * real and fake points of a batch with a single pass of twice the batch
+   * size, instead of two passes.  This gives larger matrix products, and more
+   * points to split across the threads when the discriminator is trained in
+   * parallel (see FFN::NumThreads()).  Layers whose output depends on the
+   * other points of the batch, such as BatchNorm, see the real and fake points
+   * together, so this is off by default.
+   */
+  bool BatchDiscriminator() const { return batchDiscriminator; }
+  //! Modify whether the discriminator is evaluated with a single pass.
+  bool& BatchDiscriminator() { return batchDiscriminator; }
+
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
@@ -369,6 +382,8 @@ class GAN
   double lambda;
   //! Locally stored reset parameter.
   bool reset;
+  //! Locally stored indicator of a single discriminator pass.
+  bool batchDiscriminator;
   //! Locally stored delta visitor.
   DeltaVisitor deltaVisitor;
   //! Locally stored responses.
@@ -54,6 +54,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(clippingParameter),
     lambda(lambda),
     reset(false),
+    batchDiscriminator(false),
     deterministic(false),
     genWeights(0),
     discWeights(0)
@@ -86,6 +87,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    batchDiscriminator(network.batchDiscriminator),
     currentBatch(network.currentBatch),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
@@ -119,6 +121,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    batchDiscriminator(network.batchDiscriminator),
     currentBatch(network.currentBatch),
     parameter(std::move(network.parameter)),
     numFunctions(network.numFunctions),
@@ -148,16 +151,19 @@ void GAN<Model, InitializationRuleType, Noise, PolicyType>::ResetData(
   ResetDeterministic();
 
   /**
-   * These predictors are shared by the discriminator network. The additional
-   * batch size predictors are taken from the generator network while training.
-   * For more details please look in EvaluateWithGradient() function.
+   * These predictors are shared by the discriminator network. The first
+   * additional batch size predictors are taken from the generator network
+   * while training, and the last ones hold a copy of the current batch of real
+   * data, so that the discriminator can see the fake and real points in a
+   * single pass (see BatchDiscriminator()). For more details please look in
+   * EvaluateWithGradient() function.
    */
-  this->predictors.set_size(trainData.n_rows, numFunctions + batchSize);
+  this->predictors.set_size(trainData.n_rows, numFunctions + 2 * batchSize);
   this->predictors.cols(0, numFunctions - 1) = std::move(trainData);
   this->discriminator.predictors = arma::mat(this->predictors.memptr(),
       this->predictors.n_rows, this->predictors.n_cols, false, false);
 
-  responses.ones(1, numFunctions + batchSize);
+  responses.ones(1, numFunctions + 2 * batchSize);
   responses.cols(numFunctions, numFunctions + batchSize - 1) =
       arma::zeros(1, batchSize);
   this->discriminator.responses = arma::mat(this->responses.memptr(),
@@ -252,6 +258,26 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
     ResetDeterministic();
   }
 
+  if (batchDiscriminator)
+  {
+    // Evaluate the discriminator on the fake and real points together.
+    noise.imbue( [&]() { return noiseFunction();} );
+    generator.Forward(noise);
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, generator.network.back());
+    predictors.cols(numFunctions + batchSize, numFunctions + 2 * batchSize -
+        1) = predictors.cols(i, i + batchSize - 1);
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        arma::zeros(1, batchSize);
+
+    discriminator.Forward(predictors.cols(numFunctions,
+        numFunctions + 2 * batchSize - 1));
+    return discriminator.outputLayer.Forward(
+        boost::apply_visitor(outputParameterVisitor,
+        discriminator.network.back()), responses.cols(numFunctions,
+        numFunctions + 2 * batchSize - 1));
+  }
+
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
@@ -334,24 +360,54 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
+  double res;
+  if (batchDiscriminator)
+  {
+    // Get the gradients of the Discriminator on the fake and real points with
+    // a single pass.  The loss of the output layer sums over the points, so
+    // this is the sum of the two passes done otherwise.
+    noise.imbue( [&]() { return noiseFunction();} );
+    generator.Forward(noise);
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, generator.network.back());
+    predictors.cols(numFunctions + batchSize, numFunctions + 2 * batchSize -
+        1) = predictors.cols(i, i + batchSize - 1);
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        arma::zeros(1, batchSize);
 
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(noise);
-  predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      arma::zeros(1, batchSize);
+    res = discriminator.EvaluateWithGradient(discriminator.parameter,
+        numFunctions, gradientDiscriminator, 2 * batchSize);
+  }
+  else
+  {
+    // Get the gradients of the Discriminator.
+    res = discriminator.EvaluateWithGradient(discriminator.parameter,
+        i, gradientDiscriminator, batchSize);
+
+    noise.imbue( [&]() { return noiseFunction();} );
+    generator.Forward(noise);
+    predictors.cols(numFunctions, numFunctions + batchSize - 1) =
+        boost::apply_visitor(outputParameterVisitor, generator.network.back());
+    responses.cols(numFunctions, numFunctions + batchSize - 1) =
+        arma::zeros(1, batchSize);
 
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
-  gradientDiscriminator += noiseGradientDiscriminator;
+    // Get the gradients of the Generator.
+    res += discriminator.EvaluateWithGradient(discriminator.parameter,
+        numFunctions, noiseGradientDiscriminator, batchSize);
+    gradientDiscriminator += noiseGradientDiscriminator;
+  }
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
+    // The discriminator has to hold its outputs for the fake points only.
+    // This isn't the case after a single pass over the fake and real points,
+    // or if the pass was split across the replicas of the discriminator.
+    if (batchDiscriminator || discriminator.numThreads > 1)
+    {
+      discriminator.Forward(predictors.cols(numFunctions,
+          numFunctions + batchSize - 1));
+    }
+
     // Minimize -log(D(G(noise))).
     // Pass the error from Discriminator to Generator.
     responses.cols(numFunctions, numFunctions + batchSize - 1) =
@@ -171,6 +171,14 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
+    // If the last pass was split across the replicas of the discriminator,
+    // the discriminator only holds the outputs of a part of the fake points.
+    if (discriminator.numThreads > 1)
+    {
+      discriminator.Forward(predictors.cols(numFunctions,
+          numFunctions + batchSize - 1));
+    }
+
     // Minimize -D(G(noise)).
     // Pass the error from Discriminator to Generator.
     responses.cols(numFunctions, numFunctions + batchSize - 1) =
@@ -211,37 +211,16 @@ void AtrousConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+      padding.PadHTop() != 0 || padding.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
-
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
+    ForwardConvolution(inputPaddedTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+  else
+  {
+    ForwardConvolution(inputTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
   }
 
   outputWidth = outputTemp.n_rows;
@@ -273,38 +252,8 @@ void AtrousConvolution<
       inSize * batchSize, false, false);
   gTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
-  {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> output, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-          rotatedFilter, output, strideWidth, strideHeight, dilationWidth,
-          dilationHeight);
-
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        gTemp.slice(inMap + batchCount * inSize) +=
-            output.submat(padding.PadWLeft(), padding.PadHTop(),
-                          padding.PadWLeft() + gTemp.n_rows - 1,
-                          padding.PadHTop() + gTemp.n_cols - 1);
-      }
-      else
-      {
-        gTemp.slice(inMap + batchCount * inSize) += output;
-      }
-    }
-  }
+  BackwardConvolution(mappedError, typename std::is_same<
+      BackwardConvolutionRule, Im2ColConvolution<FullConvolution>>::type());
 }
 
 template<
@@ -400,6 +349,179 @@ void AtrousConvolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::true_type)
+{
+  // Each point is a single product of its lowered input maps with all the
+  // filters, which are already stored as the filter bank the product needs.
+  const arma::Mat<eT> filters(weight.memptr(), weight.n_rows * weight.n_cols *
+      inSize, outSize, false, true);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    arma::Mat<eT> outputMaps(outputTemp.slice(b * outSize).memptr(),
+        outputTemp.n_rows * outputTemp.n_cols, outSize, false, true);
+
+    size_t outputRows, outputCols;
+    ForwardConvolutionRule::MultiChannelConvolution(input, b * inSize, inSize,
+        filters, kernelWidth, kernelHeight, outputMaps, outputRows, outputCols,
+        strideWidth, strideHeight, dilationWidth, dilationHeight);
+
+    outputMaps.each_row() += bias.t();
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::false_type)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> convOutput;
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), weight.slice(outMapIdx), convOutput,
+          strideWidth, strideHeight, dilationWidth, dilationHeight);
+
+      outputTemp.slice(outMap) += convOutput;
+    }
+
+    outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error, std::true_type)
+{
+  arma::Mat<eT> filters;
+  BackwardConvolutionRule::FilterBank(weight, inSize, outSize, true, true,
+      filters);
+
+  arma::Mat<eT> inputMaps;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    size_t outputRows, outputCols;
+    BackwardConvolutionRule::MultiChannelConvolution(error, b * outSize,
+        outSize, filters, kernelWidth, kernelHeight, inputMaps, outputRows,
+        outputCols, strideWidth, strideHeight, dilationWidth, dilationHeight);
+
+    for (size_t inMap = 0; inMap < inSize; inMap++)
+    {
+      const arma::Mat<eT> output(inputMaps.colptr(inMap), outputRows,
+          outputCols, false, true);
+
+      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+      {
+        gTemp.slice(inMap + b * inSize) +=
+            output.submat(padding.PadWLeft(), padding.PadHTop(),
+                          padding.PadWLeft() + gTemp.n_rows - 1,
+                          padding.PadHTop() + gTemp.n_cols - 1);
+      }
+      else
+      {
+        gTemp.slice(inMap + b * inSize) += output;
+      }
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void AtrousConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error, std::false_type)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> output, rotatedFilter;
+      Rotate180(weight.slice(outMapIdx), rotatedFilter);
+
+      BackwardConvolutionRule::Convolution(error.slice(outMap),
+          rotatedFilter, output, strideWidth, strideHeight, dilationWidth,
+          dilationHeight);
+
+      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+      {
+        gTemp.slice(inMap + batchCount * inSize) +=
+            output.submat(padding.PadWLeft(), padding.PadHTop(),
+                          padding.PadWLeft() + gTemp.n_rows - 1,
+                          padding.PadHTop() + gTemp.n_cols - 1);
+      }
+      else
+      {
+        gTemp.slice(inMap + batchCount * inSize) += output;
+      }
+    }
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
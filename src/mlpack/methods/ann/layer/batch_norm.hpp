@@ -232,8 +232,15 @@ class BatchNorm
   //! Locally-stored normalized input.
   arma::cube normalized;
 
-  //! Locally-stored zero mean input.
-  arma::cube inputMean;
+  //! Locally-stored inverse standard deviation of each channel.
+  OutputDataType stdInv;
+
+  //! Locally-stored sum over the batch of the error of the normalized input.
+  arma::vec normSum;
+
+  //! Locally-stored sum over the batch of the error of the normalized input
+  //! times the normalized input.
+  arma::vec normXHatSum;
 }; // class BatchNorm
 
 } // namespace ann
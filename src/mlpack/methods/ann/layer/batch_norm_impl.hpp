@@ -99,40 +99,58 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
           " greater than 1 to fix the warning." << std::endl;
     }
 
-    // Input corresponds to output from convolution layer.
-    // Use a cube for simplicity.
-    arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
-        inputSize, size, batchSize, false, false);
-
-    // Initialize output to same size and values for convenience.
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        inputSize, size, batchSize, false, false);
-    outputTemp = inputTemp;
-
-    // Calculate mean and variance over all channels.
-    mean = arma::mean(arma::mean(inputTemp, 2), 0);
-    variance = arma::mean(arma::mean(arma::pow(
-        inputTemp.each_slice() - arma::repmat(mean,
-        inputSize, 1), 2), 2), 0);
-
-    outputTemp.each_slice() -= arma::repmat(mean, inputSize, 1);
-
-    // Used in backward propagation.
-    inputMean.set_size(arma::size(inputTemp));
-    inputMean = outputTemp;
-
-    // Normalize output.
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(variance,
-        inputSize, 1) + eps);
-
-    // Re-used in backward propagation.
-    normalized.set_size(arma::size(inputTemp));
-    normalized = outputTemp;
+    // Input corresponds to output from convolution layer: each column holds
+    // the inputSize elements of each channel in turn.  The mean and the
+    // variance of each channel are computed in a single pass over the input,
+    // merging the statistics of each block of inputSize elements (Chan et
+    // al.'s update of Welford's algorithm).
+    mean.set_size(1, size);
+    variance.set_size(1, size);
+    stdInv.set_size(1, size);
+    for (size_t c = 0; c < size; ++c)
+    {
+      double channelMean = 0.0, channelM2 = 0.0;
+      size_t n = 0;
+      for (size_t b = 0; b < batchSize; ++b)
+      {
+        const eT* x = input.colptr(b) + c * inputSize;
+        double blockMean = 0.0;
+        for (size_t i = 0; i < inputSize; ++i)
+          blockMean += x[i];
+        blockMean /= inputSize;
+
+        double blockM2 = 0.0;
+        for (size_t i = 0; i < inputSize; ++i)
+          blockM2 += (x[i] - blockMean) * (x[i] - blockMean);
+
+        const double delta = blockMean - channelMean;
+        n += inputSize;
+        channelMean += delta * inputSize / n;
+        channelM2 += blockM2 + delta * delta * (n - inputSize) * inputSize / n;
+      }
+
+      mean(c) = channelMean;
+      variance(c) = channelM2 / n;
+      stdInv(c) = 1.0 / std::sqrt(variance(c) + eps);
+    }
 
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        inputSize, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        inputSize, 1);
+    // Normalize, scale and shift the input in a single pass; the normalized
+    // input is kept for the backward pass.
+    normalized.set_size(inputSize, size, batchSize);
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const eT* x = input.colptr(b);
+      double* xHat = normalized.slice(b).memptr();
+      eT* y = output.colptr(b);
+      for (size_t c = 0; c < size; ++c)
+      {
+        for (size_t i = 0; i < inputSize; ++i, ++x, ++xHat, ++y)
+        {
+          *xHat = (*x - mean(c)) * stdInv(c);
+          *y = gamma(c) * *xHat + beta(c);
+        }
+      }
+    }
 
     count += 1;
     averageFactor = average ? 1.0 / count : momentum;
@@ -150,19 +168,20 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   }
   else
   {
-    // Normalize the input and scale and shift the output.
-    output = input;
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
-        input.n_rows / size, size, batchSize, false, false);
-
-    outputTemp.each_slice() -= arma::repmat(runningMean.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() /= arma::sqrt(arma::repmat(runningVariance.t(),
-        input.n_rows / size, 1) + eps);
-    outputTemp.each_slice() %= arma::repmat(gamma.t(),
-        input.n_rows / size, 1);
-    outputTemp.each_slice() += arma::repmat(beta.t(),
-        input.n_rows / size, 1);
+    // Normalize the input and scale and shift the output, as a single scale
+    // and shift of each channel.
+    const arma::vec scale = gamma / arma::sqrt(runningVariance + eps);
+    const arma::vec shift = beta - runningMean % scale;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      const eT* x = input.colptr(b);
+      eT* y = output.colptr(b);
+      for (size_t c = 0; c < size; ++c)
+      {
+        for (size_t i = 0; i < inputSize; ++i, ++x, ++y)
+          *y = scale(c) * *x + shift(c);
+      }
+    }
   }
 }
 
@@ -173,35 +192,46 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const size_t batchSize = input.n_cols;
+  const size_t inputSize = input.n_rows / size;
 
+  // For each element of the input, the sums over the batch of
+  // dl / dxhat = dl / dy * gamma and of dl / dxhat * xhat.
+  normSum.zeros(input.n_rows, 1);
+  normXHatSum.zeros(input.n_rows, 1);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    const eT* error = gy.colptr(b);
+    const double* xHat = normalized.slice(b).memptr();
+    for (size_t c = 0, k = 0; c < size; ++c)
+    {
+      for (size_t i = 0; i < inputSize; ++i, ++k)
+      {
+        const double norm = error[k] * gamma(c);
+        normSum[k] += norm;
+        normXHatSum[k] += norm * xHat[k];
+      }
+    }
+  }
+
+  // dl / dx = stdInv / m * (dl / dxhat - sum dl / dxhat -
+  // xhat * sum dl / dxhat * xhat), using the saved inverse standard deviation.
   g.set_size(arma::size(input));
-  arma::cube gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-  arma::cube gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
-      input.n_rows / size, size, input.n_cols, false, false);
-
-  // Step 1: dl / dxhat.
-  arma::cube norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
-      input.n_rows / size, 1);
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  arma::mat temp = arma::sum(norm % inputMean, 2);
-  arma::mat vars = temp % arma::repmat(arma::pow(stdInv, 3),
-      input.n_rows / size, 1) * -0.5;
-
-  // Step 3: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  gTemp = (norm.each_slice() % arma::repmat(stdInv,
-      input.n_rows / size, 1) +
-      (inputMean.each_slice() % vars * 2)) / input.n_cols;
-
-  // Step 4: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  arma::mat normTemp = arma::sum(norm.each_slice() %
-      arma::repmat(-stdInv, input.n_rows / size, 1) , 2) /
-      input.n_cols;
-  gTemp.each_slice() += normTemp;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    const eT* error = gy.colptr(b);
+    const double* xHat = normalized.slice(b).memptr();
+    eT* delta = g.colptr(b);
+    for (size_t c = 0, k = 0; c < size; ++c)
+    {
+      const double factor = stdInv(c) / batchSize;
+      for (size_t i = 0; i < inputSize; ++i, ++k)
+      {
+        delta[k] = factor * (error[k] * gamma(c) - normSum[k] -
+            xHat[k] * normXHatSum[k]);
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -211,17 +241,23 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
-  arma::cube errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      error.n_rows / size, size, error.n_cols, false, false);
+  const size_t inputSize = error.n_rows / size;
 
-  // Step 5: dl / dy * xhat.
-  arma::mat temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = temp.t();
-
-  // Step 6: dl / dy.
-  temp = arma::sum(arma::sum(errorTemp, 0), 2);
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) = temp.t();
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in a single pass.
+  gradient.zeros(size + size, 1);
+  for (size_t b = 0; b < error.n_cols; ++b)
+  {
+    const eT* e = error.colptr(b);
+    const double* xHat = normalized.slice(b).memptr();
+    for (size_t c = 0; c < size; ++c)
+    {
+      for (size_t i = 0; i < inputSize; ++i, ++e, ++xHat)
+      {
+        gradient(c) += *e * *xHat;
+        gradient(size + c) += *e;
+      }
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -206,6 +206,24 @@ class Concat
   void serialize(Archive& ar,  const uint32_t /* version */);
 
  private:
+  /**
+   * Make the given matrix an alias of the rows of the error that belong to the
+   * module whose output starts at the given row.  The rows are contiguous if
+   * there is a single module or a single column (once the channels are taken
+   * into account); otherwise, they are copied into a buffer that is reused
+   * between passes.
+   *
+   * @param error The error of the concatenated output.
+   * @param rowCount The first row of the output of the module.
+   * @param rows The number of rows of the output of the module.
+   * @param slice The matrix to make an alias of the error of the module.
+   */
+  template<typename eT>
+  void ErrorRows(const arma::Mat<eT>& error,
+                 const size_t rowCount,
+                 const size_t rows,
+                 arma::Mat<eT>& slice);
+
   //! Parameter which indicates the input size of modules.
   arma::Row<size_t> inputSize;
 
@@ -254,6 +272,9 @@ class Concat
 
   //! Locally-stored gradient object.
   arma::mat gradient;
+
+  //! Locally-stored buffer of the error of a module.
+  arma::mat errorRows;
 }; // class Concat
 
 } // namespace ann
@@ -114,23 +114,35 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     }
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.front());
+  // The outputs of the modules are written into their rows of the output,
+  // which keeps its memory between passes if its size doesn't change.
+  size_t outputRows = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    outputRows += boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+  }
+
+  const size_t cols = boost::apply_visitor(outputParameterVisitor,
+      network.front()).n_cols;
+  output.set_size(outputRows, cols);
 
   // Reshape output to incorporate the channels.
-  output.reshape(output.n_rows / channels, output.n_cols * channels);
+  arma::Mat<eT> outputTmp(output.memptr(), outputRows / channels,
+      cols * channels, false, true);
 
-  for (size_t i = 1; i < network.size(); ++i)
+  size_t rowCount = 0;
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    arma::Mat<eT> out = boost::apply_visitor(outputParameterVisitor,
+    arma::Mat<eT>& out = boost::apply_visitor(outputParameterVisitor,
         network[i]);
 
-    out.reshape(out.n_rows / channels, out.n_cols * channels);
-
-    // Vertically concatentate output from each layer.
-    output = arma::join_cols(output, out);
+    // Vertically concatenate the output of each layer.
+    outputTmp.rows(rowCount / channels, (rowCount + out.n_rows) / channels -
+        1) = arma::Mat<eT>(out.memptr(), out.n_rows / channels,
+        out.n_cols * channels, false, true);
+    rowCount += out.n_rows;
   }
-  // Reshape output to its original shape.
-  output.reshape(output.n_rows * channels, output.n_cols / channels);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -143,8 +155,6 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
   if (run)
   {
     arma::Mat<eT> delta;
-    arma::Mat<eT> gyTmp(((arma::Mat<eT>&) gy).memptr(), gy.n_rows / channels,
-        gy.n_cols * channels, false, false);
     for (size_t i = 0; i < network.size(); ++i)
     {
       // Use rows from the error corresponding to the output from each layer.
@@ -152,8 +162,7 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
           outputParameterVisitor, network[i]).n_rows;
 
       // Extract from gy the parameters for the i-th network.
-      delta = gyTmp.rows(rowCount / channels, (rowCount + rows) / channels - 1);
-      delta.reshape(delta.n_rows * channels, delta.n_cols / channels);
+      ErrorRows(gy, rowCount, rows, delta);
 
       boost::apply_visitor(BackwardVisitor(
           boost::apply_visitor(outputParameterVisitor,
@@ -192,13 +201,9 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
   }
   rows = boost::apply_visitor(outputParameterVisitor, network[index]).n_rows;
 
-  // Reshape gy to extract the i-th layer gy.
-  arma::Mat<eT> gyTmp(((arma::Mat<eT>&) gy).memptr(), gy.n_rows / channels,
-      gy.n_cols * channels, false, false);
-
-  arma::Mat<eT> delta = gyTmp.rows(rowCount / channels, (rowCount + rows) /
-      channels - 1);
-  delta.reshape(delta.n_rows * channels, delta.n_cols / channels);
+  // Extract the i-th layer gy.
+  arma::Mat<eT> delta;
+  ErrorRows(gy, rowCount, rows, delta);
 
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
       outputParameterVisitor, network[index]), delta,
@@ -218,18 +223,14 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   if (run)
   {
     size_t rowCount = 0;
-    // Reshape error to extract the i-th layer error.
-    arma::Mat<eT> errorTmp(((arma::Mat<eT>&) error).memptr(),
-        error.n_rows / channels, error.n_cols * channels, false, false);
+    arma::Mat<eT> err;
     for (size_t i = 0; i < network.size(); ++i)
     {
       size_t rows = boost::apply_visitor(
           outputParameterVisitor, network[i]).n_rows;
 
       // Extract from error the parameters for the i-th network.
-      arma::Mat<eT> err = errorTmp.rows(rowCount / channels, (rowCount + rows) /
-          channels - 1);
-      err.reshape(err.n_rows * channels, err.n_cols / channels);
+      ErrorRows(error, rowCount, rows, err);
 
       boost::apply_visitor(GradientVisitor(input, err), network[i]);
       rowCount += rows;
@@ -255,15 +256,38 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   size_t rows = boost::apply_visitor(
       outputParameterVisitor, network[index]).n_rows;
 
-  arma::Mat<eT> errorTmp(((arma::Mat<eT>&) error).memptr(),
-      error.n_rows / channels, error.n_cols * channels, false, false);
-  arma::Mat<eT> err = errorTmp.rows(rowCount / channels, (rowCount + rows) /
-      channels - 1);
-  err.reshape(err.n_rows * channels, err.n_cols / channels);
+  arma::Mat<eT> err;
+  ErrorRows(error, rowCount, rows, err);
 
   boost::apply_visitor(GradientVisitor(input, err), network[index]);
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename eT>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::ErrorRows(
+    const arma::Mat<eT>& error,
+    const size_t rowCount,
+    const size_t rows,
+    arma::Mat<eT>& slice)
+{
+  eT* errorPtr = const_cast<eT*>(error.memptr());
+  if (network.size() == 1 || error.n_cols * channels == 1)
+  {
+    slice = arma::Mat<eT>(errorPtr + rowCount, rows, error.n_cols, false,
+        false);
+    return;
+  }
+
+  // Reshape the error to extract the rows of the module, and then give them
+  // the shape of the output of the module.
+  arma::Mat<eT> errorTmp(errorPtr, error.n_rows / channels,
+      error.n_cols * channels, false, false);
+  errorRows = errorTmp.rows(rowCount / channels, (rowCount + rows) / channels -
+      1);
+  slice = arma::Mat<eT>(errorRows.memptr(), rows, error.n_cols, false, false);
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
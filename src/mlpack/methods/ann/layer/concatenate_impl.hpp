@@ -16,6 +16,8 @@
 // In case it hasn't yet been included.
 #include "concatenate.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -91,8 +93,13 @@ void Concatenate<InputDataType, OutputDataType>::Forward(
         << "to the number of columns of input matrix." << std::endl;
   }
 
+  // The input and the concat matrix are written into their rows of the
+  // output, which keeps its memory between passes if its size doesn't change.
   inRows = input.n_rows;
-  output = arma::join_cols(input, concat);
+  output.set_size(inRows + concat.n_rows, input.n_cols);
+  output.rows(0, inRows - 1) = input;
+  if (!concat.is_empty())
+    output.rows(inRows, output.n_rows - 1) = concat;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -102,7 +109,18 @@ void Concatenate<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  g = gy.submat(0, 0, inRows - 1, concat.n_cols - 1);
+  // The rows of the input are contiguous in the error if there is a single
+  // column or nothing was concatenated, so then the delta is a view.
+  if (gy.n_cols == 1 || gy.n_rows == inRows)
+  {
+    g = arma::Mat<eT>(const_cast<eT*>(gy.memptr()), inRows, gy.n_cols, false,
+        false);
+  }
+  else
+  {
+    math::ClearAlias(g);
+    g = gy.rows(0, inRows - 1);
+  }
 }
 
 } // namespace ann
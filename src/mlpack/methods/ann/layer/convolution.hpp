@@ -16,6 +16,7 @@
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
@@ -68,9 +69,9 @@ namespace ann /** Artificial Neural Network. */ {
  *         arma::sp_mat or arma::cube).
  */
 template <
-    typename ForwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename BackwardConvolutionRule = NaiveConvolution<FullConvolution>,
-    typename GradientConvolutionRule = NaiveConvolution<ValidConvolution>,
+    typename ForwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename BackwardConvolutionRule = Im2ColConvolution<FullConvolution>,
+    typename GradientConvolutionRule = Im2ColConvolution<ValidConvolution>,
     typename InputDataType = arma::mat,
     typename OutputDataType = arma::mat
 >
@@ -325,6 +326,53 @@ class Convolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Compute the output of the layer for the given (padded) input, with one
+   * matrix product per point, when the forward rule is Im2ColConvolution.
+   */
+  template<typename eT>
+  void ForwardConvolution(const arma::Cube<eT>& input, std::true_type);
+
+  /*
+   * Compute the output of the layer for the given (padded) input, one pair of
+   * maps at a time, with any other forward rule.
+   */
+  template<typename eT>
+  void ForwardConvolution(const arma::Cube<eT>& input, std::false_type);
+
+  /*
+   * Propagate the given error back through the layer, with one matrix product
+   * per point, when the backward rule is Im2ColConvolution.
+   */
+  template<typename eT>
+  void BackwardConvolution(const arma::Cube<eT>& error, std::true_type);
+
+  /*
+   * Propagate the given error back through the layer, one pair of maps at a
+   * time, with any other backward rule.
+   */
+  template<typename eT>
+  void BackwardConvolution(const arma::Cube<eT>& error, std::false_type);
+
+  /*
+   * Compute the gradient of the filters for the given (padded) input and
+   * error, with one matrix product per point, when the gradient rule is
+   * Im2ColConvolution.
+   */
+  template<typename eT>
+  void GradientConvolution(const arma::Cube<eT>& input,
+                           const arma::Cube<eT>& error,
+                           std::true_type);
+
+  /*
+   * Compute the gradient of the filters for the given (padded) input and
+   * error, one pair of maps at a time, with any other gradient rule.
+   */
+  template<typename eT>
+  void GradientConvolution(const arma::Cube<eT>& input,
+                           const arma::Cube<eT>& error,
+                           std::false_type);
+
   /*
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
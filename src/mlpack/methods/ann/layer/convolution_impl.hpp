@@ -199,6 +199,148 @@ void Convolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
+  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+  {
+    ForwardConvolution(inputPaddedTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+  else
+  {
+    ForwardConvolution(inputTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+
+  outputWidth = outputTemp.n_rows;
+  outputHeight = outputTemp.n_cols;
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
+      outputHeight, outSize * batchSize, false, false);
+
+  g.set_size(inputWidth * inputHeight * inSize, batchSize);
+  gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight,
+      inSize * batchSize, false, false);
+  gTemp.zeros();
+
+  BackwardConvolution(mappedError, typename std::is_same<
+      BackwardConvolutionRule, Im2ColConvolution<FullConvolution>>::type());
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::Mat<eT>& gradient)
+{
+  arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
+      outputHeight, outSize * batchSize, false, false);
+  arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
+      inputHeight, inSize * batchSize, false, false);
+
+  gradient.set_size(weights.n_elem, 1);
+  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
+      weight.n_cols, weight.n_slices, false, false);
+  gradientTemp.zeros();
+
+  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+  {
+    GradientConvolution(inputPaddedTemp, mappedError, typename std::is_same<
+        GradientConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+  else
+  {
+    GradientConvolution(inputTemp, mappedError, typename std::is_same<
+        GradientConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
+  {
+    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
+        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::true_type)
+{
+  // Each point is a single product of its lowered input maps with all the
+  // filters, which are already stored as the filter bank the product needs.
+  const arma::Mat<eT> filters(weight.memptr(), weight.n_rows * weight.n_cols *
+      inSize, outSize, false, true);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    arma::Mat<eT> outputMaps(outputTemp.slice(b * outSize).memptr(),
+        outputTemp.n_rows * outputTemp.n_cols, outSize, false, true);
+
+    size_t outputRows, outputCols;
+    ForwardConvolutionRule::MultiChannelConvolution(input, b * inSize, inSize,
+        filters, kernelWidth, kernelHeight, outputMaps, outputRows, outputCols,
+        strideWidth, strideHeight);
+
+    outputMaps.each_row() += bias.t();
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::false_type)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -211,28 +353,61 @@ void Convolution<
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
       arma::Mat<eT> convOutput;
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), weight.slice(outMapIdx), convOutput,
+          strideWidth, strideHeight);
+
+      outputTemp.slice(outMap) += convOutput;
+    }
+
+    outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error, std::true_type)
+{
+  arma::Mat<eT> filters;
+  BackwardConvolutionRule::FilterBank(weight, inSize, outSize, true, true,
+      filters);
+
+  arma::Mat<eT> inputMaps;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    size_t outputRows, outputCols;
+    BackwardConvolutionRule::MultiChannelConvolution(error, b * outSize,
+        outSize, filters, kernelWidth, kernelHeight, inputMaps, outputRows,
+        outputCols, strideWidth, strideHeight);
+
+    for (size_t inMap = 0; inMap < inSize; inMap++)
+    {
+      const arma::Mat<eT> output(inputMaps.colptr(inMap), outputRows,
+          outputCols, false, true);
 
       if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
       {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight);
+        gTemp.slice(inMap + b * inSize) += output.submat(padWLeft, padHTop,
+            padWLeft + gTemp.n_rows - 1, padHTop + gTemp.n_cols - 1);
       }
       else
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight);
+        gTemp.slice(inMap + b * inSize) += output;
       }
-
-      outputTemp.slice(outMap) += convOutput;
     }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
   }
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
 }
 
 template<
@@ -249,17 +424,8 @@ void Convolution<
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::Backward(
-    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+>::BackwardConvolution(const arma::Cube<eT>& error, std::false_type)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
-      outputHeight, outSize * batchSize, false, false);
-
-  g.set_size(inputWidth * inputHeight * inSize, batchSize);
-  gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight,
-      inSize * batchSize, false, false);
-  gTemp.zeros();
-
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -274,7 +440,7 @@ void Convolution<
       arma::Mat<eT> output, rotatedFilter;
       Rotate180(weight.slice(outMapIdx), rotatedFilter);
 
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
+      BackwardConvolutionRule::Convolution(error.slice(outMap),
           rotatedFilter, output, strideWidth, strideHeight);
 
       if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
@@ -304,21 +470,56 @@ void Convolution<
     GradientConvolutionRule,
     InputDataType,
     OutputDataType
->::Gradient(
-    const arma::Mat<eT>& input,
-    const arma::Mat<eT>& error,
-    arma::Mat<eT>& gradient)
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error,
+                       std::true_type)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
-      outputHeight, outSize * batchSize, false, false);
-  arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
-      inputHeight, inSize * batchSize, false, false);
+  // With a stride, the gradient of each filter has a different form; compute
+  // it map by map.
+  if (strideWidth != 1 || strideHeight != 1)
+  {
+    GradientConvolution(input, error, std::false_type());
+    return;
+  }
 
-  gradient.set_size(weights.n_elem, 1);
-  gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
-      weight.n_cols, weight.n_slices, false, false);
-  gradientTemp.zeros();
+  // The gradient of the filter bank is the product of the transposed lowered
+  // input maps with the error maps, summed over the points.
+  arma::Mat<eT> gradientFilters(gradientTemp.memptr(), weight.n_rows *
+      weight.n_cols * inSize, outSize, false, true);
+
+  arma::Mat<eT> columns;
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    size_t outputRows, outputCols;
+    GradientConvolutionRule::Im2Col(input, b * inSize, inSize, kernelWidth,
+        kernelHeight, columns, outputRows, outputCols);
+
+    const arma::Mat<eT> errorMaps(const_cast<eT*>(
+        error.slice(b * outSize).memptr()), outputRows * outputCols, outSize,
+        false, true);
+
+    gradientFilters += columns.t() * errorMaps;
+  }
+}
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void Convolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::GradientConvolution(const arma::Cube<eT>& input,
+                       const arma::Cube<eT>& error,
+                       std::false_type)
+{
   for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
       outSize * batchSize; outMap++)
   {
@@ -330,17 +531,8 @@ void Convolution<
 
     for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
     {
-      arma::Mat<eT> inputSlice;
-      if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
+      arma::Mat<eT> inputSlice = input.slice(inMap + batchCount * inSize);
+      arma::Mat<eT> deltaSlice = error.slice(outMap);
 
       arma::Mat<eT> output;
       GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
@@ -363,9 +555,6 @@ void Convolution<
         gradientTemp.slice(outMapIdx) += output;
       }
     }
-
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
   }
 }
 
@@ -239,8 +239,8 @@ void GRU<InputDataType, OutputDataType>::Backward(
       hiddenStateModule));
 
   // Delta ot.
-  arma::mat dOt = gyLocal % (arma::ones<arma::mat>(outSize, batchSize) -
-      boost::apply_visitor(outputParameterVisitor, inputGateModule));
+  arma::mat dOt = gyLocal % (1.0 - boost::apply_visitor(
+      outputParameterVisitor, inputGateModule));
 
   // Delta of input gate.
   boost::apply_visitor(BackwardVisitor(boost::apply_visitor(
@@ -0,0 +1,249 @@
+/**
+ * @file methods/ann/layer/hierarchical_softmax.hpp
+ *
+ * Definition of the HierarchicalSoftmax class, which gives the probabilities
+ * of a large number of classes with a binary tree of classifiers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The HierarchicalSoftmax layer gives the probabilities of a large number of
+ * classes with a balanced binary tree: the classes are the leaves of the tree,
+ * each internal node has a weight vector and a bias, and the probability of a
+ * class is the product of the probabilities of the branches on the path from
+ * the root to its leaf, where the probability of the left branch of a node
+ * with score s = w^T x + b is sigmoid(s).  The loss of a point only needs the
+ * O(log(numClasses)) nodes on the path of its class, so the forward and
+ * backward passes cost O(inSize * log(numClasses)) per point instead of
+ * O(inSize * numClasses), and the probabilities are exact.  For more
+ * information, see:
+ *
+ * @code
+ * @inproceedings{morin2005hierarchical,
+ *   title     = {Hierarchical Probabilistic Neural Network Language Model},
+ *   author    = {Morin, Frederic and Bengio, Yoshua},
+ *   booktitle = {Proceedings of the Tenth International Workshop on
+ *                Artificial Intelligence and Statistics},
+ *   pages     = {246--252},
+ *   year      = {2005}
+ * }
+ * @endcode
+ *
+ * The layer is given the classes of the points of the batch through Targets()
+ * (FFN gives them to its last layer), and then its output is the loss of each
+ * point, so the network has to use the SumLoss output layer.  Without targets
+ * (in FFN::Predict()), the output is the log-probability of every class, which
+ * costs O(inSize * numClasses) per point.
+ * FFN::Forward() and FFN::Backward() don't give the targets to the layer, so
+ * they have to be set with Targets() before FFN::Forward() is called.
+ *
+ * @code
+ * FFN<SumLoss<>> model;
+ * model.Add<Linear<>>(inputSize, 128);
+ * model.Add<ReLULayer<>>();
+ * model.Add<HierarchicalSoftmax<>>(128, numClasses);
+ * model.Train(data, labels, optimizer);
+ * model.Predict(data, logProbabilities);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class HierarchicalSoftmax
+{
+ public:
+  //! Create the HierarchicalSoftmax object.
+  HierarchicalSoftmax();
+
+  /**
+   * Create the HierarchicalSoftmax layer object.  A std::invalid_argument is
+   * thrown if there are fewer than two classes.
+   *
+   * @param inSize The number of input units.
+   * @param numClasses The number of classes.
+   */
+  HierarchicalSoftmax(const size_t inSize, const size_t numClasses);
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network.  If targets were given,
+   * the output is the loss of each point; otherwise, it is the log-probability
+   * of each class.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param * (input) The output of the layer. (Unused.)
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& /* input */,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param * (error) The calculated error. (It was used by Backward().)
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& /* error */,
+                arma::Mat<eT>& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the classes of the points of the next batch.
+  OutputDataType const& Targets() const { return targets; }
+  //! Modify the classes of the points of the next batch (empty for none).
+  OutputDataType& Targets() { return targets; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of classes.
+  size_t OutputSize() const { return numClasses; }
+
+  //! Get the (inSize x (numClasses - 1)) weights; column p holds the weights
+  //! of internal node p of the tree (the children of node p are the nodes
+  //! 2p + 1 and 2p + 2, and class c is the node numClasses - 1 + c).
+  OutputDataType const& Weight() const { return weight; }
+  //! Modify the weights.
+  OutputDataType& Weight() { return weight; }
+
+  //! Get the bias of each internal node.
+  OutputDataType const& Bias() const { return bias; }
+  //! Modify the bias of each internal node.
+  OutputDataType& Bias() { return bias; }
+
+  //! Get the size of the weights.
+  size_t WeightSize() const
+  {
+    return (inSize + 1) * (numClasses - 1);
+  }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of classes.
+  size_t numClasses;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored weight parameters.
+  OutputDataType weight;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored classes of the points of the batch.
+  OutputDataType targets;
+
+  //! Whether the last forward pass computed the loss of each point.
+  bool lossPass;
+
+  //! Locally-stored nodes on the paths of the classes of the points; the path
+  //! of point i is [pathBegins[i], pathBegins[i + 1]).
+  std::vector<size_t> pathNodes;
+
+  //! Locally-stored start of the path of each point.
+  std::vector<size_t> pathBegins;
+
+  //! Locally-stored derivative of the loss with respect to the score of each
+  //! node on the paths.
+  arma::vec pathDelta;
+
+  //! Locally-stored probability of the left branch of every node (in the
+  //! forward pass without targets), and then the derivative with respect to
+  //! the score of every node.
+  OutputDataType nodeDelta;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class HierarchicalSoftmax
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "hierarchical_softmax_impl.hpp"
+
+#endif
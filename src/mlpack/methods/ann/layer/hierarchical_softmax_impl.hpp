@@ -0,0 +1,234 @@
+/**
+ * @file methods/ann/layer/hierarchical_softmax_impl.hpp
+ *
+ * Implementation of the HierarchicalSoftmax class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_HIERARCHICAL_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "hierarchical_softmax.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+HierarchicalSoftmax<InputDataType, OutputDataType>::HierarchicalSoftmax() :
+    inSize(0),
+    numClasses(0),
+    lossPass(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+HierarchicalSoftmax<InputDataType, OutputDataType>::HierarchicalSoftmax(
+    const size_t inSize,
+    const size_t numClasses) :
+    inSize(inSize),
+    numClasses(numClasses),
+    lossPass(false)
+{
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("HierarchicalSoftmax::HierarchicalSoftmax(): "
+        "there must be at least two classes!");
+  }
+
+  weights.set_size(WeightSize(), 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), inSize, numClasses - 1, false,
+      false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      numClasses - 1, 1, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  // The log-probability of a branch with score a is -log(1 + exp(-a)),
+  // computed without overflow.
+  auto logSigmoid = [](const eT a)
+  {
+    return -(std::max(-a, eT(0)) + std::log1p(std::exp(-std::abs(a))));
+  };
+
+  const size_t numNodes = numClasses - 1;
+  lossPass = !targets.is_empty();
+  if (!lossPass)
+  {
+    // Every node is needed; the log-probabilities of the nodes are computed
+    // from the root, since the parent of a node comes before the node.
+    arma::Mat<eT> scores = weight.t() * input;
+    scores.each_col() += bias;
+    output.set_size(numClasses, input.n_cols);
+    nodeDelta.set_size(numNodes, input.n_cols);
+    arma::Col<eT> nodeLogProbabilities(numNodes);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      nodeLogProbabilities[0] = 0;
+      for (size_t p = 0; p < numNodes; ++p)
+      {
+        const eT s = scores(p, i);
+        nodeDelta(p, i) = 1 / (1 + std::exp(-s));
+        for (size_t k = 2 * p + 1; k <= 2 * p + 2; ++k)
+        {
+          const eT logProbability = nodeLogProbabilities[p] +
+              logSigmoid((k == 2 * p + 1) ? s : -s);
+          if (k < numNodes)
+            nodeLogProbabilities[k] = logProbability;
+          else
+            output(k - numNodes, i) = logProbability;
+        }
+      }
+    }
+
+    return;
+  }
+
+  if (targets.n_elem != input.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HierarchicalSoftmax::Forward(): " << targets.n_elem << " targets "
+        << "were given for " << input.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  pathNodes.clear();
+  pathBegins.assign(1, 0);
+  std::vector<eT> deltas;
+  output.set_size(1, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    if (targets[i] < 0 || targets[i] >= numClasses)
+    {
+      std::ostringstream oss;
+      oss << "HierarchicalSoftmax::Forward(): class " << targets[i] << " is "
+          << "out of range (there are " << numClasses << " classes)!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Walk from the leaf of the class to the root.
+    eT loss = 0;
+    for (size_t k = numNodes + (size_t) targets[i]; k > 0; k = (k - 1) / 2)
+    {
+      const size_t p = (k - 1) / 2;
+      const eT sign = (k == 2 * p + 1) ? 1 : -1;
+      const eT a = sign * (arma::dot(weight.col(p), input.col(i)) + bias[p]);
+      loss -= logSigmoid(a);
+
+      // The derivative of -log(sigmoid(a)) is sigmoid(a) - 1.
+      pathNodes.push_back(p);
+      deltas.push_back(sign * (1 / (1 + std::exp(-a)) - 1));
+    }
+
+    output[i] = loss;
+    pathBegins.push_back(pathNodes.size());
+  }
+
+  pathDelta = arma::conv_to<arma::vec>::from(deltas);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  if (!lossPass)
+  {
+    // The derivative with respect to the log-probability of each node is the
+    // sum of the derivatives of its leaves; the derivative of log(sigmoid(s))
+    // is 1 - sigmoid(s), and the derivative of log(sigmoid(-s)) is
+    // -sigmoid(s).
+    const size_t numNodes = numClasses - 1;
+    arma::Col<eT> nodeErrors(numNodes);
+    for (size_t i = 0; i < gy.n_cols; ++i)
+    {
+      for (size_t p = numNodes; p-- > 0; )
+      {
+        const size_t left = 2 * p + 1;
+        const size_t right = 2 * p + 2;
+        const eT leftError = (left < numNodes) ? nodeErrors[left] :
+            gy(left - numNodes, i);
+        const eT rightError = (right < numNodes) ? nodeErrors[right] :
+            gy(right - numNodes, i);
+
+        nodeErrors[p] = leftError + rightError;
+        const eT probability = nodeDelta(p, i);
+        nodeDelta(p, i) = leftError * (1 - probability) - rightError *
+            probability;
+      }
+    }
+
+    g = weight * nodeDelta;
+    return;
+  }
+
+  g.zeros(inSize, gy.n_cols);
+  for (size_t i = 0; i < gy.n_cols; ++i)
+  {
+    for (size_t n = pathBegins[i]; n < pathBegins[i + 1]; ++n)
+    {
+      // The error gives the weight of the loss of each point.
+      pathDelta[n] *= gy[i];
+      g.col(i) += pathDelta[n] * weight.col(pathNodes[n]);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& /* error */,
+    arma::Mat<eT>& gradient)
+{
+  if (!lossPass)
+  {
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+        input * nodeDelta.t());
+    gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+        arma::sum(nodeDelta, 1);
+    return;
+  }
+
+  // Only the nodes on the paths of the classes of the points are nonzero.
+  gradient.zeros();
+  arma::Mat<eT> weightGradient(gradient.memptr(), inSize, numClasses - 1,
+      false, true);
+  eT* biasGradient = gradient.memptr() + weight.n_elem;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t n = pathBegins[i]; n < pathBegins[i + 1]; ++n)
+    {
+      weightGradient.col(pathNodes[n]) += pathDelta[n] * input.col(i);
+      biasGradient[pathNodes[n]] += pathDelta[n];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void HierarchicalSoftmax<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(weights));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
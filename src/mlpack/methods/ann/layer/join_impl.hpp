@@ -33,7 +33,10 @@ void Join<InputDataType, OutputDataType>::Forward(
 {
   inSizeRows = input.n_rows;
   inSizeCols = input.n_cols;
-  output = arma::vectorise(input);
+  // The output is a view of the input, since the elements of the input are
+  // already in the order of the vectorised input.
+  output = OutputType(const_cast<typename InputType::elem_type*>(
+      input.memptr()), input.n_elem, 1, false, false);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -38,6 +38,7 @@
 #include "gru.hpp"
 #include "hard_tanh.hpp"
 #include "hardshrink.hpp"
+#include "hierarchical_softmax.hpp"
 #include "highway.hpp"
 #include "join.hpp"
 #include "layer_norm.hpp"
@@ -65,11 +66,13 @@
 #include "recurrent.hpp"
 #include "reinforce_normal.hpp"
 #include "reparametrization.hpp"
+#include "sampled_softmax.hpp"
 #include "select.hpp"
 #include "sequential.hpp"
 #include "softshrink.hpp"
 #include "softmax.hpp"
 #include "softmin.hpp"
+#include "sparse_linear.hpp"
 #include "spatial_dropout.hpp"
 #include "subview.hpp"
 #include "transposed_convolution.hpp"
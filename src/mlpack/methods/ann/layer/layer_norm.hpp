@@ -197,8 +197,8 @@ class LayerNorm
   //! Locally-stored normalized input.
   OutputDataType normalized;
 
-  //! Locally-stored zero mean input.
-  OutputDataType inputMean;
+  //! Locally-stored inverse standard deviation of each point.
+  OutputDataType stdInv;
 }; // class LayerNorm
 
 } // namespace ann
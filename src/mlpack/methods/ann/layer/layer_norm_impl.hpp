@@ -59,20 +59,40 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
-
-  // Normalize the input.
-  output = input.each_row() - mean;
-  inputMean = output;
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  typedef typename OutputDataType::elem_type ElemType;
+
+  // Each point is normalized on its own.  Its mean and variance are computed
+  // in a single pass with Welford's algorithm, and it is then normalized,
+  // scaled and shifted in a second pass.
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  stdInv.set_size(1, input.n_cols);
+  normalized.set_size(arma::size(input));
+  output.set_size(arma::size(input));
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const eT* x = input.colptr(j);
+    double pointMean = 0.0, pointM2 = 0.0;
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      const double delta = x[i] - pointMean;
+      pointMean += delta / (i + 1);
+      pointM2 += delta * (x[i] - pointMean);
+    }
+
+    mean(j) = pointMean;
+    variance(j) = pointM2 / input.n_rows;
+    stdInv(j) = 1.0 / std::sqrt(variance(j) + eps);
+
+    // The normalized input is kept for the backward and gradient step.
+    ElemType* xHat = normalized.colptr(j);
+    eT* y = output.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      xHat[i] = (x[i] - pointMean) * stdInv(j);
+      y[i] = gamma(i) * xHat[i] + beta(i);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -80,23 +100,34 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat.
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  typedef typename OutputDataType::elem_type ElemType;
 
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += arma::sum(norm.each_row() % -stdInv, 0) / input.n_rows;
+  // dl / dx = stdInv * (dl / dxhat - mean(dl / dxhat) -
+  // xhat * mean(dl / dxhat * xhat)), with dl / dxhat = dl / dy * gamma, using
+  // the saved inverse standard deviation.
+  g.set_size(arma::size(input));
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const eT* error = gy.colptr(j);
+    const ElemType* xHat = normalized.colptr(j);
+    double normSum = 0.0, normXHatSum = 0.0;
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      const double norm = error[i] * gamma(i);
+      normSum += norm;
+      normXHatSum += norm * xHat[i];
+    }
+
+    normSum /= input.n_rows;
+    normXHatSum /= input.n_rows;
+
+    eT* delta = g.colptr(j);
+    for (size_t i = 0; i < input.n_rows; ++i)
+    {
+      delta[i] = stdInv(j) * (error[i] * gamma(i) - normSum -
+          xHat[i] * normXHatSum);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -106,14 +137,20 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  gradient.set_size(size + size, 1);
+  typedef typename OutputDataType::elem_type ElemType;
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // Step 5: dl / dy * xhat, and step 6: dl / dy, in a single pass.
+  gradient.zeros(size + size, 1);
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* e = error.colptr(j);
+    const ElemType* xHat = normalized.colptr(j);
+    for (size_t i = 0; i < error.n_rows; ++i)
+    {
+      gradient(i) += e[i] * xHat[i];
+      gradient(size + i) += e[i];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
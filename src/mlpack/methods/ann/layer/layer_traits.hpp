@@ -88,10 +88,19 @@ HAS_MEM_FUNC(Reset, HasResetCheck);
 // we can use with SFINAE to catch when a type has a ResetCell() function.
 HAS_MEM_FUNC(ResetCell, HasResetCellCheck);
 
+// This gives us a HasCarryStateCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a type has a CarryState()
+// function.
+HAS_MEM_FUNC(CarryState, HasCarryStateCheck);
+
 // This gives us a HasRewardCheck<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a Reward() function.
 HAS_MEM_FUNC(Reward, HasRewardCheck);
 
+// This gives us a HasTargetsCheck<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch when a type has a Targets() function.
+HAS_MEM_FUNC(Targets, HasTargetsCheck);
+
 // This gives us a HasInputWidth<T, U> type (where U is a function pointer) we
 // can use with SFINAE to catch when a type has a InputWidth() function.
 HAS_MEM_FUNC(InputWidth, HasInputWidth);
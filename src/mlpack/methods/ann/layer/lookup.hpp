@@ -85,6 +85,25 @@ class Lookup
                 const arma::Mat<eT>& error,
                 arma::Mat<eT>& gradient);
 
+  /**
+   * Calculate the gradient of the embeddings of the tokens of the input only;
+   * the gradient of the other embeddings is zero.  This is what FFN uses to
+   * compute sparse gradients, so that only the embeddings of the tokens of
+   * each batch are written.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param tokens The distinct (zero-based) tokens of the input, in increasing
+   *     order.
+   * @param tokenGradients The gradient of the embedding of each token of
+   *     tokens, one per column.
+   */
+  template<typename eT>
+  void SparseGradient(const arma::Mat<eT>& input,
+                      const arma::Mat<eT>& error,
+                      arma::uvec& tokens,
+                      arma::Mat<eT>& tokenGradients);
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -66,19 +66,37 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  const size_t seqLength = input.n_rows;
-  const size_t batchSize = input.n_cols;
-
-  arma::Cube<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
-      embeddingSize, seqLength, batchSize, false, false);
+  arma::uvec tokens;
+  arma::Mat<eT> tokenGradients;
+  SparseGradient(input, error, tokens, tokenGradients);
 
   gradient.set_size(arma::size(weights));
   gradient.zeros();
+  gradient.cols(tokens) = tokenGradients;
+}
 
-  for (size_t i = 0; i < batchSize; ++i)
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Lookup<InputDataType, OutputDataType>::SparseGradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& error,
+    arma::uvec& tokens,
+    arma::Mat<eT>& tokenGradients)
+{
+  // Column j of errorCols is the error of the j'th token of the input, in
+  // column-major order.
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(
+      arma::vectorise(input)) - 1;
+  const arma::Mat<eT> errorCols(const_cast<arma::Mat<eT>&>(error).memptr(),
+      embeddingSize, columns.n_elem, false, true);
+
+  tokens = arma::unique(columns);
+  tokenGradients.zeros(embeddingSize, tokens.n_elem);
+  for (size_t j = 0; j < columns.n_elem; ++j)
   {
-    gradient.cols(arma::conv_to<arma::uvec>::from(input.col(i)) - 1)
-        += errorTemp.slice(i);
+    const size_t t = std::lower_bound(tokens.begin(), tokens.end(),
+        columns[j]) - tokens.begin();
+    tokenGradients.col(t) += errorCols.col(j);
   }
 }
 
@@ -20,6 +20,9 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of the LPPooling.
  *
+ * All the channels of all the points of a batch are pooled in one pass, in
+ * parallel over the channels when OpenMP is available.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -153,82 +156,72 @@ class LpPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to one input slice and store the results.
    *
-   * @param input The input to be apply the pooling rule.
+   * @param input The input slice to apply the pooling rule to.
    * @param output The pooled result.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const eT* input, eT* output) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-         ++j, colidx += strideHeight)
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-           ++i, rowidx += strideWidth)
+      const size_t colBegin = j * strideHeight;
+      const size_t colEnd = std::min(colBegin + kernelHeight, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
       {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        size_t colEnd = colidx + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-          rowEnd = input.n_rows - 1;
-        if (colEnd > input.n_cols - 1)
-          colEnd = input.n_cols - 1;
+        const size_t rowBegin = i * strideWidth;
+        const size_t rowEnd = std::min(rowBegin + kernelWidth, inputWidth);
 
-        arma::mat subInput = input(
-            arma::span(rowidx, rowEnd),
-            arma::span(colidx, colEnd));
+        eT sum = 0;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            sum += std::pow(input[r + c * inputWidth], (eT) normType);
 
-        output(i, j) = pow(arma::accu(arma::pow(subInput,
-            normType)), 1.0 / normType);
+        output[i + j * outputWidth] = std::pow(sum, (eT) 1.0 / normType);
       }
     }
   }
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply unpooling to the error of one output slice and store the results.
+   * The derivative of y = (sum_k x_k^p)^(1 / p) with respect to x_k is
+   * (x_k / y)^(p - 1).
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param input The input slice.
+   * @param pooled The pooled result of the input slice.
+   * @param error The backward error.
+   * @param output The unpooled result.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
+  void Unpooling(const eT* input,
+                 const eT* pooled,
+                 const eT* error,
+                 eT* output) const
   {
-
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0, colidx = 0; j < input.n_cols; j += strideHeight, colidx++)
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < input.n_rows; i += strideWidth, rowidx++)
+      const size_t colBegin = j * strideHeight;
+      const size_t colEnd = std::min(colBegin + kernelHeight, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
       {
-        size_t rowEnd = i + kernelWidth - 1;
-        size_t colEnd = j + kernelHeight - 1;
+        const size_t rowBegin = i * strideWidth;
+        const size_t rowEnd = std::min(rowBegin + kernelWidth, inputWidth);
 
-        if (rowEnd > input.n_rows - 1)
-        {
-          if (floor)
-            continue;
-          rowEnd = input.n_rows - 1;
-        }
+        // The derivative is not defined when the whole window is zero.
+        const eT norm = pooled[i + j * outputWidth];
+        if (norm == 0)
+          continue;
 
-        if (colEnd > input.n_cols - 1)
+        const eT windowError = error[i + j * outputWidth];
+        for (size_t c = colBegin; c < colEnd; ++c)
         {
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+          {
+            output[r + c * inputWidth] += windowError * std::pow(
+                input[r + c * inputWidth] / norm, (eT) normType - 1);
+          }
         }
-
-        arma::mat InputArea = input(arma::span(i, rowEnd), arma::span(j, colEnd));
-
-        size_t sum = pow(arma::accu(arma::pow(InputArea, normType)),
-            (normType - 1) / normType);
-        unpooledError = arma::Mat<eT>(InputArea.n_rows, InputArea.n_cols);
-        unpooledError.fill(error(rowidx, colidx) / InputArea.n_elem);
-        unpooledError %= arma::pow(InputArea, normType - 1);
-        unpooledError /= sum;
-        output(arma::span(i, i + InputArea.n_rows - 1),
-            arma::span(j, j + InputArea.n_cols - 1)) += unpooledError;
       }
     }
   }
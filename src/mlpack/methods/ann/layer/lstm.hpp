@@ -31,6 +31,12 @@ namespace ann /** Artificial Neural Network. */ {
  * h &=& o \odot tanh(c)
  * @f}
  *
+ * The weights of the four gates are stacked, so that every time step computes
+ * all the gates with a single matrix product over the input and the previous
+ * output, and the activations, the cell and the output in one pass over the
+ * result.  The activations of each time step are kept in buffers that hold
+ * the last rho steps.
+ *
  * Note that if an LSTM layer is desired as the first layer of a neural network,
  * an IdentityLayer should be added to the network as the first layer, and then
  * the LSTM layer should be added.
@@ -140,6 +146,17 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Resets the cell to accept the next window of a sequence: like ResetCell(),
+   * this starts a new BPTT chain, but the cell and the output at the last step
+   * of the previous window are kept as the initial state of the new window.
+   * This is used for truncated BPTT; the error isn't propagated back past the
+   * beginning of the window.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryState(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -220,9 +237,6 @@ class LSTM
   //! Locally-stored weight object.
   OutputDataType weights;
 
-  //! Locally-stored previous output.
-  OutputDataType prevOutput;
-
   //! Locally-stored batch size.
   size_t batchSize;
 
@@ -233,9 +247,6 @@ class LSTM
   //! step.
   size_t gradientStepIdx;
 
-  //! Locally-stored cell activation error.
-  OutputDataType cellActivationError;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -245,86 +256,48 @@ class LSTM
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Weights between the output and input gate.
-  OutputDataType output2GateInputWeight;
+  //! Weights between the input and previous output, and the gates (the input,
+  //! forget and output gates and the hidden layer, in that order).
+  OutputDataType gateWeight;
 
-  //! Weights between the input and gate.
-  OutputDataType input2GateInputWeight;
+  //! Weights between the input and the gates (the first columns of
+  //! gateWeight).
+  OutputDataType input2GateWeight;
 
-  //! Bias between the input and input gate.
-  OutputDataType input2GateInputBias;
+  //! Weights between the previous output and the gates (the last columns of
+  //! gateWeight).
+  OutputDataType output2GateWeight;
 
-  //! Weights between the cell and input gate.
-  OutputDataType cell2GateInputWeight;
-
-  //! Weights between the output and forget gate.
-  OutputDataType output2GateForgetWeight;
+  //! Bias of the gates.
+  OutputDataType gateBias;
 
-  //! Weights between the input and gate.
-  OutputDataType input2GateForgetWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateForgetBias;
+  //! Weights between the previous cell and the input gate.
+  OutputDataType cell2GateInputWeight;
 
-  //! Bias between the input and gate.
+  //! Weights between the previous cell and the forget gate.
   OutputDataType cell2GateForgetWeight;
 
-  //! Weights between the output and gate.
-  OutputDataType output2GateOutputWeight;
-
-  //! Weights between the input and gate.
-  OutputDataType input2GateOutputWeight;
-
-  //! Bias between the input and gate.
-  OutputDataType input2GateOutputBias;
-
-  //! Weights between cell and output gate.
+  //! Weights between the cell and the output gate.
   OutputDataType cell2GateOutputWeight;
 
-  //! Locally-stored input gate parameter.
-  OutputDataType inputGate;
+  //! Locally-stored input and previous output of the current time step.
+  OutputDataType stackedInput;
 
-  //! Locally-stored forget gate parameter.
-  OutputDataType forgetGate;
-
-  //! Locally-stored hidden layer parameter.
-  OutputDataType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  OutputDataType outputGate;
-
-  //! Locally-stored input gate activation.
-  OutputDataType inputGateActivation;
-
-  //! Locally-stored forget gate activation.
-  OutputDataType forgetGateActivation;
-
-  //! Locally-stored output gate activation.
-  OutputDataType outputGateActivation;
-
-  //! Locally-stored hidden layer activation.
-  OutputDataType hiddenLayerActivation;
-
-  //! Locally-stored input to hidden weight.
-  OutputDataType input2HiddenWeight;
-
-  //! Locally-stored input to hidden bias.
-  OutputDataType input2HiddenBias;
-
-  //! Locally-stored output to hidden weight.
-  OutputDataType output2HiddenWeight;
+  //! Locally-stored activations of the gates, one block of columns for each
+  //! time step.
+  OutputDataType gateActivation;
 
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
-  //! Locally-stored cell activation error.
+  //! Locally-stored cell activation.
   OutputDataType cellActivation;
 
-  //! Locally-stored forget gate error.
-  OutputDataType forgetGateError;
+  //! Locally-stored error of the gates for the current time step.
+  OutputDataType gateError;
 
-  //! Locally-stored output gate error.
-  OutputDataType outputGateError;
+  //! Locally-stored error of the previous cell.
+  OutputDataType cellError;
 
   //! Locally-stored previous error.
   OutputDataType prevError;
@@ -332,20 +305,18 @@ class LSTM
   //! Locally-stored output parameters.
   OutputDataType outParameter;
 
-  //! Locally-stored input cell error parameter.
-  OutputDataType inputCellError;
-
-  //! Locally-stored input gate error.
-  OutputDataType inputGateError;
-
-  //! Locally-stored hidden layer error.
-  OutputDataType hiddenError;
-
   //! Locally-stored current rho size.
   size_t rhoSize;
 
   //! Current backpropagate through time steps.
   size_t bpttSteps;
+
+  //! Locally-stored cell of the step before the first step of the window,
+  //! carried from the previous window.
+  OutputDataType initialCell;
+
+  //! Whether the state of the previous window is carried to this one.
+  bool hasInitialCell;
 }; // class LSTM
 
 } // namespace ann
@@ -19,7 +19,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-LSTM<InputDataType, OutputDataType>::LSTM()
+LSTM<InputDataType, OutputDataType>::LSTM() :
+    hasInitialCell(false)
 {
   // Nothing to do here.
 }
@@ -38,7 +39,9 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(layer.batchStep),
     gradientStepIdx(layer.gradientStepIdx),
     rhoSize(layer.rho),
-    bpttSteps(layer.bpttSteps)
+    bpttSteps(layer.bpttSteps),
+    initialCell(layer.initialCell),
+    hasInitialCell(layer.hasInitialCell)
 {
   // Nothing to do here.
 }
@@ -57,7 +60,9 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(std::move(layer.batchStep)),
     gradientStepIdx(std::move(layer.gradientStepIdx)),
     rhoSize(std::move(layer.rho)),
-    bpttSteps(std::move(layer.bpttSteps))
+    bpttSteps(std::move(layer.bpttSteps)),
+    initialCell(std::move(layer.initialCell)),
+    hasInitialCell(layer.hasInitialCell)
 {
   // Nothing to do here.
 }
@@ -81,6 +86,8 @@ LSTM<InputDataType, OutputDataType> :: operator=(const LSTM& layer)
     grad = layer.grad;
     rhoSize = layer.rho;
     bpttSteps = layer.bpttSteps;
+    initialCell = layer.initialCell;
+    hasInitialCell = layer.hasInitialCell;
   }
   return *this; 
 }
@@ -104,6 +111,8 @@ LSTM<InputDataType, OutputDataType> :: operator=(LSTM&& layer)
     grad = std::move(layer.grad);
     rhoSize = std::move(layer.rho);
     bpttSteps = std::move(layer.bpttSteps);
+    initialCell = std::move(layer.initialCell);
+    hasInitialCell = layer.hasInitialCell;
   }
   return *this; 
 }
@@ -121,7 +130,8 @@ LSTM<InputDataType, OutputDataType>::LSTM(
     batchStep(0),
     gradientStepIdx(0),
     rhoSize(rho),
-    bpttSteps(0)
+    bpttSteps(0),
+    hasInitialCell(false)
 {
   weights.set_size(WeightSize(), 1);
 }
@@ -133,6 +143,7 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
     return;
 
   rhoSize = size;
+  hasInitialCell = false;
 
   if (batchSize == 0)
     return;
@@ -147,88 +158,74 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
 
   // Make sure all of the different matrices we will use to hold parameters are
   // at least as large as we need.
-  inputGate.set_size(outSize, rhoBatchSize);
-  forgetGate.set_size(outSize, rhoBatchSize);
-  hiddenLayer.set_size(outSize, rhoBatchSize);
-  outputGate.set_size(outSize, rhoBatchSize);
-
-  inputGateActivation.set_size(outSize, rhoBatchSize);
-  forgetGateActivation.set_size(outSize, rhoBatchSize);
-  outputGateActivation.set_size(outSize, rhoBatchSize);
-  hiddenLayerActivation.set_size(outSize, rhoBatchSize);
-
+  stackedInput.set_size(inSize + outSize, batchSize);
+  gateActivation.set_size(4 * outSize, rhoBatchSize);
   cellActivation.set_size(outSize, rhoBatchSize);
-  prevError.set_size(4 * outSize, batchSize);
+  gateError.set_size(4 * outSize, batchSize);
+  cellError.set_size(outSize, batchSize);
+  prevError.set_size(outSize, batchSize);
 
   // Now reset recurrent values to 0.
   cell.zeros(outSize, size * batchSize);
   outParameter.zeros(outSize, (size + 1) * batchSize);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryState(const size_t size)
+{
+  if (batchSize == 0 || size == std::numeric_limits<size_t>::max())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // The end of the last step of the previous window; after a full window the
+  // forward step is back to 0.
+  const size_t end = (forwardStep == 0) ? bpttSteps * batchSize : forwardStep;
+  const OutputDataType lastOutput = outParameter.cols(end, end + batchStep);
+  OutputDataType lastCell = cell.cols(end - batchSize, end - 1);
+
+  ResetCell(size);
+
+  // The output of the last step is the previous output of the first step.
+  outParameter.cols(0, batchStep) = lastOutput;
+  initialCell = std::move(lastCell);
+  hasInitialCell = true;
+}
+
 template<typename InputDataType, typename OutputDataType>
 void LSTM<InputDataType, OutputDataType>::Reset()
 {
-  // Set the weight parameter for the output gate.
-  input2GateOutputWeight = OutputDataType(weights.memptr(), outSize, inSize,
+  // Set the weight parameter for the input and previous output to gates
+  // multiplication.  The columns of the matrix are contiguous, so the weights
+  // of the input and of the previous output are aliases of its first and last
+  // columns.
+  gateWeight = OutputDataType(weights.memptr(), 4 * outSize,
+      inSize + outSize, false, false);
+  input2GateWeight = OutputDataType(weights.memptr(), 4 * outSize, inSize,
       false, false);
-  input2GateOutputBias = OutputDataType(weights.memptr() +
-      input2GateOutputWeight.n_elem, outSize, 1, false, false);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Set the weight parameter for the forget gate.
-  input2GateForgetWeight = OutputDataType(weights.memptr() + offset,
-      outSize, inSize, false, false);
-  input2GateForgetBias = OutputDataType(weights.memptr() +
-      offset + input2GateForgetWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Set the weight parameter for the input gate.
-  input2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2GateInputBias = OutputDataType(weights.memptr() +
-      offset + input2GateInputWeight.n_elem, outSize, 1, false, false);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Set the weight parameter for the hidden gate.
-  input2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, inSize, false, false);
-  input2HiddenBias = OutputDataType(weights.memptr() +
-      offset + input2HiddenWeight.n_elem, outSize, 1, false, false);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  output2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateForgetWeight.n_elem;
-
-  // Set the weight parameter for the input multiplication.
-  output2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2GateInputWeight.n_elem;
-
-  // Set the weight parameter for the hidden multiplication.
-  output2HiddenWeight = OutputDataType(weights.memptr() +
-      offset, outSize, outSize, false, false);
-  offset += output2HiddenWeight.n_elem;
-
-  // Set the weight parameter for the cell multiplication.
-  cell2GateOutputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
+  output2GateWeight = OutputDataType(weights.memptr() +
+      input2GateWeight.n_elem, 4 * outSize, outSize, false, false);
+  size_t offset = gateWeight.n_elem;
 
-  // Set the weight parameter for the cell - forget gate multiplication.
-  cell2GateForgetWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
-  offset += cell2GateOutputWeight.n_elem;
+  // Set the bias parameter of the gates.
+  gateBias = OutputDataType(weights.memptr() + offset, 4 * outSize, 1, false,
+      false);
+  offset += gateBias.n_elem;
 
   // Set the weight parameter for the cell - input gate multiplication.
-  cell2GateInputWeight = OutputDataType(weights.memptr() +
-      offset, outSize, 1, false, false);
+  cell2GateInputWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
+  offset += cell2GateInputWeight.n_elem;
+
+  // Set the weight parameter for the cell - forget gate multiplication.
+  cell2GateForgetWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
+  offset += cell2GateForgetWeight.n_elem;
+
+  // Set the weight parameter for the cell - output gate multiplication.
+  cell2GateOutputWeight = OutputDataType(weights.memptr() + offset, outSize, 1,
+      false, false);
 }
 
 // Forward when cellState is not needed.
@@ -250,6 +247,8 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
                                                   OutputType& cellState,
                                                   bool useCellState)
 {
+  typedef typename OutputDataType::elem_type ElemType;
+
   // Check if the batch size changed, the number of cols is defines the input
   // batch size.
   if (input.n_cols != batchSize)
@@ -259,90 +258,82 @@ void LSTM<InputDataType, OutputDataType>::Forward(const InputType& input,
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
-
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
-
-  if (forwardStep > 0)
+  const bool hasPrevCell = (forwardStep > 0) || hasInitialCell;
+  if (hasPrevCell && useCellState)
   {
-    if (useCellState)
+    if (!cellState.is_empty() && forwardStep > 0)
     {
-      if (!cellState.is_empty())
-      {
-        cell.cols(forwardStep - batchSize,
-            forwardStep - batchSize + batchStep) = cellState;
-      }
-      else
-      {
-        throw std::runtime_error("Cell parameter is empty.");
-      }
+      cell.cols(forwardStep - batchSize,
+          forwardStep - batchSize + batchStep) = cellState;
+    }
+    else if (!cellState.is_empty())
+    {
+      initialCell = cellState;
+    }
+    else
+    {
+      throw std::runtime_error("Cell parameter is empty.");
     }
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
 
-  inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
-
-  forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
+  // Stack the input and the previous output, so that all the gates are
+  // computed with a single matrix product.
+  stackedInput.set_size(inSize + outSize, batchSize);
+  stackedInput.rows(0, inSize - 1) = input;
+  stackedInput.rows(inSize, inSize + outSize - 1) = outParameter.cols(
       forwardStep, forwardStep + batchStep);
 
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
-
-  hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
-
-  if (forwardStep == 0)
+  OutputDataType gate(gateActivation.colptr(forwardStep), 4 * outSize,
+      batchSize, false, true);
+  gate = gateWeight * stackedInput;
+
+  // Apply the bias, the cell connections and the activations of the gates, and
+  // update the cell and the output, in a single pass.
+  const ElemType* bias = gateBias.memptr();
+  const ElemType* cell2Input = cell2GateInputWeight.memptr();
+  const ElemType* cell2Forget = cell2GateForgetWeight.memptr();
+  const ElemType* cell2Output = cell2GateOutputWeight.memptr();
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep)
-        + inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
-  }
+    ElemType* gates = gate.colptr(j);
+    const ElemType* prevCell = (forwardStep > 0) ?
+        cell.colptr(forwardStep - batchSize + j) :
+        (hasInitialCell ? initialCell.colptr(j) : NULL);
+    ElemType* currentCell = cell.colptr(forwardStep + j);
+    ElemType* currentCellActivation = cellActivation.colptr(forwardStep + j);
+    ElemType* currentOutput = outParameter.colptr(forwardStep + batchSize + j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      ElemType inputGate = gates[i] + bias[i];
+      ElemType forgetGate = gates[outSize + i] + bias[outSize + i];
+      if (hasPrevCell)
+      {
+        inputGate += cell2Input[i] * prevCell[i];
+        forgetGate += cell2Forget[i] * prevCell[i];
+      }
 
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
+      inputGate = 1.0 / (1.0 + std::exp(-inputGate));
+      forgetGate = 1.0 / (1.0 + std::exp(-forgetGate));
+      const ElemType hidden = std::tanh(gates[3 * outSize + i] +
+          bias[3 * outSize + i]);
 
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
+      currentCell[i] = inputGate * hidden;
+      if (hasPrevCell)
+        currentCell[i] += forgetGate * prevCell[i];
 
-  outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
+      const ElemType outputGate = 1.0 / (1.0 + std::exp(-(gates[2 * outSize +
+          i] + bias[2 * outSize + i] + cell2Output[i] * currentCell[i])));
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
+      currentCellActivation[i] = std::tanh(currentCell[i]);
+      currentOutput[i] = outputGate * currentCellActivation[i];
 
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) =
-      cellActivation.cols(forwardStep, forwardStep + batchStep) %
-      outputGateActivation.cols(forwardStep, forwardStep + batchStep);
+      gates[i] = inputGate;
+      gates[outSize + i] = forgetGate;
+      gates[2 * outSize + i] = outputGate;
+      gates[3 * outSize + i] = hidden;
+    }
+  }
 
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
@@ -362,75 +353,74 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Backward(
   const InputType& /* input */, const ErrorType& gy, GradientType& g)
 {
-  ErrorType gyLocal;
-  if (gradientStepIdx > 0)
-  {
-    gyLocal = gy + prevError;
-  }
-  else
-  {
-    // Make an alias.
-    gyLocal = ErrorType(((ErrorType&) gy).memptr(), gy.n_rows, gy.n_cols, false,
-        false);
-  }
-
-  outputGateError =
-      gyLocal % cellActivation.cols(backwardStep - batchStep, backwardStep) %
-      (outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - outputGateActivation.cols(backwardStep - batchStep,
-      backwardStep)));
-
-  OutputDataType cellError = gyLocal %
-      outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep -
-      batchStep, backwardStep), 2)) + outputGateError.each_col() %
-      cell2GateOutputWeight;
-
-  if (gradientStepIdx > 0)
-  {
-    cellError += inputCellError;
-  }
-
-  if (backwardStep > batchStep)
-  {
-    forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
-      (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
-      backwardStep - batchStep, backwardStep) % (1.0 -
-      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
-  }
-  else
+  typedef typename OutputDataType::elem_type ElemType;
+
+  const size_t step = backwardStep - batchStep;
+  const bool hasNextStep = (gradientStepIdx > 0);
+  const bool hasPrevCell = (backwardStep > batchStep) || hasInitialCell;
+
+  // Compute the error of all the gates and of the previous cell in a single
+  // pass.
+  gateError.set_size(4 * outSize, batchSize);
+  cellError.set_size(outSize, batchSize);
+  const ElemType* cell2Input = cell2GateInputWeight.memptr();
+  const ElemType* cell2Forget = cell2GateForgetWeight.memptr();
+  const ElemType* cell2Output = cell2GateOutputWeight.memptr();
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    forgetGateError.zeros();
+    const ElemType* error = gy.colptr(j);
+    const ElemType* nextError = hasNextStep ? prevError.colptr(j) : NULL;
+    const ElemType* gates = gateActivation.colptr(step + j);
+    const ElemType* currentCellActivation = cellActivation.colptr(step + j);
+    const ElemType* prevCell = (backwardStep > batchStep) ?
+        cell.colptr(step - batchSize + j) :
+        (hasInitialCell ? initialCell.colptr(j) : NULL);
+    ElemType* gatesError = gateError.colptr(j);
+    ElemType* prevCellError = cellError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType outputError = hasNextStep ? error[i] + nextError[i] :
+          error[i];
+      const ElemType inputGate = gates[i];
+      const ElemType forgetGate = gates[outSize + i];
+      const ElemType outputGate = gates[2 * outSize + i];
+      const ElemType hidden = gates[3 * outSize + i];
+
+      const ElemType outputGateError = outputError * currentCellActivation[i] *
+          outputGate * (1.0 - outputGate);
+
+      ElemType currentCellError = outputError * outputGate * (1.0 -
+          currentCellActivation[i] * currentCellActivation[i]) +
+          outputGateError * cell2Output[i];
+      if (hasNextStep)
+        currentCellError += prevCellError[i];
+
+      const ElemType forgetGateError = hasPrevCell ? prevCell[i] *
+          currentCellError * forgetGate * (1.0 - forgetGate) : 0.0;
+      const ElemType inputGateError = hidden * currentCellError * inputGate *
+          (1.0 - inputGate);
+      const ElemType hiddenError = inputGate * currentCellError * (1.0 -
+          hidden * hidden);
+
+      prevCellError[i] = forgetGate * currentCellError + forgetGateError *
+          cell2Forget[i] + inputGateError * cell2Input[i];
+
+      gatesError[i] = inputGateError;
+      gatesError[outSize + i] = forgetGateError;
+      gatesError[2 * outSize + i] = outputGateError;
+      gatesError[3 * outSize + i] = hiddenError;
+    }
   }
 
-  inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError %
-      (inputGateActivation.cols(backwardStep - batchStep, backwardStep) %
-      (1.0 - inputGateActivation.cols(backwardStep - batchStep, backwardStep)));
-
-  hiddenError = inputGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError % (1 - arma::pow(hiddenLayerActivation.cols(
-      backwardStep - batchStep, backwardStep), 2));
-
-  inputCellError = forgetGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError + forgetGateError.each_col() %
-      cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
-
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GateWeight.t() * gateError;
+  prevError = output2GateWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
   if (gradientStepIdx == bpttSteps)
   {
-    backwardStep = bpttSteps - 1;
+    backwardStep = batchSize * bpttSteps - 1;
     gradientStepIdx = 0;
   }
 }
@@ -442,89 +432,49 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
     const ErrorType& /* error */,
     GradientType& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
-
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
-
-  // Cell2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError %
-      cell.cols(gradientStep - batchStep, gradientStep), 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (gradientStep > batchStep)
+  const size_t step = gradientStep - batchStep;
+
+  // The gradients of the gate weights are computed directly into the gradient
+  // matrix; the columns of the input weights come first.
+  OutputDataType input2GateGradient(gradient.memptr(), 4 * outSize, inSize,
+      false, true);
+  input2GateGradient = gateError * input.t();
+
+  const OutputDataType prevOutput(outParameter.colptr(step), outSize,
+      batchSize, false, true);
+  OutputDataType output2GateGradient(gradient.memptr() +
+      input2GateGradient.n_elem, 4 * outSize, outSize, false, true);
+  output2GateGradient = gateError * prevOutput.t();
+  size_t offset = gateWeight.n_elem;
+
+  // Gate bias gradients.
+  gradient.submat(offset, 0, offset + gateBias.n_elem - 1, 0) =
+      arma::sum(gateError, 1);
+  offset += gateBias.n_elem;
+
+  // Cell2GateInputWeight and cell2GateForgetWeight gradients.
+  if (gradientStep > batchStep || hasInitialCell)
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError %
-                  cell.cols((gradientStep - batchSize) - batchStep,
-                            (gradientStep - batchSize)), 1);
+    const OutputDataType prevCell((gradientStep > batchStep) ?
+        cell.colptr(step - batchSize) : initialCell.memptr(), outSize,
+        batchSize, false, true);
+    gradient.submat(offset, 0, offset + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(gateError.rows(0, outSize - 1) % prevCell, 1);
+    gradient.submat(offset + cell2GateInputWeight.n_elem, 0, offset +
+        cell2GateInputWeight.n_elem + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(gateError.rows(outSize, 2 * outSize - 1) % prevCell, 1);
   }
   else
   {
-    gradient.submat(offset, 0, offset +
+    gradient.submat(offset, 0, offset + cell2GateInputWeight.n_elem +
         cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
   }
+  offset += cell2GateInputWeight.n_elem + cell2GateForgetWeight.n_elem;
+
+  // Cell2GateOutputWeight gradients.
+  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
+      arma::sum(gateError.rows(2 * outSize, 3 * outSize - 1) %
+      cell.cols(step, gradientStep), 1);
 
   if (gradientStep == 0)
   {
@@ -553,11 +503,9 @@ void LSTM<InputDataType, OutputDataType>::serialize(
   ar(CEREAL_NVP(gradientStep));
   ar(CEREAL_NVP(gradientStepIdx));
   ar(CEREAL_NVP(cell));
-  ar(CEREAL_NVP(inputGateActivation));
-  ar(CEREAL_NVP(forgetGateActivation));
-  ar(CEREAL_NVP(outputGateActivation));
-  ar(CEREAL_NVP(hiddenLayerActivation));
+  ar(CEREAL_NVP(gateActivation));
   ar(CEREAL_NVP(cellActivation));
+  ar(CEREAL_NVP(cellError));
   ar(CEREAL_NVP(prevError));
   ar(CEREAL_NVP(outParameter));
 }
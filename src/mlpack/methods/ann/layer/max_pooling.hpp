@@ -40,6 +40,11 @@ class MaxPoolingRule
 /**
  * Implementation of the MaxPooling layer.
  *
+ * All the channels of all the points of a batch are pooled in one pass (in
+ * parallel over the channels when OpenMP is available), and the common 2x2
+ * window with stride 2 has its own kernel.  The index of the maximum of each
+ * window is stored as a 32-bit integer for the backward pass.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -170,65 +175,100 @@ class MaxPooling
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
+  /**
+   * Return the index of the maximum of the given pooling window of one input
+   * slice; ties are broken by the first index, in column-major order.
    *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param input The input slice.
+   * @param i Row of the window in the output.
+   * @param j Column of the window in the output.
    */
   template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
+  size_t MaxIndex(const eT* input, const size_t i, const size_t j) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-        ++j, colidx += strideHeight)
+    const size_t rowBegin = i * strideWidth;
+    const size_t rowEnd = std::min(rowBegin + kernelWidth, inputWidth);
+    const size_t colBegin = j * strideHeight;
+    const size_t colEnd = std::min(colBegin + kernelHeight, inputHeight);
+
+    size_t maxIndex = rowBegin + colBegin * inputWidth;
+    for (size_t c = colBegin; c < colEnd; ++c)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-          ++i, rowidx += strideWidth)
+      for (size_t r = rowBegin; r < rowEnd; ++r)
       {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        size_t colEnd = colidx + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-          rowEnd = input.n_rows - 1;
-        if (colEnd > input.n_cols - 1)
-          colEnd = input.n_cols - 1;
-
-        arma::mat subInput = input(
-            arma::span(rowidx, rowEnd),
-            arma::span(colidx, colEnd));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
-        {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx, rowEnd),
-              arma::span(colidx, colEnd));
-
-          poolingIndices(i, j) = subIndices(idx);
-        }
+        if (input[r + c * inputWidth] > input[maxIndex])
+          maxIndex = r + c * inputWidth;
       }
     }
+
+    return maxIndex;
   }
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply pooling to one input slice and store the results.
    *
-   * @param error The backward error.
+   * @param input The input slice to apply the pooling rule to.
    * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
+   * @param poolingIndices The index of the maximum of each window in the
+   *     input slice, or NULL if they are not needed.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
+  void PoolingOperation(const eT* input,
+                        eT* output,
+                        arma::u32* poolingIndices) const
   {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
+    // Number of windows in each direction that are handled by the 2x2, stride
+    // 2 special case; the windows on the border (when the input sizes are
+    // odd and the output is rounded up) are handled by the general case.
+    size_t fastWidth = 0;
+    size_t fastHeight = 0;
+    if (kernelWidth == 2 && kernelHeight == 2 && strideWidth == 2 &&
+        strideHeight == 2)
     {
-      output(poolingIndices(i)) += error(i);
+      fastWidth = std::min(inputWidth / 2, outputWidth);
+      fastHeight = std::min(inputHeight / 2, outputHeight);
+    }
+
+    for (size_t j = 0; j < fastHeight; ++j)
+    {
+      const eT* col0 = input + 2 * j * inputWidth;
+      const eT* col1 = col0 + inputWidth;
+      for (size_t i = 0; i < fastWidth; ++i)
+      {
+        // The elements are compared in the same order as in MaxIndex().
+        size_t maxIndex = 2 * i + 2 * j * inputWidth;
+        eT maxValue = col0[2 * i];
+        if (col0[2 * i + 1] > maxValue)
+        {
+          maxValue = col0[2 * i + 1];
+          maxIndex = 2 * i + 1 + 2 * j * inputWidth;
+        }
+        if (col1[2 * i] > maxValue)
+        {
+          maxValue = col1[2 * i];
+          maxIndex = 2 * i + (2 * j + 1) * inputWidth;
+        }
+        if (col1[2 * i + 1] > maxValue)
+        {
+          maxValue = col1[2 * i + 1];
+          maxIndex = 2 * i + 1 + (2 * j + 1) * inputWidth;
+        }
+
+        output[i + j * outputWidth] = maxValue;
+        if (poolingIndices)
+          poolingIndices[i + j * outputWidth] = (arma::u32) maxIndex;
+      }
+    }
+
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      for (size_t i = (j < fastHeight) ? fastWidth : 0; i < outputWidth; ++i)
+      {
+        const size_t maxIndex = MaxIndex(input, i, j);
+        output[i + j * outputWidth] = input[maxIndex];
+        if (poolingIndices)
+          poolingIndices[i + j * outputWidth] = (arma::u32) maxIndex;
+      }
     }
   }
 
@@ -253,9 +293,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -284,9 +321,6 @@ class MaxPooling
   //! Locally-stored transformed output parameter.
   arma::cube gTemp;
 
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -296,14 +330,9 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
-
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored index of the maximum of each window, in its input slice,
+  //! for each forward pass that has not been backpropagated yet.
+  std::vector<arma::Col<arma::u32> > poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
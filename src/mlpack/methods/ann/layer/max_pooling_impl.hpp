@@ -39,7 +39,6 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
@@ -75,37 +74,23 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
         (double) kernelHeight) / (double) strideHeight + 1);
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  // Every element of the output is set by the pooling.
+  outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
 
+  arma::u32* indicesMem = NULL;
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
+    poolingIndices.push_back(arma::Col<arma::u32>(outputTemp.n_elem));
+    indicesMem = poolingIndices.back().memptr();
   }
 
-  if (!reset)
+  // All the channels of all the points are pooled in one pass.
+  const size_t outputArea = outputWidth * outputHeight;
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) inputTemp.n_slices; ++s)
   {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
-  }
-
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-  {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
-    }
+    PoolingOperation(inputTemp.slice_memptr(s), outputTemp.slice_memptr(s),
+        indicesMem ? indicesMem + s * outputArea : NULL);
   }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
@@ -124,13 +109,20 @@ void MaxPooling<InputDataType, OutputDataType>::Backward(
   arma::cube mappedError = arma::cube(((arma::Mat<eT>&) gy).memptr(),
       outputWidth, outputHeight, outSize, false, false);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  gTemp.zeros(inputTemp.n_rows, inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // The windows may overlap, so the errors are accumulated; the slices are
+  // independent.
+  const arma::u32* indicesMem = poolingIndices.back().memptr();
+  const size_t outputArea = mappedError.n_rows * mappedError.n_cols;
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    const double* error = mappedError.slice_memptr(s);
+    const arma::u32* sliceIndices = indicesMem + s * outputArea;
+    double* sliceG = gTemp.slice_memptr(s);
+    for (size_t i = 0; i < outputArea; ++i)
+      sliceG[sliceIndices[i]] += error[i];
   }
 
   poolingIndices.pop_back();
@@ -21,6 +21,10 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of the MeanPooling.
  *
+ * All the channels of all the points of a batch are pooled in one pass (in
+ * parallel over the channels when OpenMP is available), and the common 2x2
+ * window with stride 2 has its own kernel.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -152,78 +156,82 @@ class MeanPooling
 
  private:
   /**
-   * Apply pooling to the input and store the results.
+   * Apply pooling to one input slice and store the results.
    *
-   * @param input The input to be apply the pooling rule.
+   * @param input The input slice to apply the pooling rule to.
    * @param output The pooled result.
    */
   template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
+  void Pooling(const eT* input, eT* output) const
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-         ++j, colidx += strideHeight)
+    // Number of windows in each direction that are handled by the 2x2, stride
+    // 2 special case; the windows on the border are handled by the general
+    // case.
+    size_t fastWidth = 0;
+    size_t fastHeight = 0;
+    if (kernelWidth == 2 && kernelHeight == 2 && strideWidth == 2 &&
+        strideHeight == 2)
+    {
+      fastWidth = std::min(inputWidth / 2, outputWidth);
+      fastHeight = std::min(inputHeight / 2, outputHeight);
+    }
+
+    for (size_t j = 0; j < fastHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-           ++i, rowidx += strideWidth)
+      const eT* col0 = input + 2 * j * inputWidth;
+      const eT* col1 = col0 + inputWidth;
+      eT* outputCol = output + j * outputWidth;
+      for (size_t i = 0; i < fastWidth; ++i)
       {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        size_t colEnd = colidx + kernelHeight - 1;
+        outputCol[i] = 0.25 * (col0[2 * i] + col0[2 * i + 1] + col1[2 * i] +
+            col1[2 * i + 1]);
+      }
+    }
 
-        if (rowEnd > input.n_rows - 1)
-          rowEnd = input.n_rows - 1;
-        if (colEnd > input.n_cols - 1)
-          colEnd = input.n_cols - 1;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = j * strideHeight;
+      const size_t colEnd = std::min(colBegin + kernelHeight, inputHeight);
+      for (size_t i = (j < fastHeight) ? fastWidth : 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = i * strideWidth;
+        const size_t rowEnd = std::min(rowBegin + kernelWidth, inputWidth);
 
-        arma::mat subInput = input(
-            arma::span(rowidx, rowEnd),
-            arma::span(colidx, colEnd));
+        eT sum = 0;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            sum += input[r + c * inputWidth];
 
-        output(i, j) = arma::mean(arma::mean(subInput));
+        output[i + j * outputWidth] = sum / ((rowEnd - rowBegin) *
+            (colEnd - colBegin));
       }
     }
   }
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Apply unpooling to the error of one output slice and store the results:
+   * the error of each window is spread evenly over it.
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param error The backward error.
+   * @param output The unpooled result.
    */
   template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
+  void Unpooling(const eT* error, eT* output) const
   {
-
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0, colidx = 0; j < input.n_cols; j += strideHeight, colidx++)
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      for (size_t i = 0, rowidx = 0; i < input.n_rows; i += strideWidth, rowidx++)
-      { 
-        size_t rowEnd = i + kernelWidth - 1;
-        size_t colEnd = j + kernelHeight - 1;
-
-        if (rowEnd > input.n_rows - 1)
-        {
-          if (floor)
-            continue;
-          rowEnd = input.n_rows - 1;
-        }
-
-        if (colEnd > input.n_cols - 1)
-        {
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-
-        arma::mat InputArea = input(arma::span(i, rowEnd), arma::span(j, colEnd));
-
-        unpooledError = arma::Mat<eT>(InputArea.n_rows, InputArea.n_cols);
-        unpooledError.fill(error(rowidx, colidx) / InputArea.n_elem);
-
-        output(arma::span(i, i + InputArea.n_rows - 1),
-            arma::span(j, j + InputArea.n_cols - 1)) += unpooledError;
+      const size_t colBegin = j * strideHeight;
+      const size_t colEnd = std::min(colBegin + kernelHeight, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = i * strideWidth;
+        const size_t rowEnd = std::min(rowBegin + kernelWidth, inputWidth);
+
+        const eT value = error[i + j * outputWidth] / ((rowEnd - rowBegin) *
+            (colEnd - colBegin));
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            output[r + c * inputWidth] += value;
       }
     }
   }
@@ -25,7 +25,6 @@
 #define MLPACK_METHODS_ANN_LAYER_MULTIHEAD_ATTENTION_HPP
 
 #include <mlpack/prereqs.hpp>
-#include <mlpack/methods/ann/layer/softmax.hpp>
 #include <mlpack/methods/ann/layer/dropout.hpp>
 #include <mlpack/methods/ann/init_rules/glorot_init.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
@@ -48,6 +47,21 @@ namespace ann /** Artificial Neural Network. */ {
  * of shape `(embedDim * tgtSeqLen, batchSize)`. The embeddings are stored
  * consequently.
  *
+ * The projections are computed with one matrix product per batch element, and
+ * the attention scores and outputs with one product per head, directly in
+ * preallocated buffers; the scaling, the masks and the softmax are applied in
+ * a single pass over the scores.  The heads are processed in parallel when
+ * OpenMP is available.
+ *
+ * For long sequences, the scores of each head (tgtSeqLen x srcSeqLen values)
+ * may not fit in memory.  If a tile size is given, the scores are computed
+ * for tileSize target positions at a time, and the normalization of the
+ * softmax is accumulated across the tiles with the running maximum and sum of
+ * each column (the "online softmax").  Only these statistics are kept, and the
+ * backward pass computes the scores again, tile by tile; this takes about
+ * twice as many operations, but only O(tileSize * srcSeqLen) memory per
+ * thread.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -74,11 +88,14 @@ class MultiheadAttention
    * @param srcSeqLen Source sequence length.
    * @param embedDim Total dimension of the model.
    * @param numHeads Number of parallel attention heads.
+   * @param tileSize If nonzero, compute the attention for this many target
+   *     positions at a time, without storing all the scores.
    */
   MultiheadAttention(const size_t tgtSeqLen,
                      const size_t srcSeqLen,
                      const size_t embedDim,
-                     const size_t numHeads);
+                     const size_t numHeads,
+                     const size_t tileSize = 0);
 
   /**
    * Reset the layer parameters.
@@ -149,6 +166,11 @@ class MultiheadAttention
   //! Modify the number of attention heads.
   size_t& NumHeads() { return numHeads; }
 
+  //! Get the tile size (0 means that all the scores are stored).
+  size_t TileSize() const { return tileSize; }
+  //! Modify the tile size (0 means that all the scores are stored).
+  size_t& TileSize() { return tileSize; }
+
   //! Get the two dimensional Attention Mask.
   OutputDataType const& AttentionMask() const { return attnMask; }
   //! Modify the two dimensional Attention Mask.
@@ -188,6 +210,67 @@ class MultiheadAttention
   //! Element Type of the input.
   typedef typename OutputDataType::elem_type ElemType;
 
+  /**
+   * Compute the scaled and masked scores of the given head, for the target
+   * positions begin to begin + tile.n_rows - 1.
+   *
+   * @param head Index of the head (over all the batch).
+   * @param begin First target position.
+   * @param tile Matrix of size (rows, srcSeqLen) to store the scores in.
+   */
+  void HeadScores(const size_t head,
+                  const size_t begin,
+                  arma::Mat<ElemType>& tile) const;
+
+  //! Apply the softmax to each column of the given scores, in place.
+  void ColumnSoftmax(arma::Mat<ElemType>& tile) const;
+
+  /**
+   * Update the running maximum and sum of the exponentials of each column with
+   * the scores of one tile.
+   */
+  void UpdateSoftmaxStatistics(const arma::Mat<ElemType>& tile,
+                               ElemType* colMax,
+                               ElemType* colSum) const;
+
+  /**
+   * Compute the probabilities of one tile, in place, from its scores and the
+   * statistics of each column.
+   */
+  void NormalizeScores(arma::Mat<ElemType>& tile,
+                       const ElemType* colMax,
+                       const ElemType* colSum) const;
+
+  /**
+   * Compute the error of the scaled scores, in place, from the probabilities
+   * and their error.
+   *
+   * @param probs The attention probabilities.
+   * @param colDot The dot product of each column of probs and error.
+   * @param error The error of the probabilities, overwritten with the error of
+   *     the products of the projected query and key (before the scaling).
+   */
+  void SoftmaxBackward(const arma::Mat<ElemType>& probs,
+                       const arma::Row<ElemType>& colDot,
+                       arma::Mat<ElemType>& error) const;
+
+  /**
+   * Compute the errors of the projected query, key and value of each head from
+   * the error of the output.  This is shared by Backward() and Gradient().
+   *
+   * @param gy The backpropagated error, of shape
+   *     (embedDim * tgtSeqLen, batchSize).
+   * @param qError Error of the projected query, of shape
+   *     (tgtSeqLen, headDim, numHeads * batchSize).
+   * @param kError Error of the projected key, of shape
+   *     (srcSeqLen, headDim, numHeads * batchSize).
+   * @param vError Error of the projected value, same shape as kError.
+   */
+  void AttentionBackward(const arma::Mat<ElemType>& gy,
+                         arma::Cube<ElemType>& qError,
+                         arma::Cube<ElemType>& kError,
+                         arma::Cube<ElemType>& vError) const;
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -203,6 +286,9 @@ class MultiheadAttention
   //! Dimensionality of each head.
   size_t headDim;
 
+  //! Number of target positions per tile (0 means no tiling).
+  size_t tileSize;
+
   //! Two dimensional Attention Mask of shape (tgtSeqLen, srcSeqLen).
   OutputDataType attnMask;
 
@@ -245,15 +331,18 @@ class MultiheadAttention
   //! Locally-stored projected value matrix over linear layer.
   arma::Cube<ElemType> vProj;
 
-  //! Locally-stored result of output of dropout layer.
+  //! Locally-stored attention probabilities of each head (when not tiling).
   arma::Cube<ElemType> scores;
 
+  //! Locally-stored maximum score of each column of each head (when tiling).
+  arma::Mat<ElemType> scoreMax;
+
+  //! Locally-stored sum of the exponentials of each column (when tiling).
+  arma::Mat<ElemType> scoreSum;
+
   //! Locally-stored attention output weight to be fed to last linear layer.
   arma::Cube<ElemType> attnOut;
 
-  //! Softmax layer to represent the probabilities of next sequence.
-  Softmax<InputDataType, OutputDataType> softmax;
-
   //! Locally-stored delta object.
   OutputDataType delta;
 
@@ -16,8 +16,6 @@
 // In case it hasn't yet been included.
 #include "multihead_attention.hpp"
 
-#include <mlpack/core/math/multiply_slices.hpp>
-
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -29,7 +27,8 @@ MultiheadAttention() :
     srcSeqLen(0),
     embedDim(0),
     numHeads(0),
-    headDim(0)
+    headDim(0),
+    tileSize(0)
 {
   // Nothing to do here.
 }
@@ -41,11 +40,13 @@ MultiheadAttention(
     const size_t tgtSeqLen,
     const size_t srcSeqLen,
     const size_t embedDim,
-    const size_t numHeads) :
+    const size_t numHeads,
+    const size_t tileSize) :
     tgtSeqLen(tgtSeqLen),
     srcSeqLen(srcSeqLen),
     embedDim(embedDim),
-    numHeads(numHeads)
+    numHeads(numHeads),
+    tileSize(tileSize)
 {
   if (embedDim % numHeads != 0)
   {
@@ -88,103 +89,157 @@ template <typename eT>
 void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
 Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
-  typedef typename arma::Cube<eT> CubeType;
+  typedef typename arma::Mat<eT> MatType;
 
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
     Log::Fatal << "Incorrect input dimensions!" << std::endl;
   }
 
+  // The attention mask is used to black-out future sequences and generally
+  // used in Encoder-Decoder attention.  It has elements 0 or -infinity.
+  // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
+  }
+
+  // The key padding mask blacks-out any particular word in the sequence.
+  // It has elements 0 or -infinity.
+  // The shape of keyPaddingMask : (1, srcSeqLen).
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
+  {
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
+  }
+
   const size_t batchSize = input.n_cols;
+  const size_t numSlices = numHeads * batchSize;
 
   // shape of output : (embedDim * tgtSeqLen, batchSize).
   output.set_size(embedDim * tgtSeqLen, batchSize);
 
-  // Reshape the input, the query, and the key into a cube from a matrix.
-  // The shape of q : (embedDim, tgtSeqLen, batchSize).
-  // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of v : (embedDim, srcSeqLen, batchSize).
-  const CubeType q(const_cast<arma::Mat<eT>&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<arma::Mat<eT>&>(input).memptr() +
-      embedDim * tgtSeqLen * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<arma::Mat<eT>&>(input).memptr() +
-      embedDim * (tgtSeqLen + srcSeqLen) * batchSize,
-      embedDim, srcSeqLen, batchSize, false, false);
+  // The query, the key and the value are stored one after the other in the
+  // input; their shapes are (embedDim, tgtSeqLen, batchSize),
+  // (embedDim, srcSeqLen, batchSize) and (embedDim, srcSeqLen, batchSize).
+  eT* inputMem = const_cast<MatType&>(input).memptr();
+  const size_t keyOffset = embedDim * tgtSeqLen * batchSize;
+  const size_t valueOffset = embedDim * (tgtSeqLen + srcSeqLen) * batchSize;
 
   // qProj, kProj, and vProj are the linearly projected query, key and value
-  // respectively.
-  qProj.set_size(tgtSeqLen, embedDim, batchSize);
-  kProj.set_size(srcSeqLen, embedDim, batchSize);
-  vProj.set_size(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
+  // respectively, split into the heads.  The transposed projection of batch
+  // element i is computed with one product; its columns h * headDim to
+  // (h + 1) * headDim - 1 are slice i * numHeads + h.
+  qProj.set_size(tgtSeqLen, headDim, numSlices);
+  kProj.set_size(srcSeqLen, headDim, numSlices);
+  vProj.set_size(srcSeqLen, headDim, numSlices);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
   {
-    qProj.slice(i) = arma::trans(
-        queryWt * q.slice(i) + arma::repmat(qBias, 1, tgtSeqLen));
-    kProj.slice(i) = arma::trans(
-        keyWt * k.slice(i) + arma::repmat(kBias, 1, srcSeqLen));
-    vProj.slice(i) = arma::trans(
-        valueWt * v.slice(i) + arma::repmat(vBias, 1, srcSeqLen));
+    const MatType q(inputMem + i * embedDim * tgtSeqLen, embedDim, tgtSeqLen,
+        false, true);
+    const MatType k(inputMem + keyOffset + i * embedDim * srcSeqLen, embedDim,
+        srcSeqLen, false, true);
+    const MatType v(inputMem + valueOffset + i * embedDim * srcSeqLen,
+        embedDim, srcSeqLen, false, true);
+
+    MatType qHeads(qProj.slice_memptr(i * numHeads), tgtSeqLen, embedDim,
+        false, true);
+    MatType kHeads(kProj.slice_memptr(i * numHeads), srcSeqLen, embedDim,
+        false, true);
+    MatType vHeads(vProj.slice_memptr(i * numHeads), srcSeqLen, embedDim,
+        false, true);
+
+    qHeads = q.t() * queryWt.t();
+    qHeads.each_row() += qBias.t();
+    kHeads = k.t() * keyWt.t();
+    kHeads.each_row() += kBias.t();
+    vHeads = v.t() * valueWt.t();
+    vHeads.each_row() += vBias.t();
   }
 
-  // The scaling factor sqrt(headDim) is used to prevent exploding values
-  // after dot product i.e. when qProj is multiplied with kProj.
-  qProj /= std::sqrt(headDim);
-
-  // Split the qProj, kProj and vProj into n heads. That's what Multihead
-  // Attention is.
-  qProj.reshape(tgtSeqLen, headDim, numHeads * batchSize);
-  kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
-  vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
-
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = math::MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements 0 or -infinity.
-  // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
-  {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
-  }
+  // The output of all the heads is concatenated, so attnOut has shape
+  // (tgtSeqLen, embedDim, batchSize), and the output of head i is stored at
+  // i * tgtSeqLen * headDim.
+  attnOut.set_size(tgtSeqLen, embedDim, batchSize);
 
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements 0 or -infinity.
-  // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
+  if (tileSize == 0)
   {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += arma::repmat(keyPaddingMask, tgtSeqLen, 1);
+    // Keep the attention probabilities of each head for the backward pass.
+    // The buffer is only reallocated when the shape changes.
+    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+    scores.set_size(tgtSeqLen, srcSeqLen, numSlices);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numSlices; ++i)
+    {
+      MatType headScores(scores.slice_memptr(i), tgtSeqLen, srcSeqLen, false,
+          true);
+      HeadScores(i, 0, headScores);
+      ColumnSoftmax(headScores);
+
+      const MatType vHead(vProj.slice_memptr(i), srcSeqLen, headDim, false,
+          true);
+      MatType headOut(attnOut.memptr() + i * tgtSeqLen * headDim, tgtSeqLen,
+          headDim, false, true);
+      headOut = headScores * vHead;
+    }
   }
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  else
   {
-    softmax.Forward(scores.slice(i), softmax.OutputParameter());
-    scores.slice(i) = softmax.OutputParameter();
+    // The softmax normalizes each column of the scores, so the statistics of
+    // every column are accumulated over the tiles first, and the output is
+    // computed in a second pass.
+    scores.reset();
+    scoreMax.set_size(srcSeqLen, numSlices);
+    scoreSum.set_size(srcSeqLen, numSlices);
+
+    #pragma omp parallel
+    {
+      MatType tile;
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) numSlices; ++i)
+      {
+        eT* colMax = scoreMax.colptr(i);
+        eT* colSum = scoreSum.colptr(i);
+        std::fill(colMax, colMax + srcSeqLen,
+            -std::numeric_limits<eT>::infinity());
+        std::fill(colSum, colSum + srcSeqLen, 0);
+
+        for (size_t begin = 0; begin < tgtSeqLen; begin += tileSize)
+        {
+          tile.set_size(std::min(tileSize, tgtSeqLen - begin), srcSeqLen);
+          HeadScores(i, begin, tile);
+          UpdateSoftmaxStatistics(tile, colMax, colSum);
+        }
+
+        const MatType vHead(vProj.slice_memptr(i), srcSeqLen, headDim, false,
+            true);
+        MatType headOut(attnOut.memptr() + i * tgtSeqLen * headDim,
+            tgtSeqLen, headDim, false, true);
+        for (size_t begin = 0; begin < tgtSeqLen; begin += tileSize)
+        {
+          tile.set_size(std::min(tileSize, tgtSeqLen - begin), srcSeqLen);
+          HeadScores(i, begin, tile);
+          NormalizeScores(tile, colMax, colSum);
+          headOut.rows(begin, begin + tile.n_rows - 1) = tile * vHead;
+        }
+      }
+    }
   }
 
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = math::MultiplyCube2Cube(scores, vProj, false, false);
-
-  // Now we will concatenate output of all the heads i.e. we will reshape
-  // attnOut to (tgtSeqLen, embedDim, batchSize).
-  attnOut.reshape(tgtSeqLen, embedDim, batchSize);
-
   // The final output is the linear projection of attention output.
-  for (size_t i = 0; i < batchSize; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
   {
-    output.col(i) = arma::vectorise(arma::trans(attnOut.slice(i) * outWt
-        + arma::repmat(outBias, tgtSeqLen, 1)));
+    const MatType attnOutSlice(attnOut.slice_memptr(i), tgtSeqLen, embedDim,
+        false, true);
+    MatType outputCol(output.colptr(i), embedDim, tgtSeqLen, false, true);
+    outputCol = outWt.t() * attnOutSlice.t();
+    outputCol.each_col() += outBias.t();
   }
 }
 
@@ -196,6 +251,7 @@ Backward(const arma::Mat<eT>& /* input */,
          const arma::Mat<eT>& gy,
          arma::Mat<eT>& g)
 {
+  typedef typename arma::Mat<eT> MatType;
   typedef typename arma::Cube<eT> CubeType;
 
   if (gy.n_rows != tgtSeqLen * embedDim)
@@ -206,77 +262,30 @@ Backward(const arma::Mat<eT>& /* input */,
   const size_t batchSize = gy.n_cols;
   g.set_size(embedDim * (tgtSeqLen + 2 * srcSeqLen), batchSize);
 
-  // Reshape the propagated gradient into a cube.
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
-  // We need not split it into n heads now because this is the part when
-  // output were concatenated from n heads.
-  CubeType gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(), embedDim,
-      tgtSeqLen, batchSize, true, false);
+  // The errors of the projected query, key and value, split into the heads.
+  CubeType qError, kError, vError;
+  AttentionBackward(gy, qError, kError, vError);
 
-  // The shape of gyTemp : (embedDim, tgtSeqLen, batchSize).
-  // The shape of outWt : (embedDim, embedDim).
-  // The shape of the result : (tgtSeqLen, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Mat(gyTemp, outWt, true, true);
-
-  // Now since the shape of gyTemp is (tgtSeqLen, embedDim, batchSize). We will
-  // split it into n heads.
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
-
-  // Obtain backpropagted error of value.
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  CubeType tmp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
-
-  // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * valueWt));
-  }
-
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward(scores.slice(i), gyTemp.slice(i), gyTemp.slice(i));
-  }
-
-  // Obtain backpropagated error of key.
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, qProj, true, false);
-
-  // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
-  {
-    g.submat(tgtSeqLen * embedDim, i, (tgtSeqLen + srcSeqLen) * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * keyWt));
-  }
-
-  // Obtain backpropagated error of the query.
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (tgtSeqLen, headDim, numHeads * batchSize).
-  tmp = math::MultiplyCube2Cube(gyTemp, kProj) / std::sqrt(headDim);
-
-  // Concatenate results of all the attention heads.
-  tmp.reshape(tgtSeqLen, embedDim, batchSize);
-
-  for (size_t i = 0; i < batchSize; ++i)
+  // Concatenate the heads and propagate the errors through the projections.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
   {
-    g.submat(0, i, tgtSeqLen * embedDim - 1, i)
-        = arma::vectorise(arma::trans(tmp.slice(i) * queryWt));
+    const MatType qErrors(qError.slice_memptr(i * numHeads), tgtSeqLen,
+        embedDim, false, true);
+    const MatType kErrors(kError.slice_memptr(i * numHeads), srcSeqLen,
+        embedDim, false, true);
+    const MatType vErrors(vError.slice_memptr(i * numHeads), srcSeqLen,
+        embedDim, false, true);
+
+    MatType gQuery(g.colptr(i), embedDim, tgtSeqLen, false, true);
+    MatType gKey(g.colptr(i) + embedDim * tgtSeqLen, embedDim, srcSeqLen,
+        false, true);
+    MatType gValue(g.colptr(i) + embedDim * (tgtSeqLen + srcSeqLen), embedDim,
+        srcSeqLen, false, true);
+
+    gQuery = queryWt.t() * qErrors.t();
+    gKey = keyWt.t() * kErrors.t();
+    gValue = valueWt.t() * vErrors.t();
   }
 }
 
@@ -288,8 +297,8 @@ Gradient(const arma::Mat<eT>& input,
          const arma::Mat<eT>& error,
          arma::Mat<eT>& gradient)
 {
-  typedef typename arma::Cube<eT> CubeType;
   typedef typename arma::Mat<eT> MatType;
+  typedef typename arma::Cube<eT> CubeType;
 
   if (input.n_rows != embedDim * (tgtSeqLen + 2 * srcSeqLen))
   {
@@ -305,129 +314,287 @@ Gradient(const arma::Mat<eT>& input,
   const size_t wtSize = embedDim * embedDim;
 
   // The shape of gradient : (4 * embedDim * embedDim + 4 * embedDim, 1).
-  gradient.set_size(arma::size(weights));
-
-  const CubeType q(const_cast<MatType&>(input).memptr(),
-      embedDim, tgtSeqLen, batchSize, false, false);
-  const CubeType k(const_cast<MatType&>(input).memptr() + q.n_elem,
-      embedDim, srcSeqLen, batchSize, false, false);
-  const CubeType v(const_cast<MatType&>(input).memptr() + q.n_elem + k.n_elem,
-      embedDim, srcSeqLen, batchSize, false, false);
-
-  // Reshape the propagated error into a cube.
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
-  CubeType errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(), embedDim,
-      tgtSeqLen, batchSize, true, false);
-
-  // Gradient wrt. outBias, i.e. dL/d(outBias).
-  gradient.rows(4 * wtSize + 3 * embedDim, 4 * wtSize + 4 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 1));
-
-  // The shape of attnOut : (tgtSeqLen, embedDim, batchSize).
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
-  // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  CubeType gyTemp = math::MultiplyCube2Cube(attnOut, errorTemp, true, true);
-
-  // Gradient wrt. outWt, i.e. dL/d(outWt). We will take sum of gyTemp along
-  // the slices and vectorise the output.
-  gradient.rows(3 * wtSize, 4 * wtSize - 1)
-      = arma::vectorise(arma::sum(gyTemp, 2));
-
-  // Partial derivative wrt. attnOut.
-  // The shape of outWt : (embedDim, embedDim).
-  // The shape of errorTemp : (embedDim, tgtSeqLen, batchSize).
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Mat(errorTemp, outWt, true, true);
-
-  // Now we will split it into n heads i.e. reshape it into a cube of shape
-  // (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
-
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of errorTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(scores, gyTemp, true, false);
-
-  // Now we will concatenate the propagated errors from all heads i.e. we
-  // will reshape errorTemp to (srcSeqLen, embedDim, batchSize).
-  errorTemp.reshape(srcSeqLen, embedDim, batchSize);
-
-  // Gradient wrt. vBias, i.e. dL/d(vBias). We will take summation of errorTemp
-  // over all the batches and over all the sequences.
-  gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(errorTemp, 2), 0));
-
-  // Shape of v : (srcSeqLen, embedDim, batchSize).
-  // Shape of errorTemp : (srcSeqLen, embedDim, bathSize).
-  // The new shape of errorTemp : (embedDim, embedDim, batchSize).
-  errorTemp = math::MultiplyCube2Cube(errorTemp, v, true, true);
-
-  // Gradient wrt. valueWt, i.e. dL/d(valueWt). We will take summation over all
-  // batches of errorTemp.
-  gradient.rows(2 * wtSize, 3 * wtSize - 1)
-      = arma::vectorise(arma::sum(errorTemp, 2));
-
-  // Now, the shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  errorTemp = math::MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  gradient.zeros(arma::size(weights));
+
+  MatType queryWtGrad(gradient.memptr(), embedDim, embedDim, false, true);
+  MatType keyWtGrad(gradient.memptr() + wtSize, embedDim, embedDim, false,
+      true);
+  MatType valueWtGrad(gradient.memptr() + 2 * wtSize, embedDim, embedDim,
+      false, true);
+  MatType outWtGrad(gradient.memptr() + 3 * wtSize, embedDim, embedDim, false,
+      true);
+  MatType qBiasGrad(gradient.memptr() + 4 * wtSize, embedDim, 1, false, true);
+  MatType kBiasGrad(gradient.memptr() + 4 * wtSize + embedDim, embedDim, 1,
+      false, true);
+  MatType vBiasGrad(gradient.memptr() + 4 * wtSize + 2 * embedDim, embedDim, 1,
+      false, true);
+  MatType outBiasGrad(gradient.memptr() + 4 * wtSize + 3 * embedDim, embedDim,
+      1, false, true);
+
+  // The errors of the projected query, key and value, split into the heads.
+  CubeType qError, kError, vError;
+  AttentionBackward(error, qError, kError, vError);
+
+  eT* inputMem = const_cast<MatType&>(input).memptr();
+  const size_t keyOffset = embedDim * tgtSeqLen * batchSize;
+  const size_t valueOffset = embedDim * (tgtSeqLen + srcSeqLen) * batchSize;
+
+  // Sum the gradients of the projections over the batch.
+  for (size_t i = 0; i < batchSize; ++i)
   {
-    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The new shape of errorTemp remain same.
-    softmax.Backward(scores.slice(i), errorTemp.slice(i), errorTemp.slice(i));
+    const MatType q(inputMem + i * embedDim * tgtSeqLen, embedDim, tgtSeqLen,
+        false, true);
+    const MatType k(inputMem + keyOffset + i * embedDim * srcSeqLen, embedDim,
+        srcSeqLen, false, true);
+    const MatType v(inputMem + valueOffset + i * embedDim * srcSeqLen,
+        embedDim, srcSeqLen, false, true);
+    const MatType errorCol(const_cast<MatType&>(error).colptr(i), embedDim,
+        tgtSeqLen, false, true);
+    const MatType attnOutSlice(attnOut.slice_memptr(i), tgtSeqLen, embedDim,
+        false, true);
+
+    const MatType qErrors(qError.slice_memptr(i * numHeads), tgtSeqLen,
+        embedDim, false, true);
+    const MatType kErrors(kError.slice_memptr(i * numHeads), srcSeqLen,
+        embedDim, false, true);
+    const MatType vErrors(vError.slice_memptr(i * numHeads), srcSeqLen,
+        embedDim, false, true);
+
+    queryWtGrad += qErrors.t() * q.t();
+    keyWtGrad += kErrors.t() * k.t();
+    valueWtGrad += vErrors.t() * v.t();
+    outWtGrad += attnOutSlice.t() * errorCol.t();
+
+    qBiasGrad += arma::sum(qErrors, 0).t();
+    kBiasGrad += arma::sum(kErrors, 0).t();
+    vBiasGrad += arma::sum(vErrors, 0).t();
+    outBiasGrad += arma::sum(errorCol, 1);
+  }
+
+  // Regularize according to the given regularization rule.
+  regularizer.Evaluate(weights, gradient);
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+HeadScores(const size_t head,
+           const size_t begin,
+           arma::Mat<ElemType>& tile) const
+{
+  typedef typename arma::Mat<ElemType> MatType;
+
+  // The scaling factor sqrt(headDim) is used to prevent exploding values
+  // after dot product i.e. when qProj is multiplied with kProj.
+  const ElemType scale = 1 / std::sqrt((ElemType) headDim);
+
+  const MatType qHead(const_cast<ElemType*>(qProj.slice_memptr(head)),
+      tgtSeqLen, headDim, false, true);
+  const MatType kHead(const_cast<ElemType*>(kProj.slice_memptr(head)),
+      srcSeqLen, headDim, false, true);
+
+  if (tile.n_rows == tgtSeqLen)
+    tile = qHead * kHead.t();
+  else
+    tile = qHead.rows(begin, begin + tile.n_rows - 1) * kHead.t();
+
+  for (size_t c = 0; c < srcSeqLen; ++c)
+  {
+    const ElemType padding = keyPaddingMask.is_empty() ? 0 : keyPaddingMask[c];
+    ElemType* column = tile.colptr(c);
+    for (size_t r = 0; r < tile.n_rows; ++r)
+    {
+      column[r] = scale * column[r] + padding;
+      if (!attnMask.is_empty())
+        column[r] += attnMask(begin + r, c);
+    }
   }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+ColumnSoftmax(arma::Mat<ElemType>& tile) const
+{
+  for (size_t c = 0; c < tile.n_cols; ++c)
+  {
+    ElemType* column = tile.colptr(c);
+    const ElemType maxScore = *std::max_element(column, column + tile.n_rows);
+
+    ElemType sum = 0;
+    for (size_t r = 0; r < tile.n_rows; ++r)
+    {
+      column[r] = std::exp(column[r] - maxScore);
+      sum += column[r];
+    }
+
+    for (size_t r = 0; r < tile.n_rows; ++r)
+      column[r] /= sum;
+  }
+}
+
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+UpdateSoftmaxStatistics(const arma::Mat<ElemType>& tile,
+                        ElemType* colMax,
+                        ElemType* colSum) const
+{
+  for (size_t c = 0; c < tile.n_cols; ++c)
+  {
+    const ElemType* column = tile.colptr(c);
+    const ElemType maxScore = std::max(colMax[c],
+        *std::max_element(column, column + tile.n_rows));
 
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, qProj, true, false);
+    // Nothing to add when all the scores of the column are masked so far.
+    if (maxScore == -std::numeric_limits<ElemType>::infinity())
+      continue;
 
-  // We will now conctenate the propagated errors from all heads.
-  // The new shape of gyTemp : (srcSeqLen, embedDim, batchSize).
-  gyTemp.reshape(srcSeqLen, embedDim, batchSize);
+    // Rescale the sum of the previous tiles to the new maximum.
+    ElemType sum = colSum[c] * std::exp(colMax[c] - maxScore);
+    for (size_t r = 0; r < tile.n_rows; ++r)
+      sum += std::exp(column[r] - maxScore);
 
-  // Gradient wrt. kBias, i.e. dL/d(kBias). We will take summation over all the
-  // batches of gyTemp and then over all the sequences.
-  gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
+    colMax[c] = maxScore;
+    colSum[c] = sum;
+  }
+}
 
-  // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of gyTemp : (srcSeqLen, embedDim, batchSize).
-  // The shape of dkeyWt : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, k, true, true);
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+NormalizeScores(arma::Mat<ElemType>& tile,
+                const ElemType* colMax,
+                const ElemType* colSum) const
+{
+  for (size_t c = 0; c < tile.n_cols; ++c)
+  {
+    ElemType* column = tile.colptr(c);
+    for (size_t r = 0; r < tile.n_rows; ++r)
+      column[r] = std::exp(column[r] - colMax[c]) / colSum[c];
+  }
+}
 
-  // Gradient wrt. keyWt, i.e. dL/d(keyWt). We will take summation over all the
-  // batches of dkeyWt.
-  gradient.rows(wtSize, 2 * wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+SoftmaxBackward(const arma::Mat<ElemType>& probs,
+                const arma::Row<ElemType>& colDot,
+                arma::Mat<ElemType>& error) const
+{
+  const ElemType scale = 1 / std::sqrt((ElemType) headDim);
+  for (size_t c = 0; c < probs.n_cols; ++c)
+  {
+    const ElemType* probsColumn = probs.colptr(c);
+    ElemType* column = error.colptr(c);
+    for (size_t r = 0; r < probs.n_rows; ++r)
+      column[r] = scale * probsColumn[r] * (column[r] - colDot[c]);
+  }
+}
 
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp = math::MultiplyCube2Cube(errorTemp, kProj, false, false);
+template <typename InputDataType, typename OutputDataType,
+          typename RegularizerType>
+void MultiheadAttention<InputDataType, OutputDataType, RegularizerType>::
+AttentionBackward(const arma::Mat<ElemType>& gy,
+                  arma::Cube<ElemType>& qError,
+                  arma::Cube<ElemType>& kError,
+                  arma::Cube<ElemType>& vError) const
+{
+  typedef typename arma::Mat<ElemType> MatType;
 
-  // Now, we will concatenate propagated error of all heads.
-  gyTemp.reshape(tgtSeqLen, embedDim, batchSize);
-  gyTemp /= std::sqrt(headDim);
+  const size_t batchSize = gy.n_cols;
+  const size_t numSlices = numHeads * batchSize;
 
-  // Gradient wrt. qBias, i.e. dL/d(qBias). We will take summation over all the
-  // batches of gyTemp and over all the sequences.
-  gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1)
-      = arma::vectorise(arma::sum(arma::sum(gyTemp, 2), 0));
+  // Propagate the error through the output projection.  The error of batch
+  // element i has shape (tgtSeqLen, embedDim), and is split into the heads
+  // just like the projections in Forward().
+  // The shape of gyHeads : (tgtSeqLen, headDim, numHeads * batchSize).
+  arma::Cube<ElemType> gyHeads(tgtSeqLen, headDim, numSlices);
 
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
-  // The shape of q : (embedDim, tgtSeqLen, batchSize).
-  // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  gyTemp = math::MultiplyCube2Cube(gyTemp, q, true, true);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batchSize; ++i)
+  {
+    const MatType gyCol(const_cast<ElemType*>(gy.colptr(i)), embedDim,
+        tgtSeqLen, false, true);
+    MatType gyHead(gyHeads.slice_memptr(i * numHeads), tgtSeqLen, embedDim,
+        false, true);
+    gyHead = gyCol.t() * outWt.t();
+  }
 
-  // Gradient wrt. queryWt, i.e. dL/d(queryBias). We will take summation over
-  // all the batches of gyTemp.
-  gradient.rows(0, wtSize - 1) = arma::vectorise(arma::sum(gyTemp, 2));
+  qError.set_size(tgtSeqLen, headDim, numSlices);
+  kError.set_size(srcSeqLen, headDim, numSlices);
+  vError.set_size(srcSeqLen, headDim, numSlices);
 
-  // Regularize according to the given regularization rule.
-  regularizer.Evaluate(weights, gradient);
+  #pragma omp parallel
+  {
+    MatType probs, probsError;
+    arma::Row<ElemType> colDot;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) numSlices; ++i)
+    {
+      const MatType gyHead(gyHeads.slice_memptr(i), tgtSeqLen, headDim,
+          false, true);
+      const MatType qHead(const_cast<ElemType*>(qProj.slice_memptr(i)),
+          tgtSeqLen, headDim, false, true);
+      const MatType kHead(const_cast<ElemType*>(kProj.slice_memptr(i)),
+          srcSeqLen, headDim, false, true);
+      const MatType vHead(const_cast<ElemType*>(vProj.slice_memptr(i)),
+          srcSeqLen, headDim, false, true);
+
+      MatType qErrors(qError.slice_memptr(i), tgtSeqLen, headDim, false, true);
+      MatType kErrors(kError.slice_memptr(i), srcSeqLen, headDim, false, true);
+      MatType vErrors(vError.slice_memptr(i), srcSeqLen, headDim, false, true);
+
+      if (tileSize == 0)
+      {
+        const MatType headScores(const_cast<ElemType*>(
+            scores.slice_memptr(i)), tgtSeqLen, srcSeqLen, false, true);
+
+        vErrors = headScores.t() * gyHead;
+        probsError = gyHead * vHead.t();
+        colDot = arma::sum(headScores % probsError, 0);
+        SoftmaxBackward(headScores, colDot, probsError);
+        kErrors = probsError.t() * qHead;
+        qErrors = probsError * kHead;
+        continue;
+      }
+
+      // The backward pass of the softmax needs the dot product of each column
+      // of the probabilities and of their error, so the tiles are visited
+      // twice; the probabilities are computed again from the statistics each
+      // time.
+      const ElemType* colMax = scoreMax.colptr(i);
+      const ElemType* colSum = scoreSum.colptr(i);
+      vErrors.zeros();
+      kErrors.zeros();
+      colDot.zeros(srcSeqLen);
+      for (size_t begin = 0; begin < tgtSeqLen; begin += tileSize)
+      {
+        const size_t end = std::min(begin + tileSize, tgtSeqLen) - 1;
+        probs.set_size(end - begin + 1, srcSeqLen);
+        HeadScores(i, begin, probs);
+        NormalizeScores(probs, colMax, colSum);
+
+        vErrors += probs.t() * gyHead.rows(begin, end);
+        probsError = gyHead.rows(begin, end) * vHead.t();
+        colDot += arma::sum(probs % probsError, 0);
+      }
+
+      for (size_t begin = 0; begin < tgtSeqLen; begin += tileSize)
+      {
+        const size_t end = std::min(begin + tileSize, tgtSeqLen) - 1;
+        probs.set_size(end - begin + 1, srcSeqLen);
+        HeadScores(i, begin, probs);
+        NormalizeScores(probs, colMax, colSum);
+
+        probsError = gyHead.rows(begin, end) * vHead.t();
+        SoftmaxBackward(probs, colDot, probsError);
+        kErrors += probsError.t() * qHead.rows(begin, end);
+        qErrors.rows(begin, end) = probsError * kHead;
+      }
+    }
+  }
 }
 
 template <typename InputDataType, typename OutputDataType,
@@ -0,0 +1,293 @@
+/**
+ * @file methods/ann/layer/sampled_softmax.hpp
+ *
+ * Definition of the SampledSoftmax class, a softmax output layer for a large
+ * number of classes that is trained on a sample of the classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_HPP
+#define MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The SampledSoftmax layer is a Linear layer followed by a softmax over a large
+ * number of classes, which only computes the scores of a sample of the classes
+ * while it is trained.  For each batch, numSampled classes are drawn (with
+ * replacement) from the proposal distribution, and the loss of each point is
+ * the cross-entropy of the softmax over its own class and the sampled classes,
+ * where the score of each class c is corrected by -log(numSampled * Q(c)) and
+ * the sampled classes that are the class of the point are left out.  The
+ * forward and backward passes then cost O(inSize * numSampled) per point
+ * instead of O(inSize * numClasses).  For more information, see:
+ *
+ * @code
+ * @inproceedings{jean2015using,
+ *   title     = {On Using Very Large Target Vocabulary for Neural Machine
+ *                Translation},
+ *   author    = {Jean, S{\'e}bastien and Cho, Kyunghyun and Memisevic, Roland
+ *                and Bengio, Yoshua},
+ *   booktitle = {Proceedings of the 53rd Annual Meeting of the Association
+ *                for Computational Linguistics},
+ *   pages     = {1--10},
+ *   year      = {2015}
+ * }
+ * @endcode
+ *
+ * The layer is given the classes of the points of the batch through Targets()
+ * (FFN gives them to its last layer), and then its output is the loss of each
+ * point, so the network has to use the SumLoss output layer.  When the network
+ * is deterministic (for instance in FFN::Evaluate()), the loss is computed with
+ * the full softmax instead.  Without targets (in FFN::Predict()), the output is
+ * the log-probability of every class, like Linear followed by LogSoftMax.
+ * FFN::Forward() and FFN::Backward() don't give the targets to the layer, so
+ * they have to be set with Targets() before FFN::Forward() is called.
+ *
+ * @code
+ * FFN<SumLoss<>> model;
+ * model.Add<Linear<>>(inputSize, 128);
+ * model.Add<ReLULayer<>>();
+ * model.Add<SampledSoftmax<>>(128, numClasses, 64);
+ * model.Train(data, labels, optimizer);
+ * model.Predict(data, logProbabilities);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SampledSoftmax
+{
+ public:
+  //! Create the SampledSoftmax object.
+  SampledSoftmax();
+
+  /**
+   * Create the SampledSoftmax layer object.  A std::invalid_argument is thrown
+   * if the proposal distribution doesn't give a positive probability to each
+   * class.
+   *
+   * @param inSize The number of input units.
+   * @param numClasses The number of classes.
+   * @param numSampled The number of classes sampled for each batch.
+   * @param proposal The (possibly unnormalized) probability of drawing each
+   *     class; if empty, the classes are drawn uniformly.
+   */
+  SampledSoftmax(const size_t inSize,
+                 const size_t numClasses,
+                 const size_t numSampled,
+                 const arma::vec& proposal = arma::vec());
+
+  /*
+   * Reset the layer parameter.
+   */
+  void Reset();
+
+  /**
+   * Ordinary feed forward pass of a neural network.  If targets were given,
+   * the output is the loss of each point; otherwise, it is the log-probability
+   * of each class.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The output of the layer.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& gy,
+                arma::Mat<eT>& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param * (error) The calculated error. (It was used by Backward().)
+   * @param gradient The calculated gradient.
+   */
+  template<typename eT>
+  void Gradient(const arma::Mat<eT>& input,
+                const arma::Mat<eT>& /* error */,
+                arma::Mat<eT>& gradient);
+
+  //! Get the parameters.
+  OutputDataType const& Parameters() const { return weights; }
+  //! Modify the parameters.
+  OutputDataType& Parameters() { return weights; }
+
+  //! Get the input parameter.
+  InputDataType const& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  //! Get the gradient.
+  OutputDataType const& Gradient() const { return gradient; }
+  //! Modify the gradient.
+  OutputDataType& Gradient() { return gradient; }
+
+  //! Get the classes of the points of the next batch.
+  OutputDataType const& Targets() const { return targets; }
+  //! Modify the classes of the points of the next batch (empty for none).
+  OutputDataType& Targets() { return targets; }
+
+  //! Get the value of the deterministic parameter.
+  bool Deterministic() const { return deterministic; }
+  //! Modify the value of the deterministic parameter.
+  bool& Deterministic() { return deterministic; }
+
+  //! Get the input size.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of classes.
+  size_t OutputSize() const { return numClasses; }
+
+  //! Get the number of classes sampled for each batch.
+  size_t NumSampled() const { return numSampled; }
+
+  //! Get the proposal distribution (empty if it is uniform).
+  const arma::vec& Proposal() const { return proposal; }
+
+  //! Get the (inSize x numClasses) weights; column c holds the weights of
+  //! class c.
+  OutputDataType const& Weight() const { return weight; }
+  //! Modify the weights.
+  OutputDataType& Weight() { return weight; }
+
+  //! Get the bias of each class.
+  OutputDataType const& Bias() const { return bias; }
+  //! Modify the bias of each class.
+  OutputDataType& Bias() { return bias; }
+
+  //! Get the size of the weights.
+  size_t WeightSize() const
+  {
+    return (inSize * numClasses) + numClasses;
+  }
+
+  //! Get the shape of the input.
+  size_t InputShape() const
+  {
+    return inSize;
+  }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Draw the sampled classes and the log of their expected counts.
+  void Sample();
+
+  //! Compute the cumulative distribution of the proposal.
+  void ResetProposal();
+
+  //! Return the log of the expected count of the given class in a sample.
+  double LogExpectedCount(const size_t c) const;
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of classes.
+  size_t numClasses;
+
+  //! Locally-stored number of sampled classes.
+  size_t numSampled;
+
+  //! Locally-stored normalized proposal distribution (empty if uniform).
+  arma::vec proposal;
+
+  //! Locally-stored cumulative proposal distribution.
+  arma::vec cumulativeProposal;
+
+  //! Locally-stored weight object.
+  OutputDataType weights;
+
+  //! Locally-stored weight parameters.
+  OutputDataType weight;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! Locally-stored classes of the points of the batch.
+  OutputDataType targets;
+
+  //! Whether the last forward pass computed the loss of each point.
+  bool lossPass;
+
+  //! Whether the last forward pass only used the sampled classes.
+  bool sampledPass;
+
+  //! Locally-stored sampled classes.
+  arma::uvec sampled;
+
+  //! Locally-stored classes of the points, as indices.
+  arma::uvec classes;
+
+  //! Locally-stored weights of the sampled classes.
+  OutputDataType sampledWeight;
+
+  //! Locally-stored derivative of the loss with respect to the score of the
+  //! class of each point.
+  OutputDataType classDelta;
+
+  //! Locally-stored derivative of the loss with respect to the scores of the
+  //! sampled classes (or of every class, in the full passes).
+  OutputDataType scoreDelta;
+
+  //! If true, the full softmax is used.
+  bool deterministic;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored gradient object.
+  OutputDataType gradient;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SampledSoftmax
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sampled_softmax_impl.hpp"
+
+#endif
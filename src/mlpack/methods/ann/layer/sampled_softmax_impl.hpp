@@ -0,0 +1,309 @@
+/**
+ * @file methods/ann/layer/sampled_softmax_impl.hpp
+ *
+ * Implementation of the SampledSoftmax class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SAMPLED_SOFTMAX_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sampled_softmax.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SampledSoftmax<InputDataType, OutputDataType>::SampledSoftmax() :
+    inSize(0),
+    numClasses(0),
+    numSampled(0),
+    lossPass(false),
+    sampledPass(false),
+    deterministic(false)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+SampledSoftmax<InputDataType, OutputDataType>::SampledSoftmax(
+    const size_t inSize,
+    const size_t numClasses,
+    const size_t numSampled,
+    const arma::vec& proposal) :
+    inSize(inSize),
+    numClasses(numClasses),
+    numSampled(numSampled),
+    proposal(proposal),
+    lossPass(false),
+    sampledPass(false),
+    deterministic(false)
+{
+  if (numSampled == 0)
+  {
+    throw std::invalid_argument("SampledSoftmax::SampledSoftmax(): at least "
+        "one class must be sampled!");
+  }
+
+  if (!proposal.is_empty())
+  {
+    if (proposal.n_elem != numClasses)
+    {
+      std::ostringstream oss;
+      oss << "SampledSoftmax::SampledSoftmax(): the proposal distribution has "
+          << proposal.n_elem << " elements, but there are " << numClasses
+          << " classes!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (proposal.min() <= 0)
+    {
+      throw std::invalid_argument("SampledSoftmax::SampledSoftmax(): the "
+          "proposal distribution must give a positive probability to each "
+          "class!");
+    }
+
+    this->proposal /= arma::accu(proposal);
+  }
+
+  ResetProposal();
+  weights.set_size(WeightSize(), 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void SampledSoftmax<InputDataType, OutputDataType>::Reset()
+{
+  weight = OutputDataType(weights.memptr(), inSize, numClasses, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
+      numClasses, 1, false, false);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>& input, arma::Mat<eT>& output)
+{
+  lossPass = !targets.is_empty();
+  sampledPass = lossPass && !deterministic;
+
+  if (lossPass)
+  {
+    if (targets.n_elem != input.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "SampledSoftmax::Forward(): " << targets.n_elem << " targets "
+          << "were given for " << input.n_cols << " points!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    classes.set_size(input.n_cols);
+    for (size_t i = 0; i < input.n_cols; ++i)
+    {
+      if (targets[i] < 0 || targets[i] >= numClasses)
+      {
+        std::ostringstream oss;
+        oss << "SampledSoftmax::Forward(): class " << targets[i] << " is out "
+            << "of range (there are " << numClasses << " classes)!";
+        throw std::invalid_argument(oss.str());
+      }
+      classes[i] = (arma::uword) targets[i];
+    }
+  }
+
+  if (!sampledPass)
+  {
+    // Compute the log-probabilities of all the classes.
+    output = weight.t() * input;
+    output.each_col() += bias;
+    for (size_t i = 0; i < output.n_cols; ++i)
+    {
+      const eT maxScore = output.col(i).max();
+      output.col(i) -= maxScore + std::log(arma::accu(arma::exp(
+          output.col(i) - maxScore)));
+    }
+
+    if (lossPass)
+    {
+      // The derivative of the loss with respect to the scores is the softmax
+      // minus one for the class of each point.
+      scoreDelta = arma::exp(output);
+      arma::Mat<eT> losses(1, output.n_cols);
+      for (size_t i = 0; i < output.n_cols; ++i)
+      {
+        losses[i] = -output(classes[i], i);
+        scoreDelta(classes[i], i) -= 1;
+      }
+      output = std::move(losses);
+    }
+
+    return;
+  }
+
+  Sample();
+  sampledWeight = weight.cols(sampled);
+  scoreDelta = sampledWeight.t() * input;
+  classDelta.set_size(1, input.n_cols);
+  output.set_size(1, input.n_cols);
+
+  for (size_t j = 0; j < numSampled; ++j)
+    scoreDelta.row(j) += bias[sampled[j]] - LogExpectedCount(sampled[j]);
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const size_t c = classes[i];
+    const eT classScore = arma::dot(weight.col(c), input.col(i)) + bias[c] -
+        LogExpectedCount(c);
+
+    // The sampled classes that are the class of the point are left out of
+    // the softmax.
+    eT* scores = scoreDelta.colptr(i);
+    eT maxScore = classScore;
+    for (size_t j = 0; j < numSampled; ++j)
+    {
+      if (sampled[j] != c)
+        maxScore = std::max(maxScore, scores[j]);
+    }
+
+    eT sum = std::exp(classScore - maxScore);
+    for (size_t j = 0; j < numSampled; ++j)
+    {
+      scores[j] = (sampled[j] == c) ? 0 : std::exp(scores[j] - maxScore);
+      sum += scores[j];
+    }
+
+    output[i] = maxScore + std::log(sum) - classScore;
+
+    // The scores are replaced by their derivatives, the softmax probabilities.
+    const eT invSum = 1 / sum;
+    for (size_t j = 0; j < numSampled; ++j)
+      scores[j] *= invSum;
+    classDelta[i] = std::exp(classScore - maxScore) * invSum - 1;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>& input, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
+{
+  if (!lossPass)
+  {
+    // The input holds the log-probabilities; the derivative of the
+    // log-softmax gives the derivative with respect to the scores.
+    scoreDelta = gy - arma::exp(input).each_row() % arma::sum(gy, 0);
+    g = weight * scoreDelta;
+    return;
+  }
+
+  // The error gives the weight of the loss of each point.
+  scoreDelta.each_row() %= gy;
+  if (!sampledPass)
+  {
+    g = weight * scoreDelta;
+    return;
+  }
+
+  classDelta %= gy;
+  g = sampledWeight * scoreDelta;
+  for (size_t i = 0; i < g.n_cols; ++i)
+    g.col(i) += classDelta[i] * weight.col(classes[i]);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void SampledSoftmax<InputDataType, OutputDataType>::Gradient(
+    const arma::Mat<eT>& input,
+    const arma::Mat<eT>& /* error */,
+    arma::Mat<eT>& gradient)
+{
+  if (!sampledPass)
+  {
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+        input * scoreDelta.t());
+    gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+        arma::sum(scoreDelta, 1);
+    return;
+  }
+
+  // Only the columns of the sampled classes and of the classes of the points
+  // are nonzero.
+  gradient.zeros();
+  arma::Mat<eT> weightGradient(gradient.memptr(), inSize, numClasses, false,
+      true);
+  eT* biasGradient = gradient.memptr() + weight.n_elem;
+
+  const arma::Mat<eT> sampledGradient = input * scoreDelta.t();
+  const arma::Col<eT> sampledBiasGradient = arma::sum(scoreDelta, 1);
+  for (size_t j = 0; j < numSampled; ++j)
+  {
+    weightGradient.col(sampled[j]) += sampledGradient.col(j);
+    biasGradient[sampled[j]] += sampledBiasGradient[j];
+  }
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    weightGradient.col(classes[i]) += classDelta[i] * input.col(i);
+    biasGradient[classes[i]] += classDelta[i];
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void SampledSoftmax<InputDataType, OutputDataType>::Sample()
+{
+  sampled.set_size(numSampled);
+  for (size_t j = 0; j < numSampled; ++j)
+  {
+    if (proposal.is_empty())
+    {
+      sampled[j] = math::RandInt(numClasses);
+    }
+    else
+    {
+      const size_t c = std::upper_bound(cumulativeProposal.begin(),
+          cumulativeProposal.end(), math::Random()) -
+          cumulativeProposal.begin();
+      sampled[j] = std::min(c, numClasses - 1);
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+void SampledSoftmax<InputDataType, OutputDataType>::ResetProposal()
+{
+  if (proposal.is_empty())
+    cumulativeProposal.reset();
+  else
+    cumulativeProposal = arma::cumsum(proposal);
+}
+
+template<typename InputDataType, typename OutputDataType>
+double SampledSoftmax<InputDataType, OutputDataType>::LogExpectedCount(
+    const size_t c) const
+{
+  return proposal.is_empty() ? std::log((double) numSampled / numClasses) :
+      std::log(numSampled * proposal[c]);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SampledSoftmax<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(numSampled));
+  ar(CEREAL_NVP(proposal));
+  ar(CEREAL_NVP(weights));
+
+  if (cereal::is_loading<Archive>())
+    ResetProposal();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
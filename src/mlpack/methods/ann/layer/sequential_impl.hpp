@@ -16,6 +16,8 @@
 // In case it hasn't yet been included.
 #include "sequential.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
@@ -173,17 +175,26 @@ Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
     reset = true;
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.back());
-
+  arma::Mat<eT>& lastOutput = boost::apply_visitor(outputParameterVisitor,
+      network.back());
   if (Residual)
   {
-    if (arma::size(output) != arma::size(input))
+    if (arma::size(lastOutput) != arma::size(input))
     {
       Log::Fatal << "The sizes of the output and input matrices of the Residual"
           << " block should be equal. Please examine the network architecture."
           << std::endl;
     }
-    output += input;
+
+    math::ClearAlias(output);
+    output = lastOutput + input;
+  }
+  else
+  {
+    // The output is a view of the output of the last module, which isn't
+    // modified until the next forward pass.
+    output = arma::Mat<eT>(lastOutput.memptr(), lastOutput.n_rows,
+        lastOutput.n_cols, false, false);
   }
 }
 
@@ -210,11 +221,18 @@ void Sequential<
         network[network.size() - i]);
   }
 
-  g = boost::apply_visitor(deltaVisitor, network.front());
-
+  arma::Mat<eT>& firstDelta = boost::apply_visitor(deltaVisitor,
+      network.front());
   if (Residual)
   {
-    g += gy;
+    math::ClearAlias(g);
+    g = firstDelta + gy;
+  }
+  else
+  {
+    // The delta is a view of the delta of the first module.
+    g = arma::Mat<eT>(firstDelta.memptr(), firstDelta.n_rows,
+        firstDelta.n_cols, false, false);
   }
 }
 
@@ -17,6 +17,7 @@
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
@@ -40,9 +41,9 @@ namespace ann /** Artificial Neural Network. */ {
  *         arma::sp_mat or arma::cube).
  */
 template <
-    typename ForwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename BackwardConvolutionRule = NaiveConvolution<ValidConvolution>,
-    typename GradientConvolutionRule = NaiveConvolution<ValidConvolution>,
+    typename ForwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename BackwardConvolutionRule = Im2ColConvolution<ValidConvolution>,
+    typename GradientConvolutionRule = Im2ColConvolution<ValidConvolution>,
     typename InputDataType = arma::mat,
     typename OutputDataType = arma::mat
 >
@@ -313,6 +314,34 @@ class TransposedConvolution
    */
   void InitializeSamePadding();
 
+  /*
+   * Compute the output of the layer for the given (padded) input, with one
+   * matrix product per point, when the forward rule is Im2ColConvolution.
+   */
+  template<typename eT>
+  void ForwardConvolution(const arma::Cube<eT>& input, std::true_type);
+
+  /*
+   * Compute the output of the layer for the given (padded) input, one pair of
+   * maps at a time, with any other forward rule.
+   */
+  template<typename eT>
+  void ForwardConvolution(const arma::Cube<eT>& input, std::false_type);
+
+  /*
+   * Propagate the given error back through the layer, with one matrix product
+   * per point, when the backward rule is Im2ColConvolution.
+   */
+  template<typename eT>
+  void BackwardConvolution(const arma::Cube<eT>& error, std::true_type);
+
+  /*
+   * Propagate the given error back through the layer, one pair of maps at a
+   * time, with any other backward rule.
+   */
+  template<typename eT>
+  void BackwardConvolution(const arma::Cube<eT>& error, std::false_type);
+
   /*
    * Rotates a dense matrix counterclockwise by 180 degrees.
    *
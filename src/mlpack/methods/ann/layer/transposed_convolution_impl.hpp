@@ -257,40 +257,20 @@ void TransposedConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (strideWidth > 1 ||
+      strideHeight > 1 ||
+      paddingForward.PadWLeft() != 0 ||
+      paddingForward.PadWRight() != 0 ||
+      paddingForward.PadHTop() != 0 ||
+      paddingForward.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      if (strideWidth > 1 ||
-          strideHeight > 1 ||
-          paddingForward.PadWLeft() != 0 ||
-          paddingForward.PadWRight() != 0 ||
-          paddingForward.PadHTop() != 0 ||
-          paddingForward.PadHBottom() != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), rotatedFilter, convOutput, 1, 1);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), rotatedFilter, convOutput, 1, 1);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
+    ForwardConvolution(inputPaddedTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+  else
+  {
+    ForwardConvolution(inputTemp, typename std::is_same<
+        ForwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
   }
 }
 
@@ -334,33 +314,16 @@ void TransposedConvolution<
 
   gTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (paddingBackward.PadWLeft() != 0 || paddingBackward.PadWRight() != 0 ||
+      paddingBackward.PadHTop() != 0 || paddingBackward.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> output;
-
-      if (paddingBackward.PadWLeft() != 0 || paddingBackward.PadWRight() != 0 ||
-          paddingBackward.PadHTop() != 0 || paddingBackward.PadHBottom() != 0)
-      {
-        BackwardConvolutionRule::Convolution(mappedErrorPadded.slice(outMap),
-            weight.slice(outMapIdx), output, strideWidth, strideHeight);
-      }
-      else
-      {
-        BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-            weight.slice(outMapIdx), output, strideWidth, strideHeight);
-      }
-
-      gTemp.slice(inMap + batchCount * inSize) += output;
-    }
+    BackwardConvolution(mappedErrorPadded, typename std::is_same<
+        BackwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
+  }
+  else
+  {
+    BackwardConvolution(mappedError, typename std::is_same<
+        BackwardConvolutionRule, Im2ColConvolution<ValidConvolution>>::type());
   }
 }
 
@@ -433,6 +396,148 @@ void TransposedConvolution<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::true_type)
+{
+  arma::Mat<eT> filters;
+  ForwardConvolutionRule::FilterBank(weight, inSize, outSize, false, true,
+      filters);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    arma::Mat<eT> outputMaps(outputTemp.slice(b * outSize).memptr(),
+        outputTemp.n_rows * outputTemp.n_cols, outSize, false, true);
+
+    size_t outputRows, outputCols;
+    ForwardConvolutionRule::MultiChannelConvolution(input, b * inSize, inSize,
+        filters, kernelWidth, kernelHeight, outputMaps, outputRows, outputCols,
+        1, 1);
+
+    outputMaps.each_row() += bias.t();
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::ForwardConvolution(const arma::Cube<eT>& input, std::false_type)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> convOutput, rotatedFilter;
+      Rotate180(weight.slice(outMapIdx), rotatedFilter);
+
+      ForwardConvolutionRule::Convolution(input.slice(inMap +
+          batchCount * inSize), rotatedFilter, convOutput, 1, 1);
+
+      outputTemp.slice(outMap) += convOutput;
+    }
+
+    outputTemp.slice(outMap) += bias(outMap % outSize);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error, std::true_type)
+{
+  arma::Mat<eT> filters;
+  BackwardConvolutionRule::FilterBank(weight, inSize, outSize, true, false,
+      filters);
+
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    arma::Mat<eT> inputMaps(gTemp.slice(b * inSize).memptr(),
+        gTemp.n_rows * gTemp.n_cols, inSize, false, true);
+
+    size_t outputRows, outputCols;
+    BackwardConvolutionRule::MultiChannelConvolution(error, b * outSize,
+        outSize, filters, kernelWidth, kernelHeight, inputMaps, outputRows,
+        outputCols, strideWidth, strideHeight);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename InputDataType,
+    typename OutputDataType
+>
+template<typename eT>
+void TransposedConvolution<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    InputDataType,
+    OutputDataType
+>::BackwardConvolution(const arma::Cube<eT>& error, std::false_type)
+{
+  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+      outSize * batchSize; outMap++)
+  {
+    if (outMap != 0 && outMap % outSize == 0)
+    {
+      batchCount++;
+      outMapIdx = 0;
+    }
+
+    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    {
+      arma::Mat<eT> output;
+      BackwardConvolutionRule::Convolution(error.slice(outMap),
+          weight.slice(outMapIdx), output, strideWidth, strideHeight);
+
+      gTemp.slice(inMap + batchCount * inSize) += output;
+    }
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
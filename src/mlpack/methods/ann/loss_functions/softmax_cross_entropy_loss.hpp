@@ -0,0 +1,128 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy_loss.hpp
+ *
+ * Definition of the SoftmaxCrossEntropyLoss class, which fuses the LogSoftMax
+ * layer and the NegativeLogLikelihood output layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_LOSS_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The softmax cross-entropy output layer computes the negative log likelihood
+ * of the softmax of its input.  It is equivalent to a LogSoftMax layer followed
+ * by the NegativeLogLikelihood output layer, but the input of the layer are the
+ * unnormalized scores (logits) of the classes, so the network should not end
+ * with a LogSoftMax layer:
+ *
+ * @code
+ * FFN<SoftmaxCrossEntropyLoss<>> model;
+ * model.Add<Linear<>>(inputSize, 100);
+ * model.Add<ReLULayer<>>();
+ * model.Add<Linear<>>(100, numClasses);
+ * @endcode
+ *
+ * The loss of a point with scores x and class c is
+ * \f$ \log \sum_j e^{x_j} - x_c \f$, and its gradient is
+ * \f$ softmax(x) - e_c \f$.  Both are computed one column at a time directly
+ * from the scores, so no matrix of log-probabilities is stored, and the
+ * backward pass is a single pass over the scores.  Like for
+ * NegativeLogLikelihood, the target holds the class index of each point, in
+ * the range between 0 and the number of classes minus one.
+ *
+ * Since the network gives the scores of the classes, FFN::Predict() gives the
+ * scores too; the class with the largest score is the class with the largest
+ * probability.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SoftmaxCrossEntropyLoss
+{
+ public:
+  /**
+   * Create the SoftmaxCrossEntropyLoss object.
+   */
+  SoftmaxCrossEntropyLoss();
+
+  /**
+   * Computes the softmax cross-entropy loss: the sum over the points of the
+   * negative log-probability of their class.
+   *
+   * @param prediction Scores of the classes, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 0 and the number of classes minus one.
+   */
+  template<typename PredictionType, typename TargetType>
+  typename PredictionType::elem_type Forward(const PredictionType& prediction,
+                                             const TargetType& target);
+
+  /**
+   * Ordinary feed backward pass of a neural network: the gradient of the loss
+   * with respect to the scores, which is the softmax of the scores minus one
+   * for the class of each point.
+   *
+   * @param prediction Scores of the classes, one column per point.
+   * @param target The target vector, that contains the class index in the range
+   *        between 0 and the number of classes minus one.
+   * @param loss The calculated error.
+   */
+  template<typename PredictionType, typename TargetType, typename LossType>
+  void Backward(const PredictionType& prediction,
+                const TargetType& target,
+                LossType& loss);
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SoftmaxCrossEntropyLoss
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "softmax_cross_entropy_loss_impl.hpp"
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file methods/ann/loss_functions/softmax_cross_entropy_loss_impl.hpp
+ *
+ * Implementation of the SoftmaxCrossEntropyLoss class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_LOSS_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_LOSS_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "softmax_cross_entropy_loss.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SoftmaxCrossEntropyLoss<InputDataType, OutputDataType>::
+SoftmaxCrossEntropyLoss()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename PredictionType, typename TargetType>
+typename PredictionType::elem_type
+SoftmaxCrossEntropyLoss<InputDataType, OutputDataType>::Forward(
+    const PredictionType& prediction,
+    const TargetType& target)
+{
+  typedef typename PredictionType::elem_type ElemType;
+  ElemType output = 0;
+  for (size_t i = 0; i < prediction.n_cols; ++i)
+  {
+    const size_t label = (size_t) target(i);
+    Log::Assert(target(i) >= 0 && label < prediction.n_rows,
+        "Target class out of range.");
+
+    // The log of the sum of the exponentials is shifted by the largest score,
+    // so that the exponentials can't overflow.
+    const ElemType* scores = prediction.colptr(i);
+    const ElemType maxScore = arma::max(prediction.col(i));
+    ElemType sum = 0;
+    for (size_t j = 0; j < prediction.n_rows; ++j)
+      sum += std::exp(scores[j] - maxScore);
+
+    output += maxScore + std::log(sum) - scores[label];
+  }
+
+  return output;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename PredictionType, typename TargetType, typename LossType>
+void SoftmaxCrossEntropyLoss<InputDataType, OutputDataType>::Backward(
+    const PredictionType& prediction,
+    const TargetType& target,
+    LossType& loss)
+{
+  typedef typename PredictionType::elem_type ElemType;
+  loss.set_size(prediction.n_rows, prediction.n_cols);
+  for (size_t i = 0; i < prediction.n_cols; ++i)
+  {
+    const size_t label = (size_t) target(i);
+    Log::Assert(target(i) >= 0 && label < prediction.n_rows,
+        "Target class out of range.");
+
+    // The exponentials are written to the gradient, and normalized in place.
+    const ElemType* scores = prediction.colptr(i);
+    ElemType* gradient = loss.colptr(i);
+    const ElemType maxScore = arma::max(prediction.col(i));
+    ElemType sum = 0;
+    for (size_t j = 0; j < prediction.n_rows; ++j)
+    {
+      gradient[j] = std::exp(scores[j] - maxScore);
+      sum += gradient[j];
+    }
+
+    const ElemType invSum = 1 / sum;
+    for (size_t j = 0; j < prediction.n_rows; ++j)
+      gradient[j] *= invSum;
+    gradient[label] -= 1;
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SoftmaxCrossEntropyLoss<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */, const uint32_t /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file methods/ann/loss_functions/sum_loss.hpp
+ *
+ * Definition of the SumLoss class, the output layer of the networks whose last
+ * layer computes the loss of each point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTION_SUM_LOSS_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTION_SUM_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The SumLoss output layer gives the sum of its input as the loss, and ignores
+ * the target.  It is the output layer of the networks whose last layer is
+ * given the targets and computes the loss of each point itself, such as
+ * SampledSoftmax and HierarchicalSoftmax:
+ *
+ * @code
+ * FFN<SumLoss<>> model;
+ * model.Add<Linear<>>(inputSize, 128);
+ * model.Add<ReLULayer<>>();
+ * model.Add<SampledSoftmax<>>(128, numClasses, 64);
+ * @endcode
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SumLoss
+{
+ public:
+  /**
+   * Create the SumLoss object.
+   */
+  SumLoss();
+
+  /**
+   * Computes the sum of the losses of the points.
+   *
+   * @param prediction The loss of each point.
+   * @param * (target) The target vector. (Unused.)
+   */
+  template<typename PredictionType, typename TargetType>
+  typename PredictionType::elem_type Forward(const PredictionType& prediction,
+                                             const TargetType& /* target */);
+
+  /**
+   * Ordinary feed backward pass of a neural network: the gradient of the sum
+   * is one for every point.
+   *
+   * @param prediction The loss of each point.
+   * @param * (target) The target vector. (Unused.)
+   * @param loss The calculated error.
+   */
+  template<typename PredictionType, typename TargetType, typename LossType>
+  void Backward(const PredictionType& prediction,
+                const TargetType& /* target */,
+                LossType& loss);
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SumLoss
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "sum_loss_impl.hpp"
+
+#endif
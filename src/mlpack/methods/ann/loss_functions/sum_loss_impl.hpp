@@ -0,0 +1,57 @@
+/**
+ * @file methods/ann/loss_functions/sum_loss_impl.hpp
+ *
+ * Implementation of the SumLoss class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTION_SUM_LOSS_IMPL_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTION_SUM_LOSS_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sum_loss.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+SumLoss<InputDataType, OutputDataType>::SumLoss()
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename PredictionType, typename TargetType>
+typename PredictionType::elem_type
+SumLoss<InputDataType, OutputDataType>::Forward(
+    const PredictionType& prediction,
+    const TargetType& /* target */)
+{
+  return arma::accu(prediction);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename PredictionType, typename TargetType, typename LossType>
+void SumLoss<InputDataType, OutputDataType>::Backward(
+    const PredictionType& prediction,
+    const TargetType& /* target */,
+    LossType& loss)
+{
+  loss.ones(prediction.n_rows, prediction.n_cols);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void SumLoss<InputDataType, OutputDataType>::serialize(
+    Archive& /* ar */, const uint32_t /* version */)
+{
+  // Nothing to do here.
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file methods/ann/quantized_ffn.hpp
+ *
+ * Definition of the QuantizedFFN class, a feed forward network for inference
+ * whose Linear, LinearNoBias, Convolution and Lookup layers are quantized to
+ * 8-bit integers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "quantized_layer.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A trained feed forward network, turned into a network for inference whose
+ * Linear, LinearNoBias, Convolution and Lookup layers are quantized to 8-bit
+ * integers (see QuantizedLayer); the other layers are kept as they are.  The
+ * network is first frozen (see FFN::Freeze()), so BatchNorm layers are folded
+ * into the layers before them before these are quantized.  Then it is run on
+ * calibration data, which should look like the data the network will be used
+ * on, to find the range of the input of each quantized layer.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * model.Add<Linear<>>(10, 8);
+ * model.Add<ReLULayer<>>();
+ * model.Add<Linear<>>(8, 3);
+ * model.Add<LogSoftMax<>>();
+ * model.Train(trainData, trainLabels);
+ *
+ * QuantizedFFN<NegativeLogLikelihood<>> quantizedModel(model, trainData);
+ * quantizedModel.Predict(testData, predictions);
+ * @endcode
+ *
+ * The quantized layers take an eighth of the memory of the original layers,
+ * and their products are computed on 8-bit integers.  The quantized network
+ * can be serialized; it can't be trained.
+ *
+ * @tparam OutputLayerType The output layer type of the network.
+ * @tparam InitializationRuleType The initialization rule of the network.
+ * @tparam CustomLayers Any set of custom layers that could be a part of the
+ *         network.
+ */
+template<
+  typename OutputLayerType = NegativeLogLikelihood<>,
+  typename InitializationRuleType = RandomInitialization,
+  typename... CustomLayers
+>
+class QuantizedFFN
+{
+ public:
+  //! The type of the network the quantized network is created from.
+  typedef FFN<OutputLayerType, InitializationRuleType, CustomLayers...>
+      NetworkType;
+
+  //! Create an empty QuantizedFFN object; this is mostly useful to load a
+  //! network into.
+  QuantizedFFN();
+
+  /**
+   * Quantize a copy of the given network, using the given calibration data to
+   * find the range of the inputs of the quantized layers.  The network itself
+   * isn't modified.
+   *
+   * @param network Trained network to quantize.
+   * @param calibrationData Input data to calibrate the quantized layers on.
+   * @param batchSize Number of points to calibrate on at once.
+   */
+  QuantizedFFN(const NetworkType& network,
+               const arma::mat& calibrationData,
+               const size_t batchSize = 256);
+
+  /**
+   * Predict the responses to a given set of predictors, passing them through
+   * the network in batches of the given size.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               const size_t batchSize = 256);
+
+  //! Get the network that holds the layers that aren't quantized (the
+  //! quantized layers are replaced by IdentityLayer objects in it).
+  const NetworkType& Network() const { return network; }
+
+  //! Get the quantized layers.
+  const std::vector<QuantizedLayer>& QuantizedLayers() const { return layers; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Calibrate and quantize the quantizable layers, and replace them in the
+   * network.
+   *
+   * @param calibrationData Input data to calibrate the quantized layers on.
+   * @param batchSize Number of points to calibrate on at once.
+   */
+  void Quantize(const arma::mat& calibrationData, const size_t batchSize);
+
+  //! The network (without the weights of the quantized layers).
+  NetworkType network;
+
+  //! The quantized layers.
+  std::vector<QuantizedLayer> layers;
+
+  //! For each layer of the network, the index of its quantized layer, or
+  //! size_t(-1) if it isn't quantized.
+  std::vector<size_t> layerIndices;
+}; // class QuantizedFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_ffn_impl.hpp"
+
+#endif
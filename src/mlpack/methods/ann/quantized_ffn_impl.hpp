@@ -0,0 +1,191 @@
+/**
+ * @file methods/ann/quantized_ffn_impl.hpp
+ *
+ * Implementation of the QuantizedFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_ffn.hpp"
+
+#include "util/check_input_shape.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+QuantizedFFN<OutputLayerType, InitializationRuleType,
+             CustomLayers...>::QuantizedFFN()
+{
+  // Nothing to do here.
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+QuantizedFFN<OutputLayerType, InitializationRuleType,
+             CustomLayers...>::QuantizedFFN(const NetworkType& network,
+                                            const arma::mat& calibrationData,
+                                            const size_t batchSize) :
+    network(network)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("QuantizedFFN::QuantizedFFN(): batchSize must "
+        "be positive!");
+  }
+
+  if (calibrationData.n_cols == 0)
+  {
+    throw std::invalid_argument("QuantizedFFN::QuantizedFFN(): no calibration "
+        "data given!");
+  }
+
+  this->network.Freeze();
+  Quantize(calibrationData, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Quantize(const arma::mat& calibrationData,
+                                             const size_t batchSize)
+{
+  std::vector<LayerTypes<CustomLayers...> >& model = network.network;
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(model,
+      calibrationData.n_rows, "QuantizedFFN::QuantizedFFN()");
+
+  // Only the default Linear, LinearNoBias, Convolution and Lookup layers are
+  // quantized.
+  std::vector<bool> quantizable(model.size());
+  for (size_t i = 0; i < model.size(); ++i)
+  {
+    quantizable[i] = boost::get<Linear<>*>(&model[i]) ||
+        boost::get<LinearNoBias<>*>(&model[i]) ||
+        boost::get<Convolution<>*>(&model[i]) ||
+        boost::get<Lookup<>*>(&model[i]);
+  }
+
+  // Find the largest absolute input of each quantizable layer.  This also sets
+  // the input sizes of the layers.
+  std::vector<double> inputMax(model.size(), 0.0);
+  for (size_t begin = 0; begin < calibrationData.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(calibrationData.n_cols - begin));
+    const arma::mat batch(const_cast<double*>(calibrationData.colptr(begin)),
+        calibrationData.n_rows, effectiveBatchSize, false, true);
+    network.Forward(batch);
+
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+      if (!quantizable[i])
+        continue;
+
+      const arma::mat& input = (i == 0) ? batch : boost::apply_visitor(
+          network.outputParameterVisitor, model[i - 1]);
+      inputMax[i] = std::max(inputMax[i], arma::abs(input).max());
+    }
+  }
+
+  // Quantize these layers, and replace them in the network by layers without
+  // any parameters.
+  layers.clear();
+  layerIndices.assign(model.size(), size_t(-1));
+  std::vector<size_t> offsets(model.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < model.size(); ++i)
+  {
+    offsets[i] = offset;
+    offset += boost::apply_visitor(network.weightSizeVisitor, model[i]);
+
+    if (Linear<>** linear = boost::get<Linear<>*>(&model[i]))
+      layers.push_back(QuantizedLayer(**linear, inputMax[i]));
+    else if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(&model[i]))
+      layers.push_back(QuantizedLayer(**linear, inputMax[i]));
+    else if (Convolution<>** convolution =
+        boost::get<Convolution<>*>(&model[i]))
+      layers.push_back(QuantizedLayer(**convolution, inputMax[i]));
+    else if (Lookup<>** lookup = boost::get<Lookup<>*>(&model[i]))
+      layers.push_back(QuantizedLayer(**lookup));
+    else
+      continue;
+
+    boost::apply_visitor(network.deleteVisitor, model[i]);
+    model[i] = new IdentityLayer<>();
+    layerIndices[i] = layers.size() - 1;
+  }
+
+  std::vector<bool> replaced(model.size());
+  for (size_t i = 0; i < model.size(); ++i)
+    replaced[i] = (layerIndices[i] != size_t(-1));
+
+  network.ResetParameterLayout(offsets, replaced);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Predict(const arma::mat& predictors,
+                                            arma::mat& results,
+                                            const size_t batchSize)
+{
+  if (layerIndices.empty())
+  {
+    throw std::runtime_error("QuantizedFFN::Predict(): the network has not "
+        "been quantized!");
+  }
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("QuantizedFFN::Predict(): batchSize must be "
+        "positive!");
+  }
+
+  std::vector<LayerTypes<CustomLayers...> >& model = network.network;
+  arma::mat input, output;
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    input = predictors.cols(begin, begin + effectiveBatchSize - 1);
+
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+      if (layerIndices[i] != size_t(-1))
+        layers[layerIndices[i]].Forward(input, output);
+      else
+        boost::apply_visitor(ForwardVisitor(input, output), model[i]);
+
+      input.swap(output);
+    }
+
+    if (begin == 0)
+      results.set_size(input.n_rows, predictors.n_cols);
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = input;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename Archive>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::serialize(Archive& ar,
+                                              const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(network));
+  ar(CEREAL_NVP(layers));
+  ar(CEREAL_NVP(layerIndices));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
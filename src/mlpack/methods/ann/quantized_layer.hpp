@@ -0,0 +1,197 @@
+/**
+ * @file methods/ann/quantized_layer.hpp
+ *
+ * Definition of the QuantizedLayer class, an int8 version of a Linear,
+ * LinearNoBias, Convolution or Lookup layer for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_LAYER_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_LAYER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A trained layer whose weights are quantized to 8-bit integers, for
+ * inference only.  Each output channel (a row of the weights of a Linear or
+ * LinearNoBias layer, or the filters of an output map of a Convolution layer)
+ * is stored as int8 values with its own scale, max |w| / 127.  The input of
+ * the layer is quantized with a single scale, which is given by the largest
+ * absolute input seen on calibration data, and the products are computed in
+ * 32-bit integers and then scaled back to double precision, before the bias
+ * (which is kept in double precision) is added.
+ *
+ * A Lookup layer stores each embedding as int8 values with its own scale; its
+ * input (the tokens) isn't quantized, and its output is the dequantized
+ * embeddings.
+ *
+ * The weights take an eighth of the memory of the weights of the original
+ * layer.  The output is close to the output of the original layer, as long as
+ * the inputs stay in the calibrated range; larger inputs are clipped.
+ */
+class QuantizedLayer
+{
+ public:
+  //! The kinds of layers that can be quantized.
+  enum LayerType
+  {
+    DENSE,
+    CONVOLUTION,
+    LOOKUP
+  };
+
+  //! Create an empty QuantizedLayer object; this is mostly useful to load a
+  //! layer into.
+  QuantizedLayer();
+
+  /**
+   * Quantize the given Linear layer.
+   *
+   * @param layer Layer to quantize.
+   * @param inputMax Largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const Linear<>& layer, const double inputMax);
+
+  /**
+   * Quantize the given LinearNoBias layer.
+   *
+   * @param layer Layer to quantize.
+   * @param inputMax Largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const LinearNoBias<>& layer, const double inputMax);
+
+  /**
+   * Quantize the given Convolution layer.  The input size of the layer must
+   * be known, so the layer must have been run forward at least once.
+   *
+   * @param layer Layer to quantize.
+   * @param inputMax Largest absolute value of the inputs of the layer.
+   */
+  QuantizedLayer(const Convolution<>& layer, const double inputMax);
+
+  /**
+   * Quantize the given Lookup layer.
+   *
+   * @param layer Layer to quantize.
+   */
+  QuantizedLayer(const Lookup<>& layer);
+
+  /**
+   * Compute the output of the layer for the given input, in the same layout as
+   * the original layer.
+   *
+   * @param input Input data used for evaluating the layer.
+   * @param output Resulting output activation.
+   */
+  void Forward(const arma::mat& input, arma::mat& output) const;
+
+  //! Get the kind of the layer.
+  LayerType Type() const { return type; }
+
+  //! Get the quantized weights; column j holds the weights of output channel
+  //! j (or embedding j, for a Lookup layer).
+  const arma::Mat<arma::s8>& Weights() const { return weights; }
+
+  //! Get the scale of the weights of each output channel.
+  const arma::vec& Scales() const { return scales; }
+
+  //! Get the bias (empty if the layer has no bias).
+  const arma::vec& Bias() const { return bias; }
+
+  //! Get the scale of the quantized input.
+  double InputScale() const { return inputScale; }
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Quantize each column of the given matrix with its own scale.
+  void QuantizeColumns(const arma::mat& matrix);
+
+  //! Set the scale of the input from the largest absolute input.
+  void SetInputScale(const double inputMax);
+
+  //! Round the given value to the nearest int8, clipping it to [-127, 127].
+  static arma::s8 Quantize(const double value);
+
+  /**
+   * Compute weights^T * input in 32-bit integers; output(m, n) is the dot
+   * product of the weights of output channel m with column n of the input.
+   */
+  void IntegerProduct(const arma::Mat<arma::s8>& input,
+                      arma::Mat<arma::s32>& output) const;
+
+  //! The output of a Linear or LinearNoBias layer.
+  void DenseForward(const arma::mat& input, arma::mat& output) const;
+
+  //! The output of a Convolution layer.
+  void ConvolutionForward(const arma::mat& input, arma::mat& output) const;
+
+  //! The output of a Lookup layer.
+  void LookupForward(const arma::mat& input, arma::mat& output) const;
+
+  //! The kind of the layer.
+  LayerType type;
+
+  //! The quantized weights, one output channel per column.
+  arma::Mat<arma::s8> weights;
+
+  //! The scale of each column of the weights.
+  arma::vec scales;
+
+  //! The bias of each output channel.
+  arma::vec bias;
+
+  //! The scale of the quantized input.
+  double inputScale;
+
+  //! The number of input maps (Convolution only).
+  size_t inSize;
+
+  //! The width of the input maps (Convolution only).
+  size_t inputWidth;
+
+  //! The height of the input maps (Convolution only).
+  size_t inputHeight;
+
+  //! The width of the filters (Convolution only).
+  size_t kernelWidth;
+
+  //! The height of the filters (Convolution only).
+  size_t kernelHeight;
+
+  //! The stride in the width direction (Convolution only).
+  size_t strideWidth;
+
+  //! The stride in the height direction (Convolution only).
+  size_t strideHeight;
+
+  //! The padding on the left (Convolution only).
+  size_t padWLeft;
+
+  //! The padding on the right (Convolution only).
+  size_t padWRight;
+
+  //! The padding on the top (Convolution only).
+  size_t padHTop;
+
+  //! The padding on the bottom (Convolution only).
+  size_t padHBottom;
+}; // class QuantizedLayer
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_layer_impl.hpp"
+
+#endif
@@ -0,0 +1,286 @@
+/**
+ * @file methods/ann/quantized_layer_impl.hpp
+ *
+ * Implementation of the QuantizedLayer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_LAYER_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_LAYER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_layer.hpp"
+
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+inline QuantizedLayer::QuantizedLayer() :
+    type(DENSE),
+    inputScale(1.0),
+    inSize(0),
+    inputWidth(0),
+    inputHeight(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(0),
+    strideHeight(0),
+    padWLeft(0),
+    padWRight(0),
+    padHTop(0),
+    padHBottom(0)
+{
+  // Nothing to do here.
+}
+
+inline QuantizedLayer::QuantizedLayer(const Linear<>& layer,
+                                      const double inputMax) :
+    QuantizedLayer()
+{
+  // The parameters are the (outSize x inSize) weights followed by the bias.
+  const size_t weightSize = layer.OutputSize() * layer.InputSize();
+  const arma::mat weight(const_cast<double*>(layer.Parameters().memptr()),
+      layer.OutputSize(), layer.InputSize(), false, true);
+  QuantizeColumns(weight.t());
+  bias = layer.Parameters().rows(weightSize, weightSize +
+      layer.OutputSize() - 1);
+  SetInputScale(inputMax);
+}
+
+inline QuantizedLayer::QuantizedLayer(const LinearNoBias<>& layer,
+                                      const double inputMax) :
+    QuantizedLayer()
+{
+  const arma::mat weight(const_cast<double*>(layer.Parameters().memptr()),
+      layer.OutputSize(), layer.InputSize(), false, true);
+  QuantizeColumns(weight.t());
+  SetInputScale(inputMax);
+}
+
+inline QuantizedLayer::QuantizedLayer(const Convolution<>& layer,
+                                      const double inputMax) :
+    QuantizedLayer()
+{
+  type = CONVOLUTION;
+  inSize = layer.InputSize();
+  inputWidth = layer.InputWidth();
+  inputHeight = layer.InputHeight();
+  kernelWidth = layer.KernelWidth();
+  kernelHeight = layer.KernelHeight();
+  strideWidth = layer.StrideWidth();
+  strideHeight = layer.StrideHeight();
+  padWLeft = layer.PadWLeft();
+  padWRight = layer.PadWRight();
+  padHTop = layer.PadHTop();
+  padHBottom = layer.PadHBottom();
+
+  if (inputWidth == 0 || inputHeight == 0)
+  {
+    throw std::invalid_argument("QuantizedLayer::QuantizedLayer(): the input "
+        "size of the Convolution layer is unknown; run the layer forward "
+        "first!");
+  }
+
+  // The weights are already stored as a filter bank: column o holds the
+  // filters of output map o.
+  const arma::mat filters(const_cast<double*>(layer.Weight().memptr()),
+      kernelWidth * kernelHeight * inSize, layer.OutputSize(), false, true);
+  QuantizeColumns(filters);
+  bias = arma::vectorise(layer.Bias());
+  SetInputScale(inputMax);
+}
+
+inline QuantizedLayer::QuantizedLayer(const Lookup<>& layer) :
+    QuantizedLayer()
+{
+  type = LOOKUP;
+  QuantizeColumns(layer.Parameters());
+}
+
+inline void QuantizedLayer::Forward(const arma::mat& input,
+                                    arma::mat& output) const
+{
+  if (type == CONVOLUTION)
+    ConvolutionForward(input, output);
+  else if (type == LOOKUP)
+    LookupForward(input, output);
+  else
+    DenseForward(input, output);
+}
+
+inline void QuantizedLayer::QuantizeColumns(const arma::mat& matrix)
+{
+  weights.set_size(matrix.n_rows, matrix.n_cols);
+  scales.set_size(matrix.n_cols);
+  for (size_t j = 0; j < matrix.n_cols; ++j)
+  {
+    const double maxAbs = arma::abs(matrix.col(j)).max();
+    scales[j] = (maxAbs > 0.0) ? maxAbs / 127.0 : 1.0;
+    for (size_t i = 0; i < matrix.n_rows; ++i)
+      weights(i, j) = Quantize(matrix(i, j) / scales[j]);
+  }
+}
+
+inline void QuantizedLayer::SetInputScale(const double inputMax)
+{
+  inputScale = (inputMax > 0.0) ? inputMax / 127.0 : 1.0;
+}
+
+inline arma::s8 QuantizedLayer::Quantize(const double value)
+{
+  return (arma::s8) std::max(-127.0, std::min(127.0, std::round(value)));
+}
+
+inline void QuantizedLayer::IntegerProduct(const arma::Mat<arma::s8>& input,
+                                           arma::Mat<arma::s32>& output) const
+{
+  // Each product of two int8 values is at most 127^2, so the sums can't
+  // overflow unless there are more than 133000 of them.
+  const size_t k = weights.n_rows;
+  output.set_size(weights.n_cols, input.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    const arma::s8* x = input.colptr(j);
+    arma::s32* y = output.colptr(j);
+    for (size_t m = 0; m < weights.n_cols; ++m)
+    {
+      const arma::s8* w = weights.colptr(m);
+      arma::s32 sum = 0;
+      for (size_t i = 0; i < k; ++i)
+        sum += arma::s32(w[i]) * arma::s32(x[i]);
+
+      y[m] = sum;
+    }
+  }
+}
+
+inline void QuantizedLayer::DenseForward(const arma::mat& input,
+                                         arma::mat& output) const
+{
+  arma::Mat<arma::s8> quantizedInput(input.n_rows, input.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    quantizedInput[i] = Quantize(input[i] / inputScale);
+
+  arma::Mat<arma::s32> product;
+  IntegerProduct(quantizedInput, product);
+
+  output.set_size(product.n_rows, product.n_cols);
+  for (size_t j = 0; j < product.n_cols; ++j)
+  {
+    for (size_t m = 0; m < product.n_rows; ++m)
+    {
+      output(m, j) = scales[m] * inputScale * product(m, j) +
+          (bias.is_empty() ? 0.0 : bias[m]);
+    }
+  }
+}
+
+inline void QuantizedLayer::ConvolutionForward(const arma::mat& input,
+                                               arma::mat& output) const
+{
+  const size_t batchSize = input.n_cols;
+  const size_t paddedWidth = inputWidth + padWLeft + padWRight;
+  const size_t paddedHeight = inputHeight + padHTop + padHBottom;
+
+  // Quantize the input maps into the middle of the padded maps.
+  arma::Cube<arma::s8> padded(paddedWidth, paddedHeight, inSize * batchSize,
+      arma::fill::zeros);
+  const double* inputPtr = input.memptr();
+  for (size_t s = 0; s < padded.n_slices; ++s)
+  {
+    for (size_t j = 0; j < inputHeight; ++j)
+    {
+      for (size_t i = 0; i < inputWidth; ++i, ++inputPtr)
+        padded(padWLeft + i, padHTop + j, s) = Quantize(*inputPtr / inputScale);
+    }
+  }
+
+  // These are the output sizes of Im2Col().
+  const size_t outputRows = (paddedWidth - kernelWidth) / strideWidth + 1;
+  const size_t outputCols = (paddedHeight - kernelHeight) / strideHeight + 1;
+  const size_t outputSize = outputRows * outputCols;
+
+  // The lowered input of every point of the batch, with one output element
+  // per column, so that the whole batch is a single integer product.
+  arma::Mat<arma::s8> lowered(weights.n_rows, outputSize * batchSize);
+  #pragma omp parallel
+  {
+    arma::Mat<arma::s8> columns;
+
+    #pragma omp for
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
+    {
+      size_t rows, cols;
+      Im2ColConvolution<ValidConvolution>::Im2Col(padded, b * inSize, inSize,
+          kernelWidth, kernelHeight, columns, rows, cols, strideWidth,
+          strideHeight);
+      lowered.cols(b * outputSize, (b + 1) * outputSize - 1) = columns.t();
+    }
+  }
+
+  arma::Mat<arma::s32> product;
+  IntegerProduct(lowered, product);
+
+  // Output map o of point b is row o of the product for the output elements
+  // of point b.
+  output.set_size(outputSize * weights.n_cols, batchSize);
+  for (size_t b = 0; b < batchSize; ++b)
+  {
+    double* outputPtr = output.colptr(b);
+    for (size_t o = 0; o < weights.n_cols; ++o)
+    {
+      const double scale = scales[o] * inputScale;
+      for (size_t p = 0; p < outputSize; ++p, ++outputPtr)
+        *outputPtr = scale * product(o, b * outputSize + p) + bias[o];
+    }
+  }
+}
+
+inline void QuantizedLayer::LookupForward(const arma::mat& input,
+                                          arma::mat& output) const
+{
+  // Like Lookup, the tokens are 1-based.
+  const size_t embeddingSize = weights.n_rows;
+  output.set_size(embeddingSize * input.n_rows, input.n_cols);
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    for (size_t t = 0; t < input.n_rows; ++t)
+    {
+      const size_t token = (size_t) input(t, j) - 1;
+      output.col(j).subvec(t * embeddingSize, (t + 1) * embeddingSize - 1) =
+          scales[token] * arma::conv_to<arma::vec>::from(weights.col(token));
+    }
+  }
+}
+
+template<typename Archive>
+void QuantizedLayer::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(type));
+  ar(CEREAL_NVP(weights));
+  ar(CEREAL_NVP(scales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(inputWidth));
+  ar(CEREAL_NVP(inputHeight));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(padHBottom));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -300,7 +300,10 @@ class RBM
   SampleSlab(InputType& slabMean, DataType& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling, for every column of the
+   * input at once.  With persistent CD-k, the chains continue from their state
+   * after the previous call instead, as long as there are as many chains as
+   * input columns.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -380,6 +383,17 @@ class RBM
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  /**
+   * Replace each element of the given matrix, a probability, with a sample of
+   * the Bernoulli distribution of that probability.  The uniform samples of
+   * the whole matrix are drawn at once.
+   *
+   * @param probabilities Probabilities to sample from; overwritten with the
+   *        samples.
+   */
+  template<typename MatType>
+  static void SampleBernoulli(MatType& probabilities);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
@@ -136,8 +136,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   DataType hiddenBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem,
       hiddenSize, 1, false, false);
 
-  HiddenMean(input, hiddenBiasGrad);
-  weightGrad.slice(0) = hiddenBiasGrad * input.t();
+  DataType visibleBiasGrad = DataType(gradient.memptr() + weightGrad.n_elem +
+      hiddenBiasGrad.n_elem, visibleSize, 1, false, false);
+
+  // The gradients are summed over the columns of the input.
+  DataType hiddenMean;
+  HiddenMean(input, hiddenMean);
+  weightGrad.slice(0) = hiddenMean * input.t();
+  hiddenBiasGrad = arma::sum(hiddenMean, 1);
+  visibleBiasGrad = arma::sum(input, 1);
 }
 
 template<
@@ -168,11 +175,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>& output)
 {
   HiddenMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -187,11 +190,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>& output)
 {
   VisibleMean(input, output);
-
-  for (size_t i = 0; i < output.n_elem; ++i)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  SampleBernoulli(output);
 }
 
 template<
@@ -238,7 +237,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
 {
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
-  if (persistence && !state.is_empty())
+  if (persistence && state.n_cols == input.n_cols)
   {
     SampleHidden(state, gibbsTemporary);
     SampleVisible(gibbsTemporary, output);
@@ -277,7 +276,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(predictors.cols(i, i + batchSize - 1),
       positiveGradient);
 
-  for (size_t i = 0; i < negSteps; ++i)
+  for (size_t step = 0; step < negSteps; ++step)
   {
     Gibbs(predictors.cols(i, i + batchSize - 1),
         negativeSamples);
@@ -289,6 +288,21 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   gradient = ((negativeGradient / negSteps) - positiveGradient);
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename MatType>
+void RBM<InitializationRuleType, DataType, PolicyType>::SampleBernoulli(
+    MatType& probabilities)
+{
+  const arma::Mat<ElemType> uniform(probabilities.n_rows,
+      probabilities.n_cols, arma::fill::randu);
+  probabilities = arma::conv_to<arma::Mat<ElemType>>::from(
+      uniform < probabilities);
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -160,10 +160,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; ++k)
   {
-    for (size_t i = 0; i < visibleSize; ++i)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output = visibleMean + (1.0 / visiblePenalty(0)) *
+        arma::randn<arma::Mat<ElemType>>(visibleSize, 1);
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -256,10 +254,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     InputType& spikeMean,
     DataType& spike)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  SampleBernoulli(spike);
 }
 
 template<
@@ -292,13 +288,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     InputType& slabMean,
     DataType& slab)
 {
-  for (size_t i = 0; i < hiddenSize; ++i)
-  {
-    for (size_t j = 0; j < poolSize; ++j)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  slab = slabMean + (1.0 / slabPenalty) *
+      arma::randn<arma::Mat<ElemType>>(poolSize, hiddenSize);
 }
 
 } // namespace ann
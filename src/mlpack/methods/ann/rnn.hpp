@@ -20,6 +20,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "util/workspace.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -179,6 +180,57 @@ class RNN
                arma::cube responses,
                CallbackTypes&&... callbacks);
 
+  /**
+   * Train the recurrent neural network on sequences of different lengths,
+   * using the given optimizer.  The sequences are padded to the same number of
+   * time steps in the predictors (and responses), and sequenceLengths[i] is the
+   * number of time steps of sequence i; the padding is ignored.
+   *
+   * The sequences are sorted by length, so that the sequences of each batch
+   * have about the same length, and each batch is only run for as many time
+   * steps as its longest sequence has.  The loss is only computed on the time
+   * steps of each sequence (if the network predicts only the last element of a
+   * sequence, on its last time step), so the padding doesn't change the
+   * gradient.  When the optimizer shuffles the data, the sequences are
+   * shuffled and then sorted by length again, so only sequences of the same
+   * length change order.  Time steps after rho are ignored.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Number of time steps of each sequence.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  double Train(arma::cube predictors,
+               arma::cube responses,
+               arma::urowvec sequenceLengths,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the recurrent neural network on sequences of different lengths (see
+   * the overload above) with a default-constructed optimizer.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Number of time steps of each sequence.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::StandardSGD, typename... CallbackTypes>
+  double Train(arma::cube predictors,
+               arma::cube responses,
+               arma::urowvec sequenceLengths,
+               CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -194,6 +246,13 @@ class RNN
    * So, e.g., predictors(i, j, k) is the i'th dimension of the j'th data point
    * at time slice k.  The responses will be in the same format.
    *
+   * If the network is stateful (see Stateful()), each column is a stream: all
+   * the time steps of the predictors are predicted, in windows of rho time
+   * steps, and all the streams are predicted at once (batchSize is ignored).
+   * The state of the recurrent cells at the end of the predictors is the
+   * initial state of the next call, so a stream can be predicted online, in
+   * pieces, until ResetState() is called.
+   *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Number of points to predict at once.
@@ -202,6 +261,24 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Predict the responses to sequences of different lengths.  The sequences
+   * are padded as for training, and sequenceLengths[i] is the number of time
+   * steps of sequence i.  The sequences are sorted by length, so that the
+   * sequences of each batch have about the same length, and each batch is only
+   * run for as many time steps as its longest sequence has.  The results of
+   * the time steps after the end of each sequence are zero.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param sequenceLengths Number of time steps of each sequence.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(arma::cube predictors,
+               arma::cube& results,
+               const arma::urowvec& sequenceLengths,
+               const size_t batchSize = 256);
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -313,6 +390,26 @@ class RNN
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get the lengths of the training sequences, in the order of the
+  //! predictors (empty if all the sequences have rho time steps).
+  const arma::urowvec& SequenceLengths() const { return sequenceLengths; }
+
+  //! Get whether the network is stateful.
+  bool Stateful() const { return stateful; }
+  //! Modify whether the network is stateful.  A stateful network is trained
+  //! with truncated BPTT: each training sequence is a stream of any number of
+  //! time steps, which is split into windows of rho time steps; the state of
+  //! the recurrent cells at the end of a window is the initial state of the
+  //! next one, and the gradient is only propagated back through each window.
+  //! Predict() then carries the state of the cells from one call to the next.
+  bool& Stateful() { return stateful; }
+
+  /**
+   * Reset the state of the recurrent cells, so that the next call to Predict()
+   * of a stateful network starts new streams.
+   */
+  void ResetState();
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -340,11 +437,122 @@ class RNN
   template<typename InputType>
   void Forward(const InputType& input);
 
+  /**
+   * Set the training data, sorting the sequences by decreasing length if
+   * sequence lengths are given, and prepare the network for training.
+   *
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Number of time steps of each sequence (may be
+   *     empty).
+   */
+  void ResetData(arma::cube predictors,
+                 arma::cube responses,
+                 arma::urowvec sequenceLengths);
+
+  /**
+   * Throw a std::invalid_argument if the given sequence lengths don't match
+   * the given predictors.
+   *
+   * @param sequenceLengths Number of time steps of each sequence.
+   * @param predictors Input data.
+   * @param functionName Name of the calling function, for the message.
+   */
+  void CheckSequenceLengths(const arma::urowvec& sequenceLengths,
+                            const arma::cube& predictors,
+                            const std::string& functionName) const;
+
+  /**
+   * Reorder the training sequences (and their lengths).
+   *
+   * @param order The new order of the sequences.
+   */
+  void SortSequences(const arma::uvec& order);
+
+  /**
+   * Find the points of the given batch for which the loss is computed at the
+   * given time step, when sequence lengths are given.  Since the sequences
+   * are sorted by decreasing length, these are the points [first, last) of the
+   * batch.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param step Time step.
+   * @param first Set to the index (in the batch) of the first point.
+   * @param last Set to the index (in the batch) after the last point.
+   */
+  void ActivePoints(const size_t begin,
+                    const size_t batchSize,
+                    const size_t step,
+                    size_t& first,
+                    size_t& last) const;
+
+  /**
+   * Compute the loss of the points of the given batch that are active at the
+   * given time step, when sequence lengths are given.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param step Time step of the current output of the network.
+   * @param responseSeq Time step of the responses to use.
+   */
+  double MaskedLoss(const size_t begin,
+                    const size_t batchSize,
+                    const size_t step,
+                    const size_t responseSeq);
+
+  /**
+   * Set the error of the output of the network at the given time step, when
+   * sequence lengths are given; the error of the inactive points is zero.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param step Time step of the current output of the network.
+   * @param responseSeq Time step of the responses to use.
+   */
+  void MaskedError(const size_t begin,
+                   const size_t batchSize,
+                   const size_t step,
+                   const size_t responseSeq);
+
   /**
    * Reset the state of RNN cells in the network for new input sequence.
    */
   void ResetCells();
 
+  /**
+   * Prepare the RNN cells in the network for a window of the given number of
+   * time steps of a stream.
+   *
+   * @param steps Number of time steps of the window.
+   * @param carry Whether the state at the end of the previous window is the
+   *     initial state of this one.
+   */
+  void StartWindow(const size_t steps, const bool carry);
+
+  /**
+   * Evaluate the stateful network on the streams of the given batch, one
+   * window of rho time steps at a time, and add the gradient (truncated to
+   * each window) to the given gradient if it isn't NULL.
+   *
+   * @param begin Index of the first stream of the batch.
+   * @param batchSize Number of streams of the batch.
+   * @param gradient Matrix to add the gradient to, or NULL.
+   */
+  template<typename GradType>
+  double StreamEvaluate(const size_t begin,
+                        const size_t batchSize,
+                        GradType* gradient);
+
+  /**
+   * Predict the responses to the given streams with the stateful network,
+   * carrying the state of the previous call.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void StreamPredict(const arma::cube& predictors, arma::cube& results);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -394,6 +602,13 @@ class RNN
     //! Only predict the last element of the input sequence.
   bool single;
 
+  //! Whether the network is trained and used on streams (see Stateful()).
+  bool stateful;
+
+  //! Whether the state of the cells at the end of the last call to Predict()
+  //! is kept for the next one.
+  bool streaming;
+
   //! Locally-stored model modules.
   std::vector<LayerTypes<CustomLayers...> > network;
 
@@ -403,6 +618,10 @@ class RNN
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! The number of time steps of each training sequence (empty if all the
+  //! sequences have rho time steps).
+  arma::urowvec sequenceLengths;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
@@ -418,8 +637,9 @@ class RNN
   //! Locally-stored output parameter visitor.
   OutputParameterVisitor outputParameterVisitor;
 
-  //! List of all module parameters for the backward pass (BBTT).
-  std::vector<arma::mat> moduleOutputParameter;
+  //! The module parameters of every time step for the backward pass (BBTT),
+  //! kept between the passes so they don't have to be allocated again.
+  Workspace moduleOutputParameter;
 
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
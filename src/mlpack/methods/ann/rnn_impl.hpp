@@ -20,6 +20,7 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/carry_state_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -45,6 +46,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    stateful(false),
+    streaming(false),
     numFunctions(0),
     deterministic(true)
 {
@@ -63,6 +66,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(network.targetSize),
     reset(network.reset),
     single(network.single),
+    stateful(network.stateful),
+    streaming(false),
     parameter(network.parameter),
     numFunctions(network.numFunctions),
     deterministic(network.deterministic)
@@ -87,6 +92,8 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(std::move(network.targetSize)),
     reset(std::move(network.reset)),
     single(std::move(network.single)),
+    stateful(network.stateful),
+    streaming(network.streaming),
     network(std::move(network.network)),
     parameter(std::move(network.parameter)),
     numFunctions(std::move(network.numFunctions)),
@@ -153,18 +160,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
                                                               predictors.n_rows, 
                                                               "RNN<>::Train()");
 
-  numFunctions = responses.n_cols;
-
-  this->predictors = std::move(predictors);
-  this->responses = std::move(responses);
-
-  this->deterministic = true;
-  ResetDeterministic();
-
-  if (!reset)
-  {
-    ResetParameters();
-  }
+  ResetData(std::move(predictors), std::move(responses), arma::urowvec());
 
   WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
 
@@ -189,6 +185,29 @@ void RNN<OutputLayerType, InitializationRuleType,
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StartWindow(const size_t steps, const bool carry)
+{
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    if (carry)
+      boost::apply_visitor(CarryStateVisitor(steps), network[i]);
+    else
+      boost::apply_visitor(ResetCellVisitor(steps), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetState()
+{
+  ResetCells();
+  streaming = false;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType, typename... CallbackTypes>
@@ -201,10 +220,105 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
                                                               predictors.n_rows, 
                                                               "RNN<>::Train()");
 
+  ResetData(std::move(predictors), std::move(responses), arma::urowvec());
+
+  OptimizerType optimizer;
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::urowvec sequenceLengths,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      predictors.n_rows, "RNN<>::Train()");
+  CheckSequenceLengths(sequenceLengths, predictors, "RNN<>::Train()");
+
+  ResetData(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter, callbacks...);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType, typename... CallbackTypes>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::urowvec sequenceLengths,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer, callbacks...);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::urowvec sequenceLengths)
+{
+  if (stateful && single)
+  {
+    throw std::invalid_argument("RNN<>::Train(): a stateful network can't "
+        "predict only the last element of the sequences!");
+  }
+
+  if (stateful && !sequenceLengths.is_empty())
+  {
+    throw std::invalid_argument("RNN<>::Train(): sequence lengths can't be "
+        "given to a stateful network!");
+  }
+
+  if (stateful && responses.n_slices != predictors.n_slices)
+  {
+    std::ostringstream oss;
+    oss << "RNN<>::Train(): the predictors have " << predictors.n_slices
+        << " time steps, but the responses have " << responses.n_slices
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
   numFunctions = responses.n_cols;
+  streaming = false;
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths = std::move(sequenceLengths);
+
+  // With the longest sequences first, the sequences of a batch have about the
+  // same length, and the sequences that are still running at a given time
+  // step are the first ones of the batch.
+  if (!this->sequenceLengths.is_empty())
+    SortSequences(arma::stable_sort_index(this->sequenceLengths, "descend"));
 
   this->deterministic = true;
   ResetDeterministic();
@@ -213,19 +327,123 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   {
     ResetParameters();
   }
+}
 
-  OptimizerType optimizer;
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+CheckSequenceLengths(const arma::urowvec& sequenceLengths,
+                     const arma::cube& predictors,
+                     const std::string& functionName) const
+{
+  if (sequenceLengths.n_elem != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << functionName << ": " << sequenceLengths.n_elem << " sequence "
+        << "lengths were given, but there are " << predictors.n_cols
+        << " sequences!";
+    throw std::invalid_argument(oss.str());
+  }
 
-  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+  if (!sequenceLengths.is_empty() && (sequenceLengths.min() == 0 ||
+      sequenceLengths.max() > predictors.n_slices))
+  {
+    std::ostringstream oss;
+    oss << functionName << ": the sequence lengths must be between 1 and the "
+        << "number of time steps of the predictors (" << predictors.n_slices
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
 
-  // Train the model.
-  Timer::Start("rnn_optimization");
-  const double out = optimizer.Optimize(*this, parameter, callbacks...);
-  Timer::Stop("rnn_optimization");
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+SortSequences(const arma::uvec& order)
+{
+  for (size_t s = 0; s < predictors.n_slices; ++s)
+    predictors.slice(s) = arma::mat(predictors.slice(s).cols(order));
 
-  Log::Info << "RNN::RNN(): final objective of trained model is " << out
-      << "." << std::endl;
-  return out;
+  for (size_t s = 0; s < responses.n_slices; ++s)
+    responses.slice(s) = arma::mat(responses.slice(s).cols(order));
+
+  sequenceLengths = arma::urowvec(sequenceLengths.cols(order));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ActivePoints(const size_t begin,
+             const size_t batchSize,
+             const size_t step,
+             size_t& first,
+             size_t& last) const
+{
+  // The time steps after rho are ignored.
+  last = 0;
+  while (last < batchSize &&
+      std::min(size_t(sequenceLengths[begin + last]), rho) > step)
+  {
+    ++last;
+  }
+
+  // If only the last element of each sequence is predicted, the loss is
+  // computed for the sequences that end at this step.
+  first = 0;
+  if (single)
+  {
+    while (first < last &&
+        std::min(size_t(sequenceLengths[begin + first]), rho) > step + 1)
+    {
+      ++first;
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+MaskedLoss(const size_t begin,
+           const size_t batchSize,
+           const size_t step,
+           const size_t responseSeq)
+{
+  size_t first, last;
+  ActivePoints(begin, batchSize, step, first, last);
+  if (first == last)
+    return 0.0;
+
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  return outputLayer.Forward(arma::mat(output.colptr(first), output.n_rows,
+      last - first, false, true), arma::mat(responses.slice(
+      responseSeq).colptr(begin + first), responses.n_rows, last - first,
+      false, true));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+MaskedError(const size_t begin,
+            const size_t batchSize,
+            const size_t step,
+            const size_t responseSeq)
+{
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  error.zeros(output.n_rows, batchSize);
+
+  size_t first, last;
+  ActivePoints(begin, batchSize, step, first, last);
+  if (first == last)
+    return;
+
+  arma::mat activeError;
+  outputLayer.Backward(arma::mat(output.colptr(first), output.n_rows,
+      last - first, false, true), arma::mat(responses.slice(
+      responseSeq).colptr(begin + first), responses.n_rows, last - first,
+      false, true), activeError);
+  error.cols(first, last - 1) = activeError;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -237,7 +455,13 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
                                                               predictors.n_rows, 
                                                               "RNN<>::Predict()");
 
-  ResetCells();
+  if (stateful)
+  {
+    StreamPredict(predictors, results);
+    return;
+  }
+
+  ResetState();
 
   if (parameter.is_empty())
   {
@@ -280,6 +504,117 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+StreamPredict(const arma::cube& predictors, arma::cube& results)
+{
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  // Only one window of the streams is kept in memory at a time.
+  for (size_t start = 0; start < predictors.n_slices; start += rho)
+  {
+    const size_t steps = std::min(rho, size_t(predictors.n_slices - start));
+    StartWindow(steps, streaming || start > 0);
+
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      Forward(arma::mat(const_cast<double*>(predictors.slice(start +
+          seqNum).memptr()), predictors.n_rows, predictors.n_cols, false,
+          true));
+
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network.back());
+      if (start == 0 && seqNum == 0)
+      {
+        outputSize = output.n_rows;
+        results.set_size(outputSize, predictors.n_cols, predictors.n_slices);
+      }
+
+      results.slice(start + seqNum) = output;
+    }
+  }
+
+  streaming = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    arma::cube predictors,
+    arma::cube& results,
+    const arma::urowvec& sequenceLengths,
+    const size_t batchSize)
+{
+  CheckInputShape<std::vector<LayerTypes<CustomLayers...> > >(network,
+      predictors.n_rows, "RNN<>::Predict()");
+  CheckSequenceLengths(sequenceLengths, predictors, "RNN<>::Predict()");
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("RNN<>::Predict(): batchSize must be "
+        "positive!");
+  }
+
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  streaming = false;
+
+  // The batches are made of sequences of about the same length, the longest
+  // first.
+  const arma::uvec order = arma::stable_sort_index(sequenceLengths, "descend");
+
+  results.reset();
+  arma::mat stepData;
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    const arma::uvec batch = order.subvec(begin,
+        begin + effectiveBatchSize - 1);
+    const size_t steps = std::min(size_t(sequenceLengths[batch[0]]), rho);
+
+    ResetCells();
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      stepData = predictors.slice(seqNum).cols(batch);
+      Forward(stepData);
+
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network.back());
+      if (results.is_empty())
+      {
+        outputSize = output.n_rows;
+        results.zeros(outputSize, predictors.n_cols, rho);
+      }
+
+      for (size_t j = 0; j < effectiveBatchSize &&
+          sequenceLengths[batch[j]] > seqNum; ++j)
+      {
+        results.slice(seqNum).col(batch[j]) = output.col(j);
+      }
+    }
+  }
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
@@ -309,12 +644,20 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  if (stateful)
+    return StreamEvaluate(begin, batchSize, (arma::mat*) NULL);
+
+  ResetState();
 
   double performance = 0;
   size_t responseSeq = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // With sequence lengths, the batch is only run until its longest sequence
+  // (the first one) ends.
+  const size_t steps = sequenceLengths.is_empty() ? rho :
+      std::min(size_t(sequenceLengths[begin]), rho);
+
+  for (size_t seqNum = 0; seqNum < steps; ++seqNum)
   {
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
@@ -325,10 +668,17 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       responseSeq = seqNum;
     }
 
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true));
+    if (sequenceLengths.is_empty())
+    {
+      performance += outputLayer.Forward(boost::apply_visitor(
+          outputParameterVisitor, network.back()),
+          arma::mat(responses.slice(responseSeq).colptr(begin),
+              responses.n_rows, batchSize, false, true));
+    }
+    else
+    {
+      performance += MaskedLoss(begin, batchSize, seqNum, responseSeq);
+    }
   }
 
   if (outputSize == 0)
@@ -390,11 +740,17 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  if (stateful)
+    return StreamEvaluate(begin, batchSize, &gradient);
+
+  ResetState();
+  moduleOutputParameter.Clear();
 
   double performance = 0;
   size_t responseSeq = 0;
-  const size_t effectiveRho = std::min(rho, size_t(responses.size()));
+  const size_t effectiveRho = sequenceLengths.is_empty() ?
+      std::min(rho, size_t(responses.size())) :
+      std::min(size_t(sequenceLengths[begin]), rho);
 
   for (size_t seqNum = 0; seqNum < effectiveRho; ++seqNum)
   {
@@ -413,10 +769,25 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
           network[l]);
     }
 
-    performance += outputLayer.Forward(boost::apply_visitor(
-        outputParameterVisitor, network.back()),
-        arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true));
+    // Every time step stores the same number of elements, so the workspace can
+    // be sized for the whole sequence at once.
+    if (seqNum == 0)
+    {
+      moduleOutputParameter.Reserve(effectiveRho *
+          moduleOutputParameter.Used());
+    }
+
+    if (sequenceLengths.is_empty())
+    {
+      performance += outputLayer.Forward(boost::apply_visitor(
+          outputParameterVisitor, network.back()),
+          arma::mat(responses.slice(responseSeq).colptr(begin),
+              responses.n_rows, batchSize, false, true));
+    }
+    else
+    {
+      performance += MaskedLoss(begin, batchSize, seqNum, responseSeq);
+    }
   }
 
   if (outputSize == 0)
@@ -443,7 +814,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
           network[network.size() - 1 - l]);
     }
 
-    if (single && seqNum > 0)
+    if (!sequenceLengths.is_empty())
+    {
+      const size_t step = effectiveRho - seqNum - 1;
+      MaskedError(begin, batchSize, step, single ? 0 : step);
+    }
+    else if (single && seqNum > 0)
     {
       error.zeros();
     }
@@ -472,6 +848,96 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   return performance;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+StreamEvaluate(const size_t begin,
+               const size_t batchSize,
+               GradType* gradient)
+{
+  streaming = false;
+
+  if (gradient)
+  {
+    if (currentGradient.is_empty())
+    {
+      currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+          parameter.n_cols);
+    }
+
+    ResetGradients(currentGradient);
+  }
+
+  double performance = 0;
+  for (size_t start = 0; start < predictors.n_slices; start += rho)
+  {
+    // Only the outputs of the current window are stored, and the gradient
+    // isn't propagated back past its beginning.
+    const size_t steps = std::min(rho, size_t(predictors.n_slices - start));
+    StartWindow(steps, start > 0);
+    moduleOutputParameter.Clear();
+
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      Forward(arma::mat(predictors.slice(start + seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+
+      if (gradient)
+      {
+        for (size_t l = 0; l < network.size(); ++l)
+        {
+          boost::apply_visitor(SaveOutputParameterVisitor(
+              moduleOutputParameter), network[l]);
+        }
+
+        if (seqNum == 0)
+        {
+          moduleOutputParameter.Reserve(steps *
+              moduleOutputParameter.Used());
+        }
+      }
+
+      performance += outputLayer.Forward(boost::apply_visitor(
+          outputParameterVisitor, network.back()),
+          arma::mat(responses.slice(start + seqNum).colptr(begin),
+              responses.n_rows, batchSize, false, true));
+    }
+
+    if (outputSize == 0)
+    {
+      outputSize = boost::apply_visitor(outputParameterVisitor,
+          network.back()).n_elem / batchSize;
+    }
+
+    if (!gradient)
+      continue;
+
+    for (size_t seqNum = 0; seqNum < steps; ++seqNum)
+    {
+      const size_t step = start + steps - seqNum - 1;
+      currentGradient.zeros();
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            moduleOutputParameter), network[network.size() - 1 - l]);
+      }
+
+      outputLayer.Backward(boost::apply_visitor(
+          outputParameterVisitor, network.back()),
+          arma::mat(responses.slice(step).colptr(begin),
+          responses.n_rows, batchSize, false, true), error);
+
+      Backward();
+      Gradient(arma::mat(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true));
+      *gradient += currentGradient;
+    }
+  }
+
+  return performance;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -487,6 +953,18 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
+  if (!sequenceLengths.is_empty())
+  {
+    // The sequences have to stay sorted by length, so only the sequences of
+    // the same length change order.
+    const arma::uvec shuffled = arma::shuffle(arma::regspace<arma::uvec>(0,
+        predictors.n_cols - 1));
+    const arma::urowvec shuffledLengths = sequenceLengths.cols(shuffled);
+    SortSequences(shuffled.elem(arma::stable_sort_index(shuffledLengths,
+        "descend")));
+    return;
+  }
+
   arma::cube newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
@@ -514,7 +992,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Reset()
 {
   ResetParameters();
-  ResetCells();
+  ResetState();
   currentGradient.zeros();
   ResetGradients(currentGradient);
 }
@@ -0,0 +1,352 @@
+/**
+ * @file methods/ann/static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose
+ * layers are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/layer_pointer_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose layers are given as template
+ * parameters, for fast inference with a network that has already been built
+ * and trained as an FFN.  The layers are stored by value, and each step of the
+ * forward pass calls the layer directly, so there is no dispatch through the
+ * LayerTypes variant and the compiler can inline the whole network.  This
+ * matters most for small networks that are evaluated on few points at a time.
+ *
+ * A StaticFFN is created from an FFN with exactly the given layers, and can be
+ * converted back to an FFN (for instance, to continue training it).  It is
+ * serialized as the equivalent FFN, so a StaticFFN can be saved and loaded
+ * like an FFN, and a saved FFN can be loaded into a StaticFFN.
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<>> model;
+ * model.Add<Linear<>>(10, 8);
+ * model.Add<SigmoidLayer<>>();
+ * model.Add<Linear<>>(8, 3);
+ * model.Add<LogSoftMax<>>();
+ * model.Train(trainData, trainLabels);
+ *
+ * StaticFFN<NegativeLogLikelihood<>, Linear<>, SigmoidLayer<>, Linear<>,
+ *     LogSoftMax<>> staticModel(model);
+ * staticModel.Predict(testData, predictions);
+ * @endcode
+ *
+ * The element type of the network is given by the layers, so a network that
+ * was trained in double precision can run in single precision, which halves
+ * the memory traffic of inference.  Since the layers are of other types than
+ * the layers of the FFN, they are given explicitly, and only the parameters
+ * are copied:
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, Linear<arma::fmat, arma::fmat>,
+ *     SigmoidLayer<arma::fmat, arma::fmat>, Linear<arma::fmat, arma::fmat>,
+ *     LogSoftMax<arma::fmat, arma::fmat>> floatModel(NegativeLogLikelihood<>(),
+ *     Linear<arma::fmat, arma::fmat>(10, 8),
+ *     SigmoidLayer<arma::fmat, arma::fmat>(),
+ *     Linear<arma::fmat, arma::fmat>(8, 3),
+ *     LogSoftMax<arma::fmat, arma::fmat>());
+ * floatModel.SetParameters(model.Parameters());
+ * floatModel.Predict(arma::conv_to<arma::fmat>::from(testData), predictions);
+ * @endcode
+ *
+ * Only networks of arma::mat layers can be converted to and from an FFN; other
+ * networks are serialized layer by layer.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<typename OutputLayerType, typename... Layers>
+class StaticFFN
+{
+ public:
+  //! The type of the layers of the network.
+  typedef std::tuple<Layers...> NetworkType;
+
+  //! The matrix type of the network, given by the outputs of the layers.
+  typedef typename std::remove_reference<decltype(std::declval<typename
+      std::tuple_element<0, NetworkType>::type&>().OutputParameter())>::type
+      MatType;
+
+  //! The element type of the network.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the StaticFFN object with default-constructed layers and no
+   * parameters.  This is mostly useful to load a network into.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   */
+  StaticFFN(OutputLayerType outputLayer = OutputLayerType());
+
+  /**
+   * Create the StaticFFN object with the given layers.  The parameters are set
+   * to zero, so they should be set with SetParameters() before the network is
+   * used.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param layers The layers of the network.
+   */
+  StaticFFN(OutputLayerType outputLayer, const Layers&... layers);
+
+  /**
+   * Create the StaticFFN object as a copy of the given network, which must
+   * have exactly the layers given by Layers.  A std::invalid_argument is thrown
+   * if the layers of the network are of other types.  If the parameters of the
+   * network haven't been initialized, they are initialized first.
+   *
+   * @param network Network to copy.
+   */
+  template<typename InitializationRuleType, typename... CustomLayers>
+  StaticFFN(FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+      network);
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& network);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN& network);
+
+  /**
+   * Copy the network to the given FFN, which must not have any layers yet.  A
+   * std::invalid_argument is thrown otherwise.  The layers have to be of types
+   * the FFN can hold, so this is only available for arma::mat layers.
+   *
+   * @param network FFN to copy the network to.
+   */
+  template<typename InitializationRuleType, typename... CustomLayers>
+  void ToFFN(FFN<OutputLayerType, InitializationRuleType, CustomLayers...>&
+      network) const;
+
+  /**
+   * Predict the responses to a given set of predictors, passing them through
+   * the network in batches of the given size.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points to predict at once.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 256);
+
+  /**
+   * Evaluate the network on the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  double Evaluate(const PredictorsType& predictors,
+                  const ResponsesType& responses);
+
+  /**
+   * Perform the forward pass of the data in real batch mode.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  void Forward(const PredictorsType& inputs, ResponsesType& results);
+
+  //! Get the layers of the network.
+  const NetworkType& Network() const { return network; }
+
+  //! Get the I'th layer of the network.
+  template<size_t I>
+  const typename std::tuple_element<I, NetworkType>::type& Layer() const
+  {
+    return std::get<I>(network);
+  }
+
+  //! Get the parameters of the network.
+  const MatType& Parameters() const { return parameter; }
+
+  /**
+   * Set the parameters of the network, converting them to the element type of
+   * the network; for instance, to run a network trained as an FFN in single
+   * precision.  A std::invalid_argument is thrown if the number of parameters
+   * doesn't match the layers.
+   *
+   * @param parameters New parameters of the network.
+   */
+  template<typename eT>
+  void SetParameters(const arma::Mat<eT>& parameters);
+
+  //! Serialize the model (as the equivalent FFN, for arma::mat layers).
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Copy the layers of the given network, starting with the I'th layer.
+  template<size_t I, typename LayerVectorType>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  CopyLayers(const LayerVectorType& model);
+
+  //! There are no more layers to copy.
+  template<size_t I, typename LayerVectorType>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  CopyLayers(const LayerVectorType& /* model */) { }
+
+  //! Add copies of the layers to the given network, starting with the I'th
+  //! layer.
+  template<size_t I, typename FFNType>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  AddLayers(FFNType& model) const;
+
+  //! There are no more layers to add.
+  template<size_t I, typename FFNType>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  AddLayers(FFNType& /* model */) const { }
+
+  //! Make the parameters of the layers, starting with the I'th layer at the
+  //! given offset, aliases of the network parameters.
+  template<size_t I>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  ResetParameters(const size_t offset);
+
+  //! There are no more layers to reset.
+  template<size_t I>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  ResetParameters(const size_t /* offset */) { }
+
+  //! Make the parameters of the given layer an alias of the network
+  //! parameters at the given offset, and return their size.
+  template<typename LayerType>
+  typename std::enable_if<
+      HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value &&
+      !HasModelCheck<LayerType>::value, size_t>::type
+  SetWeights(LayerType& layer, const size_t offset);
+
+  //! A layer without parameters has no weights to set.
+  template<typename LayerType>
+  typename std::enable_if<
+      !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value &&
+      !HasModelCheck<LayerType>::value, size_t>::type
+  SetWeights(LayerType& /* layer */, const size_t /* offset */) { return 0; }
+
+  //! The layers inside a layer that holds other layers are arma::mat layers,
+  //! so they are set with WeightSetVisitor.
+  template<typename LayerType>
+  typename std::enable_if<HasModelCheck<LayerType>::value, size_t>::type
+  SetWeights(LayerType& layer, const size_t offset)
+  {
+    return WeightSetVisitor(parameter, offset)(&layer);
+  }
+
+  //! Get the number of parameters of the layers, starting with the I'th layer.
+  template<size_t I>
+  typename std::enable_if<I < sizeof...(Layers), size_t>::type
+  WeightSize() const;
+
+  //! There are no more layers.
+  template<size_t I>
+  typename std::enable_if<I == sizeof...(Layers), size_t>::type
+  WeightSize() const { return 0; }
+
+  //! Set the deterministic mode of the layers, starting with the I'th layer.
+  template<size_t I>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  ResetDeterministic();
+
+  //! There are no more layers to set.
+  template<size_t I>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  ResetDeterministic() { }
+
+  //! Pass the given input through the network, starting with the I'th layer.
+  template<size_t I, typename InputType>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  Forward(const InputType& input);
+
+  //! There are no more layers to pass the input through.
+  template<size_t I, typename InputType>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  Forward(const InputType& /* input */) { }
+
+  //! Serialize the layers, starting with the I'th layer.
+  template<size_t I, typename Archive>
+  typename std::enable_if<I < sizeof...(Layers), void>::type
+  SerializeLayers(Archive& ar);
+
+  //! There are no more layers to serialize.
+  template<size_t I, typename Archive>
+  typename std::enable_if<I == sizeof...(Layers), void>::type
+  SerializeLayers(Archive& /* ar */) { }
+
+  //! Serialize the network as the equivalent FFN.
+  template<typename Archive>
+  void Serialize(Archive& ar, std::true_type /* isMat */);
+
+  //! Serialize the parameters and the layers of the network.
+  template<typename Archive>
+  void Serialize(Archive& ar, std::false_type /* isMat */);
+
+  //! Get the sum of the losses of the layers, starting with the I'th layer.
+  template<size_t I>
+  typename std::enable_if<I < sizeof...(Layers), double>::type
+  Loss();
+
+  //! There are no more layers to get the loss of.
+  template<size_t I>
+  typename std::enable_if<I == sizeof...(Layers), double>::type
+  Loss() { return 0; }
+
+  //! Get the output of the last layer.
+  MatType& NetworkOutput()
+  {
+    return std::get<sizeof...(Layers) - 1>(network).OutputParameter();
+  }
+
+  //! Instantiated output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! The layers of the network.
+  NetworkType network;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The input width of the current layer during the forward pass.
+  size_t width;
+
+  //! The input height of the current layer during the forward pass.
+  size_t height;
+
+  //! Whether the input sizes of the layers have been set.
+  bool reset;
+
+  //! Whether the layers are in deterministic mode.
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
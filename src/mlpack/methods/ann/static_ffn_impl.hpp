@@ -0,0 +1,400 @@
+/**
+ * @file methods/ann/static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward neural network whose
+ * layers are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename... Layers>
+StaticFFN<OutputLayerType, Layers...>::StaticFFN(OutputLayerType outputLayer) :
+    outputLayer(std::move(outputLayer)),
+    width(0),
+    height(0),
+    reset(false),
+    deterministic(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType, typename... Layers>
+StaticFFN<OutputLayerType, Layers...>::StaticFFN(OutputLayerType outputLayer,
+                                                 const Layers&... layers) :
+    outputLayer(std::move(outputLayer)),
+    network(layers...),
+    width(0),
+    height(0),
+    reset(false),
+    deterministic(false)
+{
+  parameter.zeros(WeightSize<0>(), 1);
+  ResetParameters<0>(0);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename InitializationRuleType, typename... CustomLayers>
+StaticFFN<OutputLayerType, Layers...>::StaticFFN(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network) :
+    width(0),
+    height(0),
+    reset(false),
+    deterministic(false)
+{
+  if (network.Model().size() != sizeof...(Layers))
+  {
+    std::ostringstream oss;
+    oss << "StaticFFN::StaticFFN(): the given network has "
+        << network.Model().size() << " layers, but " << sizeof...(Layers)
+        << " were expected!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (network.Parameters().is_empty())
+    network.ResetParameters();
+
+  CopyLayers<0>(network.Model());
+
+  parameter = arma::conv_to<MatType>::from(network.Parameters());
+  ResetParameters<0>(0);
+}
+
+template<typename OutputLayerType, typename... Layers>
+StaticFFN<OutputLayerType, Layers...>::StaticFFN(const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    network(network.network),
+    parameter(network.parameter),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    deterministic(network.deterministic)
+{
+  // The copied layers still refer to the parameters of the other network.
+  ResetParameters<0>(0);
+}
+
+template<typename OutputLayerType, typename... Layers>
+StaticFFN<OutputLayerType, Layers...>&
+StaticFFN<OutputLayerType, Layers...>::operator=(const StaticFFN& network)
+{
+  if (this != &network)
+  {
+    outputLayer = network.outputLayer;
+    this->network = network.network;
+    parameter = network.parameter;
+    width = network.width;
+    height = network.height;
+    reset = network.reset;
+    deterministic = network.deterministic;
+
+    ResetParameters<0>(0);
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename InitializationRuleType, typename... CustomLayers>
+void StaticFFN<OutputLayerType, Layers...>::ToFFN(
+    FFN<OutputLayerType, InitializationRuleType, CustomLayers...>& network)
+    const
+{
+  if (!network.Model().empty())
+  {
+    throw std::invalid_argument("StaticFFN::ToFFN(): the given network "
+        "already has layers!");
+  }
+
+  AddLayers<0>(network);
+
+  // Make the parameters of the new layers aliases of the network parameters,
+  // like FFN::serialize() does when it loads a network.
+  network.Parameters() = parameter;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.Model().size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(network.Parameters(),
+        offset), network.Model()[i]);
+
+    boost::apply_visitor(ResetVisitor(), network.Model()[i]);
+  }
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename eT>
+void StaticFFN<OutputLayerType, Layers...>::SetParameters(
+    const arma::Mat<eT>& parameters)
+{
+  const size_t weights = WeightSize<0>();
+  if (parameters.n_elem != weights)
+  {
+    std::ostringstream oss;
+    oss << "StaticFFN::SetParameters(): the network has " << weights
+        << " parameters, but " << parameters.n_elem << " were given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The layers are bound to the new memory afterwards.
+  parameter = arma::conv_to<MatType>::from(arma::vectorise(parameters));
+  ResetParameters<0>(0);
+}
+
+template<typename OutputLayerType, typename... Layers>
+void StaticFFN<OutputLayerType, Layers...>::Predict(
+    const MatType& predictors, MatType& results, const size_t batchSize)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("StaticFFN::Predict(): batchSize must be "
+        "positive!");
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic<0>();
+  }
+
+  // The first batch gives the size of the output.
+  const size_t firstBatchSize = std::min(batchSize,
+      size_t(predictors.n_cols));
+  Forward<0>(MatType(const_cast<ElemType*>(predictors.colptr(0)),
+      predictors.n_rows, firstBatchSize, false, true));
+  const MatType& firstResults = NetworkOutput();
+
+  results.set_size(firstResults.n_rows, predictors.n_cols);
+  results.cols(0, firstBatchSize - 1) = firstResults;
+
+  for (size_t begin = firstBatchSize; begin < predictors.n_cols;
+      begin += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols - begin));
+    Forward<0>(MatType(const_cast<ElemType*>(predictors.colptr(begin)),
+        predictors.n_rows, effectiveBatchSize, false, true));
+
+    results.cols(begin, begin + effectiveBatchSize - 1) = NetworkOutput();
+  }
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+double StaticFFN<OutputLayerType, Layers...>::Evaluate(
+    const PredictorsType& predictors, const ResponsesType& responses)
+{
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic<0>();
+  }
+
+  // The layers take whole matrices of the element type of the network.
+  const MatType& input = predictors;
+  Forward<0>(input);
+
+  return outputLayer.Forward(NetworkOutput(), responses) + Loss<0>();
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename PredictorsType, typename ResponsesType>
+void StaticFFN<OutputLayerType, Layers...>::Forward(
+    const PredictorsType& inputs, ResponsesType& results)
+{
+  const MatType& input = inputs;
+  Forward<0>(input);
+  results = NetworkOutput();
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, Layers...>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  Serialize(ar, typename std::is_same<MatType, arma::mat>::type());
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, Layers...>::Serialize(
+    Archive& ar, std::true_type /* isMat */)
+{
+  FFN<OutputLayerType> model(outputLayer);
+  if (cereal::is_saving<Archive>())
+    ToFFN(model);
+
+  ar(CEREAL_NVP(model));
+
+  if (cereal::is_loading<Archive>())
+    *this = StaticFFN(model);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, Layers...>::Serialize(
+    Archive& ar, std::false_type /* isMat */)
+{
+  ar(CEREAL_NVP(parameter));
+  SerializeLayers<0>(ar);
+
+  // The loaded layers hold their own copies of the parameters.
+  if (cereal::is_loading<Archive>())
+  {
+    ResetParameters<0>(0);
+    width = 0;
+    height = 0;
+    reset = false;
+    deterministic = false;
+  }
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I, typename LayerVectorType>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::CopyLayers(const LayerVectorType& model)
+{
+  typedef typename std::tuple_element<I, NetworkType>::type LayerType;
+
+  const LayerType* layer = boost::apply_visitor(
+      LayerPointerVisitor<LayerType>(), model[I]);
+  if (layer == NULL)
+  {
+    std::ostringstream oss;
+    oss << "StaticFFN::StaticFFN(): layer " << I << " of the given network "
+        << "does not have the expected type!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  std::get<I>(network) = *layer;
+  CopyLayers<I + 1>(model);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I, typename FFNType>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::AddLayers(FFNType& model) const
+{
+  typedef typename std::tuple_element<I, NetworkType>::type LayerType;
+
+  model.Add(new LayerType(std::get<I>(network)));
+  AddLayers<I + 1>(model);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::ResetParameters(const size_t offset)
+{
+  const size_t weights = SetWeights(std::get<I>(network), offset);
+  ResetVisitor()(&std::get<I>(network));
+
+  ResetParameters<I + 1>(offset + weights);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<typename LayerType>
+typename std::enable_if<
+    HasParametersCheck<LayerType,
+        typename StaticFFN<OutputLayerType, Layers...>::MatType&
+        (LayerType::*)()>::value &&
+    !HasModelCheck<LayerType>::value, size_t>::type
+StaticFFN<OutputLayerType, Layers...>::SetWeights(LayerType& layer,
+                                                  const size_t offset)
+{
+  // As in WeightSetVisitor, the layer takes the memory of the alias.
+  layer.Parameters() = MatType(parameter.memptr() + offset,
+      layer.Parameters().n_rows, layer.Parameters().n_cols, false, false);
+
+  return layer.Parameters().n_elem;
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I>
+typename std::enable_if<I < sizeof...(Layers), size_t>::type
+StaticFFN<OutputLayerType, Layers...>::WeightSize() const
+{
+  typedef typename std::tuple_element<I, NetworkType>::type LayerType;
+
+  // WeightSizeVisitor doesn't modify the layer.
+  return WeightSizeVisitor()(const_cast<LayerType*>(&std::get<I>(network))) +
+      WeightSize<I + 1>();
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::ResetDeterministic()
+{
+  const DeterministicSetVisitor deterministicSetVisitor(deterministic);
+  deterministicSetVisitor(&std::get<I>(network));
+  ResetDeterministic<I + 1>();
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I, typename InputType>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::Forward(const InputType& input)
+{
+  typename std::tuple_element<I, NetworkType>::type& layer =
+      std::get<I>(network);
+
+  // The first pass sets the input sizes of the layers, as in FFN::Forward().
+  if (!reset && I > 0)
+  {
+    const SetInputWidthVisitor setInputWidthVisitor(width);
+    setInputWidthVisitor(&layer);
+
+    const SetInputHeightVisitor setInputHeightVisitor(height);
+    setInputHeightVisitor(&layer);
+  }
+
+  layer.Forward(input, layer.OutputParameter());
+
+  if (!reset)
+  {
+    const size_t outputWidth = OutputWidthVisitor()(&layer);
+    if (outputWidth != 0)
+      width = outputWidth;
+
+    const size_t outputHeight = OutputHeightVisitor()(&layer);
+    if (outputHeight != 0)
+      height = outputHeight;
+
+    if (I + 1 == sizeof...(Layers))
+      reset = true;
+  }
+
+  Forward<I + 1>(layer.OutputParameter());
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I, typename Archive>
+typename std::enable_if<I < sizeof...(Layers), void>::type
+StaticFFN<OutputLayerType, Layers...>::SerializeLayers(Archive& ar)
+{
+  ar(cereal::make_nvp("layer" + std::to_string(I), std::get<I>(network)));
+  SerializeLayers<I + 1>(ar);
+}
+
+template<typename OutputLayerType, typename... Layers>
+template<size_t I>
+typename std::enable_if<I < sizeof...(Layers), double>::type
+StaticFFN<OutputLayerType, Layers...>::Loss()
+{
+  return LossVisitor()(&std::get<I>(network)) + Loss<I + 1>();
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file methods/ann/util/image_source.hpp
+ *
+ * Definition of the ImageSource class, a source of points for PrefetchLoader
+ * that reads each image of a batch from its file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_IMAGE_SOURCE_HPP
+#define MLPACK_METHODS_ANN_UTIL_IMAGE_SOURCE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * An ImageSource gives the points of a dataset of images that are stored in
+ * files, so that a network can be trained on more images than fit in memory.
+ * The images of a batch are read with data::Load(), so every image must have
+ * the dimensions given by the ImageInfo object; the responses are held in
+ * memory.
+ *
+ * @code
+ * std::vector<std::string> files = ...;
+ * arma::mat labels = ...; // One column for each file.
+ * PrefetchLoader<ImageSource> loader(ImageSource(files, labels,
+ *     data::ImageInfo(28, 28, 1)));
+ * @endcode
+ */
+class ImageSource
+{
+ public:
+  /**
+   * Create the source for the given image files.
+   *
+   * @param files Names of the image files.
+   * @param responses Responses of the images (one column for each file).
+   * @param info Dimensions of the images.
+   */
+  ImageSource(std::vector<std::string> files,
+              arma::mat responses,
+              const data::ImageInfo& info) :
+      files(std::move(files)),
+      responses(std::move(responses)),
+      info(info)
+  {
+    if (this->files.size() != this->responses.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "ImageSource::ImageSource(): " << this->files.size() << " files "
+          << "were given, but " << this->responses.n_cols << " responses!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Get the number of images.
+  size_t NumPoints() const { return files.size(); }
+
+  /**
+   * Read the images with the given indices; each image is a column of the
+   * predictors.  A std::runtime_error is thrown if an image can't be read.
+   *
+   * @param indices Indices of the images to read.
+   * @param predictors Matrix to store the images in.
+   * @param batchResponses Matrix to store the responses of the images in.
+   */
+  void Load(const arma::uvec& indices,
+            arma::mat& predictors,
+            arma::mat& batchResponses)
+  {
+    std::vector<std::string> batchFiles(indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      batchFiles[i] = files[indices[i]];
+
+    // data::Load() may change the ImageInfo object, so a copy is used.
+    data::ImageInfo batchInfo(info);
+    data::Load(batchFiles, predictors, batchInfo, true);
+    batchResponses = responses.cols(indices);
+  }
+
+  //! Get the names of the image files.
+  const std::vector<std::string>& Files() const { return files; }
+
+  //! Get the responses of the images.
+  const arma::mat& Responses() const { return responses; }
+
+  //! Get the dimensions of the images.
+  const data::ImageInfo& Info() const { return info; }
+
+ private:
+  //! Names of the image files.
+  std::vector<std::string> files;
+
+  //! Responses of the images.
+  arma::mat responses;
+
+  //! Dimensions of the images.
+  data::ImageInfo info;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,314 @@
+/**
+ * @file methods/ann/util/prefetch_loader.hpp
+ *
+ * Definition of the PrefetchLoader class, which reads the batches of a dataset
+ * that doesn't fit in memory on a background thread, and of the LoaderFunction
+ * class, which trains a network on the batches of a PrefetchLoader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_PREFETCH_LOADER_HPP
+#define MLPACK_METHODS_ANN_UTIL_PREFETCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/training_profiler.hpp>
+#include <thread>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A PrefetchLoader gives the batches of a dataset that is read from a source
+ * (for instance, a set of image files; see ImageSource) instead of being held
+ * in memory.  The optimizers of separable functions go through the points of
+ * the dataset in order, so as soon as a batch is given, the batch that follows
+ * it is read on a background thread into a second buffer, while the current
+ * batch is used.  A batch that wasn't prefetched is read directly.
+ *
+ * The points are visited in the order of a permutation of the dataset, which
+ * Shuffle() changes; the source is only asked for the points of each batch.
+ *
+ * The source has to provide the following two functions.  Load() is called
+ * from the background thread, but never by two threads at once.
+ *
+ * @code
+ * // Return the number of points of the dataset.
+ * size_t NumPoints() const;
+ *
+ * // Read the points with the given indices, in that order, into the columns
+ * // of the given matrices.
+ * void Load(const arma::uvec& indices,
+ *           arma::mat& predictors,
+ *           arma::mat& responses);
+ * @endcode
+ *
+ * An FFN is trained on the batches of a PrefetchLoader with FFN::Train().
+ *
+ * @code
+ * ImageSource source(files, labels, ImageInfo(32, 32, 3));
+ * PrefetchLoader<ImageSource> loader(std::move(source));
+ * model.Train(loader, optimizer);
+ * @endcode
+ *
+ * @tparam SourceType Type of the source of the points.
+ */
+template<typename SourceType>
+class PrefetchLoader
+{
+ public:
+  /**
+   * Create the loader for the given source.  The points are visited in order
+   * until Shuffle() is called.
+   *
+   * @param source Source of the points.
+   * @param prefetch Whether to read the next batch on a background thread.
+   */
+  PrefetchLoader(SourceType source, const bool prefetch = true) :
+      source(std::move(source)),
+      prefetch(prefetch),
+      nextBegin(0),
+      nextBatchSize(0),
+      prefetched(false)
+  {
+    indices = arma::linspace<arma::uvec>(0, this->source.NumPoints() - 1,
+        this->source.NumPoints());
+  }
+
+  //! Copying is not allowed, since the loader owns its background thread.
+  PrefetchLoader(const PrefetchLoader& other) = delete;
+  //! Copying is not allowed, since the loader owns its background thread.
+  PrefetchLoader& operator=(const PrefetchLoader& other) = delete;
+
+  //! Wait for the background thread to finish.
+  ~PrefetchLoader() { Wait(); }
+
+  //! Get the number of points of the dataset.
+  size_t NumPoints() const { return indices.n_elem; }
+
+  //! Get whether the next batch is read on a background thread.
+  bool Prefetch() const { return prefetch; }
+  //! Modify whether the next batch is read on a background thread.
+  bool& Prefetch() { return prefetch; }
+
+  //! Get the source of the points.
+  const SourceType& Source() const { return source; }
+
+  /**
+   * Change the order in which the points are visited.  A batch that is being
+   * prefetched is discarded.
+   */
+  void Shuffle()
+  {
+    Wait();
+    prefetched = false;
+    indices = arma::shuffle(indices);
+  }
+
+  /**
+   * Get the batch of the given number of points that starts at the given
+   * position of the current order, and start reading the batch that follows
+   * it.  The matrices are swapped with the buffers of the loader, so their
+   * memory is reused.
+   *
+   * @param begin Position of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param predictors Matrix to store the predictors of the batch in.
+   * @param responses Matrix to store the responses of the batch in.
+   */
+  void Batch(const size_t begin,
+             const size_t batchSize,
+             arma::mat& predictors,
+             arma::mat& responses)
+  {
+    if (batchSize == 0 || begin + batchSize > indices.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "PrefetchLoader::Batch(): points " << begin << " to "
+          << begin + batchSize << " were requested, but the dataset has "
+          << indices.n_elem << " points!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Wait();
+    if (prefetched && nextBegin == begin && nextBatchSize == batchSize)
+    {
+      predictors.swap(nextPredictors);
+      responses.swap(nextResponses);
+    }
+    else
+    {
+      // If reading the batch on the background thread failed, reading it again
+      // here reports the error.
+      source.Load(indices.subvec(begin, begin + batchSize - 1), predictors,
+          responses);
+    }
+    prefetched = false;
+
+    if (!prefetch)
+      return;
+
+    // Start reading the next batch; after the last batch, that is the start
+    // of the next pass over the data.
+    nextBegin = (begin + batchSize < indices.n_elem) ? begin + batchSize : 0;
+    nextBatchSize = std::min(batchSize, indices.n_elem - nextBegin);
+    worker = std::thread(&PrefetchLoader::Load, this);
+  }
+
+ private:
+  //! Read the next batch; this runs on the background thread.
+  void Load()
+  {
+    try
+    {
+      source.Load(indices.subvec(nextBegin, nextBegin + nextBatchSize - 1),
+          nextPredictors, nextResponses);
+      prefetched = true;
+    }
+    catch (...)
+    {
+      // The batch is read again when it is needed.
+      prefetched = false;
+    }
+  }
+
+  //! Wait for the background thread to finish reading.
+  void Wait()
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+
+  //! The source of the points.
+  SourceType source;
+
+  //! The order in which the points are visited.
+  arma::uvec indices;
+
+  //! Whether to read the next batch on a background thread.
+  bool prefetch;
+
+  //! The thread that reads the next batch.
+  std::thread worker;
+
+  //! The position of the first point of the next batch.
+  size_t nextBegin;
+
+  //! The number of points of the next batch.
+  size_t nextBatchSize;
+
+  //! Whether the next batch has been read.
+  bool prefetched;
+
+  //! The predictors of the next batch.
+  arma::mat nextPredictors;
+
+  //! The responses of the next batch.
+  arma::mat nextResponses;
+};
+
+/**
+ * A LoaderFunction is the separable function that an optimizer minimizes to
+ * train a network on the batches of a PrefetchLoader.  Each batch is stored as
+ * the data of the network, and the network evaluates it as its whole dataset.
+ * Only the optimizers of separable functions (such as SGD and its variants)
+ * can be used.
+ *
+ * @tparam NetworkType Type of the network to train.
+ * @tparam SourceType Type of the source of the points.
+ */
+template<typename NetworkType, typename SourceType>
+class LoaderFunction
+{
+ public:
+  /**
+   * Create the function for the given network and loader.
+   *
+   * @param network Network to train.
+   * @param loader Loader that gives the batches.
+   */
+  LoaderFunction(NetworkType& network, PrefetchLoader<SourceType>& loader) :
+      network(network),
+      loader(loader)
+  {
+    // Nothing to do here.
+  }
+
+  //! Get the number of separable functions (the number of points).
+  size_t NumFunctions() const { return loader.NumPoints(); }
+
+  //! Shuffle the order in which the points are visited.
+  void Shuffle() { loader.Shuffle(); }
+
+  //! Modify the profile of the network (see FFN::Profile()); the time spent
+  //! waiting for the batches isn't part of the evaluations.
+  FunctionProfile& Profile() { return network.Profile(); }
+
+  /**
+   * Evaluate the network on the batch of the given size that starts at the
+   * given point.
+   *
+   * @param parameters Parameters of the network.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    loader.Batch(begin, batchSize, network.Predictors(), network.Responses());
+    return network.Evaluate(parameters, 0, batchSize);
+  }
+
+  /**
+   * Evaluate the network and its gradient on the batch of the given size that
+   * starts at the given point.
+   *
+   * @param parameters Parameters of the network.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points of the batch.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize)
+  {
+    loader.Batch(begin, batchSize, network.Predictors(), network.Responses());
+    return network.EvaluateWithGradient(parameters, 0, gradient, batchSize);
+  }
+
+  /**
+   * Compute the gradient of the network on the batch of the given size that
+   * starts at the given point.
+   *
+   * @param parameters Parameters of the network.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points of the batch.
+   */
+  template<typename GradType>
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                GradType& gradient,
+                const size_t batchSize)
+  {
+    loader.Batch(begin, batchSize, network.Predictors(), network.Responses());
+    network.Gradient(parameters, 0, gradient, batchSize);
+  }
+
+ private:
+  //! The network to train.
+  NetworkType& network;
+
+  //! The loader that gives the batches.
+  PrefetchLoader<SourceType>& loader;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
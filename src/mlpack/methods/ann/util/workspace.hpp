@@ -0,0 +1,177 @@
+/**
+ * @file methods/ann/util/workspace.hpp
+ *
+ * Definition of the Workspace class, a block of memory that the networks reuse
+ * for the intermediate results of every training pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_UTIL_WORKSPACE_HPP
+#define MLPACK_METHODS_ANN_UTIL_WORKSPACE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A Workspace is a single block of memory that holds the intermediate results
+ * of a training pass, so that they don't have to be allocated again for every
+ * batch.  It can be used in two ways:
+ *
+ *  - View() makes a matrix an alias of the next elements of the workspace, so
+ *    the layers write their outputs and deltas into the workspace directly.
+ *    The workspace has to be large enough for all the views (see Reserve()),
+ *    and the views are invalid once the workspace is reserved again.
+ *
+ *  - Push() and Pop() use the workspace as a stack of copies of matrices, for
+ *    instance to store the outputs of every time step of a recurrent network.
+ *    The workspace grows as needed, and keeps its size for the next passes.
+ *
+ * The views are non-strict aliases, so a layer that gives an output of another
+ * size still works; its output is then allocated separately.
+ *
+ * Copying a workspace gives an empty workspace, since the views of a workspace
+ * belong to the object that made them.  Moving a workspace keeps its memory
+ * (and so its views) valid.
+ */
+class Workspace
+{
+ public:
+  //! Create an empty workspace.
+  Workspace() : used(0) { }
+
+  //! Create an empty workspace (the memory of the other workspace isn't
+  //! copied).
+  Workspace(const Workspace& /* other */) : used(0) { }
+
+  //! Take the memory of the other workspace.
+  Workspace(Workspace&& other) = default;
+
+  //! Release the memory of the workspace (the memory of the other workspace
+  //! isn't copied).
+  Workspace& operator=(const Workspace& other)
+  {
+    if (this != &other)
+    {
+      std::vector<double>().swap(memory);
+      shapes.clear();
+      used = 0;
+    }
+
+    return *this;
+  }
+
+  //! Take the memory of the other workspace.
+  Workspace& operator=(Workspace&& other) = default;
+
+  /**
+   * Release all the views and matrices stored in the workspace, so that its
+   * memory can be used again.  The memory itself is kept.
+   */
+  void Clear()
+  {
+    shapes.clear();
+    used = 0;
+  }
+
+  /**
+   * Make sure that the workspace holds at least the given number of elements.
+   * If the memory grows, any existing view is invalid.
+   *
+   * @param size Number of elements to reserve.
+   */
+  void Reserve(const size_t size)
+  {
+    if (size > memory.size())
+      memory.resize(size);
+  }
+
+  /**
+   * Make the given matrix an alias of the next rows x cols elements of the
+   * workspace.  The previous memory of the matrix is released if the matrix
+   * owned it.  A std::logic_error is thrown if not enough memory has been
+   * reserved.
+   *
+   * @param matrix Matrix to make an alias.
+   * @param rows Number of rows of the view.
+   * @param cols Number of columns of the view.
+   */
+  void View(arma::mat& matrix, const size_t rows, const size_t cols)
+  {
+    if (used + rows * cols > memory.size())
+    {
+      throw std::logic_error("Workspace::View(): not enough memory was "
+          "reserved!");
+    }
+
+    // Armadillo can't point an existing matrix at new memory, so the matrix is
+    // constructed again in place; the destructor of an alias doesn't release
+    // anything.
+    matrix.~Mat();
+    new (&matrix) arma::mat(memory.data() + used, rows, cols, false, false);
+    used += rows * cols;
+  }
+
+  /**
+   * Store a copy of the given matrix on top of the workspace.  The memory may
+   * grow, in which case any existing view is invalid.
+   *
+   * @param matrix Matrix to store.
+   */
+  void Push(const arma::mat& matrix)
+  {
+    if (used + matrix.n_elem > memory.size())
+      memory.resize(std::max(2 * memory.size(), used + matrix.n_elem));
+
+    std::copy(matrix.begin(), matrix.end(), memory.begin() + used);
+    shapes.push_back(std::make_pair(matrix.n_rows, matrix.n_cols));
+    used += matrix.n_elem;
+  }
+
+  /**
+   * Copy the matrix on top of the workspace into the given matrix, and remove
+   * it from the workspace.  A std::logic_error is thrown if the workspace
+   * holds no matrix.
+   *
+   * @param matrix Matrix to copy the stored matrix into.
+   */
+  void Pop(arma::mat& matrix)
+  {
+    if (shapes.empty())
+      throw std::logic_error("Workspace::Pop(): the workspace is empty!");
+
+    const std::pair<size_t, size_t> shape = shapes.back();
+    shapes.pop_back();
+    used -= shape.first * shape.second;
+
+    matrix.set_size(shape.first, shape.second);
+    std::copy(memory.begin() + used,
+        memory.begin() + used + shape.first * shape.second, matrix.begin());
+  }
+
+  //! Get the number of elements in use.
+  size_t Used() const { return used; }
+
+  //! Get the number of elements the workspace holds.
+  size_t Size() const { return memory.size(); }
+
+ private:
+  //! The memory of the workspace.  A std::vector keeps its memory when it is
+  //! moved, so the views stay valid.
+  std::vector<double> memory;
+
+  //! The shapes of the matrices stored with Push().
+  std::vector<std::pair<size_t, size_t>> shapes;
+
+  //! The number of elements in use.
+  size_t used;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file methods/ann/visitor/carry_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling the CarryState() function on
+ * RNN cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * CarryStateVisitor executes the CarryState() function, which prepares a cell
+ * for the next window of a sequence while keeping its state.  Cells without a
+ * CarryState() function are reset with ResetCell() instead.
+ */
+class CarryStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Prepare the cell for a window of the given size.
+  CarryStateVisitor(const size_t size);
+
+  //! Execute the CarryState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  size_t size;
+
+  //! Execute the CarryState() function for a module which implements the
+  //! CarryState() function.
+  template<typename T>
+  typename std::enable_if<
+      HasCarryStateCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+
+  //! Execute the ResetCell() function for a module which implements the
+  //! ResetCell() function but not the CarryState() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+      HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+
+  //! Do nothing for a module which implements neither function.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+      !HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "carry_state_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file methods/ann/visitor/layer_pointer_visitor.hpp
+ *
+ * This file provides a visitor that gets a pointer to a layer of a known type
+ * from a variant holding any layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_POINTER_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_POINTER_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LayerPointerVisitor returns the given layer if it is of type LayerType, and
+ * NULL otherwise.
+ *
+ * @tparam LayerType Type of the layer to get.
+ */
+template<typename LayerType>
+class LayerPointerVisitor : public boost::static_visitor<LayerType*>
+{
+ public:
+  //! Return the layer, which has the requested type.
+  LayerType* operator()(LayerType* layer) const;
+
+  //! Return NULL, since the layer has another type.
+  template<typename OtherLayerType>
+  LayerType* operator()(OtherLayerType* layer) const;
+
+  LayerType* operator()(MoreTypes layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_pointer_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file methods/ann/visitor/layer_pointer_visitor_impl.hpp
+ *
+ * Implementation of the visitor that gets a pointer to a layer of a known type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_POINTER_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_POINTER_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_pointer_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! LayerPointerVisitor visitor class.
+template<typename LayerType>
+inline LayerType* LayerPointerVisitor<LayerType>::operator()(
+    LayerType* layer) const
+{
+  return layer;
+}
+
+template<typename LayerType>
+template<typename OtherLayerType>
+inline LayerType* LayerPointerVisitor<LayerType>::operator()(
+    OtherLayerType* /* layer */) const
+{
+  return NULL;
+}
+
+template<typename LayerType>
+inline LayerType* LayerPointerVisitor<LayerType>::operator()(
+    MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_ANN_VISITOR_LOAD_OUTPUT_PARAMETER_VISITOR_HPP
 
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/util/workspace.hpp>
 
 #include <boost/variant.hpp>
 
@@ -31,6 +32,9 @@ class LoadOutputParameterVisitor : public boost::static_visitor<void>
   //! Restore the output parameter given a parameter set.
   LoadOutputParameterVisitor(std::vector<arma::mat>& parameter);
 
+  //! Restore the output parameter from the top of the given workspace.
+  LoadOutputParameterVisitor(Workspace& workspace);
+
   //! Restore the output parameter.
   template<typename LayerType>
   void operator()(LayerType* layer) const;
@@ -38,8 +42,14 @@ class LoadOutputParameterVisitor : public boost::static_visitor<void>
   void operator()(MoreTypes layer) const;
 
  private:
-  //! The parameter set.
-  std::vector<arma::mat>& parameter;
+  //! The parameter set (NULL if a workspace is used).
+  std::vector<arma::mat>* parameter;
+
+  //! The workspace (NULL if a parameter set is used).
+  Workspace* workspace;
+
+  //! Restore the given output parameter.
+  void Load(arma::mat& outputParameter) const;
 
   //! Restore the output parameter for a module which doesn't implement the
   //! Model() function.
@@ -20,7 +20,17 @@ namespace ann {
 
 //! LoadOutputParameterVisitor visitor class.
 inline LoadOutputParameterVisitor::LoadOutputParameterVisitor(
-    std::vector<arma::mat>& parameter) : parameter(parameter)
+    std::vector<arma::mat>& parameter) :
+    parameter(&parameter),
+    workspace(NULL)
+{
+  /* Nothing to do here. */
+}
+
+inline LoadOutputParameterVisitor::LoadOutputParameterVisitor(
+    Workspace& workspace) :
+    parameter(NULL),
+    workspace(&workspace)
 {
   /* Nothing to do here. */
 }
@@ -41,8 +51,7 @@ inline typename std::enable_if<
     !HasModelCheck<T>::value, void>::type
 LoadOutputParameterVisitor::OutputParameter(T* layer) const
 {
-  layer->OutputParameter() = parameter.back();
-  parameter.pop_back();
+  Load(layer->OutputParameter());
 }
 
 template<typename T>
@@ -52,12 +61,24 @@ LoadOutputParameterVisitor::OutputParameter(T* layer) const
 {
   for (size_t i = 0; i < layer->Model().size(); ++i)
   {
-    boost::apply_visitor(LoadOutputParameterVisitor(parameter),
+    boost::apply_visitor(*this,
         layer->Model()[layer->Model().size() - i - 1]);
   }
 
-  layer->OutputParameter() = parameter.back();
-  parameter.pop_back();
+  Load(layer->OutputParameter());
+}
+
+inline void LoadOutputParameterVisitor::Load(arma::mat& outputParameter) const
+{
+  if (workspace)
+  {
+    workspace->Pop(outputParameter);
+  }
+  else
+  {
+    outputParameter = parameter->back();
+    parameter->pop_back();
+  }
 }
 
 } // namespace ann
@@ -0,0 +1,63 @@
+/**
+ * @file methods/ann/visitor/recomputable_visitor.hpp
+ *
+ * This file provides an abstraction for checking whether the output of a layer
+ * can be computed again during the backward pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECOMPUTABLE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECOMPUTABLE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * RecomputableVisitor returns whether running the Forward() function of a
+ * layer again on the same input gives the same output and leaves the layer in
+ * the same state.  This isn't the case for the layers that implement the
+ * Deterministic() function (such as Dropout, which draws a new mask, or
+ * BatchNorm, which updates its running statistics), nor for the layers that
+ * implement the Model() function, which may hold such layers.
+ */
+class RecomputableVisitor : public boost::static_visitor<bool>
+{
+ public:
+  //! Return whether the output of the layer can be computed again.
+  template<typename LayerType>
+  bool operator()(LayerType* layer) const;
+
+  bool operator()(MoreTypes layer) const;
+
+ private:
+  //! Return true if the module implements neither the Deterministic() nor the
+  //! Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+      !HasModelCheck<T>::value, bool>::type
+  LayerRecomputable(T* layer) const;
+
+  //! Return false otherwise.
+  template<typename T>
+  typename std::enable_if<
+      HasDeterministicCheck<T, bool&(T::*)(void)>::value ||
+      HasModelCheck<T>::value, bool>::type
+  LayerRecomputable(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "recomputable_visitor_impl.hpp"
+
+#endif
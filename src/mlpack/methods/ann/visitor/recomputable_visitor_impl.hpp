@@ -0,0 +1,53 @@
+/**
+ * @file methods/ann/visitor/recomputable_visitor_impl.hpp
+ *
+ * Implementation of the RecomputableVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_RECOMPUTABLE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_RECOMPUTABLE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "recomputable_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! RecomputableVisitor visitor class.
+template<typename LayerType>
+inline bool RecomputableVisitor::operator()(LayerType* layer) const
+{
+  return LayerRecomputable(layer);
+}
+
+inline bool RecomputableVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasDeterministicCheck<T, bool&(T::*)(void)>::value &&
+    !HasModelCheck<T>::value, bool>::type
+RecomputableVisitor::LayerRecomputable(T* /* layer */) const
+{
+  return true;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasDeterministicCheck<T, bool&(T::*)(void)>::value ||
+    HasModelCheck<T>::value, bool>::type
+RecomputableVisitor::LayerRecomputable(T* /* layer */) const
+{
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_VISITOR_SAVE_OUTPUT_PARAMETER_VISITOR_HPP
 
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/util/workspace.hpp>
 
 #include <boost/variant.hpp>
 
@@ -30,6 +31,10 @@ class SaveOutputParameterVisitor : public boost::static_visitor<void>
   //! Save the output parameter into the given parameter set.
   SaveOutputParameterVisitor(std::vector<arma::mat>& parameter);
 
+  //! Save the output parameter on top of the given workspace, which avoids an
+  //! allocation for every output parameter once the workspace is large enough.
+  SaveOutputParameterVisitor(Workspace& workspace);
+
   //! Save the output parameter.
   template<typename LayerType>
   void operator()(LayerType* layer) const;
@@ -37,8 +42,14 @@ class SaveOutputParameterVisitor : public boost::static_visitor<void>
   void operator()(MoreTypes layer) const;
 
  private:
-  //! The parameter set.
-  std::vector<arma::mat>& parameter;
+  //! The parameter set (NULL if a workspace is used).
+  std::vector<arma::mat>* parameter;
+
+  //! The workspace (NULL if a parameter set is used).
+  Workspace* workspace;
+
+  //! Save the given output parameter.
+  void Save(const arma::mat& outputParameter) const;
 
   //! Save the output parameter for a module which doesn't implement the
   //! Model() function.
@@ -20,7 +20,17 @@ namespace ann {
 
 //! SaveOutputParameterVisitor visitor class.
 inline SaveOutputParameterVisitor::SaveOutputParameterVisitor(
-    std::vector<arma::mat>& parameter) : parameter(parameter)
+    std::vector<arma::mat>& parameter) :
+    parameter(&parameter),
+    workspace(NULL)
+{
+  /* Nothing to do here. */
+}
+
+inline SaveOutputParameterVisitor::SaveOutputParameterVisitor(
+    Workspace& workspace) :
+    parameter(NULL),
+    workspace(&workspace)
 {
   /* Nothing to do here. */
 }
@@ -41,7 +51,7 @@ inline typename std::enable_if<
     !HasModelCheck<T>::value, void>::type
 SaveOutputParameterVisitor::OutputParameter(T* layer) const
 {
-  parameter.push_back(layer->OutputParameter());
+  Save(layer->OutputParameter());
 }
 
 template<typename T>
@@ -49,13 +59,19 @@ inline typename std::enable_if<
     HasModelCheck<T>::value, void>::type
 SaveOutputParameterVisitor::OutputParameter(T* layer) const
 {
-  parameter.push_back(layer->OutputParameter());
+  Save(layer->OutputParameter());
 
   for (size_t i = 0; i < layer->Model().size(); ++i)
-  {
-    boost::apply_visitor(SaveOutputParameterVisitor(parameter),
-        layer->Model()[i]);
-  }
+    boost::apply_visitor(*this, layer->Model()[i]);
+}
+
+inline void SaveOutputParameterVisitor::Save(
+    const arma::mat& outputParameter) const
+{
+  if (workspace)
+    workspace->Push(outputParameter);
+  else
+    parameter->push_back(outputParameter);
 }
 
 } // namespace ann
@@ -0,0 +1,73 @@
+/**
+ * @file methods/ann/visitor/target_set_visitor.hpp
+ *
+ * This file provides an abstraction for the Targets() function for different
+ * layers and automatically directs any parameter to the right layer type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * TargetSetVisitor gives the targets of the current batch to the layers that
+ * compute the loss themselves (the layers that implement the Targets()
+ * function, such as SampledSoftmax and HierarchicalSoftmax).
+ */
+class TargetSetVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Set the targets parameter given the targets of the batch.
+  TargetSetVisitor(const arma::mat& targets);
+
+  //! Set the targets parameter.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+  void operator()(MoreTypes layer) const;
+
+ private:
+  //! The targets of the batch.
+  const arma::mat& targets;
+
+  //! Set the targets parameter if the module implements the Targets()
+  //! function.
+  template<typename T>
+  typename std::enable_if<
+      HasTargetsCheck<T, arma::mat&(T::*)()>::value, void>::type
+  LayerTargets(T* layer) const;
+
+  //! Set the targets parameter of the modules of the module if the module
+  //! implements the Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTargetsCheck<T, arma::mat&(T::*)()>::value &&
+      HasModelCheck<T>::value, void>::type
+  LayerTargets(T* layer) const;
+
+  //! Do not set the targets parameter if the module doesn't implement the
+  //! Targets() or Model() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasTargetsCheck<T, arma::mat&(T::*)()>::value &&
+      !HasModelCheck<T>::value, void>::type
+  LayerTargets(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "target_set_visitor_impl.hpp"
+
+#endif
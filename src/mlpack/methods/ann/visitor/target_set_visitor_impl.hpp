@@ -0,0 +1,68 @@
+/**
+ * @file methods/ann/visitor/target_set_visitor_impl.hpp
+ *
+ * Implementation of the Targets() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_TARGET_SET_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "target_set_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! TargetSetVisitor visitor class.
+inline TargetSetVisitor::TargetSetVisitor(const arma::mat& targets) :
+    targets(targets)
+{
+  /* Nothing to do here. */
+}
+
+template<typename LayerType>
+inline void TargetSetVisitor::operator()(LayerType* layer) const
+{
+  LayerTargets(layer);
+}
+
+inline void TargetSetVisitor::operator()(MoreTypes layer) const
+{
+  layer.apply_visitor(*this);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasTargetsCheck<T, arma::mat&(T::*)()>::value, void>::type
+TargetSetVisitor::LayerTargets(T* layer) const
+{
+  layer->Targets() = targets;
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTargetsCheck<T, arma::mat&(T::*)()>::value &&
+    HasModelCheck<T>::value, void>::type
+TargetSetVisitor::LayerTargets(T* layer) const
+{
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+    boost::apply_visitor(TargetSetVisitor(targets), layer->Model()[i]);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasTargetsCheck<T, arma::mat&(T::*)()>::value &&
+    !HasModelCheck<T>::value, void>::type
+TargetSetVisitor::LayerTargets(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -85,13 +85,29 @@ void DrusillaSelect<MatType>::Train(
   arma::vec norms(referenceSet.n_cols);
 
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
-  for (size_t i = 0; i < refCopy.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) refCopy.n_cols; ++i)
   {
     refCopy.col(i) = referenceSet.col(i) - dataMean;
     norms[i] = arma::norm(refCopy.col(i));
   }
 
-  // Find the top m points for each of the l projections...
+  // Find the top m elements using priority queues.
+  typedef std::pair<double, size_t> Candidate;
+  struct CandidateCmp
+  {
+    bool operator()(const Candidate& c1, const Candidate& c2)
+    {
+      return c2.first < c1.first;
+    }
+  };
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
+
+  // Find the top m points for each of the l projections.  Each projection
+  // depends on the points chosen by the previous ones, so the projections are
+  // computed one at a time, and the points are split between threads for each
+  // of them.
   for (size_t i = 0; i < l; ++i)
   {
     // Pick best index.
@@ -100,10 +116,12 @@ void DrusillaSelect<MatType>::Train(
 
     arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
 
-    // Calculate distortion and offset and make scores.
-    std::vector<bool> closeAngle(referenceSet.n_cols, false);
+    // Calculate distortion and offset and make scores.  (std::vector<bool>
+    // can't be written by several threads.)
+    std::vector<char> closeAngle(referenceSet.n_cols, false);
     arma::vec sums(referenceSet.n_cols);
-    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) referenceSet.n_cols; ++j)
     {
       if (norms[j] > 0.0)
       {
@@ -119,28 +137,50 @@ void DrusillaSelect<MatType>::Train(
       }
     }
 
-    // Find the top m elements using a priority queue.
-    typedef std::pair<double, size_t> Candidate;
-    struct CandidateCmp
+    // The top m elements of each chunk of points are found in parallel, and
+    // the lists are merged in the order of the chunks (with the points of each
+    // list in increasing order), so that ties are resolved as in a serial scan.
+    const Candidate def = std::make_pair(double(-DBL_MAX), size_t(-1));
+    const size_t chunkSize = 16384;
+    const size_t numChunks = (sums.n_elem + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<Candidate>> chunkCandidates(numChunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
     {
-      bool operator()(const Candidate& c1, const Candidate& c2)
+      CandidateList chunkPq(CandidateCmp(), std::vector<Candidate>(m, def));
+      const size_t begin = (size_t) c * chunkSize;
+      const size_t end = std::min(begin + chunkSize, (size_t) sums.n_elem);
+      for (size_t j = begin; j < end; ++j)
       {
-        return c2.first < c1.first;
+        Candidate candidate = std::make_pair(sums[j], j);
+        if (CandidateCmp()(candidate, chunkPq.top()))
+        {
+          chunkPq.pop();
+          chunkPq.push(candidate);
+        }
       }
-    };
 
-    std::vector<Candidate> clist(
-        m, std::make_pair(double(-DBL_MAX), size_t(-1)));
-    std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        pq(CandidateCmp(), std::move(clist));
+      for (; !chunkPq.empty(); chunkPq.pop())
+        if (chunkPq.top().second != size_t(-1))
+          chunkCandidates[c].push_back(chunkPq.top());
+      std::sort(chunkCandidates[c].begin(), chunkCandidates[c].end(),
+          [](const Candidate& c1, const Candidate& c2)
+          {
+            return c1.second < c2.second;
+          });
+    }
 
-    for (size_t j = 0; j < sums.n_elem; ++j)
+    CandidateList pq(CandidateCmp(), std::vector<Candidate>(m, def));
+    for (size_t c = 0; c < numChunks; ++c)
     {
-      Candidate c = std::make_pair(sums[j], j);
-      if (CandidateCmp()(c, pq.top()))
+      for (size_t j = 0; j < chunkCandidates[c].size(); ++j)
       {
-        pq.pop();
-        pq.push(c);
+        if (CandidateCmp()(chunkCandidates[c][j], pq.top()))
+        {
+          pq.pop();
+          pq.push(chunkCandidates[c][j]);
+        }
       }
     }
 
@@ -158,7 +198,8 @@ void DrusillaSelect<MatType>::Train(
 
     // Calculate angles from the current projection.  Anything close enough,
     // mark the norm as 0.
-    for (size_t j = 0; j < norms.n_elem; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) norms.n_elem; ++j)
       if (norms[j] > 0.0 && closeAngle[j])
         norms[j] = 0.0;
   }
@@ -183,13 +224,22 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
   // Note that we aren't using trees for our search, so we can use 'int' as a
   // TreeType.
   metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
+  typedef NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
       tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+      RuleType;
+  RuleType rules(candidateSet, querySet, k, metric, 0, false);
+
+  // The query points are split between threads, each with its own rules that
+  // share the candidate lists.
+  #pragma omp parallel
+  {
+    RuleType taskRules(rules, metric);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+        taskRules.BaseCase(q, r);
+  }
 
   rules.GetResults(neighbors, distances);
 
@@ -84,12 +84,19 @@ class QDAFN
   void serialize(Archive& ar, const uint32_t /* version */);
 
   //! Get the number of projections.
-  size_t NumProjections() const { return candidateSet.size(); }
+  size_t NumProjections() const { return candidateSet.n_cols / m; }
 
-  //! Get the candidate set for the given projection table.
-  const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
-  //! Modify the candidate set for the given projection table.  Careful!
-  MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
+  //! Get (a copy of) the candidate set for the given projection table.
+  MatType CandidateSet(const size_t t) const
+  {
+    return candidateSet.cols(t * m, (t + 1) * m - 1);
+  }
+
+  //! Get the candidate sets of all the tables; the m columns of table t start
+  //! at column t * m.
+  const MatType& CandidateSet() const { return candidateSet; }
+  //! Modify the candidate sets of all the tables.  Careful!
+  MatType& CandidateSet() { return candidateSet; }
 
  private:
   //! The number of projections.
@@ -106,8 +113,9 @@ class QDAFN
   //! Values of a_i * x for each point in S.
   arma::mat sValues;
 
-  // Candidate sets; one element in the vector for each table.
-  std::vector<MatType> candidateSet;
+  //! Candidate sets of all the tables, one after the other, so that the
+  //! candidates of a table are contiguous in memory.
+  MatType candidateSet;
 };
 
 } // namespace neighbor
@@ -16,6 +16,7 @@
 #include "qdafn.hpp"
 
 #include <queue>
+#include <algorithm>
 #include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
 
 namespace mlpack {
@@ -58,6 +59,10 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   if (mIn != 0)
     m = mIn;
 
+  if (m > referenceSet.n_cols)
+    throw std::invalid_argument("QDAFN::Train(): m must not be greater than "
+        "the number of points in the reference set!");
+
   // Build tables.  This is done by drawing random points from a Gaussian
   // distribution as the vectors we project onto.  The Gaussian should have zero
   // mean and unit variance.
@@ -70,23 +75,38 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // top m elements.
   projections = referenceSet.t() * lines;
 
-  // Loop over each projection and find the top m elements.
+  // Loop over each projection and find the top m elements.  The projections
+  // are independent, so they are split between threads; only the top m
+  // elements of each projection are sorted.
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
-  candidateSet.resize(l);
-  for (size_t i = 0; i < l; ++i)
+  candidateSet.set_size(referenceSet.n_rows, l * m);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) l; ++i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
-    arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
+    const double* projection = projections.colptr(i);
+    std::vector<size_t> indices(projections.n_rows);
+    for (size_t j = 0; j < indices.size(); ++j)
+      indices[j] = j;
+    std::partial_sort(indices.begin(), indices.begin() + m, indices.end(),
+        [projection](const size_t a, const size_t b)
+        {
+          return (projection[a] > projection[b]) ||
+              (projection[a] == projection[b] && a < b);
+        });
 
     // Grab the top m elements.
     for (size_t j = 0; j < m; ++j)
     {
-      sIndices(j, i) = sortedIndices[j];
-      sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
+      sIndices(j, i) = indices[j];
+      sValues(j, i) = projection[indices[j]];
     }
   }
+
+  // Collect the candidates of each table.
+  for (size_t i = 0; i < l; ++i)
+    for (size_t j = 0; j < m; ++j)
+      candidateSet.col(i * m + j) = referenceSet.col(sIndices(j, i));
 }
 
 // Search.
@@ -104,8 +124,10 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // Search for each point.  The query points are independent, so they are
+  // split between threads.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
@@ -137,7 +159,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
 
       // Calculate distance from query point.
       const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
+          querySet.col(q), candidateSet.col(p.second * m + tableIndex));
 
       resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
 
@@ -189,9 +211,26 @@ void QDAFN<MatType>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(projections));
   ar(CEREAL_NVP(sIndices));
   ar(CEREAL_NVP(sValues));
+
+  // The candidate sets are saved as one matrix per table, as they were before
+  // they were stored contiguously.
+  std::vector<MatType> tables;
+  if (!cereal::is_loading<Archive>())
+  {
+    tables.resize(NumProjections());
+    for (size_t t = 0; t < tables.size(); ++t)
+      tables[t] = CandidateSet(t);
+  }
+
+  ar(cereal::make_nvp("candidateSet", tables));
+
   if (cereal::is_loading<Archive>())
-    candidateSet.clear();
-  ar(CEREAL_NVP(candidateSet));
+  {
+    candidateSet.set_size(tables.empty() ? 0 : tables[0].n_rows,
+        tables.size() * m);
+    for (size_t t = 0; t < tables.size(); ++t)
+      candidateSet.cols(t * m, (t + 1) * m - 1) = tables[t];
+  }
 }
 
 } // namespace neighbor
@@ -35,29 +35,181 @@ double BayesianLinearRegression::Train(const arma::mat& data,
 {
   Timer::Start("bayesian_linear_regression");
 
-  arma::mat phi;
-  arma::rowvec t;
-  arma::colvec eigVal;
-  arma::mat eigVec;
+  statistics = Statistics();
+  AccumulateStatistics(data, responses);
+  Optimize();
+
+  Timer::Stop("bayesian_linear_regression");
+
+  return RMSE(data, responses);
+}
+
+void BayesianLinearRegression::Update(const arma::mat& data,
+                                      const arma::rowvec& responses)
+{
+  if (statistics.numPoints > 0 && data.n_rows != statistics.pointsMean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression::Update(): the model has dimensionality "
+        << statistics.pointsMean.n_elem << ", but the new points have "
+        << "dimensionality " << data.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("bayesian_linear_regression");
+
+  AccumulateStatistics(data, responses);
+  Optimize();
+
+  Timer::Stop("bayesian_linear_regression");
+}
+
+void BayesianLinearRegression::Statistics::Merge(const Statistics& other)
+{
+  if (other.numPoints == 0)
+    return;
+
+  if (numPoints == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  const double total = (double) (numPoints + other.numPoints);
+  const double weight = numPoints * (other.numPoints / total);
+  const arma::colvec pointsDelta = other.pointsMean - pointsMean;
+  const double responsesDelta = other.responsesMean - responsesMean;
+
+  pointsScatter += other.pointsScatter +
+      weight * (pointsDelta * pointsDelta.t());
+  crossScatter += other.crossScatter + (weight * responsesDelta) * pointsDelta;
+  responsesScatter += other.responsesScatter +
+      weight * responsesDelta * responsesDelta;
+  pointsMean += (other.numPoints / total) * pointsDelta;
+  responsesMean += (other.numPoints / total) * responsesDelta;
+  numPoints += other.numPoints;
+}
+
+void BayesianLinearRegression::AccumulateStatistics(
+    const arma::mat& data,
+    const arma::rowvec& responses)
+{
+  if (data.n_cols != responses.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "BayesianLinearRegression::Train(): the number of points ("
+        << data.n_cols << ") differs from the number of responses ("
+        << responses.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Only a chunk of centered points is held in memory at a time.
+  const size_t chunkSize = 1024;
+
+  size_t numParts = 1;
+  #ifdef HAS_OPENMP
+    numParts = (size_t) omp_get_max_threads();
+  #endif
+  numParts = std::max((size_t) 1, std::min(numParts,
+      data.n_cols / chunkSize));
+
+  std::vector<Statistics> parts(numParts);
+  #pragma omp parallel for
+  for (omp_size_t p = 0; p < (omp_size_t) numParts; ++p)
+  {
+    const size_t begin = (size_t) p * data.n_cols / numParts;
+    const size_t end = ((size_t) p + 1) * data.n_cols / numParts;
+    for (size_t first = begin; first < end; first += chunkSize)
+    {
+      const size_t last = std::min(first + chunkSize, end) - 1;
+
+      Statistics chunk;
+      chunk.numPoints = last - first + 1;
+      chunk.pointsMean = arma::mean(data.cols(first, last), 1);
+      chunk.responsesMean = arma::mean(responses.subvec(first, last));
+
+      const arma::mat points = data.cols(first, last).each_col() -
+          chunk.pointsMean;
+      const arma::rowvec values = responses.subvec(first, last) -
+          chunk.responsesMean;
+      chunk.pointsScatter = points * points.t();
+      chunk.crossScatter = points * values.t();
+      chunk.responsesScatter = arma::dot(values, values);
+
+      parts[p].Merge(chunk);
+    }
+  }
+
+  // The parts are merged in order, so the result doesn't depend on the number
+  // of threads beyond rounding.
+  for (size_t p = 0; p < numParts; ++p)
+    statistics.Merge(parts[p]);
+}
+
+void BayesianLinearRegression::Optimize()
+{
+  const size_t n = statistics.numPoints;
+  const double nPoints = (double) n;
 
-  // Preprocess the data. Center and scale.
-  responsesOffset = CenterScaleData(data, responses, phi, t);
+  // Center and scale the statistics: centering uses the scatter matrices
+  // directly, and otherwise the means are added back.
+  arma::mat gram;
+  arma::colvec phiT;
+  double tT;
+  if (centerData)
+  {
+    dataOffset = statistics.pointsMean;
+    responsesOffset = statistics.responsesMean;
+    gram = statistics.pointsScatter;
+    phiT = statistics.crossScatter;
+    tT = statistics.responsesScatter;
+  }
+  else
+  {
+    dataOffset.reset();
+    responsesOffset = 0.0;
+    gram = statistics.pointsScatter + nPoints * (statistics.pointsMean *
+        statistics.pointsMean.t());
+    phiT = statistics.crossScatter + (nPoints * statistics.responsesMean) *
+        statistics.pointsMean;
+    tT = statistics.responsesScatter + nPoints * statistics.responsesMean *
+        statistics.responsesMean;
+  }
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+  if (scaleData)
+  {
+    dataScale = arma::sqrt(statistics.pointsScatter.diag() / (nPoints - 1));
+    gram.each_col() /= dataScale;
+    gram.each_row() /= dataScale.t();
+    phiT /= dataScale;
+  }
+  else
+  {
+    dataScale.reset();
+  }
+
+  arma::colvec eigVal;
+  arma::mat eigVec;
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(gram)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
   }
 
-  // Compute this quantities once and for all.
-  const arma::mat eigVecInv = inv(eigVec);
-  const arma::colvec eigVecInvPhitT = eigVecInv * phi * t.t();
+  // Compute this quantities once and for all.  The eigenvectors are
+  // orthonormal, so the inverse of eigVec is its transpose.
+  const arma::colvec eigVecInvPhitT = eigVec.t() * phiT;
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
   alpha = 1e-6;
-  beta =  1 / (var(t, 1) * 0.1);
+  beta =  1 / (statistics.responsesScatter / nPoints * 0.1);
 
-  unsigned short i = 0;
+  // The squared residual is computed from the statistics, and may cancel
+  // out when the fit is exact.
+  const double minResidual = std::max(std::numeric_limits<double>::epsilon() *
+      tT, std::numeric_limits<double>::min());
+
+  size_t i = 0;
   double deltaAlpha = 1.0, crit = 1.0;
 
   while ((crit > tolerance) && (i < maxIterations))
@@ -65,16 +217,19 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     deltaAlpha = -alpha;
     double deltaBeta = -beta;
 
-    // Update the solution.
-    omega = eigVec * diagmat(1 / (eigVal + (alpha / beta))) * eigVecInvPhitT;
+    // Update the solution, in the basis of the eigenvectors.
+    const arma::colvec eigOmega = eigVecInvPhitT / (eigVal + (alpha / beta));
+    omega = eigVec * eigOmega;
 
     // Update alpha.
     gamma = sum(eigVal / (alpha / beta + eigVal));
     alpha = gamma / dot(omega, omega);
 
-    // Update beta.
-    const arma::rowvec temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    // Update beta, with || t - omega^T phi ||^2 = t^T t - 2 omega^T phi t +
+    // omega^T phi phi^T omega.
+    const double residual = tT - 2 * dot(eigOmega, eigVecInvPhitT) +
+        dot(eigVal, arma::square(eigOmega));
+    beta = (nPoints - gamma) / std::max(residual, minResidual);
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -83,11 +238,7 @@ double BayesianLinearRegression::Train(const arma::mat& data,
     i++;
   }
   // Compute the covariance matrix for the uncertainties later.
-  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVecInv;
-
-  Timer::Stop("bayesian_linear_regression");
-
-  return RMSE(data, responses);
+  matCovariance = eigVec * diagmat(1 / (beta * eigVal + alpha)) * eigVec.t();
 }
 
 void BayesianLinearRegression::Predict(const arma::mat& points,
@@ -119,48 +270,6 @@ double BayesianLinearRegression::RMSE(const arma::mat& data,
   return sqrt(mean(square(responses - predictions)));
 }
 
-double BayesianLinearRegression::CenterScaleData(const arma::mat& data,
-                                                 const arma::rowvec& responses,
-                                                 arma::mat& dataProc,
-                                                 arma::rowvec& responsesProc)
-{
-  if (!centerData && !scaleData)
-  {
-    dataProc = arma::mat(const_cast<double*>(data.memptr()), data.n_rows,
-                                             data.n_cols, false, true);
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else if (centerData && !scaleData)
-  {
-    dataOffset = mean(data, 1);
-    responsesOffset = mean(responses);
-    dataProc = data.each_col() - dataOffset;
-    responsesProc = responses - responsesOffset;
-  }
-
-  else if (!centerData && scaleData)
-  {
-    dataScale = stddev(data, 0, 1);
-    dataProc = data.each_col() / dataScale;
-    responsesProc = arma::rowvec(const_cast<double*>(responses.memptr()),
-                                                     responses.n_elem, false,
-                                                     true);
-  }
-
-  else
-  {
-    dataOffset = mean(data, 1);
-    dataScale = stddev(data, 0, 1);
-    responsesOffset = mean(responses);
-    dataProc = (data.each_col() - dataOffset).each_col() / dataScale;
-    responsesProc = responses - responsesOffset;
-  }
-  return responsesOffset;
-}
-
 void BayesianLinearRegression::CenterScaleDataPred(
     const arma::mat& data,
     arma::mat& dataProc) const
@@ -122,6 +122,11 @@ class BayesianLinearRegression
    * should be column-major -- each column is an observation and each row is a
    * dimension.
    *
+   * The data is not copied: the sufficient statistics of the points (their
+   * means and the scatter matrices) are accumulated in parallel over chunks of
+   * points, and the evidence maximization only works on the eigendecomposition
+   * of the dim(P, P) Gram matrix.
+   *
    * @param data Column-major input data, dim(P, N).
    * @param responses A vector of targets, dim(N).
    * @return Root mean squared error.
@@ -129,6 +134,20 @@ class BayesianLinearRegression
   double Train(const arma::mat& data,
                const arma::rowvec& responses);
 
+  /**
+   * Update the model with new points, as if it had been trained on all the
+   * points given to Train() and Update() so far.  The sufficient statistics
+   * of the new points are merged with those of the previous points (which
+   * don't have to be kept), and the evidence maximization is run again, so
+   * the cost doesn't depend on the number of previous points.  If the model
+   * has not been trained, this is the same as Train().
+   *
+   * @param data Column-major new input data, dim(P, N).
+   * @param responses A vector of targets of the new points, dim(N).
+   */
+  void Update(const arma::mat& data,
+              const arma::rowvec& responses);
+
   /**
    * Predict \f$y_{i}\f$ for each data point in the given data matrix using the
    * currently-trained Bayesian Ridge model.
@@ -239,6 +258,9 @@ class BayesianLinearRegression
   //! Modify the tolerance for training to converge.
   double& Tolerance() { return tolerance; }
 
+  //! Get the number of points the model has been trained on.
+  size_t NumPoints() const { return statistics.numPoints; }
+
   /**
    * Serialize the BayesianLinearRegression model.
    */
@@ -283,19 +305,63 @@ class BayesianLinearRegression
   arma::mat matCovariance;
 
   /**
-   * Center and scale the data accordind to centerData and scaleData.
-   * Allows future modifications of new points.
-   *
-   * @param data Design matrix in column-major format, dim(P, N).
-   * @param responses A vector of targets.
-   * @param dataProc Data processed, dim(P, N).
-   * @param responsesProc Responses processed, dim(N).
-   * @return reponsesOffset Mean of responses.
+   * The sufficient statistics of a set of points: the means of the points and
+   * of the responses, and the sums of the products of their deviations from
+   * the means.
+   */
+  struct Statistics
+  {
+    Statistics() : numPoints(0), responsesMean(0.0), responsesScatter(0.0) { }
+
+    /**
+     * Merge the statistics of another set of points, with the pairwise update
+     * of Chan et al., which doesn't lose precision on large sets of points.
+     */
+    void Merge(const Statistics& other);
+
+    //! Serialize the statistics.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(numPoints));
+      ar(CEREAL_NVP(pointsMean));
+      ar(CEREAL_NVP(pointsScatter));
+      ar(CEREAL_NVP(crossScatter));
+      ar(CEREAL_NVP(responsesMean));
+      ar(CEREAL_NVP(responsesScatter));
+    }
+
+    //! The number of points.
+    size_t numPoints;
+    //! The mean of the points.
+    arma::colvec pointsMean;
+    //! The sum of (x - mean) (x - mean)^T over the points.
+    arma::mat pointsScatter;
+    //! The sum of (x - mean) (y - responsesMean) over the points.
+    arma::colvec crossScatter;
+    //! The mean of the responses.
+    double responsesMean;
+    //! The sum of (y - responsesMean)^2 over the points.
+    double responsesScatter;
+  };
+
+  //! The sufficient statistics of the points the model has been trained on.
+  Statistics statistics;
+
+  /**
+   * Merge the sufficient statistics of the given points into the statistics
+   * of the model.  The points are split into one contiguous part per thread,
+   * and each part is processed in chunks so that only a chunk of centered
+   * points is held in memory at a time.
    */
-  double CenterScaleData(const arma::mat& data,
-                         const arma::rowvec& responses,
-                         arma::mat& dataProc,
-                         arma::rowvec& responsesProc);
+  void AccumulateStatistics(const arma::mat& data,
+                            const arma::rowvec& responses);
+
+  /**
+   * Run the evidence maximization on the sufficient statistics of the model,
+   * after centering and scaling them according to centerData and scaleData.
+   */
+  void Optimize();
 
   /**
    * Center and scale the points before prediction.
@@ -312,4 +378,6 @@ class BayesianLinearRegression
 // Include implementation of serialize.
 #include "bayesian_linear_regression_impl.hpp"
 
+CEREAL_CLASS_VERSION(mlpack::regression::BayesianLinearRegression, 1);
+
 #endif
@@ -22,7 +22,7 @@ namespace regression {
  */
 template<typename Archive>
 void BayesianLinearRegression::serialize(Archive& ar,
-                                         const uint32_t /* version */)
+                                         const uint32_t version)
 {
   ar(CEREAL_NVP(centerData));
   ar(CEREAL_NVP(scaleData));
@@ -36,6 +36,12 @@ void BayesianLinearRegression::serialize(Archive& ar,
   ar(CEREAL_NVP(gamma));
   ar(CEREAL_NVP(omega));
   ar(CEREAL_NVP(matCovariance));
+
+  // Older models don't have the statistics that Update() needs.
+  if (version >= 1)
+    ar(CEREAL_NVP(statistics));
+  else if (cereal::is_loading<Archive>())
+    statistics = Statistics();
 }
 
 } // namespace regression
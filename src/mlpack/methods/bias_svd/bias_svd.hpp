@@ -86,6 +86,30 @@ class BiasSVD
              arma::vec& p,
              arma::vec& q);
 
+  /**
+   * Obtains the user and item matrices, and the user and item bias, using the
+   * provided data and rank, optimizing with the given optimizer instead of
+   * SGD; for instance, optimization::StratifiedSGD can be used to train with
+   * several threads.  The learning rate and number of iterations of this
+   * object are ignored.
+   *
+   * @param data Rating data matrix.
+   * @param rank Rank parameter to be used for optimization.
+   * @param u Item matrix obtained on decomposition.
+   * @param v User matrix obtained on decomposition.
+   * @param p Item bias.
+   * @param q User bias.
+   * @param optimizer Optimizer to use.
+   */
+  template<typename OptType>
+  void Apply(const arma::mat& data,
+             const size_t rank,
+             arma::mat& u,
+             arma::mat& v,
+             arma::vec& p,
+             arma::vec& q,
+             OptType& optimizer);
+
  private:
   //! Number of optimization iterations.
   size_t iterations;
@@ -178,6 +178,45 @@ void BiasSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void BiasSVDFunction<MatType>::StratifiedUpdate(
+    arma::mat& parameters,
+    const size_t i,
+    const double stepSize,
+    arma::mat& /* delayedUpdate */) const
+{
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+  const double ratingError = rating - userBias - itemBias -
+      arma::dot(parameters.col(user).subvec(0, rank - 1),
+                parameters.col(item).subvec(0, rank - 1));
+
+  // This is the same step as the one of the StandardSGD specialization.
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * parameters.col(user).subvec(0, rank - 1));
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+}
+
+template <typename MatType>
+void BiasSVDFunction<MatType>::ApplyDelayedUpdate(
+    arma::mat& /* parameters */,
+    arma::mat& /* delayedUpdate */) const
+{
+  // Every parameter is updated directly, so there is nothing to do.
+}
+
 } // namespace svd
 } // namespace mlpack
 
@@ -42,12 +42,23 @@ void BiasSVD<OptimizerType>::Apply(const arma::mat& data,
   Log::Warn << "The batch size for optimizing BiasSVD is 1."
       << std::endl;
 
-  // Make the optimizer object using a BiasSVDFunction object.
-  BiasSVDFunction<arma::mat> biasSVDFunc(data, rank, lambda);
   ens::StandardSGD optimizer(alpha, batchSize,
       iterations * data.n_cols);
+  Apply(data, rank, u, v, p, q, optimizer);
+}
 
-  // Get optimized parameters.
+template<typename OptimizerType>
+template<typename OptType>
+void BiasSVD<OptimizerType>::Apply(const arma::mat& data,
+                                   const size_t rank,
+                                   arma::mat& u,
+                                   arma::mat& v,
+                                   arma::vec& p,
+                                   arma::vec& q,
+                                   OptType& optimizer)
+{
+  // Get optimized parameters using a BiasSVDFunction object.
+  BiasSVDFunction<arma::mat> biasSVDFunc(data, rank, lambda);
   arma::mat parameters = biasSVDFunc.GetInitialPoint();
   optimizer.Optimize(biasSVDFunc, parameters);
 
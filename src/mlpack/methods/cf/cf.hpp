@@ -25,7 +25,10 @@
 #include <mlpack/methods/cf/decomposition_policies/nmf_method.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
 #include <set>
+#include <typeinfo>
 #include <map>
 #include <iostream>
 
@@ -143,6 +146,70 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold new ratings into the model without training it again.  The ratings may
+   * be of known users or of new users (whose indices follow those of the known
+   * users), but the items must be known.  The ratings are normalized with the
+   * current normalization and added to the cleaned data, replacing earlier
+   * ratings of the same user and item.  Then the column of H of each user with
+   * new ratings is computed again from all of the user's ratings with W kept
+   * fixed; this is one regularized alternating least squares step.  The factors
+   * of the items and of the other users are not changed.
+   *
+   * This requires a decomposition policy whose ratings are W * H (that is,
+   * every policy but BiasSVDPolicy and SVDPlusPlusPolicy).
+   *
+   * @param data New ratings, as a (user, item, rating) table.
+   * @param lambda Regularization parameter of the least squares problems.
+   */
+  void FoldIn(const arma::mat& data, const double lambda = 0.01);
+
+  /**
+   * Compute the given number of recommendations for every user with the given
+   * policies and keep them in the model, so that later calls to
+   * GetRecommendations() with the same policies, the same number of users for
+   * similarity and at most numRecs recommendations for known users are served
+   * from the cache without searching neighborhoods or interpolating ratings.
+   * The users are processed in parallel.  The cache is serialized with the
+   * model; it is cleared by Train(), FoldIn() and NumUsersForSimilarity().
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of recommendations to cache for each user.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void CacheRecommendations(const size_t numRecs);
+
+  //! Remove the cached recommendations.
+  void ClearCache()
+  {
+    cachedRecommendations.reset();
+    cachedPolicies.clear();
+  }
+
+  /**
+   * Return whether the cached recommendations can serve the given number of
+   * recommendations computed with the given policies.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  bool Cached(const size_t numRecs) const
+  {
+    return !cachedPolicies.empty() && numRecs <= cachedRecommendations.n_rows &&
+        cachedPolicies ==
+        CachedPolicies<NeighborSearchPolicy, InterpolationPolicy>();
+  }
+
+  //! Get the cached recommendations (one column for each user).
+  const arma::Mat<size_t>& CachedRecommendations() const
+  {
+    return cachedRecommendations;
+  }
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -152,6 +219,8 @@ class CFType
           "ignored." << std::endl;
       return;
     }
+    if (num != numUsersForSimilarity)
+      ClearCache();
     this->numUsersForSimilarity = num;
   }
 
@@ -216,6 +285,51 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for all users, using
+   * max-kernel search (FastMKS) over the item factors instead of scoring every
+   * item.  See the other overload for details.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations into.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetRecommendationsFastMKS(const size_t numRecs,
+                                 arma::Mat<size_t>& recommendations);
+
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * using max-kernel search (FastMKS) over the item factors instead of scoring
+   * every item.  The interpolated rating of an item for a user is the inner
+   * product of the item's row of W with the weighted sum of the columns of H of
+   * the user's neighborhood, so the best items are found with a tree on the
+   * rows of W.  This gives the same recommendations as GetRecommendations()
+   * when the predicted ratings are exactly W * H (that is, with every
+   * decomposition policy but BiasSVDPolicy and SVDPlusPlusPolicy), and when
+   * the denormalization doesn't depend on the item (NoNormalization,
+   * OverallMeanNormalization, UserMeanNormalization and ZScoreNormalization).
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation>
+  void GetRecommendationsFastMKS(const size_t numRecs,
+                                 arma::Mat<size_t>& recommendations,
+                                 const arma::Col<size_t>& users);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -260,9 +374,17 @@ class CFType
    * Serialize the CFType model to the given archive.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
+  //! Return the key of the cached recommendations for the given policies.
+  template<typename NeighborSearchPolicy, typename InterpolationPolicy>
+  static std::string CachedPolicies()
+  {
+    return std::string(typeid(NeighborSearchPolicy).name()) + "," +
+        typeid(InterpolationPolicy).name();
+  }
+
   //! Number of users for similarity.
   size_t numUsersForSimilarity;
   //! Rank used for matrix factorization.
@@ -273,6 +395,11 @@ class CFType
   arma::sp_mat cleanedData;
   //! Data normalization object.
   NormalizationType normalization;
+  //! Cached recommendations of each user (empty if there is no cache).
+  arma::Mat<size_t> cachedRecommendations;
+  //! Policies used to compute the cached recommendations (empty if there is
+  //! no cache).
+  std::string cachedPolicies;
 
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
@@ -289,6 +416,11 @@ class CFType
 } // namespace cf
 } // namespace mlpack
 
+// Version 1 stores the cached recommendations.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename DecompositionPolicy,
+    typename NormalizationType>),
+    (mlpack::cf::CFType<DecompositionPolicy, NormalizationType>), 1);
+
 // Include implementation of templated functions.
 #include "cf_impl.hpp"
 
@@ -84,6 +84,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearCache();
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -125,6 +126,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearCache();
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -154,6 +156,82 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+// Fold new ratings into the model.
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldIn(const arma::mat& data, const double lambda)
+{
+  if (data.n_cols == 0)
+    return;
+
+  if (data.n_rows != 3)
+  {
+    throw std::invalid_argument("CFType::FoldIn(): the ratings must be given "
+        "as a (user, item, rating) table!");
+  }
+
+  const size_t maxItem = (size_t) arma::max(data.row(1));
+  if (maxItem >= cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldIn(): item " << maxItem << " is unknown (the model "
+        << "has " << cleanedData.n_rows << " items)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The recommendations of every user may change with the new ratings.
+  ClearCache();
+
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  // Add the new ratings to the cleaned data; a new rating of an item replaces
+  // the earlier rating of the same user.
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) arma::max(data.row(0)) + 1);
+  arma::sp_mat newRatings;
+  CleanData(normalizedData, newRatings);
+  newRatings.resize(cleanedData.n_rows, numUsers);
+  cleanedData.resize(cleanedData.n_rows, numUsers);
+  cleanedData -= cleanedData % arma::spones(newRatings);
+  cleanedData += newRatings;
+
+  // Compute the factors of each user with new ratings again, with the item
+  // factors fixed.  New users start with zero factors.
+  const arma::mat& w = decomposition.W();
+  arma::mat& h = decomposition.H();
+  h.resize(h.n_rows, numUsers);
+
+  const arma::Col<size_t> users = arma::unique(
+      arma::conv_to<arma::Col<size_t>>::from(data.row(0).t()));
+  const arma::mat regularization = lambda * arma::eye(h.n_rows, h.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+  {
+    const size_t user = users[i];
+    arma::uvec items(std::distance(cleanedData.begin_col(user),
+        cleanedData.end_col(user)));
+    arma::vec ratings(items.n_elem);
+    size_t j = 0;
+    for (arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+         it != cleanedData.end_col(user); ++it, ++j)
+    {
+      items[j] = it.row();
+      ratings[j] = *it;
+    }
+
+    const arma::mat wItems = w.rows(items);
+    h.col(user) = arma::solve(wItems.t() * wItems + regularization,
+        wItems.t() * ratings);
+  }
+
+  Log::Info << "CFType::FoldIn(): folded in " << data.n_cols << " ratings of "
+      << users.n_elem << " users." << std::endl;
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -185,6 +263,20 @@ GetRecommendations(const size_t numRecs,
                    arma::Mat<size_t>& recommendations,
                    const arma::Col<size_t>& users)
 {
+  // Serve the recommendations from the cache if we can.
+  if (Cached<NeighborSearchPolicy, InterpolationPolicy>(numRecs) &&
+      (users.is_empty() || users.max() < cachedRecommendations.n_cols))
+  {
+    recommendations.set_size(numRecs, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; ++i)
+    {
+      recommendations.col(i) = cachedRecommendations.submat(0, users[i],
+          numRecs - 1, users[i]);
+    }
+
+    return;
+  }
+
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
   // Resulting similarities.
@@ -205,71 +297,215 @@ GetRecommendations(const size_t numRecs,
   recommendations.fill(SIZE_MAX);
   values.fill(DBL_MAX);
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
-  InterpolationPolicy interpolation(cleanedData);
+  // Default candidate: the smallest possible value and invalid item number.
+  const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
+      CandidateList;
 
-  for (size_t i = 0; i < users.n_elem; ++i)
+  // The users are independent, so they are processed in parallel.  Each thread
+  // has its own InterpolationPolicy object (which may cache results between
+  // calls) and its own buffers.
+  #pragma omp parallel
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
+    // Initialization of an InterpolationPolicy object should be put ahead of
+    // the following loop, because the initialization may takes a relatively
+    // long time and we don't want to repeat the initialization process in each
+    // loop.
+    InterpolationPolicy interpolation(cleanedData);
+
+    arma::vec ratings(cleanedData.n_rows);
+    arma::vec neighborRatings;
     arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
+    std::vector<bool> rated(cleanedData.n_rows, false);
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
     {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+      // First, calculate the weighted sum of neighborhood values.
+      ratings.zeros();
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+      // Calculate interpolation weights.
+      interpolation.GetWeights(weights, decomposition, users(i),
+          neighborhood.col(i), similarities.col(i), cleanedData);
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
-    {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
+        ratings += weights(j) * neighborRatings;
+      }
+
+      // Mark the items that the user has already rated.  The algorithm omits
+      // rating of zero. Thus, when normalizing original ratings in
+      // Normalize(), if normalized rating equals zero, it is set to the
+      // smallest positive double value.
+      for (arma::sp_mat::const_iterator it = cleanedData.begin_col(users(i));
+           it != cleanedData.end_col(users(i)); ++it)
+        rated[it.row()] = true;
 
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      // Let's build the list of candidate recomendations for the given user.
+      std::vector<Candidate> vect(numRecs, def);
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+      // Look through the ratings column corresponding to the current user.
+      for (size_t j = 0; j < ratings.n_rows; ++j)
       {
-        Candidate c = std::make_pair(realRating, j);
+        // Ensure that the user hasn't already rated the item.
+        if (rated[j])
+          continue; // The user already rated the item.
+
+        // Is the estimated value better than the worst candidate?
+        // Denormalize rating before comparison.
+        double realRating = normalization.Denormalize(users(i), j, ratings[j]);
+        if (realRating > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(realRating, j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
+      }
+
+      // Reset the marks for the next user.
+      for (arma::sp_mat::const_iterator it = cleanedData.begin_col(users(i));
+           it != cleanedData.end_col(users(i)); ++it)
+        rated[it.row()] = false;
+
+      for (size_t p = 1; p <= numRecs; p++)
+      {
+        recommendations(numRecs - p, i) = pqueue.top().second;
+        values(numRecs - p, i) = pqueue.top().first;
         pqueue.pop();
-        pqueue.push(c);
+      }
+
+      // If we were not able to come up with enough recommendations, issue a
+      // warning.
+      if (recommendations(numRecs - 1, i) == def.second)
+      {
+        #pragma omp critical
+        {
+          Log::Warn << "Could not provide " << numRecs << " recommendations "
+              << "for user " << users(i) << " (not enough un-rated items)!"
+              << std::endl;
+        }
       }
     }
+  }
+}
 
-    for (size_t p = 1; p <= numRecs; p++)
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+CacheRecommendations(const size_t numRecs)
+{
+  // Compute the recommendations of all users (in parallel) without the old
+  // cache, and then keep them.
+  ClearCache();
+  arma::Mat<size_t> recommendations;
+  GetRecommendations<NeighborSearchPolicy,
+                     InterpolationPolicy>(numRecs, recommendations);
+
+  cachedRecommendations = std::move(recommendations);
+  cachedPolicies = CachedPolicies<NeighborSearchPolicy, InterpolationPolicy>();
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendationsFastMKS(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations)
+{
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+
+  GetRecommendationsFastMKS<NeighborSearchPolicy,
+                            InterpolationPolicy>(numRecs, recommendations,
+                                                 users);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendationsFastMKS(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users)
+{
+  // Calculate the neighborhood of the queried users, as in
+  // GetRecommendations().
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  // The interpolated ratings of a user are W * (H.cols(neighborhood) *
+  // weights), so each user is represented by the weighted sum of the columns of
+  // H of its neighborhood.  We also need the largest number of items rated by
+  // one of the users, since rated items are skipped.
+  const arma::mat& h = decomposition.H();
+  arma::mat queries(h.n_rows, users.n_elem);
+  size_t maxRated = 0;
+  #pragma omp parallel
+  {
+    InterpolationPolicy interpolation(cleanedData);
+    arma::vec weights(numUsersForSimilarity);
+    size_t localMaxRated = 0;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+    {
+      interpolation.GetWeights(weights, decomposition, users(i),
+          neighborhood.col(i), similarities.col(i), cleanedData);
+
+      queries.col(i).zeros();
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        queries.col(i) += weights(j) * h.col(neighborhood(j, i));
+
+      const size_t rated = std::distance(cleanedData.begin_col(users(i)),
+          cleanedData.end_col(users(i)));
+      localMaxRated = std::max(localMaxRated, rated);
+    }
+
+    #pragma omp critical
+    maxRated = std::max(maxRated, localMaxRated);
+  }
+
+  // Find the items with the largest inner products; enough of them are
+  // retrieved that numRecs unrated items remain for every user.
+  const size_t k = std::min(numRecs + maxRated, (size_t) cleanedData.n_rows);
+  fastmks::FastMKS<kernel::LinearKernel> fastmks(
+      arma::mat(decomposition.W().t()));
+  arma::Mat<size_t> items;
+  arma::mat products;
+  fastmks.Search(queries, k, items, products);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(cleanedData.n_rows);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    // The items are sorted by inner product, and the denormalization doesn't
+    // change their order, so the first unrated items are the recommendations.
+    size_t found = 0;
+    for (size_t j = 0; j < k && found < numRecs; ++j)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      if (cleanedData(items(j, i), users(i)) != 0.0)
+        continue; // The user already rated the item.
+
+      recommendations(found++, i) = items(j, i);
     }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+    if (found < numRecs)
+    {
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
+    }
   }
 }
 
@@ -353,35 +589,49 @@ Predict(const arma::Mat<size_t>& combinations,
 
   arma::mat weights(numUsersForSimilarity, users.n_elem);
 
-  // Calculate interpolation weights.
-  InterpolationPolicy interpolation(cleanedData);
-  for (size_t i = 0; i < users.n_elem; ++i)
+  // Find the range of the sorted combinations of each user.
+  arma::Col<size_t> userBegin(users.n_elem + 1);
+  size_t user = 0; // Cumulative user count, because we are doing it in order.
+  for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
   {
-    interpolation.GetWeights(weights.col(i), decomposition, users[i],
-        neighborhood.col(i), similarities.col(i), cleanedData);
+    // Map the combination's user to the user ID used for kNN.
+    while (users[user] < sortedCombinations(0, i))
+      userBegin[++user] = i;
   }
+  userBegin[0] = 0;
+  userBegin[users.n_elem] = sortedCombinations.n_cols;
 
   // Now that we have the neighborhoods we need, calculate the predictions.
   predictions.set_size(combinations.n_cols);
 
-  size_t user = 0; // Cumulative user count, because we are doing it in order.
-  for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
+  // Each user's weights and the predictions of its combinations are computed
+  // by a single thread; each thread has its own InterpolationPolicy object,
+  // since it may cache results between calls.
+  #pragma omp parallel
   {
-    // Could this be made faster by calculating dot products for multiple items
-    // at once?
-    double rating = 0.0;
-
-    // Map the combination's user to the user ID used for kNN.
-    while (users[user] < sortedCombinations(0, i))
-      ++user;
+    InterpolationPolicy interpolation(cleanedData);
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    #pragma omp for
+    for (omp_size_t u = 0; u < (omp_size_t) users.n_elem; ++u)
     {
-      rating += weights(j, user) * decomposition.GetRating(
-          neighborhood(j, user), sortedCombinations(1, i));
-    }
+      // Calculate interpolation weights.
+      interpolation.GetWeights(weights.col(u), decomposition, users[u],
+          neighborhood.col(u), similarities.col(u), cleanedData);
 
-    predictions(ordering[i]) = rating;
+      for (size_t i = userBegin[u]; i < userBegin[u + 1]; ++i)
+      {
+        // Could this be made faster by calculating dot products for multiple
+        // items at once?
+        double rating = 0.0;
+        for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        {
+          rating += weights(j, u) * decomposition.GetRating(
+              neighborhood(j, u), sortedCombinations(1, i));
+        }
+
+        predictions(ordering[i]) = rating;
+      }
+    }
   }
 
   // Denormalize ratings.
@@ -427,7 +677,7 @@ template<typename DecompositionPolicy,
 template<typename Archive>
 void CFType<DecompositionPolicy,
             NormalizationType>::
-serialize(Archive& ar, const uint32_t /* version */)
+serialize(Archive& ar, const uint32_t version)
 {
   // This model is simple; just serialize all the members. No special handling
   // required.
@@ -436,6 +686,17 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(decomposition));
   ar(CEREAL_NVP(cleanedData));
   ar(CEREAL_NVP(normalization));
+
+  // Models saved before version 1 have no cached recommendations.
+  if (version >= 1)
+  {
+    ar(CEREAL_NVP(cachedRecommendations));
+    ar(CEREAL_NVP(cachedPolicies));
+  }
+  else if (cereal::is_loading<Archive>())
+  {
+    ClearCache();
+  }
 }
 
 } // namespace cf
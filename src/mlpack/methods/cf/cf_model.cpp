@@ -198,5 +198,19 @@ void CFModel::GetRecommendations(const NeighborSearchTypes nsType,
   cf->GetRecommendations(nsType, interpolationType, numRecs, recommendations);
 }
 
+//! Compute and cache recommendations for all users.
+void CFModel::CacheRecommendations(const NeighborSearchTypes nsType,
+                                   const InterpolationTypes interpolationType,
+                                   const size_t numRecs)
+{
+  cf->CacheRecommendations(nsType, interpolationType, numRecs);
+}
+
+//! Remove the cached recommendations.
+void CFModel::ClearCache()
+{
+  cf->ClearCache();
+}
+
 } // namespace cf
 } // namespace mlpack
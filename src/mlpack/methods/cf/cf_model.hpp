@@ -78,6 +78,15 @@ class CFWrapperBase
       const size_t numRecs,
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users) = 0;
+
+  //! Compute and cache recommendations for all users.
+  virtual void CacheRecommendations(
+      const NeighborSearchTypes nsType,
+      const InterpolationTypes interpolationType,
+      const size_t numRecs) = 0;
+
+  //! Remove the cached recommendations.
+  virtual void ClearCache() = 0;
 };
 
 /**
@@ -144,6 +153,15 @@ class CFWrapper : public CFWrapperBase
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users);
 
+  //! Compute and cache recommendations for all users.
+  virtual void CacheRecommendations(
+      const NeighborSearchTypes nsType,
+      const InterpolationTypes interpolationType,
+      const size_t numRecs);
+
+  //! Remove the cached recommendations.
+  virtual void ClearCache() { cf.ClearCache(); }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -267,6 +285,19 @@ class CFModel
                           const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  /**
+   * Compute the given number of recommendations for all users and keep them in
+   * the model, so that later recommendations with the same policies are served
+   * from the cache.  The cache is saved with the model, and it is cleared when
+   * the model is trained again.
+   */
+  void CacheRecommendations(const NeighborSearchTypes nsType,
+                            const InterpolationTypes interpolationType,
+                            const size_t numRecs);
+
+  //! Remove the cached recommendations.
+  void ClearCache();
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -206,6 +206,57 @@ void CFWrapper<DecompositionPolicy, NormalizationPolicy>::GetRecommendations(
   }
 }
 
+template<typename NeighborSearchPolicy, typename CFType>
+void CacheRecommendationsHelper(
+    CFType& cf,
+    const InterpolationTypes interpolationType,
+    const size_t numRecs)
+{
+  switch (interpolationType)
+  {
+    case AVERAGE_INTERPOLATION:
+      cf.template CacheRecommendations<NeighborSearchPolicy,
+                                       AverageInterpolation>(numRecs);
+      break;
+
+    case REGRESSION_INTERPOLATION:
+      cf.template CacheRecommendations<NeighborSearchPolicy,
+                                       RegressionInterpolation>(numRecs);
+      break;
+
+    case SIMILARITY_INTERPOLATION:
+      cf.template CacheRecommendations<NeighborSearchPolicy,
+                                       SimilarityInterpolation>(numRecs);
+      break;
+  }
+}
+
+//! Compute and cache recommendations for all users.
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::CacheRecommendations(
+    const NeighborSearchTypes nsType,
+    const InterpolationTypes interpolationType,
+    const size_t numRecs)
+{
+  switch (nsType)
+  {
+    case COSINE_SEARCH:
+      CacheRecommendationsHelper<CosineSearch>(cf, interpolationType,
+          numRecs);
+      break;
+
+    case EUCLIDEAN_SEARCH:
+      CacheRecommendationsHelper<EuclideanSearch>(cf, interpolationType,
+          numRecs);
+      break;
+
+    case PEARSON_SEARCH:
+      CacheRecommendationsHelper<PearsonSearch>(cf, interpolationType,
+          numRecs);
+      break;
+  }
+}
+
 template<typename DecompositionPolicy>
 CFWrapperBase* InitializeModelHelper(
     CFModel::NormalizationTypes normalizationType)
@@ -85,6 +85,7 @@ class SVDPlusPlusPolicy
 
     // Perform decomposition using the svdplusplus algorithm.
     svdpp.Apply(data, implicitDenseData, rank, w, h, p, q, y);
+    userVectors.clear();
   }
 
   /**
@@ -95,20 +96,8 @@ class SVDPlusPlusPolicy
    */
   double GetRating(const size_t user, const size_t item) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    UserVector(user, userVec);
 
     double rating =
         arma::as_scalar(w.row(item) * userVec) + p(item) + q(user);
@@ -123,20 +112,8 @@ class SVDPlusPlusPolicy
    */
   void GetRatingOfUser(const size_t user, arma::vec& rating) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    UserVector(user, userVec);
 
     rating = w * userVec + p + q(user);
   }
@@ -183,6 +160,9 @@ class SVDPlusPlusPolicy
   const arma::mat& Y() const { return y; }
   //! Get Implicit Feedback Data.
   const arma::sp_mat& ImplicitData() const { return implicitData; }
+  //! Get whether the model was loaded for prediction only (in which case Y()
+  //! and ImplicitData() are empty, and the model can't be saved).
+  bool PredictionOnly() const { return !userVectors.is_empty(); }
 
   //! Get the number of iterations.
   size_t MaxIterations() const { return maxIterations; }
@@ -212,11 +192,69 @@ class SVDPlusPlusPolicy
     ar(CEREAL_NVP(h));
     ar(CEREAL_NVP(p));
     ar(CEREAL_NVP(q));
+    // A model loaded for prediction only has no item implicit matrix left to
+    // save.
+    if (!cereal::is_loading<Archive>() && !userVectors.is_empty())
+    {
+      throw cereal::Exception("SVDPlusPlusPolicy::serialize(): a model loaded "
+          "for prediction only can't be saved!");
+    }
+
     ar(CEREAL_NVP(y));
     ar(CEREAL_NVP(implicitData));
+
+    // When loading for prediction only, the implicit feedback of each user is
+    // added to its user vector once, and the item implicit matrix and the
+    // implicit data, which are only needed to compute it, are dropped.
+    userVectors.clear();
+    if (cereal::IsPredictionOnly(ar))
+    {
+      arma::mat vectors(h.n_rows, h.n_cols);
+      for (size_t user = 0; user < h.n_cols; ++user)
+      {
+        arma::vec userVec;
+        UserVector(user, userVec);
+        vectors.col(user) = userVec;
+      }
+
+      userVectors = std::move(vectors);
+      y.clear();
+      implicitData = arma::sp_mat();
+    }
   }
 
  private:
+  /**
+   * Compute the vector of the given user: its column of the user matrix, plus
+   * the implicit feedback of the items it interacted with.
+   *
+   * @param user User ID.
+   * @param userVec Resulting user vector.
+   */
+  void UserVector(const size_t user, arma::vec& userVec) const
+  {
+    if (!userVectors.is_empty())
+    {
+      userVec = userVectors.col(user);
+      return;
+    }
+
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    userVec.zeros(h.n_rows);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+  }
+
   //! Locally stored number of iterations.
   size_t maxIterations;
   //! Learning rate for optimization.
@@ -235,6 +273,9 @@ class SVDPlusPlusPolicy
   arma::mat y;
   //! Implicit Data.
   arma::sp_mat implicitData;
+  //! The vector of each user, with its implicit feedback, if the model was
+  //! loaded for prediction only; empty otherwise.
+  arma::mat userVectors;
 };
 
 } // namespace cf
@@ -0,0 +1,104 @@
+/**
+ * @file methods/cf/neighbor_search_policies/lsh_euclidean_search.hpp
+ *
+ * Approximate nearest neighbor search with Euclidean distance, using
+ * locality-sensitive hashing.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_LSH_EUCLIDEAN_SEARCH_HPP
+#define MLPACK_METHODS_CF_LSH_EUCLIDEAN_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/lsh/lsh_search.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Approximate nearest neighbor search with Euclidean distance, using
+ * locality-sensitive hashing (LSHSearch).  This is much faster than
+ * EuclideanSearch when there are many users, but the neighborhood of a user may
+ * then miss some of its nearest neighbors.  LSH may also find fewer than k
+ * candidates for a query; the neighbors of such a query are then found
+ * exactly, so that a full neighborhood is always returned.
+ *
+ * An example of how to use LSHEuclideanSearch in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.template GetRecommendations<LSHEuclideanSearch>(10, recommendations);
+ * @endcode
+ */
+class LSHEuclideanSearch
+{
+ public:
+  using NeighborSearchType = neighbor::LSHSearch<neighbor::NearestNeighborSort>;
+
+  /**
+   * Build the hash tables on the reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numProj Number of projections in each hash table.
+   * @param numTables Number of hash tables.
+   */
+  LSHEuclideanSearch(const arma::mat& referenceSet,
+                     const size_t numProj = 10,
+                     const size_t numTables = 30) :
+      lshSearch(referenceSet, numProj, numTables)
+  { }
+
+  /**
+   * Given a set of query points, find the approximate nearest k neighbors, and
+   * return similarites. Similarities are non-negative and no larger than one.
+   *
+   * @param query A set of query points.
+   * @param k Number of neighbors to search.
+   * @param neighbors Nearest neighbors.
+   * @param similarities Similarities between query point and its neighbors.
+   */
+  void Search(const arma::mat& query, const size_t k,
+              arma::Mat<size_t>& neighbors, arma::mat& similarities)
+  {
+    lshSearch.Search(query, k, neighbors, similarities);
+
+    // LSHSearch marks the neighbors it could not find with an invalid index;
+    // those queries are searched exactly.
+    const arma::mat& referenceSet = lshSearch.ReferenceSet();
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      if (neighbors(k - 1, i) < referenceSet.n_cols)
+        continue;
+
+      arma::rowvec distances = arma::sum(arma::square(
+          referenceSet.each_col() - query.col(i)), 0);
+      const arma::uvec order = arma::sort_index(distances);
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = order[j];
+        similarities(j, i) = std::sqrt(distances[order[j]]);
+      }
+    }
+
+    // Calculate similarities from Euclidean distance. We restrict that
+    // similarities are not larger than one.
+    similarities = 1.0 / (1.0 + similarities);
+  }
+
+ private:
+  //! LSHSearch object.
+  NeighborSearchType lshSearch;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -120,6 +120,23 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings by subtracting the item means of the ratings the
+   * normalization was computed from.  The items must be known.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      datapoint(2) -= itemMean(item);
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
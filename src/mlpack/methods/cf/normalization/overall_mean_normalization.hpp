@@ -93,6 +93,22 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings by subtracting the mean of the ratings the
+   * normalization was computed from.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) -= mean;
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean.
    *
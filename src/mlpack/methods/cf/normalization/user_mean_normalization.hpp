@@ -120,6 +120,46 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize new ratings by subtracting user means.  Known users keep their
+   * mean; the mean of a new user is the mean of its new ratings.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldUserNum = userMean.n_elem;
+    const size_t userNum = std::max(oldUserNum,
+        (size_t) arma::max(data.row(0)) + 1);
+    userMean.resize(userNum); // New elements are set to zero.
+    arma::Row<size_t> ratingNum(userNum, arma::fill::zeros);
+
+    // Calculate the mean of the new users.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= oldUserNum)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user) += 1;
+      }
+    });
+
+    for (size_t i = oldUserNum; i < userNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
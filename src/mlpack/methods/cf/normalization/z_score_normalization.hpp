@@ -105,6 +105,22 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize new ratings with the mean and standard deviation of the ratings
+   * the normalization was computed from.
+   *
+   * @param data New ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
@@ -16,6 +16,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -57,8 +58,10 @@ class DBSCAN
    * Construct the DBSCAN object with the given parameters.  The batchMode
    * parameter should be set to false in the case where RAM issues will be
    * encountered (i.e. if the dataset is very large or if epsilon is large).
-   * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * When batchMode is false, the points are searched in blocks of BlockSize()
+   * points, so only the neighbors of one block are held in memory at once,
+   * and the clusters of each block are merged in parallel when OpenMP is
+   * available.
    *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
@@ -112,6 +115,11 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get the number of points searched at once when batchMode is false.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points searched at once when batchMode is false.
+  size_t& BlockSize() { return blockSize; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -123,6 +131,9 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! Number of points searched at once when batchMode is false.
+  size_t blockSize;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -131,17 +142,17 @@ class DBSCAN
 
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * also the list of cluster assignments.  This searches the points in blocks
+   * of blockSize points, and can save on RAM usage.  The neighbors of each
+   * block are merged into the union-find structure by several threads at
+   * once.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
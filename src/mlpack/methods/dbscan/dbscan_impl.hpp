@@ -30,6 +30,7 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    blockSize(10000),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -100,19 +101,27 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
+  // Cluster, then set assignments.
+  assignments.set_size(data.n_cols);
   if (batchMode)
+  {
+    emst::UnionFind uf(data.n_cols);
     BatchCluster(data, uf);
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
   else
+  {
+    emst::ConcurrentUnionFind uf(data.n_cols);
     PointwiseCluster(data, uf);
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
 
   // Get a count of all clusters.
   const size_t numClusters = arma::max(assignments) + 1;
@@ -142,7 +151,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
+ * also the list of cluster assignments.  This searches the points in blocks,
  * and can save on RAM usage.  It may be slower than the batch search with a
  * dual-tree algorithm.
  */
@@ -150,23 +159,31 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t pointsPerBlock = std::max(blockSize, (size_t) 1);
+  for (size_t begin = 0; begin < data.n_cols; begin += pointsPerBlock)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
-
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
-
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    if (begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
+
+    // Do the range search for only the points in this block; the range search
+    // itself may use several threads.
+    const size_t end = std::min(begin + pointsPerBlock, (size_t) data.n_cols);
+    const MatType block(data.cols(begin, end - 1));
+    rangeSearch.Search(block, math::Range(0.0, epsilon), neighbors, distances);
+
+    // Union to all neighbors.  The result does not depend on the order of the
+    // unions, so the points of the block can be handled concurrently.
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
+    {
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(begin + i, neighbors[i][j]);
+    }
   }
 }
 
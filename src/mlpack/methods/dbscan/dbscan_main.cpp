@@ -18,6 +18,7 @@
 #include <mlpack/methods/dbscan/random_point_selection.hpp>
 #include <mlpack/methods/dbscan/ordered_point_selection.hpp>
 #include "dbscan.hpp"
+#include "grid_dbscan.hpp"
 
 using namespace mlpack;
 using namespace mlpack::range;
@@ -63,7 +64,17 @@ BINDING_LONG_DESC(
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search.");
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search.  "
+    "With " + PRINT_PARAM_STRING("single_mode") + ", the points are also "
+    "searched in blocks instead of all at once, which uses much less memory "
+    "for large datasets, and the clusters are merged with multiple threads "
+    "when OpenMP is available."
+    "\n\n"
+    "For low-dimensional data (such as two- or three-dimensional geographic "
+    "data), the " + PRINT_PARAM_STRING("grid") + " parameter can be used to "
+    "place the points in a grid of cells of size epsilon instead of using "
+    "range search, which is usually much faster and gives the same "
+    "clustering with the Euclidean distance.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -98,6 +109,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("grid", "If set, the points are placed in a grid of cells instead "
+    "of using range search; this is fast for low-dimensional data.", "g");
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
@@ -134,6 +147,32 @@ void RunDBSCAN(RangeSearchType rs,
     IO::GetParam<arma::Row<size_t>>("assignments") = std::move(assignments);
 }
 
+// Run the grid-based clustering, and process the output.
+void RunGridDBSCAN()
+{
+  arma::mat dataset = std::move(IO::GetParam<arma::mat>("input"));
+  const double epsilon = IO::GetParam<double>("epsilon");
+  const size_t minSize = (size_t) IO::GetParam<int>("min_size");
+
+  arma::Row<size_t> assignments;
+  GridDBSCAN d(epsilon, minSize);
+
+  // If possible, avoid the overhead of calculating centroids.
+  if (IO::HasParam("centroids"))
+  {
+    arma::mat centroids;
+    d.Cluster(dataset, assignments, centroids);
+    IO::GetParam<arma::mat>("centroids") = std::move(centroids);
+  }
+  else
+  {
+    d.Cluster(dataset, assignments);
+  }
+
+  if (IO::HasParam("assignments"))
+    IO::GetParam<arma::Row<size_t>>("assignments") = std::move(assignments);
+}
+
 // Choose the point selection policy.
 template<typename RangeSearchType>
 void ChoosePointSelectionPolicy(RangeSearchType rs = RangeSearchType())
@@ -152,6 +191,10 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "naive");
+  ReportIgnoredParam({{ "grid", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "tree_type");
+  ReportIgnoredParam({{ "grid", true }}, "selection_type");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -165,8 +208,13 @@ static void mlpackMain()
   RequireParamValue<int>("min_size", [](int y) { return y > 0; },
       true, "invalid value of min_size specified");
 
+  // The grid does not use range search at all.
+  if (IO::HasParam("grid"))
+  {
+    RunGridDBSCAN();
+  }
   // Fire off naive search if needed.
-  if (IO::HasParam("naive"))
+  else if (IO::HasParam("naive"))
   {
     RangeSearch<> rs(true);
     ChoosePointSelectionPolicy(rs);
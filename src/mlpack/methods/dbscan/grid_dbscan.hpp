@@ -0,0 +1,151 @@
+/**
+ * @file methods/dbscan/grid_dbscan.hpp
+ *
+ * A grid-based implementation of DBSCAN for low-dimensional data, which hashes
+ * the points into cells instead of using range search.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_GRID_DBSCAN_HPP
+#define MLPACK_METHODS_DBSCAN_GRID_DBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * GridDBSCAN computes the same clustering as DBSCAN with the Euclidean
+ * distance, but instead of running a range search it places the points in a
+ * grid of cells whose diagonal is epsilon, following the approach of the
+ * paper below.  All the points of a cell are then within epsilon of each
+ * other and so belong to the same cluster, and two cells only need to be
+ * connected if they are close enough and some pair of their points is within
+ * epsilon.  The cells are processed in parallel when OpenMP is available.
+ *
+ * @code
+ * @inproceedings{gan2015dbscan,
+ *   title={{DBSCAN} Revisited: Mis-Claim, Un-Fixability, and Approximation},
+ *   author={Gan, J. and Tao, Y.},
+ *   booktitle={Proceedings of the 2015 ACM SIGMOD International Conference on
+ *       Management of Data},
+ *   pages={519--530},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * The number of cells that have to be checked around each cell grows
+ * exponentially with the dimensionality, so this is only fast for
+ * low-dimensional data (two or three dimensions, such as geographic data);
+ * for higher-dimensional data, DBSCAN with tree-based range search should be
+ * used instead.
+ *
+ * The assignments are identical to the assignments of DBSCAN::Cluster() when
+ * its batchMode parameter is false; in batch mode, the clusters are the same
+ * but may be numbered differently.
+ */
+class GridDBSCAN
+{
+ public:
+  /**
+   * Construct the GridDBSCAN object with the given parameters.
+   *
+   * @param epsilon Maximum distance between two neighboring points.
+   * @param minPoints Minimum number of points for each cluster.
+   */
+  GridDBSCAN(const double epsilon, const size_t minPoints) :
+      epsilon(epsilon),
+      minPoints(minPoints)
+  {
+    if (epsilon <= 0.0)
+    {
+      throw std::invalid_argument("GridDBSCAN::GridDBSCAN(): epsilon must be "
+          "positive!");
+    }
+  }
+
+  /**
+   * Performs DBSCAN clustering on the data, returning number of clusters
+   * and also the centroid of each cluster.
+   *
+   * @tparam MatType Type of dense matrix (arma::mat or arma::fmat).
+   * @param data Dataset to cluster.
+   * @param centroids Matrix in which centroids are stored.
+   */
+  template<typename MatType>
+  size_t Cluster(const MatType& data,
+                 arma::mat& centroids);
+
+  /**
+   * Performs DBSCAN clustering on the data, returning number of clusters
+   * and also the list of cluster assignments.  If assignments[i] == SIZE_MAX,
+   * then the point is considered "noise".
+   *
+   * @tparam MatType Type of dense matrix (arma::mat or arma::fmat).
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   */
+  template<typename MatType>
+  size_t Cluster(const MatType& data,
+                 arma::Row<size_t>& assignments);
+
+  /**
+   * Performs DBSCAN clustering on the data, returning number of clusters,
+   * the centroid of each cluster and also the list of cluster assignments.
+   * If assignments[i] == SIZE_MAX, then the point is considered "noise".
+   *
+   * @tparam MatType Type of dense matrix (arma::mat or arma::fmat).
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   * @param centroids Matrix in which centroids are stored.
+   */
+  template<typename MatType>
+  size_t Cluster(const MatType& data,
+                 arma::Row<size_t>& assignments,
+                 arma::mat& centroids);
+
+  //! Get the maximum distance between two neighboring points.
+  double Epsilon() const { return epsilon; }
+  //! Get the minimum number of points for each cluster.
+  size_t MinPoints() const { return minPoints; }
+
+ private:
+  //! Maximum distance between two points to be part of same cluster.
+  double epsilon;
+
+  //! Minimum number of points for a cluster.
+  size_t minPoints;
+
+  /**
+   * Place the points in the grid and union the points of each cell and the
+   * points of neighboring cells that are within epsilon of each other.
+   *
+   * @param data Dataset to cluster.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   */
+  template<typename MatType>
+  void GridCluster(const MatType& data, emst::ConcurrentUnionFind& uf) const;
+
+  /**
+   * Compute the offsets of all the cells that may hold a point within epsilon
+   * of a point of the cell at the origin, keeping only one of each pair of
+   * opposite offsets.
+   *
+   * @param dimensions Number of dimensions of the grid.
+   * @param offsets Matrix to store the offsets in (one per column).
+   */
+  static void NeighborOffsets(const size_t dimensions,
+                              arma::Mat<arma::sword>& offsets);
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "grid_dbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file methods/dbscan/grid_dbscan_impl.hpp
+ *
+ * Implementation of GridDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_GRID_DBSCAN_IMPL_HPP
+#define MLPACK_METHODS_DBSCAN_GRID_DBSCAN_IMPL_HPP
+
+#include "grid_dbscan.hpp"
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * Performs DBSCAN clustering on the data, returning number of clusters
+ * and also the centroid of each cluster.
+ */
+template<typename MatType>
+size_t GridDBSCAN::Cluster(const MatType& data, arma::mat& centroids)
+{
+  // These assignments will be thrown away, but there is no way to avoid
+  // calculating them.
+  arma::Row<size_t> assignments(data.n_cols);
+  assignments.fill(SIZE_MAX);
+
+  return Cluster(data, assignments, centroids);
+}
+
+/**
+ * Performs DBSCAN clustering on the data, returning number of clusters,
+ * the centroid of each cluster and also the list of cluster assignments.
+ */
+template<typename MatType>
+size_t GridDBSCAN::Cluster(const MatType& data,
+                           arma::Row<size_t>& assignments,
+                           arma::mat& centroids)
+{
+  const size_t numClusters = Cluster(data, assignments);
+
+  // Now calculate the centroids.
+  centroids.zeros(data.n_rows, numClusters);
+
+  // Calculate number of points in each cluster.
+  arma::Row<size_t> counts;
+  counts.zeros(numClusters);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (assignments[i] != SIZE_MAX)
+    {
+      centroids.col(assignments[i]) += arma::conv_to<arma::vec>::from(
+          data.col(i));
+      ++counts[assignments[i]];
+    }
+  }
+
+  for (size_t i = 0; i < numClusters; ++i)
+    centroids.col(i) /= counts[i];
+
+  return numClusters;
+}
+
+/**
+ * Performs DBSCAN clustering on the data, returning the number of clusters and
+ * also the list of cluster assignments.
+ */
+template<typename MatType>
+size_t GridDBSCAN::Cluster(const MatType& data,
+                           arma::Row<size_t>& assignments)
+{
+  emst::ConcurrentUnionFind uf(data.n_cols);
+  GridCluster(data, uf);
+
+  assignments.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    assignments[i] = uf.Find(i);
+
+  // Get a count of all clusters.
+  const size_t numClusters = arma::max(assignments) + 1;
+  arma::Col<size_t> counts(numClusters, arma::fill::zeros);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    counts[assignments[i]]++;
+
+  // Now assign clusters to new indices.
+  size_t currentCluster = 0;
+  arma::Col<size_t> newAssignments(numClusters);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    if (counts[i] >= minPoints)
+      newAssignments[i] = currentCluster++;
+    else
+      newAssignments[i] = SIZE_MAX;
+  }
+
+  // Now reassign.
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    assignments[i] = newAssignments[assignments[i]];
+
+  Log::Info << currentCluster << " clusters found." << std::endl;
+
+  return currentCluster;
+}
+
+/**
+ * Place the points in the grid and union the neighboring points.
+ */
+template<typename MatType>
+void GridDBSCAN::GridCluster(const MatType& data,
+                             emst::ConcurrentUnionFind& uf) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t dims = data.n_rows;
+  const size_t n = data.n_cols;
+  if (dims > 3)
+  {
+    Log::Warn << "GridDBSCAN::Cluster(): the data has " << dims
+        << " dimensions; grid-based clustering is slow in more than three "
+        << "dimensions, and DBSCAN may be faster." << std::endl;
+  }
+
+  // The diagonal of each cell is epsilon, so that all the points of a cell
+  // are neighbors.  The cells are made slightly smaller, so that rounding
+  // can't put two points more than epsilon apart in the same cell.
+  const double width = epsilon / std::sqrt((double) dims) * (1.0 - 1e-8);
+  const double squaredEpsilon = epsilon * epsilon;
+
+  // Compute the coordinates of the cell of each point.
+  const arma::Col<ElemType> minimums = arma::min(data, 1);
+  arma::Mat<arma::sword> cells(dims, n);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    for (size_t d = 0; d < dims; ++d)
+    {
+      cells(d, i) = (arma::sword) std::floor(((double) data(d, i) -
+          (double) minimums[d]) / width);
+    }
+  }
+
+  // Sort the points by cell, so that the points of each cell are contiguous.
+  auto cellLess = [dims](const arma::sword* a, const arma::sword* b)
+  {
+    return std::lexicographical_compare(a, a + dims, b, b + dims);
+  };
+
+  arma::uvec order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+      [&](const arma::uword a, const arma::uword b)
+      {
+        return cellLess(cells.colptr(a), cells.colptr(b));
+      });
+
+  // The points of cell c are order[cellStart[c]] to order[cellStart[c + 1]].
+  std::vector<size_t> cellStart;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i == 0 || cellLess(cells.colptr(order[i - 1]), cells.colptr(order[i])))
+      cellStart.push_back(i);
+  }
+  const size_t numCells = cellStart.size();
+  cellStart.push_back(n);
+
+  Log::Info << "Placed " << n << " points in " << numCells << " grid cells."
+      << std::endl;
+
+  // Keep a sorted copy of the points, so that the points of each cell are
+  // contiguous in memory.
+  const MatType sortedData(data.cols(order));
+
+  // All the points of a cell are neighbors.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numCells; ++c)
+  {
+    for (size_t i = cellStart[c] + 1; i < cellStart[c + 1]; ++i)
+      uf.Union(order[cellStart[c]], order[i]);
+  }
+
+  arma::Mat<arma::sword> offsets;
+  NeighborOffsets(dims, offsets);
+
+  // Now connect each cell to the close enough cells that hold a pair of
+  // neighboring points.
+  #pragma omp parallel
+  {
+    std::vector<arma::sword> neighbor(dims);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t c = 0; c < (omp_size_t) numCells; ++c)
+    {
+      const arma::sword* cell = cells.colptr(order[cellStart[c]]);
+      for (size_t o = 0; o < offsets.n_cols; ++o)
+      {
+        for (size_t d = 0; d < dims; ++d)
+          neighbor[d] = cell[d] + offsets(d, o);
+
+        // Find the neighbor cell, if it holds any points.
+        const std::vector<size_t>::const_iterator it = std::lower_bound(
+            cellStart.begin(), cellStart.begin() + numCells, neighbor,
+            [&](const size_t start, const std::vector<arma::sword>& key)
+            {
+              return cellLess(cells.colptr(order[start]), key.data());
+            });
+        if (it == cellStart.begin() + numCells ||
+            cellLess(neighbor.data(), cells.colptr(order[*it])))
+          continue;
+        const size_t other = it - cellStart.begin();
+
+        // There is nothing to check if the cells are already connected.
+        if (uf.Find(order[cellStart[c]]) == uf.Find(order[cellStart[other]]))
+          continue;
+
+        // Look for a pair of points within epsilon, stopping at the first.
+        bool connected = false;
+        for (size_t i = cellStart[c]; i < cellStart[c + 1] && !connected; ++i)
+        {
+          const ElemType* a = sortedData.colptr(i);
+          for (size_t j = cellStart[other]; j < cellStart[other + 1]; ++j)
+          {
+            const ElemType* b = sortedData.colptr(j);
+            double distance = 0.0;
+            for (size_t d = 0; d < dims; ++d)
+              distance += ((double) a[d] - b[d]) * ((double) a[d] - b[d]);
+
+            if (distance <= squaredEpsilon)
+            {
+              uf.Union(order[i], order[j]);
+              connected = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Compute the offsets of the cells around a cell that may hold neighbors of
+ * its points.
+ */
+inline void GridDBSCAN::NeighborOffsets(const size_t dimensions,
+                                        arma::Mat<arma::sword>& offsets)
+{
+  // Two points in cells whose coordinates differ by more than this in some
+  // dimension are more than epsilon apart.
+  const arma::sword radius = 1 +
+      (arma::sword) std::floor(std::sqrt((double) dimensions));
+
+  std::vector<arma::sword> found;
+  arma::Col<arma::sword> offset(dimensions);
+  offset.fill(-radius);
+  while (true)
+  {
+    // The squared distance between the closest points of the two cells, in
+    // units of the cell width; the squared diagonal of a cell is dimensions.
+    size_t gap = 0;
+    for (size_t d = 0; d < dimensions; ++d)
+    {
+      const arma::sword g = std::max(std::abs(offset[d]) - 1,
+          (arma::sword) 0);
+      gap += g * g;
+    }
+
+    // Only keep the offsets whose first nonzero coordinate is positive, so
+    // that each pair of cells is checked once.
+    size_t firstNonzero = 0;
+    while (firstNonzero < dimensions && offset[firstNonzero] == 0)
+      ++firstNonzero;
+
+    if (gap <= dimensions && firstNonzero < dimensions &&
+        offset[firstNonzero] > 0)
+      found.insert(found.end(), offset.begin(), offset.end());
+
+    // Move to the next offset.
+    size_t d = 0;
+    while (d < dimensions && offset[d] == radius)
+      offset[d++] = -radius;
+    if (d == dimensions)
+      break;
+    ++offset[d];
+  }
+
+  offsets = arma::Mat<arma::sword>(found.data(), dimensions,
+      found.size() / dimensions);
+}
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
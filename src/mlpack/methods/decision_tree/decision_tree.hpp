@@ -14,10 +14,13 @@
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/columnar_file.hpp>
+#include <mlpack/methods/gradient_boosting/histogram_tree_builder.hpp>
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
 #include "random_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
@@ -32,6 +35,12 @@ namespace tree {
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
  *
+ * When OpenMP is available, large trees are built with multiple threads: the
+ * splits of the dimensions of a large node are evaluated in parallel, and the
+ * subtrees below the large nodes are trained in parallel.  The tree is the same
+ * as when it is built with a single thread, as long as the split types don't
+ * use random numbers.
+ *
  * Note that `ElemType` is a template parameter controlling the type that is
  * used to store split information.  In general, you would want to set this to
  * be the same as the type of the data that you will be using, but it's not
@@ -401,6 +410,55 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on a dataset that is stored in mlpack's native
+   * binary format (see data::ColumnarFile) and that may not fit in memory,
+   * assuming that all dimensions are numeric.  This will overwrite the existing
+   * model.  Only the labels and the node of each point are held in memory; the
+   * points are read from the file in chunks of the given number of columns.
+   *
+   * The tree is built breadth-first, with one pass over the file per level.
+   * The values of each dimension are first put into at most maximumBins bins,
+   * whose edges are computed from a random sample of the points, and then
+   * during each pass a histogram of the classes of the points of each bin is
+   * accumulated for each node of the level (one dimension per thread).  The
+   * split of each node is then chosen among the bin edges, so the tree is
+   * usually close to, but not the same as, the tree that Train() would build.
+   *
+   * The split value of a numeric split is stored as the first element of
+   * ClassProbabilities() of the node, and points not larger than it go to the
+   * first child, so NumericSplitType must be a binary threshold split such as
+   * BestBinaryNumericSplit, RandomBinaryNumericSplit or HistogramNumericSplit.
+   * A std::invalid_argument is thrown if the file holds categorical dimensions
+   * or if the labels don't match the points of the file.
+   *
+   * @param filename File holding the dataset, with one point per column.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param maximumBins Maximum number of bins of each dimension (at most 256).
+   * @param chunkSize Number of points read from the file at a time.
+   * @param sampleSize Number of points used to compute the bin edges (0 means
+   *      all the points).
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @tparam eT Element type of the matrix stored in the file.
+   * @return The final entropy of decision tree.
+   */
+  template<typename eT = double>
+  double TrainOutOfCore(const std::string& filename,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        const size_t minimumLeafSize = 10,
+                        const double minimumGainSplit = 1e-7,
+                        const size_t maximumDepth = 0,
+                        const size_t maximumBins = 256,
+                        const size_t chunkSize = 65536,
+                        const size_t sampleSize = 100000,
+                        DimensionSelectionType dimensionSelector =
+                            DimensionSelectionType());
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -451,10 +509,13 @@ class DecisionTree :
                 arma::mat& probabilities) const;
 
   /**
-   * Serialize the tree.
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the number of children.
   size_t NumChildren() const { return children.size(); }
@@ -468,6 +529,20 @@ class DecisionTree :
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
 
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+
+  //! Get the majority class (only meaningful if this is a leaf).
+  size_t MajorityClass() const { return dimensionTypeOrMajorityClass; }
+
+  //! Get the class probabilities of a leaf, or the split information of a
+  //! non-leaf (which is only meaningful to the split type).
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -516,6 +591,28 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  //! A node whose training was deferred, so that it can be trained in
+  //! parallel with the other deferred nodes once the top of the tree is built.
+  struct DeferredNode
+  {
+    //! The node to train.
+    DecisionTree* node;
+    //! Index of the first point of the node.
+    size_t begin;
+    //! Number of points in the node.
+    size_t count;
+    //! Maximum depth of the subtree of the node.
+    size_t maximumDepth;
+  };
+
+  //! Return whether a node with the given number of points should be built
+  //! with multiple threads.
+  static bool BuildInParallel(const size_t count);
+
+  //! The minimum number of points a node must hold for it to be built with
+  //! multiple threads.
+  static const size_t parallelBuildMinPoints = 16384;
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
@@ -531,6 +628,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param deferred If not NULL, the children that are too small to be built
+   *      with multiple threads are added to this list instead of being
+   *      trained.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -544,7 +644,8 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               std::vector<DeferredNode>* deferred = NULL);
 
   /**
    * Corresponding to the public Train() method, this method is designed for
@@ -560,6 +661,9 @@ class DecisionTree :
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param deferred If not NULL, the children that are too small to be built
+   *      with multiple threads are added to this list instead of being
+   *      trained.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
@@ -572,7 +676,8 @@ class DecisionTree :
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
-               DimensionSelectionType& dimensionSelector);
+               DimensionSelectionType& dimensionSelector,
+               std::vector<DeferredNode>* deferred = NULL);
 };
 
 /**
@@ -600,6 +705,14 @@ typedef DecisionTree<InformationGain,
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename DimensionSelectionType, bool NoRecursion>),
+    (mlpack::tree::DecisionTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DimensionSelectionType, NoRecursion>), 1);
+
 // Include implementation.
 #include "decision_tree_impl.hpp"
 
@@ -593,6 +593,315 @@ double DecisionTree<FitnessFunction,
       dimensionSelector);
 }
 
+//! Train on a dataset stored in a file, one level at a time.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename eT>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::TrainOutOfCore(
+    const std::string& filename,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    const size_t maximumBins,
+    const size_t chunkSize,
+    const size_t sampleSize,
+    DimensionSelectionType dimensionSelector)
+{
+  data::ColumnarFile<eT> file(filename);
+  const size_t numPoints = file.NumCols();
+  const size_t numDimensions = file.NumRows();
+
+  if (labels.n_elem != numPoints)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainOutOfCore(): number of labels ("
+        << labels.n_elem << ") does not match number of points in '"
+        << filename << "' (" << numPoints << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (numPoints == 0)
+  {
+    throw std::invalid_argument("DecisionTree::TrainOutOfCore(): the dataset "
+        "is empty!");
+  }
+  if (maximumBins < 2 || maximumBins > 256)
+  {
+    std::ostringstream oss;
+    oss << "DecisionTree::TrainOutOfCore(): the number of bins must be between "
+        << "2 and 256 (given " << maximumBins << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("DecisionTree::TrainOutOfCore(): the chunk "
+        "size must be positive!");
+  }
+  if (file.HasInfo())
+  {
+    data::DatasetInfo info;
+    file.LoadInfo(info);
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      if (info.Type(d) == data::Datatype::categorical)
+      {
+        std::ostringstream oss;
+        oss << "DecisionTree::TrainOutOfCore(): dimension " << d << " of '"
+            << filename << "' is categorical, but only numeric dimensions are "
+            << "supported!";
+        throw std::invalid_argument(oss.str());
+      }
+    }
+  }
+
+  // Clear children if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // We won't be using these members, so reset them.
+  NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = numDimensions;
+
+  // Compute the bin edges of each dimension from a sample of the points.  The
+  // bin of a value is the number of edges smaller than it.
+  std::vector<arma::vec> binEdges;
+  {
+    const arma::uvec sample = (sampleSize == 0 || sampleSize >= numPoints) ?
+        arma::regspace<arma::uvec>(0, numPoints - 1) :
+        arma::uvec(arma::sort(arma::randperm<arma::uvec>(numPoints,
+            sampleSize)));
+    arma::Mat<eT> sampleData;
+    file.LoadColumns(sample, sampleData);
+    arma::Mat<unsigned char> binnedSample;
+    HistogramTreeBuilder::Bin(sampleData, maximumBins, binnedSample, binEdges);
+  }
+
+  // Turn a node into a leaf with the given class counts.
+  auto makeLeaf = [](DecisionTree& node,
+                     const arma::Col<size_t>& counts)
+  {
+    node.classProbabilities = arma::conv_to<arma::vec>::from(counts) /
+        (double) arma::accu(counts);
+    arma::uword maxIndex = 0;
+    node.classProbabilities.max(maxIndex);
+    node.dimensionTypeOrMajorityClass = (size_t) maxIndex;
+  };
+
+  // The nodes of the current level, and the class counts of their points.
+  std::vector<DecisionTree*> level(1, this);
+  std::vector<arma::Col<size_t>> levelCounts(1,
+      arma::Col<size_t>(numClasses, arma::fill::zeros));
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    if (labels[i] >= numClasses)
+    {
+      std::ostringstream oss;
+      oss << "DecisionTree::TrainOutOfCore(): label " << labels[i] << " of "
+          << "point " << i << " is not less than the number of classes ("
+          << numClasses << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+    ++levelCounts[0][labels[i]];
+  }
+  makeLeaf(*this, levelCounts[0]);
+
+  // The node of the current level that holds each point, or noNode if the
+  // point is in a leaf of an earlier level.  The points move to the next level
+  // at the start of each pass, so the split of each node of the previous level
+  // is kept: its dimension, its value, and the index of its first child in the
+  // current level (or noNode if it didn't split).
+  const size_t noNode = size_t(-1);
+  arma::Col<size_t> pointNodes(numPoints, arma::fill::zeros);
+  std::vector<size_t> splitDimensions, splitChildren;
+  std::vector<double> splitValues;
+
+  double gain = 0.0;
+  for (size_t depth = 1; !level.empty(); ++depth)
+  {
+    // Find the nodes of this level that may split, and the dimensions each of
+    // them may split on.  The other nodes are leaves.
+    std::vector<size_t> active, activeIndices(level.size(), noNode);
+    std::vector<std::vector<size_t>> activeDimensions;
+    std::vector<double> nodeGains(level.size());
+    for (size_t n = 0; n < level.size(); ++n)
+    {
+      const size_t count = arma::accu(levelCounts[n]);
+      nodeGains[n] = FitnessFunction::template EvaluatePtr<false>(
+          levelCounts[n].memptr(), numClasses, count);
+      if ((maximumDepth == 0 || depth < maximumDepth) &&
+          count >= 2 * minimumLeafSize && nodeGains[n] < 0.0)
+      {
+        activeIndices[n] = active.size();
+        active.push_back(n);
+        activeDimensions.push_back(std::vector<size_t>());
+        for (size_t d = dimensionSelector.Begin(); d != dimensionSelector.End();
+             d = dimensionSelector.Next())
+          activeDimensions.back().push_back(d);
+      }
+      else
+      {
+        gain += double(count) * nodeGains[n];
+      }
+    }
+
+    if (active.empty())
+      break;
+
+    // Accumulate the histograms of the classes of the points of each bin of
+    // each dimension of each node, in one pass over the file, one dimension
+    // per thread.
+    std::vector<arma::Cube<size_t>> histograms(numDimensions);
+    for (size_t d = 0; d < numDimensions; ++d)
+      histograms[d].zeros(numClasses, binEdges[d].n_elem + 1, active.size());
+
+    arma::Mat<eT> chunk;
+    for (size_t begin = 0; begin < numPoints; begin += chunkSize)
+    {
+      const size_t end = std::min(begin + chunkSize, numPoints);
+      file.LoadColumns(arma::regspace<arma::uvec>(begin, end - 1), chunk);
+
+      // Move the points to the nodes of this level.
+      if (!splitChildren.empty())
+      {
+        #pragma omp parallel for
+        for (omp_size_t i = 0; i < (omp_size_t) chunk.n_cols; ++i)
+        {
+          size_t& node = pointNodes[begin + i];
+          if (node == noNode)
+            continue;
+
+          const size_t child = splitChildren[node];
+          if (child == noNode)
+            node = noNode;
+          else if (chunk(splitDimensions[node], i) <= splitValues[node])
+            node = child;
+          else
+            node = child + 1;
+        }
+      }
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t d = 0; d < (omp_size_t) numDimensions; ++d)
+      {
+        const arma::vec& edges = binEdges[d];
+        arma::Cube<size_t>& histogram = histograms[d];
+        for (size_t i = 0; i < chunk.n_cols; ++i)
+        {
+          const size_t node = pointNodes[begin + i];
+          if (node == noNode || activeIndices[node] == noNode)
+            continue;
+
+          const size_t bin = std::lower_bound(edges.begin(), edges.end(),
+              (double) chunk(d, i)) - edges.begin();
+          ++histogram(labels[begin + i], bin, activeIndices[node]);
+        }
+      }
+    }
+
+    // Find the best split of each node among the bin edges.  As in
+    // BestBinaryNumericSplit, the gain of a split must exceed the gain of the
+    // node by minimumGainSplit.
+    std::vector<size_t> bestDimensions(active.size(), numDimensions);
+    std::vector<size_t> bestBins(active.size());
+    std::vector<arma::Col<size_t>> bestLeftCounts(active.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t a = 0; a < (omp_size_t) active.size(); ++a)
+    {
+      const arma::Col<size_t>& counts = levelCounts[active[a]];
+      const size_t count = arma::accu(counts);
+      double bestGain = std::min(nodeGains[active[a]] + minimumGainSplit, 0.0) *
+          count;
+
+      arma::Col<size_t> leftCounts(numClasses), rightCounts(numClasses);
+      for (size_t k = 0; k < activeDimensions[a].size(); ++k)
+      {
+        const size_t d = activeDimensions[a][k];
+        leftCounts.zeros();
+        size_t leftSize = 0;
+        for (size_t b = 0; b + 1 < histograms[d].n_cols; ++b)
+        {
+          leftCounts += histograms[d].slice(a).col(b);
+          leftSize = arma::accu(leftCounts);
+          if (leftSize < minimumLeafSize)
+            continue;
+          const size_t rightSize = count - leftSize;
+          if (rightSize < minimumLeafSize)
+            break;
+
+          rightCounts = counts - leftCounts;
+          const double splitGain = double(leftSize) *
+              FitnessFunction::template EvaluatePtr<false>(
+                  leftCounts.memptr(), numClasses, leftSize) +
+              double(rightSize) *
+              FitnessFunction::template EvaluatePtr<false>(
+                  rightCounts.memptr(), numClasses, rightSize);
+          if (splitGain > bestGain)
+          {
+            bestGain = splitGain;
+            bestDimensions[a] = d;
+            bestBins[a] = b;
+            bestLeftCounts[a] = leftCounts;
+          }
+        }
+      }
+    }
+
+    // Split the nodes, and collect the nodes of the next level.
+    std::vector<DecisionTree*> nextLevel;
+    std::vector<arma::Col<size_t>> nextLevelCounts;
+    splitDimensions.assign(level.size(), 0);
+    splitValues.assign(level.size(), 0.0);
+    splitChildren.assign(level.size(), noNode);
+    for (size_t a = 0; a < active.size(); ++a)
+    {
+      const size_t n = active[a];
+      if (bestDimensions[a] == numDimensions)
+      {
+        // The node stays a leaf.
+        gain += double(arma::accu(levelCounts[n])) * nodeGains[n];
+        continue;
+      }
+
+      DecisionTree& node = *level[n];
+      node.splitDimension = bestDimensions[a];
+      node.dimensionTypeOrMajorityClass = (size_t) data::Datatype::numeric;
+      node.classProbabilities.set_size(1);
+      node.classProbabilities[0] = binEdges[bestDimensions[a]][bestBins[a]];
+
+      splitDimensions[n] = bestDimensions[a];
+      splitValues[n] = node.classProbabilities[0];
+      splitChildren[n] = nextLevel.size();
+
+      const arma::Col<size_t> rightCounts = levelCounts[n] - bestLeftCounts[a];
+      for (size_t c = 0; c < 2; ++c)
+      {
+        DecisionTree* child = new DecisionTree(numClasses);
+        nextLevelCounts.push_back(c == 0 ? bestLeftCounts[a] : rightCounts);
+        makeLeaf(*child, nextLevelCounts.back());
+        node.children.push_back(child);
+        nextLevel.push_back(child);
+      }
+    }
+
+    level.swap(nextLevel);
+    levelCounts.swap(nextLevelCounts);
+  }
+
+  return -gain / double(numPoints);
+}
+
 //! Train on the given data, assuming all dimensions are numeric.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -615,13 +924,23 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    std::vector<DeferredNode>* deferred)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // If the tree is large enough, its top nodes are built one at a time (each
+  // evaluating its dimensions with multiple threads), and the nodes below them
+  // are deferred and then trained in parallel.
+  std::vector<DeferredNode> rootDeferred;
+  const bool parallelRoot = !NoRecursion && !deferred &&
+      BuildInParallel(count);
+  if (parallelRoot)
+    deferred = &rootDeferred;
+
   // Look through the list of dimensions and obtain the gain of the best split.
   // We'll cache the best numeric and categorical split auxiliary information in
   // numericAux and categoricalAux (and clear them later if we make no split),
@@ -634,7 +953,103 @@ double DecisionTree<FitnessFunction,
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   const size_t end = dimensionSelector.End();
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && BuildInParallel(count))
+  {
+    // Find the best split of each dimension with multiple threads, against the
+    // gain of the node.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    arma::vec dimGains(dimensions.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      const size_t i = dimensions[d];
+      arma::vec dimProbabilities;
+      dimGains[d] = DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        CategoricalAuxiliarySplitInfo dimAux;
+        dimGains[d] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            nodeGain,
+            data.cols(begin, begin + count - 1).row(i),
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimProbabilities,
+            dimAux);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        NumericAuxiliarySplitInfo dimAux;
+        dimGains[d] = NumericSplit::template SplitIfBetter<UseWeights>(
+            nodeGain,
+            data.cols(begin, begin + count - 1).row(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimProbabilities,
+            dimAux);
+      }
+    }
+
+    // Now go through the dimensions in order, as the serial loop below does.
+    // Only a dimension whose split is better than the best one so far can be
+    // taken, and it is split again against that gain, so that we get the same
+    // split (and auxiliary information) as without multiple threads.
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || dimGains[d] <= bestGain)
+        continue;
+
+      const size_t i = dimensions[d];
+      double dimGain = DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+            data.cols(begin, begin + count - 1).row(i),
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+      else
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            data.cols(begin, begin + count - 1).row(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+
+      if (dimGain == DBL_MAX)
+        continue;
+
+      bestDim = i;
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
@@ -749,17 +1164,49 @@ double DecisionTree<FitnessFunction,
             weights, currentCol - currentChildBegin, minimumGainSplit,
             maximumDepth - 1, dimensionSelector);
       }
+      else if (deferred && !BuildInParallel(childCounts[i]))
+      {
+        // The child will be trained later, in parallel with the other small
+        // children of the tree.
+        DeferredNode d = { child, currentChildBegin, childCounts[i],
+            maximumDepth - 1 };
+        deferred->push_back(d);
+      }
       else
       {
         // During recursion entropy of child node may change.
         double childGain = child->Train<UseWeights>(data, currentChildBegin,
             currentCol - currentChildBegin, datasetInfo, labels, numClasses,
             weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+            dimensionSelector, deferred);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
     }
+
+    // If we are the root of a parallel build, train the deferred nodes now.
+    // Each of them holds its own range of the points, so they can be trained
+    // at the same time.  The entropy of a deferred node was left out by its
+    // ancestors, so its share of the points is added here.
+    if (parallelRoot)
+    {
+      arma::vec deferredGains(rootDeferred.size());
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t j = 0; j < (omp_size_t) rootDeferred.size(); ++j)
+      {
+        DimensionSelectionType nodeDimensionSelector(dimensionSelector);
+        deferredGains[j] = rootDeferred[j].node->Train<UseWeights>(data,
+            rootDeferred[j].begin, rootDeferred[j].count, datasetInfo, labels,
+            numClasses, weights, minimumLeafSize, minimumGainSplit,
+            rootDeferred[j].maximumDepth, nodeDimensionSelector);
+      }
+
+      for (size_t j = 0; j < rootDeferred.size(); ++j)
+      {
+        bestGain += double(rootDeferred[j].count) / double(count) *
+            (-deferredGains[j]);
+      }
+    }
   }
   else
   {
@@ -798,13 +1245,23 @@ double DecisionTree<FitnessFunction,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    DimensionSelectionType& dimensionSelector,
+    std::vector<DeferredNode>* deferred)
 {
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // If the tree is large enough, its top nodes are built one at a time (each
+  // evaluating its dimensions with multiple threads), and the nodes below them
+  // are deferred and then trained in parallel.
+  std::vector<DeferredNode> rootDeferred;
+  const bool parallelRoot = !NoRecursion && !deferred &&
+      BuildInParallel(count);
+  if (parallelRoot)
+    deferred = &rootDeferred;
+
   // We won't be using these members, so reset them.
   CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
@@ -819,7 +1276,72 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && BuildInParallel(count))
+  {
+    // Find the best split of each dimension with multiple threads, against the
+    // gain of the node.
+    std::vector<size_t> dimensions;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dimensions.push_back(i);
+
+    const double nodeGain = bestGain;
+    arma::vec dimGains(dimensions.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      arma::vec dimProbabilities;
+      NumericAuxiliarySplitInfo dimAux;
+      dimGains[d] = NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(nodeGain,
+                                    data.cols(begin, begin + count - 1).row(
+                                        dimensions[d]),
+                                    labels.cols(begin, begin + count - 1),
+                                    numClasses,
+                                    UseWeights ?
+                                        weights.cols(begin, begin + count - 1) :
+                                        weights,
+                                    minimumLeafSize,
+                                    minimumGainSplit,
+                                    dimProbabilities,
+                                    dimAux);
+    }
+
+    // Now go through the dimensions in order, as the serial loop below does.
+    // Only a dimension whose split is better than the best one so far can be
+    // taken, and it is split again against that gain, so that we get the same
+    // split (and auxiliary information) as without multiple threads.
+    for (size_t d = 0; d < dimensions.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || dimGains[d] <= bestGain)
+        continue;
+
+      const double dimGain = NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(bestGain,
+                                    data.cols(begin, begin + count - 1).row(
+                                        dimensions[d]),
+                                    labels.cols(begin, begin + count - 1),
+                                    numClasses,
+                                    UseWeights ?
+                                        weights.cols(begin, begin + count - 1) :
+                                        weights,
+                                    minimumLeafSize,
+                                    minimumGainSplit,
+                                    classProbabilities,
+                                    *this);
+
+      if (dimGain == DBL_MAX)
+        continue;
+
+      bestDim = dimensions[d];
+      bestGain = dimGain;
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
@@ -906,17 +1428,49 @@ double DecisionTree<FitnessFunction,
             currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
             dimensionSelector);
       }
+      else if (deferred && !BuildInParallel(childCounts[i]))
+      {
+        // The child will be trained later, in parallel with the other small
+        // children of the tree.
+        DeferredNode d = { child, currentChildBegin, childCounts[i],
+            maximumDepth - 1 };
+        deferred->push_back(d);
+      }
       else
       {
         // During recursion entropy of child node may change.
         double childGain = child->Train<UseWeights>(data, currentChildBegin,
             currentCol - currentChildBegin, labels, numClasses, weights,
             minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+            dimensionSelector, deferred);
         bestGain += double(childCounts[i]) / double(count) * (-childGain);
       }
       children.push_back(child);
     }
+
+    // If we are the root of a parallel build, train the deferred nodes now.
+    // Each of them holds its own range of the points, so they can be trained
+    // at the same time.  The entropy of a deferred node was left out by its
+    // ancestors, so its share of the points is added here.
+    if (parallelRoot)
+    {
+      arma::vec deferredGains(rootDeferred.size());
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t j = 0; j < (omp_size_t) rootDeferred.size(); ++j)
+      {
+        DimensionSelectionType nodeDimensionSelector(dimensionSelector);
+        deferredGains[j] = rootDeferred[j].node->Train<UseWeights>(data,
+            rootDeferred[j].begin, rootDeferred[j].count, labels, numClasses,
+            weights, minimumLeafSize, minimumGainSplit,
+            rootDeferred[j].maximumDepth, nodeDimensionSelector);
+      }
+
+      for (size_t j = 0; j < rootDeferred.size(); ++j)
+      {
+        bestGain += double(rootDeferred[j].count) / double(count) *
+            (-deferredGains[j]);
+      }
+    }
   }
   else
   {
@@ -933,6 +1487,27 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Return whether a node should be built with multiple threads.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+bool DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  NoRecursion>::BuildInParallel(const size_t count)
+{
+#ifdef HAS_OPENMP
+  return count >= parallelBuildMinPoints && omp_get_max_threads() > 1 &&
+      !omp_in_parallel();
+#else
+  (void) count;
+  return false;
+#endif
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -1056,7 +1631,7 @@ void DecisionTree<FitnessFunction,
                   CategoricalSplitType,
                   DimensionSelectionType,
                   NoRecursion>::serialize(Archive& ar,
-                                          const uint32_t /* version */)
+                                          const uint32_t version)
 {
   // Clean memory if needed.
   if (cereal::is_loading<Archive>())
@@ -1065,13 +1640,115 @@ void DecisionTree<FitnessFunction,
       delete children[i];
     children.clear();
   }
-  // Serialize the children first.
-  ar(CEREAL_VECTOR_POINTER(children));
 
-  // Now serialize the rest of the object.
-  ar(CEREAL_NVP(splitDimension));
-  ar(CEREAL_NVP(dimensionTypeOrMajorityClass));
-  ar(CEREAL_NVP(classProbabilities));
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    // Serialize the children first.
+    ar(CEREAL_VECTOR_POINTER(children));
+
+    // Now serialize the rest of the object.
+    ar(CEREAL_NVP(splitDimension));
+    ar(CEREAL_NVP(dimensionTypeOrMajorityClass));
+    ar(CEREAL_NVP(classProbabilities));
+    return;
+  }
+
+  // The nodes of the tree are stored as arrays that hold one element for each
+  // node, in breadth-first order, so that neither saving nor loading recurses;
+  // the children of each node are the next unclaimed nodes.  The class
+  // probabilities of all the nodes are concatenated.
+  std::vector<DecisionTree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      for (size_t j = 0; j < nodes[i]->children.size(); ++j)
+        nodes.push_back(nodes[i]->children[j]);
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  std::vector<size_t> numChildren(numNodes), splitDimensions(numNodes),
+      typesOrMajorityClasses(numNodes), numProbabilities(numNodes);
+  arma::vec probabilities;
+  if (cereal::is_saving<Archive>())
+  {
+    size_t totalProbabilities = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      numChildren[i] = nodes[i]->children.size();
+      splitDimensions[i] = nodes[i]->splitDimension;
+      typesOrMajorityClasses[i] = nodes[i]->dimensionTypeOrMajorityClass;
+      numProbabilities[i] = nodes[i]->classProbabilities.n_elem;
+      totalProbabilities += numProbabilities[i];
+    }
+
+    probabilities.set_size(totalProbabilities);
+    size_t offset = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      if (numProbabilities[i] > 0)
+      {
+        probabilities.subvec(offset, offset + numProbabilities[i] - 1) =
+            nodes[i]->classProbabilities;
+      }
+      offset += numProbabilities[i];
+    }
+  }
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(splitDimensions));
+  ar(CEREAL_NVP(typesOrMajorityClasses));
+  ar(CEREAL_NVP(numProbabilities));
+  ar(CEREAL_NVP(probabilities));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+    {
+      throw std::runtime_error("DecisionTree::serialize(): the archive holds "
+          "no nodes!");
+    }
+
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    for (size_t i = 1; i < numNodes; ++i)
+      nodes[i] = new DecisionTree();
+
+    size_t nextChild = 1;
+    size_t offset = 0;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      DecisionTree* node = nodes[i];
+      if (nextChild + numChildren[i] > numNodes ||
+          offset + numProbabilities[i] > probabilities.n_elem)
+      {
+        // Free the nodes that weren't attached yet.
+        for (size_t j = nextChild; j < numNodes; ++j)
+          delete nodes[j];
+        throw std::runtime_error("DecisionTree::serialize(): the archive "
+            "holds an invalid tree!");
+      }
+
+      node->children.resize(numChildren[i]);
+      for (size_t j = 0; j < numChildren[i]; ++j)
+        node->children[j] = nodes[nextChild++];
+
+      node->splitDimension = splitDimensions[i];
+      node->dimensionTypeOrMajorityClass = typesOrMajorityClasses[i];
+      if (numProbabilities[i] > 0)
+      {
+        node->classProbabilities = probabilities.subvec(offset,
+            offset + numProbabilities[i] - 1);
+      }
+      else
+      {
+        node->classProbabilities.clear();
+      }
+      offset += numProbabilities[i];
+    }
+  }
 }
 
 template<typename FitnessFunction,
@@ -0,0 +1,201 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split between
+ * the bins of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& classProbabilities,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimum * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  const double minValue = arma::min(data);
+  const double maxValue = arma::max(data);
+
+  // Sanity check: if the maximum element is the same as the minimum, we can't
+  // split in this dimension.
+  if (minValue == maxValue)
+    return DBL_MAX;
+
+  // Build the histogram: the class counts (or weights), the number of points,
+  // and the smallest and largest value of each bin.
+  const size_t bins = Bins();
+  const double scale = bins / (maxValue - minValue);
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  if (UseWeights)
+    classWeightSums.zeros(numClasses, bins);
+  else
+    classCounts.zeros(numClasses, bins);
+  arma::Col<size_t> binCounts(bins, arma::fill::zeros);
+  arma::vec binMin(bins), binMax(bins);
+  binMin.fill(DBL_MAX);
+  binMax.fill(-DBL_MAX);
+
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const double value = data[i];
+    const size_t bin = std::min((size_t) ((value - minValue) * scale),
+        bins - 1);
+    if (UseWeights)
+      classWeightSums(labels[i], bin) += weights[i];
+    else
+      ++classCounts(labels[i], bin);
+    ++binCounts[bin];
+    binMin[bin] = std::min(binMin[bin], value);
+    binMax[bin] = std::max(binMax[bin], value);
+  }
+
+  // The smallest value to the right of each bin boundary.
+  arma::vec rightMin(bins);
+  rightMin[bins - 1] = DBL_MAX;
+  for (size_t b = bins - 1; b > 0; --b)
+    rightMin[b - 1] = std::min(binMin[b], rightMin[b]);
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+
+  // The counts of the left child start empty; those of the right child hold
+  // every point.
+  arma::Col<size_t> leftCounts, rightCounts;
+  arma::vec leftWeightSums, rightWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  if (UseWeights)
+  {
+    leftWeightSums.zeros(numClasses);
+    rightWeightSums = arma::sum(classWeightSums, 1);
+    totalWeight = arma::accu(rightWeightSums);
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    leftCounts.zeros(numClasses);
+    rightCounts = arma::sum(classCounts, 1);
+    bestFoundGain *= data.n_elem;
+  }
+
+  size_t leftSize = 0;
+  for (size_t b = 0; b < bins - 1; ++b)
+  {
+    if (binCounts[b] == 0)
+      continue; // The split would be the same as the previous one.
+
+    // Move the bin to the left child.
+    leftSize += binCounts[b];
+    if (UseWeights)
+    {
+      leftWeightSums += classWeightSums.col(b);
+      rightWeightSums -= classWeightSums.col(b);
+      totalLeftWeight += arma::accu(classWeightSums.col(b));
+    }
+    else
+    {
+      leftCounts += classCounts.col(b);
+      rightCounts -= classCounts.col(b);
+    }
+
+    const size_t rightSize = data.n_elem - leftSize;
+    if (leftSize < minimum)
+      continue;
+    if (rightSize < minimum)
+      break;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    double gain;
+    if (UseWeights)
+    {
+      const double totalRightWeight = totalWeight - totalLeftWeight;
+      const double leftGain = FitnessFunction::template EvaluatePtr<true>(
+          leftWeightSums.memptr(), numClasses, totalLeftWeight);
+      const double rightGain = FitnessFunction::template EvaluatePtr<true>(
+          rightWeightSums.memptr(), numClasses, totalRightWeight);
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      const double leftGain = FitnessFunction::template EvaluatePtr<false>(
+          leftCounts.memptr(), numClasses, leftSize);
+      const double rightGain = FitnessFunction::template EvaluatePtr<false>(
+          rightCounts.memptr(), numClasses, rightSize);
+      gain = double(leftSize) * leftGain + double(rightSize) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[b] + rightMin[b]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[b] + rightMin[b]) / 2.0;
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::vec& classProbabilities,
+    const AuxiliarySplitInfo& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -151,6 +151,12 @@ class DTree
    * Greedily expand the tree.  The points in the dataset will be reordered
    * during tree growth.
    *
+   * When OpenMP is available and the dataset is dense, a large tree is grown
+   * with multiple threads: the top nodes are split one at a time, each
+   * evaluating its dimensions in parallel, and the subtrees below them are
+   * then grown in parallel.  The tree is the same as when it is grown with a
+   * single thread.
+   *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
    * @param useVolReg If true, volume regularization is used.
@@ -353,6 +359,49 @@ class DTree
                    const ElemType splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Greedily expand the tree, as the public Grow().  If deferred is not NULL,
+   * the children that are too small to be grown with multiple threads are
+   * added to it instead of being grown, and the nodes above them are left to
+   * be finished by FinishGrow().
+   */
+  double Grow(MatType& data,
+              arma::Col<size_t>& oldFromNew,
+              const bool useVolReg,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              std::vector<DTree*>* deferred);
+
+  /**
+   * Compute the statistics of a node whose children have been grown, given the
+   * minimum values of g_k(t) of the subtrees of the children, and return the
+   * minimum value of g_k(t) of the subtree of the node.
+   */
+  double UpdateGrown(const size_t totalPoints,
+                     const bool useVolReg,
+                     const double leftG,
+                     const double rightG);
+
+  /**
+   * Finish the nodes above the deferred nodes, once they have been grown
+   * (deferredG holds the values Grow() returned for them).  The nodes are
+   * visited in the order they were deferred in; index is the next deferred
+   * node.
+   */
+  double FinishGrow(const size_t totalPoints,
+                    const bool useVolReg,
+                    const std::vector<DTree*>& deferred,
+                    const std::vector<double>& deferredG,
+                    size_t& index);
+
+  //! Return whether a node with the given number of points should be grown
+  //! with multiple threads.
+  static bool GrowInParallel(const size_t points);
+
+  //! The minimum number of points a node must hold for it to be grown with
+  //! multiple threads.
+  static const size_t parallelGrowMinPoints = 8192;
+
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
 };
@@ -450,17 +450,20 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension.  The dimensions are searched with
+  // multiple threads if the node is large enough, and the best split is then
+  // chosen in order of dimension, so the result doesn't depend on the number
+  // of threads.
+  std::vector<char> dimSplitsFound(maxVals.n_elem, 0);
+  arma::vec dimErrors(maxVals.n_elem);
+  arma::vec dimLeftErrors(maxVals.n_elem);
+  arma::vec dimRightErrors(maxVals.n_elem);
+  StatType dimSplitValues(maxVals.n_elem);
 
   // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  #pragma omp parallel for schedule(dynamic) \
+      if (points >= parallelGrowMinPoints)
+  for (omp_size_t dim = 0; dim < (omp_size_t) maxVals.n_elem; ++dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
@@ -528,24 +531,37 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
-      - volumeWithoutDim;
-
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (dimSplitFound)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
-      minError = actualMinDimError;
-      splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      dimErrors[dim] = std::log(minDimError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      dimLeftErrors[dim] = std::log(dimLeftError)
+        - 2 * std::log((double) data.n_cols)
         - volumeWithoutDim;
+      dimRightErrors[dim] = std::log(dimRightError)
+        - 2 * std::log((double) data.n_cols)
+        - volumeWithoutDim;
+      dimSplitValues[dim] = dimSplitValue;
+      dimSplitsFound[dim] = 1;
+    }
+  }
+
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (dimSplitsFound[dim] && (dimErrors[dim] > minError))
+    {
+      minError = dimErrors[dim];
+      splitDim = dim;
+      splitValue = dimSplitValues[dim];
+      leftError = dimLeftErrors[dim];
+      rightError = dimRightErrors[dim];
       splitFound = true;
-    } // end if better split found in this dimension.
+    }
   }
 
   return splitFound;
@@ -592,12 +608,46 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  if (!GrowInParallel(end - start))
+  {
+    return Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+        NULL);
+  }
+
+  // Split the large nodes at the top of the tree one at a time (each
+  // evaluating its dimensions with multiple threads), and defer the nodes
+  // below them.
+  std::vector<DTree*> deferred;
+  Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize, &deferred);
+
+  // The deferred nodes hold disjoint ranges of points, so their subtrees can
+  // be grown in parallel.
+  std::vector<double> deferredG(deferred.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) deferred.size(); ++i)
+  {
+    deferredG[i] = deferred[i]->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+        minLeafSize, NULL);
+  }
+
+  // Now finish the top of the tree.
+  size_t index = 0;
+  return FinishGrow(data.n_cols, useVolReg, deferred, deferredG, index);
+}
+
+// Greedily expand the tree, possibly deferring the small nodes.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::Grow(MatType& data,
+                                     arma::Col<size_t>& oldFromNew,
+                                     const bool useVolReg,
+                                     const size_t maxLeafSize,
+                                     const size_t minLeafSize,
+                                     std::vector<DTree*>* deferred)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
-  double leftG, rightG;
-
   // Compute points ratio.
   ratio = (double) (end - start) / (double) oldFromNew.n_elem;
 
@@ -633,30 +683,37 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       splitValue = splitValueTmp;
       splitDim = dim;
 
-      // Recursively grow the children.
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      if (deferred)
+      {
+        // Keep splitting the large children, and defer the others.  This node
+        // is finished by FinishGrow() once the deferred nodes are grown.
+        for (size_t i = 0; i < 2; ++i)
+        {
+          DTree* child = (i == 0) ? left : right;
+          if (GrowInParallel(child->End() - child->Start()))
+          {
+            child->Grow(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+                deferred);
+          }
+          else
+          {
+            deferred->push_back(child);
+          }
+        }
 
-      // Store values of R(T~) and |T~|.
-      subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+        return std::numeric_limits<double>::max();
+      }
 
-      // Find the log negative error of the subtree leaves.  This is kind of an
-      // odd one because we don't want to represent the error in non-log-space,
-      // but we have to calculate log(E_l + E_r).  So we multiply E_l and E_r by
-      // V_t (remember E_l has an inverse relationship to the volume of the
-      // nodes) and then subtract log(V_t) at the end of the whole expression.
-      // As a result we do leave log-space, but the largest quantity we
-      // represent is on the order of (V_t / V_i) where V_i is the smallest leaf
-      // node below this node, which depends heavily on the depth of the tree.
-      subtreeLeavesLogNegError = std::log(
-          std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
-          std::exp(logVolume + right->SubtreeLeavesLogNegError()))
-          - logVolume;
+      // Recursively grow the children.
+      const double leftG = left->Grow(data, oldFromNew, useVolReg,
+          maxLeafSize, minLeafSize, NULL);
+      const double rightG = right->Grow(data, oldFromNew, useVolReg,
+          maxLeafSize, minLeafSize, NULL);
+
+      return UpdateGrown(data.n_cols, useVolReg, leftG, rightG);
     }
     else
     {
@@ -673,67 +730,128 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     subtreeLeavesLogNegError = logNegError;
   }
 
-  // If this is a leaf, do not compute g_k(t); otherwise compute, store, and
-  // propagate min(g_k(t_L), g_k(t_R), g_k(t)), unless t_L and/or t_R are
-  // leaves.
-  if (subtreeLeaves == 1)
-  {
-    return std::numeric_limits<double>::max();
-  }
-  else
-  {
-    const double range = maxVals[splitDim] - minVals[splitDim];
-    const double leftRatio = (splitValue - minVals[splitDim]) / range;
-    const double rightRatio = (maxVals[splitDim] - splitValue) / range;
+  // If this is a leaf, do not compute g_k(t).
+  return std::numeric_limits<double>::max();
+}
 
-    const size_t leftPow = std::pow((double) (left->End() - left->Start()), 2);
-    const size_t rightPow = std::pow((double) (right->End() - right->Start()),
-        2);
-    const size_t thisPow = std::pow((double) (end - start), 2);
+// Compute the statistics of a node once its children have been grown.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::UpdateGrown(const size_t totalPoints,
+                                            const bool useVolReg,
+                                            const double leftG,
+                                            const double rightG)
+{
+  // Store values of R(T~) and |T~|.
+  subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
+
+  // Find the log negative error of the subtree leaves.  This is kind of an odd
+  // one because we don't want to represent the error in non-log-space, but we
+  // have to calculate log(E_l + E_r).  So we multiply E_l and E_r by V_t
+  // (remember E_l has an inverse relationship to the volume of the nodes) and
+  // then subtract log(V_t) at the end of the whole expression.  As a result we
+  // do leave log-space, but the largest quantity we represent is on the order
+  // of (V_t / V_i) where V_i is the smallest leaf node below this node, which
+  // depends heavily on the depth of the tree.
+  subtreeLeavesLogNegError = std::log(
+      std::exp(logVolume + left->SubtreeLeavesLogNegError()) +
+      std::exp(logVolume + right->SubtreeLeavesLogNegError()))
+      - logVolume;
 
-    double tmpAlphaSum = leftPow / leftRatio + rightPow / rightRatio - thisPow;
+  // Compute, store, and propagate min(g_k(t_L), g_k(t_R), g_k(t)), unless t_L
+  // and/or t_R are leaves.
+  const double range = maxVals[splitDim] - minVals[splitDim];
+  const double leftRatio = (splitValue - minVals[splitDim]) / range;
+  const double rightRatio = (maxVals[splitDim] - splitValue) / range;
 
-    if (left->SubtreeLeaves() > 1)
-    {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
-          left->AlphaUpper();
+  const size_t leftPow = std::pow((double) (left->End() - left->Start()), 2);
+  const size_t rightPow = std::pow((double) (right->End() - right->Start()),
+      2);
+  const size_t thisPow = std::pow((double) (end - start), 2);
 
-      // Whether or not this will overflow is highly dependent on the depth of
-      // the tree.
-      tmpAlphaSum += std::exp(exponent);
-    }
+  double tmpAlphaSum = leftPow / leftRatio + rightPow / rightRatio - thisPow;
 
-    if (right->SubtreeLeaves() > 1)
-    {
-      const double exponent = 2 * std::log((double) data.n_cols)
-        + logVolume
-        + right->AlphaUpper();
+  if (left->SubtreeLeaves() > 1)
+  {
+    const double exponent = 2 * std::log((double) totalPoints) + logVolume +
+        left->AlphaUpper();
 
-      tmpAlphaSum += std::exp(exponent);
-    }
+    // Whether or not this will overflow is highly dependent on the depth of
+    // the tree.
+    tmpAlphaSum += std::exp(exponent);
+  }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
-      - logVolume;
+  if (right->SubtreeLeaves() > 1)
+  {
+    const double exponent = 2 * std::log((double) totalPoints)
+      + logVolume
+      + right->AlphaUpper();
 
-    double gT;
-    if (useVolReg)
-    {
-      // This is wrong for now!
-      gT = alphaUpper; // / (subtreeLeavesVTInv - vTInv);
-    }
-    else
-    {
-      gT = alphaUpper - std::log((double) (subtreeLeaves - 1));
-    }
+    tmpAlphaSum += std::exp(exponent);
+  }
+
+  alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
+    - logVolume;
 
-    return std::min(gT, std::min(leftG, rightG));
+  double gT;
+  if (useVolReg)
+  {
+    // This is wrong for now!
+    gT = alphaUpper; // / (subtreeLeavesVTInv - vTInv);
   }
+  else
+  {
+    gT = alphaUpper - std::log((double) (subtreeLeaves - 1));
+  }
+
+  return std::min(gT, std::min(leftG, rightG));
 
   // We need to compute (c_t^2) * r_t for all subtree leaves; this is equal to
   // n_t ^ 2 / r_t * n ^ 2 = -error.  Therefore the value we need is actually
   // -1.0 * subtreeLeavesError.
 }
 
+// Finish the nodes above the deferred nodes.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::FinishGrow(const size_t totalPoints,
+                                           const bool useVolReg,
+                                           const std::vector<DTree*>& deferred,
+                                           const std::vector<double>& deferredG,
+                                           size_t& index)
+{
+  // A leaf was finished when it was made.
+  if (!left)
+    return std::numeric_limits<double>::max();
+
+  // The children are visited in the order Grow() deferred them in.
+  double childG[2];
+  for (size_t i = 0; i < 2; ++i)
+  {
+    DTree* child = (i == 0) ? left : right;
+    if (index < deferred.size() && deferred[index] == child)
+      childG[i] = deferredG[index++];
+    else
+      childG[i] = child->FinishGrow(totalPoints, useVolReg, deferred,
+          deferredG, index);
+  }
+
+  return UpdateGrown(totalPoints, useVolReg, childG[0], childG[1]);
+}
+
+//! Return whether a node should be grown with multiple threads.
+template<typename MatType, typename TagType>
+bool DTree<MatType, TagType>::GrowInParallel(const size_t points)
+{
+#ifdef HAS_OPENMP
+  // Splitting the data reorders the columns of a sparse matrix in place, so
+  // sparse subtrees can't be grown at the same time.
+  return !arma::is_SpMat<MatType>::value && points >= parallelGrowMinPoints &&
+      omp_get_max_threads() > 1 && !omp_in_parallel();
+#else
+  (void) points;
+  return false;
+#endif
+}
+
 
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::PruneAndUpdate(const double oldAlpha,
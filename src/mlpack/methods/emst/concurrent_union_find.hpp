@@ -0,0 +1,98 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * A lock-free union-find structure that can be modified by several threads at
+ * once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A union-find structure like UnionFind, but whose Find() and Union() methods
+ * may be called concurrently from several threads.  Instead of union by rank,
+ * the root with the larger index is always linked below the root with the
+ * smaller index, using an atomic compare-and-swap, and Find() compresses the
+ * paths it follows by path halving.  Because of this, the representative of
+ * each component is its smallest element, independently of the order of the
+ * calls to Union().
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      // Path halving: point x at its grandparent.  If another thread changed
+      // the parent of x in the meantime, it also moved it closer to the root.
+      const size_t gp = parent[p].load(std::memory_order_acquire);
+      if (gp != p)
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+
+      x = gp;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   */
+  void Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return;
+
+      // Link the larger root below the smaller one; this fails only if the
+      // larger root stopped being a root, in which case we try again.
+      if (x < y)
+        std::swap(x, y);
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y,
+          std::memory_order_acq_rel))
+        return;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -27,11 +27,13 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -68,6 +70,11 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * When OpenMP is available, the traversal of each Boruvka iteration is split
+ * over disjoint query subtrees that are handled by different threads; each
+ * thread collects its own candidate edges, and these are merged at the end of
+ * the iteration.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,7 +110,7 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -118,6 +125,9 @@ class DualTreeBoruvka
   //! The instantiated metric.
   MetricType metric;
 
+  //! The traversal statistics of the last computation of the MST.
+  tree::TraversalStatistics statistics;
+
   //! For sorting the edge list after the computation.
   struct SortEdgesHelper
   {
@@ -175,7 +185,30 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  /**
+   * Compute the minimum spanning tree under the mutual reachability distance
+   * max(d(a, b), core(a), core(b)) used by HDBSCAN, where core(a) is the given
+   * core distance of point a.  The results have the same format as for
+   * ComputeMST(results), and the third row holds mutual reachability
+   * distances.  The core distances are indexed like the dataset given to the
+   * constructor.
+   *
+   * @param results Matrix which results will be stored in.
+   * @param coreDistances Core distance of each point.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec& coreDistances);
+
+  //! Get the traversal statistics (base cases, scores, prunes and visited
+  //! node combinations) of the last computation of the MST.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
  private:
+  /**
+   * Compute the MST, using the given core distances (in the order of the
+   * points of the tree) if they are not NULL.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec* coreDistances);
+
   /**
    * Adds a single edge to the edge list
    */
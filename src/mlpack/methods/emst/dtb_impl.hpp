@@ -14,6 +14,8 @@
 
 #include "dtb_rules.hpp"
 
+#include <mlpack/core/tree/query_subtrees.hpp>
+
 namespace mlpack {
 namespace emst {
 
@@ -118,17 +120,151 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     arma::mat& results)
+{
+  ComputeMST(results, (const arma::vec*) NULL);
+}
+
+/**
+ * Compute the MST under the mutual reachability distance.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec& coreDistances)
+{
+  if (coreDistances.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DualTreeBoruvka::ComputeMST(): " << coreDistances.n_elem
+        << " core distances given, but the dataset has " << data.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The rules work with the indices of the points in the tree.
+  if (!naive && ownTree && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    arma::vec treeCoreDistances(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      treeCoreDistances[i] = coreDistances[oldFromNew[i]];
+
+    ComputeMST(results, &treeCoreDistances);
+  }
+  else
+  {
+    ComputeMST(results, &coreDistances);
+  }
+}
+
+/**
+ * Iteratively find the nearest neighbor of each component until the MST is
+ * complete, optionally with core distances.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec* coreDistances)
 {
   Timer::Start("emst/mst_computation");
 
   totalDist = 0; // Reset distance.
+  statistics.Reset();
 
   typedef DTBRules<MetricType, Tree> RuleType;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+                 neighborsOutComponent, metric, coreDistances);
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // With several threads, each thread collects candidate edges in its own
+  // arrays, and the results are merged after the traversal of each iteration.
+  // Each thread traverses disjoint query subtrees, so the statistics of the
+  // query nodes written by the rules are never shared between threads.
+  std::vector<arma::vec> threadDistances(numThreads);
+  std::vector<arma::Col<size_t>> threadInComponent(numThreads);
+  std::vector<arma::Col<size_t>> threadOutComponent(numThreads);
+  std::vector<Tree*> querySubtrees;
+  if (numThreads > 1 && !naive)
+    tree::QuerySubtrees(*tree, 4 * numThreads, querySubtrees);
+
+  // Without threads, the same traverser is used for every iteration.
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    if (numThreads > 1)
+    {
+      std::vector<char> threadUsed(numThreads, 0);
+
+      #pragma omp parallel
+      {
+#ifdef HAS_OPENMP
+        const size_t thread = omp_get_thread_num();
+#else
+        const size_t thread = 0;
+#endif
+        threadUsed[thread] = 1;
+        threadDistances[thread].set_size(data.n_cols);
+        threadDistances[thread].fill(DBL_MAX);
+        threadInComponent[thread].set_size(data.n_cols);
+        threadOutComponent[thread].set_size(data.n_cols);
+
+        RuleType threadRules(data, connections, threadDistances[thread],
+            threadInComponent[thread], threadOutComponent[thread], metric,
+            coreDistances);
+        typename Tree::template DualTreeTraverser<RuleType>
+            threadTraverser(threadRules);
+
+        if (naive)
+        {
+          // Full O(N^2) traversal.
+          #pragma omp for schedule(dynamic, 16)
+          for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+            for (size_t j = 0; j < data.n_cols; ++j)
+              threadRules.BaseCase(i, j);
+        }
+        else
+        {
+          #pragma omp for schedule(dynamic)
+          for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+            threadTraverser.Traverse(*querySubtrees[i], *tree);
+        }
+
+        tree::TraversalStatistics threadStatistics;
+        threadStatistics.Add(threadRules, threadTraverser);
+        #pragma omp critical
+        statistics += threadStatistics;
+      }
+
+      // Keep the best candidate edge of each component.
+      #pragma omp parallel for
+      for (omp_size_t c = 0; c < (omp_size_t) data.n_cols; ++c)
+      {
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+          if (threadUsed[t] && threadDistances[t][c] < neighborsDistances[c])
+          {
+            neighborsDistances[c] = threadDistances[t][c];
+            neighborsInComponent[c] = threadInComponent[t][c];
+            neighborsOutComponent[c] = threadOutComponent[t][c];
+          }
+        }
+      }
+    }
+    else if (naive)
     {
       // Full O(N^2) traversal.
       for (size_t i = 0; i < data.n_cols; ++i)
@@ -137,7 +273,6 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
       traverser.Traverse(*tree, *tree);
     }
 
@@ -148,12 +283,16 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      tree::TraversalStatistics cumulative(statistics);
+      cumulative.Add(rules, traverser);
+      Log::Info << "Cumulative tree traversal: " << cumulative << "."
           << std::endl;
     }
   }
 
+  // The serial traversals are counted by the rules and the traverser.
+  statistics.Add(rules, traverser);
+
   Timer::Stop("emst/mst_computation");
 
   EmitResults(results);
@@ -15,6 +15,9 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
+
+#include "concurrent_union_find.hpp"
 
 namespace mlpack {
 namespace emst {
@@ -24,11 +27,12 @@ class DTBRules
 {
  public:
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           ConcurrentUnionFind& connections,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           const arma::vec* coreDistances = NULL);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -102,7 +106,7 @@ class DTBRules
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -118,6 +122,13 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! If not NULL, the core distance of each point; the distance between two
+  //! points is then their mutual reachability distance.
+  const arma::vec* coreDistances;
+
+  //! The distances from the last scored query point to leaves.
+  tree::LeafDistanceCache<MetricType, arma::mat> leafDistances;
+
   /**
    * Update the bound for the given query node.
    */
@@ -18,11 +18,12 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         ConcurrentUnionFind& connections,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         const arma::vec* coreDistances)
 :
   dataSet(dataSet),
   connections(connections),
@@ -30,6 +31,7 @@ DTBRules(const arma::mat& dataSet,
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  coreDistances(coreDistances),
   baseCases(0),
   scores(0)
 {
@@ -54,8 +56,21 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   if (queryComponentIndex != referenceComponentIndex)
   {
     ++baseCases;
-    double distance = metric.Evaluate(dataSet.col(queryIndex),
-                                      dataSet.col(referenceIndex));
+    double distance;
+    if (!leafDistances.Distance(dataSet, dataSet, queryIndex, referenceIndex,
+        distance))
+    {
+      distance = metric.Evaluate(dataSet.col(queryIndex),
+                                 dataSet.col(referenceIndex));
+    }
+
+    // The mutual reachability distance is never smaller than the distance, so
+    // the distance bounds used for pruning still hold.
+    if (coreDistances)
+    {
+      distance = std::max(distance, std::max((*coreDistances)[queryIndex],
+          (*coreDistances)[referenceIndex]));
+    }
 
     if (distance < neighborsDistances[queryComponentIndex])
     {
@@ -93,8 +108,13 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
-      ? DBL_MAX : distance;
+  if (neighborsDistances[queryComponentIndex] < distance)
+    return DBL_MAX;
+
+  // The points of the node will be visited next, so their distances can be
+  // computed together.
+  leafDistances.Prepare(queryIndex, referenceNode);
+  return distance;
 }
 
 template<typename MetricType, typename TreeType>
@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/ip_metric.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include <queue>
 
 namespace mlpack {
@@ -302,6 +303,10 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get the traversal statistics (base cases, scores, prunes and visited
+  //! nodes) of the last search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -324,6 +329,8 @@ class FastMKS
 
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
+  //! The traversal statistics of the last search.
+  tree::TraversalStatistics statistics;
 
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
@@ -339,6 +346,40 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Perform a dual-tree traversal of the given query tree against the
+   * reference tree with the given rules, and add its statistics to the
+   * statistics of the search.  If OpenMP is available and more than one thread
+   * can be used, the query tree is split into disjoint subtrees that are
+   * traversed against the reference tree in parallel; each thread uses its own
+   * rules object that shares the candidate lists of the given rules, so the
+   * results are identical to those of the serial traversal.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param rules Rules holding the candidate lists for the query points.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Find the k maximum kernels of each query point by brute force.  The kernel
+   * matrix between blocks of query points and blocks of reference points is
+   * computed with kernel::KernelMatrix(), and the blocks of query points are
+   * split between threads.
+   *
+   * @param querySet Set of query points.
+   * @param sameSet Whether the query set is the reference set, in which case
+   *     points are not returned as their own candidates.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const bool sameSet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels);
 };
 
 } // namespace fastmks
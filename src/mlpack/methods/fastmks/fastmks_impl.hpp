@@ -16,6 +16,8 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include <mlpack/core/tree/query_subtrees.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
@@ -180,7 +182,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(other.metric)
+    metric(other.metric),
+    statistics(other.statistics)
 {
   // Set reference set correctly.
   if (referenceTree)
@@ -201,7 +204,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
-    metric(std::move(other.metric))
+    metric(std::move(other.metric)),
+    statistics(other.statistics)
 {
   // Clear information from the other.
   other.referenceSet = NULL;
@@ -210,6 +214,7 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.statistics.Reset();
 }
 
 template<typename KernelType,
@@ -248,6 +253,8 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  statistics = other.statistics;
+  return *this;
 }
 
 template<typename KernelType,
@@ -267,6 +274,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(FastMKS&& other)
     singleMode = other.singleMode;
     naive = other.naive;
     metric = std::move(other.metric);
+    statistics = other.statistics;
 
     // Clear information from the other.
     other.referenceSet = nullptr;
@@ -275,6 +283,7 @@ FastMKS<KernelType, MatType, TreeType>::operator=(FastMKS&& other)
     other.setOwner = false;
     other.singleMode = false;
     other.naive = false;
+    other.statistics.Reset();
   }
   return *this;
 }
@@ -447,6 +456,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   }
 
   Timer::Start("computing_products");
+  statistics.Reset();
 
   // No remapping will be necessary because we are using the cover tree.
   indices.set_size(k, querySet.n_cols);
@@ -455,40 +465,17 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, false, k, indices, kernels);
 
+    statistics.BaseCases() = querySet.n_cols * referenceSet->n_cols;
     Timer::Stop("computing_products");
 
     return;
   }
 
-  // Single-tree implementation.
+  // Single-tree implementation.  The rules store the last kernel value of each
+  // reference node in its statistic during single-tree traversals, so the
+  // query points can't be split between threads.
   if (singleMode)
   {
     // Create rules object (this will store the results).  This constructor
@@ -501,8 +488,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     for (size_t i = 0; i < querySet.n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    statistics.Add(rules, traverser);
+    Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
     rules.GetResults(indices, kernels);
 
@@ -562,12 +549,9 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   typedef FastMKSRules<KernelType, Tree> RuleType;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
-
-  Log::Info << rules.BaseCases() << " base cases." << std::endl;
-  Log::Info << rules.Scores() << " scores." << std::endl;
+  statistics.Reset();
+  DualTreeTraversal(*queryTree, rules);
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   rules.GetResults(indices, kernels);
 
@@ -586,43 +570,16 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 {
   // No remapping will be necessary because we are using the cover tree.
   Timer::Start("computing_products");
+  statistics.Reset();
   indices.set_size(k, referenceSet->n_cols);
   kernels.set_size(k, referenceSet->n_cols);
 
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
-
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(*referenceSet, true, k, indices, kernels);
 
+    statistics.BaseCases() = referenceSet->n_cols * (referenceSet->n_cols - 1);
     Timer::Stop("computing_products");
 
     return;
@@ -641,13 +598,8 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
       traverser.Traverse(i, *referenceTree);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
-
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    statistics.Add(rules, traverser);
+    Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
     rules.GetResults(indices, kernels);
 
@@ -661,6 +613,123 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   Search(referenceTree, k, indices, kernels);
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // Dual-tree traversals only modify the statistics of the query nodes, so the
+  // traversals of disjoint query subtrees are independent.
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Use a few more tasks than threads so that the load can be balanced.
+    std::vector<Tree*> querySubtrees;
+    tree::QuerySubtrees(queryTree, 4 * numThreads, querySubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+    {
+      RuleType taskRules(rules);
+      typename Tree::template DualTreeTraverser<RuleType> traverser(taskRules);
+      traverser.Traverse(*querySubtrees[i], *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(taskRules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+
+    return;
+  }
+#endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+  statistics.Add(rules, traverser);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const bool sameSet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels)
+{
+  // Stupid, slow, but a good benchmark.  The kernel matrix is computed in
+  // blocks, so that kernels with a block evaluation (see KernelTraits) use
+  // matrix products; the candidate lists of the query points of a block are
+  // only updated by the thread that handles the block.
+  const size_t queryBlockSize = 64;
+  const size_t referenceBlockSize = 1024;
+  const size_t numQueryBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numQueryBlocks; ++b)
+  {
+    const size_t queryBegin = b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) querySet.n_cols) - 1;
+    const MatType queryBlock = querySet.cols(queryBegin, queryEnd);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues;
+    for (size_t q = queryBegin; q <= queryEnd; ++q)
+      pqueues.push_back(CandidateList(CandidateCmp(),
+          std::vector<Candidate>(k, def)));
+
+    arma::Mat<typename MatType::elem_type> blockKernels;
+    for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+         refBegin += referenceBlockSize)
+    {
+      const size_t refEnd = std::min(refBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols) - 1;
+      const MatType referenceBlock = referenceSet->cols(refBegin, refEnd);
+      kernel::KernelMatrix(metric.Kernel(), queryBlock, referenceBlock,
+          blockKernels);
+
+      for (size_t r = 0; r < blockKernels.n_cols; ++r)
+      {
+        for (size_t q = 0; q < blockKernels.n_rows; ++q)
+        {
+          // Don't return a point as its own candidate.
+          if (sameSet && queryBegin + q == refBegin + r)
+            continue;
+
+          const double eval = blockKernels(q, r);
+          if (eval > pqueues[q].top().first)
+          {
+            pqueues[q].pop();
+            pqueues[q].push(std::make_pair(eval, refBegin + r));
+          }
+        }
+      }
+    }
+
+    for (size_t q = 0; q < pqueues.size(); ++q)
+    {
+      for (size_t j = 1; j <= k; ++j)
+      {
+        indices(k - j, queryBegin + q) = pqueues[q].top().second;
+        kernels(k - j, queryBegin + q) = pqueues[q].top().first;
+        pqueues[q].pop();
+      }
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
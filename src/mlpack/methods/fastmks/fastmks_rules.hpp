@@ -48,6 +48,19 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that shares the candidate lists and the
+   * cached self-kernels of the given FastMKSRules object, but has its own base
+   * case cache, traversal information and statistics.  This is meant for
+   * parallel dual-tree traversals, where each thread uses its own rules object
+   * on a disjoint set of query points; two threads must never work on the same
+   * query point.  Call GetResults() on the original object once all traversals
+   * are done.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  FastMKSRules(FastMKSRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -152,16 +165,25 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
+  //! Storage for the candidates of each point; this is empty if the candidate
+  //! lists are shared with another rules object.
+  std::vector<CandidateList> ownCandidates;
   //! Set of candidates for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of points to search for.
   const size_t k;
 
+  //! Storage for the query set self-kernels; this is empty if they are shared
+  //! with another rules object.
+  arma::vec ownQueryKernels;
   //! Cached query set self-kernels (|| q || for each q).
-  arma::vec queryKernels;
+  arma::vec& queryKernels;
+  //! Storage for the reference set self-kernels; this is empty if they are
+  //! shared with another rules object.
+  arma::vec ownReferenceKernels;
   //! Cached reference set self-kernels (|| r || for each r).
-  arma::vec referenceKernels;
+  arma::vec& referenceKernels;
 
   //! The instantiated kernel.
   KernelType& kernel;
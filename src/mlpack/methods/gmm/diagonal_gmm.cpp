@@ -175,21 +175,27 @@ arma::vec DiagonalGMM::Random() const
 void DiagonalGMM::Classify(const arma::mat& observations,
                            arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  // Compute the log-probability of all observations under each component at
+  // once; we have to use LogProbability() otherwise Probability() would
+  // overflow easily.
+  arma::mat logProbs(observations.n_cols, gaussians);
+  for (size_t j = 0; j < gaussians; ++j)
+  {
+    arma::vec alias(logProbs.colptr(j), logProbs.n_rows, false, true);
+    dists[j].LogProbability(observations, alias);
+    alias += log(weights[j]);
+  }
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
+  // Now find the maximum probability component of each observation.
   labels.set_size(observations.n_cols);
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
+    double probability = -std::numeric_limits<double>::infinity();
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(i, j) >= probability)
       {
-        probability = newProb;
+        probability = logProbs(i, j);
         labels[i] = j;
       }
     }
@@ -131,14 +131,13 @@ class EMFit
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
 
- private:
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
-   * This is a helper function for both overloads of Estimate().  The vectors
-   * must be already set to the number of clusters.
+   * This is a helper function for both overloads of Estimate(), and is also
+   * used by other fitters to get their initial model.  The vectors must be
+   * already set to the number of clusters.
    *
    * @param observations List of observations.
-   * @param means Vector to store means in.
    * @param dists Distributions to store model in.
    * @param weights Vector to store a priori weights in.
    */
@@ -147,20 +146,59 @@ class EMFit
       std::vector<Distribution>& dists,
       arma::vec& weights);
 
+ private:
+
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Compute the log-probability of each observation under each Gaussian,
+   * normalized so that each row of condLogProb holds the log-probability of
+   * the observation being from each Gaussian.  The observations are processed
+   * in parallel, in blocks.  The log-likelihood of the model is obtained as a
+   * byproduct, so it isn't computed separately to check convergence.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
-   * @param weights Vector of a priori weights.
+   * @param observations List of observations.
+   * @param dists Distributions of the model.
+   * @param weights A priori weights of the model.
+   * @param condLogProb Matrix to store the conditional log-probabilities in
+   *     (one row for each observation).
+   * @return The log-likelihood of the model.
+   */
+  double ExpectationStep(const arma::mat& observations,
+                         const std::vector<Distribution>& dists,
+                         const arma::vec& weights,
+                         arma::mat& condLogProb) const;
+
+  /**
+   * Update the means and covariances of the Gaussians, in parallel, from the
+   * conditional log-probabilities of the observations.
+   *
+   * @param observations List of observations.
+   * @param condLogProb Conditional log-probabilities of the observations.
+   * @param probRowSums Log of the sum of each column of condLogProb.
+   * @param dists Distributions to update.
    */
-  double LogLikelihood(
-      const arma::mat& data,
-      const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+  void MaximizationStep(const arma::mat& observations,
+                        const arma::mat& condLogProb,
+                        const arma::vec& probRowSums,
+                        std::vector<Distribution>& dists);
+
+  //! Add the weighted covariance of a block of centered observations.
+  static void AccumulateCovariance(const arma::mat& centered,
+                                   const arma::mat& weighted,
+                                   arma::mat& covariance)
+  {
+    covariance += centered * weighted.t();
+  }
+
+  //! Add the weighted diagonal covariance of a block of centered observations.
+  static void AccumulateCovariance(const arma::mat& centered,
+                                   const arma::mat& weighted,
+                                   arma::vec& covariance)
+  {
+    covariance += arma::sum(centered % weighted, 1);
+  }
+
+  //! The number of observations processed at once by the E-step and M-step.
+  static constexpr size_t blockSize = 1024;
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
@@ -21,6 +21,12 @@
 namespace mlpack {
 namespace gmm {
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+constexpr size_t EMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::blockSize;
+
 //! Constructor.
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
@@ -71,13 +77,15 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step also gives the log-likelihood of the model, so the
+  // log-likelihood isn't computed separately.
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ExpectationStep(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -86,73 +94,15 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
       probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
 
-    // Calculate the new value of the means using the updated conditional
+    // Calculate the new means and covariances using the updated conditional
     // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    MaximizationStep(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -160,7 +110,7 @@ Estimate(const arma::mat& observations,
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -179,93 +129,33 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::mat condLogProb(observations.n_cols, dists.size());
+  double l = ExpectationStep(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const arma::vec logProbabilities = arma::log(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    // Weight the conditional probability of each point being from each
+    // Gaussian by the probability of the point being from this mixture model.
+    condLogProb.each_col() += logProbabilities;
 
     // This will store the sum of probabilities of each state over all the
     // observations.
     arma::vec probRowSums(dists.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
 
-    // Calculate the new value of the means using the updated conditional
+    // Calculate the new means and covariances using the updated conditional
     // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
+    MaximizationStep(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -273,7 +163,7 @@ Estimate(const arma::mat& observations,
 
     // Update values of l; calculate new log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = ExpectationStep(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -377,36 +267,129 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+ExpectationStep(const arma::mat& observations,
+                const std::vector<Distribution>& dists,
+                const arma::vec& weights,
+                arma::mat& condLogProb) const
 {
-  double logLikelihood = 0;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
-
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
+  // Compute the log-probability of each block of observations under each
+  // Gaussian; the (Gaussian, block) pairs are independent.  The blocks are
+  // aliases of the observations, so no observation is copied.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) (dists.size() * numBlocks); ++t)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
+    const size_t i = t % dists.size();
+    const size_t begin = (t / dists.size()) * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) observations.n_cols);
+
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, end - begin, false, true);
+    arma::vec logProbs;
+    dists[i].LogProbability(block, logProbs);
+    condLogProb(arma::span(begin, end - 1), i) = logProbs + std::log(weights[i]);
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  // Normalize each row with a log-sum-exp over a block of rows at a time, so
+  // that the rows are read with unit stride.  The log-likelihood of the model
+  // is the sum of the normalizers.
+  double logLikelihood = 0.0;
+  #pragma omp parallel for reduction(+:logLikelihood) schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) observations.n_cols);
+
+    arma::mat blockProbs = condLogProb.rows(begin, end - 1);
+    arma::vec maxProbs = arma::max(blockProbs, 1);
+
+    // If the probability of a point is 0 for every Gaussian, shifting by 0
+    // gives a sum of -inf, and the row is left as it is.
+    maxProbs.replace(-std::numeric_limits<double>::infinity(), 0.0);
+    const arma::vec probSums = maxProbs + arma::log(arma::sum(arma::exp(
+        blockProbs.each_col() - maxProbs), 1));
+
+    for (size_t j = 0; j < probSums.n_elem; ++j)
     {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
+      if (probSums[j] == -std::numeric_limits<double>::infinity())
+      {
+        #pragma omp critical
+        {
+          Log::Info << "Likelihood of point " << begin + j << " is 0!  It is "
+              << "probably an outlier." << std::endl;
+        }
+        logLikelihood += probSums[j];
+        continue;
+      }
+
+      blockProbs.row(j) -= probSums[j];
+      logLikelihood += probSums[j];
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
+
+    condLogProb.rows(begin, end - 1) = blockProbs;
   }
 
   return logLikelihood;
 }
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+MaximizationStep(const arma::mat& observations,
+                 const arma::mat& condLogProb,
+                 const arma::vec& probRowSums,
+                 std::vector<Distribution>& dists)
+{
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  // The Gaussians are independent, so they are updated in parallel.  The sums
+  // are accumulated over blocks of observations, so that only one block of
+  // centered observations is held by each thread.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] == -std::numeric_limits<double>::infinity())
+      continue;
+
+    const arma::vec probs = arma::exp(condLogProb.col(i) - probRowSums[i]);
+
+    // Calculate the new value of the means using the updated conditional
+    // probabilities.
+    dists[i].Mean() = observations * probs;
+
+    // Calculate the new value of the covariances using the updated
+    // conditional probabilities and the updated means.  If the distribution is
+    // DiagonalGaussianDistribution, calculate the covariance only with
+    // diagonal components.
+    typename std::conditional<isDiagGaussDist, arma::vec, arma::mat>::type
+        covariance;
+    if (isDiagGaussDist)
+      covariance.zeros(observations.n_rows);
+    else
+      covariance.zeros(observations.n_rows, observations.n_rows);
+
+    for (size_t begin = 0; begin < observations.n_cols; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols);
+      const arma::mat tmp = observations.cols(begin, end - 1).each_col() -
+          dists[i].Mean();
+      const arma::mat tmpB = tmp.each_row() %
+          probs.subvec(begin, end - 1).t();
+
+      AccumulateCovariance(tmp, tmpB, covariance);
+    }
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+}
+
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
@@ -0,0 +1,264 @@
+/**
+ * @file methods/gmm/kdtree_em_fit.hpp
+ *
+ * Utility class to fit a GMM with EM, using a kd-tree to prune the components
+ * that have a negligible responsibility for whole nodes of points.  Used by
+ * GMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_KDTREE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_KDTREE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the EM algorithm like EMFit, but
+ * the E-step only computes the responsibilities that aren't negligible, which
+ * are stored in a sparse matrix.  A kd-tree is built on the observations; for
+ * each node of the tree and each Gaussian, the Mahalanobis distance of the
+ * points of the node to the mean is bounded with the distance from the mean to
+ * the bounding box of the node and the extreme eigenvalues of the covariance.
+ * This bounds the weighted density of every point of the node under each
+ * Gaussian, and a Gaussian is pruned for the whole node when its responsibility
+ * for every point of the node is bounded by pruneTolerance.  The densities are
+ * only computed, and the responsibilities only stored, for the Gaussians that
+ * remain in the leaves (or in the nodes where a single Gaussian is left).
+ *
+ * So for well-separated Gaussians, the E-step takes much less time than O(nk)
+ * density evaluations and much less memory than the n x k matrix of EMFit, and
+ * the M-step only visits the stored responsibilities.  The responsibilities of
+ * pruned Gaussians are taken to be 0, so the model is approximate; with a
+ * pruneTolerance of 0, nothing is pruned and the result is the one of EMFit.
+ *
+ * The leaves are processed in parallel, and the Gaussians are updated in
+ * parallel, when OpenMP is available.
+ *
+ * @code
+ * GMM gmm(10, data.n_rows);
+ * gmm.Train(data, 1, false, KDTreeEMFit<>(300, 1e-10, 1e-5));
+ * @endcode
+ *
+ * @tparam InitialClusteringType The type of clustering used for the initial
+ *     model.
+ * @tparam CovarianceConstraintPolicy The constraint on the covariances.
+ * @tparam Distribution The type of the Gaussians of the model.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class KDTreeEMFit
+{
+ public:
+  /**
+   * Construct the KDTreeEMFit object.  Setting the maximum number of
+   * iterations to 0 means that the EM algorithm will iterate until convergence
+   * (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param pruneTolerance Responsibility below which a Gaussian is pruned for
+   *     a node; must be in [0, 1).
+   * @param leafSize Maximum number of points in a leaf of the kd-tree.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  KDTreeEMFit(const size_t maxIterations = 300,
+              const double tolerance = 1e-10,
+              const double pruneTolerance = 1e-5,
+              const size_t leafSize = 64,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a GMM with tree-pruned EM.  The size of the
+   * vectors (indicating the number of components) must already be set.  If
+   * useInitialModel is true, the given model is used as the initial model;
+   * otherwise, it is given by the initial clustering of EMFit.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a GMM with tree-pruned EM, taking into account the
+   * probability of each observation being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the number of responsibilities stored by the last E-step.
+  size_t NumResponsibilities() const { return numResponsibilities; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the responsibility below which a Gaussian is pruned.
+  double PruneTolerance() const { return pruneTolerance; }
+  //! Modify the responsibility below which a Gaussian is pruned.
+  double& PruneTolerance() { return pruneTolerance; }
+
+  //! Get the maximum number of points in a leaf of the kd-tree.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum number of points in a leaf of the kd-tree.
+  size_t& LeafSize() { return leafSize; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! The type of the kd-tree on the observations.
+  typedef tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic,
+      arma::mat> TreeType;
+
+  //! The type of the covariance of a Gaussian (a vector for diagonal ones).
+  typedef typename std::conditional<std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  //! Run EM on the observations, weighted by the given probabilities if they
+  //! are not NULL.
+  void Fit(const arma::mat& observations,
+           const arma::vec* probabilities,
+           std::vector<Distribution>& dists,
+           arma::vec& weights,
+           const bool useInitialModel);
+
+  /**
+   * Compute the responsibilities that aren't pruned, weighted by the
+   * probabilities of the observations if they are not NULL.  The rows of the
+   * responsibilities are the observations (in their original order) and the
+   * columns are the Gaussians.
+   *
+   * @return The log-likelihood of the model.
+   */
+  double ExpectationStep(const TreeType& tree,
+                         const std::vector<size_t>& oldFromNew,
+                         const arma::vec* probabilities,
+                         const std::vector<Distribution>& dists,
+                         const arma::vec& weights,
+                         arma::sp_mat& responsibilities);
+
+  /**
+   * Update the Gaussians and their weights, in parallel, from the stored
+   * responsibilities.
+   */
+  void MaximizationStep(const arma::mat& observations,
+                        const arma::sp_mat& responsibilities,
+                        const double totalWeight,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights);
+
+  /**
+   * Prune the given Gaussians for the given node, and either recurse into the
+   * children or add the node and the remaining Gaussians to the list of nodes
+   * whose responsibilities are computed.
+   */
+  void CollectNodes(
+      const TreeType& node,
+      const std::vector<size_t>& candidates,
+      const std::vector<Distribution>& dists,
+      const arma::vec& logConstants,
+      const arma::vec& minEigenvalues,
+      const arma::vec& maxEigenvalues,
+      std::vector<std::pair<const TreeType*, std::vector<size_t>>>& nodes)
+      const;
+
+  //! Get the eigenvalues of a full covariance.
+  static arma::vec Eigenvalues(const arma::mat& covariance)
+  {
+    return arma::eig_sym(covariance);
+  }
+
+  //! Get the eigenvalues of a diagonal covariance.
+  static arma::vec Eigenvalues(const arma::vec& covariance)
+  {
+    return covariance;
+  }
+
+  //! Add the weighted covariance of a block of centered observations.
+  static void AccumulateCovariance(const arma::mat& centered,
+                                   const arma::mat& weighted,
+                                   arma::mat& covariance)
+  {
+    covariance += centered * weighted.t();
+  }
+
+  //! Add the weighted diagonal covariance of a block of centered observations.
+  static void AccumulateCovariance(const arma::mat& centered,
+                                   const arma::mat& weighted,
+                                   arma::vec& covariance)
+  {
+    covariance += arma::sum(centered % weighted, 1);
+  }
+
+  //! The number of observations processed at once by the M-step.
+  static constexpr size_t blockSize = 1024;
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Responsibility below which a Gaussian is pruned for a node.
+  double pruneTolerance;
+  //! Maximum number of points in a leaf of the kd-tree.
+  size_t leafSize;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+  //! The number of responsibilities stored by the last E-step.
+  size_t numResponsibilities;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "kdtree_em_fit_impl.hpp"
+
+#endif
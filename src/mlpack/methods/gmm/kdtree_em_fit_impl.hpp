@@ -0,0 +1,398 @@
+/**
+ * @file methods/gmm/kdtree_em_fit_impl.hpp
+ *
+ * Implementation of tree-pruned EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_KDTREE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_KDTREE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kdtree_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+constexpr size_t KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::blockSize;
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+KDTreeEMFit(const size_t maxIterations,
+            const double tolerance,
+            const double pruneTolerance,
+            const size_t leafSize,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    pruneTolerance(pruneTolerance),
+    leafSize(leafSize),
+    clusterer(clusterer),
+    constraint(constraint),
+    numResponsibilities(0)
+{
+  if (pruneTolerance < 0.0 || pruneTolerance >= 1.0)
+  {
+    throw std::invalid_argument("KDTreeEMFit::KDTreeEMFit(): pruneTolerance "
+        "must be in [0, 1)!");
+  }
+
+  if (leafSize == 0)
+  {
+    throw std::invalid_argument("KDTreeEMFit::KDTreeEMFit(): the leaf size "
+        "must be positive!");
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Fit(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Fit(observations, &probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Fit(const arma::mat& observations,
+                       const arma::vec* probabilities,
+                       std::vector<Distribution>& dists,
+                       arma::vec& weights,
+                       const bool useInitialModel)
+{
+  if (!useInitialModel)
+  {
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        emFit(maxIterations, tolerance, clusterer, constraint);
+    emFit.InitialClustering(observations, dists, weights);
+  }
+
+  // The tree holds a reordered copy of the observations, so that the points of
+  // each node are contiguous.
+  std::vector<size_t> oldFromNew;
+  TreeType tree(observations, oldFromNew, leafSize);
+
+  const double totalWeight = (probabilities == NULL) ?
+      (double) observations.n_cols : arma::accu(*probabilities);
+
+  arma::sp_mat responsibilities;
+  double l = ExpectationStep(tree, oldFromNew, probabilities, dists, weights,
+      responsibilities);
+
+  Log::Debug << "KDTreeEMFit::Estimate(): initial clustering log-likelihood: "
+      << l << std::endl;
+
+  double lOld = -DBL_MAX;
+
+  // Iterate to update the model until no more improvement is found.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    Log::Info << "KDTreeEMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << ", " << responsibilities.n_nonzero
+        << " responsibilities." << std::endl;
+
+    MaximizationStep(observations, responsibilities, totalWeight, dists,
+        weights);
+
+    lOld = l;
+    l = ExpectationStep(tree, oldFromNew, probabilities, dists, weights,
+        responsibilities);
+
+    iteration++;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::ExpectationStep(const TreeType& tree,
+                                   const std::vector<size_t>& oldFromNew,
+                                   const arma::vec* probabilities,
+                                   const std::vector<Distribution>& dists,
+                                   const arma::vec& weights,
+                                   arma::sp_mat& responsibilities)
+{
+  const arma::mat& dataset = tree.Dataset();
+
+  // The log of the weighted normalizing constant of each Gaussian, and the
+  // extreme eigenvalues of its covariance, which bound the Mahalanobis
+  // distance with the Euclidean distance.  Gaussians with no weight can't
+  // have any points.
+  const size_t dimensionality = dataset.n_rows;
+  arma::vec logConstants(dists.size()), minEigenvalues(dists.size()),
+      maxEigenvalues(dists.size());
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec eigenvalues = Eigenvalues(dists[i].Covariance());
+    minEigenvalues[i] = eigenvalues.min();
+    maxEigenvalues[i] = eigenvalues.max();
+    logConstants[i] = std::log(weights[i]) - 0.5 * (dimensionality *
+        std::log(2.0 * M_PI) + arma::accu(arma::log(eigenvalues)));
+
+    if (weights[i] > 0.0)
+      candidates.push_back(i);
+  }
+
+  std::vector<std::pair<const TreeType*, std::vector<size_t>>> nodes;
+  CollectNodes(tree, candidates, dists, logConstants, minEigenvalues,
+      maxEigenvalues, nodes);
+
+  // Compute the responsibilities for the points of each node, in parallel;
+  // each thread collects its responsibilities separately.
+  std::vector<arma::uword> rows, cols;
+  std::vector<double> values;
+  double logLikelihood = 0.0;
+  #pragma omp parallel
+  {
+    std::vector<arma::uword> localRows, localCols;
+    std::vector<double> localValues;
+    double localLogLikelihood = 0.0;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t n = 0; n < (omp_size_t) nodes.size(); ++n)
+    {
+      const TreeType& node = *nodes[n].first;
+      const std::vector<size_t>& nodeCandidates = nodes[n].second;
+      const size_t begin = node.Begin();
+
+      // The points of the node are an alias of the dataset of the tree.
+      const arma::mat block(const_cast<double*>(dataset.colptr(begin)),
+          dimensionality, node.Count(), false, true);
+      arma::mat logProbs(node.Count(), nodeCandidates.size());
+      arma::vec componentLogProbs;
+      for (size_t c = 0; c < nodeCandidates.size(); ++c)
+      {
+        dists[nodeCandidates[c]].LogProbability(block, componentLogProbs);
+        logProbs.col(c) = componentLogProbs +
+            std::log(weights[nodeCandidates[c]]);
+      }
+
+      for (size_t p = 0; p < node.Count(); ++p)
+      {
+        const arma::rowvec pointLogProbs = logProbs.row(p);
+        const double maxLogProb = pointLogProbs.max();
+        if (maxLogProb == -std::numeric_limits<double>::infinity())
+        {
+          #pragma omp critical
+          {
+            Log::Info << "Likelihood of point " << oldFromNew[begin + p]
+                << " is 0!  It is probably an outlier." << std::endl;
+          }
+          localLogLikelihood += maxLogProb;
+          continue;
+        }
+
+        const double logSum = maxLogProb + std::log(arma::accu(arma::exp(
+            pointLogProbs - maxLogProb)));
+        localLogLikelihood += logSum;
+
+        const size_t point = oldFromNew[begin + p];
+        const double scale = (probabilities == NULL) ? 1.0 :
+            (*probabilities)[point];
+        for (size_t c = 0; c < nodeCandidates.size(); ++c)
+        {
+          const double r = scale * std::exp(pointLogProbs[c] - logSum);
+          if (r > 0.0)
+          {
+            localRows.push_back(point);
+            localCols.push_back(nodeCandidates[c]);
+            localValues.push_back(r);
+          }
+        }
+      }
+    }
+
+    #pragma omp critical
+    {
+      rows.insert(rows.end(), localRows.begin(), localRows.end());
+      cols.insert(cols.end(), localCols.begin(), localCols.end());
+      values.insert(values.end(), localValues.begin(), localValues.end());
+      logLikelihood += localLogLikelihood;
+    }
+  }
+
+  arma::umat locations(2, values.size());
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    locations(0, i) = rows[i];
+    locations(1, i) = cols[i];
+  }
+  responsibilities = arma::sp_mat(locations, arma::vec(values), dataset.n_cols,
+      dists.size(), true, false);
+  numResponsibilities = values.size();
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::CollectNodes(
+    const TreeType& node,
+    const std::vector<size_t>& candidates,
+    const std::vector<Distribution>& dists,
+    const arma::vec& logConstants,
+    const arma::vec& minEigenvalues,
+    const arma::vec& maxEigenvalues,
+    std::vector<std::pair<const TreeType*, std::vector<size_t>>>& nodes) const
+{
+  // Bound the weighted log-density of the points of the node under each
+  // Gaussian.  The responsibility of a Gaussian is at most its largest
+  // weighted density, divided by the largest smallest weighted density of
+  // all the Gaussians.
+  std::vector<double> upperBounds(candidates.size());
+  double maxLowerBound = -DBL_MAX;
+  for (size_t c = 0; c < candidates.size(); ++c)
+  {
+    const size_t i = candidates[c];
+    const double minDistance = node.Bound().MinDistance(dists[i].Mean());
+    const double maxDistance = node.Bound().MaxDistance(dists[i].Mean());
+
+    upperBounds[c] = logConstants[i] - 0.5 * minDistance * minDistance /
+        maxEigenvalues[i];
+    const double lowerBound = logConstants[i] - 0.5 * maxDistance *
+        maxDistance / minEigenvalues[i];
+    maxLowerBound = std::max(maxLowerBound, lowerBound);
+  }
+
+  // The Gaussian with the largest lower bound is never pruned.  With a
+  // tolerance of 0, nothing is pruned.
+  const double logTolerance = std::log(pruneTolerance);
+  std::vector<size_t> remaining;
+  for (size_t c = 0; c < candidates.size(); ++c)
+    if (upperBounds[c] - maxLowerBound >= logTolerance)
+      remaining.push_back(candidates[c]);
+
+  if (remaining.size() <= 1 || node.IsLeaf())
+  {
+    nodes.push_back(std::make_pair(&node, std::move(remaining)));
+    return;
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    CollectNodes(node.Child(i), remaining, dists, logConstants,
+        minEigenvalues, maxEigenvalues, nodes);
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::MaximizationStep(const arma::mat& observations,
+                                    const arma::sp_mat& responsibilities,
+                                    const double totalWeight,
+                                    std::vector<Distribution>& dists,
+                                    arma::vec& weights)
+{
+  // The Gaussians are independent, so they are updated in parallel.  Only the
+  // stored responsibilities of each Gaussian are visited, a block of points at
+  // a time.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    const size_t count = responsibilities.col_ptrs[i + 1] -
+        responsibilities.col_ptrs[i];
+    arma::uvec points(count);
+    arma::vec probs(count);
+    size_t j = 0;
+    for (arma::sp_mat::const_iterator it = responsibilities.begin_col(i);
+         it != responsibilities.end_col(i); ++it, ++j)
+    {
+      points[j] = it.row();
+      probs[j] = (*it);
+    }
+
+    // Don't update if there's no probability of the Gaussian having points.
+    const double weight = arma::accu(probs);
+    weights[i] = weight / totalWeight;
+    if (weight == 0.0)
+      continue;
+    probs /= weight;
+
+    arma::vec mean(observations.n_rows, arma::fill::zeros);
+    for (size_t begin = 0; begin < count; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize, count);
+      mean += observations.cols(points.subvec(begin, end - 1)) *
+          probs.subvec(begin, end - 1);
+    }
+
+    CovarianceType covariance;
+    if (std::is_same<CovarianceType, arma::vec>::value)
+      covariance.zeros(observations.n_rows);
+    else
+      covariance.zeros(observations.n_rows, observations.n_rows);
+
+    for (size_t begin = 0; begin < count; begin += blockSize)
+    {
+      const size_t end = std::min(begin + blockSize, count);
+      const arma::mat block = observations.cols(points.subvec(begin,
+          end - 1));
+      const arma::mat tmp = block.each_col() - mean;
+      const arma::mat tmpB = tmp.each_row() %
+          probs.subvec(begin, end - 1).t();
+
+      AccumulateCovariance(tmp, tmpB, covariance);
+    }
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Mean() = std::move(mean);
+    dists[i].Covariance(std::move(covariance));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void KDTreeEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(pruneTolerance));
+  ar(CEREAL_NVP(leafSize));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
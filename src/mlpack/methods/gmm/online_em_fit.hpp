@@ -0,0 +1,291 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with online (stochastic) EM, from mini-batches of
+ * observations.  Used by GMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with online EM (Cappe and Moulines,
+ * 2009).  Instead of running the E-step over the whole dataset, it keeps a
+ * running average of the sufficient statistics of each Gaussian (its weight,
+ * the weighted sum of its points and the weighted sum of their outer
+ * products).  For each mini-batch, the statistics of the batch are computed
+ * under the current model, and the running average moves towards them with the
+ * step size (t + stepOffset)^-stepExponent, where t is the number of batches
+ * seen so far.  The parameters of the model are then computed from the
+ * statistics.  So the memory that's needed doesn't depend on the number of
+ * observations.
+ *
+ * The class can be used as the FittingType of GMM::Train(), in which case it
+ * makes the given number of passes over the observations, in random order.
+ * Unless an initial model is used, the model is initialized with EMFit on the
+ * first mini-batch.  For observations that arrive as a stream, Update() can be
+ * given each mini-batch directly.
+ *
+ * @code
+ * // Fit an initial model on the first observations.
+ * std::vector<distribution::GaussianDistribution> dists(10,
+ *     distribution::GaussianDistribution(dimensionality));
+ * arma::vec weights(10);
+ * EMFit<> emFit;
+ * emFit.Estimate(firstBatch, dists, weights);
+ *
+ * OnlineEMFit<> fitter;
+ * while (ReadNextBatch(batch))
+ *   fitter.Update(batch, dists, weights);
+ *
+ * GMM gmm(dists, weights);
+ * @endcode
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data
+ *       models},
+ *   author={Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal={Journal of the Royal Statistical Society: Series B (Statistical
+ *       Methodology)},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * @tparam InitialClusteringType Clustering used by EMFit for the initial model.
+ * @tparam CovarianceConstraintPolicy Constraint applied to the covariances.
+ * @tparam Distribution Type of the Gaussians.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  The step size for the t'th batch is
+   * (t + stepOffset)^-stepExponent; stepExponent must be in (0.5, 1] for the
+   * statistics to converge.
+   *
+   * @param batchSize Number of observations in each mini-batch.
+   * @param passes Number of passes over the observations made by Estimate().
+   * @param stepExponent Exponent of the decay of the step size.
+   * @param stepOffset Offset of the decay of the step size.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t passes = 3,
+              const double stepExponent = 0.6,
+              const double stepOffset = 2.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a GMM with online EM.  The size of the vectors
+   * (indicating the number of components) must already be set.  If
+   * useInitialModel is true, the given model is used as the initial model;
+   * otherwise, the initial model is fitted with EMFit on the first mini-batch.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a GMM with online EM, taking into account the
+   * probability of each observation being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     model.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with one mini-batch of observations.  The first time
+   * this is called (or after Reset()), the statistics are initialized from the
+   * given model.
+   *
+   * @param batch Observations of the mini-batch.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Update(const arma::mat& batch,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Update the model with one mini-batch of observations, each with the given
+   * probability of being from this mixture.
+   *
+   * @param batch Observations of the mini-batch.
+   * @param probabilities Probability of each observation of the batch.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Update(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Forget the statistics, so that the next Update() starts from the model.
+  void Reset() { steps = 0; }
+
+  //! Get the number of mini-batches seen since the statistics were reset.
+  size_t Steps() const { return steps; }
+
+  //! Get the number of observations in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of passes over the observations made by Estimate().
+  size_t Passes() const { return passes; }
+  //! Modify the number of passes over the observations made by Estimate().
+  size_t& Passes() { return passes; }
+
+  //! Get the exponent of the decay of the step size.
+  double StepExponent() const { return stepExponent; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepExponent() { return stepExponent; }
+
+  //! Get the offset of the decay of the step size.
+  double StepOffset() const { return stepOffset; }
+  //! Modify the offset of the decay of the step size.
+  double& StepOffset() { return stepOffset; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! The type of the covariance of a Gaussian (a vector for diagonal ones).
+  typedef typename std::conditional<std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value, arma::vec,
+      arma::mat>::type CovarianceType;
+
+  //! Run the given number of passes over the observations, in random order.
+  void RunPasses(const arma::mat& observations,
+                 const arma::vec* probabilities,
+                 std::vector<Distribution>& dists,
+                 arma::vec& weights);
+
+  //! Set the statistics to those of the given model.
+  void InitializeStatistics(const std::vector<Distribution>& dists,
+                            const arma::vec& weights);
+
+  //! Set the second moment of a Gaussian from its mean and covariance.
+  static void SecondMoment(const arma::vec& mean,
+                           const arma::mat& covariance,
+                           arma::mat& moment)
+  {
+    moment = covariance + mean * mean.t();
+  }
+
+  //! Set the second moment of a diagonal Gaussian from its mean and
+  //! covariance.
+  static void SecondMoment(const arma::vec& mean,
+                           const arma::vec& covariance,
+                           arma::vec& moment)
+  {
+    moment = covariance + mean % mean;
+  }
+
+  //! Compute the weighted second moment of a batch.
+  static void BatchMoment(const arma::mat& batch,
+                          const arma::mat& weighted,
+                          arma::mat& moment)
+  {
+    moment = weighted * batch.t();
+  }
+
+  //! Compute the weighted diagonal second moment of a batch.
+  static void BatchMoment(const arma::mat& batch,
+                          const arma::mat& weighted,
+                          arma::vec& moment)
+  {
+    moment = arma::sum(weighted % batch, 1);
+  }
+
+  //! Subtract the outer product of the mean from a second moment.
+  static void CenterMoment(const arma::vec& mean, arma::mat& moment)
+  {
+    moment -= mean * mean.t();
+  }
+
+  //! Subtract the squared mean from a diagonal second moment.
+  static void CenterMoment(const arma::vec& mean, arma::vec& moment)
+  {
+    moment -= mean % mean;
+  }
+
+  //! Number of observations in each mini-batch.
+  size_t batchSize;
+  //! Number of passes over the observations made by Estimate().
+  size_t passes;
+  //! Exponent of the decay of the step size.
+  double stepExponent;
+  //! Offset of the decay of the step size.
+  double stepOffset;
+  //! Object which will perform the initial clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of mini-batches seen since the statistics were reset.
+  size_t steps;
+  //! Running average of the weight of each Gaussian.
+  arma::vec weightStatistics;
+  //! Running average of the weighted sum of the points of each Gaussian.
+  arma::mat meanStatistics;
+  //! Running average of the weighted second moment of each Gaussian.
+  std::vector<CovarianceType> momentStatistics;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
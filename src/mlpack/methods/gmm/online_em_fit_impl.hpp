@@ -0,0 +1,272 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of online EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const size_t passes,
+            const double stepExponent,
+            const double stepOffset,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    passes(passes),
+    stepExponent(stepExponent),
+    stepOffset(stepOffset),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): the batch size "
+        "must be positive!");
+  }
+
+  if (stepExponent <= 0.5 || stepExponent > 1.0)
+  {
+    Log::Warn << "OnlineEMFit::OnlineEMFit(): stepExponent is " << stepExponent
+        << ", but should be in (0.5, 1] for online EM to converge."
+        << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (!useInitialModel)
+  {
+    // Fit the initial model on the first batch, with a few iterations of EM.
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        emFit(10, 1e-5, clusterer, constraint);
+    const size_t initialPoints = std::min(batchSize, (size_t)
+        observations.n_cols);
+    emFit.Estimate(observations.cols(0, initialPoints - 1), dists, weights,
+        false);
+  }
+
+  RunPasses(observations, NULL, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (!useInitialModel)
+  {
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        emFit(10, 1e-5, clusterer, constraint);
+    const size_t initialPoints = std::min(batchSize, (size_t)
+        observations.n_cols);
+    emFit.Estimate(observations.cols(0, initialPoints - 1),
+        probabilities.subvec(0, initialPoints - 1), dists, weights, false);
+  }
+
+  RunPasses(observations, &probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  Update(batch, arma::ones<arma::vec>(batch.n_cols), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& batch,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  if (batch.n_cols == 0)
+    return;
+
+  if (probabilities.n_elem != batch.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit::Update(): the batch has " << batch.n_cols
+        << " points, but " << probabilities.n_elem << " probabilities were "
+        << "given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (steps == 0)
+    InitializeStatistics(dists, weights);
+
+  // E-step: the responsibility of each Gaussian for each point of the batch,
+  // computed in log-space.
+  arma::mat condLogProb(batch.n_cols, dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
+    dists[i].LogProbability(batch, condLogProbAlias);
+    condLogProbAlias += std::log(weights[i]);
+  }
+
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    const double logProb = math::AccuLog(condLogProb.row(j));
+    condLogProb.row(j) -= logProb;
+  }
+
+  // The responsibilities, weighted by the probability of each point, and
+  // normalized so that the statistics of the batch are averages.
+  arma::mat responsibilities = arma::exp(condLogProb);
+  responsibilities.each_col() %= probabilities;
+  const double total = arma::accu(probabilities);
+  if (total <= 0.0)
+    return;
+  responsibilities /= total;
+
+  // Move the running statistics towards the statistics of the batch.
+  ++steps;
+  const double step = std::pow((double) steps + stepOffset, -stepExponent);
+
+  weightStatistics = (1.0 - step) * weightStatistics +
+      step * arma::sum(responsibilities, 0).t();
+  meanStatistics = (1.0 - step) * meanStatistics + step * batch *
+      responsibilities;
+
+  // M-step: compute the parameters of each Gaussian from its statistics.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    arma::mat weighted = batch.each_row() % responsibilities.col(i).t();
+    CovarianceType batchMoment;
+    BatchMoment(batch, weighted, batchMoment);
+    momentStatistics[i] = (1.0 - step) * momentStatistics[i] + step *
+        batchMoment;
+
+    // A Gaussian that is responsible for almost no points keeps its previous
+    // parameters.
+    if (weightStatistics[i] <= 1e-50)
+      continue;
+
+    dists[i].Mean() = meanStatistics.col(i) / weightStatistics[i];
+
+    CovarianceType covariance = momentStatistics[i] / weightStatistics[i];
+    CenterMoment(dists[i].Mean(), covariance);
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = weightStatistics / arma::accu(weightStatistics);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::RunPasses(const arma::mat& observations,
+                             const arma::vec* probabilities,
+                             std::vector<Distribution>& dists,
+                             arma::vec& weights)
+{
+  // The statistics start from the initial model.
+  Reset();
+
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    const arma::uvec order = arma::randperm(observations.n_cols);
+    for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize,
+          (size_t) observations.n_cols) - 1;
+      const arma::uvec indices = order.subvec(begin, end);
+      if (probabilities)
+      {
+        Update(observations.cols(indices), probabilities->elem(indices), dists,
+            weights);
+      }
+      else
+      {
+        Update(observations.cols(indices), dists, weights);
+      }
+    }
+
+    Log::Info << "OnlineEMFit::Estimate(): finished pass " << (pass + 1)
+        << " of " << passes << " (" << steps << " mini-batches)." << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitializeStatistics(const std::vector<Distribution>& dists,
+                                        const arma::vec& weights)
+{
+  const size_t dimensionality = dists.empty() ? 0 : dists[0].Mean().n_elem;
+
+  weightStatistics = weights;
+  meanStatistics.set_size(dimensionality, dists.size());
+  momentStatistics.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    meanStatistics.col(i) = weights[i] * dists[i].Mean();
+    SecondMoment(dists[i].Mean(), dists[i].Covariance(), momentStatistics[i]);
+    momentStatistics[i] *= weights[i];
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(passes));
+  ar(CEREAL_NVP(stepExponent));
+  ar(CEREAL_NVP(stepOffset));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+
+  // The statistics are not saved, so a loaded fitter starts from the model it
+  // is next given.
+  if (cereal::is_loading<Archive>())
+    Reset();
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
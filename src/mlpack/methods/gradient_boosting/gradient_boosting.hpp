@@ -0,0 +1,367 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which boosts histogram-based
+ * regression trees fitted to the gradients of a loss function.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "histogram_tree_builder.hpp"
+#include "loss_functions/squared_error_loss.hpp"
+#include "loss_functions/logistic_loss.hpp"
+#include "loss_functions/softmax_loss.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The GradientBoosting class implements gradient boosted regression trees
+ * (Friedman, 2001), with the second-order (Newton) steps and the
+ * histogram-based splits of libraries such as XGBoost and LightGBM.  The model
+ * is an initial prediction plus the sum of the values given by the trees; at
+ * each iteration, one tree per output of the model is fitted to the
+ * derivatives of the loss of the current predictions, and its values are
+ * scaled by the learning rate.
+ *
+ * Before training, the values of each dimension are put into at most 256 bins
+ * (see HistogramTreeBuilder), so that the splits of a node are found from
+ * histograms of the gradients.  Each tree may be fitted to a random subset of
+ * the points (rowSampleRate) and of the dimensions (dimensionSampleRate).
+ * The histograms are built with multiple threads.  The nodes of all the trees
+ * are stored in one contiguous array, and predictions are made for blocks of
+ * points in parallel, as in FlatForest.
+ *
+ * The loss function is given by the LossType template parameter:
+ * SquaredErrorLoss for regression (use Predict()), and LogisticLoss (two
+ * classes) or SoftmaxLoss (any number of classes) for classification (use
+ * Classify()).  A LossType class must implement the following functions:
+ *
+ * @code
+ * // Return the number of outputs of the model for the given number of classes
+ * // (which is 0 for regression).
+ * static size_t NumOutputs(const size_t numClasses);
+ *
+ * // Compute the initial prediction (one value per output).
+ * static void InitialScores(const arma::rowvec& responses,
+ *                           const size_t numOutputs,
+ *                           arma::vec& scores);
+ *
+ * // Compute the first and second derivatives of the loss of each point with
+ * // respect to each of its outputs.
+ * static void Gradients(const arma::rowvec& responses,
+ *                       const arma::mat& scores,
+ *                       arma::mat& gradients,
+ *                       arma::mat& hessians);
+ *
+ * // Return the mean loss of the given predictions.
+ * static double Evaluate(const arma::rowvec& responses,
+ *                        const arma::mat& scores);
+ *
+ * // For classification only: compute the probability of each class.
+ * static void Probabilities(const arma::mat& scores,
+ *                           arma::mat& probabilities);
+ * @endcode
+ *
+ * An example of classification is shown below:
+ *
+ * @code
+ * extern arma::mat data;
+ * extern arma::Row<size_t> labels;
+ *
+ * // Train 200 trees of depth 4 on 80% of the points each.
+ * GradientBoosting<> gb(data, labels, numClasses, 200, 0.1, 4, 20, 0.0, 1.0,
+ *     0.8);
+ *
+ * arma::Row<size_t> predictions;
+ * gb.Classify(testData, predictions);
+ * @endcode
+ *
+ * For more information, see the following papers:
+ *
+ * @code
+ * @article{friedman2001greedy,
+ *   title={Greedy function approximation: a gradient boosting machine},
+ *   author={Friedman, Jerome H.},
+ *   journal={Annals of Statistics},
+ *   volume={29},
+ *   number={5},
+ *   pages={1189--1232},
+ *   year={2001}
+ * }
+ *
+ * @inproceedings{chen2016xgboost,
+ *   title={XGBoost: A scalable tree boosting system},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * @tparam LossType Loss function to minimize.
+ */
+template<typename LossType = SoftmaxLoss>
+class GradientBoosting
+{
+ public:
+  /**
+   * Construct an empty model.  Train() must be called before predictions can
+   * be made.
+   */
+  GradientBoosting();
+
+  /**
+   * Train a classification model on the given data and labels.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of boosting iterations (the number of trees is this
+   *      times the number of outputs of the model).
+   * @param learningRate Factor of the values of each tree.
+   * @param maximumDepth Maximum number of levels of splits of each tree (0
+   *      means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum decrease of the loss for a node to split.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param rowSampleRate Proportion of the points each tree is fitted to.
+   * @param dimensionSampleRate Proportion of the dimensions each tree may split
+   *      on.
+   * @param bins Maximum number of bins of each dimension (at most 256).
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numTrees = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 0.0,
+                   const double lambda = 1.0,
+                   const double rowSampleRate = 1.0,
+                   const double dimensionSampleRate = 1.0,
+                   const size_t bins = 256);
+
+  /**
+   * Train a regression model on the given data and responses.
+   *
+   * @param data Dataset to train on.
+   * @param responses Response of each point in the dataset.
+   * @param numTrees Number of boosting iterations (the number of trees is this
+   *      times the number of outputs of the model).
+   * @param learningRate Factor of the values of each tree.
+   * @param maximumDepth Maximum number of levels of splits of each tree (0
+   *      means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum decrease of the loss for a node to split.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param rowSampleRate Proportion of the points each tree is fitted to.
+   * @param dimensionSampleRate Proportion of the dimensions each tree may split
+   *      on.
+   * @param bins Maximum number of bins of each dimension (at most 256).
+   */
+  template<typename MatType>
+  GradientBoosting(const MatType& data,
+                   const arma::rowvec& responses,
+                   const size_t numTrees = 100,
+                   const double learningRate = 0.1,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 10,
+                   const double minimumGainSplit = 0.0,
+                   const double lambda = 1.0,
+                   const double rowSampleRate = 1.0,
+                   const double dimensionSampleRate = 1.0,
+                   const size_t bins = 256);
+
+  /**
+   * Train a classification model on the given data and labels.  If warmStart
+   * is true and the model is already trained, the new trees are added to the
+   * existing ones; otherwise the model is trained from scratch.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of boosting iterations (the number of trees is this
+   *      times the number of outputs of the model).
+   * @param learningRate Factor of the values of each tree.
+   * @param maximumDepth Maximum number of levels of splits of each tree (0
+   *      means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum decrease of the loss for a node to split.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param rowSampleRate Proportion of the points each tree is fitted to.
+   * @param dimensionSampleRate Proportion of the dimensions each tree may split
+   *      on.
+   * @param bins Maximum number of bins of each dimension (at most 256).
+   * @param warmStart Whether to add trees to the existing model.
+   * @return The mean loss of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 0.0,
+               const double lambda = 1.0,
+               const double rowSampleRate = 1.0,
+               const double dimensionSampleRate = 1.0,
+               const size_t bins = 256,
+               const bool warmStart = false);
+
+  /**
+   * Train a regression model on the given data and responses.  If warmStart
+   * is true and the model is already trained, the new trees are added to the
+   * existing ones; otherwise the model is trained from scratch.
+   *
+   * @param data Dataset to train on.
+   * @param responses Response of each point in the dataset.
+   * @param numTrees Number of boosting iterations (the number of trees is this
+   *      times the number of outputs of the model).
+   * @param learningRate Factor of the values of each tree.
+   * @param maximumDepth Maximum number of levels of splits of each tree (0
+   *      means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum decrease of the loss for a node to split.
+   * @param lambda L2 regularization of the values of the leaves.
+   * @param rowSampleRate Proportion of the points each tree is fitted to.
+   * @param dimensionSampleRate Proportion of the dimensions each tree may split
+   *      on.
+   * @param bins Maximum number of bins of each dimension (at most 256).
+   * @param warmStart Whether to add trees to the existing model.
+   * @return The mean loss of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.1,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 0.0,
+               const double lambda = 1.0,
+               const double rowSampleRate = 1.0,
+               const double dimensionSampleRate = 1.0,
+               const size_t bins = 256,
+               const bool warmStart = false);
+
+  /**
+   * Classify the given points.  The loss must be a classification loss.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and compute the probability of each class for
+   * each point.  The loss must be a classification loss.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  /**
+   * Predict the responses of the given points.  The model must have one
+   * output (as with SquaredErrorLoss).
+   *
+   * @param data Set of points to predict.
+   * @param predictions This will be filled with the prediction of each point.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  /**
+   * Compute the outputs of the model (before they are turned into
+   * predictions by the loss) for the given points.
+   *
+   * @param data Set of points.
+   * @param scores This will be filled with the outputs of each point (one row
+   *      per output).
+   */
+  template<typename MatType>
+  void Scores(const MatType& data, arma::mat& scores) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the number of boosting iterations.
+  size_t NumIterations() const
+  {
+    return roots.empty() ? 0 : roots.size() / initialScores.n_elem;
+  }
+  //! Get the total number of nodes of the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of outputs of the model.
+  size_t NumOutputs() const { return initialScores.n_elem; }
+  //! Get the number of classes (0 for a regression model).
+  size_t NumClasses() const { return numClasses; }
+  //! Get the initial prediction of the model.
+  const arma::vec& InitialScores() const { return initialScores; }
+
+  //! Get the number of points that go through a tree together in Scores().
+  static size_t BlockSize() { return 64; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Train the model on the given data and responses (which are classes for a
+   * classification loss).
+   */
+  template<typename MatType>
+  double TrainInternal(const MatType& data,
+                       const arma::rowvec& responses,
+                       const size_t numClasses,
+                       const size_t numTrees,
+                       const double learningRate,
+                       const size_t maximumDepth,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const double lambda,
+                       const double rowSampleRate,
+                       const double dimensionSampleRate,
+                       const size_t bins,
+                       const bool warmStart);
+
+  //! Get the value of the leaf of the given tree that the point falls into.
+  template<typename MatType>
+  double Value(const size_t root, const MatType& data, const size_t i) const;
+
+  //! The nodes of every tree.
+  std::vector<GradientBoostingNode> nodes;
+  //! The index of the root of each tree; tree t is for output
+  //! t % NumOutputs().
+  std::vector<size_t> roots;
+  //! The initial prediction of each output.
+  arma::vec initialScores;
+  //! The number of classes (0 for regression).
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
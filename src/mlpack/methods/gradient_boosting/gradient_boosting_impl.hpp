@@ -0,0 +1,351 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_impl.hpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename LossType>
+GradientBoosting<LossType>::GradientBoosting() : numClasses(0)
+{
+  // Nothing to do.
+}
+
+template<typename LossType>
+template<typename MatType>
+GradientBoosting<LossType>::GradientBoosting(const MatType& data,
+                                             const arma::Row<size_t>& labels,
+                                             const size_t numClasses,
+                                             const size_t numTrees,
+                                             const double learningRate,
+                                             const size_t maximumDepth,
+                                             const size_t minimumLeafSize,
+                                             const double minimumGainSplit,
+                                             const double lambda,
+                                             const double rowSampleRate,
+                                             const double dimensionSampleRate,
+                                             const size_t bins) :
+    numClasses(0)
+{
+  Train(data, labels, numClasses, numTrees, learningRate, maximumDepth,
+      minimumLeafSize, minimumGainSplit, lambda, rowSampleRate,
+      dimensionSampleRate, bins);
+}
+
+template<typename LossType>
+template<typename MatType>
+GradientBoosting<LossType>::GradientBoosting(const MatType& data,
+                                             const arma::rowvec& responses,
+                                             const size_t numTrees,
+                                             const double learningRate,
+                                             const size_t maximumDepth,
+                                             const size_t minimumLeafSize,
+                                             const double minimumGainSplit,
+                                             const double lambda,
+                                             const double rowSampleRate,
+                                             const double dimensionSampleRate,
+                                             const size_t bins) :
+    numClasses(0)
+{
+  Train(data, responses, numTrees, learningRate, maximumDepth,
+      minimumLeafSize, minimumGainSplit, lambda, rowSampleRate,
+      dimensionSampleRate, bins);
+}
+
+template<typename LossType>
+template<typename MatType>
+double GradientBoosting<LossType>::Train(const MatType& data,
+                                         const arma::Row<size_t>& labels,
+                                         const size_t numClasses,
+                                         const size_t numTrees,
+                                         const double learningRate,
+                                         const size_t maximumDepth,
+                                         const size_t minimumLeafSize,
+                                         const double minimumGainSplit,
+                                         const double lambda,
+                                         const double rowSampleRate,
+                                         const double dimensionSampleRate,
+                                         const size_t bins,
+                                         const bool warmStart)
+{
+  util::CheckSameSizes(data, labels, "GradientBoosting::Train()");
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): the labels must be less than the number "
+        << "of classes (" << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return TrainInternal(data, arma::conv_to<arma::rowvec>::from(labels),
+      numClasses, numTrees, learningRate, maximumDepth, minimumLeafSize,
+      minimumGainSplit, lambda, rowSampleRate, dimensionSampleRate, bins,
+      warmStart);
+}
+
+template<typename LossType>
+template<typename MatType>
+double GradientBoosting<LossType>::Train(const MatType& data,
+                                         const arma::rowvec& responses,
+                                         const size_t numTrees,
+                                         const double learningRate,
+                                         const size_t maximumDepth,
+                                         const size_t minimumLeafSize,
+                                         const double minimumGainSplit,
+                                         const double lambda,
+                                         const double rowSampleRate,
+                                         const double dimensionSampleRate,
+                                         const size_t bins,
+                                         const bool warmStart)
+{
+  util::CheckSameSizes(data, responses, "GradientBoosting::Train()");
+
+  return TrainInternal(data, responses, 0, numTrees, learningRate,
+      maximumDepth, minimumLeafSize, minimumGainSplit, lambda, rowSampleRate,
+      dimensionSampleRate, bins, warmStart);
+}
+
+template<typename LossType>
+template<typename MatType>
+double GradientBoosting<LossType>::TrainInternal(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const size_t numClassesIn,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double lambda,
+    const double rowSampleRate,
+    const double dimensionSampleRate,
+    const size_t bins,
+    const bool warmStart)
+{
+  if (data.n_cols == 0 || data.n_rows == 0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the dataset is "
+        "empty!");
+  }
+  if (learningRate <= 0.0 || lambda < 0.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the learning rate "
+        "must be positive and lambda must be nonnegative!");
+  }
+  if (rowSampleRate <= 0.0 || rowSampleRate > 1.0 ||
+      dimensionSampleRate <= 0.0 || dimensionSampleRate > 1.0)
+  {
+    throw std::invalid_argument("GradientBoosting::Train(): the sample rates "
+        "must be in (0, 1]!");
+  }
+
+  const size_t numOutputs = LossType::NumOutputs(numClassesIn);
+
+  // Start from the predictions of the current model, or from the initial
+  // prediction of the loss.
+  arma::mat scores;
+  if (warmStart && !roots.empty())
+  {
+    if (numOutputs != initialScores.n_elem || numClassesIn != numClasses)
+    {
+      std::ostringstream oss;
+      oss << "GradientBoosting::Train(): cannot add trees for " << numClassesIn
+          << " classes to a model for " << numClasses << " classes!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Scores(data, scores);
+  }
+  else
+  {
+    nodes.clear();
+    roots.clear();
+    numClasses = numClassesIn;
+    LossType::InitialScores(responses, numOutputs, initialScores);
+    scores = arma::repmat(initialScores, 1, data.n_cols);
+  }
+
+  // Put each value into its bin; the trees are built on the bins.
+  arma::Mat<unsigned char> binnedData;
+  std::vector<arma::vec> binEdges;
+  HistogramTreeBuilder::Bin(data, bins, binnedData, binEdges);
+  HistogramTreeBuilder builder(binnedData, binEdges, maximumDepth,
+      minimumLeafSize, minimumGainSplit, lambda);
+
+  const size_t numPoints = std::max((size_t) (rowSampleRate * data.n_cols),
+      (size_t) 1);
+  const size_t numDimensions = std::max(
+      (size_t) (dimensionSampleRate * data.n_rows), (size_t) 1);
+
+  arma::mat gradients, hessians;
+  std::vector<size_t> points(data.n_cols), dimensions(data.n_rows);
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    LossType::Gradients(responses, scores, gradients, hessians);
+
+    // Choose the points and dimensions of this iteration's trees.
+    if (numPoints < data.n_cols)
+    {
+      const arma::uvec sample = arma::sort(arma::randperm(data.n_cols,
+          numPoints));
+      points.assign(sample.begin(), sample.end());
+    }
+    else
+    {
+      points.resize(data.n_cols);
+      for (size_t i = 0; i < data.n_cols; ++i)
+        points[i] = i;
+    }
+
+    if (numDimensions < data.n_rows)
+    {
+      const arma::uvec sample = arma::sort(arma::randperm(data.n_rows,
+          numDimensions));
+      dimensions.assign(sample.begin(), sample.end());
+    }
+
+    for (size_t k = 0; k < numOutputs; ++k)
+    {
+      const arma::rowvec outputGradients = gradients.row(k);
+      const arma::rowvec outputHessians = hessians.row(k);
+      const size_t root = builder.Build(outputGradients, outputHessians, points,
+          dimensions, learningRate, nodes);
+      roots.push_back(root);
+
+      // Update the predictions of every training point, including those the
+      // tree was not fitted to.
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+        scores(k, i) += Value(root, data, i);
+    }
+
+    Log::Debug << "GradientBoosting::Train(): loss after iteration " << t
+        << ": " << LossType::Evaluate(responses, scores) << "." << std::endl;
+  }
+
+  const double loss = LossType::Evaluate(responses, scores);
+  Log::Info << "GradientBoosting::Train(): trained " << roots.size()
+      << " trees with " << nodes.size() << " nodes; training loss " << loss
+      << "." << std::endl;
+
+  return loss;
+}
+
+template<typename LossType>
+template<typename MatType>
+double GradientBoosting<LossType>::Value(const size_t root,
+                                         const MatType& data,
+                                         const size_t i) const
+{
+  size_t index = root;
+  while (nodes[index].left != 0)
+  {
+    const GradientBoostingNode& node = nodes[index];
+    index = node.left + ((data(node.dimension, i) <= node.threshold) ? 0 : 1);
+  }
+
+  return nodes[index].value;
+}
+
+template<typename LossType>
+template<typename MatType>
+void GradientBoosting<LossType>::Scores(const MatType& data,
+                                        arma::mat& scores) const
+{
+  if (initialScores.n_elem == 0)
+  {
+    scores.clear();
+    throw std::invalid_argument("GradientBoosting::Scores(): the model is not "
+        "trained!");
+  }
+
+  scores = arma::repmat(initialScores, 1, data.n_cols);
+
+  // Each block of points goes through every tree before the next block, so
+  // that the nodes of a tree are reused while they are in cache.
+  const size_t numOutputs = initialScores.n_elem;
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      const size_t k = t % numOutputs;
+      for (size_t i = begin; i < end; ++i)
+        scores(k, i) += Value(roots[t], data, i);
+    }
+  }
+}
+
+template<typename LossType>
+template<typename MatType>
+void GradientBoosting<LossType>::Classify(const MatType& data,
+                                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename LossType>
+template<typename MatType>
+void GradientBoosting<LossType>::Classify(const MatType& data,
+                                          arma::Row<size_t>& predictions,
+                                          arma::mat& probabilities) const
+{
+  arma::mat scores;
+  Scores(data, scores);
+  LossType::Probabilities(scores, probabilities);
+
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = probabilities.col(i).index_max();
+}
+
+template<typename LossType>
+template<typename MatType>
+void GradientBoosting<LossType>::Predict(const MatType& data,
+                                         arma::rowvec& predictions) const
+{
+  if (initialScores.n_elem > 1)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Predict(): the model has " << initialScores.n_elem
+        << " outputs; use Classify() or Scores() instead!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat scores;
+  Scores(data, scores);
+  predictions = scores.row(0);
+}
+
+template<typename LossType>
+template<typename Archive>
+void GradientBoosting<LossType>::serialize(Archive& ar,
+                                           const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(nodes));
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(initialScores));
+  ar(CEREAL_NVP(numClasses));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
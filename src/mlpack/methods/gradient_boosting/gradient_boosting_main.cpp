@@ -0,0 +1,321 @@
+/**
+ * @file methods/gradient_boosting/gradient_boosting_main.cpp
+ *
+ * A program to build and evaluate gradient boosted trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_NAME("Gradient boosted trees");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of gradient boosted trees for classification.  Given "
+    "labeled data, a gradient boosting model can be trained and saved for "
+    "future use; or, a pre-trained model can be used for classification.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program is an implementation of gradient boosted decision trees for "
+    "classification, with the softmax loss.  At each iteration, one regression "
+    "tree per class is fitted to the gradients of the loss, with histogram-"
+    "based splits.  A model can be trained and saved for later use, or a model "
+    "may be loaded and predictions or class probabilities for points may be "
+    "generated."
+    "\n\n"
+    "The training set and associated labels are specified with the " +
+    PRINT_PARAM_STRING("training") + " and " + PRINT_PARAM_STRING("labels") +
+    " parameters, respectively.  The labels should be in the range [0, "
+    "num_classes - 1]."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  The " + PRINT_PARAM_STRING("input_model") + " parameter may "
+    "not be specified when the " + PRINT_PARAM_STRING("training") + " parameter"
+    " is specified, unless " + PRINT_PARAM_STRING("warm_start") + " is given, "
+    "in which case the new trees are added to the model.  The " +
+    PRINT_PARAM_STRING("num_trees") + " parameter controls the number of "
+    "boosting iterations, and the " + PRINT_PARAM_STRING("learning_rate") +
+    " parameter controls the factor of the values of each tree.  The " +
+    PRINT_PARAM_STRING("maximum_depth") + " parameter specifies the maximum "
+    "number of levels of splits of each tree, and the " +
+    PRINT_PARAM_STRING("minimum_leaf_size") + " parameter specifies the "
+    "minimum number of training points in each leaf.  The " +
+    PRINT_PARAM_STRING("minimum_gain_split") + " parameter controls the minimum"
+    " decrease of the loss for a node to split, and " +
+    PRINT_PARAM_STRING("lambda") + " is the L2 regularization of the values of "
+    "the leaves.  Each tree is fitted to a random subset of the points and of "
+    "the dimensions, whose sizes are set by " +
+    PRINT_PARAM_STRING("row_sample_rate") + " and " +
+    PRINT_PARAM_STRING("dimension_sample_rate") + ".  The " +
+    PRINT_PARAM_STRING("bins") + " parameter is the maximum number of bins of "
+    "each dimension.  If " + PRINT_PARAM_STRING("print_training_accuracy") +
+    " is specified, the calculated accuracy on the training set will be "
+    "printed."
+    "\n\n"
+    "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
+    "parameter, and if performance measures are desired for that test set, "
+    "labels for the test points may be specified with the " +
+    PRINT_PARAM_STRING("test_labels") + " parameter.  Predictions for each "
+    "test point may be saved via the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter.  Class probabilities for each prediction may be saved "
+    "with the " + PRINT_PARAM_STRING("probabilities") + " output parameter.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to train a model with 200 trees of depth 4 on the dataset "
+    "contained in " + PRINT_DATASET("data") + " with labels " +
+    PRINT_DATASET("labels") + ", saving the output model to " +
+    PRINT_MODEL("gb_model") + " and printing the training error, one could "
+    "call"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "data", "labels", "labels",
+        "num_trees", 200, "maximum_depth", 4, "output_model", "gb_model",
+        "print_training_accuracy", true) +
+    "\n\n"
+    "Then, to use that model to classify points in " +
+    PRINT_DATASET("test_set") + " and print the test error given the labels " +
+    PRINT_DATASET("test_labels") + " using that model, while saving the "
+    "predictions for each point to " + PRINT_DATASET("predictions") + ", one "
+    "could call "
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "test_set", "test_labels", "test_labels", "predictions",
+        "predictions"));
+
+// See also...
+BINDING_SEE_ALSO("@random_forest", "#random_forest");
+BINDING_SEE_ALSO("@adaboost", "#adaboost");
+BINDING_SEE_ALSO("@decision_tree", "#decision_tree");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("Greedy function approximation: a gradient boosting machine "
+        "(pdf)", "https://statweb.stanford.edu/~jhf/ftp/trebst.pdf");
+BINDING_SEE_ALSO("mlpack::tree::GradientBoosting C++ class documentation",
+        "@doxygen/classmlpack_1_1tree_1_1GradientBoosting.html");
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+PARAM_UROW_IN("test_labels", "Test dataset labels, if accuracy calculation is "
+    "desired.", "L");
+
+PARAM_FLAG("print_training_accuracy", "If set, then the accuracy of the model "
+    "on the training set will be predicted (verbose must also be specified).",
+    "a");
+
+PARAM_INT_IN("num_trees", "Number of boosting iterations (one tree is trained "
+    "for each class at each iteration).", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Factor of the values of each tree.", "r",
+    0.1);
+PARAM_INT_IN("maximum_depth", "Maximum number of levels of splits of each "
+    "tree (0 means no limit).", "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 10);
+PARAM_DOUBLE_IN("minimum_gain_split", "Minimum decrease of the loss needed to "
+    "make a split when building a tree.", "g", 0);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the values of the leaves.",
+    "A", 1.0);
+PARAM_DOUBLE_IN("row_sample_rate", "Proportion of the training points each "
+    "tree is fitted to.", "R", 1.0);
+PARAM_DOUBLE_IN("dimension_sample_rate", "Proportion of the dimensions each "
+    "tree may split on.", "d", 1.0);
+PARAM_INT_IN("bins", "Maximum number of bins of each dimension (at most 256).",
+    "b", 256);
+PARAM_MATRIX_OUT("probabilities", "Predicted class probabilities for each "
+    "point in the test set.", "P");
+PARAM_UROW_OUT("predictions", "Predicted classes for each point in the test "
+    "set.", "p");
+
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+PARAM_FLAG("warm_start", "If true and passed along with `training` and "
+    "`input_model` then trains more trees on top of existing model.", "w");
+
+/**
+ * This is the class that we will serialize.  It is a simple wrapper around
+ * GradientBoosting<>.
+ */
+class GradientBoostingModel
+{
+ public:
+  // The model itself, left public for direct access by this program.
+  GradientBoosting<> gb;
+
+  // Create the model.
+  GradientBoostingModel() { /* Nothing to do. */ }
+
+  // Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(gb));
+  }
+};
+
+PARAM_MODEL_IN(GradientBoostingModel, "input_model", "Pre-trained gradient "
+    "boosting model to use for classification.", "m");
+PARAM_MODEL_OUT(GradientBoostingModel, "output_model", "Model to save trained "
+    "gradient boosting model to.", "M");
+
+static void mlpackMain()
+{
+  // Initialize random seed if needed.
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Check for incompatible input parameters.
+  if (!IO::HasParam("warm_start"))
+    RequireOnlyOnePassed({ "training", "input_model" }, true);
+  else
+    // When warm_start is passed, training and input_model must also be passed.
+    RequireNoneOrAllPassed({"warm_start", "training", "input_model"}, true);
+
+  ReportIgnoredParam({{ "training", false }}, "print_training_accuracy");
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+
+  RequireAtLeastOnePassed({ "test", "output_model", "print_training_accuracy" },
+      false, "the trained model will not be used or saved");
+
+  if (IO::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "must pass labels when training"
+        " set given");
+  }
+
+  RequireParamValue<int>("num_trees", [](int x) { return x > 0; }, true,
+      "number of trees must be positive");
+
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "probabilities");
+
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("maximum_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must not be negative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; }, true,
+      "minimum leaf size must be greater than 0");
+  RequireParamValue<double>("minimum_gain_split",
+      [](double x) { return x >= 0.0; }, true,
+      "minimum gain for splitting must be nonnegative");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be nonnegative");
+  RequireParamValue<double>("row_sample_rate",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "row sample rate must be in (0, 1]");
+  RequireParamValue<double>("dimension_sample_rate",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "dimension sample rate must be in (0, 1]");
+  RequireParamValue<int>("bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "number of bins must be between 2 and 256");
+
+  ReportIgnoredParam({{ "training", false }}, "num_trees");
+  ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+
+  GradientBoostingModel* gbModel;
+  // Input model is loaded when we are either doing warm-started training or
+  // else we are making predictions only or both.
+  if (IO::HasParam("input_model"))
+    gbModel = IO::GetParam<GradientBoostingModel*>("input_model");
+  // Handles the case when we are training a new model from scratch.
+  else
+    gbModel = new GradientBoostingModel();
+
+  if (IO::HasParam("training"))
+  {
+    Timer::Start("gb_training");
+
+    // Train the model on the given input data.
+    arma::mat data = std::move(IO::GetParam<arma::mat>("training"));
+    arma::Row<size_t> labels =
+        std::move(IO::GetParam<arma::Row<size_t>>("labels"));
+
+    const size_t numTrees = (size_t) IO::GetParam<int>("num_trees");
+    const double learningRate = IO::GetParam<double>("learning_rate");
+    const size_t maxDepth = (size_t) IO::GetParam<int>("maximum_depth");
+    const size_t minimumLeafSize =
+        (size_t) IO::GetParam<int>("minimum_leaf_size");
+    const double minimumGainSplit = IO::GetParam<double>("minimum_gain_split");
+    const double lambda = IO::GetParam<double>("lambda");
+    const double rowSampleRate = IO::GetParam<double>("row_sample_rate");
+    const double dimensionSampleRate =
+        IO::GetParam<double>("dimension_sample_rate");
+    const size_t bins = (size_t) IO::GetParam<int>("bins");
+
+    Log::Info << "Training gradient boosting model with " << numTrees
+        << " iterations..." << endl;
+
+    // When adding trees, keep the number of classes of the model.
+    const size_t numClasses = IO::HasParam("warm_start") ?
+        std::max(gbModel->gb.NumClasses(), (size_t) arma::max(labels) + 1) :
+        (size_t) arma::max(labels) + 1;
+
+    // Train the model.
+    gbModel->gb.Train(data, labels, numClasses, numTrees, learningRate,
+        maxDepth, minimumLeafSize, minimumGainSplit, lambda, rowSampleRate,
+        dimensionSampleRate, bins, IO::HasParam("warm_start"));
+
+    Timer::Stop("gb_training");
+
+    // Did we want training accuracy?
+    if (IO::HasParam("print_training_accuracy"))
+    {
+      Timer::Start("gb_prediction");
+      arma::Row<size_t> predictions;
+      gbModel->gb.Classify(data, predictions);
+
+      const size_t correct = arma::accu(predictions == labels);
+
+      Log::Info << correct << " of " << labels.n_elem << " correct on training"
+          << " set (" << (double(correct) / double(labels.n_elem) * 100) << ")."
+          << endl;
+      Timer::Stop("gb_prediction");
+    }
+  }
+
+  if (IO::HasParam("test"))
+  {
+    arma::mat testData = std::move(IO::GetParam<arma::mat>("test"));
+    Timer::Start("gb_prediction");
+
+    // Get predictions and probabilities.
+    arma::Row<size_t> predictions;
+    arma::mat probabilities;
+    gbModel->gb.Classify(testData, predictions, probabilities);
+
+    // Did we want to calculate test accuracy?
+    if (IO::HasParam("test_labels"))
+    {
+      arma::Row<size_t> testLabels =
+          std::move(IO::GetParam<arma::Row<size_t>>("test_labels"));
+
+      const size_t correct = arma::accu(predictions == testLabels);
+
+      Log::Info << correct << " of " << testLabels.n_elem << " correct on test"
+          << " set (" << (double(correct) / double(testLabels.n_elem) * 100)
+          << ")." << endl;
+    }
+    Timer::Stop("gb_prediction");
+
+    // Save the outputs.
+    IO::GetParam<arma::mat>("probabilities") = std::move(probabilities);
+    IO::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+  }
+
+  // Save the output model.
+  IO::GetParam<GradientBoostingModel*>("output_model") = gbModel;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file methods/gradient_boosting/histogram_tree_builder.cpp
+ *
+ * Implementation of HistogramTreeBuilder.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "histogram_tree_builder.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+HistogramTreeBuilder::HistogramTreeBuilder(
+    const arma::Mat<unsigned char>& binnedData,
+    const std::vector<arma::vec>& binEdges,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double lambda) :
+    binnedData(binnedData),
+    binEdges(binEdges),
+    maximumDepth(maximumDepth),
+    minimumLeafSize(std::max(minimumLeafSize, (size_t) 1)),
+    minimumGainSplit(minimumGainSplit),
+    lambda(lambda),
+    gradients(NULL),
+    hessians(NULL),
+    points(NULL),
+    dimensions(NULL),
+    learningRate(1.0),
+    nodes(NULL)
+{
+  // Nothing else to do.
+}
+
+size_t HistogramTreeBuilder::Build(const arma::rowvec& gradients,
+                                   const arma::rowvec& hessians,
+                                   std::vector<size_t>& points,
+                                   const std::vector<size_t>& dimensions,
+                                   const double learningRate,
+                                   std::vector<GradientBoostingNode>& nodes)
+{
+  this->gradients = &gradients;
+  this->hessians = &hessians;
+  this->points = &points;
+  this->dimensions = &dimensions;
+  this->learningRate = learningRate;
+  this->nodes = &nodes;
+
+  const size_t root = nodes.size();
+  nodes.push_back(GradientBoostingNode());
+
+  arma::mat gradientSums, hessianSums;
+  arma::Mat<size_t> counts;
+  Histograms(0, points.size(), gradientSums, hessianSums, counts);
+  SplitNode(root, 0, points.size(), 0, gradientSums, hessianSums, counts);
+
+  return root;
+}
+
+void HistogramTreeBuilder::SplitNode(const size_t node,
+                                     const size_t begin,
+                                     const size_t end,
+                                     const size_t depth,
+                                     arma::mat& gradientSums,
+                                     arma::mat& hessianSums,
+                                     arma::Mat<size_t>& counts)
+{
+  // Every dimension holds all the points of the node, so the sums of the
+  // node can be taken from the first one.
+  const size_t count = end - begin;
+  const double g = arma::accu(gradientSums.col(0));
+  const double h = arma::accu(hessianSums.col(0));
+  const double nodeScore = g * g / (h + lambda);
+
+  // Find the best split, if we are allowed to split.
+  size_t bestDim = dimensions->size(); // This means "no split".
+  size_t bestBin = 0;
+  double bestGain = std::max(minimumGainSplit, 0.0);
+  if ((maximumDepth == 0 || depth < maximumDepth) &&
+      count >= 2 * minimumLeafSize)
+  {
+    for (size_t f = 0; f < dimensions->size(); ++f)
+    {
+      const size_t numBins = binEdges[(*dimensions)[f]].n_elem + 1;
+      double leftG = 0.0, leftH = 0.0;
+      size_t leftCount = 0;
+      for (size_t b = 0; b + 1 < numBins; ++b)
+      {
+        leftG += gradientSums(b, f);
+        leftH += hessianSums(b, f);
+        leftCount += counts(b, f);
+        if (leftCount < minimumLeafSize)
+          continue;
+        if (count - leftCount < minimumLeafSize)
+          break;
+
+        const double rightG = g - leftG;
+        const double rightH = h - leftH;
+        const double gain = 0.5 * (leftG * leftG / (leftH + lambda) +
+            rightG * rightG / (rightH + lambda) - nodeScore);
+        if (gain > bestGain)
+        {
+          bestGain = gain;
+          bestDim = f;
+          bestBin = b;
+        }
+      }
+    }
+  }
+
+  if (bestDim == dimensions->size())
+  {
+    // Make a leaf.
+    GradientBoostingNode& leaf = (*nodes)[node];
+    leaf.dimension = 0;
+    leaf.threshold = 0.0;
+    leaf.left = 0;
+    leaf.value = -learningRate * g / (h + lambda);
+    return;
+  }
+
+  const size_t dimension = (*dimensions)[bestDim];
+  const size_t left = nodes->size();
+  (*nodes)[node].dimension = dimension;
+  (*nodes)[node].threshold = binEdges[dimension][bestBin];
+  (*nodes)[node].left = left;
+  (*nodes)[node].value = 0.0;
+  nodes->push_back(GradientBoostingNode());
+  nodes->push_back(GradientBoostingNode());
+
+  // Move the points of the left child to the front of the range.
+  const unsigned char splitBin = (unsigned char) bestBin;
+  const size_t middle = std::partition(points->begin() + begin,
+      points->begin() + end, [&](const size_t p)
+      {
+        return binnedData(dimension, p) <= splitBin;
+      }) - points->begin();
+
+  // Compute the histograms of the smaller child; those of the larger child are
+  // what is left of the histograms of this node.
+  arma::mat smallGradientSums, smallHessianSums;
+  arma::Mat<size_t> smallCounts;
+  const bool leftIsSmaller = (middle - begin <= end - middle);
+  if (leftIsSmaller)
+    Histograms(begin, middle, smallGradientSums, smallHessianSums, smallCounts);
+  else
+    Histograms(middle, end, smallGradientSums, smallHessianSums, smallCounts);
+
+  gradientSums -= smallGradientSums;
+  hessianSums -= smallHessianSums;
+  counts -= smallCounts;
+
+  if (leftIsSmaller)
+  {
+    SplitNode(left, begin, middle, depth + 1, smallGradientSums,
+        smallHessianSums, smallCounts);
+    SplitNode(left + 1, middle, end, depth + 1, gradientSums, hessianSums,
+        counts);
+  }
+  else
+  {
+    SplitNode(left, begin, middle, depth + 1, gradientSums, hessianSums,
+        counts);
+    SplitNode(left + 1, middle, end, depth + 1, smallGradientSums,
+        smallHessianSums, smallCounts);
+  }
+}
+
+void HistogramTreeBuilder::Histograms(const size_t begin,
+                                      const size_t end,
+                                      arma::mat& gradientSums,
+                                      arma::mat& hessianSums,
+                                      arma::Mat<size_t>& counts) const
+{
+  gradientSums.zeros(256, dimensions->size());
+  hessianSums.zeros(256, dimensions->size());
+  counts.zeros(256, dimensions->size());
+
+  // Each thread fills the histograms of its own dimensions.
+  #pragma omp parallel for
+  for (omp_size_t f = 0; f < (omp_size_t) dimensions->size(); ++f)
+  {
+    const size_t dimension = (*dimensions)[f];
+    double* g = gradientSums.colptr(f);
+    double* h = hessianSums.colptr(f);
+    size_t* c = counts.colptr(f);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t p = (*points)[i];
+      const unsigned char bin = binnedData(dimension, p);
+      g[bin] += (*gradients)[p];
+      h[bin] += (*hessians)[p];
+      ++c[bin];
+    }
+  }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file methods/gradient_boosting/histogram_tree_builder.hpp
+ *
+ * Builder of the histogram-based regression trees of gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_HISTOGRAM_TREE_BUILDER_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_HISTOGRAM_TREE_BUILDER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A node of a regression tree of a GradientBoosting model.  The nodes of a tree
+ * are stored in an array, and the two children of a node are next to each
+ * other in that array.
+ */
+struct GradientBoostingNode
+{
+  //! Dimension the node splits on.
+  size_t dimension;
+  //! Points whose value in that dimension is not larger than this go to the
+  //! left child.
+  double threshold;
+  //! Index of the left child (the right child follows it), or 0 for a leaf.
+  size_t left;
+  //! Value of the leaf (0 for a node that splits).
+  double value;
+
+  //! Serialize the node.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(dimension));
+    ar(CEREAL_NVP(threshold));
+    ar(CEREAL_NVP(left));
+    ar(CEREAL_NVP(value));
+  }
+};
+
+/**
+ * The HistogramTreeBuilder builds the regression trees of gradient boosting.
+ * Each tree is fitted to the first and second derivatives of the loss (the
+ * gradients and hessians) of the points, with the Newton step: the value of a
+ * leaf is -G / (H + lambda), where G and H are the sums of the gradients and
+ * hessians of the points of the leaf, and a split is chosen to maximize the
+ * decrease of the loss, 0.5 * (G_L^2 / (H_L + lambda) + G_R^2 / (H_R + lambda)
+ * - G^2 / (H + lambda)).
+ *
+ * The values of each dimension are replaced by the index of their bin before
+ * training (see Bin()), so the splits of a node are found from a histogram of
+ * the gradients and hessians of each dimension, in time linear in the number
+ * of points.  Only the histogram of the smaller child of a node is computed
+ * from its points; that of the larger child is the difference between the
+ * histogram of the node and that of its sibling.  The histograms are computed
+ * with multiple threads, one dimension at a time.
+ */
+class HistogramTreeBuilder
+{
+ public:
+  /**
+   * Create the builder for the given binned dataset.
+   *
+   * @param binnedData Bin of each value of the dataset, as given by Bin().
+   * @param binEdges Bin edges of each dimension, as given by Bin().
+   * @param maximumDepth Maximum number of levels of splits of a tree (0 means
+   *      no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum decrease of the loss for a node to split.
+   * @param lambda L2 regularization of the values of the leaves.
+   */
+  HistogramTreeBuilder(const arma::Mat<unsigned char>& binnedData,
+                       const std::vector<arma::vec>& binEdges,
+                       const size_t maximumDepth,
+                       const size_t minimumLeafSize,
+                       const double minimumGainSplit,
+                       const double lambda);
+
+  /**
+   * Build a tree fitted to the given gradients and hessians, on the given
+   * points and dimensions.  The values of the leaves are multiplied by the
+   * learning rate.  The nodes of the tree are appended to the given array.
+   *
+   * @param gradients Gradient of the loss of each point of the dataset.
+   * @param hessians Second derivative of the loss of each point of the
+   *      dataset.
+   * @param points Points to fit the tree to; this is reordered.
+   * @param dimensions Dimensions the tree may split on.
+   * @param learningRate Factor of the values of the leaves.
+   * @param nodes Array that the nodes of the tree are appended to.
+   * @return Index of the root of the tree in the array of nodes.
+   */
+  size_t Build(const arma::rowvec& gradients,
+               const arma::rowvec& hessians,
+               std::vector<size_t>& points,
+               const std::vector<size_t>& dimensions,
+               const double learningRate,
+               std::vector<GradientBoostingNode>& nodes);
+
+  /**
+   * Compute the bins of each dimension of the given dataset, and the bin of
+   * each of its values.  When a dimension has no more distinct values than
+   * the given number of bins, each distinct value gets its own bin; otherwise
+   * the bins hold about the same number of points.  The bin of a value is the
+   * number of bin edges smaller than the value, so a value is not larger than
+   * edge b exactly when its bin is not larger than b.
+   *
+   * @param data Dataset to bin.
+   * @param maximumBins Maximum number of bins of a dimension (at most 256).
+   * @param binnedData This will be filled with the bin of each value.
+   * @param binEdges This will be filled with the bin edges of each dimension.
+   */
+  template<typename MatType>
+  static void Bin(const MatType& data,
+                  const size_t maximumBins,
+                  arma::Mat<unsigned char>& binnedData,
+                  std::vector<arma::vec>& binEdges);
+
+ private:
+  /**
+   * Split the given node, or make it a leaf, and then build its children.  The
+   * node holds the points in [begin, end) of the point list, and the given
+   * histograms of those points (which are modified).
+   */
+  void SplitNode(const size_t node,
+                 const size_t begin,
+                 const size_t end,
+                 const size_t depth,
+                 arma::mat& gradientSums,
+                 arma::mat& hessianSums,
+                 arma::Mat<size_t>& counts);
+
+  //! Compute the histograms of the points in [begin, end) of the point list.
+  void Histograms(const size_t begin,
+                  const size_t end,
+                  arma::mat& gradientSums,
+                  arma::mat& hessianSums,
+                  arma::Mat<size_t>& counts) const;
+
+  //! Bin of each value of the dataset.
+  const arma::Mat<unsigned char>& binnedData;
+  //! Bin edges of each dimension.
+  const std::vector<arma::vec>& binEdges;
+  //! Maximum number of levels of splits of a tree.
+  size_t maximumDepth;
+  //! Minimum number of points in each leaf.
+  size_t minimumLeafSize;
+  //! Minimum decrease of the loss for a node to split.
+  double minimumGainSplit;
+  //! L2 regularization of the values of the leaves.
+  double lambda;
+
+  //! The gradients of the tree being built.
+  const arma::rowvec* gradients;
+  //! The hessians of the tree being built.
+  const arma::rowvec* hessians;
+  //! The points of the tree being built.
+  std::vector<size_t>* points;
+  //! The dimensions of the tree being built.
+  const std::vector<size_t>* dimensions;
+  //! The learning rate of the tree being built.
+  double learningRate;
+  //! The nodes of the tree being built.
+  std::vector<GradientBoostingNode>* nodes;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_tree_builder_impl.hpp"
+
+#endif
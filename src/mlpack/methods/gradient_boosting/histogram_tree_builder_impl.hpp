@@ -0,0 +1,78 @@
+/**
+ * @file methods/gradient_boosting/histogram_tree_builder_impl.hpp
+ *
+ * Implementation of the templated functions of HistogramTreeBuilder.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_HISTOGRAM_TREE_BUILDER_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_HISTOGRAM_TREE_BUILDER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_tree_builder.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void HistogramTreeBuilder::Bin(const MatType& data,
+                               const size_t maximumBins,
+                               arma::Mat<unsigned char>& binnedData,
+                               std::vector<arma::vec>& binEdges)
+{
+  if (maximumBins < 2 || maximumBins > 256)
+  {
+    std::ostringstream oss;
+    oss << "HistogramTreeBuilder::Bin(): the number of bins must be between 2 "
+        << "and 256, but " << maximumBins << " was given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t n = data.n_cols;
+  binnedData.set_size(data.n_rows, n);
+  binEdges.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    arma::vec values(n);
+    for (size_t i = 0; i < n; ++i)
+      values[i] = data(d, i);
+    values = arma::sort(values);
+
+    std::vector<double> edges;
+    const arma::vec distinct = arma::unique(values);
+    if (distinct.n_elem <= maximumBins)
+    {
+      // Each distinct value gets its own bin.
+      for (size_t j = 0; j + 1 < distinct.n_elem; ++j)
+        edges.push_back((distinct[j] + distinct[j + 1]) / 2.0);
+    }
+    else
+    {
+      // Take the quantiles as edges; repeated values are skipped, and so is the
+      // largest value (it would leave the last bin empty).
+      for (size_t b = 1; b < maximumBins; ++b)
+      {
+        const double edge = values[(b * n) / maximumBins];
+        if ((edges.empty() || edge > edges.back()) && edge < values[n - 1])
+          edges.push_back(edge);
+      }
+    }
+    binEdges[d] = arma::vec(edges);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      binnedData(d, i) = (unsigned char) (std::lower_bound(edges.begin(),
+          edges.end(), (double) data(d, i)) - edges.begin());
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file methods/gradient_boosting/loss_functions/logistic_loss.hpp
+ *
+ * The logistic loss, for binary classification with gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_LOGISTIC_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_LOGISTIC_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The logistic loss of binary classification.  The model has one output f,
+ * the log-odds of class 1, so that the probability of class 1 is
+ * p = 1 / (1 + exp(-f)), and the loss of a point of class y is
+ * -(y log(p) + (1 - y) log(1 - p)).  Its gradient is p - y and its second
+ * derivative is p (1 - p).  This is half the work of SoftmaxLoss for two
+ * classes, since only one tree is needed per iteration.
+ */
+class LogisticLoss
+{
+ public:
+  /**
+   * Return the number of outputs of the model, which is 1.  An exception is
+   * thrown if there are not two classes.
+   *
+   * @param numClasses Number of classes.
+   */
+  static size_t NumOutputs(const size_t numClasses)
+  {
+    if (numClasses != 2)
+    {
+      std::ostringstream oss;
+      oss << "LogisticLoss::NumOutputs(): the logistic loss needs two classes, "
+          << "but " << numClasses << " were given!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return 1;
+  }
+
+  /**
+   * Compute the initial prediction of the model, which is the log-odds of the
+   * proportion of points of class 1.
+   *
+   * @param responses Classes of the training points (0 or 1).
+   * @param numOutputs Number of outputs of the model.
+   * @param scores This will be filled with the initial prediction.
+   */
+  static void InitialScores(const arma::rowvec& responses,
+                            const size_t /* numOutputs */,
+                            arma::vec& scores)
+  {
+    const double p = std::min(std::max(arma::mean(responses), 1e-10),
+        1.0 - 1e-10);
+    scores.set_size(1);
+    scores[0] = std::log(p / (1.0 - p));
+  }
+
+  /**
+   * Compute the first and second derivatives of the loss of each point with
+   * respect to its prediction.
+   *
+   * @param responses Classes of the points (0 or 1).
+   * @param scores Current predictions of the points.
+   * @param gradients This will be filled with the first derivatives.
+   * @param hessians This will be filled with the second derivatives.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::mat& scores,
+                        arma::mat& gradients,
+                        arma::mat& hessians)
+  {
+    const arma::mat p = 1.0 / (1.0 + arma::exp(-scores));
+    gradients = p - responses;
+    hessians = arma::clamp(p % (1.0 - p), 1e-16, 1.0);
+  }
+
+  /**
+   * Compute the mean loss of the given predictions.
+   *
+   * @param responses Classes of the points (0 or 1).
+   * @param scores Predictions of the points.
+   */
+  static double Evaluate(const arma::rowvec& responses, const arma::mat& scores)
+  {
+    // log(1 + exp(f)) - y f, computed without overflow.
+    const arma::rowvec f = scores.row(0);
+    return arma::mean(arma::clamp(f, 0.0, DBL_MAX) +
+        arma::log(1.0 + arma::exp(-arma::abs(f))) - responses % f);
+  }
+
+  /**
+   * Compute the probability of each class from the predictions.
+   *
+   * @param scores Predictions of the points.
+   * @param probabilities This will be filled with the probability of each
+   *      class (one row per class) for each point.
+   */
+  static void Probabilities(const arma::mat& scores, arma::mat& probabilities)
+  {
+    probabilities.set_size(2, scores.n_cols);
+    probabilities.row(1) = 1.0 / (1.0 + arma::exp(-scores.row(0)));
+    probabilities.row(0) = 1.0 - probabilities.row(1);
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
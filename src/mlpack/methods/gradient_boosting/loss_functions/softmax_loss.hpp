@@ -0,0 +1,127 @@
+/**
+ * @file methods/gradient_boosting/loss_functions/softmax_loss.hpp
+ *
+ * The softmax (multinomial) loss, for classification with gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_SOFTMAX_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_SOFTMAX_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The softmax loss of classification with any number of classes.  The model
+ * has one output f_k for each class k, and the probability of class k is
+ * p_k = exp(f_k) / sum_j exp(f_j).  The loss of a point of class y is
+ * -log(p_y); its gradient with respect to f_k is p_k - [y == k], and its second
+ * derivative is p_k (1 - p_k).  So each iteration of boosting trains one tree
+ * for each class.
+ */
+class SoftmaxLoss
+{
+ public:
+  /**
+   * Return the number of outputs of the model, which is the number of classes.
+   *
+   * @param numClasses Number of classes.
+   */
+  static size_t NumOutputs(const size_t numClasses)
+  {
+    if (numClasses < 2)
+    {
+      std::ostringstream oss;
+      oss << "SoftmaxLoss::NumOutputs(): at least two classes are needed, but "
+          << numClasses << " were given!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    return numClasses;
+  }
+
+  /**
+   * Compute the initial prediction of the model, which is the logarithm of the
+   * proportion of points of each class.
+   *
+   * @param responses Classes of the training points.
+   * @param numOutputs Number of outputs of the model (the number of classes).
+   * @param scores This will be filled with the initial prediction.
+   */
+  static void InitialScores(const arma::rowvec& responses,
+                            const size_t numOutputs,
+                            arma::vec& scores)
+  {
+    scores.zeros(numOutputs);
+    for (size_t i = 0; i < responses.n_elem; ++i)
+      scores[(size_t) responses[i]] += 1.0;
+
+    scores = arma::log(arma::clamp(scores / responses.n_elem, 1e-10, 1.0));
+  }
+
+  /**
+   * Compute the first and second derivatives of the loss of each point with
+   * respect to each of its outputs.
+   *
+   * @param responses Classes of the points.
+   * @param scores Current predictions of the points.
+   * @param gradients This will be filled with the first derivatives.
+   * @param hessians This will be filled with the second derivatives.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::mat& scores,
+                        arma::mat& gradients,
+                        arma::mat& hessians)
+  {
+    Probabilities(scores, gradients);
+    hessians = arma::clamp(gradients % (1.0 - gradients), 1e-16, 1.0);
+    for (size_t i = 0; i < responses.n_elem; ++i)
+      gradients((size_t) responses[i], i) -= 1.0;
+  }
+
+  /**
+   * Compute the mean loss of the given predictions.
+   *
+   * @param responses Classes of the points.
+   * @param scores Predictions of the points.
+   */
+  static double Evaluate(const arma::rowvec& responses, const arma::mat& scores)
+  {
+    double loss = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      // log(sum_j exp(f_j)) - f_y, computed without overflow.
+      const double maxScore = scores.col(i).max();
+      loss += maxScore + std::log(arma::accu(arma::exp(scores.col(i) -
+          maxScore))) - scores((size_t) responses[i], i);
+    }
+
+    return loss / responses.n_elem;
+  }
+
+  /**
+   * Compute the probability of each class from the predictions.
+   *
+   * @param scores Predictions of the points.
+   * @param probabilities This will be filled with the probability of each
+   *      class (one row per class) for each point.
+   */
+  static void Probabilities(const arma::mat& scores, arma::mat& probabilities)
+  {
+    // Subtract the largest output of each point to avoid overflow.
+    const arma::rowvec maxScores = arma::max(scores, 0);
+    probabilities = arma::exp(scores.each_row() - maxScores);
+    const arma::rowvec sums = arma::sum(probabilities, 0);
+    probabilities.each_row() /= sums;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
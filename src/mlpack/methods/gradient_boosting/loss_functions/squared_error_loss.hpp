@@ -0,0 +1,83 @@
+/**
+ * @file methods/gradient_boosting/loss_functions/squared_error_loss.hpp
+ *
+ * The squared error loss, for regression with gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_SQUARED_ERROR_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_LOSS_FUNCTIONS_SQUARED_ERROR_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The squared error loss 0.5 * (f - y)^2 of a prediction f of a response y.
+ * This is the loss to use for regression: the model has one output, which is
+ * the predicted response.  Its gradient is f - y and its second derivative is
+ * 1, so every tree fits the residuals of the previous trees.
+ */
+class SquaredErrorLoss
+{
+ public:
+  /**
+   * Return the number of outputs of the model, which is 1.
+   *
+   * @param numClasses Number of classes (unused; 0 for regression).
+   */
+  static size_t NumOutputs(const size_t /* numClasses */) { return 1; }
+
+  /**
+   * Compute the initial prediction of the model, which is the mean response.
+   *
+   * @param responses Responses of the training points.
+   * @param numOutputs Number of outputs of the model.
+   * @param scores This will be filled with the initial prediction.
+   */
+  static void InitialScores(const arma::rowvec& responses,
+                            const size_t /* numOutputs */,
+                            arma::vec& scores)
+  {
+    scores.set_size(1);
+    scores[0] = arma::mean(responses);
+  }
+
+  /**
+   * Compute the first and second derivatives of the loss of each point with
+   * respect to its prediction.
+   *
+   * @param responses Responses of the points.
+   * @param scores Current predictions of the points.
+   * @param gradients This will be filled with the first derivatives.
+   * @param hessians This will be filled with the second derivatives.
+   */
+  static void Gradients(const arma::rowvec& responses,
+                        const arma::mat& scores,
+                        arma::mat& gradients,
+                        arma::mat& hessians)
+  {
+    gradients = scores - responses;
+    hessians.ones(scores.n_rows, scores.n_cols);
+  }
+
+  /**
+   * Compute the mean loss of the given predictions.
+   *
+   * @param responses Responses of the points.
+   * @param scores Predictions of the points.
+   */
+  static double Evaluate(const arma::rowvec& responses, const arma::mat& scores)
+  {
+    return 0.5 * arma::mean(arma::square(scores.row(0) - responses));
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file methods/hdbscan/hdbscan.hpp
+ *
+ * An implementation of the HDBSCAN clustering method, built on the dual-tree
+ * Boruvka algorithm for minimum spanning trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+namespace mlpack {
+namespace hdbscan /** HDBSCAN clustering. */ {
+
+/**
+ * HDBSCAN (Hierarchical DBSCAN) is a density-based clustering technique
+ * described in the following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data Mining
+ *       (PAKDD 2013)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * The core distance of each point is the distance to its (minSamples - 1)th
+ * nearest neighbor, found with NeighborSearch.  The minimum spanning tree of
+ * the data under the mutual reachability distance max(d(a, b), core(a),
+ * core(b)) is computed with DualTreeBoruvka, and the single-linkage hierarchy
+ * of that tree is condensed: splits in which a side has fewer than
+ * minClusterSize points are treated as points leaving the cluster.  Finally,
+ * the clusters with the largest total stability are selected.  Apart from the
+ * nearest neighbor search and the minimum spanning tree, all steps take
+ * O(n log n) time.
+ *
+ * @tparam MetricType Metric to use.
+ * @tparam TreeType Type of tree to use for the nearest neighbor search and the
+ *     minimum spanning tree.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minClusterSize Minimum number of points in a cluster; must be at
+   *     least 2.
+   * @param minSamples Number of points (including the point itself) within
+   *     the core distance of each point; if 0, minClusterSize is used.
+   * @param allowSingleCluster If true, the whole dataset may be returned as a
+   *     single cluster.
+   */
+  HDBSCAN(const size_t minClusterSize = 5,
+          const size_t minSamples = 0,
+          const bool allowSingleCluster = false);
+
+  /**
+   * Perform HDBSCAN clustering on the data, returning the number of clusters
+   * and the cluster assignments.  If assignments[i] == SIZE_MAX, then the point
+   * is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments in.
+   */
+  size_t Cluster(const arma::mat& data, arma::Row<size_t>& assignments);
+
+  /**
+   * Perform HDBSCAN clustering on the data, returning the number of clusters,
+   * the cluster assignments, and the minimum spanning tree under the mutual
+   * reachability distance, in the format used by DualTreeBoruvka::ComputeMST().
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments in.
+   * @param mst Matrix to store the minimum spanning tree in.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::Row<size_t>& assignments,
+                 arma::mat& mst);
+
+  /**
+   * Extract the clusters from a minimum spanning tree under the mutual
+   * reachability distance, in the format used by DualTreeBoruvka::ComputeMST()
+   * (sorted by distance).  This is the last step of Cluster(), and can be used
+   * to recluster with a different minimum cluster size without recomputing
+   * the tree.
+   *
+   * @param mst Minimum spanning tree of the data.
+   * @param numPoints Number of points in the data.
+   * @param assignments Vector to store cluster assignments in.
+   * @return The number of clusters.
+   */
+  size_t ExtractClusters(const arma::mat& mst,
+                         const size_t numPoints,
+                         arma::Row<size_t>& assignments) const;
+
+  //! Get the minimum cluster size.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum cluster size.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  //! Get the number of samples used for core distances (0 means
+  //! MinClusterSize()).
+  size_t MinSamples() const { return minSamples; }
+  //! Modify the number of samples used for core distances.
+  size_t& MinSamples() { return minSamples; }
+
+  //! Get whether a single cluster may be returned.
+  bool AllowSingleCluster() const { return allowSingleCluster; }
+  //! Modify whether a single cluster may be returned.
+  bool& AllowSingleCluster() { return allowSingleCluster; }
+
+  //! Get the core distances computed during the last call to Cluster().
+  const arma::vec& CoreDistances() const { return coreDistances; }
+
+ private:
+  //! Minimum number of points in a cluster.
+  size_t minClusterSize;
+
+  //! Number of samples for core distances.
+  size_t minSamples;
+
+  //! Whether a single cluster may be returned.
+  bool allowSingleCluster;
+
+  //! Core distances of the last clustering.
+  arma::vec coreDistances;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
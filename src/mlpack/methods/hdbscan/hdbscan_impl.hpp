@@ -0,0 +1,284 @@
+/**
+ * @file methods/hdbscan/hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+
+#include "hdbscan.hpp"
+
+namespace mlpack {
+namespace hdbscan {
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+HDBSCAN<MetricType, TreeType>::HDBSCAN(const size_t minClusterSize,
+                                       const size_t minSamples,
+                                       const bool allowSingleCluster) :
+    minClusterSize(minClusterSize),
+    minSamples(minSamples),
+    allowSingleCluster(allowSingleCluster)
+{
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("HDBSCAN::HDBSCAN(): minClusterSize must be "
+        "at least 2!");
+  }
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::Row<size_t>& assignments)
+{
+  // The minimum spanning tree will be thrown away.
+  arma::mat mst;
+  return Cluster(data, assignments, mst);
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::Cluster(const arma::mat& data,
+                                              arma::Row<size_t>& assignments,
+                                              arma::mat& mst)
+{
+  const size_t samples = (minSamples == 0) ? minClusterSize : minSamples;
+  if (data.n_cols < 2 || data.n_cols < samples)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::Cluster(): dataset has " << data.n_cols << " points, but "
+        << "at least " << std::max(samples, (size_t) 2) << " are needed!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The core distance of each point is the distance to its (samples - 1)th
+  // nearest neighbor, not counting the point itself.
+  Timer::Start("hdbscan/core_distances");
+  if (samples > 1)
+  {
+    neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+        arma::mat, TreeType> knn(data);
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(samples - 1, neighbors, distances);
+    coreDistances = distances.row(samples - 2).t();
+  }
+  else
+  {
+    coreDistances.zeros(data.n_cols);
+  }
+  Timer::Stop("hdbscan/core_distances");
+
+  // Compute the minimum spanning tree under the mutual reachability distance.
+  emst::DualTreeBoruvka<MetricType, arma::mat, TreeType> dtb(data);
+  dtb.ComputeMST(mst, coreDistances);
+
+  Timer::Start("hdbscan/cluster_extraction");
+  const size_t numClusters = ExtractClusters(mst, data.n_cols, assignments);
+  Timer::Stop("hdbscan/cluster_extraction");
+
+  Log::Info << numClusters << " clusters found." << std::endl;
+
+  return numClusters;
+}
+
+template<typename MetricType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, TreeType>::ExtractClusters(
+    const arma::mat& mst,
+    const size_t numPoints,
+    arma::Row<size_t>& assignments) const
+{
+  if (numPoints == 0 || mst.n_rows != 3 || mst.n_cols != numPoints - 1)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::ExtractClusters(): the minimum spanning tree must be a "
+        << "3 x " << (numPoints == 0 ? 0 : numPoints - 1) << " matrix!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  assignments.set_size(numPoints);
+  assignments.fill(SIZE_MAX);
+  if (numPoints < minClusterSize)
+    return 0;
+
+  // Build the single-linkage hierarchy: node numPoints + i merges the two
+  // components joined by the i'th shortest edge.  The leaves are the points.
+  arma::uvec order = arma::stable_sort_index(mst.row(2).t());
+  std::vector<size_t> left(numPoints - 1), right(numPoints - 1);
+  std::vector<double> mergeDistance(numPoints - 1);
+  std::vector<size_t> nodeSize(2 * numPoints - 1, 1);
+  std::vector<size_t> componentNode(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    componentNode[i] = i;
+
+  emst::UnionFind components(numPoints);
+  for (size_t i = 0; i < numPoints - 1; ++i)
+  {
+    const size_t a = components.Find((size_t) mst(0, order[i]));
+    const size_t b = components.Find((size_t) mst(1, order[i]));
+
+    left[i] = componentNode[a];
+    right[i] = componentNode[b];
+    mergeDistance[i] = mst(2, order[i]);
+    nodeSize[numPoints + i] = nodeSize[left[i]] + nodeSize[right[i]];
+
+    components.Union(a, b);
+    componentNode[components.Find(a)] = numPoints + i;
+  }
+
+  // Condense the hierarchy from the root down.  Cluster 0 is the root; every
+  // split where both sides have at least minClusterSize points creates two new
+  // clusters, and smaller sides leave their cluster as points.  Clusters are
+  // created after their parents, so parents have smaller indices.
+  std::vector<size_t> clusterParent(1, 0);
+  std::vector<double> clusterBirth(1, 0.0);
+  std::vector<size_t> clusterSize(1, numPoints);
+  std::vector<size_t> pointCluster(numPoints, 0);
+  std::vector<double> pointLambda(numPoints, 0.0);
+
+  // Mark all points under the given node as leaving the given cluster.
+  std::vector<size_t> leafStack;
+  auto fallOut = [&](const size_t node, const size_t cluster,
+                     const double lambda)
+  {
+    leafStack.push_back(node);
+    while (!leafStack.empty())
+    {
+      const size_t current = leafStack.back();
+      leafStack.pop_back();
+      if (current < numPoints)
+      {
+        pointCluster[current] = cluster;
+        pointLambda[current] = lambda;
+      }
+      else
+      {
+        leafStack.push_back(left[current - numPoints]);
+        leafStack.push_back(right[current - numPoints]);
+      }
+    }
+  };
+
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.push_back(std::make_pair(2 * numPoints - 2, (size_t) 0));
+  while (!stack.empty())
+  {
+    const size_t node = stack.back().first;
+    const size_t cluster = stack.back().second;
+    stack.pop_back();
+
+    // Every node pushed holds at least minClusterSize >= 2 points, so it is
+    // not a leaf.
+    const size_t l = left[node - numPoints];
+    const size_t r = right[node - numPoints];
+    const double distance = mergeDistance[node - numPoints];
+    const double lambda = (distance > 0.0) ? 1.0 / distance :
+        std::numeric_limits<double>::infinity();
+
+    const bool leftIsCluster = (nodeSize[l] >= minClusterSize);
+    const bool rightIsCluster = (nodeSize[r] >= minClusterSize);
+    if (leftIsCluster && rightIsCluster)
+    {
+      for (size_t child : { l, r })
+      {
+        clusterParent.push_back(cluster);
+        clusterBirth.push_back(lambda);
+        clusterSize.push_back(nodeSize[child]);
+        stack.push_back(std::make_pair(child, clusterParent.size() - 1));
+      }
+    }
+    else
+    {
+      if (leftIsCluster)
+        stack.push_back(std::make_pair(l, cluster));
+      else
+        fallOut(l, cluster, lambda);
+
+      if (rightIsCluster)
+        stack.push_back(std::make_pair(r, cluster));
+      else
+        fallOut(r, cluster, lambda);
+    }
+  }
+
+  // The stability of a cluster sums, over its points, the range of lambda in
+  // which they belong to it.
+  const size_t numCandidates = clusterParent.size();
+  auto excess = [](const double lambda, const double birth)
+  {
+    return (lambda > birth) ? lambda - birth : 0.0;
+  };
+
+  std::vector<double> stability(numCandidates, 0.0);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    stability[pointCluster[i]] += excess(pointLambda[i],
+        clusterBirth[pointCluster[i]]);
+  }
+  for (size_t c = 1; c < numCandidates; ++c)
+  {
+    stability[clusterParent[c]] += clusterSize[c] * excess(clusterBirth[c],
+        clusterBirth[clusterParent[c]]);
+  }
+
+  // Select clusters bottom-up: a cluster is kept if it is at least as stable
+  // as the best selection among its descendants.
+  std::vector<double> childStability(numCandidates, 0.0);
+  std::vector<bool> hasChildren(numCandidates, false);
+  std::vector<bool> selected(numCandidates, false);
+  for (size_t c = numCandidates; c-- > 0; )
+  {
+    double best = childStability[c];
+    const bool selectable = (c > 0 || allowSingleCluster);
+    if (selectable && (!hasChildren[c] || stability[c] >= childStability[c]))
+    {
+      selected[c] = true;
+      best = stability[c];
+    }
+
+    if (c > 0)
+    {
+      childStability[clusterParent[c]] += best;
+      hasChildren[clusterParent[c]] = true;
+    }
+  }
+
+  // Label clusters top-down; the descendants of a selected cluster belong to
+  // it.
+  std::vector<size_t> clusterLabel(numCandidates, SIZE_MAX);
+  size_t numClusters = 0;
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    const size_t parentLabel = (c > 0) ? clusterLabel[clusterParent[c]] :
+        SIZE_MAX;
+    if (parentLabel != SIZE_MAX)
+      clusterLabel[c] = parentLabel;
+    else if (selected[c])
+      clusterLabel[c] = numClusters++;
+  }
+
+  for (size_t i = 0; i < numPoints; ++i)
+    assignments[i] = clusterLabel[pointCluster[i]];
+
+  return numClusters;
+}
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file methods/hdbscan/hdbscan_main.cpp
+ *
+ * Implementation of program to run HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "hdbscan.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_NAME("HDBSCAN clustering");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of HDBSCAN clustering.  Given a dataset, this can "
+    "compute and return a hierarchical density-based clustering of that "
+    "dataset.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program implements the HDBSCAN algorithm for clustering.  Unlike "
+    "DBSCAN, no radius needs to be given: the core distance of each point is "
+    "found with a tree-based nearest neighbor search, the minimum spanning "
+    "tree of the data under the mutual reachability distance is computed with "
+    "the dual-tree Boruvka algorithm, and the most stable clusters of the "
+    "resulting hierarchy are returned."
+    "\n\n"
+    "The input dataset to be clustered may be specified with the " +
+    PRINT_PARAM_STRING("input") + " parameter, and the minimum number of "
+    "points in a cluster may be specified with the " +
+    PRINT_PARAM_STRING("min_cluster_size") + " parameter.  The number of "
+    "neighbors used to compute core distances may be specified with the " +
+    PRINT_PARAM_STRING("min_samples") + " parameter; if it is 0, " +
+    PRINT_PARAM_STRING("min_cluster_size") + " is used.  If " +
+    PRINT_PARAM_STRING("allow_single_cluster") + " is specified, the whole "
+    "dataset may be returned as a single cluster."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("assignments") + " output parameter contains "
+    "the cluster assignments of each point; points considered noise are "
+    "assigned the largest representable unsigned integer.");
+
+// Example.
+BINDING_EXAMPLE(
+    "An example usage to run HDBSCAN on the dataset in " +
+    PRINT_DATASET("input") + " with a minimum cluster size of 10 is given "
+    "below:"
+    "\n\n" +
+    PRINT_CALL("hdbscan", "input", "input", "min_cluster_size", 10,
+        "assignments", "assignments"));
+
+// See also...
+BINDING_SEE_ALSO("@dbscan", "#dbscan");
+BINDING_SEE_ALSO("@emst", "#emst");
+BINDING_SEE_ALSO("Density-based clustering based on hierarchical density "
+        "estimates", "https://doi.org/10.1007/978-3-642-37456-2_14");
+BINDING_SEE_ALSO("mlpack::hdbscan::HDBSCAN class documentation",
+        "@doxygen/classmlpack_1_1hdbscan_1_1HDBSCAN.html");
+
+PARAM_MATRIX_IN_REQ("input", "Input dataset to cluster.", "i");
+PARAM_UROW_OUT("assignments", "Output matrix for assignments of each "
+    "point.", "a");
+
+PARAM_INT_IN("min_cluster_size", "Minimum number of points in a cluster.", "m",
+    5);
+PARAM_INT_IN("min_samples", "Number of neighbors used to compute core "
+    "distances (0 means the value of min_cluster_size).", "s", 0);
+PARAM_FLAG("allow_single_cluster", "If set, the whole dataset may be returned "
+    "as a single cluster.", "S");
+
+static void mlpackMain()
+{
+  RequireAtLeastOnePassed({ "assignments" }, false, "no output will be saved");
+
+  RequireParamValue<int>("min_cluster_size", [](int x) { return x >= 2; },
+      true, "min_cluster_size must be at least 2");
+  RequireParamValue<int>("min_samples", [](int x) { return x >= 0; },
+      true, "min_samples must be non-negative");
+
+  arma::mat dataset = std::move(IO::GetParam<arma::mat>("input"));
+  HDBSCAN<> h((size_t) IO::GetParam<int>("min_cluster_size"),
+      (size_t) IO::GetParam<int>("min_samples"),
+      IO::HasParam("allow_single_cluster"));
+
+  arma::Row<size_t> assignments;
+  h.Cluster(dataset, assignments);
+
+  if (IO::HasParam("assignments"))
+    IO::GetParam<arma::Row<size_t>>("assignments") = std::move(assignments);
+}
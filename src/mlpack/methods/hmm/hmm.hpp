@@ -158,6 +158,8 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * If OpenMP is available, the E-step is run on the sequences in parallel.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -282,6 +284,40 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute an approximation of the most probable hidden state sequence for the
+   * given data sequence, using the Viterbi algorithm with beam pruning.  At
+   * each time step, only the states whose log-probability is within the given
+   * beam of the best state are extended to the next time step, so decoding
+   * costs time proportional to the number of states in the beam (times the
+   * number of transitions out of each state, if the sparse transition matrix
+   * is used).  An infinite beam gives the exact Viterbi path.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param beam Width of the beam, in log-probability.
+   * @return Log-likelihood of the returned state sequence.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq,
+                 const double beam) const;
+
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  If OpenMP is available, the
+   * sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each data sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -290,6 +326,17 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  If OpenMP
+   * is available, the sequences are processed in parallel.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -408,6 +455,7 @@ class HMM
   arma::mat& Transition()
   {
     recalculateTransition = true;
+    recalculateSparseTransition = true;
     return transitionProxy;
   }
 
@@ -426,6 +474,25 @@ class HMM
   //! Modify the tolerance of the Baum-Welch algorithm.
   double& Tolerance() { return tolerance; }
 
+  /**
+   * Get whether a sparse copy of the transition matrix is used by the
+   * Forward-Backward and Viterbi algorithms.
+   */
+  bool UseSparseTransition() const { return useSparseTransition; }
+  /**
+   * Modify whether a sparse copy of the transition matrix is used by the
+   * Forward-Backward and Viterbi algorithms.  For models with many states and
+   * few possible transitions out of each state (such as left-to-right models),
+   * this makes each time step cost time proportional to the number of nonzero
+   * transitions instead of the square of the number of states.  This option
+   * is not serialized.
+   */
+  bool& UseSparseTransition()
+  {
+    recalculateSparseTransition = true;
+    return useSparseTransition;
+  }
+
   /**
    * Load the object.
    */
@@ -461,6 +528,19 @@ class HMM
                         double& logScales,
                         const arma::vec& prevForwardLogProb) const;
 
+  /**
+   * Given emission probabilities at time t+1, computes backward probabilities
+   * for time t.
+   *
+   * @param emissionLogProb Emission probability at time t+1.
+   * @param logScale Log of the scaling factor at time t+1.
+   * @param nextBackwardLogProb Backward probabilities at time t+1.
+   * @return Backward probabilities
+   */
+  arma::vec BackwardAtTn(const arma::vec& emissionLogProb,
+                         const double logScale,
+                         const arma::vec& nextBackwardLogProb) const;
+
   // Helper functions.
   /**
    * The Forward algorithm (part of the Forward-Backward algorithm).  Computes
@@ -506,6 +586,55 @@ class HMM
   mutable arma::mat logTransition;
 
  private:
+  /**
+   * Compute the log-probability of each observation of the given data
+   * sequence under the emission distribution of each state.  The returned
+   * matrix has rows equal to the number of observations and columns equal to
+   * the number of states.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the log-probabilities will be saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logProbs) const;
+
+  /**
+   * Compute the log of the expected number of transitions from each state to
+   * each other state in a data sequence (without the multiplication by the
+   * transition probabilities), from the results of the Forward-Backward
+   * algorithm.  This is used by the M-step of the Baum-Welch algorithm.  The
+   * statistics are stored in column-major order, for every element of the
+   * transition matrix, or only for its nonzero elements if the sparse
+   * transition matrix is used.
+   *
+   * @param forwardLogProb Forward log-probabilities of the sequence.
+   * @param backwardLogProb Backward log-probabilities of the sequence.
+   * @param logProbs Emission log-probabilities of the sequence.
+   * @param logScales Log of the scaling factors of the sequence.
+   * @param transitionLogStats Matrix in which the statistics will be saved.
+   */
+  void TransitionLogStatistics(const arma::mat& forwardLogProb,
+                               const arma::mat& backwardLogProb,
+                               const arma::mat& logProbs,
+                               const arma::vec& logScales,
+                               arma::vec& transitionLogStats) const;
+
+  /**
+   * Compute the most probable hidden state sequence with the Viterbi
+   * algorithm, extending only the states within the given beam of the best
+   * state at each time step.  The transitions out of each state are taken
+   * from the sparse transition matrix if it is used.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param beam Width of the beam, in log-probability.
+   * @return Log-likelihood of the returned state sequence.
+   */
+  double BeamViterbi(const arma::mat& dataSeq,
+                     arma::Row<size_t>& stateSeq,
+                     const double beam) const;
+
   /**
    * Make sure the variables in log space are in sync
    * with the linear counter parts.
@@ -539,6 +668,18 @@ class HMM
    * Should be removed in mlpack 4.0.
    */
   mutable bool recalculateTransition;
+
+  //! Whether or not the sparse copy of the transition matrix is used.
+  bool useSparseTransition;
+
+  //! Whether or not we need to update the sparse copy of the transition matrix.
+  mutable bool recalculateSparseTransition;
+
+  //! Sparse copy of the transition matrix, if it is used.
+  mutable arma::sp_mat sparseTransition;
+
+  //! Log of each nonzero element of sparseTransition, in column-major order.
+  mutable arma::vec sparseLogTransition;
 };
 
 } // namespace hmm
@@ -35,7 +35,9 @@ HMM<Distribution>::HMM(const size_t states,
     dimensionality(emissions.Dimensionality()),
     tolerance(tolerance),
     recalculateInitial(false),
-    recalculateTransition(false)
+    recalculateTransition(false),
+    useSparseTransition(false),
+    recalculateSparseTransition(true)
 {
   // Normalize the transition probabilities and initial state probabilities.
   initialProxy /= arma::accu(initialProxy);
@@ -62,7 +64,9 @@ HMM<Distribution>::HMM(const arma::vec& initial,
     logInitial(log(initial)),
     tolerance(tolerance),
     recalculateInitial(false),
-    recalculateTransition(false)
+    recalculateTransition(false),
+    useSparseTransition(false),
+    recalculateSparseTransition(true)
 {
   // Set the dimensionality, if we can.
   if (emission.size() > 0)
@@ -101,102 +105,122 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
-  size_t totalLength = 0;
+  // Find length of all sequences and ensure they are the correct size.  Each
+  // sequence has its own range of columns in the list of emissions.
+  std::vector<size_t> offsets(dataSeq.size() + 1, 0);
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
-    totalLength += dataSeq[seq].n_cols;
+    offsets[seq + 1] = offsets[seq] + dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
       Log::Fatal << "HMM::Train(): data sequence " << seq << " has "
           << "dimensionality " << dataSeq[seq].n_rows << " (expected "
           << dimensionality << " dimensions)." << std::endl;
   }
+  const size_t totalLength = offsets[dataSeq.size()];
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // don't change between iterations, so they are only copied once.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(offsets[seq], offsets[seq + 1] - 1) = dataSeq[seq];
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
+    // The threads only read the parameters in log space (and the sparse
+    // transition matrix) during the E-step, so they are updated first.
+    ConvertToLogSpace();
+
     // Clear new transition matrix and emission probabilities.
     arma::vec newLogInitial(logTransition.n_rows);
     newLogInitial.fill(-std::numeric_limits<double>::infinity());
-    arma::mat newLogTransition(logTransition.n_rows, logTransition.n_cols);
-    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+    // The transition statistics are kept for every element of the transition
+    // matrix, or only for its nonzero elements with the sparse transition
+    // matrix.
+    const size_t numTransitionStats = useSparseTransition ?
+        (size_t) sparseTransition.n_nonzero : (size_t) logTransition.n_elem;
+    arma::vec newLogTransitionStats(numTransitionStats);
+    newLogTransitionStats.fill(-std::numeric_limits<double>::infinity());
 
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent given the current parameters, so the
+    // E-step is run on them in parallel, with the statistics accumulated by
+    // each thread and then combined.
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
+      arma::vec threadLogInitial(logTransition.n_rows);
+      threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::vec threadLogTransitionStats(numTransitionStats);
+      threadLogTransitionStats.fill(-std::numeric_limits<double>::infinity());
+      double threadLoglik = 0.0;
+
+      #pragma omp for
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
-      }
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
-      {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        if (dataSeq[seq].n_cols == 0)
+          continue;
+
+        arma::mat logProbs;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        EmissionLogProbabilities(dataSeq[seq], logProbs);
+        Forward(dataSeq[seq], logScales, forwardLog, logProbs);
+        Backward(dataSeq[seq], logScales, backwardLog, logProbs);
+        threadLoglik += accu(logScales);
+
+        arma::mat stateLogProb = forwardLog + backwardLog;
+
+        // Add to estimate of initial probability for state j.
+        math::LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            threadLogInitial);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We postpone multiplication of the old T_ij until later.
+        arma::vec seqLogTransitionStats;
+        TransitionLogStatistics(forwardLog, backwardLog, logProbs, logScales,
+            seqLogTransitionStats);
+        for (size_t i = 0; i < numTransitionStats; ++i)
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          math::LogSumExp(tmp, output);
-
-          for (size_t j = 0; j < logTransition.n_cols; ++j)
-          {
-            // Compute the estimate of T_ij (probability of transition from
-            // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
-            arma::vec alias = newLogTransition.unsafe_col(j);
-            math::LogSumExp<arma::vec, true>(tmp2, alias);
-          }
+          threadLogTransitionStats[i] = math::LogAdd(
+              threadLogTransitionStats[i], seqLogTransitionStats[i]);
         }
 
         // Add to list of emission observations, for Distribution::Train().
+        // Each sequence has its own range of the list, so no synchronization
+        // is needed.
         for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+        {
+          emissionProb[j].subvec(offsets[seq], offsets[seq + 1] - 1) =
+              exp(stateLogProb.row(j).t());
+        }
+      }
+
+      #pragma omp critical
+      {
+        loglik += threadLoglik;
+        math::LogSumExp<arma::vec, true>(threadLogInitial, newLogInitial);
+        for (size_t i = 0; i < numTransitionStats; ++i)
+        {
+          newLogTransitionStats[i] = math::LogAdd(newLogTransitionStats[i],
+              threadLogTransitionStats[i]);
+        }
       }
     }
 
@@ -214,6 +238,29 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     else
       logInitial = newLogInitial;
 
+    // Transitions that are not in the sparse transition matrix are impossible,
+    // so they stay impossible.
+    arma::mat newLogTransition;
+    if (useSparseTransition)
+    {
+      newLogTransition.set_size(logTransition.n_rows, logTransition.n_cols);
+      newLogTransition.fill(-std::numeric_limits<double>::infinity());
+      for (size_t j = 0; j < sparseTransition.n_cols; ++j)
+      {
+        for (size_t k = sparseTransition.col_ptrs[j];
+             k < sparseTransition.col_ptrs[j + 1]; ++k)
+        {
+          newLogTransition(sparseTransition.row_indices[k], j) =
+              newLogTransitionStats[k];
+        }
+      }
+    }
+    else
+    {
+      newLogTransition = arma::reshape(newLogTransitionStats,
+          logTransition.n_rows, logTransition.n_cols);
+    }
+
     // Assign the new transition matrix.  We use %= (element-wise
     // multiplication) because every element of the new transition matrix must
     // still be multiplied by the old elements (this is the multiplication we
@@ -232,6 +279,7 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
     initialProxy = exp(logInitial);
     transitionProxy = exp(logTransition);
+    recalculateSparseTransition = true;
     // Now estimate emission probabilities.
     for (size_t state = 0; state < logTransition.n_cols; state++)
       emission[state].Train(emissionList, emissionProb[state]);
@@ -315,6 +363,7 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
 
   initialProxy = initial;
   transitionProxy = transition;
+  recalculateSparseTransition = true;
   logTransition = log(transition);
   logInitial = log(initial);
 
@@ -354,16 +403,8 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
 {
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   // First run the forward-backward algorithm.
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
@@ -490,11 +531,23 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // probable sequence of states to produce the observed data sequence.  We
   // don't use log-likelihoods to save that little bit of time, but we'll
   // calculate the log-likelihood at the end of it all.
+  ConvertToLogSpace();
+
+  // With the sparse transition matrix, only the nonzero transitions are
+  // considered.
+  if (useSparseTransition)
+  {
+    return BeamViterbi(dataSeq, stateSeq,
+        std::numeric_limits<double>::infinity());
+  }
+
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
   arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
 
-  ConvertToLogSpace();
+  // Compute the log-probability of each observation under each state.
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
@@ -502,26 +555,13 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   logStateProb.col(0).zeros();
   for (size_t state = 0; state < logTransition.n_rows; state++)
   {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    logStateProb(state, 0) = logInitial[state] + logProbs(0, state);
     stateSeqBack(state, 0) = state;
   }
 
   // Store the best first state.
   arma::uword index;
 
-  // Define a variable to store the value of log-probability for dataSeq.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
-
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     // Assemble the state probability for this element.
@@ -547,6 +587,45 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
 }
 
+/**
+ * Compute an approximation of the most probable hidden state sequence for the
+ * given observation using the Viterbi algorithm with beam pruning.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                  arma::Row<size_t>& stateSeq,
+                                  const double beam) const
+{
+  if (beam < 0.0)
+  {
+    Log::Fatal << "HMM::Predict(): beam width must be non-negative (" << beam
+        << " given)." << std::endl;
+  }
+
+  ConvertToLogSpace();
+  return BeamViterbi(dataSeq, stateSeq, beam);
+}
+
+/**
+ * Compute the most probable hidden state sequence for each of the given data
+ * sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  // Update the parameters in log space before the threads read them.
+  ConvertToLogSpace();
+
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeq[i], stateSeq[i]);
+}
+
 /**
  * Compute the log-likelihood of the given data sequence.
  */
@@ -557,16 +636,8 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   arma::vec logScales;
 
   // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   Forward(dataSeq, logScales, forwardLog, logProbs);
 
@@ -574,6 +645,23 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the log-likelihood of each of the given data sequences, in parallel.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  // Update the parameters in log space before the threads read them.
+  ConvertToLogSpace();
+
+  logLikelihoods.set_size(dataSeq.size());
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeq[i]);
+}
+
 /**
  * Compute the log of the scaling factor of the given emission probability
  * at time t. To calculate the log-likelihood for the whole sequence,
@@ -659,16 +747,8 @@ void HMM<Distribution>::Filter(const arma::mat& dataSeq,
   arma::mat forwardLogProb;
   arma::vec logScales;
   // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
 
@@ -747,12 +827,26 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
 
   // The forward probability of state j at time t is the sum over all states of
   // the probability of the previous state transitioning to the current state
-  // and emitting the given observation.  To do this computation in log-space,
-  // we can use LogSumExp().
+  // and emitting the given observation.  The previous forward probabilities
+  // are shifted by their maximum, so that the sum over all states can be
+  // computed as a single matrix-vector product with the transition matrix
+  // (which is kept in sync with logTransition), instead of exponentiating
+  // every element of the transition matrix.
   arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
-  math::LogSumExp(tmp, forwardLogProb);
+  const double maxLogProb = prevForwardLogProb.max();
+  if (std::isfinite(maxLogProb))
+  {
+    const arma::vec prevProb = exp(prevForwardLogProb - maxLogProb);
+    if (useSparseTransition)
+      forwardLogProb = log(sparseTransition * prevProb) + maxLogProb;
+    else
+      forwardLogProb = log(transitionProxy * prevProb) + maxLogProb;
+  }
+  else
+  {
+    forwardLogProb.set_size(logTransition.n_rows);
+    forwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  }
   forwardLogProb += emissionLogProb;
 
   // Normalize probability.
@@ -812,21 +906,220 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   // Now step backwards through all other observations.
   for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
   {
-    // The backward probability of state j at time t is the sum over all
-    // states of the probability of the next state having been a transition
-    // from the current state multiplied by the probability of each of those
-    // states emitting the given observation.  To compute this in log-space, we
-    // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
-    arma::vec alias = backwardLogProb.unsafe_col(t);
-    math::LogSumExpT<arma::mat, true>(tmp, alias);
-
-    // Normalize by the weights from the forward algorithm.
-    if (std::isfinite(logScales[t + 1]))
-      backwardLogProb.col(t) -= logScales[t + 1];
+    backwardLogProb.col(t) = BackwardAtTn(logProbs.row(t + 1).t(),
+        logScales[t + 1], backwardLogProb.col(t + 1));
+  }
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::BackwardAtTn(const arma::vec& emissionLogProb,
+                                          const double logScale,
+                                          const arma::vec& nextBackwardLogProb)
+    const
+{
+  // The backward probability of state j at time t is the sum over all states
+  // of the probability of the next state having been a transition from the
+  // current state multiplied by the probability of each of those states
+  // emitting the given observation.  As in ForwardAtTn(), the sum over all
+  // states is computed as a matrix-vector product, after a shift by the
+  // maximum.
+  arma::vec backwardLogProb;
+  const arma::vec nextLogProb = nextBackwardLogProb + emissionLogProb;
+  const double maxLogProb = nextLogProb.max();
+  if (std::isfinite(maxLogProb))
+  {
+    const arma::rowvec nextProb = exp(nextLogProb - maxLogProb).t();
+    if (useSparseTransition)
+      backwardLogProb = (log(nextProb * sparseTransition) + maxLogProb).t();
+    else
+      backwardLogProb = (log(nextProb * transitionProxy) + maxLogProb).t();
+  }
+  else
+  {
+    backwardLogProb.set_size(logTransition.n_cols);
+    backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  }
+
+  // Normalize by the weights from the forward algorithm.
+  if (std::isfinite(logScale))
+    backwardLogProb -= logScale;
+
+  return backwardLogProb;
+}
+
+/**
+ * Compute the log-probability of each observation under each emission
+ * distribution.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(const arma::mat& dataSeq,
+                                                 arma::mat& logProbs) const
+{
+  logProbs.set_size(dataSeq.n_cols, logTransition.n_rows);
+
+  // Save the values of log-probability to logProbs.
+  for (size_t i = 0; i < logTransition.n_rows; i++)
+  {
+    // Define alias of desired column.
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    // Use advanced constructor for using logProbs directly.
+    emission[i].LogProbability(dataSeq, alias);
+  }
+}
+
+/**
+ * Compute the log of the expected number of transitions between each pair of
+ * states in a sequence, for the M-step of the Baum-Welch algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::TransitionLogStatistics(
+    const arma::mat& forwardLogProb,
+    const arma::mat& backwardLogProb,
+    const arma::mat& logProbs,
+    const arma::vec& logScales,
+    arma::vec& transitionLogStats) const
+{
+  transitionLogStats.set_size(useSparseTransition ?
+      (size_t) sparseTransition.n_nonzero : (size_t) logTransition.n_elem);
+  const size_t length = forwardLogProb.n_cols;
+  if (length < 2)
+  {
+    transitionLogStats.fill(-std::numeric_limits<double>::infinity());
+    return;
+  }
+
+  // The statistic for the transition from state j to state i is
+  //   log sum_t exp(f(j, t) + b(i, t + 1) + E_i(seq[t + 1]) - s(t + 1)).
+  // Each time step is shifted by its maximum and the sum over t is computed as
+  // a matrix product; time steps where every state is impossible contribute
+  // nothing.
+  arma::mat next = backwardLogProb.cols(1, length - 1) +
+      logProbs.rows(1, length - 1).t();
+  next.each_row() -= logScales.subvec(1, length - 1).t();
+  arma::mat prev = forwardLogProb.cols(0, length - 2);
+
+  arma::rowvec nextMax = max(next, 0);
+  arma::rowvec prevMax = max(prev, 0);
+  nextMax.replace(-std::numeric_limits<double>::infinity(), 0.0);
+  prevMax.replace(-std::numeric_limits<double>::infinity(), 0.0);
+
+  const arma::rowvec shifts = nextMax + prevMax;
+  const double maxShift = shifts.max();
+
+  next.each_row() -= nextMax;
+  prev.each_row() -= prevMax;
+  next = exp(next);
+  next.each_row() %= exp(shifts - maxShift);
+  prev = exp(prev);
+
+  if (useSparseTransition)
+  {
+    // Only the statistics of the nonzero transitions are needed.  Each one is
+    // the dot product of two columns of the transposed matrices.
+    const arma::mat nextT = next.t();
+    const arma::mat prevT = prev.t();
+    for (size_t j = 0; j < sparseTransition.n_cols; ++j)
+    {
+      for (size_t k = sparseTransition.col_ptrs[j];
+           k < sparseTransition.col_ptrs[j + 1]; ++k)
+      {
+        transitionLogStats[k] = std::log(arma::dot(
+            nextT.col(sparseTransition.row_indices[k]), prevT.col(j))) +
+            maxShift;
+      }
+    }
+  }
+  else
+  {
+    transitionLogStats = arma::vectorise(log(next * prev.t())) + maxShift;
+  }
+}
+
+/**
+ * The Viterbi algorithm with beam pruning.  Instead of computing the best
+ * previous state of each state, each state in the beam is extended to all of
+ * the states it can transition to.
+ */
+template<typename Distribution>
+double HMM<Distribution>::BeamViterbi(const arma::mat& dataSeq,
+                                      arma::Row<size_t>& stateSeq,
+                                      const double beam) const
+{
+  const size_t states = logTransition.n_rows;
+  stateSeq.set_size(dataSeq.n_cols);
+
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
+
+  // The best previous state of each state at each time step.  States that are
+  // never reached keep state 0, but they can't be on the returned path.
+  arma::Mat<size_t> stateSeqBack(states, dataSeq.n_cols, arma::fill::zeros);
+
+  arma::vec logStateProb = logInitial + logProbs.row(0).t();
+  arma::vec nextLogStateProb(states);
+  std::vector<size_t> activeStates;
+  activeStates.reserve(states);
+
+  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  {
+    // Find the states within the beam.
+    const double threshold = logStateProb.max() - beam;
+    activeStates.clear();
+    for (size_t i = 0; i < states; i++)
+    {
+      if (std::isfinite(logStateProb[i]) && logStateProb[i] >= threshold)
+        activeStates.push_back(i);
+    }
+
+    // Extend each state in the beam to each state it can transition to.  The
+    // states are visited in increasing order, so that ties are broken like in
+    // Predict().
+    nextLogStateProb.fill(-std::numeric_limits<double>::infinity());
+    for (size_t a = 0; a < activeStates.size(); a++)
+    {
+      const size_t i = activeStates[a];
+      if (useSparseTransition)
+      {
+        for (size_t k = sparseTransition.col_ptrs[i];
+             k < sparseTransition.col_ptrs[i + 1]; k++)
+        {
+          const size_t j = sparseTransition.row_indices[k];
+          const double prob = logStateProb[i] + sparseLogTransition[k];
+          if (prob > nextLogStateProb[j])
+          {
+            nextLogStateProb[j] = prob;
+            stateSeqBack(j, t) = i;
+          }
+        }
+      }
+      else
+      {
+        for (size_t j = 0; j < states; j++)
+        {
+          const double prob = logStateProb[i] + logTransition(j, i);
+          if (prob > nextLogStateProb[j])
+          {
+            nextLogStateProb[j] = prob;
+            stateSeqBack(j, t) = i;
+          }
+        }
+      }
+    }
+
+    logStateProb = nextLogStateProb + logProbs.row(t).t();
   }
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  const double logLikelihood = logStateProb.max(index);
+  stateSeq[dataSeq.n_cols - 1] = index;
+  for (size_t t = dataSeq.n_cols - 1; t > 0; t--)
+    stateSeq[t - 1] = stateSeqBack(stateSeq[t], t);
+
+  return logLikelihood;
 }
 
 /**
@@ -847,6 +1140,16 @@ void HMM<Distribution>::ConvertToLogSpace() const
     logTransition = log(transitionProxy);
     recalculateTransition = false;
   }
+
+  if (useSparseTransition && recalculateSparseTransition)
+  {
+    sparseTransition = arma::sp_mat(transitionProxy);
+    sparseTransition.sync();
+    sparseLogTransition.set_size(sparseTransition.n_nonzero);
+    for (size_t k = 0; k < sparseTransition.n_nonzero; ++k)
+      sparseLogTransition[k] = std::log(sparseTransition.values[k]);
+    recalculateSparseTransition = false;
+  }
 }
 
 //! Serialize the HMM.
@@ -871,6 +1174,7 @@ void HMM<Distribution>::load(Archive& ar, const uint32_t /* version */)
   logInitial = log(initial);
   initialProxy = std::move(initial);
   transitionProxy = std::move(transition);
+  recalculateSparseTransition = true;
 }
 
 //! Serialize the HMM.
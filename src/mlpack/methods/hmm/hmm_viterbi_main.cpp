@@ -45,7 +45,15 @@ BINDING_LONG_DESC(
     "hidden state sequence of a given sequence of observations (specified as "
     "'" + PRINT_PARAM_STRING("input") + ", using the Viterbi algorithm.  The "
     "computed state sequence may be saved using the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "For faster decoding, beam pruning can be enabled by specifying a positive "
+    "beam width with " + PRINT_PARAM_STRING("beam") + "; then, at each time "
+    "step, only the states whose log-probability is within the beam width of "
+    "the best state are extended.  This gives an approximation of the most "
+    "probable state sequence.  For HMMs with many states and few possible "
+    "transitions out of each state, the " + PRINT_PARAM_STRING("sparse") +
+    " flag makes the algorithm only consider the nonzero transitions.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -69,6 +77,10 @@ BINDING_SEE_ALSO("mlpack::hmm::HMM class documentation",
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
+PARAM_DOUBLE_IN("beam", "If positive, the width of the beam (in "
+    "log-probability) used to prune states at each time step.  0 means no "
+    "pruning.", "b", 0.0);
+PARAM_FLAG("sparse", "If set, use a sparse transition matrix.", "s");
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -96,8 +108,14 @@ struct Viterbi
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
+    hmm.UseSparseTransition() = IO::HasParam("sparse");
+
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    const double beam = IO::GetParam<double>("beam");
+    if (beam > 0.0)
+      hmm.Predict(dataSeq, sequence, beam);
+    else
+      hmm.Predict(dataSeq, sequence);
 
     // Save output.
     IO::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
@@ -107,6 +125,8 @@ struct Viterbi
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+  RequireParamValue<double>("beam", [](double x) { return x >= 0.0; }, true,
+      "beam width must be non-negative");
 
   IO::GetParam<HMMModel*>("input_model")->PerformAction<Viterbi>((void*) NULL);
 }
@@ -0,0 +1,288 @@
+/**
+ * @file methods/hnsw/hnsw.hpp
+ *
+ * An implementation of approximate nearest neighbor search with hierarchical
+ * navigable small world (HNSW) graphs, as described in the following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Y.A. and Yashunin, D.A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018},
+ *   publisher={IEEE}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_HPP
+#define MLPACK_METHODS_HNSW_HNSW_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSW class builds a hierarchical navigable small world graph on a
+ * reference set and uses it for approximate k-nearest-neighbor search.  Each
+ * point is assigned a random level, with exponentially fewer points on higher
+ * levels, and is linked to its approximate nearest neighbors on every level up
+ * to its own.  A search descends greedily from the top level and then runs a
+ * best-first search with a candidate list of size `ef` on the bottom level;
+ * larger values of `ef` give higher recall at the cost of more distance
+ * evaluations.
+ *
+ * Points can be inserted incrementally with Insert(), and insertion uses
+ * multiple threads when OpenMP is available; with more than one thread the
+ * resulting graph depends on the order in which the threads insert the points.
+ * The distance evaluations for the (squared) Euclidean distance are written so
+ * that the compiler can vectorize them.
+ *
+ * @tparam MetricType The metric to use for the search.
+ */
+template<typename MetricType = metric::EuclideanDistance>
+class HNSW
+{
+ public:
+  /**
+   * Create an empty HNSW index.  Points can be added with Train() or Insert().
+   *
+   * @param maxNeighbors Number of neighbors each point is linked to on each
+   *     level (M in the paper); points on the bottom level can have up to
+   *     twice as many links.  Must be at least 2.
+   * @param efConstruction Size of the candidate list used when inserting
+   *     points.
+   * @param metric Instantiated metric.
+   */
+  HNSW(const size_t maxNeighbors = 16,
+       const size_t efConstruction = 200,
+       MetricType metric = MetricType());
+
+  /**
+   * Build an HNSW index on the given reference set.  To avoid copying the
+   * reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param maxNeighbors Number of neighbors each point is linked to on each
+   *     level; must be at least 2.
+   * @param efConstruction Size of the candidate list used when inserting
+   *     points.
+   * @param metric Instantiated metric.
+   */
+  HNSW(arma::mat referenceSet,
+       const size_t maxNeighbors = 16,
+       const size_t efConstruction = 200,
+       MetricType metric = MetricType());
+
+  /**
+   * Build the index on the given reference set, discarding any points that
+   * were previously inserted.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(arma::mat referenceSet);
+
+  /**
+   * Insert the given points into the index.  The new points get the indices
+   * following those of the points already in the index.
+   *
+   * @param points Points to insert.
+   */
+  void Insert(const arma::mat& points);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point in the query
+   * set.  The output matrices have k rows and one column per query point,
+   * sorted from nearest to furthest.  If fewer than k neighbors are found, the
+   * remaining entries hold the index ReferenceSet().n_cols and the distance
+   * DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param ef Size of the candidate list on the bottom level; values smaller
+   *     than k are increased to k.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 50);
+
+  /**
+   * Search for the approximate k nearest neighbors of each point in the
+   * reference set, not counting each point as its own neighbor.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param ef Size of the candidate list on the bottom level.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t ef = 50);
+
+  //! Get the reference set.
+  const arma::mat& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of neighbors each point is linked to on each level.
+  size_t MaxNeighbors() const { return maxNeighbors; }
+
+  //! Get the size of the candidate list used during insertion.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the size of the candidate list used during insertion.
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the highest level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+
+  //! Get the index of the entry point of the graph.
+  size_t EntryPoint() const { return entryPoint; }
+
+  //! Get the level of the given point.
+  size_t Level(const size_t point) const { return links[point].size() - 1; }
+
+  //! Get the points linked to the given point on the given level.
+  const std::vector<size_t>& Links(const size_t point, const size_t level)
+      const { return links[point][level]; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A candidate neighbor: (distance, index).
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * VisitedSet marks the points visited during one search.  Each thread owns
+   * one, and it is cleared in constant time between searches by changing the
+   * tag of the current search.
+   */
+  class VisitedSet
+  {
+   public:
+    VisitedSet(const size_t size) : tags(size, 0), tag(0) { }
+
+    //! Start a new search.
+    void Clear()
+    {
+      if (++tag == 0)
+      {
+        std::fill(tags.begin(), tags.end(), 0);
+        tag = 1;
+      }
+    }
+
+    //! Mark the given point, returning false if it was already visited.
+    bool Visit(const size_t point)
+    {
+      if (tags[point] == tag)
+        return false;
+      tags[point] = tag;
+      return true;
+    }
+
+   private:
+    std::vector<unsigned int> tags;
+    unsigned int tag;
+  };
+
+  //! Compute the distance between two points with the dimensionality of the
+  //! reference set.
+  double Distance(const double* a, const double* b);
+
+  //! Compute the squared Euclidean distance between two points.
+  static double SquaredEuclidean(const double* a,
+                                 const double* b,
+                                 const size_t dimensionality);
+
+  //! Draw a random level for a new point.
+  size_t RandomLevel() const;
+
+  /**
+   * Insert the given point, which must already be in the reference set and
+   * have its levels allocated, into the graph.
+   */
+  void InsertPoint(const size_t point,
+                   std::vector<std::mutex>& locks,
+                   std::mutex& entryLock,
+                   VisitedSet& visited);
+
+  /**
+   * Run a best-first search for the query on the given level, starting from
+   * the given entry points, and return the (at most) ef closest points found,
+   * sorted by distance.  If locks is not NULL, the links of each point are
+   * read while holding its lock.
+   */
+  std::vector<Candidate> SearchLevel(const double* query,
+                                     const std::vector<Candidate>& entryPoints,
+                                     const size_t ef,
+                                     const size_t level,
+                                     VisitedSet& visited,
+                                     std::vector<std::mutex>* locks);
+
+  //! Search the whole graph for the query, returning the (at most) ef closest
+  //! points found on the bottom level.
+  std::vector<Candidate> SearchGraph(const double* query,
+                                     const size_t ef,
+                                     VisitedSet& visited);
+
+  /**
+   * Keep at most m of the given candidates, which must be sorted by distance,
+   * using the heuristic of the paper: a candidate is kept only if it is closer
+   * to the base point than to every candidate already kept.
+   */
+  void SelectNeighbors(std::vector<Candidate>& candidates, const size_t m);
+
+  //! Reference set.
+  arma::mat referenceSet;
+
+  //! Number of links per point on each level.
+  size_t maxNeighbors;
+
+  //! Size of the candidate list used during insertion.
+  size_t efConstruction;
+
+  //! Multiplier of the level distribution (1 / ln(maxNeighbors)).
+  double levelMultiplier;
+
+  //! The entry point of the graph.
+  size_t entryPoint;
+
+  //! The highest level of the graph.
+  size_t maxLevel;
+
+  //! The links of each point on each of its levels: links[point][level].
+  std::vector<std::vector<std::vector<size_t>>> links;
+
+  //! Instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_impl.hpp"
+
+#endif
@@ -0,0 +1,514 @@
+/**
+ * @file methods/hnsw/hnsw_impl.hpp
+ *
+ * Implementation of the HNSW class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType>
+HNSW<MetricType>::HNSW(const size_t maxNeighbors,
+                       const size_t efConstruction,
+                       MetricType metric) :
+    maxNeighbors(maxNeighbors),
+    efConstruction(efConstruction),
+    levelMultiplier(0.0),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric)
+{
+  if (maxNeighbors < 2)
+  {
+    throw std::invalid_argument("HNSW::HNSW(): maxNeighbors must be at least "
+        "2!");
+  }
+
+  levelMultiplier = 1.0 / std::log((double) maxNeighbors);
+}
+
+template<typename MetricType>
+HNSW<MetricType>::HNSW(arma::mat referenceSet,
+                       const size_t maxNeighbors,
+                       const size_t efConstruction,
+                       MetricType metric) :
+    HNSW(maxNeighbors, efConstruction, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::Train(arma::mat referenceSetIn)
+{
+  referenceSet.reset();
+  links.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  const size_t numPoints = referenceSetIn.n_cols;
+  referenceSet = std::move(referenceSetIn);
+  if (numPoints == 0)
+    return;
+
+  Timer::Start("hnsw_building");
+
+  links.resize(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+    links[i].resize(RandomLevel() + 1);
+
+  // The first point is the initial entry point of the graph.
+  entryPoint = 0;
+  maxLevel = Level(0);
+
+  std::vector<std::mutex> locks(std::min(numPoints, (size_t) 65536));
+  std::mutex entryLock;
+  #pragma omp parallel
+  {
+    VisitedSet visited(numPoints);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 1; i < (omp_size_t) numPoints; ++i)
+      InsertPoint(i, locks, entryLock, visited);
+  }
+
+  Timer::Stop("hnsw_building");
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::Insert(const arma::mat& points)
+{
+  if (points.n_cols == 0)
+    return;
+
+  const size_t oldSize = referenceSet.n_cols;
+  if (oldSize == 0)
+  {
+    Train(points);
+    return;
+  }
+
+  util::CheckSameDimensionality(points, referenceSet, "HNSW::Insert()",
+      "points");
+
+  Timer::Start("hnsw_building");
+
+  referenceSet.insert_cols(oldSize, points);
+  const size_t numPoints = referenceSet.n_cols;
+
+  // The levels of the new points are drawn in order, so that the graph only
+  // depends on the random seed when a single thread is used.
+  links.resize(numPoints);
+  for (size_t i = oldSize; i < numPoints; ++i)
+    links[i].resize(RandomLevel() + 1);
+
+  std::vector<std::mutex> locks(std::min(numPoints, (size_t) 65536));
+  std::mutex entryLock;
+  #pragma omp parallel
+  {
+    VisitedSet visited(numPoints);
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = (omp_size_t) oldSize; i < (omp_size_t) numPoints; ++i)
+      InsertPoint(i, locks, entryLock, visited);
+  }
+
+  Timer::Stop("hnsw_building");
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::Search(const arma::mat& querySet,
+                              const size_t k,
+                              arma::Mat<size_t>& neighbors,
+                              arma::mat& distances,
+                              const size_t ef)
+{
+  util::CheckSameDimensionality(querySet, referenceSet, "HNSW::Search()",
+      "query set");
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSW::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  const size_t searchEf = std::max(ef, k);
+
+  Timer::Start("computing_neighbors");
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const std::vector<Candidate> found = SearchGraph(querySet.colptr(i),
+          searchEf, visited);
+
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, i) = (j < found.size()) ? found[j].second :
+            referenceSet.n_cols;
+        distances(j, i) = (j < found.size()) ? found[j].first : DBL_MAX;
+      }
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::Search(const size_t k,
+                              arma::Mat<size_t>& neighbors,
+                              arma::mat& distances,
+                              const size_t ef)
+{
+  if (k >= referenceSet.n_cols && k > 0)
+  {
+    std::ostringstream oss;
+    oss << "HNSW::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  if (k == 0)
+    return;
+
+  // Each point will find itself, so search for one more neighbor.
+  const size_t searchEf = std::max(ef, k + 1);
+
+  Timer::Start("computing_neighbors");
+
+  #pragma omp parallel
+  {
+    VisitedSet visited(referenceSet.n_cols);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+    {
+      const std::vector<Candidate> found = SearchGraph(referenceSet.colptr(i),
+          searchEf, visited);
+
+      size_t j = 0;
+      for (size_t f = 0; f < found.size() && j < k; ++f)
+      {
+        if (found[f].second == (size_t) i)
+          continue;
+
+        neighbors(j, i) = found[f].second;
+        distances(j, i) = found[f].first;
+        ++j;
+      }
+
+      for (; j < k; ++j)
+      {
+        neighbors(j, i) = referenceSet.n_cols;
+        distances(j, i) = DBL_MAX;
+      }
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename MetricType>
+double HNSW<MetricType>::SquaredEuclidean(const double* a,
+                                          const double* b,
+                                          const size_t dimensionality)
+{
+  // Independent accumulators let the compiler vectorize the loop without
+  // reassociating floating-point additions.
+  double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+  size_t d = 0;
+  for (; d + 4 <= dimensionality; d += 4)
+  {
+    const double diff0 = a[d] - b[d];
+    const double diff1 = a[d + 1] - b[d + 1];
+    const double diff2 = a[d + 2] - b[d + 2];
+    const double diff3 = a[d + 3] - b[d + 3];
+    sum0 += diff0 * diff0;
+    sum1 += diff1 * diff1;
+    sum2 += diff2 * diff2;
+    sum3 += diff3 * diff3;
+  }
+
+  for (; d < dimensionality; ++d)
+  {
+    const double diff = a[d] - b[d];
+    sum0 += diff * diff;
+  }
+
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+template<typename MetricType>
+double HNSW<MetricType>::Distance(const double* a, const double* b)
+{
+  const size_t dimensionality = referenceSet.n_rows;
+  if (std::is_same<MetricType, metric::EuclideanDistance>::value)
+    return std::sqrt(SquaredEuclidean(a, b, dimensionality));
+  if (std::is_same<MetricType, metric::SquaredEuclideanDistance>::value)
+    return SquaredEuclidean(a, b, dimensionality);
+
+  // Use aliases to the memory of the points for other metrics.
+  const arma::vec aVec(const_cast<double*>(a), dimensionality, false, true);
+  const arma::vec bVec(const_cast<double*>(b), dimensionality, false, true);
+  return metric.Evaluate(aVec, bVec);
+}
+
+template<typename MetricType>
+size_t HNSW<MetricType>::RandomLevel() const
+{
+  // 1 - Random() is in (0, 1], so the logarithm is finite.
+  return (size_t) std::floor(-std::log(1.0 - math::Random()) *
+      levelMultiplier);
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::InsertPoint(const size_t point,
+                                   std::vector<std::mutex>& locks,
+                                   std::mutex& entryLock,
+                                   VisitedSet& visited)
+{
+  const size_t level = links[point].size() - 1;
+  const double* query = referenceSet.colptr(point);
+
+  // If the point becomes the new top of the graph, no other insertion may
+  // start until it is linked, so the entry lock is held for the whole
+  // insertion; this is rare, since few points have a high level.
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  const size_t currentEntry = entryPoint;
+  const size_t currentMaxLevel = maxLevel;
+  if (level <= currentMaxLevel)
+    entryGuard.unlock();
+
+  std::vector<Candidate> entries(1, Candidate(Distance(query,
+      referenceSet.colptr(currentEntry)), currentEntry));
+
+  // Descend greedily through the levels above the level of the point.
+  for (size_t l = currentMaxLevel; l > level; --l)
+    entries = SearchLevel(query, entries, 1, l, visited, &locks);
+
+  for (size_t l = std::min(level, currentMaxLevel) + 1; l-- > 0; )
+  {
+    const std::vector<Candidate> found = SearchLevel(query, entries,
+        efConstruction, l, visited, &locks);
+
+    // Another thread may already have linked the point, so it can find
+    // itself.
+    std::vector<Candidate> selected;
+    selected.reserve(found.size());
+    for (size_t i = 0; i < found.size(); ++i)
+      if (found[i].second != point)
+        selected.push_back(found[i]);
+    SelectNeighbors(selected, maxNeighbors);
+
+    {
+      std::lock_guard<std::mutex> guard(locks[point % locks.size()]);
+      links[point][l].resize(selected.size());
+      for (size_t i = 0; i < selected.size(); ++i)
+        links[point][l][i] = selected[i].second;
+    }
+
+    // Link the selected neighbors back to the point, pruning their links if
+    // they have too many.
+    const size_t maxLinks = (l == 0) ? 2 * maxNeighbors : maxNeighbors;
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+      const size_t neighbor = selected[i].second;
+      std::lock_guard<std::mutex> guard(locks[neighbor % locks.size()]);
+      std::vector<size_t>& neighborLinks = links[neighbor][l];
+      if (neighborLinks.size() < maxLinks)
+      {
+        neighborLinks.push_back(point);
+        continue;
+      }
+
+      std::vector<Candidate> candidates;
+      candidates.reserve(neighborLinks.size() + 1);
+      candidates.push_back(Candidate(selected[i].first, point));
+      const double* neighborPoint = referenceSet.colptr(neighbor);
+      for (size_t j = 0; j < neighborLinks.size(); ++j)
+      {
+        candidates.push_back(Candidate(Distance(neighborPoint,
+            referenceSet.colptr(neighborLinks[j])), neighborLinks[j]));
+      }
+
+      std::sort(candidates.begin(), candidates.end());
+      SelectNeighbors(candidates, maxLinks);
+      neighborLinks.resize(candidates.size());
+      for (size_t j = 0; j < candidates.size(); ++j)
+        neighborLinks[j] = candidates[j].second;
+    }
+
+    entries = found;
+  }
+
+  if (level > currentMaxLevel)
+  {
+    // The entry lock is still held.
+    entryPoint = point;
+    maxLevel = level;
+  }
+}
+
+template<typename MetricType>
+std::vector<typename HNSW<MetricType>::Candidate>
+HNSW<MetricType>::SearchLevel(const double* query,
+                              const std::vector<Candidate>& entryPoints,
+                              const size_t ef,
+                              const size_t level,
+                              VisitedSet& visited,
+                              std::vector<std::mutex>* locks)
+{
+  visited.Clear();
+
+  // Candidates to expand, closest first, and results, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> results;
+  for (size_t i = 0; i < entryPoints.size(); ++i)
+  {
+    if (!visited.Visit(entryPoints[i].second))
+      continue;
+
+    candidates.push(entryPoints[i]);
+    results.push(entryPoints[i]);
+    if (results.size() > ef)
+      results.pop();
+  }
+
+  std::vector<size_t> lockedLinks;
+  while (!candidates.empty())
+  {
+    const Candidate current = candidates.top();
+    if (current.first > results.top().first)
+      break;
+    candidates.pop();
+
+    // During construction the links may be modified by other threads, so
+    // they are copied while holding the lock of the point.
+    const std::vector<size_t>* currentLinks = &links[current.second][level];
+    if (locks)
+    {
+      std::lock_guard<std::mutex> guard(
+          (*locks)[current.second % locks->size()]);
+      lockedLinks = *currentLinks;
+      currentLinks = &lockedLinks;
+    }
+
+    for (size_t i = 0; i < currentLinks->size(); ++i)
+    {
+      const size_t neighbor = (*currentLinks)[i];
+      if (!visited.Visit(neighbor))
+        continue;
+
+      const double distance = Distance(query, referenceSet.colptr(neighbor));
+      if (results.size() < ef || distance < results.top().first)
+      {
+        candidates.push(Candidate(distance, neighbor));
+        results.push(Candidate(distance, neighbor));
+        if (results.size() > ef)
+          results.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> found(results.size());
+  for (size_t i = found.size(); i > 0; --i)
+  {
+    found[i - 1] = results.top();
+    results.pop();
+  }
+
+  return found;
+}
+
+template<typename MetricType>
+std::vector<typename HNSW<MetricType>::Candidate>
+HNSW<MetricType>::SearchGraph(const double* query,
+                              const size_t ef,
+                              VisitedSet& visited)
+{
+  std::vector<Candidate> entries(1, Candidate(Distance(query,
+      referenceSet.colptr(entryPoint)), entryPoint));
+
+  for (size_t l = maxLevel; l > 0; --l)
+    entries = SearchLevel(query, entries, 1, l, visited, NULL);
+
+  return SearchLevel(query, entries, ef, 0, visited, NULL);
+}
+
+template<typename MetricType>
+void HNSW<MetricType>::SelectNeighbors(std::vector<Candidate>& candidates,
+                                       const size_t m)
+{
+  if (candidates.size() <= m)
+    return;
+
+  std::vector<Candidate> selected;
+  selected.reserve(m);
+  for (size_t i = 0; i < candidates.size() && selected.size() < m; ++i)
+  {
+    const double* candidate = referenceSet.colptr(candidates[i].second);
+    bool keep = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (Distance(candidate, referenceSet.colptr(selected[j].second)) <
+          candidates[i].first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(candidates[i]);
+  }
+
+  candidates.swap(selected);
+}
+
+template<typename MetricType>
+template<typename Archive>
+void HNSW<MetricType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(maxNeighbors));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(levelMultiplier));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+  ar(CEREAL_NVP(links));
+  ar(CEREAL_NVP(metric));
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * @file methods/hnsw/hnsw_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors using a hierarchical
+ * navigable small world (HNSW) graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/io.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "hnsw.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Program Name.
+BINDING_NAME("K-Approximate-Nearest-Neighbor Search with HNSW");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of approximate k-nearest-neighbor search with "
+    "hierarchical navigable small world (HNSW) graphs.  Given a set of "
+    "reference points and a set of query points, this will compute the k "
+    "approximate nearest neighbors of each query point in the reference set; "
+    "models can be saved for future use.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world (HNSW) graph built "
+    "on the reference set.  You may specify a separate set of reference points "
+    "and query points, or just a reference set which will be used as both the "
+    "reference and query set."
+    "\n\n"
+    "The graph links each point to " + PRINT_PARAM_STRING("max_neighbors") +
+    " approximate nearest neighbors on each of its levels, found with a "
+    "candidate list of size " + PRINT_PARAM_STRING("ef_construction") + ".  "
+    "Searches use a candidate list of size " + PRINT_PARAM_STRING("ef") + "; "
+    "increasing any of these parameters increases the recall of the search at "
+    "the cost of more computation.  When a model is given with " +
+    PRINT_PARAM_STRING("input_model") + ", the points given with " +
+    PRINT_PARAM_STRING("reference") + " are inserted into it.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "The graph depends on random levels drawn for each point, so the " +
+    PRINT_PARAM_STRING("seed") + " parameter can be specified to set the "
+    "random seed.  When more than one thread is used, the graph also depends "
+    "on the order in which the points are inserted by the threads.");
+
+// See also...
+BINDING_SEE_ALSO("@knn", "#knn");
+BINDING_SEE_ALSO("@lsh", "#lsh");
+BINDING_SEE_ALSO("Efficient and robust approximate nearest neighbor search "
+        "using hierarchical navigable small world graphs (pdf)",
+        "https://arxiv.org/pdf/1603.09320.pdf");
+BINDING_SEE_ALSO("mlpack::neighbor::HNSW C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1HNSW.html");
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSW<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSW<>, "output_model", "Output for trained HNSW model.", "M");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("max_neighbors", "Number of neighbors each point is linked to on "
+    "each level of the graph.", "N", 16);
+PARAM_INT_IN("ef_construction", "Size of the candidate list used when building "
+    "the graph.", "c", 200);
+PARAM_INT_IN("ef", "Size of the candidate list used when searching; values "
+    "smaller than k are increased to k.", "e", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (IO::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) IO::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (IO::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("max_neighbors", [](int x) { return x >= 2; }, true,
+      "max neighbors must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x > 0; }, true,
+      "ef must be greater than 0");
+
+  RequireAtLeastOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "ef");
+
+  ReportIgnoredParam({{ "input_model", true }}, "max_neighbors");
+  ReportIgnoredParam({{ "input_model", true }}, "ef_construction");
+
+  const size_t k = (size_t) IO::GetParam<int>("k");
+  const size_t ef = (size_t) IO::GetParam<int>("ef");
+
+  HNSW<>* hnsw;
+  if (IO::HasParam("input_model"))
+  {
+    hnsw = IO::GetParam<HNSW<>*>("input_model");
+    if (IO::HasParam("reference"))
+    {
+      Log::Info << "Inserting reference data from "
+          << IO::GetPrintableParam<arma::mat>("reference") << " into the "
+          << "model." << endl;
+      hnsw->Insert(IO::GetParam<arma::mat>("reference"));
+    }
+  }
+  else
+  {
+    const size_t maxNeighbors = (size_t) IO::GetParam<int>("max_neighbors");
+    const size_t efConstruction = (size_t) IO::GetParam<int>("ef_construction");
+
+    Log::Info << "Building HNSW graph with " << maxNeighbors << " neighbors "
+        << "per level on reference data from "
+        << IO::GetPrintableParam<arma::mat>("reference") << "." << endl;
+    hnsw = new HNSW<>(maxNeighbors, efConstruction);
+    hnsw->Train(std::move(IO::GetParam<arma::mat>("reference")));
+  }
+
+  if (IO::HasParam("k"))
+  {
+    const size_t numPoints = hnsw->ReferenceSet().n_cols;
+    // The reference set does not count each point as its own neighbor.
+    if ((IO::HasParam("query") && k > numPoints) ||
+        (!IO::HasParam("query") && k >= numPoints))
+    {
+      if (!IO::HasParam("input_model"))
+        delete hnsw;
+      Log::Fatal << "Invalid k: " << k << "; there are only " << numPoints
+          << " reference points to search!" << endl;
+    }
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+
+    Log::Info << "Computing " << k << " approximate nearest neighbors." << endl;
+    if (IO::HasParam("query"))
+    {
+      Log::Info << "Loaded query data from "
+          << IO::GetPrintableParam<arma::mat>("query") << "." << endl;
+      hnsw->Search(IO::GetParam<arma::mat>("query"), k, neighbors, distances,
+          ef);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances, ef);
+    }
+
+    Log::Info << "Neighbors computed." << endl;
+
+    IO::GetParam<arma::mat>("distances") = std::move(distances);
+    IO::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  IO::GetParam<HNSW<>*>("output_model") = hnsw;
+}
@@ -0,0 +1,458 @@
+/**
+ * @file methods/hoeffding_trees/adaptive_hoeffding_tree.hpp
+ *
+ * A Hoeffding tree for streams whose concept changes over time, which replaces
+ * subtrees that stop predicting well and bounds the number of leaves that
+ * collect split statistics.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_ADAPTIVE_HOEFFDING_TREE_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_ADAPTIVE_HOEFFDING_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/dataset_mapper.hpp>
+#include "gini_impurity.hpp"
+#include "hoeffding_numeric_split.hpp"
+#include "hoeffding_categorical_split.hpp"
+#include "ddm_drift_detector.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The AdaptiveHoeffdingTree is a streaming Hoeffding tree (see HoeffdingTree)
+ * meant to be trained on a stream forever.  It handles two problems that the
+ * HoeffdingTree has on long streams:
+ *
+ *  - Concept drift.  Every internal node monitors the error of its subtree on
+ *    the points that reach it with a drift detector.  When a drift is
+ *    detected, an alternate subtree starts growing at that node from the
+ *    following points.  After alternatePeriod more points, the alternate
+ *    replaces the subtree if it made fewer errors on those points; otherwise
+ *    it is discarded.  This is the scheme of the Hoeffding adaptive tree:
+ *
+ * @code
+ * @inproceedings{bifet2009adaptive,
+ *   title={Adaptive Learning from Evolving Data Streams},
+ *   author={Bifet, A. and Gavald{\`a}, R.},
+ *   booktitle={Advances in Intelligent Data Analysis VIII (IDA 2009)},
+ *   pages={249--260},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ *  - Memory.  The split statistics of the leaves are what makes a Hoeffding
+ *    tree large.  If maxActiveLeaves is nonzero, then every checkInterval
+ *    points the leaves are ranked by their promise (the number of training
+ *    points they misclassify, as in the VFDT paper of Domingos and Hulten), and
+ *    only the maxActiveLeaves best leaves keep their statistics.  The others
+ *    are deactivated: they keep predicting their majority class and counting
+ *    their points, and are reactivated if they become promising again.  Leaves
+ *    that have seen fewer than checkInterval points are ranked first, so that
+ *    new leaves get a chance to collect statistics.
+ *
+ * The tree is trained one point at a time (or on a matrix of points in stream
+ * order) and the template parameters are the same as for the HoeffdingTree,
+ * plus the type of the drift detector.
+ *
+ * @tparam FitnessFunction Fitness function to use.
+ * @tparam NumericSplitType Technique for splitting numeric features.
+ * @tparam CategoricalSplitType Technique for splitting categorical features.
+ * @tparam DriftDetectorType Drift detector to monitor the error of each
+ *     internal node with.
+ */
+template<typename FitnessFunction = GiniImpurity,
+         template<typename> class NumericSplitType =
+             HoeffdingDoubleNumericSplit,
+         template<typename> class CategoricalSplitType =
+             HoeffdingCategoricalSplit,
+         typename DriftDetectorType = DDMDriftDetector
+>
+class AdaptiveHoeffdingTree
+{
+ public:
+  //! Allow access to the numeric split type.
+  typedef NumericSplitType<FitnessFunction> NumericSplit;
+  //! Allow access to the categorical split type.
+  typedef CategoricalSplitType<FitnessFunction> CategoricalSplit;
+
+  /**
+   * Construct the tree with the given parameters and train it on the given
+   * points, in stream order.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param maxActiveLeaves Maximum number of leaves that collect split
+   *      statistics (0 means no limit).
+   * @param alternatePeriod Number of points an alternate subtree is compared
+   *      to the subtree it may replace for.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check,
+   *      and between each enforcement of maxActiveLeaves.
+   * @param minSamples If the node has seen this many points or fewer, no split
+   *      will be allowed.
+   * @param detectorIn Drift detector to copy for each internal node.
+   * @param categoricalSplitIn Optional instantiated categorical split object.
+   * @param numericSplitIn Optional instantiated numeric split object.
+   */
+  template<typename MatType>
+  AdaptiveHoeffdingTree(const MatType& data,
+                        const data::DatasetInfo& datasetInfo,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        const size_t maxActiveLeaves = 0,
+                        const size_t alternatePeriod = 1000,
+                        const double successProbability = 0.95,
+                        const size_t maxSamples = 0,
+                        const size_t checkInterval = 100,
+                        const size_t minSamples = 100,
+                        const DriftDetectorType& detectorIn =
+                            DriftDetectorType(),
+                        const CategoricalSplit& categoricalSplitIn =
+                            CategoricalSplit(0, 0),
+                        const NumericSplit& numericSplitIn = NumericSplit(0));
+
+  /**
+   * Construct the tree with the given parameters, but training on no data.
+   * See the other constructor for the meaning of the parameters.
+   */
+  AdaptiveHoeffdingTree(const data::DatasetInfo& datasetInfo,
+                        const size_t numClasses,
+                        const size_t maxActiveLeaves = 0,
+                        const size_t alternatePeriod = 1000,
+                        const double successProbability = 0.95,
+                        const size_t maxSamples = 0,
+                        const size_t checkInterval = 100,
+                        const size_t minSamples = 100,
+                        const DriftDetectorType& detectorIn =
+                            DriftDetectorType(),
+                        const CategoricalSplit& categoricalSplitIn =
+                            CategoricalSplit(0, 0),
+                        const NumericSplit& numericSplitIn = NumericSplit(0));
+
+  /**
+   * Construct an empty tree, which can be loaded with serialize().
+   */
+  AdaptiveHoeffdingTree();
+
+  //! Copy another tree.
+  AdaptiveHoeffdingTree(const AdaptiveHoeffdingTree& other);
+  //! Take ownership of another tree.
+  AdaptiveHoeffdingTree(AdaptiveHoeffdingTree&& other);
+  //! Copy another tree.
+  AdaptiveHoeffdingTree& operator=(const AdaptiveHoeffdingTree& other);
+  //! Take ownership of another tree.
+  AdaptiveHoeffdingTree& operator=(AdaptiveHoeffdingTree&& other);
+
+  //! Clean up memory.
+  ~AdaptiveHoeffdingTree();
+
+  /**
+   * Train on a set of points, one after another, with the given labels.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train on a single point, with the given label.
+   *
+   * @param point Point to train on.
+   * @param label Label of point to train on.
+   */
+  template<typename VecType>
+  void Train(const VecType& point, const size_t label);
+
+  /**
+   * Classify the given point.  The predicted label is returned.
+   *
+   * @param point Point to classify.
+   * @return Predicted label of point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return an estimate of the probability
+   * that the prediction is correct (the probability of the majority class of
+   * the training points in the leaf that the point goes to).
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of point.
+   * @param probability An estimate of the probability that the prediction is
+   *      correct.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point, size_t& prediction, double& probability)
+      const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and also return an estimate of the probability
+   * that each prediction is correct.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   * @param probabilities Probability estimates for each predicted label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  //! Get the number of nodes of the tree, not counting alternate subtrees.
+  size_t NumNodes() const;
+  //! Get the number of leaves, including those of alternate subtrees.
+  size_t NumLeaves() const;
+  //! Get the number of leaves that collect split statistics.
+  size_t NumActiveLeaves() const;
+  //! Get the number of alternate subtrees currently growing.
+  size_t NumAlternates() const;
+  //! Get the number of subtrees that have been replaced by alternates.
+  size_t NumReplacements() const { return numReplacements; }
+
+  //! Get the number of points the tree was trained on.
+  size_t NumSamples() const { return numSamples; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the splitting dimension of the root (size_t(-1) if no split).
+  size_t SplitDimension() const { return root->splitDimension; }
+
+  //! Get the maximum number of active leaves (0 means no limit).
+  size_t MaxActiveLeaves() const { return maxActiveLeaves; }
+  //! Modify the maximum number of active leaves (0 means no limit).
+  size_t& MaxActiveLeaves() { return maxActiveLeaves; }
+
+  //! Get the number of points alternate subtrees are evaluated on.
+  size_t AlternatePeriod() const { return alternatePeriod; }
+  //! Modify the number of points alternate subtrees are evaluated on.
+  size_t& AlternatePeriod() { return alternatePeriod; }
+
+  //! Get the confidence required for a split.
+  double SuccessProbability() const { return successProbability; }
+  //! Modify the confidence required for a split.
+  double& SuccessProbability() { return successProbability; }
+
+  //! Get the maximum number of samples before a split is forced.
+  size_t MaxSamples() const { return maxSamples; }
+  //! Modify the maximum number of samples before a split is forced.
+  size_t& MaxSamples() { return maxSamples; }
+
+  //! Get the number of samples before a split check is performed.
+  size_t CheckInterval() const { return checkInterval; }
+  //! Modify the number of samples before a split check is performed.
+  size_t& CheckInterval() { return checkInterval; }
+
+  //! Get the minimum number of samples for a split.
+  size_t MinSamples() const { return minSamples; }
+  //! Modify the minimum number of samples for a split.
+  size_t& MinSamples() { return minSamples; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * A node of the tree.  Leaves hold the split statistics (if they are
+   * active), and internal nodes hold their split, their children, the drift
+   * detector for their subtree, and possibly an alternate subtree.
+   */
+  struct Node
+  {
+    Node() :
+        splitDimension(size_t(-1)),
+        active(true),
+        numSamples(0),
+        activeSamples(0),
+        majorityClass(0),
+        majorityProbability(0.0),
+        categoricalSplit(0),
+        alternate(NULL),
+        alternateSamples(0),
+        errors(0),
+        alternateErrors(0)
+    { }
+
+    Node(const Node& other) :
+        splitDimension(other.splitDimension),
+        active(other.active),
+        numSamples(other.numSamples),
+        activeSamples(other.activeSamples),
+        classCounts(other.classCounts),
+        majorityClass(other.majorityClass),
+        majorityProbability(other.majorityProbability),
+        numericSplits(other.numericSplits),
+        categoricalSplits(other.categoricalSplits),
+        categoricalSplit(other.categoricalSplit),
+        numericSplit(other.numericSplit),
+        detector(other.detector),
+        alternate(other.alternate ? new Node(*other.alternate) : NULL),
+        alternateSamples(other.alternateSamples),
+        errors(other.errors),
+        alternateErrors(other.alternateErrors)
+    {
+      for (size_t i = 0; i < other.children.size(); ++i)
+        children.push_back(new Node(*other.children[i]));
+    }
+
+    ~Node()
+    {
+      for (size_t i = 0; i < children.size(); ++i)
+        delete children[i];
+      delete alternate;
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      if (cereal::is_loading<Archive>())
+      {
+        for (size_t i = 0; i < children.size(); ++i)
+          delete children[i];
+        children.clear();
+        delete alternate;
+        alternate = NULL;
+      }
+
+      ar(CEREAL_NVP(splitDimension));
+      ar(CEREAL_NVP(active));
+      ar(CEREAL_NVP(numSamples));
+      ar(CEREAL_NVP(activeSamples));
+      ar(CEREAL_NVP(classCounts));
+      ar(CEREAL_NVP(majorityClass));
+      ar(CEREAL_NVP(majorityProbability));
+      ar(CEREAL_NVP(numericSplits));
+      ar(CEREAL_NVP(categoricalSplits));
+      ar(CEREAL_NVP(categoricalSplit));
+      ar(CEREAL_NVP(numericSplit));
+      ar(CEREAL_NVP(detector));
+      ar(CEREAL_VECTOR_POINTER(children));
+      ar(CEREAL_POINTER(alternate));
+      ar(CEREAL_NVP(alternateSamples));
+      ar(CEREAL_NVP(errors));
+      ar(CEREAL_NVP(alternateErrors));
+    }
+
+    //! The dimension this node splits on (size_t(-1) for a leaf).
+    size_t splitDimension;
+    //! Whether this leaf collects split statistics.
+    bool active;
+    //! The number of points this leaf was trained on.
+    size_t numSamples;
+    //! The number of points this leaf was trained on since it was activated.
+    size_t activeSamples;
+    //! The number of points of each class this leaf was trained on.
+    arma::Col<size_t> classCounts;
+    //! The majority class of this leaf.
+    size_t majorityClass;
+    //! The fraction of the points of this leaf in the majority class.
+    double majorityProbability;
+    //! The statistics of each numeric dimension (active leaves only).
+    std::vector<NumericSplit> numericSplits;
+    //! The statistics of each categorical dimension (active leaves only).
+    std::vector<CategoricalSplit> categoricalSplits;
+    //! The split of this node, if it splits on a categorical dimension.
+    typename CategoricalSplit::SplitInfo categoricalSplit;
+    //! The split of this node, if it splits on a numeric dimension.
+    typename NumericSplit::SplitInfo numericSplit;
+    //! The children of this node.
+    std::vector<Node*> children;
+    //! The drift detector for the predictions of this subtree.
+    DriftDetectorType detector;
+    //! The alternate subtree, if one is growing.
+    Node* alternate;
+    //! The number of points the alternate subtree has been compared on.
+    size_t alternateSamples;
+    //! The errors of this subtree on those points.
+    size_t errors;
+    //! The errors of the alternate subtree on those points.
+    size_t alternateErrors;
+  };
+
+  //! Create a new active leaf.
+  Node* NewLeaf() const;
+
+  //! Train the given (sub)tree on a point; the subtree may be replaced.
+  template<typename VecType>
+  void Train(Node*& node, const VecType& point, const size_t label);
+
+  //! Check whether the given leaf should split, and split it if so.
+  void SplitCheck(Node& node);
+
+  //! Give split statistics to the given leaf.
+  void Activate(Node& node) const;
+
+  //! Free the split statistics of the given leaf.
+  static void Deactivate(Node& node);
+
+  //! Keep only the maxActiveLeaves most promising leaves active.
+  void EnforceMaxActiveLeaves();
+
+  //! Collect the leaves of the given subtree, including alternate subtrees.
+  static void Leaves(Node* node, std::vector<Node*>& leaves);
+
+  //! Find the child of the given node that the given point goes to.
+  template<typename VecType>
+  size_t CalculateDirection(const Node& node, const VecType& point) const;
+
+  //! Find the leaf of the given subtree that the given point goes to.
+  template<typename VecType>
+  const Node& Leaf(const Node& node, const VecType& point) const;
+
+  //! The information on the dimensions.
+  data::DatasetInfo datasetInfo;
+  //! The number of classes.
+  size_t numClasses;
+  //! The maximum number of active leaves.
+  size_t maxActiveLeaves;
+  //! The number of points alternate subtrees are evaluated on.
+  size_t alternatePeriod;
+  //! The required probability of success for a split to be performed.
+  double successProbability;
+  //! The maximum number of samples a leaf can see before splitting.
+  size_t maxSamples;
+  //! The number of samples between split checks.
+  size_t checkInterval;
+  //! The minimum number of samples for splitting.
+  size_t minSamples;
+  //! The drift detector to copy for new nodes.
+  DriftDetectorType detectorIn;
+  //! The categorical split to copy for new leaves.
+  CategoricalSplit categoricalSplitIn;
+  //! The numeric split to copy for new leaves.
+  NumericSplit numericSplitIn;
+
+  //! The root of the tree.
+  Node* root;
+  //! The number of points the tree was trained on.
+  size_t numSamples;
+  //! The number of subtrees replaced by alternates.
+  size_t numReplacements;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#include "adaptive_hoeffding_tree_impl.hpp"
+
+#endif
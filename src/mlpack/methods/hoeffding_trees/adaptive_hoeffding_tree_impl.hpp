@@ -0,0 +1,765 @@
+/**
+ * @file methods/hoeffding_trees/adaptive_hoeffding_tree_impl.hpp
+ *
+ * Implementation of the AdaptiveHoeffdingTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_ADAPTIVE_HOEFFDING_TREE_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_ADAPTIVE_HOEFFDING_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "adaptive_hoeffding_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename MatType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::AdaptiveHoeffdingTree(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t maxActiveLeaves,
+    const size_t alternatePeriod,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples,
+    const DriftDetectorType& detectorIn,
+    const CategoricalSplit& categoricalSplitIn,
+    const NumericSplit& numericSplitIn) :
+    AdaptiveHoeffdingTree(datasetInfo, numClasses, maxActiveLeaves,
+        alternatePeriod, successProbability, maxSamples, checkInterval,
+        minSamples, detectorIn, categoricalSplitIn, numericSplitIn)
+{
+  Train(data, labels);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::AdaptiveHoeffdingTree(
+    const data::DatasetInfo& datasetInfo,
+    const size_t numClasses,
+    const size_t maxActiveLeaves,
+    const size_t alternatePeriod,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples,
+    const DriftDetectorType& detectorIn,
+    const CategoricalSplit& categoricalSplitIn,
+    const NumericSplit& numericSplitIn) :
+    datasetInfo(datasetInfo),
+    numClasses(numClasses),
+    maxActiveLeaves(maxActiveLeaves),
+    alternatePeriod(alternatePeriod),
+    successProbability(successProbability),
+    maxSamples((maxSamples == 0) ? size_t(-1) : maxSamples),
+    checkInterval(checkInterval),
+    minSamples(minSamples),
+    detectorIn(detectorIn),
+    categoricalSplitIn(categoricalSplitIn),
+    numericSplitIn(numericSplitIn),
+    root(NULL),
+    numSamples(0),
+    numReplacements(0)
+{
+  root = NewLeaf();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::AdaptiveHoeffdingTree() :
+    numClasses(0),
+    maxActiveLeaves(0),
+    alternatePeriod(1000),
+    successProbability(0.95),
+    maxSamples(size_t(-1)),
+    checkInterval(100),
+    minSamples(100),
+    categoricalSplitIn(0, 0),
+    numericSplitIn(0),
+    root(new Node()),
+    numSamples(0),
+    numReplacements(0)
+{
+  // Nothing to do.
+}
+
+// Copy constructor.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::AdaptiveHoeffdingTree(
+    const AdaptiveHoeffdingTree& other) :
+    datasetInfo(other.datasetInfo),
+    numClasses(other.numClasses),
+    maxActiveLeaves(other.maxActiveLeaves),
+    alternatePeriod(other.alternatePeriod),
+    successProbability(other.successProbability),
+    maxSamples(other.maxSamples),
+    checkInterval(other.checkInterval),
+    minSamples(other.minSamples),
+    detectorIn(other.detectorIn),
+    categoricalSplitIn(other.categoricalSplitIn),
+    numericSplitIn(other.numericSplitIn),
+    root(new Node(*other.root)),
+    numSamples(other.numSamples),
+    numReplacements(other.numReplacements)
+{
+  // Nothing to do.
+}
+
+// Move constructor.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::AdaptiveHoeffdingTree(AdaptiveHoeffdingTree&& other) :
+    datasetInfo(std::move(other.datasetInfo)),
+    numClasses(other.numClasses),
+    maxActiveLeaves(other.maxActiveLeaves),
+    alternatePeriod(other.alternatePeriod),
+    successProbability(other.successProbability),
+    maxSamples(other.maxSamples),
+    checkInterval(other.checkInterval),
+    minSamples(other.minSamples),
+    detectorIn(std::move(other.detectorIn)),
+    categoricalSplitIn(std::move(other.categoricalSplitIn)),
+    numericSplitIn(std::move(other.numericSplitIn)),
+    root(other.root),
+    numSamples(other.numSamples),
+    numReplacements(other.numReplacements)
+{
+  other.root = new Node();
+  other.numSamples = 0;
+  other.numReplacements = 0;
+}
+
+// Copy assignment operator.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>&
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::operator=(const AdaptiveHoeffdingTree& other)
+{
+  if (this != &other)
+  {
+    delete root;
+
+    datasetInfo = other.datasetInfo;
+    numClasses = other.numClasses;
+    maxActiveLeaves = other.maxActiveLeaves;
+    alternatePeriod = other.alternatePeriod;
+    successProbability = other.successProbability;
+    maxSamples = other.maxSamples;
+    checkInterval = other.checkInterval;
+    minSamples = other.minSamples;
+    detectorIn = other.detectorIn;
+    categoricalSplitIn = other.categoricalSplitIn;
+    numericSplitIn = other.numericSplitIn;
+    root = new Node(*other.root);
+    numSamples = other.numSamples;
+    numReplacements = other.numReplacements;
+  }
+  return *this;
+}
+
+// Move assignment operator.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>&
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::operator=(AdaptiveHoeffdingTree&& other)
+{
+  if (this != &other)
+  {
+    datasetInfo = std::move(other.datasetInfo);
+    numClasses = other.numClasses;
+    maxActiveLeaves = other.maxActiveLeaves;
+    alternatePeriod = other.alternatePeriod;
+    successProbability = other.successProbability;
+    maxSamples = other.maxSamples;
+    checkInterval = other.checkInterval;
+    minSamples = other.minSamples;
+    detectorIn = std::move(other.detectorIn);
+    categoricalSplitIn = std::move(other.categoricalSplitIn);
+    numericSplitIn = std::move(other.numericSplitIn);
+    std::swap(root, other.root);
+    numSamples = other.numSamples;
+    numReplacements = other.numReplacements;
+
+    other.numSamples = 0;
+    other.numReplacements = 0;
+  }
+  return *this;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::~AdaptiveHoeffdingTree()
+{
+  delete root;
+}
+
+//! Train on a set of points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename MatType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels)
+{
+  util::CheckSameSizes(data, labels, "AdaptiveHoeffdingTree::Train()");
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+    Train(data.col(i), labels[i]);
+}
+
+//! Train on one point.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Train(
+    const VecType& point,
+    const size_t label)
+{
+  Train(root, point, label);
+
+  ++numSamples;
+  if (maxActiveLeaves > 0 && numSamples % checkInterval == 0)
+    EnforceMaxActiveLeaves();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Train(
+    Node*& node,
+    const VecType& point,
+    const size_t label)
+{
+  if (node->splitDimension != size_t(-1))
+  {
+    // Check how well this subtree (and its alternate, if there is one) predicts
+    // the point, before training on it.
+    const bool error = (Leaf(*node, point).majorityClass != label);
+    if (node->alternate)
+    {
+      ++node->alternateSamples;
+      if (error)
+        ++node->errors;
+      if (Leaf(*node->alternate, point).majorityClass != label)
+        ++node->alternateErrors;
+
+      if (node->alternateSamples >= alternatePeriod)
+      {
+        Node* alternate = node->alternate;
+        node->alternate = NULL;
+        if (node->alternateErrors < node->errors)
+        {
+          // The alternate predicts the current concept better, so it replaces
+          // this subtree.
+          delete node;
+          node = alternate;
+          ++numReplacements;
+        }
+        else
+        {
+          delete alternate;
+          node->alternateSamples = 0;
+          node->errors = 0;
+          node->alternateErrors = 0;
+          node->detector.Reset();
+        }
+      }
+    }
+    else if (node->detector.Update(error))
+    {
+      // The error of this subtree has increased; start growing a subtree for
+      // the new concept.
+      node->alternate = NewLeaf();
+    }
+  }
+
+  if (node->splitDimension == size_t(-1))
+  {
+    ++node->numSamples;
+    ++node->classCounts[label];
+    node->majorityClass = node->classCounts.index_max();
+    node->majorityProbability = double(node->classCounts[node->majorityClass]) /
+        node->numSamples;
+
+    // Inactive leaves don't collect statistics.
+    if (!node->active)
+      return;
+
+    ++node->activeSamples;
+    size_t numericIndex = 0;
+    size_t categoricalIndex = 0;
+    for (size_t i = 0; i < point.n_rows; ++i)
+    {
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+        node->categoricalSplits[categoricalIndex++].Train(point[i], label);
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+        node->numericSplits[numericIndex++].Train(point[i], label);
+    }
+
+    if (node->activeSamples % checkInterval == 0)
+      SplitCheck(*node);
+  }
+  else
+  {
+    // Pass the point to the alternate subtree and to the relevant child.
+    if (node->alternate)
+      Train(node->alternate, point, label);
+    Train(node->children[CalculateDirection(*node, point)], point, label);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::SplitCheck(Node& node)
+{
+  // If not enough points have been seen, we cannot split.
+  if (node.activeSamples <= minSamples)
+    return;
+
+  // Calculate epsilon, the value we need things to be greater than.
+  const double rSquared = std::pow(FitnessFunction::Range(numClasses), 2.0);
+  const double epsilon = std::sqrt(rSquared *
+      std::log(1.0 / (1.0 - successProbability)) / (2 * node.activeSamples));
+
+  // Find the best and second best possible splits.
+  double largest = -DBL_MAX;
+  size_t largestIndex = 0;
+  size_t largestTypeIndex = 0;
+  double secondLargest = -DBL_MAX;
+  size_t numericIndex = 0;
+  size_t categoricalIndex = 0;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    double bestGain = 0.0;
+    double secondBestGain = 0.0;
+    size_t typeIndex;
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      typeIndex = categoricalIndex++;
+      node.categoricalSplits[typeIndex].EvaluateFitnessFunction(bestGain,
+          secondBestGain);
+    }
+    else
+    {
+      typeIndex = numericIndex++;
+      node.numericSplits[typeIndex].EvaluateFitnessFunction(bestGain,
+          secondBestGain);
+    }
+
+    // See if these gains are better than the previous.
+    if (bestGain > largest)
+    {
+      secondLargest = largest;
+      largest = bestGain;
+      largestIndex = i;
+      largestTypeIndex = typeIndex;
+    }
+    else if (bestGain > secondLargest)
+    {
+      secondLargest = bestGain;
+    }
+
+    if (secondBestGain > secondLargest)
+      secondLargest = secondBestGain;
+  }
+
+  // Are these far enough apart to split?
+  if (!((largest > 0.0) &&
+      ((largest - secondLargest > epsilon) ||
+       (node.activeSamples > maxSamples) || (epsilon <= 0.05))))
+    return;
+
+  // Split, and create the children.
+  node.splitDimension = largestIndex;
+  arma::Col<size_t> childMajorities;
+  if (datasetInfo.Type(largestIndex) == data::Datatype::categorical)
+  {
+    node.categoricalSplits[largestTypeIndex].Split(childMajorities,
+        node.categoricalSplit);
+  }
+  else
+  {
+    node.numericSplits[largestTypeIndex].Split(childMajorities,
+        node.numericSplit);
+  }
+
+  for (size_t i = 0; i < childMajorities.n_elem; ++i)
+  {
+    node.children.push_back(NewLeaf());
+    node.children[i]->majorityClass = childMajorities[i];
+  }
+
+  // Eliminate now-unnecessary leaf information.
+  Deactivate(node);
+  node.classCounts.reset();
+  node.detector = detectorIn;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+typename AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Node*
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::NewLeaf() const
+{
+  Node* node = new Node();
+  node->classCounts.zeros(numClasses);
+  node->detector = detectorIn;
+  Activate(*node);
+  return node;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Activate(Node& node) const
+{
+  node.numericSplits.clear();
+  node.categoricalSplits.clear();
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      node.categoricalSplits.push_back(CategoricalSplit(
+          datasetInfo.NumMappings(i), numClasses, categoricalSplitIn));
+    }
+    else
+    {
+      node.numericSplits.push_back(NumericSplit(numClasses, numericSplitIn));
+    }
+  }
+
+  node.active = true;
+  node.activeSamples = 0;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Deactivate(Node& node)
+{
+  // Swap with empty vectors, so that the memory is actually released.
+  std::vector<NumericSplit>().swap(node.numericSplits);
+  std::vector<CategoricalSplit>().swap(node.categoricalSplits);
+  node.active = false;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::EnforceMaxActiveLeaves()
+{
+  std::vector<Node*> leaves;
+  Leaves(root, leaves);
+
+  // Leaves that have just been activated come first; the others are ordered by
+  // the number of training points they misclassify.
+  const size_t interval = checkInterval;
+  std::stable_sort(leaves.begin(), leaves.end(),
+      [interval](const Node* a, const Node* b)
+      {
+        const bool aNew = a->active && a->activeSamples < interval;
+        const bool bNew = b->active && b->activeSamples < interval;
+        if (aNew != bNew)
+          return aNew;
+
+        return (a->numSamples - a->classCounts.max()) >
+            (b->numSamples - b->classCounts.max());
+      });
+
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    if (i < maxActiveLeaves && !leaves[i]->active)
+      Activate(*leaves[i]);
+    else if (i >= maxActiveLeaves && leaves[i]->active)
+      Deactivate(*leaves[i]);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Leaves(
+    Node* node,
+    std::vector<Node*>& leaves)
+{
+  if (node->splitDimension == size_t(-1))
+  {
+    leaves.push_back(node);
+    return;
+  }
+
+  for (size_t i = 0; i < node->children.size(); ++i)
+    Leaves(node->children[i], leaves);
+  if (node->alternate)
+    Leaves(node->alternate, leaves);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::CalculateDirection(
+    const Node& node,
+    const VecType& point) const
+{
+  if (datasetInfo.Type(node.splitDimension) == data::Datatype::categorical)
+    return node.categoricalSplit.CalculateDirection(point[node.splitDimension]);
+  else
+    return node.numericSplit.CalculateDirection(point[node.splitDimension]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+const typename AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Node&
+AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+    DriftDetectorType>::Leaf(const Node& node, const VecType& point) const
+{
+  const Node* leaf = &node;
+  while (leaf->splitDimension != size_t(-1))
+    leaf = leaf->children[CalculateDirection(*leaf, point)];
+
+  return *leaf;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Classify(
+    const VecType& point) const
+{
+  return Leaf(*root, point).majorityClass;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename VecType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Classify(
+    const VecType& point,
+    size_t& prediction,
+    double& probability) const
+{
+  const Node& leaf = Leaf(*root, point);
+  prediction = leaf.majorityClass;
+  probability = leaf.majorityProbability;
+}
+
+//! Batch classification.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename MatType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  predictions.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    predictions[i] = Classify(data.col(i));
+}
+
+//! Batch classification with probabilities.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename MatType>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::rowvec& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    Classify(data.col(i), predictions[i], probabilities[i]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::NumNodes() const
+{
+  size_t nodes = 0;
+  std::vector<const Node*> stack(1, root);
+  while (!stack.empty())
+  {
+    const Node* node = stack.back();
+    stack.pop_back();
+    ++nodes;
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push_back(node->children[i]);
+  }
+
+  return nodes;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::NumLeaves() const
+{
+  std::vector<Node*> leaves;
+  Leaves(root, leaves);
+  return leaves.size();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::NumActiveLeaves() const
+{
+  std::vector<Node*> leaves;
+  Leaves(root, leaves);
+
+  size_t activeLeaves = 0;
+  for (size_t i = 0; i < leaves.size(); ++i)
+    if (leaves[i]->active)
+      ++activeLeaves;
+
+  return activeLeaves;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+size_t AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::NumAlternates() const
+{
+  size_t alternates = 0;
+  std::vector<const Node*> stack(1, root);
+  while (!stack.empty())
+  {
+    const Node* node = stack.back();
+    stack.pop_back();
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push_back(node->children[i]);
+    if (node->alternate)
+    {
+      ++alternates;
+      stack.push_back(node->alternate);
+    }
+  }
+
+  return alternates;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DriftDetectorType>
+template<typename Archive>
+void AdaptiveHoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DriftDetectorType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(datasetInfo));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(maxActiveLeaves));
+  ar(CEREAL_NVP(alternatePeriod));
+  ar(CEREAL_NVP(successProbability));
+  ar(CEREAL_NVP(maxSamples));
+  ar(CEREAL_NVP(checkInterval));
+  ar(CEREAL_NVP(minSamples));
+  ar(CEREAL_NVP(detectorIn));
+  ar(CEREAL_NVP(categoricalSplitIn));
+  ar(CEREAL_NVP(numericSplitIn));
+
+  if (cereal::is_loading<Archive>())
+  {
+    delete root;
+    root = NULL;
+  }
+  ar(CEREAL_POINTER(root));
+
+  ar(CEREAL_NVP(numSamples));
+  ar(CEREAL_NVP(numReplacements));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file methods/hoeffding_trees/ddm_drift_detector.cpp
+ *
+ * Implementation of the DDMDriftDetector class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ddm_drift_detector.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+DDMDriftDetector::DDMDriftDetector(const size_t minSamples,
+                                   const double warningLevel,
+                                   const double driftLevel) :
+    minSamples(minSamples),
+    warningLevel(warningLevel),
+    driftLevel(driftLevel)
+{
+  Reset();
+}
+
+bool DDMDriftDetector::Update(const bool error)
+{
+  ++numSamples;
+  if (error)
+    ++numErrors;
+
+  if (numSamples < minSamples)
+    return false;
+
+  const double rate = double(numErrors) / numSamples;
+  const double deviation = std::sqrt(rate * (1.0 - rate) / numSamples);
+
+  // The minimum is only tracked once there has been an error; otherwise, the
+  // deviation at the minimum would be zero, and any error would be a drift.
+  if (numErrors > 0 && rate + deviation < minimumRate + minimumDeviation)
+  {
+    minimumRate = rate;
+    minimumDeviation = deviation;
+  }
+
+  if (rate + deviation > minimumRate + driftLevel * minimumDeviation)
+  {
+    Reset();
+    return true;
+  }
+
+  warning = (rate + deviation > minimumRate + warningLevel * minimumDeviation);
+  return false;
+}
+
+void DDMDriftDetector::Reset()
+{
+  numSamples = 0;
+  numErrors = 0;
+  minimumRate = DBL_MAX;
+  minimumDeviation = 0.0;
+  warning = false;
+}
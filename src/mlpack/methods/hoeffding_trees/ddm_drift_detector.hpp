@@ -0,0 +1,135 @@
+/**
+ * @file methods/hoeffding_trees/ddm_drift_detector.hpp
+ *
+ * Definition of the DDMDriftDetector class, which detects changes in the error
+ * rate of a stream of predictions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_DDM_DRIFT_DETECTOR_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_DDM_DRIFT_DETECTOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The DDMDriftDetector implements the drift detection method (DDM) of Gama et
+ * al.:
+ *
+ * @code
+ * @inproceedings{gama2004learning,
+ *   title={Learning with Drift Detection},
+ *   author={Gama, J. and Medas, P. and Castillo, G. and Rodrigues, P.},
+ *   booktitle={Advances in Artificial Intelligence -- SBIA 2004},
+ *   pages={286--295},
+ *   year={2004}
+ * }
+ * @endcode
+ *
+ * The outcome of each prediction (correct or not) is given to Update().  The
+ * error rate p and its standard deviation s = sqrt(p (1 - p) / n) are tracked,
+ * along with the point where p + s was smallest (once an error has been seen).
+ * When p + s exceeds that minimum by warningLevel standard deviations,
+ * Warning() is true; once it exceeds it by driftLevel standard deviations, a
+ * drift is reported and the statistics are reset.
+ *
+ * Any class with Update(), Reset() and serialize() methods like this one can be
+ * used as the drift detector of the AdaptiveHoeffdingTree.
+ */
+class DDMDriftDetector
+{
+ public:
+  /**
+   * Create the drift detector.
+   *
+   * @param minSamples Number of predictions to see before a drift can be
+   *     detected.
+   * @param warningLevel Number of standard deviations above the minimum for a
+   *     warning.
+   * @param driftLevel Number of standard deviations above the minimum for a
+   *     drift.
+   */
+  DDMDriftDetector(const size_t minSamples = 30,
+                   const double warningLevel = 2.0,
+                   const double driftLevel = 3.0);
+
+  /**
+   * Add the outcome of a prediction.  If this detects a drift, true is
+   * returned, and the statistics are reset.
+   *
+   * @param error Whether the prediction was wrong.
+   * @return Whether a drift was detected.
+   */
+  bool Update(const bool error);
+
+  //! Forget all the predictions seen so far.
+  void Reset();
+
+  //! Get whether the error rate is at the warning level.
+  bool Warning() const { return warning; }
+  //! Get the number of predictions seen since the last reset.
+  size_t NumSamples() const { return numSamples; }
+  //! Get the error rate since the last reset.
+  double ErrorRate() const
+  {
+    return (numSamples == 0) ? 0.0 : double(numErrors) / numSamples;
+  }
+
+  //! Get the number of predictions to see before detecting a drift.
+  size_t MinSamples() const { return minSamples; }
+  //! Modify the number of predictions to see before detecting a drift.
+  size_t& MinSamples() { return minSamples; }
+
+  //! Get the warning level.
+  double WarningLevel() const { return warningLevel; }
+  //! Modify the warning level.
+  double& WarningLevel() { return warningLevel; }
+
+  //! Get the drift level.
+  double DriftLevel() const { return driftLevel; }
+  //! Modify the drift level.
+  double& DriftLevel() { return driftLevel; }
+
+  //! Serialize the drift detector.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(minSamples));
+    ar(CEREAL_NVP(warningLevel));
+    ar(CEREAL_NVP(driftLevel));
+    ar(CEREAL_NVP(numSamples));
+    ar(CEREAL_NVP(numErrors));
+    ar(CEREAL_NVP(minimumRate));
+    ar(CEREAL_NVP(minimumDeviation));
+    ar(CEREAL_NVP(warning));
+  }
+
+ private:
+  //! The number of predictions to see before detecting a drift.
+  size_t minSamples;
+  //! The number of standard deviations for a warning.
+  double warningLevel;
+  //! The number of standard deviations for a drift.
+  double driftLevel;
+
+  //! The number of predictions since the last reset.
+  size_t numSamples;
+  //! The number of wrong predictions since the last reset.
+  size_t numErrors;
+  //! The error rate where the error rate plus its deviation was smallest.
+  double minimumRate;
+  //! The deviation where the error rate plus its deviation was smallest.
+  double minimumDeviation;
+  //! Whether the error rate is at the warning level.
+  bool warning;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -213,6 +213,21 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a mini-batch of points in streaming mode, with the given labels.
+   * Each point is first passed down to its leaf; then, the statistics of every
+   * dimension of every leaf are updated in parallel, seeing the points in the
+   * same order as Train() on each point would.  Each leaf checks for a split
+   * once, after all its points of the batch have been seen, so a split only
+   * affects the points of later batches.  For high-rate streams, this is much
+   * faster than training on each point separately.
+   *
+   * @param data Points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels);
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -330,11 +345,39 @@ class HoeffdingTree
    */
   void CreateChildren();
 
-  //! Serialize the split.
+  /**
+   * Serialize the tree.  The nodes are stored as arrays with one element per
+   * node, so trees of any depth can be saved and loaded without recursion;
+   * archives of version 0, which hold each node recursively, can still be
+   * loaded.
+   */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
+  /**
+   * Serialize this node and, through pointers, its children, like archives of
+   * version 0 store the tree.
+   */
+  template<typename Archive>
+  void SerializeRecursive(Archive& ar);
+
+  /**
+   * Serialize the split information of this node (the statistics of a leaf,
+   * or the split of an internal node).  The split dimension and the dataset
+   * information must already be set.
+   */
+  template<typename Archive>
+  void SerializeSplits(Archive& ar);
+
+  /**
+   * Update the majority class of this leaf after new points have been added to
+   * its statistics, and split if a split check is due.
+   *
+   * @param oldNumSamples Number of samples seen before the new points.
+   */
+  void UpdateLeaf(const size_t oldNumSamples);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -384,6 +427,13 @@ class HoeffdingTree
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the nodes as arrays instead of recursively.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType>),
+    (mlpack::tree::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>), 1);
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
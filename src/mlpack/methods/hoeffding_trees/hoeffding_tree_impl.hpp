@@ -528,36 +528,129 @@ void HoeffdingTree<
         numericSplits[numericIndex++].Train(point[i], label);
     }
 
-    // Grab majority class from splits.
-    if (categoricalSplits.size() > 0)
-    {
-      majorityClass = categoricalSplits[0].MajorityClass();
-      majorityProbability = categoricalSplits[0].MajorityProbability();
-    }
-    else
+    UpdateLeaf(numSamples - 1);
+  }
+  else
+  {
+    // Already split.  Pass the training point to the relevant child.
+    size_t direction = CalculateDirection(point);
+    children[direction]->Train(point, label);
+  }
+}
+
+//! Train on a mini-batch of points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels)
+{
+  util::CheckSameSizes(data, labels, "HoeffdingTree::TrainMiniBatch()");
+
+  // Find the leaf that each point goes to.
+  std::vector<HoeffdingTree*> pointLeaves(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    HoeffdingTree* node = this;
+    while (node->splitDimension != size_t(-1))
+      node = node->children[node->CalculateDirection(data.col(i))];
+    pointLeaves[i] = node;
+  }
+
+  // Group the points by leaf, keeping them in order.
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  std::vector<HoeffdingTree*> leaves;
+  std::vector<std::vector<size_t>> leafPoints;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    std::unordered_map<HoeffdingTree*, size_t>::const_iterator it =
+        leafIndices.find(pointLeaves[i]);
+    if (it == leafIndices.end())
     {
-      majorityClass = numericSplits[0].MajorityClass();
-      majorityProbability = numericSplits[0].MajorityProbability();
+      it = leafIndices.insert(std::make_pair(pointLeaves[i],
+          leaves.size())).first;
+      leaves.push_back(pointLeaves[i]);
+      leafPoints.push_back(std::vector<size_t>());
     }
 
-    // Check for a split, if we should.
-    if (numSamples % checkInterval == 0)
+    leafPoints[it->second].push_back(i);
+  }
+
+  // The statistics of each dimension of each leaf are independent, so they can
+  // all be updated at the same time.
+  const size_t numDimensions = data.n_rows;
+  const size_t numTasks = leaves.size() * numDimensions;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) numTasks; ++t)
+  {
+    HoeffdingTree& leaf = *leaves[t / numDimensions];
+    const std::vector<size_t>& points = leafPoints[t / numDimensions];
+    const size_t d = t % numDimensions;
+    const size_t type = dimensionMappings->at(d).first;
+    const size_t index = dimensionMappings->at(d).second;
+
+    if (type == data::Datatype::categorical)
     {
-      const size_t numChildren = SplitCheck();
-      if (numChildren > 0)
+      for (size_t i = 0; i < points.size(); ++i)
       {
-        // We need to add a bunch of children.
-        // Delete children, if we have them.
-        children.clear();
-        CreateChildren();
+        leaf.categoricalSplits[index].Train(data(d, points[i]),
+            labels[points[i]]);
       }
     }
+    else if (type == data::Datatype::numeric)
+    {
+      for (size_t i = 0; i < points.size(); ++i)
+        leaf.numericSplits[index].Train(data(d, points[i]), labels[points[i]]);
+    }
+  }
+
+  // Now each leaf can check whether it should split.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t l = 0; l < (omp_size_t) leaves.size(); ++l)
+  {
+    const size_t oldNumSamples = leaves[l]->numSamples;
+    leaves[l]->numSamples += leafPoints[l].size();
+    leaves[l]->UpdateLeaf(oldNumSamples);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::UpdateLeaf(const size_t oldNumSamples)
+{
+  // Grab majority class from splits.
+  if (categoricalSplits.size() > 0)
+  {
+    majorityClass = categoricalSplits[0].MajorityClass();
+    majorityProbability = categoricalSplits[0].MajorityProbability();
   }
   else
   {
-    // Already split.  Pass the training point to the relevant child.
-    size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
+    majorityClass = numericSplits[0].MajorityClass();
+    majorityProbability = numericSplits[0].MajorityProbability();
+  }
+
+  // Check for a split, if we have passed a multiple of the check interval.
+  if (numSamples / checkInterval > oldNumSamples / checkInterval)
+  {
+    const size_t numChildren = SplitCheck();
+    if (numChildren > 0)
+    {
+      // We need to add a bunch of children.
+      // Delete children, if we have them.
+      children.clear();
+      CreateChildren();
+    }
   }
 }
 
@@ -925,7 +1018,135 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
+{
+  // Archives of version 0 hold the children of each node recursively.
+  if (version == 0)
+  {
+    SerializeRecursive(ar);
+    return;
+  }
+
+  // Only the root holds the dimension mappings and the dataset information;
+  // every other node shares them.
+  if (cereal::is_loading<Archive>() && ownsMappings && dimensionMappings)
+    delete dimensionMappings;
+
+  ar(CEREAL_POINTER(dimensionMappings));
+
+  // Special handling for const object.
+  data::DatasetInfo* d = NULL;
+  if (cereal::is_saving<Archive>())
+    d = const_cast<data::DatasetInfo*>(datasetInfo);
+  ar(CEREAL_POINTER(d));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (datasetInfo && ownsInfo)
+      delete datasetInfo;
+
+    datasetInfo = d;
+    ownsInfo = true;
+    ownsMappings = true; // We also own the mappings we loaded.
+
+    // Clear the children.
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i];
+    children.clear();
+  }
+
+  // The nodes of the tree are stored as arrays that hold one element for each
+  // node, in breadth-first order, so that neither saving nor loading recurses;
+  // the children of each node are the next unclaimed nodes.
+  std::vector<HoeffdingTree*> nodes;
+  size_t numNodes = 0;
+  if (cereal::is_saving<Archive>())
+  {
+    nodes.push_back(this);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      for (size_t j = 0; j < nodes[i]->children.size(); ++j)
+        nodes.push_back(nodes[i]->children[j]);
+    numNodes = nodes.size();
+  }
+  ar(CEREAL_NVP(numNodes));
+
+  std::vector<size_t> numChildren(numNodes), splitDimensions(numNodes),
+      majorityClasses(numNodes);
+  std::vector<double> majorityProbabilities(numNodes);
+  if (cereal::is_saving<Archive>())
+  {
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      numChildren[i] = nodes[i]->children.size();
+      splitDimensions[i] = nodes[i]->splitDimension;
+      majorityClasses[i] = nodes[i]->majorityClass;
+      majorityProbabilities[i] = nodes[i]->majorityProbability;
+    }
+  }
+  ar(CEREAL_NVP(numChildren));
+  ar(CEREAL_NVP(splitDimensions));
+  ar(CEREAL_NVP(majorityClasses));
+  ar(CEREAL_NVP(majorityProbabilities));
+
+  if (cereal::is_loading<Archive>())
+  {
+    if (numNodes == 0)
+      throw std::runtime_error("HoeffdingTree::serialize(): the archive holds "
+          "no nodes!");
+
+    nodes.resize(numNodes);
+    nodes[0] = this;
+    for (size_t i = 1; i < numNodes; ++i)
+    {
+      nodes[i] = new HoeffdingTree();
+
+      // The children don't own the dataset information or the mappings.
+      delete nodes[i]->dimensionMappings;
+      delete nodes[i]->datasetInfo;
+      nodes[i]->dimensionMappings = dimensionMappings;
+      nodes[i]->ownsMappings = false;
+      nodes[i]->datasetInfo = datasetInfo;
+      nodes[i]->ownsInfo = false;
+    }
+
+    size_t nextChild = 1;
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      HoeffdingTree* node = nodes[i];
+      if (nextChild + numChildren[i] > numNodes)
+      {
+        // Free the nodes that weren't attached yet.
+        for (size_t j = nextChild; j < numNodes; ++j)
+          delete nodes[j];
+        throw std::runtime_error("HoeffdingTree::serialize(): the archive "
+            "holds an invalid tree!");
+      }
+
+      node->children.resize(numChildren[i]);
+      for (size_t j = 0; j < numChildren[i]; ++j)
+        node->children[j] = nodes[nextChild++];
+
+      node->splitDimension = splitDimensions[i];
+      node->majorityClass = majorityClasses[i];
+      node->majorityProbability = majorityProbabilities[i];
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+    nodes[i]->SerializeSplits(ar);
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename Archive>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::SerializeRecursive(Archive& ar)
 {
   ar(CEREAL_NVP(splitDimension));
 
@@ -959,6 +1180,39 @@ void HoeffdingTree<
   ar(CEREAL_NVP(majorityClass));
   ar(CEREAL_NVP(majorityProbability));
 
+  SerializeSplits(ar);
+
+  if (splitDimension != size_t(-1))
+  {
+    // Serialize the children, because we have split.
+    ar(CEREAL_VECTOR_POINTER(children));
+
+    if (cereal::is_loading<Archive>())
+    {
+      for (size_t i = 0; i < children.size(); ++i)
+      {
+        // The child doesn't actually own its own DatasetInfo.  We do.  The same
+        // applies for the dimension mappings.
+        if (children[i]->datasetInfo == datasetInfo)
+          children[i]->ownsInfo = false;
+        children[i]->ownsMappings = false;
+      }
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename Archive>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::SerializeSplits(Archive& ar)
+{
   // Depending on whether or not we have split yet, we may need to save
   // different things.
   if (splitDimension == size_t(-1))
@@ -1005,26 +1259,14 @@ void HoeffdingTree<
   }
   else
   {
-    // We have split, so we only need to save the split and the children.
+    // We have split, so we only need to save the split.
     if (datasetInfo->Type(splitDimension) == data::Datatype::categorical)
       ar(CEREAL_NVP(categoricalSplit));
     else
       ar(CEREAL_NVP(numericSplit));
 
-    // Serialize the children, because we have split.
-      ar(CEREAL_VECTOR_POINTER(children));
-
     if (cereal::is_loading<Archive>())
     {
-      for (size_t i = 0; i < children.size(); ++i)
-      {
-        // The child doesn't actually own its own DatasetInfo.  We do.  The same
-        // applies for the dimension mappings.
-        if (children[i]->datasetInfo == datasetInfo)
-          children[i]->ownsInfo = false;
-        children[i]->ownsMappings = false;
-      }
-
       numericSplits.clear();
       categoricalSplits.clear();
 
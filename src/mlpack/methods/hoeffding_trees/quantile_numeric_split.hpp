@@ -0,0 +1,167 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split.hpp
+ *
+ * A binary numeric splitting procedure that summarizes the values of each
+ * class with a mergeable streaming histogram, and so uses a constant amount of
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+
+#include "binary_numeric_split_info.hpp"
+#include "streaming_histogram.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuantileNumericSplit class is a binary numeric split (like
+ * BinaryNumericSplit) that doesn't keep the values it has seen.  Instead, the
+ * values of each class are summarized by a StreamingHistogram with a fixed
+ * number of bins, so the memory used by a leaf for a dimension is
+ * O(numClasses * bins) regardless of the number of points, and Train() takes
+ * O(bins) time.  EvaluateFitnessFunction() tries the split points between the
+ * centroids of the histogram of all the classes, estimating the number of
+ * points of each class on either side of a split point from the histogram of
+ * the class.  This is the split procedure of the following paper:
+ *
+ * @code
+ * @article{ben2010streaming,
+ *   title   = {A Streaming Parallel Decision Tree Algorithm},
+ *   author  = {Ben-Haim, Yael and Tom-Tov, Elad},
+ *   journal = {Journal of Machine Learning Research},
+ *   volume  = {11},
+ *   pages   = {849--872},
+ *   year    = {2010}
+ * }
+ * @endcode
+ *
+ * Since histograms can be merged, splits trained on separate shards of the
+ * data can be merged with Merge(), which gives (up to the approximation of the
+ * histograms) the split trained on all the data.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observation used by this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class QuantileNumericSplit
+{
+ public:
+  //! The splitting information required by the QuantileNumericSplit.
+  typedef BinaryNumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes.
+   *
+   * @param numClasses Number of classes in dataset.
+   * @param bins Number of bins of the histogram of each class.
+   */
+  QuantileNumericSplit(const size_t numClasses = 0, const size_t bins = 32);
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes,
+   * using the number of bins of the given other split.  This function is
+   * required by the HoeffdingTree class.
+   */
+  QuantileNumericSplit(const size_t numClasses,
+                       const QuantileNumericSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value The value to train on.
+   * @param label The label to train on.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Merge the points seen by another split on the same dimension (for
+   * instance, a split trained on another shard of the data) into this split.
+   * Both splits must have the same number of classes.
+   *
+   * @param other Split to merge.
+   */
+  void Merge(const QuantileNumericSplit& other);
+
+  /**
+   * Given the points seen so far, evaluate the fitness function, returning the
+   * best possible gain of a binary split.  This takes O(numClasses * bins^2)
+   * time, regardless of the number of points.
+   *
+   * The best possible split will be stored in bestFitness, and the second best
+   * possible split will be stored in secondBestFitness.
+   *
+   * @param bestFitness Fitness function value for best possible split.
+   * @param secondBestFitness Fitness function value for second best possible
+   *      split.
+   */
+  void EvaluateFitnessFunction(double& bestFitness,
+                               double& secondBestFitness);
+
+  // Return the number of children if this node were to split on this feature.
+  size_t NumChildren() const { return 2; }
+
+  /**
+   * Given that a split should happen, return the majority classes of the (two)
+   * children and an initialized SplitInfo object.
+   *
+   * @param childMajorities Majority classes of the children after the split.
+   * @param splitInfo Split information.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo);
+
+  //! The majority class of the points seen so far.
+  size_t MajorityClass() const;
+  //! The probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the number of bins of the histogram of each class.
+  size_t Bins() const { return bins; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Estimate the number of points of each class on each side of the given
+   * split point.
+   *
+   * @param splitPoint Split point; column 0 of counts holds the points less
+   *     than it.
+   * @param counts Matrix to store the counts in (numClasses x 2).
+   */
+  void SplitCounts(const double splitPoint, arma::Mat<size_t>& counts) const;
+
+  //! The number of bins of the histogram of each class.
+  size_t bins;
+  //! The histogram of the values of each class.
+  std::vector<StreamingHistogram<ObservationType>> histograms;
+  //! The classes we have seen so far (for majority calculations).
+  arma::Col<size_t> classCounts;
+
+  //! A cached best split point.
+  double bestSplit;
+  //! If true, the cached best split point is accurate (that is, we have not
+  //! seen any more samples since we calculated it).
+  bool isAccurate;
+};
+
+// Convenience typedef.
+template<typename FitnessFunction>
+using QuantileDoubleNumericSplit = QuantileNumericSplit<FitnessFunction,
+    double>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file methods/hoeffding_trees/quantile_numeric_split_impl.hpp
+ *
+ * Implementation of the QuantileNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const size_t bins) :
+    bins(bins),
+    histograms(numClasses, StreamingHistogram<ObservationType>(bins)),
+    classCounts(numClasses),
+    bestSplit(-DBL_MAX),
+    isAccurate(true)
+{
+  // Zero out class counts.
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const QuantileNumericSplit& other) :
+    QuantileNumericSplit(numClasses, other.bins)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  histograms[label].Insert(value);
+  ++classCounts[label];
+
+  // Whatever we have cached is no longer valid.
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Merge(
+    const QuantileNumericSplit& other)
+{
+  if (other.classCounts.n_elem != classCounts.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "QuantileNumericSplit::Merge(): cannot merge a split with "
+        << other.classCounts.n_elem << " classes into a split with "
+        << classCounts.n_elem << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t c = 0; c < histograms.size(); ++c)
+    histograms[c].Merge(other.histograms[c]);
+  classCounts += other.classCounts;
+
+  isAccurate = false;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness)
+{
+  bestSplit = -DBL_MAX;
+
+  // Initialize with every point on the right side of the split.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  bestFitness = FitnessFunction::Evaluate(counts);
+  secondBestFitness = 0.0;
+
+  // The candidate split points are between the centroids of the histogram of
+  // all the classes.
+  StreamingHistogram<ObservationType> all(bins);
+  for (size_t c = 0; c < histograms.size(); ++c)
+    all.Merge(histograms[c]);
+
+  for (size_t i = 0; i + 1 < all.NumBins(); ++i)
+  {
+    const double splitPoint = (all.Centroid(i) + all.Centroid(i + 1)) / 2.0;
+    SplitCounts(splitPoint, counts);
+
+    const double value = FitnessFunction::Evaluate(counts);
+    if (value > bestFitness)
+    {
+      secondBestFitness = bestFitness;
+      bestFitness = value;
+      bestSplit = splitPoint;
+    }
+    else if (value > secondBestFitness)
+    {
+      secondBestFitness = value;
+    }
+  }
+
+  isAccurate = true;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo)
+{
+  if (!isAccurate)
+  {
+    double bestGain, secondBestGain;
+    EvaluateFitnessFunction(bestGain, secondBestGain);
+  }
+
+  // Make one child for each side of the split.
+  childMajorities.set_size(2);
+
+  arma::Mat<size_t> counts;
+  SplitCounts(bestSplit, counts);
+
+  // Calculate the majority classes of the children.
+  arma::uword maxIndex;
+  counts.unsafe_col(0).max(maxIndex);
+  childMajorities[0] = size_t(maxIndex);
+  counts.unsafe_col(1).max(maxIndex);
+  childMajorities[1] = size_t(maxIndex);
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo((ObservationType) bestSplit);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
+    const
+{
+  arma::uword maxIndex;
+  classCounts.max(maxIndex);
+  return size_t(maxIndex);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double QuantileNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  return double(arma::max(classCounts)) / double(arma::accu(classCounts));
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::SplitCounts(
+    const double splitPoint,
+    arma::Mat<size_t>& counts) const
+{
+  counts.set_size(classCounts.n_elem, 2);
+  for (size_t c = 0; c < histograms.size(); ++c)
+  {
+    // The estimate is rounded, since the fitness functions take counts.
+    const double left = std::round(histograms[c].Sum(splitPoint));
+    counts(c, 0) = std::min((size_t) left, classCounts[c]);
+    counts(c, 1) = classCounts[c] - counts(c, 0);
+  }
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(bins));
+  ar(CEREAL_NVP(histograms));
+  ar(CEREAL_NVP(classCounts));
+
+  if (cereal::is_loading<Archive>())
+  {
+    // The cached split point is not saved.
+    bestSplit = -DBL_MAX;
+    isAccurate = false;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file methods/hoeffding_trees/streaming_histogram.hpp
+ *
+ * Definition of the StreamingHistogram class, a mergeable summary of a stream
+ * of numeric values that uses a constant amount of memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_STREAMING_HISTOGRAM_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_STREAMING_HISTOGRAM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The StreamingHistogram class summarizes a stream of numeric values with at
+ * most maxBins bins, each holding a centroid and a number of values.  When a
+ * value is inserted and there are too many bins, the two bins with the
+ * closest centroids are merged, so the memory used doesn't depend on the
+ * number of values.  Two histograms can be merged in the same way, so that
+ * histograms built on separate shards of the data can be combined.  The
+ * number of values less than any point is then estimated by interpolating
+ * between the bins.  For more information, see:
+ *
+ * @code
+ * @article{ben2010streaming,
+ *   title   = {A Streaming Parallel Decision Tree Algorithm},
+ *   author  = {Ben-Haim, Yael and Tom-Tov, Elad},
+ *   journal = {Journal of Machine Learning Research},
+ *   volume  = {11},
+ *   pages   = {849--872},
+ *   year    = {2010}
+ * }
+ * @endcode
+ *
+ * @tparam ObservationType Type of the values.
+ */
+template<typename ObservationType = double>
+class StreamingHistogram
+{
+ public:
+  /**
+   * Create an empty histogram with the given maximum number of bins.
+   *
+   * @param maxBins Maximum number of bins.
+   */
+  StreamingHistogram(const size_t maxBins = 32);
+
+  /**
+   * Insert a value in the histogram.
+   *
+   * @param value Value to insert.
+   * @param valueCount Number of times the value is inserted.
+   */
+  void Insert(const ObservationType value, const double valueCount = 1.0);
+
+  /**
+   * Merge the bins of another histogram into this one, which keeps its
+   * maximum number of bins.
+   *
+   * @param other Histogram to merge.
+   */
+  void Merge(const StreamingHistogram& other);
+
+  /**
+   * Estimate the number of values less than the given point.  Points smaller
+   * than the smallest centroid give 0, and points larger than the largest
+   * centroid give the number of values.
+   *
+   * @param point Point to estimate the number of smaller values of.
+   */
+  double Sum(const double point) const;
+
+  //! Get the number of values inserted in the histogram.
+  double Count() const { return count; }
+
+  //! Get the number of bins.
+  size_t NumBins() const { return centroids.size(); }
+  //! Get the maximum number of bins.
+  size_t MaxBins() const { return maxBins; }
+
+  //! Get the centroid of the given bin (the bins are sorted by centroid).
+  double Centroid(const size_t i) const { return centroids[i]; }
+  //! Get the number of values of the given bin.
+  double BinCount(const size_t i) const { return counts[i]; }
+
+  //! Serialize the histogram.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Merge the bins with the closest centroids until there are at most maxBins
+  //! bins.
+  void Shrink();
+
+  //! The maximum number of bins.
+  size_t maxBins;
+  //! The centroids of the bins, in increasing order.
+  std::vector<double> centroids;
+  //! The number of values of each bin.
+  std::vector<double> counts;
+  //! The number of values inserted in the histogram.
+  double count;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_histogram_impl.hpp"
+
+#endif
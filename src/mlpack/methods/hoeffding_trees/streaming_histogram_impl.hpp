@@ -0,0 +1,148 @@
+/**
+ * @file methods/hoeffding_trees/streaming_histogram_impl.hpp
+ *
+ * Implementation of the StreamingHistogram class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_STREAMING_HISTOGRAM_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_STREAMING_HISTOGRAM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_histogram.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ObservationType>
+StreamingHistogram<ObservationType>::StreamingHistogram(const size_t maxBins) :
+    maxBins(maxBins),
+    count(0.0)
+{
+  if (maxBins < 2)
+  {
+    throw std::invalid_argument("StreamingHistogram::StreamingHistogram(): "
+        "the histogram must have at least two bins!");
+  }
+}
+
+template<typename ObservationType>
+void StreamingHistogram<ObservationType>::Insert(const ObservationType value,
+                                                 const double valueCount)
+{
+  const double point = (double) value;
+  const size_t i = std::lower_bound(centroids.begin(), centroids.end(),
+      point) - centroids.begin();
+
+  count += valueCount;
+  if (i < centroids.size() && centroids[i] == point)
+  {
+    counts[i] += valueCount;
+    return;
+  }
+
+  centroids.insert(centroids.begin() + i, point);
+  counts.insert(counts.begin() + i, valueCount);
+  Shrink();
+}
+
+template<typename ObservationType>
+void StreamingHistogram<ObservationType>::Merge(
+    const StreamingHistogram& other)
+{
+  std::vector<double> mergedCentroids, mergedCounts;
+  mergedCentroids.reserve(centroids.size() + other.centroids.size());
+  mergedCounts.reserve(centroids.size() + other.centroids.size());
+
+  // Merge the two sorted lists of bins; equal centroids are combined.
+  size_t i = 0, j = 0;
+  while (i < centroids.size() || j < other.centroids.size())
+  {
+    const bool takeThis = (j == other.centroids.size()) ||
+        (i < centroids.size() && centroids[i] <= other.centroids[j]);
+    const double centroid = takeThis ? centroids[i] : other.centroids[j];
+    const double binCount = takeThis ? counts[i++] : other.counts[j++];
+
+    if (!mergedCentroids.empty() && mergedCentroids.back() == centroid)
+    {
+      mergedCounts.back() += binCount;
+    }
+    else
+    {
+      mergedCentroids.push_back(centroid);
+      mergedCounts.push_back(binCount);
+    }
+  }
+
+  centroids.swap(mergedCentroids);
+  counts.swap(mergedCounts);
+  count += other.count;
+  Shrink();
+}
+
+template<typename ObservationType>
+double StreamingHistogram<ObservationType>::Sum(const double point) const
+{
+  if (centroids.empty() || point < centroids.front())
+    return 0.0;
+  if (point >= centroids.back())
+    return count;
+
+  // Find the bin i with centroids[i] <= point < centroids[i + 1].
+  const size_t i = std::upper_bound(centroids.begin(), centroids.end(),
+      point) - centroids.begin() - 1;
+
+  // The values of bin i are taken to be half on each side of its centroid,
+  // and the density is interpolated linearly between bins i and i + 1.
+  double sum = counts[i] / 2.0;
+  for (size_t j = 0; j < i; ++j)
+    sum += counts[j];
+
+  const double fraction = (point - centroids[i]) /
+      (centroids[i + 1] - centroids[i]);
+  const double pointCount = counts[i] + (counts[i + 1] - counts[i]) * fraction;
+  return sum + (counts[i] + pointCount) / 2.0 * fraction;
+}
+
+template<typename ObservationType>
+void StreamingHistogram<ObservationType>::Shrink()
+{
+  while (centroids.size() > maxBins)
+  {
+    // Find the two adjacent bins with the closest centroids.
+    size_t closest = 0;
+    for (size_t i = 1; i + 1 < centroids.size(); ++i)
+    {
+      if (centroids[i + 1] - centroids[i] <
+          centroids[closest + 1] - centroids[closest])
+        closest = i;
+    }
+
+    const double mergedCount = counts[closest] + counts[closest + 1];
+    centroids[closest] = (centroids[closest] * counts[closest] +
+        centroids[closest + 1] * counts[closest + 1]) / mergedCount;
+    counts[closest] = mergedCount;
+    centroids.erase(centroids.begin() + closest + 1);
+    counts.erase(counts.begin() + closest + 1);
+  }
+}
+
+template<typename ObservationType>
+template<typename Archive>
+void StreamingHistogram<ObservationType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(maxBins));
+  ar(CEREAL_NVP(centroids));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(count));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,340 @@
+/**
+ * @file methods/kde/grid_kde.cpp
+ *
+ * Implementation of grid-based kernel density estimation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "grid_kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+//! Check that the given error tolerances are valid.
+static void CheckGridErrorValues(const double relError, const double absError)
+{
+  if (relError < 0 || relError > 1)
+  {
+    throw std::invalid_argument("Relative error tolerance must be a value "
+                                "between 0 and 1");
+  }
+  if (absError < 0)
+  {
+    throw std::invalid_argument("Absolute error tolerance must be a value "
+                                "greater than or equal to 0");
+  }
+}
+
+GridKDE::GridKDE(const double relError,
+                 const double absError,
+                 const kernel::GaussianKernel& kernel,
+                 const size_t maxGridPoints) :
+    relError(relError),
+    absError(absError),
+    kernel(kernel),
+    maxGridPoints(maxGridPoints),
+    spacing(0),
+    trained(false)
+{
+  CheckGridErrorValues(relError, absError);
+}
+
+void GridKDE::Train(arma::mat referenceSet)
+{
+  // Check if referenceSet is not an empty set.
+  if (referenceSet.n_cols == 0)
+  {
+    throw std::invalid_argument("cannot train KDE model with an empty "
+                                "reference set");
+  }
+
+  if (referenceSet.n_rows == 0 || referenceSet.n_rows > 3)
+  {
+    throw std::invalid_argument("cannot train grid KDE model: only data with "
+                                "1 to 3 dimensions is supported");
+  }
+
+  this->referenceSet = std::move(referenceSet);
+
+  Timer::Start("building_grid");
+  BuildGrid();
+  Timer::Stop("building_grid");
+  trained = true;
+}
+
+void GridKDE::Evaluate(const arma::mat& querySet, arma::vec& estimations) const
+{
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  // Check querySet has at least 1 element to evaluate.
+  if (querySet.n_cols == 0)
+  {
+    Log::Warn << "GridKDE::Evaluate(): querySet is empty, no predictions will "
+              << "be returned" << std::endl;
+    return;
+  }
+
+  // Check whether dimensions match.
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: querySet and "
+                                "referenceSet dimensions don't match");
+  }
+
+  Timer::Start("computing_kde");
+  estimations.set_size(querySet.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    estimations[i] = Interpolate(querySet.colptr(i));
+  Timer::Stop("computing_kde");
+}
+
+void GridKDE::Evaluate(arma::vec& estimations) const
+{
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  // Each reference point contributes K(0) / N to its own grid estimate, so
+  // remove that contribution.
+  const double selfContribution = kernel.Evaluate(0.0) / referenceSet.n_cols;
+
+  Timer::Start("computing_kde");
+  estimations.set_size(referenceSet.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  {
+    estimations[i] = std::max(Interpolate(referenceSet.colptr(i)) -
+        selfContribution, 0.0);
+  }
+  Timer::Stop("computing_kde");
+}
+
+void GridKDE::Kernel(const kernel::GaussianKernel& newKernel)
+{
+  const bool changed = (newKernel.Bandwidth() != kernel.Bandwidth());
+  kernel = newKernel;
+  if (trained && changed)
+    BuildGrid();
+}
+
+void GridKDE::RelativeError(const double newError)
+{
+  CheckGridErrorValues(newError, absError);
+  const bool changed = (newError != relError);
+  relError = newError;
+  if (trained && changed)
+    BuildGrid();
+}
+
+void GridKDE::AbsoluteError(const double newError)
+{
+  CheckGridErrorValues(relError, newError);
+  const bool changed = (newError != absError);
+  absError = newError;
+  if (trained && changed)
+    BuildGrid();
+}
+
+void GridKDE::MaxGridPoints(const size_t newMaxGridPoints)
+{
+  const bool changed = (newMaxGridPoints != maxGridPoints);
+  maxGridPoints = newMaxGridPoints;
+  if (trained && changed)
+    BuildGrid();
+}
+
+void GridKDE::BuildGrid()
+{
+  const size_t dims = referenceSet.n_rows;
+  const double bandwidth = kernel.Bandwidth();
+
+  // The kernel is truncated where it falls below this value, so the error
+  // introduced by the truncation is bounded by it for every query point.
+  double truncation = std::max(absError, 1e-3 * relError);
+  if (truncation <= 0.0)
+    truncation = std::numeric_limits<double>::epsilon();
+  truncation = std::min(truncation, 0.5);
+  const double radius = bandwidth * std::sqrt(2.0 * std::log(1.0 /
+      truncation));
+
+  // The grid must cover every point whose density is not truncated.
+  origin = arma::min(referenceSet, 1) - radius;
+  const arma::vec extent = arma::max(referenceSet, 1) + radius - origin;
+
+  // Linear binning and multilinear interpolation each introduce a relative
+  // error of roughly (spacing / bandwidth)^2 / 8 per dimension near the modes
+  // of the density, so this spacing keeps the total within relError / 2.
+  spacing = bandwidth * std::sqrt(2.0 * relError / dims);
+
+  const size_t maxPoints = std::max(maxGridPoints, (size_t) 1 << dims);
+  auto gridPoints = [&](const double s)
+  {
+    double points = 1.0;
+    for (size_t d = 0; d < dims; ++d)
+      points *= std::ceil(extent[d] / s) + 1;
+    return points;
+  };
+
+  if (spacing <= 0.0 || gridPoints(spacing) > maxPoints)
+  {
+    Log::Warn << "GridKDE::Train(): the grid needed for the requested error "
+        << "tolerance would have more than " << maxPoints << " points; using "
+        << "a coarser grid, so the error tolerance may not hold." << std::endl;
+
+    spacing = std::max(spacing, std::pow(arma::prod(extent) / maxPoints,
+        1.0 / dims));
+    while (gridPoints(spacing) > maxPoints)
+      spacing *= 1.01;
+  }
+
+  gridSize.ones(3);
+  for (size_t d = 0; d < dims; ++d)
+    gridSize[d] = (size_t) std::ceil(extent[d] / spacing) + 1;
+
+  // Linearly bin the reference points onto the grid.
+  density.zeros(gridSize[0], gridSize[1], gridSize[2]);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    size_t base[3] = { 0, 0, 0 };
+    double frac[3] = { 0.0, 0.0, 0.0 };
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const double u = (referenceSet(d, i) - origin[d]) / spacing;
+      base[d] = std::min((size_t) u, gridSize[d] - 2);
+      frac[d] = u - base[d];
+    }
+
+    for (size_t corner = 0; corner < ((size_t) 1 << dims); ++corner)
+    {
+      size_t index[3] = { base[0], base[1], base[2] };
+      double weight = 1.0;
+      for (size_t d = 0; d < dims; ++d)
+      {
+        if ((corner >> d) & 1)
+        {
+          weight *= frac[d];
+          ++index[d];
+        }
+        else
+        {
+          weight *= 1.0 - frac[d];
+        }
+      }
+
+      density(index[0], index[1], index[2]) += weight;
+    }
+  }
+
+  // The Gaussian kernel is separable, so the convolution with the grid is
+  // done as a one-dimensional convolution along each axis.
+  const size_t halfWidth = (size_t) std::floor(radius / spacing);
+  arma::vec weights(2 * halfWidth + 1);
+  for (size_t k = 0; k < weights.n_elem; ++k)
+    weights[k] = kernel.Evaluate(((double) k - (double) halfWidth) * spacing);
+
+  // The first axis is contiguous in memory.
+  arma::mat lines(density.memptr(), gridSize[0], gridSize[1] * gridSize[2],
+      false, true);
+  ConvolveColumns(lines, weights);
+
+  if (dims > 1)
+  {
+    for (size_t s = 0; s < density.n_slices; ++s)
+    {
+      arma::mat sliceLines = density.slice(s).t();
+      ConvolveColumns(sliceLines, weights);
+      density.slice(s) = sliceLines.t();
+    }
+  }
+
+  if (dims > 2)
+  {
+    arma::mat flat(density.memptr(), gridSize[0] * gridSize[1], gridSize[2],
+        false, true);
+    arma::mat tubeLines = flat.t();
+    ConvolveColumns(tubeLines, weights);
+    flat = tubeLines.t();
+  }
+
+  // Round-off in the FFTs may leave tiny negative values.
+  density.elem(arma::find(density < 0.0)).zeros();
+  density /= referenceSet.n_cols;
+}
+
+double GridKDE::Interpolate(const double* point) const
+{
+  const size_t dims = referenceSet.n_rows;
+
+  size_t base[3] = { 0, 0, 0 };
+  double frac[3] = { 0.0, 0.0, 0.0 };
+  for (size_t d = 0; d < dims; ++d)
+  {
+    const double u = (point[d] - origin[d]) / spacing;
+    // Points outside of the grid only receive truncated contributions.
+    if (!(u >= 0.0) || u > (double) (gridSize[d] - 1))
+      return 0.0;
+
+    base[d] = std::min((size_t) u, gridSize[d] - 2);
+    frac[d] = u - base[d];
+  }
+
+  double estimate = 0.0;
+  for (size_t corner = 0; corner < ((size_t) 1 << dims); ++corner)
+  {
+    size_t index[3] = { base[0], base[1], base[2] };
+    double weight = 1.0;
+    for (size_t d = 0; d < dims; ++d)
+    {
+      if ((corner >> d) & 1)
+      {
+        weight *= frac[d];
+        ++index[d];
+      }
+      else
+      {
+        weight *= 1.0 - frac[d];
+      }
+    }
+
+    estimate += weight * density(index[0], index[1], index[2]);
+  }
+
+  return estimate;
+}
+
+void GridKDE::ConvolveColumns(arma::mat& lines, const arma::vec& weights)
+{
+  const size_t n = lines.n_rows;
+  const size_t halfWidth = (weights.n_elem - 1) / 2;
+
+  // Pad to a power of two large enough to hold the full linear convolution,
+  // so that the circular convolution computed by the FFT does not wrap.
+  size_t fftSize = 1;
+  while (fftSize < n + 2 * halfWidth)
+    fftSize *= 2;
+
+  arma::mat padded(fftSize, lines.n_cols, arma::fill::zeros);
+  padded.rows(0, n - 1) = lines;
+  arma::vec paddedWeights(fftSize, arma::fill::zeros);
+  paddedWeights.subvec(0, weights.n_elem - 1) = weights;
+
+  arma::cx_mat transform = arma::fft(padded);
+  const arma::cx_vec weightsTransform = arma::fft(paddedWeights);
+  transform.each_col() %= weightsTransform;
+
+  const arma::mat result = arma::real(arma::ifft(transform));
+  lines = result.rows(halfWidth, halfWidth + n - 1);
+}
+
+} // namespace kde
+} // namespace mlpack
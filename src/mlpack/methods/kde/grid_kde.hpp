@@ -0,0 +1,188 @@
+/**
+ * @file methods/kde/grid_kde.hpp
+ *
+ * Grid-based (binned) kernel density estimation for low-dimensional data with
+ * the Gaussian kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_GRID_KDE_HPP
+#define MLPACK_METHODS_KDE_GRID_KDE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+
+#include "kde.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * GridKDE is an alternative to the tree-based KDE class for data with one to
+ * three dimensions and the Gaussian kernel.  Instead of traversing a tree, the
+ * reference points are linearly binned onto a regular grid, the binned counts
+ * are convolved with the (truncated) kernel using FFTs, and the density at each
+ * query point is obtained by multilinear interpolation of the grid.  Once the
+ * grid is built the cost of each query is constant, which makes this much
+ * faster than the tree-based algorithms when there are many query points, as is
+ * the case for one-dimensional distributions such as latency histograms.
+ *
+ * The grid spacing is chosen from the bandwidth and the relative error
+ * tolerance, so that the error introduced by binning and interpolation is
+ * within the relative error tolerance where the density is not negligible.
+ * The kernel is truncated where its value falls below the absolute error
+ * tolerance (or a small fraction of the relative error tolerance).  If the
+ * resulting grid would have more than `maxGridPoints` points, the grid is
+ * coarsened and a warning is issued, since the error tolerance may no longer
+ * hold.  As in the KDE class, the estimations are not normalized.
+ */
+class GridKDE
+{
+ public:
+  //! Default maximum number of points in the grid.
+  static constexpr size_t defaultMaxGridPoints = 1048576;
+
+  /**
+   * Initialize GridKDE object with the given error tolerances and kernel.
+   *
+   * @param relError Relative error tolerance of the model.
+   * @param absError Absolute error tolerance of the model.
+   * @param kernel Instantiated Gaussian kernel.
+   * @param maxGridPoints Maximum number of points in the grid.
+   */
+  GridKDE(const double relError = KDEDefaultParams::relError,
+          const double absError = KDEDefaultParams::absError,
+          const kernel::GaussianKernel& kernel = kernel::GaussianKernel(),
+          const size_t maxGridPoints = defaultMaxGridPoints);
+
+  /**
+   * Train the model: store the reference set and build the grid.  The
+   * reference set must have between one and three dimensions.
+   *
+   * @param referenceSet Set of reference data.
+   */
+  void Train(arma::mat referenceSet);
+
+  /**
+   * Estimate the density at each point of the query set.  Query points
+   * outside of the grid (i.e. farther than the truncation radius from every
+   * reference point along some dimension) get an estimate of 0.
+   *
+   * @param querySet Set of query points to get the density of.
+   * @param estimations Object which will hold the density of each query point.
+   */
+  void Evaluate(const arma::mat& querySet, arma::vec& estimations) const;
+
+  /**
+   * Estimate the density at each point of the reference set, ignoring the
+   * contribution of each point to its own estimation.
+   *
+   * @param estimations Object which will hold the density of each reference
+   *     point.
+   */
+  void Evaluate(arma::vec& estimations) const;
+
+  //! Get the kernel.
+  const kernel::GaussianKernel& Kernel() const { return kernel; }
+  //! Modify the kernel.  The grid is rebuilt if the model is trained.
+  void Kernel(const kernel::GaussianKernel& newKernel);
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.  The grid is rebuilt if the model is
+  //! trained.
+  void RelativeError(const double newError);
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.  The grid is rebuilt if the model is
+  //! trained.
+  void AbsoluteError(const double newError);
+
+  //! Get the maximum number of grid points.
+  size_t MaxGridPoints() const { return maxGridPoints; }
+  //! Modify the maximum number of grid points.  The grid is rebuilt if the
+  //! model is trained.
+  void MaxGridPoints(const size_t newMaxGridPoints);
+
+  //! Get the reference set.
+  const arma::mat& ReferenceSet() const { return referenceSet; }
+
+  //! Get the spacing between grid points.
+  double Spacing() const { return spacing; }
+
+  //! Get the number of grid points along each dimension.
+  const arma::Col<size_t>& GridSize() const { return gridSize; }
+
+  //! Check whether the model is trained or not.
+  bool IsTrained() const { return trained; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(relError));
+    ar(CEREAL_NVP(absError));
+    ar(CEREAL_NVP(kernel));
+    ar(CEREAL_NVP(maxGridPoints));
+    ar(CEREAL_NVP(referenceSet));
+    ar(CEREAL_NVP(origin));
+    ar(CEREAL_NVP(spacing));
+    ar(CEREAL_NVP(gridSize));
+    ar(CEREAL_NVP(density));
+    ar(CEREAL_NVP(trained));
+  }
+
+ private:
+  //! Relative error tolerance.
+  double relError;
+
+  //! Absolute error tolerance.
+  double absError;
+
+  //! Gaussian kernel.
+  kernel::GaussianKernel kernel;
+
+  //! Maximum number of grid points.
+  size_t maxGridPoints;
+
+  //! Reference set.
+  arma::mat referenceSet;
+
+  //! Position of the first grid point.
+  arma::vec origin;
+
+  //! Spacing between grid points (the same along every dimension).
+  double spacing;
+
+  //! Number of grid points along each of the three grid axes; unused axes
+  //! have size 1.
+  arma::Col<size_t> gridSize;
+
+  //! Unnormalized density at each grid point.
+  arma::cube density;
+
+  //! Whether the model is trained.
+  bool trained;
+
+  //! Build the grid from the reference set.
+  void BuildGrid();
+
+  //! Interpolate the density of the grid at the given point.
+  double Interpolate(const double* point) const;
+
+  /**
+   * Convolve each column of the given matrix with the given kernel weights,
+   * which are centered and have odd length, using FFTs.  Values outside of
+   * each column are taken to be zero.
+   */
+  static void ConvolveColumns(arma::mat& lines, const arma::vec& weights);
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "kde_stat.hpp"
 
@@ -178,6 +179,29 @@ class KDE
    */
   void Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences);
 
+  /**
+   * Compute the moments of every node of the reference tree (the centroid of
+   * its descendants, the scatter matrix around the centroid, the sum of the
+   * cubed distances to the centroid and the largest distance to the centroid)
+   * and store them in the statistics of the nodes, in parallel if OpenMP is
+   * available.  Afterwards, single-tree evaluations with the Gaussian kernel
+   * and the Euclidean distance estimate the nodes whose third order remainder
+   * fits in the error tolerance with a second-order Taylor expansion of the
+   * kernel around the centroid, so fewer nodes have to be visited.  This is
+   * meant for models that serve many small batches of queries against a fixed
+   * reference set; the moments are saved with the model, and they have to be
+   * computed again after Train().
+   *
+   * @pre The model has to be previously trained.
+   */
+  void Precompute();
+
+  //! Check whether the moments of the reference tree were computed.
+  bool Precomputed() const
+  {
+    return trained && !referenceTree->Stat().Centroid().is_empty();
+  }
+
   /**
    * Estimate density of each point in the query set given the data of the
    * reference set. The result is stored in an estimations vector.
@@ -295,6 +319,14 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  //! Get the traversal statistics (base cases, scores, prunes and visited
+  //! nodes) of the last evaluation.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
+  //! Get the number of reference nodes estimated with a Taylor expansion in the
+  //! last evaluation.
+  size_t TaylorApproximations() const { return taylorApproximations; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -346,12 +378,55 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! The traversal statistics of the last evaluation.
+  tree::TraversalStatistics statistics;
+
+  //! The number of reference nodes estimated with a Taylor expansion in the
+  //! last evaluation.
+  size_t taylorApproximations;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  /**
+   * Run the dual-tree algorithm for the given query tree against the reference
+   * tree, adding the (unnormalized) density estimations to the given vector.
+   * If OpenMP is available and more than one thread can be used, the query
+   * tree is split into disjoint subtrees that are traversed in parallel, each
+   * with its own rules object and its own random number generator for Monte
+   * Carlo estimations.  The error tolerances left over by the pruned node
+   * combinations are kept in the statistics of the query nodes, so each of
+   * them is only used by the thread that owns the node.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param estimations Vector to accumulate the estimations in.
+   * @param sameSet Whether the query and reference trees are the same.
+   */
+  void DualTreeTraversal(Tree& queryTree,
+                         arma::vec& estimations,
+                         const bool sameSet);
+
+  /**
+   * Perform a single-tree traversal for each of the given query points, with
+   * multiple threads if OpenMP is available.  Each thread has its own rules
+   * object (with its own error tolerances for each query point and its own
+   * random number generator), and each query point is handled by one thread.
+   * The query points are split in chunks small enough for small batches to
+   * use every thread.  If the reference tree was precomputed and the query
+   * and reference sets are different, the rules may use Taylor expansions
+   * (the expansion of a node would include the query point itself).
+   *
+   * @param querySet Query points.
+   * @param estimations Vector to accumulate the estimations in.
+   * @param sameSet Whether the query and reference sets are the same.
+   */
+  void SingleTreeTraversal(const MatType& querySet,
+                           arma::vec& estimations,
+                           const bool sameSet);
 };
 
 } // namespace kde
@@ -12,6 +12,7 @@
 
 #include "kde.hpp"
 #include "kde_rules.hpp"
+#include <mlpack/core/tree/query_subtrees.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -72,7 +73,8 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    taylorApproximations(0)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -106,7 +108,9 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    statistics(other.statistics),
+    taylorApproximations(other.taylorApproximations)
 {
   if (trained)
   {
@@ -152,7 +156,9 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    statistics(other.statistics),
+    taylorApproximations(other.taylorApproximations)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -168,6 +174,8 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.statistics.Reset();
+  other.taylorApproximations = 0;
 }
 
 template<typename KernelType,
@@ -212,6 +220,8 @@ operator=(const KDE& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    statistics = other.statistics;
+    taylorApproximations = other.taylorApproximations;
     if (trained)
     {
       if (ownsReferenceTree)
@@ -278,6 +288,8 @@ operator=(KDE&& other)
     this->initialSampleSize = other.initialSampleSize;
     this->mcEntryCoef = other.mcEntryCoef;
     this->mcBreakCoef = other.mcBreakCoef;
+    this->statistics = other.statistics;
+    this->taylorApproximations = other.taylorApproximations;
   }
   return *this;
 }
@@ -378,6 +390,69 @@ Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences)
   this->trained = true;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Precompute()
+{
+  if (!trained)
+  {
+    throw std::runtime_error("cannot precompute KDE model: model needs to be "
+                             "trained before precomputation");
+  }
+
+  Timer::Start("precomputing_kde_moments");
+
+  // Collect the nodes, so that their moments can be computed in parallel.
+  std::vector<Tree*> nodes(1, referenceTree);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    for (size_t j = 0; j < nodes[i]->NumChildren(); ++j)
+      nodes.push_back(&nodes[i]->Child(j));
+  }
+
+  const MatType& dataset = referenceTree->Dataset();
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+  {
+    Tree& node = *nodes[i];
+    KDEStat& stat = node.Stat();
+    const size_t numDesc = node.NumDescendants();
+
+    stat.Centroid().zeros(dataset.n_rows);
+    for (size_t j = 0; j < numDesc; ++j)
+      stat.Centroid() += dataset.col(node.Descendant(j));
+    stat.Centroid() /= numDesc;
+
+    stat.Scatter().zeros(dataset.n_rows, dataset.n_rows);
+    stat.ThirdMoment() = 0;
+    stat.Radius() = 0;
+    for (size_t j = 0; j < numDesc; ++j)
+    {
+      const arma::vec e = dataset.col(node.Descendant(j)) - stat.Centroid();
+      const double distance = arma::norm(e);
+      stat.Scatter() += e * e.t();
+      stat.ThirdMoment() += std::pow(distance, 3.0);
+      stat.Radius() = std::max(stat.Radius(), distance);
+    }
+  }
+
+  Timer::Stop("precomputing_kde_moments");
+  Log::Info << "KDE::Precompute(): computed the moments of " << nodes.size()
+      << " nodes." << std::endl;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -444,35 +519,9 @@ Evaluate(MatType querySet, arma::vec& estimations)
     Timer::Start("computing_kde");
 
     // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              metric,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
+    SingleTreeTraversal(querySet, estimations, false);
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
-
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
   }
 }
 
@@ -542,32 +591,12 @@ Evaluate(Tree* queryTree,
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, estimations, false);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -611,41 +640,19 @@ Evaluate(arma::vec& estimations)
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            metric,
-                            kernel,
-                            monteCarlo,
-                            true);
-
   if (mode == DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraversal(*referenceTree, estimations, true);
   }
   else if (mode == SINGLE_TREE_MODE)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(referenceTree->Dataset(), estimations, true);
   }
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
   RearrangeEstimations(*oldFromNewReferences, estimations);
   Timer::Stop("computing_kde");
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -866,5 +873,150 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeTraversal(Tree& queryTree, arma::vec& estimations, const bool sameSet)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  statistics.Reset();
+  taylorApproximations = 0;
+
+  // Each rules object draws the samples of its Monte Carlo estimations from
+  // its own random number generator, seeded from the global one.
+  const size_t seed = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // The Monte Carlo alphas are stored in the reference tree, so compute them
+    // before the reference tree is shared between threads.
+    if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+      RuleType::InitializeAlphas(*referenceTree, mcProb);
+
+    // Each subtree holds a disjoint set of query points, so each rules object
+    // only touches its own entries of the estimations vector and its own query
+    // node statistics (which hold the unused error tolerances).
+    std::vector<Tree*> querySubtrees;
+    tree::QuerySubtrees(queryTree, 4 * numThreads, querySubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+    {
+      RuleType rules(referenceTree->Dataset(), queryTree.Dataset(),
+          estimations, relError, absError, mcProb, initialSampleSize,
+          mcEntryCoef, mcBreakCoef, metric, kernel, monteCarlo, sameSet,
+          seed + i);
+      DualTreeTraversalType<RuleType> traverser(rules);
+      traverser.Traverse(*querySubtrees[i], *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(rules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+  }
+  else
+#endif
+  {
+    RuleType rules(referenceTree->Dataset(), queryTree.Dataset(), estimations,
+        relError, absError, mcProb, initialSampleSize, mcEntryCoef,
+        mcBreakCoef, metric, kernel, monteCarlo, sameSet, seed);
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(queryTree, *referenceTree);
+    statistics.Add(rules, traverser);
+  }
+
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeTraversal(const MatType& querySet,
+                    arma::vec& estimations,
+                    const bool sameSet)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  // The Monte Carlo alphas are stored in the reference tree, so compute them
+  // before the reference tree is shared between threads.
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    RuleType::InitializeAlphas(*referenceTree, mcProb);
+
+  // Each thread draws the samples of its Monte Carlo estimations from its own
+  // random number generator, seeded from the global one.
+  const size_t seed = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+  statistics.Reset();
+  taylorApproximations = 0;
+
+  // Small batches are split in small chunks, so that every thread gets some
+  // query points.
+  size_t chunkSize = 64;
+#ifdef HAS_OPENMP
+  chunkSize = std::max((size_t) 1, std::min(chunkSize,
+      (size_t) querySet.n_cols / (4 * omp_get_max_threads())));
+#endif
+
+  #pragma omp parallel
+  {
+    size_t threadSeed = seed;
+#ifdef HAS_OPENMP
+    threadSeed += omp_get_thread_num();
+#endif
+
+    RuleType rules(referenceTree->Dataset(), querySet, estimations, relError,
+        absError, mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef, metric,
+        kernel, monteCarlo, sameSet, threadSeed, !sameSet);
+    SingleTreeTraversalType<RuleType> traverser(rules);
+
+    // Each query point is handled by one thread, so the threads write to
+    // different entries of the estimations vector.
+    #pragma omp for schedule(dynamic, chunkSize)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    tree::TraversalStatistics threadStatistics;
+    threadStatistics.Add(rules, traverser);
+    #pragma omp critical
+    {
+      statistics += threadStatistics;
+      taylorApproximations += rules.TaylorApproximations();
+    }
+  }
+
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+  if (taylorApproximations > 0)
+  {
+    Log::Info << taylorApproximations << " reference nodes were estimated "
+        << "with Taylor expansions." << std::endl;
+  }
+}
+
 } // namespace kde
 } // namespace mlpack
@@ -56,6 +56,16 @@ BINDING_LONG_DESC(
     "use dual-tree algorithm or single-tree algorithm using the " +
     PRINT_PARAM_STRING("algorithm") + " option."
     "\n\n"
+    "For data with one to three dimensions and the Gaussian kernel, the 'grid' "
+    "algorithm can be selected instead.  It bins the reference points onto a "
+    "regular grid, convolves the grid with the kernel using FFTs and "
+    "interpolates the result at each query point, which is much faster than "
+    "the tree-based algorithms when there are many query points.  The grid "
+    "spacing is chosen from the bandwidth and " +
+    PRINT_PARAM_STRING("rel_error") + ", and the kernel is truncated according "
+    "to " + PRINT_PARAM_STRING("abs_error") + "; no tree is used, so " +
+    PRINT_PARAM_STRING("tree") + " is ignored."
+    "\n\n"
     "Monte Carlo estimations can be used to accelerate the KDE estimate when "
     "the Gaussian Kernel is used. This provides a probabilistic guarantee on "
     "the the error of the resulting KDE instead of an absolute guarantee."
@@ -152,7 +162,7 @@ PARAM_STRING_IN("tree", "Tree to use for the prediction."
     "('kd-tree', 'ball-tree', 'cover-tree', 'octree', 'r-tree').",
     "t", "kd-tree");
 PARAM_STRING_IN("algorithm", "Algorithm to use for the prediction."
-    "('dual-tree', 'single-tree').",
+    "('dual-tree', 'single-tree', 'grid').",
     "a", "dual-tree");
 PARAM_DOUBLE_IN("rel_error",
                 "Relative error tolerance for the prediction.",
@@ -231,8 +241,8 @@ static void mlpackMain()
       "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
   RequireParamInSet<string>("tree", { "kd-tree", "ball-tree", "cover-tree",
       "octree", "r-tree"}, true, "unknown tree type");
-  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree"},
-      true, "unknown algorithm");
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree",
+      "grid" }, true, "unknown algorithm");
   RequireParamValue<double>("rel_error", [](double x){return x >= 0 && x <= 1;},
       true, "relative error must be between 0 and 1");
   RequireParamValue<double>("abs_error", [](double x){return x >= 0;},
@@ -250,6 +260,29 @@ static void mlpackMain()
       "Monte Carlo break coefficient must be greater than 0 and less than "
       "or equal to 1");
 
+  // The grid algorithm has its own restrictions.
+  if (modeStr == "grid")
+  {
+    ReportIgnoredParam("tree", "the grid algorithm does not use a tree");
+    ReportIgnoredParam("monte_carlo", "the grid algorithm does not use Monte "
+        "Carlo estimations");
+    if (IO::HasParam("reference"))
+    {
+      if (kernelStr != "gaussian")
+      {
+        Log::Fatal << "The grid algorithm only supports the Gaussian kernel."
+            << std::endl;
+      }
+      const size_t dimensionality = IO::GetParam<arma::mat>("reference").n_rows;
+      if (dimensionality == 0 || dimensionality > 3)
+      {
+        Log::Fatal << "The grid algorithm only supports data with 1 to 3 "
+            << "dimensions, but the reference set has " << dimensionality
+            << " dimensions." << std::endl;
+      }
+    }
+  }
+
   KDEModel* kde;
 
   if (IO::HasParam("reference"))
@@ -271,7 +304,9 @@ static void mlpackMain()
       kde->KernelType() = KDEModel::TRIANGULAR_KERNEL;
 
     // Set TreeType.
-    if (treeStr == "kd-tree")
+    if (modeStr == "grid")
+      kde->TreeType() = KDEModel::GRID;
+    else if (treeStr == "kd-tree")
       kde->TreeType() = KDEModel::KD_TREE;
     else if (treeStr == "ball-tree")
       kde->TreeType() = KDEModel::BALL_TREE;
@@ -183,6 +183,12 @@ KDEWrapperBase* InitializeModelHelper(const KDEModel::KernelTypes kernelType,
 
 void KDEModel::InitializeModel()
 {
+  if (treeType == GRID && kernelType != GAUSSIAN_KERNEL)
+  {
+    throw std::invalid_argument("cannot initialize KDE model: the grid "
+                                "algorithm only supports the Gaussian kernel");
+  }
+
   // Clean memory, if necessary.
   delete kdeModel;
 
@@ -213,6 +219,11 @@ void KDEModel::InitializeModel()
       kdeModel = InitializeModelHelper<tree::RTree>(kernelType, relError,
           absError, bandwidth);
       break;
+
+    case GRID:
+      kdeModel = new GridKDEWrapper(relError, absError,
+          kernel::GaussianKernel(bandwidth));
+      break;
   }
 }
 
@@ -239,6 +250,31 @@ void KDEModel::BuildModel(arma::mat&& referenceSet)
   kdeModel->Train(std::move(referenceSet));
 }
 
+// Train the grid.
+void GridKDEWrapper::Train(arma::mat&& referenceSet)
+{
+  kde.Train(std::move(referenceSet));
+}
+
+// Perform bichromatic grid evaluation.
+void GridKDEWrapper::Evaluate(arma::mat&& querySet, arma::vec& estimates)
+{
+  const size_t dimension = querySet.n_rows;
+  kde.Evaluate(querySet, estimates);
+  kernel::GaussianKernel gaussian = kde.Kernel();
+  KernelNormalizer::ApplyNormalizer<kernel::GaussianKernel>(gaussian,
+      dimension, estimates);
+}
+
+// Perform monochromatic grid evaluation.
+void GridKDEWrapper::Evaluate(arma::vec& estimates)
+{
+  kde.Evaluate(estimates);
+  kernel::GaussianKernel gaussian = kde.Kernel();
+  KernelNormalizer::ApplyNormalizer<kernel::GaussianKernel>(gaussian,
+      kde.ReferenceSet().n_rows, estimates);
+}
+
 // Perform bichromatic evaluation.
 void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimates)
 {
@@ -251,6 +287,12 @@ void KDEModel::Evaluate(arma::vec& estimates)
   kdeModel->Evaluate(estimates);
 }
 
+// Compute the moments of the nodes of the reference tree.
+void KDEModel::Precompute()
+{
+  kdeModel->Precompute();
+}
+
 // Clean memory.
 void KDEModel::CleanMemory()
 {
@@ -313,5 +355,13 @@ void KDEModel::MCBreakCoefficient(const double newBreakCoef)
   kdeModel->MCBreakCoef(mcBreakCoef);
 }
 
+// Instantiate the serialization for the archives used by the bindings.
+template void KDEModel::serialize(cereal::BinaryInputArchive&, const uint32_t);
+template void KDEModel::serialize(cereal::BinaryOutputArchive&, const uint32_t);
+template void KDEModel::serialize(cereal::JSONInputArchive&, const uint32_t);
+template void KDEModel::serialize(cereal::JSONOutputArchive&, const uint32_t);
+template void KDEModel::serialize(cereal::XMLInputArchive&, const uint32_t);
+template void KDEModel::serialize(cereal::XMLOutputArchive&, const uint32_t);
+
 } // namespace kde
 } // namespace mlpack
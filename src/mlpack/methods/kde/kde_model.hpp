@@ -23,6 +23,7 @@
 
 // Remaining includes.
 #include "kde.hpp"
+#include "grid_kde.hpp"
 
 namespace mlpack {
 namespace kde {
@@ -124,6 +125,9 @@ class KDEWrapperBase
 
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(arma::vec& estimates) = 0;
+
+  //! Compute the moments of the nodes for Taylor expansions.
+  virtual void Precompute() = 0;
 };
 
 /**
@@ -203,6 +207,9 @@ class KDEWrapper : public KDEWrapperBase
   //! Perform monochromatic KDE (i.e. with the reference set as the query set).
   virtual void Evaluate(arma::vec& estimates);
 
+  //! Compute the moments of the nodes for Taylor expansions.
+  virtual void Precompute() { kde.Precompute(); }
+
   //! Serialize the KDE model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -220,6 +227,103 @@ class KDEWrapper : public KDEWrapperBase
   KDEType kde;
 };
 
+/**
+ * GridKDEWrapper wraps the grid-based GridKDE class so that it can be held by
+ * KDEModel.  GridKDE only supports the Gaussian kernel and does not use trees,
+ * so the Monte Carlo parameters and the search mode are stored but ignored.
+ */
+class GridKDEWrapper : public KDEWrapperBase
+{
+ public:
+  //! Create the GridKDEWrapper object, initializing the internally-held
+  //! GridKDE object.
+  GridKDEWrapper(const double relError,
+                 const double absError,
+                 const kernel::GaussianKernel& kernel) :
+      kde(relError, absError, kernel),
+      monteCarlo(KDEDefaultParams::monteCarlo),
+      initialSampleSize(KDEDefaultParams::initialSampleSize),
+      mode(KDEDefaultParams::mode)
+  {
+    // Nothing left to do.
+  }
+
+  //! Create a new GridKDEWrapper that is the same as this one.
+  virtual GridKDEWrapper* Clone() const { return new GridKDEWrapper(*this); }
+
+  //! Destruct the GridKDEWrapper (nothing to do).
+  virtual ~GridKDEWrapper() { }
+
+  //! Modify the bandwidth of the kernel.
+  virtual void Bandwidth(const double bw)
+  {
+    kde.Kernel(kernel::GaussianKernel(bw));
+  }
+
+  //! Modify the relative error tolerance.
+  virtual void RelativeError(const double eps) { kde.RelativeError(eps); }
+
+  //! Modify the absolute error tolerance.
+  virtual void AbsoluteError(const double eps) { kde.AbsoluteError(eps); }
+
+  //! Get whether Monte Carlo search is being used (it is ignored).
+  virtual bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo search is being used (it is ignored).
+  virtual bool& MonteCarlo() { return monteCarlo; }
+
+  //! Modify the Monte Carlo probability (it is ignored).
+  virtual void MCProb(const double /* mcProb */) { }
+
+  //! Get the Monte Carlo sample size (it is ignored).
+  virtual size_t MCInitialSampleSize() const { return initialSampleSize; }
+  //! Modify the Monte Carlo sample size (it is ignored).
+  virtual size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Modify the Monte Carlo entry coefficient (it is ignored).
+  virtual void MCEntryCoef(const double /* e */) { }
+
+  //! Modify the Monte Carlo break coefficient (it is ignored).
+  virtual void MCBreakCoef(const double /* b */) { }
+
+  //! Get the search mode (it is ignored).
+  virtual KDEMode Mode() const { return mode; }
+  //! Modify the search mode (it is ignored).
+  virtual KDEMode& Mode() { return mode; }
+
+  //! Train the model (build the grid).
+  virtual void Train(arma::mat&& referenceSet);
+
+  //! Perform bichromatic KDE (i.e. KDE with a separate query set).
+  virtual void Evaluate(arma::mat&& querySet,
+                        arma::vec& estimates);
+
+  //! Perform monochromatic KDE (i.e. with the reference set as the query set).
+  virtual void Evaluate(arma::vec& estimates);
+
+  //! The grid has nothing to precompute.
+  virtual void Precompute() { }
+
+  //! Serialize the KDE model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(kde));
+  }
+
+ protected:
+  //! The instantiated GridKDE object that we are wrapping.
+  GridKDE kde;
+
+  //! Unused Monte Carlo flag.
+  bool monteCarlo;
+
+  //! Unused Monte Carlo initial sample size.
+  size_t initialSampleSize;
+
+  //! Unused search mode.
+  KDEMode mode;
+};
+
 /**
  * The KDEModel provides an abstraction for the KDE class, abstracting away the
  * KernelType and TreeType parameters and allowing those to be specified at
@@ -235,7 +339,8 @@ class KDEModel
     BALL_TREE,
     COVER_TREE,
     OCTREE,
-    R_TREE
+    R_TREE,
+    GRID // Not a tree: binned grid approximation (see GridKDE).
   };
 
   enum KernelTypes
@@ -452,6 +557,14 @@ class KDEModel
    */
   void Evaluate(arma::vec& estimations);
 
+  /**
+   * Compute the moments of the nodes of the reference tree, so that
+   * single-tree evaluations with the Gaussian kernel can use Taylor
+   * expansions; see KDE::Precompute().  This does nothing for the grid.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   */
+  void Precompute();
 
  private:
   //! Clean memory.
@@ -463,4 +576,36 @@ class KDEModel
 
 #include "kde_model_impl.hpp"
 
+namespace mlpack {
+namespace kde {
+
+/**
+ * The serialization of KDEModel, which covers every KDE type it can hold, is
+ * compiled into libmlpack (in kde_model.cpp) for the archives used by the
+ * bindings, so that the programs that load and save models don't have to
+ * instantiate it again.
+ *
+ * @cond
+ */
+
+extern template void KDEModel::serialize(cereal::BinaryInputArchive&,
+                                         const uint32_t);
+extern template void KDEModel::serialize(cereal::BinaryOutputArchive&,
+                                         const uint32_t);
+extern template void KDEModel::serialize(cereal::JSONInputArchive&,
+                                         const uint32_t);
+extern template void KDEModel::serialize(cereal::JSONOutputArchive&,
+                                         const uint32_t);
+extern template void KDEModel::serialize(cereal::XMLInputArchive&,
+                                         const uint32_t);
+extern template void KDEModel::serialize(cereal::XMLOutputArchive&,
+                                         const uint32_t);
+
+/**
+ * @endcond
+ */
+
+} // namespace kde
+} // namespace mlpack
+
 #endif
@@ -159,6 +159,13 @@ void KDEModel::serialize(Archive& ar, const uint32_t /* version */)
     case R_TREE:
       SerializationHelper<tree::RTree>(ar, kdeModel, kernelType);
       break;
+
+    case GRID:
+      {
+        GridKDEWrapper& typedModel = dynamic_cast<GridKDEWrapper&>(*kdeModel);
+        ar(CEREAL_NVP(typedModel));
+        break;
+      }
   }
 }
 
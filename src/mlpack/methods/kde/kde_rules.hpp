@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -45,6 +46,14 @@ class KDERules
    *                   possible.
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
+   * @param seed Seed of the random number generator of the Monte Carlo
+   *             estimations.  Each rules object has its own generator, so
+   *             several rules objects can be used by different threads.
+   * @param taylor If true, single-tree scores of reference nodes whose moments
+   *               were computed by KDE::Precompute() may use a second-order
+   *               Taylor expansion of the Gaussian kernel around the centroid
+   *               of the node (only with the Gaussian kernel and the Euclidean
+   *               distance).
    */
   KDERules(const arma::mat& referenceSet,
            const arma::mat& querySet,
@@ -58,7 +67,9 @@ class KDERules
            MetricType& metric,
            KernelType& kernel,
            const bool monteCarlo,
-           const bool sameSet);
+           const bool sameSet,
+           const size_t seed = 0,
+           const bool taylor = false);
 
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -93,10 +104,25 @@ class KDERules
   //! Get the number of scores.
   size_t Scores() const { return scores; }
 
+  //! Get the number of reference nodes estimated with a Taylor expansion.
+  size_t TaylorApproximations() const { return taylorApproximations; }
+
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
   size_t MinimumBaseCases() const { return 0; }
 
+  /**
+   * Compute the Monte Carlo alpha of every node of the given reference tree.
+   * The alphas are otherwise computed (and stored in the statistics of the
+   * nodes) the first time each node is scored, so this must be called before
+   * several rules objects traverse the same reference tree at the same time.
+   *
+   * @param referenceNode Root of the reference tree.
+   * @param mcProb Probability of relative error compliance for Monte Carlo
+   *               estimations.
+   */
+  static void InitializeAlphas(TreeType& referenceNode, const double mcProb);
+
  private:
   //! Evaluate kernel value of 2 points given their indexes.
   double EvaluateKernel(const size_t queryIndex,
@@ -107,7 +133,56 @@ class KDERules
                         const arma::vec& reference) const;
 
   //! Calculate depth alpha for some node.
-  double CalculateAlpha(TreeType* node);
+  static double CalculateAlpha(TreeType* node, const double mcBeta);
+
+  //! Pick a random descendant of a reference node in [lo, hiExclusive).
+  size_t RandomDescendant(const size_t lo, const size_t hiExclusive);
+
+  /**
+   * Estimate the contribution of the given reference node to the density of
+   * the given query point with the second-order Taylor expansion of the
+   * Gaussian kernel around the centroid of the node, if the bound of the third
+   * order remainder lets the node be pruned.
+   *
+   * @param queryIndex Index of the query point.
+   * @param referenceNode Reference node, whose moments must be computed.
+   * @param alreadyDidRefPoint0 Whether the first point of the node was
+   *     already evaluated.
+   * @param minKernel Smallest kernel value between the query point and the
+   *     node.
+   * @param maxKernel Largest kernel value between the query point and the
+   *     node.
+   * @param errorTolerance Error tolerance of each point of the node.
+   * @param pointAccumErrorTol Accumulated error tolerance of each point.
+   * @return Whether the node was estimated (and so pruned).
+   */
+  bool TaylorPrune(const size_t queryIndex,
+                   TreeType& referenceNode,
+                   const bool alreadyDidRefPoint0,
+                   const double minKernel,
+                   const double maxKernel,
+                   const double errorTolerance,
+                   const double pointAccumErrorTol);
+
+  //! Get the bandwidth of the Gaussian kernel.
+  template<typename KernelT>
+  static double GaussianBandwidth(
+      const KernelT& kernel,
+      const typename std::enable_if<std::is_same<KernelT,
+          kernel::GaussianKernel>::value>::type* = 0)
+  {
+    return kernel.Bandwidth();
+  }
+
+  //! Kernels other than the Gaussian kernel have no Taylor expansion.
+  template<typename KernelT>
+  static double GaussianBandwidth(
+      const KernelT& /* kernel */,
+      const typename std::enable_if<!std::is_same<KernelT,
+          kernel::GaussianKernel>::value>::type* = 0)
+  {
+    return 0.0;
+  }
 
   //! The reference set.
   const arma::mat& referenceSet;
@@ -162,6 +237,10 @@ class KDERules
   constexpr static bool kernelIsGaussian =
       std::is_same<KernelType, kernel::GaussianKernel>::value;
 
+  //! Whether Taylor expansions are used (they need the Gaussian kernel and the
+  //! Euclidean distance).
+  const bool taylor;
+
   //! Absolute error tolerance available for each reference point.
   const double absErrorTol;
 
@@ -171,14 +250,23 @@ class KDERules
   //! The last reference index.
   size_t lastReferenceIndex;
 
+  //! The distances from the last scored query point to leaves.
+  tree::LeafDistanceCache<MetricType, arma::mat> leafDistances;
+
   //! Traversal information.
   TraversalInfoType traversalInfo;
 
+  //! Random number generator of the Monte Carlo estimations.
+  std::mt19937 randGen;
+
   //! The number of base cases.
   size_t baseCases;
 
   //! The number of scores.
   size_t scores;
+
+  //! The number of reference nodes estimated with a Taylor expansion.
+  size_t taylorApproximations;
 };
 
 /**
@@ -36,7 +36,9 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     MetricType& metric,
     KernelType& kernel,
     const bool monteCarlo,
-    const bool sameSet) :
+    const bool sameSet,
+    const size_t seed,
+    const bool taylor) :
     referenceSet(referenceSet),
     querySet(querySet),
     densities(densities),
@@ -50,11 +52,15 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     kernel(kernel),
     monteCarlo(monteCarlo),
     sameSet(sameSet),
+    taylor(taylor && kernelIsGaussian &&
+        std::is_same<MetricType, metric::EuclideanDistance>::value),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
+    randGen((uint32_t) seed),
     baseCases(0),
-    scores(0)
+    scores(0),
+    taylorApproximations(0)
 {
   // Initialize accumError.
   accumError = arma::vec(querySet.n_cols, arma::fill::zeros);
@@ -81,8 +87,13 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
     return 0.0;
 
   // Calculations.
-  const double distance = metric.Evaluate(querySet.col(queryIndex),
-                                          referenceSet.col(referenceIndex));
+  double distance;
+  if (!leafDistances.Distance(querySet, referenceSet, queryIndex,
+      referenceIndex, distance))
+  {
+    distance = metric.Evaluate(querySet.col(queryIndex),
+                               referenceSet.col(referenceIndex));
+  }
   const double kernelValue = kernel.Evaluate(distance);
   densities(queryIndex) += kernelValue;
 
@@ -110,7 +121,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
@@ -184,6 +195,17 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     if (kernelIsGaussian && monteCarlo)
       accumMCAlpha(queryIndex) += depthAlpha;
   }
+  else if (taylor && !referenceNode.Stat().Centroid().is_empty() &&
+           TaylorPrune(queryIndex, referenceNode, alreadyDidRefPoint0,
+               minKernel, maxKernel, errorTolerance, pointAccumErrorTol))
+  {
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+
+    // Store not used alpha for Monte Carlo.
+    if (monteCarlo)
+      accumMCAlpha(queryIndex) += depthAlpha;
+  }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
            kernelIsGaussian)
@@ -222,9 +244,9 @@ Score(const size_t queryIndex, TreeType& referenceNode)
         // Sample and evaluate random points from the reference node.
         size_t randomPoint;
         if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
+          randomPoint = RandomDescendant(1, refNumDesc);
         else
-          randomPoint = math::RandInt(0, refNumDesc);
+          randomPoint = RandomDescendant(0, refNumDesc);
 
         sample(oldSize + i) =
             EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -287,6 +309,10 @@ Score(const size_t queryIndex, TreeType& referenceNode)
       accumMCAlpha(queryIndex) += depthAlpha;
   }
 
+  // If the node will be visited, its distances can be computed together.
+  if (score != DBL_MAX)
+    leafDistances.Prepare(queryIndex, referenceNode);
+
   ++scores;
   traversalInfo.LastReferenceNode() = &referenceNode;
   traversalInfo.LastScore() = score;
@@ -316,7 +342,7 @@ Score(TreeType& queryNode, TreeType& referenceNode)
 
   // Calculate alpha if Monte Carlo is available.
   if (monteCarlo && kernelIsGaussian)
-    depthAlpha = CalculateAlpha(&referenceNode);
+    depthAlpha = CalculateAlpha(&referenceNode, mcBeta);
   else
     depthAlpha = -1;
 
@@ -439,9 +465,9 @@ Score(TreeType& queryNode, TreeType& referenceNode)
           // Sample and evaluate random points from the reference node.
           size_t randomPoint;
           if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
+            randomPoint = RandomDescendant(1, refNumDesc);
           else
-            randomPoint = math::RandInt(0, refNumDesc);
+            randomPoint = RandomDescendant(0, refNumDesc);
 
           sample(oldSize + i) =
               EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
@@ -546,7 +572,7 @@ EvaluateKernel(const arma::vec& query, const arma::vec& reference) const
 
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline double KDERules<MetricType, KernelType, TreeType>::
-CalculateAlpha(TreeType* node)
+CalculateAlpha(TreeType* node, const double mcBeta)
 {
   KDEStat& stat = node->Stat();
 
@@ -573,6 +599,80 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::
+InitializeAlphas(TreeType& referenceNode, const double mcProb)
+{
+  // The alpha of a node depends on the alpha of its parent.
+  CalculateAlpha(&referenceNode, 1 - mcProb);
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+    InitializeAlphas(referenceNode.Child(i), mcProb);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline size_t KDERules<MetricType, KernelType, TreeType>::
+RandomDescendant(const size_t lo, const size_t hiExclusive)
+{
+  std::uniform_int_distribution<size_t> dist(lo, hiExclusive - 1);
+  return dist(randGen);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::
+TaylorPrune(const size_t queryIndex,
+            TreeType& referenceNode,
+            const bool alreadyDidRefPoint0,
+            const double minKernel,
+            const double maxKernel,
+            const double errorTolerance,
+            const double pointAccumErrorTol)
+{
+  const KDEStat& stat = referenceNode.Stat();
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  const size_t numPoints = alreadyDidRefPoint0 ? refNumDesc - 1 : refNumDesc;
+  if (numPoints == 0)
+    return false;
+
+  // With d = q - c and e = r - c, the sum of exp(-|d - e|^2 / (2 h^2)) over
+  // the descendants r is K(|d|) * (n - tr(S) / (2 h^2) + d^T S d / (2 h^4))
+  // up to the third order in e, since the sum of the e is zero.
+  const double bandwidth = GaussianBandwidth(kernel);
+  const double h2 = bandwidth * bandwidth;
+  const arma::vec d = querySet.unsafe_col(queryIndex) - stat.Centroid();
+  const double distance = arma::norm(d);
+
+  // The third directional derivative of the kernel on the segment between c
+  // and r is bounded by max |z^3 - 3z| exp(-z^2 / 2) / h^3 = 1.3801 / h^3,
+  // and by K(m) * ((M / h)^3 + 3 M / h) / h^3, where m and M are the smallest
+  // and largest distances from q to the ball of radius Radius() around c.
+  const double minDistance = std::max(distance - stat.Radius(), 0.0);
+  const double maxRatio = (distance + stat.Radius()) / bandwidth;
+  const double derivativeBound = std::min(1.3801,
+      kernel.Evaluate(minDistance) * (std::pow(maxRatio, 3.0) + 3 * maxRatio)) /
+      (h2 * bandwidth);
+  const double pointError = stat.ThirdMoment() * derivativeBound /
+      (6 * numPoints);
+  if (2 * pointError > 2 * errorTolerance + pointAccumErrorTol)
+    return false;
+
+  double estimate = kernel.Evaluate(distance) * (refNumDesc -
+      arma::trace(stat.Scatter()) / (2 * h2) +
+      arma::dot(d, stat.Scatter() * d) / (2 * h2 * h2));
+  if (alreadyDidRefPoint0)
+    estimate -= EvaluateKernel(queryIndex, referenceNode.Point(0));
+
+  // The exact sum is between the bounds of the kernel, so clamping can only
+  // reduce the error.
+  estimate = std::min(std::max(estimate, numPoints * minKernel),
+      numPoints * maxKernel);
+  densities(queryIndex) += estimate;
+
+  // Subtract used error tolerance or add extra available tolerance.
+  accumError(queryIndex) -= numPoints * (2 * pointError - 2 * errorTolerance);
+  ++taylorApproximations;
+  return true;
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
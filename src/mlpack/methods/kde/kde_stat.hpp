@@ -29,7 +29,9 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      thirdMoment(0),
+      radius(0)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -38,7 +40,9 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      thirdMoment(0),
+      radius(0)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -65,14 +69,49 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
+  //! Get the centroid of the descendants of the node (empty if the moments of
+  //! the node haven't been computed by KDE::Precompute()).
+  inline const arma::vec& Centroid() const { return centroid; }
+
+  //! Modify the centroid of the descendants of the node.
+  inline arma::vec& Centroid() { return centroid; }
+
+  //! Get the scatter matrix of the descendants of the node, that is the sum of
+  //! (r - c) * (r - c)^T over the descendants r, where c is the centroid.
+  inline const arma::mat& Scatter() const { return scatter; }
+
+  //! Modify the scatter matrix of the descendants of the node.
+  inline arma::mat& Scatter() { return scatter; }
+
+  //! Get the sum of the cubed distances of the descendants to the centroid.
+  inline double ThirdMoment() const { return thirdMoment; }
+
+  //! Modify the sum of the cubed distances of the descendants to the centroid.
+  inline double& ThirdMoment() { return thirdMoment; }
+
+  //! Get the largest distance of a descendant to the centroid.
+  inline double Radius() const { return radius; }
+
+  //! Modify the largest distance of a descendant to the centroid.
+  inline double& Radius() { return radius; }
+
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(mcBeta));
     ar(CEREAL_NVP(mcAlpha));
     ar(CEREAL_NVP(accumAlpha));
     ar(CEREAL_NVP(accumError));
+
+    // Version 0 of the statistic has no moments.
+    if (version >= 1)
+    {
+      ar(CEREAL_NVP(centroid));
+      ar(CEREAL_NVP(scatter));
+      ar(CEREAL_NVP(thirdMoment));
+      ar(CEREAL_NVP(radius));
+    }
   }
 
  private:
@@ -87,9 +126,23 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Centroid of the descendants (empty if the moments are not computed).
+  arma::vec centroid;
+
+  //! Scatter matrix of the descendants around the centroid.
+  arma::mat scatter;
+
+  //! Sum of the cubed distances of the descendants to the centroid.
+  double thirdMoment;
+
+  //! Largest distance of a descendant to the centroid.
+  double radius;
 };
 
 } // namespace kde
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::kde::KDEStat, 1);
+
 #endif
@@ -0,0 +1,86 @@
+/**
+ * @file methods/kernel_approximation/fourier_frequencies.hpp
+ *
+ * Sampling of the random frequencies used by RandomFourierFeatures.  By
+ * Bochner's theorem, a shift-invariant kernel k(x - y) is the Fourier transform
+ * of a probability distribution; the specializations below draw frequencies
+ * from that distribution for the kernels that are supported.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_FOURIER_FREQUENCIES_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_FOURIER_FREQUENCIES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * FourierFrequencies<KernelType> provides a static Sample() function that
+ * fills a matrix with frequencies drawn from the spectral distribution of the
+ * kernel, one frequency per column:
+ *
+ * @code
+ * static void Sample(const KernelType& kernel,
+ *                    const size_t dimensionality,
+ *                    const size_t numFeatures,
+ *                    arma::mat& frequencies);
+ * @endcode
+ *
+ * Only shift-invariant kernels have a spectral distribution, so there is no
+ * general implementation; using RandomFourierFeatures with a kernel that has
+ * no specialization is a compile-time error.
+ */
+template<typename KernelType>
+class FourierFrequencies;
+
+/**
+ * The spectral distribution of the Gaussian kernel with bandwidth sigma is the
+ * normal distribution N(0, sigma^{-2} I).
+ */
+template<>
+class FourierFrequencies<GaussianKernel>
+{
+ public:
+  static void Sample(const GaussianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFeatures);
+    frequencies /= kernel.Bandwidth();
+  }
+};
+
+/**
+ * The spectral distribution of the Laplacian kernel exp(-||x - y|| / sigma) is
+ * the multivariate Cauchy distribution with scale 1 / sigma.  A sample is a
+ * standard normal vector divided by sigma times the absolute value of an
+ * independent standard normal variable.
+ */
+template<>
+class FourierFrequencies<LaplacianKernel>
+{
+ public:
+  static void Sample(const LaplacianKernel& kernel,
+                     const size_t dimensionality,
+                     const size_t numFeatures,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn(dimensionality, numFeatures);
+    const arma::rowvec scales = arma::abs(arma::randn<arma::rowvec>(
+        numFeatures)) * kernel.Bandwidth();
+    frequencies.each_row() /= scales;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file methods/kernel_approximation/kernel_approximation_classifier.hpp
+ *
+ * A classifier that trains a linear model on an explicit kernel feature map.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_KERNEL_APPROXIMATION_CLASSIFIER_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_KERNEL_APPROXIMATION_CLASSIFIER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * KernelApproximationClassifier chains a kernel feature map (such as
+ * RandomFourierFeatures or NystroemFeatures) with a linear classifier (such as
+ * svm::LinearSVM or regression::LogisticRegression).  Training fits the
+ * feature map to the data and trains the classifier on the transformed points;
+ * classification transforms the points with the same map.  This gives an
+ * accuracy close to that of the kernel machine at the cost of a linear model.
+ *
+ * For example, an approximate Gaussian kernel SVM can be trained with
+ *
+ * @code
+ * KernelApproximationClassifier<RandomFourierFeatures<GaussianKernel>,
+ *     svm::LinearSVM<>> c(RandomFourierFeatures<GaussianKernel>(500,
+ *     GaussianKernel(0.5)));
+ * c.Train(data, labels, numClasses);
+ * c.Classify(testData, predictions);
+ * @endcode
+ *
+ * @tparam FeatureMapType Feature map, with Train(data) and
+ *     Transform(data, features) methods.
+ * @tparam ClassifierType Linear classifier, with Train(data, labels, ...) and
+ *     Classify(data, labels, ...) methods.
+ */
+template<typename FeatureMapType, typename ClassifierType>
+class KernelApproximationClassifier
+{
+ public:
+  /**
+   * Create the classifier with the given (untrained) feature map and
+   * classifier.
+   *
+   * @param featureMap Feature map to use.
+   * @param classifier Linear classifier to use.
+   */
+  KernelApproximationClassifier(
+      const FeatureMapType& featureMap = FeatureMapType(),
+      const ClassifierType& classifier = ClassifierType()) :
+      featureMap(featureMap),
+      classifier(classifier)
+  { }
+
+  /**
+   * Fit the feature map to the data and train the classifier on the
+   * transformed data.  Any additional arguments are passed to the Train()
+   * method of the classifier.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the training points.
+   * @param args Additional arguments for the classifier.
+   * @return The return value of the Train() method of the classifier.
+   */
+  template<typename... Args>
+  double Train(const arma::mat& data,
+               const arma::Row<size_t>& labels,
+               Args&&... args)
+  {
+    featureMap.Train(data);
+    arma::mat features;
+    featureMap.Transform(data, features);
+    return classifier.Train(features, labels, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Classify the given points.  Any additional arguments are passed to the
+   * Classify() method of the classifier.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Vector to store the predicted labels in.
+   * @param args Additional arguments for the classifier.
+   */
+  template<typename... Args>
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& labels,
+                Args&&... args) const
+  {
+    arma::mat features;
+    featureMap.Transform(data, features);
+    classifier.Classify(features, labels, std::forward<Args>(args)...);
+  }
+
+  //! Get the feature map.
+  const FeatureMapType& FeatureMap() const { return featureMap; }
+  //! Modify the feature map.
+  FeatureMapType& FeatureMap() { return featureMap; }
+
+  //! Get the classifier.
+  const ClassifierType& Classifier() const { return classifier; }
+  //! Modify the classifier.
+  ClassifierType& Classifier() { return classifier; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(featureMap));
+    ar(CEREAL_NVP(classifier));
+  }
+
+ private:
+  //! The feature map.
+  FeatureMapType featureMap;
+  //! The linear classifier.
+  ClassifierType classifier;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
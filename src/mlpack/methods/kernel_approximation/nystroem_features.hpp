@@ -0,0 +1,122 @@
+/**
+ * @file methods/kernel_approximation/nystroem_features.hpp
+ *
+ * An explicit feature map whose inner products approximate a kernel, computed
+ * with the Nystroem method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_NYSTROEM_FEATURES_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_NYSTROEM_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * NystroemFeatures maps points to a space of `rank` dimensions in which inner
+ * products approximate a kernel.  Train() selects `rank` landmark points with
+ * the given PointSelectionPolicy (the same policies as NystroemMethod) and
+ * eigendecomposes the kernel matrix K_mm = U S U^T between them.  A point x is
+ * then mapped to
+ *
+ *   z(x) = S^{-1/2} U^T k(x),
+ *
+ * where k(x) holds the kernel evaluations between x and the landmarks, so that
+ * z(x)^T z(y) is the Nystroem approximation of k(x, y).  Unlike
+ * NystroemMethod, the map can be applied to points that were not used in
+ * training, so the transformed points can be given to any linear model, such
+ * as LinearSVM or LogisticRegression (see KernelApproximationClassifier).
+ *
+ * @tparam KernelType Kernel to approximate.
+ * @tparam PointSelectionPolicy Policy used to select the landmarks.
+ */
+template<
+  typename KernelType,
+  typename PointSelectionPolicy = KMeansSelection<>
+>
+class NystroemFeatures
+{
+ public:
+  /**
+   * Create the feature map.  Train() must be called before Transform().
+   *
+   * @param rank Number of landmarks (and of features).
+   * @param kernel Kernel to approximate.
+   */
+  NystroemFeatures(const size_t rank = 100,
+                   const KernelType& kernel = KernelType());
+
+  /**
+   * Select the landmarks from the given dataset and compute the projection
+   * of the kernel evaluations.  The dataset must have at least `rank` points.
+   *
+   * @param data Dataset to select the landmarks from.
+   */
+  void Train(const arma::mat& data);
+
+  /**
+   * Map the given points to the feature space.  The output has Rank() rows and
+   * one column per point, and is computed in parallel over blocks of points.
+   *
+   * @param data Points to transform.
+   * @param features Matrix to store the transformed points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& features) const;
+
+  //! Get the rank of the approximation.
+  size_t Rank() const { return rank; }
+  //! Modify the rank of the approximation (Train() has to be called again).
+  size_t& Rank() { return rank; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel (Train() has to be called again).
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the landmarks, one per column.
+  const arma::mat& Landmarks() const { return landmarks; }
+  //! Get the projection S^{-1/2} U^T of the kernel evaluations.
+  const arma::mat& Projection() const { return projection; }
+
+  //! Serialize the feature map.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Store the landmarks returned by a policy that selects centroids.
+  void SetLandmarks(const arma::mat& data, const arma::mat* selectedData);
+
+  //! Store the landmarks returned by a policy that selects points.
+  void SetLandmarks(const arma::mat& data,
+                    const arma::Col<size_t>& selectedPoints);
+
+  //! Compute the kernel evaluations between the landmarks and the given
+  //! points [begin, end].
+  void KernelColumns(const arma::mat& data,
+                     const size_t begin,
+                     const size_t end,
+                     arma::mat& columns) const;
+
+  //! Rank of the approximation.
+  size_t rank;
+  //! Kernel to approximate.
+  KernelType kernel;
+  //! Landmarks, one per column.
+  arma::mat landmarks;
+  //! Projection of the kernel evaluations.
+  arma::mat projection;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "nystroem_features_impl.hpp"
+
+#endif
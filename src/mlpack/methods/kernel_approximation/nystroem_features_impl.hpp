@@ -0,0 +1,147 @@
+/**
+ * @file methods/kernel_approximation/nystroem_features_impl.hpp
+ *
+ * Implementation of NystroemFeatures.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_NYSTROEM_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_NYSTROEM_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nystroem_features.hpp"
+
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/util/size_checks.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType, typename PointSelectionPolicy>
+NystroemFeatures<KernelType, PointSelectionPolicy>::NystroemFeatures(
+    const size_t rank,
+    const KernelType& kernel) :
+    rank(rank),
+    kernel(kernel)
+{
+  if (rank == 0)
+  {
+    throw std::invalid_argument("NystroemFeatures::NystroemFeatures(): rank "
+        "must be greater than 0!");
+  }
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::Train(
+    const arma::mat& data)
+{
+  if (data.n_cols < rank)
+  {
+    std::ostringstream oss;
+    oss << "NystroemFeatures::Train(): dataset has " << data.n_cols
+        << " points, but at least " << rank << " are needed!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SetLandmarks(data, PointSelectionPolicy::Select(data, rank));
+
+  arma::mat miniKernel;
+  KernelColumns(landmarks, 0, rank - 1, miniKernel);
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  if (!arma::eig_sym(eigval, eigvec, arma::symmatu(miniKernel)))
+  {
+    throw std::runtime_error("NystroemFeatures::Train(): eigendecomposition "
+        "of the landmark kernel matrix failed!");
+  }
+
+  // Directions in which the landmark kernel matrix is (numerically) singular
+  // are dropped, as in NystroemMethod.
+  arma::vec scales(rank, arma::fill::zeros);
+  for (size_t i = 0; i < rank; ++i)
+    if (eigval[i] > 1e-20)
+      scales[i] = 1.0 / std::sqrt(eigval[i]);
+
+  projection = arma::diagmat(scales) * eigvec.t();
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::Transform(
+    const arma::mat& data,
+    arma::mat& features) const
+{
+  if (landmarks.n_cols == 0)
+  {
+    throw std::runtime_error("NystroemFeatures::Transform(): the feature map "
+        "must be trained before transforming points!");
+  }
+
+  util::CheckSameDimensionality(data, landmarks,
+      "NystroemFeatures::Transform()");
+
+  features.set_size(rank, data.n_cols);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+
+    arma::mat columns;
+    KernelColumns(data, begin, end, columns);
+    features.cols(begin, end) = projection * columns;
+  }
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+template<typename Archive>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(rank));
+  ar(CEREAL_NVP(kernel));
+  ar(CEREAL_NVP(landmarks));
+  ar(CEREAL_NVP(projection));
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::SetLandmarks(
+    const arma::mat& /* data */,
+    const arma::mat* selectedData)
+{
+  landmarks = *selectedData;
+  delete selectedData;
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::SetLandmarks(
+    const arma::mat& data,
+    const arma::Col<size_t>& selectedPoints)
+{
+  landmarks = data.cols(arma::conv_to<arma::uvec>::from(selectedPoints));
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemFeatures<KernelType, PointSelectionPolicy>::KernelColumns(
+    const arma::mat& data,
+    const size_t begin,
+    const size_t end,
+    arma::mat& columns) const
+{
+  // Each caller may run in its own thread, so the kernel is copied.
+  KernelType localKernel(kernel);
+  const arma::mat block = data.cols(begin, end);
+  KernelMatrix(localKernel, landmarks, block, columns);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file methods/kernel_approximation/random_fourier_features.hpp
+ *
+ * An explicit feature map whose inner products approximate a shift-invariant
+ * kernel, with random Fourier features.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "fourier_frequencies.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * RandomFourierFeatures maps points to a space of numFeatures dimensions in
+ * which inner products approximate a shift-invariant kernel, as described in
+ * the following paper:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random Features for Large-Scale Kernel Machines},
+ *   author={Rahimi, A. and Recht, B.},
+ *   booktitle={Advances in Neural Information Processing Systems 20
+ *       (NIPS 2007)},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * The feature map is z(x) = sqrt(2 / D) cos(W^T x + b), where the D columns of
+ * W are drawn from the spectral distribution of the kernel (see
+ * FourierFrequencies) and b is uniform in [0, 2 pi).  The expected value of
+ * z(x)^T z(y) is k(x, y), and the approximation error decreases as
+ * O(1 / sqrt(D)).  Since the map is explicit, the transformed points can be
+ * given to any linear model, such as LinearSVM or LogisticRegression (see
+ * KernelApproximationClassifier).
+ *
+ * @tparam KernelType Shift-invariant kernel to approximate; GaussianKernel and
+ *     LaplacianKernel are supported.
+ */
+template<typename KernelType>
+class RandomFourierFeatures
+{
+ public:
+  /**
+   * Create the feature map.  Train() must be called before Transform().
+   *
+   * @param numFeatures Number of random features.
+   * @param kernel Kernel to approximate.
+   */
+  RandomFourierFeatures(const size_t numFeatures = 100,
+                        const KernelType& kernel = KernelType());
+
+  /**
+   * Draw the random frequencies and offsets for points of the dimensionality
+   * of the given data.  Only the number of rows of the data is used.
+   *
+   * @param data Dataset the map will be applied to.
+   */
+  void Train(const arma::mat& data);
+
+  /**
+   * Map the given points to the random feature space.  The output has
+   * NumFeatures() rows and one column per point, and is computed in parallel
+   * over blocks of points.
+   *
+   * @param data Points to transform.
+   * @param features Matrix to store the transformed points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& features) const;
+
+  //! Get the number of random features.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of random features (Train() has to be called again).
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel (Train() has to be called again).
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the random frequencies, one per column.
+  const arma::mat& Frequencies() const { return frequencies; }
+  //! Get the random offsets.
+  const arma::vec& Offsets() const { return offsets; }
+
+  //! Serialize the feature map.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Number of random features.
+  size_t numFeatures;
+  //! Kernel to approximate.
+  KernelType kernel;
+  //! Random frequencies, one per column.
+  arma::mat frequencies;
+  //! Random offsets in [0, 2 pi).
+  arma::vec offsets;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "random_fourier_features_impl.hpp"
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file methods/kernel_approximation/random_fourier_features_impl.hpp
+ *
+ * Implementation of RandomFourierFeatures.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_APPROXIMATION_RANDOM_FOURIER_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_APPROXIMATION_RANDOM_FOURIER_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_fourier_features.hpp"
+
+#include <mlpack/core/util/size_checks.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+RandomFourierFeatures<KernelType>::RandomFourierFeatures(
+    const size_t numFeatures,
+    const KernelType& kernel) :
+    numFeatures(numFeatures),
+    kernel(kernel)
+{
+  if (numFeatures == 0)
+  {
+    throw std::invalid_argument("RandomFourierFeatures::RandomFourierFeatures()"
+        ": numFeatures must be greater than 0!");
+  }
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Train(const arma::mat& data)
+{
+  FourierFrequencies<KernelType>::Sample(kernel, data.n_rows, numFeatures,
+      frequencies);
+  offsets = 2.0 * M_PI * arma::randu<arma::vec>(numFeatures);
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Transform(const arma::mat& data,
+                                                  arma::mat& features) const
+{
+  if (frequencies.n_cols == 0)
+  {
+    throw std::runtime_error("RandomFourierFeatures::Transform(): the feature "
+        "map must be trained before transforming points!");
+  }
+
+  util::CheckSameDimensionality(data, frequencies,
+      "RandomFourierFeatures::Transform()");
+
+  features.set_size(frequencies.n_cols, data.n_cols);
+  const double scale = std::sqrt(2.0 / frequencies.n_cols);
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+
+    arma::mat projections = frequencies.t() * data.cols(begin, end);
+    projections.each_col() += offsets;
+    features.cols(begin, end) = scale * arma::cos(projections);
+  }
+}
+
+template<typename KernelType>
+template<typename Archive>
+void RandomFourierFeatures<KernelType>::serialize(Archive& ar,
+                                                  const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numFeatures));
+  ar(CEREAL_NVP(kernel));
+  ar(CEREAL_NVP(frequencies));
+  ar(CEREAL_NVP(offsets));
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KERNEL_PCA_NAIVE_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kpca {
@@ -23,73 +24,131 @@ class NaiveKernelRule
 {
  public:
   /**
-   * Construct the exact kernel matrix.
+   * Construct the exact kernel matrix.  If only a few components are
+   * requested (the rank is small compared to the number of points), the
+   * leading eigenvectors of the kernel matrix are found with a randomized
+   * subspace iteration, and only rank eigenvalues and eigenvectors are
+   * returned; otherwise, the kernel matrix is fully eigendecomposed.
    *
    * @param data Input data points.
    * @param transformedData Matrix to output results into.
    * @param eigval KPCA eigenvalues will be written to this vector.
    * @param eigvec KPCA eigenvectors will be written to this matrix.
-   * @param * (rank) Rank to be used for matrix approximation.
+   * @param rank Number of components to be computed.
    * @param kernel Kernel to be used for computation.
    */
   static void ApplyKernelMatrix(const arma::mat& data,
                                 arma::mat& transformedData,
                                 arma::vec& eigval,
                                 arma::mat& eigvec,
-                                const size_t /* rank */,
+                                const size_t rank,
                                 KernelType kernel = KernelType())
 {
-  // Construct the kernel matrix.
+  // Construct the kernel matrix.  Kernels with a block evaluation compute it
+  // with matrix products; otherwise, only the upper triangular part is
+  // evaluated, since the matrix is symmetric.
   arma::mat kernelMatrix;
-  // Resize the kernel matrix to the right size.
-  kernelMatrix.set_size(data.n_cols, data.n_cols);
-
-  // Note that we only need to calculate the upper triangular part of the
-  // kernel matrix, since it is symmetric. This helps minimize the number of
-  // kernel evaluations.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    for (size_t j = i; j < data.n_cols; ++j)
-    {
-      // Evaluate the kernel on these two points.
-      kernelMatrix(i, j) = kernel.Evaluate(data.unsafe_col(i),
-                                           data.unsafe_col(j));
-    }
-  }
-
-  // Copy to the lower triangular part of the matrix.
-  for (size_t i = 1; i < data.n_cols; ++i)
-    for (size_t j = 0; j < i; ++j)
-      kernelMatrix(i, j) = kernelMatrix(j, i);
+  kernel::KernelMatrix(kernel, data, kernelMatrix);
 
   // For PCA the data has to be centered, even if the data is centered. But it
   // is not guaranteed that the data, when mapped to the kernel space, is also
   // centered. Since we actually never work in the feature space we cannot
   // center the data. So, we perform a "psuedo-centering" using the kernel
-  // matrix.
-  arma::rowvec rowMean = arma::sum(kernelMatrix, 0) / kernelMatrix.n_cols;
-  kernelMatrix.each_col() -= arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
-  kernelMatrix.each_row() -= rowMean;
-  kernelMatrix += arma::sum(rowMean) / kernelMatrix.n_cols;
-
-  // Eigendecompose the centered kernel matrix.
+  // matrix.  Since the kernel matrix is symmetric, the means of its rows and
+  // of its columns are the same, and it is centered in place.
   kernelMatrix = arma::symmatu(kernelMatrix);
-  if (!arma::eig_sym(eigval, eigvec, kernelMatrix))
+  const arma::vec mean = arma::mean(kernelMatrix, 1);
+  const double totalMean = arma::mean(mean);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) kernelMatrix.n_cols; ++j)
   {
-    Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    for (size_t i = 0; i < kernelMatrix.n_rows; ++i)
+      kernelMatrix(i, j) += totalMean - (mean[i] + mean[j]);
   }
 
-  // Swap the eigenvalues since they are ordered backwards (we need largest to
-  // smallest).
-  for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
-    eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+  // Eigendecompose the centered kernel matrix.  The randomized method needs
+  // a few products of the kernel matrix with (rank + 10) vectors, which is
+  // much cheaper than the full eigendecomposition when the rank is small.
+  if (rank > 0 && 4 * (rank + 10) < kernelMatrix.n_cols)
+  {
+    RandomizedEigenvectors(kernelMatrix, rank, eigval, eigvec);
+  }
+  else
+  {
+    if (!arma::eig_sym(eigval, eigvec, kernelMatrix))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
 
-  // Flip the coefficients to produce the same effect.
-  eigvec = arma::fliplr(eigvec);
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+  }
 
   transformedData = eigvec.t() * kernelMatrix;
   transformedData.each_col() /= arma::sqrt(eigval);
 }
+
+ private:
+  /**
+   * Find the rank leading eigenvalues and eigenvectors of the given symmetric
+   * matrix with a randomized subspace iteration: an orthonormal basis of the
+   * product of the matrix (applied three times) with a random matrix spans
+   * approximately the leading eigenvectors, and the eigendecomposition of
+   * the matrix projected on that basis gives them.  For more information,
+   * see:
+   *
+   * @code
+   * @article{halko2011finding,
+   *   title   = {Finding Structure with Randomness: Probabilistic Algorithms
+   *              for Constructing Approximate Matrix Decompositions},
+   *   author  = {Halko, Nathan and Martinsson, Per-Gunnar and Tropp, Joel A.},
+   *   journal = {SIAM Review},
+   *   volume  = {53},
+   *   number  = {2},
+   *   pages   = {217--288},
+   *   year    = {2011}
+   * }
+   * @endcode
+   *
+   * @param matrix Symmetric matrix to eigendecompose.
+   * @param rank Number of eigenvalues and eigenvectors to find.
+   * @param eigval Vector to store the eigenvalues in (largest to smallest).
+   * @param eigvec Matrix to store the eigenvectors in.
+   */
+  static void RandomizedEigenvectors(const arma::mat& matrix,
+                                     const size_t rank,
+                                     arma::vec& eigval,
+                                     arma::mat& eigvec)
+  {
+    const size_t subspaceSize = std::min(rank + 10, (size_t) matrix.n_cols);
+
+    // Orthonormalize after each product, so that the leading eigenvectors
+    // don't swamp the others.
+    arma::mat basis, r;
+    arma::qr_econ(basis, r, matrix * arma::randn(matrix.n_cols,
+        subspaceSize));
+    for (size_t i = 0; i < 2; ++i)
+      arma::qr_econ(basis, r, matrix * basis);
+
+    arma::mat projected = basis.t() * matrix * basis;
+    projected = arma::symmatu(projected);
+    arma::vec projectedEigval;
+    arma::mat projectedEigvec;
+    if (!arma::eig_sym(projectedEigval, projectedEigvec, projected))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
+
+    // The eigenvalues are ordered from smallest to largest.
+    eigval = arma::flipud(projectedEigval.tail(rank));
+    eigvec = basis * arma::fliplr(projectedEigvec.tail_cols(rank));
+  }
 };
 
 } // namespace kpca
@@ -0,0 +1,89 @@
+/**
+ * @file methods/kernel_pca/kernel_rules/random_fourier_method.hpp
+ *
+ * Use random Fourier features to approximate the kernel in kernel PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/kernel_approximation/random_fourier_features.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Kernel rule that maps the data explicitly with RandomFourierFeatures and
+ * performs PCA in the random feature space.  The feature space can be centered
+ * exactly, and only a numFeatures x numFeatures covariance matrix is
+ * decomposed, so the cost is linear in the number of points.  The results
+ * approximate those of NaiveKernelRule.
+ *
+ * @tparam KernelType Shift-invariant kernel (GaussianKernel or
+ *     LaplacianKernel).
+ * @tparam NumFeatures Number of random Fourier features.
+ */
+template<typename KernelType, size_t NumFeatures = 1000>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Apply kernel PCA with random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param * (rank) Rank to be used for matrix approximation.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t /* rank */,
+                                KernelType kernel = KernelType())
+  {
+    kernel::RandomFourierFeatures<KernelType> rff(NumFeatures, kernel);
+    rff.Train(data);
+    arma::mat features;
+    rff.Transform(data, features);
+
+    // Center the data in the feature space.
+    features.each_col() -= arma::mean(features, 1);
+
+    // The nonzero eigenvalues of the centered kernel matrix Z^T Z are those of
+    // Z Z^T, and its eigenvectors are Z^T u / sqrt(lambda).
+    arma::vec covEigval;
+    arma::mat covEigvec;
+    if (!arma::eig_sym(covEigval, covEigvec, features * features.t()))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
+
+    // Keep the components with positive eigenvalues, from largest to
+    // smallest.
+    const arma::uvec order = arma::sort_index(covEigval, "descend");
+    size_t numComponents = 0;
+    while (numComponents < order.n_elem &&
+        covEigval[order[numComponents]] > 1e-10)
+      ++numComponents;
+
+    eigval = covEigval.elem(order.head(numComponents));
+    const arma::mat u = covEigvec.cols(order.head(numComponents));
+
+    transformedData = u.t() * features;
+    eigvec = transformedData.t();
+    eigvec.each_row() /= arma::sqrt(eigval).t();
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * The DistributedKMeans class, which runs k-means clustering on a dataset that
+ * is split across several processes, with k-means|| initialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "naive_kmeans.hpp"
+#include "local_reduction.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class runs k-means clustering on a dataset that is split into shards, one
+ * for each process.  Each process runs a Lloyd step on its own shard, and then
+ * the sums and counts of the points of each cluster are added up over all the
+ * processes, so that every process holds the same centroids after each
+ * iteration.  The communication goes through a reduction backend (see
+ * LocalReduction for its interface), so MPI or any other transport can be used.
+ *
+ * Unless initial centroids are given, they are chosen with k-means||, the
+ * distributed version of k-means++: each process samples candidate centroids
+ * from its shard in a few rounds, and the candidates, weighted by the number of
+ * points closest to them, are then reduced to the final centroids with
+ * k-means++.
+ *
+ * @code
+ * MPIReduction reduction; // A user-defined backend.
+ * arma::mat shard = ...; // The points of this process.
+ * DistributedKMeans<> k;
+ * arma::mat centroids;
+ * k.Cluster(shard, 10, centroids, reduction);
+ * @endcode
+ *
+ * Each Lloyd step is given centroids that were averaged over all the
+ * processes, and not the ones it returned.  So the Lloyd step must not keep
+ * bounds between iterations: NaiveKMeans and PellegMooreKMeans can be used, but
+ * ElkanKMeans, HamerlyKMeans and DualTreeKMeans can't.  A cluster that has no
+ * points on any process keeps its previous centroid.
+ *
+ * For more information on k-means||, see the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType The distance metric to use.
+ * @tparam LloydStepType Implementation of a single Lloyd step on a shard.
+ * @tparam MatType Type of matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the DistributedKMeans object.
+   *
+   * @param maxIterations Maximum number of Lloyd iterations (0 means no
+   *     limit).
+   * @param rounds Number of sampling rounds of k-means||.
+   * @param oversampling Expected number of candidates sampled in each round of
+   *     k-means||, as a multiple of the number of clusters.
+   * @param metric Optional MetricType object; for when the metric has state
+   *     it needs to store.
+   */
+  DistributedKMeans(const size_t maxIterations = 1000,
+                    const size_t rounds = 5,
+                    const double oversampling = 2.0,
+                    const MetricType metric = MetricType());
+
+  /**
+   * Cluster the points of all the processes.  This has to be called by every
+   * process, with its own shard, and gives the same centroids to every
+   * process.  If initialGuess is true, the centroids matrix holds the initial
+   * centroids (which must be the same on every process).
+   *
+   * @param shard Points held by this process.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix to store the centroids in.
+   * @param reduction Reduction backend.
+   * @param initialGuess If true, the centroids matrix holds the initial
+   *     centroids.
+   */
+  template<typename ReductionType>
+  void Cluster(const MatType& shard,
+               const size_t clusters,
+               arma::mat& centroids,
+               ReductionType& reduction,
+               const bool initialGuess = false);
+
+  /**
+   * Choose initial centroids with k-means||.  This has to be called by every
+   * process, with its own shard, and gives the same centroids to every
+   * process.
+   *
+   * @param shard Points held by this process.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix to store the centroids in.
+   * @param reduction Reduction backend.
+   */
+  template<typename ReductionType>
+  void Initialize(const MatType& shard,
+                  const size_t clusters,
+                  arma::mat& centroids,
+                  ReductionType& reduction);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of sampling rounds of k-means||.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds of k-means||.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the oversampling factor of k-means||.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor of k-means||.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  /**
+   * Update the distance of each point of the shard to its closest candidate,
+   * with the candidates from the given index on.
+   */
+  void UpdateDistances(const MatType& shard,
+                       const arma::mat& candidates,
+                       const size_t firstCandidate,
+                       arma::vec& distances,
+                       arma::Row<size_t>& closest);
+
+  /**
+   * Choose the given number of centroids from the weighted candidates with
+   * k-means++.
+   */
+  void WeightedKMeansPlusPlus(const arma::mat& candidates,
+                              const arma::vec& weights,
+                              const size_t clusters,
+                              arma::mat& centroids);
+
+  //! Maximum number of Lloyd iterations.
+  size_t maxIterations;
+  //! Number of sampling rounds of k-means||.
+  size_t rounds;
+  //! Oversampling factor of k-means||.
+  double oversampling;
+  //! Instantiated distance metric.
+  MetricType metric;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,286 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of the DistributedKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<MetricType, LloydStepType, MatType>::DistributedKMeans(
+    const size_t maxIterations,
+    const size_t rounds,
+    const double oversampling,
+    const MetricType metric) :
+    maxIterations(maxIterations),
+    rounds(rounds),
+    oversampling(oversampling),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+template<typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename ReductionType>
+void DistributedKMeans<MetricType, LloydStepType, MatType>::Cluster(
+    const MatType& shard,
+    const size_t clusters,
+    arma::mat& centroids,
+    ReductionType& reduction,
+    const bool initialGuess)
+{
+  if (initialGuess)
+  {
+    if (centroids.n_cols != clusters || centroids.n_rows != shard.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "DistributedKMeans::Cluster(): the initial centroids are "
+          << centroids.n_rows << "x" << centroids.n_cols << ", but should be "
+          << shard.n_rows << "x" << clusters << "!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+  else
+  {
+    Initialize(shard, clusters, centroids, reduction);
+  }
+
+  const size_t dims = shard.n_rows;
+  LloydStepType<MetricType, MatType> lloydStep(shard, metric);
+  arma::mat localCentroids;
+  arma::Col<size_t> localCounts;
+
+  // The sums of the points of each cluster, with the counts in the last row,
+  // so that a single reduction is needed for each iteration.
+  arma::mat sums(dims + 1, clusters);
+
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    lloydStep.Iterate(centroids, localCentroids, localCounts);
+
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      if (localCounts[c] > 0)
+        sums(arma::span(0, dims - 1), c) = localCentroids.col(c) *
+            (double) localCounts[c];
+      else
+        sums.col(c).zeros();
+
+      sums(dims, c) = (double) localCounts[c];
+    }
+
+    reduction.Sum(sums);
+
+    // Every process computes the same new centroids.
+    cNorm = 0.0;
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      if (sums(dims, c) == 0)
+        continue; // The cluster keeps its previous centroid.
+
+      const arma::vec newCentroid = sums(arma::span(0, dims - 1), c) /
+          sums(dims, c);
+      cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroid), 2.0);
+      centroids.col(c) = newCentroid;
+    }
+    cNorm = std::sqrt(cNorm);
+
+    ++iteration;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << ".\n";
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  Log::Info << "DistributedKMeans::Cluster(): finished after " << iteration
+      << " iterations; " << lloydStep.DistanceCalculations() << " distance "
+      << "calculations on this process." << std::endl;
+}
+
+template<typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+template<typename ReductionType>
+void DistributedKMeans<MetricType, LloydStepType, MatType>::Initialize(
+    const MatType& shard,
+    const size_t clusters,
+    arma::mat& centroids,
+    ReductionType& reduction)
+{
+  // Find the number of points of each process.
+  arma::mat sizes(reduction.Size(), 1, arma::fill::zeros);
+  sizes[reduction.Rank()] = shard.n_cols;
+  reduction.Sum(sizes);
+
+  const size_t totalPoints = (size_t) arma::accu(sizes);
+  if (totalPoints < clusters)
+  {
+    std::ostringstream oss;
+    oss << "DistributedKMeans::Initialize(): " << clusters << " clusters "
+        << "were requested, but there are only " << totalPoints << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The first candidate is a point chosen uniformly at random among the points
+  // of every process.
+  arma::mat choice(1, 1);
+  if (reduction.Rank() == 0)
+  {
+    choice[0] = (double) std::min((size_t) (math::Random() * totalPoints),
+        totalPoints - 1);
+  }
+  reduction.Broadcast(choice, 0);
+
+  size_t index = (size_t) choice[0];
+  size_t owner = 0;
+  while (index >= (size_t) sizes[owner])
+    index -= (size_t) sizes[owner++];
+
+  arma::mat candidates(shard.n_rows, 1, arma::fill::zeros);
+  if (reduction.Rank() == owner)
+    candidates.col(0) = arma::vec(shard.col(index));
+  reduction.Sum(candidates);
+
+  // The squared distance from each point of this process to its closest
+  // candidate.
+  arma::vec distances(shard.n_cols);
+  distances.fill(DBL_MAX);
+  arma::Row<size_t> closest(shard.n_cols);
+  UpdateDistances(shard, candidates, 0, distances, closest);
+
+  // In each round, each point is sampled with a probability proportional to
+  // its squared distance to the candidates.
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    arma::mat cost(1, 1);
+    cost[0] = arma::accu(distances);
+    reduction.Sum(cost);
+    if (cost[0] == 0.0)
+      break; // Every point is at a candidate.
+
+    std::vector<size_t> sampled;
+    for (size_t i = 0; i < shard.n_cols; ++i)
+      if (math::Random() * cost[0] < oversampling * clusters * distances[i])
+        sampled.push_back(i);
+
+    arma::mat localCandidates(shard.n_rows, sampled.size());
+    for (size_t i = 0; i < sampled.size(); ++i)
+      localCandidates.col(i) = arma::vec(shard.col(sampled[i]));
+
+    arma::mat newCandidates;
+    reduction.Gather(localCandidates, newCandidates);
+
+    const size_t firstCandidate = candidates.n_cols;
+    candidates = arma::join_rows(candidates, newCandidates);
+    UpdateDistances(shard, candidates, firstCandidate, distances, closest);
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::mat weights(candidates.n_cols, 1, arma::fill::zeros);
+  for (size_t i = 0; i < shard.n_cols; ++i)
+    weights[closest[i]] += 1.0;
+  reduction.Sum(weights);
+
+  Log::Info << "DistributedKMeans::Initialize(): reducing "
+      << candidates.n_cols << " candidates to " << clusters << " centroids."
+      << std::endl;
+
+  // The random choices differ between the processes, so the centroids are
+  // chosen by the first process only.
+  if (reduction.Rank() == 0)
+    WeightedKMeansPlusPlus(candidates, weights.col(0), clusters, centroids);
+  reduction.Broadcast(centroids, 0);
+}
+
+template<typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<MetricType, LloydStepType, MatType>::UpdateDistances(
+    const MatType& shard,
+    const arma::mat& candidates,
+    const size_t firstCandidate,
+    arma::vec& distances,
+    arma::Row<size_t>& closest)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) shard.n_cols; ++i)
+  {
+    for (size_t j = firstCandidate; j < candidates.n_cols; ++j)
+    {
+      const double distance = std::pow(metric.Evaluate(shard.col(i),
+          candidates.col(j)), 2.0);
+      if (distance < distances[i])
+      {
+        distances[i] = distance;
+        closest[i] = j;
+      }
+    }
+  }
+}
+
+template<typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<MetricType, LloydStepType, MatType>::
+WeightedKMeansPlusPlus(const arma::mat& candidates,
+                       const arma::vec& weights,
+                       const size_t clusters,
+                       arma::mat& centroids)
+{
+  centroids.set_size(candidates.n_rows, clusters);
+
+  // If there are not enough candidates (this can only happen if many points
+  // are equal), the candidates are repeated; the extra clusters then stay
+  // empty.
+  if (candidates.n_cols <= clusters)
+  {
+    for (size_t c = 0; c < clusters; ++c)
+      centroids.col(c) = candidates.col(c % candidates.n_cols);
+    return;
+  }
+
+  arma::vec minDistances(candidates.n_cols);
+  minDistances.fill(DBL_MAX);
+  arma::vec probabilities(weights);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    // Sample the next centroid with a probability proportional to the weight
+    // of each candidate times its squared distance to the chosen centroids.
+    const double total = arma::accu(probabilities);
+    size_t next = 0;
+    if (total > 0.0)
+    {
+      double target = math::Random() * total;
+      while (next < candidates.n_cols - 1 && target >= probabilities[next])
+        target -= probabilities[next++];
+    }
+
+    centroids.col(c) = candidates.col(next);
+    for (size_t j = 0; j < candidates.n_cols; ++j)
+    {
+      minDistances[j] = std::min(minDistances[j], std::pow(metric.Evaluate(
+          candidates.col(j), centroids.col(c)), 2.0));
+    }
+    probabilities = weights % minDistances;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
 
@@ -78,6 +79,10 @@ class DualTreeKMeans
   //! Modify the number of distance calculations.
   size_t& DistanceCalculations() { return distanceCalculations; }
 
+  //! Get the traversal statistics of the last iteration (of both the
+  //! nearest neighbor search of the centroids and the assignment traversal).
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
  private:
   //! The original dataset reference.
   const MatType& datasetOrig; // Maybe not necessary.
@@ -90,6 +95,8 @@ class DualTreeKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+  //! Traversal statistics of the last iteration.
+  tree::TraversalStatistics statistics;
   //! Track iteration number.
   size_t iteration;
 
@@ -110,6 +110,8 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
       NNSTreeType> nns(std::move(*centroidTree));
 
+  statistics.Reset();
+
   // Reset information in the tree, if we need to.
   if (iteration > 0)
   {
@@ -123,6 +125,7 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::Mat<size_t> closestClusters; // We don't actually care about these.
     nns.Search(1, closestClusters, *interclusterDistancesTemp);
     distanceCalculations += nns.BaseCases() + nns.Scores();
+    statistics += nns.Statistics();
 
     // We need to do the unmapping ourselves, if the tree does mapping.
     if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -166,6 +169,8 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   tree->Stat().Pruned() = 0;
   traverser.Traverse(*tree, nns.ReferenceTree());
   distanceCalculations += rules.BaseCases() + rules.Scores();
+  statistics.Add(rules, traverser);
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   Timer::Start("tree_mod");
   DecoalesceTree(*tree);
@@ -12,9 +12,21 @@
 #ifndef MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include "lloyd_helper.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
+/**
+ * Elkan's algorithm for a single Lloyd iteration, which uses the triangle
+ * inequality to avoid most of the distance calculations.  As with NaiveKMeans,
+ * the distances are computed with LloydHelper, so sparse points are only
+ * accessed through their nonzero elements for the Euclidean and spherical
+ * distances.
+ *
+ * @tparam MetricType Type of metric; it must satisfy the triangle inequality.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
 template<typename MetricType, typename MatType>
 class ElkanKMeans
 {
@@ -43,6 +55,8 @@ class ElkanKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The distance computations and centroid updates.
+  LloydHelper<MetricType, MatType> helper;
 
   //! Holds intra-cluster distances.
   arma::mat clusterDistances;
@@ -0,0 +1,215 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * This file implements the k-means|| (scalable k-means++) initialization
+ * strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class implements the k-means|| initialization, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, B. and Moseley, B. and Vattani, A. and Kumar, R. and
+ *       Vassilvitskii, S.},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * Instead of sampling one centroid per pass over the data like k-means++, each
+ * of a few rounds samples every point independently with probability
+ * proportional to its squared distance to the closest candidate, so that about
+ * oversamplingFactor * k candidates are added per round.  Each candidate is
+ * then weighted by the number of points closest to it, and k centroids are
+ * chosen from the candidates with weighted k-means++.  This needs only a few
+ * passes over the data, each of which is parallel when OpenMP is available.
+ *
+ * In accordance with mlpack's InitialPartitionPolicy template type, we only
+ * need to implement a constructor and a method to compute the initial
+ * centroids.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the k-means|| initialization with the given parameters.
+   *
+   * @param oversamplingFactor Expected number of candidates added in each
+   *     round, as a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds.
+   */
+  KMeansParallelInitialization(const double oversamplingFactor = 2.0,
+                               const size_t rounds = 5) :
+      oversamplingFactor(oversamplingFactor),
+      rounds(rounds)
+  {
+    if (oversamplingFactor <= 0.0)
+    {
+      throw std::invalid_argument("KMeansParallelInitialization::"
+          "KMeansParallelInitialization(): oversamplingFactor must be "
+          "positive!");
+    }
+  }
+
+  /**
+   * Initialize the centroids matrix with k-means||.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids)
+  {
+    centroids.set_size(data.n_rows, clusters);
+    if (clusters == 0)
+      return;
+
+    // The squared distance of each point to its closest candidate, and the
+    // index of that candidate.
+    arma::vec minDistances(data.n_cols);
+    minDistances.fill(std::numeric_limits<double>::max());
+    arma::Col<size_t> closest(data.n_cols, arma::fill::zeros);
+
+    std::vector<size_t> candidates;
+    candidates.push_back(math::RandInt(0, data.n_cols));
+    UpdateClosest(data, candidates, 0, minDistances, closest);
+
+    const double expectedSamples = oversamplingFactor * clusters;
+    for (size_t r = 0; r < rounds; ++r)
+    {
+      const double cost = arma::accu(minDistances);
+      if (!(cost > 0.0))
+        break;
+
+      // The random numbers are drawn in order, so that the candidates only
+      // depend on the random seed.
+      const arma::vec samples = arma::randu<arma::vec>(data.n_cols);
+      const size_t oldSize = candidates.size();
+      for (size_t p = 0; p < data.n_cols; ++p)
+      {
+        if (samples[p] * cost < expectedSamples * minDistances[p])
+          candidates.push_back(p);
+      }
+
+      UpdateClosest(data, candidates, oldSize, minDistances, closest);
+    }
+
+    // With too few candidates, the remaining centroids are sampled from the
+    // whole dataset like k-means++ does.
+    if (candidates.size() <= clusters)
+    {
+      while (candidates.size() < clusters)
+      {
+        candidates.push_back(
+            KMeansPlusPlusInitialization::SampleIndex(minDistances));
+        UpdateClosest(data, candidates, candidates.size() - 1, minDistances,
+            closest);
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        centroids.col(i) = data.col(candidates[i]);
+      return;
+    }
+
+    // Weight each candidate by the number of points closest to it.
+    arma::vec weights(candidates.size(), arma::fill::zeros);
+    for (size_t p = 0; p < data.n_cols; ++p)
+      weights[closest[p]] += 1.0;
+
+    arma::mat candidatePoints(data.n_rows, candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+      candidatePoints.col(i) = data.col(candidates[i]);
+
+    // Choose the centroids from the candidates with weighted k-means++.
+    size_t chosen = KMeansPlusPlusInitialization::SampleIndex(weights);
+    centroids.col(0) = candidatePoints.col(chosen);
+    arma::vec candidateDistances(candidates.size());
+    candidateDistances.fill(std::numeric_limits<double>::max());
+    for (size_t i = 1; i < clusters; ++i)
+    {
+      KMeansPlusPlusInitialization::UpdateMinDistances(candidatePoints,
+          candidatePoints.col(chosen), candidateDistances);
+      chosen = KMeansPlusPlusInitialization::SampleIndex(weights %
+          candidateDistances);
+      centroids.col(i) = candidatePoints.col(chosen);
+    }
+  }
+
+  //! Get the oversampling factor.
+  double OversamplingFactor() const { return oversamplingFactor; }
+  //! Modify the oversampling factor.
+  double& OversamplingFactor() { return oversamplingFactor; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+ private:
+  /**
+   * Update the closest candidate of each point with the candidates starting
+   * at the given index.
+   */
+  template<typename MatType>
+  static void UpdateClosest(const MatType& data,
+                            const std::vector<size_t>& candidates,
+                            const size_t begin,
+                            arma::vec& minDistances,
+                            arma::Col<size_t>& closest)
+  {
+    if (begin == candidates.size())
+      return;
+
+    // Copy the new candidates, so that each point reads them contiguously.
+    arma::mat newCandidates(data.n_rows, candidates.size() - begin);
+    for (size_t c = begin; c < candidates.size(); ++c)
+      newCandidates.col(c - begin) = data.col(candidates[c]);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t p = 0; p < (omp_size_t) data.n_cols; ++p)
+    {
+      for (size_t c = 0; c < newCandidates.n_cols; ++c)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(p), newCandidates.col(c));
+        if (distance < minDistances[p])
+        {
+          minDistances[p] = distance;
+          closest[p] = begin + c;
+        }
+      }
+    }
+  }
+
+  //! The expected number of candidates per round, as a multiple of k.
+  double oversamplingFactor;
+  //! The number of sampling rounds.
+  size_t rounds;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -8,6 +8,8 @@
 #define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 /**
  * This class implements the k-means++ initialization, as described in the
@@ -36,8 +38,9 @@ class KMeansPlusPlusInitialization
   KMeansPlusPlusInitialization() { }
 
   /**
-   * Initialize the centroids matrix by randomly sampling points from the data
-   * matrix.
+   * Initialize the centroids matrix by sampling points from the data matrix,
+   * each with probability proportional to its squared distance to the closest
+   * centroid sampled so far.
    *
    * @param data Dataset.
    * @param clusters Number of clusters.
@@ -49,54 +52,102 @@ class KMeansPlusPlusInitialization
                              arma::mat& centroids)
   {
     centroids.set_size(data.n_rows, clusters);
+    if (clusters == 0)
+      return;
 
     // We'll sample our first point fully randomly.
     size_t firstPoint = mlpack::math::RandInt(0, data.n_cols);
     centroids.col(0) = data.col(firstPoint);
 
-    // Utility variable.
-    arma::vec distribution(data.n_cols);
+    // The squared distance between each point and its closest already-chosen
+    // centroid.  Only the newest centroid can change it, so each new centroid
+    // costs O(n) distance evaluations instead of O(n * i).
+    arma::vec minDistances(data.n_cols);
+    minDistances.fill(std::numeric_limits<double>::max());
 
     // Now, sample other points...
     for (size_t i = 1; i < clusters; ++i)
     {
-      // We must compute the CDF for sampling... this depends on the computation
-      // of the minimum distance between each point and its closest
-      // already-chosen centroid.
-      //
-      // This computation is ripe for speedup with trees!  I am not sure exactly
-      // how much we would need to approximate, but I think it could be done
-      // without breaking the O(log k)-competitive guarantee (I think).
-      for (size_t p = 0; p < data.n_cols; ++p)
-      {
-        double minDistance = std::numeric_limits<double>::max();
-        for (size_t j = 0; j < i; ++j)
-        {
-          const double distance =
-              mlpack::metric::SquaredEuclideanDistance::Evaluate(data.col(p),
-              centroids.col(j));
-          minDistance = std::min(distance, minDistance);
-        }
+      UpdateMinDistances(data, centroids.col(i - 1), minDistances);
+      centroids.col(i) = data.col(SampleIndex(minDistances));
+    }
+  }
 
-        distribution[p] = minDistance;
-      }
+  /**
+   * Update the squared distances between each point and its closest centroid
+   * with the given new centroid.  The points are processed in parallel when
+   * OpenMP is available.
+   *
+   * @param data Dataset.
+   * @param centroid New centroid.
+   * @param minDistances Squared distance of each point to its closest
+   *     centroid.
+   */
+  template<typename MatType, typename VecType>
+  inline static void UpdateMinDistances(const MatType& data,
+                                        const VecType& centroid,
+                                        arma::vec& minDistances)
+  {
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t p = 0; p < (omp_size_t) data.n_cols; ++p)
+    {
+      const double distance =
+          mlpack::metric::SquaredEuclideanDistance::Evaluate(data.col(p),
+          centroid);
+      if (distance < minDistances[p])
+        minDistances[p] = distance;
+    }
+  }
 
-      // Next normalize the distribution (actually technically we could avoid
-      // this).
-      distribution /= arma::accu(distribution);
+  /**
+   * Sample an index with probability proportional to the given non-negative
+   * weights, or uniformly if all the weights are zero.  The sums of blocks of
+   * weights are computed in parallel, so only one block has to be scanned.
+   *
+   * @param weights Weight of each index.
+   * @return The sampled index.
+   */
+  inline static size_t SampleIndex(const arma::vec& weights)
+  {
+    const size_t blockSize = 1024;
+    const size_t numBlocks = (weights.n_elem + blockSize - 1) / blockSize;
+
+    arma::vec blockSums(numBlocks);
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) weights.n_elem);
+      blockSums[b] = arma::accu(weights.subvec(begin, end - 1));
+    }
+
+    const double total = arma::accu(blockSums);
+    const double sampleValue = mlpack::math::Random() * total;
+    if (!(total > 0.0))
+      return mlpack::math::RandInt(0, weights.n_elem);
 
-      // Turn it into a CDF for convenience...
-      for (size_t j = 1; j < distribution.n_elem; ++j)
-        distribution[j] += distribution[j - 1];
+    // Find the block of the sampled value, and then the index in the block.
+    double cumulative = 0.0;
+    size_t block = 0;
+    while (block + 1 < numBlocks && cumulative + blockSums[block] < sampleValue)
+      cumulative += blockSums[block++];
 
-      // Sample a point...
-      const double sampleValue = mlpack::math::Random();
-      const double* elem = std::lower_bound(distribution.begin(),
-          distribution.end(), sampleValue);
-      const size_t position = (size_t)
-          (elem - distribution.begin()) / sizeof(double);
-      centroids.col(i) = data.col(position);
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) weights.n_elem);
+    size_t lastPositive = begin;
+    for (size_t p = begin; p < end; ++p)
+    {
+      if (weights[p] <= 0.0)
+        continue;
+
+      cumulative += weights[p];
+      lastPositive = p;
+      if (cumulative >= sampleValue)
+        return p;
     }
+
+    // The sums may differ slightly because of rounding.
+    return lastPositive;
   }
 };
 
@@ -0,0 +1,283 @@
+/**
+ * @file methods/kmeans/lloyd_helper.hpp
+ *
+ * Point-centroid distances and centroid accumulation for the Lloyd step types,
+ * with specializations that work directly on the nonzero elements of sparse
+ * points and that implement spherical k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LLOYD_HELPER_HPP
+#define MLPACK_METHODS_KMEANS_LLOYD_HELPER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/spherical_distance.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+//! Compute the dot product of the i'th point of a dense dataset with the j'th
+//! centroid.
+template<typename eT>
+inline double PointDot(const arma::Mat<eT>& dataset,
+                       const size_t i,
+                       const arma::mat& centroids,
+                       const size_t j)
+{
+  const eT* point = dataset.colptr(i);
+  const double* centroid = centroids.colptr(j);
+  double dot = 0.0;
+  for (size_t r = 0; r < dataset.n_rows; ++r)
+    dot += point[r] * centroid[r];
+  return dot;
+}
+
+//! Compute the dot product of the i'th point of a sparse dataset with the j'th
+//! centroid, using only the nonzero elements of the point.
+template<typename eT>
+inline double PointDot(const arma::SpMat<eT>& dataset,
+                       const size_t i,
+                       const arma::mat& centroids,
+                       const size_t j)
+{
+  const double* centroid = centroids.colptr(j);
+  double dot = 0.0;
+  for (typename arma::SpMat<eT>::const_iterator it = dataset.begin_col(i);
+       it != dataset.end_col(i); ++it)
+    dot += (*it) * centroid[it.row()];
+  return dot;
+}
+
+//! Compute the squared norm of the i'th point of a dense dataset.
+template<typename eT>
+inline double PointSquaredNorm(const arma::Mat<eT>& dataset, const size_t i)
+{
+  const eT* point = dataset.colptr(i);
+  double norm = 0.0;
+  for (size_t r = 0; r < dataset.n_rows; ++r)
+    norm += point[r] * point[r];
+  return norm;
+}
+
+//! Compute the squared norm of the i'th point of a sparse dataset.
+template<typename eT>
+inline double PointSquaredNorm(const arma::SpMat<eT>& dataset, const size_t i)
+{
+  double norm = 0.0;
+  for (typename arma::SpMat<eT>::const_iterator it = dataset.begin_col(i);
+       it != dataset.end_col(i); ++it)
+    norm += (*it) * (*it);
+  return norm;
+}
+
+//! Add the i'th point of a dense dataset, times the given scale, to the c'th
+//! column of sums.
+template<typename eT>
+inline void AddPoint(const arma::Mat<eT>& dataset,
+                     const size_t i,
+                     const double scale,
+                     arma::mat& sums,
+                     const size_t c)
+{
+  const eT* point = dataset.colptr(i);
+  double* sum = sums.colptr(c);
+  for (size_t r = 0; r < dataset.n_rows; ++r)
+    sum[r] += scale * point[r];
+}
+
+//! Add the i'th point of a sparse dataset, times the given scale, to the c'th
+//! column of sums, without densifying the point.
+template<typename eT>
+inline void AddPoint(const arma::SpMat<eT>& dataset,
+                     const size_t i,
+                     const double scale,
+                     arma::mat& sums,
+                     const size_t c)
+{
+  double* sum = sums.colptr(c);
+  for (typename arma::SpMat<eT>::const_iterator it = dataset.begin_col(i);
+       it != dataset.end_col(i); ++it)
+    sum[it.row()] += scale * (*it);
+}
+
+/**
+ * The LloydHelper class computes the distances between the points and the
+ * centroids for NaiveKMeans and ElkanKMeans, and accumulates the new
+ * centroids.  Before the distances to a set of centroids are computed,
+ * Prepare() must be called with these centroids.  Evaluate() may be called by
+ * several threads at once.
+ *
+ * By default the metric is evaluated on each pair and the new centroids are
+ * the means of their points.  This is specialized for the Euclidean distance
+ * on sparse data, and for the spherical distance.
+ *
+ * @tparam MetricType The metric of the clustering.
+ * @tparam MatType The type of the dataset.
+ */
+template<typename MetricType, typename MatType>
+class LloydHelper
+{
+ public:
+  //! Create the helper for the given dataset and metric.
+  LloydHelper(const MatType& dataset, MetricType& metric) :
+      dataset(dataset), metric(metric) { }
+
+  //! Prepare the distance computations to the given centroids.
+  void Prepare(const arma::mat& /* centroids */) { }
+
+  //! Compute the distance between the i'th point and the j'th centroid.
+  double Evaluate(const size_t i, const arma::mat& centroids, const size_t j)
+  {
+    return metric.Evaluate(dataset.col(i), centroids.unsafe_col(j));
+  }
+
+  //! Add the i'th point to the c'th column of sums.
+  void Add(const size_t i, arma::mat& sums, const size_t c) const
+  {
+    AddPoint(dataset, i, 1.0, sums, c);
+  }
+
+  //! Turn the sums of the points of each cluster into the new centroids.
+  void Finalize(arma::mat& sums, const arma::Col<size_t>& counts) const
+  {
+    for (size_t c = 0; c < sums.n_cols; ++c)
+      if (counts[c] != 0)
+        sums.col(c) /= counts[c];
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+};
+
+/**
+ * The helper for the (squared) Euclidean distance on sparse data.  The squared
+ * norms of the points are computed once, so that the squared distance to a
+ * centroid only needs its squared norm and one dot product over the nonzero
+ * elements of the point.
+ */
+template<bool TakeRoot, typename eT>
+class LloydHelper<metric::LMetric<2, TakeRoot>, arma::SpMat<eT>>
+{
+ public:
+  //! Create the helper and compute the squared norms of the points.
+  LloydHelper(const arma::SpMat<eT>& dataset,
+              metric::LMetric<2, TakeRoot>& /* metric */) :
+      dataset(dataset),
+      pointNorms(dataset.n_cols)
+  {
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      pointNorms[i] = PointSquaredNorm(dataset, i);
+  }
+
+  //! Compute the squared norms of the given centroids.
+  void Prepare(const arma::mat& centroids)
+  {
+    centroidNorms = arma::sum(arma::square(centroids), 0).t();
+  }
+
+  //! Compute the distance between the i'th point and the j'th centroid.
+  double Evaluate(const size_t i, const arma::mat& centroids, const size_t j)
+  {
+    // Rounding can make the distance of close points slightly negative.
+    const double distance = std::max(0.0, pointNorms[i] + centroidNorms[j] -
+        2.0 * PointDot(dataset, i, centroids, j));
+    return TakeRoot ? std::sqrt(distance) : distance;
+  }
+
+  //! Add the i'th point to the c'th column of sums.
+  void Add(const size_t i, arma::mat& sums, const size_t c) const
+  {
+    AddPoint(dataset, i, 1.0, sums, c);
+  }
+
+  //! Turn the sums of the points of each cluster into the new centroids.
+  void Finalize(arma::mat& sums, const arma::Col<size_t>& counts) const
+  {
+    for (size_t c = 0; c < sums.n_cols; ++c)
+      if (counts[c] != 0)
+        sums.col(c) /= counts[c];
+  }
+
+ private:
+  //! The dataset.
+  const arma::SpMat<eT>& dataset;
+  //! The squared norms of the points.
+  arma::vec pointNorms;
+  //! The squared norms of the current centroids.
+  arma::vec centroidNorms;
+};
+
+/**
+ * The helper for spherical k-means.  The distances are computed from the dot
+ * products of the points with the centroids and the norms of both (the norms
+ * of the points are computed once), which only touches the nonzero elements
+ * of sparse points.  Each new centroid is the mean of the normalized points of
+ * its cluster, normalized to unit length.
+ */
+template<typename MatType>
+class LloydHelper<metric::SphericalDistance, MatType>
+{
+ public:
+  //! Create the helper and compute the squared norms of the points.
+  LloydHelper(const MatType& dataset,
+              metric::SphericalDistance& /* metric */) :
+      dataset(dataset),
+      pointNorms(dataset.n_cols)
+  {
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      pointNorms[i] = PointSquaredNorm(dataset, i);
+  }
+
+  //! Compute the squared norms of the given centroids.
+  void Prepare(const arma::mat& centroids)
+  {
+    centroidNorms = arma::sum(arma::square(centroids), 0).t();
+  }
+
+  //! Compute the distance between the i'th point and the j'th centroid.
+  double Evaluate(const size_t i, const arma::mat& centroids, const size_t j)
+  {
+    return metric::SphericalDistance::FromSimilarity(
+        PointDot(dataset, i, centroids, j), pointNorms[i], centroidNorms[j]);
+  }
+
+  //! Add the normalized i'th point to the c'th column of sums; points with
+  //! norm zero have no direction and are not added.
+  void Add(const size_t i, arma::mat& sums, const size_t c) const
+  {
+    if (pointNorms[i] > 0.0)
+      AddPoint(dataset, i, 1.0 / std::sqrt(pointNorms[i]), sums, c);
+  }
+
+  //! Turn the sums of the normalized points of each cluster into unit-length
+  //! centroids.
+  void Finalize(arma::mat& sums, const arma::Col<size_t>& counts) const
+  {
+    for (size_t c = 0; c < sums.n_cols; ++c)
+    {
+      const double norm = arma::norm(sums.col(c), 2);
+      if (counts[c] != 0 && norm > 0.0)
+        sums.col(c) /= norm;
+    }
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The squared norms of the points.
+  arma::vec pointNorms;
+  //! The squared norms of the current centroids.
+  arma::vec centroidNorms;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
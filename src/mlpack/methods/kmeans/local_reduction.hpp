@@ -0,0 +1,94 @@
+/**
+ * @file methods/kmeans/local_reduction.hpp
+ *
+ * The LocalReduction class, a reduction backend for DistributedKMeans with a
+ * single process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LOCAL_REDUCTION_HPP
+#define MLPACK_METHODS_KMEANS_LOCAL_REDUCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A reduction backend for DistributedKMeans when all the data is held by a
+ * single process; every operation is then a no-op.  This also shows the
+ * interface that a backend has to implement.  Each operation is collective:
+ * it has to be called by every process, in the same order.
+ *
+ * A backend for MPI could be written as follows.
+ *
+ * @code
+ * class MPIReduction
+ * {
+ *  public:
+ *   size_t Rank() const { int r; MPI_Comm_rank(MPI_COMM_WORLD, &r); return r; }
+ *   size_t Size() const { int s; MPI_Comm_size(MPI_COMM_WORLD, &s); return s; }
+ *
+ *   void Sum(arma::mat& matrix)
+ *   {
+ *     MPI_Allreduce(MPI_IN_PLACE, matrix.memptr(), matrix.n_elem, MPI_DOUBLE,
+ *         MPI_SUM, MPI_COMM_WORLD);
+ *   }
+ *
+ *   void Gather(const arma::mat& local, arma::mat& all)
+ *   {
+ *     // Gather the number of elements of each process with MPI_Allgather(),
+ *     // then the elements with MPI_Allgatherv().
+ *   }
+ *
+ *   void Broadcast(arma::mat& matrix, const size_t root)
+ *   {
+ *     // Broadcast the size of the matrix, then its elements, with
+ *     // MPI_Bcast().
+ *   }
+ * };
+ * @endcode
+ */
+class LocalReduction
+{
+ public:
+  //! Get the index of this process.
+  size_t Rank() const { return 0; }
+
+  //! Get the number of processes.
+  size_t Size() const { return 1; }
+
+  /**
+   * Replace the given matrix with the sum of the matrices of every process.
+   * The matrix has the same size on every process.
+   *
+   * @param matrix Matrix to sum.
+   */
+  void Sum(arma::mat& /* matrix */) { }
+
+  /**
+   * Concatenate the columns of the given matrices of every process, in the
+   * order of their ranks, and give the result to every process.  The matrices
+   * have the same number of rows, but may have different numbers of columns.
+   *
+   * @param local Matrix of this process.
+   * @param all Matrix to store the columns of every process in.
+   */
+  void Gather(const arma::mat& local, arma::mat& all) { all = local; }
+
+  /**
+   * Give the given matrix of the root process to every process.
+   *
+   * @param matrix Matrix to broadcast (set on the root process).
+   * @param root Rank of the process that holds the matrix.
+   */
+  void Broadcast(arma::mat& /* matrix */, const size_t /* root */) { }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
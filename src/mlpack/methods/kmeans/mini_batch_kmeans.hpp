@@ -0,0 +1,168 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means (Sculley, 2010), which moves the
+ * centroids towards the points of a small random batch in each iteration
+ * instead of passing over the whole dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of mini-batch k-means, for use as the LloydStepType of the
+ * KMeans class.  Each iteration samples a batch of points from the dataset
+ * (with replacement) and assigns every point of the batch to its closest
+ * centroid.  Each centroid is then moved towards each of its points with a
+ * learning rate of 1 / n, where n is the number of points assigned to that
+ * centroid over all the iterations so far.  An iteration costs
+ * O(batchSize * k) distance calculations, and not O(N * k), so the centroids
+ * come close to convergence after a small fraction of the passes over the
+ * data that Lloyd's algorithm needs.
+ *
+ * The result is an approximation of k-means clustering, and the centroids keep
+ * moving slightly between iterations.  So KMeans usually stops at its maximum
+ * number of iterations, rather than when the centroids converge.
+ *
+ * @code
+ * KMeans<metric::EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, MiniBatchKMeans> k(200);
+ * k.Cluster(data, clusters, centroids);
+ * @endcode
+ *
+ * The batches can also be read from a stream, for data that doesn't fit in
+ * memory: construct the object with only a metric and give each batch to
+ * Update().
+ *
+ * @code
+ * MiniBatchKMeans<metric::EuclideanDistance, arma::mat> miniBatch(metric);
+ * arma::mat centroids = ...; // Initial centroids.
+ * while (ReadNextBatch(batch))
+ *   miniBatch.Update(batch, centroids);
+ * @endcode
+ *
+ * For more information, see the following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   * Each iteration samples batchSize points from the dataset.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points in each batch.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1024);
+
+  /**
+   * Construct the MiniBatchKMeans object without a dataset; the batches are
+   * then given to Update().
+   *
+   * @param metric Instantiated metric.
+   */
+  MiniBatchKMeans(MetricType& metric);
+
+  /**
+   * Run a single iteration of mini-batch k-means on a batch sampled from the
+   * dataset, putting the updated centroids into the newCentroids matrix.  A
+   * cluster is only reported as empty (its count is 0) if no point has been
+   * assigned to it in any iteration so far.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster over all the
+   *     iterations so far.
+   * @return The distance that the centroids moved, as for the other Lloyd
+   *     steps.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Move the given centroids towards the points of the given batch.  The
+   * per-centroid counts are kept between calls, so the learning rate of each
+   * centroid decreases as it is given more points.
+   *
+   * @param batch Points of the batch.
+   * @param centroids Centroids to update.
+   * @return The distance that the centroids moved.
+   */
+  template<typename BatchType>
+  double Update(const BatchType& batch, arma::mat& centroids);
+
+  //! Get the number of points assigned to each cluster so far.
+  const arma::Col<size_t>& Counts() const { return clusterCounts; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Assign the points of a batch to their closest centroids, and move the
+   * centroids towards them.  If sample is true, the batch is sampled from the
+   * given data; otherwise, the batch is all of the given data.
+   */
+  template<typename DataType>
+  double UpdatePoints(const DataType& data,
+                      arma::mat& centroids,
+                      const bool sample);
+
+  //! The dataset (NULL if the batches are given to Update()).
+  const MatType* dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The number of points in each batch.
+  size_t batchSize;
+
+  //! The number of points assigned to each cluster over all the batches.
+  arma::Col<size_t> clusterCounts;
+
+  //! The cluster that each point of the current batch is assigned to.
+  arma::Row<size_t> assignments;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
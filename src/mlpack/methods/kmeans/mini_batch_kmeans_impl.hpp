@@ -0,0 +1,150 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(&dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(MetricType& metric) :
+    dataset(NULL),
+    metric(metric),
+    batchSize(0),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration on a sampled batch.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (dataset == NULL)
+  {
+    throw std::logic_error("MiniBatchKMeans::Iterate(): no dataset was given; "
+        "use Update() instead!");
+  }
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("MiniBatchKMeans::Iterate(): the batch size "
+        "must be positive!");
+  }
+
+  newCentroids = centroids;
+  const double cNorm = UpdatePoints(*dataset, newCentroids, true);
+  counts = clusterCounts;
+
+  return cNorm;
+}
+
+// Update the centroids with the given batch.
+template<typename MetricType, typename MatType>
+template<typename BatchType>
+double MiniBatchKMeans<MetricType, MatType>::Update(const BatchType& batch,
+                                                    arma::mat& centroids)
+{
+  if (batch.n_rows != centroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MiniBatchKMeans::Update(): the batch has " << batch.n_rows
+        << " dimensions, but the centroids have " << centroids.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return UpdatePoints(batch, centroids, false);
+}
+
+template<typename MetricType, typename MatType>
+template<typename DataType>
+double MiniBatchKMeans<MetricType, MatType>::UpdatePoints(
+    const DataType& data,
+    arma::mat& centroids,
+    const bool sample)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // The points of the batch are either sampled from the data (with
+  // replacement), or they are all the points of the data.
+  const size_t points = sample ? batchSize : data.n_cols;
+  arma::Col<size_t> indices(points);
+  for (size_t i = 0; i < points; ++i)
+    indices[i] = sample ? (size_t) math::RandInt((int) data.n_cols) : i;
+
+  // Find the closest centroid to each point of the batch in parallel, before
+  // any centroid moves.
+  assignments.set_size(points);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) points; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(data.col(indices[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+  distanceCalculations += centroids.n_cols * points;
+
+  const arma::mat oldCentroids(centroids);
+
+  // Move each centroid towards its points, with a learning rate that decreases
+  // as the centroid is given more points.
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t cluster = assignments[i];
+    ++clusterCounts[cluster];
+    centroids.col(cluster) += (arma::vec(data.col(indices[i])) -
+        centroids.col(cluster)) / (double) clusterCounts[cluster];
+  }
+
+  // Calculate how far the centroids moved.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(oldCentroids.col(i), centroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
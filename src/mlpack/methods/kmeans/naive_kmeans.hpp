@@ -16,6 +16,8 @@
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
 
+#include "lloyd_helper.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -25,6 +27,11 @@ namespace kmeans {
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * The distances to the centroids are computed with LloydHelper, so that sparse
+ * points are only accessed through their nonzero elements when the metric is
+ * the (squared) Euclidean distance or the spherical distance; with
+ * metric::SphericalDistance, this is spherical k-means.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -61,6 +68,8 @@ class NaiveKMeans
   const MatType& dataset;
   //! The instantiated metric.
   MetricType& metric;
+  //! The distance computations and centroid updates.
+  LloydHelper<MetricType, MatType> helper;
 
   //! Number of distance calculations.
   size_t distanceCalculations;
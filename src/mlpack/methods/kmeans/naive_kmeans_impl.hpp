@@ -27,6 +27,7 @@ NaiveKMeans<MetricType, MatType>::NaiveKMeans(const MatType& dataset,
                                               MetricType& metric) :
     dataset(dataset),
     metric(metric),
+    helper(dataset, metric),
     distanceCalculations(0)
 { /* Nothing to do. */ }
 
@@ -38,6 +39,7 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 {
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
+  helper.Prepare(centroids);
 
   // Find the closest centroid to each point and update the new centroids.
   // Computed in parallel over the complete dataset
@@ -57,8 +59,7 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
       for (size_t j = 0; j < centroids.n_cols; ++j)
       {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
+        const double distance = helper.Evaluate(i, centroids, j);
         if (distance < minDistance)
         {
           minDistance = distance;
@@ -69,7 +70,7 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       Log::Assert(closestCluster != centroids.n_cols);
 
       // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
+      helper.Add(i, localCentroids, closestCluster);
       localCounts(closestCluster)++;
     }
     // Combine calculated state from each thread
@@ -81,9 +82,7 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now normalize the centroid.
-  for (size_t i = 0; i < centroids.n_cols; ++i)
-    if (counts(i) != 0)
-      newCentroids.col(i) /= counts(i);
+  helper.Finalize(newCentroids, counts);
 
   distanceCalculations += centroids.n_cols * dataset.n_cols;
 
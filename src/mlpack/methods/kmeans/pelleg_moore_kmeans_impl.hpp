@@ -53,14 +53,74 @@ double PellegMooreKMeans<MetricType, MatType>::Iterate(
   typedef PellegMooreKMeansRules<MetricType, TreeType> RulesType;
   RulesType rules(dataset, centroids, newCentroids, counts, metric);
 
-  // Use single-tree traverser.
-  typename TreeType::template SingleTreeTraverser<RulesType> traverser(rules);
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Score the top levels of the tree here, until there are enough subtrees
+    // to balance the load between the threads.  Each node takes its blacklist
+    // from its parent, so once a node is scored, its subtree can be traversed
+    // independently of the rest of the tree.  A query index of 0 is used, as
+    // in the traversal below.
+    std::vector<TreeType*> subtrees;
+    if (rules.Score(0, *tree) != DBL_MAX && !tree->IsLeaf())
+      subtrees.push_back(tree);
+
+    while (!subtrees.empty() && subtrees.size() < 4 * numThreads)
+    {
+      std::vector<TreeType*> children;
+      for (size_t i = 0; i < subtrees.size(); ++i)
+      {
+        for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        {
+          TreeType& child = subtrees[i]->Child(j);
+          if (rules.Score(0, child) != DBL_MAX && !child.IsLeaf())
+            children.push_back(&child);
+        }
+      }
+
+      subtrees.swap(children);
+    }
+
+    distanceCalculations += rules.DistanceCalculations();
+
+    // Now traverse the subtrees in parallel; each thread sums the points of
+    // each cluster separately.
+    #pragma omp parallel
+    {
+      arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+      RulesType localRules(dataset, centroids, localCentroids, localCounts,
+          metric);
+      typename TreeType::template SingleTreeTraverser<RulesType>
+          traverser(localRules);
 
-  // Now, do a traversal with a fake query index (since the query index is
-  // irrelevant; we are checking each node with all clusters.
-  traverser.Traverse(0, *tree);
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+        traverser.Traverse(0, *subtrees[i]);
 
-  distanceCalculations += rules.DistanceCalculations();
+      #pragma omp critical
+      {
+        newCentroids += localCentroids;
+        counts += localCounts;
+        distanceCalculations += localRules.DistanceCalculations();
+      }
+    }
+  }
+  else
+#endif
+  {
+    // Use single-tree traverser.
+    typename TreeType::template SingleTreeTraverser<RulesType>
+        traverser(rules);
+
+    // Now, do a traversal with a fake query index (since the query index is
+    // irrelevant; we are checking each node with all clusters.
+    traverser.Traverse(0, *tree);
+
+    distanceCalculations += rules.DistanceCalculations();
+  }
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
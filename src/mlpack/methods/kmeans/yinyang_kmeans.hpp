@@ -0,0 +1,127 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans.hpp
+ *
+ * An implementation of Yinyang k-means, which prunes distance calculations with
+ * one lower bound per group of centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "lloyd_helper.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of a single Lloyd iteration with the Yinyang k-means
+ * algorithm, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *   title={Yinyang k-means: A drop-in replacement of the classic k-means with
+ *       consistent speedup},
+ *   author={Ding, Y. and Zhao, Y. and Shen, X. and Musuvathi, M. and
+ *       Mytkowicz, T.},
+ *   booktitle={Proceedings of the 32nd International Conference on Machine
+ *       Learning (ICML '15)},
+ *   pages={579--587},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * The centroids are grouped (by clustering the initial centroids), and each
+ * point keeps an upper bound on the distance to its centroid and one lower
+ * bound per group on the distance to the other centroids of the group.  This
+ * lies between Elkan's algorithm, which keeps k lower bounds per point (too
+ * much memory for large k), and Hamerly's algorithm, which keeps one lower
+ * bound per point (which prunes poorly for large k).  A group whose lower bound
+ * is larger than the upper bound of a point is skipped entirely; after each
+ * iteration, the lower bound of a group is moved by the largest movement of
+ * its centroids.
+ *
+ * The points are processed in parallel when OpenMP is available.
+ *
+ * @tparam MetricType Type of metric; it must satisfy the triangle inequality.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class YinyangKMeans
+{
+ public:
+  /**
+   * Construct the YinyangKMeans object, which must store the bounds of each
+   * point.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param groupSize Average number of centroids in each group; the centroids
+   *     are split into ceil(k / groupSize) groups.
+   */
+  YinyangKMeans(const MatType& dataset,
+                MetricType& metric,
+                const size_t groupSize = 10);
+
+  /**
+   * Run a single iteration of the Yinyang algorithm, updating the given
+   * centroids into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of groups of centroids (0 before the first iteration).
+  size_t NumGroups() const { return groups.size(); }
+
+ private:
+  /**
+   * Split the centroids into groups with a few iterations of k-means on the
+   * centroids.
+   */
+  void GroupCentroids(const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The distance computations and centroid updates.
+  LloydHelper<MetricType, MatType> helper;
+  //! The average number of centroids in each group.
+  size_t groupSize;
+
+  //! The centroids of each group.
+  std::vector<std::vector<size_t>> groups;
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+
+  //! Holds the index of the cluster that owns each point.
+  arma::Col<size_t> assignments;
+  //! Upper bounds on the distance between each point and its closest cluster.
+  arma::vec upperBounds;
+  //! Lower bounds on the distance between each point and the other clusters
+  //! of each group.
+  arma::mat lowerBounds;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans_impl.hpp
+ *
+ * Implementation of the Yinyang k-means Lloyd step.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+YinyangKMeans<MetricType, MatType>::YinyangKMeans(const MatType& dataset,
+                                                  MetricType& metric,
+                                                  const size_t groupSize) :
+    dataset(dataset),
+    metric(metric),
+    helper(dataset, metric),
+    groupSize(groupSize),
+    distanceCalculations(0)
+{
+  if (groupSize == 0)
+  {
+    throw std::invalid_argument("YinyangKMeans::YinyangKMeans(): groupSize "
+        "must be positive!");
+  }
+}
+
+template<typename MetricType, typename MatType>
+double YinyangKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
+                                                   arma::mat& newCentroids,
+                                                   arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+  helper.Prepare(centroids);
+
+  // If this is the first iteration, we must group the centroids, and all the
+  // distances are computed to set the bounds.
+  const bool firstIteration = (centroidGroups.n_elem != centroids.n_cols);
+  if (firstIteration)
+  {
+    GroupCentroids(centroids);
+    assignments.zeros(dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
+    lowerBounds.set_size(groups.size(), dataset.n_cols);
+  }
+  const size_t numGroups = groups.size();
+
+  size_t yinyangPruned = 0;
+
+  // The bounds of each point are only used by the thread that processes it,
+  // and each thread sums the points of each cluster separately.
+  #pragma omp parallel
+  {
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+    size_t localDistanceCalculations = 0;
+    size_t localPruned = 0;
+
+    // The closest and second closest distances to the centroids of each
+    // group, and the closest centroid of each group.
+    arma::vec groupBest(numGroups), groupSecond(numGroups);
+    arma::Col<size_t> groupBestIndex(numGroups);
+    std::vector<size_t> examined;
+    examined.reserve(numGroups);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      if (firstIteration)
+      {
+        groupBest.fill(DBL_MAX);
+        groupSecond.fill(DBL_MAX);
+        for (size_t c = 0; c < centroids.n_cols; ++c)
+        {
+          const double dist = helper.Evaluate(i, centroids, c);
+          const size_t g = centroidGroups[c];
+          if (dist < groupBest[g])
+          {
+            groupSecond[g] = groupBest[g];
+            groupBest[g] = dist;
+            groupBestIndex[g] = c;
+          }
+          else if (dist < groupSecond[g])
+          {
+            groupSecond[g] = dist;
+          }
+        }
+        localDistanceCalculations += centroids.n_cols;
+
+        const size_t bestGroup = groupBest.index_min();
+        assignments[i] = groupBestIndex[bestGroup];
+        upperBounds(i) = groupBest[bestGroup];
+        for (size_t g = 0; g < numGroups; ++g)
+          lowerBounds(g, i) = (g == bestGroup) ? groupSecond[g] : groupBest[g];
+      }
+      else
+      {
+        // Global filter: if the upper bound is below every group's lower
+        // bound, the assignment can't change.
+        const size_t assignment = assignments[i];
+        const double minLowerBound = lowerBounds.col(i).min();
+        if (upperBounds(i) <= minLowerBound)
+        {
+          ++localPruned;
+          helper.Add(i, localCentroids, assignment);
+          ++localCounts[assignment];
+          continue;
+        }
+
+        // Tighten the upper bound and try again.
+        upperBounds(i) = helper.Evaluate(i, centroids, assignment);
+        ++localDistanceCalculations;
+        if (upperBounds(i) <= minLowerBound)
+        {
+          helper.Add(i, localCentroids, assignment);
+          ++localCounts[assignment];
+          continue;
+        }
+
+        // Group filter: only the groups whose lower bound is below the
+        // distance to the current centroid can hold a closer centroid.
+        const double oldDistance = upperBounds(i);
+        size_t best = assignment;
+        double bestDistance = oldDistance;
+        examined.clear();
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          if (lowerBounds(g, i) >= oldDistance)
+            continue;
+
+          examined.push_back(g);
+          groupBest[g] = DBL_MAX;
+          groupSecond[g] = DBL_MAX;
+          for (size_t j = 0; j < groups[g].size(); ++j)
+          {
+            const size_t c = groups[g][j];
+            if (c == assignment)
+              continue;
+
+            const double dist = helper.Evaluate(i, centroids, c);
+            ++localDistanceCalculations;
+            if (dist < groupBest[g])
+            {
+              groupSecond[g] = groupBest[g];
+              groupBest[g] = dist;
+              groupBestIndex[g] = c;
+            }
+            else if (dist < groupSecond[g])
+            {
+              groupSecond[g] = dist;
+            }
+          }
+
+          if (groupBest[g] < bestDistance)
+          {
+            best = groupBestIndex[g];
+            bestDistance = groupBest[g];
+          }
+        }
+
+        // The examined groups get exact lower bounds, which exclude the new
+        // centroid of the point; the old centroid becomes a candidate for the
+        // lower bound of its group.
+        for (size_t e = 0; e < examined.size(); ++e)
+        {
+          const size_t g = examined[e];
+          lowerBounds(g, i) = (best != assignment && centroidGroups[best] == g)
+              ? groupSecond[g] : groupBest[g];
+        }
+        if (best != assignment)
+        {
+          const size_t oldGroup = centroidGroups[assignment];
+          lowerBounds(oldGroup, i) = std::min(lowerBounds(oldGroup, i),
+              oldDistance);
+        }
+
+        assignments[i] = best;
+        upperBounds(i) = bestDistance;
+      }
+
+      helper.Add(i, localCentroids, assignments[i]);
+      ++localCounts[assignments[i]];
+    }
+
+    // Combine the sums of each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+      distanceCalculations += localDistanceCalculations;
+      yinyangPruned += localPruned;
+    }
+  }
+
+  // Normalize centroids and calculate the movement of each cluster and the
+  // largest movement in each group.
+  helper.Finalize(newCentroids, counts);
+  arma::vec centroidMovements(centroids.n_cols);
+  arma::vec groupMovements(numGroups, arma::fill::zeros);
+  double cNorm = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    centroidMovements(c) = metric.Evaluate(centroids.col(c),
+        newCentroids.col(c));
+    cNorm += std::pow(centroidMovements(c), 2.0);
+    ++distanceCalculations;
+
+    const size_t g = centroidGroups[c];
+    groupMovements(g) = std::max(groupMovements(g), centroidMovements(c));
+  }
+
+  // Now update the bounds.  It doesn't matter if a lower bound becomes
+  // negative.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    upperBounds(i) += centroidMovements(assignments[i]);
+    lowerBounds.col(i) -= groupMovements;
+  }
+
+  Log::Info << "Yinyang prunes: " << yinyangPruned << ".\n";
+
+  return std::sqrt(cNorm);
+}
+
+template<typename MetricType, typename MatType>
+void YinyangKMeans<MetricType, MatType>::GroupCentroids(
+    const arma::mat& centroids)
+{
+  const size_t k = centroids.n_cols;
+  const size_t numGroups = std::max((size_t) 1,
+      std::min(k, (k + groupSize - 1) / groupSize));
+  centroidGroups.zeros(k);
+
+  // Run five iterations of k-means on the centroids, starting from evenly
+  // spaced centroids, like the paper does.
+  if (numGroups > 1)
+  {
+    arma::mat groupCenters(centroids.n_rows, numGroups);
+    for (size_t g = 0; g < numGroups; ++g)
+      groupCenters.col(g) = centroids.col(g * k / numGroups);
+
+    arma::Col<size_t> groupCounts(numGroups);
+    for (size_t iteration = 0; iteration < 5; ++iteration)
+    {
+      #pragma omp parallel for
+      for (omp_size_t c = 0; c < (omp_size_t) k; ++c)
+      {
+        double bestDistance = DBL_MAX;
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          const double dist = metric.Evaluate(centroids.col(c),
+              groupCenters.col(g));
+          if (dist < bestDistance)
+          {
+            bestDistance = dist;
+            centroidGroups[c] = g;
+          }
+        }
+      }
+      distanceCalculations += k * numGroups;
+
+      // Empty groups keep their center.
+      groupCounts.zeros();
+      arma::mat sums(centroids.n_rows, numGroups, arma::fill::zeros);
+      for (size_t c = 0; c < k; ++c)
+      {
+        sums.col(centroidGroups[c]) += centroids.col(c);
+        ++groupCounts[centroidGroups[c]];
+      }
+      for (size_t g = 0; g < numGroups; ++g)
+        if (groupCounts[g] > 0)
+          groupCenters.col(g) = sums.col(g) / groupCounts[g];
+    }
+  }
+
+  // Build the list of centroids of each group, without the empty groups.
+  std::vector<std::vector<size_t>> allGroups(numGroups);
+  for (size_t c = 0; c < k; ++c)
+    allGroups[centroidGroups[c]].push_back(c);
+
+  groups.clear();
+  for (size_t g = 0; g < numGroups; ++g)
+  {
+    if (allGroups[g].empty())
+      continue;
+
+    for (size_t j = 0; j < allGroups[g].size(); ++j)
+      centroidGroups[allGroups[g][j]] = groups.size();
+    groups.push_back(allGroups[g]);
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -230,15 +230,33 @@ double LARS::Train(const arma::mat& matX,
     return maxCorr;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  // Compute the Gram matrix, unless one was given.  If this is the elastic net
+  // problem, we will add lambda2 * I_n to the matrix.  With the Cholesky
+  // decomposition, only the Gram matrix columns of the active set are needed;
+  // these are computed as variables are activated, so the full d x d Gram
+  // matrix is never formed on high-dimensional data.
+  if (matGram == &matGramInternal)
   {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
+    if (useCholesky)
+    {
+      matGramInternal.reset();
+    }
+    else
+    {
+      ComputeGram(dataRef);
+      if (elasticNet)
+        matGramInternal.diag() += lambda2;
+    }
+  }
+  else if (matGram->n_rows != dataRef.n_cols ||
+           matGram->n_cols != dataRef.n_cols)
+  {
+    Timer::Stop("lars_regression");
+    std::ostringstream oss;
+    oss << "LARS::Train(): the given Gram matrix has size " << matGram->n_rows
+        << " x " << matGram->n_cols << ", but the data has " << dataRef.n_cols
+        << " dimensions!";
+    throw std::invalid_argument(oss.str());
   }
 
   // Main loop.
@@ -260,16 +278,29 @@ double LARS::Train(const arma::mat& matX,
     {
       if (useCholesky)
       {
-        // vec newGramCol = vec(activeSet.size());
-        // for (size_t i = 0; i < activeSet.size(); ++i)
-        // {
-        //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
-        // }
-        // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
-            arma::conv_to<arma::uvec>::from(activeSet));
-
-        CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
+        if (matGram->n_elem > 0)
+        {
+          arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
+              arma::conv_to<arma::uvec>::from(activeSet));
+
+          CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
+        }
+        else
+        {
+          // Compute the new column of the Gram matrix from the data; each
+          // entry is a dot product of two contiguous columns.
+          arma::vec newGramCol(activeSet.size());
+          #pragma omp parallel for schedule(static) \
+              if (activeSet.size() * dataRef.n_rows > 100000)
+          for (omp_size_t i = 0; i < (omp_size_t) activeSet.size(); ++i)
+          {
+            newGramCol[i] = arma::dot(dataRef.col(activeSet[i]),
+                dataRef.col(changeInd));
+          }
+
+          CholeskyInsert(arma::dot(dataRef.col(changeInd),
+              dataRef.col(changeInd)), newGramCol);
+        }
       }
 
       // Add variable to active set.
@@ -364,13 +395,16 @@ double LARS::Train(const arma::mat& matX,
     // If not all variables are active.
     if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
     {
-      // Compute correlations with direction.
+      // Compute correlations with direction.  This is a single matrix-vector
+      // product over all dimensions instead of one dot product per inactive
+      // dimension.
+      const arma::vec dirCorrs = trans(dataRef) * yHatDirection;
       for (size_t ind = 0; ind < dataRef.n_cols; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        const double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        const double dirCorr = dirCorrs[ind];
         const double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         const double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0.0) && (val1 < gamma))
@@ -473,6 +507,127 @@ double LARS::Train(const arma::mat& data,
   return Train(data, responses, beta, transposeData);
 }
 
+double LARS::CrossValidate(const arma::mat& data,
+                           const arma::rowvec& responses,
+                           const arma::vec& lambdas,
+                           const size_t folds,
+                           arma::vec& errors,
+                           const bool transposeData)
+{
+  const size_t numPoints = (transposeData ? data.n_cols : data.n_rows);
+  if (lambdas.n_elem == 0)
+  {
+    throw std::invalid_argument("LARS::CrossValidate(): at least one value of "
+        "lambda1 must be given!");
+  }
+  if (folds < 2 || folds > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "LARS::CrossValidate(): the number of folds must be between 2 and "
+        << "the number of points (" << numPoints << "), but is " << folds
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (responses.n_elem != numPoints)
+  {
+    std::ostringstream oss;
+    oss << "LARS::CrossValidate(): number of points (" << numPoints << ") "
+        << "does not match number of responses (" << responses.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("lars_cross_validation");
+
+  // A single path down to the smallest lambda1 contains the solutions for all
+  // the others, so each fold is trained once.  The folds are independent and
+  // are trained in parallel.
+  const double minLambda = lambdas.min();
+  std::vector<arma::vec> foldErrors(folds);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t f = 0; f < (omp_size_t) folds; ++f)
+  {
+    const size_t first = f * numPoints / folds;
+    const size_t last = (f + 1) * numPoints / folds - 1;
+
+    arma::mat trainData(data);
+    arma::rowvec trainResponses(responses);
+    trainResponses.shed_cols(first, last);
+    const arma::rowvec testResponses = responses.subvec(first, last);
+    arma::mat testData;
+    if (transposeData)
+    {
+      trainData.shed_cols(first, last);
+      testData = data.cols(first, last);
+    }
+    else
+    {
+      trainData.shed_rows(first, last);
+      testData = data.rows(first, last);
+    }
+
+    LARS model(useCholesky, minLambda, lambda2, tolerance);
+    model.Train(trainData, trainResponses, transposeData);
+
+    foldErrors[f].set_size(lambdas.n_elem);
+    arma::vec beta;
+    for (size_t l = 0; l < lambdas.n_elem; ++l)
+    {
+      model.PathSolution(lambdas[l], beta);
+      const arma::rowvec predictions = transposeData ? arma::rowvec(beta.t() *
+          testData) : arma::rowvec(trans(testData * beta));
+      foldErrors[f][l] = arma::accu(arma::square(testResponses -
+          predictions)) / testResponses.n_elem;
+    }
+  }
+
+  // Sum the errors in fold order, so that the result is deterministic.
+  errors.zeros(lambdas.n_elem);
+  for (size_t f = 0; f < folds; ++f)
+    errors += foldErrors[f];
+  errors /= folds;
+
+  Timer::Stop("lars_cross_validation");
+
+  // Retrain on the full data with the best value of lambda1.
+  lambda1 = lambdas[errors.index_min()];
+  Train(data, responses, transposeData);
+
+  return lambda1;
+}
+
+void LARS::PathSolution(const double lambda, arma::vec& beta) const
+{
+  if (betaPath.empty())
+  {
+    throw std::runtime_error("LARS::PathSolution(): the model must be trained "
+        "first!");
+  }
+
+  // The path is piecewise linear in lambda between the breakpoints, which are
+  // sorted in decreasing order of lambda.
+  if (lambda >= lambdaPath[0])
+  {
+    beta = betaPath[0];
+    return;
+  }
+
+  for (size_t k = 1; k < lambdaPath.size(); ++k)
+  {
+    if (lambda >= lambdaPath[k])
+    {
+      const double width = lambdaPath[k - 1] - lambdaPath[k];
+      const double interp = (width > 0.0) ?
+          (lambdaPath[k - 1] - lambda) / width : 1.0;
+      beta = (1 - interp) * betaPath[k - 1] + interp * betaPath[k];
+      return;
+    }
+  }
+
+  // lambda is below the end of the path.
+  beta = betaPath.back();
+}
+
 void LARS::Predict(const arma::mat& points,
                    arma::rowvec& predictions,
                    const bool rowMajor) const
@@ -512,6 +667,42 @@ void LARS::ComputeYHatDirection(const arma::mat& matX,
     yHatDirection += betaDirection(i) * matX.col(activeSet[i]);
 }
 
+void LARS::ComputeGram(const arma::mat& matX)
+{
+  // The Gram matrix is symmetric, so only the blocks on and above the diagonal
+  // are computed, in parallel, and the blocks below are their transposes.
+  const size_t dims = matX.n_cols;
+  const size_t blockSize = 256;
+  const size_t numBlocks = (dims + blockSize - 1) / blockSize;
+  const size_t numPairs = numBlocks * (numBlocks + 1) / 2;
+  matGramInternal.set_size(dims, dims);
+
+  #pragma omp parallel for schedule(dynamic) if (numPairs > 1)
+  for (omp_size_t p = 0; p < (omp_size_t) numPairs; ++p)
+  {
+    // Find the block (i, j), i <= j, of the p'th pair in row-major order.
+    size_t i = 0;
+    size_t rem = p;
+    while (rem >= numBlocks - i)
+    {
+      rem -= numBlocks - i;
+      ++i;
+    }
+    const size_t j = i + rem;
+
+    const size_t iFirst = i * blockSize;
+    const size_t iLast = std::min(iFirst + blockSize, dims) - 1;
+    const size_t jFirst = j * blockSize;
+    const size_t jLast = std::min(jFirst + blockSize, dims) - 1;
+
+    const arma::mat block = trans(matX.cols(iFirst, iLast)) *
+        matX.cols(jFirst, jLast);
+    matGramInternal.submat(iFirst, jFirst, iLast, jLast) = block;
+    if (i != j)
+      matGramInternal.submat(jFirst, iFirst, jLast, iLast) = trans(block);
+  }
+}
+
 void LARS::InterpolateBeta()
 {
   int pathLength = betaPath.size();
@@ -561,21 +752,18 @@ void LARS::CholeskyInsert(double sqNormNewX, const arma::vec& newGramCol)
   }
   else
   {
-    arma::mat matNewR = arma::mat(n + 1, n + 1);
-
     if (elasticNet)
       sqNormNewX += lambda2;
 
     arma::vec matUtriCholFactork = solve(trimatl(trans(matUtriCholFactor)),
         newGramCol);
 
-    matNewR(arma::span(0, n - 1), arma::span(0, n - 1)) = matUtriCholFactor;
-    matNewR(arma::span(0, n - 1), n) = matUtriCholFactork;
-    matNewR(n, arma::span(0, n - 1)).fill(0.0);
-    matNewR(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
-                                          matUtriCholFactork));
-
-    matUtriCholFactor = matNewR;
+    // Grow the factor in place; resize() keeps the existing elements.
+    matUtriCholFactor.resize(n + 1, n + 1);
+    matUtriCholFactor(arma::span(0, n - 1), n) = matUtriCholFactork;
+    matUtriCholFactor(n, arma::span(0, n - 1)).fill(0.0);
+    matUtriCholFactor(n, n) = sqrt(sqNormNewX - dot(matUtriCholFactork,
+                                                    matUtriCholFactork));
   }
 }
 
@@ -628,11 +816,15 @@ void LARS::CholeskyDelete(const size_t colToKill)
       GivensRotate(matUtriCholFactor(arma::span(k, k + 1), k), rotatedVec,
           matG);
       matUtriCholFactor(arma::span(k, k + 1), k) = rotatedVec;
-      if (k < n - 1)
+
+      // Apply the rotation to rows k and k + 1 of the remaining columns in
+      // place, without forming a temporary 2 x (n - k - 1) matrix.
+      for (size_t j = k + 1; j < n; ++j)
       {
-        matUtriCholFactor(arma::span(k, k + 1), arma::span(k + 1, n - 1)) =
-            matG * matUtriCholFactor(arma::span(k, k + 1),
-            arma::span(k + 1, n - 1));
+        const double a = matUtriCholFactor(k, j);
+        const double b = matUtriCholFactor(k + 1, j);
+        matUtriCholFactor(k, j) = matG(0, 0) * a + matG(0, 1) * b;
+        matUtriCholFactor(k + 1, j) = matG(1, 0) * a + matG(1, 1) * b;
       }
     }
 
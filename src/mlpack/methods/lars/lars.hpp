@@ -236,6 +236,43 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Select lambda1 by k-fold cross-validation over the given values, then train
+   * the model on all the data with the best value, which is also stored in
+   * Lambda1().  The folds are contiguous blocks of points, so the data should
+   * be shuffled beforehand if it is ordered.  Because the LARS path contains
+   * the solution for every lambda1 above its end, only one path is computed
+   * per fold (down to the smallest value), and the folds are trained in
+   * parallel.  The current values of lambda2, UseCholesky() and Tolerance()
+   * are used; a precomputed Gram matrix is only used for the final training.
+   *
+   * @param data Input data.
+   * @param responses A vector of targets.
+   * @param lambdas Values of lambda1 to evaluate.
+   * @param folds Number of folds.
+   * @param errors Vector to store the mean squared validation error of each
+   *     value of lambda1 in.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   * @return The value of lambda1 with the smallest validation error.
+   */
+  double CrossValidate(const arma::mat& data,
+                       const arma::rowvec& responses,
+                       const arma::vec& lambdas,
+                       const size_t folds,
+                       arma::vec& errors,
+                       const bool transposeData = true);
+
+  /**
+   * Compute the solution for the given value of lambda1 from the solution path
+   * of the last training, by interpolating between the points of the path.
+   * Values of lambda1 below the end of the path give the final solution.
+   *
+   * @param lambda Value of lambda1.
+   * @param beta Vector to store the solution in.
+   */
+  void PathSolution(const double lambda, arma::vec& beta) const;
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -375,6 +412,14 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
+  /**
+   * Compute the Gram matrix of the given row-major data into matGramInternal,
+   * in parallel over blocks of dimensions.
+   *
+   * @param matX Row-major input data.
+   */
+  void ComputeGram(const arma::mat& matX);
+
   // compute "equiangular" direction in output space
   void ComputeYHatDirection(const arma::mat& matX,
                             const arma::vec& betaDirection,
@@ -12,6 +12,7 @@
  */
 #include "linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/size_checks.hpp>
 
 using namespace mlpack;
 using namespace mlpack::regression;
@@ -29,7 +30,8 @@ LinearRegression::LinearRegression(const arma::mat& predictors,
                                    const double lambda,
                                    const bool intercept) :
     lambda(lambda),
-    intercept(intercept)
+    intercept(intercept),
+    numPoints(0)
 {
   Train(predictors, responses, weights, intercept);
 }
@@ -81,13 +83,191 @@ double LinearRegression::Train(const arma::mat& predictors,
   // Then we'll use Armadillo to solve it.
   // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
   // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  // X X^T and y X^T are kept as the sufficient statistics of the model, so
+  // that more chunks can be added with AddChunk().
+  gram = p * p.t();
+  moments = p * r.t();
+  numPoints = nCols;
 
-  parameters = arma::solve(cov, p * r.t());
+  arma::mat cov = gram + lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+
+  parameters = arma::solve(cov, moments);
   return ComputeError(predictors, responses);
 }
 
+void LinearRegression::AddChunk(const arma::mat& predictors,
+                                const arma::rowvec& responses,
+                                const arma::rowvec& weights)
+{
+  arma::mat chunkGram;
+  arma::vec chunkMoments;
+  ChunkStatistics(predictors, responses, weights, chunkGram, chunkMoments,
+      "LinearRegression::AddChunk()");
+
+  if (gram.n_elem == 0)
+  {
+    gram = std::move(chunkGram);
+    moments = std::move(chunkMoments);
+  }
+  else
+  {
+    gram += chunkGram;
+    moments += chunkMoments;
+  }
+  numPoints += predictors.n_cols;
+}
+
+void LinearRegression::RemoveChunk(const arma::mat& predictors,
+                                   const arma::rowvec& responses,
+                                   const arma::rowvec& weights)
+{
+  if (predictors.n_cols > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::RemoveChunk(): cannot remove "
+        << predictors.n_cols << " points from statistics of " << numPoints
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat chunkGram;
+  arma::vec chunkMoments;
+  ChunkStatistics(predictors, responses, weights, chunkGram, chunkMoments,
+      "LinearRegression::RemoveChunk()");
+
+  gram -= chunkGram;
+  moments -= chunkMoments;
+  numPoints -= predictors.n_cols;
+}
+
+void LinearRegression::Solve()
+{
+  if (numPoints == 0)
+  {
+    throw std::runtime_error("LinearRegression::Solve(): no points have been "
+        "added to the model!");
+  }
+
+  const arma::mat cov = gram + lambda * arma::eye<arma::mat>(gram.n_rows,
+      gram.n_rows);
+
+  // cov = R^T R, so the parameters are found with two triangular solves.  If
+  // the system is not positive definite (for instance because there are fewer
+  // points than dimensions and lambda is 0), fall back to the general solver
+  // used by Train().
+  arma::mat r;
+  if (arma::chol(r, cov))
+  {
+    const arma::vec y = arma::solve(arma::trimatl(r.t()), moments);
+    parameters = arma::solve(arma::trimatu(r), y);
+  }
+  else
+  {
+    Log::Warn << "LinearRegression::Solve(): the regularized Gram matrix is "
+        << "not positive definite; using a general solver." << std::endl;
+    parameters = arma::solve(cov, moments);
+  }
+}
+
+void LinearRegression::ResetStatistics()
+{
+  gram.reset();
+  moments.reset();
+  numPoints = 0;
+}
+
+void LinearRegression::ChunkStatistics(const arma::mat& predictors,
+                                       const arma::rowvec& responses,
+                                       const arma::rowvec& weights,
+                                       arma::mat& chunkGram,
+                                       arma::vec& chunkMoments,
+                                       const std::string& caller) const
+{
+  util::CheckSameSizes(predictors, responses, caller, "responses");
+  if (weights.n_elem > 0)
+    util::CheckSameSizes(predictors, weights, caller, "weights");
+
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  if (gram.n_elem > 0 && gram.n_rows != dims)
+  {
+    std::ostringstream oss;
+    oss << caller << ": chunk has " << predictors.n_rows
+        << " dimensions, but the model has " << (gram.n_rows -
+        (intercept ? 1 : 0)) << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The points are processed in blocks, and each block is copied (with the
+  // intercept row and the weights applied) so that the Gram matrix of the
+  // block is a single matrix product.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (predictors.n_cols + blockSize - 1) / blockSize;
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numBlocks));
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // Each thread accumulates into its own statistics; these are summed in
+  // thread order afterwards, so the result does not depend on the timing of
+  // the threads.
+  std::vector<arma::mat> threadGrams(numThreads);
+  std::vector<arma::vec> threadMoments(numThreads);
+
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+  {
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+#else
+    const size_t thread = 0;
+#endif
+    threadGrams[thread].zeros(dims, dims);
+    threadMoments[thread].zeros(dims);
+    arma::mat p;
+    arma::rowvec r;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t first = b * blockSize;
+      const size_t last = std::min(first + blockSize, predictors.n_cols) - 1;
+
+      p.set_size(dims, last - first + 1);
+      if (intercept)
+      {
+        p.row(0).ones();
+        p.rows(1, dims - 1) = predictors.cols(first, last);
+      }
+      else
+      {
+        p = predictors.cols(first, last);
+      }
+      r = responses.subvec(first, last);
+
+      if (weights.n_elem > 0)
+      {
+        const arma::rowvec sqrtWeights = arma::sqrt(weights.subvec(first,
+            last));
+        p.each_row() %= sqrtWeights;
+        r %= sqrtWeights;
+      }
+
+      threadGrams[thread] += p * p.t();
+      threadMoments[thread] += p * r.t();
+    }
+  }
+
+  chunkGram.zeros(dims, dims);
+  chunkMoments.zeros(dims);
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    chunkGram += threadGrams[t];
+    chunkMoments += threadMoments[t];
+  }
+}
+
 void LinearRegression::Predict(const arma::mat& points,
     arma::rowvec& predictions) const
 {
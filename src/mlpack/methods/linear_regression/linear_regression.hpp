@@ -59,14 +59,14 @@ class LinearRegression
    * called (or make sure the model parameters are set) before calling
    * Predict()!
    */
-  LinearRegression() : lambda(0.0), intercept(true) { }
+  LinearRegression() : lambda(0.0), intercept(true), numPoints(0) { }
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model, including its
+   * sufficient statistics; to train incrementally, use AddChunk() and Solve().
+   * To set the regularization parameter lambda, call Lambda() or set a
+   * different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -79,8 +79,8 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
+   * This will completely ignore and overwrite the existing model, including its
+   * sufficient statistics; to train incrementally, use AddChunk() and Solve().
    * To set the regularization parameter lambda, call Lambda() or set a
    * different value in the constructor.
    *
@@ -95,6 +95,53 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Add a chunk of data to the sufficient statistics of the model (the Gram
+   * matrix X X^T and the vector X y^T), without solving for the parameters.
+   * The statistics of large chunks are accumulated in parallel.  Chunks can be
+   * added (and removed with RemoveChunk()) in any order, so a model over a
+   * sliding window can be kept without revisiting the data inside the window;
+   * call Solve() to compute the parameters from the current statistics.  The
+   * statistics are also set by Train(), and the Intercept() setting of the
+   * model is used for all chunks.
+   *
+   * @param predictors X, the matrix of data points in the chunk.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights; if empty, all weights are 1.
+   */
+  void AddChunk(const arma::mat& predictors,
+                const arma::rowvec& responses,
+                const arma::rowvec& weights = arma::rowvec());
+
+  /**
+   * Remove a chunk of data that was previously added with AddChunk() (or
+   * trained on with Train()) from the sufficient statistics of the model.  The
+   * same predictors, responses and weights must be given.  Call Solve() to
+   * compute the parameters from the remaining statistics.
+   *
+   * @param predictors X, the matrix of data points in the chunk.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights; if empty, all weights are 1.
+   */
+  void RemoveChunk(const arma::mat& predictors,
+                   const arma::rowvec& responses,
+                   const arma::rowvec& weights = arma::rowvec());
+
+  /**
+   * Compute the parameters of the model from the sufficient statistics of the
+   * chunks that have been added, using the current value of Lambda().  The
+   * regularized normal equations are solved with a Cholesky decomposition,
+   * falling back to a general solver if the system is not positive definite.
+   * This takes O(d^3) time, independently of the number of points.
+   */
+  void Solve();
+
+  /**
+   * Clear the sufficient statistics of the model, keeping the current
+   * parameters.
+   */
+  void ResetStatistics();
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -136,15 +183,34 @@ class LinearRegression
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
 
+  //! Return the accumulated Gram matrix X X^T (including the intercept row).
+  const arma::mat& Gram() const { return gram; }
+  //! Return the accumulated vector X y^T (including the intercept row).
+  const arma::vec& Moments() const { return moments; }
+  //! Return the number of points in the sufficient statistics.
+  size_t NumPoints() const { return numPoints; }
+
   /**
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */)
+  void serialize(Archive& ar, const uint32_t version)
   {
     ar(CEREAL_NVP(parameters));
     ar(CEREAL_NVP(lambda));
     ar(CEREAL_NVP(intercept));
+
+    // Models saved before version 1 have no sufficient statistics.
+    if (version > 0)
+    {
+      ar(CEREAL_NVP(gram));
+      ar(CEREAL_NVP(moments));
+      ar(CEREAL_NVP(numPoints));
+    }
+    else if (cereal::is_loading<Archive>())
+    {
+      ResetStatistics();
+    }
   }
 
  private:
@@ -162,9 +228,31 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! Accumulated Gram matrix of the (possibly weighted) design matrix.
+  arma::mat gram;
+
+  //! Accumulated product of the design matrix and the responses.
+  arma::vec moments;
+
+  //! Number of points in the sufficient statistics.
+  size_t numPoints;
+
+  /**
+   * Compute the Gram matrix and moments of the given chunk, in parallel over
+   * blocks of points.  The caller is used in error messages.
+   */
+  void ChunkStatistics(const arma::mat& predictors,
+                       const arma::rowvec& responses,
+                       const arma::rowvec& weights,
+                       arma::mat& chunkGram,
+                       arma::vec& chunkMoments,
+                       const std::string& caller) const;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+CEREAL_CLASS_VERSION(mlpack::regression::LinearRegression, 1);
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
@@ -0,0 +1,205 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent.hpp
+ *
+ * A dual coordinate descent solver for linear SVMs, which is much faster than
+ * the primal optimizers for sparse high-dimensional data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * DualCoordinateDescent trains a linear SVM by solving the dual of the
+ * L1-loss (hinge loss) SVM problem one coordinate at a time, with shrinking of
+ * the bounded variables, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{hsieh2008dual,
+ *   title={A dual coordinate descent method for large-scale linear SVM},
+ *   author={Hsieh, C.-J. and Chang, K.-W. and Lin, C.-J. and Keerthi, S. S.
+ *       and Sundararajan, S.},
+ *   booktitle={Proceedings of the 25th International Conference on Machine
+ *       Learning (ICML '08)},
+ *   pages={408--415},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each update only touches one point, so for sparse data (arma::sp_mat) the
+ * cost of an update is the number of nonzero elements of the point.
+ *
+ * The multiclass model is trained one-vs-rest: the column of the parameters of
+ * class c minimizes
+ *
+ * @f[
+ * \frac{\lambda}{2} || w_c ||^2 + \frac{1}{n} \sum_i \max(0, \delta - y_i w_c^T
+ * x_i)
+ * @f]
+ *
+ * with y_i = 1 if the i'th point is of class c and y_i = -1 otherwise (the
+ * intercept, if any, is the last element of w_c and is regularized like the
+ * other parameters).  This is not the Weston-Watkins objective of
+ * LinearSVMFunction, but the model is used in the same way, and the classes
+ * are trained in parallel when OpenMP is available.  With two classes, only
+ * one problem is solved, and the second column is the negation of the first.
+ *
+ * The class is selected as the optimizer of LinearSVM::Train():
+ *
+ * @code
+ * LinearSVM<arma::sp_mat> svm(0.001);
+ * svm.Train(data, labels, numClasses, DualCoordinateDescent(1000, 0.1));
+ * @endcode
+ */
+class DualCoordinateDescent
+{
+ public:
+  /**
+   * Create the solver with the given parameters.
+   *
+   * @param maxIterations Maximum number of passes over the points for each
+   *     class (0 means no limit).
+   * @param tolerance Tolerance on the largest violation of the optimality
+   *     conditions (the gap between the largest and smallest projected
+   *     gradients) for convergence.
+   * @param shrinking Whether to temporarily remove the variables that are
+   *     likely to stay at a bound.
+   */
+  DualCoordinateDescent(const size_t maxIterations = 1000,
+                        const double tolerance = 0.1,
+                        const bool shrinking = true) :
+      maxIterations(maxIterations),
+      tolerance(tolerance),
+      shrinking(shrinking)
+  { /* Nothing to do. */ }
+
+  /**
+   * Train the one-vs-rest linear SVM on the given data.  The parameters are
+   * set to a matrix with one column for each class, and one row for each
+   * dimension (plus one for the intercept, if it is used).
+   *
+   * @param data Training points (one per column).
+   * @param labels Labels of the points, in [0, numClasses).
+   * @param numClasses Number of classes.
+   * @param lambda L2-regularization constant; must be positive.
+   * @param delta Margin of the hinge loss; must be positive.
+   * @param fitIntercept Whether to fit an intercept.
+   * @param parameters Matrix to store the parameters in.
+   * @return The sum over the classes of the primal objectives.
+   */
+  template<typename MatType, typename ElemType>
+  double Optimize(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const double lambda,
+                  const double delta,
+                  const bool fitIntercept,
+                  arma::Mat<ElemType>& parameters);
+
+  //! Get the maximum number of passes over the points.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes over the points.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether shrinking is used.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether shrinking is used.
+  bool& Shrinking() { return shrinking; }
+
+ private:
+  /**
+   * Solve the binary problem of the given class, with the given upper bound
+   * on the dual variables, and store the solution (scaled to margin 1) in w.
+   * The order of the updates is shuffled with the given generator.
+   *
+   * @return The number of passes over the points.
+   */
+  template<typename MatType>
+  size_t OptimizeClass(const MatType& data,
+                       const arma::Row<size_t>& labels,
+                       const size_t positiveClass,
+                       const double c,
+                       const bool fitIntercept,
+                       const arma::vec& squaredNorms,
+                       math::RandomStream& rng,
+                       arma::vec& w) const;
+
+  //! Compute the dot product of the i'th point of dense data with w.
+  template<typename ElemType>
+  static double Dot(const arma::Mat<ElemType>& data,
+                    const size_t i,
+                    const arma::vec& w)
+  {
+    const ElemType* point = data.colptr(i);
+    double dot = 0.0;
+    for (size_t r = 0; r < data.n_rows; ++r)
+      dot += point[r] * w[r];
+    return dot;
+  }
+
+  //! Compute the dot product of the i'th point of sparse data with w.
+  template<typename ElemType>
+  static double Dot(const arma::SpMat<ElemType>& data,
+                    const size_t i,
+                    const arma::vec& w)
+  {
+    double dot = 0.0;
+    for (typename arma::SpMat<ElemType>::const_iterator it =
+         data.begin_col(i); it != data.end_col(i); ++it)
+      dot += (*it) * w[it.row()];
+    return dot;
+  }
+
+  //! Add the i'th point of dense data, times the given scale, to w.
+  template<typename ElemType>
+  static void Add(const arma::Mat<ElemType>& data,
+                  const size_t i,
+                  const double scale,
+                  arma::vec& w)
+  {
+    const ElemType* point = data.colptr(i);
+    for (size_t r = 0; r < data.n_rows; ++r)
+      w[r] += scale * point[r];
+  }
+
+  //! Add the i'th point of sparse data, times the given scale, to w.
+  template<typename ElemType>
+  static void Add(const arma::SpMat<ElemType>& data,
+                  const size_t i,
+                  const double scale,
+                  arma::vec& w)
+  {
+    for (typename arma::SpMat<ElemType>::const_iterator it =
+         data.begin_col(i); it != data.end_col(i); ++it)
+      w[it.row()] += scale * (*it);
+  }
+
+  //! The maximum number of passes over the points.
+  size_t maxIterations;
+  //! The tolerance for convergence.
+  double tolerance;
+  //! Whether shrinking is used.
+  bool shrinking;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "dual_coordinate_descent_impl.hpp"
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent_impl.hpp
+ *
+ * Implementation of the dual coordinate descent solver for linear SVMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dual_coordinate_descent.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename MatType, typename ElemType>
+double DualCoordinateDescent::Optimize(const MatType& data,
+                                       const arma::Row<size_t>& labels,
+                                       const size_t numClasses,
+                                       const double lambda,
+                                       const double delta,
+                                       const bool fitIntercept,
+                                       arma::Mat<ElemType>& parameters)
+{
+  if (lambda <= 0.0 || delta <= 0.0)
+  {
+    throw std::invalid_argument("DualCoordinateDescent::Optimize(): lambda "
+        "and delta must be positive!");
+  }
+  if (labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("DualCoordinateDescent::Optimize(): the "
+        "number of labels must be the number of points!");
+  }
+
+  // The problem of each class is scaled so that the margin is 1: with
+  // w = delta * v, the objective is (lambda * delta^2) times
+  // 0.5 * ||v||^2 + C * sum_i max(0, 1 - y_i v^T x_i).
+  const size_t n = data.n_cols;
+  const double c = 1.0 / (lambda * delta * n);
+  const size_t dimensionality = data.n_rows + (fitIntercept ? 1 : 0);
+
+  // The diagonal of the kernel matrix doesn't depend on the class.
+  arma::vec squaredNorms(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    squaredNorms[i] = 0.0;
+    for (typename MatType::const_iterator it = data.begin_col(i);
+         it != data.end_col(i); ++it)
+      squaredNorms[i] += (*it) * (*it);
+    if (fitIntercept)
+      squaredNorms[i] += 1.0;
+  }
+
+  // With two classes, the second one-vs-rest problem is the negation of the
+  // first.
+  const size_t numProblems = (numClasses == 2) ? 1 : numClasses;
+  arma::mat solutions(dimensionality, numProblems);
+
+  // Each problem gets its own stream of the same seed, so the result doesn't
+  // depend on the number of threads.
+  const uint64_t seed = math::randGen();
+  size_t totalIterations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:totalIterations)
+  for (omp_size_t p = 0; p < (omp_size_t) numProblems; ++p)
+  {
+    const size_t positiveClass = (numClasses == 2) ? 1 : p;
+    math::RandomStream rng(seed, p);
+    arma::vec w(dimensionality, arma::fill::zeros);
+    totalIterations += OptimizeClass(data, labels, positiveClass, c,
+        fitIntercept, squaredNorms, rng, w);
+    solutions.col(p) = delta * w;
+  }
+
+  Log::Info << "DualCoordinateDescent::Optimize(): " << totalIterations
+      << " passes over the points for " << numProblems << " problem(s)."
+      << std::endl;
+
+  parameters.set_size(dimensionality, numClasses);
+  if (numClasses == 2)
+  {
+    parameters.col(1) = arma::conv_to<arma::Col<ElemType>>::from(
+        solutions.col(0));
+    parameters.col(0) = -parameters.col(1);
+  }
+  else
+  {
+    parameters = arma::conv_to<arma::Mat<ElemType>>::from(solutions);
+  }
+
+  // Compute the primal objective of each problem.
+  double objective = 0.0;
+  for (size_t p = 0; p < numProblems; ++p)
+  {
+    const size_t positiveClass = (numClasses == 2) ? 1 : p;
+    const arma::vec w = solutions.col(p);
+    double loss = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double y = (labels[i] == positiveClass) ? 1.0 : -1.0;
+      double score = Dot(data, i, w);
+      if (fitIntercept)
+        score += w[data.n_rows];
+      loss += std::max(0.0, delta - y * score);
+    }
+
+    objective += 0.5 * lambda * arma::dot(w, w) + loss / n;
+  }
+
+  return objective;
+}
+
+template<typename MatType>
+size_t DualCoordinateDescent::OptimizeClass(const MatType& data,
+                                            const arma::Row<size_t>& labels,
+                                            const size_t positiveClass,
+                                            const double c,
+                                            const bool fitIntercept,
+                                            const arma::vec& squaredNorms,
+                                            math::RandomStream& rng,
+                                            arma::vec& w) const
+{
+  const size_t n = data.n_cols;
+  const size_t interceptIndex = data.n_rows;
+  arma::vec alpha(n, arma::fill::zeros);
+
+  // The indices of the points that aren't shrunk are the first activeSize
+  // elements of the order.
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+  size_t activeSize = n;
+
+  // The largest and smallest projected gradients of the previous pass, which
+  // are used to shrink the variables.
+  double oldMaxGradient = DBL_MAX;
+  double oldMinGradient = -DBL_MAX;
+
+  size_t iteration = 0;
+  while (maxIterations == 0 || iteration < maxIterations)
+  {
+    ++iteration;
+    std::shuffle(order.begin(), order.begin() + activeSize, rng);
+
+    double maxGradient = -DBL_MAX;
+    double minGradient = DBL_MAX;
+    size_t s = 0;
+    while (s < activeSize)
+    {
+      const size_t i = order[s];
+      if (squaredNorms[i] == 0.0)
+      {
+        ++s;
+        continue;
+      }
+
+      const double y = (labels[i] == positiveClass) ? 1.0 : -1.0;
+      double score = Dot(data, i, w);
+      if (fitIntercept)
+        score += w[interceptIndex];
+      const double gradient = y * score - 1.0;
+
+      // Compute the projected gradient, and shrink the variables at a bound
+      // whose gradient points outside of the feasible region by more than any
+      // projected gradient of the previous pass.
+      double projectedGradient = 0.0;
+      if (alpha[i] == 0.0)
+      {
+        if (shrinking && gradient > oldMaxGradient)
+        {
+          std::swap(order[s], order[--activeSize]);
+          continue;
+        }
+        else if (gradient < 0.0)
+        {
+          projectedGradient = gradient;
+        }
+      }
+      else if (alpha[i] == c)
+      {
+        if (shrinking && gradient < oldMinGradient)
+        {
+          std::swap(order[s], order[--activeSize]);
+          continue;
+        }
+        else if (gradient > 0.0)
+        {
+          projectedGradient = gradient;
+        }
+      }
+      else
+      {
+        projectedGradient = gradient;
+      }
+
+      maxGradient = std::max(maxGradient, projectedGradient);
+      minGradient = std::min(minGradient, projectedGradient);
+
+      if (std::abs(projectedGradient) > 1e-12)
+      {
+        const double oldAlpha = alpha[i];
+        alpha[i] = std::min(std::max(alpha[i] - gradient / squaredNorms[i],
+            0.0), c);
+        const double step = (alpha[i] - oldAlpha) * y;
+        Add(data, i, step, w);
+        if (fitIntercept)
+          w[interceptIndex] += step;
+      }
+
+      ++s;
+    }
+
+    if (maxGradient - minGradient <= tolerance)
+    {
+      // If variables were shrunk, check the optimality conditions on all of
+      // them before stopping.
+      if (activeSize == n)
+        break;
+
+      activeSize = n;
+      oldMaxGradient = DBL_MAX;
+      oldMinGradient = -DBL_MAX;
+      continue;
+    }
+
+    oldMaxGradient = (maxGradient <= 0.0) ? DBL_MAX : maxGradient;
+    oldMinGradient = (minGradient >= 0.0) ? -DBL_MAX : minGradient;
+  }
+
+  return iteration;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
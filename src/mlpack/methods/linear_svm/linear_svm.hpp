@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "linear_svm_function.hpp"
+#include "dual_coordinate_descent.hpp"
 
 namespace mlpack {
 namespace svm {
@@ -25,7 +26,9 @@ namespace svm {
  * model, and supports training with multiple optimizers and classification.
  * The class supports different observation types via the MatType template
  * parameter; for instance, support vector classification can be performed
- * on sparse datasets by specifying arma::sp_mat as the MatType parameter.
+ * on sparse datasets by specifying arma::sp_mat as the MatType parameter, and
+ * in single precision by specifying arma::fmat.  The parameters of the model
+ * are dense, with the element type of MatType.
  *
  * Linear SVM can be used for general classification tasks which will work
  * on multiclass classification. More technical details about
@@ -80,6 +83,11 @@ template <typename MatType = arma::mat>
 class LinearSVM
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! The type of the model parameters (always dense).
+  typedef arma::Mat<ElemType> DenseMatType;
+
   /**
    * Construct the LinearSVM class with the provided data and labels.
    * This will train the model. Optionally, the parameter 'lambda' can be
@@ -188,7 +196,7 @@ class LinearSVM
    */
   void Classify(const MatType& data,
                 arma::Row<size_t>& labels,
-                arma::mat& scores) const;
+                DenseMatType& scores) const;
 
   /**
    * Classify the given points, returning class scores for each point.
@@ -197,7 +205,7 @@ class LinearSVM
    * @param scores Class scores for each point.
    */
   void Classify(const MatType& data,
-                arma::mat& scores) const;
+                DenseMatType& scores) const;
 
   /**
    * Classify the given point. The predicted class label is returned.
@@ -258,6 +266,21 @@ class LinearSVM
                const size_t numClasses = 2,
                OptimizerType optimizer = OptimizerType());
 
+  /**
+   * Train the Linear SVM with the given training data, using dual coordinate
+   * descent.  This trains a one-vs-rest model (see DualCoordinateDescent),
+   * and is much faster than the other optimizers on sparse data.
+   *
+   * @param data Input training features. Each column associate with one sample.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Instantiated dual coordinate descent solver.
+   * @return Sum of the objective values of the one-vs-rest problems.
+   */
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               DualCoordinateDescent optimizer);
 
   //! Sets the number of classes.
   size_t& NumClasses() { return numClasses; }
@@ -278,9 +301,9 @@ class LinearSVM
   bool& FitIntercept() { return fitIntercept; }
 
   //! Set the model parameters.
-  arma::mat& Parameters() { return parameters; }
+  DenseMatType& Parameters() { return parameters; }
   //! Get the model parameters.
-  const arma::mat& Parameters() const { return parameters; }
+  const DenseMatType& Parameters() const { return parameters; }
 
   //! Gets the features size of the training data
   size_t FeatureSize() const
@@ -301,7 +324,7 @@ class LinearSVM
 
  private:
   //! Parameters after optimization.
-  arma::mat parameters;
+  DenseMatType parameters;
   //! Number of classes.
   size_t numClasses;
   //! L2-Regularization constant.
@@ -22,12 +22,20 @@ namespace svm {
 /**
  * The hinge loss function for the linear SVM objective function.
  * This is used by various ensmallen optimizers to train the linear
- * SVM model.
+ * SVM model.  The data may be dense or sparse; the parameters are always
+ * dense, with the element type of the data.
+ *
+ * @tparam MatType Type of data matrix.
  */
 template <typename MatType = arma::mat>
 class LinearSVMFunction
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! The type of the parameters (always dense).
+  typedef arma::Mat<ElemType> DenseMatType;
+
   /**
    * Construct the Linear SVM objective function with given parameters.
    *
@@ -59,7 +67,7 @@ class LinearSVMFunction
    * @param numClasses Number of classes for classification.
    * @param fitIntercept If true, an intercept is fitted.
    */
-  static void InitializeWeights(arma::mat& weights,
+  static void InitializeWeights(DenseMatType& weights,
                                 const size_t featureSize,
                                 const size_t numClasses,
                                 const bool fitIntercept = false);
@@ -68,10 +76,10 @@ class LinearSVMFunction
    * Constructs the ground truth label matrix with the passed labels.
    *
    * @param labels Labels associated with the training data.
-   * @param groundTruth Pointer to arma::mat which stores the computed matrix.
+   * @param groundTruth Sparse matrix which stores the computed matrix.
    */
   void GetGroundTruthMatrix(const arma::Row<size_t>& labels,
-                            arma::sp_mat& groundTruth);
+                            arma::SpMat<ElemType>& groundTruth);
 
   /**
    * Evaluate the hinge loss function for all the datapoints
@@ -79,7 +87,7 @@ class LinearSVMFunction
    * @param parameters The parameters of the SVM.
    * @return The value of the loss function for the entire dataset.
    */
-  double Evaluate(const arma::mat& parameters);
+  double Evaluate(const DenseMatType& parameters);
 
   /**
    * Evaluate the hinge loss function on the specified datapoints.
@@ -90,7 +98,7 @@ class LinearSVMFunction
    * @param batchSize Size of batch to process.
    * @return The value of the loss function for the given parameters.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const DenseMatType& parameters,
                   const size_t firstId,
                   const size_t batchSize = 1);
 
@@ -103,7 +111,7 @@ class LinearSVMFunction
    * @param gradient Linear matrix to output the gradient into.
    */
   template <typename GradType>
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const DenseMatType& parameters,
                 GradType& gradient);
 
   /**
@@ -117,11 +125,29 @@ class LinearSVMFunction
    * @param batchSize Size of the batch to process.
    */
   template <typename GradType>
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const DenseMatType& parameters,
                 const size_t firstId,
                 GradType& gradient,
                 const size_t batchSize = 1);
 
+  /**
+   * Evaluate the gradient of the hinge loss function on the specified
+   * datapoints as a sparse matrix, whose only nonzero rows are the intercept
+   * and the features that are nonzero in the batch.  As in Hogwild!, the
+   * regularization is only applied to those rows, so that an update does not
+   * touch the rest of the parameters.  This is the overload used by lock-free
+   * parallel optimizers such as optimization::HogwildSGD and ens::ParallelSGD.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the datapoint to use for the gradient evaluation.
+   * @param gradient Sparse matrix to output the gradient into.
+   * @param batchSize Size of the batch to process.
+   */
+  void Gradient(const DenseMatType& parameters,
+                const size_t firstId,
+                arma::SpMat<ElemType>& gradient,
+                const size_t batchSize = 1);
+
   /**
    * Evaluate the gradient of the hinge loss function, following
    * the LinearFunctionType requirements on the Gradient function
@@ -134,7 +160,7 @@ class LinearSVMFunction
    * @return The value of the loss function at the given parameters.
    */
   template <typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
+  double EvaluateWithGradient(const DenseMatType& parameters,
                               GradType& gradient) const;
 
   /**
@@ -152,20 +178,20 @@ class LinearSVMFunction
    * @return The value of the loss function at the given parameters.
    */
   template <typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
+  double EvaluateWithGradient(const DenseMatType& parameters,
                               const size_t firstId,
                               GradType& gradient,
                               const size_t batchSize = 1) const;
 
   //! Return the initial point for the optimization.
-  const arma::mat& InitialPoint() const { return initialPoint; }
+  const DenseMatType& InitialPoint() const { return initialPoint; }
   //! Modify the initial point for the optimization.
-  arma::mat& InitialPoint() { return initialPoint; }
+  DenseMatType& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const arma::sp_mat& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  arma::sp_mat& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
@@ -180,10 +206,10 @@ class LinearSVMFunction
 
  private:
   //! The initial point, from which to start the optimization.
-  arma::mat initialPoint;
+  DenseMatType initialPoint;
 
   //! Label matrix for provided data
-  arma::sp_mat groundTruth;
+  arma::SpMat<ElemType> groundTruth;
 
   //! The datapoints for training.
   MatType dataset;
@@ -51,7 +51,7 @@ LinearSVMFunction<MatType>::LinearSVMFunction(
  */
 template <typename MatType>
 void LinearSVMFunction<MatType>::InitializeWeights(
-    arma::mat &weights,
+    DenseMatType& weights,
     const size_t featureSize,
     const size_t numClasses,
     const bool fitIntercept)
@@ -73,7 +73,7 @@ void LinearSVMFunction<MatType>::InitializeWeights(
 template <typename MatType>
 void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
     const arma::Row<size_t>& labels,
-    arma::sp_mat& groundTruth)
+    arma::SpMat<ElemType>& groundTruth)
 {
   // Calculate the ground truth matrix according to the labels passed. The
   // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
@@ -96,12 +96,12 @@ void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
   }
 
   // All entries are '1'.
-  arma::vec values;
+  arma::Col<ElemType> values;
   values.ones(labels.n_elem);
 
   // Calculate the matrix.
-  groundTruth = arma::sp_mat(rowPointers, colPointers, values, numClasses,
-                             labels.n_elem);
+  groundTruth = arma::SpMat<ElemType>(rowPointers, colPointers, values,
+      numClasses, labels.n_elem);
 }
 
 /**
@@ -110,41 +110,25 @@ void LinearSVMFunction<MatType>::GetGroundTruthMatrix(
 template <typename MatType>
 void LinearSVMFunction<MatType>::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      dataset.n_cols - 1, dataset.n_cols));
+  // Recover the labels from the ground truth matrix, so that the points and
+  // the labels can be shuffled together without densifying sparse data.
+  arma::Row<size_t> labels(groundTruth.n_cols);
+  typename arma::SpMat<ElemType>::const_iterator it = groundTruth.begin();
+  for (; it != groundTruth.end(); ++it)
+    labels[it.col()] = it.row();
+
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  math::ShuffleData(dataset, labels, newData, newLabels);
 
-  // Re-sort data.
-  arma::mat newData = dataset.cols(ordering);
   math::ClearAlias(dataset);
   dataset = std::move(newData);
-
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(groundTruth.n_nonzero);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
-  {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-    values(loc) = (*it);
-
-    ++it;
-    ++loc;
-  }
-
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-                             groundTruth.n_cols);
+  GetGroundTruthMatrix(newLabels, groundTruth);
 }
 
 template <typename MatType>
 double LinearSVMFunction<MatType>::Evaluate(
-    const arma::mat& parameters)
+    const DenseMatType& parameters)
 {
   // The objective function is the hinge loss function and it is
   // calculated over all the training examples.
@@ -155,7 +139,7 @@ double LinearSVMFunction<MatType>::Evaluate(
   double loss, regularization;
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   // Check intercept condition.
   if (!fitIntercept)
@@ -179,12 +163,14 @@ double LinearSVMFunction<MatType>::Evaluate(
   //  - Adding the margin parameter `delta`.
   //  - Removing the `delta` parameter from correct class label in each
   //    column.
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth), numClasses, 1)) + delta
       - (delta * groundTruth);
 
   // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX)) / dataset.n_cols;
+  loss = arma::accu(arma::clamp(margin, ElemType(0),
+      std::numeric_limits<ElemType>::max())) / dataset.n_cols;
 
   // Adding the regularization term.
   regularization = 0.5 * lambda * arma::dot(parameters, parameters);
@@ -194,7 +180,7 @@ double LinearSVMFunction<MatType>::Evaluate(
 
 template <typename MatType>
 double LinearSVMFunction<MatType>::Evaluate(
-    const arma::mat& parameters,
+    const DenseMatType& parameters,
     const size_t firstId,
     const size_t batchSize)
 {
@@ -204,7 +190,7 @@ double LinearSVMFunction<MatType>::Evaluate(
   double loss, regularization, cost;
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   // Check intercept condition.
   if (!fitIntercept)
@@ -215,16 +201,17 @@ double LinearSVMFunction<MatType>::Evaluate(
   {
     scores = parameters.rows(0, dataset.n_rows - 1).t()
         * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
       + delta - (delta * groundTruth.cols(firstId, lastId));
 
   // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
+  loss = arma::accu(arma::clamp(margin, ElemType(0),
+      std::numeric_limits<ElemType>::max()));
   loss /= batchSize;
 
   // Adding the regularization term.
@@ -237,7 +224,7 @@ double LinearSVMFunction<MatType>::Evaluate(
 template <typename MatType>
 template <typename GradType>
 void LinearSVMFunction<MatType>::Gradient(
-    const arma::mat& parameters,
+    const DenseMatType& parameters,
     GradType& gradient)
 {
   // The objective is to minimize the loss, which is evaluated as the sum
@@ -246,7 +233,7 @@ void LinearSVMFunction<MatType>::Gradient(
   // Also, we need to increase the score of the correct class.
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   if (!fitIntercept)
   {
@@ -259,16 +246,17 @@ void LinearSVMFunction<MatType>::Gradient(
         dataset.n_cols);
   }
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth), numClasses, 1)) + delta
       - (delta * groundTruth);
 
   // An element of `mask` matrix holds `1` corresponding to
   // each positive element of `margin` matrix.
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
+  DenseMatType mask = margin.for_each([](ElemType& val)
       { val = (val > 0) ? 1: 0; });
 
-  arma::mat difference = groundTruth
+  DenseMatType difference = groundTruth
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
   // The gradient is evaluated as follows:
@@ -289,7 +277,7 @@ void LinearSVMFunction<MatType>::Gradient(
     gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
         dataset * difference.t();
     gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
+        arma::ones<arma::Row<ElemType>>(dataset.n_cols) * difference.t();
   }
 
   gradient /= dataset.n_cols;
@@ -301,7 +289,7 @@ void LinearSVMFunction<MatType>::Gradient(
 template <typename MatType>
 template <typename GradType>
 void LinearSVMFunction<MatType>::Gradient(
-    const arma::mat& parameters,
+    const DenseMatType& parameters,
     const size_t firstId,
     GradType& gradient,
     const size_t batchSize)
@@ -309,7 +297,7 @@ void LinearSVMFunction<MatType>::Gradient(
   const size_t lastId = firstId + batchSize - 1;
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   // Check intercept condition.
   if (!fitIntercept)
@@ -323,16 +311,17 @@ void LinearSVMFunction<MatType>::Gradient(
         + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
       + delta - (delta * groundTruth.cols(firstId, lastId));
 
   // For each sample, find the total number of classes where
   // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
+  DenseMatType mask = margin.for_each([](ElemType& val)
       { val = (val > 0) ? 1: 0; });
 
-  arma::mat difference = groundTruth.cols(firstId, lastId)
+  DenseMatType difference = groundTruth.cols(firstId, lastId)
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
   // Check intercept condition
@@ -346,7 +335,7 @@ void LinearSVMFunction<MatType>::Gradient(
     gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
         dataset.cols(firstId, lastId) * difference.t();
     gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
+        arma::ones<arma::Row<ElemType>>(batchSize) * difference.t();
   }
 
   gradient /= batchSize;
@@ -355,16 +344,103 @@ void LinearSVMFunction<MatType>::Gradient(
   gradient += lambda * parameters;
 }
 
+template <typename MatType>
+void LinearSVMFunction<MatType>::Gradient(
+    const DenseMatType& parameters,
+    const size_t firstId,
+    arma::SpMat<ElemType>& gradient,
+    const size_t batchSize)
+{
+  const size_t lastId = firstId + batchSize - 1;
+
+  // Scores for each class are evaluated.
+  DenseMatType scores;
+
+  // Check intercept condition.
+  if (!fitIntercept)
+  {
+    scores = parameters.t() * dataset.cols(firstId, lastId);
+  }
+  else
+  {
+    scores = parameters.rows(0, dataset.n_rows - 1).t()
+        * dataset.cols(firstId, lastId)
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
+  }
+
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
+      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
+      + delta - (delta * groundTruth.cols(firstId, lastId));
+
+  // For each sample, find the total number of classes where
+  // ( margin > 0 ).
+  DenseMatType mask = margin.for_each([](ElemType& val)
+      { val = (val > 0) ? 1: 0; });
+
+  const DenseMatType difference = (groundTruth.cols(firstId, lastId)
+      % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask) / batchSize;
+
+  // Collect the terms of the intercept row and, for each nonzero element of
+  // the batch, of the row of its feature; the terms of the same parameter are
+  // summed by the constructor.
+  const arma::SpMat<ElemType> batch(dataset.cols(firstId, lastId));
+  const size_t numTerms = numClasses * (batch.n_nonzero +
+      (fitIntercept ? 1 : 0));
+  arma::umat locations(2, numTerms);
+  arma::Col<ElemType> values(numTerms);
+  size_t k = 0;
+  if (fitIntercept)
+  {
+    const arma::Col<ElemType> interceptTerms = arma::sum(difference, 1);
+    for (size_t c = 0; c < numClasses; ++c, ++k)
+    {
+      locations(0, k) = parameters.n_rows - 1;
+      locations(1, k) = c;
+      values[k] = interceptTerms[c];
+    }
+  }
+
+  typename arma::SpMat<ElemType>::const_iterator it = batch.begin();
+  for (; it != batch.end(); ++it)
+  {
+    for (size_t c = 0; c < numClasses; ++c, ++k)
+    {
+      locations(0, k) = it.row();
+      locations(1, k) = c;
+      values[k] = difference(c, it.col()) * (*it);
+    }
+  }
+
+  // Zeros are kept, so that every touched parameter is regularized below.
+  const arma::SpMat<ElemType> loss(true, locations, values, parameters.n_rows,
+      parameters.n_cols, true, false);
+
+  // Adding the regularization contribution of the touched parameters.
+  locations.set_size(2, loss.n_nonzero);
+  values.set_size(loss.n_nonzero);
+  k = 0;
+  for (it = loss.begin(); it != loss.end(); ++it, ++k)
+  {
+    locations(0, k) = it.row();
+    locations(1, k) = it.col();
+    values[k] = (*it) + lambda * parameters(it.row(), it.col());
+  }
+
+  gradient = arma::SpMat<ElemType>(locations, values, parameters.n_rows,
+      parameters.n_cols, false);
+}
+
 template <typename MatType>
 template <typename GradType>
 double LinearSVMFunction<MatType>::EvaluateWithGradient(
-    const arma::mat& parameters,
+    const DenseMatType& parameters,
     GradType& gradient) const
 {
   double loss, regularization, cost;
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   if (!fitIntercept)
   {
@@ -377,16 +453,17 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
         dataset.n_cols);
   }
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth), numClasses, 1)) + delta
       - (delta * groundTruth);
 
   // For each sample, find the total number of classes where
   // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
+  DenseMatType mask = margin.for_each([](ElemType& val)
       { val = (val > 0) ? 1: 0; });
 
-  arma::mat difference = groundTruth
+  DenseMatType difference = groundTruth
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
   // Check intercept condition
@@ -400,7 +477,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
             dataset * difference.t();
     gradient.row(parameters.n_rows - 1) =
-            arma::ones<arma::rowvec>(dataset.n_cols) * difference.t();
+            arma::ones<arma::Row<ElemType>>(dataset.n_cols) * difference.t();
   }
 
   gradient /= dataset.n_cols;
@@ -409,7 +486,8 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   gradient += lambda * parameters;
 
   // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin, 0.0, DBL_MAX));
+  loss = arma::accu(arma::clamp(margin, ElemType(0),
+      std::numeric_limits<ElemType>::max()));
   loss /= dataset.n_cols;
 
   // Adding the regularization term.
@@ -422,7 +500,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
 template <typename MatType>
 template <typename GradType>
 double LinearSVMFunction<MatType>::EvaluateWithGradient(
-    const arma::mat& parameters,
+    const DenseMatType& parameters,
     const size_t firstId,
     GradType& gradient,
     const size_t batchSize) const
@@ -433,7 +511,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   double loss, regularization, cost;
 
   // Scores for each class are evaluated.
-  arma::mat scores;
+  DenseMatType scores;
 
   // Check intercept condition.
   if (!fitIntercept)
@@ -444,19 +522,20 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   {
     scores = parameters.rows(0, dataset.n_rows - 1).t()
         * dataset.cols(firstId, lastId)
-        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
+        + arma::repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
   }
 
-  arma::mat margin = scores - (arma::repmat(arma::ones(numClasses).t()
+  DenseMatType margin = scores - (arma::repmat(
+      arma::ones<DenseMatType>(1, numClasses)
       * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
       + delta - (delta * groundTruth.cols(firstId, lastId));
 
   // For each sample, find the total number of classes where
   // ( margin > 0 ).
-  arma::mat mask = margin.for_each([](arma::mat::elem_type& val)
+  DenseMatType mask = margin.for_each([](ElemType& val)
       { val = (val > 0) ? 1: 0; });
 
-  arma::mat difference = groundTruth.cols(firstId, lastId)
+  DenseMatType difference = groundTruth.cols(firstId, lastId)
       % (-arma::repmat(arma::sum(mask), numClasses, 1)) + mask;
 
   // Check intercept condition
@@ -470,7 +549,7 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
     gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
         dataset.cols(firstId, lastId) * difference.t();
     gradient.row(parameters.n_rows - 1) =
-        arma::ones<arma::rowvec>(batchSize) * difference.t();
+        arma::ones<arma::Row<ElemType>>(batchSize) * difference.t();
   }
 
   gradient /= batchSize;
@@ -480,7 +559,8 @@ double LinearSVMFunction<MatType>::EvaluateWithGradient(
   gradient += lambda * parameters;
 
   // The Hinge Loss Function
-  loss = arma::accu(arma::clamp(margin.cols(firstId, lastId), 0.0, DBL_MAX));
+  loss = arma::accu(arma::clamp(margin, ElemType(0),
+      std::numeric_limits<ElemType>::max()));
   loss /= batchSize;
 
   // Adding the regularization term.
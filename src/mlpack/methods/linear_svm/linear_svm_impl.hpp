@@ -144,12 +144,36 @@ double LinearSVM<MatType>::Train(
   return out;
 }
 
+template <typename MatType>
+double LinearSVM<MatType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    DualCoordinateDescent optimizer)
+{
+  if (numClasses <= 1)
+  {
+    throw std::invalid_argument("LinearSVM dataset has 0 number of classes!");
+  }
+
+  // The solver doesn't need a starting point.
+  Timer::Start("linear_svm_optimization");
+  const double out = optimizer.Optimize(data, labels, numClasses, lambda,
+      delta, fitIntercept, parameters);
+  Timer::Stop("linear_svm_optimization");
+
+  Log::Info << "LinearSVM::LinearSVM(): final objective of "
+            << "trained model is " << out << "." << std::endl;
+
+  return out;
+}
+
 template <typename MatType>
 void LinearSVM<MatType>::Classify(
     const MatType& data,
     arma::Row<size_t>& labels) const
 {
-  arma::mat scores;
+  DenseMatType scores;
   Classify(data, labels, scores);
 }
 
@@ -157,7 +181,7 @@ template <typename MatType>
 void LinearSVM<MatType>::Classify(
     const MatType& data,
     arma::Row<size_t>& labels,
-    arma::mat& scores) const
+    DenseMatType& scores) const
 {
   Classify(data, scores);
 
@@ -171,7 +195,7 @@ void LinearSVM<MatType>::Classify(
 template <typename MatType>
 void LinearSVM<MatType>::Classify(
     const MatType& data,
-    arma::mat& scores) const
+    DenseMatType& scores) const
 {
   util::CheckSameDimensionality(data, FeatureSize(), "LinearSVM::Classify()");
 
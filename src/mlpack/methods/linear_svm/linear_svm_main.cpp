@@ -62,12 +62,16 @@ BINDING_LONG_DESC(
     "be specified with the " + PRINT_PARAM_STRING("delta") + " option."
     "The optimizer used to train the model can be specified with the " +
     PRINT_PARAM_STRING("optimizer") + " parameter.  Available options are "
-    "'psgd' (parallel stochastic gradient descent) and 'lbfgs' (the L-BFGS"
-    " optimizer).  There are also various parameters for the optimizer; the " +
+    "'psgd' (parallel stochastic gradient descent), 'lbfgs' (the L-BFGS"
+    " optimizer) and 'dcd' (dual coordinate descent, which trains a "
+    "one-vs-rest model and is usually the fastest for large or sparse "
+    "datasets).  There are also various parameters for the optimizer; the " +
     PRINT_PARAM_STRING("max_iterations") + " parameter specifies the maximum "
     "number of allowed iterations, and the " +
     PRINT_PARAM_STRING("tolerance") + " parameter specifies the tolerance for "
-    "convergence.  For the parallel SGD optimizer, the " +
+    "convergence (for 'dcd', the default tolerance is 0.1, the largest "
+    "allowed violation of the optimality conditions).  For the parallel SGD "
+    "optimizer, the " +
     PRINT_PARAM_STRING("step_size") + " parameter controls the step size taken "
     "at each iteration by the optimizer and the maximum number of epochs "
     "(specified with " + PRINT_PARAM_STRING("epochs") + "). If the "
@@ -125,8 +129,8 @@ PARAM_INT_IN("num_classes", "Number of classes for classification; if "
     "unspecified (or 0), the number of classes found in the labels will be "
     "used.", "c", 0);
 PARAM_FLAG("no_intercept", "Do not add the intercept term to the model.", "N");
-PARAM_STRING_IN("optimizer", "Optimizer to use for training ('lbfgs' or "
-    "'psgd').", "O", "lbfgs");
+PARAM_STRING_IN("optimizer", "Optimizer to use for training ('lbfgs', "
+    "'psgd' or 'dcd').", "O", "lbfgs");
 PARAM_DOUBLE_IN("tolerance", "Convergence tolerance for optimizer.", "e",
     1e-10);
 PARAM_INT_IN("max_iterations", "Maximum iterations for optimizer (0 indicates "
@@ -206,7 +210,7 @@ static void mlpackMain()
       true, "tolerance must be non-negative");
 
   // Optimizer has to be L-BFGS or parallel SGD.
-  RequireParamInSet<string>("optimizer", { "lbfgs", "psgd" },
+  RequireParamInSet<string>("optimizer", { "lbfgs", "psgd", "dcd" },
       true, "unknown optimizer");
 
   // Epochs needs to be non-negative.
@@ -232,12 +236,12 @@ static void mlpackMain()
     }
   }
 
-  if (optimizerType != "lbfgs")
+  if (optimizerType == "psgd")
   {
     if (IO::HasParam("max_iterations"))
     {
       Log::Warn << PRINT_PARAM_STRING("max_iterations") << " ignored because "
-          << "optimizer type is not 'lbfgs'." << std::endl;
+          << "optimizer type is 'psgd'." << std::endl;
     }
   }
 
@@ -347,10 +351,8 @@ static void mlpackMain()
 
       ens::ConstantStep decayPolicy(stepSize);
 
-      #ifdef HAS_OPENMP
-      size_t threads = omp_get_max_threads();
-      #else
-      size_t threads = 1;
+      const size_t threads = util::NumThreads();
+      #ifndef HAS_OPENMP
       Log::Warn << "Using parallel SGD, but OpenMP support is "
                 << "not available!" << endl;
       #endif
@@ -364,6 +366,17 @@ static void mlpackMain()
       // This will train the model.
       model->svm.Train(trainingSet, labels, numClasses, psgdOpt);
     }
+    else if (optimizerType == "dcd")
+    {
+      DualCoordinateDescent dcdOpt(maxIterations);
+      if (IO::HasParam("tolerance"))
+        dcdOpt.Tolerance() = tolerance;
+
+      Log::Info << "Training model with dual coordinate descent." << endl;
+
+      // This will train the model.
+      model->svm.Train(trainingSet, labels, numClasses, dcdOpt);
+    }
   }
   if (IO::HasParam("test"))
   {
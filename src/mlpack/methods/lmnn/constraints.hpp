@@ -213,6 +213,18 @@ class Constraints
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Calculate the k impostors (and their distances, if outputDistance is not
+  * NULL) of the points in queries[i], which all have the label
+  * uniqueLabels[i].  The classes are handled in parallel, and no reference
+  * tree is built for classes without query points.
+  */
+  void ComputeImpostors(arma::Mat<size_t>& outputNeighbors,
+                        arma::mat* outputDistance,
+                        const arma::mat& dataset,
+                        const arma::vec& norms,
+                        const std::vector<arma::uvec>& queries);
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
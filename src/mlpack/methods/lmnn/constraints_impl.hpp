@@ -171,30 +171,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  ComputeImpostors(outputMatrix, NULL, dataset, norms, indexSame);
 }
 
 // Calculates k differently labeled nearest neighbors. The function
@@ -209,31 +186,8 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(indexSame[i]) = neighbors;
-    outputDistance.cols(indexSame[i]) = distances;
-  }
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, norms,
+      indexSame);
 }
 
 // Calculates k differently labeled nearest neighbors on a
@@ -249,39 +203,13 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+  const arma::Row<size_t> sublabels = labels.cols(begin,
+      begin + batchSize - 1);
+  std::vector<arma::uvec> queries(uniqueLabels.n_elem);
+  for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+    queries[i] = begin + arma::find(sublabels == uniqueLabels[i]);
 
-    // Store impostors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  ComputeImpostors(outputMatrix, NULL, dataset, norms, queries);
 }
 
 // Calculates k differently labeled nearest neighbors & distances on a
@@ -298,40 +226,13 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
-
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
+  const arma::Row<size_t> sublabels = labels.cols(begin,
+      begin + batchSize - 1);
+  std::vector<arma::uvec> queries(uniqueLabels.n_elem);
+  for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+    queries[i] = begin + arma::find(sublabels == uniqueLabels[i]);
 
-    // Store impostors.
-    outputNeighbors.cols(begin + subIndexSame) = neighbors;
-    outputDistance.cols(begin + subIndexSame) = distances;
-  }
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, norms, queries);
 }
 
 // Calculates k differently labeled nearest neighbors & distances over some
@@ -348,39 +249,69 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  const arma::uvec subPoints = points.head(numPoints);
+  const arma::Row<size_t> sublabels = labels.cols(subPoints);
+  std::vector<arma::uvec> queries(uniqueLabels.n_elem);
+  for (size_t i = 0; i < uniqueLabels.n_elem; ++i)
+    queries[i] = subPoints.elem(arma::find(sublabels == uniqueLabels[i]));
 
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
+  ComputeImpostors(outputNeighbors, &outputDistance, dataset, norms, queries);
+}
 
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+// Calculates the impostors of the given points of each class, in parallel over
+// the classes.
+template<typename MetricType>
+void Constraints<MetricType>::ComputeImpostors(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat* outputDistance,
+    const arma::mat& dataset,
+    const arma::vec& norms,
+    const std::vector<arma::uvec>& queries)
+{
+  bool failed = false;
+  std::string error;
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) uniqueLabels.n_elem; ++i)
   {
-    // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    // Don't build a tree for classes without any query points.
+    if (queries[i].n_elem == 0)
+      continue;
 
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; ++j)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
+    try
+    {
+      // Perform KNN search with differently labeled points as reference
+      // set and same class points as query set.
+      KNN knn(dataset.cols(indexDiff[i]));
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      knn.Search(dataset.cols(queries[i]), k, neighbors, distances);
+
+      // Re-order neighbors on the basis of increasing norm in case
+      // of ties among distances.
+      ReorderResults(distances, neighbors, norms);
+
+      // Re-map neighbors to their index.
+      for (size_t j = 0; j < neighbors.n_elem; ++j)
+        neighbors(j) = indexDiff[i].at(neighbors(j));
+
+      // Store impostors.  The query sets of different classes are disjoint.
+      outputNeighbors.cols(queries[i]) = neighbors;
+      if (outputDistance != NULL)
+        outputDistance->cols(queries[i]) = distances;
+    }
+    catch (std::exception& e)
+    {
+      #pragma omp critical
+      {
+        failed = true;
+        error = e.what();
+      }
+    }
   }
+
+  if (failed)
+    throw std::runtime_error(error);
 }
 
 // Generates {data point, target neighbors, impostors} triplets using
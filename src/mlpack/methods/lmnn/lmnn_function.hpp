@@ -251,6 +251,32 @@ class LMNNFunction
                         const arma::mat& transformation,
                         const size_t begin,
                         const size_t batchSize);
+  /**
+  * Transform the dataset with the given transformation and, every range
+  * iterations, recalculate the impostors of the points whose bounds allow them
+  * to have changed.  The norm of the change of the transformation since the
+  * cached evaluations of each point were computed is stored in
+  * transformationDiffs, or -1 if the cache can't be used.
+  */
+  inline void UpdateImpostors(const arma::mat& transformation,
+                              arma::vec& transformationDiffs);
+  //! Like UpdateImpostors(), but only for the points of a batch.
+  inline void UpdateImpostors(const arma::mat& transformation,
+                              const size_t begin,
+                              const size_t batchSize,
+                              arma::vec& transformationDiffs);
+  /**
+  * Calculate the cost of the points [begin, begin + batchSize) and, if the
+  * given pointers are not NULL, the gradient terms due to their target
+  * neighbors (cij) and to their active triplets (cil).  The points are handled
+  * in parallel; triplets are skipped when their cached bounds show that they
+  * are inactive.
+  */
+  double ComputeTerms(const size_t begin,
+                      const size_t batchSize,
+                      const arma::vec& transformationDiffs,
+                      arma::mat* cij,
+                      arma::mat* cil);
 };
 
 } // namespace lmnn
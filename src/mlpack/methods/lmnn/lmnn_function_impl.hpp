@@ -212,123 +212,12 @@ inline void LMNNFunction<MetricType>::TransDiff(
 template<typename MetricType>
 double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation)
 {
-  double cost = 0;
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, transformationDiffs);
 
-  // Apply metric over dataset.
-  transformedDataset = transformation * dataset;
-
-  double transformationDiff = 0;
-  if (!transformationOld.is_empty())
-  {
-    // Calculate norm of change in transformation.
-    transformationDiff = arma::norm(transformation - transformationOld);
-  }
-
-  if (!transformationOld.is_empty() && iteration++ % range == 0)
-  {
-    if (impBounds)
-    {
-      // Track number of data points to use for impostors calculatiom.
-      size_t numPoints = 0;
-
-      for (size_t i = 0; i < dataset.n_cols; ++i)
-      {
-        if (transformationDiff * (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++) = i;
-        }
-      }
-
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance,
-          transformedDataset, labels, norm, points, numPoints);
-    }
-    else
-    {
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance, transformedDataset, labels,
-          norm);
-    }
-  }
-  else if (iteration++ % range == 0)
-  {
-    // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance, transformedDataset, labels, norm);
-  }
-
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                          transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
-
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation. Here bp stands for
-      // breaking point.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
-          }
-          else
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
-          }
-        }
-
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
-
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
-
-        cost += regularization * (1 + eval);
-
-        // Reset cache.
-        if (eval > -1)
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-        }
-      }
-    }
-  }
+  const double cost = ComputeTerms(0, dataset.n_cols, transformationDiffs,
+      NULL, NULL);
 
   // Update cache transformation matrix.
   transformationOld = transformation;
@@ -342,122 +231,12 @@ double LMNNFunction<MetricType>::Evaluate(const arma::mat& transformation,
                                           const size_t begin,
                                           const size_t batchSize)
 {
-  double cost = 0;
-
-  // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
-  TransDiff(transformationDiffs, transformation, begin, batchSize);
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, begin, batchSize, transformationDiffs);
 
-  // Apply metric over dataset.
-  transformedDataset = transformation * dataset;
-
-  if (impBounds && iteration++ % range == 0)
-  {
-    // Track number of data points to use for impostors calculatiom.
-    size_t numPoints = 0;
-
-    for (size_t i = begin; i < begin + batchSize; ++i)
-    {
-      if (lastTransformationIndices(i))
-      {
-        if (transformationDiffs[lastTransformationIndices[i]] *
-            (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++)  = i;
-        }
-      }
-      else
-      {
-        points(numPoints++) = i;
-      }
-    }
-
-    // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance,
-        transformedDataset, labels, norm, points, numPoints);
-  }
-  else if (iteration++ % range == 0)
-  {
-    // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance, transformedDataset, labels,
-        norm, begin, batchSize);
-  }
-
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                          transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
-
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation. Here bp stands for
-      // breaking point.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
-          }
-          else
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
-          }
-        }
-
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
-
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
-
-        cost += regularization * (1 + eval);
-
-        // Reset cache.
-        if (eval > -1 && lastTransformationIndices(i))
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
-          lastTransformationIndices(i) = 0;
-        }
-      }
-    }
-  }
+  const double cost = ComputeTerms(begin, batchSize, transformationDiffs,
+      NULL, NULL);
 
   // Update cache.
   UpdateCache(transformation, begin, batchSize);
@@ -471,125 +250,15 @@ template<typename GradType>
 void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
                                         GradType& gradient)
 {
-  // Apply metric over dataset.
-  transformedDataset = transformation * dataset;
-
-  double transformationDiff = 0;
-  if (!transformationOld.is_empty() && iteration++ % range == 0)
-  {
-    // Calculate norm of change in transformation.
-    transformationDiff = arma::norm(transformation - transformationOld);
-
-    if (impBounds)
-    {
-      // Track number of data points to use for impostors calculatiom.
-      size_t numPoints = 0;
-
-      for (size_t i = 0; i < dataset.n_cols; ++i)
-      {
-        if (transformationDiff * (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++) = i;
-        }
-      }
-
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance,
-          transformedDataset, labels, norm, points, numPoints);
-    }
-    else
-    {
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance, transformedDataset, labels,
-          norm);
-    }
-  }
-  else if (iteration++ % range == 0)
-  {
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance, transformedDataset, labels,
-          norm);
-  }
-
-  gradient.zeros(transformation.n_rows, transformation.n_cols);
-
-  // Calculate gradient due to target neighbors.
-  arma::mat cij = pCij;
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, transformationDiffs);
 
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // The gradient due to target neighbors is precalculated.
+  arma::mat cil;
+  ComputeTerms(0, dataset.n_cols, transformationDiffs, NULL, &cil);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-  {
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
-          }
-          else
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
-          }
-        }
-
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
-
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
-
-        // Reset cache.
-        if (eval > -1)
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-        }
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
-      }
-    }
-  }
-
-  gradient = 2 * transformation * ((1 - regularization) * cij +
+  gradient = 2 * transformation * ((1 - regularization) * pCij +
       regularization * cil);
 
   // Update cache transformation matrix.
@@ -604,413 +273,347 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
                                         GradType& gradient,
                                         const size_t batchSize)
 {
-  // Apply metric over dataset.
-  transformedDataset = transformation * dataset;
-
-  // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
-  TransDiff(transformationDiffs, transformation, begin, batchSize);
-
-  if (impBounds && iteration++ % range == 0)
-  {
-    // Track number of data points to use for impostors calculatiom.
-    size_t numPoints = 0;
-
-    for (size_t i = begin; i < begin + batchSize; ++i)
-    {
-      if (lastTransformationIndices(i))
-      {
-        if (transformationDiffs[lastTransformationIndices[i]] *
-            (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++)  = i;
-        }
-      }
-      else
-      {
-        points(numPoints++) = i;
-      }
-    }
-
-    // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance,
-        transformedDataset, labels, norm, points, numPoints);
-  }
-  else if (iteration++ % range == 0)
-  {
-    // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance, transformedDataset, labels,
-        norm, begin, batchSize);
-  }
-
-  gradient.zeros(transformation.n_rows, transformation.n_cols);
-
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, begin, batchSize, transformationDiffs);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
-  {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
+  arma::mat cij, cil;
+  ComputeTerms(begin, batchSize, transformationDiffs, &cij, &cil);
 
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
+  gradient = 2 * transformation * ((1 - regularization) * cij +
+      regularization * cil);
 
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+  // Update cache.
+  UpdateCache(transformation, begin, batchSize);
+}
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+//! Compute cost & gradient over whole dataset.
+template<typename MetricType>
+template<typename GradType>
+double LMNNFunction<MetricType>::EvaluateWithGradient(
+                                   const arma::mat& transformation,
+                                   GradType& gradient)
+{
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, transformationDiffs);
 
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
-          }
-          else
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
-          }
-        }
+  // The gradient due to target neighbors is precalculated.
+  arma::mat cil;
+  const double cost = ComputeTerms(0, dataset.n_cols, transformationDiffs,
+      NULL, &cil);
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+  gradient = 2 * transformation * ((1 - regularization) * pCij +
+      regularization * cil);
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+  // Update cache transformation matrix.
+  transformationOld = transformation;
 
-        // Reset cache.
-        if (eval > -1 && lastTransformationIndices(i))
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
-          lastTransformationIndices(i) = 0;
-        }
+  return cost;
+}
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+//! Compute cost & gradient over a batch of data points.
+template<typename MetricType>
+template<typename GradType>
+double LMNNFunction<MetricType>::EvaluateWithGradient(
+                                   const arma::mat& transformation,
+                                   const size_t begin,
+                                   GradType& gradient,
+                                   const size_t batchSize)
+{
+  // Apply metric over dataset and refresh the impostors, if necessary.
+  arma::vec transformationDiffs;
+  UpdateImpostors(transformation, begin, batchSize, transformationDiffs);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
-      }
-    }
-  }
+  arma::mat cij, cil;
+  const double cost = ComputeTerms(begin, batchSize, transformationDiffs,
+      &cij, &cil);
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
       regularization * cil);
 
   // Update cache.
   UpdateCache(transformation, begin, batchSize);
+
+  return cost;
 }
 
-//! Compute cost & gradient over whole dataset.
+// Transform the dataset and recalculate the impostors every range iterations,
+// for the non-separable objective.
 template<typename MetricType>
-template<typename GradType>
-double LMNNFunction<MetricType>::EvaluateWithGradient(
-                                   const arma::mat& transformation,
-                                   GradType& gradient)
+inline void LMNNFunction<MetricType>::UpdateImpostors(
+    const arma::mat& transformation,
+    arma::vec& transformationDiffs)
 {
-  double cost = 0;
-
   // Apply metric over dataset.
   transformedDataset = transformation * dataset;
 
-  double transformationDiff = 0;
+  // The cached evaluations can only be used if there is a previous
+  // transformation; a negative difference marks them as unusable.
+  double transformationDiff = -1.0;
   if (!transformationOld.is_empty())
   {
     // Calculate norm of change in transformation.
     transformationDiff = arma::norm(transformation - transformationOld);
   }
+  transformationDiffs.set_size(dataset.n_cols);
+  transformationDiffs.fill(transformationDiff);
 
-  if (!transformationOld.is_empty() && iteration++ % range == 0)
+  if (iteration++ % range != 0)
+    return;
+
+  if (!transformationOld.is_empty() && impBounds)
   {
-    if (impBounds)
+    // Only the points whose impostors may have changed, according to the
+    // bounds, are searched again; the reference trees are only built for the
+    // classes of those points.
+    size_t numPoints = 0;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
     {
-      // Track number of data points to use for impostors calculatiom.
-      size_t numPoints = 0;
-
-      for (size_t i = 0; i < dataset.n_cols; ++i)
+      if (transformationDiff * (2 * norm(i) + norm(impostors(k - 1, i)) +
+          norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
       {
-        if (transformationDiff * (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++) = i;
-        }
+        points(numPoints++) = i;
       }
-
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance,
-          transformedDataset, labels, norm, points, numPoints);
     }
-    else
+
+    // Re-calculate impostors on transformed dataset.
+    if (numPoints > 0)
     {
-      // Re-calculate impostors on transformed dataset.
       constraint.Impostors(impostors, distance, transformedDataset, labels,
-          norm);
+          norm, points, numPoints);
     }
   }
-  else if (iteration++ % range == 0)
-  {
-      // Re-calculate impostors on transformed dataset.
-      constraint.Impostors(impostors, distance, transformedDataset, labels,
-          norm);
-  }
-
-  gradient.zeros(transformation.n_rows, transformation.n_cols);
-
-  // Calculate gradient due to target neighbors.
-  arma::mat cij = pCij;
-
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
-
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  else
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
-
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
-      {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
-
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % range == 0)
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
-          }
-          else
-          {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
-          }
-        }
-
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
-
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
-
-        cost += regularization * (1 + eval);
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
-      }
-    }
+    // Re-calculate impostors on transformed dataset.
+    constraint.Impostors(impostors, distance, transformedDataset, labels, norm);
   }
-
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
-
-  // Update cache transformation matrix.
-  transformationOld = transformation;
-
-  return cost;
 }
 
-//! Compute cost & gradient over a batch of data points.
+// Transform the dataset and recalculate the impostors of the batch every range
+// iterations, for the separable objective.
 template<typename MetricType>
-template<typename GradType>
-double LMNNFunction<MetricType>::EvaluateWithGradient(
-                                   const arma::mat& transformation,
-                                   const size_t begin,
-                                   GradType& gradient,
-                                   const size_t batchSize)
+inline void LMNNFunction<MetricType>::UpdateImpostors(
+    const arma::mat& transformation,
+    const size_t begin,
+    const size_t batchSize,
+    arma::vec& transformationDiffs)
 {
-  double cost = 0;
+  // Calculate norm of change in transformation, for each point of the batch.
+  std::map<size_t, double> diffs;
+  TransDiff(diffs, transformation, begin, batchSize);
 
-  // Calculate norm of change in transformation.
-  std::map<size_t, double> transformationDiffs;
-  TransDiff(transformationDiffs, transformation, begin, batchSize);
+  // Points that have no cached transformation can't use the cached
+  // evaluations; a negative difference marks them as unusable.
+  transformationDiffs.set_size(batchSize);
+  for (size_t i = begin; i < begin + batchSize; ++i)
+  {
+    transformationDiffs[i - begin] = (lastTransformationIndices(i) != 0) ?
+        diffs[lastTransformationIndices[i]] : -1.0;
+  }
 
   // Apply metric over dataset.
   transformedDataset = transformation * dataset;
 
-  if (impBounds && iteration++ % range == 0)
+  if (iteration++ % range != 0)
+    return;
+
+  if (impBounds)
   {
-    // Track number of data points to use for impostors calculatiom.
+    // Only the points whose impostors may have changed, according to the
+    // bounds, are searched again.
     size_t numPoints = 0;
-
     for (size_t i = begin; i < begin + batchSize; ++i)
     {
-      if (lastTransformationIndices(i))
-      {
-        if (transformationDiffs[lastTransformationIndices[i]] *
-            (2 * norm(i) + norm(impostors(k - 1, i)) +
-            norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
-        {
-          points(numPoints++)  = i;
-        }
-      }
-      else
+      const double diff = transformationDiffs[i - begin];
+      if (diff < 0.0 || diff * (2 * norm(i) + norm(impostors(k - 1, i)) +
+          norm(impostors(k, i))) > distance(k, i) - distance(k - 1, i))
       {
         points(numPoints++) = i;
       }
     }
 
     // Re-calculate impostors on transformed dataset.
-    constraint.Impostors(impostors, distance,
-        transformedDataset, labels, norm, points, numPoints);
+    if (numPoints > 0)
+    {
+      constraint.Impostors(impostors, distance, transformedDataset, labels,
+          norm, points, numPoints);
+    }
   }
-  else if (iteration++ % range == 0)
+  else
   {
     // Re-calculate impostors on transformed dataset.
     constraint.Impostors(impostors, distance, transformedDataset, labels,
         norm, begin, batchSize);
   }
+}
 
-  gradient.zeros(transformation.n_rows, transformation.n_cols);
-
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+// Calculate the cost and the gradient terms of the points
+// [begin, begin + batchSize).
+template<typename MetricType>
+double LMNNFunction<MetricType>::ComputeTerms(
+    const size_t begin,
+    const size_t batchSize,
+    const arma::vec& transformationDiffs,
+    arma::mat* cij,
+    arma::mat* cil)
+{
+  const size_t d = dataset.n_rows;
+  // Evaluations right after the first impostor search use the distances
+  // returned by the search.
+  const bool useDistances = (iteration - 1 % range == 0);
+
+  // Each thread accumulates its own terms; they are summed in thread order
+  // afterwards, so that the result does not depend on the scheduling.
+  #ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), batchSize));
+  #else
+  const size_t numThreads = 1;
+  #endif
+  std::vector<double> costs(numThreads, 0.0);
+  std::vector<arma::mat> cijs(numThreads), cils(numThreads);
 
-  for (size_t i = begin; i < begin + batchSize; ++i)
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
   {
-    for (size_t j = 0; j < k ; ++j)
+    #ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+    #else
+    const size_t thread = 0;
+    #endif
+
+    double& threadCost = costs[thread];
+    if (cij != NULL)
+      cijs[thread].zeros(d, d);
+    if (cil != NULL)
+      cils[thread].zeros(d, d);
+
+    // The differences of the active triplets of a point are gathered, so that
+    // their outer products are accumulated with a single matrix product.
+    arma::mat targetDiffs(d, k), activeTargets(d, k * k), activeImpostors(d,
+        k * k);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
     {
-      // Calculate cost due to distance between target neighbors & data point.
-      double eval = metric.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
+      const size_t i = begin + b;
+      const double transformationDiff = transformationDiffs[b];
 
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
-
-    for (int j = k - 1; j >= 0; j--)
-    {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (size_t j = 0; j < k ; ++j)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        double eval = 0;
-
-        // Bounds for eval.
-        if (lastTransformationIndices(i) && evalOld(l, j, i) < -1)
-        {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+        // Calculate cost due to distance between target neighbors & data
+        // point.
+        double eval = metric.Evaluate(transformedDataset.col(i),
+                            transformedDataset.col(targetNeighbors(j, i)));
+        threadCost += (1 - regularization) * eval;
+
+        // Calculate gradient due to target neighbors.
+        if (cij != NULL)
+          targetDiffs.col(j) = dataset.col(i) - dataset.col(targetNeighbors(j,
+              i));
+      }
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
-        }
+      if (cij != NULL)
+        cijs[thread] += targetDiffs * targetDiffs.t();
 
-        // Calculate exact eval value.
-        if (eval > -1)
+      size_t numActive = 0;
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation. Here bp stands
+        // for breaking point.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          if (iteration - 1 % range == 0)
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          double eval = 0;
+
+          // Bounds for eval.
+          if (transformationDiff >= 0.0 && evalOld(l, j, i) < -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distance(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = metric.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   metric.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (useDistances)
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distance(l, i);
+            }
+            else
+            {
+              eval = metric.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     metric.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        cost += regularization * (1 + eval);
+          threadCost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+          // Reset cache.
+          evalOld(l, j, i) = 0;
+          maxImpNorm(l, i) = 0;
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+          // Caculate gradient due to impostors.
+          if (cil != NULL)
+          {
+            activeTargets.col(numActive) = dataset.col(i) -
+                dataset.col(targetNeighbors(j, i));
+            activeImpostors.col(numActive) = dataset.col(i) -
+                dataset.col(impostors(l, i));
+            ++numActive;
+          }
+        }
+      }
+
+      if (numActive > 0)
+      {
+        cils[thread] += activeTargets.head_cols(numActive) *
+            activeTargets.head_cols(numActive).t();
+        cils[thread] -= activeImpostors.head_cols(numActive) *
+            activeImpostors.head_cols(numActive).t();
       }
     }
   }
 
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
+  double cost = 0.0;
+  for (size_t t = 0; t < numThreads; ++t)
+    cost += costs[t];
 
-  // Update cache.
-  UpdateCache(transformation, begin, batchSize);
+  if (cij != NULL)
+  {
+    *cij = cijs[0];
+    for (size_t t = 1; t < numThreads; ++t)
+      *cij += cijs[t];
+  }
+
+  if (cil != NULL)
+  {
+    *cil = cils[0];
+    for (size_t t = 1; t < numThreads; ++t)
+      *cil += cils[t];
+  }
 
   return cost;
 }
@@ -118,6 +118,25 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * for the given batch as a sparse matrix, whose only nonzero elements are the
+   * intercept and the features that are nonzero in the batch.  As in Hogwild!,
+   * the regularization is only applied to those features, so that an update
+   * does not touch the rest of the parameters.  This is the overload used by
+   * lock-free parallel optimizers such as optimization::HogwildSGD and
+   * ens::ParallelSGD.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Sparse vector to output gradient into.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -159,6 +178,22 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
+  /**
+   * Compute the log-likelihood of the points in [begin, begin + batchSize)
+   * and, if gradient is not NULL, the gradient of its negation (without the
+   * regularization term).  The points are split into blocks that are processed
+   * in parallel with OpenMP.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point.
+   * @param batchSize Number of points.
+   * @param gradient If not NULL, matrix to store the gradient in.
+   */
+  double LogLikelihood(const arma::mat& parameters,
+                       const size_t begin,
+                       const size_t batchSize,
+                       arma::mat* gradient = NULL) const;
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
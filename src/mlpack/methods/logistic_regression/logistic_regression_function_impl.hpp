@@ -82,20 +82,11 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoid %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  // terms for computational efficiency.
+  const double result = LogLikelihood(parameters, 0, predictors.n_cols);
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -117,16 +108,8 @@ double LogisticRegressionFunction<MatType>::Evaluate(
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
   // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
-      (2 * respD - 1.0)));
+  const double result = LogLikelihood(parameters, begin, batchSize);
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -138,17 +121,11 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const arma::mat& parameters,
     arma::mat& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
+  LogLikelihood(parameters, 0, predictors.n_cols, &gradient);
 
-  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  // Regularization term.
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -161,23 +138,63 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
+  arma::mat batchGradient;
+  LogLikelihood(parameters, begin, batchSize, &batchGradient);
+
   // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
-      / predictors.n_cols * batchSize;
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+  gradient = std::move(batchGradient);
+}
 
-  const arma::rowvec exponents = parameters(0, 0) +
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::sp_mat& gradient,
+    const size_t batchSize) const
+{
+  const size_t end = begin + batchSize - 1;
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
       parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
-  // Calculating the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+      predictors.cols(begin, end))));
+  const arma::rowvec diffs = sigmoids -
+      arma::conv_to<arma::rowvec>::from(responses.subvec(begin, end));
+
+  // Collect one term for the intercept and one for each nonzero element of the
+  // batch; the terms of the same feature are summed by the constructor.
+  const arma::sp_mat batch(predictors.cols(begin, end));
+  arma::umat locations(2, batch.n_nonzero + 1, arma::fill::zeros);
+  arma::vec values(batch.n_nonzero + 1);
+  values[0] = arma::accu(diffs);
+  size_t k = 1;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it, ++k)
+  {
+    locations(1, k) = it.row() + 1;
+    values[k] = diffs[it.col()] * (*it);
+  }
+
+  // Zeros are kept, so that every touched feature is regularized below.
+  const arma::sp_mat loss(true, locations, values, 1, parameters.n_elem, true,
+      false);
+
+  // Add the regularization of the touched features.
+  const double scale = lambda * batchSize / predictors.n_cols;
+  locations.set_size(2, loss.n_nonzero);
+  values.set_size(loss.n_nonzero);
+  k = 0;
+  for (arma::sp_mat::const_iterator it = loss.begin(); it != loss.end();
+       ++it, ++k)
+  {
+    locations(0, k) = 0;
+    locations(1, k) = it.col();
+    values[k] = (*it) + ((it.col() == 0) ? 0.0 :
+        scale * parameters[it.col()]);
+  }
+
+  gradient = arma::sp_mat(locations, values, 1, parameters.n_elem, false);
 }
 
 /**
@@ -212,27 +229,19 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     const arma::mat& parameters,
     GradType& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization = lambda *
-      parameters.tail_cols(parameters.n_elem - 1);
-
   const double objectiveRegularization = lambda / 2.0 *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
+  // Compute the objective function and the gradient from the same sigmoids.
+  arma::mat fullGradient;
+  const double result = LogLikelihood(parameters, 0, predictors.n_cols,
+      &fullGradient);
 
-  gradient.set_size(arma::size(parameters));
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoids %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  // Regularization term.
+  fullGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
+  gradient = std::move(fullGradient);
 
   // Invert the result, because it's a minimization.
   return objectiveRegularization - result;
@@ -246,38 +255,103 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  // Regularization term.
-  arma::mat regularization =
-      lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
-      batchSize;
-
   const double objectiveRegularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+  // Compute the objective function and the gradient from the same sigmoids.
+  arma::mat batchGradient;
+  const double result = LogLikelihood(parameters, begin, batchSize,
+      &batchGradient);
 
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
-      (2 * respD - 1.0)));
+  // Regularization term.
+  batchGradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
+  gradient = std::move(batchGradient);
 
   // Invert the result, because it's a minimization.
   return objectiveRegularization - result;
 }
 
+template<typename MatType>
+double LogisticRegressionFunction<MatType>::LogLikelihood(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat* gradient) const
+{
+  // The points are processed in blocks, so that the temporaries of each block
+  // stay in cache and the blocks can be split between threads.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numBlocks));
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // Each thread accumulates into its own objective and gradient; these are
+  // summed in thread order afterwards, so the result does not depend on the
+  // timing of the threads.
+  std::vector<double> threadResults(numThreads, 0.0);
+  std::vector<arma::rowvec> threadGradients((gradient == NULL) ? 0 :
+      numThreads);
+
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+  {
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+#else
+    const size_t thread = 0;
+#endif
+    if (gradient != NULL)
+      threadGradients[thread].zeros(parameters.n_elem);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t first = begin + b * blockSize;
+      const size_t last = std::min(first + blockSize, begin + batchSize) - 1;
+
+      // Calculate the sigmoid function values.  The intercept term is
+      // parameters(0, 0) and does not need to be multiplied by any of the
+      // predictors.
+      const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+          parameters.tail_cols(parameters.n_elem - 1) *
+          predictors.cols(first, last))));
+      const arma::rowvec respD = arma::conv_to<arma::rowvec>::from(
+          responses.subvec(first, last));
+
+      threadResults[thread] += arma::accu(arma::log(1.0 - respD + sigmoids %
+          (2 * respD - 1.0)));
+
+      if (gradient != NULL)
+      {
+        const arma::rowvec diffs = sigmoids - respD;
+        threadGradients[thread][0] += arma::accu(diffs);
+        threadGradients[thread].tail_cols(parameters.n_elem - 1) += diffs *
+            predictors.cols(first, last).t();
+      }
+    }
+  }
+
+  double result = 0.0;
+  if (gradient != NULL)
+    gradient->zeros(parameters.n_rows, parameters.n_cols);
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    result += threadResults[t];
+    if (gradient != NULL)
+      *gradient += threadGradients[t];
+  }
+
+  return result;
+}
+
 } // namespace regression
 } // namespace mlpack
 
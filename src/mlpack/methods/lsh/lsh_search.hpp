@@ -290,9 +290,28 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the offsets of each row of the second hash table in
+  //! BucketContents(); row i spans [BucketOffsets()[i], BucketOffsets()[i +
+  //! 1]).
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
+
+  //! Get the contents of all the rows of the second hash table, stored
+  //! contiguously.
+  const arma::Col<size_t>& BucketContents() const { return bucketContents; }
+
+  //! Get the second hash table, with one vector per row.  This makes a copy of
+  //! the table; prefer BucketOffsets() and BucketContents().
+  std::vector<arma::Col<size_t>> SecondHashTable() const
+  {
+    std::vector<arma::Col<size_t>> table((bucketOffsets.n_elem > 0) ?
+        bucketOffsets.n_elem - 1 : 0);
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+      table[i] = bucketContents.subvec(bucketOffsets[i],
+          bucketOffsets[i + 1] - 1);
+    }
+    return table;
+  }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -307,25 +326,69 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Buffers used to find the candidates of a query.  Each thread keeps its
+   * own, so that they are not reallocated for every query.
+   */
+  struct ProbingScratch
+  {
+    //! The code of the query in each table.
+    arma::mat queryCodes;
+    //! The second-level hash of each probing bin (one row per bin) in each
+    //! table.
+    arma::Mat<size_t> hashMat;
+    //! The codes of the additional probing bins of one table.
+    arma::mat additionalProbingBins;
+    //! The score of each perturbation, in the original and in sorted order.
+    arma::vec scores;
+    arma::vec sortedScores;
+    //! The perturbations, sorted by score.
+    std::vector<size_t> order;
+    //! The perturbation sets generated for the current table.
+    std::vector<std::vector<bool>> perturbationSets;
+    //! Min-heap of (score, index) pairs of the perturbation sets.
+    std::vector<std::pair<double, size_t>> minHeap;
+    //! The perturbation set being expanded, and its successor.
+    std::vector<bool> current;
+    std::vector<bool> next;
+  };
+
+  /**
+   * Stack the projections and the offsets of the first numTablesToSearch
+   * tables, so that points are hashed into all of them with a single matrix
+   * product: the code of a point in table i (before flooring and division by
+   * the hash width) is rows [i * numProj, (i + 1) * numProj) of
+   * stackedProjections * point + stackedOffsets.
+   *
+   * @param numTablesToSearch The number of tables to stack.
+   * @param stackedProjections Matrix to store the stacked projections in.
+   * @param stackedOffsets Vector to store the stacked offsets in.
+   */
+  void StackProjections(const size_t numTablesToSearch,
+                        arma::mat& stackedProjections,
+                        arma::vec& stackedOffsets) const;
+
+  /**
+   * This function takes the codes of a query in each of the hash tables and
+   * hashes them to buckets of the second hash table, and all the points (if
+   * any) in those buckets are collected as the potential neighbor candidates.
    *
-   * @param queryPoint The query point currently being processed.
+   * @param queryCodesNotFloored The projections of the query in each table
+   *    that is searched (plus the offsets), one column per table.
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
+   *    multiple buckets of the second hash table, in increasing order.
+   * @param candidateFlags Bitmap with one entry per reference point, used to
+   *    discard duplicate candidates.  It must be all false on entry, and it is
+   *    all false again on exit; each thread should use its own.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
+   * @param scratch Buffers to use; each thread should use its own.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
+  void ReturnIndicesFromTable(const arma::mat& queryCodesNotFloored,
                               arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+                              std::vector<bool>& candidateFlags,
+                              const size_t T,
+                              ProbingScratch& scratch) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -378,13 +441,13 @@ class LSHSearch
    * @param queryCodeNotFloored vector containing the projection location of the
    *    query.
    * @param T number of additional probing bins.
-   * @param additionalProbingBins matrix. Each column will hold one additional
-   *    bin.
+   * @param scratch Buffers to use.  On exit, each column of
+   *    scratch.additionalProbingBins holds one additional bin.
   */
   void GetAdditionalProbingBins(const arma::vec& queryCode,
                                 const arma::vec& queryCodeNotFloored,
                                 const size_t T,
-                                arma::mat& additionalProbingBins) const;
+                                ProbingScratch& scratch) const;
 
   /**
    * Returns the score of a perturbation vector generated by perturbation set A.
@@ -450,13 +513,14 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The offsets of each row of the final hash table in bucketContents; there
+  //! are (< secondHashSize) rows, each with (<= bucketSize) elements, and one
+  //! extra offset marking the end of the last row.
+  arma::Col<size_t> bucketOffsets;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The contents of all the rows of the final hash table, stored
+  //! contiguously.
+  arma::Col<size_t> bucketContents;
 
   //! For a particular hash value, points to the row in secondHashTable
   //! corresponding to this value. Length secondHashSize.
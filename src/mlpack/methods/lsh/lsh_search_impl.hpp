@@ -83,8 +83,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +103,8 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -131,8 +131,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -153,8 +153,8 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -254,12 +254,24 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   }
 
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
-
-  for (size_t i = 0; i < numTables; ++i)
+  // vector for table i will be held in column i, so that the entries of each
+  // table are contiguous and ordered by point.
+  const size_t numPoints = this->referenceSet.n_cols;
+  arma::Mat<size_t> secondHashVectors(numPoints, numTables);
+
+  // The points are hashed in blocks, so that the projected keys of all the
+  // tables that are processed at the same time fit in memory.  Each (table,
+  // block) pair is independent, so they are processed in parallel.
+  const size_t blockSize = 65536;
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t task = 0; task < (omp_size_t) (numTables * numBlocks);
+      ++task)
   {
+    const size_t i = task / numBlocks;
+    const size_t begin = (task % numBlocks) * blockSize;
+    const size_t end = std::min(begin + blockSize, numPoints);
+
     // Step IV: create the 'numProj'-dimensional key for each point in each
     // table.
 
@@ -271,10 +283,9 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
-    hashMat += offsetMat;
+    arma::mat hashMat = projections.slice(i).t() *
+        this->referenceSet.cols(begin, end - 1);
+    hashMat.each_col() += offsets.unsafe_col(i);
     hashMat /= hashWidth;
 
     // Step V: Putting the points in the 'secondHashTable' by hashing the key.
@@ -287,61 +298,91 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
       if (unmodVector[j] >= 0.0)
       {
         const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
+        secondHashVectors(begin + j, i) = key;
       }
       else
       {
         const double mod = fmod(-unmodVector[j], shs);
         const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
+        secondHashVectors(begin + j, i) = key;
       }
     }
   }
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
+  // Step VI: build the second hash table in a compressed layout: the contents
+  // of all buckets are stored contiguously in 'bucketContents', and row r of
+  // the table spans [bucketOffsets[r], bucketOffsets[r + 1]).  The entries are
+  // split into contiguous chunks, one per thread; each chunk counts its keys,
+  // and then writes its points after those of the previous chunks, so that
+  // every bucket keeps the points in (table, point) order regardless of the
+  // number of threads.
+  const size_t numEntries = secondHashVectors.n_elem;
+  size_t numChunks = 1;
+  #ifdef HAS_OPENMP
+    numChunks = (size_t) omp_get_max_threads();
+  #endif
+  numChunks = std::max((size_t) 1, std::min(numChunks, numEntries / blockSize));
+  const size_t chunkSize = (numEntries + numChunks - 1) / numChunks;
+
+  // chunkStarts(b, c) is the number of entries with key b in chunk c; it is
+  // turned into the position of the first such entry within its bucket.
+  arma::Mat<size_t> chunkStarts(secondHashSize, numChunks, arma::fill::zeros);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+  {
+    const size_t end = std::min((c + 1) * chunkSize, numEntries);
+    for (size_t e = c * chunkSize; e < end; ++e)
+      chunkStarts(secondHashVectors[e], c)++;
+  }
 
-  // Enforce the maximum bucket size.
+  // Now, count the number of rows we have in the second hash table, and
+  // enforce the maximum bucket size.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  arma::Col<size_t> secondHashBinCounts(secondHashSize);
+  size_t numRowsInTable = 0;
+  for (size_t b = 0; b < secondHashSize; ++b)
+  {
+    size_t total = 0;
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      const size_t count = chunkStarts(b, c);
+      chunkStarts(b, c) = total;
+      total += count;
+    }
+
+    secondHashBinCounts[b] = std::min(total, effectiveBucketSize);
+    if (secondHashBinCounts[b] > 0)
+      bucketRowInHashTable[b] = numRowsInTable++;
+  }
 
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
+  for (size_t b = 0; b < secondHashSize; ++b)
+  {
+    const size_t row = bucketRowInHashTable[b];
+    if (row < secondHashSize)
+      bucketOffsets[row + 1] = bucketOffsets[row] + secondHashBinCounts[b];
+  }
 
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  // Next we must assign each point in each table to the right row of the
+  // second hash table; points beyond the bucket size are dropped.
+  bucketContents.set_size(bucketOffsets[numRowsInTable]);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    const size_t end = std::min((c + 1) * chunkSize, numEntries);
+    for (size_t e = c * chunkSize; e < end; ++e)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      const size_t hashInd = secondHashVectors[e];
+      const size_t position = chunkStarts(hashInd, c)++;
+      if (position < secondHashBinCounts[hashInd])
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        // The point ID is the position of the entry within its table.
+        bucketContents[bucketOffsets[bucketRowInHashTable[hashInd]] +
+            position] = e % numPoints;
       }
-
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+    }
+  }
 
   Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
             << "maximum length of " << arma::max(secondHashBinCounts) << ", "
@@ -525,48 +566,32 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     const arma::vec& queryCode,
     const arma::vec& queryCodeNotFloored,
     const size_t T,
-    arma::mat& additionalProbingBins) const
+    ProbingScratch& scratch) const
 {
   // No additional bins requested. Our work is done.
   if (T == 0)
     return;
 
-  // Each column of additionalProbingBins is the code of a bin.
+  // Each column of additionalProbingBins is the code of a bin.  Copy the
+  // query's code, then in the end we will add/subtract according to
+  // perturbations we calculated.
+  arma::mat& additionalProbingBins = scratch.additionalProbingBins;
   additionalProbingBins.set_size(numProj, T);
-
-  // Copy the query's code, then in the end we will  add/subtract according
-  // to perturbations we calculated.
-  for (size_t c = 0; c < T; ++c)
-    additionalProbingBins.col(c) = queryCode;
-
-
-  // Calculate query point's projection position.
-  arma::mat projection = queryCodeNotFloored;
-
-  // Use projection to calculate query's distance from hash limits.
-  arma::vec limLow = projection - queryCode * hashWidth;
-  arma::vec limHigh = hashWidth - limLow;
-
-  // Calculate scores. score = distance^2.
-  arma::vec scores(2 * numProj);
-  scores.rows(0, numProj - 1) = arma::pow(limLow, 2);
-  scores.rows(numProj, (2 * numProj) - 1) = arma::pow(limHigh, 2);
-
-  // Actions vector describes what perturbation (-1/+1) corresponds to a score.
-  arma::Col<short int> actions(2 * numProj); // will be [-1 ... 1 ...]
-  actions.rows(0, numProj - 1) = // First numProj rows.
-    -1 * arma::ones< arma::Col<short int> > (numProj); // -1s
-  actions.rows(numProj, (2 * numProj) - 1) = // Last numProj rows.
-    arma::ones< arma::Col<short int> > (numProj); // 1s
-
-
-  // Acting dimension vector shows which coordinate to transform according to
-  // actions (actions are described by actions vector above).
-  arma::Col<size_t> positions(2 * numProj); // Will be [0 1 2 ... 0 1 2 ...].
-  positions.rows(0, numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
-  positions.rows(numProj, 2 * numProj - 1) =
-    arma::linspace< arma::Col<size_t> >(0, numProj - 1, numProj);
+  additionalProbingBins.each_col() = queryCode;
+
+  // Use the query's projection position to calculate its distance from the
+  // hash limits, and calculate scores: score = distance^2.  Perturbation s
+  // subtracts 1 from dimension s if s < numProj, and adds 1 to dimension
+  // s - numProj otherwise.
+  arma::vec& scores = scratch.scores;
+  scores.set_size(2 * numProj);
+  for (size_t p = 0; p < numProj; ++p)
+  {
+    const double limLow = queryCodeNotFloored[p] - queryCode[p] * hashWidth;
+    const double limHigh = hashWidth - limLow;
+    scores[p] = limLow * limLow;
+    scores[numProj + p] = limHigh * limHigh;
+  }
 
   // Special case: No need to create heap for 1 or 2 codes.
   if (T <= 2)
@@ -587,7 +612,7 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     }
 
     // Add or subtract 1 to dimension corresponding to minimum score.
-    additionalProbingBins(positions[minloc], 0) += actions[minloc];
+    additionalProbingBins(minloc % numProj, 0) += (minloc < numProj) ? -1 : 1;
     if (T == 1)
       return; // Done if asked for only 1 code.
 
@@ -612,16 +637,25 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
     }
 
     // Add or subtract 1 to create second-lowest scoring vector.
-    additionalProbingBins(positions[minloc2], 1) += actions[minloc2];
+    additionalProbingBins(minloc2 % numProj, 1) +=
+        (minloc2 < numProj) ? -1 : 1;
     return;
   }
 
   // General case: more than 2 perturbation vectors require use of minheap.
   // Sort everything in increasing order.
-  arma::uvec sortidx = arma::sort_index(scores);
-  scores = scores(sortidx);
-  actions = actions(sortidx);
-  positions = positions(sortidx);
+  std::vector<size_t>& order = scratch.order;
+  order.resize(2 * numProj);
+  for (size_t s = 0; s < order.size(); ++s)
+    order[s] = s;
+  std::sort(order.begin(), order.end(), [&scores](const size_t a,
+      const size_t b) { return scores[a] < scores[b] ||
+      (scores[a] == scores[b] && a < b); });
+
+  arma::vec& sortedScores = scratch.sortedScores;
+  sortedScores.set_size(2 * numProj);
+  for (size_t s = 0; s < order.size(); ++s)
+    sortedScores[s] = scores[order[s]];
 
   // Theory:
   // A probing sequence is a sequence of T probing bins where a query's
@@ -636,106 +670,111 @@ void LSHSearch<SortPolicy, MatType>::GetAdditionalProbingBins(
   // is the next most likely perturbation set.
   // Transform perturbation set to perturbation vector by setting the
   // dimensions specified by the set to queryCode+action (action is {-1, 1}).
+  //
+  // The sets and the heap are kept in the scratch buffers, whose storage is
+  // reused from one table (and one query) to the next.
 
   // Perturbation sets (A) mark with 1 the (score, action, dimension) positions
   // included in a given perturbation vector. Other spaces are 0.
-  std::vector<bool> Ao(2 * numProj);
-  Ao[0] = 1; // Smallest vector includes only smallest score.
-
-  std::vector< std::vector<bool> > perturbationSets;
-  perturbationSets.push_back(Ao); // Storage of perturbation sets.
+  std::vector<std::vector<bool>>& perturbationSets = scratch.perturbationSets;
+  std::vector<std::pair<double, size_t>>& minHeap = scratch.minHeap;
+  const std::greater<std::pair<double, size_t>> heapCmp;
+  size_t numSets = 0;
+  minHeap.clear();
+
+  // Store a new perturbation set and add its score to the minheap.
+  auto pushSet = [&](const std::vector<bool>& A)
+  {
+    if (numSets == perturbationSets.size())
+      perturbationSets.push_back(A);
+    else
+      perturbationSets[numSets] = A;
 
-  std::priority_queue<
-    std::pair<double, size_t>,        // contents: pairs of (score, index)
-    std::vector<                      // container: vector of pairs
-      std::pair<double, size_t>
-      >,
-    std::greater< std::pair<double, size_t> > // comparator of pairs
-  > minHeap; // our minheap
+    minHeap.push_back(std::make_pair(PerturbationScore(A, sortedScores),
+        numSets++));
+    std::push_heap(minHeap.begin(), minHeap.end(), heapCmp);
+  };
 
-  // Start by adding the lowest scoring set to the minheap.
-  minHeap.push(std::make_pair(PerturbationScore(Ao, scores), 0));
+  // Start by adding the lowest scoring set (which includes only the smallest
+  // score) to the minheap.
+  std::vector<bool>& Ai = scratch.current;
+  std::vector<bool>& Aj = scratch.next;
+  Ai.assign(2 * numProj, false);
+  Ai[0] = true;
+  pushSet(Ai);
 
   // Loop invariable: after pvec iterations, additionalProbingBins contains pvec
   // valid codes of the lowest-scoring bins (bins most likely to contain
   // neighbors of the query).
   for (size_t pvec = 0; pvec < T; ++pvec)
   {
-    std::vector<bool> Ai;
     do
     {
       // Get the perturbation set corresponding to the minimum score.
-      Ai = perturbationSets[ minHeap.top().second ];
-      minHeap.pop(); // .top() returns, .pop() removes
-
-      // Shift operation on Ai (replace max with max+1).
-      std::vector<bool> As = Ai;
-
-      // Don't add invalid sets.
-      if (PerturbationShift(As) && PerturbationValid(As))
-      {
-        perturbationSets.push_back(As); // add shifted set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(As, scores),
-            perturbationSets.size() - 1));
-      }
-
-      // Expand operation on Ai (add max+1 to set).
-      std::vector<bool> Ae = Ai;
-
-      // Don't add invalid sets.
-      if (PerturbationExpand(Ae) && PerturbationValid(Ae))
-      {
-        perturbationSets.push_back(Ae); // add expanded set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(Ae, scores),
-            perturbationSets.size() - 1));
-      }
+      std::pop_heap(minHeap.begin(), minHeap.end(), heapCmp);
+      Ai = perturbationSets[minHeap.back().second];
+      minHeap.pop_back();
+
+      // Shift operation on Ai (replace max with max+1); don't add invalid
+      // sets.
+      Aj = Ai;
+      if (PerturbationShift(Aj) && PerturbationValid(Aj))
+        pushSet(Aj);
+
+      // Expand operation on Ai (add max+1 to set); don't add invalid sets.
+      Aj = Ai;
+      if (PerturbationExpand(Aj) && PerturbationValid(Aj))
+        pushSet(Aj);
     } while (!PerturbationValid(Ai)); // Discard invalid perturbations
 
     // Found valid perturbation set Ai. Construct perturbation vector from set.
     for (size_t pos = 0; pos < Ai.size(); ++pos)
     {
       // If Ai[pos] is marked, add action to probing vector.
-      additionalProbingBins(positions(pos), pvec) += Ai[pos] ? actions(pos) : 0;
+      if (Ai[pos])
+      {
+        additionalProbingBins(order[pos] % numProj, pvec) +=
+            (order[pos] < numProj) ? -1 : 1;
+      }
     }
   }
 }
 
 template<typename SortPolicy, typename MatType>
-template<typename VecType>
+void LSHSearch<SortPolicy, MatType>::StackProjections(
+    const size_t numTablesToSearch,
+    arma::mat& stackedProjections,
+    arma::vec& stackedOffsets) const
+{
+  stackedProjections.set_size(numProj * numTablesToSearch, projections.n_rows);
+  for (size_t i = 0; i < numTablesToSearch; ++i)
+  {
+    stackedProjections.rows(i * numProj, (i + 1) * numProj - 1) =
+        projections.slice(i).t();
+  }
+
+  // The offsets are stored column by column, so this puts the offsets of each
+  // table next to each other.
+  stackedOffsets = arma::vectorise(offsets.cols(0, numTablesToSearch - 1));
+}
+
+template<typename SortPolicy, typename MatType>
 void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
+    const arma::mat& queryCodesNotFloored,
     arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+    std::vector<bool>& candidateFlags,
+    const size_t T,
+    ProbingScratch& scratch) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; ++i)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
+  const size_t numTablesToSearch = queryCodesNotFloored.n_cols;
 
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
+  // The query's key in each table is a 'numProj' dimensional integer vector.
+  arma::mat& allProjInTables = scratch.queryCodes;
   allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
-  arma::Mat<size_t> hashMat;
+  arma::Mat<size_t>& hashMat = scratch.hashMat;
   hashMat.set_size(T + 1, numTablesToSearch);
 
   // Compute the primary hash value of each key of the query into a bucket of
@@ -752,17 +791,16 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     for (size_t i = 0; i < numTablesToSearch; ++i)
     {
       // Construct this table's probing sequence of length T.
-      arma::mat additionalProbingBins;
       GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
-                                T,
-                                additionalProbingBins);
+                               queryCodesNotFloored.unsafe_col(i),
+                               T,
+                               scratch);
 
       // Map each probing bin to a bin in secondHashTable (just like we did for
       // the primary hash table).
       hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
         arma::conv_to< arma::Col<size_t> >:: // floor by typecasting to size_t
-        from(secondHashWeights.t() * additionalProbingBins);
+        from(secondHashWeights.t() * scratch.additionalProbingBins);
       for (size_t p = 1; p < T + 1; ++p)
         hashMat(p, i) = (hashMat(p, i) % secondHashSize);
     }
@@ -776,82 +814,47 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // count bucket contents
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
+  // Retrieve the candidates, keeping only one copy of each.  The bitmap marks
+  // the points already found for this query; it is owned by the calling
+  // thread, so it is not reallocated for every query.
+  referenceIndices.set_size(maxNumPoints);
+  size_t numCandidates = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t hashInd = hashMat(p, i); // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+      if (tableRow < secondHashSize)
+      {
+        for (size_t j = bucketOffsets[tableRow];
+             j < bucketOffsets[tableRow + 1]; ++j)
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          const size_t index = bucketContents[j];
+          if (!candidateFlags[index])
+          {
+            candidateFlags[index] = true;
+            referenceIndices[numCandidates++] = index;
+          }
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
-  {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
-
-    // Retrieve candidates.
-    size_t start = 0;
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
-    {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
-
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
-      }
-    }
+  // Clear the bitmap for the next query.
+  referenceIndices.resize(numCandidates);
+  for (size_t j = 0; j < numCandidates; ++j)
+    candidateFlags[referenceIndices[j]] = false;
 
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
-  }
+  // Return the candidates in order, so that the base case visits the
+  // reference set sequentially.
+  std::sort(referenceIndices.begin(), referenceIndices.end());
 }
 
 // Search for nearest neighbors in a given query set.
@@ -903,31 +906,60 @@ void LSHSearch<SortPolicy, MatType>::Search(
 
   size_t avgIndicesReturned = 0;
 
+  // Decide on the number of tables to look into: if no user input is given,
+  // search all, and never search more than the existing number of tables.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // The queries are hashed in blocks, with a single matrix product for all
+  // the tables.
+  arma::mat stackedProjections;
+  arma::vec stackedOffsets;
+  StackProjections(tablesToSearch, stackedProjections, stackedOffsets);
+  const size_t blockSize = 256;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
+  // Parallelization to process more than one block of queries at a time.
+  #pragma omp parallel shared(resultingNeighbors, distances) \
       reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // Each thread marks the candidates of its current query in its own
+    // bitmap, and keeps its own buffers.
+    std::vector<bool> candidateFlags(referenceSet.n_cols, false);
+    ProbingScratch scratch;
+    arma::mat blockCodes;
     arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+      // Project the block of queries in all the tables.
+      blockCodes = stackedProjections * querySet.cols(begin, end - 1);
+      blockCodes.each_col() += stackedOffsets;
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        // Hash every query into every hash table and eventually into the
+        // 'secondHashTable' to obtain the neighbor candidates.
+        const arma::mat queryCodes(blockCodes.colptr(i - begin), numProj,
+            tablesToSearch, false, true);
+        ReturnIndicesFromTable(queryCodes, refIndices, candidateFlags,
+            Teffective, scratch);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += refIndices.n_elem;
+
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -969,31 +1001,61 @@ Search(const size_t k,
 
   size_t avgIndicesReturned = 0;
 
+  // Decide on the number of tables to look into: if no user input is given,
+  // search all, and never search more than the existing number of tables.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
+  // The queries are hashed in blocks, with a single matrix product for all
+  // the tables.
+  arma::mat stackedProjections;
+  arma::vec stackedOffsets;
+  StackProjections(tablesToSearch, stackedProjections, stackedOffsets);
+  const size_t blockSize = 256;
+  const size_t numBlocks = (referenceSet.n_cols + blockSize - 1) / blockSize;
+
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
+  // Parallelization to process more than one block of queries at a time.
+  #pragma omp parallel shared(resultingNeighbors, distances) \
       reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
+    // Each thread marks the candidates of its current query in its own
+    // bitmap, and keeps its own buffers.
+    std::vector<bool> candidateFlags(referenceSet.n_cols, false);
+    ProbingScratch scratch;
+    arma::mat blockCodes;
     arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) referenceSet.n_cols);
+
+      // Project the block of queries in all the tables.
+      blockCodes = stackedProjections * referenceSet.cols(begin, end - 1);
+      blockCodes.each_col() += stackedOffsets;
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        // Hash every query into every hash table and eventually into the
+        // 'secondHashTable' to obtain the neighbor candidates.
+        const arma::mat queryCodes(blockCodes.colptr(i - begin), numProj,
+            tablesToSearch, false, true);
+        ReturnIndicesFromTable(queryCodes, refIndices, candidateFlags,
+            Teffective, scratch);
+
+        // An informative book-keeping for the number of neighbor candidates
+        // returned on average.
+        avgIndicesReturned += refIndices.n_elem;
+
+        // Sequentially go through all the candidates and save the best 'k'
+        // candidates.
+        BaseCase(i, refIndices, k, resultingNeighbors, distances);
+      }
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -1050,8 +1112,8 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
+  ar(CEREAL_NVP(bucketOffsets));
+  ar(CEREAL_NVP(bucketContents));
   ar(CEREAL_NVP(bucketRowInHashTable));
   ar(CEREAL_NVP(distanceEvaluations));
 }
@@ -19,12 +19,19 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values,
-                                   const size_t r) :
+                                   const size_t r,
+                                   const MatrixCompletionSolver solver) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+    solver(solver),
+    lambda(1e-6),
+    maxIterations(1000),
+    tolerance(1e-9),
+    sdp(solver == SDP_SOLVER ? indices.n_cols : 0, 0,
+        arma::randu<arma::mat>(m + n, r))
 {
   CheckValues();
-  InitSDP();
+  if (solver == SDP_SOLVER)
+    InitSDP();
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
@@ -33,6 +40,10 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
     m(m), n(n), indices(indices), values(values),
+    solver(SDP_SOLVER),
+    lambda(1e-6),
+    maxIterations(1000),
+    tolerance(1e-9),
     sdp(indices.n_cols, 0, initialPoint)
 {
   CheckValues();
@@ -42,13 +53,19 @@ MatrixCompletion::MatrixCompletion(const size_t m,
 MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
-                                   const arma::vec& values) :
+                                   const arma::vec& values,
+                                   const MatrixCompletionSolver solver) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0,
+    solver(solver),
+    lambda(1e-6),
+    maxIterations(1000),
+    tolerance(1e-9),
+    sdp(solver == SDP_SOLVER ? indices.n_cols : 0, 0,
         arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
 {
   CheckValues();
-  InitSDP();
+  if (solver == SDP_SOLVER)
+    InitSDP();
 }
 
 void MatrixCompletion::CheckValues()
@@ -92,12 +109,111 @@ void MatrixCompletion::InitSDP()
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
+  if (solver == ALS_SOLVER)
+  {
+    arma::mat u, v;
+    RecoverALS(u, v);
+    recovered = u * trans(v);
+    return;
+  }
+
   recovered = sdp.Function().GetInitialPoint();
   sdp.Optimize(recovered);
   recovered = recovered * trans(recovered);
   recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
 }
 
+void MatrixCompletion::Recover(arma::mat& u, arma::mat& v)
+{
+  if (solver == ALS_SOLVER)
+  {
+    RecoverALS(u, v);
+    return;
+  }
+
+  // The completed matrix is the upper right block of R R^T.
+  arma::mat r = sdp.Function().GetInitialPoint();
+  sdp.Optimize(r);
+  u = r.rows(0, m - 1);
+  v = r.rows(m, m + n - 1);
+}
+
+void MatrixCompletion::RecoverALS(arma::mat& u, arma::mat& v)
+{
+  // The factors are stored transposed, so that the factor of each row (or
+  // column) is contiguous.
+  const arma::mat& initialPoint = sdp.Function().GetInitialPoint();
+  arma::mat uTrans = trans(initialPoint.rows(0, m - 1));
+  arma::mat vTrans = trans(initialPoint.rows(m, m + n - 1));
+
+  // Column j of byColumn holds the known entries of column j of the matrix,
+  // and column i of byRow holds the known entries of row i.  Known entries
+  // that are zero are kept.
+  const arma::sp_mat byColumn(indices, arma::vec(values), m, n, true, false);
+  const arma::sp_mat byRow(arma::flipud(indices), arma::vec(values), n, m,
+      true, false);
+
+  double lastObjective = DBL_MAX;
+  for (size_t i = 0; i != maxIterations; ++i)
+  {
+    SolveLeastSquares(byRow, vTrans, uTrans);
+    SolveLeastSquares(byColumn, uTrans, vTrans);
+
+    double objective = lambda *
+        (arma::accu(arma::square(uTrans)) + arma::accu(arma::square(vTrans)));
+    #pragma omp parallel for reduction(+:objective) schedule(dynamic, 64)
+    for (omp_size_t j = 0; j < (omp_size_t) n; ++j)
+    {
+      for (arma::sp_mat::const_iterator it = byColumn.begin_col(j);
+           it != byColumn.end_col(j); ++it)
+      {
+        const double error = arma::dot(uTrans.col(it.row()), vTrans.col(j)) -
+            (*it);
+        objective += error * error;
+      }
+    }
+
+    Log::Info << "MatrixCompletion: ALS iteration " << (i + 1) << ", objective "
+        << objective << "." << std::endl;
+
+    if (lastObjective - objective < tolerance * objective)
+      break;
+    lastObjective = objective;
+  }
+
+  u = trans(uTrans);
+  v = trans(vTrans);
+}
+
+void MatrixCompletion::SolveLeastSquares(const arma::sp_mat& observed,
+                                         const arma::mat& fixed,
+                                         arma::mat& result) const
+{
+  const size_t rank = fixed.n_rows;
+  result.set_size(rank, observed.n_cols);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) observed.n_cols; ++j)
+  {
+    arma::mat gram = lambda * arma::eye<arma::mat>(rank, rank);
+    arma::vec rhs(rank, arma::fill::zeros);
+    for (arma::sp_mat::const_iterator it = observed.begin_col(j);
+         it != observed.end_col(j); ++it)
+    {
+      gram += fixed.col(it.row()) * trans(fixed.col(it.row()));
+      rhs += (*it) * fixed.col(it.row());
+    }
+
+    // The system is singular only if there is no regularization and too few
+    // known entries; then nothing is known about this factor.
+    arma::vec solution;
+    if (arma::solve(solution, gram, rhs))
+      result.col(j) = solution;
+    else
+      result.col(j).zeros();
+  }
+}
+
 size_t MatrixCompletion::DefaultRank(const size_t m,
                                      const size_t n,
                                      const size_t p)
@@ -19,6 +19,16 @@
 namespace mlpack {
 namespace matrix_completion {
 
+//! The solvers that MatrixCompletion can recover the matrix with.
+enum MatrixCompletionSolver
+{
+  //! Solve the nuclear norm minimization SDP with LRSDP.  This recovers the
+  //! matrix exactly, but it is only practical for a few thousand rows.
+  SDP_SOLVER,
+  //! Alternating least squares over the known entries only.
+  ALS_SOLVER
+};
+
 /**
  * This class implements the popular nuclear norm minimization heuristic for
  * matrix completion problems. That is, given known values M_ij's, the
@@ -48,6 +58,25 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
+ * Since the SDP grows with m + n, MatrixCompletion can also use alternating
+ * least squares (ALS_SOLVER) on the known entries instead.  The completed
+ * matrix is then X = U V^T, with U (m x r) and V (n x r) minimizing
+ *
+ *   sum_{(i, j) known} (U_i V_j^T - M_ij)^2 + lambda (||U||_F^2 + ||V||_F^2),
+ *
+ * whose minimum is also the minimum of sum (X_ij - M_ij)^2 + 2 lambda ||X||_*
+ * over the matrices X of rank at most r (Hastie et al., "Matrix completion and
+ * low-rank SVD via fast alternating least squares", JMLR 16, 2015).  Each
+ * half-step solves one small r x r ridge regression per row (or column), in
+ * parallel; the cost of an iteration is linear in the number of known entries,
+ * and the known entries are only stored once by row and once by column.
+ *
+ * @code
+ * MatrixCompletion mc(m, n, indices, values, 10, ALS_SOLVER);
+ * arma::mat u, v;
+ * mc.Recover(u, v); // The completed matrix is u * v.t().
+ * @endcode
+ *
  * @see LRSDP
  */
 class MatrixCompletion
@@ -64,12 +93,14 @@ class MatrixCompletion
    * @param values Vector containing the values of the known entries (must be
    *    length p).
    * @param r Maximum rank of solution.
+   * @param solver Solver to recover the matrix with.
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
                    const arma::umat& indices,
                    const arma::vec& values,
-                   const size_t r);
+                   const size_t r,
+                   const MatrixCompletionSolver solver = SDP_SOLVER);
 
   /**
    * Construct a matrix completion problem, specifying the initial point of the
@@ -98,19 +129,51 @@ class MatrixCompletion
    *    [2 x p]).
    * @param values Vector containing the values of the known entries (must be
    *    length p).
+   * @param solver Solver to recover the matrix with.
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
                    const arma::umat& indices,
-                   const arma::vec& values);
+                   const arma::vec& values,
+                   const MatrixCompletionSolver solver = SDP_SOLVER);
 
   /**
-   * Solve the underlying SDP to fill in the remaining values.
+   * Solve the underlying problem to fill in the remaining values.
    *
    * @param recovered Will contain the completed matrix.
    */
   void Recover(arma::mat& recovered);
 
+  /**
+   * Solve the underlying problem, and return the completed matrix as the
+   * product u * v.t() of two factors of rank r, without forming the m x n
+   * matrix.
+   *
+   * @param u Will contain the left factor (m x r).
+   * @param v Will contain the right factor (n x r).
+   */
+  void Recover(arma::mat& u, arma::mat& v);
+
+  //! Get the solver used to recover the matrix.
+  MatrixCompletionSolver Solver() const { return solver; }
+
+  //! Get the regularization of the ALS solver.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization of the ALS solver.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum number of iterations of the ALS solver (0 means no
+  //! limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the ALS solver.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance of the ALS solver: it stops when the objective improves
+  //! by less than this fraction of its value.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the ALS solver.
+  double& Tolerance() { return tolerance; }
+
   //! Return the underlying SDP.
   const ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() const
   {
@@ -129,7 +192,17 @@ class MatrixCompletion
   //! Vector containing the values of the known entries.
   arma::mat values;
 
-  //! The underlying SDP to be solved.
+  //! The solver used to recover the matrix.
+  MatrixCompletionSolver solver;
+  //! The regularization of the ALS solver.
+  double lambda;
+  //! The maximum number of iterations of the ALS solver.
+  size_t maxIterations;
+  //! The tolerance of the ALS solver.
+  double tolerance;
+
+  //! The underlying SDP to be solved.  With the ALS solver, it has no
+  //! constraints; only its initial point is used.
   ens::LRSDP<ens::SDP<arma::sp_mat>> sdp;
 
   //! Validate the input matrices.
@@ -137,6 +210,30 @@ class MatrixCompletion
   //! Initialize the SDP.
   void InitSDP();
 
+  /**
+   * Recover the factors of the completed matrix with alternating least
+   * squares, starting from the initial point of the SDP.
+   *
+   * @param u Will contain the left factor (m x r).
+   * @param v Will contain the right factor (n x r).
+   */
+  void RecoverALS(arma::mat& u, arma::mat& v);
+
+  /**
+   * Solve the ridge regression of each column of the given matrix of known
+   * entries onto the fixed factor; the factors are stored transposed, so that
+   * column j of the known entries gives column j of the result.  The columns
+   * are solved in parallel.
+   *
+   * @param observed Known entries, with one column per column of the result.
+   * @param fixed The transposed fixed factor (one column per row of
+   *     observed).
+   * @param result Will contain the other transposed factor.
+   */
+  void SolveLeastSquares(const arma::sp_mat& observed,
+                         const arma::mat& fixed,
+                         arma::mat& result) const;
+
   //! Select a rank of the matrix given that is of size m x n and has p known
   //! elements.
   static size_t DefaultRank(const size_t m, const size_t n, const size_t p);
@@ -204,61 +204,112 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Whether or not each seed converged.  (std::vector<bool> can't be written
+  // from multiple threads.)
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // All range searches use the same reference tree, and are run directly with
+  // the single-tree traverser so that many seeds can be shifted at once.
+  typedef range::RangeSearch<>::Tree Tree;
+  typedef range::RangeSearchRules<metric::EuclideanDistance, Tree> RuleType;
+  std::vector<size_t> oldFromNew;
+  Tree referenceTree(data, oldFromNew);
+  const math::Range validRadius(0, radius);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    metric::EuclideanDistance metric;
+    arma::mat query(pSeeds->n_rows, 1);
+    std::vector<std::vector<size_t> > neighbors(1);
+    std::vector<std::vector<double> > distances(1);
+    arma::colvec newCentroid(pSeeds->n_rows);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      // Initial centroid is the seed itself.
+      allCentroids.col(i) = pSeeds->unsafe_col(i);
+      for (size_t completedIterations = 0; completedIterations < maxIterations
+          || forceConvergence; completedIterations++)
+      {
+        query.col(0) = allCentroids.col(i);
+        neighbors[0].clear();
+        distances[0].clear();
+
+        RuleType rules(referenceTree.Dataset(), query, validRadius, neighbors,
+            distances, metric);
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(0, referenceTree);
+        if (neighbors[0].size() == 0) // There are no points in the cluster.
+          break;
+
+        // The tree rearranged its copy of the dataset; map the neighbors back.
+        for (size_t j = 0; j < neighbors[0].size(); ++j)
+          neighbors[0][j] = oldFromNew[neighbors[0][j]];
+
+        // Calculate new centroid.
+        newCentroid.zeros();
+        if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+          newCentroid = allCentroids.unsafe_col(i);
+
+        // If the mean shift vector is small enough, it has converged.
+        if (metric::EuclideanDistance::Evaluate(newCentroid,
+            allCentroids.unsafe_col(i)) < 1e-3 * radius)
+        {
+          converged[i] = 1;
+          break;
+        }
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
+      }
+    }
+  }
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+  std::vector<arma::uword> convergedIndices;
+  for (size_t i = 0; i < converged.size(); ++i)
+    if (converged[i])
+      convergedIndices.push_back(i);
 
-      // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+  centroids.reset();
+  if (!convergedIndices.empty())
+  {
+    // A converged centroid is a duplicate if it is closer than the radius to
+    // an earlier centroid that was kept.  The candidates for each centroid are
+    // found with a single monochromatic range search.
+    const arma::mat candidates = allCentroids.cols(
+        arma::uvec(convergedIndices));
+    range::RangeSearch<> dedupSearcher(candidates);
+    std::vector<std::vector<size_t> > neighbors;
+    std::vector<std::vector<double> > distances;
+    dedupSearcher.Search(validRadius, neighbors, distances);
+
+    std::vector<char> kept(candidates.n_cols, 0);
+    std::vector<arma::uword> keptIndices;
+    for (size_t i = 0; i < candidates.n_cols; ++i)
+    {
+      bool isDuplicated = false;
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        if (neighbors[i][j] < i && kept[neighbors[i][j]] &&
+            distances[i][j] < radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          isDuplicated = true;
+          break;
         }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
-        break;
       }
 
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      if (!isDuplicated)
+      {
+        kept[i] = 1;
+        keptIndices.push_back(i);
+      }
     }
+
+    centroids = candidates.cols(arma::uvec(keptIndices));
   }
 
   // If no centroid has converged due to too little iterations and without
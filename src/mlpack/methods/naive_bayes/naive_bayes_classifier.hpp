@@ -230,6 +230,40 @@ class NaiveBayesClassifier
   //! Small value to prevent log of zero.
   double epsilon;
 
+  /**
+   * Compute the number of points of each class in the given data, the mean of
+   * the points of each class, and the sum of their squared deviations from the
+   * mean.  The points are processed in parallel if OpenMP is available.
+   *
+   * @param data Set of points.
+   * @param labels Labels of the points.
+   * @param counts Column vector to store the number of points of each class in.
+   * @param classMeans Matrix to store the mean of each class in.
+   * @param squares Matrix to store the sum of squared deviations of each class
+   *     in.
+   */
+  template<typename MatType>
+  void ComputeMoments(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      ModelMatType& counts,
+                      ModelMatType& classMeans,
+                      ModelMatType& squares,
+                      const typename std::enable_if<
+                          !arma::is_SpMat<MatType>::value>::type* = 0) const;
+
+  /**
+   * Compute the same moments as the other overload for sparse data, visiting
+   * only the nonzero values of each point.
+   */
+  template<typename MatType>
+  void ComputeMoments(const MatType& data,
+                      const arma::Row<size_t>& labels,
+                      ModelMatType& counts,
+                      ModelMatType& classMeans,
+                      ModelMatType& squares,
+                      const typename std::enable_if<
+                          arma::is_SpMat<MatType>::value>::type* = 0) const;
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
@@ -109,70 +109,193 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   // for each of the features with respect to each of the labels.
   if (incremental)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
+    // Use incremental algorithm.  The counts, means, and sums of squared
+    // deviations of the classes in the new data are merged into the model with
+    // the pairwise update of Chan et al., which gives the same model as adding
+    // the points one at a time.
+    ModelMatType counts, batchMeans, batchSquares;
+    ComputeMoments(data, labels, counts, batchMeans, batchSquares);
+
+    // First, de-normalize probabilities and variances.
     probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
     for (size_t i = 0; i < probabilities.n_elem; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      const ElemType oldCount = probabilities[i];
+      const ElemType newCount = counts[i];
+      if (newCount == 0)
+        continue;
+
+      if (oldCount > 2)
+        variances.col(i) *= (oldCount - 1);
+
+      const ElemType count = oldCount + newCount;
+      const ModelMatType delta = batchMeans.col(i) - means.col(i);
+      means.col(i) += delta * (newCount / count);
+      variances.col(i) += batchSquares.col(i) +
+          arma::square(delta) * (oldCount * newCount / count);
+      probabilities[i] = count;
+
+      if (count > 2)
+        variances.col(i) /= (count - 1);
     }
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
-    means.zeros();
-    variances.zeros();
-
     // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
     // possible to calculate the means and variances using a faster one-pass
     // algorithm but there are some precision and stability issues.  If this is
     // too slow, it's an option to use the faster algorithm by default and then
     // have this (and the incremental algorithm) be other options.
+    ComputeMoments(data, labels, probabilities, means, variances);
+
+    // Normalize variances.
+    for (size_t i = 0; i < probabilities.n_elem; ++i)
+      if (probabilities[i] > 1)
+        variances.col(i) /= (probabilities[i] - 1);
+  }
+
+  // Add epsilon to prevent log of zero.
+  variances += epsilon;
+
+  // The class probabilities are normalized by all the points the model was
+  // trained on.
+  if (incremental)
+    trainingPoints += data.n_cols;
+  else
+    trainingPoints = data.n_cols;
+  probabilities /= trainingPoints;
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::ComputeMoments(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    ModelMatType& counts,
+    ModelMatType& classMeans,
+    ModelMatType& squares,
+    const typename std::enable_if<!arma::is_SpMat<MatType>::value>::type*)
+    const
+{
+  const size_t numClasses = probabilities.n_elem;
+  counts.zeros(numClasses, 1);
+  classMeans.zeros(data.n_rows, numClasses);
+  squares.zeros(data.n_rows, numClasses);
+
+  // Calculate the means.  Each thread sums its own points, and the sums are
+  // added together at the end.
+  #pragma omp parallel
+  {
+    ModelMatType threadCounts(numClasses, 1, arma::fill::zeros);
+    ModelMatType threadSums(data.n_rows, numClasses, arma::fill::zeros);
 
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      ++threadCounts[label];
+      threadSums.col(label) += data.col(j);
     }
 
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+    #pragma omp critical
+    {
+      counts += threadCounts;
+      classMeans += threadSums;
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      classMeans.col(i) /= counts[i];
+
+  // Calculate the sums of squared deviations from the means.
+  #pragma omp parallel
+  {
+    ModelMatType threadSquares(data.n_rows, numClasses, arma::fill::zeros);
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      threadSquares.col(label) += arma::square(data.col(j) -
+          classMeans.col(label));
     }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+    #pragma omp critical
+    squares += threadSquares;
   }
+}
 
-  // Add epsilon to prevent log of zero.
-  variances += epsilon;
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::ComputeMoments(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    ModelMatType& counts,
+    ModelMatType& classMeans,
+    ModelMatType& squares,
+    const typename std::enable_if<arma::is_SpMat<MatType>::value>::type*)
+    const
+{
+  const size_t numClasses = probabilities.n_elem;
+  counts.zeros(numClasses, 1);
+  classMeans.zeros(data.n_rows, numClasses);
+  squares.zeros(data.n_rows, numClasses);
+
+  // Calculate the means, visiting only the nonzero values of each point.
+  #pragma omp parallel
+  {
+    ModelMatType threadCounts(numClasses, 1, arma::fill::zeros);
+    ModelMatType threadSums(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++threadCounts[label];
+      for (typename MatType::const_iterator it = data.begin_col(j);
+           it != data.end_col(j); ++it)
+        threadSums(it.row(), label) += (*it);
+    }
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+    #pragma omp critical
+    {
+      counts += threadCounts;
+      classMeans += threadSums;
+    }
+  }
+
+  // Normalize means.
+  for (size_t i = 0; i < numClasses; ++i)
+    if (counts[i] != 0.0)
+      classMeans.col(i) /= counts[i];
+
+  // Each point contributes m^2 to the sum of squared deviations of a feature
+  // with mean m, plus x (x - 2 m) if its value x for the feature is nonzero;
+  // so the zeros of the points never have to be visited.
+  #pragma omp parallel
+  {
+    ModelMatType threadSquares(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      for (typename MatType::const_iterator it = data.begin_col(j);
+           it != data.end_col(j); ++it)
+      {
+        threadSquares(it.row(), label) += (*it) *
+            ((*it) - 2 * classMeans(it.row(), label));
+      }
+    }
+
+    #pragma omp critical
+    squares += threadSquares;
+  }
+
+  for (size_t i = 0; i < numClasses; ++i)
+    squares.col(i) += counts[i] * arma::square(classMeans.col(i));
 }
 
 template<typename ModelMatType>
@@ -210,24 +333,20 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; ++i)
-  {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        arma::accu(arma::log(variances.col(i))) + exponents);
-  }
+  // The exponent of the Gaussian of class i is the sum over the features of
+  // -(x - mu_i)^2 / (2 sigma_i^2), which expands into products of x and x^2
+  // with the model; so the log likelihoods of all classes are computed with two
+  // matrix products (and sparse data is never densified).
+  const ModelMatType invVar = 1.0 / variances;
+  logLikelihoods = -0.5 * invVar.t() * arma::square(data) +
+      (means % invVar).t() * data;
+
+  // The remaining terms only depend on the class.
+  const ModelMatType classTerms = arma::log(probabilities) +
+      data.n_rows / -2.0 * log(2 * M_PI) -
+      0.5 * arma::sum(arma::log(variances), 0).t() -
+      0.5 * arma::sum(arma::square(means) % invVar, 0).t();
+  logLikelihoods.each_col() += classTerms.col(0);
 }
 
 template<typename ModelMatType>
@@ -325,15 +444,15 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   LogLikelihood(data, logLikelihoods);
 
   predictionProbs.set_size(arma::size(logLikelihoods));
-  double maxValue, logProbX;
-  for (size_t j = 0; j < data.n_cols; ++j)
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
   {
     // The LogLikelihood() gives us the unnormalized log likelihood which is
     // Log(Prob(X|Y)) + Log(Prob(Y)), so we subtract the normalization term.
     // Besides, to prevent underflow in log of sum of exp of x operation (where
     // x is a small negative value), we use logsumexp(x - max(x)) + max(x).
-    maxValue = arma::max(logLikelihoods.col(j));
-    logProbX = log(arma::accu(exp(logLikelihoods.col(j) -
+    const double maxValue = arma::max(logLikelihoods.col(j));
+    const double logProbX = log(arma::accu(exp(logLikelihoods.col(j) -
         maxValue))) + maxValue;
     predictionProbs.col(j) = arma::exp(logLikelihoods.col(j) - logProbX);
   }
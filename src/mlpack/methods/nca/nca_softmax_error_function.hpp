@@ -162,8 +162,8 @@ class SoftmaxErrorFunction
    *
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
-   * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * p_i or p_ij.  The calculation takes O(n^2) time, which is not great, but
+   * it is done in parallel over the points.
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
@@ -68,14 +68,19 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
 {
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
+  // The points of the batch are independent, so they are handled in parallel
+  // and their results are summed in order afterwards.
+  arma::vec results(batchSize, arma::fill::zeros);
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
   {
+    const size_t i = begin + b;
+    double denominator = 0;
+    double numerator = 0;
     for (size_t k = 0; k < dataset.n_cols; ++k)
     {
       // Don't consider the case where the points are the same.
@@ -97,14 +102,16 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
     // denominator is not 0.
     if (denominator == 0.0)
     {
+      #pragma omp critical
       Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
       continue;
     }
 
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
+    // Negate because the optimizer is a minimizer.
+    results[b] = -(numerator / denominator);
   }
-  return result;
+
+  return arma::accu(results);
 }
 
 //! The non-separable implementation, where Precalculate() is used.
@@ -119,38 +126,57 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
   //       sum_{j in class of i} (p_ij x_ij x_ij^T)
   // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
+  // memory-friendly way to calculate this.  Over each pair (i, k) with i < k,
+  // the sum gains w_ik x_ik x_ik^T, where
   //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
-  arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  //   if class of i is the same as the class of k,
+  //     w_ik = ((p_i - 1) p_ik) + ((p_k - 1) p_ki)
+  //   otherwise,
+  //     w_ik = (p_i p_ik + p_k p_ki).
+  //
+  // Since the weights are symmetric, expanding x_ik = x_i - x_k gives
+  //
+  //   sum_{i < k} w_ik x_ik x_ik^T = X diag(s) X^T - (X M^T + M X^T) / 2,
+  //
+  // with s_i = sum_k w_ik and m_i = sum_k w_ik x_k.  s and M are computed in
+  // parallel over the points in O(n^2 d) time; only O(n d^2) work remains.
+  const size_t n = stretchedDataset.n_cols;
+  arma::rowvec s(n);
+  arma::mat m(dataset.n_rows, n);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+    double weightSum = 0.0;
+    arma::vec weightedPoints(dataset.n_rows, arma::fill::zeros);
+    for (size_t k = 0; k < n; ++k)
     {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
+      if (k == (size_t) i)
+        continue;
 
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+      // Calculate p_ik and p_ki first.
+      const double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                               stretchedDataset.unsafe_col(k)));
+      const double p_ik = eval / denominators(i);
+      const double p_ki = eval / denominators(k);
+
+      const double weight = (labels[i] == labels[k]) ?
+          ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) :
+          (p[i] * p_ik + p[k] * p_ki);
+
+      // We are not using stretched points here.
+      weightSum += weight;
+      weightedPoints += weight * dataset.col(k);
     }
+
+    s[i] = weightSum;
+    m.col(i) = weightedPoints;
   }
 
+  arma::mat cross = dataset * m.t();
+  arma::mat sum = (dataset.each_row() % s) * dataset.t() -
+      0.5 * (cross + cross.t());
+
   // Assemble the final gradient.
   gradient = -2 * coordinates * sum;
 }
@@ -163,72 +189,91 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
-
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
+  // For each point i of the batch, the gradient gains
+  //   -2 A (p_i sum_k p_ik x_ik x_ik^T - sum_{j in class i} p_ij x_ij x_ij^T),
+  // which is -2 A X_i diag(c) X_i^T with X_i = X - x_i 1^T and
+  // c_k = p_ik (p_i - [class of k is class of i]).  Each term is then a single
+  // matrix product, and the points of the batch are handled in parallel with
+  // one accumulator per thread.
+  const size_t d = coordinates.n_rows;
 
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; ++i)
+
+  #ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), batchSize));
+  #else
+  const size_t numThreads = 1;
+  #endif
+  std::vector<arma::mat> sums(numThreads, arma::zeros<arma::mat>(d, d));
+
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
   {
-    numerator = 0;
-    denominator = 0;
+    #ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+    #else
+    const size_t thread = 0;
+    #endif
 
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+    arma::rowvec c(dataset.n_cols);
+    arma::mat diffs;
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) batchSize; ++b)
     {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
+      const size_t i = begin + b;
 
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
+      // We will need to calculate p_i before this evaluation is done, so
+      // these two variables will hold the information necessary for that.
+      double numerator = 0;
+      double denominator = 0;
+      for (size_t k = 0; k < dataset.n_cols; ++k)
+      {
+        // Don't consider the case where the points are the same.
+        if (i == k)
+        {
+          c[k] = 0.0;
+          continue;
+        }
+
+        // Calculate the numerator of p_ik.
+        c[k] = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
+                                    stretchedDataset.unsafe_col(k)));
+        if (labels[i] == labels[k])
+          numerator += c[k];
+        denominator += c[k];
+      }
 
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
+      if (denominator == 0)
       {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
+        #pragma omp critical
+        Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+        // If the denominator is zero, then all p_ik should be zero and there
+        // is no gradient contribution from this point.
+        continue;
       }
 
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
-    }
+      // Turn the numerators of p_ik into the weights c_k.
+      const double p = numerator / denominator;
+      for (size_t k = 0; k < dataset.n_cols; ++k)
+      {
+        c[k] *= (labels[i] == labels[k]) ? (p - 1.0) / denominator :
+            p / denominator;
+      }
 
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
-    }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
+      // For x_ik we are not using stretched points.
+      diffs = dataset.each_col() - dataset.col(i);
+      sums[thread] += (diffs.each_row() % c) * diffs.t();
     }
-
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
   }
+
+  arma::mat sum = sums[0];
+  for (size_t t = 1; t < numThreads; ++t)
+    sum += sums[t];
+
+  // We negate the gradient, because our optimizer is a minimizer.
+  gradient = -2 * coordinates * sum;
 }
 
 template<typename MetricType>
@@ -261,28 +306,30 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
   // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
+  // the numerators (the sum for all j in class of i).  Each point is handled
+  // independently in parallel, which evaluates every pair twice but needs no
+  // synchronization; the sums are accumulated in the same order as a single
+  // pass over the pairs would.
   p.zeros(stretchedDataset.n_cols);
   denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
+    for (size_t j = 0; j < stretchedDataset.n_cols; ++j)
     {
+      if (j == (size_t) i)
+        continue;
+
       // Evaluate exp(-d(x_i, x_j)).
       double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
                                          stretchedDataset.unsafe_col(j)));
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
       denominators[i] += eval;
-      denominators[j] += eval;
 
-      // If i and j are the same class, add to numerator of both.
+      // If i and j are the same class, add to the numerator.
       if (labels[i] == labels[j])
-      {
         p[i] += eval;
-        p[j] += eval;
-      }
     }
   }
 
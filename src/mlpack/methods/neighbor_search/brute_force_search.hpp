@@ -0,0 +1,193 @@
+/**
+ * @file methods/neighbor_search/brute_force_search.hpp
+ *
+ * A blocked brute-force neighbor search for the Euclidean distance, which
+ * computes the distances between tiles of query and reference points with
+ * matrix products.  This is used by NeighborSearch in NAIVE_MODE.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The blocked brute-force search, for metrics and matrix types it can be used
+ * with.  By default it can't be used, and Search() returns false; it is
+ * specialized for the (squared) Euclidean distance on dense matrices.
+ *
+ * @tparam SortPolicy The sort policy of the search.
+ * @tparam MetricType The metric of the search.
+ * @tparam MatType The type of the datasets.
+ */
+template<typename SortPolicy, typename MetricType, typename MatType>
+struct BruteForceSearch
+{
+  /**
+   * Return false, since the brute-force search can't be used.
+   */
+  static bool Search(const MatType& /* querySet */,
+                     const MatType& /* referenceSet */,
+                     const size_t /* k */,
+                     const bool /* sameSet */,
+                     arma::Mat<size_t>& /* neighbors */,
+                     arma::mat& /* distances */)
+  {
+    return false;
+  }
+};
+
+/**
+ * The blocked brute-force search for the Euclidean distance on dense matrices.
+ * The query points are split into tiles, which are searched in parallel; for
+ * each tile, the squared distances to a tile of reference points are computed
+ * at once from one matrix product and the squared norms of the points (which
+ * are computed once), and the candidates of each query point are kept in a
+ * bounded heap.  Since the distances given by the matrix product can have a
+ * small rounding error, the distances of the final neighbors are computed
+ * again with the metric, so they are exactly the ones the rules-based search
+ * would give.
+ */
+template<typename SortPolicy, bool TakeRoot, typename eT>
+struct BruteForceSearch<SortPolicy, metric::LMetric<2, TakeRoot>,
+    arma::Mat<eT>>
+{
+  /**
+   * Find the k best neighbors of each query point in the reference set.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet Set of reference points.
+   * @param k Number of neighbors to find.
+   * @param sameSet Whether the query set is the reference set, in which case
+   *     a point isn't returned as its own neighbor.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @return true, since the search can be used.
+   */
+  static bool Search(const arma::Mat<eT>& querySet,
+                     const arma::Mat<eT>& referenceSet,
+                     const size_t k,
+                     const bool sameSet,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances)
+  {
+    typedef std::pair<double, size_t> Candidate;
+    // The heap keeps its worst candidate at the front, like the candidate
+    // lists of NeighborSearchRules.
+    auto candidateCmp = [](const Candidate& c1, const Candidate& c2)
+    {
+      return !SortPolicy::IsBetter(c2.first, c1.first);
+    };
+
+    neighbors.set_size(k, querySet.n_cols);
+    distances.set_size(k, querySet.n_cols);
+    if (k == 0)
+      return true;
+
+    const arma::Row<eT> queryNorms = arma::sum(arma::square(querySet), 0);
+    const arma::Row<eT> referenceNorms = sameSet ? queryNorms :
+        arma::Row<eT>(arma::sum(arma::square(referenceSet), 0));
+
+    // Tiles of this size keep the products of a tile in cache for the
+    // selection of the candidates.
+    const size_t queryTileSize = 256;
+    const size_t referenceTileSize = 1024;
+    const size_t numQueryTiles = (querySet.n_cols + queryTileSize - 1) /
+        queryTileSize;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) numQueryTiles; ++t)
+    {
+      const size_t queryBegin = t * queryTileSize;
+      const size_t queryEnd = std::min(queryBegin + queryTileSize,
+          (size_t) querySet.n_cols);
+
+      std::vector<std::vector<Candidate>> heaps(queryEnd - queryBegin,
+          std::vector<Candidate>(k, Candidate(SortPolicy::WorstDistance(),
+          size_t() - 1)));
+
+      arma::Mat<eT> products;
+      for (size_t referenceBegin = 0; referenceBegin < referenceSet.n_cols;
+          referenceBegin += referenceTileSize)
+      {
+        const size_t referenceEnd = std::min(referenceBegin +
+            referenceTileSize, (size_t) referenceSet.n_cols);
+
+        // Each column holds the products of one query point with the
+        // reference points of the tile.
+        products = referenceSet.cols(referenceBegin, referenceEnd - 1).t() *
+            querySet.cols(queryBegin, queryEnd - 1);
+
+        for (size_t q = 0; q < queryEnd - queryBegin; ++q)
+        {
+          std::vector<Candidate>& heap = heaps[q];
+          const eT* product = products.colptr(q);
+          const double queryNorm = queryNorms[queryBegin + q];
+          for (size_t r = 0; r < referenceEnd - referenceBegin; ++r)
+          {
+            const size_t reference = referenceBegin + r;
+            if (sameSet && reference == queryBegin + q)
+              continue;
+
+            // Rounding can make the distance of close points slightly
+            // negative.
+            const double distance = std::max(0.0, queryNorm +
+                referenceNorms[reference] - 2.0 * product[r]);
+            const Candidate c(TakeRoot ? std::sqrt(distance) : distance,
+                reference);
+            if (candidateCmp(c, heap.front()))
+            {
+              std::pop_heap(heap.begin(), heap.end(), candidateCmp);
+              heap.back() = c;
+              std::push_heap(heap.begin(), heap.end(), candidateCmp);
+            }
+          }
+        }
+      }
+
+      // Compute the distances of the neighbors exactly, and sort them.
+      for (size_t q = 0; q < queryEnd - queryBegin; ++q)
+      {
+        std::vector<Candidate>& heap = heaps[q];
+        for (size_t i = 0; i < k; ++i)
+        {
+          if (heap[i].second != size_t() - 1)
+          {
+            heap[i].first = metric::LMetric<2, TakeRoot>::Evaluate(
+                querySet.col(queryBegin + q),
+                referenceSet.col(heap[i].second));
+          }
+        }
+
+        std::sort(heap.begin(), heap.end(),
+            [](const Candidate& c1, const Candidate& c2)
+            {
+              if (c1.first != c2.first)
+                return SortPolicy::IsBetter(c1.first, c2.first);
+              return c1.second < c2.second;
+            });
+
+        for (size_t i = 0; i < k; ++i)
+        {
+          neighbors(i, queryBegin + q) = heap[i].second;
+          distances(i, queryBegin + q) = heap[i].first;
+        }
+      }
+    }
+
+    return true;
+  }
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
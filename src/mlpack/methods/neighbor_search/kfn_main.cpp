@@ -103,6 +103,9 @@ PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("float32", "Hold and search the reference set in single precision, "
+    "which halves the memory of the model (only valid for kd-trees, ball "
+    "trees, cover trees, vp trees, and random projection trees).", "f");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -127,6 +130,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "float32");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -202,6 +206,14 @@ static void mlpackMain()
         "ub", "oct" }, true, "unknown tree type");
     const string treeType = IO::GetParam<string>("tree_type");
     const bool randomBasis = IO::HasParam("random_basis");
+    const bool singlePrecision = IO::HasParam("float32");
+
+    if (singlePrecision)
+    {
+      RequireParamInSet<string>("tree_type", { "kd", "cover", "ball", "vp",
+          "rp", "max-rp" }, true, "tree type does not support single precision "
+          "(" + PRINT_PARAM_STRING("float32") + ")");
+    }
 
     kfn = new KFNModel();
 
@@ -237,6 +249,7 @@ static void mlpackMain()
 
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->SinglePrecision() = singlePrecision;
     kfn->LeafSize() = size_t(lsInt);
 
     Log::Info << "Using reference data from "
@@ -263,7 +276,7 @@ static void mlpackMain()
 
     Log::Info << "Using kFN model from '"
         << IO::GetPrintableParam<KFNModel*>("input_model") << "' (trained on "
-        << kfn->Dataset().n_rows << "x" << kfn->Dataset().n_cols
+        << kfn->Dimensionality() << "x" << kfn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
@@ -278,10 +291,10 @@ static void mlpackMain()
       Log::Info << "Using query data from "
           << IO::GetPrintableParam<arma::mat>("query") << "." << endl;
       queryData = std::move(IO::GetParam<arma::mat>("query"));
-      if (queryData.n_rows != kfn->Dataset().n_rows)
+      if (queryData.n_rows != kfn->Dimensionality())
       {
         // Clean memory if needed.
-        const size_t dimensions = kfn->Dataset().n_rows;
+        const size_t dimensions = kfn->Dimensionality();
         if (IO::HasParam("reference"))
           delete kfn;
         Log::Fatal << "Query has invalid dimensions (" << queryData.n_rows <<
@@ -292,10 +305,10 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > kfn->Dataset().n_cols)
+    if (k > kfn->NumReferencePoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumReferencePoints();
       if (IO::HasParam("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -305,10 +318,10 @@ static void mlpackMain()
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!IO::HasParam("query") && k == kfn->Dataset().n_cols)
+    if (!IO::HasParam("query") && k == kfn->NumReferencePoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumReferencePoints();
       if (IO::HasParam("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -23,6 +23,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "stream_search.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -94,11 +95,33 @@ PARAM_MODEL_IN(KNNModel, "input_model", "Pre-trained kNN model.", "m");
 PARAM_MODEL_OUT(KNNModel, "output_model", "If specified, the kNN model will be "
     "output here.", "M");
 
+// The reference set of the model may be updated without rebuilding the tree.
+PARAM_UCOL_IN("delete_reference", "Indices of points to delete from the "
+    "reference set before searching; the points that follow a deleted point "
+    "move down to fill its index.", "");
+PARAM_MATRIX_IN("insert_reference", "Matrix containing points to insert into "
+    "the reference set before searching (after any deletion); they are given "
+    "the next indices of the reference set.", "");
+
 // The user may specify a query file of query points and a number of nearest
 // neighbors to search for.
 PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
 PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 
+// Query sets that don't fit in memory can be streamed from a file instead.
+PARAM_STRING_IN("query_stream", "File containing query points (one per line, "
+    "in CSV or whitespace-separated format) to be read and searched for in "
+    "chunks, for query sets that don't fit in memory; the results are written "
+    "to 'neighbors_stream' and 'distances_stream' as each chunk is finished.",
+    "", "");
+PARAM_STRING_IN("neighbors_stream", "File to write the neighbors of the points "
+    "in 'query_stream' to, one line per query point (CSV format).", "", "");
+PARAM_STRING_IN("distances_stream", "File to write the distances of the "
+    "neighbors of the points in 'query_stream' to, one line per query point "
+    "(CSV format).", "", "");
+PARAM_INT_IN("chunk_size", "Number of query points from 'query_stream' to "
+    "search for at a time.", "", 100000);
+
 // The user may specify the type of tree to use, and a few parameters for tree
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
@@ -115,6 +138,9 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("float32", "Hold and search the reference set in single precision, "
+    "which halves the memory of the model (only valid for kd-trees, ball "
+    "trees, cover trees, vp trees, and random projection trees).", "f");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -135,6 +161,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam({{ "input_model", true }}, "float32");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
   ReportIgnoredParam({{ "input_model", true }}, "rho");
   if (IO::HasParam("input_model") && IO::HasParam("leaf_size"))
@@ -149,7 +176,7 @@ static void mlpackMain()
       "no results will be saved");
 
   // If the user specifies k but no output files, they should be warned.
-  if (IO::HasParam("k"))
+  if (IO::HasParam("k") && !IO::HasParam("query_stream"))
   {
     RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
         "nearest neighbor search results will not be saved");
@@ -161,6 +188,26 @@ static void mlpackMain()
   ReportIgnoredParam({{ "k", false }}, "true_neighbors");
   ReportIgnoredParam({{ "k", false }}, "true_distances");
   ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "query_stream");
+
+  // Streaming mode writes its own output files.
+  RequireOnlyOnePassed({ "query", "query_stream" }, true, "", true);
+  if (IO::HasParam("query_stream"))
+  {
+    RequireAtLeastOnePassed({ "neighbors_stream", "distances_stream" }, false,
+        "nearest neighbor search results will not be saved");
+    ReportIgnoredParam("neighbors", "streaming results go to "
+        "'neighbors_stream'");
+    ReportIgnoredParam("distances", "streaming results go to "
+        "'distances_stream'");
+    ReportIgnoredParam("true_neighbors", "query points are streamed");
+    ReportIgnoredParam("true_distances", "query points are streamed");
+  }
+  ReportIgnoredParam({{ "query_stream", false }}, "neighbors_stream");
+  ReportIgnoredParam({{ "query_stream", false }}, "distances_stream");
+  ReportIgnoredParam({{ "query_stream", false }}, "chunk_size");
+  RequireParamValue<int>("chunk_size", [](int x) { return x > 0; }, true,
+      "chunk size must be positive");
 
   // Sanity check on leaf size.
   RequireParamValue<int>("leaf_size", [](int x) { return x > 0; },
@@ -211,12 +258,20 @@ static void mlpackMain()
     // Get all the parameters.
     const string treeType = IO::GetParam<string>("tree_type");
     const bool randomBasis = IO::HasParam("random_basis");
+    const bool singlePrecision = IO::HasParam("float32");
 
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
         "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
         "max-rp", "ub", "oct" }, true, "unknown tree type");
 
+    if (singlePrecision)
+    {
+      RequireParamInSet<string>("tree_type", { "kd", "cover", "ball", "vp",
+          "rp", "max-rp" }, true, "tree type does not support single precision "
+          "(" + PRINT_PARAM_STRING("float32") + ")");
+    }
+
     knn = new KNNModel();
 
     if (treeType == "kd")
@@ -252,6 +307,7 @@ static void mlpackMain()
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
+    knn->SinglePrecision() = singlePrecision;
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
@@ -280,10 +336,50 @@ static void mlpackMain()
 
     Log::Info << "Loaded kNN model from '"
         << IO::GetPrintableParam<KNNModel*>("input_model") << "' (trained on "
-        << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
+        << knn->Dimensionality() << "x" << knn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
+  // Update the reference set, if requested.
+  if (IO::HasParam("delete_reference"))
+  {
+    const arma::Col<size_t>& indices =
+        IO::GetParam<arma::Col<size_t>>("delete_reference");
+    if (indices.n_elem > 0 && indices.max() >= knn->NumReferencePoints())
+    {
+      // Clean memory if needed before crashing.
+      const size_t referencePoints = knn->NumReferencePoints();
+      if (IO::HasParam("reference"))
+        delete knn;
+      Log::Fatal << "Invalid reference point index to delete: "
+          << indices.max() << "; there are only " << referencePoints
+          << " reference points." << endl;
+    }
+
+    Log::Info << "Deleting " << indices.n_elem << " reference points." << endl;
+    knn->DeleteReferencePoints(indices);
+  }
+
+  if (IO::HasParam("insert_reference"))
+  {
+    arma::mat insertData =
+        std::move(IO::GetParam<arma::mat>("insert_reference"));
+    if (knn->NumReferencePoints() > 0 &&
+        insertData.n_rows != knn->Dimensionality())
+    {
+      // Clean memory if needed before crashing.
+      const size_t dimensions = knn->Dimensionality();
+      if (IO::HasParam("reference"))
+        delete knn;
+      Log::Fatal << "Inserted points have invalid dimensions ("
+          << insertData.n_rows << "); should be " << dimensions << "!" << endl;
+    }
+
+    Log::Info << "Inserting " << insertData.n_cols << " reference points."
+        << endl;
+    knn->InsertReferencePoints(std::move(insertData));
+  }
+
   // Perform search, if desired.
   if (IO::HasParam("k"))
   {
@@ -295,10 +391,10 @@ static void mlpackMain()
       Log::Info << "Using query data from "
           << IO::GetPrintableParam<arma::mat>("query") << "." << endl;
       queryData = std::move(IO::GetParam<arma::mat>("query"));
-      if (queryData.n_rows != knn->Dataset().n_rows)
+      if (queryData.n_rows != knn->Dimensionality())
       {
         // Clean memory if needed before crashing.
-        const size_t dimensions = knn->Dataset().n_rows;
+        const size_t dimensions = knn->Dimensionality();
         if (IO::HasParam("reference"))
           delete knn;
         Log::Fatal << "Query has invalid dimensions(" << queryData.n_rows <<
@@ -309,10 +405,10 @@ static void mlpackMain()
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
+    if (k > knn->NumReferencePoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumReferencePoints();
       if (IO::HasParam("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -322,10 +418,11 @@ static void mlpackMain()
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!IO::HasParam("query") && k == knn->Dataset().n_cols)
+    if (!IO::HasParam("query") && !IO::HasParam("query_stream") &&
+        k == knn->NumReferencePoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumReferencePoints();
       if (IO::HasParam("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -333,6 +430,32 @@ static void mlpackMain()
           << "not been provided." << endl;
     }
 
+    // In streaming mode, the results are written out chunk by chunk.
+    if (IO::HasParam("query_stream"))
+    {
+      const string queryFile = IO::GetParam<string>("query_stream");
+      Log::Info << "Streaming query data from '" << queryFile << "' in chunks "
+          << "of " << IO::GetParam<int>("chunk_size") << " points." << endl;
+
+      try
+      {
+        StreamSearch(*knn, queryFile, IO::GetParam<string>("neighbors_stream"),
+            IO::GetParam<string>("distances_stream"), k,
+            (size_t) IO::GetParam<int>("chunk_size"));
+      }
+      catch (std::exception& e)
+      {
+        // Clean memory if needed before crashing.
+        if (IO::HasParam("reference"))
+          delete knn;
+        Log::Fatal << "Streaming search failed: " << e.what() << "." << endl;
+      }
+
+      Log::Info << "Search complete." << endl;
+      IO::GetParam<KNNModel*>("output_model") = knn;
+      return;
+    }
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
@@ -20,6 +20,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
@@ -277,6 +278,61 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Insert the given points into the reference set, without rebuilding the
+   * reference tree.  The points are given the indices NumReferencePoints(),
+   * NumReferencePoints() + 1, and so on, and are searched by brute force
+   * alongside the reference tree until the tree is rebuilt.  If rebuild is
+   * true and the number of pending updates is now above RebuildRatio() times
+   * the number of points in the reference tree, Rebuild() is called.
+   *
+   * @param points Points to insert into the reference set.
+   * @param rebuild Whether to rebuild the tree if there are too many pending
+   *     updates.
+   */
+  void InsertReferencePoints(const MatType& points, const bool rebuild = true);
+
+  /**
+   * Delete the points with the given indices from the reference set, without
+   * rebuilding the reference tree.  As with arma::Mat::shed_cols(), the points
+   * that follow a deleted point move down to fill its index.  Deleted points
+   * that are held in the reference tree are skipped by the searches until the
+   * tree is rebuilt.  If rebuild is true and the number of pending updates is
+   * now above RebuildRatio() times the number of points in the reference tree,
+   * Rebuild() is called.
+   *
+   * @param indices Indices of the points to delete from the reference set.
+   * @param rebuild Whether to rebuild the tree if there are too many pending
+   *     updates.
+   */
+  void DeleteReferencePoints(const arma::Col<size_t>& indices,
+                             const bool rebuild = true);
+
+  /**
+   * Rebuild the reference tree (or reference set, for naive search) with all
+   * the inserted points and without the deleted points.  The indices of the
+   * points of the reference set do not change.
+   */
+  void Rebuild();
+
+  /**
+   * Return the current reference set, which is the reference set the model was
+   * trained on with the inserted points appended and the deleted points
+   * removed.  Unlike ReferenceSet(), the points are in the order of their
+   * indices.
+   */
+  MatType MergedReferenceSet() const;
+
+  //! Get the number of points in the current reference set.
+  size_t NumReferencePoints() const;
+
+  //! Get the number of inserted and deleted points that the reference tree
+  //! does not reflect yet.
+  size_t NumPendingUpdates() const;
+
+  //! Return whether there are enough pending updates to rebuild the tree.
+  bool NeedsRebuild() const;
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -311,10 +367,14 @@ class NeighborSearch
 
   //! Return the total number of base case evaluations performed during the last
   //! search.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return statistics.BaseCases(); }
 
   //! Return the number of node combination scores during the last search.
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return statistics.Scores(); }
+
+  //! Get the traversal statistics (base cases, scores, prunes and visited
+  //! nodes) of the last search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
 
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
@@ -326,7 +386,17 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
-  //! Access the reference dataset.
+  //! Get the ratio of pending updates to points in the reference tree above
+  //! which InsertReferencePoints() and DeleteReferencePoints() rebuild the
+  //! tree.
+  double RebuildRatio() const { return rebuildRatio; }
+  //! Modify the ratio of pending updates to points in the reference tree above
+  //! which InsertReferencePoints() and DeleteReferencePoints() rebuild the
+  //! tree.
+  double& RebuildRatio() { return rebuildRatio; }
+
+  //! Access the reference dataset.  This does not reflect any pending inserted
+  //! or deleted points; see MergedReferenceSet().
   const MatType& ReferenceSet() const { return *referenceSet; }
 
   //! Access the reference tree.
@@ -354,15 +424,100 @@ class NeighborSearch
   //! Instantiation of metric.
   MetricType metric;
 
-  //! The total number of base cases.
-  size_t baseCases;
-  //! The total number of scores (applicable for non-naive search).
-  size_t scores;
+  //! The traversal statistics of the last search (only the base cases are
+  //! counted for naive search).
+  tree::TraversalStatistics statistics;
 
   //! If this is true, the reference tree bounds need to be reset on a call to
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! Points inserted into the reference set since the tree was built.
+  MatType insertedReferences;
+  //! The index in the current reference set of each point the tree was built
+  //! on, or size_t(-1) if it was deleted.  This is empty if no point of the
+  //! tree was deleted.
+  std::vector<size_t> currentFromTrained;
+  //! The index in the set the tree was built on of each point of the current
+  //! reference set that is held in the tree.  This is empty if no point of the
+  //! tree was deleted.
+  std::vector<size_t> trainedFromCurrent;
+  //! The ratio of pending updates to tree points that triggers a rebuild.
+  double rebuildRatio;
+
+  //! Convenience typedef for the rules used by the tree traversals.
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  /**
+   * Search the points the reference tree was built on, ignoring any pending
+   * updates.  See Search().
+   */
+  void TrainedSearch(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
+
+  /**
+   * Search the points the reference tree was built on with the given query
+   * tree, ignoring any pending updates.  See Search().
+   */
+  void TrainedSearch(Tree& queryTree,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     bool sameSet);
+
+  /**
+   * Combine the results of a search of the reference tree (which may contain
+   * deleted points, and which must hold k neighbors plus the number of deleted
+   * points, if there are that many) with a brute-force search of the inserted
+   * points, giving the k best neighbors in the current reference set.
+   *
+   * @param querySet Set of query points, in the order of the results.
+   * @param k Number of neighbors to search for.
+   * @param trainedNeighbors Neighbors found in the reference tree.
+   * @param trainedDistances Distances of the neighbors found in the reference
+   *     tree.
+   * @param neighbors Matrix to store the combined neighbors in.
+   * @param distances Matrix to store the combined distances in.
+   */
+  void MergeUpdates(const MatType& querySet,
+                    const size_t k,
+                    const arma::Mat<size_t>& trainedNeighbors,
+                    const arma::mat& trainedDistances,
+                    arma::Mat<size_t>& neighbors,
+                    arma::mat& distances);
+
+  //! Forget all pending updates (when the tree is rebuilt).
+  void ClearUpdates();
+
+  /**
+   * Perform a dual-tree traversal of the given query tree against the
+   * reference tree with the given rules.  If OpenMP is available and more than
+   * one thread can be used, the query tree is split into disjoint subtrees that
+   * are traversed against the reference tree in parallel; each thread uses its
+   * own rules object that shares the candidate lists of the given rules, so
+   * the results are identical to those of the serial traversal.  The number of
+   * threads is controlled in the usual OpenMP way (e.g. OMP_NUM_THREADS).
+   *
+   * @param queryTree Tree built on the query points.
+   * @param rules Rules holding the candidate lists for the query points.
+   */
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
+  /**
+   * Perform a single-tree traversal of the reference tree for each of the
+   * query points held by the given rules, with the given traverser type.  If
+   * OpenMP is available and more than one thread can be used, the query points
+   * are processed in parallel; each thread uses its own rules object and
+   * traverser, sharing the candidate lists of the given rules.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules holding the candidate lists for the query points.
+   */
+  template<typename TraverserType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
   //! The NSModel class should have access to internal members.
   friend class LeafSizeNSWrapper<SortPolicy, TreeType, DualTreeTraversalType,
       SingleTreeTraversalType>;
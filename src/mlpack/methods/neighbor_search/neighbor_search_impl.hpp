@@ -16,7 +16,9 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
+#include "brute_force_search.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
+#include <mlpack/core/tree/query_subtrees.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -45,6 +47,44 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Return whether the query subtrees of the given tree hold disjoint sets of
+//! points, so that they can be traversed concurrently.
+template<typename TreeType>
+bool HasDisjointQuerySubtrees(
+    const TreeType& /* tree */,
+    const typename std::enable_if_t<
+        !tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  return true;
+}
+
+//! Return whether the query subtrees of the given spill tree hold disjoint
+//! sets of points; this is the case if no node of the tree is overlapping (for
+//! instance, if the tree was built with tau = 0).
+template<typename TreeType>
+bool HasDisjointQuerySubtrees(
+    const TreeType& tree,
+    const typename std::enable_if_t<
+        tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  std::stack<const TreeType*> nodes;
+  nodes.push(&tree);
+  while (!nodes.empty())
+  {
+    const TreeType* node = nodes.top();
+    nodes.pop();
+
+    if (node->Overlap())
+      return false;
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+
+  return true;
+}
+
 // Construct the object.
 template<typename SortPolicy,
          typename MetricType,
@@ -66,9 +106,8 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
-    baseCases(0),
-    scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildRatio(0.05)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -93,9 +132,8 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
-    baseCases(0),
-    scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildRatio(0.05)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -119,9 +157,8 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
-    baseCases(0),
-    scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildRatio(0.05)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -153,9 +190,12 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     searchMode(other.searchMode),
     epsilon(other.epsilon),
     metric(other.metric),
-    baseCases(other.baseCases),
-    scores(other.scores),
-    treeNeedsReset(false)
+    statistics(other.statistics),
+    treeNeedsReset(false),
+    insertedReferences(other.insertedReferences),
+    currentFromTrained(other.currentFromTrained),
+    trainedFromCurrent(other.trainedFromCurrent),
+    rebuildRatio(other.rebuildRatio)
 {
   // Nothing else to do.
 }
@@ -177,9 +217,12 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     searchMode(other.searchMode),
     epsilon(other.epsilon),
     metric(std::move(other.metric)),
-    baseCases(other.baseCases),
-    scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    statistics(other.statistics),
+    treeNeedsReset(other.treeNeedsReset),
+    insertedReferences(std::move(other.insertedReferences)),
+    currentFromTrained(std::move(other.currentFromTrained)),
+    trainedFromCurrent(std::move(other.trainedFromCurrent)),
+    rebuildRatio(other.rebuildRatio)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -187,9 +230,9 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
-  other.baseCases = 0;
-  other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
+  other.ClearUpdates();
 }
 
 // Copy operator.
@@ -230,9 +273,12 @@ NeighborSearch<SortPolicy,
   searchMode = other.searchMode;
   epsilon = other.epsilon;
   metric = other.metric;
-  baseCases = other.baseCases;
-  scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = false;
+  insertedReferences = other.insertedReferences;
+  currentFromTrained = other.currentFromTrained;
+  trainedFromCurrent = other.trainedFromCurrent;
+  rebuildRatio = other.rebuildRatio;
 }
 
 // Move operator.
@@ -272,9 +318,12 @@ NeighborSearch<SortPolicy,
   searchMode = other.searchMode;
   epsilon = other.epsilon;
   metric = other.metric;
-  baseCases = other.baseCases;
-  scores = other.scores;
+  statistics = other.statistics;
   treeNeedsReset = other.treeNeedsReset;
+  insertedReferences = std::move(other.insertedReferences);
+  currentFromTrained = std::move(other.currentFromTrained);
+  trainedFromCurrent = std::move(other.trainedFromCurrent);
+  rebuildRatio = other.rebuildRatio;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
@@ -285,9 +334,9 @@ NeighborSearch<SortPolicy,
   other.referenceSet = &other.referenceTree->Dataset();
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
-  other.baseCases = 0;
-  other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
+  other.ClearUpdates();
 }
 
 // Clean memory.
@@ -342,6 +391,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  ClearUpdates();
 }
 
 template<typename SortPolicy,
@@ -371,6 +422,229 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+
+  ClearUpdates();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::InsertReferencePoints(
+    const MatType& points,
+    const bool rebuild)
+{
+  if (points.n_cols == 0)
+    return;
+
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedReferences.n_rows;
+  if (NumReferencePoints() > 0 && points.n_rows != dimensionality)
+  {
+    std::stringstream ss;
+    ss << "Dimensionality of the inserted points (" << points.n_rows << ") "
+        << "does not match the dimensionality of the reference set ("
+        << dimensionality << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (insertedReferences.n_cols == 0)
+    insertedReferences = points;
+  else
+    insertedReferences = arma::join_rows(insertedReferences, points);
+
+  if (rebuild && NeedsRebuild())
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DeleteReferencePoints(
+    const arma::Col<size_t>& indices,
+    const bool rebuild)
+{
+  if (indices.n_elem == 0)
+    return;
+
+  // Deleting the points from the last one down keeps the indices valid.
+  const arma::Col<size_t> sortedIndices = arma::unique(indices);
+  const size_t numPoints = NumReferencePoints();
+  if (sortedIndices[sortedIndices.n_elem - 1] >= numPoints)
+  {
+    std::stringstream ss;
+    ss << "Cannot delete reference point "
+        << sortedIndices[sortedIndices.n_elem - 1] << "; there are only "
+        << numPoints << " points in the reference set";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Start tracking the points of the tree, if this is the first time that one
+  // of them is deleted.
+  const size_t numTrained = numPoints - insertedReferences.n_cols;
+  if (currentFromTrained.empty() && sortedIndices[0] < numTrained)
+  {
+    currentFromTrained.resize(referenceSet->n_cols);
+    trainedFromCurrent.resize(referenceSet->n_cols);
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+    {
+      currentFromTrained[i] = i;
+      trainedFromCurrent[i] = i;
+    }
+  }
+
+  bool deletedTrained = false;
+  for (size_t i = sortedIndices.n_elem; i > 0; --i)
+  {
+    const size_t index = sortedIndices[i - 1];
+    if (index >= numTrained)
+    {
+      insertedReferences.shed_col(index - numTrained);
+    }
+    else
+    {
+      currentFromTrained[trainedFromCurrent[index]] = size_t(-1);
+      deletedTrained = true;
+    }
+  }
+
+  // Renumber the remaining points of the tree.
+  if (deletedTrained)
+  {
+    trainedFromCurrent.clear();
+    for (size_t i = 0; i < currentFromTrained.size(); ++i)
+    {
+      if (currentFromTrained[i] != size_t(-1))
+      {
+        currentFromTrained[i] = trainedFromCurrent.size();
+        trainedFromCurrent.push_back(i);
+      }
+    }
+  }
+
+  if (rebuild && NeedsRebuild())
+    Rebuild();
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Rebuild()
+{
+  Train(MergedReferenceSet());
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MergedReferenceSet() const
+{
+  const size_t dimensionality = (referenceSet->n_cols > 0) ?
+      referenceSet->n_rows : insertedReferences.n_rows;
+  const size_t numTrained = NumReferencePoints() - insertedReferences.n_cols;
+
+  MatType points(dimensionality, NumReferencePoints());
+  for (size_t i = 0; i < referenceSet->n_cols; ++i)
+  {
+    const size_t trained = oldFromNewReferences.empty() ? i :
+        oldFromNewReferences[i];
+    const size_t current = currentFromTrained.empty() ? trained :
+        currentFromTrained[trained];
+    if (current != size_t(-1))
+      points.col(current) = referenceSet->col(i);
+  }
+
+  if (insertedReferences.n_cols > 0)
+    points.cols(numTrained, points.n_cols - 1) = insertedReferences;
+
+  return points;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NumReferencePoints() const
+{
+  const size_t numTrained = currentFromTrained.empty() ? referenceSet->n_cols :
+      trainedFromCurrent.size();
+  return numTrained + insertedReferences.n_cols;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NumPendingUpdates() const
+{
+  const size_t numDeleted = currentFromTrained.empty() ? 0 :
+      referenceSet->n_cols - trainedFromCurrent.size();
+  return numDeleted + insertedReferences.n_cols;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::NeedsRebuild() const
+{
+  const size_t numUpdates = NumPendingUpdates();
+  return (numUpdates > 0) &&
+      (numUpdates > rebuildRatio * referenceSet->n_cols);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ClearUpdates()
+{
+  insertedReferences.reset();
+  currentFromTrained.clear();
+  trainedFromCurrent.clear();
 }
 
 /**
@@ -391,6 +665,183 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     const size_t k,
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
+{
+  if (NumPendingUpdates() == 0)
+  {
+    TrainedSearch(querySet, k, neighbors, distances);
+    return;
+  }
+
+  if (k > NumReferencePoints())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << NumReferencePoints() << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Search the tree for enough neighbors that k of them are left once the
+  // deleted points are skipped.
+  const size_t numDeleted = NumPendingUpdates() - insertedReferences.n_cols;
+  const size_t trainedK = std::min(k + numDeleted,
+      (size_t) referenceSet->n_cols);
+
+  arma::Mat<size_t> trainedNeighbors(trainedK, querySet.n_cols);
+  arma::mat trainedDistances(trainedK, querySet.n_cols);
+  if (trainedK > 0)
+    TrainedSearch(querySet, trainedK, trainedNeighbors, trainedDistances);
+  else
+    statistics.Reset();
+
+  MergeUpdates(querySet, k, trainedNeighbors, trainedDistances, neighbors,
+      distances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    Tree& queryTree,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    bool sameSet)
+{
+  if (NumPendingUpdates() == 0)
+  {
+    TrainedSearch(queryTree, k, neighbors, distances, sameSet);
+    return;
+  }
+
+  if (sameSet)
+    throw std::invalid_argument("cannot call NeighborSearch::Search() with "
+        "sameSet = true while there are pending reference set updates; call "
+        "Rebuild() first");
+
+  if (k > NumReferencePoints())
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << NumReferencePoints() << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  const size_t numDeleted = NumPendingUpdates() - insertedReferences.n_cols;
+  const size_t trainedK = std::min(k + numDeleted,
+      (size_t) referenceSet->n_cols);
+
+  arma::Mat<size_t> trainedNeighbors(trainedK, queryTree.Dataset().n_cols);
+  arma::mat trainedDistances(trainedK, queryTree.Dataset().n_cols);
+  if (trainedK > 0)
+  {
+    TrainedSearch(queryTree, trainedK, trainedNeighbors, trainedDistances,
+        false);
+  }
+  else
+  {
+    statistics.Reset();
+  }
+
+  MergeUpdates(queryTree.Dataset(), k, trainedNeighbors, trainedDistances,
+      neighbors, distances);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::MergeUpdates(
+    const MatType& querySet,
+    const size_t k,
+    const arma::Mat<size_t>& trainedNeighbors,
+    const arma::mat& trainedDistances,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  typedef std::pair<double, size_t> Candidate;
+
+  const size_t numTrained = NumReferencePoints() - insertedReferences.n_cols;
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    candidates.clear();
+
+    // Take the neighbors from the tree that were not deleted.  Missing
+    // neighbors (if the tree had too few points) have an invalid index.
+    for (size_t j = 0; j < trainedNeighbors.n_rows; ++j)
+    {
+      const size_t trained = trainedNeighbors(j, i);
+      if (trained >= referenceSet->n_cols)
+        continue;
+
+      const size_t current = currentFromTrained.empty() ? trained :
+          currentFromTrained[trained];
+      if (current != size_t(-1))
+        candidates.push_back(Candidate(trainedDistances(j, i), current));
+    }
+
+    // Compare against all the inserted points.
+    for (size_t j = 0; j < insertedReferences.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(querySet.col(i),
+          insertedReferences.col(j));
+      candidates.push_back(Candidate(distance, numTrained + j));
+    }
+
+    const size_t numFound = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + numFound,
+        candidates.end(), [](const Candidate& a, const Candidate& b)
+        {
+          return (a.first != b.first) && SortPolicy::IsBetter(a.first,
+              b.first);
+        });
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j < numFound)
+      {
+        neighbors(j, i) = candidates[j].second;
+        distances(j, i) = candidates[j].first;
+      }
+      else
+      {
+        neighbors(j, i) = size_t() - 1;
+        distances(j, i) = SortPolicy::WorstDistance();
+      }
+    }
+  }
+
+  statistics.BaseCases() += querySet.n_cols * insertedReferences.n_cols;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::TrainedSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
 {
   if (k > referenceSet->n_cols)
   {
@@ -402,8 +853,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  statistics.Reset();
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -431,12 +881,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distancePtr->set_size(k, querySet.n_cols);
 
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      statistics.BaseCases() += querySet.n_cols * referenceSet->n_cols;
+
+      // For the Euclidean distance on dense matrices, the blocked brute-force
+      // search is much faster than evaluating each pair with the rules.
+      if (BruteForceSearch<SortPolicy, MetricType, MatType>::Search(querySet,
+          *referenceSet, k, false, *neighborPtr, *distancePtr))
+        break;
+
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
@@ -445,8 +901,6 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
-      baseCases += querySet.n_cols * referenceSet->n_cols;
-
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
@@ -455,20 +909,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      // Traverse for each point.
+      SingleTreeTraversal<SingleTreeTraversalType<RuleType>>(querySet.n_cols,
+          rules);
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -485,18 +930,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      DualTreeTraversal(*queryTree, rules);
 
-      traverser.Traverse(*queryTree, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
 
@@ -508,20 +944,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, metric);
 
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      // Traverse for each point.
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          querySet.n_cols, rules);
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
@@ -599,7 +1026,7 @@ template<typename SortPolicy,
          template<typename> class DualTreeTraversalType,
          template<typename> class SingleTreeTraversalType>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
-DualTreeTraversalType, SingleTreeTraversalType>::Search(
+DualTreeTraversalType, SingleTreeTraversalType>::TrainedSearch(
     Tree& queryTree,
     const size_t k,
     arma::Mat<size_t>& neighbors,
@@ -621,8 +1048,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  statistics.Reset();
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -638,24 +1064,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   distances.set_size(k, querySet.n_cols);
 
   // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraversal(queryTree, rules);
 
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   rules.GetResults(*neighborPtr, distances);
 
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
-
   Timer::Stop("computing_neighbors");
 
   // Do we need to map indices?
@@ -689,6 +1105,47 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
+  if (NumPendingUpdates() > 0)
+  {
+    const size_t numPoints = NumReferencePoints();
+    if (k >= numPoints)
+    {
+      std::stringstream ss;
+      ss << "Requested value of k (" << k << ") is not less than the number "
+          << "of points in the reference set (" << numPoints << ") and no "
+          << "query set has been provided.";
+      throw std::invalid_argument(ss.str());
+    }
+
+    // Search with the current reference set as the query set, and drop each
+    // point from its own results.
+    arma::Mat<size_t> allNeighbors;
+    arma::mat allDistances;
+    Search(MergedReferenceSet(), k + 1, allNeighbors, allDistances);
+
+    neighbors.set_size(k, numPoints);
+    distances.set_size(k, numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      bool skipped = false;
+      size_t found = 0;
+      for (size_t j = 0; j <= k && found < k; ++j)
+      {
+        if (!skipped && allNeighbors(j, i) == i)
+        {
+          skipped = true;
+          continue;
+        }
+
+        neighbors(found, i) = allNeighbors(j, i);
+        distances(found, i) = allDistances(j, i);
+        ++found;
+      }
+    }
+
+    return;
+  }
+
   if (k > referenceSet->n_cols)
   {
     std::stringstream ss;
@@ -707,8 +1164,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   Timer::Start("computing_neighbors");
 
-  baseCases = 0;
-  scores = 0;
+  statistics.Reset();
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -726,38 +1182,39 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   distancePtr->set_size(k, referenceSet->n_cols);
 
   // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
       true /* don't return the same point as nearest neighbor */);
 
+  // Whether the results were found without the rules.
+  bool bruteForce = false;
+
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      statistics.BaseCases() += referenceSet->n_cols * referenceSet->n_cols;
+
+      // For the Euclidean distance on dense matrices, the blocked brute-force
+      // search is much faster than evaluating each pair with the rules.
+      bruteForce = BruteForceSearch<SortPolicy, MetricType, MatType>::Search(
+          *referenceSet, *referenceSet, k, true, *neighborPtr, *distancePtr);
+      if (bruteForce)
+        break;
+
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
-      baseCases += referenceSet->n_cols * referenceSet->n_cols;
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
+      // Traverse for each point.
+      SingleTreeTraversal<SingleTreeTraversalType<RuleType>>(
+          referenceSet->n_cols, rules);
 
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
       break;
     }
     case DUAL_TREE_MODE:
@@ -782,30 +1239,21 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraversal(queryTree, rules);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraversal(*referenceTree, rules);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
@@ -813,25 +1261,17 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      SingleTreeTraversal<tree::GreedySingleTreeTraverser<Tree, RuleType>>(
+          referenceSet->n_cols, rules);
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      Log::Info << "Tree traversal: " << statistics << "." << std::endl;
       break;
     }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
+  if (!bruteForce)
+    rules.GetResults(*neighborPtr, *distancePtr);
 
   Timer::Stop("computing_neighbors");
 
@@ -859,6 +1299,95 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // Spill trees with overlapping nodes may hold a query point in more than one
+  // node, so the subtrees would not be independent.
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1 && HasDisjointQuerySubtrees(queryTree))
+  {
+    // Use a few more tasks than threads so that the load can be balanced.
+    std::vector<Tree*> querySubtrees;
+    tree::QuerySubtrees(queryTree, 4 * numThreads, querySubtrees);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+    {
+      RuleType taskRules(rules, metric);
+      DualTreeTraversalType<RuleType> traverser(taskRules);
+      traverser.Traverse(*querySubtrees[i], *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(taskRules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+
+    return;
+  }
+#endif
+
+  DualTreeTraversalType<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+  statistics.Add(rules, traverser);
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename TraverserType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+#ifdef HAS_OPENMP
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  if (omp_get_max_threads() > 1 && !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    #pragma omp parallel
+    {
+      RuleType taskRules(rules, metric);
+      TraverserType traverser(taskRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(taskRules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+
+    return;
+  }
+#endif
+
+  TraverserType traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+  statistics.Add(rules, traverser);
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -989,11 +1518,16 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     }
   }
 
+  // Serialize the reference set updates that are not in the tree yet.
+  ar(CEREAL_NVP(insertedReferences));
+  ar(CEREAL_NVP(currentFromTrained));
+  ar(CEREAL_NVP(trainedFromCurrent));
+  ar(CEREAL_NVP(rebuildRatio));
+
   // Reset base cases and scores.
   if (cereal::is_loading<Archive>())
   {
-    baseCases = 0;
-    scores = 0;
+    statistics.Reset();
   }
 }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
 
 #include <queue>
 
@@ -54,6 +55,19 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a NeighborSearchRules object that shares the candidate lists of
+   * the given NeighborSearchRules object, but has its own base case cache,
+   * traversal information and statistics.  This is meant for parallel
+   * traversals, where each thread uses its own rules object on a disjoint set
+   * of query points; two threads must never work on the same query point.
+   * Call GetResults() on the original object once all traversals are done.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   * @param metric Instantiated metric.
+   */
+  NeighborSearchRules(NeighborSearchRules& other, MetricType& metric);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -183,8 +197,12 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Storage for the candidate neighbors of each point; this is empty if the
+  //! candidate lists are shared with another rules object.
+  std::vector<CandidateList> ownCandidates;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -205,6 +223,9 @@ class NeighborSearchRules
   //! The last base case result.
   double lastBaseCase;
 
+  //! The distances from the last scored query point to leaves.
+  tree::LeafDistanceCache<MetricType, typename TreeType::Mat> leafDistances;
+
   //! The number of base cases that have been performed.
   size_t baseCases;
   //! The number of scores that have been performed.
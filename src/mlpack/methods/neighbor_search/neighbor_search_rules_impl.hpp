@@ -29,6 +29,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(ownCandidates),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -59,6 +60,28 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other,
+    MetricType& metric) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    metric(metric),
+    sameSet(other.sameSet),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // As in the other constructor, the last query and reference nodes must be
+  // invalid but not NULL.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -84,6 +107,8 @@ inline force_inline // Absolutely MUST be inline so optimizations can happen.
 double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
 BaseCase(const size_t queryIndex, const size_t referenceIndex)
 {
+  MLPACK_PROFILE_SCOPE(TREE_BASE_CASE);
+
   // If the datasets are the same, then this search is only using one dataset
   // and we should not return identical points.
   if (sameSet && (queryIndex == referenceIndex))
@@ -93,8 +118,13 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
     return lastBaseCase;
 
-  double distance = metric.Evaluate(querySet.col(queryIndex),
-                                    referenceSet.col(referenceIndex));
+  double distance;
+  if (!leafDistances.Distance(querySet, referenceSet, queryIndex,
+      referenceIndex, distance))
+  {
+    distance = metric.Evaluate(querySet.col(queryIndex),
+                               referenceSet.col(referenceIndex));
+  }
   ++baseCases;
 
   InsertNeighbor(queryIndex, referenceIndex, distance);
@@ -112,6 +142,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
     TreeType& referenceNode)
 {
+  MLPACK_PROFILE_SCOPE(TREE_SCORE);
   ++scores; // Count number of Score() calls.
   double distance;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -146,8 +177,13 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   double bestDistance = candidates[queryIndex].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(distance, bestDistance)) ?
-      SortPolicy::ConvertToScore(distance) : DBL_MAX;
+  if (!SortPolicy::IsBetter(distance, bestDistance))
+    return DBL_MAX;
+
+  // The points of the node will be visited next, so their distances can be
+  // computed together.
+  leafDistances.Prepare(queryIndex, referenceNode);
+  return SortPolicy::ConvertToScore(distance);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -190,6 +226,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     TreeType& queryNode,
     TreeType& referenceNode)
 {
+  MLPACK_PROFILE_SCOPE(TREE_SCORE);
   ++scores; // Count number of Score() calls.
 
   // Update our bound.
@@ -0,0 +1,248 @@
+/**
+ * @file methods/neighbor_search/nn_descent.hpp
+ *
+ * An implementation of approximate all-k-nearest-neighbor graph construction
+ * with NN-descent, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title={Efficient k-nearest neighbor graph construction for generic
+ *       similarity measures},
+ *   author={Dong, W. and Moses, C. and Li, K.},
+ *   booktitle={Proceedings of the 20th International Conference on World
+ *       Wide Web (WWW '11)},
+ *   pages={577--586},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class computes an approximate k-nearest-neighbor graph of a
+ * dataset: the approximate k nearest neighbors of every point of the dataset,
+ * not counting each point as its own neighbor.  This gives the same result as
+ * the monochromatic NeighborSearch::Search(k, neighbors, distances), but is
+ * much faster for large or high-dimensional datasets.
+ *
+ * NN-descent relies on the observation that a neighbor of a neighbor is likely
+ * to be a neighbor.  Starting from an initial graph, each iteration compares
+ * the neighbors (and reverse neighbors) of each point with each other (the
+ * "local join"), and keeps the closer points it finds.  Only the neighbors that
+ * were found in the previous iteration are joined with each other and with the
+ * older neighbors, and at most sampleRate * k neighbors of each kind are used
+ * per point, which avoids most of the repeated comparisons.  The iterations
+ * stop when fewer than tolerance * k * n neighbors change.
+ *
+ * The initial graph can be random, or can be built from the leaves of a random
+ * projection tree or a spill tree on the dataset: the points of each leaf are
+ * compared with each other, which gives a good initial graph at low cost.
+ *
+ * The local joins use multiple threads when OpenMP is available; with more
+ * than one thread the resulting graph may depend on the order in which the
+ * threads update it.
+ *
+ * @code
+ * NNDescent<> nnDescent;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * nnDescent.Compute(dataset, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for the distances.
+ * @tparam MatType The type of the dataset.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  //! The ways to build the initial graph.
+  enum InitializationType
+  {
+    //! Each point gets k random neighbors.
+    RANDOM_INIT,
+    //! The points of each leaf of a random projection tree are compared.
+    RP_TREE_INIT,
+    //! The points of each leaf of a spill tree are compared.
+    SPILL_TREE_INIT
+  };
+
+  /**
+   * Create the NNDescent object with the given parameters.
+   *
+   * @param initialization How to build the initial graph.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param sampleRate Fraction of the neighbors of each point used by the
+   *     local joins; must be in (0, 1].
+   * @param tolerance The iterations stop when fewer than tolerance * k * n
+   *     neighbors change.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(const InitializationType initialization = RP_TREE_INIT,
+            const size_t maxIterations = 10,
+            const double sampleRate = 0.5,
+            const double tolerance = 0.001,
+            MetricType metric = MetricType());
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the dataset,
+   * not counting each point as its own neighbor.  The output matrices have k
+   * rows and one column per point, sorted from nearest to furthest, like the
+   * output of NeighborSearch::Search().
+   *
+   * @param dataset Set of points.
+   * @param k Number of neighbors to compute; must be less than the number of
+   *     points.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Compute(const MatType& dataset,
+               const size_t k,
+               arma::Mat<size_t>& neighbors,
+               arma::mat& distances);
+
+  //! Get the way the initial graph is built.
+  InitializationType Initialization() const { return initialization; }
+  //! Modify the way the initial graph is built.
+  InitializationType& Initialization() { return initialization; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 means no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the fraction of the neighbors used by the local joins.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the fraction of the neighbors used by the local joins.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the maximum leaf size of the initialization tree.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum leaf size of the initialization tree; leaves always
+  //! hold at least k + 1 points (0 means 2 * (k + 1)).
+  size_t& LeafSize() { return leafSize; }
+
+  //! Get the overlap of the spill tree used for initialization.
+  double Tau() const { return tau; }
+  //! Modify the overlap of the spill tree used for initialization.
+  double& Tau() { return tau; }
+
+  //! Get the number of iterations of the last computation.
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations of the last computation.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  /**
+   * The candidate neighbors of all points, as one max-heap of k candidates per
+   * point.  Updates lock the heap of the updated point.
+   */
+  class NeighborGraph
+  {
+   public:
+    //! Create the graph with k empty candidates for each point.
+    NeighborGraph(const size_t numPoints, const size_t k);
+
+    //! Try to add the given candidate to the heap of the given point; return
+    //! whether it was added.
+    bool Insert(const size_t point,
+                const size_t candidate,
+                const double distance);
+
+    //! Get the index of the j'th candidate of the given point.
+    size_t& Index(const size_t point, const size_t j)
+    { return indices[point * k + j]; }
+    //! Get the distance of the j'th candidate of the given point.
+    double& Distance(const size_t point, const size_t j)
+    { return distances[point * k + j]; }
+    //! Get whether the j'th candidate of the given point is new.
+    char& IsNew(const size_t point, const size_t j)
+    { return isNew[point * k + j]; }
+
+    //! Get the number of candidates of each point.
+    size_t K() const { return k; }
+
+   private:
+    //! The number of candidates of each point.
+    size_t k;
+    //! The indices of the candidates (numPoints + 1 if empty).
+    std::vector<size_t> indices;
+    //! The distances of the candidates.
+    std::vector<double> distances;
+    //! Whether each candidate was added since it was last used in a join.
+    std::vector<char> isNew;
+    //! The locks of the heaps; several points share each lock.
+    std::vector<std::mutex> locks;
+  };
+
+  //! Add the pairs of points of the leaves of the given tree to the graph.
+  template<typename TreeType>
+  void InitializeFromTree(const MatType& dataset,
+                          TreeType& tree,
+                          const std::vector<size_t>& oldFromNew,
+                          NeighborGraph& graph);
+
+  //! Give each point random neighbors until it has k neighbors.
+  void FillRandomly(const MatType& dataset, NeighborGraph& graph);
+
+  //! Evaluate the distance between two points and add each point to the heap
+  //! of the other; return the number of changed neighbors.
+  size_t Update(const MatType& dataset,
+                const size_t p,
+                const size_t q,
+                NeighborGraph& graph);
+
+  //! How to build the initial graph.
+  InitializationType initialization;
+  //! The maximum number of iterations.
+  size_t maxIterations;
+  //! The fraction of the neighbors used by the local joins.
+  double sampleRate;
+  //! The tolerance for termination.
+  double tolerance;
+  //! The maximum leaf size of the initialization tree.
+  size_t leafSize;
+  //! The overlap of the spill tree used for initialization.
+  double tau;
+  //! The number of iterations of the last computation.
+  size_t iterations;
+  //! The number of distance evaluations of the last computation.
+  size_t distanceEvaluations;
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
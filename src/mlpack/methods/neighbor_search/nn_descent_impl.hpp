@@ -0,0 +1,363 @@
+/**
+ * @file methods/neighbor_search/nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(
+    const InitializationType initialization,
+    const size_t maxIterations,
+    const double sampleRate,
+    const double tolerance,
+    MetricType metric) :
+    initialization(initialization),
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    tolerance(tolerance),
+    leafSize(0),
+    tau(0.0),
+    iterations(0),
+    distanceEvaluations(0),
+    metric(metric)
+{
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    throw std::invalid_argument("NNDescent::NNDescent(): sampleRate must be "
+        "in (0, 1]!");
+  }
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Compute(const MatType& dataset,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  const size_t numPoints = dataset.n_cols;
+  if (k >= numPoints && numPoints > 0)
+  {
+    std::ostringstream oss;
+    oss << "NNDescent::Compute(): requested " << k << " approximate nearest "
+        << "neighbors, but the dataset has only " << numPoints << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  iterations = 0;
+  distanceEvaluations = 0;
+  neighbors.set_size(k, numPoints);
+  distances.set_size(k, numPoints);
+  if (k == 0 || numPoints == 0)
+    return;
+
+  Timer::Start("nn_descent");
+
+  NeighborGraph graph(numPoints, k);
+
+  // Build the initial graph.  Leaves must hold more than k points to give each
+  // of their points k neighbors.
+  const size_t treeLeafSize = std::max(k + 1, (leafSize == 0) ?
+      2 * (k + 1) : leafSize);
+  if (initialization == RP_TREE_INIT)
+  {
+    std::vector<size_t> oldFromNew;
+    tree::RPTree<MetricType, tree::EmptyStatistic, MatType> tree(dataset,
+        oldFromNew, treeLeafSize);
+    InitializeFromTree(dataset, tree, oldFromNew, graph);
+  }
+  else if (initialization == SPILL_TREE_INIT)
+  {
+    // The spill tree doesn't reorder the points.
+    tree::SPTree<MetricType, tree::EmptyStatistic, MatType> tree(dataset, tau,
+        treeLeafSize);
+    InitializeFromTree(dataset, tree, std::vector<size_t>(), graph);
+  }
+  FillRandomly(dataset, graph);
+
+  const size_t sampleSize = std::max((size_t) 1,
+      (size_t) std::ceil(sampleRate * k));
+  std::vector<std::vector<size_t>> newLists(numPoints), oldLists(numPoints);
+  std::vector<std::vector<size_t>> newReverse(numPoints),
+      oldReverse(numPoints);
+  std::vector<size_t> candidates;
+  while (maxIterations == 0 || iterations < maxIterations)
+  {
+    ++iterations;
+
+    // Collect the old neighbors and a sample of the new neighbors of each
+    // point; the sampled neighbors are not new anymore.  This is done with a
+    // single thread, so that the samples only depend on the random seed.
+    for (size_t v = 0; v < numPoints; ++v)
+    {
+      newLists[v].clear();
+      oldLists[v].clear();
+      candidates.clear();
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (graph.Index(v, j) == numPoints)
+          continue;
+        if (graph.IsNew(v, j))
+          candidates.push_back(j);
+        else
+          oldLists[v].push_back(graph.Index(v, j));
+      }
+
+      for (size_t i = 0; i < std::min(sampleSize, candidates.size()); ++i)
+      {
+        const size_t pick = i + math::RandInt(candidates.size() - i);
+        std::swap(candidates[i], candidates[pick]);
+        graph.IsNew(v, candidates[i]) = 0;
+        newLists[v].push_back(graph.Index(v, candidates[i]));
+      }
+    }
+
+    // Find the reverse neighbors.
+    for (size_t v = 0; v < numPoints; ++v)
+    {
+      newReverse[v].clear();
+      oldReverse[v].clear();
+    }
+    for (size_t v = 0; v < numPoints; ++v)
+    {
+      for (size_t i = 0; i < newLists[v].size(); ++i)
+        newReverse[newLists[v][i]].push_back(v);
+      for (size_t i = 0; i < oldLists[v].size(); ++i)
+        oldReverse[oldLists[v][i]].push_back(v);
+    }
+
+    // Add a sample of the reverse neighbors to the lists of each point.
+    for (size_t v = 0; v < numPoints; ++v)
+    {
+      std::vector<size_t>* reverse[2] = { &newReverse[v], &oldReverse[v] };
+      std::vector<size_t>* lists[2] = { &newLists[v], &oldLists[v] };
+      for (size_t l = 0; l < 2; ++l)
+      {
+        std::vector<size_t>& r = *reverse[l];
+        for (size_t i = 0; i < std::min(sampleSize, r.size()); ++i)
+        {
+          const size_t pick = i + math::RandInt(r.size() - i);
+          std::swap(r[i], r[pick]);
+          lists[l]->push_back(r[i]);
+        }
+
+        std::sort(lists[l]->begin(), lists[l]->end());
+        lists[l]->erase(std::unique(lists[l]->begin(), lists[l]->end()),
+            lists[l]->end());
+      }
+    }
+
+    // The local join: compare the new neighbors of each point with each other
+    // and with the old neighbors.
+    size_t changes = 0;
+    size_t evaluations = 0;
+    #pragma omp parallel for schedule(dynamic, 16) \
+        reduction(+:changes, evaluations)
+    for (omp_size_t v = 0; v < (omp_size_t) numPoints; ++v)
+    {
+      const std::vector<size_t>& newList = newLists[v];
+      const std::vector<size_t>& oldList = oldLists[v];
+      for (size_t i = 0; i < newList.size(); ++i)
+      {
+        for (size_t j = i + 1; j < newList.size(); ++j)
+        {
+          changes += Update(dataset, newList[i], newList[j], graph);
+          ++evaluations;
+        }
+
+        for (size_t j = 0; j < oldList.size(); ++j)
+        {
+          if (newList[i] == oldList[j])
+            continue;
+
+          changes += Update(dataset, newList[i], oldList[j], graph);
+          ++evaluations;
+        }
+      }
+    }
+
+    distanceEvaluations += evaluations;
+    Log::Info << "NN-descent iteration " << iterations << ": " << changes
+        << " neighbors changed." << std::endl;
+    if (changes <= tolerance * k * numPoints)
+      break;
+  }
+
+  // Sort the neighbors of each point.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t v = 0; v < (omp_size_t) numPoints; ++v)
+  {
+    std::vector<std::pair<double, size_t>> sorted(k);
+    for (size_t j = 0; j < k; ++j)
+      sorted[j] = std::make_pair(graph.Distance(v, j), graph.Index(v, j));
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, v) = sorted[j].second;
+      distances(j, v) = sorted[j].first;
+    }
+  }
+
+  Timer::Stop("nn_descent");
+}
+
+template<typename MetricType, typename MatType>
+template<typename TreeType>
+void NNDescent<MetricType, MatType>::InitializeFromTree(
+    const MatType& dataset,
+    TreeType& tree,
+    const std::vector<size_t>& oldFromNew,
+    NeighborGraph& graph)
+{
+  std::vector<TreeType*> leaves;
+  std::vector<TreeType*> stack(1, &tree);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.back();
+    stack.pop_back();
+    if (node->IsLeaf())
+      leaves.push_back(node);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  size_t evaluations = 0;
+  #pragma omp parallel for schedule(dynamic, 4) reduction(+:evaluations)
+  for (omp_size_t l = 0; l < (omp_size_t) leaves.size(); ++l)
+  {
+    const TreeType& leaf = *leaves[l];
+    std::vector<size_t> points(leaf.NumPoints());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      points[i] = oldFromNew.empty() ? leaf.Point(i) :
+          oldFromNew[leaf.Point(i)];
+    }
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      for (size_t j = i + 1; j < points.size(); ++j)
+      {
+        Update(dataset, points[i], points[j], graph);
+        ++evaluations;
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::FillRandomly(const MatType& dataset,
+                                                  NeighborGraph& graph)
+{
+  const size_t numPoints = dataset.n_cols;
+  const size_t k = graph.K();
+  for (size_t v = 0; v < numPoints; ++v)
+  {
+    size_t count = 0;
+    for (size_t j = 0; j < k; ++j)
+      count += (graph.Index(v, j) != numPoints);
+
+    // Since k < numPoints, there are always enough other points.
+    while (count < k)
+    {
+      const size_t candidate = math::RandInt(numPoints);
+      if (candidate == v)
+        continue;
+
+      const double distance = metric.Evaluate(dataset.col(v),
+          dataset.col(candidate));
+      ++distanceEvaluations;
+      count += graph.Insert(v, candidate, distance);
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+size_t NNDescent<MetricType, MatType>::Update(const MatType& dataset,
+                                              const size_t p,
+                                              const size_t q,
+                                              NeighborGraph& graph)
+{
+  const double distance = metric.Evaluate(dataset.col(p), dataset.col(q));
+  return (size_t) graph.Insert(p, q, distance) +
+      (size_t) graph.Insert(q, p, distance);
+}
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NeighborGraph::NeighborGraph(
+    const size_t numPoints,
+    const size_t k) :
+    k(k),
+    indices(numPoints * k, numPoints),
+    distances(numPoints * k, DBL_MAX),
+    isNew(numPoints * k, 0),
+    locks(std::min(numPoints, (size_t) 65536))
+{
+  // Nothing else to do.
+}
+
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::NeighborGraph::Insert(
+    const size_t point,
+    const size_t candidate,
+    const double distance)
+{
+  if (candidate == point)
+    return false;
+
+  std::lock_guard<std::mutex> guard(locks[point % locks.size()]);
+
+  // The first candidate is the furthest one.
+  size_t* heapIndices = indices.data() + point * k;
+  double* heapDistances = distances.data() + point * k;
+  char* heapIsNew = isNew.data() + point * k;
+  if (distance >= heapDistances[0])
+    return false;
+  for (size_t j = 0; j < k; ++j)
+    if (heapIndices[j] == candidate)
+      return false;
+
+  // Replace the furthest candidate, and restore the heap.
+  size_t j = 0;
+  while (true)
+  {
+    const size_t left = 2 * j + 1;
+    if (left >= k)
+      break;
+    const size_t child = (left + 1 < k &&
+        heapDistances[left + 1] > heapDistances[left]) ? left + 1 : left;
+    if (heapDistances[child] <= distance)
+      break;
+
+    heapIndices[j] = heapIndices[child];
+    heapDistances[j] = heapDistances[child];
+    heapIsNew[j] = heapIsNew[child];
+    j = child;
+  }
+
+  heapIndices[j] = candidate;
+  heapDistances[j] = distance;
+  heapIsNew[j] = 1;
+  return true;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file methods/neighbor_search/ns_model.cpp
+ *
+ * Explicit instantiation of the NSModel classes used by the knn and kfn
+ * bindings, so that they are compiled once, into libmlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ns_model.hpp"
+
+MLPACK_NS_MODEL_INSTANTIATION(, mlpack::neighbor::NearestNeighborSort);
+MLPACK_NS_MODEL_INSTANTIATION(, mlpack::neighbor::FurthestNeighborSort);
@@ -30,7 +30,9 @@ namespace neighbor {
  * NSWrapperBase is a base wrapper class for holding all NeighborSearch types
  * supported by NSModel.  All NeighborSearch type wrappers inherit from this
  * class, allowing a simple interface via inheritance for all the different
- * types we want to support.
+ * types we want to support.  The functions that take or return points are
+ * declared in NSTypedWrapperBase, since they depend on the element type of the
+ * points.
  */
 class NSWrapperBase
 {
@@ -46,8 +48,8 @@ class NSWrapperBase
   //! Destruct the NSWrapperBase (nothing to do).
   virtual ~NSWrapperBase() { };
 
-  //! Return a reference to the dataset.
-  virtual const arma::mat& Dataset() const = 0;
+  //! Get the dimensionality of the reference set.
+  virtual size_t Dimensionality() const = 0;
 
   //! Get the search mode.
   virtual NeighborSearchMode SearchMode() const = 0;
@@ -59,26 +61,63 @@ class NSWrapperBase
   //! Modify the approximation parameter epsilon.
   virtual double& Epsilon() = 0;
 
+  //! Perform monochromatic neighbor search (i.e. use the reference set as the
+  //! query set).
+  virtual void Search(const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) = 0;
+
+  //! Delete points from the reference set, rebuilding the tree with the given
+  //! parameters if there are too many pending updates.
+  virtual void DeleteReferencePoints(const arma::Col<size_t>& indices,
+                                     const size_t leafSize,
+                                     const double tau,
+                                     const double rho) = 0;
+
+  //! Get the number of points in the current reference set.
+  virtual size_t NumReferencePoints() const = 0;
+};
+
+/**
+ * NSTypedWrapperBase adds the functions that take or return points of the
+ * given element type to NSWrapperBase.
+ *
+ * @tparam ElemType Element type of the points (double or float).
+ */
+template<typename ElemType>
+class NSTypedWrapperBase : public NSWrapperBase
+{
+ public:
+  //! Return a reference to the dataset.
+  virtual const arma::Mat<ElemType>& Dataset() const = 0;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const { return Dataset().n_rows; }
+
   //! Train the NeighborSearch model with the given parameters.
-  virtual void Train(arma::mat&& referenceSet,
+  virtual void Train(arma::Mat<ElemType>&& referenceSet,
                      const size_t leafSize,
                      const double tau,
                      const double rho) = 0;
 
   //! Perform bichromatic neighbor search (i.e. search with a separate query
   //! set).
-  virtual void Search(arma::mat&& querySet,
+  virtual void Search(arma::Mat<ElemType>&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
                       const size_t leafSize,
                       const double rho) = 0;
 
-  //! Perform monochromatic neighbor search (i.e. use the reference set as the
-  //! query set).
-  virtual void Search(const size_t k,
-                      arma::Mat<size_t>& neighbors,
-                      arma::mat& distances) = 0;
+  // Don't hide the monochromatic search.
+  using NSWrapperBase::Search;
+
+  //! Insert points into the reference set, rebuilding the tree with the given
+  //! parameters if there are too many pending updates.
+  virtual void InsertReferencePoints(arma::Mat<ElemType>&& points,
+                                     const size_t leafSize,
+                                     const double tau,
+                                     const double rho) = 0;
 };
 
 /**
@@ -88,15 +127,16 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType = double,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      arma::Mat<ElemType>>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
-class NSWrapper : public NSWrapperBase
+                      arma::Mat<ElemType>>::template SingleTreeTraverser>
+class NSWrapper : public NSTypedWrapperBase<ElemType>
 {
  public:
   //! Construct the NSWrapper object, initializing the internally-held
@@ -116,7 +156,7 @@ class NSWrapper : public NSWrapperBase
   virtual NSWrapper* Clone() const { return new NSWrapper(*this); }
 
   //! Get a reference to the reference set.
-  const arma::mat& Dataset() const { return ns.ReferenceSet(); }
+  const arma::Mat<ElemType>& Dataset() const { return ns.ReferenceSet(); }
 
   //! Get the search mode.
   NeighborSearchMode SearchMode() const { return ns.SearchMode(); }
@@ -130,14 +170,14 @@ class NSWrapper : public NSWrapperBase
 
   //! Train the model with the given options.  For NSWrapper, we ignore the
   //! extra parameters.
-  virtual void Train(arma::mat&& referenceSet,
+  virtual void Train(arma::Mat<ElemType>&& referenceSet,
                      const size_t /* leafSize */,
                      const double /* tau */,
                      const double /* rho */);
 
   //! Perform bichromatic neighbor search (i.e. search with a separate query
   //! set).  For NSWrapper, we ignore the extra parameters.
-  virtual void Search(arma::mat&& querySet,
+  virtual void Search(arma::Mat<ElemType>&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
@@ -150,6 +190,23 @@ class NSWrapper : public NSWrapperBase
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances);
 
+  //! Insert points into the reference set.  If the tree must be rebuilt, it is
+  //! rebuilt with Train(), so the given parameters are used.
+  virtual void InsertReferencePoints(arma::Mat<ElemType>&& points,
+                                     const size_t leafSize,
+                                     const double tau,
+                                     const double rho);
+
+  //! Delete points from the reference set.  If the tree must be rebuilt, it is
+  //! rebuilt with Train(), so the given parameters are used.
+  virtual void DeleteReferencePoints(const arma::Col<size_t>& indices,
+                                     const size_t leafSize,
+                                     const double tau,
+                                     const double rho);
+
+  //! Get the number of points in the current reference set.
+  size_t NumReferencePoints() const { return ns.NumReferencePoints(); }
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -161,7 +218,7 @@ class NSWrapper : public NSWrapperBase
   // Convenience typedef for the neighbor search type held by this class.
   typedef NeighborSearch<SortPolicy,
                          metric::EuclideanDistance,
-                         arma::mat,
+                         arma::Mat<ElemType>,
                          TreeType,
                          DualTreeTraversalType,
                          SingleTreeTraversalType> NSType;
@@ -179,17 +236,19 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType = double,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      arma::Mat<ElemType>>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<metric::EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      arma::Mat<ElemType>>::template SingleTreeTraverser>
 class LeafSizeNSWrapper :
     public NSWrapper<SortPolicy,
                      TreeType,
+                     ElemType,
                      DualTreeTraversalType,
                      SingleTreeTraversalType>
 {
@@ -200,6 +259,7 @@ class LeafSizeNSWrapper :
                     const double epsilon) :
       NSWrapper<SortPolicy,
                 TreeType,
+                ElemType,
                 DualTreeTraversalType,
                 SingleTreeTraversalType>(searchMode, epsilon)
   {
@@ -217,20 +277,27 @@ class LeafSizeNSWrapper :
 
   //! Train a model with the given parameters.  This overload uses leafSize but
   //! ignores the other parameters.
-  virtual void Train(arma::mat&& referenceSet,
+  virtual void Train(arma::Mat<ElemType>&& referenceSet,
                      const size_t leafSize,
                      const double /* tau */,
                      const double /* rho */);
 
   //! Perform bichromatic search (e.g. search with a separate query set).  This
   //! overload uses the leaf size, but ignores the other parameters.
-  virtual void Search(arma::mat&& querySet,
+  virtual void Search(arma::Mat<ElemType>&& querySet,
                       const size_t k,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
                       const size_t leafSize,
                       const double /* rho */);
 
+  // Don't hide the monochromatic search.
+  using NSWrapper<SortPolicy,
+                  TreeType,
+                  ElemType,
+                  DualTreeTraversalType,
+                  SingleTreeTraversalType>::Search;
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -241,6 +308,7 @@ class LeafSizeNSWrapper :
  protected:
   using NSWrapper<SortPolicy,
                   TreeType,
+                  ElemType,
                   DualTreeTraversalType,
                   SingleTreeTraversalType>::ns;
 };
@@ -254,6 +322,7 @@ class SpillNSWrapper :
     public NSWrapper<
         SortPolicy,
         tree::SPTree,
+        double,
         tree::SPTree<metric::EuclideanDistance,
                      NeighborSearchStat<SortPolicy>,
                      arma::mat>::template DefeatistDualTreeTraverser,
@@ -268,6 +337,7 @@ class SpillNSWrapper :
       NSWrapper<
           SortPolicy,
           tree::SPTree,
+          double,
           tree::SPTree<metric::EuclideanDistance,
                        NeighborSearchStat<SortPolicy>,
                        arma::mat>::template DefeatistDualTreeTraverser,
@@ -300,6 +370,18 @@ class SpillNSWrapper :
                       const size_t leafSize,
                       const double rho);
 
+  // Don't hide the monochromatic search.
+  using NSWrapper<
+      SortPolicy,
+      tree::SPTree,
+      double,
+      tree::SPTree<metric::EuclideanDistance,
+                   NeighborSearchStat<SortPolicy>,
+                   arma::mat>::template DefeatistDualTreeTraverser,
+      tree::SPTree<metric::EuclideanDistance,
+                   NeighborSearchStat<SortPolicy>,
+                   arma::mat>::template DefeatistSingleTreeTraverser>::Search;
+
   //! Serialize the NeighborSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -311,6 +393,7 @@ class SpillNSWrapper :
   using NSWrapper<
       SortPolicy,
       tree::SPTree,
+      double,
       tree::SPTree<metric::EuclideanDistance,
                    NeighborSearchStat<SortPolicy>,
                    arma::mat>::template DefeatistDualTreeTraverser,
@@ -361,6 +444,8 @@ class NSModel
   bool randomBasis;
   //! This is the random projection matrix; only used if randomBasis is true.
   arma::mat q;
+  //! If true, the points are held and searched in single precision.
+  bool singlePrecision;
 
   size_t leafSize;
   double tau;
@@ -380,8 +465,12 @@ class NSModel
    * @param treeType Type of tree to use.
    * @param randomBasis Whether or not to project the points onto a random basis
    *      before searching.
+   * @param singlePrecision Whether or not to hold and search the points in
+   *      single precision (arma::fmat); this halves the memory of the model.
    */
-  NSModel(TreeTypes treeType = TreeTypes::KD_TREE, bool randomBasis = false);
+  NSModel(TreeTypes treeType = TreeTypes::KD_TREE,
+          bool randomBasis = false,
+          bool singlePrecision = false);
 
   /**
    * Copy the given NSModel.
@@ -416,10 +505,18 @@ class NSModel
 
   //! Serialize the neighbor search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
-  //! Expose the dataset.
-  const arma::mat& Dataset() const;
+  /**
+   * Expose the dataset.  ElemType must be float if the model uses single
+   * precision and double otherwise; a std::invalid_argument is thrown if it
+   * isn't.
+   */
+  template<typename ElemType = double>
+  const arma::Mat<ElemType>& Dataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -449,17 +546,31 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the points are held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the points are held in single precision; this takes effect
+  //! the next time the model is built.
+  bool& SinglePrecision() { return singlePrecision; }
+
   //! Initialize the model type.  (This does not perform any training.)
   void InitializeModel(const NeighborSearchMode searchMode,
                        const double epsilon);
 
-  //! Build the reference tree.
-  void BuildModel(arma::mat&& referenceSet,
+  /**
+   * Build the reference tree.  The reference set is converted to the precision
+   * of the model if its element type is different.
+   */
+  template<typename ElemType>
+  void BuildModel(arma::Mat<ElemType>&& referenceSet,
                   const NeighborSearchMode searchMode,
                   const double epsilon = 0);
 
-  //! Perform neighbor search.  The query set will be reordered.
-  void Search(arma::mat&& querySet,
+  /**
+   * Perform neighbor search.  The query set will be reordered, and is
+   * converted to the precision of the model if its element type is different.
+   */
+  template<typename ElemType>
+  void Search(arma::Mat<ElemType>&& querySet,
               const size_t k,
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
@@ -469,14 +580,149 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Insert the given points into the reference set without rebuilding the
+   * tree; the points are given the next indices of the reference set.  The
+   * tree is rebuilt (with the current leaf size, tau and rho) once there are
+   * enough pending updates.  The points are converted to the precision of the
+   * model if their element type is different.
+   *
+   * @param points Points to insert.
+   */
+  template<typename ElemType>
+  void InsertReferencePoints(arma::Mat<ElemType>&& points);
+
+  /**
+   * Delete the points with the given indices from the reference set without
+   * rebuilding the tree; the points that follow a deleted point move down to
+   * fill its index.  The tree is rebuilt (with the current leaf size, tau and
+   * rho) once there are enough pending updates.
+   *
+   * @param indices Indices of the points to delete.
+   */
+  void DeleteReferencePoints(const arma::Col<size_t>& indices);
+
+  //! Get the number of points in the current reference set.
+  size_t NumReferencePoints() const;
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Create the NeighborSearch wrapper for the current tree type with the
+  //! given element type.
+  template<typename ElemType>
+  NSTypedWrapperBase<ElemType>* CreateWrapper(
+      const NeighborSearchMode searchMode,
+      const double epsilon) const;
+
+  //! Create the NeighborSearch wrapper for a tree type that only supports
+  //! double precision.
+  NSTypedWrapperBase<double>* CreateDoubleWrapper(
+      const NeighborSearchMode searchMode,
+      const double epsilon,
+      const double* tag) const;
+
+  //! Throw a std::invalid_argument, since the tree type only supports double
+  //! precision.
+  template<typename ElemType>
+  NSTypedWrapperBase<ElemType>* CreateDoubleWrapper(
+      const NeighborSearchMode searchMode,
+      const double epsilon,
+      const ElemType* tag) const;
+
+  //! Serialize the NeighborSearch wrapper with the given element type.
+  template<typename ElemType, typename Archive>
+  void SerializeWrapper(Archive& ar);
+
+  //! Serialize the NeighborSearch wrapper of a tree type that only supports
+  //! double precision.
+  template<typename Archive>
+  void SerializeDoubleWrapper(Archive& ar, const double* tag);
+
+  //! Throw a std::invalid_argument, since the tree type only supports double
+  //! precision.
+  template<typename Archive, typename ElemType>
+  void SerializeDoubleWrapper(Archive& ar, const ElemType* tag);
+
+  //! Get the wrapper as a wrapper of the given element type; a
+  //! std::invalid_argument is thrown if the model has the other precision.
+  template<typename ElemType>
+  NSTypedWrapperBase<ElemType>* TypedWrapper() const;
+
+  //! Convert the given points to the precision of the model, and project them
+  //! onto the random basis if one is used.
+  template<typename ElemType, typename ModelElemType>
+  void ConvertPoints(arma::Mat<ElemType>&& points,
+                     arma::Mat<ModelElemType>& converted) const;
+
+  //! Project the given points onto the random basis if one is used; they
+  //! already have the precision of the model.
+  template<typename ElemType>
+  void ConvertPoints(arma::Mat<ElemType>&& points,
+                     arma::Mat<ElemType>& converted) const;
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the NSModel classes used by the bindings.
+CEREAL_CLASS_VERSION(mlpack::neighbor::NSModel<
+    mlpack::neighbor::NearestNeighborSort>, 1);
+CEREAL_CLASS_VERSION(mlpack::neighbor::NSModel<
+    mlpack::neighbor::FurthestNeighborSort>, 1);
+
 // Include implementation.
 #include "ns_model_impl.hpp"
 
+/**
+ * The NSModel types used by the knn and kfn bindings are compiled into
+ * libmlpack (in ns_model.cpp), so that every binding and program that uses
+ * them links against one copy of NSModel and of all the NeighborSearch types
+ * it holds, instead of instantiating its own.  This macro declares (with
+ * EXTERN = extern) or defines (with an empty EXTERN) those instantiations.
+ *
+ * @cond
+ */
+#define MLPACK_NS_MODEL_INSTANTIATION(EXTERN, SortPolicy) \
+  EXTERN template class mlpack::neighbor::NSModel<SortPolicy>; \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::BuildModel( \
+      arma::mat&&, const mlpack::neighbor::NeighborSearchMode, const double); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::BuildModel( \
+      arma::fmat&&, const mlpack::neighbor::NeighborSearchMode, \
+      const double); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::Search( \
+      arma::mat&&, const size_t, arma::Mat<size_t>&, arma::mat&); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::Search( \
+      arma::fmat&&, const size_t, arma::Mat<size_t>&, arma::mat&); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>:: \
+      InsertReferencePoints(arma::mat&&); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>:: \
+      InsertReferencePoints(arma::fmat&&); \
+  EXTERN template const arma::mat& \
+      mlpack::neighbor::NSModel<SortPolicy>::Dataset<double>() const; \
+  EXTERN template const arma::fmat& \
+      mlpack::neighbor::NSModel<SortPolicy>::Dataset<float>() const; \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::BinaryInputArchive&, const uint32_t); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::BinaryOutputArchive&, const uint32_t); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::JSONInputArchive&, const uint32_t); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::JSONOutputArchive&, const uint32_t); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::XMLInputArchive&, const uint32_t); \
+  EXTERN template void mlpack::neighbor::NSModel<SortPolicy>::serialize( \
+      cereal::XMLOutputArchive&, const uint32_t)
+
+MLPACK_NS_MODEL_INSTANTIATION(extern,
+    mlpack::neighbor::NearestNeighborSort);
+MLPACK_NS_MODEL_INSTANTIATION(extern,
+    mlpack::neighbor::FurthestNeighborSort);
+
+/**
+ * @endcond
+ */
+
 #endif
@@ -27,11 +27,13 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
->::Train(arma::mat&& referenceSet,
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::Train(arma::Mat<ElemType>&& referenceSet,
          const size_t /* leafSize */,
          const double /* tau */,
          const double /* rho */)
@@ -45,11 +47,13 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
->::Search(arma::mat&& querySet,
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::Search(arma::Mat<ElemType>&& querySet,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances,
@@ -65,10 +69,12 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances)
@@ -76,17 +82,61 @@ void NSWrapper<
   ns.Search(k, neighbors, distances);
 }
 
+//! Insert points into the reference set, rebuilding with Train() if needed.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename ElemType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::InsertReferencePoints(arma::Mat<ElemType>&& points,
+                         const size_t leafSize,
+                         const double tau,
+                         const double rho)
+{
+  ns.InsertReferencePoints(points, false);
+  if (ns.NeedsRebuild())
+    Train(ns.MergedReferenceSet(), leafSize, tau, rho);
+}
+
+//! Delete points from the reference set, rebuilding with Train() if needed.
+template<typename SortPolicy,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         typename ElemType,
+         template<typename RuleType> class DualTreeTraversalType,
+         template<typename RuleType> class SingleTreeTraversalType>
+void NSWrapper<
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::DeleteReferencePoints(const arma::Col<size_t>& indices,
+                         const size_t leafSize,
+                         const double tau,
+                         const double rho)
+{
+  ns.DeleteReferencePoints(indices, false);
+  if (ns.NeedsRebuild())
+    Train(ns.MergedReferenceSet(), leafSize, tau, rho);
+}
+
 //! Train a model with the given parameters.  This overload uses leafSize but
 //! ignores the other parameters.
 template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
->::Train(arma::mat&& referenceSet,
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::Train(arma::Mat<ElemType>&& referenceSet,
          const size_t leafSize,
          const double /* tau */,
          const double /* rho */)
@@ -112,11 +162,13 @@ template<typename SortPolicy,
          template<typename TreeMetricType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename ElemType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
->::Search(arma::mat&& querySet,
+    SortPolicy, TreeType, ElemType, DualTreeTraversalType,
+    SingleTreeTraversalType
+>::Search(arma::Mat<ElemType>&& querySet,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances,
@@ -193,9 +245,12 @@ void SpillNSWrapper<SortPolicy>::Search(arma::mat&& querySet,
  * basis should be used.
  */
 template<typename SortPolicy>
-NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
+NSModel<SortPolicy>::NSModel(TreeTypes treeType,
+                             bool randomBasis,
+                             bool singlePrecision) :
     treeType(treeType),
     randomBasis(randomBasis),
+    singlePrecision(singlePrecision),
     leafSize(20),
     tau(0.0),
     rho(0.7),
@@ -209,6 +264,7 @@ NSModel<SortPolicy>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(other.q),
+    singlePrecision(other.singlePrecision),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
@@ -222,6 +278,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
+    singlePrecision(other.singlePrecision),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
@@ -230,6 +287,7 @@ NSModel<SortPolicy>::NSModel(NSModel&& other) :
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.leafSize = 20;
   other.tau = 0.0;
   other.rho = 0.7;
@@ -246,6 +304,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
     treeType = other.treeType;
     randomBasis = other.randomBasis;
     q = other.q;
+    singlePrecision = other.singlePrecision;
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
@@ -265,6 +324,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     treeType = other.treeType;
     randomBasis = other.randomBasis;
     q = std::move(other.q);
+    singlePrecision = other.singlePrecision;
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
@@ -273,6 +333,7 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
     // Reset parameters of the other model.
     other.treeType = TreeTypes::KD_TREE;
     other.randomBasis = false;
+    other.singlePrecision = false;
     other.leafSize = 20;
     other.tau = 0.0;
     other.rho = 0.7;
@@ -292,7 +353,7 @@ NSModel<SortPolicy>::~NSModel()
 //! Serialize the kNN model.
 template<typename SortPolicy>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
+void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
@@ -301,29 +362,103 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(tau));
   ar(CEREAL_NVP(rho));
 
+  // Models saved before single precision was supported hold double-precision
+  // points.  Only the sort policies given a version in ns_model.hpp store the
+  // precision.
+  if (version >= 1)
+  {
+    ar(CEREAL_NVP(singlePrecision));
+  }
+  else if (cereal::is_loading<Archive>())
+  {
+    singlePrecision = false;
+  }
+  else if (singlePrecision)
+  {
+    throw std::runtime_error("NSModel::serialize(): single-precision models "
+        "cannot be saved with this sort policy!");
+  }
+
   // This should never happen, but just in case, be clean with memory.
   if (cereal::is_loading<Archive>())
     InitializeModel(DUAL_TREE_MODE, 0.0); // Values will be overwritten.
 
+  if (singlePrecision)
+    SerializeWrapper<float>(ar);
+  else
+    SerializeWrapper<double>(ar);
+}
+
+//! Serialize the wrapper with the given element type.
+template<typename SortPolicy>
+template<typename ElemType, typename Archive>
+void NSModel<SortPolicy>::SerializeWrapper(Archive& ar)
+{
   // Avoid polymorphic serialization by explicitly serializing the correct type.
   switch (treeType)
   {
     case KD_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, tree::KDTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy,
-                         tree::KDTree>&>(*nSearch);
+        LeafSizeNSWrapper<SortPolicy, tree::KDTree, ElemType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::KDTree,
+                                           ElemType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case COVER_TREE:
       {
-        NSWrapper<SortPolicy, tree::StandardCoverTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy,
-                                   tree::StandardCoverTree>&>(*nSearch);
+        NSWrapper<SortPolicy, tree::StandardCoverTree, ElemType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, tree::StandardCoverTree,
+                                   ElemType>&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
+    case BALL_TREE:
+      {
+        LeafSizeNSWrapper<SortPolicy, tree::BallTree, ElemType>& typedSearch =
+            dynamic_cast<LeafSizeNSWrapper<SortPolicy, tree::BallTree,
+                                           ElemType>&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
+    case VP_TREE:
+      {
+        NSWrapper<SortPolicy, tree::VPTree, ElemType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, tree::VPTree,
+                                   ElemType>&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
+    case RP_TREE:
+      {
+        NSWrapper<SortPolicy, tree::RPTree, ElemType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, tree::RPTree,
+                                   ElemType>&>(*nSearch);
+        ar(CEREAL_NVP(typedSearch));
+        break;
+      }
+    case MAX_RP_TREE:
+      {
+        NSWrapper<SortPolicy, tree::MaxRPTree, ElemType>& typedSearch =
+            dynamic_cast<NSWrapper<SortPolicy, tree::MaxRPTree,
+                                   ElemType>&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+    default:
+      SerializeDoubleWrapper(ar, (const ElemType*) NULL);
+      break;
+  }
+}
+
+//! Serialize the wrapper of a tree type that only supports double precision.
+template<typename SortPolicy>
+template<typename Archive>
+void NSModel<SortPolicy>::SerializeDoubleWrapper(Archive& ar,
+                                                 const double* /* tag */)
+{
+  switch (treeType)
+  {
     case R_TREE:
       {
         NSWrapper<SortPolicy, tree::RTree>& typedSearch =
@@ -338,14 +473,6 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
         ar(CEREAL_NVP(typedSearch));
         break;
       }
-    case BALL_TREE:
-      {
-        LeafSizeNSWrapper<SortPolicy, tree::BallTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy,
-                                           tree::BallTree>&>(*nSearch);
-        ar(CEREAL_NVP(typedSearch));
-        break;
-      }
     case X_TREE:
       {
         NSWrapper<SortPolicy, tree::XTree>& typedSearch =
@@ -381,27 +508,6 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
         ar(CEREAL_NVP(typedSearch));
         break;
       }
-    case VP_TREE:
-      {
-        NSWrapper<SortPolicy, tree::VPTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::VPTree>&>(*nSearch);
-        ar(CEREAL_NVP(typedSearch));
-        break;
-      }
-    case RP_TREE:
-      {
-        NSWrapper<SortPolicy, tree::RPTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::RPTree>&>(*nSearch);
-        ar(CEREAL_NVP(typedSearch));
-        break;
-      }
-    case MAX_RP_TREE:
-      {
-        NSWrapper<SortPolicy, tree::MaxRPTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, tree::MaxRPTree>&>(*nSearch);
-        ar(CEREAL_NVP(typedSearch));
-        break;
-      }
     case UB_TREE:
       {
         NSWrapper<SortPolicy, tree::UBTree>& typedSearch =
@@ -417,14 +523,35 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+    default:
+      break;
   }
 }
 
+//! A tree type that only supports double precision can't hold other points;
+//! the wrapper can't have been created, so this is never called.
+template<typename SortPolicy>
+template<typename Archive, typename ElemType>
+void NSModel<SortPolicy>::SerializeDoubleWrapper(Archive& /* ar */,
+                                                 const ElemType* /* tag */)
+{
+  throw std::invalid_argument("NSModel::serialize(): the " + TreeName() +
+      " does not support single precision!");
+}
+
 //! Expose the dataset.
 template<typename SortPolicy>
-const arma::mat& NSModel<SortPolicy>::Dataset() const
+template<typename ElemType>
+const arma::Mat<ElemType>& NSModel<SortPolicy>::Dataset() const
+{
+  return TypedWrapper<ElemType>()->Dataset();
+}
+
+//! Get the dimensionality of the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::Dimensionality() const
 {
-  return nSearch->Dataset();
+  return nSearch->Dimensionality();
 }
 
 //! Access the search mode.
@@ -460,68 +587,152 @@ void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
 {
   // Clear existing memory.
   if (nSearch)
+  {
     delete nSearch;
+    nSearch = NULL;
+  }
+
+  if (singlePrecision)
+    nSearch = CreateWrapper<float>(searchMode, epsilon);
+  else
+    nSearch = CreateWrapper<double>(searchMode, epsilon);
+}
 
+//! Create the wrapper for the current tree type with the given element type.
+template<typename SortPolicy>
+template<typename ElemType>
+NSTypedWrapperBase<ElemType>* NSModel<SortPolicy>::CreateWrapper(
+    const NeighborSearchMode searchMode,
+    const double epsilon) const
+{
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::KDTree>(searchMode,
-          epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, tree::KDTree, ElemType>(
+          searchMode, epsilon);
     case COVER_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::StandardCoverTree>(searchMode,
+      return new NSWrapper<SortPolicy, tree::StandardCoverTree, ElemType>(
+          searchMode, epsilon);
+    case BALL_TREE:
+      return new LeafSizeNSWrapper<SortPolicy, tree::BallTree, ElemType>(
+          searchMode, epsilon);
+    case VP_TREE:
+      return new NSWrapper<SortPolicy, tree::VPTree, ElemType>(searchMode,
           epsilon);
-      break;
+    case RP_TREE:
+      return new NSWrapper<SortPolicy, tree::RPTree, ElemType>(searchMode,
+          epsilon);
+    case MAX_RP_TREE:
+      return new NSWrapper<SortPolicy, tree::MaxRPTree, ElemType>(searchMode,
+          epsilon);
+    default:
+      return CreateDoubleWrapper(searchMode, epsilon, (const ElemType*) NULL);
+  }
+}
+
+//! Create the wrapper of a tree type that only supports double precision.
+template<typename SortPolicy>
+NSTypedWrapperBase<double>* NSModel<SortPolicy>::CreateDoubleWrapper(
+    const NeighborSearchMode searchMode,
+    const double epsilon,
+    const double* /* tag */) const
+{
+  switch (treeType)
+  {
     case R_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, tree::RTree>(searchMode, epsilon);
     case R_STAR_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RStarTree>(searchMode, epsilon);
-      break;
-    case BALL_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::BallTree>(searchMode,
-          epsilon);
-      break;
+      return new NSWrapper<SortPolicy, tree::RStarTree>(searchMode, epsilon);
     case X_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::XTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, tree::XTree>(searchMode, epsilon);
     case HILBERT_R_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::HilbertRTree>(searchMode,
+      return new NSWrapper<SortPolicy, tree::HilbertRTree>(searchMode,
           epsilon);
-      break;
     case R_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, tree::RPlusTree>(searchMode, epsilon);
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RPlusPlusTree>(searchMode,
+      return new NSWrapper<SortPolicy, tree::RPlusPlusTree>(searchMode,
           epsilon);
-      break;
-    case VP_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::VPTree>(searchMode, epsilon);
-      break;
-    case RP_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::RPTree>(searchMode, epsilon);
-      break;
-    case MAX_RP_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::MaxRPTree>(searchMode, epsilon);
-      break;
     case SPILL_TREE:
-      nSearch = new SpillNSWrapper<SortPolicy>(searchMode, epsilon);
-      break;
+      return new SpillNSWrapper<SortPolicy>(searchMode, epsilon);
     case UB_TREE:
-      nSearch = new NSWrapper<SortPolicy, tree::UBTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, tree::UBTree>(searchMode, epsilon);
     case OCTREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, tree::Octree>(searchMode,
+      return new LeafSizeNSWrapper<SortPolicy, tree::Octree>(searchMode,
           epsilon);
-      break;
+    default:
+      throw std::invalid_argument("NSModel::InitializeModel(): unknown tree "
+          "type!");
+  }
+}
+
+//! Tree types that only support double precision can't be created with other
+//! element types.
+template<typename SortPolicy>
+template<typename ElemType>
+NSTypedWrapperBase<ElemType>* NSModel<SortPolicy>::CreateDoubleWrapper(
+    const NeighborSearchMode /* searchMode */,
+    const double /* epsilon */,
+    const ElemType* /* tag */) const
+{
+  throw std::invalid_argument("NSModel::InitializeModel(): the " + TreeName() +
+      " does not support single precision; use a kd-tree, cover tree, ball "
+      "tree, vantage point tree or random projection tree instead!");
+}
+
+//! Get the wrapper as a wrapper of the given element type.
+template<typename SortPolicy>
+template<typename ElemType>
+NSTypedWrapperBase<ElemType>* NSModel<SortPolicy>::TypedWrapper() const
+{
+  NSTypedWrapperBase<ElemType>* typedSearch =
+      dynamic_cast<NSTypedWrapperBase<ElemType>*>(nSearch);
+  if (typedSearch == NULL)
+  {
+    throw std::invalid_argument(std::string("NSModel::Dataset(): the model "
+        "holds ") + (singlePrecision ? "single" : "double") + "-precision "
+        "points!");
   }
 
+  return typedSearch;
+}
+
+//! Convert points to the precision of the model, projecting them onto the
+//! random basis if necessary.
+template<typename SortPolicy>
+template<typename ElemType, typename ModelElemType>
+void NSModel<SortPolicy>::ConvertPoints(
+    arma::Mat<ElemType>&& points,
+    arma::Mat<ModelElemType>& converted) const
+{
+  converted = arma::conv_to<arma::Mat<ModelElemType>>::from(points);
+  points.reset();
+  if (randomBasis)
+    converted = arma::conv_to<arma::Mat<ModelElemType>>::from(q) * converted;
+}
+
+//! The points already have the precision of the model, so they only have to be
+//! projected onto the random basis if necessary.
+template<typename SortPolicy>
+template<typename ElemType>
+void NSModel<SortPolicy>::ConvertPoints(arma::Mat<ElemType>&& points,
+                                        arma::Mat<ElemType>& converted) const
+{
+  if (randomBasis)
+  {
+    converted = arma::conv_to<arma::Mat<ElemType>>::from(q) * points;
+    points.reset();
+  }
+  else
+  {
+    converted = std::move(points);
+  }
 }
 
 //! Build the reference tree.
 template<typename SortPolicy>
-void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
+template<typename ElemType>
+void NSModel<SortPolicy>::BuildModel(arma::Mat<ElemType>&& referenceSet,
                                      const NeighborSearchMode searchMode,
                                      const double epsilon)
 {
@@ -557,9 +768,9 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     }
   }
 
-  // Do we need to modify the reference set?
-  if (randomBasis)
-    referenceSet = q * referenceSet;
+  // Create the wrapper first, so that an unsupported tree type is reported
+  // before the reference set is converted.
+  InitializeModel(searchMode, epsilon);
 
   if (searchMode != NAIVE_MODE)
   {
@@ -567,8 +778,20 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     Log::Info << "Building reference tree..." << std::endl;
   }
 
-  InitializeModel(searchMode, epsilon);
-  nSearch->Train(std::move(referenceSet), leafSize, tau, rho);
+  // The reference set is converted to the precision of the model (and
+  // projected onto the random basis, if necessary).
+  if (singlePrecision)
+  {
+    arma::fmat points;
+    ConvertPoints(std::move(referenceSet), points);
+    TypedWrapper<float>()->Train(std::move(points), leafSize, tau, rho);
+  }
+  else
+  {
+    arma::mat points;
+    ConvertPoints(std::move(referenceSet), points);
+    TypedWrapper<double>()->Train(std::move(points), leafSize, tau, rho);
+  }
 
   if (searchMode != NAIVE_MODE)
   {
@@ -579,15 +802,12 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
 
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
-void NSModel<SortPolicy>::Search(arma::mat&& querySet,
+template<typename ElemType>
+void NSModel<SortPolicy>::Search(arma::Mat<ElemType>&& querySet,
                                  const size_t k,
                                  arma::Mat<size_t>& neighbors,
                                  arma::mat& distances)
 {
-  // We may need to map the query set randomly.
-  if (randomBasis)
-    querySet = q * querySet;
-
   Log::Info << "Searching for " << k << " neighbors with ";
 
   switch (SearchMode())
@@ -607,7 +827,21 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       break;
   }
 
-  nSearch->Search(std::move(querySet), k, neighbors, distances, leafSize, rho);
+  // We may need to convert the query set, or map it randomly.
+  if (singlePrecision)
+  {
+    arma::fmat points;
+    ConvertPoints(std::move(querySet), points);
+    TypedWrapper<float>()->Search(std::move(points), k, neighbors, distances,
+        leafSize, rho);
+  }
+  else
+  {
+    arma::mat points;
+    ConvertPoints(std::move(querySet), points);
+    TypedWrapper<double>()->Search(std::move(points), k, neighbors, distances,
+        leafSize, rho);
+  }
 }
 
 //! Perform neighbor search.
@@ -642,6 +876,43 @@ void NSModel<SortPolicy>::Search(const size_t k,
   nSearch->Search(k, neighbors, distances);
 }
 
+//! Insert points into the reference set.
+template<typename SortPolicy>
+template<typename ElemType>
+void NSModel<SortPolicy>::InsertReferencePoints(arma::Mat<ElemType>&& points)
+{
+  // The points must be converted and projected like the reference set was.
+  if (singlePrecision)
+  {
+    arma::fmat converted;
+    ConvertPoints(std::move(points), converted);
+    TypedWrapper<float>()->InsertReferencePoints(std::move(converted),
+        leafSize, tau, rho);
+  }
+  else
+  {
+    arma::mat converted;
+    ConvertPoints(std::move(points), converted);
+    TypedWrapper<double>()->InsertReferencePoints(std::move(converted),
+        leafSize, tau, rho);
+  }
+}
+
+//! Delete points from the reference set.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::DeleteReferencePoints(
+    const arma::Col<size_t>& indices)
+{
+  nSearch->DeleteReferencePoints(indices, leafSize, tau, rho);
+}
+
+//! Get the number of points in the current reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::NumReferencePoints() const
+{
+  return nSearch->NumReferencePoints();
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
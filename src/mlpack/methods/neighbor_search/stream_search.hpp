@@ -0,0 +1,225 @@
+/**
+ * @file methods/neighbor_search/stream_search.hpp
+ *
+ * Out-of-core neighbor search: query points are read from a text file in
+ * chunks, and the results of each chunk are written to the output files before
+ * the next chunk is read, so the memory used does not depend on the number of
+ * query points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_STREAM_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_STREAM_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Read up to maxPoints points from the given stream, which holds one point per
+ * line, with the dimensions separated by commas, tabs or spaces (i.e. a CSV or
+ * plain text file as saved by data::Save()).  Empty lines are skipped.  A
+ * std::runtime_error is thrown if a line can't be parsed or has a different
+ * number of dimensions than the given one.
+ *
+ * @param stream Stream to read from.
+ * @param maxPoints Maximum number of points to read.
+ * @param dimensionality Number of dimensions of each point; if 0, it is set to
+ *     the number of values on the first line read.
+ * @param lineNumber Number of lines read from the stream so far (for error
+ *     messages); this is updated.
+ * @param points Matrix to store the points in, one point per column.
+ * @return Whether any point was read.
+ */
+inline bool ReadPointChunk(std::istream& stream,
+                           const size_t maxPoints,
+                           size_t& dimensionality,
+                           size_t& lineNumber,
+                           arma::mat& points)
+{
+  std::vector<double> values;
+  std::string line;
+  size_t numPoints = 0;
+  while (numPoints < maxPoints && std::getline(stream, line))
+  {
+    ++lineNumber;
+
+    const size_t oldSize = values.size();
+    const char* position = line.c_str();
+    char* end;
+    while (true)
+    {
+      // Skip separators.
+      while (*position == ',' || *position == ' ' || *position == '\t' ||
+             *position == '\r')
+        ++position;
+      if (*position == '\0')
+        break;
+
+      const double value = std::strtod(position, &end);
+      if (end == position)
+      {
+        std::ostringstream oss;
+        oss << "cannot parse line " << lineNumber << " of query points";
+        throw std::runtime_error(oss.str());
+      }
+
+      values.push_back(value);
+      position = end;
+    }
+
+    const size_t numValues = values.size() - oldSize;
+    if (numValues == 0)
+      continue;
+
+    if (dimensionality == 0)
+      dimensionality = numValues;
+
+    if (numValues != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "line " << lineNumber << " of query points has " << numValues
+          << " dimensions, but " << dimensionality << " were expected";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++numPoints;
+  }
+
+  if (numPoints == 0)
+    return false;
+
+  points = arma::mat(values.data(), dimensionality, numPoints);
+  return true;
+}
+
+/**
+ * Write each column of the given matrix as one line of comma-separated values
+ * (the CSV layout of data::Save()).
+ *
+ * @param stream Stream to write to.
+ * @param matrix Matrix to write.
+ */
+template<typename eT>
+void WriteColumns(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  for (size_t i = 0; i < matrix.n_cols; ++i)
+  {
+    for (size_t j = 0; j < matrix.n_rows; ++j)
+    {
+      if (j > 0)
+        stream << ',';
+      stream << matrix(j, i);
+    }
+    stream << '\n';
+  }
+}
+
+/**
+ * Search for the k neighbors of each of the points in the given query file,
+ * reading and searching chunkSize points at a time, and write the results of
+ * each chunk to the neighbors and distances files as soon as they are
+ * computed.  The query file must hold one point per line (see
+ * ReadPointChunk()); both output files get one line per query point, in the
+ * order of the query file.  Either output file name may be empty, in which case
+ * those results are not written.  A std::runtime_error is thrown if a file
+ * can't be opened, written or parsed.
+ *
+ * The model can be any class with a Search(arma::mat&&, k, neighbors,
+ * distances) method and a Dimensionality() method, such as NSModel.
+ *
+ * @param model Trained model to search with.
+ * @param queryFile File to read query points from.
+ * @param neighborsFile File to write the neighbors to (may be empty).
+ * @param distancesFile File to write the distances to (may be empty).
+ * @param k Number of neighbors to search for.
+ * @param chunkSize Number of query points to search for at once.
+ * @return The number of query points searched for.
+ */
+template<typename ModelType>
+size_t StreamSearch(ModelType& model,
+                    const std::string& queryFile,
+                    const std::string& neighborsFile,
+                    const std::string& distancesFile,
+                    const size_t k,
+                    const size_t chunkSize)
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("StreamSearch(): chunk size must be positive");
+
+  std::ifstream queryStream(queryFile);
+  if (!queryStream.is_open())
+    throw std::runtime_error("cannot open query file '" + queryFile + "'");
+
+  std::ofstream neighborsStream, distancesStream;
+  if (!neighborsFile.empty())
+  {
+    neighborsStream.open(neighborsFile);
+    if (!neighborsStream.is_open())
+    {
+      throw std::runtime_error("cannot open neighbors file '" + neighborsFile +
+          "'");
+    }
+  }
+  if (!distancesFile.empty())
+  {
+    distancesStream.open(distancesFile);
+    if (!distancesStream.is_open())
+    {
+      throw std::runtime_error("cannot open distances file '" + distancesFile +
+          "'");
+    }
+    distancesStream << std::setprecision(
+        std::numeric_limits<double>::max_digits10);
+  }
+
+  size_t dimensionality = model.Dimensionality();
+  size_t lineNumber = 0;
+  size_t numQueries = 0;
+  arma::mat chunk;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  while (ReadPointChunk(queryStream, chunkSize, dimensionality, lineNumber,
+      chunk))
+  {
+    numQueries += chunk.n_cols;
+    model.Search(std::move(chunk), k, neighbors, distances);
+
+    if (!neighborsFile.empty())
+    {
+      WriteColumns(neighborsStream, neighbors);
+      if (!neighborsStream.good())
+      {
+        throw std::runtime_error("cannot write to neighbors file '" +
+            neighborsFile + "'");
+      }
+    }
+
+    if (!distancesFile.empty())
+    {
+      WriteColumns(distancesStream, distances);
+      if (!distancesStream.good())
+      {
+        throw std::runtime_error("cannot write to distances file '" +
+            distancesFile + "'");
+      }
+    }
+
+    Log::Info << "Searched for the neighbors of " << numQueries << " query "
+        << "points." << std::endl;
+  }
+
+  return numQueries;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
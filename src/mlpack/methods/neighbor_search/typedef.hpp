@@ -66,6 +66,23 @@ using DefeatistKNN = NeighborSearch<
  */
 typedef DefeatistKNN<tree::SPTree> SpillKNN;
 
+/**
+ * KNN and KFN are compiled into libmlpack (in typedef.cpp), so that the
+ * programs that use them don't have to instantiate them again.
+ *
+ * @cond
+ */
+
+extern template class NeighborSearch<NearestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+extern template class NeighborSearch<FurthestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+/**
+ * @endcond
+ */
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -0,0 +1,254 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD method for use in the Principal
+ * Components Analysis method, which updates the decomposition from
+ * mini-batches of points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "policy_traits.hpp"
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental SVD policy, following the sequential
+ * Karhunen-Loeve update with a mean update described in the paper below.
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title={Incremental learning for robust visual tracking},
+ *   author={Ross, D.A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   journal={International Journal of Computer Vision},
+ *   volume={77},
+ *   number={1--3},
+ *   pages={125--141},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * The mean, the top singular values and the left singular vectors of the
+ * centered data seen so far are kept.  Each mini-batch of points is centered
+ * on its own mean and stacked next to the current singular vectors (scaled by
+ * their singular values) and a correction column for the change of the mean;
+ * the thin SVD of that d x (rank + batchSize + 1) matrix gives the new
+ * decomposition.  The memory used is therefore independent of the number of
+ * points, and the data never has to be centered as a whole.  If the rank is
+ * at least the dimensionality of the data, the result is exact.
+ *
+ * When used by PCA, Apply() streams over the data in batches of BatchSize()
+ * points.  To process a stream, call Update() for each mini-batch, and then
+ * Transform() to project points onto the current components.
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Create the incremental SVD policy.
+   *
+   * @param batchSize Number of points in each mini-batch used by Apply(); if 0,
+   *     the whole dataset is a single batch.
+   */
+  IncrementalSVDPolicy(const size_t batchSize = 1000) :
+      batchSize(batchSize),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental SVD.  Any previous state of the decomposition is cleared.
+   *
+   * @param data Data matrix.
+   * @param centeredData Data matrix to decompose; it does not need to be
+   *     centered.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    Reset();
+
+    const size_t step = (batchSize == 0) ? centeredData.n_cols : batchSize;
+    for (size_t first = 0; first < centeredData.n_cols; first += step)
+    {
+      const size_t last = std::min(first + step, centeredData.n_cols) - 1;
+      Update(centeredData.cols(first, last), rank);
+    }
+
+    EigenValues(eigVal);
+    eigvec = components;
+
+    // The transformed data may be the same matrix as the input.
+    arma::mat transformed;
+    Transform(centeredData, transformed);
+    transformedData = std::move(transformed);
+  }
+
+  /**
+   * Update the decomposition with a mini-batch of points, keeping at most
+   * the given number of components.
+   *
+   * @param batch Points to add to the decomposition.
+   * @param rank Maximum number of components to keep; if 0, all are kept.
+   */
+  void Update(const arma::mat& batch, const size_t rank)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (numPoints > 0 && batch.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalSVDPolicy::Update(): batch has " << batch.n_rows
+          << " dimensions, but the decomposition has " << mean.n_elem << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const double n = (double) numPoints;
+    const double m = (double) batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+
+    // Stack the scaled current components, the centered batch, and the
+    // correction for the difference of the means.
+    const size_t k = components.n_cols;
+    arma::mat stacked(batch.n_rows, k + batch.n_cols + (numPoints > 0 ? 1 : 0));
+    if (k > 0)
+    {
+      stacked.cols(0, k - 1) = components;
+      stacked.cols(0, k - 1).each_row() %= singularValues.t();
+    }
+    stacked.cols(k, k + batch.n_cols - 1) = batch.each_col() - batchMean;
+    if (numPoints > 0)
+      stacked.col(stacked.n_cols - 1) = std::sqrt(n * m / (n + m)) *
+          (mean - batchMean);
+
+    arma::mat u, v;
+    arma::vec s;
+    if (!arma::svd_econ(u, s, v, stacked, 'l'))
+    {
+      throw std::runtime_error("IncrementalSVDPolicy::Update(): singular "
+          "value decomposition failed!");
+    }
+
+    const size_t keep = (rank == 0) ? s.n_elem : std::min(rank, s.n_elem);
+    components = u.cols(0, keep - 1);
+    singularValues = s.subvec(0, keep - 1);
+
+    if (numPoints == 0)
+      mean = batchMean;
+    else
+      mean = (n * mean + m * batchMean) / (n + m);
+    numPoints += batch.n_cols;
+  }
+
+  /**
+   * Project the given points onto the current components.  The points are
+   * not centered in a copy; the projection of the mean is subtracted from the
+   * projected points instead.
+   *
+   * @param points Points to project.
+   * @param transformed Matrix to store the projected points in.
+   */
+  void Transform(const arma::mat& points, arma::mat& transformed) const
+  {
+    if (numPoints == 0)
+    {
+      throw std::runtime_error("IncrementalSVDPolicy::Transform(): no points "
+          "have been added to the decomposition!");
+    }
+
+    transformed = components.t() * points;
+    transformed.each_col() -= components.t() * mean;
+  }
+
+  /**
+   * Compute the eigenvalues of the covariance matrix for the current
+   * components.
+   *
+   * @param eigVal Vector to store the eigenvalues in.
+   */
+  void EigenValues(arma::vec& eigVal) const
+  {
+    // The covariance matrix is X * X' / (N - 1).
+    if (numPoints < 2)
+      eigVal.zeros(singularValues.n_elem);
+    else
+      eigVal = arma::square(singularValues) / (numPoints - 1);
+  }
+
+  //! Clear the decomposition.
+  void Reset()
+  {
+    mean.reset();
+    components.reset();
+    singularValues.reset();
+    numPoints = 0;
+  }
+
+  //! Get the number of points in each mini-batch used by Apply().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch used by Apply().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the current components (left singular vectors).
+  const arma::mat& Components() const { return components; }
+  //! Get the current singular values.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the number of points seen so far.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Serialize the decomposition.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(batchSize));
+    ar(CEREAL_NVP(mean));
+    ar(CEREAL_NVP(components));
+    ar(CEREAL_NVP(singularValues));
+    ar(CEREAL_NVP(numPoints));
+  }
+
+ private:
+  //! Number of points in each mini-batch used by Apply().
+  size_t batchSize;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Left singular vectors of the centered points seen so far.
+  arma::mat components;
+  //! Singular values of the centered points seen so far.
+  arma::vec singularValues;
+  //! Number of points seen so far.
+  size_t numPoints;
+};
+
+//! IncrementalSVDPolicy centers each mini-batch itself.
+template<>
+class DecompositionPolicyTraits<IncrementalSVDPolicy>
+{
+ public:
+  static const bool CentersData = true;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file methods/pca/decomposition_policies/policy_traits.hpp
+ *
+ * Traits of the decomposition policies used by PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_POLICY_TRAITS_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_POLICY_TRAITS_HPP
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * This class holds the traits of a decomposition policy for PCA.  By default
+ * the policy is given a centered copy of the data; a policy that centers the
+ * data itself should specialize this class.
+ */
+template<typename DecompositionPolicy>
+class DecompositionPolicyTraits
+{
+ public:
+  /**
+   * If true, the policy centers the data itself, so when the data does not
+   * have to be scaled, PCA passes the original data as the centered data and
+   * no centered copy is made.
+   */
+  static const bool CentersData = false;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -17,7 +17,9 @@
 #define MLPACK_METHODS_PCA_PCA_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/lin_alg.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/policy_traits.hpp>
 
 namespace mlpack {
 namespace pca {
@@ -141,6 +143,22 @@ class PCA
     }
   }
 
+  /**
+   * Return the data to give to the decomposition policy: the data itself if
+   * the policy centers it and no scaling is needed, and otherwise a centered
+   * (and possibly scaled) copy, stored in centeredData.
+   */
+  const arma::mat& CenterData(const arma::mat& data, arma::mat& centeredData)
+  {
+    if (DecompositionPolicyTraits<DecompositionPolicy>::CentersData &&
+        !scaleData)
+      return data;
+
+    math::Center(data, centeredData);
+    ScaleData(centeredData);
+    return centeredData;
+  }
+
   //! Whether or not the data will be scaled by standard deviation when PCA is
   //! performed.
   bool scaleData;
@@ -46,14 +46,12 @@ void PCA<DecompositionPolicy>::Apply(const arma::mat& data,
 {
   Timer::Start("pca");
 
-  // Center the data into a temporary matrix.
+  // Center the data into a temporary matrix (unless the decomposition policy
+  // centers it itself), and scale the data if the user asked for it.
   arma::mat centeredData;
-  math::Center(data, centeredData);
+  const arma::mat& policyData = CenterData(data, centeredData);
 
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
+  decomposition.Apply(data, policyData, transformedData, eigVal, eigvec,
       data.n_rows);
 
   Timer::Stop("pca");
@@ -119,16 +117,15 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
 
   Timer::Start("pca");
 
-  // Center the data into a temporary matrix.
+  // Center the data into a temporary matrix (unless the decomposition policy
+  // centers it itself), and scale the data if the user asked for it.
   arma::mat centeredData;
-  math::Center(data, centeredData);
-
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
+  const arma::mat& policyData = CenterData(data, centeredData);
 
-  decomposition.Apply(data, centeredData, data, eigVal, eigvec, newDimension);
+  decomposition.Apply(data, policyData, data, eigVal, eigvec, newDimension);
 
-  if (newDimension < eigvec.n_rows)
+  // Policies may return fewer dimensions than the data has.
+  if (newDimension < data.n_rows)
     // Drop unnecessary rows.
     data.shed_rows(newDimension, data.n_rows - 1);
 
@@ -0,0 +1,231 @@
+/**
+ * @file methods/product_quantization/ivf_pq_search.cpp
+ *
+ * Implementation of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ivf_pq_search.hpp"
+
+#include <mlpack/core/util/size_checks.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+IVFPQSearch::IVFPQSearch(const size_t numLists,
+                         const size_t numSubspaces,
+                         const size_t numCentroids,
+                         const size_t maxIterations) :
+    numLists(numLists),
+    maxIterations(maxIterations),
+    quantizer(numSubspaces, numCentroids, maxIterations),
+    numPoints(0)
+{
+  if (numLists == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::IVFPQSearch(): numLists must be "
+        "greater than 0!");
+  }
+}
+
+void IVFPQSearch::Train(const arma::mat& trainingSet)
+{
+  if (trainingSet.n_cols < numLists)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): training set has " << trainingSet.n_cols
+        << " points, but at least " << numLists << " are needed for the coarse "
+        << "quantizer!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("ivf_pq_training");
+
+  arma::Row<size_t> assignments;
+  kmeans::KMeans<> kmeans(maxIterations);
+  kmeans.Cluster(trainingSet, numLists, assignments, coarseCentroids);
+
+  // The product quantizer encodes the residuals to the coarse centroids.
+  arma::mat residuals(trainingSet.n_rows, trainingSet.n_cols);
+  for (size_t i = 0; i < trainingSet.n_cols; ++i)
+    residuals.col(i) = trainingSet.col(i) - coarseCentroids.col(assignments[i]);
+  quantizer.Train(residuals);
+
+  listCodes.clear();
+  listCodes.resize(numLists);
+  listIndices.clear();
+  listIndices.resize(numLists);
+  numPoints = 0;
+
+  Timer::Stop("ivf_pq_training");
+}
+
+void IVFPQSearch::Add(const arma::mat& points)
+{
+  if (coarseCentroids.n_cols == 0)
+  {
+    throw std::runtime_error("IVFPQSearch::Add(): the index must be trained "
+        "before points are added!");
+  }
+
+  util::CheckSameDimensionality(points, coarseCentroids, "IVFPQSearch::Add()",
+      "points");
+
+  Timer::Start("ivf_pq_encoding");
+
+  const size_t numSubspaces = quantizer.NumSubspaces();
+  arma::Row<size_t> lists(points.n_cols);
+  arma::Mat<unsigned char> codes(numSubspaces, points.n_cols);
+  #pragma omp parallel
+  {
+    arma::vec residual(points.n_rows);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    {
+      lists[i] = NearestList(points.colptr(i));
+      residual = points.col(i) - coarseCentroids.col(lists[i]);
+      quantizer.Encode(residual.memptr(), codes.colptr(i));
+    }
+  }
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    listCodes[lists[i]].insert(listCodes[lists[i]].end(), codes.colptr(i),
+        codes.colptr(i) + numSubspaces);
+    listIndices[lists[i]].push_back(numPoints + i);
+  }
+  numPoints += points.n_cols;
+
+  Timer::Stop("ivf_pq_encoding");
+}
+
+void IVFPQSearch::Search(const arma::mat& querySet,
+                         const size_t k,
+                         arma::Mat<size_t>& neighbors,
+                         arma::mat& distances,
+                         const size_t numProbes) const
+{
+  if (coarseCentroids.n_cols == 0)
+  {
+    throw std::runtime_error("IVFPQSearch::Search(): the index must be "
+        "trained before searching!");
+  }
+
+  util::CheckSameDimensionality(querySet, coarseCentroids,
+      "IVFPQSearch::Search()", "query set");
+
+  if (k > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but the index has " << numPoints << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (k == 0)
+    return;
+
+  Timer::Start("computing_neighbors");
+
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  const size_t numSubspaces = quantizer.NumSubspaces();
+  typedef std::pair<double, size_t> Candidate;
+
+  #pragma omp parallel
+  {
+    arma::vec residual(querySet.n_rows);
+    arma::mat table;
+    std::vector<Candidate> cells(numLists);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      // Find the cells closest to the query.
+      for (size_t l = 0; l < numLists; ++l)
+      {
+        cells[l] = Candidate(arma::accu(arma::square(querySet.col(i) -
+            coarseCentroids.col(l))), l);
+      }
+      std::partial_sort(cells.begin(), cells.begin() + probes, cells.end());
+
+      // Keep the k best candidates in a max-heap.
+      std::priority_queue<Candidate> best;
+      for (size_t p = 0; p < probes; ++p)
+      {
+        const size_t list = cells[p].second;
+        if (listIndices[list].empty())
+          continue;
+
+        residual = querySet.col(i) - coarseCentroids.col(list);
+        quantizer.DistanceTable(residual.memptr(), table);
+
+        const unsigned char* code = listCodes[list].data();
+        const std::vector<size_t>& indices = listIndices[list];
+        for (size_t j = 0; j < indices.size(); ++j, code += numSubspaces)
+        {
+          const double distance = ProductQuantizer::Distance(table, code);
+          if (best.size() < k)
+          {
+            best.push(Candidate(distance, indices[j]));
+          }
+          else if (distance < best.top().first)
+          {
+            best.pop();
+            best.push(Candidate(distance, indices[j]));
+          }
+        }
+      }
+
+      for (size_t j = k; j > best.size(); --j)
+      {
+        neighbors(j - 1, i) = numPoints;
+        distances(j - 1, i) = DBL_MAX;
+      }
+
+      while (!best.empty())
+      {
+        neighbors(best.size() - 1, i) = best.top().second;
+        distances(best.size() - 1, i) = std::sqrt(best.top().first);
+        best.pop();
+      }
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+size_t IVFPQSearch::NearestList(const double* point) const
+{
+  size_t best = 0;
+  double bestDistance = DBL_MAX;
+  for (size_t l = 0; l < coarseCentroids.n_cols; ++l)
+  {
+    const double* centroid = coarseCentroids.colptr(l);
+    double distance = 0.0;
+    for (size_t d = 0; d < coarseCentroids.n_rows; ++d)
+    {
+      const double diff = point[d] - centroid[d];
+      distance += diff * diff;
+    }
+
+    if (distance < bestDistance)
+    {
+      bestDistance = distance;
+      best = l;
+    }
+  }
+
+  return best;
+}
+
+} // namespace neighbor
+} // namespace mlpack
@@ -0,0 +1,148 @@
+/**
+ * @file methods/product_quantization/ivf_pq_search.hpp
+ *
+ * An inverted file index with product-quantized residuals (IVF-PQ) for
+ * approximate nearest neighbor search on reference sets that are too large to
+ * keep in memory uncompressed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * IVFPQSearch is an approximate nearest neighbor index in which the reference
+ * points are not stored, only their product quantization codes.  A coarse
+ * k-means quantizer splits the space into `numLists` cells; each reference
+ * point is added to the inverted list of its nearest cell, and the residual
+ * between the point and the cell centroid is encoded with a ProductQuantizer.
+ * A search visits the `numProbes` cells closest to the query and ranks the
+ * points in their lists with asymmetric distances, so the cost of a search is
+ * a fraction of a linear scan over the compressed codes.
+ *
+ * The index is trained on a sample of the data with Train(); reference points
+ * are then added in batches of any size with Add(), so the full reference set
+ * never has to be in memory at once.  The neighbor indices returned by
+ * Search() are the order in which the points were added.
+ */
+class IVFPQSearch
+{
+ public:
+  /**
+   * Create an untrained index.
+   *
+   * @param numLists Number of cells of the coarse quantizer.
+   * @param numSubspaces Number of subspaces (and bytes per point) of the
+   *     product quantizer.
+   * @param numCentroids Number of centroids in each subspace; at most 256.
+   * @param maxIterations Maximum number of k-means iterations used in
+   *     training.
+   */
+  IVFPQSearch(const size_t numLists = 100,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const size_t maxIterations = 25);
+
+  /**
+   * Train the coarse quantizer and the product quantizer on the given
+   * training set, removing any points already added to the index.  The
+   * training set must have at least as many points as there are lists and
+   * centroids per subspace.
+   *
+   * @param trainingSet Set of points to learn the quantizers from.
+   */
+  void Train(const arma::mat& trainingSet);
+
+  /**
+   * Encode the given points and add them to the index.  The index must be
+   * trained.
+   *
+   * @param points Points to add.
+   */
+  void Add(const arma::mat& points);
+
+  /**
+   * Search for the approximate k nearest neighbors of each query point.  The
+   * output matrices have k rows and one column per query point, sorted from
+   * nearest to furthest, and the distances are the approximate Euclidean
+   * distances to the encoded points.  If fewer than k points are in the
+   * probed lists, the remaining entries hold the index NumPoints() and the
+   * distance DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param numProbes Number of lists to search for each query point.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t numProbes = 1) const;
+
+  //! Get the number of lists.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of points in the index.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the product quantizer.
+  const ProductQuantizer& Quantizer() const { return quantizer; }
+  //! Get the centroids of the coarse quantizer.
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+
+  //! Get the indices of the points in the given list.
+  const std::vector<size_t>& ListIndices(const size_t list) const
+  { return listIndices[list]; }
+  //! Get the codes of the points in the given list, NumSubspaces() bytes per
+  //! point.
+  const std::vector<unsigned char>& ListCodes(const size_t list) const
+  { return listCodes[list]; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(numLists));
+    ar(CEREAL_NVP(maxIterations));
+    ar(CEREAL_NVP(quantizer));
+    ar(CEREAL_NVP(coarseCentroids));
+    ar(CEREAL_NVP(listCodes));
+    ar(CEREAL_NVP(listIndices));
+    ar(CEREAL_NVP(numPoints));
+  }
+
+ private:
+  //! Find the cell of the coarse quantizer closest to the given point.
+  size_t NearestList(const double* point) const;
+
+  //! Number of cells of the coarse quantizer.
+  size_t numLists;
+  //! Maximum number of k-means iterations for the coarse quantizer.
+  size_t maxIterations;
+  //! Quantizer of the residuals.
+  ProductQuantizer quantizer;
+  //! Centroids of the coarse quantizer.
+  arma::mat coarseCentroids;
+  //! Codes of the points in each list.
+  std::vector<std::vector<unsigned char>> listCodes;
+  //! Indices of the points in each list.
+  std::vector<std::vector<size_t>> listIndices;
+  //! Number of points in the index.
+  size_t numPoints;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
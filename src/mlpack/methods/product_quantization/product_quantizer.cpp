@@ -0,0 +1,170 @@
+/**
+ * @file methods/product_quantization/product_quantizer.cpp
+ *
+ * Implementation of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "product_quantizer.hpp"
+
+#include <mlpack/core/util/size_checks.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+ProductQuantizer::ProductQuantizer(const size_t numSubspaces,
+                                   const size_t numCentroids,
+                                   const size_t maxIterations) :
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    maxIterations(maxIterations),
+    dimensionality(0)
+{
+  if (numSubspaces == 0)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): "
+        "numSubspaces must be greater than 0!");
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): "
+        "numCentroids must be between 1 and 256!");
+  }
+}
+
+void ProductQuantizer::Train(const arma::mat& data)
+{
+  if (data.n_rows < numSubspaces)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): data has " << data.n_rows
+        << " dimensions, but " << numSubspaces << " subspaces were requested!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols < numCentroids)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): data has " << data.n_cols
+        << " points, but at least " << numCentroids << " are needed to learn "
+        << "the codebooks!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  dimensionality = data.n_rows;
+  centroids.resize(numSubspaces);
+
+  // k-means uses the global random number generator, so the codebooks are
+  // learned one after another.
+  kmeans::KMeans<> kmeans(maxIterations);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const arma::mat subspaceData = data.rows(SubspaceBegin(s),
+        SubspaceBegin(s + 1) - 1);
+    kmeans.Cluster(subspaceData, numCentroids, centroids[s]);
+  }
+}
+
+void ProductQuantizer::Encode(const double* point, unsigned char* code) const
+{
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const size_t begin = SubspaceBegin(s);
+    const size_t subspaceDims = SubspaceBegin(s + 1) - begin;
+    const arma::mat& codebook = centroids[s];
+
+    size_t best = 0;
+    double bestDistance = DBL_MAX;
+    for (size_t c = 0; c < codebook.n_cols; ++c)
+    {
+      const double* centroid = codebook.colptr(c);
+      double distance = 0.0;
+      for (size_t d = 0; d < subspaceDims; ++d)
+      {
+        const double diff = point[begin + d] - centroid[d];
+        distance += diff * diff;
+      }
+
+      if (distance < bestDistance)
+      {
+        bestDistance = distance;
+        best = c;
+      }
+    }
+
+    code[s] = (unsigned char) best;
+  }
+}
+
+void ProductQuantizer::Encode(const arma::mat& data,
+                              arma::Mat<unsigned char>& codes) const
+{
+  if (dimensionality == 0)
+  {
+    throw std::runtime_error("ProductQuantizer::Encode(): the quantizer must "
+        "be trained before encoding!");
+  }
+
+  util::CheckSameDimensionality(data, dimensionality,
+      "ProductQuantizer::Encode()", "data");
+
+  codes.set_size(numSubspaces, data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    Encode(data.colptr(i), codes.colptr(i));
+}
+
+void ProductQuantizer::Decode(const arma::Mat<unsigned char>& codes,
+                              arma::mat& data) const
+{
+  if (codes.n_rows != numSubspaces)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Decode(): codes have " << codes.n_rows
+        << " rows, but the quantizer has " << numSubspaces << " subspaces!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  data.set_size(dimensionality, codes.n_cols);
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      const size_t begin = SubspaceBegin(s);
+      data.col(i).subvec(begin, SubspaceBegin(s + 1) - 1) =
+          centroids[s].col(codes(s, i));
+    }
+  }
+}
+
+void ProductQuantizer::DistanceTable(const double* query,
+                                     arma::mat& table) const
+{
+  table.set_size(numCentroids, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const size_t begin = SubspaceBegin(s);
+    const size_t subspaceDims = SubspaceBegin(s + 1) - begin;
+    const arma::mat& codebook = centroids[s];
+    for (size_t c = 0; c < codebook.n_cols; ++c)
+    {
+      const double* centroid = codebook.colptr(c);
+      double distance = 0.0;
+      for (size_t d = 0; d < subspaceDims; ++d)
+      {
+        const double diff = query[begin + d] - centroid[d];
+        distance += diff * diff;
+      }
+
+      table(c, s) = distance;
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
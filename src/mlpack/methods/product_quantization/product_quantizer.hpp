@@ -0,0 +1,169 @@
+/**
+ * @file methods/product_quantization/product_quantizer.hpp
+ *
+ * Product quantization of vectors into compact byte codes, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011},
+ *   publisher={IEEE}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_PRODUCT_QUANTIZATION_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ProductQuantizer class splits the dimensions of the data into a number
+ * of contiguous subspaces and learns a codebook of at most 256 centroids in
+ * each subspace with k-means.  Each vector is then stored as one byte per
+ * subspace: the index of the nearest centroid of its subvector.  With 8-byte
+ * doubles and one subspace for every 8 dimensions, this reduces the memory of
+ * a vector 64 times.
+ *
+ * Squared Euclidean distances between an uncompressed query and the encoded
+ * vectors are computed asymmetrically: DistanceTable() computes the distance
+ * between the query and every centroid once, after which the distance to each
+ * code is the sum of one table entry per subspace (see Distance()).
+ */
+class ProductQuantizer
+{
+ public:
+  /**
+   * Create an untrained product quantizer.
+   *
+   * @param numSubspaces Number of subspaces (and bytes per code).
+   * @param numCentroids Number of centroids in each subspace; at most 256.
+   * @param maxIterations Maximum number of k-means iterations used to learn
+   *     each codebook.
+   */
+  ProductQuantizer(const size_t numSubspaces = 8,
+                   const size_t numCentroids = 256,
+                   const size_t maxIterations = 25);
+
+  /**
+   * Learn the codebooks from the given training set, which must have at least
+   * as many points as centroids and at least numSubspaces dimensions.  A
+   * representative sample of the data is sufficient.
+   *
+   * @param data Training set.
+   */
+  void Train(const arma::mat& data);
+
+  /**
+   * Encode the given points.  The codes have one row per subspace and one
+   * column per point.
+   *
+   * @param data Points to encode.
+   * @param codes Matrix to store the codes in.
+   */
+  void Encode(const arma::mat& data, arma::Mat<unsigned char>& codes) const;
+
+  /**
+   * Encode a single point into numSubspaces bytes.
+   *
+   * @param point Pointer to the Dimensionality() elements of the point.
+   * @param code Pointer to the NumSubspaces() bytes to store the code in.
+   */
+  void Encode(const double* point, unsigned char* code) const;
+
+  /**
+   * Reconstruct approximate points from the given codes.
+   *
+   * @param codes Codes to decode.
+   * @param data Matrix to store the reconstructed points in.
+   */
+  void Decode(const arma::Mat<unsigned char>& codes, arma::mat& data) const;
+
+  /**
+   * Compute the squared Euclidean distances between the given query and every
+   * centroid of every subspace.  The table has one row per centroid and one
+   * column per subspace.
+   *
+   * @param query Pointer to the Dimensionality() elements of the query.
+   * @param table Matrix to store the distances in.
+   */
+  void DistanceTable(const double* query, arma::mat& table) const;
+
+  /**
+   * Compute the approximate squared Euclidean distance between a query and an
+   * encoded vector, using the distance table of the query.
+   *
+   * @param table Distance table computed with DistanceTable().
+   * @param code Pointer to the NumSubspaces() bytes of the code.
+   */
+  static double Distance(const arma::mat& table, const unsigned char* code)
+  {
+    double distance = 0.0;
+    const double* column = table.memptr();
+    for (size_t s = 0; s < table.n_cols; ++s, column += table.n_rows)
+      distance += column[code[s]];
+    return distance;
+  }
+
+  //! Get the number of subspaces.
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids in each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get the maximum number of k-means iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of k-means iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the dimensionality of the encoded vectors (0 if not trained).
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the first dimension of the given subspace; subspace NumSubspaces()
+  //! gives the dimensionality.
+  size_t SubspaceBegin(const size_t subspace) const
+  { return subspace * dimensionality / numSubspaces; }
+
+  //! Get the centroids of the given subspace, one per column.
+  const arma::mat& Centroids(const size_t subspace) const
+  { return centroids[subspace]; }
+
+  //! Serialize the quantizer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(numSubspaces));
+    ar(CEREAL_NVP(numCentroids));
+    ar(CEREAL_NVP(maxIterations));
+    ar(CEREAL_NVP(dimensionality));
+    ar(CEREAL_NVP(centroids));
+  }
+
+ private:
+  //! Number of subspaces.
+  size_t numSubspaces;
+  //! Number of centroids in each subspace.
+  size_t numCentroids;
+  //! Maximum number of k-means iterations.
+  size_t maxIterations;
+  //! Dimensionality of the encoded vectors.
+  size_t dimensionality;
+  //! Centroids of each subspace.
+  std::vector<arma::mat> centroids;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
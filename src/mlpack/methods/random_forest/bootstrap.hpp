@@ -18,6 +18,8 @@ namespace tree {
 
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ * The indices of the points that were not drawn (the out-of-bag points) are
+ * stored in outOfBag, in increasing order.
  */
 template<bool UseWeights,
          typename MatType,
@@ -28,20 +30,49 @@ void Bootstrap(const MatType& dataset,
                const WeightsType& weights,
                MatType& bootstrapDataset,
                LabelsType& bootstrapLabels,
-               WeightsType& bootstrapWeights)
+               WeightsType& bootstrapWeights,
+               arma::uvec& outOfBag)
 {
   bootstrapDataset.set_size(dataset.n_rows, dataset.n_cols);
   bootstrapLabels.set_size(labels.n_elem);
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
 
-  // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  // Random sampling with replacement.  This is called inside parallel regions,
+  // so the indices are drawn with math::RandInt(), which uses the generator
+  // of the calling thread there.
+  arma::uvec indices(dataset.n_cols);
+  arma::Col<unsigned char> drawn(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    indices[i] = math::RandInt(dataset.n_cols);
+    drawn[indices[i]] = 1;
+  }
   bootstrapDataset = dataset.cols(indices);
   bootstrapLabels = labels.cols(indices);
   if (UseWeights)
     bootstrapWeights = weights.cols(indices);
+
+  outOfBag = arma::find(drawn == 0);
+}
+
+/**
+ * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void Bootstrap(const MatType& dataset,
+               const LabelsType& labels,
+               const WeightsType& weights,
+               MatType& bootstrapDataset,
+               LabelsType& bootstrapLabels,
+               WeightsType& bootstrapWeights)
+{
+  arma::uvec outOfBag;
+  Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights, outOfBag);
 }
 
 } // namespace tree
@@ -0,0 +1,196 @@
+/**
+ * @file methods/random_forest/compact_forest.hpp
+ *
+ * The CompactForest class, which stores trained decision trees with as little
+ * memory as possible.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPACT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPACT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/map_policies/datatype.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A CompactForest is a read-only copy of trained decision trees (a
+ * RandomForest, or any number of DecisionTrees) that uses much less memory
+ * than the trees themselves, for models that must be kept in memory or stored
+ * for a long time.  Like a FlatForest, the nodes of all the trees are stored
+ * in one array in breadth-first order, but each node only takes 16 bytes: the
+ * threshold is stored as a float, the split dimension as a 16-bit integer,
+ * and the index of the first child as a 32-bit integer.  The class
+ * probabilities of the leaves are stored as floats in a pool that is shared by
+ * all the leaves of all the trees, and each distinct set of probabilities is
+ * only stored once; since most leaves of a deep forest are pure, the pool is
+ * usually tiny.  A DecisionTree node, in comparison, holds an arma::vec of
+ * class probabilities, a vector of children, and several other members.
+ *
+ * The thresholds are rounded down to floats, so the predictions are the same
+ * as those of the original trees for points whose values can be stored as
+ * floats (in particular, for arma::fmat data); other points may only go to a
+ * different child when they are closer to a threshold than the precision of a
+ * float.  The class probabilities given by Classify() are averaged over the
+ * trees, as in RandomForest, and are exact up to float precision.
+ *
+ * As for FlatForest, the trees must use threshold splits for numeric
+ * dimensions and AllCategoricalSplit for categorical dimensions.  The split
+ * dimensions must be less than 65536.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * CompactForest compact(rf);
+ * data::Save("model.bin", "model", compact);
+ *
+ * arma::Row<size_t> predictions;
+ * compact.Classify(testData, predictions);
+ * @endcode
+ */
+class CompactForest
+{
+ public:
+  /**
+   * Create an empty CompactForest.  Trees can be added with AddTree().
+   */
+  CompactForest() : numClasses(0) { }
+
+  /**
+   * Compact every tree of the given forest.
+   *
+   * @param forest Trained forest (for instance a RandomForest).
+   */
+  template<typename ForestType>
+  explicit CompactForest(const ForestType& forest);
+
+  /**
+   * Compact the given tree and add it to the forest.  Every tree must have
+   * the same number of classes.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Predict the class of the given point, and the probability of each class
+   * (the average of the probabilities given by the trees).
+   *
+   * @param point Point to classify.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points, and the probability of each class
+   * for each point (the average of the probabilities given by the trees).
+   * The points are classified in parallel.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Get the number of distinct sets of leaf class probabilities.
+  size_t NumLeafDistributions() const
+  {
+    return (numClasses == 0) ? 0 : leafProbabilities.size() / numClasses;
+  }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A node of a compacted tree.
+  struct Node
+  {
+    //! Split value of a numeric split.
+    float threshold;
+    //! Index of the first child, or of the first class probability of a leaf
+    //! in the pool.
+    uint32_t child;
+    //! Dimension the node splits on.
+    uint16_t dimension;
+    //! Number of children (0 for a leaf).
+    uint16_t numChildren;
+    //! Whether the node splits on a categorical dimension.
+    bool categorical;
+
+    //! Serialize the node.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(threshold));
+      ar(CEREAL_NVP(child));
+      ar(CEREAL_NVP(dimension));
+      ar(CEREAL_NVP(numChildren));
+      ar(CEREAL_NVP(categorical));
+    }
+  };
+
+  /**
+   * Get the index of the leaf of the given tree that the given point falls
+   * into.
+   *
+   * @param root Index of the root of the tree.
+   * @param data Matrix (or vector) holding the point.
+   * @param i Index of the point in data.
+   */
+  template<typename MatType>
+  size_t Leaf(const size_t root, const MatType& data, const size_t i) const;
+
+  //! Return the index in the pool of the given leaf class probabilities,
+  //! adding them to the pool if they aren't in it yet.
+  uint32_t PoolIndex(const std::vector<float>& probabilities);
+
+  //! The nodes of every tree.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree.
+  std::vector<uint32_t> roots;
+  //! The distinct class probabilities of the leaves, numClasses for each.
+  std::vector<float> leafProbabilities;
+  //! The index in leafProbabilities of each distinct set of probabilities.
+  //! This is only used to add trees; it is rebuilt when loading.
+  std::map<std::vector<float>, uint32_t> poolIndices;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "compact_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file methods/random_forest/compact_forest_impl.hpp
+ *
+ * Implementation of the CompactForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPACT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPACT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compact_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ForestType>
+CompactForest::CompactForest(const ForestType& forest) : numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename TreeType>
+void CompactForest::AddTree(const TreeType& tree)
+{
+  const size_t treeClasses = tree.NumClasses();
+  if (roots.empty())
+  {
+    numClasses = treeClasses;
+  }
+  else if (treeClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "CompactForest::AddTree(): the tree has " << treeClasses
+        << " classes, but the forest has " << numClasses << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Visit the tree in breadth-first order; the children of each node are
+  // given consecutive indices when the node is visited.  The nodes are only
+  // added once the whole tree is known to fit.
+  std::vector<Node> treeNodes(1);
+  std::vector<std::pair<const TreeType*, size_t>> queue;
+  queue.push_back(std::make_pair(&tree, (size_t) 0));
+  std::vector<float> probabilities(numClasses);
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    const TreeType& current = *queue[q].first;
+    const size_t index = queue[q].second;
+
+    Node node;
+    node.numChildren = (uint16_t) current.NumChildren();
+    node.dimension = 0;
+    node.threshold = 0.0f;
+    node.categorical = false;
+    if (current.NumChildren() == 0)
+    {
+      const arma::vec& treeProbabilities = current.ClassProbabilities();
+      for (size_t c = 0; c < numClasses; ++c)
+        probabilities[c] = (float) treeProbabilities[c];
+      node.child = PoolIndex(probabilities);
+    }
+    else
+    {
+      if (current.NumChildren() > std::numeric_limits<uint16_t>::max() ||
+          current.SplitDimension() > std::numeric_limits<uint16_t>::max())
+      {
+        throw std::invalid_argument("CompactForest::AddTree(): the split "
+            "dimensions and the numbers of children must be less than "
+            "65536!");
+      }
+
+      const size_t firstChild = nodes.size() + treeNodes.size();
+      if (firstChild + current.NumChildren() >
+          std::numeric_limits<uint32_t>::max())
+      {
+        throw std::invalid_argument("CompactForest::AddTree(): too many nodes "
+            "for a CompactForest!");
+      }
+
+      node.child = (uint32_t) firstChild;
+      node.dimension = (uint16_t) current.SplitDimension();
+      node.categorical = (current.SplitDimensionType() ==
+          data::Datatype::categorical);
+      if (!node.categorical)
+      {
+        // Round the threshold down, so that a value stored as a float goes to
+        // the same child as before.
+        const double threshold = current.ClassProbabilities()[0];
+        node.threshold = (float) threshold;
+        if ((double) node.threshold > threshold)
+        {
+          node.threshold = std::nextafter(node.threshold,
+              -std::numeric_limits<float>::infinity());
+        }
+      }
+
+      for (size_t c = 0; c < current.NumChildren(); ++c)
+      {
+        queue.push_back(std::make_pair(&current.Child(c),
+            treeNodes.size()));
+        treeNodes.push_back(Node());
+      }
+    }
+
+    treeNodes[index] = node;
+  }
+
+  roots.push_back((uint32_t) nodes.size());
+  nodes.insert(nodes.end(), treeNodes.begin(), treeNodes.end());
+}
+
+inline uint32_t CompactForest::PoolIndex(
+    const std::vector<float>& probabilities)
+{
+  std::map<std::vector<float>, uint32_t>::const_iterator it =
+      poolIndices.find(probabilities);
+  if (it != poolIndices.end())
+    return it->second;
+
+  if (leafProbabilities.size() + probabilities.size() >
+      std::numeric_limits<uint32_t>::max())
+  {
+    throw std::invalid_argument("CompactForest::AddTree(): too many distinct "
+        "leaves for a CompactForest!");
+  }
+
+  const uint32_t index = (uint32_t) leafProbabilities.size();
+  leafProbabilities.insert(leafProbabilities.end(), probabilities.begin(),
+      probabilities.end());
+  poolIndices[probabilities] = index;
+  return index;
+}
+
+template<typename MatType>
+size_t CompactForest::Leaf(const size_t root,
+                           const MatType& data,
+                           const size_t i) const
+{
+  size_t index = root;
+  while (nodes[index].numChildren != 0)
+  {
+    const Node& node = nodes[index];
+    const double value = data(node.dimension, i);
+    if (node.categorical)
+      index = node.child + (size_t) value;
+    else
+      index = node.child + (value <= node.threshold ? 0 : 1);
+  }
+
+  return index;
+}
+
+template<typename VecType>
+void CompactForest::Classify(const VecType& point,
+                             size_t& prediction,
+                             arma::vec& probabilities) const
+{
+  if (roots.empty())
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("CompactForest::Classify(): the forest has no "
+        "trees!");
+  }
+
+  probabilities.zeros(numClasses);
+  for (size_t t = 0; t < roots.size(); ++t)
+  {
+    const float* leaf = leafProbabilities.data() +
+        nodes[Leaf(roots[t], point, 0)].child;
+    for (size_t c = 0; c < numClasses; ++c)
+      probabilities[c] += leaf[c];
+  }
+
+  probabilities /= roots.size();
+  prediction = probabilities.index_max();
+}
+
+template<typename MatType>
+void CompactForest::Classify(const MatType& data,
+                             arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void CompactForest::Classify(const MatType& data,
+                             arma::Row<size_t>& predictions,
+                             arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("CompactForest::Classify(): the forest has no "
+        "trees!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    double* point = probabilities.colptr(i);
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      const float* leaf = leafProbabilities.data() +
+          nodes[Leaf(roots[t], data, i)].child;
+      for (size_t c = 0; c < numClasses; ++c)
+        point[c] += leaf[c];
+    }
+
+    probabilities.col(i) /= roots.size();
+    predictions[i] = probabilities.col(i).index_max();
+  }
+}
+
+template<typename Archive>
+void CompactForest::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(nodes));
+  ar(CEREAL_NVP(leafProbabilities));
+
+  // Rebuild the index of the pool, so that more trees can be added.
+  if (cereal::is_loading<Archive>())
+  {
+    poolIndices.clear();
+    for (size_t i = 0; i + numClasses <= leafProbabilities.size() &&
+        numClasses > 0; i += numClasses)
+    {
+      poolIndices[std::vector<float>(leafProbabilities.begin() + i,
+          leafProbabilities.begin() + i + numClasses)] = (uint32_t) i;
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file methods/random_forest/flat_forest.hpp
+ *
+ * The FlatForest class, which stores trained decision trees in contiguous
+ * arrays for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/map_policies/datatype.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A FlatForest is a read-only copy of trained decision trees (a RandomForest,
+ * or any number of DecisionTrees) that is laid out for fast classification.
+ * The nodes of all the trees are stored in one contiguous array, in
+ * breadth-first order so that the children of a node are next to each other,
+ * and the class probabilities of the leaves are stored in another array.
+ * Classify() then goes down each tree with integer offsets instead of pointers,
+ * and processes the points in blocks so that the nodes of a tree stay in cache
+ * while the points of a block go through it.  The blocks are classified in
+ * parallel.
+ *
+ * The predictions are the same as those of the trees that were flattened: the
+ * class probabilities of the trees are averaged, as in RandomForest.  The
+ * trees must use threshold splits for numeric dimensions (points that are not
+ * larger than the split value go to the first child), which
+ * BestBinaryNumericSplit, RandomBinaryNumericSplit and HistogramNumericSplit
+ * all do, and AllCategoricalSplit for categorical dimensions.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * FlatForest flat(rf);
+ *
+ * arma::Row<size_t> predictions;
+ * flat.Classify(testData, predictions);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  /**
+   * Create an empty FlatForest.  Trees can be added with AddTree().
+   */
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Flatten every tree of the given forest.
+   *
+   * @param forest Trained forest (for instance a RandomForest).
+   */
+  template<typename ForestType>
+  explicit FlatForest(const ForestType& forest);
+
+  /**
+   * Flatten the given tree and add it to the forest.  Every tree must have the
+   * same number of classes.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Predict the classes of the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of the given points, and the probability of each class
+   * for each point (the average of the probabilities given by the trees).
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  /**
+   * Get the class probabilities given by one tree for one of the given points.
+   *
+   * @param tree Index of the tree.
+   * @param data Set of points.
+   * @param i Index of the point in data.
+   * @return Pointer to the NumClasses() class probabilities.
+   */
+  template<typename MatType>
+  const double* TreeProbabilities(const size_t tree,
+                                  const MatType& data,
+                                  const size_t i) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of points that go through a tree together in Classify().
+  static size_t BlockSize() { return 64; }
+
+ private:
+  //! A node of a flattened tree.
+  struct Node
+  {
+    //! Index of the first child, or of the first class probability of a leaf.
+    size_t child;
+    //! Number of children (0 for a leaf).
+    size_t numChildren;
+    //! Dimension the node splits on.
+    size_t dimension;
+    //! Split value of a numeric split.
+    double threshold;
+    //! Whether the node splits on a categorical dimension.
+    bool categorical;
+  };
+
+  //! Get the index of the leaf of the given tree that the point falls into.
+  template<typename MatType>
+  size_t Leaf(const size_t root, const MatType& data, const size_t i) const;
+
+  //! The nodes of every tree.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree.
+  std::vector<size_t> roots;
+  //! The class probabilities of every leaf, numClasses for each leaf.
+  std::vector<double> leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
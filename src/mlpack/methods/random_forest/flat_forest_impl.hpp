@@ -0,0 +1,169 @@
+/**
+ * @file methods/random_forest/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename ForestType>
+FlatForest::FlatForest(const ForestType& forest) : numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename TreeType>
+void FlatForest::AddTree(const TreeType& tree)
+{
+  const size_t treeClasses = tree.NumClasses();
+  if (roots.empty())
+  {
+    numClasses = treeClasses;
+  }
+  else if (treeClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "FlatForest::AddTree(): the tree has " << treeClasses << " classes, "
+        << "but the forest has " << numClasses << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Visit the tree in breadth-first order; the children of each node are
+  // given consecutive indices when the node is visited.
+  roots.push_back(nodes.size());
+  nodes.push_back(Node());
+  std::vector<std::pair<const TreeType*, size_t>> queue;
+  queue.push_back(std::make_pair(&tree, roots.back()));
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    const TreeType& current = *queue[q].first;
+    const size_t index = queue[q].second;
+
+    Node node;
+    node.numChildren = current.NumChildren();
+    if (node.numChildren == 0)
+    {
+      node.child = leafProbabilities.size();
+      node.dimension = 0;
+      node.threshold = 0.0;
+      node.categorical = false;
+      const arma::vec& probabilities = current.ClassProbabilities();
+      leafProbabilities.insert(leafProbabilities.end(), probabilities.begin(),
+          probabilities.end());
+    }
+    else
+    {
+      node.child = nodes.size();
+      node.dimension = current.SplitDimension();
+      node.categorical = (current.SplitDimensionType() ==
+          data::Datatype::categorical);
+      node.threshold = node.categorical ? 0.0 :
+          current.ClassProbabilities()[0];
+      for (size_t c = 0; c < node.numChildren; ++c)
+      {
+        queue.push_back(std::make_pair(&current.Child(c), nodes.size()));
+        nodes.push_back(Node());
+      }
+    }
+
+    nodes[index] = node;
+  }
+}
+
+template<typename MatType>
+size_t FlatForest::Leaf(const size_t root,
+                        const MatType& data,
+                        const size_t i) const
+{
+  size_t index = root;
+  while (nodes[index].numChildren != 0)
+  {
+    const Node& node = nodes[index];
+    const double value = data(node.dimension, i);
+    if (node.categorical)
+      index = node.child + (size_t) value;
+    else
+      index = node.child + (value <= node.threshold ? 0 : 1);
+  }
+
+  return index;
+}
+
+template<typename MatType>
+const double* FlatForest::TreeProbabilities(const size_t tree,
+                                            const MatType& data,
+                                            const size_t i) const
+{
+  return leafProbabilities.data() + nodes[Leaf(roots[tree], data, i)].child;
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void FlatForest::Classify(const MatType& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): the forest has no "
+        "trees!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  // Each block of points goes through every tree before the next block, so
+  // that the nodes of a tree are reused while they are in cache.
+  const size_t blockSize = BlockSize();
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leaf = leafProbabilities.data() +
+            nodes[Leaf(roots[t], data, i)].child;
+        double* point = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          point[c] += leaf[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= roots.size();
+      predictions[i] = probabilities.col(i).index_max();
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file methods/random_forest/random_forest.cpp
+ *
+ * Explicit instantiation of RandomForest<>, so that it is compiled once, into
+ * libmlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template class RandomForest<>;
+
+template double RandomForest<>::Train(
+    const arma::mat&, const arma::Row<size_t>&, const size_t, const size_t,
+    const size_t, const double, const size_t, const bool,
+    MultipleRandomDimensionSelect);
+
+template double RandomForest<>::Train(
+    const arma::mat&, const data::DatasetInfo&, const arma::Row<size_t>&,
+    const size_t, const size_t, const size_t, const double, const size_t,
+    const bool, MultipleRandomDimensionSelect);
+
+template double RandomForest<>::Train(
+    const arma::mat&, const arma::Row<size_t>&, const size_t,
+    const arma::rowvec&, const size_t, const size_t, const double,
+    const size_t, const bool, MultipleRandomDimensionSelect);
+
+template double RandomForest<>::Train(
+    const arma::mat&, const data::DatasetInfo&, const arma::Row<size_t>&,
+    const size_t, const arma::rowvec&, const size_t, const size_t,
+    const double, const size_t, const bool, MultipleRandomDimensionSelect);
+
+template size_t RandomForest<>::Classify(const arma::vec&) const;
+
+template void RandomForest<>::Classify(const arma::vec&, size_t&,
+    arma::vec&) const;
+
+template void RandomForest<>::Classify(const arma::mat&,
+    arma::Row<size_t>&) const;
+
+template void RandomForest<>::Classify(const arma::mat&,
+    arma::Row<size_t>&, arma::mat&) const;
+
+template void RandomForest<>::serialize(cereal::BinaryInputArchive&,
+    const uint32_t);
+
+template void RandomForest<>::serialize(cereal::BinaryOutputArchive&,
+    const uint32_t);
+
+template void RandomForest<>::serialize(cereal::JSONInputArchive&,
+    const uint32_t);
+
+template void RandomForest<>::serialize(cereal::JSONOutputArchive&,
+    const uint32_t);
+
+template void RandomForest<>::serialize(cereal::XMLInputArchive&,
+    const uint32_t);
+
+template void RandomForest<>::serialize(cereal::XMLOutputArchive&,
+    const uint32_t);
+
+} // namespace tree
+} // namespace mlpack
@@ -15,6 +15,8 @@
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 #include "bootstrap.hpp"
+#include "flat_forest.hpp"
+#include "compact_forest.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -186,6 +188,7 @@ class RandomForest
    * @param maximumDepth Maximum depth for the tree.
    * @param warmStart When set to `true`, it adds `numTrees` new trees to the
    *     existing random forest otherwise a new forest is trained from scratch.
+   *     The number of classes must then be the one of the existing trees.
    * @param dimensionSelector Instantiated dimension selection policy.
    * @return The average entropy of all the decision trees trained under forest.
    */
@@ -220,6 +223,7 @@ class RandomForest
    * @param maximumDepth Maximum depth for the tree.
    * @param warmStart When set to `true`, it adds `numTrees` new trees to the
    *     existing random forest else a new forest is trained from scratch.
+   *     The number of classes must then be the one of the existing trees.
    * @param dimensionSelector Instantiated dimension selection policy.
    * @return The average entropy of all the decision trees trained under forest.
    */
@@ -253,6 +257,7 @@ class RandomForest
    * @param maximumDepth Maximum depth for the tree.
    * @param warmStart When set to `true`, it adds `numTrees` new trees to the
    *     existing random forest else a new forest is trained from scratch.
+   *     The number of classes must then be the one of the existing trees.
    * @param dimensionSelector Instantiated dimension selection policy.
    * @return The average entropy of all the decision trees trained under forest.
    */
@@ -288,6 +293,7 @@ class RandomForest
    * @param maximumDepth Maximum depth for the tree.
    * @param warmStart When set to `true`, it adds `numTrees` new trees to the
    *     existing random forest else a new forest is trained from scratch.
+   *     The number of classes must then be the one of the existing trees.
    * @param dimensionSelector Instantiated dimension selection policy.
    * @return The average entropy of all the decision trees trained under forest.
    */
@@ -353,19 +359,112 @@ class RandomForest
                 arma::Row<size_t>& predictions,
                 arma::mat& probabilities) const;
 
+  /**
+   * Compute the out-of-bag error of the forest: each training point is
+   * classified by the trees whose bootstrap sample doesn't contain it, and the
+   * error is the fraction of misclassified points, among the points that are
+   * out of bag for at least one tree.  This estimates the generalization error
+   * without retraining (like cross-validation would).  The points are
+   * classified in parallel with a FlatForest.
+   *
+   * The out-of-bag points of each tree are recorded by Train() when bootstrap
+   * sampling is used; they aren't serialized, and the trees trained by
+   * different calls to Train() (with warm-starting) must have been trained on
+   * the same dataset.  An exception is thrown if no tree has out-of-bag
+   * points.
+   *
+   * @param data Dataset the forest was trained on.
+   * @param labels Labels of the dataset.
+   * @return Out-of-bag error, in [0, 1].
+   */
+  template<typename MatType>
+  double OOBError(const MatType& data, const arma::Row<size_t>& labels) const;
+
+  /**
+   * Compute the gain-based (mean decrease in impurity) importance of each
+   * dimension: the given points are passed down every tree, and the decrease
+   * of the impurity given by FitnessFunction at each split, weighted by the
+   * number of points that reach the split, is added to the importance of the
+   * split dimension.  The importances are averaged over the trees and
+   * normalized to sum to 1.  The trees are processed in parallel.
+   *
+   * The points are usually the training set (the trees were built on bootstrap
+   * samples of it, so the importances are close to the ones of the samples).
+   *
+   * @param data Set of points to compute the importances with.
+   * @param labels Labels of the points.
+   * @param importances Output importance of each dimension.
+   */
+  template<typename MatType>
+  void ComputeGainImportance(const MatType& data,
+                             const arma::Row<size_t>& labels,
+                             arma::vec& importances) const;
+
+  /**
+   * Compute the permutation importance of each dimension: the increase of the
+   * classification error on the given points when the values of the dimension
+   * are shuffled between the points.  Unlike the gain-based importance, this
+   * isn't biased towards dimensions with many possible splits, and it is
+   * usually computed on held-out points.  The dimensions are processed in
+   * parallel, with a FlatForest; each thread needs a copy of the data.
+   *
+   * @param data Set of points to compute the importances with.
+   * @param labels Labels of the points.
+   * @param importances Output importance of each dimension.
+   * @param numRepeats Number of shuffles of each dimension (the increases of
+   *     the error are averaged).
+   */
+  template<typename MatType>
+  void ComputePermutationImportance(const MatType& data,
+                                    const arma::Row<size_t>& labels,
+                                    arma::vec& importances,
+                                    const size_t numRepeats = 1) const;
+
+  //! Get the indices of the out-of-bag points of a tree (empty if the tree
+  //! wasn't trained with bootstrap sampling in this process).
+  const arma::uvec& OutOfBag(const size_t i) const { return outOfBag[i]; }
+
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
   //! Modify a tree in the forest (be careful!).
   DecisionTreeType& Tree(const size_t i) { return trees[i]; }
 
-  //! Get the number of trees in the forest.
+  //! Get the number of trees in the forest (0 once the forest is compacted;
+  //! see CompactModel()).
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Replace the trees of the forest with a CompactForest, which uses much
+   * less memory and is serialized in much less space (see CompactForest).
+   * Classify() then uses the compact model, but the trees themselves, and so
+   * Tree(), warm-started training, the out-of-bag error and the importances,
+   * are no longer available.  Training the forest again without warm-starting
+   * replaces the compact model with new trees.
+   */
+  void Compact();
+
+  //! Return whether the trees were replaced by a compact model.
+  bool IsCompact() const { return compactForest.NumTrees() > 0; }
+  //! Get the compact model of the forest (empty unless Compact() was called).
+  const CompactForest& CompactModel() const { return compactForest; }
+
+  /**
+   * Remove the given number of oldest trees from the forest.  The trees are
+   * kept in the order they were trained in, so a warm-started Train() call on
+   * new data followed by RemoveOldestTrees() replaces the oldest trees with
+   * trees trained on the new data, without retraining the other trees.  The
+   * average gain is left unchanged, since the gains of the individual trees
+   * are not stored.
+   *
+   * @param count Number of trees to remove (at most NumTrees()).
+   */
+  void RemoveOldestTrees(const size_t count);
+
   /**
    * Serialize the random forest.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
   /**
@@ -384,7 +483,8 @@ class RandomForest
    * @param maximumDepth Maximum depth for the tree.
    * @param dimensionSelector Instantiated dimension selection policy.
    * @param warmStart When set to `true`, it fits new trees and add them to the
-   *     previous forest else a new forest is trained from scratch.
+   *     previous forest else a new forest is trained from scratch.  The number
+   *     of classes must then be the one of the existing trees.
    * @tparam UseWeights Whether or not to use the weights parameter.
    * @tparam UseDatasetInfo Whether or not to use the datasetInfo parameter.
    * @tparam MatType The type of data matrix (i.e. arma::mat).
@@ -406,8 +506,14 @@ class RandomForest
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
 
+  //! The indices of the out-of-bag points of each tree.
+  std::vector<arma::uvec> outOfBag;
+
   //! The average gain of the forest.
   double avgGain;
+
+  //! The compact model that replaces the trees after Compact().
+  CompactForest compactForest;
 };
 
 /**
@@ -445,7 +551,85 @@ using ExtraTrees = RandomForest<FitnessFunction,
 } // namespace tree
 } // namespace mlpack
 
+// Version 1 stores the compact model.
+CEREAL_TEMPLATE_CLASS_VERSION((template<typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap>),
+    (mlpack::tree::RandomForest<FitnessFunction, DimensionSelectionType,
+    NumericSplitType, CategoricalSplitType, UseBootstrap>), 1);
+
 // Include implementation.
 #include "random_forest_impl.hpp"
 
+namespace mlpack {
+namespace tree {
+
+/**
+ * RandomForest<>, the forest used by the random_forest binding, is compiled
+ * into libmlpack (in random_forest.cpp) for arma::mat data, so that the
+ * programs that use it don't have to instantiate it again.
+ *
+ * @cond
+ */
+
+extern template class RandomForest<>;
+
+extern template double RandomForest<>::Train(
+    const arma::mat&, const arma::Row<size_t>&, const size_t, const size_t,
+    const size_t, const double, const size_t, const bool,
+    MultipleRandomDimensionSelect);
+
+extern template double RandomForest<>::Train(
+    const arma::mat&, const data::DatasetInfo&, const arma::Row<size_t>&,
+    const size_t, const size_t, const size_t, const double, const size_t,
+    const bool, MultipleRandomDimensionSelect);
+
+extern template double RandomForest<>::Train(
+    const arma::mat&, const arma::Row<size_t>&, const size_t,
+    const arma::rowvec&, const size_t, const size_t, const double,
+    const size_t, const bool, MultipleRandomDimensionSelect);
+
+extern template double RandomForest<>::Train(
+    const arma::mat&, const data::DatasetInfo&, const arma::Row<size_t>&,
+    const size_t, const arma::rowvec&, const size_t, const size_t,
+    const double, const size_t, const bool, MultipleRandomDimensionSelect);
+
+extern template size_t RandomForest<>::Classify(const arma::vec&) const;
+
+extern template void RandomForest<>::Classify(const arma::vec&, size_t&,
+    arma::vec&) const;
+
+extern template void RandomForest<>::Classify(const arma::mat&,
+    arma::Row<size_t>&) const;
+
+extern template void RandomForest<>::Classify(const arma::mat&,
+    arma::Row<size_t>&, arma::mat&) const;
+
+extern template void RandomForest<>::serialize(cereal::BinaryInputArchive&,
+    const uint32_t);
+
+extern template void RandomForest<>::serialize(cereal::BinaryOutputArchive&,
+    const uint32_t);
+
+extern template void RandomForest<>::serialize(cereal::JSONInputArchive&,
+    const uint32_t);
+
+extern template void RandomForest<>::serialize(cereal::JSONOutputArchive&,
+    const uint32_t);
+
+extern template void RandomForest<>::serialize(cereal::XMLInputArchive&,
+    const uint32_t);
+
+extern template void RandomForest<>::serialize(cereal::XMLOutputArchive&,
+    const uint32_t);
+
+/**
+ * @endcond
+ */
+
+} // namespace tree
+} // namespace mlpack
+
 #endif
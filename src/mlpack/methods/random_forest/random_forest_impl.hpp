@@ -335,6 +335,12 @@ void RandomForest<
             size_t& prediction,
             arma::vec& probabilities) const
 {
+  if (IsCompact())
+  {
+    compactForest.Classify(point, prediction, probabilities);
+    return;
+  }
+
   // Check edge case.
   if (trees.size() == 0)
   {
@@ -381,6 +387,12 @@ void RandomForest<
 >::Classify(const MatType& data,
             arma::Row<size_t>& predictions) const
 {
+  if (IsCompact())
+  {
+    compactForest.Classify(data, predictions);
+    return;
+  }
+
   // Check edge case.
   if (trees.size() == 0)
   {
@@ -417,6 +429,12 @@ void RandomForest<
             arma::Row<size_t>& predictions,
             arma::mat& probabilities) const
 {
+  if (IsCompact())
+  {
+    compactForest.Classify(data, predictions, probabilities);
+    return;
+  }
+
   // Check edge case.
   if (trees.size() == 0)
   {
@@ -437,6 +455,303 @@ void RandomForest<
   }
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+double RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::OOBError(const MatType& data, const arma::Row<size_t>& labels) const
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("RandomForest::OOBError(): the number of "
+        "labels must be the number of points!");
+  }
+
+  // Find the trees for which each point is out of bag, as lists stored one
+  // after the other.
+  const size_t n = data.n_cols;
+  arma::Col<size_t> offsets(n + 1, arma::fill::zeros);
+  for (size_t t = 0; t < outOfBag.size(); ++t)
+  {
+    for (size_t j = 0; j < outOfBag[t].n_elem; ++j)
+    {
+      if (outOfBag[t][j] >= n)
+      {
+        throw std::invalid_argument("RandomForest::OOBError(): the dataset is "
+            "smaller than the one the forest was trained on!");
+      }
+
+      ++offsets[outOfBag[t][j] + 1];
+    }
+  }
+  offsets = arma::cumsum(offsets);
+
+  if (offsets[n] == 0)
+  {
+    throw std::invalid_argument("RandomForest::OOBError(): no tree has "
+        "out-of-bag points!");
+  }
+
+  std::vector<size_t> oobTrees(offsets[n]);
+  arma::Col<size_t> next = offsets.head(n);
+  for (size_t t = 0; t < outOfBag.size(); ++t)
+    for (size_t j = 0; j < outOfBag[t].n_elem; ++j)
+      oobTrees[next[outOfBag[t][j]]++] = t;
+
+  // Each point is classified by its out-of-bag trees only.
+  const FlatForest flat(*this);
+  const size_t numClasses = flat.NumClasses();
+  size_t errors = 0;
+  size_t oobPoints = 0;
+  #pragma omp parallel reduction(+:errors, oobPoints)
+  {
+    arma::vec probabilities(numClasses);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      if (offsets[i] == offsets[i + 1])
+        continue;
+
+      probabilities.zeros();
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+      {
+        const double* treeProbabilities = flat.TreeProbabilities(oobTrees[j],
+            data, i);
+        for (size_t c = 0; c < numClasses; ++c)
+          probabilities[c] += treeProbabilities[c];
+      }
+
+      ++oobPoints;
+      if (probabilities.index_max() != labels[i])
+        ++errors;
+    }
+  }
+
+  return (double) errors / oobPoints;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::ComputeGainImportance(const MatType& data,
+                         const arma::Row<size_t>& labels,
+                         arma::vec& importances) const
+{
+  if (trees.empty())
+  {
+    throw std::invalid_argument("RandomForest::ComputeGainImportance(): no "
+        "random forest trained!");
+  }
+  if (labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("RandomForest::ComputeGainImportance(): the "
+        "number of labels must be the number of points!");
+  }
+
+  const size_t numClasses = trees[0].NumClasses();
+  importances.zeros(data.n_rows);
+
+  #pragma omp parallel
+  {
+    arma::vec localImportances(data.n_rows, arma::fill::zeros);
+
+    // The nodes that remain to be visited, with the points that reach them.
+    std::vector<std::pair<const DecisionTreeType*, std::vector<size_t>>> stack;
+    arma::Col<size_t> counts(numClasses);
+    arma::Mat<size_t> childCounts;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+    {
+      std::vector<size_t> all(data.n_cols);
+      for (size_t i = 0; i < data.n_cols; ++i)
+        all[i] = i;
+      stack.push_back(std::make_pair(&trees[t], std::move(all)));
+
+      while (!stack.empty())
+      {
+        const DecisionTreeType* node = stack.back().first;
+        std::vector<size_t> points = std::move(stack.back().second);
+        stack.pop_back();
+
+        const size_t numChildren = node->NumChildren();
+        if (numChildren == 0 || points.empty())
+          continue;
+
+        // Split the points between the children.
+        std::vector<std::vector<size_t>> childPoints(numChildren);
+        childCounts.zeros(numClasses, numChildren);
+        counts.zeros();
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+          const size_t i = points[j];
+          const size_t direction = node->CalculateDirection(data.col(i));
+          childPoints[direction].push_back(i);
+          ++childCounts(labels[i], direction);
+          ++counts[labels[i]];
+        }
+
+        // The gains are negated impurities.
+        double decrease = -(double) points.size() *
+            FitnessFunction::template EvaluatePtr<false>(counts.memptr(),
+            numClasses, (size_t) points.size());
+        for (size_t c = 0; c < numChildren; ++c)
+        {
+          if (childPoints[c].empty())
+            continue;
+
+          decrease += (double) childPoints[c].size() *
+              FitnessFunction::template EvaluatePtr<false>(
+              childCounts.colptr(c), numClasses,
+              (size_t) childPoints[c].size());
+          stack.push_back(std::make_pair(&node->Child(c),
+              std::move(childPoints[c])));
+        }
+
+        localImportances[node->SplitDimension()] += decrease;
+      }
+    }
+
+    #pragma omp critical
+    importances += localImportances;
+  }
+
+  const double total = arma::accu(importances);
+  if (total > 0.0)
+    importances /= total;
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::ComputePermutationImportance(const MatType& data,
+                                const arma::Row<size_t>& labels,
+                                arma::vec& importances,
+                                const size_t numRepeats) const
+{
+  if (trees.empty())
+  {
+    throw std::invalid_argument("RandomForest::ComputePermutationImportance(): "
+        "no random forest trained!");
+  }
+  if (labels.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("RandomForest::ComputePermutationImportance(): "
+        "the number of labels must be the number of points!");
+  }
+  if (numRepeats == 0)
+  {
+    throw std::invalid_argument("RandomForest::ComputePermutationImportance(): "
+        "numRepeats must be positive!");
+  }
+
+  const FlatForest flat(*this);
+  arma::Row<size_t> predictions;
+  flat.Classify(data, predictions);
+  const double baseError = (double) arma::accu(predictions != labels) /
+      data.n_cols;
+
+  // Each dimension is shuffled with its own stream of the same seed, so the
+  // result doesn't depend on the number of threads.
+  const uint64_t seed = math::randGen();
+  importances.set_size(data.n_rows);
+
+  #pragma omp parallel
+  {
+    // The shuffled dimension is restored after use, so each thread only needs
+    // one copy of the data.
+    MatType permuted(data);
+    arma::Row<size_t> permutedPredictions;
+    std::vector<size_t> order(data.n_cols);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      math::RandomStream rng(seed, d);
+      double error = 0.0;
+      for (size_t r = 0; r < numRepeats; ++r)
+      {
+        for (size_t i = 0; i < data.n_cols; ++i)
+          order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        for (size_t i = 0; i < data.n_cols; ++i)
+          permuted(d, i) = data(d, order[i]);
+
+        flat.Classify(permuted, permutedPredictions);
+        error += (double) arma::accu(permutedPredictions != labels) /
+            data.n_cols;
+      }
+
+      for (size_t i = 0; i < data.n_cols; ++i)
+        permuted(d, i) = data(d, i);
+
+      importances[d] = error / numRepeats - baseError;
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::RemoveOldestTrees(const size_t count)
+{
+  if (count > trees.size())
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::RemoveOldestTrees(): cannot remove " << count
+        << " trees from a forest of " << trees.size() << " trees!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  trees.erase(trees.begin(), trees.begin() + count);
+  outOfBag.erase(outOfBag.begin(), outOfBag.begin() + count);
+  if (trees.empty())
+    avgGain = 0.0;
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -451,7 +766,7 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     UseBootstrap
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
 {
   size_t numTrees;
   if (cereal::is_loading<Archive>())
@@ -461,12 +776,50 @@ void RandomForest<
 
   ar(CEREAL_NVP(numTrees));
 
-  // Allocate space if needed.
+  // Allocate space if needed.  The out-of-bag points aren't serialized.
   if (cereal::is_loading<Archive>())
+  {
     trees.resize(numTrees);
+    outOfBag.clear();
+    outOfBag.resize(numTrees);
+  }
 
   ar(CEREAL_NVP(trees));
   ar(CEREAL_NVP(avgGain));
+
+  // Older versions didn't have a compact model.
+  if (version > 0)
+    ar(CEREAL_NVP(compactForest));
+  else if (cereal::is_loading<Archive>())
+    compactForest = CompactForest();
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap
+>::Compact()
+{
+  if (trees.empty())
+  {
+    throw std::invalid_argument("RandomForest::Compact(): no random forest "
+        "trained!");
+  }
+
+  compactForest = CompactForest(*this);
+
+  // Release the memory of the trees.
+  std::vector<DecisionTreeType>().swap(trees);
+  std::vector<arma::uvec>().swap(outOfBag);
 }
 
 template<
@@ -497,17 +850,41 @@ double RandomForest<
 {
   // Reset the forest if we are not doing a warm-start.
   if (!warmStart)
+  {
     trees.clear();
+    outOfBag.clear();
+    compactForest = CompactForest();
+  }
+  else if (IsCompact())
+  {
+    throw std::invalid_argument("RandomForest::Train(): cannot warm-start a "
+        "compacted forest!");
+  }
+  else if (!trees.empty() && trees[0].NumClasses() != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Train(): cannot warm-start a forest of "
+        << trees[0].NumClasses() << " classes with " << numClasses
+        << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
   const size_t oldNumTrees = trees.size();
   trees.resize(trees.size() + numTrees);
+  outOfBag.resize(trees.size());
 
   // Convert avgGain to total gain.
   double totalGain = avgGain * oldNumTrees;
 
+  // Each tree draws its random numbers from its own stream, so the forest
+  // doesn't depend on which thread trains which tree.
+  const uint64_t streamSeed = math::randGen();
+
   // Train each tree individually.
   #pragma omp parallel for reduction( + : totalGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    math::SeedThreadRandGen(streamSeed, oldNumTrees + i);
+
     MatType bootstrapDataset;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
@@ -515,19 +892,23 @@ double RandomForest<
     {
       Timer::Start("bootstrap");
       Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-          bootstrapLabels, bootstrapWeights);
+          bootstrapLabels, bootstrapWeights, outOfBag[oldNumTrees + i]);
       Timer::Stop("bootstrap");
     }
 
+    // The bootstrap sample is only used by this tree, so it is moved into the
+    // tree instead of being copied again (the tree needs its own copy of the
+    // data, since it reorders the points as it splits them).
     Timer::Start("train_tree");
     if (UseWeights)
     {
       if (UseDatasetInfo)
       {
         totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize, minimumGainSplit,
+                maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
                 numClasses, weights, minimumLeafSize, minimumGainSplit,
                 maximumDepth, dimensionSelector);
@@ -535,9 +916,10 @@ double RandomForest<
       else
       {
         totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, bootstrapWeights, minimumLeafSize,
-                minimumGainSplit, maximumDepth, dimensionSelector) :
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize, minimumGainSplit,
+                maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, labels, numClasses,
                 weights, minimumLeafSize, minimumGainSplit, maximumDepth,
                 dimensionSelector);
@@ -548,9 +930,10 @@ double RandomForest<
       if (UseDatasetInfo)
       {
         totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector) :
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                minimumLeafSize, minimumGainSplit, maximumDepth,
+                dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, datasetInfo, labels,
                 numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
                 dimensionSelector);
@@ -558,9 +941,9 @@ double RandomForest<
       else
       {
         totalGain += UseBootstrap ?
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector) :
+            trees[oldNumTrees + i].Train(std::move(bootstrapDataset),
+                std::move(bootstrapLabels), numClasses, minimumLeafSize,
+                minimumGainSplit, maximumDepth, dimensionSelector) :
             trees[oldNumTrees + i].Train(dataset, labels, numClasses,
                 minimumLeafSize, minimumGainSplit, maximumDepth,
                 dimensionSelector);
@@ -63,6 +63,15 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("print_training_accuracy") + " is specified, the "
     "calculated accuracy on the training set will be printed."
     "\n\n"
+    "If " + PRINT_PARAM_STRING("warm_start") + " is specified along with " +
+    PRINT_PARAM_STRING("training") + " and " +
+    PRINT_PARAM_STRING("input_model") + ", " + PRINT_PARAM_STRING("num_trees") +
+    " new trees are trained and added to the given forest, without retraining "
+    "its trees.  If " + PRINT_PARAM_STRING("max_trees") + " is also specified, "
+    "the oldest trees are then removed so that the forest has at most " +
+    PRINT_PARAM_STRING("max_trees") + " trees; this replaces the oldest trees "
+    "with trees trained on the new data."
+    "\n\n"
     "Test data may be specified with the " + PRINT_PARAM_STRING("test") + " "
     "parameter, and if performance measures are desired for that test set, "
     "labels for the test points may be specified with the " +
@@ -132,6 +141,8 @@ PARAM_INT_IN("subspace_dim", "Dimensionality of random subspace to use for "
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_FLAG("warm_start", "If true and passed along with `training` and "
     "`input_model` then trains more trees on top of existing model.", "w");
+PARAM_INT_IN("max_trees", "If positive, the oldest trees are removed after "
+    "training so that the forest has at most this many trees.", "X", 0);
 
 /**
  * This is the class that we will serialize.  It is a pretty simple wrapper
@@ -189,6 +200,8 @@ static void mlpackMain()
 
   RequireParamValue<int>("num_trees", [](int x) { return x > 0; }, true,
       "number of trees in forest must be positive");
+  RequireParamValue<int>("max_trees", [](int x) { return x >= 0; }, true,
+      "maximum number of trees in forest must not be negative");
 
   ReportIgnoredParam({{ "test", false }}, "predictions");
   ReportIgnoredParam({{ "test", false }}, "probabilities");
@@ -205,6 +218,7 @@ static void mlpackMain()
 
   ReportIgnoredParam({{ "training", false }}, "num_trees");
   ReportIgnoredParam({{ "training", false }}, "minimum_leaf_size");
+  ReportIgnoredParam({{ "training", false }}, "max_trees");
 
   RandomForestModel* rfModel;
   // Input model is loaded when we are either doing warm-started training or
@@ -242,12 +256,35 @@ static void mlpackMain()
     Log::Info << "Training random forest with " << numTrees << " trees..."
         << endl;
 
-    const size_t numClasses = arma::max(labels) + 1;
+    // When warm-starting, the new data may not have all the classes of the
+    // existing trees.
+    size_t numClasses = arma::max(labels) + 1;
+    if (IO::HasParam("warm_start") && rfModel->rf.NumTrees() > 0)
+    {
+      const size_t modelClasses = rfModel->rf.Tree(0).NumClasses();
+      if (numClasses > modelClasses)
+      {
+        Log::Fatal << "The labels of " << PRINT_PARAM_STRING("training")
+            << " have " << numClasses << " classes, but the model given with "
+            << PRINT_PARAM_STRING("input_model") << " has " << modelClasses
+            << " classes!" << endl;
+      }
+      numClasses = modelClasses;
+    }
 
     // Train the model.
     rfModel->rf.Train(data, labels, numClasses, numTrees, minimumLeafSize,
         minimumGainSplit, maxDepth, IO::HasParam("warm_start"), mrds);
 
+    // Drop the oldest trees if the forest is too large.
+    const size_t maxTrees = (size_t) IO::GetParam<int>("max_trees");
+    if (maxTrees > 0 && rfModel->rf.NumTrees() > maxTrees)
+    {
+      Log::Info << "Removing the " << rfModel->rf.NumTrees() - maxTrees
+          << " oldest trees of the forest." << endl;
+      rfModel->rf.RemoveOldestTrees(rfModel->rf.NumTrees() - maxTrees);
+    }
+
     Timer::Stop("rf_training");
 
     // Did we want training accuracy?
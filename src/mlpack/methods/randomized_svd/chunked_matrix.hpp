@@ -0,0 +1,108 @@
+/**
+ * @file methods/randomized_svd/chunked_matrix.hpp
+ *
+ * A matrix stored on disk as a sequence of files, each holding a block of
+ * consecutive columns, that can be read one chunk at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_MATRIX_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * ChunkedMatrix is a disk-backed matrix for out-of-core algorithms such as
+ * ChunkedRandomizedSVD.  The matrix is the horizontal concatenation of the
+ * matrices stored in a list of files, each of which is loaded with
+ * data::Load() only when it is needed, so only one chunk per thread is in
+ * memory at any time.  All chunks must have the same number of rows.  The
+ * chunks can be written with data::Save(); for large sparse matrices, the
+ * Armadillo binary format is the fastest to read.
+ *
+ * Any other class can be used in place of ChunkedMatrix, as long as it
+ * provides the same ChunkType typedef and the Rows(), NumChunks() and
+ * LoadChunk() methods, and LoadChunk() can be called from several threads at
+ * once.
+ *
+ * @tparam MatType Type of each chunk (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::sp_mat>
+class ChunkedMatrix
+{
+ public:
+  //! The type of each chunk.
+  typedef MatType ChunkType;
+
+  /**
+   * Create the matrix from the given list of files, in column order.  The
+   * first chunk is loaded to find the number of rows of the matrix.
+   *
+   * @param files Files holding the chunks of the matrix.
+   * @param transpose Whether to transpose the chunks when loading them (as in
+   *     data::Load()).
+   */
+  ChunkedMatrix(const std::vector<std::string>& files,
+                const bool transpose = true) :
+      files(files),
+      transpose(transpose),
+      rows(0)
+  {
+    if (files.empty())
+    {
+      throw std::invalid_argument("ChunkedMatrix::ChunkedMatrix(): at least "
+          "one file must be given!");
+    }
+
+    MatType chunk;
+    LoadChunk(0, chunk);
+    rows = chunk.n_rows;
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t Rows() const { return rows; }
+
+  //! Get the number of chunks of the matrix.
+  size_t NumChunks() const { return files.size(); }
+
+  //! Get the files holding the chunks of the matrix.
+  const std::vector<std::string>& Files() const { return files; }
+
+  /**
+   * Load the given chunk of the matrix.  A std::runtime_error is thrown if the
+   * file cannot be loaded.
+   *
+   * @param index Index of the chunk.
+   * @param chunk Matrix to store the chunk in.
+   */
+  void LoadChunk(const size_t index, MatType& chunk) const
+  {
+    if (!data::Load(files[index], chunk, false, transpose))
+    {
+      std::ostringstream oss;
+      oss << "ChunkedMatrix::LoadChunk(): cannot load chunk " << index
+          << " from '" << files[index] << "'!";
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+ private:
+  //! Files holding the chunks.
+  std::vector<std::string> files;
+  //! Whether to transpose the chunks when loading them.
+  bool transpose;
+  //! Number of rows of the matrix.
+  size_t rows;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
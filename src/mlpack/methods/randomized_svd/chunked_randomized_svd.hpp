@@ -0,0 +1,148 @@
+/**
+ * @file methods/randomized_svd/chunked_randomized_svd.hpp
+ *
+ * An out-of-core variant of the randomized SVD that streams over a matrix
+ * stored in chunks of columns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_RANDOMIZED_SVD_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_RANDOMIZED_SVD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "chunked_matrix.hpp"
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * ChunkedRandomizedSVD computes a truncated SVD A ~ U S V^T of a d x N matrix
+ * A that does not fit in memory, with the randomized range finder and power
+ * iterations of Halko et al. (see RandomizedSVD).  The matrix is given as a
+ * sequence of column chunks (for instance a ChunkedMatrix), and only d x l
+ * dense matrices are kept in memory, where l is the size of the power
+ * iterations, so N can be far larger than d.
+ *
+ * Each pass over the matrix computes A A^T Q = sum_c A_c (A_c^T Q) for a
+ * d x l matrix Q; the chunks are loaded and multiplied in parallel, and the
+ * per-thread sums are added in thread order, so the result is deterministic.
+ * The range of A is found with 1 + MaxIterations() passes, orthonormalizing Q
+ * after each one; one more pass gives Q^T A A^T Q, whose eigendecomposition
+ * gives the singular values and the left singular vectors U = Q W.  If the
+ * right singular vectors are requested, V = A^T U S^-1 takes one last pass.
+ * Unlike RandomizedSVD, the data is not centered.
+ *
+ * Since the singular values come from the eigenvalues of Q^T A A^T Q, singular
+ * values smaller than about sqrt(eps) times the largest one are not accurate.
+ *
+ * @code
+ * std::vector<std::string> files = { "part0.bin", "part1.bin", "part2.bin" };
+ * ChunkedMatrix<arma::sp_mat> matrix(files);
+ *
+ * ChunkedRandomizedSVD rsvd;
+ * arma::mat u;
+ * arma::vec s;
+ * rsvd.Apply(matrix, u, s, 20);
+ * @endcode
+ */
+class ChunkedRandomizedSVD
+{
+ public:
+  /**
+   * Create the object for the out-of-core randomized SVD method.
+   *
+   * @param iteratedPower Size of the normalized power iterations
+   *        (Default: rank + 2).
+   * @param maxIterations Number of iterations for the power method
+   *        (Default: 2).
+   */
+  ChunkedRandomizedSVD(const size_t iteratedPower = 0,
+                       const size_t maxIterations = 2) :
+      iteratedPower(iteratedPower),
+      maxIterations(maxIterations)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Compute the singular values and left singular vectors of the given
+   * chunked matrix.
+   *
+   * @param matrix Chunked matrix to decompose.
+   * @param u Matrix to store the left singular vectors in (d x rank).
+   * @param s Vector to store the singular values in, in decreasing order.
+   * @param rank Rank of the approximation.
+   */
+  template<typename ChunkedMatrixType>
+  void Apply(const ChunkedMatrixType& matrix,
+             arma::mat& u,
+             arma::vec& s,
+             const size_t rank);
+
+  /**
+   * Compute the truncated SVD of the given chunked matrix, including the
+   * right singular vectors (N x rank), which takes an extra pass over the
+   * matrix.
+   *
+   * @param matrix Chunked matrix to decompose.
+   * @param u Matrix to store the left singular vectors in (d x rank).
+   * @param s Vector to store the singular values in, in decreasing order.
+   * @param v Matrix to store the right singular vectors in (N x rank).
+   * @param rank Rank of the approximation.
+   */
+  template<typename ChunkedMatrixType>
+  void Apply(const ChunkedMatrixType& matrix,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
+  //! Get the size of the normalized power iterations.
+  size_t IteratedPower() const { return iteratedPower; }
+  //! Modify the size of the normalized power iterations.
+  size_t& IteratedPower() { return iteratedPower; }
+
+  //! Get the number of iterations for the power method.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the number of iterations for the power method.
+  size_t& MaxIterations() { return maxIterations; }
+
+ private:
+  /**
+   * Compute the singular values and left singular vectors, and store the
+   * number of columns of each chunk in chunkCols.
+   */
+  template<typename ChunkedMatrixType>
+  void Decompose(const ChunkedMatrixType& matrix,
+                 arma::mat& u,
+                 arma::vec& s,
+                 const size_t rank,
+                 std::vector<size_t>& chunkCols) const;
+
+  /**
+   * Compute result = A A^T q with one pass over the chunks, and store the
+   * number of columns of each chunk in chunkCols.
+   */
+  template<typename ChunkedMatrixType>
+  void MultiplyGram(const ChunkedMatrixType& matrix,
+                    const arma::mat& q,
+                    arma::mat& result,
+                    std::vector<size_t>& chunkCols) const;
+
+  //! Locally stored size of the normalized power iterations.
+  size_t iteratedPower;
+
+  //! Locally stored number of iterations for the power method.
+  size_t maxIterations;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_randomized_svd_impl.hpp"
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file methods/randomized_svd/chunked_randomized_svd_impl.hpp
+ *
+ * Implementation of the out-of-core randomized SVD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_CHUNKED_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_randomized_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename ChunkedMatrixType>
+void ChunkedRandomizedSVD::Apply(const ChunkedMatrixType& matrix,
+                                 arma::mat& u,
+                                 arma::vec& s,
+                                 const size_t rank)
+{
+  std::vector<size_t> chunkCols;
+  Decompose(matrix, u, s, rank, chunkCols);
+}
+
+template<typename ChunkedMatrixType>
+void ChunkedRandomizedSVD::Decompose(const ChunkedMatrixType& matrix,
+                                     arma::mat& u,
+                                     arma::vec& s,
+                                     const size_t rank,
+                                     std::vector<size_t>& chunkCols) const
+{
+  const size_t d = matrix.Rows();
+  if (rank == 0 || rank > d)
+  {
+    std::ostringstream oss;
+    oss << "ChunkedRandomizedSVD::Apply(): rank must be between 1 and the "
+        << "number of rows (" << d << "), but is " << rank << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t l = std::min(std::max((iteratedPower == 0) ? rank + 2 :
+      iteratedPower, rank), d);
+
+  // Find an orthonormal basis Q for the range of A A^T applied to a random
+  // matrix, and refine it with power iterations.
+  arma::mat q = arma::randn<arma::mat>(d, l);
+  arma::mat y, r;
+  for (size_t i = 0; i <= maxIterations; ++i)
+  {
+    MultiplyGram(matrix, q, y, chunkCols);
+    arma::qr_econ(q, r, y);
+  }
+
+  // The eigendecomposition of Q^T A A^T Q = W S^2 W^T gives the singular
+  // values of A, and U = Q W.
+  MultiplyGram(matrix, q, y, chunkCols);
+  arma::mat projectedGram = q.t() * y;
+  projectedGram = 0.5 * (projectedGram + projectedGram.t());
+
+  arma::vec eigval;
+  arma::mat eigvec;
+  if (!arma::eig_sym(eigval, eigvec, projectedGram))
+  {
+    throw std::runtime_error("ChunkedRandomizedSVD::Apply(): "
+        "eigendecomposition failed!");
+  }
+
+  // eig_sym() returns the eigenvalues in ascending order.
+  eigval = arma::flipud(eigval);
+  eigvec = arma::fliplr(eigvec);
+  s = arma::sqrt(arma::clamp(eigval.subvec(0, rank - 1), 0.0, DBL_MAX));
+  u = q * eigvec.cols(0, rank - 1);
+}
+
+template<typename ChunkedMatrixType>
+void ChunkedRandomizedSVD::Apply(const ChunkedMatrixType& matrix,
+                                 arma::mat& u,
+                                 arma::vec& s,
+                                 arma::mat& v,
+                                 const size_t rank)
+{
+  std::vector<size_t> chunkCols;
+  Decompose(matrix, u, s, rank, chunkCols);
+
+  // Scale U so that A^T (U S^-1) = V; zero singular values give zero columns.
+  arma::mat scaledU = u;
+  for (size_t i = 0; i < rank; ++i)
+    scaledU.col(i) *= (s[i] > 0.0) ? 1.0 / s[i] : 0.0;
+
+  // Find the first column of each chunk, so the chunks can be processed in
+  // parallel.
+  typedef typename ChunkedMatrixType::ChunkType ChunkType;
+  const size_t numChunks = matrix.NumChunks();
+  std::vector<size_t> offsets(numChunks + 1, 0);
+  for (size_t c = 0; c < numChunks; ++c)
+    offsets[c + 1] = offsets[c] + chunkCols[c];
+
+  v.set_size(offsets[numChunks], rank);
+  bool failed = false;
+  std::string error;
+  #pragma omp parallel
+  {
+    ChunkType chunk;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      try
+      {
+        matrix.LoadChunk(c, chunk);
+      }
+      catch (std::exception& e)
+      {
+        #pragma omp critical
+        {
+          failed = true;
+          error = e.what();
+        }
+        continue;
+      }
+
+      if (chunk.n_cols > 0)
+        v.rows(offsets[c], offsets[c + 1] - 1) = chunk.t() * scaledU;
+    }
+  }
+
+  if (failed)
+    throw std::runtime_error(error);
+}
+
+template<typename ChunkedMatrixType>
+void ChunkedRandomizedSVD::MultiplyGram(const ChunkedMatrixType& matrix,
+                                        const arma::mat& q,
+                                        arma::mat& result,
+                                        std::vector<size_t>& chunkCols) const
+{
+  typedef typename ChunkedMatrixType::ChunkType ChunkType;
+  const size_t numChunks = matrix.NumChunks();
+  chunkCols.resize(numChunks);
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numChunks));
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // Each thread accumulates into its own product; these are summed in thread
+  // order afterwards, so the result does not depend on the timing of the
+  // threads.  Exceptions cannot leave the parallel region, so errors are
+  // recorded and thrown afterwards.
+  std::vector<arma::mat> threadResults(numThreads);
+  bool failed = false;
+  std::string error;
+
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+  {
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+#else
+    const size_t thread = 0;
+#endif
+    threadResults[thread].zeros(q.n_rows, q.n_cols);
+    ChunkType chunk;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      try
+      {
+        matrix.LoadChunk(c, chunk);
+        if (chunk.n_rows != q.n_rows)
+        {
+          std::ostringstream oss;
+          oss << "ChunkedRandomizedSVD::Apply(): chunk " << c << " has "
+              << chunk.n_rows << " rows, but the matrix has " << q.n_rows
+              << "!";
+          throw std::invalid_argument(oss.str());
+        }
+      }
+      catch (std::exception& e)
+      {
+        #pragma omp critical
+        {
+          failed = true;
+          error = e.what();
+        }
+        continue;
+      }
+
+      chunkCols[c] = chunk.n_cols;
+      if (chunk.n_cols > 0)
+        threadResults[thread] += chunk * arma::mat(chunk.t() * q);
+    }
+  }
+
+  if (failed)
+    throw std::runtime_error(error);
+
+  result.zeros(q.n_rows, q.n_cols);
+  for (size_t t = 0; t < numThreads; ++t)
+    result += threadResults[t];
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file methods/range_search/multi_range_count_rules.hpp
+ *
+ * Rules for counting the reference points within each of several radii of
+ * each query point with one traversal, so that it can be done with arbitrary
+ * tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_MULTI_RANGE_COUNT_RULES_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_MULTI_RANGE_COUNT_RULES_HPP
+
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The MultiRangeCountRules class is a template helper class used by
+ * RangeSearch when counting the points within several radii with single-tree
+ * traversals.  Like RangeCountRules, but the sorted radii split the distances
+ * into buckets: bucket 0 holds the distances in [0, radii[0]], and bucket k
+ * the distances in (radii[k - 1], radii[k]].  Each base case is added to the
+ * bucket of its distance, reference nodes farther than the largest radius are
+ * pruned, and when the whole bound of a reference node is in one bucket, all
+ * of its descendants are added to that bucket at once.  The number of points
+ * within radii[k] is then the sum of the first k + 1 buckets.
+ *
+ * If the query and reference sets are the same, a point is counted in its own
+ * bucket 0, and the caller subtracts it afterwards.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename TreeType>
+class MultiRangeCountRules
+{
+ public:
+  /**
+   * Construct the MultiRangeCountRules object.  This is usually done from
+   * within the RangeSearch class at search time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param radii Nonnegative radii, in increasing order.
+   * @param counts Matrix of bucket counts (one row per radius and one column
+   *      per query point) to add the counted points to.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same.
+   */
+  MultiRangeCountRules(const arma::mat& referenceSet,
+                       const arma::mat& querySet,
+                       const arma::vec& radii,
+                       arma::Mat<size_t>& counts,
+                       MetricType& metric,
+                       const bool sameSet = false);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node should
+   * not be recursed into at all: either it is farther than the largest radius,
+   * or all its points were counted.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The radii do not change during
+   * the traversal, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return 0; }
+
+  /**
+   * Return the bucket of the given distance: the index of the smallest radius
+   * that is at least the distance, or the number of radii if the distance is
+   * larger than all of them.
+   *
+   * @param radii Nonnegative radii, in increasing order.
+   * @param distance Distance to find the bucket of.
+   */
+  static size_t Bucket(const arma::vec& radii, const double distance)
+  {
+    return std::lower_bound(radii.begin(), radii.end(), distance) -
+        radii.begin();
+  }
+
+ private:
+  //! The reference set.
+  const arma::mat& referenceSet;
+
+  //! The query set.
+  const arma::mat& querySet;
+
+  //! The radii to count the points within.
+  const arma::vec& radii;
+
+  //! The bucket counts of the query points.
+  arma::Mat<size_t>& counts;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! If true, the query and reference set are taken to be the same.
+  bool sameSet;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! The distances from the last scored query point to leaves.
+  tree::LeafDistanceCache<MetricType, arma::mat> leafDistances;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace range
+} // namespace mlpack
+
+// Include implementation.
+#include "multi_range_count_rules_impl.hpp"
+
+#endif
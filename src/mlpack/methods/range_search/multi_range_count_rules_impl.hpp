@@ -0,0 +1,166 @@
+/**
+ * @file methods/range_search/multi_range_count_rules_impl.hpp
+ *
+ * Implementation of rules for counting the points within several radii with
+ * generic trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_MULTI_RANGE_COUNT_RULES_IMPL_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_MULTI_RANGE_COUNT_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "multi_range_count_rules.hpp"
+
+namespace mlpack {
+namespace range {
+
+template<typename MetricType, typename TreeType>
+MultiRangeCountRules<MetricType, TreeType>::MultiRangeCountRules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const arma::vec& radii,
+    arma::Mat<size_t>& counts,
+    MetricType& metric,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    radii(radii),
+    counts(counts),
+    metric(metric),
+    sameSet(sameSet),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+//! The base case.  Evaluate the distance between the two points and count the
+//! reference point in the bucket of the distance.
+template<typename MetricType, typename TreeType>
+inline force_inline
+double MultiRangeCountRules<MetricType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If we have just performed this base case, don't do it again.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0; // No value to return... this shouldn't do anything bad.
+
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+
+  // The distance of a point to itself is exactly 0; this is counted the same
+  // way as when the point is counted with the rest of a node.
+  if (sameSet && (queryIndex == referenceIndex))
+  {
+    ++counts(0, queryIndex);
+    return 0.0;
+  }
+
+  double distance;
+  if (!leafDistances.Distance(querySet, referenceSet, queryIndex,
+      referenceIndex, distance))
+  {
+    distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+        referenceSet.unsafe_col(referenceIndex));
+  }
+  ++baseCases;
+
+  const size_t bucket = Bucket(radii, distance);
+  if (bucket < radii.n_elem)
+    ++counts(bucket, queryIndex);
+
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename TreeType>
+double MultiRangeCountRules<MetricType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  math::Range distances;
+
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    // In this situation, we calculate the base case.  So we should check to be
+    // sure we haven't already done that.
+    double baseCase;
+    if (tree::TreeTraits<TreeType>::HasSelfChildren &&
+        (referenceNode.Parent() != NULL) &&
+        (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
+    {
+      // If the tree has self-children and this is a self-child, the base case
+      // was already calculated.
+      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      lastQueryIndex = queryIndex;
+      lastReferenceIndex = referenceNode.Point(0);
+    }
+    else
+    {
+      // We must calculate the base case by hand.
+      baseCase = BaseCase(queryIndex, referenceNode.Point(0));
+    }
+
+    // This may be possibly loose for non-ball bound trees.
+    distances.Lo() = baseCase - referenceNode.FurthestDescendantDistance();
+    distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
+
+    // Update last distance calculation.
+    referenceNode.Stat().LastDistance() = baseCase;
+  }
+  else
+  {
+    distances = referenceNode.RangeDistance(querySet.unsafe_col(queryIndex));
+    ++scores;
+  }
+
+  // Prune the node if it is farther than the largest radius.
+  if (distances.Lo() > radii[radii.n_elem - 1])
+    return DBL_MAX;
+
+  // In this case, all of the points in the reference node are in the same
+  // bucket, so they are counted at once.  If the base case with the first
+  // point of the node was just calculated, that point was already counted.
+  const size_t bucket = Bucket(radii, distances.Hi());
+  if (bucket < radii.n_elem && Bucket(radii, distances.Lo()) == bucket)
+  {
+    size_t baseCaseMod = 0;
+    if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+        (queryIndex == lastQueryIndex) &&
+        (referenceNode.Point(0) == lastReferenceIndex))
+    {
+      baseCaseMod = 1;
+    }
+
+    counts(bucket, queryIndex) += referenceNode.NumDescendants() - baseCaseMod;
+    return DBL_MAX; // We don't need to go any deeper.
+  }
+
+  // Otherwise the score doesn't matter.  The points of the node will be visited
+  // next, so their distances can be computed together.
+  leafDistances.Prepare(queryIndex, referenceNode);
+  return 0.0;
+}
+
+//! Single-tree rescoring function.
+template<typename MetricType, typename TreeType>
+double MultiRangeCountRules<MetricType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+} // namespace range
+} // namespace mlpack
+
+#endif
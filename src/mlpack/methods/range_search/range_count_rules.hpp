@@ -0,0 +1,136 @@
+/**
+ * @file methods/range_search/range_count_rules.hpp
+ *
+ * Rules for range counting, which counts the reference points in the range of
+ * each query point without storing them, so that it can be done with arbitrary
+ * tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_COUNT_RULES_HPP
+
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The RangeCountRules class is a template helper class used by RangeSearch
+ * when counting the points in a range with single-tree traversals.  When the
+ * whole bound of a reference node is in the range of a query point, all of the
+ * descendants of the node are counted at once, and the node is pruned.
+ *
+ * If the query and reference sets are the same, a point is counted in its own
+ * range (with distance 0), so that whole nodes can be counted without checking
+ * which points they hold; the caller subtracts it afterwards.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename MetricType, typename TreeType>
+class RangeCountRules
+{
+ public:
+  /**
+   * Construct the RangeCountRules object.  This is usually done from within
+   * the RangeSearch class at search time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to count the points of.
+   * @param counts Vector of counts (one per query point) to add the counted
+   *      points to.
+   * @param metric Instantiated metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same.
+   */
+  RangeCountRules(const arma::mat& referenceSet,
+                  const arma::mat& querySet,
+                  const math::Range& range,
+                  arma::Col<size_t>& counts,
+                  MetricType& metric,
+                  const bool sameSet = false);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node should
+   * not be recursed into at all: either it has no points in the range, or all
+   * its points were counted.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  The range does not change
+   * during the traversal, so this returns the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return 0; }
+
+ private:
+  //! The reference set.
+  const arma::mat& referenceSet;
+
+  //! The query set.
+  const arma::mat& querySet;
+
+  //! The range of distances for which we are counting.
+  const math::Range& range;
+
+  //! The counts of the query points.
+  arma::Col<size_t>& counts;
+
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! If true, the query and reference set are taken to be the same.
+  bool sameSet;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! The distances from the last scored query point to leaves.
+  tree::LeafDistanceCache<MetricType, arma::mat> leafDistances;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace range
+} // namespace mlpack
+
+// Include implementation.
+#include "range_count_rules_impl.hpp"
+
+#endif
@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include "range_search_stat.hpp"
 
 namespace mlpack {
@@ -268,6 +269,160 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in compressed sparse row (CSR) form
+   * instead of one vector per query point.  The neighbors of query point i are
+   * neighbors[offsets[i]] to neighbors[offsets[i + 1] - 1], with the
+   * corresponding distances at the same positions of distances; so offsets has
+   * one more element than there are query points, and the results of each
+   * query point are not sorted in any particular order.
+   *
+   * The query points are searched independently with a single-tree traversal
+   * (or a brute-force scan, if naive is set), in parallel if OpenMP is
+   * available; each thread collects its results in its own buffers, which are
+   * then copied into place.  The singleMode setting is ignored, because
+   * dual-tree traversals produce the results of a query point in several
+   * pieces.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Vector to store the start of the results of each query
+   *      point in.
+   * @param neighbors Vector to store the indices of all found points in.
+   * @param distances Vector to store the distances of all found points in.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in compressed sparse row (CSR) form.  A point
+   * is not returned in its own results.  See the bichromatic overload above
+   * for details on the output format.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Vector to store the start of the results of each point in.
+   * @param neighbors Vector to store the indices of all found points in.
+   * @param distances Vector to store the distances of all found points in.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing them.  When the whole bound of a reference node is in
+   * the range of a query point, all the points of the node are counted at
+   * once, so this is much faster than Search() for large ranges, and only
+   * needs one number per query point.
+   *
+   * The query points are counted independently with a single-tree traversal
+   * (or a brute-force scan, if naive is set), in parallel if OpenMP is
+   * available.  The singleMode setting is ignored.
+   *
+   * @param querySet Set of query points to count with.
+   * @param range Range of distances in which to count.
+   * @param counts Vector to store the number of reference points in the range
+   *      of each query point in.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set,
+   * without storing them.  A point is not counted in its own range.  See the
+   * bichromatic overload above for details.
+   *
+   * @param range Range of distances in which to count.
+   * @param counts Vector to store the number of points in the range of each
+   *      point in.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
+  /**
+   * Search for the reference points within each of several radii of each
+   * point in the query set, with a single search for the largest radius
+   * (which uses the naive and singleMode settings like the other Search()
+   * overloads).  This is much cheaper than one Search() per radius when
+   * sweeping a parameter such as the radius of DBSCAN.
+   *
+   * The radii must be nonnegative and in increasing order.  The neighbors and
+   * distances of each query point are returned sorted by increasing distance,
+   * and counts(k, i) is the number of reference points within radii[k] of
+   * query point i; so the neighbors of query point i within radii[k] are the
+   * first counts(k, i) entries of neighbors[i].
+   *
+   * @param querySet Set of query points to search with.
+   * @param radii Radii to search within, in increasing order.
+   * @param neighbors Object which will hold the neighbors within the largest
+   *      radius of each query point, sorted by distance.
+   * @param distances Object which will hold the distances corresponding to
+   *      the indices in neighbors.
+   * @param counts Matrix to store the number of neighbors within each radius
+   *      of each query point in (one row per radius).
+   */
+  void Search(const MatType& querySet,
+              const arma::vec& radii,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances,
+              arma::Mat<size_t>& counts);
+
+  /**
+   * Search for the points within each of several radii of each point in the
+   * reference set, with a single search for the largest radius.  A point is
+   * not returned in its own results.  See the bichromatic overload above for
+   * details on the output format.
+   *
+   * @param radii Radii to search within, in increasing order.
+   * @param neighbors Object which will hold the neighbors within the largest
+   *      radius of each point, sorted by distance.
+   * @param distances Object which will hold the distances corresponding to
+   *      the indices in neighbors.
+   * @param counts Matrix to store the number of neighbors within each radius
+   *      of each point in (one row per radius).
+   */
+  void Search(const arma::vec& radii,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances,
+              arma::Mat<size_t>& counts);
+
+  /**
+   * Count the reference points within each of several radii of each point in
+   * the query set with a single traversal, without storing them.  Reference
+   * nodes farther than the largest radius are pruned, the points of each base
+   * case are counted in the bucket between consecutive radii that holds their
+   * distance, and whole nodes whose bound is inside one bucket are counted at
+   * once.  As with the other Count() overloads, the query points are counted
+   * independently (in parallel if OpenMP is available), and the singleMode
+   * setting is ignored.
+   *
+   * @param querySet Set of query points to count with.
+   * @param radii Radii to count within; they must be nonnegative and in
+   *      increasing order.
+   * @param counts Matrix to store the number of reference points within
+   *      radii[k] of query point i in, at counts(k, i).
+   */
+  void Count(const MatType& querySet,
+             const arma::vec& radii,
+             arma::Mat<size_t>& counts);
+
+  /**
+   * Count the points within each of several radii of each point in the
+   * reference set with a single traversal.  A point is not counted in its own
+   * range.  See the bichromatic overload above for details.
+   *
+   * @param radii Radii to count within, in increasing order.
+   * @param counts Matrix to store the number of points within radii[k] of
+   *      point i in, at counts(k, i).
+   */
+  void Count(const arma::vec& radii, arma::Mat<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -279,9 +434,12 @@ class RangeSearch
   bool& Naive() { return naive; }
 
   //! Get the number of base cases during the last search.
-  size_t BaseCases() const { return baseCases; }
+  size_t BaseCases() const { return statistics.BaseCases(); }
   //! Get the number of scores during the last search.
-  size_t Scores() const { return scores; }
+  size_t Scores() const { return statistics.Scores(); }
+  //! Get the traversal statistics (base cases, scores, prunes and visited
+  //! nodes) of the last search.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
 
   //! Serialize the model.
   template<typename Archive>
@@ -313,10 +471,124 @@ class RangeSearch
   //! Instantiated distance metric.
   MetricType metric;
 
-  //! The total number of base cases during the last search.
-  size_t baseCases;
-  //! The total number of scores during the last search.
-  size_t scores;
+  //! The traversal statistics of the last search.
+  tree::TraversalStatistics statistics;
+
+  /**
+   * Perform a single-tree traversal of the reference tree for each point in
+   * the given query set, storing the results in the given vectors (which must
+   * already have one entry per query point) and setting the base case and
+   * score counts.  If OpenMP is available and more than one thread can be
+   * used, the query points are processed in parallel, with one rules object
+   * and traverser per thread.
+   *
+   * @param querySet Set of query points.
+   * @param range Range of distances to search for.
+   * @param neighbors Vector to store the neighbors of each query point in.
+   * @param distances Vector to store the distances of each query point in.
+   * @param sameSet Whether the query and reference sets are the same.
+   */
+  void SingleTreeTraversal(const MatType& querySet,
+                           const math::Range& range,
+                           std::vector<std::vector<size_t>>& neighbors,
+                           std::vector<std::vector<double>>& distances,
+                           const bool sameSet);
+
+  /**
+   * Perform a dual-tree traversal of the given query tree against the
+   * reference tree, storing the results in the given vectors (which must
+   * already have one entry per query point) and setting the base case and
+   * score counts.  If OpenMP is available and more than one thread can be
+   * used, the query tree is split into disjoint subtrees that are traversed in
+   * parallel, each with its own rules object; the set of results is identical
+   * to that of the serial traversal.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param range Range of distances to search for.
+   * @param neighbors Vector to store the neighbors of each query point in.
+   * @param distances Vector to store the distances of each query point in.
+   * @param sameSet Whether the query and reference trees are the same.
+   */
+  void DualTreeTraversal(Tree& queryTree,
+                         const math::Range& range,
+                         std::vector<std::vector<size_t>>& neighbors,
+                         std::vector<std::vector<double>>& distances,
+                         const bool sameSet);
+
+  /**
+   * Search for the points in the given range of each query point separately,
+   * storing the results in CSR form, and setting the base case and score
+   * counts.  This is used by both Search() overloads that return CSR output.
+   *
+   * @param querySet Set of query points.
+   * @param range Range of distances to search for.
+   * @param offsets Vector to store the start of the results of each query
+   *      point in.
+   * @param neighbors Vector to store the indices of all found points in.
+   * @param distances Vector to store the distances of all found points in.
+   * @param sameSet Whether the query set is the reference set.
+   */
+  void CompactSearch(const MatType& querySet,
+                     const math::Range& range,
+                     arma::Col<size_t>& offsets,
+                     arma::Col<size_t>& neighbors,
+                     arma::vec& distances,
+                     const bool sameSet);
+
+  /**
+   * Count the points in the given range of each query point separately, and
+   * set the base case and score counts.  This is used by both Count()
+   * overloads.
+   *
+   * @param querySet Set of query points.
+   * @param range Range of distances to count the points of.
+   * @param counts Vector to store the counts in.
+   * @param sameSet Whether the query set is the reference set.
+   */
+  void CountPoints(const MatType& querySet,
+                   const math::Range& range,
+                   arma::Col<size_t>& counts,
+                   const bool sameSet);
+
+  /**
+   * Count the points within each of the given radii of each query point
+   * separately, and set the base case and score counts.  This is used by both
+   * multi-radius Count() overloads.
+   *
+   * @param querySet Set of query points.
+   * @param radii Radii to count within, in increasing order.
+   * @param counts Matrix to store the counts in.
+   * @param sameSet Whether the query set is the reference set.
+   */
+  void CountRadii(const MatType& querySet,
+                  const arma::vec& radii,
+                  arma::Mat<size_t>& counts,
+                  const bool sameSet);
+
+  /**
+   * Sort the results of each query point by distance, and count the results
+   * within each radius.  This is used by both multi-radius Search()
+   * overloads.
+   *
+   * @param radii Radii to count within, in increasing order.
+   * @param neighbors Neighbors of each query point.
+   * @param distances Distances of each query point.
+   * @param counts Matrix to store the counts in.
+   */
+  static void SortByRadius(const arma::vec& radii,
+                           std::vector<std::vector<size_t>>& neighbors,
+                           std::vector<std::vector<double>>& distances,
+                           arma::Mat<size_t>& counts);
+
+  /**
+   * Throw an exception if the given radii are empty, negative, or not in
+   * increasing order.
+   *
+   * @param radii Radii to check.
+   * @param functionName Name of the calling function, for the error message.
+   */
+  static void CheckRadii(const arma::vec& radii,
+                         const std::string& functionName);
 
   //! For access to mappings when building models.
   friend class LeafSizeRSWrapper<TreeType>;
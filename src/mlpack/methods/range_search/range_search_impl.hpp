@@ -17,6 +17,9 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include "range_count_rules.hpp"
+#include "multi_range_count_rules.hpp"
+#include <mlpack/core/tree/query_subtrees.hpp>
 
 namespace mlpack {
 namespace range {
@@ -60,8 +63,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     naive(naive),
     singleMode(!naive && singleMode),
     metric(metric),
-    baseCases(0),
-    scores(0)
+    statistics()
 {
   // Nothing to do.
 }
@@ -81,8 +83,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     naive(false),
     singleMode(singleMode),
     metric(metric),
-    baseCases(0),
-    scores(0)
+    statistics()
 {
   // Nothing else to initialize.
 }
@@ -102,8 +103,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     naive(naive),
     singleMode(singleMode),
     metric(metric),
-    baseCases(0),
-    scores(0)
+    statistics()
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -130,8 +130,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     naive(other.naive),
     singleMode(other.singleMode),
     metric(other.metric),
-    baseCases(other.baseCases),
-    scores(other.scores)
+    statistics(other.statistics)
 {
   // Nothing to do.
 }
@@ -149,8 +148,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     naive(other.naive),
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
-    baseCases(other.baseCases),
-    scores(other.scores)
+    statistics(other.statistics)
 {
   // Clear other object.
   other.referenceTree =
@@ -159,8 +157,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.treeOwner = true;
   other.naive = false;
   other.singleMode = false;
-  other.baseCases = 0;
-  other.scores = 0;
+  other.statistics.Reset();
 }
 
 template<typename MetricType,
@@ -181,8 +178,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(const RangeSearch& other)
     naive = other.naive;
     singleMode = other.singleMode;
     metric = other.metric;
-    baseCases = other.baseCases;
-    scores = other.scores;
+    statistics = other.statistics;
   }
   return *this;
 }
@@ -211,8 +207,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
     naive = other.naive;
     singleMode = other.singleMode;
     metric = std::move(other.metric);
-    baseCases = other.baseCases;
-    scores = other.scores;
+    statistics = other.statistics;
 
     // Clear other object.
     other.referenceTree = nullptr;
@@ -220,8 +215,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch&& other)
     other.treeOwner = false;
     other.naive = false;
     other.singleMode = false;
-    other.baseCases = 0;
-    other.scores = 0;
+    other.statistics.Reset();
 
   }
   return *this;
@@ -358,8 +352,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   typedef RangeSearchRules<MetricType, Tree> RuleType;
 
   // Reset counts.
-  baseCases = 0;
-  scores = 0;
+  statistics.Reset();
 
   if (naive)
   {
@@ -371,21 +364,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       for (size_t j = 0; j < referenceSet->n_cols; ++j)
         rules.BaseCase(i, j);
 
-    baseCases += (querySet.n_cols * referenceSet->n_cols);
+    statistics.BaseCases() += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    // Traverse for each point.
+    SingleTreeTraversal(querySet, range, *neighborPtr, *distancePtr, false);
   }
   else // Dual-tree recursion.
   {
@@ -396,21 +380,14 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    DualTreeTraversal(*queryTree, range, *neighborPtr, *distancePtr, false);
 
     // Clean up tree memory.
     delete queryTree;
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -516,20 +493,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   distances.clear();
   distances.resize(querySet.n_cols);
 
-  // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
-
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, range, *neighborPtr, distances, false);
 
   Timer::Stop("range_search/computing_neighbors");
-
-  baseCases = rules.BaseCases();
-  scores = rules.Scores();
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   // Do we need to map indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -595,33 +562,21 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
       for (size_t j = 0; j < referenceSet->n_cols; ++j)
         rules.BaseCase(i, j);
 
-    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
-    scores = 0;
+    statistics.Reset();
+    statistics.BaseCases() = (referenceSet->n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    // Traverse for each point.
+    SingleTreeTraversal(*referenceSet, range, *neighborPtr, *distancePtr, true);
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    DualTreeTraversal(*referenceTree, range, *neighborPtr, *distancePtr, true);
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
 
   // Do we need to map the reference indices?
   if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
@@ -651,6 +606,270 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Search()", "query set");
+
+  Timer::Start("range_search/computing_neighbors");
+  CompactSearch(querySet, range, offsets, neighbors, distances, false);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  Timer::Start("range_search/computing_neighbors");
+  CompactSearch(*referenceSet, range, offsets, neighbors, distances, true);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Count()", "query set");
+
+  Timer::Start("range_search/computing_neighbors");
+  CountPoints(querySet, range, counts, false);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  Timer::Start("range_search/computing_neighbors");
+  CountPoints(*referenceSet, range, counts, true);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const arma::vec& radii,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    arma::Mat<size_t>& counts)
+{
+  CheckRadii(radii, "RangeSearch::Search()");
+
+  // One search with the largest radius finds the neighbors for every radius.
+  neighbors.clear();
+  distances.clear();
+  Search(querySet, math::Range(0.0, radii[radii.n_elem - 1]), neighbors,
+      distances);
+
+  // If the reference set is empty, no search was done at all.
+  neighbors.resize(querySet.n_cols);
+  distances.resize(querySet.n_cols);
+  SortByRadius(radii, neighbors, distances, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const arma::vec& radii,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    arma::Mat<size_t>& counts)
+{
+  CheckRadii(radii, "RangeSearch::Search()");
+
+  neighbors.clear();
+  distances.clear();
+  Search(math::Range(0.0, radii[radii.n_elem - 1]), neighbors, distances);
+
+  neighbors.resize(referenceSet->n_cols);
+  distances.resize(referenceSet->n_cols);
+  SortByRadius(radii, neighbors, distances, counts);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const arma::vec& radii,
+    arma::Mat<size_t>& counts)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Count()", "query set");
+  CheckRadii(radii, "RangeSearch::Count()");
+
+  Timer::Start("range_search/computing_neighbors");
+  CountRadii(querySet, radii, counts, false);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const arma::vec& radii,
+    arma::Mat<size_t>& counts)
+{
+  CheckRadii(radii, "RangeSearch::Count()");
+
+  Timer::Start("range_search/computing_neighbors");
+  CountRadii(*referenceSet, radii, counts, true);
+  Timer::Stop("range_search/computing_neighbors");
+  Log::Info << "Tree traversal: " << statistics << "." << std::endl;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const bool sameSet)
+{
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+
+#ifdef HAS_OPENMP
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  if (omp_get_max_threads() > 1 && !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    statistics.Reset();
+
+    #pragma omp parallel
+    {
+      // Each query point is only handled by one thread, so each thread only
+      // touches its own entries of the result vectors.
+      RuleType rules(*referenceSet, querySet, range, neighbors, distances,
+          metric, sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(rules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+
+    return;
+  }
+#endif
+
+  RuleType rules(*referenceSet, querySet, range, neighbors, distances, metric,
+      sameSet);
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+  // Now have it traverse for each point.
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  statistics.Reset();
+  statistics.Add(rules, traverser);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const bool sameSet)
+{
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Each subtree holds a disjoint set of query points, so each rules object
+    // only touches its own entries of the result vectors.
+    std::vector<Tree*> querySubtrees;
+    tree::QuerySubtrees(queryTree, 4 * numThreads, querySubtrees);
+
+    statistics.Reset();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+    {
+      RuleType rules(*referenceSet, queryTree.Dataset(), range, neighbors,
+          distances, metric, sameSet);
+      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      traverser.Traverse(*querySubtrees[i], *referenceTree);
+
+      tree::TraversalStatistics taskStatistics;
+      taskStatistics.Add(rules, traverser);
+      #pragma omp critical
+      statistics += taskStatistics;
+    }
+
+    return;
+  }
+#endif
+
+  RuleType rules(*referenceSet, queryTree.Dataset(), range, neighbors,
+      distances, metric, sameSet);
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  statistics.Reset();
+  statistics.Add(rules, traverser);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -667,8 +886,7 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
   // Reset base cases and scores if we are loading.
   if (cereal::is_loading<Archive>())
   {
-    baseCases = 0;
-    scores = 0;
+    statistics.Reset();
   }
 
   // If we are doing naive search, we serialize the dataset.  Otherwise we
@@ -720,6 +938,376 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::CompactSearch(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances,
+    const bool sameSet)
+{
+  typedef RangeSearchRules<MetricType, Tree> RuleType;
+
+  // offsets[i + 1] first holds the number of results of query point i, and is
+  // turned into the end of its results once all counts are known.
+  offsets.zeros(querySet.n_cols + 1);
+  neighbors.reset();
+  distances.reset();
+  statistics.Reset();
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // Indices into a tree we built have to be mapped back; in the monochromatic
+  // case, this includes the query indices.
+  const bool mapIndices = !naive && treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset;
+
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  const bool parallel = naive || !tree::TreeTraits<Tree>::HasSelfChildren;
+
+  #pragma omp parallel if (parallel)
+  {
+    // The results of the queries handled by this thread, in the order they
+    // were handled, with the query index and the start of its results.
+    std::vector<size_t> threadNeighbors;
+    std::vector<double> threadDistances;
+    std::vector<std::pair<size_t, size_t>> threadQueries;
+
+    // Each query point is searched as a one-point query set, so that the
+    // rules only need one result vector.
+    arma::mat query(querySet.n_rows, 1);
+    std::vector<std::vector<size_t>> queryNeighbors(1);
+    std::vector<std::vector<double>> queryDistances(1);
+    tree::TraversalStatistics threadStatistics;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const size_t outIndex = (sameSet && mapIndices) ?
+          oldFromNewReferences[i] : (size_t) i;
+      const size_t start = threadNeighbors.size();
+      threadQueries.push_back(std::make_pair(outIndex, start));
+
+      if (naive)
+      {
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        {
+          if (sameSet && j == (size_t) i)
+            continue;
+
+          const double distance = metric.Evaluate(querySet.col(i),
+              referenceSet->col(j));
+          if (range.Contains(distance))
+          {
+            threadNeighbors.push_back(j);
+            threadDistances.push_back(distance);
+          }
+        }
+        threadStatistics.BaseCases() += referenceSet->n_cols;
+      }
+      else
+      {
+        query.col(0) = querySet.col(i);
+        queryNeighbors[0].clear();
+        queryDistances[0].clear();
+
+        // The rules remember the last base case, so a new rules object is
+        // needed for every query point.
+        RuleType rules(*referenceSet, query, range, queryNeighbors,
+            queryDistances, metric);
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(0, *referenceTree);
+        threadStatistics.Add(rules, traverser);
+
+        for (size_t j = 0; j < queryNeighbors[0].size(); ++j)
+        {
+          const size_t neighbor = queryNeighbors[0][j];
+          if (sameSet && neighbor == (size_t) i)
+            continue;
+
+          threadNeighbors.push_back(mapIndices ?
+              oldFromNewReferences[neighbor] : neighbor);
+          threadDistances.push_back(queryDistances[0][j]);
+        }
+      }
+
+      offsets[outIndex + 1] = threadNeighbors.size() - start;
+    }
+
+    #pragma omp critical
+    statistics += threadStatistics;
+
+    #pragma omp single
+    {
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        offsets[i + 1] += offsets[i];
+
+      neighbors.set_size(offsets[querySet.n_cols]);
+      distances.set_size(offsets[querySet.n_cols]);
+    }
+
+    // Copy the results of this thread into place.
+    for (size_t q = 0; q < threadQueries.size(); ++q)
+    {
+      const size_t start = threadQueries[q].second;
+      const size_t end = (q + 1 < threadQueries.size()) ?
+          threadQueries[q + 1].second : threadNeighbors.size();
+      const size_t outStart = offsets[threadQueries[q].first];
+      std::copy(threadNeighbors.begin() + start, threadNeighbors.begin() + end,
+          neighbors.begin() + outStart);
+      std::copy(threadDistances.begin() + start, threadDistances.begin() + end,
+          distances.begin() + outStart);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::CountPoints(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts,
+    const bool sameSet)
+{
+  typedef RangeCountRules<MetricType, Tree> RuleType;
+
+  counts.zeros(querySet.n_cols);
+  statistics.Reset();
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  const bool parallel = naive || !tree::TreeTraits<Tree>::HasSelfChildren;
+
+  #pragma omp parallel if (parallel)
+  {
+    tree::TraversalStatistics threadStatistics;
+
+    if (naive)
+    {
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      {
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        {
+          if (sameSet && j == (size_t) i)
+            continue;
+
+          if (range.Contains(metric.Evaluate(querySet.col(i),
+              referenceSet->col(j))))
+            ++counts[i];
+        }
+        threadStatistics.BaseCases() += referenceSet->n_cols;
+      }
+    }
+    else
+    {
+      // Each query point only changes its own count, so one rules object and
+      // traverser can be used for all the query points of the thread.
+      RuleType rules(*referenceSet, querySet, range, counts, metric, sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadStatistics.Add(rules, traverser);
+    }
+
+    #pragma omp critical
+    statistics += threadStatistics;
+  }
+
+  if (sameSet && !naive)
+  {
+    // The rules count each point in its own range (when the range contains 0).
+    if (range.Contains(0.0))
+      counts -= 1;
+
+    // Map the counts of a rearranged reference set back to the original order.
+    if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      arma::Col<size_t> mappedCounts(counts.n_elem);
+      for (size_t i = 0; i < counts.n_elem; ++i)
+        mappedCounts[oldFromNewReferences[i]] = counts[i];
+      counts.swap(mappedCounts);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::CountRadii(
+    const MatType& querySet,
+    const arma::vec& radii,
+    arma::Mat<size_t>& counts,
+    const bool sameSet)
+{
+  typedef MultiRangeCountRules<MetricType, Tree> RuleType;
+
+  // First each point is only counted in the bucket of its distance.
+  counts.zeros(radii.n_elem, querySet.n_cols);
+  statistics.Reset();
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  const bool parallel = naive || !tree::TreeTraits<Tree>::HasSelfChildren;
+
+  #pragma omp parallel if (parallel)
+  {
+    tree::TraversalStatistics threadStatistics;
+
+    if (naive)
+    {
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+      {
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        {
+          if (sameSet && j == (size_t) i)
+            continue;
+
+          const size_t bucket = RuleType::Bucket(radii,
+              metric.Evaluate(querySet.col(i), referenceSet->col(j)));
+          if (bucket < radii.n_elem)
+            ++counts(bucket, i);
+        }
+        threadStatistics.BaseCases() += referenceSet->n_cols;
+      }
+    }
+    else
+    {
+      // Each query point only changes its own counts, so one rules object and
+      // traverser can be used for all the query points of the thread.
+      RuleType rules(*referenceSet, querySet, radii, counts, metric, sameSet);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadStatistics.Add(rules, traverser);
+    }
+
+    #pragma omp critical
+    statistics += threadStatistics;
+  }
+
+  // The points within radii[k] are those in the first k + 1 buckets.
+  counts = arma::cumsum(counts);
+
+  if (sameSet && !naive)
+  {
+    // The rules count each point in its own range (every radius contains 0).
+    counts -= 1;
+
+    // Map the counts of a rearranged reference set back to the original order.
+    if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      arma::Mat<size_t> mappedCounts(counts.n_rows, counts.n_cols);
+      for (size_t i = 0; i < counts.n_cols; ++i)
+        mappedCounts.col(oldFromNewReferences[i]) = counts.col(i);
+      counts.swap(mappedCounts);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::SortByRadius(
+    const arma::vec& radii,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    arma::Mat<size_t>& counts)
+{
+  counts.set_size(radii.n_elem, neighbors.size());
+
+  #pragma omp parallel
+  {
+    std::vector<size_t> order;
+    std::vector<size_t> sortedNeighbors;
+    std::vector<double> sortedDistances;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) neighbors.size(); ++i)
+    {
+      // Sort the results of this query point by distance.
+      const std::vector<double>& d = distances[i];
+      order.resize(d.size());
+      for (size_t j = 0; j < order.size(); ++j)
+        order[j] = j;
+      std::sort(order.begin(), order.end(),
+          [&d](const size_t a, const size_t b) { return d[a] < d[b]; });
+
+      sortedNeighbors.resize(order.size());
+      sortedDistances.resize(order.size());
+      for (size_t j = 0; j < order.size(); ++j)
+      {
+        sortedNeighbors[j] = neighbors[i][order[j]];
+        sortedDistances[j] = d[order[j]];
+      }
+      neighbors[i].swap(sortedNeighbors);
+      distances[i].swap(sortedDistances);
+
+      // The results within each radius are now a prefix of the results.
+      for (size_t k = 0; k < radii.n_elem; ++k)
+      {
+        counts(k, i) = std::upper_bound(distances[i].begin(),
+            distances[i].end(), radii[k]) - distances[i].begin();
+      }
+    }
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::CheckRadii(
+    const arma::vec& radii,
+    const std::string& functionName)
+{
+  if (radii.n_elem == 0)
+  {
+    throw std::invalid_argument(functionName + ": at least one radius must "
+        "be given!");
+  }
+
+  if (radii[0] < 0.0)
+  {
+    throw std::invalid_argument(functionName + ": the radii must be "
+        "nonnegative!");
+  }
+
+  for (size_t k = 1; k < radii.n_elem; ++k)
+  {
+    if (radii[k] < radii[k - 1])
+    {
+      throw std::invalid_argument(functionName + ": the radii must be in "
+          "increasing order!");
+    }
+  }
+}
+
 } // namespace range
 } // namespace mlpack
 
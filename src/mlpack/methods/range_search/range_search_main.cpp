@@ -112,7 +112,40 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 // Search settings.
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
-    "dual-tree search).", "S");
+    "dual-tree search).  The query points are then searched in parallel, and "
+    "their results are collected directly into flat arrays.", "S");
+
+// Save range search results in CSR form to the given file, with one line per
+// query point.  Lines may be empty, if no points were found.
+template<typename eT>
+void SaveResults(const string& filename,
+                 const string& description,
+                 const arma::Col<size_t>& offsets,
+                 const arma::Col<eT>& values)
+{
+  fstream stream(filename.c_str(), fstream::out);
+  if (!stream.is_open())
+  {
+    Log::Warn << "Cannot open file '" << filename << "' to save output "
+        << description << " to!" << endl;
+    return;
+  }
+
+  // Loop over each point.
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      if (j > offsets[i])
+        stream << ", ";
+      stream << values[j];
+    }
+
+    stream << endl;
+  }
+
+  stream.close();
+}
 
 static void mlpackMain()
 {
@@ -253,74 +286,55 @@ static void mlpackMain()
       Log::Warn << PRINT_PARAM_STRING("single_mode") << " ignored because "
           << PRINT_PARAM_STRING("naive") << " is present." << endl;
 
-    // Now run the search.
-    vector<vector<size_t>> neighbors;
-    vector<vector<double>> distances;
-
-    if (IO::HasParam("query"))
-      rs->Search(std::move(queryData), r, neighbors, distances);
+    // Now run the search.  Single-tree and naive searches write their results
+    // directly into flat arrays; dual-tree results are flattened afterwards.
+    arma::Col<size_t> offsets;
+    arma::Col<size_t> neighbors;
+    arma::vec distances;
+    if (naive || singleMode)
+    {
+      if (IO::HasParam("query"))
+        rs->Search(std::move(queryData), r, offsets, neighbors, distances);
+      else
+        rs->Search(r, offsets, neighbors, distances);
+    }
     else
-      rs->Search(r, neighbors, distances);
+    {
+      vector<vector<size_t>> neighborLists;
+      vector<vector<double>> distanceLists;
+      if (IO::HasParam("query"))
+        rs->Search(std::move(queryData), r, neighborLists, distanceLists);
+      else
+        rs->Search(r, neighborLists, distanceLists);
 
-    Log::Info << "Search complete." << endl;
+      offsets.zeros(neighborLists.size() + 1);
+      for (size_t i = 0; i < neighborLists.size(); ++i)
+        offsets[i + 1] = offsets[i] + neighborLists[i].size();
 
-    // Save output, if desired.  We have to do this by hand.
-    if (IO::HasParam("distances_file"))
-    {
-      const string distancesFile = IO::GetParam<string>("distances_file");
-      fstream distancesStr(distancesFile.c_str(), fstream::out);
-      if (!distancesStr.is_open())
+      neighbors.set_size(offsets[neighborLists.size()]);
+      distances.set_size(offsets[neighborLists.size()]);
+      for (size_t i = 0; i < neighborLists.size(); ++i)
       {
-        Log::Warn << "Cannot open file '" << distancesFile << "' to save output"
-            << " distances to!" << endl;
+        std::copy(neighborLists[i].begin(), neighborLists[i].end(),
+            neighbors.begin() + offsets[i]);
+        std::copy(distanceLists[i].begin(), distanceLists[i].end(),
+            distances.begin() + offsets[i]);
       }
-      else
-      {
-        // Loop over each point.
-        for (size_t i = 0; i < distances.size(); ++i)
-        {
-          // Store the distances of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < distances[i].size(); ++j)
-            distancesStr << distances[i][j] << ", ";
-
-          if (distances[i].size() > 0)
-            distancesStr << distances[i][distances[i].size() - 1];
+    }
 
-          distancesStr << endl;
-        }
+    Log::Info << "Search complete." << endl;
 
-        distancesStr.close();
-      }
+    // Save output, if desired.  We have to do this by hand.
+    if (IO::HasParam("distances_file"))
+    {
+      SaveResults(IO::GetParam<string>("distances_file"), "distances",
+          offsets, distances);
     }
 
     if (IO::HasParam("neighbors_file"))
     {
-      const string neighborsFile = IO::GetParam<string>("neighbors_file");
-      fstream neighborsStr(neighborsFile.c_str(), fstream::out);
-      if (!neighborsStr.is_open())
-      {
-        Log::Warn << "Cannot open file '" << neighborsFile << "' to save output"
-            << " neighbor indices to!" << endl;
-      }
-      else
-      {
-        // Loop over each point.
-        for (size_t i = 0; i < neighbors.size(); ++i)
-        {
-          // Store the neighbors of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < neighbors[i].size(); ++j)
-            neighborsStr << neighbors[i][j] << ", ";
-
-          if (neighbors[i].size() > 0)
-            neighborsStr << neighbors[i][neighbors[i].size() - 1];
-
-          neighborsStr << endl;
-        }
-
-        neighborsStr.close();
-      }
+      SaveResults(IO::GetParam<string>("neighbors_file"), "neighbor indices",
+          offsets, neighbors);
     }
   }
 
@@ -58,8 +58,13 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
     return 0.0; // No value to return... this shouldn't do anything bad.
 
-  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
-      referenceSet.unsafe_col(referenceIndex));
+  double distance;
+  if (!leafDistances.Distance(querySet, referenceSet, queryIndex,
+      referenceIndex, distance))
+  {
+    distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+        referenceSet.unsafe_col(referenceIndex));
+  }
   ++baseCases;
 
   // Update last indices, so we don't accidentally perform a base case twice.
@@ -131,7 +136,9 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
   }
 
   // Otherwise the score doesn't matter.  Recursion order is irrelevant in
-  // range search.
+  // range search.  The points of the node will be visited next, so their
+  // distances can be computed together.
+  leafDistances.Prepare(queryIndex, referenceNode);
   return 0.0;
 }
 
@@ -75,6 +75,19 @@ class RSWrapperBase
   virtual void Search(const math::Range& range,
                       std::vector<std::vector<size_t>>& neighbors,
                       std::vector<std::vector<double>>& distances) = 0;
+
+  //! Perform bichromatic range search, returning the results in CSR form.
+  virtual void Search(arma::mat&& querySet,
+                      const math::Range& range,
+                      arma::Col<size_t>& offsets,
+                      arma::Col<size_t>& neighbors,
+                      arma::vec& distances) = 0;
+
+  //! Perform monochromatic range search, returning the results in CSR form.
+  virtual void Search(const math::Range& range,
+                      arma::Col<size_t>& offsets,
+                      arma::Col<size_t>& neighbors,
+                      arma::vec& distances) = 0;
 };
 
 /**
@@ -132,6 +145,19 @@ class RSWrapper : public RSWrapperBase
                       std::vector<std::vector<size_t>>& neighbors,
                       std::vector<std::vector<double>>& distances);
 
+  //! Perform bichromatic range search, returning the results in CSR form.
+  virtual void Search(arma::mat&& querySet,
+                      const math::Range& range,
+                      arma::Col<size_t>& offsets,
+                      arma::Col<size_t>& neighbors,
+                      arma::vec& distances);
+
+  //! Perform monochromatic range search, returning the results in CSR form.
+  virtual void Search(const math::Range& range,
+                      arma::Col<size_t>& offsets,
+                      arma::Col<size_t>& neighbors,
+                      arma::vec& distances);
+
   //! Serialize the RangeSearch model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -347,6 +373,40 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform range search, returning the results in compressed sparse row
+   * form.  This takes possession of the query set.  The query points are
+   * searched independently in parallel, with single-tree search unless naive
+   * search is used.  For more information on the output format, see
+   * RangeSearch<>::Search().
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param offsets Output: start of the results of each query point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(arma::mat&& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Perform monochromatic range search, returning the results in compressed
+   * sparse row form.  For more information on the output format, see
+   * RangeSearch<>::Search().
+   *
+   * @param range Range to search for.
+   * @param offsets Output: start of the results of each point.
+   * @param neighbors Output: neighbors falling within the desired range.
+   * @param distances Output: distances of neighbors.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
  private:
   //! The type of tree we are using.
   TreeTypes treeType;
@@ -395,6 +395,33 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Perform a single-tree traversal of the reference tree for each of the
+   * query points held by the given rules.  If OpenMP is available and more
+   * than one thread can be used, the query points are processed in parallel;
+   * each thread uses its own rules object and traverser, sharing the candidate
+   * lists and sample counts of the given rules.
+   *
+   * @param numQueries Number of query points.
+   * @param rules Rules holding the candidate lists for the query points.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(const size_t numQueries, RuleType& rules);
+
+  /**
+   * Perform a dual-tree traversal of the given query tree against the
+   * reference tree with the given rules.  If OpenMP is available and more than
+   * one thread can be used, the query tree is split into disjoint subtrees
+   * that are traversed against the reference tree in parallel; each thread
+   * uses its own rules object (with its own stream of samples) that shares the
+   * candidate lists of the given rules.
+   *
+   * @param queryTree Tree built on the query points.
+   * @param rules Rules holding the candidate lists for the query points.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(Tree& queryTree, RuleType& rules);
+
   //! For access to mappings when building models.
   friend class LeafSizeRAWrapper<TreeType>;
 }; // class RASearch
@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "ra_search_rules.hpp"
+#include <mlpack/core/tree/query_subtrees.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -323,12 +324,8 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      SingleTreeTraversal(querySet.n_cols, rules);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -352,12 +349,11 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    DualTreeTraversal(*queryTree, rules);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
@@ -466,9 +462,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(*queryTree, rules);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -539,19 +533,12 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse for each point.
+    SingleTreeTraversal(referenceSet->n_cols, rules);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    DualTreeTraversal(*referenceTree, rules);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -597,6 +584,104 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::ResetQueryTree(
     ResetQueryTree(&queryNode->Child(i));
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeTraversal(
+    const size_t numQueries,
+    RuleType& rules)
+{
+  typedef typename Tree::template SingleTreeTraverser<RuleType> TraverserType;
+
+#ifdef HAS_OPENMP
+  // For trees with self-children, the single-tree rules cache distances in the
+  // statistics of reference nodes, so those can't be shared between threads.
+  if (omp_get_max_threads() > 1 && !tree::TreeTraits<Tree>::HasSelfChildren)
+  {
+    size_t taskDistComputations = 0;
+
+    #pragma omp parallel reduction(+:taskDistComputations)
+    {
+      RuleType taskRules(rules, metric);
+      TraverserType traverser(taskRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) numQueries; ++i)
+      {
+        taskRules.Reseed(i);
+        traverser.Traverse(i, *referenceTree);
+      }
+
+      taskDistComputations += taskRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += taskDistComputations;
+    return;
+  }
+#endif
+
+  // Each query point has its own stream of samples, so the results don't
+  // depend on the number of threads.
+  TraverserType traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    rules.Reseed(i);
+    traverser.Traverse(i, *referenceTree);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::DualTreeTraversal(
+    Tree& queryTree,
+    RuleType& rules)
+{
+  typedef typename Tree::template DualTreeTraverser<RuleType> TraverserType;
+
+#ifdef HAS_OPENMP
+  // The dual-tree rules only modify the statistics of the query nodes, so the
+  // traversals of disjoint query subtrees are independent.  The sampling
+  // guarantees hold for each query node, so they still hold when the subtrees
+  // are traversed separately.
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Use a few more tasks than threads so that the load can be balanced.
+    std::vector<Tree*> querySubtrees;
+    tree::QuerySubtrees(queryTree, 4 * numThreads, querySubtrees);
+
+    size_t taskDistComputations = 0;
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:taskDistComputations)
+    for (omp_size_t i = 0; i < (omp_size_t) querySubtrees.size(); ++i)
+    {
+      RuleType taskRules(rules, metric);
+      taskRules.Reseed(i);
+      TraverserType traverser(taskRules);
+      traverser.Traverse(*querySubtrees[i], *referenceTree);
+
+      taskDistComputations += taskRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += taskDistComputations;
+    return;
+  }
+#endif
+
+  TraverserType traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
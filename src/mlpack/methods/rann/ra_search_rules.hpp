@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/traversal_info.hpp>
 
 #include <queue>
+#include <random>
 
 namespace mlpack {
 namespace neighbor {
@@ -66,6 +67,34 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Construct an RASearchRules object that shares the candidate lists and the
+   * sample counts of the given RASearchRules object, but has its own traversal
+   * information and statistics.  This is meant for parallel traversals, where
+   * each thread uses its own rules object on a disjoint set of query points;
+   * two threads must never work on the same query point.  Call GetResults() on
+   * the original object once all traversals are done.
+   *
+   * The new object draws its samples from its own random number generator, so
+   * threads don't share a generator; it has the seed of the given object, and
+   * Reseed() selects the stream of samples to use.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   * @param metric Instantiated metric.
+   */
+  RASearchRules(RASearchRules& other, MetricType& metric);
+
+  /**
+   * Restart the random number generator of the rules on the given stream of
+   * samples.  The samples of a stream only depend on the stream and on the
+   * seed drawn from math::randGen when the rules were constructed, so a search
+   * that restarts a stream for each query point (or each query subtree) makes
+   * the same samples no matter how the work is split between threads.
+   *
+   * @param stream Index of the stream of samples.
+   */
+  void Reseed(const size_t stream) { randGen.seed((uint32_t) (seed + stream)); }
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -227,7 +256,10 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  //! Get the number of distance computations.
+  size_t NumDistComputations() const { return numDistComputations; }
+  //! Modify the number of distance computations.
+  size_t& NumDistComputations() { return numDistComputations; }
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -268,8 +300,12 @@ class RASearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
+  //! Storage for the candidate neighbors of each point; this is empty if the
+  //! candidate lists are shared with another rules object.
+  std::vector<CandidateList> ownCandidates;
+
   //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -289,8 +325,12 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
+  //! Storage for the number of samples made for every query; this is empty if
+  //! the counts are shared with another rules object.
+  arma::Col<size_t> ownNumSamplesMade;
+
   //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  arma::Col<size_t>& numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -301,6 +341,12 @@ class RASearchRules
   //! If the query and reference set are identical, this is true.
   bool sameSet;
 
+  //! The seed of the streams of samples (see Reseed()).
+  size_t seed;
+
+  //! The random number generator used for sampling.
+  std::mt19937 randGen;
+
   TraversalInfoType traversalInfo;
 
   /**
@@ -314,6 +360,17 @@ class RASearchRules
                       const size_t neighbor,
                       const double distance);
 
+  /**
+   * Sample distinct points from a node with the given number of descendants.
+   *
+   * @param numDescendants Number of descendants of the node.
+   * @param samplesReqd Number of samples to take.
+   * @param distinctSamples Vector to store the indices of the samples in.
+   */
+  void ObtainNodeSamples(const size_t numDescendants,
+                         const size_t samplesReqd,
+                         arma::uvec& distinctSamples);
+
   /**
    * Perform actual scoring for single-tree case.
    */
@@ -85,6 +85,27 @@ class RegularizedSVD
              arma::mat& u,
              arma::mat& v);
 
+  /**
+   * Obtains the user and item matrices using the provided data and rank,
+   * optimizing with the given optimizer instead of SGD; for instance,
+   * optimization::HogwildSGD or optimization::StratifiedSGD can be used to
+   * train with several threads.  Optimizers other than StratifiedSGD must
+   * accept sparse gradients.  The learning rate and number of iterations of
+   * this object are ignored.
+   *
+   * @param data Rating data matrix.
+   * @param rank Rank parameter to be used for optimization.
+   * @param u Item matrix obtained on decomposition.
+   * @param v User matrix obtained on decomposition.
+   * @param optimizer Optimizer to use.
+   */
+  template<typename OptType>
+  void Apply(const arma::mat& data,
+             const size_t rank,
+             arma::mat& u,
+             arma::mat& v,
+             OptType& optimizer);
+
  private:
   //! Number of optimization iterations.
   size_t iterations;
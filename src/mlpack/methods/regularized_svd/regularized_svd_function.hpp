@@ -94,6 +94,33 @@ class RegularizedSVDFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take one SGD step on the given rating, for the StratifiedSGD optimizer.
+   * Only the columns of the user and the item of the rating are written.
+   *
+   * @param parameters Parameters(user/item matrices) of the
+   *     decomposition.
+   * @param i Index of the rating.
+   * @param stepSize Step size of the update.
+   * @param delayedUpdate Delayed update (unused).
+   */
+  void StratifiedUpdate(arma::mat& parameters,
+                        const size_t i,
+                        const double stepSize,
+                        arma::mat& delayedUpdate) const;
+
+  /**
+   * Add the delayed update written by StratifiedUpdate() to the parameters,
+   * and reset it.  There is no delayed update for
+   * RegularizedSVD, so this does nothing.
+   *
+   * @param parameters Parameters(user/item matrices) of the
+   *     decomposition.
+   * @param delayedUpdate Delayed update to apply.
+   */
+  void ApplyDelayedUpdate(arma::mat& parameters,
+                          arma::mat& delayedUpdate) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
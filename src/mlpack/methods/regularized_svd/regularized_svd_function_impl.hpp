@@ -150,6 +150,36 @@ void RegularizedSVDFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void RegularizedSVDFunction<MatType>::StratifiedUpdate(
+    arma::mat& parameters,
+    const size_t i,
+    const double stepSize,
+    arma::mat& /* delayedUpdate */) const
+{
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+
+  // Prediction error for the example.
+  const double rating = data(2, i);
+  const double ratingError = rating - arma::dot(parameters.col(user),
+                                                parameters.col(item));
+
+  // This is the same step as the one of the StandardSGD specialization.
+  parameters.col(user) -= stepSize * (lambda * parameters.col(user) -
+                                      ratingError * parameters.col(item));
+  parameters.col(item) -= stepSize * (lambda * parameters.col(item) -
+                                      ratingError * parameters.col(user));
+}
+
+template <typename MatType>
+void RegularizedSVDFunction<MatType>::ApplyDelayedUpdate(
+    arma::mat& /* parameters */,
+    arma::mat& /* delayedUpdate */) const
+{
+  // Every parameter is updated directly, so there is nothing to do.
+}
+
 } // namespace svd
 } // namespace mlpack
 
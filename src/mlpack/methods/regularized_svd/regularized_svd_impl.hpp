@@ -39,12 +39,21 @@ void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
   Log::Warn << "The batch size for optimizing RegularizedSVD is 1."
       << std::endl;
 
-  // Make the optimizer object using a RegularizedSVDFunction object.
-  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
   ens::StandardSGD optimizer(alpha, batchSize,
       iterations * data.n_cols);
+  Apply(data, rank, u, v, optimizer);
+}
 
-  // Get optimized parameters.
+template<typename OptimizerType>
+template<typename OptType>
+void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
+                                          const size_t rank,
+                                          arma::mat& u,
+                                          arma::mat& v,
+                                          OptType& optimizer)
+{
+  // Get optimized parameters using a RegularizedSVDFunction object.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
   arma::mat parameters = rSVDFunc.GetInitialPoint();
   optimizer.Optimize(rSVDFunc, parameters);
 
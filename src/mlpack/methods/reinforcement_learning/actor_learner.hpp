@@ -0,0 +1,324 @@
+/**
+ * @file methods/reinforcement_learning/actor_learner.hpp
+ *
+ * This file is the definition of the ActorLearner class, which trains a
+ * Q-network with many actor threads whose action values are computed in
+ * batches by a central inference thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ACTOR_LEARNER_HPP
+#define MLPACK_METHODS_RL_ACTOR_LEARNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "replay/concurrent_replay.hpp"
+#include "training_config.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * An actor-learner architecture for Q-learning, in the spirit of Ape-X and
+ * SEED RL.  Training runs three kinds of threads:
+ *
+ *  - config.NumWorkers() actor threads, each stepping its own copy of the
+ *    environment.  Actors do not evaluate the network; they send their
+ *    current state to the inference thread and wait for an action.
+ *  - One inference thread, which collects the pending states of the actors
+ *    into a batch (waiting at most maxWait microseconds for a batch of
+ *    maxBatchSize states), evaluates the network on the whole batch with one
+ *    call to Predict(), and selects the actions with the behavior policy.
+ *  - The learner, which runs on the thread that called Train().  It samples
+ *    the transitions that the actors store in a shared replay memory (by
+ *    default a ConcurrentReplay), updates the learning network exactly like
+ *    QLearning::TrainAgent(), and publishes the new parameters to the
+ *    inference thread every config.UpdateInterval() updates.
+ *
+ * For more details, see the following:
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *  title     = {Distributed Prioritized Experience Replay},
+ *  author    = {Horgan, Dan and Quan, John and Budden, David and
+ *               Barth-Maron, Gabriel and Hessel, Matteo and
+ *               van Hasselt, Hado and Silver, David},
+ *  booktitle = {International Conference on Learning Representations},
+ *  year      = {2018}
+ * }
+ * @endcode
+ *
+ * The behavior policy and the replay memory's Sample() draw from mlpack's
+ * global random number generator, so they, and the initial states of the
+ * episodes, are drawn under a common lock.  Because of this, the environment's
+ * Sample() method and the network should not draw random numbers (for
+ * instance, Acrobot, dropout and noisy layers are not supported).
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ * @tparam NetworkType The network to compute action value.
+ * @tparam UpdaterType How to apply gradients when training.
+ * @tparam PolicyType Behavior policy of the agent.
+ * @tparam ReplayType Experience replay method; Store() must be safe to call
+ *     from several threads at once.
+ */
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType = ConcurrentReplay<EnvironmentType>
+>
+class ActorLearner
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the ActorLearner object with given settings.
+   *
+   * @param config Hyper-parameters for training.
+   * @param network The network to compute action value.
+   * @param policy Behavior policy of the agent.
+   * @param replayMethod Experience replay method shared by the actors.
+   * @param updater How to apply gradients when training.
+   * @param environment Reinforcement learning task; each actor gets a copy.
+   * @param maxBatchSize Largest batch of states evaluated at once by the
+   *     inference thread; if 0, the number of actors is used.
+   * @param maxWait Longest time, in microseconds, that the inference thread
+   *     waits for a batch to fill up.
+   */
+  ActorLearner(TrainingConfig config,
+               NetworkType network,
+               PolicyType policy,
+               ReplayType& replayMethod,
+               UpdaterType updater = UpdaterType(),
+               EnvironmentType environment = EnvironmentType(),
+               const size_t maxBatchSize = 0,
+               const size_t maxWait = 1000);
+
+  //! Copying is not allowed, since the object is shared by its threads.
+  ActorLearner(const ActorLearner& other) = delete;
+  //! Copying is not allowed, since the object is shared by its threads.
+  ActorLearner& operator=(const ActorLearner& other) = delete;
+
+  /**
+   * Clean memory.
+   */
+  ~ActorLearner();
+
+  /**
+   * Train the network until the measure says to stop.  The measure is called
+   * on the learner thread with the return of every episode finished by an
+   * actor.
+   *
+   * @tparam Measure The type of the measurement. It should be a
+   *   callable object like
+   *   @code
+   *   bool foo(double reward);
+   *   @endcode
+   *   where reward is the total reward of an episode of an actor, and the
+   *   return value should indicate whether the training process is
+   *   completed.
+   * @param measure The measurement instance.
+   */
+  template <typename Measure>
+  void Train(Measure& measure);
+
+  /**
+   * Execute a deterministic test episode with the learning network, on the
+   * calling thread.
+   *
+   * @return Return of the episode.
+   */
+  double Episode();
+
+  //! Get the total number of steps taken by the actors.
+  size_t TotalSteps() const { return totalSteps.load(); }
+
+  //! Get the number of updates made by the learner.
+  size_t LearnerSteps() const { return learnerSteps; }
+
+  //! Get training config.
+  const TrainingConfig& Config() const { return config; }
+  //! Modify training config.
+  TrainingConfig& Config() { return config; }
+
+  //! Get the learning network.
+  const NetworkType& Network() const { return learningNetwork; }
+  //! Modify the learning network.
+  NetworkType& Network() { return learningNetwork; }
+
+  //! Get the behavior policy.
+  const PolicyType& Policy() const { return policy; }
+  //! Modify the behavior policy.
+  PolicyType& Policy() { return policy; }
+
+  //! Get the environment.
+  const EnvironmentType& Environment() const { return environment; }
+  //! Modify the environment.
+  EnvironmentType& Environment() { return environment; }
+
+  //! Get the largest batch evaluated at once by the inference thread.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+  //! Modify the largest batch evaluated at once by the inference thread.
+  size_t& MaxBatchSize() { return maxBatchSize; }
+
+  //! Get the longest wait for a batch, in microseconds.
+  size_t MaxWait() const { return maxWait; }
+  //! Modify the longest wait for a batch, in microseconds.
+  size_t& MaxWait() { return maxWait; }
+
+  //! Get the number of batches evaluated by the inference thread during the
+  //! last call to Train().
+  size_t InferenceBatches() const { return inferenceBatches; }
+
+ private:
+  /**
+   * Run an actor: step a copy of the environment, asking the inference
+   * thread for the actions, until training stops.
+   *
+   * @param id Index of the actor.
+   */
+  void Act(const size_t id);
+
+  /**
+   * Run the inference thread: evaluate the network on batches of the states
+   * sent by the actors until training stops.
+   */
+  void Serve();
+
+  /**
+   * Send the given state of the given actor to the inference thread and
+   * wait for the action to take.
+   *
+   * @param id Index of the actor.
+   * @param state Current state of the actor.
+   * @param action Action to take.
+   * @return false if training stopped before the action was selected.
+   */
+  bool RequestAction(const size_t id,
+                     const StateType& state,
+                     ActionType& action);
+
+  /**
+   * Update the learning network with a batch sampled from the replay memory.
+   */
+  void TrainAgent();
+
+  /**
+   * Select the best action based on given action value.
+   * @param actionValues Action values.
+   * @return Selected actions.
+   */
+  arma::Col<size_t> BestAction(const arma::mat& actionValues);
+
+  /**
+   * Stop all the threads after an error; the first error is rethrown by
+   * Train().
+   */
+  void Fail();
+
+  //! Locally-stored hyper-parameters.
+  TrainingConfig config;
+
+  //! Locally-stored learning network, used by the learner.
+  NetworkType learningNetwork;
+
+  //! Locally-stored target network, used by the learner.
+  NetworkType targetNetwork;
+
+  //! Locally-stored copy of the learning network, used by the inference
+  //! thread.
+  NetworkType actorNetwork;
+
+  //! Locally-stored behavior policy, used by the inference thread.
+  PolicyType policy;
+
+  //! Locally-stored experience method.
+  ReplayType& replayMethod;
+
+  //! Locally-stored updater.
+  UpdaterType updater;
+  #if ENS_VERSION_MAJOR >= 2
+  typename UpdaterType::template Policy<arma::mat, arma::mat>* updatePolicy;
+  #endif
+
+  //! Locally-stored reinforcement learning task.
+  EnvironmentType environment;
+
+  //! Locally-stored largest batch for the inference thread.
+  size_t maxBatchSize;
+
+  //! Locally-stored longest wait for a batch, in microseconds.
+  size_t maxWait;
+
+  //! Total steps of the actors since the start of the task.
+  std::atomic<size_t> totalSteps;
+
+  //! Number of updates made by the learner.
+  size_t learnerSteps;
+
+  //! Number of batches evaluated by the inference thread.
+  size_t inferenceBatches;
+
+  //! Whether training should stop.
+  std::atomic<bool> stop;
+
+  //! Protects the requests and answers below.
+  std::mutex inferenceMutex;
+  //! Signaled when an actor sends a state, or when training stops.
+  std::condition_variable requestReady;
+  //! Signaled when actions are selected, or when training stops.
+  std::condition_variable resultReady;
+  //! Encoded state sent by each actor.
+  arma::mat requests;
+  //! Whether each actor is waiting for its request to be evaluated.
+  std::vector<char> requested;
+  //! Whether the action of each actor is ready.
+  std::vector<char> answered;
+  //! Action selected for each actor.
+  std::vector<ActionType> actions;
+  //! Number of requests not yet taken by the inference thread.
+  size_t numPending;
+  //! Whether the inference thread stopped.
+  bool stopInference;
+
+  //! Protects the published parameters.
+  std::mutex parameterMutex;
+  //! Parameters of the learning network to be used by the inference thread.
+  arma::mat publishedParameters;
+  //! Whether new parameters were published.
+  bool parametersChanged;
+
+  //! Serializes the use of the global random number generator.
+  std::mutex randomMutex;
+
+  //! Protects the returns of the finished episodes.
+  std::mutex episodeMutex;
+  //! Returns of the episodes finished since the learner last looked.
+  std::vector<double> finishedReturns;
+
+  //! Protects the first error seen by a thread.
+  std::mutex errorMutex;
+  //! First error seen by a thread.
+  std::exception_ptr error;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation
+#include "actor_learner_impl.hpp"
+#endif
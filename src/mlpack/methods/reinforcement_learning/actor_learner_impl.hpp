@@ -0,0 +1,584 @@
+/**
+ * @file methods/reinforcement_learning/actor_learner_impl.hpp
+ *
+ * This file is the implementation of the ActorLearner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ACTOR_LEARNER_IMPL_HPP
+#define MLPACK_METHODS_RL_ACTOR_LEARNER_IMPL_HPP
+
+#include "actor_learner.hpp"
+
+#include <chrono>
+
+namespace mlpack {
+namespace rl {
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::ActorLearner(TrainingConfig config,
+                NetworkType network,
+                PolicyType policy,
+                ReplayType& replayMethod,
+                UpdaterType updater,
+                EnvironmentType environment,
+                const size_t maxBatchSize,
+                const size_t maxWait) :
+    config(std::move(config)),
+    learningNetwork(std::move(network)),
+    policy(std::move(policy)),
+    replayMethod(replayMethod),
+    updater(std::move(updater)),
+    #if ENS_VERSION_MAJOR >= 2
+    updatePolicy(NULL),
+    #endif
+    environment(std::move(environment)),
+    maxBatchSize(maxBatchSize),
+    maxWait(maxWait),
+    totalSteps(0),
+    learnerSteps(0),
+    inferenceBatches(0),
+    stop(false),
+    numPending(0),
+    stopInference(false),
+    parametersChanged(false)
+{
+  if (this->config.NumWorkers() == 0)
+  {
+    throw std::invalid_argument("ActorLearner::ActorLearner(): the number of "
+        "workers must be greater than 0!");
+  }
+
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("ActorLearner::ActorLearner(): the actors' "
+        "transitions are interleaved, so only single-step replay can be "
+        "used!");
+  }
+
+  // Set up the learning network, and copy it to the target and inference
+  // networks.
+  if (learningNetwork.Parameters().is_empty())
+    learningNetwork.ResetParameters();
+  targetNetwork = learningNetwork;
+  actorNetwork = learningNetwork;
+
+  #if ENS_VERSION_MAJOR == 1
+  this->updater.Initialize(learningNetwork.Parameters().n_rows,
+                           learningNetwork.Parameters().n_cols);
+  #else
+  this->updatePolicy = new typename UpdaterType::template
+      Policy<arma::mat, arma::mat>(this->updater,
+                                   learningNetwork.Parameters().n_rows,
+                                   learningNetwork.Parameters().n_cols);
+  #endif
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::~ActorLearner()
+{
+  #if ENS_VERSION_MAJOR >= 2
+  delete updatePolicy;
+  #endif
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+template <typename Measure>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Train(Measure& measure)
+{
+  const size_t numActors = config.NumWorkers();
+  stop = false;
+  error = nullptr;
+  inferenceBatches = 0;
+
+  // The inference thread starts from the current learning network.
+  actorNetwork.Parameters() = learningNetwork.Parameters();
+  parametersChanged = false;
+
+  requests.set_size(StateType::dimension, numActors);
+  requested.assign(numActors, 0);
+  answered.assign(numActors, 0);
+  actions.assign(numActors, ActionType());
+  numPending = 0;
+  stopInference = false;
+  finishedReturns.clear();
+
+  std::thread server(&ActorLearner::Serve, this);
+  std::vector<std::thread> actors;
+  for (size_t i = 0; i < numActors; ++i)
+    actors.push_back(std::thread(&ActorLearner::Act, this, i));
+
+  // Run the learner on this thread.
+  std::vector<double> returns;
+  try
+  {
+    while (!stop)
+    {
+      // Report the finished episodes.
+      {
+        std::lock_guard<std::mutex> lock(episodeMutex);
+        returns.swap(finishedReturns);
+      }
+      for (size_t i = 0; i < returns.size() && !stop; ++i)
+      {
+        if (measure(returns[i]))
+          stop = true;
+      }
+      returns.clear();
+      if (stop)
+        break;
+
+      // Wait for the actors to explore first.
+      if (totalSteps < config.ExplorationSteps() || replayMethod.Size() == 0)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      TrainAgent();
+      ++learnerSteps;
+
+      // Update the target network.
+      if (learnerSteps % config.TargetNetworkSyncInterval() == 0)
+        targetNetwork.Parameters() = learningNetwork.Parameters();
+
+      // Send the new parameters to the inference thread.
+      if (learnerSteps % config.UpdateInterval() == 0)
+      {
+        std::lock_guard<std::mutex> lock(parameterMutex);
+        publishedParameters = learningNetwork.Parameters();
+        parametersChanged = true;
+      }
+    }
+  }
+  catch (...)
+  {
+    Fail();
+  }
+
+  // Wake up the inference thread and the actors waiting for it.
+  {
+    std::lock_guard<std::mutex> lock(inferenceMutex);
+    stopInference = true;
+  }
+  requestReady.notify_all();
+  resultReady.notify_all();
+
+  for (size_t i = 0; i < actors.size(); ++i)
+    actors[i].join();
+  server.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+double ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Episode()
+{
+  StateType state = environment.InitialSample();
+  double totalReturn = 0.0;
+  size_t steps = 0;
+  arma::colvec actionValue;
+  while (!environment.IsTerminal(state))
+  {
+    if (config.StepLimit() && steps >= config.StepLimit())
+      break;
+
+    // Take the greedy action.
+    learningNetwork.Predict(state.Encode(), actionValue);
+    ActionType action;
+    action.action = static_cast<decltype(action.action)>(
+        arma::as_scalar(arma::find(actionValue == actionValue.max(), 1)));
+
+    StateType nextState;
+    totalReturn += environment.Sample(state, action, nextState);
+    state = nextState;
+    ++steps;
+  }
+  return totalReturn;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Act(const size_t id)
+{
+  try
+  {
+    EnvironmentType actorEnvironment(environment);
+    StateType state;
+    {
+      std::lock_guard<std::mutex> lock(randomMutex);
+      state = actorEnvironment.InitialSample();
+    }
+
+    double episodeReturn = 0.0;
+    size_t steps = 0;
+    ActionType action;
+    while (!stop)
+    {
+      if (!RequestAction(id, state, action))
+        break;
+
+      // Interact with the environment to advance to next state.
+      StateType nextState;
+      const double reward = actorEnvironment.Sample(state, action, nextState);
+      const bool isTerminal = actorEnvironment.IsTerminal(nextState);
+
+      // Store the transition for replay.
+      replayMethod.Store(state, action, reward, nextState, isTerminal,
+          config.Discount());
+      ++totalSteps;
+
+      episodeReturn += reward;
+      state = nextState;
+      ++steps;
+
+      if (isTerminal || (config.StepLimit() && steps >= config.StepLimit()))
+      {
+        {
+          std::lock_guard<std::mutex> lock(episodeMutex);
+          finishedReturns.push_back(episodeReturn);
+        }
+
+        std::lock_guard<std::mutex> lock(randomMutex);
+        state = actorEnvironment.InitialSample();
+        episodeReturn = 0.0;
+        steps = 0;
+      }
+    }
+  }
+  catch (...)
+  {
+    Fail();
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+bool ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::RequestAction(const size_t id, const StateType& state, ActionType& action)
+{
+  std::unique_lock<std::mutex> lock(inferenceMutex);
+  if (stopInference)
+    return false;
+
+  requests.col(id) = state.Encode();
+  requested[id] = 1;
+  ++numPending;
+  requestReady.notify_one();
+
+  resultReady.wait(lock, [&]() { return answered[id] || stopInference; });
+  if (!answered[id])
+    return false;
+
+  answered[id] = 0;
+  action = actions[id];
+  return true;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Serve()
+{
+  try
+  {
+    const size_t numActors = requested.size();
+    const size_t batchTarget = (maxBatchSize == 0) ? numActors :
+        std::min(maxBatchSize, numActors);
+
+    std::vector<size_t> batch;
+    arma::mat states, actionValues;
+    std::vector<ActionType> selected;
+    while (true)
+    {
+      // Collect a batch of pending states.
+      {
+        std::unique_lock<std::mutex> lock(inferenceMutex);
+        requestReady.wait(lock, [&]()
+            { return numPending > 0 || stopInference; });
+        if (stopInference)
+          break;
+
+        // Give the other actors a little time to join the batch.
+        requestReady.wait_for(lock, std::chrono::microseconds(maxWait), [&]()
+            { return numPending >= batchTarget || stopInference; });
+        if (stopInference)
+          break;
+
+        batch.clear();
+        for (size_t i = 0; i < numActors && batch.size() < batchTarget; ++i)
+        {
+          if (requested[i])
+          {
+            batch.push_back(i);
+            requested[i] = 0;
+          }
+        }
+        numPending -= batch.size();
+
+        states.set_size(requests.n_rows, batch.size());
+        for (size_t k = 0; k < batch.size(); ++k)
+          states.col(k) = requests.col(batch[k]);
+      }
+
+      // Use the latest parameters published by the learner.
+      {
+        std::lock_guard<std::mutex> lock(parameterMutex);
+        if (parametersChanged)
+        {
+          actorNetwork.Parameters() = publishedParameters;
+          parametersChanged = false;
+        }
+      }
+
+      // Evaluate the whole batch at once.
+      actorNetwork.Predict(states, actionValues);
+      ++inferenceBatches;
+
+      // Select the actions according to the behavior policy.
+      selected.resize(batch.size());
+      {
+        std::lock_guard<std::mutex> lock(randomMutex);
+        for (size_t k = 0; k < batch.size(); ++k)
+        {
+          selected[k] = policy.Sample(actionValues.unsafe_col(k), false,
+              config.NoisyQLearning());
+          if (totalSteps > config.ExplorationSteps())
+            policy.Anneal();
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(inferenceMutex);
+        for (size_t k = 0; k < batch.size(); ++k)
+        {
+          actions[batch[k]] = selected[k];
+          answered[batch[k]] = 1;
+        }
+      }
+      resultReady.notify_all();
+    }
+  }
+  catch (...)
+  {
+    Fail();
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::TrainAgent()
+{
+  // Sample from previous experience.
+  arma::mat sampledStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec isTerminal;
+  {
+    std::lock_guard<std::mutex> lock(randomMutex);
+    replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+  }
+
+  // Compute action value for next state with target network.
+  arma::mat nextActionValues;
+  targetNetwork.Predict(sampledNextStates, nextActionValues);
+
+  arma::Col<size_t> bestActions;
+  if (config.DoubleQLearning())
+  {
+    // If use double Q-Learning, use learning network to select the best action.
+    arma::mat nextActionValues;
+    learningNetwork.Predict(sampledNextStates, nextActionValues);
+    bestActions = BestAction(nextActionValues);
+  }
+  else
+  {
+    bestActions = BestAction(nextActionValues);
+  }
+
+  // Compute the update target.
+  arma::mat target;
+  learningNetwork.Forward(sampledStates, target);
+
+  /**
+   * If the agent is at a terminal state, then we don't need to add the
+   * discounted reward. At terminal state, the agent wont perform any
+   * action.
+   */
+  for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
+  {
+    target(sampledActions[i].action, i) = sampledRewards(i) +
+        config.Discount() * nextActionValues(bestActions(i), i) *
+        (1 - isTerminal[i]);
+  }
+
+  // Learn from experience.
+  arma::mat gradients;
+  learningNetwork.Backward(sampledStates, target, gradients);
+
+  replayMethod.Update(target, sampledActions, nextActionValues, gradients);
+
+  #if ENS_VERSION_MAJOR == 1
+  updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
+  #else
+  updatePolicy->Update(learningNetwork.Parameters(), config.StepSize(),
+      gradients);
+  #endif
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+arma::Col<size_t> ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::BestAction(const arma::mat& actionValues)
+{
+  // Take best possible action at a particular instance.
+  arma::Col<size_t> bestActions(actionValues.n_cols);
+  arma::rowvec maxActionValues = arma::max(actionValues, 0);
+  for (size_t i = 0; i < actionValues.n_cols; ++i)
+  {
+    bestActions(i) = arma::as_scalar(
+        arma::find(actionValues.col(i) == maxActionValues[i], 1));
+  }
+  return bestActions;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename PolicyType,
+  typename ReplayType
+>
+void ActorLearner<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  PolicyType,
+  ReplayType
+>::Fail()
+{
+  {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error)
+      error = std::current_exception();
+  }
+  stop = true;
+
+  {
+    std::lock_guard<std::mutex> lock(inferenceMutex);
+    stopInference = true;
+  }
+  requestReady.notify_all();
+  resultReady.notify_all();
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * @file methods/reinforcement_learning/agent_evaluator.hpp
+ *
+ * This file is the definition of the AgentEvaluator class, which runs many
+ * deterministic test episodes of a trained agent at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_AGENT_EVALUATOR_HPP
+#define MLPACK_METHODS_RL_AGENT_EVALUATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "environment/vectorized_environment.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Evaluate a trained agent (such as QLearning or SAC) by running many
+ * deterministic episodes at once, and collect the distribution of their
+ * returns and the number of steps taken per second.
+ *
+ * The episodes are run in lockstep in copies of the environment, in batches
+ * of at most batchSize episodes: at each step, the agent selects the actions
+ * of all the unfinished episodes of the batch with one call to
+ * SelectActions(), so the network is evaluated once per step on the whole
+ * batch and never copied, and the copies of the environment are stepped in
+ * parallel with OpenMP.
+ *
+ * The initial states of the episodes are drawn from mlpack's random number
+ * generator; if a seed is given, it is set before each evaluation, so that
+ * different agents (for instance, different checkpoints of one agent) are
+ * evaluated on the same episodes.  Environments whose Sample() method draws
+ * random numbers (such as Acrobot) should be evaluated with parallel set to
+ * false.
+ *
+ * @code
+ * AgentEvaluator<CartPole> evaluator(100);
+ * evaluator.Evaluate(agent);
+ * const double meanReturn = evaluator.MeanReturn();
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ */
+template<typename EnvironmentType>
+class AgentEvaluator
+{
+ public:
+  /**
+   * Create the AgentEvaluator object with the given settings.
+   *
+   * @param numEpisodes Number of episodes run by each evaluation.
+   * @param environment Reinforcement learning task; each episode is run in a
+   *     copy of it.
+   * @param batchSize Largest number of episodes run at once; if 0, all
+   *     episodes are run at once.
+   * @param maxSteps Largest number of steps of an episode; if 0, episodes
+   *     only end at a terminal state.
+   * @param seed Seed set before each evaluation; if 0, the random number
+   *     generator is not seeded.
+   * @param parallel Whether to step the copies of the environment in
+   *     parallel.
+   */
+  AgentEvaluator(const size_t numEpisodes,
+                 const EnvironmentType& environment = EnvironmentType(),
+                 const size_t batchSize = 0,
+                 const size_t maxSteps = 0,
+                 const size_t seed = 0,
+                 const bool parallel = true);
+
+  /**
+   * Run the episodes with the given agent.  The agent is set to be
+   * deterministic while the episodes run, and is neither trained nor given
+   * the transitions.
+   *
+   * @tparam AgentType The type of the agent; it must provide
+   *     SelectActions(const arma::mat&, std::vector<ActionType>&) and
+   *     Deterministic(), as QLearning and SAC do.
+   * @param agent The agent to evaluate.
+   * @return Mean return of the episodes.
+   */
+  template<typename AgentType>
+  double Evaluate(AgentType& agent);
+
+  //! Get the return of each episode of the last evaluation.
+  const arma::vec& Returns() const { return returns; }
+
+  //! Get the number of steps of each episode of the last evaluation.
+  const arma::Col<size_t>& EpisodeSteps() const { return episodeSteps; }
+
+  //! Get the mean return of the last evaluation.
+  double MeanReturn() const { return arma::mean(returns); }
+
+  //! Get the standard deviation of the returns of the last evaluation.
+  double StddevReturn() const { return arma::stddev(returns); }
+
+  //! Get the total number of steps of the last evaluation.
+  size_t TotalSteps() const { return arma::accu(episodeSteps); }
+
+  //! Get the time taken by the last evaluation, in seconds.
+  double Time() const { return time; }
+
+  //! Get the number of steps taken per second by the last evaluation.
+  double StepsPerSecond() const
+  { return (time > 0.0) ? TotalSteps() / time : 0.0; }
+
+  //! Get the number of episodes run by each evaluation.
+  size_t NumEpisodes() const { return numEpisodes; }
+  //! Modify the number of episodes run by each evaluation.
+  size_t& NumEpisodes() { return numEpisodes; }
+
+  //! Get the environment.
+  const EnvironmentType& Environment() const { return environment; }
+  //! Modify the environment.
+  EnvironmentType& Environment() { return environment; }
+
+  //! Get the largest number of episodes run at once.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the largest number of episodes run at once.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the largest number of steps of an episode.
+  size_t MaxSteps() const { return maxSteps; }
+  //! Modify the largest number of steps of an episode.
+  size_t& MaxSteps() { return maxSteps; }
+
+  //! Get the seed set before each evaluation.
+  size_t Seed() const { return seed; }
+  //! Modify the seed set before each evaluation.
+  size_t& Seed() { return seed; }
+
+  //! Get whether the copies of the environment are stepped in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the copies of the environment are stepped in parallel.
+  bool& Parallel() { return parallel; }
+
+ private:
+  //! Locally-stored number of episodes.
+  size_t numEpisodes;
+
+  //! Locally-stored reinforcement learning task.
+  EnvironmentType environment;
+
+  //! Locally-stored largest number of episodes run at once.
+  size_t batchSize;
+
+  //! Locally-stored largest number of steps of an episode.
+  size_t maxSteps;
+
+  //! Locally-stored seed.
+  size_t seed;
+
+  //! Locally-stored indicator of parallel stepping.
+  bool parallel;
+
+  //! Return of each episode of the last evaluation.
+  arma::vec returns;
+
+  //! Number of steps of each episode of the last evaluation.
+  arma::Col<size_t> episodeSteps;
+
+  //! Time taken by the last evaluation, in seconds.
+  double time;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+// Include implementation
+#include "agent_evaluator_impl.hpp"
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file methods/reinforcement_learning/agent_evaluator_impl.hpp
+ *
+ * This file is the implementation of the AgentEvaluator class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_AGENT_EVALUATOR_IMPL_HPP
+#define MLPACK_METHODS_RL_AGENT_EVALUATOR_IMPL_HPP
+
+#include "agent_evaluator.hpp"
+
+#include <chrono>
+
+namespace mlpack {
+namespace rl {
+
+template<typename EnvironmentType>
+AgentEvaluator<EnvironmentType>::AgentEvaluator(
+    const size_t numEpisodes,
+    const EnvironmentType& environment,
+    const size_t batchSize,
+    const size_t maxSteps,
+    const size_t seed,
+    const bool parallel) :
+    numEpisodes(numEpisodes),
+    environment(environment),
+    batchSize(batchSize),
+    maxSteps(maxSteps),
+    seed(seed),
+    parallel(parallel),
+    time(0.0)
+{ /* Nothing to do here. */ }
+
+template<typename EnvironmentType>
+template<typename AgentType>
+double AgentEvaluator<EnvironmentType>::Evaluate(AgentType& agent)
+{
+  using ActionType = typename EnvironmentType::Action;
+
+  if (numEpisodes == 0)
+  {
+    throw std::invalid_argument("AgentEvaluator::Evaluate(): numEpisodes "
+        "must be greater than 0!");
+  }
+
+  if (seed != 0)
+    math::RandomSeed(seed);
+
+  const bool deterministic = agent.Deterministic();
+  agent.Deterministic() = true;
+
+  returns.set_size(numEpisodes);
+  episodeSteps.set_size(numEpisodes);
+
+  const size_t maxBatch = (batchSize == 0) ? numEpisodes :
+      std::min(batchSize, numEpisodes);
+
+  arma::mat states, nextStates;
+  std::vector<ActionType> actions;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+
+  const auto start = std::chrono::steady_clock::now();
+  try
+  {
+    for (size_t first = 0; first < numEpisodes; first += maxBatch)
+    {
+      // The last batch may be smaller.
+      const size_t size = std::min(maxBatch, numEpisodes - first);
+      VectorizedEnvironment<EnvironmentType> environments(size, environment,
+          parallel);
+
+      environments.InitialSample();
+      while (environments.NumActive() > 0)
+      {
+        environments.ActiveStates(states);
+        agent.SelectActions(states, actions);
+        environments.Step(actions, rewards, nextStates, isTerminal, maxSteps);
+      }
+
+      for (size_t i = 0; i < size; ++i)
+      {
+        returns[first + i] = environments.Returns()[i];
+        episodeSteps[first + i] = environments.Steps(i);
+      }
+    }
+  }
+  catch (...)
+  {
+    agent.Deterministic() = deterministic;
+    throw;
+  }
+  time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+      start).count();
+
+  agent.Deterministic() = deterministic;
+  return MeanReturn();
+}
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file methods/reinforcement_learning/environment/vectorized_environment.hpp
+ *
+ * This file is an implementation of a wrapper that steps several copies of an
+ * environment in lockstep.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTORIZED_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A set of copies of an environment that are stepped in lockstep.  Each copy
+ * runs its own episode; at every step, the states of the copies whose episode
+ * has not yet finished (the active copies) are encoded as the columns of one
+ * matrix, so that an agent can select all of their actions with a single
+ * forward pass of its network, and the resulting transitions can be stored
+ * in a replay buffer in bulk.  A copy becomes inactive once it reaches a
+ * terminal state.
+ *
+ * Optionally, the copies can be stepped in parallel with OpenMP.  This is only
+ * safe if the environment's Sample() method does not share state between
+ * copies; for instance, environments that draw random numbers in Sample()
+ * (such as Acrobot) should not be stepped in parallel.
+ *
+ * @tparam EnvironmentType The environment of the reinforcement learning task.
+ */
+template<typename EnvironmentType>
+class VectorizedEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @param environment Environment to copy.
+   * @param parallel Whether to step the copies in parallel.
+   */
+  VectorizedEnvironment(const size_t numEnvironments,
+                        const EnvironmentType& environment = EnvironmentType(),
+                        const bool parallel = false) :
+      environments(numEnvironments, environment),
+      states(numEnvironments),
+      steps(numEnvironments, 0),
+      returns(numEnvironments, arma::fill::zeros),
+      parallel(parallel)
+  {
+    if (numEnvironments == 0)
+    {
+      throw std::invalid_argument("VectorizedEnvironment::"
+          "VectorizedEnvironment(): numEnvironments must be greater than 0!");
+    }
+  }
+
+  /**
+   * Start a new episode in every copy of the environment.  All copies become
+   * active.
+   */
+  void InitialSample()
+  {
+    active.clear();
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      states[i] = environments[i].InitialSample();
+      steps[i] = 0;
+      if (!environments[i].IsTerminal(states[i]))
+        active.push_back(i);
+    }
+    returns.zeros();
+  }
+
+  /**
+   * Encode the states of the active copies as the columns of a matrix, in the
+   * order of Active().
+   *
+   * @param encoded Matrix to store the encoded states in.
+   */
+  void ActiveStates(arma::mat& encoded) const
+  {
+    encoded.set_size(StateType::dimension, active.size());
+    for (size_t k = 0; k < active.size(); ++k)
+      encoded.col(k) = states[active[k]].Encode();
+  }
+
+  /**
+   * Take one step in each active copy of the environment.  The k'th action is
+   * applied to the copy Active()[k].  Copies that reach a terminal state, or
+   * that have taken stepLimit steps (if stepLimit is not 0), become inactive.
+   *
+   * @param actions Actions to take, one for each active copy.
+   * @param rewards Row vector to store the reward of each step in.
+   * @param nextStates Matrix to store the encoded next state of each step in.
+   * @param isTerminal Row vector to store whether each next state is terminal
+   *     in.
+   * @param stepLimit Maximum number of steps in an episode; 0 means no limit.
+   */
+  void Step(const std::vector<ActionType>& actions,
+            arma::rowvec& rewards,
+            arma::mat& nextStates,
+            arma::irowvec& isTerminal,
+            const size_t stepLimit = 0)
+  {
+    if (actions.size() != active.size())
+    {
+      std::ostringstream oss;
+      oss << "VectorizedEnvironment::Step(): " << actions.size() << " actions "
+          << "given, but " << active.size() << " environments are active!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const size_t numActive = active.size();
+    std::vector<StateType> next(numActive);
+    rewards.set_size(numActive);
+
+    #pragma omp parallel for if (parallel)
+    for (omp_size_t k = 0; k < (omp_size_t) numActive; ++k)
+    {
+      const size_t i = active[k];
+      rewards[k] = environments[i].Sample(states[i], actions[k], next[k]);
+    }
+
+    nextStates.set_size(StateType::dimension, numActive);
+    isTerminal.set_size(numActive);
+    std::vector<size_t> stillActive;
+    for (size_t k = 0; k < numActive; ++k)
+    {
+      const size_t i = active[k];
+      isTerminal[k] = environments[i].IsTerminal(next[k]);
+      nextStates.col(k) = next[k].Encode();
+      states[i] = next[k];
+      returns[i] += rewards[k];
+      ++steps[i];
+
+      if (!isTerminal[k] && (stepLimit == 0 || steps[i] < stepLimit))
+        stillActive.push_back(i);
+    }
+    active.swap(stillActive);
+  }
+
+  //! Get the number of copies of the environment.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the indices of the active copies.
+  const std::vector<size_t>& Active() const { return active; }
+  //! Get the number of active copies.
+  size_t NumActive() const { return active.size(); }
+
+  //! Get the given copy of the environment.
+  const EnvironmentType& Environment(const size_t i) const
+  { return environments[i]; }
+  //! Modify the given copy of the environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+
+  //! Get the current state of the given copy.
+  const StateType& State(const size_t i) const { return states[i]; }
+
+  //! Get the number of steps taken in the current episode of the given copy.
+  size_t Steps(const size_t i) const { return steps[i]; }
+
+  //! Get the return of the current episode of each copy.
+  const arma::vec& Returns() const { return returns; }
+
+  //! Get whether the copies are stepped in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the copies are stepped in parallel.
+  bool& Parallel() { return parallel; }
+
+ private:
+  //! Locally-stored copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! Locally-stored current state of each copy.
+  std::vector<StateType> states;
+
+  //! Locally-stored number of steps in the current episode of each copy.
+  std::vector<size_t> steps;
+
+  //! Locally-stored return of the current episode of each copy.
+  arma::vec returns;
+
+  //! Locally-stored indices of the active copies.
+  std::vector<size_t> active;
+
+  //! Locally-stored indicator of whether to step in parallel.
+  bool parallel;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
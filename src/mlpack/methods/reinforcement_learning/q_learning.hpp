@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "environment/vectorized_environment.hpp"
 #include "replay/random_replay.hpp"
 #include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
@@ -110,6 +111,27 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Select an action for each of the given encoded states, using a single
+   * forward pass of the learning network.
+   *
+   * @param states Encoded states, one per column.
+   * @param actions Vector to store the selected actions in.
+   */
+  void SelectActions(const arma::mat& states, std::vector<ActionType>& actions);
+
+  /**
+   * Execute an episode in each copy of a vectorized environment.  The copies
+   * are stepped in lockstep: at each step, the actions of all active copies
+   * are selected with one forward pass, and their transitions are stored in
+   * the replay buffer together.  The agent is trained once per transition, as
+   * in Episode().  Vectorized episodes require single-step replay.
+   *
+   * @param environments Copies of the environment to run episodes in.
+   * @return Mean return of the episodes.
+   */
+  double Episode(VectorizedEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -237,9 +237,18 @@ void QLearning<
 
   size_t batchSize = sampledNextStates.n_cols;
 
-  // Compute action value for next state with target network.
-  arma::mat nextActionValues;
-  targetNetwork.Predict(sampledNextStates, nextActionValues);
+  // Compute the distributions of the next states with the target network.
+  arma::mat nextDists;
+  targetNetwork.Forward(sampledNextStates, nextDists);
+
+  // The action values are the expectations of the distributions; the atoms of
+  // each action are contiguous in each column, so they can all be computed
+  // with one product.
+  const size_t actionSize = nextDists.n_rows / atomSize;
+  const arma::mat nextAtoms(nextDists.memptr(), atomSize,
+      actionSize * batchSize, false, true);
+  arma::mat nextActionValues = arma::reshape(support.t() * nextAtoms,
+      actionSize, batchSize);
 
   arma::Col<size_t> nextAction;
   if (config.DoubleQLearning())
@@ -254,8 +263,7 @@ void QLearning<
     nextAction = BestAction(nextActionValues);
   }
 
-  arma::mat nextDists, nextDist(atomSize, batchSize);
-  targetNetwork.Forward(sampledNextStates, nextDists);
+  arma::mat nextDist(atomSize, batchSize);
   for (size_t i = 0; i < batchSize; ++i)
   {
     nextDist.col(i) = nextDists(nextAction(i) * atomSize, i,
@@ -265,23 +273,27 @@ void QLearning<
   arma::mat tZ = (arma::conv_to<arma::mat>::from(config.Discount() *
       (support * (1 - isTerminal))).each_row() + sampledRewards);
   tZ = arma::clamp(tZ, config.VMin(), config.VMax());
-  arma::mat b = (tZ - config.VMin()) / (config.VMax() - config.VMin()) *
+  const arma::mat b = (tZ - config.VMin()) / (config.VMax() - config.VMin()) *
       (atomSize - 1);
-  arma::mat l = arma::floor(b);
-  arma::mat u = arma::ceil(b);
 
-  arma::mat projDistUpper = nextDist % (u - b);
-  arma::mat projDistLower = nextDist % (b - l);
-
-  arma::mat projDist = arma::zeros<arma::mat>(arma::size(nextDist));
-  for (size_t batchNo = 0; batchNo < batchSize; batchNo++)
+  // Each atom of the next distribution is split between the two atoms around
+  // its projection; taking u = l + 1 keeps the whole mass of the atoms that
+  // fall exactly on an atom of the support.
+  const arma::mat l = arma::clamp(arma::floor(b), 0.0,
+      (double) atomSize - 2.0);
+
+  // Scatter the mass into the projected distribution, using the linear index
+  // of each target atom.
+  arma::mat projDist(atomSize, batchSize, arma::fill::zeros);
+  double* proj = projDist.memptr();
+  for (size_t k = 0; k < b.n_elem; ++k)
   {
-    for (size_t j = 0; j < atomSize; j++)
-    {
-      projDist(l(j, batchNo), batchNo) += projDistUpper(j, batchNo);
-      projDist(u(j, batchNo), batchNo) += projDistLower(j, batchNo);
-    }
+    const size_t lower = (k / atomSize) * atomSize + (size_t) l[k];
+    const double upperWeight = b[k] - l[k];
+    proj[lower] += nextDist[k] * (1.0 - upperWeight);
+    proj[lower + 1] += nextDist[k] * upperWeight;
   }
+
   arma::mat dists;
   learningNetwork.Forward(sampledStates, dists);
   arma::mat lossGradients = arma::zeros<arma::mat>(arma::size(dists));
@@ -387,6 +399,90 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::SelectActions(const arma::mat& states, std::vector<ActionType>& actions)
+{
+  // Get the action values of all states at once.
+  arma::mat actionValues;
+  learningNetwork.Predict(states, actionValues);
+
+  // Select the actions according to the behavior policy.
+  actions.resize(states.n_cols);
+  for (size_t i = 0; i < states.n_cols; ++i)
+  {
+    actions[i] = policy.Sample(actionValues.unsafe_col(i), deterministic,
+        config.NoisyQLearning());
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+double QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episode(VectorizedEnvironment<EnvironmentType>& environments)
+{
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("QLearning::Episode(): vectorized "
+        "environments can only be used with single-step replay!");
+  }
+
+  // Get the initial states from the environments.
+  environments.InitialSample();
+
+  arma::mat states, nextStates;
+  std::vector<ActionType> actions;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+
+  // Running until all environments get to a terminal state.
+  while (environments.NumActive() > 0)
+  {
+    environments.ActiveStates(states);
+    SelectActions(states, actions);
+
+    // Interact with the environments to advance to the next states.
+    environments.Step(actions, rewards, nextStates, isTerminal);
+
+    // Store the transitions for replay.
+    replayMethod.Store(states, actions, rewards, nextStates, isTerminal);
+
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+      totalSteps++;
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      if (config.IsCategorical())
+        TrainCategoricalAgent();
+      else
+        TrainAgent();
+    }
+  }
+
+  return arma::mean(environments.Returns());
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -134,17 +134,15 @@ class CategoricalDQN
   {
     arma::mat q_atoms;
     network.Predict(state, q_atoms);
-    activations.copy_size(q_atoms);
-    actionValue.set_size(q_atoms.n_rows / atomSize, q_atoms.n_cols);
+    Normalize(q_atoms);
+
+    // The action values are the expectations of the distributions.
+    const size_t actionSize = activations.n_rows / atomSize;
+    const arma::mat atoms(activations.memptr(), atomSize,
+        actionSize * activations.n_cols, false, true);
     arma::rowvec support = arma::linspace<arma::rowvec>(vMin, vMax, atomSize);
-    for (size_t i = 0; i < q_atoms.n_rows; i += atomSize)
-    {
-      arma::mat activation = activations.rows(i, i + atomSize - 1);
-      arma::mat input = q_atoms.rows(i, i + atomSize - 1);
-      softMax.Forward(input, activation);
-      activations.rows(i, i + atomSize - 1) = activation;
-      actionValue.row(i/atomSize) = support * activation;
-    }
+    actionValue = arma::reshape(support * atoms, actionSize,
+        activations.n_cols);
   }
 
   /**
@@ -157,14 +155,7 @@ class CategoricalDQN
   {
     arma::mat q_atoms;
     network.Forward(state, q_atoms);
-    activations.copy_size(q_atoms);
-    for (size_t i = 0; i < q_atoms.n_rows; i += atomSize)
-    {
-      arma::mat activation = activations.rows(i, i + atomSize - 1);
-      arma::mat input = q_atoms.rows(i, i + atomSize - 1);
-      softMax.Forward(input, activation);
-      activations.rows(i, i + atomSize - 1) = activation;
-    }
+    Normalize(q_atoms);
     dist = activations;
   }
 
@@ -204,19 +195,38 @@ class CategoricalDQN
                 arma::mat& lossGradients,
                 arma::mat& gradient)
   {
+    // As in Normalize(), the softmax of every action is handled at once.
     arma::mat activationGradients(arma::size(activations));
-    for (size_t i = 0; i < activations.n_rows; i += atomSize)
-    {
-      arma::mat activationGrad;
-      arma::mat lossGrad = lossGradients.rows(i, i + atomSize - 1);
-      arma::mat activation = activations.rows(i, i + atomSize - 1);
-      softMax.Backward(activation, lossGrad, activationGrad);
-      activationGradients.rows(i, i + atomSize - 1) = activationGrad;
-    }
+    const size_t blocks = activations.n_elem / atomSize;
+    const arma::mat activation(activations.memptr(), atomSize, blocks, false,
+        true);
+    const arma::mat lossGrad(lossGradients.memptr(), atomSize, blocks, false,
+        true);
+    arma::mat activationGrad(activationGradients.memptr(), atomSize, blocks,
+        false, true);
+    softMax.Backward(activation, lossGrad, activationGrad);
     network.Backward(state, activationGradients, gradient);
   }
 
  private:
+  /**
+   * Apply the softmax to the atoms of each action, and store the distributions
+   * in activations.  The atoms of each action are contiguous in each column,
+   * so the outputs can be viewed as a matrix with one column per action and
+   * state, and all the distributions computed with a single softmax.
+   *
+   * @param q_atoms The outputs of the network.
+   */
+  void Normalize(const arma::mat& q_atoms)
+  {
+    activations.set_size(arma::size(q_atoms));
+    const size_t blocks = q_atoms.n_elem / atomSize;
+    const arma::mat input(const_cast<double*>(q_atoms.memptr()), atomSize,
+        blocks, false, true);
+    arma::mat activation(activations.memptr(), atomSize, blocks, false, true);
+    softMax.Forward(input, activation);
+  }
+
   //! Locally-stored network.
   NetworkType network;
 
@@ -0,0 +1,271 @@
+/**
+ * @file methods/reinforcement_learning/replay/concurrent_prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay that can be
+ * shared by several threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_CONCURRENT_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_CONCURRENT_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "concurrent_replay.hpp"
+#include "concurrent_sumtree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay that many actor threads can
+ * store experiences in while a learner thread samples batches from it and
+ * updates their priorities, as in Ape-X:
+ *
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *  title     = {Distributed Prioritized Experience Replay},
+ *  author    = {Horgan, Dan and Quan, John and Budden, David and
+ *               Barth-Maron, Gabriel and Hessel, Matteo and
+ *               van Hasselt, Hado and Silver, David},
+ *  booktitle = {International Conference on Learning Representations},
+ *  year      = {2018}
+ * }
+ * @endcode
+ *
+ * The experiences are kept in a ConcurrentReplay ring buffer, and the
+ * priorities in a ConcurrentSumTree.  New experiences get the largest priority
+ * seen so far, so that they are sampled at least once.  As with
+ * PrioritizedReplay, the sampled transitions are weighted by importance
+ * sampling, and the weights are used to scale the gradients in Update().
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class ConcurrentPrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of concurrent prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much prioritization is used.
+   * @param dimension The dimension of an encoded state.
+   */
+  ConcurrentPrioritizedReplay(const size_t batchSize,
+                              const size_t capacity,
+                              const double alpha,
+                              const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      alpha(alpha),
+      maxPriority(1.0),
+      initialBeta(0.6),
+      beta(0.6),
+      replayBetaIters(10000),
+      memory(batchSize, capacity, dimension),
+      priorities(capacity)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience with the largest priority seen so far.  This
+   * may be called from several threads at once.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param * (discount) The discount parameter; unused, since only one-step
+   *     transitions are stored.
+   */
+  void Store(const StateType& state,
+             const ActionType& action,
+             const double reward,
+             const StateType& nextState,
+             const bool isEnd,
+             const double& /* discount */ = 1.0)
+  {
+    const size_t position = memory.Store(state, action, reward, nextState,
+        isEnd);
+    priorities.Set(position, std::pow(maxPriority.load(
+        std::memory_order_relaxed), alpha));
+  }
+
+  /**
+   * Sample some experiences according to their priorities.  This may be
+   * called concurrently with Store(), but not with other calls to Sample() or
+   * Update().  If no experience has been stored yet, the output is empty.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              std::vector<ActionType>& sampledActions,
+              arma::rowvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::irowvec& isTerminal)
+  {
+    const size_t numStored = memory.Size();
+    const size_t numSamples = (numStored == 0) ? 0 : batchSize;
+    sampledIndices.set_size(numSamples);
+    sampledStates.set_size(memory.Dimension(), numSamples);
+    sampledActions.resize(numSamples);
+    sampledRewards.set_size(numSamples);
+    sampledNextStates.set_size(memory.Dimension(), numSamples);
+    isTerminal.set_size(numSamples);
+    weights.set_size(numSamples);
+    if (numSamples == 0)
+      return;
+
+    BetaAnneal();
+
+    // Draw one sample from each of batchSize ranges of equal mass.  Positions
+    // that are not stored yet or are being written are drawn again, from the
+    // whole range; if that keeps failing (for instance because all priorities
+    // are zero), a position is drawn uniformly instead.
+    const double totalSum = priorities.Sum();
+    const double sumPerRange = totalSum / batchSize;
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      size_t position = (totalSum > 0.0) ?
+          priorities.FindPrefixSum((math::Random() + i) * sumPerRange) :
+          math::RandInt(numStored);
+      size_t attempts = 0;
+      while (position >= numStored || !memory.Read(position, i, sampledStates,
+          sampledActions, sampledRewards, sampledNextStates, isTerminal))
+      {
+        position = (totalSum > 0.0 && ++attempts < 10) ?
+            priorities.FindPrefixSum(math::Random() * totalSum) :
+            math::RandInt(numStored);
+      }
+      sampledIndices[i] = position;
+
+      double probability = priorities.Get(position) / totalSum;
+      if (!(probability > 0.0))
+        probability = 1.0 / numStored;
+      weights[i] = std::pow(numStored * probability, -beta);
+    }
+    weights /= weights.max();
+  }
+
+  /**
+   * Update priorities of sampled transitions.
+   *
+   * @param indices The indices of sample to be updated.
+   * @param newPriorities Their corresponding priorities.
+   */
+  void UpdatePriorities(const arma::ucolvec& indices,
+                        const arma::colvec& newPriorities)
+  {
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      priorities.Set(indices[i], std::pow(newPriorities[i], alpha));
+
+    // Only the learner changes the largest priority.
+    maxPriority.store(std::max(maxPriority.load(std::memory_order_relaxed),
+        newPriorities.max()), std::memory_order_relaxed);
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size.
+   */
+  size_t Size() const { return memory.Size(); }
+
+  /**
+   * Annealing the beta.
+   */
+  void BetaAnneal()
+  {
+    beta = std::min(1.0, beta + (1 - initialBeta) * 1.0 / replayBetaIters);
+  }
+
+  /**
+   * Update the priorities of transitions and Update the gradients.
+   *
+   * @param target The learned value.
+   * @param sampledActions Agent's sampled action.
+   * @param nextActionValues Agent's next action.
+   * @param gradients The model's gradients.
+   */
+  void Update(arma::mat target,
+              std::vector<ActionType> sampledActions,
+              arma::mat nextActionValues,
+              arma::mat& gradients)
+  {
+    arma::colvec tdError(target.n_cols);
+    for (size_t i = 0; i < target.n_cols; ++i)
+    {
+      tdError(i) = nextActionValues(sampledActions[i].action, i) -
+          target(sampledActions[i].action, i);
+    }
+    tdError = arma::abs(tdError);
+    UpdatePriorities(sampledIndices, tdError);
+
+    // Update the gradient.
+    gradients = arma::mean(weights) * gradients;
+  }
+
+  /**
+   * Recompute the sums of the priorities exactly.  This should be called
+   * from time to time when no other thread uses the memory, to remove the
+   * rounding errors that concurrent updates accumulate.
+   */
+  void RebuildPriorities() { priorities.Rebuild(); }
+
+  //! Get the number of steps for n-step agent; this is always 1.
+  const size_t& NSteps() const { return memory.NSteps(); }
+
+  //! Get the importance sampling weights of the last sampled transitions.
+  const arma::rowvec& Weights() const { return weights; }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! How much prioritization is used.
+  //! (0 - no prioritization, 1 - full prioritization)
+  double alpha;
+
+  //! Locally-stored the max priority.
+  std::atomic<double> maxPriority;
+
+  //! Initial value of beta for prioritized replay buffer.
+  double initialBeta;
+
+  //! The value of beta for current sample.
+  double beta;
+
+  //! How many iteration for replay beta to decay.
+  size_t replayBetaIters;
+
+  //! Locally-stored experiences.
+  ConcurrentReplay<EnvironmentType> memory;
+
+  //! Locally-stored priorities of the experiences.
+  ConcurrentSumTree<double> priorities;
+
+  //! Locally-stored the indices of sampled transitions.
+  arma::ucolvec sampledIndices;
+
+  //! Locally-stored the weights of sampled transitions.
+  arma::rowvec weights;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file methods/reinforcement_learning/replay/concurrent_replay.hpp
+ *
+ * This file is an implementation of random experience replay that can be
+ * shared by several threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_CONCURRENT_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_CONCURRENT_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of random experience replay that many actor threads can
+ * store experiences in while a learner thread samples batches from it, as in
+ * an Ape-X style split between actors and a learner.
+ *
+ * @code
+ * @inproceedings{horgan2018distributed,
+ *  title     = {Distributed Prioritized Experience Replay},
+ *  author    = {Horgan, Dan and Quan, John and Budden, David and
+ *               Barth-Maron, Gabriel and Hessel, Matteo and
+ *               van Hasselt, Hado and Silver, David},
+ *  booktitle = {International Conference on Learning Representations},
+ *  year      = {2018}
+ * }
+ * @endcode
+ *
+ * The memory is a ring buffer.  Store() claims the next position with an
+ * atomic increment of the write cursor, so concurrent calls write to
+ * different positions without locking.  Each position also has an atomic
+ * flag that is held while it is written or read: Sample() skips positions that
+ * are being written, and Store() only waits when the ring has wrapped around
+ * onto a position that is still being accessed.
+ *
+ * Only one-step transitions are supported, since the transitions stored by
+ * different threads are interleaved.
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class ConcurrentReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of concurrent experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param dimension The dimension of an encoded state.
+   */
+  ConcurrentReplay(const size_t batchSize,
+                   const size_t capacity,
+                   const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      nSteps(1),
+      cursor(0),
+      slots(capacity),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity)
+  {
+    if (capacity == 0)
+    {
+      throw std::invalid_argument("ConcurrentReplay::ConcurrentReplay(): "
+          "capacity must be greater than 0!");
+    }
+
+    for (size_t i = 0; i < capacity; ++i)
+      slots[i].store(empty, std::memory_order_relaxed);
+  }
+
+  /**
+   * Store the given experience.  This may be called from several threads at
+   * once.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   * @param * (discount) The discount parameter; unused, since only one-step
+   *     transitions are stored.
+   * @return The position the experience was stored at.
+   */
+  size_t Store(const StateType& state,
+               const ActionType& action,
+               const double reward,
+               const StateType& nextState,
+               const bool isEnd,
+               const double& /* discount */ = 1.0)
+  {
+    const size_t position = cursor.fetch_add(1, std::memory_order_relaxed) %
+        capacity;
+
+    // Wait until nobody else is accessing the position.
+    unsigned char expected = slots[position].load(std::memory_order_relaxed);
+    do
+    {
+      if (expected == busy)
+        expected = slots[position].load(std::memory_order_relaxed);
+    } while (expected == busy || !slots[position].compare_exchange_weak(
+        expected, busy, std::memory_order_acquire));
+
+    states.col(position) = state.Encode();
+    actions[position] = action;
+    rewards[position] = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal[position] = isEnd;
+
+    slots[position].store(ready, std::memory_order_release);
+    return position;
+  }
+
+  /**
+   * Copy the experience at the given position into the given column of the
+   * given matrices, unless the position is empty or being written.  This may
+   * be called concurrently with Store().
+   *
+   * @param position Position of the experience.
+   * @param column Column to copy the experience into.
+   * @param sampledStates Encoded states.
+   * @param sampledActions Actions.
+   * @param sampledRewards Rewards.
+   * @param sampledNextStates Encoded next states.
+   * @param sampledTerminal Whether each next state is terminal state.
+   * @return Whether the experience was copied.
+   */
+  bool Read(const size_t position,
+            const size_t column,
+            arma::mat& sampledStates,
+            std::vector<ActionType>& sampledActions,
+            arma::rowvec& sampledRewards,
+            arma::mat& sampledNextStates,
+            arma::irowvec& sampledTerminal)
+  {
+    unsigned char expected = ready;
+    if (!slots[position].compare_exchange_strong(expected, busy,
+        std::memory_order_acquire))
+      return false;
+
+    sampledStates.col(column) = states.col(position);
+    sampledActions[column] = actions[position];
+    sampledRewards[column] = rewards[position];
+    sampledNextStates.col(column) = nextStates.col(position);
+    sampledTerminal[column] = isTerminal[position];
+
+    slots[position].store(ready, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Sample some experiences uniformly.  This may be called concurrently with
+   * Store(), but not with other calls to Sample().  If no experience has been
+   * stored yet, the output is empty.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              std::vector<ActionType>& sampledActions,
+              arma::rowvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::irowvec& isTerminal)
+  {
+    const size_t upperBound = Size();
+    const size_t numSamples = (upperBound == 0) ? 0 : batchSize;
+    sampledStates.set_size(Dimension(), numSamples);
+    sampledActions.resize(numSamples);
+    sampledRewards.set_size(numSamples);
+    sampledNextStates.set_size(Dimension(), numSamples);
+    isTerminal.set_size(numSamples);
+
+    // A position that is being written is replaced by another one.
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      while (!Read(math::RandInt(upperBound), i, sampledStates, sampledActions,
+          sampledRewards, sampledNextStates, isTerminal)) { }
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size.
+   */
+  size_t Size() const
+  {
+    return std::min(cursor.load(std::memory_order_relaxed), capacity);
+  }
+
+  /**
+   * Update the priorities of transitions and Update the gradients.
+   *
+   * @param * (target) The learned value
+   * @param * (sampledActions) Agent's sampled action
+   * @param * (nextActionValues) Agent's next action
+   * @param * (gradients) The model's gradients
+   */
+  void Update(arma::mat /* target */,
+              std::vector<ActionType> /* sampledActions */,
+              arma::mat /* nextActionValues */,
+              arma::mat& /* gradients */)
+  {
+    /* Do nothing for random replay. */
+  }
+
+  //! Get the number of steps for n-step agent; this is always 1.
+  const size_t& NSteps() const { return nSteps; }
+
+  //! Get the dimension of an encoded state.
+  size_t Dimension() const { return states.n_rows; }
+
+  //! Get the total memory size in terms of number of examples.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  //! Values of the per-position flags.
+  static constexpr unsigned char empty = 0;
+  static constexpr unsigned char ready = 1;
+  static constexpr unsigned char busy = 2;
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Locally-stored number of steps to look into the future.
+  size_t nSteps;
+
+  //! Total number of calls to Store(); the next position to write is this
+  //! modulo the capacity.
+  std::atomic<size_t> cursor;
+
+  //! Locally-stored flag of each position.
+  std::vector<std::atomic<unsigned char>> slots;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  std::vector<ActionType> actions;
+
+  //! Locally-stored previous rewards.
+  arma::rowvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::irowvec isTerminal;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
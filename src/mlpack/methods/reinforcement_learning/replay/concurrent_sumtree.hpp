@@ -0,0 +1,161 @@
+/**
+ * @file methods/reinforcement_learning/replay/concurrent_sumtree.hpp
+ *
+ * This file is an implementation of a SumTree that can be modified by several
+ * threads at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_CONCURRENT_SUMTREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_CONCURRENT_SUMTREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A SumTree whose Set(), Get(), Sum() and FindPrefixSum() methods may be called
+ * concurrently from several threads without locks.  Instead of recomputing the
+ * sums of the ancestors of a changed element, Set() atomically swaps the
+ * element and adds the difference to each ancestor with a compare-and-swap
+ * loop.  Since these additions commute, the tree is consistent once all calls
+ * to Set() have returned; a concurrent FindPrefixSum() may see a partially
+ * updated path, but it always returns a valid index.
+ *
+ * Because the sums are maintained incrementally, floating-point rounding
+ * errors accumulate over many updates; Rebuild() recomputes the sums exactly,
+ * but must not be called concurrently with the other methods.
+ *
+ * @tparam T The array's element type.
+ */
+template<typename T>
+class ConcurrentSumTree
+{
+ public:
+  /**
+   * Default constructor.
+   */
+  ConcurrentSumTree() : capacity(0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Construct an instance of ConcurrentSumTree class.  The capacity is rounded
+   * up to a power of two.
+   *
+   * @param size Size of data.
+   */
+  ConcurrentSumTree(const size_t size) : capacity(1)
+  {
+    while (capacity < size)
+      capacity *= 2;
+
+    element = std::vector<std::atomic<T>>(2 * capacity);
+    for (size_t i = 0; i < element.size(); ++i)
+      element[i].store(T(0), std::memory_order_relaxed);
+  }
+
+  /**
+   * Set the data array with idx.
+   *
+   * @param idx The array idx to be changed.
+   * @param value The data that array with idx to be.
+   */
+  void Set(size_t idx, const T value)
+  {
+    idx += capacity;
+    const T delta = value - element[idx].exchange(value,
+        std::memory_order_acq_rel);
+    for (idx /= 2; idx >= 1; idx /= 2)
+      Add(element[idx], delta);
+  }
+
+  /**
+   * Get the data array with idx.
+   *
+   * @param idx The array idx to get data.
+   */
+  T Get(const size_t idx) const
+  {
+    return element[idx + capacity].load(std::memory_order_acquire);
+  }
+
+  /**
+   * Get the sum of the whole array.
+   */
+  T Sum() const
+  {
+    return (capacity == 0) ? T(0) :
+        element[1].load(std::memory_order_acquire);
+  }
+
+  /**
+   * Find the highest index `idx` in the array such that
+   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
+   *
+   * @param mass The upper bound of segment array sum.
+   */
+  size_t FindPrefixSum(T mass) const
+  {
+    size_t idx = 1;
+    while (idx < capacity)
+    {
+      const T left = element[2 * idx].load(std::memory_order_acquire);
+      if (left > mass)
+      {
+        idx = 2 * idx;
+      }
+      else
+      {
+        mass -= left;
+        idx = 2 * idx + 1;
+      }
+    }
+    return idx - capacity;
+  }
+
+  /**
+   * Recompute all the sums from the elements, removing accumulated rounding
+   * errors.  This is not thread-safe.
+   */
+  void Rebuild()
+  {
+    for (size_t i = capacity - 1; i > 0; --i)
+    {
+      element[i].store(element[2 * i].load(std::memory_order_relaxed) +
+          element[2 * i + 1].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+  }
+
+  //! Get the capacity of the data array.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  //! Atomically add the given value to the given element.
+  static void Add(std::atomic<T>& target, const T value)
+  {
+    T current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value,
+        std::memory_order_acq_rel))
+    {
+      // current now holds the latest value; try again.
+    }
+  }
+
+  //! The capacity of the data array.
+  size_t capacity;
+
+  //! Double size of capacity, maintain the segment sum of data.
+  std::vector<std::atomic<T>> element;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
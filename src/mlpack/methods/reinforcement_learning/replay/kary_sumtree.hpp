@@ -0,0 +1,265 @@
+/**
+ * @file methods/reinforcement_learning/replay/kary_sumtree.hpp
+ *
+ * This file is an implementation of a sumtree where each node has many
+ * children, stored next to each other.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_KARY_SUMTREE_HPP
+#define MLPACK_METHODS_RL_KARY_SUMTREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of a k-ary SumTree, used to maintain the prefix sums of an
+ * array.  It provides the same interface as SumTree, but each node has Arity
+ * children, and the children of a node are stored contiguously, level by
+ * level.  With the default arity of 8, the children of a node fill one cache
+ * line of doubles, and the tree is a third as deep as a binary tree; so a
+ * prefix sum search touches a third of the cache lines that SumTree touches.
+ *
+ * In addition, the priorities of a batch of elements can be updated by only
+ * recomputing each of their ancestors once, and a batch of prefix sum searches
+ * can be done level by level.
+ *
+ * @tparam T The array's element type.
+ * @tparam Arity The number of children of each node.
+ */
+template<typename T, size_t Arity = 8>
+class KArySumTree
+{
+ public:
+  static_assert(Arity >= 2, "KArySumTree: Arity must be at least 2.");
+
+  /**
+   * Default constructor.
+   */
+  KArySumTree() : capacity(0), depth(0), offsets(1, 0), element(1, T(0))
+  { /* Nothing to do here. */ }
+
+  /**
+   * Construct an instance of KArySumTree class.  The number of leaves is
+   * rounded up to a power of Arity.
+   *
+   * @param capacity Size of data.
+   */
+  KArySumTree(const size_t capacity) :
+      capacity(capacity),
+      depth(0)
+  {
+    size_t leaves = 1;
+    while (leaves < capacity)
+    {
+      leaves *= Arity;
+      ++depth;
+    }
+
+    // The level l holds Arity^l nodes, and starts at offsets[l].
+    offsets.resize(depth + 1);
+    size_t levelSize = 1, total = 0;
+    for (size_t l = 0; l <= depth; ++l)
+    {
+      offsets[l] = total;
+      total += levelSize;
+      levelSize *= Arity;
+    }
+    element = std::vector<T>(total, T(0));
+  }
+
+  /**
+   * Set the data array with idx.
+   *
+   * @param idx The array idx to be changed.
+   * @param value The data that array with idx to be.
+   */
+  void Set(size_t idx, const T value)
+  {
+    element[offsets[depth] + idx] = value;
+    for (size_t l = depth; l > 0; --l)
+    {
+      idx /= Arity;
+      UpdateNode(l - 1, idx);
+    }
+  }
+
+  /**
+   * Set the data with a batch of indices.  Each ancestor of the changed
+   * elements is only recomputed once.
+   *
+   * @param indices The indices of data to be changed.
+   * @param data The data that array with indices to be.
+   */
+  void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
+  {
+    if (indices.n_elem == 0)
+      return;
+
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      element[offsets[depth] + indices[i]] = data[i];
+
+    // arma::unique() sorts the parents, so the nodes of each level are
+    // recomputed in memory order.
+    arma::ucolvec parents = indices;
+    for (size_t l = depth; l > 0; --l)
+    {
+      parents = arma::unique(parents / Arity);
+      for (size_t i = 0; i < parents.n_elem; ++i)
+        UpdateNode(l - 1, parents[i]);
+    }
+  }
+
+  /**
+   * Get the data array with idx.
+   *
+   * @param idx The array idx to get data.
+   */
+  T Get(const size_t idx) const { return element[offsets[depth] + idx]; }
+
+  /**
+   * Get the data of the given indices.
+   *
+   * @param indices The array indices to get data.
+   * @param data The data of each index.
+   */
+  void BatchGet(const arma::ucolvec& indices, arma::Col<T>& data) const
+  {
+    data.set_size(indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      data[i] = Get(indices[i]);
+  }
+
+  /**
+   * Calculate the sum of contiguous subsequence of the array.
+   *
+   * @param start The starting position of subsequence.
+   * @param end The end position of subsequence (not included).
+   */
+  T Sum(size_t start, size_t end) const
+  {
+    T sum = T(0);
+    for (size_t l = depth + 1; l > 0 && start < end; --l)
+    {
+      // Add the nodes whose parents are not entirely in the range, then move
+      // up to the parents.
+      const T* level = element.data() + offsets[l - 1];
+      while (start < end && start % Arity != 0)
+        sum += level[start++];
+      while (end > start && end % Arity != 0)
+        sum += level[--end];
+      start /= Arity;
+      end /= Arity;
+    }
+    return sum;
+  }
+
+  /**
+   * Shortcut for calculating the sum of whole array.
+   */
+  T Sum() const { return element[0]; }
+
+  /**
+   * Find the highest index `idx` in the array such that
+   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
+   *
+   * @param mass The upper bound of segment array sum.
+   */
+  size_t FindPrefixSum(T mass) const
+  {
+    size_t node = 0;
+    for (size_t l = 1; l <= depth; ++l)
+      node = FindChild(l, node, mass);
+    return node;
+  }
+
+  /**
+   * Do FindPrefixSum() for each of the given masses.  The searches go down
+   * the tree together, level by level, so the upper levels stay in cache and
+   * the searches of one level are independent of each other.
+   *
+   * @param masses The upper bounds of segment array sum.
+   * @param indices The index found for each mass.
+   */
+  void BatchFindPrefixSum(const arma::Col<T>& masses,
+                          arma::ucolvec& indices) const
+  {
+    arma::Col<T> remaining = masses;
+    indices.zeros(masses.n_elem);
+    for (size_t l = 1; l <= depth; ++l)
+    {
+      for (size_t i = 0; i < masses.n_elem; ++i)
+        indices[i] = FindChild(l, indices[i], remaining[i]);
+    }
+  }
+
+  //! Get the number of elements that can be stored.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  /**
+   * Recompute the given node of the given level from its children.
+   *
+   * @param level The level of the node.
+   * @param node The index of the node in its level.
+   */
+  void UpdateNode(const size_t level, const size_t node)
+  {
+    const T* children = element.data() + offsets[level + 1] + node * Arity;
+    T sum = T(0);
+    for (size_t c = 0; c < Arity; ++c)
+      sum += children[c];
+    element[offsets[level] + node] = sum;
+  }
+
+  /**
+   * Find the child of the given node that holds the given mass, and remove
+   * the mass of its preceding siblings.  If rounding errors make the mass
+   * larger than the sum of the children, the last child with nonzero sum is
+   * used.
+   *
+   * @param level The level of the children.
+   * @param node The index of the parent in its level.
+   * @param mass The mass to find; updated to the mass within the child.
+   * @return The index of the child in its level.
+   */
+  size_t FindChild(const size_t level, const size_t node, T& mass) const
+  {
+    const size_t first = node * Arity;
+    const T* children = element.data() + offsets[level] + first;
+    size_t lastNonZero = 0;
+    for (size_t c = 0; c < Arity; ++c)
+    {
+      if (children[c] > mass)
+        return first + c;
+      if (children[c] > T(0))
+        lastNonZero = c;
+      mass -= children[c];
+    }
+
+    mass = children[lastNonZero];
+    return first + lastNonZero;
+  }
+
+  //! The capacity of the data array.
+  size_t capacity;
+
+  //! The number of levels below the root.
+  size_t depth;
+
+  //! The position of the first node of each level in the element vector.
+  std::vector<size_t> offsets;
+
+  //! The sums of all the nodes, level by level; the last level is the data.
+  std::vector<T> element;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -13,7 +13,8 @@
 #define MLPACK_METHODS_RL_PRIORITIZED_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "sumtree.hpp"
+#include "state_storage.hpp"
+#include "kary_sumtree.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -34,8 +35,11 @@ namespace rl {
  * @endcode
  *
  * @tparam EnvironmentType Desired task.
+ * @tparam StateStorageType How the encoded states are stored; see
+ *     FullStateStorage and CompactStateStorage.
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType,
+          typename StateStorageType = FullStateStorage<>>
 class PrioritizedReplay
 {
  public:
@@ -93,20 +97,13 @@ class PrioritizedReplay
       initialBeta(0.6),
       replayBetaIters(10000),
       nSteps(nSteps),
-      states(dimension, capacity),
+      storage(dimension, capacity),
       actions(capacity),
       rewards(capacity),
-      nextStates(dimension, capacity),
       isTerminal(capacity)
   {
-    size_t size = 1;
-    while (size < capacity)
-    {
-      size *= 2;
-    }
-
     beta = initialBeta;
-    idxSum = SumTree<double>(size);
+    idxSum = KArySumTree<double>(capacity);
   }
 
   /**
@@ -144,10 +141,9 @@ class PrioritizedReplay
 
     state = nStepBuffer.front().state;
     action = nStepBuffer.front().action;
-    states.col(position) = state.Encode();
+    storage.Store(position, state.Encode(), nextState.Encode());
     actions[position] = action;
     rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
     isTerminal(position) = isEnd;
 
     idxSum.Set(position, maxPriority * alpha);
@@ -160,6 +156,46 @@ class PrioritizedReplay
     }
   }
 
+  /**
+   * Store a batch of single-step experiences at once, one in each column of
+   * the given matrices, such as the transitions of the copies of a
+   * VectorizedEnvironment.  This is only supported when nSteps is 1, since
+   * consecutive columns do not belong to the same episode.
+   *
+   * @param states Given encoded states.
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param nextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void Store(const arma::mat& states,
+             const std::vector<ActionType>& actions,
+             const arma::rowvec& rewards,
+             const arma::mat& nextStates,
+             const arma::irowvec& isEnd)
+  {
+    if (nSteps != 1)
+    {
+      throw std::invalid_argument("PrioritizedReplay::Store(): batches of "
+          "experiences can only be stored when nSteps is 1!");
+    }
+
+    for (size_t i = 0; i < states.n_cols; ++i)
+    {
+      storage.Store(position, states.col(i), nextStates.col(i));
+      this->actions[position] = actions[i];
+      this->rewards(position) = rewards[i];
+      this->isTerminal(position) = isEnd[i];
+      idxSum.Set(position, maxPriority * alpha);
+      position++;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
   /**
    * Get the reward, next state and terminal boolean for nth step.
    *
@@ -197,14 +233,15 @@ class PrioritizedReplay
    */
   arma::ucolvec SampleProportional()
   {
-    arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
-    double sumPerRange = totalSum / batchSize;
-    for (size_t bt = 0; bt < batchSize; bt++)
-    {
-      const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
-    }
+    // Draw one mass from each of batchSize ranges of equal size, and search
+    // for all of them at once.
+    const double totalSum = idxSum.Sum(0, (full ? capacity : position));
+    const double sumPerRange = totalSum / batchSize;
+    const arma::colvec masses = (arma::randu<arma::colvec>(batchSize) +
+        arma::regspace<arma::colvec>(0, batchSize - 1)) * sumPerRange;
+
+    arma::ucolvec idxes;
+    idxSum.BatchFindPrefixSum(masses, idxes);
     return idxes;
   }
 
@@ -227,23 +264,20 @@ class PrioritizedReplay
     sampledIndices = SampleProportional();
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
+    storage.States(sampledIndices, sampledStates);
     for (size_t t = 0; t < sampledIndices.n_rows; t ++)
       sampledActions.push_back(actions[sampledIndices[t]]);
     sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
+    storage.NextStates(sampledIndices, sampledNextStates);
     isTerminal = this->isTerminal.elem(sampledIndices).t();
 
     // Calculate the weights of sampled transitions.
 
     size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
-
-    for (size_t i = 0; i < sampledIndices.n_rows; ++i)
-    {
-      double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
-      weights(i) = pow(numSample * p_sample, -beta);
-    }
+    arma::colvec sampledPriorities;
+    idxSum.BatchGet(sampledIndices, sampledPriorities);
+    weights = arma::pow(numSample * sampledPriorities.t() / idxSum.Sum(),
+        -beta);
     weights /= weights.max();
   }
 
@@ -337,7 +371,7 @@ class PrioritizedReplay
   size_t replayBetaIters;
 
   //! Locally-stored the prefix sum of prioritization.
-  SumTree<double> idxSum;
+  KArySumTree<double> idxSum;
 
   //! Locally-stored the indices of sampled transitions.
   arma::ucolvec sampledIndices;
@@ -351,8 +385,8 @@ class PrioritizedReplay
   //! Locally-stored buffer containing n consecutive steps.
   std::deque<Transition> nStepBuffer;
 
-  //! Locally-stored encoded previous states.
-  arma::mat states;
+  //! Locally-stored encoded previous states and next states.
+  StateStorageType storage;
 
   //! Locally-stored previous actions.
   std::vector<ActionType> actions;
@@ -360,9 +394,6 @@ class PrioritizedReplay
   //! Locally-stored previous rewards.
   arma::rowvec rewards;
 
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
-
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
 };
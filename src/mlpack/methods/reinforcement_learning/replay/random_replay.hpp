@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_RL_REPLAY_RANDOM_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "state_storage.hpp"
 #include <cassert>
 
 namespace mlpack {
@@ -39,8 +40,11 @@ namespace rl {
  * @endcode
  *
  * @tparam EnvironmentType Desired task.
+ * @tparam StateStorageType How the encoded states are stored; see
+ *     FullStateStorage and CompactStateStorage.
  */
-template <typename EnvironmentType>
+template <typename EnvironmentType,
+          typename StateStorageType = FullStateStorage<>>
 class RandomReplay
 {
  public:
@@ -84,10 +88,9 @@ class RandomReplay
       position(0),
       full(false),
       nSteps(nSteps),
-      states(dimension, capacity),
+      storage(dimension, capacity),
       actions(capacity),
       rewards(capacity),
-      nextStates(dimension, capacity),
       isTerminal(capacity)
   { /* Nothing to do here. */ }
 
@@ -127,10 +130,9 @@ class RandomReplay
     state = nStepBuffer.front().state;
     action = nStepBuffer.front().action;
 
-    states.col(position) = state.Encode();
+    storage.Store(position, state.Encode(), nextState.Encode());
     actions[position] = action;
     rewards(position) = reward;
-    nextStates.col(position) = nextState.Encode();
     isTerminal(position) = isEnd;
     position++;
     if (position == capacity)
@@ -140,6 +142,45 @@ class RandomReplay
     }
   }
 
+  /**
+   * Store a batch of single-step experiences at once, one in each column of
+   * the given matrices, such as the transitions of the copies of a
+   * VectorizedEnvironment.  This is only supported when nSteps is 1, since
+   * consecutive columns do not belong to the same episode.
+   *
+   * @param states Given encoded states.
+   * @param actions Given actions.
+   * @param rewards Given rewards.
+   * @param nextStates Given encoded next states.
+   * @param isEnd Whether each next state is terminal state.
+   */
+  void Store(const arma::mat& states,
+             const std::vector<ActionType>& actions,
+             const arma::rowvec& rewards,
+             const arma::mat& nextStates,
+             const arma::irowvec& isEnd)
+  {
+    if (nSteps != 1)
+    {
+      throw std::invalid_argument("RandomReplay::Store(): batches of "
+          "experiences can only be stored when nSteps is 1!");
+    }
+
+    for (size_t i = 0; i < states.n_cols; ++i)
+    {
+      storage.Store(position, states.col(i), nextStates.col(i));
+      this->actions[position] = actions[i];
+      this->rewards(position) = rewards[i];
+      this->isTerminal(position) = isEnd[i];
+      position++;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
   /**
    * Get the reward, next state and terminal boolean for nth step.
    *
@@ -190,11 +231,11 @@ class RandomReplay
     arma::uvec sampledIndices = arma::randi<arma::uvec>(
         batchSize, arma::distr_param(0, upperBound - 1));
 
-    sampledStates = states.cols(sampledIndices);
+    storage.States(sampledIndices, sampledStates);
     for (size_t t = 0; t < sampledIndices.n_rows; t ++)
       sampledActions.push_back(actions[sampledIndices[t]]);
     sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
+    storage.NextStates(sampledIndices, sampledNextStates);
     isTerminal = this->isTerminal.elem(sampledIndices).t();
   }
 
@@ -246,8 +287,8 @@ class RandomReplay
   //! Locally-stored buffer containing n consecutive steps.
   std::deque<Transition> nStepBuffer;
 
-  //! Locally-stored encoded previous states.
-  arma::mat states;
+  //! Locally-stored encoded previous states and next states.
+  StateStorageType storage;
 
   //! Locally-stored previous actions.
   std::vector<ActionType> actions;
@@ -255,9 +296,6 @@ class RandomReplay
   //! Locally-stored previous rewards.
   arma::rowvec rewards;
 
-  //! Locally-stored encoded previous next states.
-  arma::mat nextStates;
-
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
 };
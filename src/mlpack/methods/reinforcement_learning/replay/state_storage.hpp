@@ -0,0 +1,237 @@
+/**
+ * @file methods/reinforcement_learning/replay/state_storage.hpp
+ *
+ * This file defines the policies that RandomReplay and PrioritizedReplay use
+ * to store the encoded states of the transitions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_STATE_STORAGE_HPP
+#define MLPACK_METHODS_RL_REPLAY_STATE_STORAGE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Store the state and the next state of every transition, as elements of type
+ * ElemType.  Using float or unsigned char instead of double reduces the memory
+ * used by the replay buffer; the encoded states are converted to ElemType, so
+ * for unsigned char they should be integers in [0, 255] (such as pixels).
+ *
+ * A state storage policy keeps the states of the transitions at the positions
+ * of a ring buffer, which are written in order.  It must provide the following
+ * functions.
+ *
+ * @code
+ * // Store the state and next state of the transition at the given position.
+ * template<typename VecType1, typename VecType2>
+ * void Store(const size_t position,
+ *            const VecType1& state,
+ *            const VecType2& nextState);
+ *
+ * // Get the states and next states of the transitions at the given
+ * // positions, as the columns of the given matrices.
+ * void States(const arma::uvec& positions, arma::mat& states) const;
+ * void NextStates(const arma::uvec& positions, arma::mat& nextStates) const;
+ * @endcode
+ *
+ * @tparam ElemType Type of the stored elements.
+ */
+template<typename ElemType = double>
+class FullStateStorage
+{
+ public:
+  //! Create an empty storage.
+  FullStateStorage() { }
+
+  /**
+   * Create the storage for the given number of transitions.
+   *
+   * @param dimension The dimension of an encoded state.
+   * @param capacity Number of transitions.
+   */
+  FullStateStorage(const size_t dimension, const size_t capacity) :
+      states(dimension, capacity),
+      nextStates(dimension, capacity)
+  { /* Nothing to do here. */ }
+
+  //! Store the state and next state of the transition at the given position.
+  template<typename VecType1, typename VecType2>
+  void Store(const size_t position,
+             const VecType1& state,
+             const VecType2& nextState)
+  {
+    states.col(position) = arma::conv_to<arma::Col<ElemType>>::from(state);
+    nextStates.col(position) =
+        arma::conv_to<arma::Col<ElemType>>::from(nextState);
+  }
+
+  //! Get the states of the transitions at the given positions.
+  void States(const arma::uvec& positions, arma::mat& sampledStates) const
+  {
+    sampledStates = arma::conv_to<arma::mat>::from(states.cols(positions));
+  }
+
+  //! Get the next states of the transitions at the given positions.
+  void NextStates(const arma::uvec& positions,
+                  arma::mat& sampledNextStates) const
+  {
+    sampledNextStates = arma::conv_to<arma::mat>::from(
+        nextStates.cols(positions));
+  }
+
+ private:
+  //! Locally-stored encoded states.
+  arma::Mat<ElemType> states;
+
+  //! Locally-stored encoded next states.
+  arma::Mat<ElemType> nextStates;
+};
+
+/**
+ * Store each state only once, as elements of type ElemType.  Within an
+ * episode, the next state of a single-step transition is the state of the
+ * transition that follows it, which is stored at the next position of the ring
+ * buffer; so the next state is only stored explicitly when it is not the state
+ * of the next transition, for the last transition of each episode (and for
+ * the most recent transition, until the next one is stored).  This halves the
+ * memory of single-step replay; with n-step replay, the next states are
+ * never the states of the next transitions, so they are all stored
+ * explicitly.
+ *
+ * As with FullStateStorage, the encoded states are converted to ElemType.
+ * Whether a next state is the state of the next transition is decided by
+ * comparing the converted values exactly.
+ *
+ * @tparam ElemType Type of the stored elements.
+ */
+template<typename ElemType = double>
+class CompactStateStorage
+{
+ public:
+  //! Create an empty storage.
+  CompactStateStorage() : capacity(0), last(0), hasLast(false) { }
+
+  /**
+   * Create the storage for the given number of transitions.
+   *
+   * @param dimension The dimension of an encoded state.
+   * @param capacity Number of transitions.
+   */
+  CompactStateStorage(const size_t dimension, const size_t capacity) :
+      capacity(capacity),
+      states(dimension, capacity),
+      linked(capacity, false),
+      last(0),
+      hasLast(false)
+  { /* Nothing to do here. */ }
+
+  //! Store the state and next state of the transition at the given position.
+  template<typename VecType1, typename VecType2>
+  void Store(const size_t position,
+             const VecType1& state,
+             const VecType2& nextState)
+  {
+    const arma::Col<ElemType> converted =
+        arma::conv_to<arma::Col<ElemType>>::from(state);
+
+    // The transition stored before this one can use this state as its next
+    // state if they are equal; otherwise its next state is kept.
+    if (hasLast)
+    {
+      if (position == (last + 1) % capacity &&
+          arma::all(converted == lastNextState))
+      {
+        linked[last] = true;
+      }
+      else
+      {
+        linked[last] = false;
+        explicitNextStates[last] = lastNextState;
+      }
+    }
+
+    // The transition at this position is overwritten.
+    explicitNextStates.erase(position);
+    linked[position] = false;
+
+    states.col(position) = converted;
+    lastNextState = arma::conv_to<arma::Col<ElemType>>::from(nextState);
+    last = position;
+    hasLast = true;
+  }
+
+  //! Get the states of the transitions at the given positions.
+  void States(const arma::uvec& positions, arma::mat& sampledStates) const
+  {
+    sampledStates = arma::conv_to<arma::mat>::from(states.cols(positions));
+  }
+
+  //! Get the next states of the transitions at the given positions.
+  void NextStates(const arma::uvec& positions,
+                  arma::mat& sampledNextStates) const
+  {
+    sampledNextStates.set_size(states.n_rows, positions.n_elem);
+    for (size_t i = 0; i < positions.n_elem; ++i)
+    {
+      const size_t p = positions[i];
+      if (hasLast && p == last)
+      {
+        sampledNextStates.col(i) = arma::conv_to<arma::vec>::from(
+            lastNextState);
+      }
+      else if (linked[p])
+      {
+        sampledNextStates.col(i) = arma::conv_to<arma::vec>::from(
+            states.col((p + 1) % capacity));
+      }
+      else
+      {
+        sampledNextStates.col(i) = arma::conv_to<arma::vec>::from(
+            explicitNextStates.at(p));
+      }
+    }
+  }
+
+  //! Get the number of next states that are stored explicitly.
+  size_t NumExplicitNextStates() const
+  {
+    return explicitNextStates.size() + (hasLast ? 1 : 0);
+  }
+
+ private:
+  //! Locally-stored number of transitions.
+  size_t capacity;
+
+  //! Locally-stored encoded states.
+  arma::Mat<ElemType> states;
+
+  //! Whether the next state of each transition is the state at the next
+  //! position.
+  std::vector<bool> linked;
+
+  //! Locally-stored next states that are not the state of the next
+  //! transition.
+  std::unordered_map<size_t, arma::Col<ElemType>> explicitNextStates;
+
+  //! Position of the most recent transition.
+  size_t last;
+
+  //! Next state of the most recent transition.
+  arma::Col<ElemType> lastNextState;
+
+  //! Whether a transition was stored.
+  bool hasLast;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
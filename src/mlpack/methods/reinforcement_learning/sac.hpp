@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "environment/vectorized_environment.hpp"
 #include "replay/random_replay.hpp"
 #include <mlpack/methods/ann/activation_functions/tanh_function.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
@@ -122,6 +123,28 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Select an action for each of the given encoded states, using a single
+   * forward pass of the policy network.
+   *
+   * @param states Encoded states, one per column.
+   * @param actions Vector to store the selected actions in.
+   */
+  void SelectActions(const arma::mat& states, std::vector<ActionType>& actions);
+
+  /**
+   * Execute an episode in each copy of a vectorized environment.  The copies
+   * are stepped in lockstep: at each step, the actions of all active copies
+   * are selected with one forward pass, and their transitions are stored in
+   * the replay buffer together.  The networks are updated as often as in
+   * Episode() for each transition.  Vectorized episodes require single-step
+   * replay.
+   *
+   * @param environments Copies of the environment to run episodes in.
+   * @return Mean return of the episodes.
+   */
+  double Episode(VectorizedEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
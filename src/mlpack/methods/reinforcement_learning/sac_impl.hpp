@@ -358,6 +358,95 @@ double SAC<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+void SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::SelectActions(const arma::mat& states, std::vector<ActionType>& actions)
+{
+  // Get the actions at all states at once, from policy.
+  arma::mat outputActions;
+  policyNetwork.Predict(states, outputActions);
+
+  if (!deterministic)
+  {
+    arma::mat noise = arma::randn<arma::mat>(arma::size(outputActions)) * 0.1;
+    noise = arma::clamp(noise, -0.25, 0.25);
+    outputActions = outputActions + noise;
+  }
+
+  actions.resize(states.n_cols);
+  for (size_t i = 0; i < states.n_cols; ++i)
+  {
+    actions[i].action = arma::conv_to<std::vector<double>>::from(
+        outputActions.col(i));
+  }
+}
+
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename UpdaterType,
+  typename ReplayType
+>
+double SAC<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  UpdaterType,
+  ReplayType
+>::Episode(VectorizedEnvironment<EnvironmentType>& environments)
+{
+  if (replayMethod.NSteps() != 1)
+  {
+    throw std::invalid_argument("SAC::Episode(): vectorized environments can "
+        "only be used with single-step replay!");
+  }
+
+  // Get the initial states from the environments.
+  environments.InitialSample();
+
+  arma::mat states, nextStates;
+  std::vector<ActionType> actions;
+  arma::rowvec rewards;
+  arma::irowvec isTerminal;
+
+  // Running until all environments get to a terminal state or the step limit.
+  while (environments.NumActive() > 0)
+  {
+    environments.ActiveStates(states);
+    SelectActions(states, actions);
+
+    // Interact with the environments to advance to the next states.
+    environments.Step(actions, rewards, nextStates, isTerminal,
+        config.StepLimit());
+
+    // Store the transitions for replay.
+    replayMethod.Store(states, actions, rewards, nextStates, isTerminal);
+
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+      totalSteps++;
+      if (deterministic || totalSteps < config.ExplorationSteps())
+        continue;
+      for (size_t j = 0; j < config.UpdateInterval(); j++)
+        Update();
+    }
+  }
+
+  return arma::mean(environments.Returns());
+}
+
 } // namespace rl
 } // namespace mlpack
 #endif
@@ -45,7 +45,7 @@ namespace regression {
  * const size_t numIterations = 100; // Maximum number of iterations.
  *
  * // Train the model using an instantiated optimizer for the training.
- * SoftmaxRegression regressor(trainData.n_rows, numClasses);
+ * SoftmaxRegression<> regressor(trainData.n_rows, numClasses);
  * ens::L_BFGS optimizer(numBasis, numIterations);
  * regressor.Train(trainData, labels, numClasses, std::move(optimizer));
  *
@@ -55,10 +55,23 @@ namespace regression {
  * // Obtain predictions from both the learned models.
  * regressor.Classify(testData, predictions);
  * @endcode
+ *
+ * The class supports different observation types via the MatType template
+ * parameter; for instance, sparse datasets can be used by specifying
+ * arma::sp_mat, and single-precision datasets by specifying arma::fmat.  The
+ * parameters of the model are dense, with the element type of MatType.
+ *
+ * @tparam MatType Type of data matrix.
  */
+template<typename MatType = arma::mat>
 class SoftmaxRegression
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! The type of the model parameters (always dense).
+  typedef arma::Mat<ElemType> DenseMatType;
+
   /**
    * Initialize the SoftmaxRegression without performing training.  Default
    * value of lambda is 0.0001.  Be sure to use Train() before calling
@@ -86,7 +99,7 @@ class SoftmaxRegression
    * @param fitIntercept add intercept term or not.
    */
   template<typename OptimizerType = ens::L_BFGS>
-  SoftmaxRegression(const arma::mat& data,
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda = 0.0001,
@@ -110,7 +123,7 @@ class SoftmaxRegression
    *        See https://www.ensmallen.org/docs.html#callback-documentation.
    */
   template<typename OptimizerType, typename... CallbackTypes>
-  SoftmaxRegression(const arma::mat& data,
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda,
@@ -125,7 +138,7 @@ class SoftmaxRegression
    * @param dataset Set of points to classify.
    * @param labels Predicted labels for each point.
    */
-  void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
+  void Classify(const MatType& dataset, arma::Row<size_t>& labels) const;
   /**
    * Classify the given point. The predicted class label is returned.
    * The function calculates the probabilites for every class, given the point.
@@ -147,9 +160,9 @@ class SoftmaxRegression
    * @param labels Predicted labels for each point.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
+  void Classify(const MatType& dataset,
                 arma::Row<size_t>& labels,
-                arma::mat& probabilities) const;
+                DenseMatType& probabilities) const;
 
   /**
    * Classify the given points, returning class probabilities for each point.
@@ -157,8 +170,8 @@ class SoftmaxRegression
    * @param dataset Matrix of data points to be classified.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
-                arma::mat& probabilities) const;
+  void Classify(const MatType& dataset,
+                DenseMatType& probabilities) const;
 
   /**
    * Computes accuracy of the learned model given the feature data and the
@@ -168,7 +181,7 @@ class SoftmaxRegression
    * @param testData Matrix of data points using which predictions are made.
    * @param labels Vector of labels associated with the data.
    */
-  double ComputeAccuracy(const arma::mat& testData,
+  double ComputeAccuracy(const MatType& testData,
                          const arma::Row<size_t>& labels) const;
   /**
    * Train the softmax regression with the given training data.
@@ -181,7 +194,7 @@ class SoftmaxRegression
    * @return Objective value of the final point.
    */
   template<typename OptimizerType = ens::L_BFGS>
-  double Train(const arma::mat& data,
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
@@ -199,7 +212,7 @@ class SoftmaxRegression
    * @return Objective value of the final point.
    */
   template<typename OptimizerType = ens::L_BFGS, typename... CallbackTypes>
-  double Train(const arma::mat& data,
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer,
@@ -219,9 +232,9 @@ class SoftmaxRegression
   bool FitIntercept() const { return fitIntercept; }
 
   //! Get the model parameters.
-  arma::mat& Parameters() { return parameters; }
+  DenseMatType& Parameters() { return parameters; }
   //! Get the model parameters.
-  const arma::mat& Parameters() const { return parameters; }
+  const DenseMatType& Parameters() const { return parameters; }
 
   //! Gets the features size of the training data
   size_t FeatureSize() const
@@ -242,7 +255,7 @@ class SoftmaxRegression
 
  private:
   //! Parameters after optimization.
-  arma::mat parameters;
+  DenseMatType parameters;
   //! Number of classes.
   size_t numClasses;
   //! L2-regularization constant.
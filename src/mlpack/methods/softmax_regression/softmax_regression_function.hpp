@@ -18,9 +18,24 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression.  The data may be any dense or
+ * sparse Armadillo matrix type, given by the MatType template parameter; the
+ * parameters, probabilities and gradients are dense matrices with the same
+ * element type as the data, so that, e.g., arma::fmat or arma::sp_mat data can
+ * be used without converting it to arma::mat.
+ *
+ * @tparam MatType Type of the data matrix.
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
+  //! The element type of the data.
+  typedef typename MatType::elem_type ElemType;
+  //! The type of the parameters, probabilities and gradients.
+  typedef arma::Mat<ElemType> DenseMatType;
+
   /**
    * Construct the Softmax Regression objective function with the given
    * parameters.
@@ -31,14 +46,14 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
                             const bool fitIntercept = false);
 
   //! Initializes the parameters of the model to suitable values.
-  const arma::mat InitializeWeights();
+  const DenseMatType InitializeWeights();
 
   /**
    * Shuffle the dataset.
@@ -54,9 +69,9 @@ class SoftmaxRegressionFunction
    * @param fitIntercept If true, an intercept is fitted.
    * @return Initialized model weights.
    */
-  static const arma::mat InitializeWeights(const size_t featureSize,
-                                           const size_t numClasses,
-                                           const bool fitIntercept = false);
+  static const DenseMatType InitializeWeights(const size_t featureSize,
+                                              const size_t numClasses,
+                                              const bool fitIntercept = false);
 
   /**
    * Initialize Softmax Regression weights (trainable parameters) with the given
@@ -67,7 +82,7 @@ class SoftmaxRegressionFunction
    * @param numClasses Number of classes for classification.
    * @param fitIntercept Intercept term flag.
    */
-  static void InitializeWeights(arma::mat &weights,
+  static void InitializeWeights(DenseMatType& weights,
                                 const size_t featureSize,
                                 const size_t numClasses,
                                 const bool fitIntercept = false);
@@ -76,10 +91,10 @@ class SoftmaxRegressionFunction
    * Constructs the ground truth label matrix with the passed labels.
    *
    * @param labels Labels associated with the training data.
-   * @param groundTruth Pointer to arma::mat which stores the computed matrix.
+   * @param groundTruth Sparse matrix to store the computed matrix in.
    */
   void GetGroundTruthMatrix(const arma::Row<size_t>& labels,
-                            arma::sp_mat& groundTruth);
+                            arma::SpMat<ElemType>& groundTruth);
 
   /**
    * Evaluate the probabilities matrix with the passed parameters.
@@ -88,12 +103,12 @@ class SoftmaxRegressionFunction
    * It represents the probability of data_j belongs to class i.
    *
    * @param parameters Current values of the model parameters.
-   * @param probabilities Pointer to arma::mat which stores the probabilities.
+   * @param probabilities Matrix to store the probabilities in.
    * @param start Index of point to start at.
    * @param batchSize Number of points to calculate probabilities for.
    */
-  void GetProbabilitiesMatrix(const arma::mat& parameters,
-                              arma::mat& probabilities,
+  void GetProbabilitiesMatrix(const DenseMatType& parameters,
+                              DenseMatType& probabilities,
                               const size_t start,
                               const size_t batchSize) const;
 
@@ -106,7 +121,7 @@ class SoftmaxRegressionFunction
    *
    * @param parameters Current values of the model parameters.
    */
-  double Evaluate(const arma::mat& parameters) const;
+  double Evaluate(const DenseMatType& parameters) const;
 
   /**
    * Evaluate the objective function of the softmax regression model for a
@@ -119,7 +134,7 @@ class SoftmaxRegressionFunction
    * @param start First index of the data points to use.
    * @param batchSize Number of data points to evaluate objective for.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const DenseMatType& parameters,
                   const size_t start,
                   const size_t batchSize = 1) const;
 
@@ -127,12 +142,13 @@ class SoftmaxRegressionFunction
    * Evaluates the gradient values of the objective function given the current
    * set of parameters. The function calculates the probabilities for each class
    * given the parameters, and computes the gradients based on the difference
-   * from the ground truth.
+   * from the ground truth.  The product with the data is computed as
+   * data * residuals^T, so that sparse data is never transposed.
    *
    * @param parameters Current values of the model parameters.
    * @param gradient Matrix where gradient values will be stored.
    */
-  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+  void Gradient(const DenseMatType& parameters, DenseMatType& gradient) const;
 
   /**
    * Evaluate the gradient of the objective function given the current set of
@@ -145,11 +161,56 @@ class SoftmaxRegressionFunction
    * @param gradient Matrix to store gradient into.
    * @param batchSize Number of data points to evaluate gradient for.
    */
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const DenseMatType& parameters,
                 const size_t start,
-                arma::mat& gradient,
+                DenseMatType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the objective function on a subset of the data as
+   * a sparse matrix, whose only nonzero columns are the intercept and the
+   * features that are nonzero in the batch.  As in Hogwild!, the
+   * regularization is only applied to those columns, so that an update does
+   * not touch the rest of the parameters.  This is the overload used by
+   * lock-free parallel optimizers such as optimization::HogwildSGD and
+   * ens::ParallelSGD.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Sparse matrix to store gradient into.
+   * @param batchSize Number of data points to evaluate gradient for.
+   */
+  void Gradient(const DenseMatType& parameters,
+                const size_t start,
+                arma::SpMat<ElemType>& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters.  The class probabilities are only computed once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The value of the objective function.
+   */
+  double EvaluateWithGradient(const DenseMatType& parameters,
+                              DenseMatType& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient on a subset of the data,
+   * given the current set of parameters.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to use.
+   * @return The value of the objective function.
+   */
+  double EvaluateWithGradient(const DenseMatType& parameters,
+                              const size_t start,
+                              DenseMatType& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -159,12 +220,12 @@ class SoftmaxRegressionFunction
    *    gradient is to be computed.
    * @param gradient Out param for the gradient value.
    */
-  void PartialGradient(const arma::mat& parameters,
+  void PartialGradient(const DenseMatType& parameters,
                        size_t j,
-                       arma::sp_mat& gradient) const;
+                       arma::SpMat<ElemType>& gradient) const;
 
   //! Return the initial point for the optimization.
-  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  const DenseMatType& GetInitialPoint() const { return initialPoint; }
 
   //! Gets the number of classes.
   size_t NumClasses() const { return numClasses; }
@@ -188,12 +249,28 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
+  /**
+   * Compute the sum of the log-likelihoods of the points in
+   * [start, start + batchSize) and, if gradient is not NULL, the sum of the
+   * gradients of their negative log-likelihoods.  The points are split into
+   * blocks that are processed in parallel with OpenMP.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param batchSize Number of data points to use.
+   * @param gradient If not NULL, matrix to store the gradient in.
+   */
+  double LogLikelihood(const DenseMatType& parameters,
+                       const size_t start,
+                       const size_t batchSize,
+                       DenseMatType* gradient = NULL) const;
+
   //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  MatType data;
   //! Label matrix for the provided data.
-  arma::sp_mat groundTruth;
+  arma::SpMat<ElemType> groundTruth;
   //! Initial parameter point.
-  arma::mat initialPoint;
+  DenseMatType initialPoint;
   //! Number of classes.
   size_t numClasses;
   //! L2-regularization constant.
@@ -205,4 +282,7 @@ class SoftmaxRegressionFunction
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
@@ -0,0 +1,463 @@
+/**
+ * @file methods/softmax_regression/softmax_regression_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for softmax regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "softmax_regression_function.hpp"
+
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept) :
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+
+  // Calculate the label matrix.
+  GetGroundTruthMatrix(labels, groundTruth);
+}
+
+/**
+ * Shuffle the data.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Shuffle()
+{
+  // Recover the labels from the ground truth matrix, so that the points and
+  // the labels can be shuffled together (this works for sparse data too).
+  arma::Row<size_t> labels(groundTruth.n_cols);
+  typename arma::SpMat<ElemType>::const_iterator it = groundTruth.begin();
+  for (; it != groundTruth.end(); ++it)
+    labels[it.col()] = it.row();
+
+  MatType newData;
+  arma::Row<size_t> newLabels;
+  math::ShuffleData(data, labels, newData, newLabels);
+
+  math::ClearAlias(data);
+  data = std::move(newData);
+  GetGroundTruthMatrix(newLabels, groundTruth);
+}
+
+/**
+ * Initializes parameter weights to random values taken from a scaled standard
+ * normal distribution. The weights cannot be initialized to zero, as that will
+ * lead to each class output being the same.
+ */
+template<typename MatType>
+const typename SoftmaxRegressionFunction<MatType>::DenseMatType
+SoftmaxRegressionFunction<MatType>::InitializeWeights()
+{
+  return InitializeWeights(data.n_rows, numClasses, fitIntercept);
+}
+
+template<typename MatType>
+const typename SoftmaxRegressionFunction<MatType>::DenseMatType
+SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+    DenseMatType parameters;
+    InitializeWeights(parameters, featureSize, numClasses, fitIntercept);
+    return parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    DenseMatType& weights,
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+  // Initialize values to 0.005 * r. 'r' is a matrix of random values taken from
+  // a Gaussian distribution with mean zero and variance one.
+  // If the fitIntercept flag is true, parameters.col(0) is the intercept.
+  if (fitIntercept)
+    weights.randn(numClasses, featureSize + 1);
+  else
+    weights.randn(numClasses, featureSize);
+  weights *= 0.005;
+}
+
+/**
+ * This is equivalent to applying the indicator function to the training
+ * labels. The output is in the form of a matrix, which leads to simpler
+ * calculations in the Evaluate() and Gradient() methods.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
+    const arma::Row<size_t>& labels, arma::SpMat<ElemType>& groundTruth)
+{
+  // Calculate the ground truth matrix according to the labels passed. The
+  // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
+  // where each column contains a single entry of '1', marking the label
+  // corresponding to that example.
+
+  // Row pointers and column pointers corresponding to the entries.
+  arma::uvec rowPointers(labels.n_elem);
+  arma::uvec colPointers(labels.n_elem + 1);
+
+  // colPointers[0] needs to be set to 0.
+  colPointers[0] = 0;
+
+  // Row pointers are the labels of the examples, and column pointers are the
+  // number of cumulative entries made uptil that column.
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    rowPointers(i) = labels(i);
+    colPointers(i + 1) = i + 1;
+  }
+
+  // All entries are '1'.
+  arma::Col<ElemType> values;
+  values.ones(labels.n_elem);
+
+  // Calculate the matrix.
+  groundTruth = arma::SpMat<ElemType>(rowPointers, colPointers, values,
+      numClasses, labels.n_elem);
+}
+
+/**
+ * Evaluate the probabilities matrix. If fitIntercept flag is true,
+ * it should consider the parameters.cols(0) intercept term.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
+    const DenseMatType& parameters,
+    DenseMatType& probabilities,
+    const size_t start,
+    const size_t batchSize) const
+{
+  DenseMatType hypothesis;
+
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = arma::exp(parameters * [1; data]).
+    //
+    // Since the cost of join may be high due to the copy of original data,
+    // split the hypothesis computation to two components.
+    hypothesis = arma::exp(
+        arma::repmat(parameters.col(0), 1, batchSize) +
+        parameters.cols(1, parameters.n_cols - 1) *
+        data.cols(start, start + batchSize - 1));
+  }
+  else
+  {
+    hypothesis = arma::exp(parameters *
+        data.cols(start, start + batchSize - 1));
+  }
+
+  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
+                                            numClasses, 1);
+}
+
+/**
+ * Evaluates the objective function given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const DenseMatType& parameters) const
+{
+  // The objective function is the negative log likelihood of the model
+  // calculated over all the training examples. Mathematically it is as follows:
+  // log likelihood = sum(1{y_i = j} * log(probability(j))) / m
+  // The sum is over all 'i's and 'j's, where 'i' points to a training example
+  // and 'j' points to a particular class. 1{x} is an indicator function whose
+  // value is 1 only when 'x' is satisfied, otherwise it is 0.
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization to control the
+  // parameter weights.
+  const double logLikelihood = LogLikelihood(parameters, 0, data.n_cols) /
+      data.n_cols;
+  const double weightDecay = 0.5 * lambda *
+      arma::accu(parameters % parameters);
+
+  // The cost is the sum of the negative log likelihood and the regularization
+  // terms.
+  return -logLikelihood + weightDecay;
+}
+
+/**
+ * Evaluate the objective function for the given points given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const DenseMatType& parameters,
+    const size_t start,
+    const size_t batchSize) const
+{
+  const double logLikelihood = LogLikelihood(parameters, start, batchSize) /
+      batchSize;
+  const double weightDecay = 0.5 * lambda *
+      arma::accu(parameters % parameters);
+
+  return -logLikelihood + weightDecay;
+}
+
+/**
+ * Calculates and stores the gradient values given a set of parameters.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const DenseMatType& parameters,
+    DenseMatType& gradient) const
+{
+  LogLikelihood(parameters, 0, data.n_cols, &gradient);
+  gradient = gradient / data.n_cols + lambda * parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const DenseMatType& parameters,
+    const size_t start,
+    DenseMatType& gradient,
+    const size_t batchSize) const
+{
+  LogLikelihood(parameters, start, batchSize, &gradient);
+  gradient = gradient / batchSize + lambda * parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const DenseMatType& parameters,
+    const size_t start,
+    arma::SpMat<ElemType>& gradient,
+    const size_t batchSize) const
+{
+  DenseMatType probabilities;
+  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  const DenseMatType inner = (probabilities -
+      groundTruth.cols(start, start + batchSize - 1)) / batchSize;
+
+  // Collect the terms of the intercept column and, for each nonzero element
+  // of the batch, of the column of its feature; the terms of the same
+  // parameter are summed by the constructor.
+  const arma::SpMat<ElemType> batch(data.cols(start, start + batchSize - 1));
+  const size_t offset = fitIntercept ? 1 : 0;
+  const size_t numTerms = numClasses * (batch.n_nonzero + offset);
+  arma::umat locations(2, numTerms);
+  arma::Col<ElemType> values(numTerms);
+  size_t k = 0;
+  if (fitIntercept)
+  {
+    const arma::Col<ElemType> interceptTerms = arma::sum(inner, 1);
+    for (size_t c = 0; c < numClasses; ++c, ++k)
+    {
+      locations(0, k) = c;
+      locations(1, k) = 0;
+      values[k] = interceptTerms[c];
+    }
+  }
+
+  typename arma::SpMat<ElemType>::const_iterator it = batch.begin();
+  for (; it != batch.end(); ++it)
+  {
+    for (size_t c = 0; c < numClasses; ++c, ++k)
+    {
+      locations(0, k) = c;
+      locations(1, k) = it.row() + offset;
+      values[k] = inner(c, it.col()) * (*it);
+    }
+  }
+
+  // Zeros are kept, so that every touched parameter is regularized below.
+  const arma::SpMat<ElemType> loss(true, locations, values, parameters.n_rows,
+      parameters.n_cols, true, false);
+
+  // Add the regularization of the touched parameters.
+  locations.set_size(2, loss.n_nonzero);
+  values.set_size(loss.n_nonzero);
+  k = 0;
+  for (it = loss.begin(); it != loss.end(); ++it, ++k)
+  {
+    locations(0, k) = it.row();
+    locations(1, k) = it.col();
+    values[k] = (*it) + lambda * parameters(it.row(), it.col());
+  }
+
+  gradient = arma::SpMat<ElemType>(locations, values, parameters.n_rows,
+      parameters.n_cols, false);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const DenseMatType& parameters,
+    DenseMatType& gradient) const
+{
+  const double logLikelihood = LogLikelihood(parameters, 0, data.n_cols,
+      &gradient) / data.n_cols;
+  gradient = gradient / data.n_cols + lambda * parameters;
+
+  return -logLikelihood + 0.5 * lambda * arma::accu(parameters % parameters);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const DenseMatType& parameters,
+    const size_t start,
+    DenseMatType& gradient,
+    const size_t batchSize) const
+{
+  const double logLikelihood = LogLikelihood(parameters, start, batchSize,
+      &gradient) / batchSize;
+  gradient = gradient / batchSize + lambda * parameters;
+
+  return -logLikelihood + 0.5 * lambda * arma::accu(parameters % parameters);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::LogLikelihood(
+    const DenseMatType& parameters,
+    const size_t start,
+    const size_t batchSize,
+    DenseMatType* gradient) const
+{
+  // The points are processed in blocks, so that the probabilities of each
+  // block stay in cache and the blocks can be split between threads.
+  const size_t blockSize = 2048;
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
+
+#ifdef HAS_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numBlocks));
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // Each thread accumulates into its own log-likelihood and gradient; these
+  // are summed in thread order afterwards, so the result does not depend on
+  // the timing of the threads.
+  std::vector<double> threadResults(numThreads, 0.0);
+  std::vector<DenseMatType> threadGradients((gradient == NULL) ? 0 :
+      numThreads);
+
+  #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+  {
+#ifdef HAS_OPENMP
+    const size_t thread = omp_get_thread_num();
+#else
+    const size_t thread = 0;
+#endif
+    if (gradient != NULL)
+      threadGradients[thread].zeros(parameters.n_rows, parameters.n_cols);
+
+    DenseMatType probabilities;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t first = start + b * blockSize;
+      const size_t size = std::min(blockSize, batchSize - b * blockSize);
+      const size_t last = first + size - 1;
+
+      // Calculate the class probabilities for each training example. The
+      // probabilities for each of the classes are given by:
+      // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
+      // The sum is calculated over all the classes.
+      // x_i is the input vector for a particular training example.
+      // theta_j is the parameter vector associated with a particular class.
+      GetProbabilitiesMatrix(parameters, probabilities, first, size);
+
+      threadResults[thread] += arma::accu(groundTruth.cols(first, last) %
+          arma::log(probabilities));
+
+      if (gradient != NULL)
+      {
+        // The product with the data is taken as data * inner^T, which for
+        // sparse data only visits the nonzero elements.
+        const DenseMatType inner = probabilities -
+            groundTruth.cols(first, last);
+        DenseMatType& g = threadGradients[thread];
+        if (fitIntercept)
+        {
+          // Treating the intercept term parameters.col(0) seperately to avoid
+          // the cost of building matrix [1; data].
+          g.col(0) += arma::sum(inner, 1);
+          g.cols(1, parameters.n_cols - 1) +=
+              (data.cols(first, last) * inner.t()).t();
+        }
+        else
+        {
+          g += (data.cols(first, last) * inner.t()).t();
+        }
+      }
+    }
+  }
+
+  double result = 0.0;
+  if (gradient != NULL)
+    gradient->zeros(parameters.n_rows, parameters.n_cols);
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    result += threadResults[t];
+    if (gradient != NULL)
+      *gradient += threadGradients[t];
+  }
+
+  return result;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PartialGradient(
+    const DenseMatType& parameters,
+    const size_t j,
+    arma::SpMat<ElemType>& gradient) const
+{
+  gradient.zeros(arma::size(parameters));
+
+  DenseMatType probabilities;
+  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+
+  // Calculate the required part of the gradient.
+  const DenseMatType inner = probabilities - groundTruth;
+  if (fitIntercept)
+  {
+    if (j == 0)
+    {
+      gradient.col(j) = arma::sum(inner, 1) / data.n_cols +
+          lambda * parameters.col(0);
+    }
+    else
+    {
+      // Column j of the parameters corresponds to feature j - 1.
+      gradient.col(j) = inner * DenseMatType(data.row(j - 1)).t() /
+          data.n_cols + lambda * parameters.col(j);
+    }
+  }
+  else
+  {
+    gradient.col(j) = inner * DenseMatType(data.row(j)).t() / data.n_cols +
+        lambda * parameters.col(j);
+  }
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -103,9 +103,9 @@ PARAM_UROW_IN("labels", "A matrix containing labels (0 or 1) for the points "
     "in the training set (y). The labels must order as a row.", "l");
 
 // Model loading/saving.
-PARAM_MODEL_IN(SoftmaxRegression, "input_model", "File containing existing "
+PARAM_MODEL_IN(SoftmaxRegression<>, "input_model", "File containing existing "
     "model (parameters).", "m");
-PARAM_MODEL_OUT(SoftmaxRegression, "output_model", "File to save trained "
+PARAM_MODEL_OUT(SoftmaxRegression<>, "output_model", "File to save trained "
     "softmax regression model to.", "M");
 
 // Testing.
@@ -167,11 +167,11 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "output_model", "predictions" }, false, "no results"
       " will be saved");
 
-  SoftmaxRegression* sm = TrainSoftmax<SoftmaxRegression>(maxIterations);
+  SoftmaxRegression<>* sm = TrainSoftmax<SoftmaxRegression<>>(maxIterations);
 
   TestClassifyAcc(sm->NumClasses(), *sm);
 
-  IO::GetParam<SoftmaxRegression*>("output_model") = sm;
+  IO::GetParam<SoftmaxRegression<>*>("output_model") = sm;
 }
 
 size_t CalculateNumberOfClasses(const size_t numClasses,
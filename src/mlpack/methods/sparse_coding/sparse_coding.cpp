@@ -39,22 +39,27 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
+  Log::Debug << "Optimizing the codes of " << data.n_cols << " points."
+      << std::endl;
+
+  // The points are coded independently, so each thread codes its own points
+  // with its own LARS object; all of them share the Gram matrix.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      arma::vec code = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictionary, responses, code, false);
+    }
   }
 }
 
@@ -239,6 +244,56 @@ double SparseCoding::OptimizeDictionary(const arma::mat& data,
   return normGradient;
 }
 
+// Online dictionary learning step, with one mini-batch of points.
+void SparseCoding::OnlineUpdate(const arma::mat& batch)
+{
+  if (dictionary.n_rows != batch.n_rows || dictionary.n_cols != atoms)
+  {
+    std::ostringstream oss;
+    oss << "SparseCoding::OnlineUpdate(): the dictionary has size "
+        << dictionary.n_rows << " x " << dictionary.n_cols << ", but it must "
+        << "have size " << batch.n_rows << " x " << atoms << "; initialize it "
+        << "first!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (codeProducts.n_rows != atoms || dataCodeProducts.n_rows != batch.n_rows)
+  {
+    codeProducts.zeros(atoms, atoms);
+    dataCodeProducts.zeros(batch.n_rows, atoms);
+  }
+
+  arma::mat codes;
+  Encode(batch, codes);
+  codeProducts += codes * codes.t();
+  dataCodeProducts += batch * codes.t();
+
+  // Minimize the surrogate objective
+  //   0.5 tr(D^T D A) - tr(D^T B)   subject to ||D_j||_2 <= 1
+  // one atom at a time; each atom has a closed-form solution given the others.
+  // An atom that no code has used yet is left unchanged.
+  for (size_t j = 0; j < atoms; ++j)
+  {
+    const double weight = codeProducts(j, j);
+    if (weight <= 0.0)
+      continue;
+
+    arma::vec atom = dictionary.col(j) + (dataCodeProducts.col(j) -
+        dictionary * codeProducts.col(j)) / weight;
+    const double atomNorm = arma::norm(atom, 2);
+    if (atomNorm > 1)
+      atom /= atomNorm;
+    dictionary.col(j) = atom;
+  }
+}
+
+// Forget the online statistics.
+void SparseCoding::ResetOnlineStatistics()
+{
+  codeProducts.reset();
+  dataCodeProducts.reset();
+}
+
 // Project each atom of the dictionary back into the unit ball (if necessary).
 void SparseCoding::ProjectDictionary()
 {
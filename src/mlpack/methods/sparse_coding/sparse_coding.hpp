@@ -108,6 +108,25 @@ namespace sparse_coding {
  * Once a dictionary is trained with Train(), another matrix may be encoded with
  * the Encode() function.
  *
+ * For datasets that are too large to code in full at each iteration, the
+ * dictionary can instead be learned online with TrainOnline() or OnlineUpdate()
+ * (which processes one mini-batch of points at a time, for instance as they are
+ * read from disk).  These use the online dictionary learning algorithm of
+ * Mairal et al.: the products of the codes and points seen so far are summed
+ * into two small matrices, and after each mini-batch the atoms are updated by
+ * block coordinate descent on the surrogate objective given by those matrices.
+ *
+ * @code
+ * @inproceedings{mairal2009online,
+ *   title = {Online dictionary learning for sparse coding},
+ *   author = {Mairal, J. and Bach, F. and Ponce, J. and Sapiro, G.},
+ *   booktitle = {Proceedings of the 26th Annual International Conference on
+ *       Machine Learning (ICML 2009)},
+ *   pages = {689--696},
+ *   year = {2009}
+ * }
+ * @endcode
+ *
  * @tparam DictionaryInitializationPolicy The class to use to initialize the
  *     dictionary; must have 'void Initialize(const arma::mat& data, arma::mat&
  *     dictionary)' function.
@@ -185,6 +204,44 @@ class SparseCoding
                const DictionaryInitializer& initializer =
                    DictionaryInitializer());
 
+  /**
+   * Train the sparse coding model on the given dataset with online dictionary
+   * learning: after the dictionary is initialized, the points are processed in
+   * random mini-batches of the given size with OnlineUpdate(), for the given
+   * number of passes over the dataset.  The number of iterations and the
+   * tolerances of the model are not used.
+   *
+   * @param data Dataset to train on.
+   * @param batchSize Number of points in each mini-batch.
+   * @param passes Number of passes over the dataset.
+   * @param initializer The initializer to use.
+   */
+  template<typename DictionaryInitializer = DataDependentRandomInitializer>
+  void TrainOnline(const arma::mat& data,
+                   const size_t batchSize = 256,
+                   const size_t passes = 1,
+                   const DictionaryInitializer& initializer =
+                       DictionaryInitializer());
+
+  /**
+   * Update the dictionary with the given mini-batch of points: the points are
+   * encoded with the current dictionary, the products of the codes and points
+   * are added to the online statistics, and each atom is updated once by block
+   * coordinate descent.  The dictionary must already be initialized (by
+   * Train(), TrainOnline(), or through Dictionary()); call
+   * ResetOnlineStatistics() before the first mini-batch if the dictionary was
+   * set in some other way since the last online update.
+   *
+   * @param batch Mini-batch of points to learn from.
+   */
+  void OnlineUpdate(const arma::mat& batch);
+
+  /**
+   * Forget the points that online updates have seen, so that the next call to
+   * OnlineUpdate() starts learning from the current dictionary.
+   */
+  void ResetOnlineStatistics();
+
   /**
    * Sparse code each point in the given dataset via LARS, using the current
    * dictionary and store the encoded data in the codes matrix.
@@ -254,6 +311,11 @@ class SparseCoding
   //! Modify the tolerance for Newton's method (dictionary optimization step).
   double& NewtonTolerance() { return newtonTolerance; }
 
+  //! Get the sum of Z_i Z_i^T over the points seen by online updates.
+  const arma::mat& CodeProducts() const { return codeProducts; }
+  //! Get the sum of X_i Z_i^T over the points seen by online updates.
+  const arma::mat& DataCodeProducts() const { return dataCodeProducts; }
+
   //! Serialize the sparse coding model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -276,6 +338,12 @@ class SparseCoding
   double objTolerance;
   //! Tolerance for Newton's method (dictionary training).
   double newtonTolerance;
+
+  //! Sum of Z_i Z_i^T over the points seen by online updates (k x k).  (The
+  //! online statistics are not serialized.)
+  arma::mat codeProducts;
+  //! Sum of X_i Z_i^T over the points seen by online updates (d x k).
+  arma::mat dataCodeProducts;
 };
 
 } // namespace sparse_coding
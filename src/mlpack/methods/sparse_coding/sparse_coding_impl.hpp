@@ -47,8 +47,9 @@ double SparseCoding::Train(
   // Now, train.
   Timer::Start("sparse_coding");
 
-  // Initialize the dictionary.
+  // Initialize the dictionary; anything learned online before is forgotten.
   initializer.Initialize(data, atoms, dictionary);
+  ResetOnlineStatistics();
 
   double lastObjVal = DBL_MAX;
 
@@ -109,6 +110,42 @@ double SparseCoding::Train(
   return lastObjVal;
 }
 
+template<typename DictionaryInitializer>
+void SparseCoding::TrainOnline(
+    const arma::mat& data,
+    const size_t batchSize,
+    const size_t passes,
+    const DictionaryInitializer& initializer)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("SparseCoding::TrainOnline(): batchSize must "
+        "be positive!");
+  }
+
+  Timer::Start("sparse_coding");
+
+  // Initialize the dictionary, and forget anything learned before.
+  initializer.Initialize(data, atoms, dictionary);
+  ResetOnlineStatistics();
+
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    Log::Info << "Online dictionary learning pass " << (pass + 1) << " of "
+        << passes << "." << std::endl;
+
+    const arma::uvec order = arma::shuffle(
+        arma::linspace<arma::uvec>(0, data.n_cols - 1, data.n_cols));
+    for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize, (size_t) data.n_cols);
+      OnlineUpdate(data.cols(order.subvec(begin, end - 1)));
+    }
+  }
+
+  Timer::Stop("sparse_coding");
+}
+
 template<typename Archive>
 void SparseCoding::serialize(Archive& ar, const uint32_t /* version */)
 {
@@ -110,6 +110,34 @@ class SVDPlusPlus
              arma::vec& q,
              arma::mat& y);
 
+  /**
+   * Trains the model and obtains user/item matrices, user/item bias, and
+   * item implicit matrix, optimizing with the given optimizer instead of SGD;
+   * for instance, optimization::StratifiedSGD can be used to train with
+   * several threads.  The learning rate and number of iterations of this
+   * object are ignored.
+   *
+   * @param data Rating data matrix.
+   * @param implicitData Implicit feedback.
+   * @param rank Rank parameter to be used for optimization.
+   * @param u Item matrix obtained on decomposition.
+   * @param v User matrix obtained on decomposition.
+   * @param p Item bias.
+   * @param q User bias.
+   * @param y Item matrix with respect to implicit feedback.
+   * @param optimizer Optimizer to use.
+   */
+  template<typename OptType>
+  void Apply(const arma::mat& data,
+             const arma::mat& implicitData,
+             const size_t rank,
+             arma::mat& u,
+             arma::mat& v,
+             arma::vec& p,
+             arma::vec& q,
+             arma::mat& y,
+             OptType& optimizer);
+
   /**
    * Trains the model and obtains user/item matrices, user/item bias, and
    * item implicit matrix. Whether a user rates an item is used as implicit
@@ -103,6 +103,35 @@ class SVDPlusPlusFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Take one SGD step on the given rating, for the StratifiedSGD optimizer.
+   * Only the columns of the user and the item of the rating are written;
+   * the updates of the implicit item vectors of the user, which are shared
+   * with other users, are added to delayedUpdate instead.
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param i Index of the rating.
+   * @param stepSize Step size of the update.
+   * @param delayedUpdate Delayed update of the implicit item vectors
+   *     (rank x number of items); allocated if it is empty.
+   */
+  void StratifiedUpdate(arma::mat& parameters,
+                        const size_t i,
+                        const double stepSize,
+                        arma::mat& delayedUpdate) const;
+
+  /**
+   * Add the delayed update written by StratifiedUpdate() to the parameters,
+   * and reset it.
+   *
+   * @param parameters Parameters(user/item matrices, user/item bias,
+   *     item implicit matrix) of the decomposition.
+   * @param delayedUpdate Delayed update to apply.
+   */
+  void ApplyDelayedUpdate(arma::mat& parameters,
+                          arma::mat& delayedUpdate) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
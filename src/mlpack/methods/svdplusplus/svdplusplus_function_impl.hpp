@@ -285,6 +285,78 @@ void SVDPlusPlusFunction<MatType>::Gradient(const arma::mat& parameters,
   }
 }
 
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::StratifiedUpdate(
+    arma::mat& parameters,
+    const size_t i,
+    const double stepSize,
+    arma::mat& delayedUpdate) const
+{
+  if (delayedUpdate.is_empty())
+    delayedUpdate.zeros(rank, numItems);
+
+  const size_t user = data(0, i);
+  const size_t item = data(1, i) + numUsers;
+  const size_t implicitStart = numUsers + numItems;
+
+  // Calculate the error in the prediction.
+  const double rating = data(2, i);
+  const double userBias = parameters(rank, user);
+  const double itemBias = parameters(rank, item);
+
+  arma::vec userVec(rank, arma::fill::zeros);
+  arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+  arma::sp_mat::const_iterator itEnd = implicitData.end_col(user);
+  size_t implicitCount = 0;
+  for (; it != itEnd; ++it)
+  {
+    userVec += parameters.col(implicitStart + it.row()).subvec(0, rank - 1);
+    implicitCount += 1;
+  }
+  if (implicitCount != 0)
+    userVec /= std::sqrt(implicitCount);
+  userVec += parameters.col(user).subvec(0, rank - 1);
+
+  const double ratingError = rating - userBias - itemBias -
+      arma::dot(userVec, parameters.col(item).subvec(0, rank - 1));
+
+  // This is the same step as the one of the StandardSGD specialization, but
+  // the steps of the implicit item vectors are delayed, since other threads
+  // may be reading them.
+  it = implicitData.begin_col(user);
+  for (; it != itEnd; ++it)
+  {
+    delayedUpdate.col(it.row()) -= stepSize * 2.0 * (lambda / implicitCount *
+        parameters.col(implicitStart + it.row()).subvec(0, rank - 1) -
+        ratingError / std::sqrt(implicitCount) *
+        parameters.col(item).subvec(0, rank - 1));
+  }
+
+  parameters.col(user).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(user).subvec(0, rank - 1) -
+      ratingError * parameters.col(item).subvec(0, rank - 1));
+  parameters.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+      lambda * parameters.col(item).subvec(0, rank - 1) -
+      ratingError * userVec);
+  parameters(rank, user) -= stepSize * 2 * (
+      lambda * parameters(rank, user) - ratingError);
+  parameters(rank, item) -= stepSize * 2 * (
+      lambda * parameters(rank, item) - ratingError);
+}
+
+template <typename MatType>
+void SVDPlusPlusFunction<MatType>::ApplyDelayedUpdate(
+    arma::mat& parameters,
+    arma::mat& delayedUpdate) const
+{
+  if (delayedUpdate.is_empty())
+    return;
+
+  parameters.submat(0, numUsers + numItems, rank - 1,
+      numUsers + 2 * numItems - 1) += delayedUpdate;
+  delayedUpdate.zeros();
+}
+
 } // namespace svd
 } // namespace mlpack
 
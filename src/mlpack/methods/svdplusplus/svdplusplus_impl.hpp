@@ -44,16 +44,29 @@ void SVDPlusPlus<OptimizerType>::Apply(const arma::mat& data,
   Log::Warn << "The batch size for optimizing SVDPlusPlus is 1."
       << std::endl;
 
+  ens::StandardSGD optimizer(alpha, batchSize,
+      iterations * data.n_cols);
+  Apply(data, implicitData, rank, u, v, p, q, y, optimizer);
+}
+
+template<typename OptimizerType>
+template<typename OptType>
+void SVDPlusPlus<OptimizerType>::Apply(const arma::mat& data,
+                                       const arma::mat& implicitData,
+                                       const size_t rank,
+                                       arma::mat& u,
+                                       arma::mat& v,
+                                       arma::vec& p,
+                                       arma::vec& q,
+                                       arma::mat& y,
+                                       OptType& optimizer)
+{
   // Converts implicitData to the form of sparse matrix.
   arma::sp_mat cleanedData;
   CleanData(implicitData, cleanedData, data);
 
-  // Make the optimizer object using a SVDPlusPlusFunction object.
+  // Get optimized parameters using a SVDPlusPlusFunction object.
   SVDPlusPlusFunction<arma::mat> svdPPFunc(data, cleanedData, rank, lambda);
-  ens::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
-
-  // Get optimized parameters.
   arma::mat parameters = svdPPFunc.GetInitialPoint();
   optimizer.Optimize(svdPPFunc, parameters);
 
@@ -20,6 +20,7 @@
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/binary_cross_entropy_loss.hpp>
+#include <mlpack/methods/ann/loss_functions/sum_loss.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
 
@@ -495,6 +496,166 @@ TEST_CASE("GradientLinearLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-4);
 }
 
+/**
+ * Sampled softmax layer numerical gradient test.  The random seed is set before
+ * each evaluation, so that the same classes are sampled.
+ */
+TEST_CASE("GradientSampledSoftmaxLayerTest", "[ANNLayerTest]")
+{
+  // SampledSoftmax function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(10, 1)),
+        target(arma::mat("7"))
+    {
+      model = new FFN<SumLoss<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 10);
+      model->Add<SampledSoftmax<> >(10, 30, 5, arma::vec(arma::randu(30) +
+          0.1));
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      math::RandomSeed(42);
+      return model->EvaluateWithGradient(model->Parameters(), 0, gradient, 1);
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<SumLoss<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Make sure that the deterministic loss and the predictions of the sampled
+ * softmax layer are those of the full softmax.
+ */
+TEST_CASE("SampledSoftmaxFullSoftmaxTest", "[ANNLayerTest]")
+{
+  const size_t inSize = 10;
+  const size_t numClasses = 20;
+  arma::mat data = arma::randn(inSize, 30);
+  arma::mat labels(1, data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(numClasses);
+
+  FFN<SumLoss<>> model;
+  model.Add<SampledSoftmax<> >(inSize, numClasses, 5);
+  const double loss = model.Evaluate(data, labels);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  REQUIRE(predictions.n_rows == numClasses);
+  REQUIRE(predictions.n_cols == data.n_cols);
+
+  // The weights of class c are column c of the weight matrix.
+  const arma::mat weight(model.Parameters().memptr(), inSize, numClasses);
+  const arma::vec bias(model.Parameters().memptr() + weight.n_elem,
+      numClasses);
+  arma::mat scores = weight.t() * data;
+  scores.each_col() += bias;
+
+  double expectedLoss = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double maxScore = scores.col(i).max();
+    const double logSum = maxScore + std::log(arma::accu(arma::exp(
+        scores.col(i) - maxScore)));
+    expectedLoss += logSum - scores((size_t) labels[i], i);
+    for (size_t c = 0; c < numClasses; ++c)
+    {
+      REQUIRE(predictions(c, i) ==
+          Approx(scores(c, i) - logSum).epsilon(1e-7));
+    }
+  }
+
+  REQUIRE(loss == Approx(expectedLoss).epsilon(1e-7));
+}
+
+/**
+ * Hierarchical softmax layer numerical gradient test.
+ */
+TEST_CASE("GradientHierarchicalSoftmaxLayerTest", "[ANNLayerTest]")
+{
+  // HierarchicalSoftmax function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(10, 1)),
+        target(arma::mat("9"))
+    {
+      model = new FFN<SumLoss<>, NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 10);
+      model->Add<HierarchicalSoftmax<> >(10, 13);
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<SumLoss<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Make sure that the hierarchical softmax layer gives a distribution over the
+ * classes, and that its loss is the negative log-probability of the classes.
+ */
+TEST_CASE("HierarchicalSoftmaxProbabilityTest", "[ANNLayerTest]")
+{
+  const size_t numClasses = 13;
+  arma::mat data = arma::randn(10, 20);
+  arma::mat labels(1, data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(numClasses);
+
+  FFN<SumLoss<>> model;
+  model.Add<HierarchicalSoftmax<> >(10, numClasses);
+  const double loss = model.Evaluate(data, labels);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  REQUIRE(predictions.n_rows == numClasses);
+
+  double expectedLoss = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    REQUIRE(arma::accu(arma::exp(predictions.col(i))) ==
+        Approx(1.0).epsilon(1e-10));
+    expectedLoss -= predictions((size_t) labels[i], i);
+  }
+
+  REQUIRE(loss == Approx(expectedLoss).epsilon(1e-7));
+}
+
 /**
  * Simple Linear3D layer test.
  */
@@ -1503,6 +1664,64 @@ TEST_CASE("WriteCellStateParamLSTMLayerTest", "[ANNLayerTest]")
   }
 }
 
+/**
+ * Test the LSTM layer against a direct implementation of the LSTM equations,
+ * with random weights laid out as the stacked gates of the layer.
+ */
+TEST_CASE("StackedGatesLSTMLayerTest", "[ANNLayerTest]")
+{
+  const size_t rho = 5, inputSize = 4, outputSize = 3, batchSize = 6;
+
+  arma::cube input(inputSize, batchSize, rho, arma::fill::randn);
+
+  LSTM<> lstm(inputSize, outputSize, rho);
+  lstm.Parameters().randn();
+  lstm.Reset();
+  lstm.ResetCell(rho);
+
+  // The weights of the input, forget and output gates and the hidden layer are
+  // stacked, followed by their bias and the cell connections.
+  const arma::mat& parameters = lstm.Parameters();
+  const arma::mat weight(parameters.memptr(), 4 * outputSize,
+      inputSize + outputSize);
+  const arma::mat bias(parameters.memptr() + weight.n_elem, 4 * outputSize,
+      1);
+  const arma::mat cellWeight(parameters.memptr() + weight.n_elem + bias.n_elem,
+      outputSize, 3);
+
+  arma::mat outCalc = arma::zeros(outputSize, batchSize);
+  arma::mat cellCalc = arma::zeros(outputSize, batchSize);
+  arma::mat outLstm, cellLstm;
+  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  {
+    lstm.Forward(input.slice(seqNum), outLstm, cellLstm);
+
+    arma::mat gates = weight * arma::join_cols(input.slice(seqNum), outCalc);
+    gates.each_col() += bias;
+
+    arma::mat inputGate = gates.rows(0, outputSize - 1);
+    inputGate += cellCalc.each_col() % cellWeight.col(0);
+    inputGate = 1.0 / (1.0 + arma::exp(-inputGate));
+
+    arma::mat forgetGate = gates.rows(outputSize, 2 * outputSize - 1);
+    forgetGate += cellCalc.each_col() % cellWeight.col(1);
+    forgetGate = 1.0 / (1.0 + arma::exp(-forgetGate));
+
+    const arma::mat hidden = arma::tanh(gates.rows(3 * outputSize,
+        4 * outputSize - 1));
+    cellCalc = forgetGate % cellCalc + inputGate % hidden;
+
+    arma::mat outputGate = gates.rows(2 * outputSize, 3 * outputSize - 1);
+    outputGate += cellCalc.each_col() % cellWeight.col(2);
+    outputGate = 1.0 / (1.0 + arma::exp(-outputGate));
+
+    outCalc = outputGate % arma::tanh(cellCalc);
+
+    CheckMatrices(outLstm, outCalc, 1e-10);
+    CheckMatrices(cellLstm, cellCalc, 1e-10);
+  }
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * GRU layer work.
@@ -1669,6 +1888,40 @@ TEST_CASE("SimpleConcatLayerTest", "[ANNLayerTest]")
   REQUIRE(arma::accu(delta) == 0);
 }
 
+/**
+ * Make sure that the Concat layer gives each module its own rows of the error
+ * when the batch has several points.
+ */
+TEST_CASE("ConcatBatchTest", "[ANNLayerTest]")
+{
+  arma::mat output, input, error, delta;
+  Linear<>* moduleA = new Linear<>(10, 4);
+  moduleA->Parameters().randu();
+  moduleA->Reset();
+
+  Linear<>* moduleB = new Linear<>(10, 6);
+  moduleB->Parameters().randu();
+  moduleB->Reset();
+
+  Concat<> module;
+  module.Add(moduleA);
+  module.Add(moduleB);
+
+  input = arma::randu(10, 5);
+  module.Forward(input, output);
+  CheckMatrices(output, arma::join_cols(moduleA->OutputParameter(),
+      moduleB->OutputParameter()));
+
+  // The layer is run twice to make sure the buffers are reused correctly.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    error = arma::randu(10, 5);
+    module.Backward(input, error, delta);
+    CheckMatrices(delta, moduleA->Weight().t() * error.rows(0, 3) +
+        moduleB->Weight().t() * error.rows(4, 9));
+  }
+}
+
 /**
  * Test to check Concat layer along different axes.
  */
@@ -1981,6 +2234,59 @@ TEST_CASE("GradientLookupLayerTest", "[ANNLayerTest]")
   REQUIRE(CheckGradient(function) <= 1e-6);
 }
 
+/**
+ * The sparse gradient of a network with a Lookup layer is the same as the
+ * dense gradient, and it only has nonzero elements for the embeddings of the
+ * tokens of the batch.
+ */
+TEST_CASE("LookupLayerSparseGradientTest", "[ANNLayerTest]")
+{
+  const size_t seqLength = 5;
+  const size_t embeddingSize = 4;
+  const size_t vocabSize = 500;
+  const size_t batchSize = 8;
+
+  arma::mat input(seqLength, batchSize);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    input(i) = math::RandInt(1, 20);
+  arma::mat target = arma::zeros(10, batchSize);
+  for (size_t i = 0; i < batchSize; ++i)
+    target(math::RandInt(0, 10), i) = 1;
+
+  FFN<BCELoss<>, GlorotInitialization> model(BCELoss<>(1e-10, false));
+  model.Predictors() = input;
+  model.Responses() = target;
+  model.Add<Lookup<> >(vocabSize, embeddingSize);
+  model.Add<Linear<> >(embeddingSize * seqLength, 10);
+  model.Add<Softmax<> >();
+  model.ResetParameters();
+
+  arma::mat denseGradient;
+  const double denseObjective = model.EvaluateWithGradient(model.Parameters(),
+      0, denseGradient, batchSize);
+  arma::sp_mat sparseGradient;
+  const double sparseObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, sparseGradient, batchSize);
+
+  REQUIRE(sparseObjective == Approx(denseObjective).epsilon(1e-10));
+  CheckMatrices(denseGradient, arma::mat(sparseGradient));
+
+  // Only the embeddings of the first 20 tokens can be nonzero.
+  const size_t linearSize = (embeddingSize * seqLength + 1) * 10;
+  REQUIRE(sparseGradient.n_nonzero <= 20 * embeddingSize + linearSize);
+  for (arma::sp_mat::const_iterator it = sparseGradient.begin();
+       it != sparseGradient.end(); ++it)
+  {
+    if (it.row() < vocabSize * embeddingSize)
+      REQUIRE(it.row() < 20 * embeddingSize);
+  }
+
+  // Training with sparse gradients decreases the objective.
+  ens::StandardSGD optimizer(0.1, batchSize, 20 * batchSize);
+  model.TrainSparse(input, target, optimizer);
+  REQUIRE(model.Evaluate(model.Parameters(), 0, batchSize) < denseObjective);
+}
+
 /**
  * Test that the functions that can access the parameters of the
  * Lookup layer work.
@@ -2309,6 +2615,58 @@ TEST_CASE("BatchNormLayerParametersTest", "[ANNLayerTest]")
   CheckMatrices(layer.TrainingMean(), runningMean);
 }
 
+/**
+ * Test that the statistics of the BatchNorm layer are computed accurately for
+ * feature maps with a large offset, and that its backward pass matches the
+ * direct computation.
+ */
+TEST_CASE("BatchNormLargeOffsetTest", "[ANNLayerTest]")
+{
+  // Three feature maps of 4 x 4 elements, with a batch of 8 points.
+  const size_t maps = 3, mapSize = 16, batchSize = 8;
+  arma::mat input = arma::randn(maps * mapSize, batchSize) + 1e8;
+
+  BatchNorm<> layer(maps, 1e-5);
+  layer.Reset();
+
+  arma::mat output;
+  layer.Forward(input, output);
+
+  // Each feature map of the output has zero mean and unit variance; the
+  // elements of feature map c are rows c * mapSize to (c + 1) * mapSize - 1.
+  for (size_t c = 0; c < maps; ++c)
+  {
+    const arma::vec map = arma::vectorise(output.rows(c * mapSize,
+        (c + 1) * mapSize - 1));
+    REQUIRE(arma::mean(map) == Approx(0.0).margin(1e-6));
+    REQUIRE(arma::var(map, 1) == Approx(1.0).epsilon(1e-4));
+  }
+
+  // Compute the error of the input directly from the definition, for each
+  // element of the feature maps over the batch.
+  const arma::mat gy = arma::randn(maps * mapSize, batchSize);
+  arma::mat g;
+  layer.Backward(input, gy, g);
+
+  arma::mat expected(maps * mapSize, batchSize);
+  for (size_t c = 0; c < maps; ++c)
+  {
+    const arma::mat map = input.rows(c * mapSize, (c + 1) * mapSize - 1);
+    const arma::mat centered = map - arma::mean(arma::vectorise(map));
+    const double stdInv = 1.0 / std::sqrt(arma::mean(arma::vectorise(
+        arma::square(centered))) + 1e-5);
+    const arma::mat xHat = centered * stdInv;
+    const arma::mat norm = gy.rows(c * mapSize, (c + 1) * mapSize - 1);
+
+    arma::mat mapError = norm - xHat.each_col() % arma::sum(norm % xHat, 1);
+    mapError.each_col() -= arma::sum(norm, 1);
+    expected.rows(c * mapSize, (c + 1) * mapSize - 1) = stdInv / batchSize *
+        mapError;
+  }
+
+  CheckMatrices(g, expected, 1e-4);
+}
+
 /**
  * VirtualBatchNorm layer numerical gradient test.
  */
@@ -3736,6 +4094,83 @@ TEST_CASE("ConvolutionLayerPaddingTest", "[ANNLayerTest]")
   module2.Backward(input, output, delta);
 }
 
+/**
+ * Run the given layers, which should only differ in their convolution rules,
+ * on the same random input with the same random parameters, and check that
+ * they give the same output, delta and gradient.
+ */
+template<typename LayerType, typename OtherLayerType>
+void CheckSameConvolutionLayer(LayerType& layer,
+                               OtherLayerType& otherLayer,
+                               const size_t inputSize,
+                               const size_t batchSize)
+{
+  layer.Parameters().randu(layer.WeightSize(), 1);
+  otherLayer.Parameters() = layer.Parameters();
+  layer.Reset();
+  otherLayer.Reset();
+
+  arma::mat input(inputSize, batchSize, arma::fill::randu);
+  arma::mat output, otherOutput;
+  layer.Forward(input, output);
+  otherLayer.Forward(input, otherOutput);
+  CheckMatrices(output, otherOutput, 1e-8);
+
+  arma::mat error(output.n_rows, output.n_cols, arma::fill::randu);
+  arma::mat delta, otherDelta;
+  layer.Backward(output, error, delta);
+  otherLayer.Backward(otherOutput, error, otherDelta);
+  CheckMatrices(delta, otherDelta, 1e-8);
+
+  arma::mat gradient, otherGradient;
+  layer.Gradient(input, error, gradient);
+  otherLayer.Gradient(input, error, otherGradient);
+  CheckMatrices(gradient, otherGradient, 1e-8);
+}
+
+/**
+ * Test that Im2ColConvolution gives the same results as NaiveConvolution in the
+ * convolution layers, with several maps, points, strides and paddings.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef Convolution<NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>> NaiveConvolutionLayer;
+  typedef AtrousConvolution<NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>> NaiveAtrousConvolutionLayer;
+  typedef TransposedConvolution<NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<ValidConvolution>> NaiveTransposedConvolutionLayer;
+
+  for (size_t stride = 1; stride <= 2; ++stride)
+  {
+    for (size_t pad = 0; pad <= 1; ++pad)
+    {
+      NaiveConvolutionLayer naive(3, 4, 3, 3, stride, stride, pad, pad, 9, 9);
+      Convolution<> im2col(3, 4, 3, 3, stride, stride, pad, pad, 9, 9);
+      CheckSameConvolutionLayer(naive, im2col, 9 * 9 * 3, 5);
+
+      NaiveAtrousConvolutionLayer naiveAtrous(2, 3, 3, 3, stride, stride, pad,
+          pad, 11, 11, 2, 2);
+      AtrousConvolution<> im2colAtrous(2, 3, 3, 3, stride, stride, pad, pad,
+          11, 11, 2, 2);
+      CheckSameConvolutionLayer(naiveAtrous, im2colAtrous, 11 * 11 * 2, 4);
+    }
+  }
+
+  NaiveTransposedConvolutionLayer naiveTransposed(2, 3, 3, 3, 1, 1, 0, 0, 5,
+      5, 7, 7);
+  TransposedConvolution<> im2colTransposed(2, 3, 3, 3, 1, 1, 0, 0, 5, 5, 7, 7);
+  CheckSameConvolutionLayer(naiveTransposed, im2colTransposed, 5 * 5 * 2, 3);
+
+  NaiveTransposedConvolutionLayer naiveStrided(2, 3, 3, 3, 2, 2, 1, 1, 3, 3,
+      5, 5);
+  TransposedConvolution<> im2colStrided(2, 3, 3, 3, 2, 2, 1, 1, 3, 3, 5, 5);
+  CheckSameConvolutionLayer(naiveStrided, im2colStrided, 3 * 3 * 2, 3);
+}
+
 /**
  * Test that the padding options in Transposed Convolution layer.
  */
@@ -4019,6 +4454,74 @@ TEST_CASE("MaxPoolingTestCase", "[ANNLayerTest]")
   REQUIRE(output.n_cols == 1);
 }
 
+/**
+ * Check the pooling kernels against a direct computation, and their backward
+ * passes with the Jacobian test, for the 2x2 stride 2 special case (with a
+ * border window) and for the general case, over several channels.
+ */
+TEST_CASE("PoolingKernelsTest", "[ANNLayerTest]")
+{
+  const size_t inputWidth = 7;
+  const size_t inputHeight = 5;
+  const size_t channels = 3;
+
+  arma::mat input = arma::randu(inputWidth * inputHeight * channels, 1);
+  arma::cube inputCube(input.memptr(), inputWidth, inputHeight, channels,
+      false, true);
+
+  // Each pair is (kernel size, stride); the output is rounded up.
+  const size_t settings[2][2] = { { 2, 2 }, { 3, 2 } };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    const size_t kernel = settings[t][0];
+    const size_t stride = settings[t][1];
+    const size_t outputWidth = std::ceil((inputWidth - (double) kernel) /
+        stride + 1);
+    const size_t outputHeight = std::ceil((inputHeight - (double) kernel) /
+        stride + 1);
+
+    arma::cube maxResult(outputWidth, outputHeight, channels);
+    arma::cube meanResult(outputWidth, outputHeight, channels);
+    arma::cube lpResult(outputWidth, outputHeight, channels);
+    for (size_t s = 0; s < channels; ++s)
+    {
+      for (size_t j = 0; j < outputHeight; ++j)
+      {
+        for (size_t i = 0; i < outputWidth; ++i)
+        {
+          const arma::mat window = inputCube.slice(s).submat(i * stride,
+              j * stride, std::min(i * stride + kernel, inputWidth) - 1,
+              std::min(j * stride + kernel, inputHeight) - 1);
+          maxResult(i, j, s) = window.max();
+          meanResult(i, j, s) = arma::mean(arma::vectorise(window));
+          lpResult(i, j, s) = arma::norm(arma::vectorise(window), 2);
+        }
+      }
+    }
+
+    MaxPooling<> maxModule(kernel, kernel, stride, stride, false);
+    MeanPooling<> meanModule(kernel, kernel, stride, stride, false);
+    LpPooling<> lpModule(2, kernel, kernel, stride, stride, false);
+    maxModule.InputWidth() = meanModule.InputWidth() =
+        lpModule.InputWidth() = inputWidth;
+    maxModule.InputHeight() = meanModule.InputHeight() =
+        lpModule.InputHeight() = inputHeight;
+
+    arma::mat output;
+    maxModule.Forward(input, output);
+    CheckMatrices(output, arma::vectorise(maxResult));
+    meanModule.Forward(input, output);
+    CheckMatrices(output, arma::vectorise(meanResult));
+    lpModule.Forward(input, output);
+    CheckMatrices(output, arma::vectorise(lpResult));
+
+    arma::mat jacobianInput(input.n_rows, 1);
+    REQUIRE(JacobianTest(maxModule, jacobianInput) <= 1e-5);
+    REQUIRE(JacobianTest(meanModule, jacobianInput) <= 1e-5);
+    REQUIRE(JacobianTest(lpModule, jacobianInput) <= 1e-5);
+  }
+}
+
 /**
  * Test that the functions that can modify and access the parameters of the
  * Glimpse layer work.
@@ -5027,6 +5530,69 @@ TEST_CASE("JacobianMultiheadAttentionTest", "[ANNLayerTest]")
   }
 }
 
+/**
+ * Make sure that the tiled MultiheadAttention computes the same results as
+ * the MultiheadAttention storing all the scores, including when the tile size
+ * does not divide the target sequence length.
+ */
+TEST_CASE("TiledMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 7;
+  const size_t srcSeqLen = 5;
+  const size_t embedDim = 6;
+  const size_t numHeads = 3;
+  const size_t batchSize = 4;
+
+  arma::mat attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
+  for (size_t i = 0; i < tgtSeqLen; ++i)
+  {
+    for (size_t j = i + 1; j < srcSeqLen; ++j)
+      attnMask(i, j) = std::numeric_limits<double>::lowest();
+  }
+
+  arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+  keyPaddingMask(srcSeqLen - 1) = std::numeric_limits<double>::lowest();
+
+  MultiheadAttention<> module(tgtSeqLen, srcSeqLen, embedDim, numHeads);
+  module.Parameters().randu();
+  module.Reset();
+  module.AttentionMask() = attnMask;
+  module.KeyPaddingMask() = keyPaddingMask;
+
+  MultiheadAttention<> tiledModule(tgtSeqLen, srcSeqLen, embedDim, numHeads,
+      3);
+  REQUIRE(tiledModule.TileSize() == 3);
+  tiledModule.Parameters() = module.Parameters();
+  tiledModule.Reset();
+  tiledModule.AttentionMask() = attnMask;
+  tiledModule.KeyPaddingMask() = keyPaddingMask;
+
+  arma::mat input = arma::randu(embedDim * (tgtSeqLen + 2 * srcSeqLen),
+      batchSize);
+  arma::mat gy = arma::randu(embedDim * tgtSeqLen, batchSize);
+
+  arma::mat output, tiledOutput;
+  module.Forward(input, output);
+  tiledModule.Forward(input, tiledOutput);
+  CheckMatrices(output, tiledOutput, 1e-8);
+
+  arma::mat g, tiledG;
+  module.Backward(input, gy, g);
+  tiledModule.Backward(input, gy, tiledG);
+  CheckMatrices(g, tiledG, 1e-8);
+
+  arma::mat gradient, tiledGradient;
+  module.Gradient(input, gy, gradient);
+  tiledModule.Gradient(input, gy, tiledGradient);
+  CheckMatrices(gradient, tiledGradient, 1e-8);
+
+  // The tiled layer must also pass the Jacobian test.
+  MultiheadAttention<> smallModule(4, 3, 4, 2, 3);
+  smallModule.Parameters().randu();
+  arma::mat smallInput = arma::randu(4 * (4 + 2 * 3), 1);
+  REQUIRE(JacobianTest(smallModule, smallInput) <= 1e-5);
+}
+
 /**
  * Numerical gradient test for MultiheadAttention layer.
  */
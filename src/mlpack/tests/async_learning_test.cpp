@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/sigmoid_cross_entropy_error.hpp>
+#include <mlpack/methods/reinforcement_learning/actor_learner.hpp>
 #include <mlpack/methods/reinforcement_learning/async_learning.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
@@ -247,3 +248,73 @@ TEST_CASE("NStepQLearningTest", "[AsyncLearningTest]")
   agent.Train(measure);
   Log::Debug << "Total test episodes: " << testEpisodes << std::endl;
 }
+
+// Test the actor-learner architecture with batched inference in Cart Pole.
+TEST_CASE("ActorLearnerTest", "[AsyncLearningTest]")
+{
+  bool success = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 128);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(128, 2);
+
+    // Set up the policy and the replay memory shared by the actors.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+    ConcurrentReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.NumWorkers() = 4;
+    config.UpdateInterval() = 1;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.StepLimit() = 200;
+
+    ActorLearner<CartPole, decltype(model), ens::AdamUpdate,
+        decltype(policy)> agent(std::move(config), std::move(model),
+        std::move(policy), replayMethod);
+
+    arma::vec rewards(50, arma::fill::zeros);
+    size_t pos = 0;
+    size_t episodes = 0;
+    auto measure = [&rewards, &pos, &episodes](double reward)
+    {
+      if (episodes > 2000)
+        return true; // Fake convergence...
+      episodes++;
+      rewards[pos++] = reward;
+      pos %= rewards.n_elem;
+      double avgReward = arma::mean(rewards);
+      Log::Debug << "Average return: " << avgReward
+          << " Episode return: " << reward << std::endl;
+      return (avgReward > 40);
+    };
+
+    agent.Train(measure);
+    Log::Debug << "Total episodes: " << episodes << std::endl;
+
+    // Every action was selected in a batch of at least one state, and every
+    // transition was stored.
+    REQUIRE(agent.TotalSteps() > 0);
+    REQUIRE(agent.InferenceBatches() > 0);
+    REQUIRE(agent.InferenceBatches() <= agent.TotalSteps() + 4);
+    REQUIRE(replayMethod.Size() == std::min(agent.TotalSteps(),
+        (size_t) 10000));
+    REQUIRE(std::isfinite(agent.Episode()));
+
+    if (arma::mean(rewards) > 40)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
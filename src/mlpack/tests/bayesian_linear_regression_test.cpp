@@ -193,3 +193,39 @@ TEST_CASE("EqualtoRidge", "[BayesianLinearRegressionTest]")
 
   REQUIRE(trial <= 3);
 }
+
+// Check that training on some points and updating the model with the others
+// gives the model trained on all the points.
+TEST_CASE("BayesianLinearRegressionUpdateTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 3000, 10, 0.5);
+
+  BayesianLinearRegression full(true, true);
+  full.Train(matX, y);
+
+  BayesianLinearRegression incremental(true, true);
+  incremental.Train(matX.cols(0, 1199), y.subvec(0, 1199));
+  REQUIRE(incremental.NumPoints() == 1200);
+  incremental.Update(matX.cols(1200, 2999), y.subvec(1200, 2999));
+  REQUIRE(incremental.NumPoints() == 3000);
+
+  REQUIRE(incremental.Alpha() == Approx(full.Alpha()).epsilon(1e-6));
+  REQUIRE(incremental.Beta() == Approx(full.Beta()).epsilon(1e-6));
+  REQUIRE(incremental.ResponsesOffset() ==
+      Approx(full.ResponsesOffset()).epsilon(1e-8));
+  for (size_t i = 0; i < full.Omega().n_elem; ++i)
+  {
+    REQUIRE(incremental.Omega()[i] == Approx(full.Omega()[i]).epsilon(1e-6));
+    REQUIRE(incremental.DataOffset()[i] ==
+        Approx(full.DataOffset()[i]).margin(1e-8));
+    REQUIRE(incremental.DataScale()[i] ==
+        Approx(full.DataScale()[i]).epsilon(1e-8));
+  }
+
+  // The new points must have the dimensionality of the model.
+  REQUIRE_THROWS_AS(incremental.Update(arma::randn(5, 10),
+      arma::randn<arma::rowvec>(10)), std::invalid_argument);
+}
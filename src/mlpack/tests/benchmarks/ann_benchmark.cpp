@@ -0,0 +1,121 @@
+/**
+ * @file tests/benchmarks/ann_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of feedforward, convolutional
+ * and recurrent networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Benchmark the forward pass, and the forward and backward passes, of the
+ * given network on the given batch.
+ */
+template<typename NetworkType>
+void BenchmarkFFN(const std::string& name,
+                  NetworkType& model,
+                  const arma::mat& input,
+                  const arma::mat& target)
+{
+  arma::mat output, gradient;
+
+  BENCHMARK(name + " forward")
+  {
+    model.Forward(input, output);
+    return output.n_elem;
+  };
+
+  BENCHMARK(name + " forward and backward")
+  {
+    model.Forward(input, output);
+    return model.Backward(input, target, gradient);
+  };
+}
+
+TEST_CASE("FFNBenchmark", "[ANNBenchmark]")
+{
+  math::RandomSeed(42);
+  const arma::mat input = arma::randu<arma::mat>(100, 256);
+  const arma::mat target = arma::randu<arma::mat>(10, 256);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<>>(100, 200);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(200, 200);
+  model.Add<ReLULayer<>>();
+  model.Add<Linear<>>(200, 10);
+  model.ResetParameters();
+
+  BenchmarkFFN("FFN", model, input, target);
+
+  const arma::mat trainTarget = arma::randu<arma::mat>(10, 1024);
+  const arma::mat trainInput = arma::randu<arma::mat>(100, 1024);
+  BENCHMARK("FFN training epoch")
+  {
+    ens::StandardSGD opt(0.01, 32, trainInput.n_cols, -1, false);
+    return model.Train(trainInput, trainTarget, opt);
+  };
+}
+
+TEST_CASE("CNNBenchmark", "[ANNBenchmark]")
+{
+  math::RandomSeed(42);
+  // A batch of 64 28x28 images.
+  const arma::mat input = arma::randu<arma::mat>(28 * 28, 64);
+  const arma::mat target = arma::randu<arma::mat>(10, 64);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Convolution<>>(1, 8, 5, 5, 1, 1, 0, 0, 28, 28);
+  model.Add<ReLULayer<>>();
+  model.Add<MaxPooling<>>(8, 8, 2, 2);
+  model.Add<Convolution<>>(8, 12, 2, 2);
+  model.Add<ReLULayer<>>();
+  model.Add<MaxPooling<>>(2, 2, 2, 2);
+  model.Add<Linear<>>(192, 10);
+  model.ResetParameters();
+
+  BenchmarkFFN("CNN", model, input, target);
+}
+
+TEST_CASE("LSTMBenchmark", "[ANNBenchmark]")
+{
+  math::RandomSeed(42);
+  // A batch of 32 sequences of 20 steps.
+  const size_t rho = 20;
+  const arma::cube input = arma::randu<arma::cube>(10, 32, rho);
+  const arma::cube target = arma::randu<arma::cube>(1, 32, rho);
+
+  RNN<MeanSquaredError<>> model(rho);
+  model.Add<Linear<>>(10, 32);
+  model.Add<LSTM<>>(32, 32, rho);
+  model.Add<Linear<>>(32, 1);
+  model.Reset();
+
+  arma::cube output;
+  BENCHMARK("LSTM forward")
+  {
+    model.Predict(input, output);
+    return output.n_elem;
+  };
+
+  BENCHMARK("LSTM training epoch")
+  {
+    ens::StandardSGD opt(0.01, 32, input.n_cols, -1, false);
+    return model.Train(input, target, opt);
+  };
+}
@@ -0,0 +1,66 @@
+/**
+ * @file tests/benchmarks/benchmark_data.hpp
+ *
+ * Fixed synthetic datasets for the benchmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_BENCHMARKS_BENCHMARK_DATA_HPP
+#define MLPACK_TESTS_BENCHMARKS_BENCHMARK_DATA_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace benchmarks {
+
+/**
+ * Generate a dataset of Gaussian clusters with the given seed, so that every
+ * run of a benchmark uses the same data no matter which benchmarks ran
+ * before.
+ *
+ * @param dimensionality Number of dimensions of the points.
+ * @param numPoints Number of points.
+ * @param numClusters Number of clusters.
+ * @param dataset Matrix to store the points in.
+ * @param labels Vector to store the cluster of each point in.
+ * @param seed Seed of the random number generator.
+ */
+inline void ClusteredData(const size_t dimensionality,
+                          const size_t numPoints,
+                          const size_t numClusters,
+                          arma::mat& dataset,
+                          arma::Row<size_t>& labels,
+                          const size_t seed = 42)
+{
+  math::RandomSeed(seed);
+
+  const arma::mat centroids = 10.0 * arma::randu<arma::mat>(dimensionality,
+      numClusters);
+  dataset = arma::randn<arma::mat>(dimensionality, numPoints);
+  labels.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    labels[i] = i % numClusters;
+    dataset.col(i) += centroids.col(labels[i]);
+  }
+}
+
+//! Generate a dataset of Gaussian clusters, without labels.
+inline arma::mat ClusteredData(const size_t dimensionality,
+                               const size_t numPoints,
+                               const size_t numClusters,
+                               const size_t seed = 42)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ClusteredData(dimensionality, numPoints, numClusters, dataset, labels, seed);
+  return dataset;
+}
+
+} // namespace benchmarks
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file tests/benchmarks/clustering_benchmark.cpp
+ *
+ * Benchmarks of the k-means variants and of GMM training with EM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/yinyang_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::kmeans;
+using namespace mlpack::gmm;
+
+/**
+ * Benchmark the given Lloyd step type, starting from the same centroids every
+ * time.
+ */
+template<template<class, class> class LloydStepType>
+void BenchmarkKMeans(const std::string& name,
+                     const arma::mat& dataset,
+                     const arma::mat& initialCentroids)
+{
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType> kmeans(10);
+  arma::Row<size_t> assignments;
+
+  BENCHMARK(name + " k-means")
+  {
+    arma::mat centroids(initialCentroids);
+    kmeans.Cluster(dataset, centroids.n_cols, assignments, centroids, false,
+        true);
+    return centroids.n_elem;
+  };
+}
+
+TEST_CASE("KMeansBenchmark", "[ClusteringBenchmark]")
+{
+  const arma::mat dataset = ClusteredData(5, 20000, 20);
+  const arma::mat initialCentroids = dataset.cols(0, 19);
+
+  BenchmarkKMeans<NaiveKMeans>("naive", dataset, initialCentroids);
+  BenchmarkKMeans<ElkanKMeans>("Elkan", dataset, initialCentroids);
+  BenchmarkKMeans<HamerlyKMeans>("Hamerly", dataset, initialCentroids);
+  BenchmarkKMeans<YinyangKMeans>("Yinyang", dataset, initialCentroids);
+  BenchmarkKMeans<PellegMooreKMeans>("Pelleg-Moore", dataset,
+      initialCentroids);
+  BenchmarkKMeans<DefaultDualTreeKMeans>("dual-tree", dataset,
+      initialCentroids);
+  BenchmarkKMeans<CoverTreeDualTreeKMeans>("cover tree dual-tree", dataset,
+      initialCentroids);
+}
+
+TEST_CASE("GMMEMBenchmark", "[ClusteringBenchmark]")
+{
+  const arma::mat dataset = ClusteredData(5, 10000, 5);
+
+  BENCHMARK("GMM EM training")
+  {
+    // The same initial model is used by every run.
+    math::RandomSeed(42);
+    GMM gmm(5, 5);
+    return gmm.Train(dataset, 1);
+  };
+}
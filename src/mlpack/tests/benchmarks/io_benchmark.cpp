@@ -0,0 +1,88 @@
+/**
+ * @file tests/benchmarks/io_benchmark.cpp
+ *
+ * Benchmarks of dataset loading and of model serialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+TEST_CASE("LoadBenchmark", "[IOBenchmark]")
+{
+  const arma::mat dataset = ClusteredData(20, 50000, 10);
+  data::Save("benchmark_data.csv", dataset, true);
+  data::Save("benchmark_data.bin", dataset, true);
+
+  arma::mat loaded;
+  BENCHMARK("CSV load")
+  {
+    data::Load("benchmark_data.csv", loaded, true);
+    return loaded.n_elem;
+  };
+
+  BENCHMARK("CSV save")
+  {
+    return data::Save("benchmark_data.csv", dataset, true);
+  };
+
+  BENCHMARK("binary load")
+  {
+    data::Load("benchmark_data.bin", loaded, true);
+    return loaded.n_elem;
+  };
+
+  remove("benchmark_data.csv");
+  remove("benchmark_data.bin");
+}
+
+/**
+ * Benchmark saving and loading the given model in each format.
+ */
+template<typename ModelType>
+void BenchmarkSerialization(const std::string& name, ModelType& model)
+{
+  const std::string formats[] = { "bin", "xml", "json" };
+  for (const std::string& format : formats)
+  {
+    const std::string filename = "benchmark_model." + format;
+
+    BENCHMARK(name + " save (" + format + ")")
+    {
+      return data::Save(filename, "model", model, true);
+    };
+
+    ModelType loaded;
+    BENCHMARK(name + " load (" + format + ")")
+    {
+      return data::Load(filename, "model", loaded, true);
+    };
+
+    remove(filename.c_str());
+  }
+}
+
+TEST_CASE("SerializationBenchmark", "[IOBenchmark]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ClusteredData(10, 10000, 5, dataset, labels);
+
+  math::RandomSeed(42);
+  tree::RandomForest<> forest(dataset, labels, 5, 20);
+  BenchmarkSerialization("random forest", forest);
+
+  neighbor::KNN knn(dataset);
+  BenchmarkSerialization("kNN model", knn);
+}
@@ -0,0 +1,33 @@
+/**
+ * @file tests/benchmarks/main.cpp
+ *
+ * Main file for the Catch benchmarks of mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <iostream>
+#include <mlpack/core.hpp>
+
+#define CATCH_CONFIG_RUNNER  // we will define main()
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+
+int main(int argc, char** argv)
+{
+  // The synthetic datasets of the benchmarks are generated from a fixed seed,
+  // so that the results of different runs can be compared.
+  mlpack::math::RandomSeed(42);
+
+  mlpack::Log::Info.ignoreInput = true;
+  mlpack::Log::Warn.ignoreInput = true;
+
+  std::cout << "mlpack version: " << mlpack::util::GetVersion() << std::endl;
+  std::cout << "armadillo version: " << arma::arma_version::as_string()
+      << std::endl;
+
+  // Use "-r xml" or "-r junit" to get machine-readable results.
+  return Catch::Session().run(argc, argv);
+}
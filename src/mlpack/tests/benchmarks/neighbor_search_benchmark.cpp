@@ -0,0 +1,84 @@
+/**
+ * @file tests/benchmarks/neighbor_search_benchmark.cpp
+ *
+ * Benchmarks of k-nearest-neighbor search with different trees and leaf sizes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+/**
+ * Benchmark the tree building and the search of the given NeighborSearch type.
+ */
+template<typename NSType>
+void BenchmarkKNN(const std::string& name,
+                  const arma::mat& dataset,
+                  const NeighborSearchMode mode)
+{
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  BENCHMARK(name + " build")
+  {
+    return NSType(dataset, mode).ReferenceSet().n_cols;
+  };
+
+  NSType knn(dataset, mode);
+  BENCHMARK(name + " search")
+  {
+    knn.Search(5, neighbors, distances);
+    return neighbors.n_elem;
+  };
+}
+
+TEST_CASE("KNNTreeBenchmark", "[KNNBenchmark]")
+{
+  const arma::mat dataset = ClusteredData(5, 10000, 10);
+
+  BenchmarkKNN<KNN>("kd-tree dual-tree", dataset, DUAL_TREE_MODE);
+  BenchmarkKNN<KNN>("kd-tree single-tree", dataset, SINGLE_TREE_MODE);
+  BenchmarkKNN<NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::mat, BallTree>>("ball tree dual-tree", dataset, DUAL_TREE_MODE);
+  BenchmarkKNN<NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::mat, StandardCoverTree>>("cover tree dual-tree", dataset,
+      DUAL_TREE_MODE);
+  BenchmarkKNN<NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::mat, RTree>>("R tree dual-tree", dataset, DUAL_TREE_MODE);
+  BenchmarkKNN<NeighborSearch<NearestNeighborSort, metric::EuclideanDistance,
+      arma::mat, Octree>>("octree dual-tree", dataset, DUAL_TREE_MODE);
+}
+
+TEST_CASE("KNNLeafSizeBenchmark", "[KNNBenchmark]")
+{
+  const arma::mat dataset = ClusteredData(5, 10000, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  const size_t leafSizes[] = { 1, 10, 40, 100 };
+  for (const size_t leafSize : leafSizes)
+  {
+    typedef KNN::Tree Tree;
+    std::vector<size_t> oldFromNew;
+    Tree tree(dataset, oldFromNew, leafSize);
+    KNN knn(std::move(tree), DUAL_TREE_MODE);
+
+    BENCHMARK("kd-tree leaf size " + std::to_string(leafSize) + " search")
+    {
+      knn.Search(5, neighbors, distances);
+      return neighbors.n_elem;
+    };
+  }
+}
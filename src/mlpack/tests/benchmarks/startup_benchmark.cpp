@@ -0,0 +1,52 @@
+/**
+ * @file tests/benchmarks/startup_benchmark.cpp
+ *
+ * Benchmarks of the startup time of the command-line programs whose models
+ * are compiled into libmlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <cstdlib>
+#include <fstream>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+
+/**
+ * Benchmark running the given program with --version, which only loads the
+ * program and its libraries and parses the parameters.  The program is
+ * skipped if it wasn't built.
+ */
+void BenchmarkStartup(const std::string& program)
+{
+  const std::string path = std::string(MLPACK_BINARY_DIR) + "/" + program;
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+  {
+    WARN(path << " was not found; build it to benchmark its startup time.");
+    return;
+  }
+
+  std::cout << program << ": " << file.tellg() << " bytes." << std::endl;
+  #ifdef _WIN32
+  const std::string command = "\"" + path + "\" --version > NUL";
+  #else
+  const std::string command = "\"" + path + "\" --version > /dev/null";
+  #endif
+  BENCHMARK(program + " startup")
+  {
+    return std::system(command.c_str());
+  };
+}
+
+TEST_CASE("BindingStartupBenchmark", "[StartupBenchmark]")
+{
+  BenchmarkStartup("mlpack_knn");
+  BenchmarkStartup("mlpack_kfn");
+  BenchmarkStartup("mlpack_kde");
+  BenchmarkStartup("mlpack_random_forest");
+}
@@ -0,0 +1,66 @@
+/**
+ * @file tests/benchmarks/tree_learner_benchmark.cpp
+ *
+ * Benchmarks of decision tree and random forest training and prediction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "../catch.hpp"
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::tree;
+
+TEST_CASE("DecisionTreeBenchmark", "[TreeLearnerBenchmark]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ClusteredData(10, 20000, 5, dataset, labels);
+
+  BENCHMARK("decision tree training")
+  {
+    DecisionTree<> tree(dataset, labels, 5);
+    return tree.NumChildren();
+  };
+
+  DecisionTree<> tree(dataset, labels, 5);
+  arma::Row<size_t> predictions;
+  BENCHMARK("decision tree prediction")
+  {
+    tree.Classify(dataset, predictions);
+    return predictions.n_elem;
+  };
+}
+
+TEST_CASE("RandomForestBenchmark", "[TreeLearnerBenchmark]")
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ClusteredData(10, 20000, 5, dataset, labels);
+
+  BENCHMARK("random forest training")
+  {
+    // The bootstrap samples are the same in every run.
+    math::RandomSeed(42);
+    RandomForest<> forest(dataset, labels, 5, 20);
+    return forest.NumTrees();
+  };
+
+  math::RandomSeed(42);
+  RandomForest<> forest(dataset, labels, 5, 20);
+  arma::Row<size_t> predictions;
+  BENCHMARK("random forest prediction")
+  {
+    forest.Classify(dataset, predictions);
+    return predictions.n_elem;
+  };
+}
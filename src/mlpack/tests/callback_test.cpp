@@ -226,7 +226,7 @@ TEST_CASE("SRWithOptimizerCallback", "[CallbackTest]")
   ens::StandardSGD sgd(0.1, 1, 5);
   std::stringstream stream;
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
   sr.Train(data, labels, numClasses, sgd, ens::ProgressBar(70, stream));
 
   REQUIRE(stream.str().length() > 0);
@@ -279,3 +279,73 @@ TEST_CASE("SparseAutoencodeCallbackTest", "[CallbackTest]")
   mlpack::nn::SparseAutoencoder encoder2(data1, 5, 1, 0, 0, 0 , optimizer, cb);
   REQUIRE(cb.BestObjective() > 0);
 }
+
+/**
+ * Make sure the TrainingProfiler callback records every step of the training
+ * of a FFN model, the time of its layers, and that it can be saved as JSON.
+ */
+TEST_CASE("FFNTrainingProfilerTest", "[CallbackTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+  arma::mat labels = arma::randu<arma::mat>(1, 100);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<>>(5, 8);
+  model.Add<SigmoidLayer<>>();
+  model.Add<Linear<>>(8, 1);
+
+  // Two epochs of ten batches of ten points.
+  ens::StandardSGD opt(0.01, 10, 200);
+  TrainingProfiler profiler;
+  model.Train(data, labels, opt, profiler);
+
+  REQUIRE(profiler.NumSteps() == 20);
+  REQUIRE(profiler.Steps().size() == 20);
+  REQUIRE(profiler.Points() == 200);
+  for (size_t i = 0; i < profiler.Steps().size(); ++i)
+  {
+    REQUIRE(profiler.Steps()[i].points == 10);
+    REQUIRE(profiler.Steps()[i].evaluationTime <= profiler.Steps()[i].time);
+  }
+  REQUIRE(profiler.Epochs().size() >= 1);
+
+  REQUIRE(profiler.LayerForwardTime().size() == 3);
+  REQUIRE(profiler.LayerBackwardTime().size() == 3);
+  REQUIRE(arma::accu(arma::vec(profiler.LayerForwardTime())) > 0);
+  REQUIRE(profiler.Time() > 0);
+  REQUIRE(profiler.EvaluationTime() <= profiler.Time());
+  REQUIRE(profiler.PointsPerSecond() > 0);
+
+  // The network doesn't record its passes after the training.
+  REQUIRE(!model.Profile().Enabled());
+
+  REQUIRE(data::Save("training_profile.json", "profile", profiler));
+  std::ifstream stream("training_profile.json");
+  const std::string json((std::istreambuf_iterator<char>(stream)),
+      std::istreambuf_iterator<char>());
+  REQUIRE(json.find("pointsPerSecond") != std::string::npos);
+  REQUIRE(json.find("layerForwardTime") != std::string::npos);
+  stream.close();
+  remove("training_profile.json");
+}
+
+/**
+ * Make sure the TrainingProfiler callback uses the batch size of the optimizer
+ * for functions that don't record their passes.
+ */
+TEST_CASE("LRTrainingProfilerTest", "[CallbackTest]")
+{
+  arma::mat data("1 2 3;"
+                 "1 2 3");
+  arma::Row<size_t> responses("1 1 0");
+
+  ens::StandardSGD sgd(0.1, 1, 5);
+  LogisticRegression<> logisticRegression(data, responses, sgd, 0.001);
+  TrainingProfiler profiler;
+  logisticRegression.Train<ens::StandardSGD>(data, responses, sgd, profiler);
+
+  REQUIRE(profiler.NumSteps() > 0);
+  REQUIRE(profiler.Points() == profiler.NumSteps());
+  REQUIRE(profiler.EvaluationTime() == 0);
+  REQUIRE(profiler.LayerForwardTime().empty());
+}
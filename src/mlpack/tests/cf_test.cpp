@@ -29,6 +29,7 @@
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/cosine_search.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/pearson_search.hpp>
+#include <mlpack/methods/cf/neighbor_search_policies/lsh_euclidean_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/similarity_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/regression_interpolation.hpp>
@@ -786,6 +787,44 @@ TEST_CASE("CFPredictSVDPPTest", "[CFTest]")
   CFPredict<SVDPlusPlusPolicy>();
 }
 
+/**
+ * Make sure that an SVDPlusPlus model loaded for prediction only makes the
+ * same predictions, without its implicit data, and can't be saved again.
+ */
+TEST_CASE("CFPredictionOnlySVDPPTest", "[CFTest]")
+{
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  SVDPlusPlusPolicy decomposition;
+  CFType<SVDPlusPlusPolicy> c(dataset, decomposition, 5, 5, 30);
+  REQUIRE(data::Save("cf_svdpp_model.bin", "model", c, true));
+
+  CFType<SVDPlusPlusPolicy> p;
+  REQUIRE(data::Load("cf_svdpp_model.bin", "model", p, true,
+      data::format::autodetect, true));
+  remove("cf_svdpp_model.bin");
+
+  REQUIRE(p.Decomposition().PredictionOnly());
+  REQUIRE(p.Decomposition().Y().n_elem == 0);
+  REQUIRE(p.Decomposition().ImplicitData().n_nonzero == 0);
+
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+  {
+    REQUIRE(p.Predict(savedCols(0, i), savedCols(1, i)) ==
+        Approx(c.Predict(savedCols(0, i), savedCols(1, i))).epsilon(1e-7));
+  }
+
+  arma::Mat<size_t> recommendations, predictionOnlyRecommendations;
+  c.GetRecommendations(10, recommendations);
+  p.GetRecommendations(10, predictionOnlyRecommendations);
+  CheckMatrices(recommendations, predictionOnlyRecommendations);
+
+  REQUIRE(data::Save("cf_svdpp_model.bin", "model", p, false) == false);
+  remove("cf_svdpp_model.bin");
+}
+
 // Compare batch Predict() and individual Predict() for randomized SVD.
 TEST_CASE("CFBatchPredictRandSVDTest", "[CFTest]")
 {
@@ -1190,6 +1229,149 @@ TEST_CASE("CFPredictPearsonSearch", "[CFTest]")
   CFPredict<NMFPolicy, OverallMeanNormalization, PearsonSearch>(2.0);
 }
 
+/**
+ * Make sure that a user can be folded into a trained model, and that its
+ * predicted ratings are then reasonable.
+ */
+TEST_CASE("CFFoldInNewUserTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  // Hold out all the ratings of the last user.
+  const size_t user = (size_t) arma::max(dataset.row(0));
+  const arma::uvec userCols = arma::find(dataset.row(0) == user);
+  const arma::uvec otherCols = arma::find(dataset.row(0) != user);
+  const arma::mat userData = dataset.cols(userCols);
+  const arma::mat otherData = dataset.cols(otherCols);
+
+  CFType<NMFPolicy, UserMeanNormalization> c(otherData, NMFPolicy(), 5, 5,
+      30);
+  REQUIRE(c.CleanedData().n_cols == user);
+
+  c.FoldIn(userData);
+  REQUIRE(c.CleanedData().n_cols == user + 1);
+  REQUIRE(c.Decomposition().H().n_cols == user + 1);
+  REQUIRE(c.CleanedData().col(user).n_nonzero == userData.n_cols);
+
+  // The folded-in ratings should be fitted reasonably well.
+  double totalError = 0.0;
+  for (size_t i = 0; i < userData.n_cols; ++i)
+  {
+    const double prediction = c.Predict(user, (size_t) userData(1, i));
+    totalError += std::pow(prediction - userData(2, i), 2.0);
+  }
+  REQUIRE(std::sqrt(totalError / userData.n_cols) < 2.0);
+
+  arma::Mat<size_t> recommendations;
+  arma::Col<size_t> users(1);
+  users[0] = user;
+  c.GetRecommendations(5, recommendations, users);
+  for (size_t i = 0; i < recommendations.n_elem; ++i)
+    REQUIRE(c.CleanedData()(recommendations[i], user) == 0.0);
+
+  // Ratings of unknown items can't be folded in.
+  arma::mat unknownItem(3, 1);
+  unknownItem(0, 0) = 0;
+  unknownItem(1, 0) = c.CleanedData().n_rows;
+  unknownItem(2, 0) = 3.0;
+  REQUIRE_THROWS_AS(c.FoldIn(unknownItem), std::invalid_argument);
+}
+
+/**
+ * Make sure that Predict() is returning reasonable results for
+ * LSHEuclideanSearch.
+ */
+TEST_CASE("CFPredictLSHEuclideanSearch", "[CFTest]")
+{
+  CFPredict<NMFPolicy, OverallMeanNormalization, LSHEuclideanSearch>(2.0);
+}
+
+/**
+ * Make sure that GetRecommendationsFastMKS() gives recommendations that are as
+ * good as those of GetRecommendations().
+ */
+TEST_CASE("CFGetRecommendationsFastMKSTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<NMFPolicy, UserMeanNormalization> c(dataset, NMFPolicy(), 5, 5, 30);
+
+  arma::Mat<size_t> recommendations, fastRecommendations;
+  c.GetRecommendations(10, recommendations);
+  c.GetRecommendationsFastMKS(10, fastRecommendations);
+
+  REQUIRE(fastRecommendations.n_rows == 10);
+  REQUIRE(fastRecommendations.n_cols == recommendations.n_cols);
+
+  // The items may differ when ratings are tied, so compare the predicted
+  // ratings of the recommendations.
+  for (size_t i = 0; i < recommendations.n_cols; ++i)
+  {
+    for (size_t j = 0; j < recommendations.n_rows; ++j)
+    {
+      REQUIRE(c.CleanedData()(fastRecommendations(j, i), i) == 0.0);
+      REQUIRE(c.Predict(i, fastRecommendations(j, i)) ==
+          Approx(c.Predict(i, recommendations(j, i))).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that cached recommendations are the same as computed ones, that
+ * they are serialized, and that FoldIn() clears them.
+ */
+TEST_CASE("CFCacheRecommendationsTest", "[CFTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("GroupLensSmall.csv", dataset))
+    FAIL("Cannot load test dataset GroupLensSmall.csv!");
+
+  CFType<NMFPolicy, UserMeanNormalization> c(dataset, NMFPolicy(), 5, 5, 30);
+
+  arma::Mat<size_t> recommendations, cachedRecommendations;
+  c.GetRecommendations<CosineSearch, SimilarityInterpolation>(5,
+      recommendations);
+
+  c.CacheRecommendations<CosineSearch, SimilarityInterpolation>(10);
+  REQUIRE(c.Cached<CosineSearch, SimilarityInterpolation>(5));
+  REQUIRE(!c.Cached<CosineSearch, SimilarityInterpolation>(11));
+  REQUIRE(!c.Cached<EuclideanSearch, SimilarityInterpolation>(5));
+  REQUIRE(c.CachedRecommendations().n_rows == 10);
+  REQUIRE(c.CachedRecommendations().n_cols == c.CleanedData().n_cols);
+
+  c.GetRecommendations<CosineSearch, SimilarityInterpolation>(5,
+      cachedRecommendations);
+  CheckMatrices(recommendations, cachedRecommendations);
+
+  arma::Col<size_t> users("3 0 7");
+  c.GetRecommendations<CosineSearch, SimilarityInterpolation>(5,
+      cachedRecommendations, users);
+  REQUIRE(cachedRecommendations.n_cols == users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+      REQUIRE(cachedRecommendations(j, i) == recommendations(j, users[i]));
+  }
+
+  // The cache should be saved with the model.
+  CFType<NMFPolicy, UserMeanNormalization> cXml, cJson, cBinary;
+  SerializeObjectAll(c, cXml, cJson, cBinary);
+  REQUIRE(cXml.Cached<CosineSearch, SimilarityInterpolation>(10));
+  REQUIRE(cJson.Cached<CosineSearch, SimilarityInterpolation>(10));
+  REQUIRE(cBinary.Cached<CosineSearch, SimilarityInterpolation>(10));
+  CheckMatrices(c.CachedRecommendations(), cXml.CachedRecommendations(),
+      cJson.CachedRecommendations(), cBinary.CachedRecommendations());
+
+  // New ratings may change the recommendations.
+  c.FoldIn(dataset.cols(0, 9));
+  REQUIRE(!c.Cached<CosineSearch, SimilarityInterpolation>(5));
+  REQUIRE(c.CachedRecommendations().is_empty());
+}
+
 /**
  * Make sure that Predict() is returning reasonable results for
  * AverageInterpolation.
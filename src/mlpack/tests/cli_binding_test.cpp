@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/bindings/cli/cli_option.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
 #include "catch.hpp"
@@ -653,3 +654,102 @@ TEST_CASE("DeleteAllocatedMemoryModelTest", "[CLIOptionTest]")
   DeleteAllocatedMemory<GaussianKernel*>((util::ParamData&) d,
       (const void*) NULL, (void*) NULL);
 }
+
+// Test that SetServeInput() sets a matrix parameter to the points of the
+// requests, as if it had been loaded.
+TEST_CASE("SetServeInputMatrixTest", "[CLIOptionTest]")
+{
+  util::ParamData d;
+  typedef tuple<string, size_t, size_t> TupleType;
+  d.value = boost::any(make_tuple(arma::mat(), TupleType{"", 0, 0}));
+  d.wasPassed = false;
+  d.loaded = false;
+  d.noTranspose = false;
+
+  arma::mat points(4, 7, arma::fill::randu);
+  SetServeInput<arma::mat>(d, (const void*) &points, (void*) NULL);
+
+  tuple<arma::mat, TupleType>& t =
+      *boost::any_cast<tuple<arma::mat, TupleType>>(&d.value);
+  REQUIRE(d.wasPassed == true);
+  REQUIRE(d.loaded == true);
+  REQUIRE(get<1>(get<1>(t)) == 4);
+  REQUIRE(get<2>(get<1>(t)) == 7);
+  CheckMatrices(get<0>(t), points);
+
+  // A parameter that isn't transposed holds one point per row.
+  d.noTranspose = true;
+  SetServeInput<arma::mat>(d, (const void*) &points, (void*) NULL);
+  CheckMatrices(get<0>(t), arma::mat(points.t()));
+}
+
+// Test that GetServeOutput() gives one column per point for matrices and
+// vectors.
+TEST_CASE("GetServeOutputTest", "[CLIOptionTest]")
+{
+  util::ParamData d;
+  typedef tuple<string, size_t, size_t> TupleType;
+  arma::Row<size_t> predictions("0 2 1 1 3");
+  d.value = boost::any(make_tuple(predictions, TupleType{"", 0, 0}));
+
+  arma::mat output;
+  GetServeOutput<arma::Row<size_t>>(d, (const void*) NULL, (void*) &output);
+  REQUIRE(output.n_rows == 1);
+  REQUIRE(output.n_cols == 5);
+  for (size_t i = 0; i < 5; ++i)
+    REQUIRE(output[i] == (double) predictions[i]);
+
+  util::ParamData d2;
+  arma::mat probabilities(3, 5, arma::fill::randu);
+  d2.value = boost::any(make_tuple(probabilities, TupleType{"", 0, 0}));
+  GetServeOutput<arma::mat>(d2, (const void*) NULL, (void*) &output);
+  CheckMatrices(output, probabilities);
+}
+
+// Test that requests of the serving mode are parsed, and that malformed
+// requests don't prevent reading the next ones.
+TEST_CASE("ReadServeRequestTest", "[CLIOptionTest]")
+{
+  istringstream in("a 2\n1,2,3\n4 5 6\n\nb 2\n1,2\n1,2,3\nc 1\n1,x\n"
+      "d 0\nquit\ne 1\n1\n");
+
+  ServeRequest request;
+  REQUIRE(ReadServeRequest(in, request));
+  REQUIRE(request.id == "a");
+  REQUIRE(request.error.empty());
+  CheckMatrices(request.points, arma::mat("1 4; 2 5; 3 6"));
+
+  // The points of b don't have the same dimensionality.
+  REQUIRE(ReadServeRequest(in, request));
+  REQUIRE(request.id == "b");
+  REQUIRE(!request.error.empty());
+
+  REQUIRE(ReadServeRequest(in, request));
+  REQUIRE(request.id == "c");
+  REQUIRE(!request.error.empty());
+
+  REQUIRE(ReadServeRequest(in, request));
+  REQUIRE(request.id == "d");
+  REQUIRE(request.error.empty());
+  REQUIRE(request.points.n_cols == 0);
+
+  // The input stops at "quit".
+  REQUIRE(!ReadServeRequest(in, request));
+}
+
+// Test the quantiles of the latency histogram.
+TEST_CASE("LatencyHistogramTest", "[CLIOptionTest]")
+{
+  LatencyHistogram h;
+  REQUIRE(h.Quantile(0.5) == 0.0);
+
+  for (size_t i = 0; i < 90; ++i)
+    h.Add(10.0);
+  for (size_t i = 0; i < 10; ++i)
+    h.Add(1000.0);
+
+  REQUIRE(h.Count() == 100);
+  REQUIRE(h.Quantile(0.5) == 16.0);
+  REQUIRE(h.Quantile(0.9) == 16.0);
+  REQUIRE(h.Quantile(0.99) == 1024.0);
+}
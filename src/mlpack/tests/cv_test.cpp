@@ -262,7 +262,7 @@ TEST_CASE("PredictionsTypeTest", "[CVTest]")
   // CheckPredictionsType<FFN<>, arma::mat>();
 
   CheckPredictionsType<LogisticRegression<>, arma::Row<size_t>>();
-  CheckPredictionsType<SoftmaxRegression, arma::Row<size_t>>();
+  CheckPredictionsType<SoftmaxRegression<>, arma::Row<size_t>>();
   CheckPredictionsType<HoeffdingTree<>, arma::Row<size_t>, arma::mat>();
   CheckPredictionsType<HoeffdingTree<>, arma::Row<size_t>, arma::imat>();
   CheckPredictionsType<DecisionTree<>, arma::Row<size_t>, arma::mat,
@@ -325,7 +325,7 @@ TEST_CASE("TakesDatasetInfoTest", "[CVTest]")
       "Value should be true");
   static_assert(!MetaInfoExtractor<LinearRegression>::TakesDatasetInfo,
       "Value should be false");
-  static_assert(!MetaInfoExtractor<SoftmaxRegression>::TakesDatasetInfo,
+  static_assert(!MetaInfoExtractor<SoftmaxRegression<>>::TakesDatasetInfo,
       "Value should be false");
 }
 
@@ -337,7 +337,7 @@ TEST_CASE("TakesNumClassesTest", "[CVTest]")
 {
   static_assert(MetaInfoExtractor<DecisionTree<>>::TakesNumClasses,
       "Value should be true");
-  static_assert(MetaInfoExtractor<SoftmaxRegression>::TakesNumClasses,
+  static_assert(MetaInfoExtractor<SoftmaxRegression<>>::TakesNumClasses,
       "Value should be true");
   static_assert(!MetaInfoExtractor<LinearRegression>::TakesNumClasses,
       "Value should be false");
@@ -554,6 +554,37 @@ TEST_CASE("KFoldCVWithWeightedLRTest", "[CVTest]")
   REQUIRE((1.0 - mse) == Approx(1.0).epsilon(1e-7));
 }
 
+/**
+ * Test that training the folds at once gives the same score and model as
+ * training them one after another.
+ */
+TEST_CASE("KFoldCVParallelTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 103);
+  arma::rowvec responses = arma::sum(data, 0) + 0.1 *
+      arma::randn<arma::rowvec>(103);
+  arma::rowvec weights = arma::randu<arma::rowvec>(103);
+
+  KFoldCV<LinearRegression, MSE> cv(7, data, responses, weights, false);
+  const double serialMSE = cv.Evaluate(0.01);
+  const arma::vec serialParameters = cv.Model().Parameters();
+
+  cv.NumThreads() = 4;
+  const double parallelMSE = cv.Evaluate(0.01);
+
+  REQUIRE(parallelMSE == Approx(serialMSE).epsilon(1e-7));
+  REQUIRE(arma::approx_equal(cv.Model().Parameters(), serialParameters,
+      "absdiff", 1e-10));
+
+  // A copy keeps the data and the number of threads, but not the model; and
+  // shuffling the original does not change the data of the copy.
+  KFoldCV<LinearRegression, MSE> cvCopy(cv);
+  REQUIRE(cvCopy.NumThreads() == 4);
+  REQUIRE_THROWS_AS(cvCopy.Model(), std::logic_error);
+  cv.Shuffle();
+  REQUIRE(cvCopy.Evaluate(0.01) == Approx(serialMSE).epsilon(1e-7));
+}
+
 /**
  * Test k-fold cross-validation with decision trees constructed in multiple
  * ways.
@@ -779,3 +810,35 @@ TEST_CASE("SilhouetteScoreTest", "[CVTest]")
   double silhouetteScore = SilhouetteScore::Overall(X, labels, metric);
   REQUIRE(silhouetteScore == Approx(0.1121684822489150).epsilon(1e-7));
 }
+
+/**
+ * Test that the tiled silhouette score matches the score computed from the
+ * pairwise distances, and that the sampled score is close to it.
+ */
+TEST_CASE("SilhouetteScoreTiledTest", "[CVTest]")
+{
+  // Three well-separated clusters, with more points than one tile.
+  arma::mat X = arma::randn<arma::mat>(3, 600);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = 3 * (i % 3) + 1;
+    X.col(i) += 10.0 * (i % 3);
+  }
+  metric::EuclideanDistance metric;
+
+  const arma::rowvec expected = SilhouetteScore::SamplesScore(
+      PairwiseDistances(X, metric), labels);
+  const arma::rowvec scores = SilhouetteScore::SamplesScore(X, labels, metric);
+  REQUIRE(scores.n_elem == 600);
+  for (size_t i = 0; i < 600; ++i)
+    REQUIRE(scores[i] == Approx(expected[i]).epsilon(1e-7));
+
+  const double overall = SilhouetteScore::Overall(X, labels, metric);
+  REQUIRE(overall == Approx(arma::mean(expected)).epsilon(1e-7));
+  REQUIRE(SilhouetteScore::Overall(X, labels, metric, 600) ==
+      Approx(overall).epsilon(1e-7));
+
+  const double sampled = SilhouetteScore::Overall(X, labels, metric, 200);
+  REQUIRE(std::abs(sampled - overall) < 0.05);
+}
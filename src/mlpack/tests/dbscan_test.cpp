@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/dbscan/dbscan.hpp>
+#include <mlpack/methods/dbscan/grid_dbscan.hpp>
 #include <mlpack/methods/dbscan/random_point_selection.hpp>
 
 #include "test_catch_tools.hpp"
@@ -306,3 +307,103 @@ TEST_CASE("RandomPointSelectionTest", "[DBSCANTest]")
   // The number of assignments returned should be the same as points.
   REQUIRE(assignments.n_elem == points.n_cols);
 }
+
+/**
+ * Check that searching in small blocks gives the same clustering as batch
+ * mode, up to the labels of the clusters.
+ */
+TEST_CASE("BlockSingleModeTest", "[DBSCANTest]")
+{
+  arma::mat points(2, 1500);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = arma::randn<arma::vec>(2) + 6.0 * (i % 5);
+
+  DBSCAN<> batch(0.6, 5);
+  arma::Row<size_t> batchAssignments;
+  const size_t batchClusters = batch.Cluster(points, batchAssignments);
+
+  DBSCAN<> blocked(0.6, 5, false);
+  blocked.BlockSize() = 37;
+  arma::Row<size_t> blockAssignments;
+  const size_t blockClusters = blocked.Cluster(points, blockAssignments);
+
+  REQUIRE(blockClusters == batchClusters);
+
+  // Map the labels of one clustering onto the other.
+  arma::Col<size_t> mapping(batchClusters);
+  mapping.fill(SIZE_MAX);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (batchAssignments[i] == SIZE_MAX)
+    {
+      REQUIRE(blockAssignments[i] == SIZE_MAX);
+      continue;
+    }
+
+    REQUIRE(blockAssignments[i] != SIZE_MAX);
+    if (mapping[batchAssignments[i]] == SIZE_MAX)
+      mapping[batchAssignments[i]] = blockAssignments[i];
+    REQUIRE(mapping[batchAssignments[i]] == blockAssignments[i]);
+  }
+}
+
+/**
+ * Check that the grid-based clustering gives exactly the same assignments as
+ * DBSCAN in single mode on two-dimensional data.
+ */
+TEST_CASE("GridDBSCANTwoDimensionalTest", "[DBSCANTest]")
+{
+  arma::mat points(2, 2000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = arma::randn<arma::vec>(2) + 5.0 * (i % 4);
+
+  // Add some noise.
+  points.cols(0, 99) = 30.0 * arma::randu<arma::mat>(2, 100) - 5.0;
+
+  DBSCAN<> d(0.3, 5, false);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  GridDBSCAN g(0.3, 5);
+  arma::Row<size_t> gridAssignments;
+  const size_t gridClusters = g.Cluster(points, gridAssignments);
+
+  REQUIRE(gridClusters == clusters);
+  REQUIRE(gridAssignments.n_elem == points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    REQUIRE(gridAssignments[i] == assignments[i]);
+
+  // The centroids should also match.
+  arma::mat centroids, gridCentroids;
+  d.Cluster(points, assignments, centroids);
+  g.Cluster(points, gridAssignments, gridCentroids);
+  CheckMatrices(centroids, gridCentroids);
+}
+
+/**
+ * Check that the grid-based clustering gives exactly the same assignments as
+ * DBSCAN in single mode on three-dimensional data, for several values of
+ * epsilon.
+ */
+TEST_CASE("GridDBSCANThreeDimensionalTest", "[DBSCANTest]")
+{
+  arma::mat points(3, 1000, arma::fill::randu);
+
+  const double epsilons[] = { 0.01, 0.05, 0.1, 2.0 };
+  for (const double epsilon : epsilons)
+  {
+    DBSCAN<> d(epsilon, 3, false);
+    arma::Row<size_t> assignments;
+    const size_t clusters = d.Cluster(points, assignments);
+
+    GridDBSCAN g(epsilon, 3);
+    arma::Row<size_t> gridAssignments;
+    const size_t gridClusters = g.Cluster(points, gridAssignments);
+
+    REQUIRE(gridClusters == clusters);
+    for (size_t i = 0; i < points.n_cols; ++i)
+      REQUIRE(gridAssignments[i] == assignments[i]);
+  }
+
+  REQUIRE_THROWS_AS(GridDBSCAN(0.0, 3), std::invalid_argument);
+}
@@ -376,6 +376,121 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made.
+  REQUIRE(gain > bestGain);
+
+  // Make sure weight works and is not different than the unweighted one.
+  REQUIRE(gain == weightedGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  // The class probabilities, for this split, hold the splitting point, which
+  // should be between 4 and 5.
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split a dimension that gives no
+ * gain.
+ */
+TEST_CASE("HistogramNumericSplitNoGainTest", "[DecisionTreeTest]")
+{
+  arma::vec values(100);
+  arma::Row<size_t> labels(100);
+  arma::rowvec weights;
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities,
+      aux);
+
+  // Make sure there was no split.
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+}
+
+/**
+ * When every distinct value falls into its own bin, the HistogramNumericSplit
+ * should find the same split as the BestBinaryNumericSplit.
+ */
+TEST_CASE("HistogramNumericSplitMatchesBestBinaryTest", "[DecisionTreeTest]")
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = math::RandInt(100);
+    labels[i] = (values[i] + math::RandInt(30) > 60) ? 1 : 0;
+    weights[i] = math::Random();
+  }
+
+  arma::vec bestProbabilities, histogramProbabilities;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo bestAux;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 1e-7, bestProbabilities,
+      bestAux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 5, 1e-7, histogramProbabilities, histogramAux);
+
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramProbabilities.n_elem == 1);
+  REQUIRE(histogramProbabilities[0] == Approx(bestProbabilities[0]));
+
+  const double weightedBestGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, bestProbabilities, bestAux);
+  const double weightedHistogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(weightedBestGain,
+      values, labels, 2, weights, 5, 1e-7, histogramProbabilities,
+      histogramAux);
+
+  REQUIRE(weightedHistogramGain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(histogramProbabilities[0] == Approx(bestProbabilities[0]));
+}
+
 /**
  * Check that the RandomBinaryNumericSplit won't split if not enough points are
  * given.
@@ -1403,3 +1518,129 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that a tree built with multiple threads is the same as a tree built
+ * with a single thread.
+ */
+TEST_CASE("DecisionTreeParallelBuildTest", "[DecisionTreeTest]")
+{
+  // The tree must be large enough to be built in parallel.
+  arma::mat dataset(5, 40000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(1, i) + dataset(3, i) > 1.0) ? 1 : 0;
+    if (dataset(4, i) > 0.8)
+      labels[i] = 2;
+  }
+  arma::rowvec weights(dataset.n_cols, arma::fill::randu);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DecisionTree<> serialTree(dataset, labels, 3, 5);
+  DecisionTree<> serialWeightedTree(dataset, labels, 3, weights, 5);
+  omp_set_num_threads(4);
+  DecisionTree<> parallelTree(dataset, labels, 3, 5);
+  DecisionTree<> parallelWeightedTree(dataset, labels, 3, weights, 5);
+  omp_set_num_threads(prevNumThreads);
+
+  arma::mat testData(5, 2000, arma::fill::randu);
+  arma::Row<size_t> serialPredictions, parallelPredictions;
+  serialTree.Classify(testData, serialPredictions);
+  parallelTree.Classify(testData, parallelPredictions);
+  REQUIRE(arma::all(serialPredictions == parallelPredictions));
+
+  serialWeightedTree.Classify(testData, serialPredictions);
+  parallelWeightedTree.Classify(testData, parallelPredictions);
+  REQUIRE(arma::all(serialPredictions == parallelPredictions));
+
+  REQUIRE(parallelTree.SplitDimension() == serialTree.SplitDimension());
+  REQUIRE(parallelTree.NumChildren() == serialTree.NumChildren());
+}
+#endif
+
+/**
+ * Make sure that a tree trained out of core on the vc2 dataset, in small
+ * chunks, is about as accurate as a tree trained in memory, and that with one
+ * bin per distinct value it finds the same root split.
+ */
+TEST_CASE("DecisionTreeOutOfCoreTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  data::ColumnarFile<double>::Save("decision_tree_out_of_core.mlbin", dataset);
+
+  DecisionTree<> tree(dataset, labels, 3, 5);
+  DecisionTree<> outOfCoreTree;
+  const double entropy = outOfCoreTree.TrainOutOfCore(
+      "decision_tree_out_of_core.mlbin", labels, 3, 5, 1e-7, 0, 256, 17);
+  REQUIRE(entropy >= 0.0);
+
+  arma::Row<size_t> predictions, outOfCorePredictions;
+  tree.Classify(testDataset, predictions);
+  outOfCoreTree.Classify(testDataset, outOfCorePredictions);
+  const size_t correct = arma::accu(predictions == testLabels);
+  const size_t outOfCoreCorrect = arma::accu(outOfCorePredictions ==
+      testLabels);
+  REQUIRE(outOfCoreCorrect + 0.05 * testLabels.n_elem >= correct);
+
+  // vc2 has fewer than 256 distinct values in each dimension, so the root
+  // split is the same as that of the tree trained in memory.
+  REQUIRE(outOfCoreTree.NumChildren() == 2);
+  REQUIRE(outOfCoreTree.SplitDimension() == tree.SplitDimension());
+
+  // The labels must match the points of the file.
+  arma::Row<size_t> shortLabels = labels.subvec(0, labels.n_elem - 2);
+  REQUIRE_THROWS_AS(outOfCoreTree.TrainOutOfCore(
+      "decision_tree_out_of_core.mlbin", shortLabels, 3),
+      std::invalid_argument);
+
+  remove("decision_tree_out_of_core.mlbin");
+}
+
+/**
+ * Make sure that an out-of-core tree honors the maximum depth, and that a
+ * stump trained out of core matches one trained in memory on data with few
+ * distinct values.
+ */
+TEST_CASE("DecisionTreeOutOfCoreStumpTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(3, 1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    dataset(0, i) = (double) (i % 7);
+    dataset(1, i) = (double) ((i * 13) % 10);
+    dataset(2, i) = (double) ((i * 31) % 11);
+    labels[i] = (dataset(1, i) > 4.0) ? 1 : 0;
+  }
+
+  data::ColumnarFile<double>::Save("decision_tree_out_of_core.mlbin", dataset);
+
+  DecisionTree<> stump;
+  stump.TrainOutOfCore("decision_tree_out_of_core.mlbin", labels, 2, 1, 1e-7,
+      2, 256, 100, 200);
+  remove("decision_tree_out_of_core.mlbin");
+
+  REQUIRE(stump.NumChildren() == 2);
+  REQUIRE(stump.Child(0).NumChildren() == 0);
+  REQUIRE(stump.Child(1).NumChildren() == 0);
+  REQUIRE(stump.SplitDimension() == 1);
+
+  arma::Row<size_t> predictions;
+  stump.Classify(dataset, predictions);
+  REQUIRE(arma::all(predictions == labels));
+}
@@ -782,3 +782,49 @@ TEST_CASE("MoveOperatorTest", "[DETTest]")
   REQUIRE(testDTree2.Right()->SplitDim() == 1);
   REQUIRE(testDTree2.Right()->SplitValue() == Approx(0.5).epsilon(1e-7));
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that a tree grown with multiple threads is the same as a tree grown
+ * with a single thread.
+ */
+TEST_CASE("DETParallelGrowTest", "[DETTest]")
+{
+  // The tree must be large enough to be grown in parallel.
+  arma::mat data(4, 40000, arma::fill::randn);
+  data.row(1) %= data.row(0);
+  arma::mat serialData(data), parallelData(data);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DTree<arma::mat> serialTree(serialData);
+  arma::Col<size_t> serialOldFromNew =
+      arma::regspace<arma::Col<size_t>>(0, data.n_cols - 1);
+  const double serialAlpha = serialTree.Grow(serialData, serialOldFromNew,
+      false, 50, 10);
+
+  omp_set_num_threads(4);
+  DTree<arma::mat> parallelTree(parallelData);
+  arma::Col<size_t> parallelOldFromNew =
+      arma::regspace<arma::Col<size_t>>(0, data.n_cols - 1);
+  const double parallelAlpha = parallelTree.Grow(parallelData,
+      parallelOldFromNew, false, 50, 10);
+  omp_set_num_threads(prevNumThreads);
+
+  REQUIRE(parallelAlpha == Approx(serialAlpha).epsilon(1e-12));
+  REQUIRE(parallelTree.SubtreeLeaves() == serialTree.SubtreeLeaves());
+  REQUIRE(parallelTree.SubtreeLeavesLogNegError() ==
+      Approx(serialTree.SubtreeLeavesLogNegError()).epsilon(1e-12));
+  REQUIRE(parallelTree.AlphaUpper() ==
+      Approx(serialTree.AlphaUpper()).epsilon(1e-12));
+  REQUIRE(arma::all(parallelOldFromNew == serialOldFromNew));
+
+  arma::mat testData(4, 1000, arma::fill::randn);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    arma::vec point = testData.col(i);
+    REQUIRE(parallelTree.ComputeValue(point) ==
+        Approx(serialTree.ComputeValue(point)).epsilon(1e-12));
+  }
+}
+#endif
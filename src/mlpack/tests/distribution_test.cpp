@@ -1544,3 +1544,44 @@ TEST_CASE("DiagonalGaussianWeightedParametersReductionTest",
     REQUIRE(d1.Covariance()(i) == Approx(d2.Covariance()(i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that the batch LogProbability() of each distribution gives the same
+ * results as the LogProbability() of each point, for enough points that they
+ * are split into several blocks.
+ */
+TEST_CASE("BatchLogProbabilityTest", "[DistributionTest]")
+{
+  arma::mat points(4, 3000, arma::fill::randn);
+  arma::mat covariance(4, 4, arma::fill::randu);
+  covariance = covariance * covariance.t() + arma::eye<arma::mat>(4, 4);
+
+  GaussianDistribution g(arma::vec("0.5 -1.0 2.0 0.0"), covariance);
+  DiagonalGaussianDistribution dg(arma::vec("0.5 -1.0 2.0 0.0"),
+      arma::vec("1.5 0.5 2.0 1.0"));
+  LaplaceDistribution l(arma::vec("0.5 -1.0 2.0 0.0"), 1.5);
+  RegressionDistribution rd(points.rows(1, 3), points.row(0) +
+      0.1 * arma::randn<arma::rowvec>(points.n_cols));
+
+  arma::vec gLogProbs, dgLogProbs, lLogProbs, rdLogProbs;
+  g.LogProbability(points, gLogProbs);
+  dg.LogProbability(points, dgLogProbs);
+  l.LogProbability(points, lLogProbs);
+  rd.LogProbability(points, rdLogProbs);
+
+  REQUIRE(gLogProbs.n_elem == points.n_cols);
+  REQUIRE(dgLogProbs.n_elem == points.n_cols);
+  REQUIRE(lLogProbs.n_elem == points.n_cols);
+  REQUIRE(rdLogProbs.n_elem == points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE(gLogProbs[i] ==
+        Approx(g.LogProbability(points.col(i))).epsilon(1e-7));
+    REQUIRE(dgLogProbs[i] ==
+        Approx(dg.LogProbability(points.col(i))).epsilon(1e-7));
+    REQUIRE(lLogProbs[i] ==
+        Approx(l.LogProbability(points.col(i))).epsilon(1e-7));
+    REQUIRE(rdLogProbs[i] ==
+        Approx(rd.LogProbability(points.col(i))).epsilon(1e-7));
+  }
+}
@@ -163,3 +163,37 @@ TEST_CASE("SparseTest", "[DrusillaSelectTest]")
   REQUIRE(distances.n_cols == 1000);
   REQUIRE(distances.n_rows == 3);
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that training and searching with several threads gives the same
+ * results as with one thread.
+ */
+TEST_CASE("DrusillaSelectParallelTest", "[DrusillaSelectTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 40000);
+  arma::mat queries = arma::randu<arma::mat>(5, 500);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DrusillaSelect<> serial(dataset, 5, 10);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serial.Search(queries, 3, serialNeighbors, serialDistances);
+
+  omp_set_num_threads(4);
+  DrusillaSelect<> parallel(dataset, 5, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  parallel.Search(queries, 3, neighbors, distances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  // Ties are unlikely with random data, so the candidates are the same.
+  REQUIRE(arma::all(arma::sort(parallel.CandidateIndices()) ==
+      arma::sort(serial.CandidateIndices())));
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+}
+#endif
@@ -274,3 +274,52 @@ TEST_CASE("EMSTBallTreeTest", "[EMSTTest]")
     REQUIRE(bstResults(2, i) == Approx(ballResults(2, i)).epsilon(1e-7));
   }
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that computing the MST with several threads gives the same tree as
+ * with a single thread, for both the dual-tree and the naive algorithm.
+ */
+TEST_CASE("EMSTParallelTest", "[EMSTTest]")
+{
+  arma::mat inputData = arma::randu<arma::mat>(3, 5000);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  DualTreeBoruvka<> sequential(inputData);
+  arma::mat sequentialResults;
+  sequential.ComputeMST(sequentialResults);
+
+  omp_set_num_threads(std::max(prevNumThreads, (size_t) 4));
+  DualTreeBoruvka<> parallel(inputData);
+  arma::mat parallelResults;
+  parallel.ComputeMST(parallelResults);
+
+  DualTreeBoruvka<> naive(inputData.cols(0, 999), true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults);
+  omp_set_num_threads(prevNumThreads);
+
+  DualTreeBoruvka<> naiveSequential(inputData.cols(0, 999), true);
+  arma::mat naiveSequentialResults;
+  naiveSequential.ComputeMST(naiveSequentialResults);
+
+  // With random data, there are no ties between distances.
+  REQUIRE(parallelResults.n_cols == sequentialResults.n_cols);
+  for (size_t i = 0; i < parallelResults.n_cols; ++i)
+  {
+    REQUIRE(parallelResults(0, i) == sequentialResults(0, i));
+    REQUIRE(parallelResults(1, i) == sequentialResults(1, i));
+    REQUIRE(parallelResults(2, i) ==
+        Approx(sequentialResults(2, i)).epsilon(1e-7));
+  }
+
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    REQUIRE(naiveResults(0, i) == naiveSequentialResults(0, i));
+    REQUIRE(naiveResults(1, i) == naiveSequentialResults(1, i));
+    REQUIRE(naiveResults(2, i) ==
+        Approx(naiveSequentialResults(2, i)).epsilon(1e-7));
+  }
+}
+#endif
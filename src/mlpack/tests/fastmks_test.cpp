@@ -1134,3 +1134,54 @@ TEST_CASE("CopyAssignmentTest", "[FastMKSTest]")
       REQUIRE(newKernels[i] == Approx(0.0).margin(1e-5));
   }
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel dual-tree traversal and the parallel naive search
+ * give exactly the same results as the serial ones, for both bichromatic and
+ * monochromatic search.
+ */
+TEST_CASE("FastMKSParallelSearchTest", "[FastMKSTest]")
+{
+  arma::mat data;
+  data.randn(5, 2000);
+  arma::mat queries;
+  queries.randn(5, 500);
+  PolynomialKernel pk(2.0, 1.0);
+
+  FastMKS<PolynomialKernel> tree(data, pk);
+  FastMKS<PolynomialKernel> naive(data, pk, false, true);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  arma::Mat<size_t> serialIndices, serialMonoIndices, serialNaiveIndices;
+  arma::mat serialKernels, serialMonoKernels, serialNaiveKernels;
+  omp_set_num_threads(1);
+  tree.Search(queries, 10, serialIndices, serialKernels);
+  tree.Search(10, serialMonoIndices, serialMonoKernels);
+  naive.Search(queries, 10, serialNaiveIndices, serialNaiveKernels);
+
+  arma::Mat<size_t> indices, monoIndices, naiveIndices;
+  arma::mat kernels, monoKernels, naiveKernels;
+  omp_set_num_threads(4);
+  tree.Search(queries, 10, indices, kernels);
+  tree.Search(10, monoIndices, monoKernels);
+  naive.Search(queries, 10, naiveIndices, naiveKernels);
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    REQUIRE(indices[i] == serialIndices[i]);
+    REQUIRE(kernels[i] == Approx(serialKernels[i]).epsilon(1e-7));
+    REQUIRE(indices[i] == serialNaiveIndices[i]);
+    REQUIRE(naiveIndices[i] == serialNaiveIndices[i]);
+    REQUIRE(naiveKernels[i] == serialNaiveKernels[i]);
+  }
+
+  for (size_t i = 0; i < monoIndices.n_elem; ++i)
+  {
+    REQUIRE(monoIndices[i] == serialMonoIndices[i]);
+    REQUIRE(monoKernels[i] == Approx(serialMonoKernels[i]).epsilon(1e-7));
+  }
+}
+#endif
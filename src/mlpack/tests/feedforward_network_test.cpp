@@ -15,6 +15,8 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/quantized_ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <ensmallen.hpp>
 
@@ -865,6 +867,335 @@ TEST_CASE("PartialForwardTest", "[FeedForwardNetworkTest]")
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Test that predicting in batches gives the same results as predicting one
+ * point at a time, whatever the batch size.
+ */
+TEST_CASE("FFNBatchPredictTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat input(10, 100, arma::fill::randu);
+
+  arma::mat expected;
+  model.Predict(input, expected, 1);
+  REQUIRE(expected.n_rows == 3);
+  REQUIRE(expected.n_cols == 100);
+
+  const size_t batchSizes[] = { 7, 64, 100, 256 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    arma::mat output;
+    model.Predict(input, output, batchSizes[i]);
+    CheckMatrices(output, expected);
+  }
+
+  arma::mat output;
+  REQUIRE_THROWS_AS(model.Predict(input, output, 0), std::invalid_argument);
+}
+
+/**
+ * Test that a StaticFFN gives the same results as the FFN it was created from,
+ * and that it can be converted back and serialized.
+ */
+TEST_CASE("StaticFFNTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat input(10, 100, arma::fill::randu);
+  arma::mat responses = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+
+  arma::mat expected;
+  model.Predict(input, expected);
+
+  typedef StaticFFN<NegativeLogLikelihood<>, Linear<>, SigmoidLayer<>,
+      Linear<>, LogSoftMax<>> StaticModelType;
+  StaticModelType staticModel(model);
+
+  arma::mat output;
+  staticModel.Predict(input, output, 7);
+  CheckMatrices(output, expected);
+  REQUIRE(staticModel.Evaluate(input, responses) ==
+      Approx(model.Evaluate(input, responses)).epsilon(1e-7));
+
+  // A copy must not share the parameters of the original.
+  StaticModelType copy(staticModel);
+  staticModel = StaticModelType();
+  copy.Predict(input, output);
+  CheckMatrices(output, expected);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> converted;
+  copy.ToFFN(converted);
+  converted.Predict(input, output);
+  CheckMatrices(output, expected);
+  REQUIRE_THROWS_AS(copy.ToFFN(converted), std::invalid_argument);
+
+  StaticModelType xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(copy, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlOutput, jsonOutput, binaryOutput;
+  xmlModel.Predict(input, xmlOutput);
+  jsonModel.Predict(input, jsonOutput);
+  binaryModel.Predict(input, binaryOutput);
+  CheckMatrices(expected, xmlOutput, jsonOutput, binaryOutput);
+
+  // The layers of the network have to match the given layers.
+  typedef StaticFFN<NegativeLogLikelihood<>, Linear<>, TanHLayer<>,
+      Linear<>, LogSoftMax<>> OtherModelType;
+  REQUIRE_THROWS_AS(OtherModelType(model), std::invalid_argument);
+}
+
+/**
+ * Test that a StaticFFN with single-precision layers gives the predictions of
+ * the double-precision FFN whose parameters it is given.
+ */
+TEST_CASE("StaticFFNFloatTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat input(10, 100, arma::fill::randu);
+  arma::mat responses = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+
+  arma::mat expected;
+  model.Predict(input, expected);
+
+  typedef StaticFFN<NegativeLogLikelihood<arma::fmat, arma::fmat>,
+      Linear<arma::fmat, arma::fmat>, SigmoidLayer<arma::fmat, arma::fmat>,
+      Linear<arma::fmat, arma::fmat>, LogSoftMax<arma::fmat, arma::fmat>>
+      FloatModelType;
+  FloatModelType floatModel(NegativeLogLikelihood<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(10, 8),
+      SigmoidLayer<arma::fmat, arma::fmat>(),
+      Linear<arma::fmat, arma::fmat>(8, 3),
+      LogSoftMax<arma::fmat, arma::fmat>());
+  REQUIRE(floatModel.Parameters().n_elem == model.Parameters().n_elem);
+
+  floatModel.SetParameters(model.Parameters());
+
+  const arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat output;
+  floatModel.Predict(floatInput, output, 7);
+  REQUIRE(output.n_rows == expected.n_rows);
+  REQUIRE(output.n_cols == expected.n_cols);
+  for (size_t i = 0; i < output.n_elem; ++i)
+    REQUIRE(output[i] == Approx(expected[i]).margin(1e-4));
+
+  const arma::fmat floatResponses = arma::conv_to<arma::fmat>::from(responses);
+  REQUIRE(floatModel.Evaluate(floatInput, floatResponses) ==
+      Approx(model.Evaluate(input, responses)).epsilon(1e-4));
+
+  // The number of parameters has to match the layers.
+  REQUIRE_THROWS_AS(floatModel.SetParameters(arma::mat(10, 1)),
+      std::invalid_argument);
+
+  FloatModelType xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(floatModel, xmlModel, jsonModel, binaryModel);
+
+  arma::fmat xmlOutput, jsonOutput, binaryOutput;
+  xmlModel.Predict(floatInput, xmlOutput);
+  jsonModel.Predict(floatInput, jsonOutput);
+  binaryModel.Predict(floatInput, binaryOutput);
+  CheckMatrices(arma::conv_to<arma::mat>::from(output),
+      arma::conv_to<arma::mat>::from(xmlOutput),
+      arma::conv_to<arma::mat>::from(jsonOutput),
+      arma::conv_to<arma::mat>::from(binaryOutput));
+}
+
+/**
+ * Test that the training passes that store the outputs and deltas of the layers
+ * in the workspace give the same objective and gradient as a network that
+ * doesn't use the workspace, and that the workspace is reused between passes.
+ */
+TEST_CASE("FFNTrainingWorkspaceTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+
+  // 100 points in batches of 32 gives a smaller last batch.
+  ens::StandardSGD opt(0.01, 32, 200, -1, false);
+  model.Train(data, labels, opt);
+
+  const size_t batchSizes[] = { 32, 4, 32, 32 };
+  const double* outputMemory = NULL;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const size_t batchSize = batchSizes[i];
+    arma::mat gradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, batchSize);
+
+    // A copy doesn't share the workspace, and the public Forward() and
+    // Backward() don't use it.
+    FFN<NegativeLogLikelihood<>, RandomInitialization> copy(model);
+    arma::mat output, expectedGradient;
+    copy.Forward(model.Predictors().cols(0, batchSize - 1), output);
+    const double expectedObjective = copy.Backward(
+        model.Predictors().cols(0, batchSize - 1),
+        model.Responses().cols(0, batchSize - 1), expectedGradient);
+
+    REQUIRE(objective == Approx(expectedObjective).epsilon(1e-10));
+    CheckMatrices(gradient, expectedGradient);
+
+    // Passes with the same batch size write into the same memory.
+    const double* memory = boost::apply_visitor(OutputParameterVisitor(),
+        model.Model()[0]).memptr();
+    if (i == 3)
+      REQUIRE(memory == outputMemory);
+    outputMemory = memory;
+  }
+}
+
+/**
+ * Test that training with activation checkpointing gives the same objective
+ * and gradient as training that keeps the outputs of all layers, with layers
+ * that are recomputed and layers (Dropout and BatchNorm) that are always kept.
+ */
+TEST_CASE("FFNCheckpointTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model, checkpointModel;
+  FFN<NegativeLogLikelihood<>, RandomInitialization>* models[] = { &model,
+      &checkpointModel };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    models[i]->Add<Linear<> >(10, 8);
+    models[i]->Add<SigmoidLayer<> >();
+    models[i]->Add<Linear<> >(8, 8);
+    models[i]->Add<BatchNorm<> >(8);
+    models[i]->Add<TanHLayer<> >();
+    models[i]->Add<Linear<> >(8, 8);
+    models[i]->Add<Dropout<> >(0.3);
+    models[i]->Add<ReLULayer<> >();
+    models[i]->Add<Linear<> >(8, 3);
+    models[i]->Add<LogSoftMax<> >();
+    models[i]->ResetParameters();
+  }
+
+  checkpointModel.Parameters() = model.Parameters();
+  checkpointModel.CheckpointEvery(3);
+  REQUIRE(checkpointModel.Checkpoints().size() == 3);
+  REQUIRE(checkpointModel.Checkpoints()[0] == 2);
+  REQUIRE(checkpointModel.Checkpoints()[2] == 8);
+
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+  model.Predictors() = data;
+  model.Responses() = labels;
+  checkpointModel.Predictors() = data;
+  checkpointModel.Responses() = labels;
+
+  // The first pass also sets up the network; the others reuse the workspace
+  // of the model without checkpointing.
+  const size_t batchSizes[] = { 32, 32, 10 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat gradient, checkpointGradient;
+    math::RandomSeed(i + 1);
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, batchSizes[i]);
+    math::RandomSeed(i + 1);
+    const double checkpointObjective = checkpointModel.EvaluateWithGradient(
+        checkpointModel.Parameters(), 0, checkpointGradient, batchSizes[i]);
+
+    REQUIRE(checkpointObjective == Approx(objective).epsilon(1e-10));
+    REQUIRE(arma::approx_equal(checkpointGradient, gradient, "absdiff",
+        1e-10));
+
+    // Only the outputs of the checkpoints and the layers that can't be
+    // recomputed are kept.
+    REQUIRE(boost::apply_visitor(OutputParameterVisitor(),
+        checkpointModel.Model()[0]).is_empty());
+    REQUIRE(!boost::apply_visitor(OutputParameterVisitor(),
+        checkpointModel.Model()[2]).is_empty());
+    REQUIRE(!boost::apply_visitor(OutputParameterVisitor(),
+        checkpointModel.Model()[6]).is_empty());
+  }
+
+  // Turning checkpointing off gives the normal passes again.
+  checkpointModel.CheckpointEvery(0);
+  REQUIRE(checkpointModel.Checkpoints().empty());
+  ens::StandardSGD opt(0.01, 32, 100, -1, false);
+  REQUIRE(std::isfinite(checkpointModel.Train(data, labels, opt)));
+}
+
+/**
+ * Check that splitting the batches of the given network across threads gives
+ * the same objective and gradient as one thread.
+ */
+template<typename OutputLayerType>
+void CheckNumThreads(const arma::mat& data, const arma::mat& labels)
+{
+  FFN<OutputLayerType, RandomInitialization> model, parallelModel;
+  FFN<OutputLayerType, RandomInitialization>* models[] = { &model,
+      &parallelModel };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    models[i]->template Add<Linear<> >(10, 8);
+    models[i]->template Add<SigmoidLayer<> >();
+    models[i]->template Add<Linear<> >(8, 3);
+    models[i]->template Add<LogSoftMax<> >();
+    models[i]->ResetParameters();
+    models[i]->Predictors() = data;
+    models[i]->Responses() = labels;
+  }
+
+  parallelModel.Parameters() = model.Parameters();
+  parallelModel.NumThreads() = 4;
+  REQUIRE(parallelModel.NumThreads() == 4);
+
+  // The batch sizes give parts of different sizes, and fewer points than
+  // threads.
+  const size_t batchSizes[] = { 32, 10, 3, 1, 32 };
+  for (size_t i = 0; i < 5; ++i)
+  {
+    arma::mat gradient, parallelGradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, batchSizes[i]);
+    const double parallelObjective = parallelModel.EvaluateWithGradient(
+        parallelModel.Parameters(), 0, parallelGradient, batchSizes[i]);
+
+    REQUIRE(parallelObjective == Approx(objective).epsilon(1e-10));
+    REQUIRE(arma::approx_equal(parallelGradient, gradient, "absdiff", 1e-10));
+  }
+
+  // Training with several threads works too.
+  ens::StandardSGD opt(0.01, 32, 100, -1, false);
+  const double objective = parallelModel.Train(data, labels, opt);
+  REQUIRE(std::isfinite(objective));
+}
+
+/**
+ * Test that splitting the batches across threads gives the same results, for
+ * an output layer that sums over the batch and one that averages over it.
+ */
+TEST_CASE("FFNNumThreadsTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 100) * 3);
+  CheckNumThreads<NegativeLogLikelihood<> >(data, labels);
+
+  arma::mat responses(3, 100, arma::fill::randu);
+  CheckNumThreads<MeanSquaredError<> >(data, responses);
+}
+
 /**
  * Test that FFN::Train() returns finite objective value.
  */
@@ -1008,3 +1339,325 @@ TEST_CASE("FFNCheckInputShapeTest", "[FeedForwardNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(trainData, trainLabels, opt), std::logic_error);
 }
+
+/**
+ * Test that freezing a network folds its BatchNorm layers into the layers
+ * before them and removes its Dropout layers without changing its predictions.
+ */
+TEST_CASE("FFNFreezeTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 200) * 3);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<ReLULayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(8, 6);
+  // Each feature of this BatchNorm layer normalizes two outputs.
+  model.Add<BatchNorm<> >(3);
+  model.Add<SigmoidLayer<> >();
+  model.Add<AlphaDropout<> >(0.2);
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Train the network so the BatchNorm layers hold statistics.
+  ens::StandardSGD opt(0.01, 32, 400, -1, false);
+  model.Train(data, labels, opt);
+
+  arma::mat expected;
+  model.Predict(data, expected);
+  const size_t size = model.Parameters().n_elem;
+
+  model.Freeze();
+  REQUIRE(model.Model().size() == 6);
+  REQUIRE(model.Parameters().n_elem == size - 2 * 8 - 2 * 3);
+
+  arma::mat output;
+  model.Predict(data, output);
+  CheckMatrices(output, expected, 1e-8);
+
+  // The same for a BatchNorm layer after a convolution.
+  arma::mat images(2 * 6 * 6, 200, arma::fill::randu);
+  FFN<NegativeLogLikelihood<>, RandomInitialization> convModel;
+  convModel.Add<Convolution<> >(2, 3, 3, 3, 1, 1, 0, 0, 6, 6);
+  convModel.Add<BatchNorm<> >(3);
+  convModel.Add<ReLULayer<> >();
+  convModel.Add<Linear<> >(3 * 4 * 4, 3);
+  convModel.Add<LogSoftMax<> >();
+
+  ens::StandardSGD convOpt(0.01, 32, 400, -1, false);
+  convModel.Train(images, labels, convOpt);
+
+  convModel.Predict(images, expected);
+  convModel.Freeze();
+  REQUIRE(convModel.Model().size() == 4);
+
+  convModel.Predict(images, output);
+  CheckMatrices(output, expected, 1e-8);
+}
+
+/**
+ * Test that pruning zeroes the smallest weights, and that freezing a pruned
+ * network makes its Linear layers sparse without changing its predictions.
+ */
+TEST_CASE("FFNPruneTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 200) * 3);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<ReLULayer<> >();
+  model.Add<LinearNoBias<> >(20, 10);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+
+  ens::StandardSGD opt(0.01, 32, 400, -1, false);
+  model.Train(data, labels, opt);
+
+  const arma::mat weight = boost::get<Linear<>*>(model.Model()[0])->Weight();
+  const arma::mat bias = boost::get<Linear<>*>(model.Model()[0])->Bias();
+  const arma::mat lastWeight =
+      boost::get<Linear<>*>(model.Model()[4])->Weight();
+  model.Prune(0.9);
+
+  // The 20 largest weights of the first layer are kept.
+  const arma::mat& prunedWeight =
+      boost::get<Linear<>*>(model.Model()[0])->Weight();
+  REQUIRE(arma::accu(prunedWeight != 0) == 20);
+  const arma::vec magnitudes = arma::sort(arma::abs(arma::vectorise(weight)));
+  for (size_t i = 0; i < prunedWeight.n_elem; ++i)
+  {
+    if (prunedWeight[i] != 0.0)
+    {
+      REQUIRE(prunedWeight[i] == weight[i]);
+      REQUIRE(std::abs(weight[i]) >= magnitudes[180]);
+    }
+  }
+  CheckMatrices(boost::get<Linear<>*>(model.Model()[0])->Bias(), bias);
+
+  // Make the last layer dense again, so that only the first two layers are
+  // sparse enough to be replaced.
+  boost::get<Linear<>*>(model.Model()[4])->Weight() = lastWeight;
+
+  arma::mat expected;
+  model.Predict(data, expected);
+  const size_t size = model.Parameters().n_elem;
+
+  model.Freeze(0.5);
+  REQUIRE(model.Model().size() == 6);
+  REQUIRE(model.Parameters().n_elem == size - (10 * 20 + 20) - 20 * 10);
+  for (size_t i = 0; i < 4; i += 2)
+  {
+    MoreTypes* layer = boost::get<MoreTypes>(&model.Model()[i]);
+    REQUIRE(layer != NULL);
+    REQUIRE(boost::get<SparseLinear<>*>(layer) != NULL);
+    REQUIRE(boost::get<SparseLinear<>*>(*layer)->Weight().n_nonzero == 20);
+  }
+  REQUIRE(boost::get<Linear<>*>(&model.Model()[4]) != NULL);
+
+  arma::mat output;
+  model.Predict(data, output);
+  CheckMatrices(output, expected, 1e-8);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> xmlModel, jsonModel,
+      binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlOutput, jsonOutput, binaryOutput;
+  xmlModel.Predict(data, xmlOutput);
+  jsonModel.Predict(data, jsonOutput);
+  binaryModel.Predict(data, binaryOutput);
+  CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
+}
+
+/**
+ * Test that a quantized network gives almost the same predictions as the
+ * original network, and that it can be serialized.
+ */
+TEST_CASE("QuantizedFFNTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 200) * 3);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<ReLULayer<> >();
+  model.Add<LinearNoBias<> >(8, 6);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(6, 3);
+  model.Add<LogSoftMax<> >();
+
+  ens::StandardSGD opt(0.01, 32, 400, -1, false);
+  model.Train(data, labels, opt);
+
+  arma::mat expected;
+  model.Predict(data, expected);
+
+  QuantizedFFN<NegativeLogLikelihood<>, RandomInitialization> quantizedModel(
+      model, data);
+  REQUIRE(quantizedModel.QuantizedLayers().size() == 3);
+  REQUIRE(quantizedModel.QuantizedLayers()[0].Weights().n_elem == 10 * 8);
+  // Only the parameters of the layers that aren't quantized are left.
+  REQUIRE(quantizedModel.Network().Parameters().n_elem == 0);
+
+  arma::mat output;
+  quantizedModel.Predict(data, output, 64);
+  REQUIRE(output.n_rows == expected.n_rows);
+  REQUIRE(output.n_cols == expected.n_cols);
+  REQUIRE(arma::abs(output - expected).max() < 0.05);
+
+  QuantizedFFN<NegativeLogLikelihood<>, RandomInitialization> xmlModel,
+      jsonModel, binaryModel;
+  SerializeObjectAll(quantizedModel, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlOutput, jsonOutput, binaryOutput;
+  xmlModel.Predict(data, xmlOutput);
+  jsonModel.Predict(data, jsonOutput);
+  binaryModel.Predict(data, binaryOutput);
+  CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
+
+  // The same for a padded, strided convolution followed by a pooling layer
+  // that isn't quantized.
+  arma::mat images(2 * 7 * 7, 100, arma::fill::randu);
+  FFN<NegativeLogLikelihood<>, RandomInitialization> convModel;
+  convModel.Add<Convolution<> >(2, 3, 3, 3, 2, 2, 1, 1, 7, 7);
+  convModel.Add<ReLULayer<> >();
+  convModel.Add<MeanPooling<> >(2, 2, 2, 2);
+  convModel.Add<Linear<> >(3 * 2 * 2, 3);
+  convModel.Add<LogSoftMax<> >();
+
+  convModel.Predict(images, expected);
+  QuantizedFFN<NegativeLogLikelihood<>, RandomInitialization> quantizedConv(
+      convModel, images, 32);
+  REQUIRE(quantizedConv.QuantizedLayers().size() == 2);
+
+  quantizedConv.Predict(images, output);
+  REQUIRE(arma::abs(output - expected).max() < 0.05);
+
+  // And for a Lookup layer.
+  arma::mat tokens = arma::floor(arma::randu<arma::mat>(5, 100) * 20) + 1;
+  FFN<NegativeLogLikelihood<>, RandomInitialization> lookupModel;
+  lookupModel.Add<Lookup<> >(20, 4);
+  lookupModel.Add<Linear<> >(4 * 5, 3);
+  lookupModel.Add<LogSoftMax<> >();
+
+  lookupModel.Predict(tokens, expected);
+  QuantizedFFN<NegativeLogLikelihood<>, RandomInitialization> quantizedLookup(
+      lookupModel, tokens);
+  quantizedLookup.Predict(tokens, output);
+  REQUIRE(arma::abs(output - expected).max() < 0.05);
+}
+
+/**
+ * A source of points for PrefetchLoader that holds the points in memory.
+ */
+class MatrixSource
+{
+ public:
+  MatrixSource(const arma::mat& predictors, const arma::mat& responses) :
+      predictors(predictors), responses(responses) { }
+
+  size_t NumPoints() const { return predictors.n_cols; }
+
+  void Load(const arma::uvec& indices,
+            arma::mat& batchPredictors,
+            arma::mat& batchResponses)
+  {
+    batchPredictors = predictors.cols(indices);
+    batchResponses = responses.cols(indices);
+  }
+
+ private:
+  arma::mat predictors;
+  arma::mat responses;
+};
+
+/**
+ * Test that PrefetchLoader gives the right batches, whether they were
+ * prefetched or not.
+ */
+TEST_CASE("PrefetchLoaderBatchTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(4, 25, arma::fill::randu);
+  arma::mat labels(1, 25, arma::fill::randu);
+  PrefetchLoader<MatrixSource> loader(MatrixSource(data, labels));
+  REQUIRE(loader.NumPoints() == 25);
+
+  // Two passes in order, so the first batch of the second pass is prefetched
+  // after the last, smaller batch.
+  arma::mat predictors, responses;
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    for (size_t begin = 0; begin < 25; begin += 10)
+    {
+      const size_t batchSize = std::min((size_t) 10, 25 - begin);
+      loader.Batch(begin, batchSize, predictors, responses);
+      CheckMatrices(predictors, data.cols(begin, begin + batchSize - 1));
+      CheckMatrices(responses, labels.cols(begin, begin + batchSize - 1));
+    }
+  }
+
+  // A batch that wasn't prefetched.
+  loader.Batch(7, 3, predictors, responses);
+  CheckMatrices(predictors, data.cols(7, 9));
+
+  REQUIRE_THROWS_AS(loader.Batch(20, 10, predictors, responses),
+      std::invalid_argument);
+
+  // After shuffling, one pass still visits every point once.
+  loader.Shuffle();
+  arma::mat visited;
+  arma::mat visitedLabels;
+  for (size_t begin = 0; begin < 25; begin += 5)
+  {
+    loader.Batch(begin, 5, predictors, responses);
+    visited = arma::join_rows(visited, predictors);
+    visitedLabels = arma::join_rows(visitedLabels, responses);
+  }
+
+  const arma::uvec order = arma::sort_index(visitedLabels.row(0).t());
+  const arma::uvec expectedOrder = arma::sort_index(labels.row(0).t());
+  CheckMatrices(visited.cols(order), data.cols(expectedOrder));
+}
+
+/**
+ * Test that training an FFN on the batches of a PrefetchLoader gives the same
+ * model as training it on the matrices.
+ */
+TEST_CASE("FFNPrefetchLoaderTrainTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 200) * 3);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Predict() initializes the parameters, so that they can be copied.
+  arma::mat output;
+  model.Predict(data, output);
+  FFN<NegativeLogLikelihood<>, RandomInitialization> loaderModel = model;
+  loaderModel.Predict(data, output);
+  loaderModel.Parameters() = model.Parameters();
+
+  ens::StandardSGD opt(0.01, 10, 200, -1, false);
+  const double objective = model.Train(data, labels, opt);
+
+  PrefetchLoader<MatrixSource> loader(MatrixSource(data, labels));
+  ens::StandardSGD loaderOpt(0.01, 10, 200, -1, false);
+  const double loaderObjective = loaderModel.Train(loader, loaderOpt);
+
+  REQUIRE(loaderObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(loaderModel.Parameters(), model.Parameters(), 1e-7);
+
+  // Training with a shuffled order works too.
+  ens::StandardSGD shuffleOpt(0.01, 16, 1000, -1, true);
+  REQUIRE(std::isfinite(loaderModel.Train(loader, shuffleOpt)));
+}
@@ -345,3 +345,67 @@ TEST_CASE("GANMemorySharingTest", "[GANNetworkTest]")
   CheckMatricesNotEqual(gan.Predictors().head_cols(trainData.n_cols),
       trainData);
 }
+
+/*
+ * Make sure that evaluating the discriminator on the real and fake points with
+ * a single pass, and splitting the passes of the discriminator across several
+ * threads, give the same objective and gradient as the default training step.
+ */
+TEST_CASE("GANBatchDiscriminatorTest", "[GANNetworkTest]")
+{
+  size_t batchSize = 8;
+  size_t noiseDim = 2;
+
+  arma::mat trainData(1, 100);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  FFN<SigmoidCrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 16);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(16, 1);
+
+  FFN<SigmoidCrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 8);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(8, 1);
+
+  GaussianInitialization gaussian(0, 0.1);
+  std::function<double ()> noiseFunction = [](){ return math::Random(-8, 8) +
+      math::RandNormal(0, 1) * 0.01;};
+  typedef GAN<FFN<SigmoidCrossEntropyError<> >, GaussianInitialization,
+      std::function<double()> > GANType;
+
+  GANType gan(generator, discriminator, gaussian, noiseFunction, noiseDim,
+      batchSize, 1, 0, 1);
+  gan.ResetData(trainData);
+
+  math::RandomSeed(7);
+  arma::mat gradient;
+  const double objective = gan.EvaluateWithGradient(gan.Parameters(), 16,
+      gradient, batchSize);
+  math::RandomSeed(7);
+  const double evaluation = gan.Evaluate(gan.Parameters(), 16, batchSize);
+
+  for (size_t numThreads = 1; numThreads <= 4; numThreads += 3)
+  {
+    for (size_t batched = 0; batched < 2; ++batched)
+    {
+      GANType other(generator, discriminator, gaussian, noiseFunction,
+          noiseDim, batchSize, 1, 0, 1);
+      other.ResetData(trainData);
+      other.Parameters() = gan.Parameters();
+      other.BatchDiscriminator() = (batched == 1);
+      other.Discriminator().NumThreads() = numThreads;
+
+      math::RandomSeed(7);
+      arma::mat otherGradient;
+      REQUIRE(other.EvaluateWithGradient(other.Parameters(), 16,
+          otherGradient, batchSize) == Approx(objective).epsilon(1e-8));
+      CheckMatrices(gradient, otherGradient, 1e-6);
+
+      math::RandomSeed(7);
+      REQUIRE(other.Evaluate(other.Parameters(), 16, batchSize) ==
+          Approx(evaluation).epsilon(1e-8));
+    }
+  }
+}
@@ -14,6 +14,8 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
+#include <mlpack/methods/gmm/kdtree_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -484,6 +486,173 @@ TEST_CASE("GMMRandomTest", "[GMMTest]")
       1)).epsilon(0.13));
 }
 
+/**
+ * Make sure that online EM recovers the parameters of a GMM, both when used as
+ * the fitter of GMM::Train() and when given a stream of mini-batches.
+ */
+TEST_CASE("GMMTrainOnlineEMTest", "[GMMTest]")
+{
+  GMM gmm(2, 2);
+  gmm.Weights() = arma::vec("0.40 0.60");
+  gmm.Component(0) = distribution::GaussianDistribution("-3.0 2.0",
+      "1.00 0.30; 0.30 0.80");
+  gmm.Component(1) = distribution::GaussianDistribution("4.0 -1.0",
+      "0.90 -0.20; -0.20 1.10");
+
+  arma::mat observations(2, 10000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations.col(i) = gmm.Random();
+
+  GMM gmm2(2, 2);
+  gmm2.Train(observations, 1, false, OnlineEMFit<>(500, 3));
+
+  arma::uvec sortedIndices = sort_index(gmm2.Weights());
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const distribution::GaussianDistribution& d =
+        gmm2.Component(sortedIndices[i]);
+
+    REQUIRE(gmm2.Weights()[sortedIndices[i]] ==
+        Approx(gmm.Weights()[i]).epsilon(0.05));
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(d.Mean()[j] ==
+          Approx(gmm.Component(i).Mean()[j]).margin(0.1));
+      for (size_t k = 0; k < 2; ++k)
+      {
+        REQUIRE(d.Covariance()(j, k) ==
+            Approx(gmm.Component(i).Covariance()(j, k)).margin(0.15));
+      }
+    }
+  }
+
+  // Now start from a perturbed model and give the observations to Update() as
+  // a stream of mini-batches.
+  std::vector<distribution::GaussianDistribution> dists;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    dists.push_back(distribution::GaussianDistribution(
+        gmm.Component(i).Mean() + 0.5, arma::eye<arma::mat>(2, 2)));
+  }
+  arma::vec weights("0.5 0.5");
+
+  OnlineEMFit<> fitter;
+  for (size_t begin = 0; begin < observations.n_cols; begin += 250)
+    fitter.Update(observations.cols(begin, begin + 249), dists, weights);
+
+  REQUIRE(fitter.Steps() == 40);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(weights[i] == Approx(gmm.Weights()[i]).epsilon(0.05));
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(dists[i].Mean()[j] ==
+          Approx(gmm.Component(i).Mean()[j]).margin(0.1));
+    }
+  }
+}
+
+/**
+ * Make sure that tree-pruned EM recovers well-separated Gaussians, and only
+ * keeps a few responsibilities per point.
+ */
+TEST_CASE("GMMTrainKDTreeEMTest", "[GMMTest]")
+{
+  GMM gmm(3, 2);
+  gmm.Weights() = arma::vec("0.30 0.30 0.40");
+  gmm.Component(0) = distribution::GaussianDistribution("-10.0 0.0",
+      "1.00 0.30; 0.30 0.80");
+  gmm.Component(1) = distribution::GaussianDistribution("10.0 0.0",
+      "0.90 -0.20; -0.20 1.10");
+  gmm.Component(2) = distribution::GaussianDistribution("0.0 15.0",
+      "1.20 0.00; 0.00 0.70");
+
+  arma::mat observations(2, 6000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations.col(i) = gmm.Random();
+
+  std::vector<distribution::GaussianDistribution> dists(3,
+      distribution::GaussianDistribution(2));
+  arma::vec weights(3);
+  KDTreeEMFit<> fitter(300, 1e-10, 1e-5, 32);
+  fitter.Estimate(observations, dists, weights);
+
+  // Nearly every point only has a responsibility for its own Gaussian.
+  REQUIRE(fitter.NumResponsibilities() < 1.2 * observations.n_cols);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    // Find the Gaussian that matches the mean of the i'th true Gaussian.
+    size_t match = 0;
+    for (size_t j = 1; j < 3; ++j)
+    {
+      if (arma::norm(dists[j].Mean() - gmm.Component(i).Mean()) <
+          arma::norm(dists[match].Mean() - gmm.Component(i).Mean()))
+        match = j;
+    }
+
+    REQUIRE(weights[match] == Approx(gmm.Weights()[i]).epsilon(0.05));
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(dists[match].Mean()[j] ==
+          Approx(gmm.Component(i).Mean()[j]).margin(0.1));
+      for (size_t k = 0; k < 2; ++k)
+      {
+        REQUIRE(dists[match].Covariance()(j, k) ==
+            Approx(gmm.Component(i).Covariance()(j, k)).margin(0.15));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that tree-pruned EM with a tolerance of 0 gives the same model as
+ * EMFit from the same initial model.
+ */
+TEST_CASE("KDTreeEMFitNoPruningTest", "[GMMTest]")
+{
+  GMM gmm(2, 2);
+  gmm.Weights() = arma::vec("0.50 0.50");
+  gmm.Component(0) = distribution::GaussianDistribution("-1.0 0.0",
+      "1.00 0.30; 0.30 0.80");
+  gmm.Component(1) = distribution::GaussianDistribution("1.5 0.5",
+      "0.90 -0.20; -0.20 1.10");
+
+  arma::mat observations(2, 2000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations.col(i) = gmm.Random();
+
+  std::vector<distribution::GaussianDistribution> emDists;
+  emDists.push_back(distribution::GaussianDistribution("-2.0 1.0",
+      "1.0 0.0; 0.0 1.0"));
+  emDists.push_back(distribution::GaussianDistribution("2.0 -1.0",
+      "1.0 0.0; 0.0 1.0"));
+  std::vector<distribution::GaussianDistribution> treeDists(emDists);
+  arma::vec emWeights("0.5 0.5");
+  arma::vec treeWeights(emWeights);
+
+  EMFit<> emFit(20, 1e-10);
+  emFit.Estimate(observations, emDists, emWeights, true);
+  KDTreeEMFit<> treeFit(20, 1e-10, 0.0, 16);
+  treeFit.Estimate(observations, treeDists, treeWeights, true);
+
+  REQUIRE(treeFit.NumResponsibilities() == 2 * observations.n_cols);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    REQUIRE(treeWeights[i] == Approx(emWeights[i]).epsilon(1e-5));
+    for (size_t j = 0; j < 2; ++j)
+    {
+      REQUIRE(treeDists[i].Mean()[j] ==
+          Approx(emDists[i].Mean()[j]).margin(1e-5));
+      for (size_t k = 0; k < 2; ++k)
+      {
+        REQUIRE(treeDists[i].Covariance()(j, k) ==
+            Approx(emDists[i].Covariance()(j, k)).margin(1e-5));
+      }
+    }
+  }
+}
+
 /**
  * Test classification of observations by component.
  */
@@ -0,0 +1,253 @@
+/**
+ * @file tests/gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class and related classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+/**
+ * Make sure that a dimension with few distinct values gets one bin per value,
+ * and that the bin of a value agrees with the bin edges.
+ */
+TEST_CASE("HistogramTreeBuilderBinTest", "[GradientBoostingTest]")
+{
+  arma::mat data(2, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    data(0, i) = (double) (i % 5);
+    data(1, i) = (double) i;
+  }
+
+  arma::Mat<unsigned char> binnedData;
+  std::vector<arma::vec> binEdges;
+  HistogramTreeBuilder::Bin(data, 64, binnedData, binEdges);
+
+  REQUIRE(binnedData.n_rows == 2);
+  REQUIRE(binnedData.n_cols == 1000);
+  REQUIRE(binEdges.size() == 2);
+
+  // Five distinct values: four edges, halfway between the values.
+  REQUIRE(binEdges[0].n_elem == 4);
+  for (size_t j = 0; j < 4; ++j)
+    REQUIRE(binEdges[0][j] == Approx(j + 0.5));
+
+  // A thousand distinct values: at most 63 edges.
+  REQUIRE(binEdges[1].n_elem <= 63);
+  REQUIRE(binEdges[1].n_elem >= 60);
+
+  for (size_t d = 0; d < 2; ++d)
+  {
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      const size_t bin = binnedData(d, i);
+      if (bin > 0)
+        REQUIRE(data(d, i) > binEdges[d][bin - 1]);
+      if (bin < binEdges[d].n_elem)
+        REQUIRE(data(d, i) <= binEdges[d][bin]);
+    }
+  }
+}
+
+/**
+ * Make sure that gradient boosting with the squared error loss fits a simple
+ * function.
+ */
+TEST_CASE("GradientBoostingRegressionTest", "[GradientBoostingTest]")
+{
+  arma::mat data(3, 2000, arma::fill::randu);
+  arma::rowvec responses = 3.0 * data.row(0) + arma::square(data.row(1)) +
+      0.01 * arma::randn<arma::rowvec>(2000);
+
+  GradientBoosting<SquaredErrorLoss> gb(data, responses, 200, 0.1, 4);
+
+  REQUIRE(gb.NumTrees() == 200);
+  REQUIRE(gb.NumIterations() == 200);
+  REQUIRE(gb.NumOutputs() == 1);
+
+  arma::mat testData(3, 500, arma::fill::randu);
+  arma::rowvec testResponses = 3.0 * testData.row(0) +
+      arma::square(testData.row(1));
+
+  arma::rowvec predictions;
+  gb.Predict(testData, predictions);
+  REQUIRE(predictions.n_elem == 500);
+
+  // The variance of the responses is about 0.84.
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  REQUIRE(mse < 0.02);
+}
+
+/**
+ * Make sure that more iterations make the training loss smaller.
+ */
+TEST_CASE("GradientBoostingLossDecreasesTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  GradientBoosting<> gb;
+  const double loss1 = gb.Train(dataset, labels, 3, 5);
+  const double loss2 = gb.Train(dataset, labels, 3, 50);
+
+  REQUIRE(loss2 < loss1);
+  REQUIRE(gb.NumIterations() == 50);
+  REQUIRE(gb.NumTrees() == 150);
+}
+
+/**
+ * Make sure that gradient boosting is about as accurate as a random forest on
+ * the vc2 dataset, with softmax loss and with subsampling.
+ */
+TEST_CASE("GradientBoostingClassificationTest", "[GradientBoostingTest]")
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  GradientBoosting<> gb(dataset, labels, 3, 100, 0.1, 3, 5);
+  GradientBoosting<> sampledGB(dataset, labels, 3, 100, 0.1, 3, 5, 0.0, 1.0,
+      0.7, 0.7);
+
+  arma::Row<size_t> predictions, sampledPredictions;
+  arma::mat probabilities;
+  gb.Classify(testDataset, predictions, probabilities);
+  sampledGB.Classify(testDataset, sampledPredictions);
+
+  REQUIRE(probabilities.n_rows == 3);
+  REQUIRE(probabilities.n_cols == testDataset.n_cols);
+  for (size_t i = 0; i < probabilities.n_cols; ++i)
+    REQUIRE(arma::accu(probabilities.col(i)) == Approx(1.0).epsilon(1e-7));
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  const size_t sampledCorrect = arma::accu(sampledPredictions == testLabels);
+  REQUIRE(correct >= size_t(0.7 * testDataset.n_cols));
+  REQUIRE(sampledCorrect >= size_t(0.7 * testDataset.n_cols));
+}
+
+/**
+ * Make sure that the logistic loss works for two classes, and gives the same
+ * kind of model as the softmax loss with one tree per iteration.
+ */
+TEST_CASE("GradientBoostingLogisticLossTest", "[GradientBoostingTest]")
+{
+  arma::mat data(2, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (data(0, i) + data(1, i) > 1.0) ? 1 : 0;
+
+  GradientBoosting<LogisticLoss> gb(data, labels, 2, 100, 0.2, 3);
+  REQUIRE(gb.NumOutputs() == 1);
+  REQUIRE(gb.NumTrees() == 100);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  gb.Classify(data, predictions, probabilities);
+  REQUIRE(probabilities.n_rows == 2);
+  REQUIRE(arma::accu(predictions == labels) >= 950);
+
+  // The logistic loss needs two classes.
+  GradientBoosting<LogisticLoss> gb2;
+  arma::Row<size_t> threeLabels = labels;
+  threeLabels[0] = 2;
+  REQUIRE_THROWS_AS(gb2.Train(data, threeLabels, 3), std::invalid_argument);
+}
+
+/**
+ * Make sure that adding trees to a model continues from its predictions.
+ */
+TEST_CASE("GradientBoostingWarmStartTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  GradientBoosting<> gb;
+  const double loss1 = gb.Train(dataset, labels, 3, 10);
+  const double loss2 = gb.Train(dataset, labels, 3, 10, 0.1, 6, 10, 0.0, 1.0,
+      1.0, 1.0, 256, true);
+
+  REQUIRE(gb.NumIterations() == 20);
+  REQUIRE(loss2 < loss1);
+
+  // The model can't be extended with a different number of classes.
+  REQUIRE_THROWS_AS(gb.Train(dataset, labels, 4, 10, 0.1, 6, 10, 0.0, 1.0, 1.0,
+      1.0, 256, true), std::invalid_argument);
+}
+
+/**
+ * Make sure that an untrained model can't make predictions.
+ */
+TEST_CASE("GradientBoostingEmptyClassifyTest", "[GradientBoostingTest]")
+{
+  arma::mat data(3, 10, arma::fill::randu);
+  GradientBoosting<> gb;
+
+  arma::Row<size_t> predictions;
+  REQUIRE_THROWS_AS(gb.Classify(data, predictions), std::invalid_argument);
+}
+
+/**
+ * Make sure we can serialize a gradient boosting model.
+ */
+TEST_CASE("GradientBoostingSerializationTest", "[GradientBoostingTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  GradientBoosting<> gb(dataset, labels, 3, 20);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  gb.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  GradientBoosting<> xmlGB, jsonGB, binaryGB;
+  binaryGB.Train(dataset, labels, 3, 3);
+  SerializeObjectAll(gb, xmlGB, jsonGB, binaryGB);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, jsonProbabilities, binaryProbabilities;
+
+  xmlGB.Classify(dataset, xmlPredictions, xmlProbabilities);
+  jsonGB.Classify(dataset, jsonPredictions, jsonProbabilities);
+  binaryGB.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}
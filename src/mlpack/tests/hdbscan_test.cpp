@@ -0,0 +1,148 @@
+/**
+ * @file tests/hdbscan_test.cpp
+ *
+ * Test the HDBSCAN implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan/hdbscan.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::emst;
+using namespace mlpack::hdbscan;
+
+/**
+ * Generate three well-separated Gaussian blobs of 100 points each.
+ */
+void HDBSCANBlobs(arma::mat& points)
+{
+  points.randn(2, 300);
+  points.cols(0, 99) *= 0.3;
+  points.cols(100, 199) = 0.3 * points.cols(100, 199) + 10.0;
+  points.cols(200, 299) = 0.3 * points.cols(200, 299) - 10.0;
+}
+
+/**
+ * Make sure that well-separated blobs are found as separate clusters.
+ */
+TEST_CASE("HDBSCANBlobsTest", "[HDBSCANTest]")
+{
+  arma::mat points;
+  HDBSCANBlobs(points);
+
+  HDBSCAN<> h(10);
+  arma::Row<size_t> assignments;
+  const size_t clusters = h.Cluster(points, assignments);
+
+  REQUIRE(clusters == 3);
+  REQUIRE(assignments.n_elem == points.n_cols);
+
+  // The majority label of each blob must be different, and nearly all points
+  // of the blob must have it.
+  std::vector<size_t> labels;
+  for (size_t b = 0; b < 3; ++b)
+  {
+    arma::Row<size_t> counts(clusters, arma::fill::zeros);
+    for (size_t i = 100 * b; i < 100 * (b + 1); ++i)
+      if (assignments[i] != SIZE_MAX)
+        ++counts[assignments[i]];
+
+    REQUIRE(counts.max() >= 90);
+    labels.push_back(counts.index_max());
+  }
+
+  REQUIRE(labels[0] != labels[1]);
+  REQUIRE(labels[0] != labels[2]);
+  REQUIRE(labels[1] != labels[2]);
+}
+
+/**
+ * Make sure that far-away points are labeled as noise.
+ */
+TEST_CASE("HDBSCANOutlierTest", "[HDBSCANTest]")
+{
+  arma::mat points;
+  HDBSCANBlobs(points);
+  points.resize(2, 302);
+  points.col(300) = arma::vec({ 100.0, 100.0 });
+  points.col(301) = arma::vec({ -100.0, 100.0 });
+
+  HDBSCAN<> h(10);
+  arma::Row<size_t> assignments;
+  h.Cluster(points, assignments);
+
+  REQUIRE(assignments[300] == SIZE_MAX);
+  REQUIRE(assignments[301] == SIZE_MAX);
+}
+
+/**
+ * The minimum spanning tree computed by the tree-based DualTreeBoruvka with
+ * core distances must have the same total weight as the naive one.
+ */
+TEST_CASE("HDBSCANCoreDistanceMSTTest", "[HDBSCANTest]")
+{
+  arma::mat points(3, 500, arma::fill::randu);
+
+  HDBSCAN<> h(5);
+  arma::Row<size_t> assignments;
+  arma::mat mst;
+  h.Cluster(points, assignments, mst);
+
+  REQUIRE(h.CoreDistances().n_elem == points.n_cols);
+  REQUIRE(mst.n_cols == points.n_cols - 1);
+
+  DualTreeBoruvka<> naive(points, true);
+  arma::mat naiveMST;
+  naive.ComputeMST(naiveMST, h.CoreDistances());
+
+  REQUIRE(arma::accu(mst.row(2)) ==
+      Approx(arma::accu(naiveMST.row(2))).epsilon(1e-7));
+
+  // Every edge weight is at least the core distance of both endpoints.
+  for (size_t i = 0; i < mst.n_cols; ++i)
+  {
+    REQUIRE(mst(2, i) >= h.CoreDistances()[(size_t) mst(0, i)] - 1e-10);
+    REQUIRE(mst(2, i) >= h.CoreDistances()[(size_t) mst(1, i)] - 1e-10);
+  }
+}
+
+/**
+ * Reextracting clusters from the tree gives the same result as clustering.
+ */
+TEST_CASE("HDBSCANExtractClustersTest", "[HDBSCANTest]")
+{
+  arma::mat points;
+  HDBSCANBlobs(points);
+
+  HDBSCAN<> h(10);
+  arma::Row<size_t> assignments, extracted;
+  arma::mat mst;
+  const size_t clusters = h.Cluster(points, assignments, mst);
+
+  REQUIRE(h.ExtractClusters(mst, points.n_cols, extracted) == clusters);
+  REQUIRE(arma::all(assignments == extracted));
+}
+
+/**
+ * Make sure invalid parameters throw.
+ */
+TEST_CASE("HDBSCANInvalidParametersTest", "[HDBSCANTest]")
+{
+  REQUIRE_THROWS_AS(HDBSCAN<>(1), std::invalid_argument);
+
+  arma::mat points(2, 5, arma::fill::randu);
+  arma::Row<size_t> assignments;
+  HDBSCAN<> h(10);
+  REQUIRE_THROWS_AS(h.Cluster(points, assignments), std::invalid_argument);
+
+  arma::mat mst(3, 2);
+  REQUIRE_THROWS_AS(h.ExtractClusters(mst, 5, assignments),
+      std::invalid_argument);
+}
@@ -528,6 +528,138 @@ TEST_CASE("DiscreteHMMLogLikelihoodTest", "[HMMTest]")
       Approx(-24.51556128368).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch LogLikelihood() and Predict() give the same results as
+ * the versions for a single sequence.
+ */
+TEST_CASE("DiscreteHMMBatchLogLikelihoodPredictTest", "[HMMTest]")
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0].Probabilities() = "0.75 0.25 0.00 0.00";
+  emission[1].Probabilities() = "0.00 0.25 0.25 0.50";
+  emission[2].Probabilities() = "0.10 0.40 0.40 0.10";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> dataSeq(100);
+  std::vector<arma::Row<size_t>> generatedStates(100);
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    hmm.Generate(5 + i % 20, dataSeq[i], generatedStates[i]);
+
+  arma::vec logLikelihoods;
+  hmm.LogLikelihood(dataSeq, logLikelihoods);
+
+  std::vector<arma::Row<size_t>> stateSeq;
+  arma::vec predictLogLikelihoods;
+  hmm.Predict(dataSeq, stateSeq, predictLogLikelihoods);
+
+  REQUIRE(logLikelihoods.n_elem == dataSeq.size());
+  REQUIRE(stateSeq.size() == dataSeq.size());
+  REQUIRE(predictLogLikelihoods.n_elem == dataSeq.size());
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(dataSeq[i])).epsilon(1e-10));
+
+    arma::Row<size_t> states;
+    const double predictLogLikelihood = hmm.Predict(dataSeq[i], states);
+    REQUIRE(predictLogLikelihoods[i] ==
+        Approx(predictLogLikelihood).epsilon(1e-10));
+    REQUIRE(stateSeq[i].n_elem == states.n_elem);
+    for (size_t t = 0; t < states.n_elem; ++t)
+      REQUIRE(stateSeq[i][t] == states[t]);
+  }
+}
+
+/**
+ * Make sure that a left-to-right HMM gives the same results with and without
+ * the sparse transition matrix, and that beam pruning with a wide beam gives
+ * the exact Viterbi path.
+ */
+TEST_CASE("DiscreteHMMSparseTransitionTest", "[HMMTest]")
+{
+  // Each state either stays, or moves to one of the next two states.
+  const size_t states = 30;
+  arma::mat transition(states, states, arma::fill::zeros);
+  for (size_t j = 0; j < states; ++j)
+  {
+    transition(j, j) = 0.6;
+    if (j + 1 < states)
+      transition(j + 1, j) = 0.3;
+    if (j + 2 < states)
+      transition(j + 2, j) = 0.1;
+    transition.col(j) /= arma::accu(transition.col(j));
+  }
+
+  arma::vec initial(states, arma::fill::zeros);
+  initial[0] = 1.0;
+
+  std::vector<DiscreteDistribution> emission(states, DiscreteDistribution(4));
+  for (size_t j = 0; j < states; ++j)
+  {
+    emission[j].Probabilities() = arma::randu<arma::vec>(4) + 0.1;
+    emission[j].Probabilities() /= arma::accu(emission[j].Probabilities());
+  }
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+  HMM<DiscreteDistribution> sparseHmm(hmm);
+  sparseHmm.UseSparseTransition() = true;
+
+  std::vector<arma::mat> dataSeq(10);
+  std::vector<arma::Row<size_t>> generatedStates(10);
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+    hmm.Generate(40, dataSeq[i], generatedStates[i]);
+
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    REQUIRE(sparseHmm.LogLikelihood(dataSeq[i]) ==
+        Approx(hmm.LogLikelihood(dataSeq[i])).epsilon(1e-10));
+
+    arma::Row<size_t> denseStates, sparseStates, beamStates;
+    const double denseLogLik = hmm.Predict(dataSeq[i], denseStates);
+    const double sparseLogLik = sparseHmm.Predict(dataSeq[i], sparseStates);
+    const double beamLogLik = sparseHmm.Predict(dataSeq[i], beamStates,
+        1000.0);
+
+    REQUIRE(sparseLogLik == Approx(denseLogLik).epsilon(1e-10));
+    REQUIRE(beamLogLik == Approx(denseLogLik).epsilon(1e-10));
+    for (size_t t = 0; t < denseStates.n_elem; ++t)
+    {
+      REQUIRE(sparseStates[t] == denseStates[t]);
+      REQUIRE(beamStates[t] == denseStates[t]);
+    }
+
+    // A narrow beam must still give a valid path.
+    arma::Row<size_t> narrowStates;
+    const double narrowLogLik = hmm.Predict(dataSeq[i], narrowStates, 1.0);
+    REQUIRE(narrowLogLik <= denseLogLik + 1e-10);
+    REQUIRE(std::isfinite(narrowLogLik));
+    for (size_t t = 1; t < narrowStates.n_elem; ++t)
+      REQUIRE(transition(narrowStates[t], narrowStates[t - 1]) > 0.0);
+  }
+
+  // Training must give the same model, and keep the impossible transitions
+  // impossible.
+  hmm.Tolerance() = 1e-8;
+  sparseHmm.Tolerance() = 1e-8;
+  const double denseLogLik = hmm.Train(dataSeq);
+  const double sparseLogLik = sparseHmm.Train(dataSeq);
+
+  REQUIRE(sparseLogLik == Approx(denseLogLik).epsilon(1e-6));
+  for (size_t i = 0; i < transition.n_elem; ++i)
+  {
+    if (transition[i] == 0.0)
+      REQUIRE(sparseHmm.Transition()[i] == 0.0);
+    else
+      REQUIRE(sparseHmm.Transition()[i] ==
+          Approx(hmm.Transition()[i]).margin(1e-5));
+  }
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -0,0 +1,250 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSW' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include "catch.hpp"
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+
+#include <mlpack/methods/hnsw/hnsw.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Compute the fraction of the true neighbors that were found.
+ */
+static double HNSWRecall(const arma::Mat<size_t>& found,
+                         const arma::Mat<size_t>& truth)
+{
+  size_t hits = 0;
+  for (size_t i = 0; i < found.n_cols; ++i)
+  {
+    for (size_t j = 0; j < found.n_rows; ++j)
+    {
+      if (arma::any(truth.col(i) == found(j, i)))
+        ++hits;
+    }
+  }
+
+  return (double) hits / found.n_elem;
+}
+
+/**
+ * Make sure that the approximate neighbors are close to the exact neighbors
+ * found by KNN.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+  const size_t k = 10;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+
+  HNSW<> hnsw(referenceData, 16, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, k, neighbors, distances, 100);
+
+  REQUIRE(neighbors.n_rows == k);
+  REQUIRE(neighbors.n_cols == queryData.n_cols);
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.95);
+
+  // The distances must be sorted and correct.
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      REQUIRE(distances(j, i) == Approx(metric::EuclideanDistance::Evaluate(
+          queryData.col(i), referenceData.col(neighbors(j, i)))).epsilon(1e-7));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+}
+
+/**
+ * Monochromatic search must not return each point as its own neighbor.
+ */
+TEST_CASE("HNSWMonochromaticTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  const size_t k = 5;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  HNSW<> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(k, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == k);
+  REQUIRE(neighbors.n_cols == referenceData.n_cols);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < k; ++j)
+      REQUIRE(neighbors(j, i) != i);
+
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.95);
+}
+
+/**
+ * Points inserted incrementally must be found by later searches.
+ */
+TEST_CASE("HNSWIncrementalInsertTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  HNSW<> hnsw(referenceData.cols(0, 499));
+  hnsw.Insert(referenceData.cols(500, 999));
+
+  REQUIRE(hnsw.ReferenceSet().n_cols == 1000);
+  CheckMatrices(hnsw.ReferenceSet(), referenceData);
+
+  // Each point is its own nearest neighbor.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(referenceData, 1, neighbors, distances);
+
+  size_t found = 0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    if (neighbors(0, i) == i)
+      ++found;
+  REQUIRE(found >= 990);
+
+  // Every link must point to a valid point on the same level.
+  for (size_t i = 0; i < hnsw.ReferenceSet().n_cols; ++i)
+  {
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& links = hnsw.Links(i, l);
+      REQUIRE(links.size() <= ((l == 0) ? 2 : 1) * hnsw.MaxNeighbors());
+      for (size_t j = 0; j < links.size(); ++j)
+      {
+        REQUIRE(links[j] < hnsw.ReferenceSet().n_cols);
+        REQUIRE(links[j] != i);
+        REQUIRE(hnsw.Level(links[j]) >= l);
+      }
+    }
+  }
+}
+
+/**
+ * Requesting more neighbors than there are points must throw.
+ */
+TEST_CASE("HNSWInvalidKTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 20);
+  HNSW<> hnsw(referenceData);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(hnsw.Search(referenceData, 21, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(20, neighbors, distances),
+      std::invalid_argument);
+
+  arma::mat wrongDimData = arma::randu<arma::mat>(4, 20);
+  REQUIRE_THROWS_AS(hnsw.Search(wrongDimData, 1, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(HNSW<>(referenceData, 1), std::invalid_argument);
+}
+
+/**
+ * A serialized HNSW index must give the same results.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 50);
+
+  HNSW<> hnsw(referenceData, 8, 50);
+  HNSW<> xmlHnsw, jsonHnsw, binaryHnsw;
+  SerializeObjectAll(hnsw, xmlHnsw, jsonHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+  xmlHnsw.Search(queryData, 5, xmlNeighbors, xmlDistances);
+  jsonHnsw.Search(queryData, 5, jsonNeighbors, jsonDistances);
+  binaryHnsw.Search(queryData, 5, binaryNeighbors, binaryDistances);
+
+  REQUIRE(xmlHnsw.MaxNeighbors() == 8);
+  REQUIRE(jsonHnsw.EfConstruction() == 50);
+  REQUIRE(binaryHnsw.EntryPoint() == hnsw.EntryPoint());
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
+
+/**
+ * HNSW must also work with other metrics.
+ */
+TEST_CASE("HNSWManhattanTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(4, 100);
+
+  NeighborSearch<NearestNeighborSort, metric::ManhattanDistance>
+      knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 5, trueNeighbors, trueDistances);
+
+  HNSW<metric::ManhattanDistance> hnsw(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(queryData, 5, neighbors, distances);
+
+  REQUIRE(HNSWRecall(neighbors, trueNeighbors) >= 0.95);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Building the graph with multiple threads must give the same recall as with a
+ * single thread.
+ */
+TEST_CASE("HNSWParallelBuildTest", "[HNSWTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 5000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  HNSW<> parallelHnsw(referenceData);
+
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  HNSW<> sequentialHnsw(referenceData);
+  omp_set_num_threads(prevNumThreads);
+
+  arma::Mat<size_t> parallelNeighbors, sequentialNeighbors;
+  arma::mat parallelDistances, sequentialDistances;
+  parallelHnsw.Search(queryData, 10, parallelNeighbors, parallelDistances);
+  sequentialHnsw.Search(queryData, 10, sequentialNeighbors,
+      sequentialDistances);
+
+  const double parallelRecall = HNSWRecall(parallelNeighbors, trueNeighbors);
+  const double sequentialRecall = HNSWRecall(sequentialNeighbors,
+      trueNeighbors);
+  REQUIRE(parallelRecall >= 0.95);
+  REQUIRE(parallelRecall >= sequentialRecall - 0.02);
+}
+#endif
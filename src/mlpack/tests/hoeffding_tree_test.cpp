@@ -15,7 +15,9 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/quantile_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/methods/hoeffding_trees/adaptive_hoeffding_tree.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -946,6 +948,173 @@ TEST_CASE("BinaryNumericHoeffdingTreeTest", "[HoeffdingTreeTest]")
   REQUIRE(batchCorrect > 8550);
 }
 
+/**
+ * Make sure the StreamingHistogram keeps a bounded number of bins, estimates
+ * the number of values below a point well, and that a merged histogram holds
+ * all the values.
+ */
+TEST_CASE("StreamingHistogramTest", "[HoeffdingTreeTest]")
+{
+  StreamingHistogram<> h1(16), h2(16);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    h1.Insert(mlpack::math::Random());
+    h2.Insert(mlpack::math::Random());
+    REQUIRE(h1.NumBins() <= 16);
+  }
+
+  REQUIRE(h1.Count() == Approx(2000.0));
+  REQUIRE(h1.Sum(-1.0) == 0.0);
+  REQUIRE(h1.Sum(2.0) == Approx(2000.0));
+
+  // The values are uniform on [0, 1].
+  REQUIRE(h1.Sum(0.25) == Approx(500.0).margin(80.0));
+  REQUIRE(h1.Sum(0.5) == Approx(1000.0).margin(80.0));
+  REQUIRE(h1.Sum(0.75) == Approx(1500.0).margin(80.0));
+
+  h1.Merge(h2);
+  REQUIRE(h1.NumBins() <= 16);
+  REQUIRE(h1.Count() == Approx(4000.0));
+  REQUIRE(h1.Sum(0.5) == Approx(2000.0).margin(160.0));
+
+  double total = 0.0;
+  for (size_t i = 0; i < h1.NumBins(); ++i)
+    total += h1.BinCount(i);
+  REQUIRE(total == Approx(4000.0));
+
+  REQUIRE_THROWS_AS(StreamingHistogram<>(1), std::invalid_argument);
+}
+
+/**
+ * Create a QuantileNumericSplit object, feed it samples of two separated
+ * classes, and make sure the split is between them.
+ */
+TEST_CASE("QuantileNumericSplitSimpleSplitTest", "[HoeffdingTreeTest]")
+{
+  QuantileNumericSplit<GiniImpurity> split(2); // 2 classes.
+
+  // Feed it samples.
+  for (size_t i = 0; i < 500; ++i)
+  {
+    split.Train(mlpack::math::Random(), 0);
+    split.Train(mlpack::math::Random() + 1.0, 1);
+  }
+
+  // The Gini impurity for the unsplit node is 0.5, and the children should be
+  // close to pure.
+  double bestGain, secondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  REQUIRE(bestGain == Approx(0.5).margin(0.05));
+  REQUIRE(bestGain > secondBestGain);
+
+  // Now, when we ask it to split, ensure that the split value is reasonable.
+  arma::Col<size_t> childMajorities;
+  BinaryNumericSplitInfo<> splitInfo;
+  split.Split(childMajorities, splitInfo);
+
+  REQUIRE(childMajorities[0] == 0);
+  REQUIRE(childMajorities[1] == 1);
+  REQUIRE(splitInfo.CalculateDirection(0.5) == 0);
+  REQUIRE(splitInfo.CalculateDirection(1.5) == 1);
+  REQUIRE(splitInfo.CalculateDirection(-1.0) == 0);
+  REQUIRE(splitInfo.CalculateDirection(3.0) == 1);
+}
+
+/**
+ * Make sure that merging QuantileNumericSplits trained on two shards of the
+ * data gives the same majority class and a similar split as training on all
+ * of it.
+ */
+TEST_CASE("QuantileNumericSplitMergeTest", "[HoeffdingTreeTest]")
+{
+  QuantileNumericSplit<GiniImpurity> split(2), shard1(2), shard2(2);
+
+  for (size_t i = 0; i < 500; ++i)
+  {
+    const double a = mlpack::math::Random();
+    const double b = mlpack::math::Random() + 1.0;
+    const double c = mlpack::math::Random();
+    split.Train(a, 0);
+    split.Train(b, 1);
+    split.Train(c, 0);
+    shard1.Train(a, 0);
+    shard1.Train(b, 1);
+    shard2.Train(c, 0);
+  }
+
+  shard1.Merge(shard2);
+  REQUIRE(shard1.MajorityClass() == split.MajorityClass());
+  REQUIRE(shard1.MajorityProbability() ==
+      Approx(split.MajorityProbability()));
+
+  double bestGain, secondBestGain, mergedBestGain, mergedSecondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  shard1.EvaluateFitnessFunction(mergedBestGain, mergedSecondBestGain);
+  REQUIRE(mergedBestGain == Approx(bestGain).margin(0.02));
+
+  arma::Col<size_t> childMajorities;
+  BinaryNumericSplitInfo<> splitInfo;
+  shard1.Split(childMajorities, splitInfo);
+  REQUIRE(splitInfo.CalculateDirection(0.5) == 0);
+  REQUIRE(splitInfo.CalculateDirection(1.5) == 1);
+
+  // Merging splits with a different number of classes is an error.
+  QuantileNumericSplit<GiniImpurity> other(3);
+  REQUIRE_THROWS_AS(shard1.Merge(other), std::invalid_argument);
+}
+
+/**
+ * Train a HoeffdingTree with QuantileNumericSplits on the same data as the
+ * BinaryNumericHoeffdingTreeTest, and make sure it is accurate.
+ */
+TEST_CASE("QuantileNumericHoeffdingTreeTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4); // All features are numeric, except the fourth.
+  info.MapString<double>("0", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 0.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, QuantileDoubleNumericSplit> TreeType;
+  TreeType streamTree(info, 3);
+  for (size_t i = 0; i < 9000; ++i)
+    streamTree.Train(dataset.col(i), labels[i]);
+
+  REQUIRE(streamTree.NumChildren() > 0);
+  REQUIRE(streamTree.SplitDimension() == 1);
+
+  arma::Row<size_t> streamLabels(9000);
+  streamTree.Classify(dataset, streamLabels);
+
+  size_t streamCorrect = 0;
+  for (size_t i = 0; i < 9000; ++i)
+    if (labels[i] == streamLabels[i])
+      ++streamCorrect;
+
+  // Require a pretty high accuracy: 90%.
+  REQUIRE(streamCorrect > 8100);
+}
+
 /**
  * Test majority probabilities.
  */
@@ -1475,3 +1644,235 @@ TEST_CASE("HoeffdingTreeModelSerializationTest", "[HoeffdingTreeTest]")
     }
   }
 }
+
+/**
+ * Make sure that training on mini-batches of one point is the same as training
+ * on each point.
+ */
+TEST_CASE("HoeffdingTreeMiniBatchOnePointTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset(3, 3000, arma::fill::randu);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+    labels[i] = (dataset(1, i) > 0.5) ? ((dataset(2, i) > 0.3) ? 1 : 2) : 0;
+
+  data::DatasetInfo info(3);
+  HoeffdingTree<> streamTree(info, 3, 0.95, 5000, 100);
+  HoeffdingTree<> miniBatchTree(info, 3, 0.95, 5000, 100);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    streamTree.Train(dataset.col(i), labels[i]);
+    const arma::mat point = dataset.col(i);
+    miniBatchTree.TrainMiniBatch(point, labels.subvec(i, i));
+  }
+
+  REQUIRE(streamTree.NumChildren() > 0);
+  REQUIRE(streamTree.NumDescendants() == miniBatchTree.NumDescendants());
+  REQUIRE(streamTree.SplitDimension() == miniBatchTree.SplitDimension());
+
+  arma::Row<size_t> streamPredictions, miniBatchPredictions;
+  arma::rowvec streamProbabilities, miniBatchProbabilities;
+  streamTree.Classify(dataset, streamPredictions, streamProbabilities);
+  miniBatchTree.Classify(dataset, miniBatchPredictions,
+      miniBatchProbabilities);
+
+  CheckMatrices(streamPredictions, miniBatchPredictions);
+  CheckMatrices(streamProbabilities, miniBatchProbabilities);
+}
+
+/**
+ * Make sure that a tree trained on mini-batches, with categorical and numeric
+ * features, is about as accurate as a tree trained on each point.
+ */
+TEST_CASE("HoeffdingTreeMiniBatchTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(4, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(4);
+  info.Type(3) = data::Datatype::categorical;
+  info.MapString<size_t>("cat0", 3);
+  info.MapString<size_t>("cat1", 3);
+  info.MapString<size_t>("cat2", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 2.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 1.0;
+    labels[i + 2] = 1;
+  }
+
+  HoeffdingTree<> streamTree(info, 3);
+  HoeffdingTree<> miniBatchTree(info, 3);
+  for (size_t i = 0; i < 9000; ++i)
+    streamTree.Train(dataset.col(i), labels[i]);
+  for (size_t i = 0; i < 9000; i += 500)
+  {
+    const arma::mat batch = dataset.cols(i, i + 499);
+    miniBatchTree.TrainMiniBatch(batch, labels.subvec(i, i + 499));
+  }
+
+  REQUIRE(miniBatchTree.NumChildren() > 0);
+
+  arma::Row<size_t> streamPredictions, miniBatchPredictions;
+  streamTree.Classify(dataset, streamPredictions);
+  miniBatchTree.Classify(dataset, miniBatchPredictions);
+
+  const size_t streamCorrect = arma::accu(streamPredictions == labels);
+  const size_t miniBatchCorrect = arma::accu(miniBatchPredictions == labels);
+  REQUIRE(miniBatchCorrect > 6000);
+  REQUIRE(miniBatchCorrect + 300 >= streamCorrect);
+}
+
+/**
+ * Make sure that the DDM drift detector doesn't detect a drift in a stationary
+ * stream, and does detect one when the error rate increases.
+ */
+TEST_CASE("DDMDriftDetectorTest", "[HoeffdingTreeTest]")
+{
+  DDMDriftDetector detector;
+
+  // One error out of every ten predictions.
+  for (size_t i = 0; i < 2000; ++i)
+    REQUIRE(!detector.Update(i % 10 == 0));
+  REQUIRE(!detector.Warning());
+  REQUIRE(detector.ErrorRate() == Approx(0.1).epsilon(1e-5));
+
+  // Now one error out of every two predictions.
+  size_t drift = 0;
+  for (size_t i = 0; i < 500; ++i)
+  {
+    if (detector.Update(i % 2 == 0))
+    {
+      drift = i + 1;
+      break;
+    }
+  }
+
+  REQUIRE(drift > 0);
+  REQUIRE(detector.NumSamples() == 0);
+}
+
+/**
+ * Make sure that the adaptive Hoeffding tree replaces its subtree when the
+ * concept of the stream changes.
+ */
+TEST_CASE("AdaptiveHoeffdingTreeDriftTest", "[HoeffdingTreeTest]")
+{
+  arma::mat data(2, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  arma::Row<size_t> driftedLabels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    labels[i] = (data(0, i) > 0.5) ? 1 : 0;
+    driftedLabels[i] = 1 - labels[i];
+  }
+
+  data::DatasetInfo info(2);
+  AdaptiveHoeffdingTree<> tree(data, info, labels, 2);
+  REQUIRE(tree.SplitDimension() == 0);
+  REQUIRE(tree.NumReplacements() == 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(data, predictions);
+  REQUIRE(arma::accu(predictions == labels) > 18000);
+
+  // Now the labels are swapped; the tree must follow.
+  tree.Train(data, driftedLabels);
+  REQUIRE(tree.NumReplacements() > 0);
+  REQUIRE(tree.NumSamples() == 40000);
+
+  tree.Classify(data, predictions);
+  REQUIRE(arma::accu(predictions == driftedLabels) > 18000);
+}
+
+/**
+ * Make sure that no more than the given number of leaves collect statistics,
+ * and that the tree still predicts reasonably well.
+ */
+TEST_CASE("AdaptiveHoeffdingTreeMaxActiveLeavesTest", "[HoeffdingTreeTest]")
+{
+  // Generate data.
+  arma::mat dataset(3, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(3); // All features are numeric.
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+
+  AdaptiveHoeffdingTree<> tree(dataset, info, labels, 3, 3);
+
+  REQUIRE(tree.NumLeaves() > 3);
+  REQUIRE(tree.NumActiveLeaves() <= 3);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  REQUIRE(arma::accu(predictions == labels) > 6000);
+}
+
+/**
+ * Make sure that the adaptive Hoeffding tree can be serialized, including its
+ * split statistics.
+ */
+TEST_CASE("AdaptiveHoeffdingTreeSerializationTest", "[HoeffdingTreeTest]")
+{
+  arma::mat data(3, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    labels[i] = (data(1, i) > 0.4) ? ((data(2, i) > 0.7) ? 2 : 1) : 0;
+
+  data::DatasetInfo info(3);
+  AdaptiveHoeffdingTree<> tree(data, info, labels, 3, 4);
+  AdaptiveHoeffdingTree<> xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, jsonTree, binaryTree);
+
+  REQUIRE(xmlTree.NumLeaves() == tree.NumLeaves());
+  REQUIRE(jsonTree.NumActiveLeaves() == tree.NumActiveLeaves());
+  REQUIRE(binaryTree.NumNodes() == tree.NumNodes());
+
+  arma::Row<size_t> predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  tree.Classify(data, predictions);
+  xmlTree.Classify(data, xmlPredictions);
+  jsonTree.Classify(data, jsonPredictions);
+  binaryTree.Classify(data, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+
+  // The loaded trees can continue training.
+  arma::mat moreData(3, 1000, arma::fill::randu);
+  arma::Row<size_t> moreLabels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    moreLabels[i] = (moreData(1, i) > 0.4) ? 1 : 0;
+
+  binaryTree.Train(moreData, moreLabels);
+  REQUIRE(binaryTree.NumSamples() == 6000);
+  REQUIRE(binaryTree.NumActiveLeaves() <= 4);
+}
@@ -0,0 +1,194 @@
+/**
+ * @file tests/hogwild_sgd_test.cpp
+ *
+ * Tests for the HogwildSGD optimizer and the sparse gradients of the linear
+ * models it is used with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/hogwild_sgd.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::regression;
+using namespace mlpack::svd;
+using namespace mlpack::svm;
+
+/**
+ * Check that a sparse gradient matches the dense gradient on its nonzero
+ * elements and, if the dense gradient has no regularization, everywhere.
+ */
+void CheckSparseGradient(const arma::mat& dense,
+                         const arma::sp_mat& sparse,
+                         const bool unregularized)
+{
+  REQUIRE(sparse.n_rows == dense.n_rows);
+  REQUIRE(sparse.n_cols == dense.n_cols);
+
+  if (unregularized)
+  {
+    CheckMatrices(dense, arma::mat(sparse));
+    return;
+  }
+
+  for (arma::sp_mat::const_iterator it = sparse.begin(); it != sparse.end();
+       ++it)
+  {
+    REQUIRE((*it) == Approx(dense(it.row(), it.col())).epsilon(1e-7));
+  }
+}
+
+/**
+ * Generate a sparse dataset whose labels are given by a random linear model.
+ */
+void SparseLinearDataset(const size_t dimensionality,
+                         const size_t points,
+                         arma::sp_mat& data,
+                         arma::Row<size_t>& labels)
+{
+  data.sprandu(dimensionality, points, 0.05);
+  const arma::rowvec weights = arma::randn<arma::rowvec>(dimensionality);
+  const arma::rowvec scores = weights * data;
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = (scores[i] > 0.0) ? 1 : 0;
+}
+
+/**
+ * Make sure that the sparse gradients of the linear models only touch the
+ * features of the batch, and are otherwise the same as the dense gradients.
+ */
+TEST_CASE("HogwildSGDSparseGradientTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseLinearDataset(50, 200, data, labels);
+
+  for (const double lambda : { 0.0, 0.5 })
+  {
+    const bool unregularized = (lambda == 0.0);
+
+    LogisticRegressionFunction<arma::sp_mat> lrf(data, labels, lambda);
+    const arma::mat lrParameters = arma::randn<arma::rowvec>(51);
+    arma::mat lrGradient;
+    arma::sp_mat lrSparseGradient;
+    lrf.Gradient(lrParameters, 10, lrGradient, 5);
+    lrf.Gradient(lrParameters, 10, lrSparseGradient, 5);
+    CheckSparseGradient(lrGradient, lrSparseGradient, unregularized);
+    // Only the intercept and the features of the batch can be touched.
+    REQUIRE(lrSparseGradient.n_nonzero <=
+        arma::sp_mat(data.cols(10, 14)).n_nonzero + 1);
+
+    SoftmaxRegressionFunction<arma::sp_mat> srf(data, labels, 2, lambda,
+        true);
+    const arma::mat srParameters = srf.GetInitialPoint();
+    arma::mat srGradient;
+    arma::sp_mat srSparseGradient;
+    srf.Gradient(srParameters, 10, srGradient, 5);
+    srf.Gradient(srParameters, 10, srSparseGradient, 5);
+    CheckSparseGradient(srGradient, srSparseGradient, unregularized);
+
+    LinearSVMFunction<arma::sp_mat> svmf(data, labels, 2, lambda, 1.0, true);
+    const arma::mat svmParameters = svmf.InitialPoint();
+    arma::mat svmGradient;
+    arma::sp_mat svmSparseGradient;
+    svmf.Gradient(svmParameters, 10, svmGradient, 5);
+    svmf.Gradient(svmParameters, 10, svmSparseGradient, 5);
+    CheckSparseGradient(svmGradient, svmSparseGradient, unregularized);
+  }
+}
+
+/**
+ * Train logistic regression on sparse data with HogwildSGD.
+ */
+TEST_CASE("HogwildSGDLogisticRegressionTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseLinearDataset(100, 4000, data, labels);
+
+  LogisticRegression<arma::sp_mat> lr(data.n_rows, 0.0);
+  HogwildSGD optimizer(0.5, 50, 1e-8);
+  lr.Train(data, labels, optimizer);
+
+  REQUIRE(lr.ComputeAccuracy(data, labels) >= 95.0);
+}
+
+/**
+ * Train softmax regression and a linear SVM on sparse data with HogwildSGD.
+ */
+TEST_CASE("HogwildSGDSoftmaxRegressionLinearSVMTest", "[HogwildSGDTest]")
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SparseLinearDataset(100, 4000, data, labels);
+
+  SoftmaxRegression<arma::sp_mat> sr(data.n_rows, 2, true);
+  sr.Lambda() = 0.0;
+  sr.Train(data, labels, 2, HogwildSGD(0.5, 50, 1e-8));
+  REQUIRE(sr.ComputeAccuracy(data, labels) >= 95.0);
+
+  LinearSVM<arma::sp_mat> svm(data, labels, 2, 0.0, 1.0, false,
+      HogwildSGD(0.1, 50, 1e-8));
+  REQUIRE(svm.ComputeAccuracy(data, labels) >= 0.95);
+}
+
+/**
+ * Train regularized SVD with HogwildSGD; this is the same setup as the
+ * ens::ParallelSGD test in regularized_svd_test.cpp.
+ */
+TEST_CASE("HogwildSGDRegularizedSVDTest", "[HogwildSGDTest]")
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+
+  // Make rating entries from random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, 0.01);
+  HogwildSGD optimizer(0.01, 0, 1e-5);
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+  REQUIRE(relativeError == Approx(0.0).margin(1e-2));
+
+  // The decomposition can also be trained through RegularizedSVD.
+  arma::mat u, v;
+  RegularizedSVD<> rSVD(10, 0.01, 0.01);
+  HogwildSGD svdOptimizer(0.01, 20);
+  rSVD.Apply(data, rank, u, v, svdOptimizer);
+  REQUIRE(u.n_cols == rank);
+  REQUIRE(v.n_rows == rank);
+}
@@ -324,6 +324,169 @@ TEST_CASE("HPTTest", "[HPTTest]")
   REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
 }
 
+/**
+ * Test that the parallel grid search of HyperParameterTuner finds the same
+ * hyper-parameters and model as the serial one.
+ */
+TEST_CASE("HPTParallelGridSearchTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double serialLambda1, serialLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      serialHpt(validationSize, xs, ys);
+  std::tie(serialLambda1, serialLambda2) = serialHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  double parallelLambda1, parallelLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      parallelHpt(validationSize, xs, ys);
+  parallelHpt.NumThreads() = 4;
+  std::tie(parallelLambda1, parallelLambda2) = parallelHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(serialHpt.BestObjective() ==
+      Approx(parallelHpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(serialLambda1 == Approx(parallelLambda1).epsilon(1e-7));
+  REQUIRE(serialLambda2 == Approx(parallelLambda2).epsilon(1e-7));
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(parallelHpt.BestModel(), validationXs,
+      validationYs);
+  REQUIRE(serialHpt.BestObjective() == Approx(objective).epsilon(1e-7));
+}
+
+/**
+ * Test that the successive halving of HyperParameterTuner gives the result of
+ * a full grid search when there is a single round, and otherwise returns a
+ * candidate of the grid evaluated with all the training data.
+ */
+TEST_CASE("HPTSuccessiveHalvingTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  // With a minimum training fraction of 1, only the last round is run.
+  double lambda1, lambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      hpt(validationSize, xs, ys);
+  hpt.SuccessiveHalving() = true;
+  hpt.MinTrainingFraction() = 1.0;
+  hpt.NumThreads() = 2;
+  std::tie(lambda1, lambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(lambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(lambda2).epsilon(1e-7));
+
+  // With several rounds, the result can't be better than the full grid
+  // search, and the best model is trained on all the training data.
+  hpt.MinTrainingFraction() = 0.25;
+  hpt.ReductionFactor() = 2.0;
+  std::tie(lambda1, lambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(arma::any(lambda1Set == lambda1));
+  REQUIRE(arma::any(lambda2Set == lambda2));
+  REQUIRE(hpt.BestObjective() >= expectedObjective - 1e-7);
+
+  SimpleCV<LARS, MSE> cv(validationSize, xs, ys);
+  REQUIRE(hpt.BestObjective() == Approx(cv.Evaluate(transposeData,
+      useCholesky, lambda1, lambda2)).epsilon(1e-7));
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(hpt.BestModel(), validationXs,
+      validationYs);
+  REQUIRE(hpt.BestObjective() == Approx(objective).epsilon(1e-7));
+
+  // Successive halving needs a reduction factor greater than 1.
+  hpt.ReductionFactor() = 1.0;
+  REQUIRE_THROWS_AS(hpt.Optimize(Fixed(transposeData), Fixed(useCholesky),
+      lambda1Set, lambda2Set), std::invalid_argument);
+}
+
+/**
+ * Test that SimpleCV trains on the first points of the training set when the
+ * training fraction is less than 1.
+ */
+TEST_CASE("SimpleCVTrainingFractionTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 100);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.1 * arma::randn(1, 100);
+
+  SimpleCV<LARS, MSE> cv(0.2, xs, ys);
+  cv.TrainingFraction() = 0.5;
+  const double objective = cv.Evaluate(true, false, 0.01, 0.1);
+
+  LARS model(xs.cols(0, 39), ys.cols(0, 39), true, false, 0.01, 0.1);
+  REQUIRE(objective == Approx(MSE::Evaluate(model, xs.cols(80, 99),
+      ys.cols(80, 99))).epsilon(1e-7));
+
+  cv.TrainingFraction() = 0.0;
+  REQUIRE_THROWS_AS(cv.Evaluate(true, false, 0.01, 0.1),
+      std::invalid_argument);
+}
+
+/**
+ * Test that CVFunction does not run cross-validation again for parameters
+ * that have already been evaluated.
+ */
+TEST_CASE("CVFunctionCacheTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 100);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.1 * arma::randn(1, 100);
+
+  SimpleCV<LARS, MSE> cv(0.2, xs, ys);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 4);
+
+  CVFunction<decltype(cv), LARS, 4> cvFun(cv, datasetInfo, 0.0, 0.0);
+
+  arma::mat candidates("1 1 1; 0 0 0; 0.1 1.0 0.1; 0.2 0.2 0.2");
+  arma::rowvec objectives;
+  cvFun.EvaluateCandidates(candidates, objectives, 2);
+
+  REQUIRE(cvFun.NumEvaluations() == 2);
+  REQUIRE(objectives.n_elem == 3);
+  REQUIRE(objectives[0] == objectives[2]);
+  REQUIRE(objectives[0] == Approx(cv.Evaluate(true, false, 0.1, 0.2))
+      .epsilon(1e-7));
+  REQUIRE(objectives[1] == Approx(cv.Evaluate(true, false, 1.0, 0.2))
+      .epsilon(1e-7));
+
+  // Evaluating a known candidate again gives the stored objective.
+  REQUIRE(cvFun.Evaluate(candidates.col(1)) == objectives[1]);
+  REQUIRE(cvFun.NumEvaluations() == 2);
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
@@ -156,4 +156,43 @@ TEST_CASE("ImageInfoSerialization", "[ImageLoadTest]")
   REQUIRE(info.Quality() == binaryInfo.Quality());
 }
 
+/**
+ * Test that many images are loaded in parallel into the right columns, and
+ * that they can be resized while they are loaded.
+ */
+TEST_CASE("LoadVectorImageParallelResizeTest", "[ImageLoadTest]")
+{
+  arma::Mat<unsigned char> single;
+  data::ImageInfo info;
+  REQUIRE(data::Load("test_image.png", single, info, false) == true);
+
+  std::vector<std::string> files(20, "test_image.png");
+  arma::mat matrix;
+  data::ImageInfo vectorInfo;
+  REQUIRE(data::Load(files, matrix, vectorInfo, false) == true);
+  REQUIRE(matrix.n_cols == 20);
+  for (size_t i = 0; i < matrix.n_cols; ++i)
+  {
+    CheckMatrices(arma::mat(matrix.col(i)),
+        arma::conv_to<arma::mat>::from(single));
+  }
+
+  // Resize the images to half their size.
+  arma::Mat<unsigned char> resized;
+  data::ImageInfo resizedInfo;
+  REQUIRE(data::Load(files, resized, resizedInfo, data::ImageInfo(25, 20),
+      false) == true);
+  REQUIRE(resizedInfo.Width() == 25);
+  REQUIRE(resizedInfo.Height() == 20);
+  REQUIRE(resizedInfo.Channels() == 3);
+  REQUIRE(resized.n_rows == 25 * 20 * 3);
+  REQUIRE(resized.n_cols == 20);
+  for (size_t i = 1; i < resized.n_cols; ++i)
+    REQUIRE(arma::all(resized.col(i) == resized.col(0)));
+
+  // A missing file makes the load fail.
+  files[7] = "missing_image.png";
+  REQUIRE(data::Load(files, matrix, vectorInfo, false) == false);
+}
+
 #endif // HAS_STB.
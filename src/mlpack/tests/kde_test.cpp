@@ -10,6 +10,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/grid_kde.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
@@ -1297,3 +1298,322 @@ TEST_CASE("GaussianBreadthDualKDTreeMonteCarloKDE", "[KDETest]")
 
   REQUIRE(correctResults > 70);
 }
+
+/**
+ * Test that the grid approximation is within the relative error tolerance of
+ * the exact result in one dimension.
+ */
+TEST_CASE("GridKDEOneDimensionalTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(1, 1000);
+  arma::mat query = 0.8 * arma::randu(1, 200) + 0.1;
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec gridEstimations;
+  const double kernelBandwidth = 0.05;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  // Grid KDE.
+  GridKDE kde(relError, 0.0, kernel);
+  kde.Train(reference);
+  kde.Evaluate(query, gridEstimations);
+
+  REQUIRE(gridEstimations.n_elem == query.n_cols);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(gridEstimations[i]).epsilon(relError));
+}
+
+/**
+ * Test the grid approximation in two and three dimensions.
+ */
+TEST_CASE("GridKDEMultiDimensionalTest", "[KDETest]")
+{
+  const double relError = 0.05;
+  for (size_t dims = 2; dims <= 3; ++dims)
+  {
+    arma::mat reference = arma::randu(dims, 2000);
+    arma::mat query = 0.6 * arma::randu(dims, 100) + 0.2;
+    arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+    arma::vec gridEstimations;
+
+    GaussianKernel kernel(0.2);
+    BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+    GridKDE kde(relError, 0.0, kernel);
+    kde.Train(reference);
+    kde.Evaluate(query, gridEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      REQUIRE(bfEstimations[i] ==
+          Approx(gridEstimations[i]).epsilon(relError));
+    }
+  }
+}
+
+/**
+ * Test that monochromatic grid evaluation ignores the contribution of each
+ * point to itself, like the tree-based KDE.
+ */
+TEST_CASE("GridKDEMonochromaticTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(1, 500);
+  const double relError = 0.05;
+
+  GaussianKernel kernel(0.1);
+  arma::vec bfEstimations = arma::vec(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfEstimations, kernel);
+  bfEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  GridKDE kde(relError, 0.0, kernel);
+  kde.Train(reference);
+  arma::vec gridEstimations;
+  kde.Evaluate(gridEstimations);
+
+  // Points on the edges of the data have low density, so only check the
+  // interior points.
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    if (reference(0, i) < 0.1 || reference(0, i) > 0.9)
+      continue;
+
+    REQUIRE(bfEstimations[i] == Approx(gridEstimations[i]).epsilon(relError));
+  }
+}
+
+/**
+ * Make sure that query points far away from the reference set get an estimate
+ * of 0 and that changing the bandwidth rebuilds the grid.
+ */
+TEST_CASE("GridKDEBandwidthChangeTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 500);
+  arma::mat query = arma::randu(2, 50);
+  query.col(0).fill(100.0);
+
+  GridKDE kde(0.05, 0.0, GaussianKernel(0.1));
+  kde.Train(reference);
+  const double oldSpacing = kde.Spacing();
+
+  kde.Kernel(GaussianKernel(0.3));
+  REQUIRE(kde.Spacing() == Approx(3 * oldSpacing).epsilon(1e-5));
+
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  GaussianKernel kernel(0.3);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  arma::vec gridEstimations;
+  kde.Evaluate(query, gridEstimations);
+  REQUIRE(gridEstimations[0] == 0.0);
+  for (size_t i = 1; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(gridEstimations[i]).epsilon(0.05));
+}
+
+/**
+ * Make sure the grid approximation rejects data with too many dimensions.
+ */
+TEST_CASE("GridKDEInvalidDimensionsTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(4, 100);
+  GridKDE kde;
+  REQUIRE_THROWS_AS(kde.Train(reference), std::invalid_argument);
+
+  arma::vec estimations;
+  REQUIRE_THROWS_AS(kde.Evaluate(estimations), std::runtime_error);
+}
+
+/**
+ * Make sure a serialized grid model gives the same results.
+ */
+TEST_CASE("GridKDESerializationTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 500);
+  arma::mat query = arma::randu(2, 100);
+
+  GridKDE kde(0.1, 0.0, GaussianKernel(0.2));
+  kde.Train(reference);
+  arma::vec estimations;
+  kde.Evaluate(query, estimations);
+
+  GridKDE kdeXml, kdeText, kdeBinary;
+  SerializeObjectAll(kde, kdeXml, kdeText, kdeBinary);
+
+  REQUIRE(kdeXml.IsTrained() == true);
+  REQUIRE(kdeText.IsTrained() == true);
+  REQUIRE(kdeBinary.IsTrained() == true);
+  REQUIRE(kdeBinary.RelativeError() == Approx(0.1).epsilon(1e-10));
+  REQUIRE(kdeBinary.Kernel().Bandwidth() == Approx(0.2).epsilon(1e-10));
+
+  arma::vec xmlEstimations, textEstimations, binaryEstimations;
+  kdeXml.Evaluate(query, xmlEstimations);
+  kdeText.Evaluate(query, textEstimations);
+  kdeBinary.Evaluate(query, binaryEstimations);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    REQUIRE(estimations[i] == Approx(xmlEstimations[i]).epsilon(1e-8));
+    REQUIRE(estimations[i] == Approx(textEstimations[i]).epsilon(1e-8));
+    REQUIRE(estimations[i] == Approx(binaryEstimations[i]).epsilon(1e-8));
+  }
+}
+
+/**
+ * Test that single-tree evaluations of a precomputed model use Taylor
+ * expansions and respect the error tolerance, and that the moments are saved
+ * with the model.
+ */
+TEST_CASE("GaussianKDEPrecomputedTaylorTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 20);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.5;
+  const double relError = 0.05;
+
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  typedef KDE<GaussianKernel, metric::EuclideanDistance, arma::mat,
+      tree::KDTree> KDEType;
+  KDEType kde(relError, 0.0, kernel, KDEMode::SINGLE_TREE_MODE);
+  kde.Train(reference);
+  REQUIRE(!kde.Precomputed());
+
+  arma::vec estimations;
+  kde.Evaluate(query, estimations);
+  REQUIRE(kde.TaylorApproximations() == 0);
+
+  kde.Precompute();
+  REQUIRE(kde.Precomputed());
+  kde.Evaluate(query, estimations);
+  REQUIRE(kde.TaylorApproximations() > 0);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(estimations[i]).epsilon(relError));
+
+  KDEType kdeXml, kdeText, kdeBinary;
+  SerializeObjectAll(kde, kdeXml, kdeText, kdeBinary);
+  REQUIRE(kdeXml.Precomputed());
+  REQUIRE(kdeText.Precomputed());
+  REQUIRE(kdeBinary.Precomputed());
+
+  arma::vec binaryEstimations;
+  kdeBinary.Evaluate(query, binaryEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(estimations[i] == Approx(binaryEstimations[i]).epsilon(1e-8));
+
+  // Training again discards the moments.
+  kde.Train(reference);
+  REQUIRE(!kde.Precomputed());
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Test that the parallel dual-tree traversal respects the error tolerance, in
+ * both the bichromatic and monochromatic settings.
+ */
+TEST_CASE("GaussianKDEParallelDualTreeTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 300);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec bfMonoEstimations = arma::vec(reference.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations, treeMonoEstimations;
+  const double kernelBandwidth = 0.12;
+  const double relError = 0.05;
+
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      kde(relError, 0.0, kernel);
+  kde.Train(reference);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  kde.Evaluate(query, treeEstimations);
+  kde.Evaluate(treeMonoEstimations);
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(bfEstimations[i] == Approx(treeEstimations[i]).epsilon(relError));
+
+  // Brute-force monochromatic estimations, excluding each point itself.
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    for (size_t j = 0; j < reference.n_cols; ++j)
+    {
+      if (i != j)
+      {
+        bfMonoEstimations[i] += kernel.Evaluate(
+            metric::EuclideanDistance::Evaluate(reference.col(i),
+                                                reference.col(j)));
+      }
+    }
+  }
+  bfMonoEstimations /= reference.n_cols;
+
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    REQUIRE(bfMonoEstimations[i] ==
+        Approx(treeMonoEstimations[i]).epsilon(relError));
+  }
+}
+
+/**
+ * Test that the parallel single-tree and dual-tree traversals with Monte Carlo
+ * estimations give results within the relative error for most query points,
+ * and that the exact single-tree traversal respects the error tolerance.
+ */
+TEST_CASE("GaussianKDEParallelMonteCarloTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.05;
+
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  metric::EuclideanDistance metric;
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      dualKDE(relError, 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric, true,
+      0.95, 100, 3, 0.8);
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      singleKDE(relError, 0.0, kernel, KDEMode::SINGLE_TREE_MODE, metric, true,
+      0.95, 100, 3, 0.8);
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      exactKDE(relError, 0.0, kernel, KDEMode::SINGLE_TREE_MODE);
+  dualKDE.Train(reference);
+  singleKDE.Train(reference);
+  exactKDE.Train(reference);
+
+  arma::vec dualEstimations, singleEstimations, exactEstimations;
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  dualKDE.Evaluate(query, dualEstimations);
+  singleKDE.Evaluate(query, singleEstimations);
+  exactKDE.Evaluate(query, exactEstimations);
+  omp_set_num_threads(prevNumThreads);
+
+  // The Monte Carlo estimation has a random component so it can fail.
+  // Therefore we require a reasonable amount of results to be right.
+  size_t dualCorrect = 0, singleCorrect = 0;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    if (std::abs((bfEstimations[i] - dualEstimations[i]) / bfEstimations[i]) <
+        relError)
+      ++dualCorrect;
+    if (std::abs((bfEstimations[i] - singleEstimations[i]) /
+        bfEstimations[i]) < relError)
+      ++singleCorrect;
+    REQUIRE(bfEstimations[i] == Approx(exactEstimations[i]).epsilon(relError));
+  }
+
+  REQUIRE(dualCorrect > 70);
+  REQUIRE(singleCorrect > 70);
+}
+#endif
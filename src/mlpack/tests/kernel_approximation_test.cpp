@@ -0,0 +1,218 @@
+/**
+ * @file tests/kernel_approximation_test.cpp
+ *
+ * Tests for the explicit kernel feature maps and KernelApproximationClassifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kernel_approximation/random_fourier_features.hpp>
+#include <mlpack/methods/kernel_approximation/nystroem_features.hpp>
+#include <mlpack/methods/kernel_approximation/kernel_approximation_classifier.hpp>
+#include <mlpack/methods/nystroem_method/ordered_selection.hpp>
+#include <mlpack/methods/linear_svm/linear_svm.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+
+#include "catch.hpp"
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+
+// Compute the exact kernel matrix between the columns of a and b.
+template<typename KernelType>
+arma::mat ExactKernelMatrix(const arma::mat& a,
+                            const arma::mat& b,
+                            KernelType kernel)
+{
+  arma::mat k(a.n_cols, b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      k(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  return k;
+}
+
+// Create two classes that are not linearly separable: a ball around the origin
+// and a shell around it.
+void RingDataset(const size_t points,
+                 arma::mat& data,
+                 arma::Row<size_t>& labels)
+{
+  data.randn(2, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 2;
+    const double radius = (labels[i] == 0) ? 0.5 : 2.0;
+    data.col(i) *= (radius + 0.1 * math::Random()) / arma::norm(data.col(i));
+  }
+}
+
+/**
+ * Inner products of random Fourier features should approximate the Gaussian
+ * kernel.
+ */
+TEST_CASE("RandomFourierFeaturesGaussianTest", "[KernelApproximationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 60);
+  GaussianKernel kernel(0.8);
+
+  RandomFourierFeatures<GaussianKernel> rff(10000, kernel);
+  rff.Train(data);
+  arma::mat features;
+  rff.Transform(data, features);
+
+  REQUIRE(features.n_rows == 10000);
+  REQUIRE(features.n_cols == 60);
+
+  const arma::mat approx = features.t() * features;
+  const arma::mat exact = ExactKernelMatrix(data, data, kernel);
+  REQUIRE(arma::abs(approx - exact).max() < 0.06);
+}
+
+/**
+ * Inner products of random Fourier features should approximate the Laplacian
+ * kernel.
+ */
+TEST_CASE("RandomFourierFeaturesLaplacianTest", "[KernelApproximationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 60);
+  LaplacianKernel kernel(1.5);
+
+  RandomFourierFeatures<LaplacianKernel> rff(10000, kernel);
+  rff.Train(data);
+  arma::mat features;
+  rff.Transform(data, features);
+
+  const arma::mat approx = features.t() * features;
+  const arma::mat exact = ExactKernelMatrix(data, data, kernel);
+  REQUIRE(arma::abs(approx - exact).max() < 0.06);
+}
+
+/**
+ * Make sure that untrained or mismatched feature maps throw.
+ */
+TEST_CASE("KernelFeatureMapErrorsTest", "[KernelApproximationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 20);
+  arma::mat features;
+
+  RandomFourierFeatures<GaussianKernel> rff(10);
+  REQUIRE_THROWS_AS(rff.Transform(data, features), std::runtime_error);
+  rff.Train(data);
+  arma::mat wrongData = arma::randu<arma::mat>(4, 20);
+  REQUIRE_THROWS_AS(rff.Transform(wrongData, features), std::invalid_argument);
+
+  NystroemFeatures<GaussianKernel, OrderedSelection> nf(30);
+  REQUIRE_THROWS_AS(nf.Transform(data, features), std::runtime_error);
+  REQUIRE_THROWS_AS(nf.Train(data), std::invalid_argument);
+}
+
+/**
+ * With every training point as a landmark, the Nystroem features reproduce the
+ * kernel matrix of the training set, and the map extends to new points.
+ */
+TEST_CASE("NystroemFeaturesFullRankTest", "[KernelApproximationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 20);
+  GaussianKernel kernel(0.3);
+
+  NystroemFeatures<GaussianKernel, OrderedSelection> nf(20, kernel);
+  nf.Train(data);
+  arma::mat features;
+  nf.Transform(data, features);
+
+  REQUIRE(features.n_rows == 20);
+  CheckMatrices(features.t() * features, ExactKernelMatrix(data, data, kernel),
+      1e-3);
+
+  // Points that are landmarks have the exact kernel with all other points.
+  arma::mat newData = arma::randu<arma::mat>(3, 10);
+  arma::mat newFeatures;
+  nf.Transform(newData, newFeatures);
+  CheckMatrices(features.t() * newFeatures,
+      ExactKernelMatrix(data, newData, kernel), 1e-3);
+}
+
+/**
+ * Make sure the default k-means landmark selection gives a reasonable
+ * approximation.
+ */
+TEST_CASE("NystroemFeaturesKMeansTest", "[KernelApproximationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(2, 500);
+  GaussianKernel kernel(1.0);
+
+  NystroemFeatures<GaussianKernel> nf(50, kernel);
+  nf.Train(data);
+  arma::mat features;
+  nf.Transform(data, features);
+
+  REQUIRE(nf.Landmarks().n_cols == 50);
+  const arma::mat exact = ExactKernelMatrix(data, data, kernel);
+  const double error = arma::norm(features.t() * features - exact, "fro") /
+      arma::norm(exact, "fro");
+  REQUIRE(error < 0.01);
+}
+
+/**
+ * A linear SVM on random Fourier features should separate a ring from the
+ * ball inside it.
+ */
+TEST_CASE("KernelApproximationLinearSVMTest", "[KernelApproximationTest]")
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  RingDataset(1000, data, labels);
+  RingDataset(200, testData, testLabels);
+
+  KernelApproximationClassifier<RandomFourierFeatures<GaussianKernel>,
+      svm::LinearSVM<>> c(RandomFourierFeatures<GaussianKernel>(300,
+      GaussianKernel(1.0)), svm::LinearSVM<>(2, 1e-4, 1.0, true));
+  c.Train(data, labels, 2);
+
+  arma::Row<size_t> predictions;
+  c.Classify(testData, predictions);
+  const double accuracy = arma::accu(predictions == testLabels) /
+      (double) testLabels.n_elem;
+  REQUIRE(accuracy > 0.95);
+}
+
+/**
+ * Logistic regression on Nystroem features should separate a ring from the
+ * ball inside it, and the model should survive serialization.
+ */
+TEST_CASE("KernelApproximationLogisticRegressionTest",
+          "[KernelApproximationTest]")
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  RingDataset(1000, data, labels);
+  RingDataset(200, testData, testLabels);
+
+  typedef KernelApproximationClassifier<NystroemFeatures<GaussianKernel>,
+      regression::LogisticRegression<>> ClassifierType;
+  ClassifierType c(NystroemFeatures<GaussianKernel>(30, GaussianKernel(1.0)));
+  c.Train(data, labels);
+
+  arma::Row<size_t> predictions;
+  c.Classify(testData, predictions);
+  const double accuracy = arma::accu(predictions == testLabels) /
+      (double) testLabels.n_elem;
+  REQUIRE(accuracy > 0.95);
+
+  ClassifierType xmlC, jsonC, binaryC;
+  SerializeObjectAll(c, xmlC, jsonC, binaryC);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlC.Classify(testData, xmlPredictions);
+  jsonC.Classify(testData, jsonPredictions);
+  binaryC.Classify(testData, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
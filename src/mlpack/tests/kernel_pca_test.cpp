@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include "catch.hpp"
@@ -147,3 +148,63 @@ TEST_CASE("CircleTransformationTestNystroem", "[KernelPCATest]")
   REQUIRE(ranges[0].Contains(ranges[2]) == false);
   REQUIRE(ranges[1].Contains(ranges[2]) == false);
 }
+
+/**
+ * The eigenvalues found with random Fourier features should be close to those
+ * of the exact centered kernel matrix.
+ */
+TEST_CASE("RandomFourierEigenvaluesTest", "[KernelPCATest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+
+  KernelPCA<GaussianKernel> naive(GaussianKernel(0.5));
+  arma::mat naiveTransformed;
+  arma::vec naiveEigval;
+  naive.Apply(dataset, naiveTransformed, naiveEigval);
+
+  KernelPCA<GaussianKernel, RandomFourierKernelRule<GaussianKernel, 4000> >
+      rff(GaussianKernel(0.5));
+  arma::mat rffTransformed, rffEigvec;
+  arma::vec rffEigval;
+  rff.Apply(dataset, rffTransformed, rffEigval, rffEigvec);
+
+  REQUIRE(rffTransformed.n_cols == dataset.n_cols);
+  REQUIRE(rffEigvec.n_rows == dataset.n_cols);
+  REQUIRE(rffEigval.n_elem >= 3);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(std::abs(rffEigval[i] - naiveEigval[i]) <= 0.1 * naiveEigval[0]);
+
+  // The eigenvectors of the kernel matrix are orthonormal.
+  CheckMatrices(rffEigvec.head_cols(3).t() * rffEigvec.head_cols(3),
+      arma::eye<arma::mat>(3, 3), 1e-3);
+}
+
+/**
+ * When only a few components are requested, the naive method finds them with
+ * a randomized eigensolver; the eigenvalues should be those of the full
+ * eigendecomposition.
+ */
+TEST_CASE("NaiveTruncatedEigenvaluesTest", "[KernelPCATest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+
+  KernelPCA<GaussianKernel> kpca(GaussianKernel(0.5));
+  arma::mat fullTransformed;
+  arma::vec fullEigval;
+  kpca.Apply(dataset, fullTransformed, fullEigval);
+
+  arma::mat transformed, eigvec;
+  arma::vec eigval;
+  kpca.Apply(dataset, transformed, eigval, eigvec, 3);
+
+  REQUIRE(eigval.n_elem == 3);
+  REQUIRE(eigvec.n_rows == dataset.n_cols);
+  REQUIRE(eigvec.n_cols == 3);
+  REQUIRE(transformed.n_rows == 3);
+  REQUIRE(transformed.n_cols == dataset.n_cols);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(std::abs(eigval[i] - fullEigval[i]) <= 1e-4 * fullEigval[0]);
+
+  // The eigenvectors of the kernel matrix are orthonormal.
+  CheckMatrices(eigvec.t() * eigvec, arma::eye<arma::mat>(3, 3), 1e-6);
+}
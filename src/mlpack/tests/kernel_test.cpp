@@ -14,10 +14,12 @@
 #include <mlpack/core/kernels/epanechnikov_kernel.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include <mlpack/core/kernels/laplacian_kernel.hpp>
 #include <mlpack/core/kernels/linear_kernel.hpp>
 #include <mlpack/core/kernels/polynomial_kernel.hpp>
 #include <mlpack/core/kernels/spherical_kernel.hpp>
+#include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -632,3 +634,87 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+//! A Gaussian kernel that is only evaluated one pair of points at a time.
+class ScalarGaussianKernel : public GaussianKernel
+{
+ public:
+  ScalarGaussianKernel(const double bandwidth) : GaussianKernel(bandwidth) { }
+
+  template<typename VecTypeA, typename VecTypeB>
+  double Evaluate(const VecTypeA& a, const VecTypeB& b) const
+  {
+    return GaussianKernel::Evaluate(a, b);
+  }
+};
+
+/**
+ * Check that KernelMatrix() gives the same kernel matrices as one evaluation
+ * of the given kernel per pair of points.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat a(5, 30, arma::fill::randu);
+  arma::mat b(5, 40, arma::fill::randu);
+  // A point at the origin has no direction for the cosine distance.
+  a.col(3).zeros();
+
+  arma::mat k;
+  KernelMatrix(kernel, a, b, k);
+  REQUIRE(k.n_rows == a.n_cols);
+  REQUIRE(k.n_cols == b.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      REQUIRE(k(i, j) == Approx(kernel.Evaluate(a.col(i), b.col(j))).margin(
+          1e-10));
+
+  KernelMatrix(kernel, a, k);
+  REQUIRE(k.n_rows == a.n_cols);
+  REQUIRE(k.n_cols == a.n_cols);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < a.n_cols; ++j)
+      REQUIRE(k(i, j) == Approx(kernel.Evaluate(a.col(i), a.col(j))).margin(
+          1e-10));
+
+  // The sparse version always evaluates the kernel once per pair of points.
+  arma::sp_mat sa(a), sb(b);
+  KernelMatrix(kernel, sa, sb, k);
+  for (size_t i = 0; i < a.n_cols; ++i)
+    for (size_t j = 0; j < b.n_cols; ++j)
+      REQUIRE(k(i, j) == Approx(kernel.Evaluate(a.col(i), b.col(j))).margin(
+          1e-10));
+}
+
+/**
+ * Make sure that block evaluation of the kernels gives the same kernel
+ * matrices as scalar evaluation.
+ */
+TEST_CASE("KernelMatrixTest", "[KernelTest]")
+{
+  LinearKernel linear;
+  PolynomialKernel polynomial(3.0, 0.5);
+  HyperbolicTangentKernel hyperbolicTangent(0.3, 0.1);
+  CosineDistance cosine;
+  GaussianKernel gaussian(0.7);
+  LaplacianKernel laplacian(0.7);
+  CauchyKernel cauchy(0.7);
+  EpanechnikovKernel epanechnikov(0.9);
+  TriangularKernel triangular(0.9);
+  SphericalKernel spherical(0.9);
+  // KernelTraits is not specialized for derived classes, so this kernel has no
+  // block evaluation.
+  ScalarGaussianKernel scalarGaussian(0.7);
+
+  CheckKernelMatrix(linear);
+  CheckKernelMatrix(polynomial);
+  CheckKernelMatrix(hyperbolicTangent);
+  CheckKernelMatrix(cosine);
+  CheckKernelMatrix(gaussian);
+  CheckKernelMatrix(laplacian);
+  CheckKernelMatrix(cauchy);
+  CheckKernelMatrix(epanechnikov);
+  CheckKernelMatrix(triangular);
+  CheckKernelMatrix(spherical);
+  CheckKernelMatrix(scalarGaussian);
+}
@@ -13,13 +13,18 @@
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
 #include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/yinyang_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
+#include <mlpack/core/metrics/spherical_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
@@ -553,6 +558,89 @@ TEST_CASE("KMeansPlusPlusTest", "[KMeansTest]")
   REQUIRE(distortion < 14500.0);
 }
 
+/**
+ * Test that the k-means|| initialization strategy returns decent initial
+ * cluster estimates, and that it can be used by KMeans.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  // The same five Gaussians as in KMeansPlusPlusTest.
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization k;
+  arma::mat resultingCentroids;
+  k.Cluster(data, 5, resultingCentroids);
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  // Calculate the sum of distances from the closest centroids.
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, metric::EuclideanDistance::Evaluate(
+          data.col(i), resultingCentroids.col(j)));
+    }
+    distortion += bestDist;
+  }
+
+  // See KMeansPlusPlusTest for the bound.
+  REQUIRE(distortion < 14500.0);
+
+  // Asking for more clusters than candidates fills the remaining centroids
+  // from the dataset.
+  KMeansParallelInitialization oneRound(0.1, 1);
+  oneRound.Cluster(data, 20, resultingCentroids);
+  REQUIRE(resultingCentroids.n_cols == 20);
+
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 5, assignments);
+  REQUIRE(assignments.n_elem == data.n_cols);
+  REQUIRE(assignments.max() < 5);
+}
+
+/**
+ * The k-means++ centroids must be distinct points of the dataset.
+ */
+TEST_CASE("KMeansPlusPlusDistinctCentroidsTest", "[KMeansTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 5000);
+
+  arma::mat resultingCentroids;
+  KMeansPlusPlusInitialization::Cluster(data, 100, resultingCentroids);
+  REQUIRE(resultingCentroids.n_cols == 100);
+
+  for (size_t i = 0; i < resultingCentroids.n_cols; ++i)
+  {
+    bool found = false;
+    for (size_t p = 0; p < data.n_cols && !found; ++p)
+      found = arma::approx_equal(data.col(p), resultingCentroids.col(i),
+          "absdiff", 0.0);
+    REQUIRE(found);
+
+    for (size_t j = 0; j < i; ++j)
+      REQUIRE(arma::any(resultingCentroids.col(i) !=
+          resultingCentroids.col(j)));
+  }
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -598,6 +686,93 @@ TEST_CASE("SparseKMeansTest", "[KMeansTest]")
   REQUIRE(assignments[11] == clusterTwo);
 }
 
+/**
+ * Make sure that a Lloyd iteration of NaiveKMeans and ElkanKMeans on sparse
+ * data gives the same result as on the same dense data.
+ */
+TEST_CASE("SparseLloydIterationTest", "[KMeansTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(300, 500, 0.05);
+  arma::mat denseData(sparseData);
+
+  arma::mat centroids(300, 6, arma::fill::randu);
+  centroids *= 0.1;
+  metric::EuclideanDistance metric;
+
+  NaiveKMeans<metric::EuclideanDistance, arma::sp_mat> sparseNaive(
+      sparseData, metric);
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> denseNaive(denseData,
+      metric);
+  ElkanKMeans<metric::EuclideanDistance, arma::sp_mat> sparseElkan(
+      sparseData, metric);
+  ElkanKMeans<metric::EuclideanDistance, arma::mat> denseElkan(denseData,
+      metric);
+
+  arma::mat sparseCentroids, denseCentroids, elkanCentroids,
+      denseElkanCentroids;
+  arma::Col<size_t> sparseCounts, denseCounts, elkanCounts, denseElkanCounts;
+  sparseNaive.Iterate(centroids, sparseCentroids, sparseCounts);
+  denseNaive.Iterate(centroids, denseCentroids, denseCounts);
+  sparseElkan.Iterate(centroids, elkanCentroids, elkanCounts);
+  denseElkan.Iterate(centroids, denseElkanCentroids, denseElkanCounts);
+
+  REQUIRE(arma::all(sparseCounts == denseCounts));
+  REQUIRE(arma::all(elkanCounts == denseElkanCounts));
+  REQUIRE(arma::all(elkanCounts == denseCounts));
+  REQUIRE(arma::approx_equal(sparseCentroids, denseCentroids, "absdiff",
+      1e-10));
+  REQUIRE(arma::approx_equal(elkanCentroids, denseCentroids, "absdiff",
+      1e-10));
+}
+
+/**
+ * Make sure that spherical k-means clusters sparse documents by direction and
+ * not by norm, and gives unit-length centroids.
+ */
+TEST_CASE("SphericalKMeansTest", "[KMeansTest]")
+{
+  // The documents of the first topic only use the first 50 words, and the
+  // documents of the second topic only use the last 50 words.  The norms of
+  // the documents are very different, so Euclidean k-means would split them
+  // by length instead.
+  arma::sp_mat data(100, 40);
+  for (size_t i = 0; i < 40; ++i)
+  {
+    const size_t offset = (i < 20) ? 0 : 50;
+    const double scale = (i % 2 == 0) ? 1.0 : 100.0;
+    for (size_t w = 0; w < 5; ++w)
+      data(offset + math::RandInt(50), i) = scale * math::Random(0.5, 1.0);
+  }
+
+  arma::mat initialCentroids(100, 2);
+  initialCentroids.col(0) = arma::vec(data.col(0));
+  initialCentroids.col(1) = arma::vec(data.col(20));
+
+  arma::Row<size_t> naiveAssignments, elkanAssignments;
+  arma::mat naiveCentroids(initialCentroids), elkanCentroids(initialCentroids);
+
+  KMeans<metric::SphericalDistance, SampleInitialization,
+      MaxVarianceNewCluster, NaiveKMeans, arma::sp_mat> naive;
+  naive.Cluster(data, 2, naiveAssignments, naiveCentroids, false, true);
+  KMeans<metric::SphericalDistance, SampleInitialization,
+      MaxVarianceNewCluster, ElkanKMeans, arma::sp_mat> elkan;
+  elkan.Cluster(data, 2, elkanAssignments, elkanCentroids, false, true);
+
+  for (size_t i = 0; i < 40; ++i)
+  {
+    REQUIRE(naiveAssignments[i] == ((i < 20) ? 0 : 1));
+    REQUIRE(elkanAssignments[i] == naiveAssignments[i]);
+  }
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    REQUIRE(arma::norm(naiveCentroids.col(c), 2) == Approx(1.0).epsilon(1e-7));
+    REQUIRE(arma::norm(elkanCentroids.col(c) - naiveCentroids.col(c), 2) ==
+        Approx(0.0).margin(1e-7));
+  }
+}
+
 #endif // ARMA_HAS_SPMAT
 
 TEST_CASE("ElkanTest", "[KMeansTest]")
@@ -669,6 +844,74 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+TEST_CASE("YinyangTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 1000);
+    dataset.randu();
+
+    // Use enough clusters to get several groups of centroids.
+    const size_t k = 15 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    // Make sure the Yinyang algorithm and the naive method return the same
+    // clusters.
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        YinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == yinyangAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(naiveCentroids[i] == Approx(yinyangCentroids[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure the Yinyang algorithm groups the centroids and prunes distance
+ * calculations.
+ */
+TEST_CASE("YinyangPruningTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::mat centroids = dataset.cols(0, 49);
+  metric::EuclideanDistance metric;
+
+  YinyangKMeans<metric::EuclideanDistance, arma::mat> yinyang(dataset, metric,
+      10);
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> naive(dataset, metric);
+
+  arma::mat yinyangCentroids, naiveCentroids;
+  arma::Col<size_t> yinyangCounts, naiveCounts;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    yinyang.Iterate(centroids, yinyangCentroids, yinyangCounts);
+    naive.Iterate(centroids, naiveCentroids, naiveCounts);
+
+    REQUIRE(arma::all(yinyangCounts == naiveCounts));
+    REQUIRE(arma::approx_equal(yinyangCentroids, naiveCentroids, "absdiff",
+        1e-10));
+    centroids = naiveCentroids;
+  }
+
+  REQUIRE(yinyang.NumGroups() > 1);
+  REQUIRE(yinyang.NumGroups() <= 5);
+  REQUIRE(yinyang.DistanceCalculations() < naive.DistanceCalculations());
+}
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -800,3 +1043,94 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Make sure that mini-batch k-means finds the centroids of well-separated
+ * clusters, both as the Lloyd step of KMeans and when the batches are given to
+ * it one at a time.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  // Three clusters of 2000 points around known means.
+  const arma::mat means("0.0 10.0 -10.0; 0.0 10.0 5.0");
+  arma::mat dataset(2, 6000);
+  arma::Row<size_t> labels(6000);
+  for (size_t i = 0; i < 6000; ++i)
+  {
+    labels[i] = i % 3;
+    dataset.col(i) = means.col(i % 3) + 0.5 * arma::randn<arma::vec>(2);
+  }
+
+  // Start from one point of each cluster.
+  const arma::mat initialCentroids = dataset.cols(0, 2);
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(50);
+  arma::Row<size_t> assignments;
+  arma::mat centroids(initialCentroids);
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == labels[i]);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(means[i]).margin(0.1));
+
+  // Now give the dataset in batches of 500 points.
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> miniBatch(metric);
+  centroids = initialCentroids;
+  for (size_t begin = 0; begin < dataset.n_cols; begin += 500)
+    miniBatch.Update(dataset.cols(begin, begin + 499), centroids);
+
+  REQUIRE(arma::accu(miniBatch.Counts()) == dataset.n_cols);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(means[i]).margin(0.1));
+
+  // A batch of the wrong dimensionality is an error.
+  REQUIRE_THROWS_AS(miniBatch.Update(arma::mat(3, 10), centroids),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that DistributedKMeans with a single process gives the same
+ * centroids as KMeans, and that k-means|| finds well-separated clusters.
+ */
+TEST_CASE("DistributedKMeansTest", "[KMeansTest]")
+{
+  const arma::mat means("0.0 10.0 -10.0 5.0; 0.0 10.0 5.0 -8.0");
+  arma::mat dataset(2, 2000);
+  for (size_t i = 0; i < 2000; ++i)
+    dataset.col(i) = means.col(i % 4) + 0.5 * arma::randn<arma::vec>(2);
+
+  // From the same initial centroids, the Lloyd iterations are the same.
+  arma::mat centroids = dataset.cols(0, 3);
+  arma::mat kmeansCentroids(centroids);
+  KMeans<> kmeans;
+  kmeans.Cluster(dataset, 4, kmeansCentroids, true);
+
+  LocalReduction reduction;
+  DistributedKMeans<> distributed;
+  distributed.Cluster(dataset, 4, centroids, reduction, true);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(kmeansCentroids[i]).epsilon(1e-7));
+
+  // k-means|| should pick one candidate near each cluster, so every true mean
+  // is found.
+  distributed.Cluster(dataset, 4, centroids, reduction);
+  REQUIRE(centroids.n_cols == 4);
+  for (size_t c = 0; c < 4; ++c)
+  {
+    double minDistance = DBL_MAX;
+    for (size_t j = 0; j < 4; ++j)
+    {
+      minDistance = std::min(minDistance, EuclideanDistance::Evaluate(
+          means.col(c), centroids.col(j)));
+    }
+
+    REQUIRE(minDistance < 0.1);
+  }
+
+  REQUIRE_THROWS_AS(distributed.Cluster(dataset.cols(0, 2), 4, centroids,
+      reduction), std::invalid_argument);
+}
@@ -16,6 +16,7 @@
 #include <mlpack/core/tree/example_tree.hpp>
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
+#include "serialization.hpp"
 
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -683,6 +684,55 @@ TEST_CASE("KNNDualTreeVsNaive", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that the blocked brute-force search used in naive mode for the
+ * Euclidean distance finds the true neighbors in high dimensions, with several
+ * tiles of query and reference points, for both kinds of search.
+ */
+TEST_CASE("KNNNaiveBlockedHighDimensionalTest", "[KNNTest]")
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(64, 2500);
+  arma::mat querySet = arma::randu<arma::mat>(64, 300);
+  const size_t k = 7;
+
+  KNN naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, monoNeighbors;
+  arma::mat distances, monoDistances;
+  naive.Search(querySet, k, neighbors, distances);
+  naive.Search(k, monoNeighbors, monoDistances);
+
+  REQUIRE(neighbors.n_rows == k);
+  REQUIRE(neighbors.n_cols == querySet.n_cols);
+  REQUIRE(monoNeighbors.n_cols == referenceSet.n_cols);
+
+  // Check a few query points of each search by sorting all the distances.
+  for (size_t q = 0; q < querySet.n_cols; q += 37)
+  {
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      const arma::vec point = (mono == 1) ? arma::vec(referenceSet.col(q)) :
+          arma::vec(querySet.col(q));
+      arma::vec allDistances(referenceSet.n_cols);
+      for (size_t r = 0; r < referenceSet.n_cols; ++r)
+        allDistances[r] = EuclideanDistance::Evaluate(point,
+            referenceSet.col(r));
+      if (mono == 1)
+        allDistances[q] = DBL_MAX;
+
+      const arma::uvec order = arma::sort_index(allDistances);
+      for (size_t i = 0; i < k; ++i)
+      {
+        const size_t neighbor = (mono == 1) ? monoNeighbors(i, q) :
+            neighbors(i, q);
+        const double distance = (mono == 1) ? monoDistances(i, q) :
+            distances(i, q);
+        REQUIRE(neighbor == order[i]);
+        REQUIRE(distance == Approx(allDistances[order[i]]).epsilon(1e-12));
+      }
+    }
+  }
+}
+
 /**
  * Test the dual-tree nearest-neighbors method with the naive method.  This uses
  * only a reference dataset.
@@ -1227,6 +1277,66 @@ TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that single-precision models find the same neighbors as the
+ * double-precision baseline, including after serialization, and that tree types
+ * without single-precision support are rejected.
+ */
+TEST_CASE("KNNModelSinglePrecisionTest", "[KNNTest]")
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::KD_TREE,
+      KNNModel::COVER_TREE, KNNModel::BALL_TREE, KNNModel::VP_TREE,
+      KNNModel::RP_TREE, KNNModel::MAX_RP_TREE };
+  for (size_t i = 0; i < 6; ++i)
+  {
+    KNNModel model(treeTypes[i], false, true);
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(std::move(referenceCopy), DUAL_TREE_MODE);
+
+    REQUIRE(model.Dimensionality() == 10);
+    REQUIRE(model.NumReferencePoints() == 200);
+    REQUIRE(model.Dataset<float>().n_cols == 200);
+    REQUIRE_THROWS_AS(model.Dataset<double>(), std::invalid_argument);
+
+    KNNModel xmlModel, jsonModel, binaryModel;
+    SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+    REQUIRE(binaryModel.SinglePrecision() == true);
+
+    KNNModel* searchModels[] = { &model, &xmlModel, &jsonModel, &binaryModel };
+    for (size_t m = 0; m < 4; ++m)
+    {
+      arma::mat queryCopy(queryData);
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      searchModels[m]->Search(std::move(queryCopy), 3, neighbors, distances);
+
+      REQUIRE(neighbors.n_rows == baselineNeighbors.n_rows);
+      REQUIRE(neighbors.n_cols == baselineNeighbors.n_cols);
+      for (size_t k = 0; k < distances.n_elem; ++k)
+      {
+        REQUIRE(neighbors[k] == baselineNeighbors[k]);
+        REQUIRE(distances[k] == Approx(baselineDistances[k]).epsilon(1e-5));
+      }
+    }
+  }
+
+  // The R tree does not support single precision.
+  KNNModel rTreeModel(KNNModel::R_TREE, false, true);
+  arma::mat referenceCopy(referenceData);
+  REQUIRE_THROWS_AS(rTreeModel.BuildModel(std::move(referenceCopy),
+      DUAL_TREE_MODE), std::invalid_argument);
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1816,3 +1926,246 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(arma::accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel dual-tree traversal gives exactly the same
+ * results as the serial traversal, for both bichromatic and monochromatic
+ * search, with kd-trees and cover trees.
+ */
+TEST_CASE("KNNParallelDualTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 500);
+
+  KNN knn(dataset);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverKnn(dataset);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  arma::Mat<size_t> serialNeighbors, serialMonoNeighbors, serialCoverNeighbors;
+  arma::mat serialDistances, serialMonoDistances, serialCoverDistances;
+  omp_set_num_threads(1);
+  knn.Search(querySet, 10, serialNeighbors, serialDistances);
+  knn.Search(10, serialMonoNeighbors, serialMonoDistances);
+  coverKnn.Search(querySet, 10, serialCoverNeighbors, serialCoverDistances);
+
+  arma::Mat<size_t> neighbors, monoNeighbors, coverNeighbors;
+  arma::mat distances, monoDistances, coverDistances;
+  omp_set_num_threads(4);
+  knn.Search(querySet, 10, neighbors, distances);
+  knn.Search(10, monoNeighbors, monoDistances);
+  coverKnn.Search(querySet, 10, coverNeighbors, coverDistances);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+  CheckMatrices(monoNeighbors, serialMonoNeighbors);
+  CheckMatrices(monoDistances, serialMonoDistances);
+  CheckMatrices(coverNeighbors, serialCoverNeighbors);
+  CheckMatrices(coverDistances, serialCoverDistances);
+}
+
+/**
+ * Make sure that the parallel single-tree and greedy single-tree searches give
+ * exactly the same results as the serial searches.
+ */
+TEST_CASE("KNNParallelSingleTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 500);
+
+  KNN knn(dataset, SINGLE_TREE_MODE);
+  KNN greedyKnn(dataset, GREEDY_SINGLE_TREE_MODE);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  arma::Mat<size_t> serialNeighbors, serialMonoNeighbors, serialGreedyNeighbors;
+  arma::mat serialDistances, serialMonoDistances, serialGreedyDistances;
+  omp_set_num_threads(1);
+  knn.Search(querySet, 10, serialNeighbors, serialDistances);
+  knn.Search(10, serialMonoNeighbors, serialMonoDistances);
+  greedyKnn.Search(querySet, 10, serialGreedyNeighbors, serialGreedyDistances);
+
+  arma::Mat<size_t> neighbors, monoNeighbors, greedyNeighbors;
+  arma::mat distances, monoDistances, greedyDistances;
+  omp_set_num_threads(4);
+  knn.Search(querySet, 10, neighbors, distances);
+  knn.Search(10, monoNeighbors, monoDistances);
+  greedyKnn.Search(querySet, 10, greedyNeighbors, greedyDistances);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+  CheckMatrices(monoNeighbors, serialMonoNeighbors);
+  CheckMatrices(monoDistances, serialMonoDistances);
+  CheckMatrices(greedyNeighbors, serialGreedyNeighbors);
+  CheckMatrices(greedyDistances, serialGreedyDistances);
+}
+
+/**
+ * Make sure that the parallel defeatist searches with a hybrid spill tree give
+ * exactly the same results as the serial searches.
+ */
+TEST_CASE("KNNParallelSpillTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 500);
+
+  SpillKNN::Tree referenceTree(dataset, 0.05 /* tau parameter */);
+  SpillKNN spTreeSearch(std::move(referenceTree));
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    if (mode)
+      spTreeSearch.SearchMode() = SINGLE_TREE_MODE;
+
+    arma::Mat<size_t> serialNeighbors, serialMonoNeighbors;
+    arma::mat serialDistances, serialMonoDistances;
+    omp_set_num_threads(1);
+    spTreeSearch.Search(querySet, 10, serialNeighbors, serialDistances);
+    spTreeSearch.Search(10, serialMonoNeighbors, serialMonoDistances);
+
+    arma::Mat<size_t> neighbors, monoNeighbors;
+    arma::mat distances, monoDistances;
+    omp_set_num_threads(4);
+    spTreeSearch.Search(querySet, 10, neighbors, distances);
+    spTreeSearch.Search(10, monoNeighbors, monoDistances);
+    omp_set_num_threads(prevNumThreads);
+
+    CheckMatrices(neighbors, serialNeighbors);
+    CheckMatrices(distances, serialDistances);
+    CheckMatrices(monoNeighbors, serialMonoNeighbors);
+    CheckMatrices(monoDistances, serialMonoDistances);
+  }
+}
+#endif
+
+/**
+ * Make sure that inserting and deleting reference points gives the same
+ * results as searching the updated reference set from scratch, both before and
+ * after the tree is rebuilt.
+ */
+template<typename KNNType>
+void CheckReferenceUpdates(const NeighborSearchMode mode)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat querySet = arma::randu<arma::mat>(3, 100);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 40);
+
+  KNNType knn(dataset, mode);
+  knn.RebuildRatio() = DBL_MAX; // Don't rebuild automatically.
+
+  // Delete some of the original points and some of the inserted points.
+  knn.InsertReferencePoints(newPoints.cols(0, 19));
+  arma::Col<size_t> indices = { 0, 17, 250, 499, 510, 519 };
+  knn.DeleteReferencePoints(indices);
+  knn.InsertReferencePoints(newPoints.cols(20, 39));
+
+  arma::mat expected = arma::join_rows(dataset, newPoints.cols(0, 19));
+  for (size_t i = indices.n_elem; i > 0; --i)
+    expected.shed_col(indices[i - 1]);
+  expected = arma::join_rows(expected, newPoints.cols(20, 39));
+
+  REQUIRE(knn.NumReferencePoints() == expected.n_cols);
+  REQUIRE(knn.NumPendingUpdates() == 42);
+  CheckMatrices(knn.MergedReferenceSet(), expected);
+
+  KNN naive(expected, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, naiveMonoNeighbors;
+  arma::mat naiveDistances, naiveMonoDistances;
+  naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+  naive.Search(10, naiveMonoNeighbors, naiveMonoDistances);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    arma::Mat<size_t> neighbors, monoNeighbors;
+    arma::mat distances, monoDistances;
+    knn.Search(querySet, 10, neighbors, distances);
+    knn.Search(10, monoNeighbors, monoDistances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+    CheckMatrices(monoNeighbors, naiveMonoNeighbors);
+    CheckMatrices(monoDistances, naiveMonoDistances);
+
+    // The second time, search the rebuilt tree.
+    knn.Rebuild();
+    REQUIRE(knn.NumPendingUpdates() == 0);
+    REQUIRE(knn.NumReferencePoints() == expected.n_cols);
+  }
+}
+
+TEST_CASE("KNNReferenceUpdatesTest", "[KNNTest]")
+{
+  CheckReferenceUpdates<KNN>(NAIVE_MODE);
+  CheckReferenceUpdates<KNN>(SINGLE_TREE_MODE);
+  CheckReferenceUpdates<KNN>(DUAL_TREE_MODE);
+  CheckReferenceUpdates<NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, StandardCoverTree>>(DUAL_TREE_MODE);
+}
+
+/**
+ * Make sure that the tree is rebuilt automatically once there are enough
+ * pending updates.
+ */
+TEST_CASE("KNNReferenceUpdatesRebuildTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+
+  KNN knn(dataset);
+  knn.RebuildRatio() = 0.1;
+
+  knn.InsertReferencePoints(arma::randu<arma::mat>(3, 5));
+  REQUIRE(knn.NumPendingUpdates() == 5);
+  REQUIRE(knn.ReferenceSet().n_cols == 100);
+
+  // 11 pending updates are more than 10% of the tree.
+  knn.DeleteReferencePoints(arma::Col<size_t>({ 1, 2, 3, 4, 5, 6 }));
+  REQUIRE(knn.NumPendingUpdates() == 0);
+  REQUIRE(knn.ReferenceSet().n_cols == 99);
+  REQUIRE(knn.NumReferencePoints() == 99);
+
+  // Deleting a point that doesn't exist is an error.
+  REQUIRE_THROWS_AS(knn.DeleteReferencePoints(arma::Col<size_t>({ 99 })),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the traversal statistics match the counts of the search, and
+ * that tree searches prune while naive search doesn't.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  KNN dualTree(dataset, DUAL_TREE_MODE);
+  KNN singleTree(dataset, SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  naive.Search(5, neighbors, distances);
+  dualTree.Search(5, neighbors, distances);
+  singleTree.Search(5, neighbors, distances);
+
+  REQUIRE(naive.Statistics().BaseCases() == naive.BaseCases());
+  REQUIRE(naive.Statistics().Prunes() == 0);
+
+  REQUIRE(dualTree.Statistics().BaseCases() == dualTree.BaseCases());
+  REQUIRE(dualTree.Statistics().Scores() == dualTree.Scores());
+  REQUIRE(dualTree.Statistics().Prunes() > 0);
+  REQUIRE(dualTree.Statistics().Visited() > 0);
+  REQUIRE(dualTree.Statistics().PruneRatio() > 0.0);
+  REQUIRE(dualTree.Statistics().PruneRatio() <= 1.0);
+
+  REQUIRE(singleTree.Statistics().BaseCases() == singleTree.BaseCases());
+  REQUIRE(singleTree.Statistics().Prunes() > 0);
+  REQUIRE(singleTree.Statistics().Visited() ==
+      singleTree.Statistics().Scores() - singleTree.Statistics().Prunes());
+  // Fewer base cases than the naive search.
+  REQUIRE(singleTree.Statistics().BaseCases() < naive.BaseCases());
+}
@@ -15,6 +15,7 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
@@ -728,3 +729,69 @@ TEST_CASE("RAModelTest", "[KRANNTest]")
     }
   }
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel single-tree search makes the same samples as the
+ * serial one, and that the parallel dual-tree search still satisfies the
+ * rank-approximation guarantee.
+ */
+TEST_CASE("KRANNParallelSearchTest", "[KRANNTest]")
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  if (!data::Load("rann_test_r_3_900.csv", refData))
+    FAIL("Cannot load dataset rann_test_r_3_900.csv");
+  if (!data::Load("rann_test_q_3_100.csv", queryData))
+    FAIL("Cannot load dataset rann_test_q_3_100.csv");
+
+  arma::Mat<size_t> qrRanks;
+  if (!data::Load("rann_test_qr_ranks.csv", qrRanks, false, false))
+    FAIL("Cannot load dataset rann_test_qr_ranks.csv");
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  // Each query point has its own stream of samples in single-tree search, so
+  // the number of threads doesn't change the results.
+  RASearch<> single(refData, false, true, 1.0, 0.95, false, false, 5);
+  arma::Mat<size_t> serialNeighbors, neighbors;
+  arma::mat serialDistances, distances;
+
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  single.Search(queryData, 3, serialNeighbors, serialDistances);
+
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  single.Search(queryData, 3, neighbors, distances);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+
+  // 1% of 900 is 9, so the rank is expected to be less than 10.
+  RASearch<> dual(refData, false, false, 1.0, 0.95, false, false, 5);
+  const size_t numRounds = 200;
+  const size_t expectedRankErrorUB = 10;
+  arma::Col<size_t> numSuccessRounds(queryData.n_cols, arma::fill::zeros);
+  for (size_t rounds = 0; rounds < numRounds; rounds++)
+  {
+    dual.Search(queryData, 1, neighbors, distances);
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+      if (qrRanks(i, neighbors(0, i)) < expectedRankErrorUB)
+        numSuccessRounds[i]++;
+  }
+
+  omp_set_num_threads(prevNumThreads);
+
+  // At most 5% of the queries should fall below the 95%-tile threshold.
+  const size_t threshold = floor(numRounds *
+      (0.95 - (1.96 * sqrt(0.95 * 0.05 / numRounds))));
+  size_t numQueriesFail = 0;
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    if (numSuccessRounds[i] < threshold)
+      numQueriesFail++;
+
+  REQUIRE(numQueriesFail < 6);
+}
+#endif
@@ -469,3 +469,89 @@ TEST_CASE("LARSCopyConstructorTest", "[LARSTest]")
   // The output of both models should be the same.
   CheckMatrices(predictions, predictionsFromCopiedModel);
 }
+
+/**
+ * Make sure that the Cholesky path without a Gram matrix, the Gram matrix path
+ * (with a blocked Gram matrix) and a precomputed Gram matrix all give the same
+ * LASSO solution on data with more dimensions than points.
+ */
+TEST_CASE("LARSHighDimensionalGramTest", "[LARSTest]")
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 200, 600);
+
+  const double lambda1 = 0.5 * arma::abs(X * y.t()).max();
+  arma::vec betaCholesky, betaGram, betaPrecomputed;
+
+  LARS larsCholesky(true, lambda1);
+  larsCholesky.Train(X, y, betaCholesky);
+  // The full Gram matrix is not needed with the Cholesky decomposition.
+  REQUIRE(larsCholesky.MatUtriCholFactor().n_rows ==
+      larsCholesky.ActiveSet().size());
+
+  LARS larsGram(false, lambda1);
+  larsGram.Train(X, y, betaGram);
+
+  const arma::mat gram = X * X.t();
+  LARS larsPrecomputed(true, gram, lambda1);
+  larsPrecomputed.Train(X, y, betaPrecomputed);
+
+  CheckMatrices(betaCholesky, betaGram, 1e-6);
+  CheckMatrices(betaCholesky, betaPrecomputed, 1e-6);
+
+  arma::vec errCorr = X * trans(X) * betaCholesky - X * y.t();
+  LARSVerifyCorrectness(betaCholesky, errCorr, lambda1);
+
+  // A precomputed Gram matrix of the wrong size is an error.
+  const arma::mat wrongGram = gram.submat(0, 0, 99, 99);
+  LARS larsWrong(true, wrongGram, lambda1);
+  REQUIRE_THROWS_AS(larsWrong.Train(X, y), std::invalid_argument);
+}
+
+/**
+ * Test cross-validation of lambda1 and reading solutions off the path.
+ */
+TEST_CASE("LARSCrossValidateTest", "[LARSTest]")
+{
+  // Only a few of the dimensions are relevant.
+  arma::mat X = arma::randn(50, 500);
+  arma::vec trueBeta = arma::zeros(50);
+  trueBeta.subvec(0, 4) = arma::randn(5) + 3.0;
+  arma::rowvec y = trueBeta.t() * X + 0.1 * arma::randn<arma::rowvec>(500);
+
+  const double maxCorr = arma::abs(X * y.t()).max();
+  const arma::vec lambdas = { 0.9 * maxCorr, 0.5 * maxCorr, 0.1 * maxCorr,
+      0.01 * maxCorr };
+
+  LARS lars(true);
+  arma::vec errors;
+  const double best = lars.CrossValidate(X, y, lambdas, 5, errors);
+
+  REQUIRE(errors.n_elem == lambdas.n_elem);
+  REQUIRE(best == lars.Lambda1());
+  REQUIRE(best == lambdas[errors.index_min()]);
+  // The largest value shrinks the solution too much.
+  REQUIRE(errors[0] > errors.min());
+
+  // The final model is the one trained on all the data with the best value.
+  LARS larsBest(true, best);
+  arma::vec beta;
+  larsBest.Train(X, y, beta);
+  CheckMatrices(lars.Beta(), beta, 1e-6);
+
+  // Solutions read off a longer path match the solutions trained directly.
+  LARS larsPath(true, lambdas.min());
+  larsPath.Train(X, y);
+  for (size_t l = 0; l < lambdas.n_elem; ++l)
+  {
+    LARS larsDirect(true, lambdas[l]);
+    arma::vec betaDirect, betaPath;
+    larsDirect.Train(X, y, betaDirect);
+    larsPath.PathSolution(lambdas[l], betaPath);
+    CheckMatrices(betaDirect, betaPath, 1e-6);
+  }
+
+  REQUIRE_THROWS_AS(lars.CrossValidate(X, y, lambdas, 1, errors),
+      std::invalid_argument);
+}
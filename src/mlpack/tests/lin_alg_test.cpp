@@ -86,6 +86,43 @@ TEST_CASE("TestCenterB", "[LinAlgTest]")
   }
 }
 
+/**
+ * Make sure that centering a matrix in place gives the same result as
+ * centering a copy.
+ */
+TEST_CASE("TestCenterInPlace", "[LinAlgTest]")
+{
+  mat tmp = randu<mat>(7, 3000);
+  mat tmp_out;
+  Center(tmp, tmp_out);
+  Center(tmp);
+
+  REQUIRE(approx_equal(tmp, tmp_out, "absdiff", 1e-12));
+  REQUIRE(max(abs(mean(tmp, 1))) < 1e-12);
+}
+
+/**
+ * Make sure that ColumnCovariance(), which accumulates several blocks of points
+ * (possibly on different threads), matches arma::cov(), and that the result of
+ * WhitenUsingSVD() has the identity covariance.
+ */
+TEST_CASE("TestColumnCovarianceBlocks", "[LinAlgTest]")
+{
+  mat x = randn<mat>(6, 5000);
+  x.row(2) *= 4.0;
+  x.row(3) += 10.0;
+
+  const mat cov = ColumnCovariance(x);
+  REQUIRE(approx_equal(cov, arma::cov(x.t()), "absdiff", 1e-10));
+  REQUIRE(approx_equal(ColumnCovariance(x, 1), arma::cov(x.t(), 1),
+      "absdiff", 1e-10));
+
+  mat whitened, whiteningMatrix;
+  WhitenUsingSVD(x, whitened, whiteningMatrix);
+  REQUIRE(approx_equal(ColumnCovariance(whitened), eye<mat>(6, 6),
+      "absdiff", 1e-8));
+}
+
 TEST_CASE("TestOrthogonalize", "[LinAlgTest]")
 {
   // Generate a random matrix; then, orthogonalize it and test if it's
@@ -266,3 +266,75 @@ TEST_CASE("LinearRegressionTrainReturnObjective", "[LinearRegressionTest]")
 
   REQUIRE(std::isfinite(error) == true);
 }
+
+/**
+ * Test that accumulating the data in chunks and solving gives the same model
+ * as training on all the data at once, with and without weights and an
+ * intercept.
+ */
+TEST_CASE("LinearRegressionAddChunkTest", "[LinearRegressionTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(6, 5000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(5000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(5000);
+
+  for (const bool intercept : { true, false })
+  {
+    LinearRegression lr(dataset, responses, weights, 0.1, intercept);
+
+    LinearRegression lrChunks(dataset.cols(0, 999), responses.subvec(0, 999),
+        weights.subvec(0, 999), 0.1, intercept);
+    lrChunks.AddChunk(dataset.cols(1000, 3499), responses.subvec(1000, 3499),
+        weights.subvec(1000, 3499));
+    lrChunks.AddChunk(dataset.cols(3500, 4999), responses.subvec(3500, 4999),
+        weights.subvec(3500, 4999));
+    lrChunks.Solve();
+
+    REQUIRE(lrChunks.NumPoints() == 5000);
+    REQUIRE(lrChunks.Gram().n_rows == (intercept ? 7 : 6));
+    CheckMatrices(lr.Parameters(), lrChunks.Parameters(), 1e-5);
+  }
+}
+
+/**
+ * Test that removing a chunk from the statistics gives the same model as
+ * training on the remaining data, for a sliding window.
+ */
+TEST_CASE("LinearRegressionSlidingWindowTest", "[LinearRegressionTest]")
+{
+  arma::mat dataset = arma::randn<arma::mat>(4, 3000);
+  arma::rowvec responses = arma::randn<arma::rowvec>(3000);
+
+  LinearRegression window;
+  window.AddChunk(dataset.cols(0, 999), responses.subvec(0, 999));
+  window.AddChunk(dataset.cols(1000, 1999), responses.subvec(1000, 1999));
+  window.Solve();
+
+  LinearRegression lr(dataset.cols(0, 1999), responses.subvec(0, 1999));
+  CheckMatrices(lr.Parameters(), window.Parameters(), 1e-5);
+
+  // Slide the window forward.
+  window.AddChunk(dataset.cols(2000, 2999), responses.subvec(2000, 2999));
+  window.RemoveChunk(dataset.cols(0, 999), responses.subvec(0, 999));
+  window.Solve();
+
+  lr.Train(dataset.cols(1000, 2999), responses.subvec(1000, 2999));
+  REQUIRE(window.NumPoints() == 2000);
+  CheckMatrices(lr.Parameters(), window.Parameters(), 1e-5);
+
+  // The statistics are kept when the model is serialized.
+  LinearRegression xmlLr, jsonLr, binaryLr;
+  SerializeObjectAll(window, xmlLr, jsonLr, binaryLr);
+  CheckMatrices(window.Gram(), xmlLr.Gram(), jsonLr.Gram(), binaryLr.Gram());
+  REQUIRE(binaryLr.NumPoints() == 2000);
+
+  // Removing more points than are in the statistics is an error, as is adding
+  // a chunk with the wrong dimensionality.
+  REQUIRE_THROWS_AS(window.RemoveChunk(dataset, responses),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(window.AddChunk(dataset.rows(0, 2), responses),
+      std::invalid_argument);
+
+  LinearRegression empty;
+  REQUIRE_THROWS_AS(empty.Solve(), std::runtime_error);
+}
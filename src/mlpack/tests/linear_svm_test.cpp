@@ -14,6 +14,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::svm;
@@ -877,6 +878,79 @@ TEST_CASE("LinearSVMSparseLBFGSTest", "[LinearSVMTest]")
   }
 }
 
+/**
+ * Make sure that the batch objective and gradient with an intercept match
+ * those of the full objective on the same points, for sparse and dense data.
+ */
+TEST_CASE("LinearSVMFunctionSparseBatchTest", "[LinearSVMTest]")
+{
+  const size_t numClasses = 3;
+  arma::sp_mat sparseData;
+  sparseData.sprandu(15, 300, 0.2);
+  arma::mat data(sparseData);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = math::RandInt(0, numClasses);
+
+  LinearSVMFunction<arma::mat> svmf(data, labels, numClasses, 0.1, 1.0, true);
+  LinearSVMFunction<arma::sp_mat> svmfSparse(sparseData, labels, numClasses,
+      0.1, 1.0, true);
+
+  // The objective restricted to points [100, 150).
+  const arma::mat batch = data.cols(100, 149);
+  const arma::Row<size_t> batchLabels = labels.subvec(100, 149);
+  LinearSVMFunction<arma::mat> batchf(batch, batchLabels, numClasses, 0.1, 1.0,
+      true);
+
+  const arma::mat parameters = svmf.InitialPoint();
+  arma::mat gradient, sparseGradient, batchGradient;
+  const double batchObjective = batchf.EvaluateWithGradient(parameters,
+      batchGradient);
+
+  REQUIRE(svmf.Evaluate(parameters, 100, 50) ==
+      Approx(batchObjective).epsilon(1e-7));
+  REQUIRE(svmfSparse.Evaluate(parameters, 100, 50) ==
+      Approx(batchObjective).epsilon(1e-7));
+
+  REQUIRE(svmf.EvaluateWithGradient(parameters, 100, gradient, 50) ==
+      Approx(batchObjective).epsilon(1e-7));
+  REQUIRE(svmfSparse.EvaluateWithGradient(parameters, 100, sparseGradient,
+      50) == Approx(batchObjective).epsilon(1e-7));
+  CheckMatrices(gradient, batchGradient);
+  CheckMatrices(sparseGradient, batchGradient);
+
+  svmfSparse.Gradient(parameters, 100, sparseGradient, 50);
+  CheckMatrices(sparseGradient, batchGradient);
+}
+
+/**
+ * Make sure that a single-precision linear SVM can be trained.
+ */
+TEST_CASE("LinearSVMFloatTest", "[LinearSVMTest]")
+{
+  const size_t numClasses = 2;
+  const double lambda = 0.0001;
+
+  // A very simple fake dataset.
+  arma::fmat dataset = "2 0 0;"
+                       "0 0 0;"
+                       "0 2 1;"
+                       "1 0 2;"
+                       "0 1 0";
+
+  // Corresponding labels.
+  arma::Row<size_t> labels = "1 0 1";
+
+  LinearSVM<arma::fmat> lsvm(dataset, labels, numClasses, lambda);
+
+  const arma::fmat& parameters = lsvm.Parameters();
+  REQUIRE(parameters.n_rows == dataset.n_rows);
+  REQUIRE(parameters.n_cols == numClasses);
+
+  const double acc = lsvm.ComputeAccuracy(dataset, labels);
+  REQUIRE(acc == Approx(1.0).epsilon(0.005));
+}
+
 /**
  * Test training of linear svm for multiple classes on a complex gaussian
  * dataset using L-BFGS optimizer.
@@ -1181,3 +1255,80 @@ TEST_CASE("LinearSVMCallbackTest", "[LinearSVMTest]")
 
   REQUIRE(cb.calledEndOptimization == true);
 }
+
+/**
+ * Make sure that dual coordinate descent trains an accurate one-vs-rest model
+ * on five well-separated Gaussians.
+ */
+TEST_CASE("LinearSVMDCDMultipleClasses", "[LinearSVMTest]")
+{
+  const size_t points = 1000;
+  const size_t numClasses = 5;
+  const double lambda = 0.001;
+
+  arma::mat identity = arma::eye<arma::mat>(5, 5);
+  std::vector<GaussianDistribution> gaussians;
+  gaussians.push_back(GaussianDistribution(arma::vec("1.0 9.0 1.0 2.0 2.0"),
+      identity));
+  gaussians.push_back(GaussianDistribution(arma::vec("4.0 3.0 4.0 2.0 2.0"),
+      identity));
+  gaussians.push_back(GaussianDistribution(arma::vec("3.0 2.0 7.0 0.0 5.0"),
+      identity));
+  gaussians.push_back(GaussianDistribution(arma::vec("4.0 1.0 1.0 2.0 7.0"),
+      identity));
+  gaussians.push_back(GaussianDistribution(arma::vec("1.0 0.0 1.0 8.0 3.0"),
+      identity));
+
+  arma::mat data(5, points), testData(5, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % numClasses;
+    data.col(i) = gaussians[labels[i]].Random();
+    testData.col(i) = gaussians[labels[i]].Random();
+  }
+
+  LinearSVM<arma::mat> lsvm(data, labels, numClasses, lambda, 1.0, true,
+      DualCoordinateDescent(1000, 0.01));
+
+  REQUIRE(lsvm.Parameters().n_rows == 6);
+  REQUIRE(lsvm.Parameters().n_cols == numClasses);
+  REQUIRE(lsvm.ComputeAccuracy(data, labels) >= 0.97);
+  REQUIRE(lsvm.ComputeAccuracy(testData, labels) >= 0.95);
+}
+
+/**
+ * Make sure that dual coordinate descent gives the same model for sparse and
+ * dense data, and that the two classes of a binary model are opposite.
+ */
+TEST_CASE("LinearSVMSparseDCDTest", "[LinearSVMTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 800, 0.3);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = (dataset(0, i) + dataset(1, i) > dataset(2, i)) ? 1 : 0;
+
+  LinearSVM<arma::mat> lr(2, 0.001, 1.0, true);
+  LinearSVM<arma::sp_mat> lrSparse(2, 0.001, 1.0, true);
+  math::RandomSeed(42);
+  const double objective = lr.Train(denseDataset, labels, 2,
+      DualCoordinateDescent(1000, 0.01));
+  math::RandomSeed(42);
+  const double sparseObjective = lrSparse.Train(dataset, labels, 2,
+      DualCoordinateDescent(1000, 0.01));
+
+  REQUIRE(objective == Approx(sparseObjective).epsilon(1e-8));
+  REQUIRE(lr.Parameters().n_rows == 11);
+  REQUIRE(lr.Parameters().n_elem == lrSparse.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+  {
+    REQUIRE(lr.Parameters()[i] == Approx(lrSparse.Parameters()[i]).
+        epsilon(1e-8).margin(1e-10));
+  }
+
+  REQUIRE(arma::approx_equal(lr.Parameters().col(0), -lr.Parameters().col(1),
+      "absdiff", 1e-12));
+  REQUIRE(lrSparse.ComputeAccuracy(dataset, labels) >= 0.9);
+}
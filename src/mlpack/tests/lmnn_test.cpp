@@ -193,6 +193,30 @@ TEST_CASE("LMNNInitialEvaluateWithGradientTest", "[LMNNTest]")
   REQUIRE(gradient(1, 1) == Approx(12.0).epsilon(1e-7));
 }
 
+/**
+ * The separable objective and gradient over the whole dataset should match the
+ * non-separable objective and gradient.
+ */
+TEST_CASE("LMNNSeparableMatchesNonSeparableTest", "[LMNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = i % 4;
+
+  LMNNFunction<> lmnnfn(dataset, labels, 3, 0.5, 1);
+  LMNNFunction<> separableLmnnfn(dataset, labels, 3, 0.5, 1);
+
+  arma::mat coordinates = arma::randu<arma::mat>(3, 3) + arma::eye(3, 3);
+  arma::mat gradient, separableGradient;
+  const double objective = lmnnfn.EvaluateWithGradient(coordinates, gradient);
+  const double separableObjective = separableLmnnfn.EvaluateWithGradient(
+      coordinates, 0, separableGradient, 200);
+
+  REQUIRE(separableObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(gradient, separableGradient, 1e-4);
+}
+
 /**
  * Ensure the separable objective function is right.
  */
@@ -10,11 +10,16 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <sstream>
+#include <iomanip>
+#include <limits>
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
+#include <mlpack/core/data/numa_placement.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
 #include "catch.hpp"
+#include "serialization.hpp"
 #include "test_catch_tools.hpp"
 
 using namespace mlpack;
@@ -438,6 +443,110 @@ TEST_CASE("LoadTransposedCSVTest", "[LoadSaveTest]")
   remove("test_file.csv");
 }
 
+/**
+ * Make sure that a numeric CSV file that is large enough to be split between
+ * threads is loaded exactly like Armadillo loads it, with and without
+ * transposing.
+ */
+TEST_CASE("LoadLargeNumericCSVTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(7, 40000, arma::fill::randn);
+  dataset.col(5).fill(1e300);
+  dataset.col(6).zeros();
+
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << setprecision(numeric_limits<double>::max_digits10);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      f << (j > 0 ? ", " : "") << dataset(j, i);
+    f << "\n";
+  }
+  f.close();
+
+  arma::mat armaDataset;
+  REQUIRE(armaDataset.load("test_file.csv", arma::csv_ascii) == true);
+
+#ifdef HAS_OPENMP
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  arma::mat test, untransposed;
+  const bool success = data::Load("test_file.csv", test, false, true);
+  const bool untransposedSuccess = data::Load("test_file.csv", untransposed,
+      false, false);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  REQUIRE(success == true);
+  REQUIRE(untransposedSuccess == true);
+
+  REQUIRE(test.n_rows == dataset.n_rows);
+  REQUIRE(test.n_cols == dataset.n_cols);
+  REQUIRE(untransposed.n_rows == armaDataset.n_rows);
+  REQUIRE(untransposed.n_cols == armaDataset.n_cols);
+
+  // The values must be exactly the same.
+  for (size_t i = 0; i < test.n_cols; ++i)
+  {
+    for (size_t j = 0; j < test.n_rows; ++j)
+    {
+      REQUIRE(test(j, i) == armaDataset(i, j));
+      REQUIRE(untransposed(i, j) == armaDataset(i, j));
+    }
+  }
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
+/**
+ * Make sure that the fast numeric text loader refuses files it doesn't handle,
+ * and that data::Load() still loads them like Armadillo does.
+ */
+TEST_CASE("LoadNumericTextFallbackTest", "[LoadSaveTest]")
+{
+  const char* contents[] = { "1,2,3\n4,,6\n", "1,2,3\n4,5\n",
+      "1,2,3\n\n4,5,6\n", "1,2,3,\n4,5,6,\n", "1,2,3\n4,x,6\n" };
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    fstream f;
+    f.open("test_file.csv", fstream::out);
+    f << contents[i];
+    f.close();
+
+    arma::mat test;
+    REQUIRE(data::LoadNumericText("test_file.csv", test, arma::csv_ascii,
+        true) == false);
+    REQUIRE(test.n_elem == 0);
+
+    arma::mat armaDataset;
+    const bool armaSuccess = armaDataset.load("test_file.csv",
+        arma::csv_ascii);
+    REQUIRE(data::Load("test_file.csv", test, false, false) == armaSuccess);
+    if (armaSuccess)
+    {
+      REQUIRE(test.n_rows == armaDataset.n_rows);
+      REQUIRE(test.n_cols == armaDataset.n_cols);
+      for (size_t j = 0; j < test.n_elem; ++j)
+      {
+        if (std::isnan(armaDataset[j]))
+          REQUIRE(std::isnan(test[j]));
+        else
+          REQUIRE(test[j] == armaDataset[j]);
+      }
+    }
+  }
+
+  // Remove the file.
+  remove("test_file.csv");
+}
+
 /**
  * Make sure ColVec can be loaded.
  */
@@ -1348,6 +1457,94 @@ TEST_CASE("LoadJsonTest", "[LoadSaveTest]")
   REQUIRE(y.inb.s == x.inb.s);
 }
 
+// A model with Armadillo members, for the aligned binary tests.
+class ArmaModel
+{
+ public:
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar(CEREAL_NVP(c));
+    ar(CEREAL_NVP(m));
+    ar(CEREAL_NVP(v));
+    ar(CEREAL_NVP(r));
+    ar(CEREAL_NVP(cube));
+    ar(CEREAL_NVP(sp));
+  }
+
+  char c;
+  arma::mat m;
+  arma::vec v;
+  arma::Row<size_t> r;
+  arma::cube cube;
+  arma::sp_mat sp;
+};
+
+/**
+ * Make sure models saved with format::aligned_binary are loaded correctly by
+ * Load() and MappedModel, and that MappedModel aliases their matrices.
+ */
+TEST_CASE("LoadAlignedBinaryTest", "[LoadSaveTest]")
+{
+  ArmaModel x;
+  x.c = 'x';
+  x.m.randu(13, 17);
+  x.v.randu(31);
+  x.r = arma::randi<arma::Row<size_t>>(7, arma::distr_param(0, 100));
+  x.cube.randu(3, 4, 5);
+  x.sp.sprandu(20, 30, 0.1);
+
+  REQUIRE(data::Save("test_aligned.bin", "x", x, false,
+      data::format::aligned_binary) == true);
+
+  // The header is recognized with autodetection and with format::binary.
+  ArmaModel y, z;
+  REQUIRE(data::Load("test_aligned.bin", "x", y, false) == true);
+  REQUIRE(data::Load("test_aligned.bin", "x", z, false,
+      data::format::binary) == true);
+
+  data::MappedModel<ArmaModel> mapped("test_aligned.bin", "x");
+  ArmaModel& w = mapped.Model();
+
+  for (ArmaModel* l : { &y, &z, &w })
+  {
+    REQUIRE(l->c == 'x');
+    CheckMatrices(l->m, x.m);
+    CheckMatrices(l->v, x.v);
+    CheckMatrices(l->r, x.r);
+    CheckMatrices(l->cube, x.cube);
+    CheckMatrices(arma::mat(l->sp), arma::mat(x.sp));
+    REQUIRE(l->v.n_cols == 1);
+    REQUIRE(l->r.n_rows == 1);
+  }
+
+  // The matrices of the mapped model alias the aligned blocks of the file.
+  REQUIRE(w.m.mem_state == 1);
+  REQUIRE(w.v.mem_state == 1);
+  REQUIRE(w.r.mem_state == 1);
+  if (mapped.IsMapped())
+  {
+    REQUIRE((size_t) w.m.memptr() % 64 == 0);
+    REQUIRE((size_t) w.v.memptr() % 64 == 0);
+    REQUIRE((size_t) w.r.memptr() % 64 == 0);
+  }
+
+  // A mapped matrix can be modified and resized.
+  w.m(0, 0) = 5.0;
+  REQUIRE(w.m(0, 0) == 5.0);
+  w.v.set_size(100);
+  w.v.fill(2.0);
+  REQUIRE(arma::accu(w.v) == Approx(200.0));
+
+  // A file that was not saved with format::aligned_binary can't be mapped.
+  REQUIRE(data::Save("test_unaligned.bin", "x", x, false) == true);
+  REQUIRE_THROWS_AS(data::MappedModel<ArmaModel>("test_unaligned.bin", "x"),
+      std::runtime_error);
+
+  remove("test_aligned.bin");
+  remove("test_unaligned.bin");
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -2311,6 +2508,78 @@ TEST_CASE("CategoryCaseTest", "[LoadSaveTest]")
   remove("test.arff");
 }
 
+/**
+ * Make sure that sparse ARFF lines can be loaded into dense and sparse
+ * matrices, and mixed with dense lines.
+ */
+TEST_CASE("SparseARFFTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two {A, B, C}" << endl;
+  f << "@attribute three numeric" << endl;
+  f << "@attribute four string" << endl;
+  f << "@data" << endl;
+  f << "{0 1.5, 3 'hello, world'}" << endl;
+  f << endl;
+  f << "% comment" << endl;
+  f << "{1 C, 2 -2} % comment" << endl;
+  f << "{}" << endl;
+  f << "3, B, 0, \"hello, world\"" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  if (!data::Load("test.arff", dataset, info))
+    FAIL("Cannot load dataset");
+
+  REQUIRE(dataset.n_rows == 4);
+  REQUIRE(dataset.n_cols == 4);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.NumMappings(1) == 3);
+  REQUIRE(info.Type(3) == Datatype::categorical);
+  REQUIRE(info.NumMappings(3) == 1);
+
+  // The values that aren't given are 0 (the first category, for the
+  // categorical attributes).
+  REQUIRE(dataset(0, 0) == Approx(1.5).epsilon(1e-7));
+  REQUIRE(dataset(1, 0) == 0.0);
+  REQUIRE(dataset(2, 0) == 0.0);
+  REQUIRE(dataset(3, 0) == 0.0);
+  REQUIRE(dataset(1, 1) == info.MapString<double>("C", 1));
+  REQUIRE(dataset(2, 1) == Approx(-2.0).epsilon(1e-7));
+  REQUIRE(arma::all(dataset.col(2) == 0.0));
+  REQUIRE(dataset(0, 3) == Approx(3.0).epsilon(1e-7));
+  REQUIRE(dataset(1, 3) == info.MapString<double>("B", 1));
+  REQUIRE(dataset(3, 3) == dataset(3, 0));
+
+  arma::sp_mat sparseDataset;
+  DatasetInfo sparseInfo;
+  data::LoadARFF("test.arff", sparseDataset, sparseInfo);
+
+  REQUIRE(sparseDataset.n_rows == 4);
+  REQUIRE(sparseDataset.n_cols == 4);
+  REQUIRE(sparseDataset.n_nonzero == 5);
+  CheckMatrices(arma::mat(sparseDataset), dataset);
+
+  // Unordered sparse indices aren't allowed.
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one numeric" << endl;
+  f << "@attribute two numeric" << endl;
+  f << "@data" << endl;
+  f << "{1 2, 0 1}" << endl;
+  f.close();
+
+  DatasetInfo badInfo;
+  REQUIRE_THROWS_AS(data::LoadARFF("test.arff", dataset, badInfo),
+      std::runtime_error);
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -2486,6 +2755,57 @@ TEST_CASE("DatasetMapperNonUniqueTest", "[LoadSaveTest]")
   REQUIRE(dm.UnmapString(nan, 0, 2) == "cheese");
 }
 
+/**
+ * Make sure the mappings of a DatasetMapper survive serialization, both in the
+ * compact format of DatasetInfo and in the older format that is still used for
+ * mappers without a version.
+ */
+TEST_CASE("DatasetMapperSerializationTest", "[LoadSaveTest]")
+{
+  DatasetInfo info(3);
+  for (size_t i = 0; i < 1000; ++i)
+    info.MapString<double>("value" + std::to_string(i % 300), 2);
+  info.MapString<double>("hello", 0);
+
+  DatasetInfo xmlInfo, jsonInfo, binaryInfo;
+  SerializeObjectAll(info, xmlInfo, jsonInfo, binaryInfo);
+
+  for (DatasetInfo* newInfo : { &xmlInfo, &jsonInfo, &binaryInfo })
+  {
+    REQUIRE(newInfo->Dimensionality() == 3);
+    REQUIRE(newInfo->Type(0) == Datatype::categorical);
+    REQUIRE(newInfo->Type(1) == Datatype::numeric);
+    REQUIRE(newInfo->NumMappings(0) == 1);
+    REQUIRE(newInfo->NumMappings(1) == 0);
+    REQUIRE(newInfo->NumMappings(2) == 300);
+    for (size_t i = 0; i < 300; ++i)
+    {
+      REQUIRE(newInfo->UnmapString(i, 2) == "value" + std::to_string(i));
+      REQUIRE(newInfo->UnmapValue("value" + std::to_string(i), 2) == i);
+    }
+
+    // New strings get the next value.
+    REQUIRE(newInfo->MapString<double>("new", 2) == 300.0);
+  }
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> dm(policy, 1);
+  dm.MapString<size_t>(5.0, 0);
+  dm.MapString<size_t>(4.3, 0);
+
+  DatasetMapper<IncrementPolicy, double> xmlDm, jsonDm, binaryDm;
+  SerializeObjectAll(dm, xmlDm, jsonDm, binaryDm);
+
+  for (DatasetMapper<IncrementPolicy, double>* newDm :
+      { &xmlDm, &jsonDm, &binaryDm })
+  {
+    REQUIRE(newDm->NumMappings(0) == 2);
+    REQUIRE(newDm->UnmapValue(5.0, 0) == 0);
+    REQUIRE(newDm->UnmapValue(4.3, 0) == 1);
+    REQUIRE(newDm->UnmapString(1, 0) == 4.3);
+  }
+}
+
 /**
  * Make sure if we load a CSV with a header, that that header doesn't get loaded
  * as a point.
@@ -2504,3 +2824,410 @@ TEST_CASE("LoadCSVHeaderTest", "[LoadSaveTest]")
   REQUIRE(dataset.n_rows == 4);
   REQUIRE(dataset.n_cols == 2);
 }
+
+/**
+ * Make sure a matrix saved as an mlpack binary dataset is loaded back exactly,
+ * with and without transposing.
+ */
+TEST_CASE("SaveLoadMlbinTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(13, 1000, arma::fill::randu);
+
+  arma::mat test;
+  REQUIRE(data::Save("test.mlbin", dataset) == true);
+  REQUIRE(data::Load("test.mlbin", test) == true);
+
+  REQUIRE(test.n_rows == dataset.n_rows);
+  REQUIRE(test.n_cols == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    REQUIRE(test[i] == dataset[i]);
+
+  // The transpose parameter means the same as for the other formats.
+  arma::mat transposed;
+  REQUIRE(data::Save("test.mlbin", dataset, false, false) == true);
+  REQUIRE(data::Load("test.mlbin", transposed, false, false) == true);
+
+  REQUIRE(transposed.n_rows == dataset.n_rows);
+  REQUIRE(transposed.n_cols == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    REQUIRE(transposed[i] == dataset[i]);
+
+  // Loading with a different element type fails.
+  arma::fmat wrongType;
+  REQUIRE(data::Load("test.mlbin", wrongType) == false);
+
+  remove("test.mlbin");
+}
+
+/**
+ * Make sure the mappings of a dataset are saved along with it.
+ */
+TEST_CASE("SaveLoadMlbinDatasetInfoTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "1, a, 0.5" << endl;
+  f << "2, b, 1.5" << endl;
+  f << "3, a, 2.5" << endl;
+  f << "4, c, 3.5" << endl;
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_file.csv", dataset, info) == true);
+
+  // Mappings can't be saved to other formats.
+  REQUIRE(data::Save("test_file.csv", dataset, info) == false);
+  REQUIRE(data::Save("test.mlbin", dataset, info) == true);
+
+  arma::mat test;
+  data::DatasetInfo testInfo;
+  REQUIRE(data::Load("test.mlbin", test, testInfo) == true);
+
+  REQUIRE(test.n_rows == dataset.n_rows);
+  REQUIRE(test.n_cols == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    REQUIRE(test[i] == dataset[i]);
+
+  REQUIRE(testInfo.Dimensionality() == 3);
+  REQUIRE(testInfo.Type(0) == data::Datatype::numeric);
+  REQUIRE(testInfo.Type(1) == data::Datatype::categorical);
+  REQUIRE(testInfo.Type(2) == data::Datatype::numeric);
+  REQUIRE(testInfo.NumMappings(1) == 3);
+  for (size_t i = 0; i < test.n_cols; ++i)
+  {
+    REQUIRE(testInfo.UnmapString(test(1, i), 1) ==
+        info.UnmapString(dataset(1, i), 1));
+  }
+
+  // A file saved without mappings has only numeric dimensions.
+  REQUIRE(data::Save("test.mlbin", dataset) == true);
+  REQUIRE(data::Load("test.mlbin", test, testInfo) == true);
+  REQUIRE(testInfo.Dimensionality() == 3);
+  REQUIRE(testInfo.Type(1) == data::Datatype::numeric);
+
+  remove("test_file.csv");
+  remove("test.mlbin");
+}
+
+/**
+ * Make sure ColumnarFile gives the same matrix whether the file is compressed
+ * or not, that an uncompressed file is mapped without copying, and that
+ * selected columns can be read.
+ */
+TEST_CASE("ColumnarFileTest", "[LoadSaveTest]")
+{
+  // Integer-valued data with many repeated values compresses well.  Use enough
+  // points to get several blocks.
+  arma::mat dataset = arma::floor(arma::randu<arma::mat>(10, 30000) * 4.0);
+  dataset.col(7).randu();
+
+  arma::uvec columns;
+  columns << 29999 << 3 << 7 << 15000 << 3 << 0;
+
+  for (size_t compress = 0; compress < 2; ++compress)
+  {
+    data::ColumnarFile<double>::Save("test.mlbin", dataset, (compress == 1));
+
+    data::ColumnarFile<double> file("test.mlbin");
+    REQUIRE(file.NumRows() == dataset.n_rows);
+    REQUIRE(file.NumCols() == dataset.n_cols);
+    REQUIRE(file.IsCompressed() == (compress == 1));
+    REQUIRE(file.HasInfo() == false);
+
+    const arma::mat& mapped = file.Matrix();
+    REQUIRE(mapped.n_rows == dataset.n_rows);
+    REQUIRE(mapped.n_cols == dataset.n_cols);
+    for (size_t i = 0; i < dataset.n_elem; ++i)
+      REQUIRE(mapped[i] == dataset[i]);
+
+    arma::mat selected;
+    file.LoadColumns(columns, selected);
+    REQUIRE(selected.n_rows == dataset.n_rows);
+    REQUIRE(selected.n_cols == columns.n_elem);
+    for (size_t i = 0; i < columns.n_elem; ++i)
+      for (size_t j = 0; j < dataset.n_rows; ++j)
+        REQUIRE(selected(j, i) == dataset(j, columns[i]));
+
+    arma::uvec badColumns;
+    badColumns << 30000;
+    REQUIRE_THROWS_AS(file.LoadColumns(badColumns, selected),
+        std::invalid_argument);
+
+    data::DatasetInfo info;
+    REQUIRE_THROWS_AS(file.LoadInfo(info), std::runtime_error);
+  }
+
+  // The compressed file must actually be smaller.
+  data::ColumnarFile<double>::Save("test.mlbin", dataset, false);
+  std::ifstream uncompressed("test.mlbin", std::ios::binary | std::ios::ate);
+  const size_t uncompressedSize = (size_t) uncompressed.tellg();
+  uncompressed.close();
+
+  data::ColumnarFile<double>::Save("test.mlbin", dataset, true);
+  std::ifstream compressed("test.mlbin", std::ios::binary | std::ios::ate);
+  const size_t compressedSize = (size_t) compressed.tellg();
+  compressed.close();
+
+  REQUIRE(compressedSize < uncompressedSize / 2);
+
+  // A truncated file is rejected.
+  std::ofstream truncated("test.mlbin", std::ios::binary | std::ios::trunc);
+  truncated << "MLPKDATA";
+  truncated.close();
+
+  REQUIRE_THROWS_AS(data::ColumnarFile<double>("test.mlbin"),
+      std::runtime_error);
+
+  remove("test.mlbin");
+}
+
+/**
+ * Make sure that placing the columns of a matrix over the NUMA nodes doesn't
+ * change its contents, when loading it and when building a tree on it.
+ */
+TEST_CASE("NumaPlacementTest", "[LoadSaveTest]")
+{
+  REQUIRE(data::NumaPlacement() == false);
+  data::SetNumaPlacement(true);
+
+  // The matrix must be large enough to be placed.
+  arma::mat dataset(10, 60000, arma::fill::randu);
+  arma::mat placed(dataset);
+  data::PlaceColumns(placed);
+  REQUIRE(placed.n_rows == dataset.n_rows);
+  REQUIRE(placed.n_cols == dataset.n_cols);
+  REQUIRE(arma::all(arma::vectorise(placed == dataset)));
+
+  arma::mat test;
+  REQUIRE(data::Save("test.mlbin", dataset) == true);
+  REQUIRE(data::Load("test.mlbin", test) == true);
+  REQUIRE(arma::all(arma::vectorise(test == dataset)));
+
+  // The tree holds the same points, in its own order.
+  std::vector<size_t> oldFromNew;
+  tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, arma::mat>
+      kdTree(dataset, oldFromNew);
+  for (size_t i = 0; i < dataset.n_cols; i += 997)
+  {
+    REQUIRE(arma::all(kdTree.Dataset().col(i) ==
+        dataset.col(oldFromNew[i])));
+  }
+
+  data::SetNumaPlacement(false);
+  remove("test.mlbin");
+}
+
+/**
+ * Make sure LibSVM files are loaded into the right sparse matrix and labels.
+ */
+TEST_CASE("LoadLibSVMTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test.svm", std::fstream::out);
+  f << "# A comment line." << std::endl;
+  f << "1 1:0.5 3:2.5" << std::endl;
+  f << std::endl;
+  f << "-1 qid:3 4:1 2:-3 # unsorted, with a query id" << std::endl;
+  f << "0.5 2:0 5:7\r" << std::endl;
+  f << "2" << std::endl;
+  f.close();
+
+  arma::sp_mat matrix;
+  arma::rowvec labels;
+  REQUIRE(data::LoadLibSVM("test.svm", matrix, labels) == true);
+
+  REQUIRE(matrix.n_rows == 5);
+  REQUIRE(matrix.n_cols == 4);
+  REQUIRE(matrix.n_nonzero == 5);
+  REQUIRE(matrix(0, 0) == 0.5);
+  REQUIRE(matrix(2, 0) == 2.5);
+  REQUIRE(matrix(1, 1) == -3.0);
+  REQUIRE(matrix(3, 1) == 1.0);
+  REQUIRE(matrix(4, 2) == 7.0);
+  REQUIRE(labels.n_elem == 4);
+  REQUIRE(labels[0] == 1.0);
+  REQUIRE(labels[1] == -1.0);
+  REQUIRE(labels[2] == 0.5);
+  REQUIRE(labels[3] == 2.0);
+
+  // The number of features can be given, and the indices can start at 0.
+  REQUIRE(data::LoadLibSVM("test.svm", matrix, labels, false, 10, true) ==
+      true);
+  REQUIRE(matrix.n_rows == 10);
+  REQUIRE(matrix(1, 0) == 0.5);
+  REQUIRE(matrix(5, 2) == 7.0);
+  REQUIRE(data::LoadLibSVM("test.svm", matrix, labels, false, 4) == false);
+
+  // data::Load() loads the features only.
+  arma::sp_mat loaded;
+  REQUIRE(data::Load("test.svm", loaded) == true);
+  REQUIRE(loaded.n_rows == 5);
+  REQUIRE(loaded.n_cols == 4);
+  REQUIRE(loaded(4, 2) == 7.0);
+
+  // Bad files are rejected.
+  const char* badLines[] = { "1 2:1 2:3", "a 1:1", "1 2", "1 0:1",
+      "1 1:x" };
+  for (size_t i = 0; i < 5; ++i)
+  {
+    f.open("test.svm", std::fstream::out);
+    f << "1 1:1" << std::endl << badLines[i] << std::endl;
+    f.close();
+
+    REQUIRE(data::LoadLibSVM("test.svm", matrix, labels) == false);
+    REQUIRE_THROWS_AS(data::LoadLibSVM("test.svm", matrix, labels, true),
+        std::runtime_error);
+  }
+
+  // A file large enough to be split across threads gives the same matrix as
+  // building it from its entries.
+  arma::sp_mat expected;
+  expected.sprandu(50, 20000, 0.1);
+  arma::rowvec expectedLabels = arma::floor(3 * arma::randu<arma::rowvec>(
+      20000));
+  f.open("test.svm", std::fstream::out);
+  f << std::setprecision(17);
+  for (size_t j = 0; j < expected.n_cols; ++j)
+  {
+    f << expectedLabels[j];
+    for (arma::sp_mat::const_col_iterator it = expected.begin_col(j);
+         it != expected.end_col(j); ++it)
+      f << " " << (it.row() + 1) << ":" << (*it);
+    f << std::endl;
+  }
+  f.close();
+
+  REQUIRE(data::LoadLibSVM("test.svm", matrix, labels, false, 50) == true);
+  REQUIRE(matrix.n_cols == expected.n_cols);
+  REQUIRE(matrix.n_nonzero == expected.n_nonzero);
+  REQUIRE(arma::accu(arma::abs(matrix - expected)) == 0.0);
+  REQUIRE(arma::all(labels == expectedLabels));
+
+  remove("test.svm");
+}
+
+/**
+ * Make sure that a matrix written in blocks with a BlockWriter can be loaded,
+ * with and without transposing it and converting its elements.
+ */
+TEST_CASE("BlockWriterTest", "[LoadSaveTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 103);
+
+  for (size_t transpose = 0; transpose < 2; ++transpose)
+  {
+    for (size_t writeBehind = 0; writeBehind < 2; ++writeBehind)
+    {
+      data::BlockWriter<double> writer("test.bin", 5, 103, (transpose == 1),
+          arma::auto_detect, (writeBehind == 1));
+      for (size_t i = 0; i < 103; i += 10)
+        writer.Write(dataset.cols(i, std::min(i + 10, size_t(103)) - 1));
+      writer.Finish();
+
+      arma::mat loaded;
+      REQUIRE(data::Load("test.bin", loaded, false, (transpose == 1)));
+      REQUIRE(arma::approx_equal(loaded, dataset, "absdiff", 0.0));
+    }
+  }
+
+  // Indices can be stored with 32 bits.
+  arma::Mat<size_t> indices = arma::randi<arma::Mat<size_t>>(7, 55,
+      arma::distr_param(0, 1000));
+  data::SaveInBlocks<uint32_t>("test.bin", indices, true, arma::auto_detect,
+      4);
+  arma::Mat<uint32_t> loadedIndices;
+  REQUIRE(data::Load("test.bin", loadedIndices));
+  REQUIRE(loadedIndices.n_rows == 7);
+  REQUIRE(loadedIndices.n_cols == 55);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    REQUIRE(loadedIndices[i] == indices[i]);
+
+  // Too many or too few points can't be written.
+  data::BlockWriter<double> writer("test.bin", 5, 20);
+  writer.Write(dataset.cols(0, 9));
+  REQUIRE_THROWS_AS(writer.Write(dataset.cols(0, 19)), std::invalid_argument);
+  REQUIRE_THROWS_AS(writer.Write(arma::mat(4, 2)), std::invalid_argument);
+  REQUIRE_THROWS_AS(writer.Finish(), std::runtime_error);
+
+  REQUIRE_THROWS_AS(data::BlockWriter<double>("test.csv", 5, 20),
+      std::invalid_argument);
+
+  remove("test.bin");
+}
+
+/**
+ * Make sure that streaming a dataset in blocks gives the same points as loading
+ * it, for each format that can be streamed, with and without reading ahead.
+ */
+TEST_CASE("DataStreamTest", "[LoadSaveTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 103);
+
+  data::Save("test.csv", dataset);
+  data::Save("test.bin", dataset);
+  data::Save("test_nt.bin", dataset, false, false);
+  data::ColumnarFile<double>::Save("test.mlbin", dataset);
+
+  const std::string files[] = { "test.csv", "test.bin", "test_nt.bin",
+      "test.mlbin" };
+  for (size_t f = 0; f < 4; ++f)
+  {
+    for (size_t readAhead = 0; readAhead < 2; ++readAhead)
+    {
+      data::DataStream<double> stream(files[f], 10, (f != 2),
+          (readAhead == 1));
+      REQUIRE(stream.NumRows() == dataset.n_rows);
+      if (f == 0)
+        REQUIRE(stream.NumCols() == size_t(-1));
+      else
+        REQUIRE(stream.NumCols() == dataset.n_cols);
+
+      // Stream the dataset twice, to check Reset().
+      for (size_t pass = 0; pass < 2; ++pass)
+      {
+        arma::mat block;
+        size_t numBlocks = 0;
+        while (stream.Next(block))
+        {
+          const size_t begin = 10 * numBlocks;
+          ++numBlocks;
+          REQUIRE(block.n_rows == dataset.n_rows);
+          REQUIRE(block.n_cols == std::min(size_t(10), 103 - begin));
+          REQUIRE(stream.Position() == begin + block.n_cols);
+
+          // The CSV file holds rounded values.
+          const double tolerance = (f == 0) ? 1e-5 : 0.0;
+          REQUIRE(arma::approx_equal(block, dataset.cols(begin,
+              begin + block.n_cols - 1), "absdiff", tolerance));
+        }
+
+        REQUIRE(numBlocks == 11);
+        REQUIRE(block.n_cols == 0);
+        stream.Reset();
+      }
+    }
+  }
+
+  // A point with the wrong number of values is reported when its block is
+  // read.
+  std::ofstream bad("test.csv");
+  for (size_t i = 0; i < 15; ++i)
+    bad << "1, 2, 3" << std::endl;
+  bad << "1, 2" << std::endl;
+  bad.close();
+
+  data::DataStream<double> badStream("test.csv", 10);
+  arma::mat block;
+  REQUIRE(badStream.Next(block) == true);
+  REQUIRE_THROWS_AS(badStream.Next(block), std::runtime_error);
+
+  REQUIRE_THROWS_AS(data::DataStream<double>("test.csv", 0),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(data::DataStream<float>("test.bin"), std::runtime_error);
+
+  remove("test.csv");
+  remove("test.bin");
+  remove("test_nt.bin");
+  remove("test.mlbin");
+}
@@ -501,6 +501,51 @@ TEST_CASE("LogisticRegressionFunctionRegularizationSeparableGradient",
   }
 }
 
+/**
+ * Make sure that the objective and gradient on a dataset large enough to be
+ * split into several blocks match the sums over small batches.
+ */
+TEST_CASE("LogisticRegressionFunctionBlockedEvaluate",
+          "[LogisticRegressionTest]")
+{
+  const size_t points = 20000;
+  const size_t dimension = 10;
+  const size_t batchSize = 500;
+
+  arma::mat data;
+  data.randn(dimension, points);
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+
+  arma::rowvec parameters;
+  parameters.randn(dimension + 1);
+
+  double batchObjective = 0.0;
+  arma::mat batchGradient(arma::size(parameters), arma::fill::zeros);
+  for (size_t i = 0; i < points; i += batchSize)
+  {
+    arma::mat gradient;
+    batchObjective += lrf.Evaluate(parameters, i, batchSize);
+    lrf.Gradient(parameters, i, gradient, batchSize);
+    batchGradient += gradient;
+  }
+
+  arma::mat gradient, fullGradient;
+  const double objective = lrf.EvaluateWithGradient(parameters, gradient);
+  lrf.Gradient(parameters, fullGradient);
+
+  REQUIRE(objective == Approx(batchObjective).epsilon(1e-7));
+  REQUIRE(lrf.Evaluate(parameters) == Approx(batchObjective).epsilon(1e-7));
+  for (size_t j = 0; j < parameters.n_elem; ++j)
+  {
+    REQUIRE(gradient[j] == Approx(batchGradient[j]).epsilon(1e-7));
+    REQUIRE(fullGradient[j] == Approx(batchGradient[j]).epsilon(1e-7));
+  }
+}
+
 // Test training of logistic regression on a simple dataset.
 TEST_CASE("LogisticRegressionLBFGSSimpleTest", "[LogisticRegressionTest]")
 {
@@ -21,6 +21,7 @@
 #include <mlpack/methods/ann/loss_functions/earth_mover_distance.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/sigmoid_cross_entropy_error.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/binary_cross_entropy_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/reconstruction_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/margin_ranking_loss.hpp>
@@ -380,6 +381,43 @@ TEST_CASE("SimpleSigmoidCrossEntropyErrorTest", "[LossFunctionsTest]")
   REQUIRE(output.n_cols == input3.n_cols);
 }
 
+/**
+ * Make sure that the softmax cross-entropy loss gives the same loss and
+ * gradient as the LogSoftMax layer followed by the negative log likelihood.
+ * (LogSoftMax approximates the exponential, so the tolerance is loose.)
+ */
+TEST_CASE("SoftmaxCrossEntropyLossTest", "[LossFunctionsTest]")
+{
+  arma::mat input = arma::randn(10, 20);
+  // Large scores must not overflow.
+  input.col(3) += 1000.0;
+  arma::mat target(1, 20);
+  for (size_t i = 0; i < target.n_cols; ++i)
+    target(i) = math::RandInt(0, 10);
+
+  SoftmaxCrossEntropyLoss<> module;
+  LogSoftMax<> logSoftMax;
+  NegativeLogLikelihood<> nll;
+
+  arma::mat logProbabilities;
+  logSoftMax.Forward(input, logProbabilities);
+  const double expected = nll.Forward(logProbabilities, target);
+  REQUIRE(module.Forward(input, target) == Approx(expected).epsilon(1e-4));
+
+  arma::mat error, expectedOutput, output;
+  nll.Backward(logProbabilities, target, error);
+  logSoftMax.Backward(logProbabilities, error, expectedOutput);
+  module.Backward(input, target, output);
+
+  REQUIRE(output.n_rows == input.n_rows);
+  REQUIRE(output.n_cols == input.n_cols);
+  CheckMatrices(output, expectedOutput, 1e-2);
+
+  // The gradient of each point sums to zero.
+  for (size_t i = 0; i < output.n_cols; ++i)
+    REQUIRE(arma::accu(output.col(i)) == Approx(0.0).margin(1e-10));
+}
+
 /**
  * Simple test for the Earth Mover Distance Layer.
  */
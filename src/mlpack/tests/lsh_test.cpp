@@ -850,8 +850,90 @@ TEST_CASE("ParallelMonochromatic", "[LSHTest]")
       sequentialNeighbors, parallelNeighbors);
   REQUIRE(recall == 1);
 }
+
+/**
+ * Test: building the hash tables with multiple threads gives exactly the same
+ * second hash table as building them with one thread.
+ */
+TEST_CASE("ParallelTrain", "[LSHTest]")
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 20000);
+
+  math::RandomSeed(42);
+  LSHSearch<> parallelLSH(rdata, 3, 10, 0.5, 99901, 50);
+
+  size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  LSHSearch<> sequentialLSH(rdata, 3, 10, 0.5, 99901, 50);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(parallelLSH.BucketOffsets(), sequentialLSH.BucketOffsets());
+  CheckMatrices(parallelLSH.BucketContents(), sequentialLSH.BucketContents());
+}
 #endif
 
+/**
+ * Test: the compressed second hash table respects the bucket size, and every
+ * row holds valid point indices.
+ */
+TEST_CASE("LSHBucketLayoutTest", "[LSHTest]")
+{
+  const size_t bucketSize = 3;
+  arma::mat rdata = arma::randu<arma::mat>(3, 1000);
+  LSHSearch<> lsh(rdata, 2, 5, 0.3, 99901, bucketSize);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<size_t>& contents = lsh.BucketContents();
+  REQUIRE(offsets.n_elem > 1);
+  REQUIRE(offsets[0] == 0);
+  REQUIRE(offsets[offsets.n_elem - 1] == contents.n_elem);
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    REQUIRE(offsets[i + 1] > offsets[i]);
+    REQUIRE(offsets[i + 1] - offsets[i] <= bucketSize);
+  }
+
+  for (size_t i = 0; i < contents.n_elem; ++i)
+    REQUIRE(contents[i] < rdata.n_cols);
+
+  // The per-row view matches the compressed layout.
+  std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  REQUIRE(table.size() == offsets.n_elem - 1);
+  for (size_t i = 0; i < table.size(); ++i)
+    REQUIRE(table[i].n_elem == offsets[i + 1] - offsets[i]);
+}
+
+/**
+ * The queries are hashed in blocks that share buffers; make sure that the
+ * results of multiprobe search are the same as when each query is searched on
+ * its own.
+ */
+TEST_CASE("LSHBlockedMultiprobeSearchTest", "[LSHTest]")
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(4, 600);
+  LSHSearch<> lsh(rdata, 4, 6, 0.5, 99901, 100);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(qdata, 3, neighbors, distances, 4, 5);
+
+  for (size_t i = 0; i < qdata.n_cols; i += 37)
+  {
+    arma::Mat<size_t> queryNeighbors;
+    arma::mat queryDistances;
+    lsh.Search(qdata.col(i), 3, queryNeighbors, queryDistances, 4, 5);
+
+    REQUIRE(arma::all(queryNeighbors.col(0) == neighbors.col(i)));
+    for (size_t j = 0; j < 3; ++j)
+    {
+      if (queryNeighbors(j, 0) < rdata.n_cols)
+        REQUIRE(queryDistances(j, 0) == Approx(distances(j, i)));
+    }
+  }
+}
+
 // Test the copy constructor and the copy operator.
 TEST_CASE("LSHTestCopyConstructorAndOperatorTest", "[LSHTest]")
 {
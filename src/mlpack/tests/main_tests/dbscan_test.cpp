@@ -475,3 +475,37 @@ TEST_CASE_METHOD(DBSCANTestFixture, "DBSCANRandomSelectionFlagTest",
 
   REQUIRE(arma::accu(orderedOutput != randomOutput) > 0);
 }
+
+/**
+ * Check that the grid gives the same assignments as single-tree search.
+ */
+TEST_CASE_METHOD(DBSCANTestFixture, "DBSCANGridTest",
+                 "[DBSCANMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("single_mode", true);
+
+  mlpackMain();
+
+  arma::Row<size_t> singleModeOutput;
+  singleModeOutput = std::move(IO::GetParam<arma::Row<size_t>>("assignments"));
+
+  bindings::tests::CleanMemory();
+
+  IO::GetSingleton().Parameters()["input"].wasPassed = false;
+  IO::GetSingleton().Parameters()["single_mode"].wasPassed = false;
+
+  SetInputParam("input", inputData);
+  SetInputParam("grid", true);
+
+  mlpackMain();
+
+  arma::Row<size_t> gridOutput;
+  gridOutput = std::move(IO::GetParam<arma::Row<size_t>>("assignments"));
+
+  CheckMatrices(singleModeOutput, gridOutput);
+}
@@ -244,3 +244,65 @@ TEST_CASE_METHOD(HMMViterbiTestFixture,
   REQUIRE(out.n_rows == 1);
   REQUIRE(out.n_cols == observations.n_cols);
 }
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiSparseBeamTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+  HMMModel* h2 = new HMMModel(*h);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+
+  mlpackMain();
+
+  arma::Mat<size_t> out = IO::GetParam<arma::Mat<size_t> >("output");
+
+  // With the sparse transition matrix and a beam wide enough to keep every
+  // state, the same sequence must be predicted.
+  bindings::tests::CleanMemory();
+  IO::GetSingleton().Parameters()["input_model"].wasPassed = false;
+
+  SetInputParam("input_model", h2);
+  SetInputParam("input", std::move(inp));
+  SetInputParam("sparse", true);
+  SetInputParam("beam", 1e10);
+
+  mlpackMain();
+
+  arma::Mat<size_t> out2 = IO::GetParam<arma::Mat<size_t> >("output");
+
+  REQUIRE(out2.n_rows == out.n_rows);
+  REQUIRE(out2.n_cols == out.n_cols);
+  for (size_t i = 0; i < out.n_elem; ++i)
+    REQUIRE(out2[i] == out[i]);
+}
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiNegativeBeamTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", std::move(inp));
+  SetInputParam("beam", -1.0);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
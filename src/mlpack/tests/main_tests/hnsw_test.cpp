@@ -0,0 +1,138 @@
+/**
+ * @file tests/main_tests/hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    IO::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    IO::ClearSettings();
+  }
+};
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWOutputDimensionTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", std::move(query));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::Mat<size_t>>("neighbors").n_cols == 40);
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_rows == 6);
+  REQUIRE(IO::GetParam<arma::mat>("distances").n_cols == 40);
+}
+
+/**
+ * Check that a saved model gives the same results, and that reference points
+ * passed with a model are inserted into it.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWModelReuseTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(3, 200);
+  arma::mat query = arma::randu<arma::mat>(3, 20);
+
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 3);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = IO::GetParam<arma::Mat<size_t>>("neighbors");
+  arma::mat distances = IO::GetParam<arma::mat>("distances");
+
+  IO::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model",
+      IO::GetParam<neighbor::HNSW<>*>("output_model"));
+  SetInputParam("query", query);
+
+  mlpackMain();
+
+  CheckMatrices(neighbors, IO::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, IO::GetParam<arma::mat>("distances"));
+
+  // Now insert more points into the model.
+  SetInputParam("reference", arma::mat(arma::randu<arma::mat>(3, 50)));
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<neighbor::HNSW<>*>("output_model")->ReferenceSet().n_cols
+      == 250);
+}
+
+/**
+ * Check that an invalid k is rejected.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWInvalidKTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(3, 20);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 20);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) -1);
+
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Check that max_neighbors must be at least 2.
+ */
+TEST_CASE_METHOD(HNSWTestFixture, "HNSWInvalidMaxNeighborsTest",
+                 "[HNSWMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(3, 20);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("max_neighbors", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
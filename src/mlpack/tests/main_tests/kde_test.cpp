@@ -574,3 +574,62 @@ TEST_CASE_METHOD(KDETestFixture, "KDEMainMonteCarloFlag",
   const double sumDifferences = arma::accu(differences);
   REQUIRE(sumDifferences > 0);
 }
+
+/**
+  * Ensure that the grid algorithm gives normalized estimations within the
+  * relative error tolerance of the dual-tree algorithm.
+ **/
+TEST_CASE_METHOD(KDETestFixture, "KDEMainGridAlgorithm",
+                "[KDEMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = 0.6 * arma::randu(2, 100) + 0.2;
+  arma::vec kdeEstimations, mainEstimations;
+  double kernelBandwidth = 0.2;
+  double relError = 0.01;
+
+  kernel::GaussianKernel kernel(kernelBandwidth);
+  metric::EuclideanDistance metric;
+  KDE<kernel::GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::KDTree>
+      kde(relError, 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(query, kdeEstimations);
+  kdeEstimations /= kernel.Normalizer(reference.n_rows);
+
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("kernel", std::string("gaussian"));
+  SetInputParam("algorithm", std::string("grid"));
+  SetInputParam("rel_error", 0.05);
+  SetInputParam("bandwidth", kernelBandwidth);
+
+  mlpackMain();
+
+  mainEstimations = std::move(IO::GetParam<arma::vec>("predictions"));
+  REQUIRE(IO::GetParam<KDEModel*>("output_model")->TreeType() ==
+      KDEModel::GRID);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(kdeEstimations[i] == Approx(mainEstimations[i]).epsilon(0.06));
+}
+
+/**
+  * Ensure we get an exception when the grid algorithm is used with a kernel
+  * other than the Gaussian kernel.
+ **/
+TEST_CASE_METHOD(KDETestFixture, "KDEMainGridInvalidKernel",
+                "[KDEMainTest][BindingTests]")
+{
+  arma::mat reference = arma::randu<arma::mat>(2, 10);
+
+  SetInputParam("reference", reference);
+  SetInputParam("kernel", std::string("epanechnikov"));
+  SetInputParam("algorithm", std::string("grid"));
+
+  Log::Fatal.ignoreInput = true;
+  REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
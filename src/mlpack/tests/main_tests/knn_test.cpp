@@ -698,3 +698,86 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNDifferentLeafSizes",
   REQUIRE(IO::GetParam<KNNModel*>("output_model")->LeafSize() == (int) 10);
   delete output_model;
 }
+
+/**
+ * Make sure that points can be deleted from and inserted into the reference
+ * set of a model, and that the results match a search on the updated set.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNUpdateReferenceTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 100); // 100 points in 3 dimensions.
+  arma::mat insertData;
+  insertData.randu(3, 5);
+  arma::mat queryData;
+  queryData.randu(3, 20);
+  arma::Col<size_t> deleteIndices = { 3, 50, 99 };
+
+  arma::mat expected = referenceData;
+  for (size_t i = deleteIndices.n_elem; i > 0; --i)
+    expected.shed_col(deleteIndices[i - 1]);
+  expected = arma::join_rows(expected, insertData);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("delete_reference", deleteIndices);
+  SetInputParam("insert_reference", insertData);
+  SetInputParam("query", queryData);
+  SetInputParam("k", (int) 10);
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<KNNModel*>("output_model")->NumReferencePoints() ==
+      102);
+
+  KNN naive(expected, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queryData, 10, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(IO::GetParam<arma::Mat<size_t>>("neighbors"), naiveNeighbors);
+  CheckMatrices(IO::GetParam<arma::mat>("distances"), naiveDistances);
+}
+
+/**
+ * Make sure that streaming the query points from a file in small chunks gives
+ * the same results as searching for all of them at once.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNQueryStreamTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 200);
+  arma::mat queryData;
+  queryData.randu(3, 53);
+
+  // One point per line.
+  if (!data::Save("knn_stream_queries.csv", queryData))
+    FAIL("Cannot save query points!");
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> expectedNeighbors;
+  arma::mat expectedDistances;
+  knn.Search(queryData, 5, expectedNeighbors, expectedDistances);
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("query_stream", std::string("knn_stream_queries.csv"));
+  SetInputParam("neighbors_stream", std::string("knn_stream_neighbors.csv"));
+  SetInputParam("distances_stream", std::string("knn_stream_distances.csv"));
+  SetInputParam("chunk_size", (int) 10);
+  SetInputParam("k", (int) 5);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE(data::Load("knn_stream_neighbors.csv", neighbors));
+  REQUIRE(data::Load("knn_stream_distances.csv", distances));
+
+  remove("knn_stream_queries.csv");
+  remove("knn_stream_neighbors.csv");
+  remove("knn_stream_distances.csv");
+
+  CheckMatrices(neighbors, expectedNeighbors);
+  CheckMatrices(distances, expectedDistances);
+}
@@ -525,3 +525,40 @@ TEST_CASE_METHOD(RandomForestTestFixture, "RandomForestWarmStart",
 
   REQUIRE(oldNumTrees + 10 == newNumTrees);
 }
+
+/**
+ * Ensure that max_trees removes the oldest trees of a warm-started model.
+ */
+TEST_CASE_METHOD(RandomForestTestFixture, "RandomForestWarmStartMaxTrees",
+                 "[RandomForestMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Input training data.
+  SetInputParam("training", inputData);
+  SetInputParam("labels", labels);
+
+  mlpackMain();
+
+  // Input training data.
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("warm_start", true);
+  SetInputParam("num_trees", (int) 4);
+  SetInputParam("max_trees", (int) 10);
+
+  // Input pre-trained model.
+  SetInputParam("input_model",
+                IO::GetParam<RandomForestModel*>("output_model"));
+
+  mlpackMain();
+
+  REQUIRE(IO::GetParam<RandomForestModel*>("output_model")->rf.NumTrees() ==
+      10);
+}
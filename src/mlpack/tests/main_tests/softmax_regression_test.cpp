@@ -155,7 +155,7 @@ TEST_CASE_METHOD(
   // Input trained model.
   SetInputParam("test", std::move(testData));
   SetInputParam("input_model",
-                IO::GetParam<SoftmaxRegression*>("output_model"));
+                IO::GetParam<SoftmaxRegression<>*>("output_model"));
 
   mlpackMain();
 
@@ -286,7 +286,7 @@ TEST_CASE_METHOD(
 
   // Input pre-trained model.
   SetInputParam("input_model",
-                IO::GetParam<SoftmaxRegression*>("output_model"));
+                IO::GetParam<SoftmaxRegression<>*>("output_model"));
 
   Log::Fatal.ignoreInput = true;
   REQUIRE_THROWS_AS(mlpackMain(), std::runtime_error);
@@ -334,7 +334,7 @@ TEST_CASE_METHOD(
 
   // Store output parameters.
   arma::mat modelParam;
-  modelParam = IO::GetParam<SoftmaxRegression*>("output_model")->Parameters();
+  modelParam = IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters();
 
   bindings::tests::CleanMemory();
 
@@ -358,7 +358,7 @@ TEST_CASE_METHOD(
   for (size_t i = 0; i < modelParam.n_elem; ++i)
   {
     REQUIRE(modelParam[i] !=
-        IO::GetParam<SoftmaxRegression*>("output_model")->Parameters()[i]);
+        IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters()[i]);
   }
 }
 
@@ -403,7 +403,7 @@ TEST_CASE_METHOD(
 
   // Store output parameters.
   arma::mat modelParam;
-  modelParam = IO::GetParam<SoftmaxRegression*>("output_model")->Parameters();
+  modelParam = IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters();
 
   bindings::tests::CleanMemory();
 
@@ -427,7 +427,7 @@ TEST_CASE_METHOD(
   for (size_t i = 0; i < modelParam.n_elem; ++i)
   {
     REQUIRE(modelParam[i] !=
-        IO::GetParam<SoftmaxRegression*>("output_model")->Parameters()[i]);
+        IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters()[i]);
   }
 }
 
@@ -472,7 +472,7 @@ TEST_CASE_METHOD(
 
   // Store output parameters.
   arma::mat modelParam;
-  modelParam = IO::GetParam<SoftmaxRegression*>("output_model")->Parameters();
+  modelParam = IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters();
 
   bindings::tests::CleanMemory();
 
@@ -494,6 +494,6 @@ TEST_CASE_METHOD(
   // Check that initial parameters has 1 more parameter than
   // final parameters matrix.
   REQUIRE(
-      IO::GetParam<SoftmaxRegression*>("output_model")->Parameters().n_cols ==
+      IO::GetParam<SoftmaxRegression<>*>("output_model")->Parameters().n_cols ==
       modelParam.n_cols + 1);
 }
@@ -60,3 +60,49 @@ TEST_CASE("UniformMatrixCompletionSDP", "[MatrixCompletionTest]")
        Approx(Xorig(indices(0, i), indices(1, i))).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure that the ALS solver recovers a random low-rank matrix from half of
+ * its entries, and that both Recover() overloads agree.
+ */
+TEST_CASE("UniformMatrixCompletionALS", "[MatrixCompletionTest]")
+{
+  const arma::mat Xorig = arma::randu<arma::mat>(60, 3) *
+      arma::randu<arma::mat>(3, 50);
+
+  // Take every other entry, shifted by one on odd rows.
+  arma::umat indices(2, Xorig.n_elem / 2);
+  arma::vec values(indices.n_cols);
+  size_t p = 0;
+  for (size_t i = 0; i < Xorig.n_rows; ++i)
+  {
+    for (size_t j = (i % 2); j < Xorig.n_cols; j += 2, ++p)
+    {
+      indices(0, p) = i;
+      indices(1, p) = j;
+      values(p) = Xorig(i, j);
+    }
+  }
+
+  MatrixCompletion mc(Xorig.n_rows, Xorig.n_cols, indices, values, 3,
+      ALS_SOLVER);
+  REQUIRE(mc.Solver() == ALS_SOLVER);
+  mc.Lambda() = 1e-9;
+
+  arma::mat recovered, u, v;
+  mc.Recover(recovered);
+  mc.Recover(u, v);
+
+  REQUIRE(u.n_rows == Xorig.n_rows);
+  REQUIRE(v.n_rows == Xorig.n_cols);
+  REQUIRE(u.n_cols == 3);
+  REQUIRE(v.n_cols == 3);
+
+  const double err = arma::norm(Xorig - recovered, "fro") /
+      arma::norm(Xorig, "fro");
+  REQUIRE(err == Approx(0.0).margin(1e-3));
+
+  const double factorErr = arma::norm(recovered - u * v.t(), "fro") /
+      arma::norm(Xorig, "fro");
+  REQUIRE(factorErr == Approx(0.0).margin(1e-8));
+}
@@ -162,3 +162,40 @@ TEST_CASE("GaussianClustering", "[MeanShiftTest]")
 
   REQUIRE(success == true);
 }
+
+// Make sure that no two returned centroids are closer than the radius, and that
+// every point is assigned to its nearest centroid, when many seeds are used.
+TEST_CASE("MeanShiftDistinctCentroidsTest", "[MeanShiftTest]")
+{
+  arma::mat dataset(2, 1500, arma::fill::randn);
+  dataset.cols(500, 999).each_col() += arma::vec("8.0 0.0");
+  dataset.cols(1000, 1499).each_col() += arma::vec("0.0 8.0");
+
+  // Use every point as a seed.
+  MeanShift<> meanShift(2.0);
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(dataset, assignments, centroids, true, false);
+
+  REQUIRE(centroids.n_cols >= 3);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    for (size_t j = i + 1; j < centroids.n_cols; ++j)
+    {
+      REQUIRE(metric::EuclideanDistance::Evaluate(centroids.col(i),
+          centroids.col(j)) >= 2.0);
+    }
+  }
+
+  REQUIRE(assignments.n_elem == dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const double assigned = metric::EuclideanDistance::Evaluate(
+        dataset.col(i), centroids.col(assignments[i]));
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      REQUIRE(assigned <= metric::EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j)) + 1e-10);
+    }
+  }
+}
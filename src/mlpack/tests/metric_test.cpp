@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include "catch.hpp"
 #include <mlpack/core/metrics/iou_metric.hpp>
 #include <mlpack/core/metrics/non_maximal_supression.hpp>
@@ -97,6 +98,94 @@ TEST_CASE("LINFMetricTest", "[MetricTest]")
       Approx(lMetric.Evaluate(a2, b2)).epsilon(1e-7));
 }
 
+/**
+ * Make sure that the batch evaluation of the L-p metrics matches the
+ * evaluation of each pair.
+ */
+TEST_CASE("LMetricBatchTest", "[MetricTest]")
+{
+  arma::mat a(6, 40, arma::fill::randn);
+  arma::mat b(6, 25, arma::fill::randn);
+  b.col(3) = a.col(7);
+
+  arma::mat l1, l2, squaredL2, lInf;
+  ManhattanDistance::Evaluate(a, b, l1);
+  EuclideanDistance::Evaluate(a, b, l2);
+  SquaredEuclideanDistance::Evaluate(a, b, squaredL2);
+  ChebyshevDistance::Evaluate(a, b, lInf);
+
+  REQUIRE(l2.n_rows == a.n_cols);
+  REQUIRE(l2.n_cols == b.n_cols);
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      REQUIRE(l1(i, j) == Approx(ManhattanDistance::Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-10));
+      REQUIRE(l2(i, j) == Approx(EuclideanDistance::Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-7).margin(1e-6));
+      REQUIRE(squaredL2(i, j) == Approx(SquaredEuclideanDistance::Evaluate(
+          a.col(i), b.col(j))).epsilon(1e-7).margin(1e-10));
+      REQUIRE(lInf(i, j) == Approx(ChebyshevDistance::Evaluate(a.col(i),
+          b.col(j))).epsilon(1e-10));
+    }
+  }
+
+  // Identical points can't have a negative distance.
+  REQUIRE(squaredL2(7, 3) >= 0.0);
+
+  arma::mat c(5, 10, arma::fill::randn);
+  REQUIRE_THROWS_AS(EuclideanDistance::Evaluate(a, c, l2),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the batch evaluation of the Mahalanobis distance matches the
+ * evaluation of each pair, and that the Euclidean distance between transformed
+ * points is the Mahalanobis distance, for full-rank and low-rank covariances.
+ */
+TEST_CASE("MahalanobisBatchTransformTest", "[MetricTest]")
+{
+  arma::mat a(5, 30, arma::fill::randn);
+  arma::mat b(5, 20, arma::fill::randn);
+
+  for (size_t rank = 3; rank <= 5; rank += 2)
+  {
+    const arma::mat l(rank, 5, arma::fill::randn);
+    MahalanobisDistance<true> distance(l.t() * l);
+
+    arma::mat distances;
+    distance.Evaluate(a, b, distances);
+    REQUIRE(distances.n_rows == a.n_cols);
+    REQUIRE(distances.n_cols == b.n_cols);
+
+    arma::mat aTransformed, bTransformed;
+    distance.Transform(a, aTransformed);
+    distance.Transform(b, bTransformed);
+    REQUIRE(aTransformed.n_rows == 5);
+
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      for (size_t i = 0; i < a.n_cols; ++i)
+      {
+        const double expected = distance.Evaluate(a.col(i), b.col(j));
+        REQUIRE(distances(i, j) ==
+            Approx(expected).epsilon(1e-7).margin(1e-6));
+        REQUIRE(EuclideanDistance::Evaluate(aTransformed.col(i),
+            bTransformed.col(j)) == Approx(expected).epsilon(1e-7));
+      }
+    }
+  }
+
+  // The squared distance without a covariance is the squared Euclidean
+  // distance.
+  MahalanobisDistance<false> identity;
+  arma::mat distances;
+  identity.Evaluate(a, b, distances);
+  REQUIRE(distances(4, 6) == Approx(SquaredEuclideanDistance::Evaluate(
+      a.col(4), b.col(6))).epsilon(1e-7));
+}
+
 /**
  * Simple test for IoU metric.
  */
@@ -398,3 +398,68 @@ TEST_CASE("NaiveBayesClassifierHighDimensionsTest", "[NBCTest]")
   for (size_t i = 0; i < calcVec.n_cols; ++i)
     REQUIRE(calcVec(i) == testLabels(i));
 }
+
+/**
+ * Make sure that training on sparse data gives the same model and the same
+ * predictions as training on the same data stored densely.
+ */
+TEST_CASE("NaiveBayesClassifierSparseTest", "[NBCTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(40, 600, 0.1);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(600,
+      arma::distr_param(0, 2));
+  arma::mat data(sparseData);
+
+  NaiveBayesClassifier<> nbc(data, labels, 3);
+  NaiveBayesClassifier<> sparseNbc(sparseData, labels, 3);
+
+  REQUIRE(arma::approx_equal(nbc.Means(), sparseNbc.Means(), "absdiff",
+      1e-10));
+  REQUIRE(arma::approx_equal(nbc.Variances(), sparseNbc.Variances(),
+      "absdiff", 1e-10));
+  REQUIRE(arma::approx_equal(nbc.Probabilities(), sparseNbc.Probabilities(),
+      "absdiff", 1e-10));
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  nbc.Classify(data, predictions, probabilities);
+  sparseNbc.Classify(sparseData, sparsePredictions, sparseProbabilities);
+
+  REQUIRE(arma::all(predictions == sparsePredictions));
+  REQUIRE(arma::approx_equal(probabilities, sparseProbabilities, "absdiff",
+      1e-8));
+}
+
+/**
+ * Make sure that training incrementally on several batches gives the same model
+ * as training on one point at a time.
+ */
+TEST_CASE("NaiveBayesClassifierIncrementalBatchesTest", "[NBCTest]")
+{
+  arma::mat data(5, 900, arma::fill::randn);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(900,
+      arma::distr_param(0, 3));
+  data.each_row() += arma::conv_to<arma::rowvec>::from(labels);
+
+  NaiveBayesClassifier<> nbc(5, 4);
+  nbc.Train(data.cols(0, 299), labels.subvec(0, 299), 4, true);
+  nbc.Train(data.cols(300, 899), labels.subvec(300, 899), 4, true);
+
+  NaiveBayesClassifier<> pointNbc(5, 4);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    pointNbc.Train(data.col(i), labels[i]);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    REQUIRE(nbc.Means()[i] == Approx(pointNbc.Means()[i]).epsilon(1e-7));
+    REQUIRE(nbc.Variances()[i] ==
+        Approx(pointNbc.Variances()[i]).epsilon(1e-7));
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    REQUIRE(nbc.Probabilities()[i] ==
+        Approx(pointNbc.Probabilities()[i]).epsilon(1e-7));
+  }
+}
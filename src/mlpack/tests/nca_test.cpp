@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::metric;
@@ -246,6 +247,30 @@ TEST_CASE("SoftmaxSeparableGradient", "[NCATesT]")
   REQUIRE(gradient(1, 1) == Approx(-2.0 * -0.1435886).epsilon(0.0001));
 }
 
+/**
+ * The separable objective and gradient over the whole dataset should match the
+ * non-separable objective and gradient.
+ */
+TEST_CASE("SoftmaxSeparableMatchesNonSeparable", "[NCATesT]")
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+    labels[i] = i % 3;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  arma::mat coordinates = arma::randu<arma::mat>(3, 3) + arma::eye(3, 3);
+
+  const double objective = sef.Evaluate(coordinates);
+  REQUIRE(sef.Evaluate(coordinates, 0, 100) ==
+      Approx(objective).epsilon(1e-7));
+
+  arma::mat gradient, separableGradient;
+  sef.Gradient(coordinates, gradient);
+  sef.Gradient(coordinates, 0, separableGradient, 100);
+  CheckMatrices(gradient, separableGradient, 1e-4);
+}
+
 //
 // Tests for the NCA algorithm.
 //
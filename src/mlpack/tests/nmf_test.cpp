@@ -18,6 +18,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace std;
 using namespace arma;
@@ -240,6 +241,54 @@ TEST_CASE("SparseNMFALSTest", "[NMFTest]")
   REQUIRE(success == true);
 }
 
+/**
+ * Make sure that one step of the ALS and multiplicative distance update rules
+ * gives the same result as the closed-form expressions, for both sparse and
+ * dense input matrices.
+ */
+TEST_CASE("SparseNMFUpdateRulesMatchDenseTest", "[NMFTest]")
+{
+  sp_mat v;
+  v.sprandu(300, 200, 0.05);
+  const mat dv(v);
+  const mat h0 = randu<mat>(6, 200) + 0.1;
+  const mat w0 = randu<mat>(300, 6) + 0.1;
+
+  // Alternating least squares.
+  mat w(w0), dw(w0);
+  NMFALSUpdate::WUpdate(v, w, h0);
+  NMFALSUpdate::WUpdate(dv, dw, h0);
+  mat expectedW = dv * h0.t() * pinv(h0 * h0.t());
+  expectedW.elem(find(expectedW < 0.0)).zeros();
+  CheckMatrices(w, expectedW, 1e-5);
+  CheckMatrices(dw, expectedW, 1e-5);
+
+  mat h(h0), dh(h0);
+  NMFALSUpdate::HUpdate(v, w0, h);
+  NMFALSUpdate::HUpdate(dv, w0, dh);
+  mat expectedH = pinv(w0.t() * w0) * w0.t() * dv;
+  expectedH.elem(find(expectedH < 0.0)).zeros();
+  CheckMatrices(h, expectedH, 1e-5);
+  CheckMatrices(dh, expectedH, 1e-5);
+
+  // Multiplicative distance updates.
+  w = w0;
+  dw = w0;
+  NMFMultiplicativeDistanceUpdate::WUpdate(v, w, h0);
+  NMFMultiplicativeDistanceUpdate::WUpdate(dv, dw, h0);
+  expectedW = (w0 % (dv * h0.t())) / (w0 * h0 * h0.t());
+  CheckMatrices(w, expectedW, 1e-5);
+  CheckMatrices(dw, expectedW, 1e-5);
+
+  h = h0;
+  dh = h0;
+  NMFMultiplicativeDistanceUpdate::HUpdate(v, w0, h);
+  NMFMultiplicativeDistanceUpdate::HUpdate(dv, w0, dh);
+  expectedH = (h0 % (w0.t() * dv)) / (w0.t() * w0 * h0);
+  CheckMatrices(h, expectedH, 1e-5);
+  CheckMatrices(dh, expectedH, 1e-5);
+}
+
 /**
  * Check if all elements in W and H are non-negative.
  * Default Case.
@@ -0,0 +1,128 @@
+/**
+ * @file tests/nn_descent_test.cpp
+ *
+ * Unit tests for the 'NNDescent' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/nn_descent.hpp>
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Compute the fraction of the true neighbors that were found.
+ */
+static double NNDescentRecall(const arma::Mat<size_t>& found,
+                              const arma::Mat<size_t>& truth)
+{
+  size_t hits = 0;
+  for (size_t i = 0; i < found.n_cols; ++i)
+  {
+    for (size_t j = 0; j < found.n_rows; ++j)
+    {
+      if (arma::any(truth.col(i) == found(j, i)))
+        ++hits;
+    }
+  }
+
+  return (double) hits / found.n_elem;
+}
+
+/**
+ * Make sure that the graph is close to the exact k-nearest-neighbor graph for
+ * each way of building the initial graph, and that it has the format of the
+ * results of KNN::Search().
+ */
+TEST_CASE("NNDescentRecallTest", "[NNDescentTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(8, 2000);
+  const size_t k = 10;
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  typedef NNDescent<> NNDescentType;
+  const NNDescentType::InitializationType initializations[] = {
+      NNDescentType::RANDOM_INIT, NNDescentType::RP_TREE_INIT,
+      NNDescentType::SPILL_TREE_INIT };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    NNDescentType nnDescent(initializations[i], 0);
+    nnDescent.Tau() = 0.05;
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    nnDescent.Compute(dataset, k, neighbors, distances);
+
+    REQUIRE(neighbors.n_rows == k);
+    REQUIRE(neighbors.n_cols == dataset.n_cols);
+    REQUIRE(distances.n_rows == k);
+    REQUIRE(distances.n_cols == dataset.n_cols);
+    REQUIRE(NNDescentRecall(neighbors, trueNeighbors) >= 0.9);
+
+    // NN-descent must need fewer distance evaluations than brute force.
+    REQUIRE(nnDescent.DistanceEvaluations() <
+        dataset.n_cols * (dataset.n_cols - 1) / 2);
+
+    // The distances must be sorted and correct, and no point may be its own
+    // neighbor.
+    for (size_t p = 0; p < neighbors.n_cols; ++p)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        REQUIRE(neighbors(j, p) != p);
+        REQUIRE(distances(j, p) == Approx(metric::EuclideanDistance::Evaluate(
+            dataset.col(p), dataset.col(neighbors(j, p)))).epsilon(1e-7));
+        if (j > 0)
+          REQUIRE(distances(j, p) >= distances(j - 1, p));
+      }
+    }
+  }
+}
+
+/**
+ * NN-descent on a tiny dataset, where every other point is a neighbor, must
+ * find the exact graph.
+ */
+TEST_CASE("NNDescentSmallDatasetTest", "[NNDescentTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 8);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(7, trueNeighbors, trueDistances);
+
+  NNDescent<> nnDescent;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  nnDescent.Compute(dataset, 7, neighbors, distances);
+
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+}
+
+/**
+ * Invalid parameters must be rejected.
+ */
+TEST_CASE("NNDescentInvalidParametersTest", "[NNDescentTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  NNDescent<> nnDescent;
+  REQUIRE_THROWS_AS(nnDescent.Compute(dataset, 10, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(NNDescent<>(NNDescent<>::RANDOM_INIT, 10, 0.0),
+      std::invalid_argument);
+}
@@ -230,3 +230,37 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Test that the sparse one-hot encoding of a matrix is the same as the dense
+ * encoding, with a dimension with many categories.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat matrix(4, 2000);
+  matrix.row(0) = arma::randn<arma::rowvec>(2000);
+  matrix.row(1) = arma::conv_to<arma::rowvec>::from(
+      arma::randi<arma::irowvec>(2000, arma::distr_param(0, 999)));
+  matrix.row(2).zeros();
+  matrix.row(3) = arma::conv_to<arma::rowvec>::from(
+      arma::randi<arma::irowvec>(2000, arma::distr_param(0, 2)));
+
+  arma::Col<size_t> indices("1 3");
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  data::OneHotEncoding(matrix, indices, output);
+  data::OneHotEncoding(matrix, indices, sparseOutput);
+
+  REQUIRE(sparseOutput.n_rows == output.n_rows);
+  REQUIRE(sparseOutput.n_cols == output.n_cols);
+  // The numeric dimension of zeros has no nonzero values.
+  REQUIRE(sparseOutput.n_nonzero == arma::accu(output != 0.0));
+  CheckMatrices(arma::mat(sparseOutput), output);
+
+  // The labels overload gives the same encoding as the dense one.
+  arma::mat labelsOutput;
+  arma::sp_mat sparseLabelsOutput;
+  data::OneHotEncoding(matrix.row(3), labelsOutput);
+  data::OneHotEncoding(matrix.row(3), sparseLabelsOutput);
+  CheckMatrices(arma::mat(sparseLabelsOutput), labelsOutput);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file tests/parallel_test.cpp
+ *
+ * Tests for the functions that configure the number of threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+/**
+ * Test that the number of threads can be set, restored to the default, and set
+ * for a scope.
+ */
+TEST_CASE("NumThreadsTest", "[ParallelTest]")
+{
+  const size_t defaultNumThreads = DefaultNumThreads();
+  REQUIRE(defaultNumThreads >= 1);
+  REQUIRE(NumThreads() == defaultNumThreads);
+
+  #ifdef HAS_OPENMP
+  SetNumThreads(3);
+  REQUIRE(NumThreads() == 3);
+
+  size_t teamSize = 0;
+  #pragma omp parallel
+  {
+    #pragma omp single
+    teamSize = (size_t) omp_get_num_threads();
+  }
+  REQUIRE(teamSize <= 3);
+
+  {
+    ScopedNumThreads scoped(2);
+    REQUIRE(NumThreads() == 2);
+
+    // 0 keeps the current number.
+    ScopedNumThreads unchanged(0);
+    REQUIRE(NumThreads() == 2);
+  }
+  REQUIRE(NumThreads() == 3);
+  #else
+  // Without OpenMP there is always one thread.
+  SetNumThreads(3);
+  REQUIRE(NumThreads() == 1);
+  #endif
+
+  SetNumThreads(0);
+  REQUIRE(NumThreads() == defaultNumThreads);
+}
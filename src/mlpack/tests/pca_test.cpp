@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -204,6 +205,15 @@ TEST_CASE("ArmaComparisonRandomizedPCATest", "[PCATest]")
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ */
+TEST_CASE("ArmaComparisonIncrementalPCATest", "[PCATest]")
+{
+  IncrementalSVDPolicy decomposition(128);
+  ArmaComparisonPCA<IncrementalSVDPolicy>(false, decomposition);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -336,3 +346,65 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
   // The eigenvalues should sum to three.
   REQUIRE(accu(eigval) == Approx(3.0).epsilon(0.001));
 }
+
+/**
+ * Make sure that streaming mini-batches through the incremental SVD policy
+ * gives the same decomposition as exact PCA, and that a truncated rank keeps
+ * the top components of low-rank data.
+ */
+TEST_CASE("IncrementalPCAStreamingTest", "[PCATest]")
+{
+  // Data with three strong directions, plus a little noise, and a mean far
+  // from the origin.
+  arma::mat data = arma::randn<arma::mat>(10, 3) *
+      arma::randn<arma::mat>(3, 2000) + 0.01 * arma::randn<arma::mat>(10, 2000);
+  data.each_col() += 100.0 * arma::randu<arma::vec>(10);
+
+  PCA<ExactSVDPolicy> exactPCA;
+  arma::mat exactTransformed, exactEigvec;
+  arma::vec exactEigVal;
+  exactPCA.Apply(data, exactTransformed, exactEigVal, exactEigvec);
+
+  IncrementalSVDPolicy full, truncated;
+  for (size_t first = 0; first < data.n_cols; first += 137)
+  {
+    const size_t last = std::min(first + 137, (size_t) data.n_cols) - 1;
+    full.Update(data.cols(first, last), 0);
+    truncated.Update(data.cols(first, last), 3);
+  }
+
+  REQUIRE(full.NumPoints() == 2000);
+  REQUIRE(truncated.Components().n_cols == 3);
+
+  arma::vec eigVal, truncatedEigVal;
+  full.EigenValues(eigVal);
+  truncated.EigenValues(truncatedEigVal);
+  REQUIRE(eigVal.n_elem == 10);
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(eigVal[i] == Approx(exactEigVal[i]).epsilon(1e-6));
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(truncatedEigVal[i] == Approx(exactEigVal[i]).epsilon(1e-4));
+
+  // The projections are the same up to the sign of each component.
+  arma::mat transformed;
+  truncated.Transform(data, transformed);
+  REQUIRE(transformed.n_rows == 3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (arma::dot(transformed.row(i), exactTransformed.row(i)) < 0)
+      transformed.row(i) *= -1;
+
+    REQUIRE(arma::norm(transformed.row(i) - exactTransformed.row(i)) <=
+        1e-3 * arma::norm(exactTransformed.row(i)));
+  }
+
+  // Dimensionality reduction through PCA keeps the requested dimensions.
+  PCA<IncrementalSVDPolicy> incrementalPCA(false, IncrementalSVDPolicy(500));
+  arma::mat reduced = data;
+  incrementalPCA.Apply(reduced, (size_t) 3);
+  REQUIRE(reduced.n_rows == 3);
+  REQUIRE(reduced.n_cols == 2000);
+
+  REQUIRE_THROWS_AS(full.Update(arma::randu<arma::mat>(5, 10), 0),
+      std::invalid_argument);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file tests/pipeline_test.cpp
+ *
+ * Tests for the data::Pipeline class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/pipeline.hpp>
+#include <mlpack/core/data/one_hot_encoding.hpp>
+#include <mlpack/core/data/imputation_methods/mean_imputation.hpp>
+#include <mlpack/core/data/scaler_methods/min_max_scaler.hpp>
+#include <mlpack/core/data/scaler_methods/standard_scaler.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+using namespace std;
+
+/**
+ * Create a dataset whose first two dimensions are numeric, with a few missing
+ * values, and whose last dimension is categorical.
+ */
+static arma::mat PipelineDataset(const size_t numPoints)
+{
+  arma::mat data(3, numPoints);
+  data.row(0) = arma::randn<arma::rowvec>(numPoints);
+  data.row(1) = 5 * arma::randu<arma::rowvec>(numPoints);
+  data.row(2) = arma::conv_to<arma::rowvec>::from(
+      arma::randi<arma::irowvec>(numPoints, arma::distr_param(0, 3)));
+  for (size_t i = 0; i < numPoints; i += 7)
+    data(i % 2, i) = std::numeric_limits<double>::quiet_NaN();
+
+  return data;
+}
+
+/**
+ * Make sure that the fused pipeline gives the same result as applying the
+ * imputer, the scaler and the one-hot encoding one after another.
+ */
+TEST_CASE("PipelineMatchesSeparateStagesTest", "[PipelineTest]")
+{
+  const arma::mat data = PipelineDataset(3000);
+
+  Pipeline<StandardScaler> pipeline;
+  pipeline.AddImputation(Pipeline<>::MEAN_IMPUTATION);
+  pipeline.AddScaling();
+  pipeline.AddOneHotEncoding(arma::Col<size_t>("2"));
+  pipeline.Fit(data);
+
+  arma::mat output;
+  pipeline.Transform(data, output);
+
+  // Apply the stages separately.
+  arma::mat expected = data;
+  MeanImputation<double> imputation;
+  imputation.Impute(expected, std::numeric_limits<double>::quiet_NaN(), 0);
+  imputation.Impute(expected, std::numeric_limits<double>::quiet_NaN(), 1);
+
+  StandardScaler scaler;
+  arma::mat numeric = expected.rows(0, 1);
+  scaler.Fit(numeric);
+  scaler.Transform(numeric, numeric);
+  expected.rows(0, 1) = numeric;
+
+  arma::mat encoded;
+  OneHotEncoding(expected, arma::Col<size_t>("2"), encoded);
+
+  REQUIRE(pipeline.OutputDimensionality() == encoded.n_rows);
+  CheckMatrices(output, encoded);
+
+  // Transforming in place gives the same result.
+  arma::mat inPlace = data;
+  pipeline.Transform(inPlace, inPlace);
+  CheckMatrices(output, inPlace);
+}
+
+/**
+ * Make sure that binarized dimensions are not scaled, that categories that
+ * were not seen by Fit() are encoded as zeros, and that the pipeline can be
+ * serialized.
+ */
+TEST_CASE("PipelineBinarizeSerializationTest", "[PipelineTest]")
+{
+  const arma::mat data = PipelineDataset(500);
+
+  Pipeline<MinMaxScaler> pipeline;
+  pipeline.AddImputation(Pipeline<MinMaxScaler>::CUSTOM_IMPUTATION,
+      std::numeric_limits<double>::quiet_NaN(), -1.0);
+  pipeline.AddBinarization(1, 2.5);
+  pipeline.AddScaling();
+  pipeline.AddOneHotEncoding(arma::Col<size_t>("2"));
+
+  // The pipeline must be fitted first.
+  arma::mat output;
+  REQUIRE_THROWS_AS(pipeline.Transform(data, output), std::runtime_error);
+  pipeline.Fit(data);
+  pipeline.Transform(data, output);
+
+  // Only the first dimension is scaled.
+  REQUIRE(arma::min(output.row(0)) == Approx(0.0).margin(1e-10));
+  REQUIRE(arma::max(output.row(0)) == Approx(1.0));
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const double expected = std::isnan(data(1, i)) ? 0.0 :
+        (data(1, i) > 2.5 ? 1.0 : 0.0);
+    REQUIRE(output(1, i) == expected);
+  }
+
+  // An unknown category is encoded as zeros.
+  arma::mat unknown = data.cols(0, 1);
+  unknown(2, 0) = 10.0;
+  arma::mat unknownOutput;
+  pipeline.Transform(unknown, unknownOutput);
+  REQUIRE(arma::accu(unknownOutput.col(0).tail(4)) == 0.0);
+  REQUIRE(arma::accu(unknownOutput.col(1).tail(4)) == 1.0);
+
+  Pipeline<MinMaxScaler> xmlPipeline, jsonPipeline, binaryPipeline;
+  SerializeObjectAll(pipeline, xmlPipeline, jsonPipeline, binaryPipeline);
+
+  arma::mat xmlOutput, jsonOutput, binaryOutput;
+  xmlPipeline.Transform(data, xmlOutput);
+  jsonPipeline.Transform(data, jsonOutput);
+  binaryPipeline.Transform(data, binaryOutput);
+  CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
+}
@@ -0,0 +1,231 @@
+/**
+ * @file tests/product_quantization_test.cpp
+ *
+ * Tests for the ProductQuantizer and IVFPQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/product_quantization/ivf_pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include "catch.hpp"
+#include "serialization.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Generate clustered data, which product quantization encodes well.
+ */
+static arma::mat PQTestData(const size_t dims,
+                            const size_t points,
+                            const size_t clusters)
+{
+  arma::mat centers = 10.0 * arma::randu<arma::mat>(dims, clusters);
+  arma::mat data = 0.5 * arma::randn<arma::mat>(dims, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) += centers.col(i % clusters);
+  return data;
+}
+
+/**
+ * Decoding the codes must approximate the original points much better than
+ * their mean does.
+ */
+TEST_CASE("ProductQuantizerReconstructionTest", "[ProductQuantizationTest]")
+{
+  arma::mat data = PQTestData(16, 2000, 20);
+
+  ProductQuantizer pq(4, 64);
+  pq.Train(data);
+  REQUIRE(pq.Dimensionality() == 16);
+
+  arma::Mat<unsigned char> codes;
+  pq.Encode(data, codes);
+  REQUIRE(codes.n_rows == 4);
+  REQUIRE(codes.n_cols == 2000);
+  REQUIRE(arma::max(arma::vectorise(codes)) < 64);
+
+  arma::mat reconstruction;
+  pq.Decode(codes, reconstruction);
+  REQUIRE(reconstruction.n_rows == 16);
+  REQUIRE(reconstruction.n_cols == 2000);
+
+  const double error = arma::accu(arma::square(data - reconstruction));
+  const double variance = arma::accu(arma::square(data.each_col() -
+      arma::mean(data, 1)));
+  REQUIRE(error < 0.1 * variance);
+}
+
+/**
+ * The asymmetric distance must equal the distance to the decoded point.
+ */
+TEST_CASE("ProductQuantizerAsymmetricDistanceTest",
+          "[ProductQuantizationTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(10, 500);
+  arma::mat queries = arma::randu<arma::mat>(10, 20);
+
+  // The subspaces have uneven sizes here.
+  ProductQuantizer pq(3, 16);
+  pq.Train(data);
+  REQUIRE(pq.SubspaceBegin(0) == 0);
+  REQUIRE(pq.SubspaceBegin(3) == 10);
+
+  arma::Mat<unsigned char> codes;
+  pq.Encode(data, codes);
+  arma::mat reconstruction;
+  pq.Decode(codes, reconstruction);
+
+  arma::mat table;
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    pq.DistanceTable(queries.colptr(q), table);
+    REQUIRE(table.n_rows == 16);
+    REQUIRE(table.n_cols == 3);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const double expected = arma::accu(arma::square(queries.col(q) -
+          reconstruction.col(i)));
+      REQUIRE(ProductQuantizer::Distance(table, codes.colptr(i)) ==
+          Approx(expected).epsilon(1e-10));
+    }
+  }
+}
+
+/**
+ * Make sure invalid parameters throw.
+ */
+TEST_CASE("ProductQuantizerInvalidParametersTest",
+          "[ProductQuantizationTest]")
+{
+  REQUIRE_THROWS_AS(ProductQuantizer(0, 256), std::invalid_argument);
+  REQUIRE_THROWS_AS(ProductQuantizer(4, 257), std::invalid_argument);
+  REQUIRE_THROWS_AS(IVFPQSearch(0), std::invalid_argument);
+
+  ProductQuantizer pq(8, 16);
+  // Too few dimensions and too few points.
+  REQUIRE_THROWS_AS(pq.Train(arma::randu<arma::mat>(4, 100)),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(pq.Train(arma::randu<arma::mat>(16, 10)),
+      std::invalid_argument);
+
+  arma::Mat<unsigned char> codes;
+  REQUIRE_THROWS_AS(pq.Encode(arma::randu<arma::mat>(16, 10), codes),
+      std::runtime_error);
+
+  IVFPQSearch index(10, 4, 16);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  REQUIRE_THROWS_AS(index.Add(arma::randu<arma::mat>(8, 10)),
+      std::runtime_error);
+
+  index.Train(arma::randu<arma::mat>(8, 200));
+  index.Add(arma::randu<arma::mat>(8, 50));
+  REQUIRE_THROWS_AS(index.Search(arma::randu<arma::mat>(8, 5), 51, neighbors,
+      distances), std::invalid_argument);
+  REQUIRE_THROWS_AS(index.Search(arma::randu<arma::mat>(7, 5), 1, neighbors,
+      distances), std::invalid_argument);
+}
+
+/**
+ * Points added in several batches must all be stored, with consecutive
+ * indices.
+ */
+TEST_CASE("IVFPQSearchAddTest", "[ProductQuantizationTest]")
+{
+  arma::mat data = PQTestData(8, 1500, 10);
+
+  IVFPQSearch index(16, 4, 32);
+  index.Train(data.cols(0, 499));
+  index.Add(data.cols(0, 999));
+  index.Add(data.cols(1000, 1499));
+  REQUIRE(index.NumPoints() == 1500);
+
+  std::vector<bool> seen(1500, false);
+  size_t total = 0;
+  for (size_t l = 0; l < index.NumLists(); ++l)
+  {
+    REQUIRE(index.ListCodes(l).size() == 4 * index.ListIndices(l).size());
+    for (size_t j = 0; j < index.ListIndices(l).size(); ++j)
+    {
+      REQUIRE(index.ListIndices(l)[j] < 1500);
+      REQUIRE(!seen[index.ListIndices(l)[j]]);
+      seen[index.ListIndices(l)[j]] = true;
+      ++total;
+    }
+  }
+  REQUIRE(total == 1500);
+}
+
+/**
+ * Searching all lists must find most of the true nearest neighbors.
+ */
+TEST_CASE("IVFPQSearchRecallTest", "[ProductQuantizationTest]")
+{
+  arma::mat data = PQTestData(16, 3000, 30);
+  arma::mat queries = data.cols(0, 99) + 0.1 * arma::randn<arma::mat>(16, 100);
+
+  KNN knn(data);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queries, 1, trueNeighbors, trueDistances);
+
+  IVFPQSearch index(20, 8, 256);
+  index.Train(data);
+  index.Add(data);
+
+  // Check that the true nearest neighbor is within the 10 returned ones.
+  size_t hits = 0;
+  const size_t probes[] = { 1, 5, 20 };
+  for (size_t p = 0; p < 3; ++p)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    index.Search(queries, 10, neighbors, distances, probes[p]);
+    REQUIRE(neighbors.n_rows == 10);
+    REQUIRE(neighbors.n_cols == 100);
+
+    hits = 0;
+    for (size_t i = 0; i < queries.n_cols; ++i)
+    {
+      if (arma::any(neighbors.col(i) == trueNeighbors(0, i)))
+        ++hits;
+      for (size_t j = 1; j < 10; ++j)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  REQUIRE(hits >= 90);
+}
+
+/**
+ * A serialized index must give the same results.
+ */
+TEST_CASE("IVFPQSearchSerializationTest", "[ProductQuantizationTest]")
+{
+  arma::mat data = PQTestData(8, 1000, 10);
+  arma::mat queries = arma::randu<arma::mat>(8, 20);
+
+  IVFPQSearch index(10, 4, 32);
+  index.Train(data);
+  index.Add(data);
+
+  IVFPQSearch xmlIndex, jsonIndex, binaryIndex;
+  SerializeObjectAll(index, xmlIndex, jsonIndex, binaryIndex);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, jsonDistances, binaryDistances;
+  index.Search(queries, 5, neighbors, distances, 3);
+  xmlIndex.Search(queries, 5, xmlNeighbors, xmlDistances, 3);
+  jsonIndex.Search(queries, 5, jsonNeighbors, jsonDistances, 3);
+  binaryIndex.Search(queries, 5, binaryNeighbors, binaryDistances, 3);
+
+  CheckMatrices(neighbors, xmlNeighbors, jsonNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, jsonDistances, binaryDistances);
+}
@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/loss_functions/empty_loss.hpp>
+#include <mlpack/methods/reinforcement_learning/agent_evaluator.hpp>
 #include <mlpack/methods/reinforcement_learning/q_learning.hpp>
 #include <mlpack/methods/reinforcement_learning/sac.hpp>
 #include <mlpack/methods/reinforcement_learning/q_networks/simple_dqn.hpp>
@@ -36,6 +37,7 @@
 #include <numeric>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -123,6 +125,99 @@ TEST_CASE("CartPoleWithDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Test DQN in Cart Pole task with several copies of the environment.
+TEST_CASE("CartPoleWithVectorizedDQN", "[QLearningTest]")
+{
+  // Set up the network.
+  SimpleDQN<> network(4, 128, 128, 2);
+
+  // Set up the policy and replay method.
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  // Setting all training hyperparameters.
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.Discount() = 0.9;
+  config.TargetNetworkSyncInterval() = 100;
+  config.ExplorationSteps() = 100;
+  config.DoubleQLearning() = false;
+  config.StepLimit() = 200;
+
+  // Set up DQN agent.
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  VectorizedEnvironment<CartPole> envs(8);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    const size_t totalSteps = agent.TotalSteps();
+    const double meanReturn = agent.Episode(envs);
+
+    // Each step of each copy counts as one step of the agent.
+    size_t steps = 0;
+    for (size_t j = 0; j < envs.NumEnvironments(); ++j)
+      steps += envs.Steps(j);
+    REQUIRE(agent.TotalSteps() == totalSteps + steps);
+    REQUIRE(std::isfinite(meanReturn));
+    REQUIRE(meanReturn == Approx(arma::mean(envs.Returns())));
+  }
+  REQUIRE(replayMethod.Size() == agent.TotalSteps());
+
+  // Vectorized episodes need single-step replay.
+  RandomReplay<CartPole> nStepReplay(10, 10000, 3);
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      nStepAgent(config, network, policy, nStepReplay);
+  REQUIRE_THROWS_AS(nStepAgent.Episode(envs), std::invalid_argument);
+}
+
+//! Test that AgentEvaluator runs deterministic episodes of a DQN agent.
+TEST_CASE("CartPoleDQNAgentEvaluator", "[QLearningTest]")
+{
+  SimpleDQN<> network(4, 32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.ExplorationSteps() = 100;
+
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  // Run the episodes in batches, with a last batch that is smaller.
+  AgentEvaluator<CartPole> evaluator(25, CartPole(), 10, 50, 42);
+  const double meanReturn = evaluator.Evaluate(agent);
+
+  REQUIRE(agent.Deterministic() == false);
+  REQUIRE(agent.TotalSteps() == 0);
+  REQUIRE(replayMethod.Size() == 0);
+  REQUIRE(evaluator.Returns().n_elem == 25);
+  REQUIRE(meanReturn == Approx(arma::mean(evaluator.Returns())));
+  for (size_t i = 0; i < 25; ++i)
+  {
+    // Cart Pole gives a reward of 1 for each step.
+    REQUIRE(evaluator.EpisodeSteps()[i] <= 50);
+    REQUIRE(evaluator.Returns()[i] == Approx(evaluator.EpisodeSteps()[i]));
+  }
+  REQUIRE(evaluator.TotalSteps() == arma::accu(evaluator.EpisodeSteps()));
+  REQUIRE(evaluator.StepsPerSecond() >= 0.0);
+
+  // The same seed gives the same episodes.
+  const arma::vec returns = evaluator.Returns();
+  evaluator.Evaluate(agent);
+  CheckMatrices(returns, evaluator.Returns());
+
+  // A single episode without a step limit is the same as a test episode.
+  AgentEvaluator<CartPole> single(1, CartPole(), 0, 0, 7);
+  single.Evaluate(agent);
+  math::RandomSeed(7);
+  agent.Deterministic() = true;
+  REQUIRE(agent.Episode() == Approx(single.Returns()[0]));
+
+  AgentEvaluator<CartPole> empty(0);
+  REQUIRE_THROWS_AS(empty.Evaluate(agent), std::invalid_argument);
+}
+
 //! Test DQN in Cart Pole task with Prioritized Replay.
 TEST_CASE("CartPoleWithDQNPrioritizedReplay", "[QLearningTest]")
 {
@@ -504,6 +599,45 @@ TEST_CASE("CartPoleWithCategoricalDQN", "[QLearningTest]")
   REQUIRE(converged);
 }
 
+//! Check that the distributions and action values given by CategoricalDQN are
+//! consistent.
+TEST_CASE("CategoricalDQNDistributionsTest", "[QLearningTest]")
+{
+  TrainingConfig config;
+  config.IsCategorical() = true;
+  config.AtomSize() = 11;
+  config.VMin() = -5.0;
+  config.VMax() = 5.0;
+
+  CategoricalDQN<> network(4, 16, 16, 3, config);
+  network.ResetParameters();
+
+  arma::mat states(4, 10, arma::fill::randu);
+  arma::mat dists, actionValues;
+  network.Forward(states, dists);
+  network.Predict(states, actionValues);
+
+  REQUIRE(dists.n_rows == 3 * config.AtomSize());
+  REQUIRE(dists.n_cols == 10);
+  REQUIRE(actionValues.n_rows == 3);
+  REQUIRE(actionValues.n_cols == 10);
+
+  const arma::rowvec support = arma::linspace<arma::rowvec>(config.VMin(),
+      config.VMax(), config.AtomSize());
+  for (size_t i = 0; i < states.n_cols; ++i)
+  {
+    for (size_t a = 0; a < 3; ++a)
+    {
+      const arma::vec dist = dists(a * config.AtomSize(), i,
+          arma::size(config.AtomSize(), 1));
+      REQUIRE(arma::all(dist >= 0.0));
+      REQUIRE(arma::accu(dist) == Approx(1.0).epsilon(1e-7));
+      REQUIRE(actionValues(a, i) ==
+          Approx(arma::as_scalar(support * dist)).epsilon(1e-7));
+    }
+  }
+}
+
 //! Test SAC on Pendulum task.
 TEST_CASE("PendulumWithSAC", "[QLearningTest]")
 {
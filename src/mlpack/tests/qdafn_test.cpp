@@ -241,3 +241,37 @@ TEST_CASE("QDAFNSparseTest", "[QDAFNTest]")
   REQUIRE(distances.n_rows == 3);
   REQUIRE(distances.n_cols == 1000);
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that training and searching with several threads gives the same
+ * results as with one thread.
+ */
+TEST_CASE("QDAFNParallelTest", "[QDAFNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 5000);
+  arma::mat queries = arma::randu<arma::mat>(5, 500);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  math::RandomSeed(7);
+  QDAFN<> serial(dataset, 10, 30);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serial.Search(queries, 3, serialNeighbors, serialDistances);
+
+  omp_set_num_threads(4);
+  math::RandomSeed(7);
+  QDAFN<> parallel(dataset, 10, 30);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  parallel.Search(queries, 3, neighbors, distances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(parallel.CandidateSet(), serial.CandidateSet());
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+}
+#endif
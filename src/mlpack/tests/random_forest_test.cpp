@@ -154,6 +154,46 @@ TEST_CASE("UnweightedNumericLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Make sure that a random forest with histogram splits is about as accurate as
+ * one with exact splits.
+ */
+TEST_CASE("HistogramNumericSplitLearningTest", "[RandomForestTest]")
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2.csv");
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, HistogramNumericSplit>
+      hrf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+
+  // Get performance statistics on test data.
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  arma::Row<size_t> rfPredictions;
+  arma::Row<size_t> hrfPredictions;
+
+  rf.Classify(testDataset, rfPredictions);
+  hrf.Classify(testDataset, hrfPredictions);
+
+  // Calculate the number of correct points.
+  size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  size_t hrfCorrect = arma::accu(hrfPredictions == testLabels);
+
+  REQUIRE(hrfCorrect >= rfCorrect * 0.9);
+  REQUIRE(hrfCorrect >= size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -559,6 +599,44 @@ TEST_CASE("WarmStartTreesPredictionsQualityTest", "[RandomForestTest]")
   REQUIRE(newCorrect >= oldCorrect);
 }
 
+/**
+ * Test that a warm-started Train() followed by RemoveOldestTrees() replaces the
+ * oldest trees and keeps the other ones, and that both check their arguments.
+ */
+TEST_CASE("ReplaceOldestTreesTest", "[RandomForestTest]")
+{
+  arma::mat trainingData;
+  arma::Row<size_t> trainingLabels;
+  data::DatasetInfo di;
+  MockCategoricalData(trainingData, trainingLabels, di);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 10 /* 10 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+
+  // Store the predictions of the newest five trees.
+  arma::Mat<size_t> oldPredictions(5, trainingData.n_cols);
+  for (size_t t = 0; t < 5; ++t)
+    for (size_t i = 0; i < trainingData.n_cols; ++i)
+      oldPredictions(t, i) = rf.Tree(5 + t).Classify(trainingData.col(i));
+
+  rf.Train(trainingData, di, trainingLabels, 5, 5 /* 5 trees */, 1, 1e-7, 0,
+      true /* warmStart */, MultipleRandomDimensionSelect(4));
+  REQUIRE(rf.NumTrees() == 15);
+  rf.RemoveOldestTrees(5);
+  REQUIRE(rf.NumTrees() == 10);
+
+  // The kept trees are now the oldest ones.
+  for (size_t t = 0; t < 5; ++t)
+    for (size_t i = 0; i < trainingData.n_cols; ++i)
+      REQUIRE(rf.Tree(t).Classify(trainingData.col(i)) == oldPredictions(t, i));
+
+  REQUIRE_THROWS_AS(rf.RemoveOldestTrees(11), std::invalid_argument);
+  REQUIRE_THROWS_AS(rf.Train(trainingData, di, trainingLabels, 6, 5, 1, 1e-7,
+      0, true /* warmStart */, MultipleRandomDimensionSelect(4)),
+      std::invalid_argument);
+  REQUIRE(rf.NumTrees() == 10);
+}
+
 /**
  * Ensure that the Extra Trees algorithm gives decent accuracy.
  */
@@ -609,3 +687,236 @@ TEST_CASE("ExtraTreesAccuracyTest", "[RandomForestTest]")
 
   REQUIRE(accuracy >= 0.91);
 }
+
+/**
+ * Make sure that a FlatForest gives the same predictions and probabilities as
+ * the random forest it was built from, on numeric and categorical data.
+ */
+TEST_CASE("FlatForestClassifyTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 25 /* 25 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+  FlatForest flat(rf);
+  REQUIRE(flat.NumTrees() == 25);
+  REQUIRE(flat.NumClasses() == 5);
+
+  arma::Row<size_t> predictions, flatPredictions;
+  arma::mat probabilities, flatProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  flat.Classify(testData, flatPredictions, flatProbabilities);
+
+  REQUIRE(arma::accu(predictions != flatPredictions) == 0);
+  REQUIRE(flatProbabilities.n_rows == probabilities.n_rows);
+  REQUIRE(flatProbabilities.n_cols == probabilities.n_cols);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    REQUIRE(flatProbabilities[i] == Approx(probabilities[i]).margin(1e-10));
+
+  // A single decision tree can be flattened too.
+  DecisionTree<> dt(trainingData, di, trainingLabels, 5, 5);
+  FlatForest flatTree;
+  flatTree.AddTree(dt);
+  dt.Classify(testData, predictions);
+  flatTree.Classify(testData, flatPredictions);
+  REQUIRE(arma::accu(predictions != flatPredictions) == 0);
+
+  // Trees with a different number of classes can't be added.
+  DecisionTree<> otherTree(trainingData, di, trainingLabels, 6, 5);
+  REQUIRE_THROWS_AS(flatTree.AddTree(otherTree), std::invalid_argument);
+}
+
+/**
+ * Make sure that a CompactForest gives the same predictions as the forest it
+ * was built from, and that a compacted RandomForest can be serialized.
+ */
+TEST_CASE("CompactForestClassifyTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // The thresholds are stored as floats, so the predictions are only exactly
+  // the same for values that can be stored as floats.
+  d = arma::conv_to<arma::mat>::from(arma::conv_to<arma::fmat>::from(d));
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 25 /* 25 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+  CompactForest compact(rf);
+  REQUIRE(compact.NumTrees() == 25);
+  REQUIRE(compact.NumClasses() == 5);
+
+  // Leaves with the same class probabilities share them, so there are fewer
+  // distinct leaves than leaves.
+  REQUIRE(compact.NumLeafDistributions() > 0);
+  REQUIRE(compact.NumLeafDistributions() < compact.NumNodes() / 2);
+
+  arma::Row<size_t> predictions, compactPredictions;
+  arma::mat probabilities, compactProbabilities;
+  rf.Classify(testData, predictions, probabilities);
+  compact.Classify(testData, compactPredictions, compactProbabilities);
+
+  REQUIRE(arma::accu(predictions != compactPredictions) == 0);
+  REQUIRE(compactProbabilities.n_rows == probabilities.n_rows);
+  REQUIRE(compactProbabilities.n_cols == probabilities.n_cols);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    REQUIRE(compactProbabilities[i] == Approx(probabilities[i]).margin(1e-6));
+
+  // Now compact the forest itself.
+  rf.Compact();
+  REQUIRE(rf.IsCompact());
+  REQUIRE(rf.NumTrees() == 0);
+  REQUIRE(rf.CompactModel().NumTrees() == 25);
+
+  arma::Row<size_t> forestPredictions;
+  rf.Classify(testData, forestPredictions);
+  REQUIRE(arma::accu(predictions != forestPredictions) == 0);
+
+  size_t prediction;
+  arma::vec pointProbabilities;
+  rf.Classify(testData.col(3), prediction, pointProbabilities);
+  REQUIRE(prediction == predictions[3]);
+  REQUIRE(rf.Classify(testData.col(7)) == predictions[7]);
+
+  // A compacted forest can't be warm-started.
+  REQUIRE_THROWS_AS(rf.Train(trainingData, di, trainingLabels, 5, 2, 1, 1e-7,
+      0, true), std::invalid_argument);
+
+  RandomForest<> xmlForest, jsonForest, binaryForest;
+  binaryForest.Train(trainingData, trainingLabels, 5, 3);
+  SerializeObjectAll(rf, xmlForest, jsonForest, binaryForest);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlForest.Classify(testData, xmlPredictions);
+  jsonForest.Classify(testData, jsonPredictions);
+  binaryForest.Classify(testData, binaryPredictions);
+  REQUIRE(binaryForest.IsCompact());
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+
+  // Training again replaces the compact model.
+  binaryForest.Train(trainingData, di, trainingLabels, 5, 3);
+  REQUIRE(!binaryForest.IsCompact());
+  REQUIRE(binaryForest.NumTrees() == 3);
+}
+
+/**
+ * Make sure that the out-of-bag points of a bootstrap sample are exactly the
+ * points that weren't drawn.
+ */
+TEST_CASE("BootstrapOutOfBagTest", "[RandomForestTest]")
+{
+  arma::mat dataset(1, 1000);
+  dataset.row(0) = arma::linspace<arma::rowvec>(0, 999, 1000);
+  arma::Row<size_t> labels(1000, arma::fill::zeros);
+  arma::rowvec weights; // Unused.
+
+  arma::mat bootstrapDataset;
+  arma::Row<size_t> bootstrapLabels;
+  arma::rowvec bootstrapWeights;
+  arma::uvec outOfBag;
+  Bootstrap<false>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights, outOfBag);
+
+  arma::Col<size_t> drawn(1000, arma::fill::zeros);
+  for (size_t i = 0; i < bootstrapDataset.n_cols; ++i)
+    drawn[(size_t) bootstrapDataset(0, i)] = 1;
+
+  REQUIRE(outOfBag.n_elem == 1000 - arma::accu(drawn));
+  for (size_t j = 0; j < outOfBag.n_elem; ++j)
+  {
+    REQUIRE(drawn[outOfBag[j]] == 0);
+    if (j > 0)
+      REQUIRE(outOfBag[j] > outOfBag[j - 1]);
+  }
+
+  // About a third of the points are out of bag.
+  REQUIRE(outOfBag.n_elem > 300);
+  REQUIRE(outOfBag.n_elem < 440);
+}
+
+/**
+ * Make sure that the out-of-bag error is close to the test error, and that it
+ * can't be computed without bootstrap samples.
+ */
+TEST_CASE("RandomForestOOBErrorTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  RandomForest<> rf(dataset, labels, 3, 50 /* 50 trees */, 1, 1e-7);
+  for (size_t t = 0; t < rf.NumTrees(); ++t)
+    REQUIRE(rf.OutOfBag(t).n_elem > 0);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+  const double testError = (double) arma::accu(predictions != testLabels) /
+      testLabels.n_elem;
+  const double oobError = rf.OOBError(dataset, labels);
+
+  REQUIRE(oobError >= 0.0);
+  REQUIRE(oobError <= 0.4);
+  REQUIRE(std::abs(oobError - testError) <= 0.15);
+
+  // Extra trees don't use bootstrap samples.
+  ExtraTrees<> et(dataset, labels, 3, 10 /* 10 trees */, 1, 1e-7);
+  REQUIRE_THROWS_AS(et.OOBError(dataset, labels), std::invalid_argument);
+}
+
+/**
+ * Make sure that both feature importances find the only informative dimension.
+ */
+TEST_CASE("RandomForestFeatureImportanceTest", "[RandomForestTest]")
+{
+  arma::mat dataset(4, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (dataset(2, i) > 0.5) ? 1 : 0;
+
+  RandomForest<> rf(dataset, labels, 2, 20 /* 20 trees */, 5, 1e-7);
+
+  arma::vec gainImportances;
+  rf.ComputeGainImportance(dataset, labels, gainImportances);
+  REQUIRE(gainImportances.n_elem == 4);
+  REQUIRE(arma::accu(gainImportances) == Approx(1.0));
+  REQUIRE(gainImportances.index_max() == 2);
+  REQUIRE(gainImportances[2] > 0.5);
+
+  arma::mat testDataset(4, 500, arma::fill::randu);
+  arma::Row<size_t> testLabels(500);
+  for (size_t i = 0; i < 500; ++i)
+    testLabels[i] = (testDataset(2, i) > 0.5) ? 1 : 0;
+
+  arma::vec permutationImportances;
+  rf.ComputePermutationImportance(testDataset, testLabels,
+      permutationImportances, 3);
+  REQUIRE(permutationImportances.n_elem == 4);
+  REQUIRE(permutationImportances.index_max() == 2);
+  REQUIRE(permutationImportances[2] > 0.3);
+  for (size_t d = 0; d < 4; ++d)
+  {
+    if (d != 2)
+      REQUIRE(std::abs(permutationImportances[d]) < 0.05);
+  }
+}
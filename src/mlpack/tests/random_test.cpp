@@ -94,3 +94,92 @@ TEST_CASE("WeightedRandomTest", "[RandomTest]")
     }
   }
 }
+
+// Test that the streams of RandomStream are reproducible and look uniform and
+// normal.
+TEST_CASE("RandomStreamTest", "[RandomTest]")
+{
+  RandomStream a(42, 3), b(42, 3), c(42, 4), d(43, 3);
+  bool differentStream = false, differentSeed = false;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const uint64_t x = a();
+    REQUIRE(x == b());
+    differentStream |= (x != c());
+    differentSeed |= (x != d());
+  }
+
+  REQUIRE(differentStream);
+  REQUIRE(differentSeed);
+
+  // Seeding again restarts the stream.
+  RandomStream e(42, 3);
+  const uint64_t first = e();
+  e();
+  e.Seed(42, 3);
+  REQUIRE(e() == first);
+
+  const size_t n = 100000;
+  arma::vec uniform(n), normal(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    uniform[i] = a.Random();
+    normal[i] = a.RandNormal();
+  }
+
+  REQUIRE(uniform.min() >= 0.0);
+  REQUIRE(uniform.max() < 1.0);
+  REQUIRE(arma::mean(uniform) == Approx(0.5).margin(0.01));
+  REQUIRE(arma::var(uniform) == Approx(1.0 / 12.0).margin(0.005));
+  REQUIRE(arma::mean(normal) == Approx(0.0).margin(0.02));
+  REQUIRE(arma::var(normal) == Approx(1.0).margin(0.02));
+
+  // It can be used with the standard library.
+  std::vector<size_t> values(100);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = i;
+  std::shuffle(values.begin(), values.end(), a);
+  std::sort(values.begin(), values.end());
+  for (size_t i = 0; i < values.size(); ++i)
+    REQUIRE(values[i] == i);
+}
+
+// Test that the streams of the threads are reproducible, and that a parallel
+// loop that seeds the stream of each iteration doesn't depend on the
+// scheduling.
+TEST_CASE("ThreadRandGenTest", "[RandomTest]")
+{
+  const size_t n = 1000;
+  arma::vec first(n), second(n);
+  arma::vec* results[] = { &first, &second };
+  for (size_t r = 0; r < 2; ++r)
+  {
+    RandomSeed(17);
+
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      (*results[r])[i] = Random();
+  }
+
+  REQUIRE(arma::all(first == second));
+
+  RandomSeed(18);
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    second[i] = Random();
+  REQUIRE(arma::any(first != second));
+
+  // Stream i of a seed, whichever thread draws it.
+  #pragma omp parallel for schedule(dynamic, 7)
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    SeedThreadRandGen(5, i);
+    first[i] = ThreadRandGen().Random();
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    RandomStream stream(5, i);
+    REQUIRE(first[i] == stream.Random());
+  }
+}
@@ -12,6 +12,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
+#include <mlpack/methods/randomized_svd/chunked_randomized_svd.hpp>
 
 #include "catch.hpp"
 
@@ -60,3 +61,74 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The out-of-core randomized SVD of a low-rank matrix stored in chunks on disk
+ * should match the exact SVD.
+ */
+TEST_CASE("ChunkedRandomizedSVDReconstructionError", "[RandomizedSVDTest]")
+{
+  // A 40 x 1000 matrix of rank 5.
+  arma::mat data = arma::randn<arma::mat>(40, 5) *
+      arma::diagmat(arma::vec("10 5 3 2 1")) * arma::randn<arma::mat>(5, 1000);
+
+  // Store the matrix in four chunks of uneven size.
+  const size_t bounds[] = { 0, 100, 450, 451, 1000 };
+  std::vector<std::string> files;
+  for (size_t c = 0; c < 4; ++c)
+  {
+    std::ostringstream oss;
+    oss << "chunked_rsvd_" << c << ".bin";
+    files.push_back(oss.str());
+    data::Save(files.back(), arma::mat(data.cols(bounds[c],
+        bounds[c + 1] - 1)));
+  }
+
+  svd::ChunkedMatrix<arma::mat> matrix(files);
+  REQUIRE(matrix.Rows() == 40);
+  REQUIRE(matrix.NumChunks() == 4);
+
+  arma::mat u1, v1, u2, v2;
+  arma::vec s1, s2;
+  arma::svd_econ(u1, s1, v1, data);
+
+  svd::ChunkedRandomizedSVD rSVD(0, 3);
+  rSVD.Apply(matrix, u2, s2, v2, 5);
+
+  REQUIRE(u2.n_rows == 40);
+  REQUIRE(u2.n_cols == 5);
+  REQUIRE(v2.n_rows == 1000);
+  REQUIRE(v2.n_cols == 5);
+
+  double error = arma::norm(s2 - s1.subvec(0, 4)) / arma::norm(s2);
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  const arma::mat reconstruct = u2 * arma::diagmat(s2) * v2.t();
+  error = arma::norm(data - reconstruct, "frob") / arma::norm(data, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  // Sparse chunks give the same singular values as the dense data.
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(30, 800, 0.1);
+  std::vector<std::string> sparseFiles;
+  for (size_t c = 0; c < 2; ++c)
+  {
+    std::ostringstream oss;
+    oss << "chunked_rsvd_sparse_" << c << ".bin";
+    sparseFiles.push_back(oss.str());
+    data::Save(sparseFiles.back(), arma::sp_mat(sparseData.cols(c * 400,
+        c * 400 + 399)));
+  }
+
+  svd::ChunkedMatrix<arma::sp_mat> sparseMatrix(sparseFiles);
+  arma::vec s3;
+  arma::mat u3;
+  svd::ChunkedRandomizedSVD(30, 0).Apply(sparseMatrix, u3, s3, 30);
+  arma::svd_econ(u1, s1, v1, arma::mat(sparseData));
+  error = arma::norm(s3.subvec(0, 9) - s1.subvec(0, 9)) / arma::norm(s1);
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  for (size_t c = 0; c < files.size(); ++c)
+    remove(files[c].c_str());
+  for (size_t c = 0; c < sparseFiles.size(); ++c)
+    remove(sparseFiles[c].c_str());
+}
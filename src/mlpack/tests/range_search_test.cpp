@@ -1714,3 +1714,281 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the parallel dual-tree traversal finds exactly the same
+ * neighbors as the serial traversal, in both the bichromatic and monochromatic
+ * settings.
+ */
+TEST_CASE("RangeSearchParallelDualTreeTest", "[RangeSearchTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  RangeSearch<> rs(dataset);
+  const math::Range r(0.1, 0.25);
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  vector<vector<size_t>> serialNeighbors, serialMonoNeighbors;
+  vector<vector<double>> serialDistances, serialMonoDistances;
+  omp_set_num_threads(1);
+  rs.Search(querySet, r, serialNeighbors, serialDistances);
+  rs.Search(r, serialMonoNeighbors, serialMonoDistances);
+
+  vector<vector<size_t>> neighbors, monoNeighbors;
+  vector<vector<double>> distances, monoDistances;
+  omp_set_num_threads(4);
+  rs.Search(querySet, r, neighbors, distances);
+  rs.Search(r, monoNeighbors, monoDistances);
+  omp_set_num_threads(prevNumThreads);
+
+  // The order of results for each point may differ, so sort them first.
+  REQUIRE(neighbors.size() == serialNeighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    std::sort(neighbors[i].begin(), neighbors[i].end());
+    std::sort(serialNeighbors[i].begin(), serialNeighbors[i].end());
+    REQUIRE(neighbors[i] == serialNeighbors[i]);
+  }
+
+  REQUIRE(monoNeighbors.size() == serialMonoNeighbors.size());
+  for (size_t i = 0; i < monoNeighbors.size(); ++i)
+  {
+    std::sort(monoNeighbors[i].begin(), monoNeighbors[i].end());
+    std::sort(serialMonoNeighbors[i].begin(), serialMonoNeighbors[i].end());
+    REQUIRE(monoNeighbors[i] == serialMonoNeighbors[i]);
+  }
+}
+#endif
+
+/**
+ * Make sure that the CSR output of RangeSearch holds the same results as the
+ * nested vector output, for trees that rearrange the dataset, for the cover
+ * tree, and for naive search.
+ */
+template<typename RSType>
+void CheckCompactResults(RSType& rs,
+                         const arma::mat& querySet,
+                         const math::Range& r)
+{
+  vector<vector<size_t>> neighbors, monoNeighbors;
+  vector<vector<double>> distances, monoDistances;
+  rs.Search(querySet, r, neighbors, distances);
+  rs.Search(r, monoNeighbors, monoDistances);
+
+  arma::Col<size_t> offsets, compactNeighbors;
+  arma::Col<size_t> monoOffsets, monoCompactNeighbors;
+  arma::vec compactDistances, monoCompactDistances;
+  rs.Search(querySet, r, offsets, compactNeighbors, compactDistances);
+  rs.Search(r, monoOffsets, monoCompactNeighbors, monoCompactDistances);
+
+  const arma::Col<size_t>* allOffsets[2] = { &offsets, &monoOffsets };
+  const arma::Col<size_t>* allNeighbors[2] = { &compactNeighbors,
+      &monoCompactNeighbors };
+  const arma::vec* allDistances[2] = { &compactDistances,
+      &monoCompactDistances };
+  const vector<vector<size_t>>* expectedNeighbors[2] = { &neighbors,
+      &monoNeighbors };
+  const vector<vector<double>>* expectedDistances[2] = { &distances,
+      &monoDistances };
+
+  for (size_t s = 0; s < 2; ++s)
+  {
+    vector<vector<pair<double, size_t>>> expected;
+    SortResults(*expectedNeighbors[s], *expectedDistances[s], expected);
+
+    REQUIRE(allOffsets[s]->n_elem == expected.size() + 1);
+    REQUIRE((*allOffsets[s])[0] == 0);
+    REQUIRE(allNeighbors[s]->n_elem == (*allOffsets[s])[expected.size()]);
+    REQUIRE(allDistances[s]->n_elem == allNeighbors[s]->n_elem);
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+      vector<pair<double, size_t>> found;
+      for (size_t j = (*allOffsets[s])[i]; j < (*allOffsets[s])[i + 1]; ++j)
+      {
+        found.push_back(make_pair((*allDistances[s])[j],
+            (*allNeighbors[s])[j]));
+      }
+      sort(found.begin(), found.end());
+
+      REQUIRE(found.size() == expected[i].size());
+      for (size_t j = 0; j < found.size(); ++j)
+      {
+        REQUIRE(found[j].second == expected[i][j].second);
+        REQUIRE(found[j].first == Approx(expected[i][j].first).epsilon(1e-7));
+      }
+    }
+  }
+}
+
+TEST_CASE("RangeSearchCompactOutputTest", "[RangeSearchTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+  const math::Range r(0.1, 0.25);
+
+  RangeSearch<> kdSearch(dataset);
+  CheckCompactResults(kdSearch, querySet, r);
+
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> coverSearch(
+      dataset);
+  CheckCompactResults(coverSearch, querySet, r);
+
+  RangeSearch<> naiveSearch(dataset, true);
+  CheckCompactResults(naiveSearch, querySet, r);
+}
+
+/**
+ * Make sure that the counts of both Count() overloads are the sizes of the
+ * results of the corresponding Search() overloads.
+ */
+template<typename RangeSearchType>
+void CheckCounts(RangeSearchType& rs,
+                 const arma::mat& querySet,
+                 const math::Range& r)
+{
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  arma::Col<size_t> counts;
+
+  rs.Search(querySet, r, neighbors, distances);
+  rs.Count(querySet, r, counts);
+  REQUIRE(counts.n_elem == querySet.n_cols);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    REQUIRE(counts[i] == neighbors[i].size());
+
+  rs.Search(r, neighbors, distances);
+  rs.Count(r, counts);
+  REQUIRE(counts.n_elem == rs.ReferenceSet().n_cols);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    REQUIRE(counts[i] == neighbors[i].size());
+}
+
+/**
+ * Check range counting with ranges that contain whole nodes (and, for the
+ * ranges that start at 0, the query points themselves), for several tree types.
+ */
+TEST_CASE("RangeCountTest", "[RangeSearchTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+
+  RangeSearch<> kdSearch(dataset);
+  RangeSearch<EuclideanDistance, arma::mat, Octree> octreeSearch(dataset);
+  RangeSearch<EuclideanDistance, arma::mat, BallTree> ballSearch(dataset);
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> coverSearch(
+      dataset);
+  RangeSearch<> naiveSearch(dataset, true);
+
+  const math::Range ranges[] = { math::Range(0.0, 0.3), math::Range(0.1, 0.5),
+      math::Range(0.0, 2.0) };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CheckCounts(kdSearch, querySet, ranges[i]);
+    CheckCounts(octreeSearch, querySet, ranges[i]);
+    CheckCounts(ballSearch, querySet, ranges[i]);
+    CheckCounts(coverSearch, querySet, ranges[i]);
+    CheckCounts(naiveSearch, querySet, ranges[i]);
+  }
+
+  // With a range containing every point, each point is in the range of all the
+  // others.
+  arma::Col<size_t> counts;
+  octreeSearch.Count(math::Range(0.0, 2.0), counts);
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    REQUIRE(counts[i] == 999);
+}
+
+/**
+ * Make sure that the multi-radius Search() and Count() give the same results
+ * as separate searches with each radius.
+ */
+template<typename RangeSearchType>
+void CheckMultiRadius(RangeSearchType& rs,
+                      const arma::mat& querySet,
+                      const arma::vec& radii)
+{
+  std::vector<std::vector<size_t>> neighbors, multiNeighbors;
+  std::vector<std::vector<double>> distances, multiDistances;
+  arma::Col<size_t> counts;
+  arma::Mat<size_t> searchCounts, multiCounts;
+
+  rs.Search(querySet, radii, multiNeighbors, multiDistances, searchCounts);
+  rs.Count(querySet, radii, multiCounts);
+  REQUIRE(multiNeighbors.size() == querySet.n_cols);
+  REQUIRE(searchCounts.n_rows == radii.n_elem);
+  REQUIRE(searchCounts.n_cols == querySet.n_cols);
+  REQUIRE(multiCounts.n_rows == radii.n_elem);
+  REQUIRE(multiCounts.n_cols == querySet.n_cols);
+
+  for (size_t k = 0; k < radii.n_elem; ++k)
+  {
+    const math::Range r(0.0, radii[k]);
+    rs.Count(querySet, r, counts);
+    rs.Search(querySet, r, neighbors, distances);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      REQUIRE(multiCounts(k, i) == counts[i]);
+      REQUIRE(searchCounts(k, i) == counts[i]);
+
+      // The neighbors within the radius are the first ones.
+      std::vector<size_t> expected(neighbors[i]);
+      std::vector<size_t> found(multiNeighbors[i].begin(),
+          multiNeighbors[i].begin() + searchCounts(k, i));
+      std::sort(expected.begin(), expected.end());
+      std::sort(found.begin(), found.end());
+      REQUIRE(found == expected);
+    }
+  }
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    REQUIRE(std::is_sorted(multiDistances[i].begin(),
+        multiDistances[i].end()));
+
+  // Now the monochromatic versions.
+  rs.Count(radii, multiCounts);
+  rs.Search(radii, multiNeighbors, multiDistances, searchCounts);
+  for (size_t k = 0; k < radii.n_elem; ++k)
+  {
+    rs.Count(math::Range(0.0, radii[k]), counts);
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      REQUIRE(multiCounts(k, i) == counts[i]);
+      REQUIRE(searchCounts(k, i) == counts[i]);
+    }
+  }
+}
+
+/**
+ * Check the multi-radius searches for several tree types, and that invalid
+ * radii are rejected.
+ */
+TEST_CASE("RangeSearchMultiRadiusTest", "[RangeSearchTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 800);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  RangeSearch<> kdSearch(dataset);
+  RangeSearch<> singleSearch(dataset, false, true);
+  RangeSearch<EuclideanDistance, arma::mat, BallTree> ballSearch(dataset);
+  RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree> coverSearch(
+      dataset);
+  RangeSearch<> naiveSearch(dataset, true);
+
+  const arma::vec radii("0.05 0.1 0.1 0.25 0.4");
+  CheckMultiRadius(kdSearch, querySet, radii);
+  CheckMultiRadius(singleSearch, querySet, radii);
+  CheckMultiRadius(ballSearch, querySet, radii);
+  CheckMultiRadius(coverSearch, querySet, radii);
+  CheckMultiRadius(naiveSearch, querySet, radii);
+
+  arma::Mat<size_t> counts;
+  REQUIRE_THROWS_AS(kdSearch.Count(arma::vec("0.2 0.1"), counts),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(kdSearch.Count(arma::vec("-0.1 0.1"), counts),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(kdSearch.Count(arma::vec(), counts),
+      std::invalid_argument);
+}
@@ -27,6 +27,7 @@
 #include <ensmallen.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -100,14 +101,14 @@ TEST_CASE("BinaryRBMClassificationTest", "[RBMNetworkTest]")
 
   // Use an instantiated optimizer for the training.
   L_BFGS optimizer(numBasis, numIterations);
-  SoftmaxRegression regressor(trainData, trainLabels,
+  SoftmaxRegression<> regressor(trainData, trainLabels,
       numClasses, 0.001, false, optimizer);
 
   double classificationAccuracy = regressor.ComputeAccuracy(testData,
     testLabels);
 
   L_BFGS rbmOptimizer(numBasis, numIterations);
-  SoftmaxRegression rbmRegressor(XRbm, trainLabels, numClasses,
+  SoftmaxRegression<> rbmRegressor(XRbm, trainLabels, numClasses,
         0.001, false, rbmOptimizer);
   double rbmClassificationAccuracy = rbmRegressor.ComputeAccuracy(YRbm,
       testLabels);
@@ -199,7 +200,7 @@ TEST_CASE("ssRBMClassificationTest", "[RBMNetworkTest]")
   const size_t numIterations = 100; // Maximum number of iterations.
 
   L_BFGS ssRbmOptimizer(numBasis, numIterations);
-  SoftmaxRegression ssRbmRegressor(XRbm, trainLabels, numClasses,
+  SoftmaxRegression<> ssRbmRegressor(XRbm, trainLabels, numClasses,
         0.001, false, ssRbmOptimizer);
   double ssRbmClassificationAccuracy = ssRbmRegressor.ComputeAccuracy(
       YRbm, testLabels);
@@ -251,3 +252,45 @@ TEST_CASE("MiscTest", "[RBMNetworkTest]")
   X = X.t();
   BuildVanillaNetwork<arma::Mat<float>>(X, 2);
 }
+
+/*
+ * Make sure that the gradient of a batch is the sum of the gradients of its
+ * points, and that the batched Bernoulli sampling of the hidden units has the
+ * right means.
+ */
+TEST_CASE("BinaryRBMBatchTest", "[RBMNetworkTest]")
+{
+  const size_t visibleSize = 6, hiddenSize = 4, batchSize = 20;
+  arma::mat data = arma::round(arma::randu<arma::mat>(visibleSize,
+      batchSize));
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization> model(data, gaussian, visibleSize, hiddenSize,
+      batchSize);
+  model.Reset();
+
+  arma::mat batchGradient(model.Parameters().n_elem, 1);
+  arma::mat pointGradient(model.Parameters().n_elem, 1);
+  arma::mat sumGradient(model.Parameters().n_elem, 1, arma::fill::zeros);
+  model.Phase(data, batchGradient);
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    model.Phase(arma::mat(data.col(i)), pointGradient);
+    sumGradient += pointGradient;
+  }
+  CheckMatrices(batchGradient, sumGradient);
+
+  // The visible bias gradient is the sum of the points.
+  CheckMatrices(batchGradient.tail_rows(visibleSize), arma::sum(data, 1));
+
+  // Sample the hidden units of many copies of one point.
+  const arma::mat copies = arma::repmat(data.col(0), 1, 10000);
+  arma::mat means, samples;
+  model.HiddenMean(copies, means);
+  model.SampleHidden(copies, samples);
+  REQUIRE(samples.n_rows == hiddenSize);
+  REQUIRE(samples.n_cols == 10000);
+  REQUIRE(arma::accu(samples % (1 - samples)) == 0.0);
+  for (size_t j = 0; j < hiddenSize; ++j)
+    REQUIRE(arma::mean(samples.row(j)) == Approx(means(j, 0)).margin(0.03));
+}
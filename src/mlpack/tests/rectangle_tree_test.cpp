@@ -1359,3 +1359,178 @@ TEST_CASE("RectangleTreeMoveDatasetTest", "[RectangleTreeTraitsTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Count the leaves of the given tree.
+ */
+template<typename TreeType>
+size_t CountLeaves(const TreeType& tree)
+{
+  if (tree.IsLeaf())
+    return 1;
+
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    numLeaves += CountLeaves(tree.Child(i));
+
+  return numLeaves;
+}
+
+/**
+ * Bulk-load a tree of the given type in the given order, check that it is
+ * valid, and check that a nearest neighbor search with it gives the results of
+ * a naive search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoadedTree(const arma::mat& dataset,
+                         const BulkLoadType bulkLoadType)
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, bulkLoadType, 20, 6, 5, 2);
+
+  REQUIRE(tree.NumDescendants() == dataset.n_cols);
+
+  CheckContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); ++i)
+  {
+    REQUIRE(neighbors1[i] == neighbors2[i]);
+    REQUIRE(distances1[i] == distances2[i]);
+  }
+}
+
+// Make sure that the trees with overlapping nodes are packed bottom-up into
+// full leaves, and are valid.
+TEST_CASE("RectangleTreeBulkLoadTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+
+  for (const BulkLoadType bulkLoadType : { STR_BULK_LOAD, HILBERT_BULK_LOAD })
+  {
+    TreeType tree(dataset, bulkLoadType, 20, 6, 5, 2);
+
+    // The points should fill the smallest possible number of leaves.
+    REQUIRE(CountLeaves(tree) == 50);
+    CheckExactContainment(tree);
+    CheckFills(tree);
+
+    CheckBulkLoadedTree<RTree>(dataset, bulkLoadType);
+    CheckBulkLoadedTree<RStarTree>(dataset, bulkLoadType);
+    CheckBulkLoadedTree<XTree>(dataset, bulkLoadType);
+  }
+}
+
+// Make sure that the trees that can't be packed bottom-up are still valid when
+// they are bulk-loaded.
+TEST_CASE("RectangleTreeBulkLoadInsertionTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  for (const BulkLoadType bulkLoadType : { STR_BULK_LOAD, HILBERT_BULK_LOAD })
+  {
+    typedef HilbertRTree<EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>, arma::mat> HilbertTreeType;
+    HilbertTreeType hilbertTree(dataset, bulkLoadType, 20, 6, 5, 2);
+    CheckHilbertOrdering(hilbertTree);
+    CheckDiscreteHilbertValueSync(hilbertTree);
+
+    typedef RPlusTree<EuclideanDistance,
+        NeighborSearchStat<NearestNeighborSort>, arma::mat> RPlusTreeType;
+    RPlusTreeType rPlusTree(dataset, bulkLoadType, 20, 6, 5, 2);
+    CheckOverlap(rPlusTree);
+
+    CheckBulkLoadedTree<HilbertRTree>(dataset, bulkLoadType);
+    CheckBulkLoadedTree<RPlusTree>(dataset, bulkLoadType);
+    CheckBulkLoadedTree<RPlusPlusTree>(dataset, bulkLoadType);
+  }
+}
+
+// Make sure that the snapshots of a ConcurrentRectangleTree don't change when
+// points are inserted, and that a published snapshot can be searched.
+TEST_CASE("ConcurrentRectangleTreeSnapshotTest", "[RectangleTreeTraitsTest]")
+{
+  arma::mat dataset;
+  dataset.randu(5, 1000); // 1000 points in 5 dimensions.
+  arma::mat newPoints;
+  newPoints.randu(5, 100);
+
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  ConcurrentRectangleTree<TreeType> index(dataset, 20, 6, 5, 2);
+
+  std::shared_ptr<const TreeType> oldSnapshot = index.Snapshot();
+  REQUIRE(oldSnapshot->NumDescendants() == 1000);
+
+  for (size_t i = 0; i < newPoints.n_cols; ++i)
+    REQUIRE(index.Insert(newPoints.col(i)) == 1000 + i);
+  REQUIRE(index.Delete(3) == true);
+  REQUIRE(index.NumUnpublishedChanges() == 101);
+
+  // The published snapshot must not see the changes.
+  REQUIRE(index.Snapshot() == oldSnapshot);
+  REQUIRE(oldSnapshot->NumDescendants() == 1000);
+  REQUIRE(oldSnapshot->Dataset().n_cols == 1000);
+
+  index.Publish();
+  REQUIRE(index.NumUnpublishedChanges() == 0);
+
+  std::shared_ptr<const TreeType> snapshot = index.Snapshot();
+  REQUIRE(snapshot->NumDescendants() == 1099);
+  REQUIRE(snapshot->Dataset().n_cols == 1100);
+  REQUIRE(oldSnapshot->NumDescendants() == 1000);
+  CheckContainment(*snapshot);
+  CheckHierarchy(*snapshot);
+  CheckNumDescendants(*snapshot);
+
+  // Search the snapshot, which holds every point but the deleted one.
+  arma::mat queries;
+  queries.randu(5, 50);
+
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RulesType;
+  EuclideanDistance metric;
+  RulesType rules(snapshot->Dataset(), queries, 3, metric);
+  TreeType::SingleTreeTraverser<RulesType> traverser(rules);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+    traverser.Traverse(i, *snapshot);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  rules.GetResults(neighbors1, distances1);
+
+  arma::mat referenceSet = snapshot->Dataset();
+  referenceSet.shed_col(3);
+  KNN knn(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+  knn.Search(queries, 3, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.n_elem; ++i)
+  {
+    // Map the indices back to the dataset of the snapshot.
+    const size_t neighbor = (neighbors2[i] >= 3) ? neighbors2[i] + 1 :
+        neighbors2[i];
+    REQUIRE(neighbors1[i] == neighbor);
+    REQUIRE(distances1[i] == Approx(distances2[i]).epsilon(1e-7));
+  }
+}
@@ -931,3 +931,134 @@ TEST_CASE("RNNCheckInputShapeTest", "[RecurrentNetworkTest]")
 
   REQUIRE_THROWS_AS(model.Train(input, labels, opt), std::logic_error);
 }
+
+/**
+ * Test that sequences of different lengths can be trained on and predicted
+ * together, and that the padding after the end of each sequence is ignored.
+ */
+TEST_CASE("RNNVariableLengthTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+  const size_t dimensionality = 3;
+  const size_t sequences = 12;
+
+  arma::cube input(dimensionality, sequences, rho, arma::fill::randu);
+  arma::cube responses(1, sequences, rho, arma::fill::randu);
+  arma::urowvec lengths = arma::randi<arma::urowvec>(sequences,
+      arma::distr_param(3, (int) rho));
+  lengths[0] = rho;
+
+  // The same data, with different values after the end of each sequence.
+  arma::cube paddedInput(input), paddedResponses(responses);
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    for (size_t s = lengths[i]; s < rho; ++s)
+    {
+      paddedInput.slice(s).col(i).fill(100.0);
+      paddedResponses.slice(s).col(i).fill(-100.0);
+    }
+  }
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(dimensionality, 5, rho);
+  model.Add<Linear<> >(5, 1);
+
+  RNN<MeanSquaredError<> > paddedModel(model);
+
+  // Both models start from the same weights.
+  StandardSGD opt(0.01, 4, 10 * sequences, -100, false);
+  math::RandomSeed(1);
+  const double objVal = model.Train(input, responses, lengths, opt);
+  math::RandomSeed(1);
+  const double paddedObjVal = paddedModel.Train(paddedInput, paddedResponses,
+      lengths, opt);
+
+  REQUIRE(std::isfinite(objVal));
+  REQUIRE(objVal == Approx(paddedObjVal).epsilon(1e-7));
+  CheckMatrices(model.Parameters(), paddedModel.Parameters());
+
+  // The predictions of each sequence must be the predictions of the whole
+  // sequence up to its length, and zero after it.
+  arma::cube predictions, maskedPredictions;
+  model.Predict(input, predictions, sequences);
+  model.Predict(paddedInput, maskedPredictions, lengths, 4);
+
+  REQUIRE(maskedPredictions.n_rows == predictions.n_rows);
+  REQUIRE(maskedPredictions.n_cols == sequences);
+  REQUIRE(maskedPredictions.n_slices == rho);
+  for (size_t i = 0; i < sequences; ++i)
+  {
+    for (size_t s = 0; s < rho; ++s)
+    {
+      if (s < lengths[i])
+      {
+        CheckMatrices(maskedPredictions.slice(s).col(i),
+            predictions.slice(s).col(i));
+      }
+      else
+      {
+        REQUIRE(arma::all(maskedPredictions.slice(s).col(i) == 0.0));
+      }
+    }
+  }
+
+  // The lengths must match the data.
+  REQUIRE_THROWS_AS(model.Predict(input, predictions,
+      arma::urowvec(sequences - 1, arma::fill::ones)), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Predict(input, predictions,
+      arma::urowvec(sequences, arma::fill::zeros)), std::invalid_argument);
+}
+
+/**
+ * Test that a stateful network gives the same predictions on a stream, in
+ * windows and in pieces, as the network on the whole stream, and that it can
+ * be trained with truncated BPTT.
+ */
+TEST_CASE("RNNStatefulTest", "[RecurrentNetworkTest]")
+{
+  const size_t streamLength = 20;
+  const size_t window = 5;
+  const size_t dimensionality = 3;
+  const size_t streams = 4;
+
+  arma::cube input(dimensionality, streams, streamLength, arma::fill::randu);
+  arma::cube responses(1, streams, streamLength, arma::fill::randu);
+
+  RNN<MeanSquaredError<> > model(streamLength);
+  model.Add<IdentityLayer<> >();
+  model.Add<LSTM<> >(dimensionality, 5, streamLength);
+  model.Add<Linear<> >(5, 1);
+
+  arma::cube predictions;
+  model.Predict(input, predictions);
+
+  // The state is carried from one window to the next.
+  model.Rho() = window;
+  model.Stateful() = true;
+  arma::cube streamPredictions;
+  model.Predict(input, streamPredictions);
+  REQUIRE(streamPredictions.n_slices == streamLength);
+  CheckMatrices(predictions, streamPredictions);
+
+  // And from one call to the next.
+  model.ResetState();
+  arma::cube firstPredictions, secondPredictions;
+  model.Predict(input.slices(0, 11), firstPredictions);
+  model.Predict(input.slices(12, streamLength - 1), secondPredictions);
+  CheckMatrices(predictions.slices(0, 11), firstPredictions);
+  CheckMatrices(predictions.slices(12, streamLength - 1), secondPredictions);
+
+  // A new stream starts after ResetState().
+  model.ResetState();
+  model.Predict(input.slices(0, 11), firstPredictions);
+  CheckMatrices(predictions.slices(0, 11), firstPredictions);
+
+  StandardSGD opt(0.01, 2, 10 * streams, -100);
+  const double objVal = model.Train(input, responses, opt);
+  REQUIRE(std::isfinite(objVal));
+
+  // Only whole streams can be trained on.
+  REQUIRE_THROWS_AS(model.Train(input, arma::cube(1, streams, window), opt),
+      std::invalid_argument);
+}
@@ -20,7 +20,11 @@
 #include <mlpack/methods/reinforcement_learning/environment/continuous_double_pole_cart.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/vectorized_environment.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/state_storage.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/concurrent_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/concurrent_prioritized_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include "catch.hpp"
@@ -271,6 +275,315 @@ TEST_CASE("RandomReplayTest", "[RLComponentsTest]")
   }
 }
 
+/**
+ * Store a batch of transitions and make sure they are sampled back.
+ */
+TEST_CASE("RandomReplayBatchStoreTest", "[RLComponentsTest]")
+{
+  RandomReplay<MountainCar> replay(5, 4);
+  arma::mat states(2, 6, arma::fill::randu);
+  arma::mat nextStates(2, 6, arma::fill::randu);
+  arma::rowvec rewards = arma::linspace<arma::rowvec>(0, 5, 6);
+  arma::irowvec isEnd = { 0, 1, 0, 1, 0, 1 };
+  std::vector<MountainCar::Action> actions(6);
+  for (size_t i = 0; i < 6; ++i)
+    actions[i].action = MountainCar::Action::actions(i % 3);
+
+  // The buffer has room for four transitions, so the first two are
+  // overwritten.
+  replay.Store(states, actions, rewards, nextStates, isEnd);
+  REQUIRE(4 == replay.Size());
+
+  arma::mat sampledStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::mat sampledNextStates;
+  arma::irowvec sampledTerminal;
+  replay.Sample(sampledStates, sampledActions, sampledRewards,
+      sampledNextStates, sampledTerminal);
+
+  for (size_t i = 0; i < sampledRewards.n_elem; ++i)
+  {
+    const size_t j = (size_t) sampledRewards[i];
+    REQUIRE(j >= 2);
+    CheckMatrices(states.col(j), sampledStates.col(i));
+    CheckMatrices(nextStates.col(j), sampledNextStates.col(i));
+    REQUIRE(sampledActions[i].action == actions[j].action);
+    REQUIRE(sampledTerminal[i] == isEnd[j]);
+  }
+
+  // Batches can't be stored in an n-step buffer.
+  RandomReplay<MountainCar> nStepReplay(5, 4, 3);
+  REQUIRE_THROWS_AS(nStepReplay.Store(states, actions, rewards, nextStates,
+      isEnd), std::invalid_argument);
+}
+
+/**
+ * Make sure that CompactStateStorage returns the same states as
+ * FullStateStorage, while storing few next states explicitly.
+ */
+TEST_CASE("CompactStateStorageTest", "[RLComponentsTest]")
+{
+  const size_t capacity = 100;
+  FullStateStorage<float> full(4, capacity);
+  CompactStateStorage<float> compact(4, capacity);
+
+  // Run several episodes, so that the ring buffer wraps around.
+  CartPole env(30);
+  size_t position = 0, numEpisodes = 0;
+  for (size_t episode = 0; episode < 20; ++episode)
+  {
+    CartPole::State state = env.InitialSample();
+    while (!env.IsTerminal(state))
+    {
+      CartPole::Action action;
+      action.action = CartPole::Action::actions(math::RandInt(2));
+      CartPole::State nextState;
+      env.Sample(state, action, nextState);
+
+      full.Store(position, state.Encode(), nextState.Encode());
+      compact.Store(position, state.Encode(), nextState.Encode());
+      position = (position + 1) % capacity;
+      state = nextState;
+    }
+    ++numEpisodes;
+  }
+
+  arma::uvec positions = arma::regspace<arma::uvec>(0, capacity - 1);
+  arma::mat fullStates, fullNextStates, compactStates, compactNextStates;
+  full.States(positions, fullStates);
+  full.NextStates(positions, fullNextStates);
+  compact.States(positions, compactStates);
+  compact.NextStates(positions, compactNextStates);
+
+  CheckMatrices(fullStates, compactStates);
+  CheckMatrices(fullNextStates, compactNextStates);
+
+  // Only the last next state of each episode in the buffer is stored.
+  REQUIRE(compact.NumExplicitNextStates() <= numEpisodes);
+  REQUIRE(compact.NumExplicitNextStates() < capacity / 10);
+
+  // A replay memory can use the compact storage of unsigned chars.
+  RandomReplay<MountainCar, CompactStateStorage<unsigned char>> replay(5, 10);
+  MountainCar::State first(arma::colvec({ 3.0, 200.0 }));
+  MountainCar::State second(arma::colvec({ 4.0, 100.0 }));
+  MountainCar::Action action;
+  action.action = MountainCar::Action::actions::forward;
+  replay.Store(first, action, 1.0, second, false, 0.9);
+  replay.Store(second, action, 1.0, first, true, 0.9);
+
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec sampledTerminal;
+  replay.Sample(sampledStates, sampledActions, sampledRewards,
+      sampledNextStates, sampledTerminal);
+  for (size_t i = 0; i < sampledStates.n_cols; ++i)
+  {
+    if (sampledTerminal[i])
+    {
+      CheckMatrices(sampledStates.col(i), second.Encode());
+      CheckMatrices(sampledNextStates.col(i), first.Encode());
+    }
+    else
+    {
+      CheckMatrices(sampledStates.col(i), first.Encode());
+      CheckMatrices(sampledNextStates.col(i), second.Encode());
+    }
+  }
+}
+
+/**
+ * Make sure that every transition sampled from a replay memory is one of the
+ * transitions stored by the actors.  The transitions of MountainCar are
+ * encoded so that state, reward and next state identify each other.
+ */
+template<typename ReplayType>
+void CheckConcurrentReplay(ReplayType& replay, const size_t numTransitions)
+{
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec sampledTerminal;
+
+  // Returns whether all the sampled transitions were stored.
+  auto checkSample = [&]()
+  {
+    replay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, sampledTerminal);
+    bool valid = true;
+    for (size_t i = 0; i < sampledRewards.n_elem; ++i)
+    {
+      const size_t id = (size_t) sampledRewards[i];
+      valid &= (id < numTransitions);
+      valid &= (sampledStates(0, i) == (double) id);
+      valid &= (sampledStates(1, i) == -(double) id);
+      valid &= (sampledNextStates(0, i) == (double) id + 1);
+      valid &= (sampledActions[i].action ==
+          MountainCar::Action::actions(id % 3));
+      valid &= (sampledTerminal[i] == (int) (id % 2));
+    }
+    return valid;
+  };
+
+  // One thread samples while the others store transitions.
+  bool valid = true;
+  #pragma omp parallel
+  {
+    #pragma omp single nowait
+    {
+      for (size_t i = 0; i < 100; ++i)
+      {
+        if (replay.Size() > 0)
+          valid &= checkSample();
+      }
+    }
+
+    #pragma omp for
+    for (omp_size_t id = 0; id < (omp_size_t) numTransitions; ++id)
+    {
+      MountainCar::State state, nextState;
+      state.Data() = { (double) id, -(double) id };
+      nextState.Data() = { (double) id + 1, 0.0 };
+      MountainCar::Action action;
+      action.action = MountainCar::Action::actions(id % 3);
+      replay.Store(state, action, (double) id, nextState, id % 2, 1.0);
+    }
+  }
+  REQUIRE(valid);
+
+  REQUIRE(replay.Size() == std::min(numTransitions, (size_t) 1000));
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(checkSample());
+    REQUIRE(sampledRewards.n_elem == 32);
+  }
+}
+
+/**
+ * Store transitions from several threads in a concurrent memory while
+ * sampling from it.
+ */
+TEST_CASE("ConcurrentReplayTest", "[RLComponentsTest]")
+{
+  ConcurrentReplay<MountainCar> replay(32, 1000);
+  REQUIRE(replay.Size() == 0);
+
+  // Nothing can be sampled from an empty memory.
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec sampledTerminal;
+  replay.Sample(sampledStates, sampledActions, sampledRewards,
+      sampledNextStates, sampledTerminal);
+  REQUIRE(sampledRewards.n_elem == 0);
+
+  CheckConcurrentReplay(replay, 5000);
+}
+
+/**
+ * Store transitions from several threads in a concurrent prioritized memory
+ * while sampling from it, and make sure that priorities are respected.
+ */
+TEST_CASE("ConcurrentPrioritizedReplayTest", "[RLComponentsTest]")
+{
+  ConcurrentPrioritizedReplay<MountainCar> replay(32, 1000, 1.0);
+  CheckConcurrentReplay(replay, 5000);
+
+  // Give all but one position a tiny priority; then almost all samples should
+  // be the transition at that position.
+  arma::ucolvec indices = arma::regspace<arma::ucolvec>(0, 999);
+  arma::colvec priorities(1000);
+  priorities.fill(1e-8);
+  priorities[123] = 1.0;
+  replay.UpdatePriorities(indices, priorities);
+
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<MountainCar::Action> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec sampledTerminal;
+  replay.Sample(sampledStates, sampledActions, sampledRewards,
+      sampledNextStates, sampledTerminal);
+
+  size_t count = 0;
+  for (size_t i = 0; i < sampledRewards.n_elem; ++i)
+  {
+    count = std::max(count, (size_t) arma::accu(sampledRewards ==
+        sampledRewards[i]));
+  }
+  REQUIRE(count >= 30);
+  REQUIRE(replay.Weights().n_elem == 32);
+  REQUIRE(replay.Weights().max() == Approx(1.0));
+}
+
+/**
+ * Make sure that the copies of a vectorized environment behave like
+ * independent environments, and become inactive when they terminate.
+ */
+TEST_CASE("VectorizedEnvironmentTest", "[RLComponentsTest]")
+{
+  for (const bool parallel : { false, true })
+  {
+    VectorizedEnvironment<CartPole> envs(4, CartPole(20), parallel);
+    REQUIRE(envs.NumEnvironments() == 4);
+
+    envs.InitialSample();
+    REQUIRE(envs.NumActive() == 4);
+
+    // Step each copy alongside a separate environment.
+    std::vector<CartPole> reference(4, CartPole(20));
+    std::vector<CartPole::State> referenceStates(4);
+    for (size_t i = 0; i < 4; ++i)
+    {
+      reference[i].InitialSample();
+      referenceStates[i] = envs.State(i);
+    }
+
+    arma::mat states, nextStates;
+    arma::rowvec rewards;
+    arma::irowvec isTerminal;
+    size_t totalSteps = 0;
+    while (envs.NumActive() > 0)
+    {
+      envs.ActiveStates(states);
+      REQUIRE(states.n_cols == envs.NumActive());
+
+      const std::vector<size_t> active = envs.Active();
+      std::vector<CartPole::Action> actions(active.size());
+      for (size_t k = 0; k < active.size(); ++k)
+      {
+        actions[k].action = CartPole::Action::actions(active[k] % 2);
+        CheckMatrices(states.col(k), referenceStates[active[k]].Encode());
+      }
+
+      envs.Step(actions, rewards, nextStates, isTerminal);
+      totalSteps += active.size();
+
+      for (size_t k = 0; k < active.size(); ++k)
+      {
+        const size_t i = active[k];
+        CartPole::State next;
+        const double reward = reference[i].Sample(referenceStates[i],
+            actions[k], next);
+        REQUIRE(reward == Approx(rewards[k]).epsilon(1e-7));
+        CheckMatrices(nextStates.col(k), next.Encode());
+        REQUIRE(isTerminal[k] == (int) reference[i].IsTerminal(next));
+        referenceStates[i] = next;
+      }
+    }
+
+    // Every copy was stepped until its episode ended.
+    size_t steps = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      REQUIRE(envs.Steps(i) <= 20);
+      REQUIRE(envs.Steps(i) == reference[i].StepsPerformed());
+      steps += envs.Steps(i);
+    }
+    REQUIRE(steps == totalSteps);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -172,3 +172,48 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Check that fitting the given scaler chunk by chunk gives the same scaling as
+ * fitting it at once, and that FitTransform() works in place.
+ */
+template<typename ScalerType>
+void CheckPartialFit(const arma::mat& input)
+{
+  ScalerType scale, chunkScale, inPlaceScale;
+  arma::mat output, chunkOutput;
+  scale.Fit(input);
+  scale.Transform(input, output);
+
+  chunkScale.PartialFit(arma::mat(input.cols(0, 1233)));
+  chunkScale.PartialFit(arma::mat(input.cols(1234, input.n_cols - 1)));
+  chunkScale.Transform(input, chunkOutput);
+  CheckMatrices(output, chunkOutput);
+
+  arma::mat inPlace = input;
+  inPlaceScale.FitTransform(inPlace, inPlace);
+  CheckMatrices(output, inPlace);
+
+  inPlaceScale.InverseTransform(inPlace, inPlace);
+  CheckMatrices(input, inPlace);
+}
+
+/**
+ * Test PartialFit() and FitTransform() of the scalers on enough points to be
+ * fitted and transformed in several blocks.
+ */
+TEST_CASE("ScalerPartialFitTest", "[ScalingTest]")
+{
+  arma::mat input = 10 * arma::randu<arma::mat>(5, 5000) - 3;
+
+  CheckPartialFit<data::MinMaxScaler>(input);
+  CheckPartialFit<data::MaxAbsScaler>(input);
+  CheckPartialFit<data::StandardScaler>(input);
+  CheckPartialFit<data::MeanNormalization>(input);
+
+  // The one-pass statistics match the statistics of Armadillo.
+  data::StandardScaler scale;
+  scale.Fit(input);
+  CheckMatrices(scale.ItemMean(), arma::mat(arma::mean(input, 1)));
+  CheckMatrices(scale.ItemStdDev(), arma::mat(arma::stddev(input, 1, 1)));
+}
@@ -359,6 +359,37 @@ TEST_CASE("BinarySpaceTreeOverwriteTest", "[SerializationTest]")
   CheckTrees(tree, xmlTree, jsonTree, binaryTree);
 }
 
+/**
+ * Make sure that a degenerate tree, which is a chain of nodes, survives a round
+ * trip; the nodes are stored as arrays, not recursively.
+ */
+TEST_CASE("DeepBinarySpaceTreeTest", "[SerializationTest]")
+{
+  // With midpoint splits, each split only separates the largest point.
+  arma::mat data(1, 61);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data[i] = std::ldexp(1.0, (int) i);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data, 1);
+
+  size_t depth = 0;
+  for (TreeType* node = &tree; !node->IsLeaf(); node = node->Left())
+    ++depth;
+  REQUIRE(depth >= 50);
+
+  TreeType* xmlTree;
+  TreeType* jsonTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, jsonTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *jsonTree, *binaryTree);
+
+  delete xmlTree;
+  delete jsonTree;
+  delete binaryTree;
+}
+
 TEST_CASE("CoverTreeTest", "[SerializationTest]")
 {
   arma::mat data;
@@ -664,10 +695,10 @@ TEST_CASE("SoftmaxRegressionTest", "[SerializationTest]")
     labels[i] = 0;
   for (size_t i = 500; i < 1000; ++i)
     labels[i] = 1;
-  SoftmaxRegression sr(dataset, labels, 2);
-  SoftmaxRegression srXml(dataset.n_rows, 2);
-  SoftmaxRegression srText(dataset.n_rows, 2);
-  SoftmaxRegression srBinary(dataset.n_rows, 2);
+  SoftmaxRegression<> sr(dataset, labels, 2);
+  SoftmaxRegression<> srXml(dataset.n_rows, 2);
+  SoftmaxRegression<> srText(dataset.n_rows, 2);
+  SoftmaxRegression<> srBinary(dataset.n_rows, 2);
 
   SerializeObjectAll(sr, srXml, srText, srBinary);
 
@@ -1073,16 +1104,10 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
-
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  CheckMatrices(lsh.BucketContents(), xmlLsh.BucketContents(),
+      jsonLsh.BucketContents(), binaryLsh.BucketContents());
 }
 
 // Make sure serialization works for LARS.
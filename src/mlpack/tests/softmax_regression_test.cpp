@@ -13,6 +13,7 @@
 #include <mlpack/methods/softmax_regression/softmax_regression.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::regression;
@@ -35,7 +36,7 @@ TEST_CASE("SoftmaxRegressionFunctionEvaluate", "[SoftmaxRegressionTest]")
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; ++i)
@@ -82,9 +83,9 @@ TEST_CASE("SoftmaxRegressionFunctionRegularizationEvaluate",
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; ++i)
@@ -125,8 +126,8 @@ TEST_CASE("SoftmaxRegressionFunctionGradient",
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -197,7 +198,7 @@ TEST_CASE("SoftmaxRegressionTwoClasses", "[SoftmaxRegressionTest]")
   }
 
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
 
   // Compare training accuracy to 100.
   const double acc = sr.ComputeAccuracy(data, labels);
@@ -241,7 +242,7 @@ TEST_CASE("SoftmaxRegressionFitIntercept", "[SoftmaxRegressionTest]")
   }
 
   // Now train a logistic regression object on it.
-  SoftmaxRegression lr(data, responses, 2, 0.01, true);
+  SoftmaxRegression<> lr(data, responses, 2, 0.01, true);
 
   // Ensure that the error is close to zero.
   const double acc = lr.ComputeAccuracy(data, responses);
@@ -309,7 +310,7 @@ TEST_CASE("SoftmaxRegressionMultipleClasses", "[SoftmaxRegressionTest]")
   }
 
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
 
   // Compare training accuracy to 100.
   const double acc = sr.ComputeAccuracy(data, labels);
@@ -357,8 +358,8 @@ TEST_CASE("SoftmaxRegressionTrainTest", "[SoftmaxRegressionTest]")
   for (size_t i = 500; i < 1000; ++i)
     labels[i] = size_t(1.0);
 
-  SoftmaxRegression sr(dataset.n_rows, 2);
-  SoftmaxRegression sr2(dataset.n_rows, 2);
+  SoftmaxRegression<> sr(dataset.n_rows, 2);
+  SoftmaxRegression<> sr2(dataset.n_rows, 2);
   sr.Parameters() = sr2.Parameters();
   ens::L_BFGS lbfgs;
   sr.Train(dataset, labels, 2, std::move(lbfgs));
@@ -388,10 +389,10 @@ TEST_CASE("SoftmaxRegressionOptimizerTrainTest", "[SoftmaxRegressionTest]")
     labels[i] = size_t(1.0);
 
   ens::L_BFGS lbfgs;
-  SoftmaxRegression sr(dataset.n_rows, 2, true);
+  SoftmaxRegression<> sr(dataset.n_rows, 2, true);
 
   ens::L_BFGS lbfgs2;
-  SoftmaxRegression sr2(dataset.n_rows, 2, true);
+  SoftmaxRegression<> sr2(dataset.n_rows, 2, true);
 
   sr.Lambda() = sr2.Lambda() = 0.01;
   sr.Parameters() = sr2.Parameters();
@@ -458,7 +459,7 @@ TEST_CASE("SoftmaxRegressionClassifySinglePointTest",
   }
 
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
 
   // Create test dataset.
   for (size_t i = 0; i < points / 5; ++i)
@@ -541,7 +542,7 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesTest",
   }
 
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
 
   // Create test dataset.
   for (size_t i = 0; i < points / 5; ++i)
@@ -629,7 +630,7 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
   }
 
   // Train softmax regression object.
-  SoftmaxRegression sr(data, labels, numClasses, lambda);
+  SoftmaxRegression<> sr(data, labels, numClasses, lambda);
 
   // Create test dataset.
   for (size_t i = 0; i < points / 5; ++i)
@@ -674,3 +675,149 @@ TEST_CASE("SoftmaxRegressionComputeProbabilitiesAndLabelsTest",
     REQUIRE(testLabels(i) == labels(i));
   }
 }
+
+/**
+ * Make sure that the objective function and its gradient are the same for
+ * sparse and dense data.
+ */
+TEST_CASE("SoftmaxRegressionFunctionSparseTest", "[SoftmaxRegressionTest]")
+{
+  const size_t points = 500;
+  const size_t inputSize = 20;
+  const size_t numClasses = 4;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(inputSize, points, 0.1);
+  arma::mat data(sparseData);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (const bool fitIntercept : { false, true })
+  {
+    SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.1,
+        fitIntercept);
+    SoftmaxRegressionFunction<arma::sp_mat> srfSparse(sparseData, labels,
+        numClasses, 0.1, fitIntercept);
+
+    const arma::mat parameters = srf.GetInitialPoint();
+    REQUIRE(srf.Evaluate(parameters) ==
+        Approx(srfSparse.Evaluate(parameters)).epsilon(1e-7));
+    REQUIRE(srf.Evaluate(parameters, 100, 50) ==
+        Approx(srfSparse.Evaluate(parameters, 100, 50)).epsilon(1e-7));
+
+    arma::mat gradient, sparseGradient;
+    srf.Gradient(parameters, gradient);
+    srfSparse.Gradient(parameters, sparseGradient);
+    CheckMatrices(gradient, sparseGradient, 1e-5);
+
+    srf.Gradient(parameters, 100, gradient, 50);
+    srfSparse.Gradient(parameters, 100, sparseGradient, 50);
+    CheckMatrices(gradient, sparseGradient, 1e-5);
+  }
+}
+
+/**
+ * Train dense and sparse softmax regression models from the same starting
+ * point and make sure they end up with the same parameters.
+ */
+TEST_CASE("SoftmaxRegressionSparseTest", "[SoftmaxRegressionTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(10, 800, 0.3);
+  arma::mat data(sparseData);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  SoftmaxRegression<> sr(data.n_rows, 3, true);
+  SoftmaxRegression<arma::sp_mat> srSparse(sparseData.n_rows, 3, true);
+  srSparse.Parameters() = sr.Parameters();
+
+  sr.Train(data, labels, 3, ens::L_BFGS());
+  srSparse.Train(sparseData, labels, 3, ens::L_BFGS());
+
+  REQUIRE(sr.Parameters().n_elem == srSparse.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    REQUIRE(sr.Parameters()[i] ==
+        Approx(srSparse.Parameters()[i]).epsilon(1e-4));
+  }
+}
+
+/**
+ * Make sure that a single-precision softmax regression model can be trained on
+ * a simple dataset.
+ */
+TEST_CASE("SoftmaxRegressionFloatTest", "[SoftmaxRegressionTest]")
+{
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::fmat data(3, 1000);
+  arma::Row<size_t> responses(1000);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    data.col(i) = arma::conv_to<arma::fvec>::from(g1.Random());
+    responses[i] = 0;
+  }
+  for (size_t i = 500; i < 1000; ++i)
+  {
+    data.col(i) = arma::conv_to<arma::fvec>::from(g2.Random());
+    responses[i] = 1;
+  }
+
+  SoftmaxRegression<arma::fmat> sr(data, responses, 2, 0.01, true);
+
+  const arma::fmat& parameters = sr.Parameters();
+  REQUIRE(parameters.n_rows == 2);
+  REQUIRE(parameters.n_cols == 4);
+
+  const double acc = sr.ComputeAccuracy(data, responses);
+  REQUIRE(acc == Approx(100.0).epsilon(0.02));
+}
+
+/**
+ * Make sure that the objective and gradient on a dataset large enough to be
+ * split into several blocks match the averages over small batches.
+ */
+TEST_CASE("SoftmaxRegressionFunctionBlockedEvaluate",
+          "[SoftmaxRegressionTest]")
+{
+  const size_t points = 10000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 4;
+  const size_t batchSize = 500;
+
+  arma::mat data;
+  data.randn(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  // Without regularization, the full objective and gradient are the averages
+  // of the batch objectives and gradients.
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.0, true);
+  const arma::mat parameters = srf.GetInitialPoint();
+
+  double batchObjective = 0.0;
+  arma::mat batchGradient(arma::size(parameters), arma::fill::zeros);
+  for (size_t i = 0; i < points; i += batchSize)
+  {
+    arma::mat gradient;
+    batchObjective += srf.Evaluate(parameters, i, batchSize) * batchSize /
+        points;
+    srf.Gradient(parameters, i, gradient, batchSize);
+    batchGradient += gradient * batchSize / points;
+  }
+
+  arma::mat gradient, fullGradient;
+  const double objective = srf.EvaluateWithGradient(parameters, gradient);
+  srf.Gradient(parameters, fullGradient);
+
+  REQUIRE(objective == Approx(batchObjective).epsilon(1e-7));
+  REQUIRE(srf.Evaluate(parameters) == Approx(batchObjective).epsilon(1e-7));
+  CheckMatrices(gradient, batchGradient, 1e-5);
+  CheckMatrices(fullGradient, batchGradient, 1e-5);
+}
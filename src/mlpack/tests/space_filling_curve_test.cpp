@@ -0,0 +1,122 @@
+/**
+ * @file tests/space_filling_curve_test.cpp
+ *
+ * Tests for the ordering of datasets along space-filling curves.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/space_filling_curve.hpp>
+
+#include "test_catch_tools.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+/**
+ * Make sure that the given order is a permutation of the given number of
+ * points.
+ */
+void CheckPermutation(const arma::Col<size_t>& order, const size_t n)
+{
+  REQUIRE(order.n_elem == n);
+  std::vector<bool> found(n, false);
+  for (size_t i = 0; i < n; ++i)
+  {
+    REQUIRE(order[i] < n);
+    REQUIRE(!found[order[i]]);
+    found[order[i]] = true;
+  }
+}
+
+/**
+ * Check the Z-order and the Hilbert order of the cells of a 4x4 grid, with one
+ * point per cell.
+ */
+TEST_CASE("SpaceFillingCurveGridTest", "[SpaceFillingCurveTest]")
+{
+  // Cell (x, y) is point 4 * x + y.
+  arma::mat dataset(2, 16);
+  for (size_t x = 0; x < 4; ++x)
+  {
+    for (size_t y = 0; y < 4; ++y)
+    {
+      dataset(0, 4 * x + y) = x;
+      dataset(1, 4 * x + y) = y;
+    }
+  }
+
+  arma::Col<size_t> order;
+  SpaceFillingCurveOrder(dataset, order, z_order, 2);
+  CheckPermutation(order, 16);
+
+  // With the first dimension as the most significant, the Z-order of the 2x2
+  // blocks is (0, 0), (0, 1), (1, 0), (1, 1), and the same inside each block.
+  const size_t zExpected[] = { 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14,
+      15 };
+  for (size_t i = 0; i < 16; ++i)
+    REQUIRE(order[i] == zExpected[i]);
+
+  // Consecutive cells along the Hilbert curve are always neighbours.
+  SpaceFillingCurveOrder(dataset, order, hilbert, 2);
+  CheckPermutation(order, 16);
+  REQUIRE(order[0] == 0);
+  for (size_t i = 1; i < 16; ++i)
+  {
+    const double dist = arma::accu(arma::abs(dataset.col(order[i]) -
+        dataset.col(order[i - 1])));
+    REQUIRE(dist == Approx(1.0));
+  }
+}
+
+/**
+ * Make sure that SpaceFillingCurveSort() reorders the dataset with the order,
+ * and that the order does not depend on the number of threads.
+ */
+TEST_CASE("SpaceFillingCurveSortTest", "[SpaceFillingCurveTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 50000);
+
+  for (size_t curve = 0; curve < 2; ++curve)
+  {
+    const space_filling_curve c = (curve == 0) ? z_order : hilbert;
+
+    arma::mat sorted;
+    arma::Col<size_t> order;
+    SpaceFillingCurveSort(dataset, sorted, order, c, 10);
+    CheckPermutation(order, dataset.n_cols);
+    arma::mat expected = dataset.cols(order);
+    CheckMatrices(sorted, expected);
+
+    // Points along the curve should be much closer to each other than random
+    // pairs of points.
+    const double meanStep = arma::mean(arma::sqrt(arma::sum(arma::square(
+        sorted.cols(1, sorted.n_cols - 1) - sorted.cols(0, sorted.n_cols - 2)),
+        0)));
+    REQUIRE(meanStep < 0.1);
+
+#ifdef HAS_OPENMP
+    const int prevNumThreads = omp_get_max_threads();
+    arma::Col<size_t> serialOrder;
+    omp_set_num_threads(1);
+    SpaceFillingCurveOrder(dataset, serialOrder, c, 10);
+    omp_set_num_threads(3);
+    arma::Col<size_t> parallelOrder;
+    SpaceFillingCurveOrder(dataset, parallelOrder, c, 10);
+    omp_set_num_threads(prevNumThreads);
+
+    CheckMatrices(serialOrder, order);
+    CheckMatrices(parallelOrder, order);
+#endif
+  }
+
+  arma::Col<size_t> order;
+  REQUIRE_THROWS_AS(SpaceFillingCurveOrder(dataset, order, hilbert, 0),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(SpaceFillingCurveOrder(dataset, order, hilbert, 33),
+      std::invalid_argument);
+}
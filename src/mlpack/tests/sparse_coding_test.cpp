@@ -214,3 +214,65 @@ TEST_CASE("SparseCodingTrainReturnObjective", "[SparseCodingTest]")
 
   REQUIRE(std::isfinite(objVal) == true);
 }
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the codes do not depend on the number of threads that the
+ * points are coded with.
+ */
+TEST_CASE("SparseCodingParallelEncodeTest", "[SparseCodingTest]")
+{
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  for (uword i = 0; i < X.n_cols; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding sc(25, 0.1, 0.1);
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  mat serialCodes, parallelCodes;
+  omp_set_num_threads(1);
+  sc.Encode(X, serialCodes);
+  omp_set_num_threads(4);
+  sc.Encode(X, parallelCodes);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(serialCodes, parallelCodes);
+}
+
+#endif
+
+/**
+ * Make sure that online dictionary learning improves the objective on the
+ * training data and keeps the atoms in the unit ball.
+ */
+TEST_CASE("SparseCodingOnlineTrainTest", "[SparseCodingTest]")
+{
+  mat X;
+  X.load("mnist_first250_training_4s_and_9s.arm");
+  for (uword i = 0; i < X.n_cols; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding sc(25, 0.1);
+  DataDependentRandomInitializer::Initialize(X, 25, sc.Dictionary());
+
+  mat codes;
+  sc.Encode(X, codes);
+  const double initialObjective = sc.Objective(X, codes);
+
+  sc.TrainOnline<NothingInitializer>(X, 50, 3);
+
+  REQUIRE(sc.Dictionary().n_rows == X.n_rows);
+  REQUIRE(sc.Dictionary().n_cols == 25);
+  REQUIRE(sc.CodeProducts().n_rows == 25);
+  REQUIRE(sc.DataCodeProducts().n_cols == 25);
+  for (uword j = 0; j < sc.Dictionary().n_cols; ++j)
+    REQUIRE(norm(sc.Dictionary().col(j), 2) <= 1.0 + 1e-10);
+
+  sc.Encode(X, codes);
+  REQUIRE(sc.Objective(X, codes) < initialObjective);
+}
@@ -304,3 +304,87 @@ TEST_CASE("SpillTreeMoveDatasetTest", "[SpillTreeTest]")
   REQUIRE(tree.Dataset().n_rows == 3);
   REQUIRE(tree.Dataset().n_cols == 1000);
 }
+
+/**
+ * Make sure that the given spill trees are the same: the same nodes, holding
+ * the same points, with the same bounds.
+ */
+template<typename TreeType>
+void CheckSameSpillTree(const TreeType& tree, const TreeType& other)
+{
+  REQUIRE(tree.NumChildren() == other.NumChildren());
+  REQUIRE(tree.NumDescendants() == other.NumDescendants());
+  REQUIRE(tree.NumPoints() == other.NumPoints());
+  REQUIRE(tree.Overlap() == other.Overlap());
+  REQUIRE(tree.ParentDistance() ==
+      Approx(other.ParentDistance()).margin(1e-10));
+  REQUIRE(tree.FurthestDescendantDistance() ==
+      Approx(other.FurthestDescendantDistance()).margin(1e-10));
+
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    REQUIRE(tree.Descendant(i) == other.Descendant(i));
+  for (size_t i = 0; i < tree.NumPoints(); ++i)
+    REQUIRE(tree.Point(i) == other.Point(i));
+
+  for (size_t i = 0; i < tree.Bound().Dim(); ++i)
+  {
+    REQUIRE(tree.Bound()[i].Lo() ==
+        Approx(other.Bound()[i].Lo()).margin(1e-10));
+    REQUIRE(tree.Bound()[i].Hi() ==
+        Approx(other.Bound()[i].Hi()).margin(1e-10));
+  }
+
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameSpillTree(tree.Child(i), other.Child(i));
+}
+
+/**
+ * Make sure that copying a tree (which copies the pool of points) gives the
+ * same tree, and that the copy does not depend on the copied tree.
+ */
+TEST_CASE("SpillTreeCopyPointsTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType* tree = new TreeType(dataset, 0.1 /* tau */);
+  TreeType copy(*tree);
+  TreeType assigned(dataset);
+  assigned = copy;
+
+  CheckSameSpillTree(copy, *tree);
+  delete tree;
+
+  CheckSameSpillTree(assigned, copy);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that building the tree in parallel gives exactly the same tree as
+ * building it serially, with and without overlapping nodes.
+ */
+TEST_CASE("SpillTreeParallelBuildTest", "[SpillTreeTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 30000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef MeanSPTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      MeanTreeType;
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, 0.02 /* tau */);
+  TreeType serialNoOverlapTree(dataset);
+  MeanTreeType serialMeanTree(dataset, 0.02 /* tau */);
+
+  omp_set_num_threads(4);
+  TreeType tree(dataset, 0.02 /* tau */);
+  TreeType noOverlapTree(dataset);
+  MeanTreeType meanTree(dataset, 0.02 /* tau */);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckSameSpillTree(tree, serialTree);
+  CheckSameSpillTree(noOverlapTree, serialNoOverlapTree);
+  CheckSameSpillTree(meanTree, serialMeanTree);
+}
+#endif
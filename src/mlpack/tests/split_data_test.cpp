@@ -421,3 +421,46 @@ TEST_CASE("SplitLabeledDataResultField", "[SplitDataTest]")
   CheckFields(input, inputConcat);
   CheckFields(label, labelConcat);
 }
+
+/**
+ * Check that SplitInPlace() and the index variants give the same split as
+ * Split() with the same seed.
+ */
+TEST_CASE("SplitInPlaceMatchesSplitTest", "[SplitDataTest]")
+{
+  mat input(13, 1000, fill::randu);
+  Row<size_t> labels = arma::randi<Row<size_t>>(1000,
+      arma::distr_param(0, 4));
+
+  for (const bool stratify : { false, true })
+  {
+    math::RandomSeed(42);
+    const auto value = Split(input, labels, 0.3, true, stratify);
+    const mat& trainData = std::get<0>(value);
+    const mat& testData = std::get<1>(value);
+    const Row<size_t>& trainLabels = std::get<2>(value);
+    const Row<size_t>& testLabels = std::get<3>(value);
+
+    uvec trainIndices, testIndices;
+    math::RandomSeed(42);
+    if (stratify)
+      StratifiedSplitIndices(labels, trainIndices, testIndices, 0.3);
+    else
+      SplitIndices(input.n_cols, trainIndices, testIndices, 0.3);
+
+    CheckMatrices(trainData, mat(input.cols(trainIndices)));
+    CheckMatrices(testData, mat(input.cols(testIndices)));
+
+    mat permuted(input);
+    Row<size_t> permutedLabels(labels);
+    math::RandomSeed(42);
+    const size_t trainSize = SplitInPlace(permuted, permutedLabels, 0.3, true,
+        stratify);
+
+    REQUIRE(trainSize == trainData.n_cols);
+    CheckMatrices(trainData, mat(permuted.head_cols(trainSize)));
+    CheckMatrices(testData, mat(permuted.tail_cols(testData.n_cols)));
+    REQUIRE(accu(trainLabels != permutedLabels.head(trainSize)) == 0);
+    REQUIRE(accu(testLabels != permutedLabels.tail(testLabels.n_elem)) == 0);
+  }
+}
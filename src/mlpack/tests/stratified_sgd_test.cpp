@@ -0,0 +1,170 @@
+/**
+ * @file tests/stratified_sgd_test.cpp
+ *
+ * Tests for the StratifiedSGD optimizer and the matrix factorization functions
+ * it is used with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/stratified_sgd.hpp>
+#include <mlpack/methods/bias_svd/bias_svd.hpp>
+#include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/svdplusplus/svdplusplus.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::optimization;
+using namespace mlpack::svd;
+
+/**
+ * Make a rating dataset from random user and item vectors (the parameters of
+ * a regularized SVD of the given rank).
+ */
+void StratifiedRatingDataset(const size_t numUsers,
+                             const size_t numItems,
+                             const size_t numRatings,
+                             const size_t rank,
+                             arma::mat& data)
+{
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+  data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+}
+
+/**
+ * Train regularized SVD with StratifiedSGD; this is the same setup as the
+ * HogwildSGD test.
+ */
+TEST_CASE("StratifiedSGDRegularizedSVDTest", "[StratifiedSGDTest]")
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+
+  arma::mat data;
+  StratifiedRatingDataset(numUsers, numItems, numRatings, rank, data);
+
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, 0.01);
+  StratifiedSGD optimizer(0.01, 0, 1e-5);
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; ++i)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+  REQUIRE(relativeError == Approx(0.0).margin(1e-2));
+
+  // The decomposition can also be trained through RegularizedSVD.
+  arma::mat u, v;
+  RegularizedSVD<> rSVD(10, 0.01, 0.01);
+  StratifiedSGD svdOptimizer(0.01, 20);
+  rSVD.Apply(data, rank, u, v, svdOptimizer);
+  REQUIRE(u.n_cols == rank);
+  REQUIRE(v.n_rows == rank);
+}
+
+/**
+ * Make sure that StratifiedSGD decreases the objectives of BiasSVD and SVD++,
+ * and that it can be used through BiasSVD and SVDPlusPlus.
+ */
+TEST_CASE("StratifiedSGDBiasSVDSVDPlusPlusTest", "[StratifiedSGDTest]")
+{
+  const size_t numUsers = 100;
+  const size_t numItems = 100;
+  const size_t numRatings = 2000;
+  const size_t rank = 5;
+
+  arma::mat data;
+  StratifiedRatingDataset(numUsers, numItems, numRatings, rank, data);
+  arma::sp_mat implicitData = arma::sprandu(numItems, numUsers, 0.05);
+
+  BiasSVDFunction<arma::mat> biasSVDFunc(data, rank, 0.01);
+  arma::mat biasParameters = biasSVDFunc.GetInitialPoint();
+  const double biasObjective = biasSVDFunc.Evaluate(biasParameters);
+  StratifiedSGD optimizer(0.01, 20, 1e-8);
+  optimizer.Optimize(biasSVDFunc, biasParameters);
+  REQUIRE(biasSVDFunc.Evaluate(biasParameters) < 0.5 * biasObjective);
+
+  SVDPlusPlusFunction<arma::mat> svdPPFunc(data, implicitData, rank, 0.01);
+  arma::mat svdPPParameters = svdPPFunc.GetInitialPoint();
+  const double svdPPObjective = svdPPFunc.Evaluate(svdPPParameters);
+  optimizer.Optimize(svdPPFunc, svdPPParameters);
+  REQUIRE(svdPPFunc.Evaluate(svdPPParameters) < 0.5 * svdPPObjective);
+
+  arma::mat u, v, y;
+  arma::vec p, q;
+  BiasSVD<> biasSVD(10, 0.01, 0.01);
+  biasSVD.Apply(data, rank, u, v, p, q, optimizer);
+  REQUIRE(u.n_rows == numItems);
+  REQUIRE(v.n_cols == numUsers);
+  REQUIRE(p.n_elem == numItems);
+  REQUIRE(q.n_elem == numUsers);
+
+  SVDPlusPlus<> svdPP(10, 0.01, 0.01);
+  arma::mat implicitPairs = data.submat(0, 0, 1, numRatings / 2);
+  svdPP.Apply(data, implicitPairs, rank, u, v, p, q, y, optimizer);
+  REQUIRE(u.n_rows == numItems);
+  REQUIRE(v.n_cols == numUsers);
+  REQUIRE(y.n_rows == rank);
+  REQUIRE(y.n_cols == numItems);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * With several threads, the result of StratifiedSGD only depends on the
+ * random seed, and not on the scheduling of the threads.
+ */
+TEST_CASE("StratifiedSGDReproducibleTest", "[StratifiedSGDTest]")
+{
+  const size_t numUsers = 100;
+  const size_t numItems = 100;
+  const size_t numRatings = 2000;
+  const size_t rank = 5;
+
+  arma::mat data;
+  StratifiedRatingDataset(numUsers, numItems, numRatings, rank, data);
+  arma::sp_mat implicitData = arma::sprandu(numItems, numUsers, 0.05);
+  SVDPlusPlusFunction<arma::mat> svdPPFunc(data, implicitData, rank, 0.01);
+
+  const int prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  StratifiedSGD optimizer(0.01, 10, 1e-8);
+  math::RandomSeed(12);
+  arma::mat parameters1 = svdPPFunc.GetInitialPoint();
+  const double objective1 = optimizer.Optimize(svdPPFunc, parameters1);
+
+  math::RandomSeed(12);
+  arma::mat parameters2 = svdPPFunc.GetInitialPoint();
+  const double objective2 = optimizer.Optimize(svdPPFunc, parameters2);
+
+  omp_set_num_threads(prevNumThreads);
+
+  REQUIRE(objective1 == Approx(objective2).epsilon(1e-10));
+  CheckMatrices(parameters1, parameters2);
+  REQUIRE(objective1 < svdPPFunc.Evaluate(svdPPFunc.GetInitialPoint()));
+}
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/core/data/string_encoding_policies/dictionary_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/bag_of_words_encoding_policy.hpp>
 #include <mlpack/core/data/string_encoding_policies/tf_idf_encoding_policy.hpp>
+#include <mlpack/core/data/string_encoding_policies/feature_hashing_encoding_policy.hpp>
 #include <memory>
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -1434,3 +1435,93 @@ TEST_CASE("SplitByAnyOfTfIdfEncodingSerialization", "[StringEncodingTest]")
 
   CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
 }
+
+/**
+ * Test that the parallel tokenization assigns the labels in the order of the
+ * first occurrence of the tokens, and that the sparse output is the same as
+ * the dense output.
+ */
+TEST_CASE("ParallelStringEncodingTest", "[StringEncodingTest]")
+{
+  vector<string> input;
+  for (size_t i = 0; i < 500; ++i)
+  {
+    input.push_back(stringEncodingInput[i % 3] + " token" +
+        std::to_string(i % 37) + " word" + std::to_string(i));
+  }
+  SplitByAnyOf tokenizer(" ,.");
+
+  // CreateMap() adds the tokens one string after another.
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> reference;
+  for (const string& line : input)
+    reference.CreateMap(line, tokenizer);
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> encoder, sparseEncoder;
+  encoder.Encode(input, output, tokenizer);
+  sparseEncoder.Encode(input, sparseOutput, tokenizer);
+
+  REQUIRE(encoder.Dictionary().Size() == reference.Dictionary().Size());
+  for (const string& token : reference.Dictionary().Tokens())
+  {
+    REQUIRE(encoder.Dictionary().Value(token) ==
+        reference.Dictionary().Value(token));
+    REQUIRE(sparseEncoder.Dictionary().Value(token) ==
+        reference.Dictionary().Value(token));
+  }
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  TfIdfEncoding<SplitByAnyOf::TokenType> tfIdfEncoder, sparseTfIdfEncoder;
+  tfIdfEncoder.Encode(input, output, tokenizer);
+  sparseTfIdfEncoder.Encode(input, sparseOutput, tokenizer);
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
+/**
+ * Test that feature hashing maps equal tokens to the same signed feature,
+ * does not depend on the other strings, and gives the same dense and sparse
+ * output.
+ */
+TEST_CASE("FeatureHashingEncodingTest", "[StringEncodingTest]")
+{
+  using EncoderType = FeatureHashingEncoding<SplitByAnyOf::TokenType>;
+  SplitByAnyOf tokenizer(" ,.");
+
+  EncoderType encoder;
+  encoder.Dictionary() = HashingDictionary<SplitByAnyOf::TokenType>(64);
+
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+  encoder.Encode(stringEncodingInput, sparseOutput, tokenizer);
+
+  REQUIRE(output.n_rows == 64);
+  REQUIRE(output.n_cols == stringEncodingInput.size());
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  // Each string is encoded on its own.
+  for (size_t i = 0; i < stringEncodingInput.size(); ++i)
+  {
+    arma::mat single;
+    encoder.Encode(vector<string>(1, stringEncodingInput[i]), single,
+        tokenizer);
+    CheckMatrices(arma::mat(output.col(i)), single);
+  }
+
+  // A repeated token adds its sign twice to its feature.
+  arma::mat repeated;
+  encoder.Encode(vector<string>(1, "mlpack mlpack"), repeated, tokenizer);
+  REQUIRE(arma::accu(arma::abs(repeated)) == Approx(2.0));
+  REQUIRE(arma::accu(repeated != 0.0) == 1);
+
+  // Without signs, the features count the tokens of each string.
+  encoder.EncodingPolicy().AlternateSign() = false;
+  encoder.Encode(stringEncodingInput, output, tokenizer);
+  REQUIRE(arma::all(arma::vectorise(output) >= 0.0));
+
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> counter;
+  arma::mat counts;
+  counter.Encode(stringEncodingInput, counts, tokenizer);
+  CheckMatrices(arma::mat(arma::sum(output)), arma::mat(arma::sum(counts)));
+}
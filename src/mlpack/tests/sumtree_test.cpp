@@ -11,6 +11,8 @@
  */
 #include <mlpack/core.hpp>
 
+#include <mlpack/methods/reinforcement_learning/replay/concurrent_sumtree.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/kary_sumtree.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/sumtree.hpp>
 
 #include "catch.hpp"
@@ -88,3 +90,101 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   CHECK(sumtree.FindPrefixSum(2.8) <= 3);
   CHECK(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Test that concurrent updates of a ConcurrentSumTree give the same sums and
+ * prefix sum searches as a SumTree.
+ */
+TEST_CASE("ConcurrentSumTreeTest", "[SumTreeTest]")
+{
+  const size_t size = 1000;
+  ConcurrentSumTree<double> concurrent(size);
+  REQUIRE(concurrent.Capacity() == 1024);
+
+  // Each element is set several times, and the elements are set from several
+  // threads.
+  arma::vec values(size, arma::fill::randu);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) size; ++i)
+  {
+    concurrent.Set(i, 1.0);
+    concurrent.Set(i, 3.0 * values[i]);
+    concurrent.Set(i, values[i]);
+  }
+
+  SumTree<double> sumtree(1024);
+  for (size_t i = 0; i < size; ++i)
+    sumtree.Set(i, values[i]);
+
+  for (size_t i = 0; i < size; ++i)
+    REQUIRE(concurrent.Get(i) == Approx(values[i]).epsilon(1e-10));
+  REQUIRE(concurrent.Sum() == Approx(sumtree.Sum()).epsilon(1e-10));
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double mass = (i + 0.5) / 100.0 * sumtree.Sum();
+    REQUIRE(concurrent.FindPrefixSum(mass) == sumtree.FindPrefixSum(mass));
+  }
+
+  concurrent.Rebuild();
+  REQUIRE(concurrent.Sum() == Approx(arma::accu(values)).epsilon(1e-10));
+}
+
+/**
+ * Test that a KArySumTree gives the same sums and prefix sum searches as a
+ * SumTree, with single and batch operations.
+ */
+TEST_CASE("KArySumTreeTest", "[SumTreeTest]")
+{
+  const size_t size = 1000;
+  KArySumTree<double> kary(size);
+  KArySumTree<double, 4> batchKary(size);
+  SumTree<double> sumtree(1024);
+  REQUIRE(kary.Capacity() == size);
+
+  arma::vec values(size, arma::fill::randu);
+  for (size_t i = 0; i < size; ++i)
+  {
+    kary.Set(i, values[i]);
+    sumtree.Set(i, values[i]);
+  }
+
+  // Update some elements, with repeated parents.
+  arma::ucolvec indices = arma::randi<arma::ucolvec>(100,
+      arma::distr_param(0, size - 1));
+  indices = arma::unique(indices);
+  arma::vec newValues(indices.n_elem, arma::fill::randu);
+  values.elem(indices) = newValues;
+  kary.BatchUpdate(indices, newValues);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    sumtree.Set(indices[i], newValues[i]);
+  batchKary.BatchUpdate(arma::regspace<arma::ucolvec>(0, size - 1), values);
+
+  for (size_t i = 0; i < size; ++i)
+  {
+    REQUIRE(kary.Get(i) == Approx(values[i]).epsilon(1e-10));
+    REQUIRE(batchKary.Get(i) == Approx(values[i]).epsilon(1e-10));
+  }
+  REQUIRE(kary.Sum() == Approx(sumtree.Sum()).epsilon(1e-10));
+  REQUIRE(batchKary.Sum() == Approx(sumtree.Sum()).epsilon(1e-10));
+  REQUIRE(kary.Sum(0, 1) == Approx(values[0]).epsilon(1e-10));
+  REQUIRE(kary.Sum(13, 734) ==
+      Approx(arma::accu(values.subvec(13, 733))).epsilon(1e-10));
+  REQUIRE(batchKary.Sum(500, 1000) ==
+      Approx(arma::accu(values.subvec(500, 999))).epsilon(1e-10));
+
+  arma::vec masses = arma::randu<arma::vec>(50) * sumtree.Sum();
+  arma::ucolvec found;
+  kary.BatchFindPrefixSum(masses, found);
+  REQUIRE(found.n_elem == 50);
+  for (size_t i = 0; i < masses.n_elem; ++i)
+  {
+    REQUIRE(kary.FindPrefixSum(masses[i]) == sumtree.FindPrefixSum(masses[i]));
+    REQUIRE(found[i] == sumtree.FindPrefixSum(masses[i]));
+    REQUIRE(batchKary.FindPrefixSum(masses[i]) ==
+        sumtree.FindPrefixSum(masses[i]));
+  }
+
+  // A mass larger than the sum gives the last nonzero element.
+  REQUIRE(kary.FindPrefixSum(2 * kary.Sum()) == size - 1);
+}
@@ -18,6 +18,7 @@
 #include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -191,3 +192,32 @@ TEST_CASE("SVDBatchNegativeElementTest", "[SVDBatchTest]")
   REQUIRE(arma::norm(test, "fro") ==
       Approx(arma::norm(result, "fro")).epsilon(0.09));
 }
+
+/**
+ * Make sure the sparse and dense SVD batch learning steps agree.
+ */
+TEST_CASE("SVDBatchSparseDenseStepTest", "[SVDBatchTest]")
+{
+  sp_mat v;
+  v.sprandu(150, 100, 0.1);
+  const mat dv(v);
+  const mat w0 = randu<mat>(150, 4);
+  const mat h0 = randu<mat>(4, 100);
+
+  SVDBatchLearning sparse(0.01, 0.01, 0.01, 0.5);
+  SVDBatchLearning dense(0.01, 0.01, 0.01, 0.5);
+  sparse.Initialize(v, 4);
+  dense.Initialize(dv, 4);
+
+  mat w(w0), dw(w0), h(h0), dh(h0);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    sparse.WUpdate(v, w, h);
+    sparse.HUpdate(v, w, h);
+    dense.WUpdate(dv, dw, dh);
+    dense.HUpdate(dv, dw, dh);
+  }
+
+  CheckMatrices(w, dw, 1e-5);
+  CheckMatrices(h, dh, 1e-5);
+}
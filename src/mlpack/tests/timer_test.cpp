@@ -143,3 +143,94 @@ TEST_CASE("DisabledTimingTest", "[TimerTest]")
 
   REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
+
+/**
+ * The profile timers should be summed over threads, ignore recursive scopes,
+ * and do nothing while disabled.
+ */
+TEST_CASE("ProfileTimersTest", "[TimerTest]")
+{
+  ProfileTimers::Reset();
+
+  // Nothing is counted while timing is disabled.
+  {
+    ScopedProfileTimer timer(ProfileTimerID::TREE_BUILD);
+  }
+  REQUIRE(ProfileTimers::Calls(ProfileTimerID::TREE_BUILD) == 0);
+
+  ProfileTimers::Enable();
+  std::thread threads[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads[i] = std::thread([]()
+        {
+          ScopedProfileTimer outer(ProfileTimerID::TREE_BUILD);
+          {
+            // A recursive scope is counted as a call but not timed again.
+            ScopedProfileTimer inner(ProfileTimerID::TREE_BUILD);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          }
+        });
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+  ProfileTimers::Disable();
+
+  // The counters of the threads are kept after they exit.
+  REQUIRE(ProfileTimers::Calls(ProfileTimerID::TREE_BUILD) == 6);
+  REQUIRE(ProfileTimers::Get(ProfileTimerID::TREE_BUILD) >=
+      std::chrono::milliseconds(60));
+  REQUIRE(ProfileTimers::Get(ProfileTimerID::TREE_BUILD) <
+      std::chrono::milliseconds(6 * 20 * 10));
+  REQUIRE(ProfileTimers::Calls(ProfileTimerID::FFN_FORWARD) == 0);
+  REQUIRE(std::string(ProfileTimers::Name(ProfileTimerID::TREE_BUILD)) ==
+      "tree_build");
+
+  ProfileTimers::Reset();
+  REQUIRE(ProfileTimers::Calls(ProfileTimerID::TREE_BUILD) == 0);
+  REQUIRE(ProfileTimers::Get(ProfileTimerID::TREE_BUILD).count() == 0);
+}
+
+/**
+ * Each run of a timer should be recorded as an event of the thread it ran on
+ * while tracing is enabled.
+ */
+TEST_CASE("TimerTraceTest", "[TimerTest]")
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::EnableTracing();
+
+  Timer::Start("trace_timer");
+  Timer::Stop("trace_timer");
+
+  std::thread thread([]()
+      {
+        Timer::Start("trace_thread_timer");
+        Timer::Stop("trace_thread_timer");
+      });
+  thread.join();
+
+  // This run is not recorded.
+  Timer::DisableTracing();
+  Timer::Start("trace_timer");
+  Timer::Stop("trace_timer");
+
+  REQUIRE(IO::GetSingleton().timer.NumTraceEvents() == 2);
+
+  std::ostringstream stream;
+  IO::GetSingleton().timer.WriteTrace(stream);
+  const std::string trace = stream.str();
+
+  REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+  REQUIRE(trace.find("\"name\": \"trace_timer\"") != std::string::npos);
+  REQUIRE(trace.find("\"name\": \"trace_thread_timer\"") != std::string::npos);
+  // The two timers ran on different threads.
+  REQUIRE(trace.find("\"tid\": 0") != std::string::npos);
+  REQUIRE(trace.find("\"tid\": 1") != std::string::npos);
+
+  Timer::ResetAll();
+  REQUIRE(IO::GetSingleton().timer.NumTraceEvents() == 0);
+  Timer::DisableTiming();
+}
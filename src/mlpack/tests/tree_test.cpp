@@ -11,6 +11,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/tree/bounds.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/binary_space_tree/mapped_tree.hpp>
+#include <mlpack/core/tree/leaf_distance_cache.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
@@ -1806,6 +1808,233 @@ TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
   REQUIRE(tree2.NumChildren() == 2);
 }
 
+//! Make sure that the descendants of the given root are stored contiguously in
+//! breadth-first order.
+template<typename TreeType>
+void CheckPackedNodes(TreeType& root)
+{
+  std::vector<TreeType*> nodes;
+  for (size_t i = 0; i < root.NumChildren(); ++i)
+    nodes.push_back(&root.Child(i));
+  for (size_t i = 0; i < nodes.size(); ++i)
+    for (size_t j = 0; j < nodes[i]->NumChildren(); ++j)
+      nodes.push_back(&nodes[i]->Child(j));
+
+  for (size_t i = 1; i < nodes.size(); ++i)
+    REQUIRE(nodes[i] == nodes[i - 1] + 1);
+}
+
+/**
+ * Make sure that built, copied, moved and assigned trees hold their nodes in
+ * one contiguous block, and that the copies are still the same tree.
+ */
+TEST_CASE("BinarySpaceTreePackedNodesTest", "[TreeTest]")
+{
+  arma::mat dataset(3, 1000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 10);
+  CheckPackedNodes(tree);
+
+  TreeType copy(tree);
+  CheckPackedNodes(copy);
+  CheckSameTree(copy, tree);
+
+  TreeType moved(std::move(copy));
+  CheckPackedNodes(moved);
+  CheckSameTree(moved, tree);
+  REQUIRE(moved.Left()->Parent() == &moved);
+  REQUIRE(moved.Right()->Parent() == &moved);
+
+  TreeType assigned(dataset, 50);
+  assigned = tree;
+  CheckPackedNodes(assigned);
+  CheckSameTree(assigned, tree);
+}
+
+//! Make sure that two binary space trees have exactly the same structure.
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.ParentDistance() == Approx(b.ParentDistance()));
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()));
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    REQUIRE(a.Bound()[d].Lo() == b.Bound()[d].Lo());
+    REQUIRE(a.Bound()[d].Hi() == b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a kd-tree saved with MappedTree::Save() and mapped again is
+ * exactly the same as the original tree, and that it aliases the file.
+ */
+TEST_CASE("MappedTreeTest", "[TreeTest]")
+{
+  arma::mat dataset(4, 3000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew, 15);
+
+  MappedTree<TreeType>::Save("mapped_tree_test.bin", tree, oldFromNew);
+
+  {
+    MappedTree<TreeType> mapped("mapped_tree_test.bin");
+
+    REQUIRE(mapped.OldFromNew() == oldFromNew);
+    REQUIRE(mapped.Tree().Parent() == (TreeType*) NULL);
+    CheckMatrices(mapped.Tree().Dataset(), tree.Dataset());
+    CheckSameTree(mapped.Tree(), tree);
+
+    // Every node must use the same dataset.
+    std::stack<TreeType*> stack;
+    stack.push(&mapped.Tree());
+    while (!stack.empty())
+    {
+      TreeType* node = stack.top();
+      stack.pop();
+      REQUIRE(&node->Dataset() == &mapped.Tree().Dataset());
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        stack.push(&node->Child(i));
+    }
+
+    // The tree can be moved out of the mapping.
+    TreeType moved(std::move(mapped.Tree()));
+    CheckSameTree(moved, tree);
+  }
+
+  // A file that is not a mapped tree can't be loaded.
+  data::Save("mapped_tree_test.bin", dataset);
+  REQUIRE_THROWS_AS(MappedTree<TreeType>("mapped_tree_test.bin"),
+      std::runtime_error);
+
+  remove("mapped_tree_test.bin");
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that building a kd-tree with multiple threads gives exactly the
+ * same tree and the same mappings as building it with one thread.
+ */
+TEST_CASE("BinarySpaceTreeParallelBuildTest", "[TreeTest]")
+{
+  arma::mat dataset(5, 50000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef BinarySpaceTree<EuclideanDistance, EmptyStatistic, arma::mat,
+      HRectBound, MeanSplit> MeanTreeType;
+
+  const int prevNumThreads = omp_get_max_threads();
+
+  std::vector<size_t> serialOldFromNew, serialNewFromOld;
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, serialOldFromNew, serialNewFromOld);
+  MeanTreeType serialMeanTree(dataset);
+
+  std::vector<size_t> oldFromNew, newFromOld;
+  omp_set_num_threads(4);
+  TreeType tree(dataset, oldFromNew, newFromOld);
+  MeanTreeType meanTree(dataset);
+  omp_set_num_threads(prevNumThreads);
+
+  REQUIRE(oldFromNew == serialOldFromNew);
+  REQUIRE(newFromOld == serialNewFromOld);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+  CheckSameTree(tree, serialTree);
+
+  CheckMatrices(meanTree.Dataset(), serialMeanTree.Dataset());
+  CheckSameTree(meanTree, serialMeanTree);
+}
+#endif
+
+/**
+ * Make sure that the LeafDistanceCache gives the same distances as the metric
+ * for every point of a prepared leaf, and nothing for other points.
+ */
+TEST_CASE("LeafDistanceCacheTest", "[TreeTest]")
+{
+  arma::mat dataset(7, 1000);
+  dataset.randu();
+  arma::mat queries(7, 20);
+  queries.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset, 10);
+
+  LeafDistanceCache<EuclideanDistance, arma::mat> cache;
+  LeafDistanceCache<SquaredEuclideanDistance, arma::mat> squaredCache;
+  REQUIRE(LeafDistanceCache<EuclideanDistance, arma::mat>::IsBatchable);
+  REQUIRE(!LeafDistanceCache<ManhattanDistance, arma::mat>::IsBatchable);
+  REQUIRE(!LeafDistanceCache<EuclideanDistance, arma::sp_mat>::IsBatchable);
+
+  // Collect the leaves of the tree.
+  std::vector<TreeType*> leaves;
+  std::stack<TreeType*> nodes;
+  nodes.push(&tree);
+  while (!nodes.empty())
+  {
+    TreeType* node = nodes.top();
+    nodes.pop();
+    if (node->IsLeaf())
+      leaves.push_back(node);
+    else
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        nodes.push(&node->Child(i));
+  }
+
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    for (size_t l = 0; l < leaves.size(); ++l)
+    {
+      // Leaves with a single point are never cached.
+      const TreeType& leaf = *leaves[l];
+      if (leaf.NumPoints() < 2)
+        continue;
+
+      cache.Prepare(q, leaf);
+      squaredCache.Prepare(q, leaf);
+
+      double distance;
+      for (size_t i = 0; i < leaf.NumPoints(); ++i)
+      {
+        const arma::vec diff = queries.col(q) -
+            tree.Dataset().col(leaf.Point(i));
+
+        REQUIRE(cache.Distance(queries, tree.Dataset(), q, leaf.Point(i),
+            distance));
+        REQUIRE(distance == Approx(arma::norm(diff)).epsilon(1e-10));
+
+        REQUIRE(squaredCache.Distance(queries, tree.Dataset(), q,
+            leaf.Point(i), distance));
+        REQUIRE(distance == Approx(arma::dot(diff, diff)).epsilon(1e-10));
+
+        // Another query point was not prepared.
+        REQUIRE(!cache.Distance(queries, tree.Dataset(), q + 1, leaf.Point(i),
+            distance));
+      }
+
+      // The next leaf has not been prepared for this query point yet.
+      if (l + 1 < leaves.size())
+      {
+        REQUIRE(!cache.Distance(queries, tree.Dataset(), q,
+            leaves[l + 1]->Point(0), distance));
+      }
+    }
+  }
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1954,6 +2183,54 @@ TEST_CASE("CoverTreeConstructionTest", "[TreeTest]")
   // implementation.
 }
 
+// Make sure two cover trees have the same structure.
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Point() == b.Point());
+  REQUIRE(a.Scale() == b.Scale());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()).epsilon(1e-7));
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Create a cover tree that is large enough for its distances to be computed in
+ * parallel, and make sure it's accurate and the same as with one thread.
+ */
+TEST_CASE("CoverTreeParallelConstructionTest", "[TreeTest]")
+{
+  arma::mat dataset;
+  dataset.randu(5, 10000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  arma::vec counts;
+  counts.zeros(10000);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 10000; ++i)
+    REQUIRE(counts[i] == 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+  TreeType serialTree(dataset);
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(oldThreads);
+  #endif
+
+  CheckSameCoverTree(tree, serialTree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include "catch.hpp"
@@ -47,3 +48,45 @@ TEST_CASE("TestUnion", "[UnionFindTest]")
   REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
   REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
+
+TEST_CASE("TestConcurrentUnion", "[UnionFindTest]")
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; ++i)
+    REQUIRE(testUnionFind.Find(i) == i);
+
+  testUnionFind.Union(0, 1);
+  testUnionFind.Union(2, 3);
+  testUnionFind.Union(0, 2);
+  testUnionFind.Union(5, 0);
+  testUnionFind.Union(0, 6);
+
+  // The representative of each component is its smallest element.
+  REQUIRE(testUnionFind.Find(1) == 0);
+  REQUIRE(testUnionFind.Find(3) == 0);
+  REQUIRE(testUnionFind.Find(5) == 0);
+  REQUIRE(testUnionFind.Find(6) == 0);
+  REQUIRE(testUnionFind.Find(4) == 4);
+  REQUIRE(testUnionFind.Find(9) == 9);
+}
+
+/**
+ * Union the elements of a large structure from many threads at once and make
+ * sure the components are correct.
+ */
+TEST_CASE("TestConcurrentUnionParallel", "[UnionFindTest]")
+{
+  static const size_t testSize = 100000;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  // Link every element to the element 7 positions further, so that there are
+  // 7 components, identified by the element modulo 7.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) testSize - 7; ++i)
+    testUnionFind.Union(testSize - 8 - i, testSize - 1 - i);
+
+  for (size_t i = 0; i < testSize; ++i)
+    REQUIRE(testUnionFind.Find(i) == i % 7);
+}